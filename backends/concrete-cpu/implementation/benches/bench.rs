@@ -1,8 +1,19 @@
+use concrete_cpu::c_api::csprng::{new_dyn_seeder, DynamicRandomGenerator};
+use concrete_cpu::c_api::keyswitch::{
+    concrete_cpu_batched_keyswitch_lwe_ciphertext_u64, concrete_cpu_keyswitch_key_size_u64,
+    concrete_cpu_keyswitch_lwe_ciphertext_u64,
+};
 use concrete_cpu::c_api::linear_op::{
     concrete_cpu_add_lwe_ciphertext_u64, concrete_cpu_add_plaintext_lwe_ciphertext_u64,
     concrete_cpu_mul_cleartext_lwe_ciphertext_u64, concrete_cpu_negate_lwe_ciphertext_u64,
 };
+use concrete_cpu::c_api::secret_key::{
+    concrete_cpu_encrypt_lwe_ciphertext_u64, concrete_cpu_encrypt_lwe_ciphertext_vector_u64,
+};
+use concrete_cpu::c_api::types::{EncCsprng, Parallelism};
+use concrete_csprng::seeders::Seed;
 use criterion::{criterion_group, criterion_main, Criterion};
+use tfhe::core_crypto::prelude::EncryptionRandomGenerator;
 
 pub fn criterion_benchmark(c: &mut Criterion) {
     for lwe_dimension in [128, 256, 512] {
@@ -63,5 +74,122 @@ pub fn criterion_benchmark(c: &mut Criterion) {
     }
 }
 
-criterion_group!(benches, criterion_benchmark);
+pub fn encryption_benchmark(c: &mut Criterion) {
+    // The pixels of an image, encrypted one by one or in a single call
+    let count = 784;
+    let variance = 2.0_f64.powi(-50);
+    let mut seeder = new_dyn_seeder();
+    let mut generator =
+        EncryptionRandomGenerator::<DynamicRandomGenerator>::new(Seed(0), seeder.as_mut());
+    let csprng =
+        &mut generator as *mut EncryptionRandomGenerator<DynamicRandomGenerator> as *mut EncCsprng;
+    for lwe_dimension in [512, 1024, 2048] {
+        let lwe_size = lwe_dimension + 1;
+        let sk = vec![1_u64; lwe_dimension];
+        let plaintexts = vec![0_u64; count];
+
+        c.bench_function(
+            &format!("encrypt-lwe-ciphertext-u64-{lwe_dimension}x{count}"),
+            |b| {
+                let mut out = vec![0_u64; lwe_size * count];
+                b.iter(|| unsafe {
+                    for (i, plaintext) in plaintexts.iter().enumerate() {
+                        concrete_cpu_encrypt_lwe_ciphertext_u64(
+                            sk.as_ptr(),
+                            out[i * lwe_size..].as_mut_ptr(),
+                            *plaintext,
+                            lwe_dimension,
+                            variance,
+                            csprng,
+                        );
+                    }
+                });
+            },
+        );
+
+        for (name, parallelism) in [("seq", Parallelism::No), ("par", Parallelism::Rayon)] {
+            c.bench_function(
+                &format!("encrypt-lwe-ciphertext-vector-{name}-u64-{lwe_dimension}x{count}"),
+                |b| {
+                    let mut out = vec![0_u64; lwe_size * count];
+                    b.iter(|| unsafe {
+                        concrete_cpu_encrypt_lwe_ciphertext_vector_u64(
+                            sk.as_ptr(),
+                            out.as_mut_ptr(),
+                            plaintexts.as_ptr(),
+                            count,
+                            lwe_dimension,
+                            variance,
+                            csprng,
+                            parallelism,
+                        );
+                    });
+                },
+            );
+        }
+    }
+}
+
+pub fn keyswitch_benchmark(c: &mut Criterion) {
+    // A batch of ciphertexts keyswitched one by one or in a single key-major call
+    let count = 64;
+    let (level, base_log) = (5, 3);
+    let (input_dimension, output_dimension) = (2048, 800);
+    let ksk_size =
+        unsafe { concrete_cpu_keyswitch_key_size_u64(level, input_dimension, output_dimension) };
+    let ksk = vec![0_u64; ksk_size];
+    let ct_in = vec![0_u64; (input_dimension + 1) * count];
+    let output_size = output_dimension + 1;
+
+    c.bench_function(
+        &format!("keyswitch-lwe-ciphertext-u64-{input_dimension}-{output_dimension}x{count}"),
+        |b| {
+            let mut out = vec![0_u64; output_size * count];
+            b.iter(|| unsafe {
+                for i in 0..count {
+                    concrete_cpu_keyswitch_lwe_ciphertext_u64(
+                        out[i * output_size..].as_mut_ptr(),
+                        ct_in[i * (input_dimension + 1)..].as_ptr(),
+                        ksk.as_ptr(),
+                        level,
+                        base_log,
+                        input_dimension,
+                        output_dimension,
+                    );
+                }
+            });
+        },
+    );
+
+    for (name, parallelism) in [("seq", Parallelism::No), ("par", Parallelism::Rayon)] {
+        c.bench_function(
+            &format!(
+                "batched-keyswitch-lwe-ciphertext-{name}-u64-{input_dimension}-{output_dimension}x{count}"
+            ),
+            |b| {
+                let mut out = vec![0_u64; output_size * count];
+                b.iter(|| unsafe {
+                    concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+                        out.as_mut_ptr(),
+                        ct_in.as_ptr(),
+                        count,
+                        ksk.as_ptr(),
+                        level,
+                        base_log,
+                        input_dimension,
+                        output_dimension,
+                        parallelism,
+                    );
+                });
+            },
+        );
+    }
+}
+
+criterion_group!(
+    benches,
+    criterion_benchmark,
+    encryption_benchmark,
+    keyswitch_benchmark
+);
 criterion_main!(benches);
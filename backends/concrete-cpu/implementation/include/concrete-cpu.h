@@ -14,6 +14,32 @@
 #include "concrete-num_complex.h"
 
 
+enum CsprngBackend
+#ifdef __cplusplus
+  : uint32_t
+#endif // __cplusplus
+ {
+  Software = 0,
+  AesNi = 1,
+  ArmAes = 2,
+};
+#ifndef __cplusplus
+typedef uint32_t CsprngBackend;
+#endif // __cplusplus
+
+enum FftBackend
+#ifdef __cplusplus
+  : uint32_t
+#endif // __cplusplus
+ {
+  Scalar = 0,
+  Avx2 = 1,
+  Avx512 = 2,
+};
+#ifndef __cplusplus
+typedef uint32_t FftBackend;
+#endif // __cplusplus
+
 enum Parallelism
 #ifdef __cplusplus
   : uint32_t
@@ -92,6 +118,30 @@ void concrete_cpu_add_plaintext_lwe_ciphertext_u64(uint64_t *ct_out,
                                                    uint64_t plaintext,
                                                    size_t lwe_dimension);
 
+void concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out_vec,
+                                                       const uint64_t *ct_in_vec,
+                                                       size_t count,
+                                                       const uint64_t *accumulators,
+                                                       size_t accumulator_stride,
+                                                       const c64 *fourier_bsk,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t glwe_dimension,
+                                                       size_t polynomial_size,
+                                                       size_t input_lwe_dimension,
+                                                       const struct Fft *fft,
+                                                       Parallelism parallelism);
+
+void concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(uint64_t *ct_out_vec,
+                                                       const uint64_t *ct_in_vec,
+                                                       size_t count,
+                                                       const uint64_t *keyswitch_key,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t input_dimension,
+                                                       size_t output_dimension,
+                                                       Parallelism parallelism);
+
 void concrete_cpu_bootstrap_key_convert_u64_to_fourier(const uint64_t *standard_bsk,
                                                        c64 *fourier_bsk,
                                                        size_t decomposition_level_count,
@@ -112,6 +162,41 @@ size_t concrete_cpu_bootstrap_key_size_u64(size_t decomposition_level_count,
                                            size_t polynomial_size,
                                            size_t input_lwe_dimension);
 
+void concrete_cpu_bootstrap_lwe_ciphertext_compact_u64(uint64_t *ct_out,
+                                                       const uint64_t *ct_in,
+                                                       const uint64_t *accumulator,
+                                                       const float *compact_fourier_bsk,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t glwe_dimension,
+                                                       size_t polynomial_size,
+                                                       size_t input_lwe_dimension,
+                                                       const struct Fft *fft,
+                                                       uint8_t *stack,
+                                                       size_t stack_size);
+
+ScratchStatus concrete_cpu_bootstrap_lwe_ciphertext_compact_u64_scratch(size_t *stack_size,
+                                                                        size_t *stack_align,
+                                                                        size_t decomposition_level_count,
+                                                                        size_t glwe_dimension,
+                                                                        size_t polynomial_size,
+                                                                        const struct Fft *fft);
+
+void concrete_cpu_bootstrap_lwe_ciphertext_many_lut_u64(uint64_t *ct_out_vec,
+                                                        const uint64_t *ct_in,
+                                                        const uint64_t *accumulator,
+                                                        size_t lut_count,
+                                                        size_t lut_stride,
+                                                        const c64 *fourier_bsk,
+                                                        size_t decomposition_level_count,
+                                                        size_t decomposition_base_log,
+                                                        size_t glwe_dimension,
+                                                        size_t polynomial_size,
+                                                        size_t input_lwe_dimension,
+                                                        const struct Fft *fft,
+                                                        uint8_t *stack,
+                                                        size_t stack_size);
+
 void concrete_cpu_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out,
                                                const uint64_t *ct_in,
                                                const uint64_t *accumulator,
@@ -242,6 +327,22 @@ void concrete_cpu_encrypt_lwe_ciphertext_u64(const uint64_t *lwe_sk,
                                              double variance,
                                              struct EncCsprng *csprng);
 
+void concrete_cpu_encrypt_lwe_ciphertext_vector_u64(const uint64_t *lwe_sk,
+                                                    uint64_t *lwe_out,
+                                                    const uint64_t *input,
+                                                    size_t count,
+                                                    size_t lwe_dimension,
+                                                    double variance,
+                                                    struct EncCsprng *csprng,
+                                                    Parallelism parallelism);
+
+void concrete_cpu_encrypt_lwe_ciphertext_vector_with_randomness_u64(const uint64_t *lwe_sk,
+                                                                     uint64_t *lwe_inout,
+                                                                     const uint64_t *input,
+                                                                     size_t count,
+                                                                     size_t lwe_dimension,
+                                                                     Parallelism parallelism);
+
 void concrete_cpu_encrypt_seeded_lwe_ciphertext_u64(const uint64_t *lwe_sk,
                                                     uint64_t *seeded_lwe_out,
                                                     uint64_t input,
@@ -279,26 +380,55 @@ ScratchStatus concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(size_t *stack_
                                                                   size_t bsk_polynomial_size,
                                                                   const struct Fft *fft);
 
+void concrete_cpu_fill_lwe_encryption_randomness_u64(uint64_t *randomness_out,
+                                                     size_t count,
+                                                     size_t lwe_dimension,
+                                                     double variance,
+                                                     struct EncCsprng *csprng,
+                                                     Parallelism parallelism);
+
 void concrete_cpu_fill_with_random_gaussian(uint64_t *buffer,
                                             size_t size,
                                             double variance,
                                             struct Csprng *csprng);
 
+void concrete_cpu_fork_encryption_csprng(struct EncCsprng *mem, struct EncCsprng *parent);
+
 size_t concrete_cpu_fourier_bootstrap_key_size_u64(size_t decomposition_level_count,
                                                    size_t glwe_dimension,
                                                    size_t polynomial_size,
                                                    size_t input_lwe_dimension);
 
+CsprngBackend concrete_cpu_get_csprng_backend(void);
+
+FftBackend concrete_cpu_get_fft_backend(void);
+
 size_t concrete_cpu_ggsw_ciphertext_size_u64(size_t glwe_dimension,
                                              size_t polynomial_size,
                                              size_t decomposition_level_count);
 
 size_t concrete_cpu_glwe_ciphertext_size_u64(size_t glwe_dimension, size_t polynomial_size);
 
+size_t concrete_cpu_glwe_packing_keyswitch_key_size_u64(size_t decomposition_level_count,
+                                                        size_t input_dimension,
+                                                        size_t output_glwe_dimension,
+                                                        size_t output_polynomial_size);
+
 size_t concrete_cpu_glwe_secret_key_buffer_size_u64(size_t glwe_dimension, size_t polynomial_size);
 
 size_t concrete_cpu_glwe_secret_key_size_u64(size_t lwe_dimension, size_t polynomial_size);
 
+void concrete_cpu_init_glwe_packing_keyswitch_key_u64(uint64_t *glwe_pksk,
+                                                      const uint64_t *input_lwe_sk,
+                                                      const uint64_t *output_glwe_sk,
+                                                      size_t input_lwe_dimension,
+                                                      size_t output_glwe_dimension,
+                                                      size_t output_polynomial_size,
+                                                      size_t decomposition_level_count,
+                                                      size_t decomposition_base_log,
+                                                      double variance,
+                                                      struct EncCsprng *csprng);
+
 void concrete_cpu_init_lwe_bootstrap_key_u64(uint64_t *lwe_bsk,
                                              const uint64_t *input_lwe_sk,
                                              const uint64_t *output_glwe_sk,
@@ -357,6 +487,18 @@ void concrete_cpu_init_seeded_lwe_keyswitch_key_u64(uint64_t *seeded_lwe_ksk,
                                                     struct Uint128 compression_seed,
                                                     double variance);
 
+bool concrete_cpu_is_csprng_backend_available(CsprngBackend backend);
+
+void concrete_cpu_keyswitch_and_pack_lwe_ciphertext_list_u64(uint64_t *glwe_ct_out,
+                                                             const uint64_t *lwe_ct_list_in,
+                                                             size_t lwe_ct_count,
+                                                             const uint64_t *glwe_pksk,
+                                                             size_t decomposition_level_count,
+                                                             size_t decomposition_base_log,
+                                                             size_t input_dimension,
+                                                             size_t output_glwe_dimension,
+                                                             size_t output_polynomial_size);
+
 size_t concrete_cpu_keyswitch_key_size_u64(size_t decomposition_level_count,
                                            size_t input_dimension,
                                            size_t output_dimension);
@@ -420,6 +562,8 @@ size_t concrete_cpu_serialize_lwe_secret_key_u64(const uint64_t *lwe_sk,
                                                  uint8_t *out_buffer,
                                                  size_t out_buffer_len);
 
+int concrete_cpu_set_csprng_backend(CsprngBackend backend);
+
 size_t concrete_cpu_tfhers_fheint_buffer_size_u64(size_t lwe_size, size_t n_cts, size_t n_elem);
 
 int64_t concrete_cpu_tfhers_int8_to_lwe_array(const uint8_t *buffer,
@@ -1,13 +1,14 @@
-use concrete_csprng::generators::SoftwareRandomGenerator;
 use concrete_fft::c64;
 use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
 use crate::c_api::types::{EncCsprng, Parallelism, ScratchStatus, Uint128};
+use aligned_vec::CACHELINE_ALIGN;
 use core::slice;
-use dyn_stack::PodStack;
+use dyn_stack::{GlobalPodBuffer, PodStack, StackReq};
+use rayon::prelude::*;
 
-use super::csprng::new_dyn_seeder;
+use super::csprng::{new_dyn_seeder, DynamicRandomGenerator};
 use super::secret_key::{
     concrete_cpu_glwe_ciphertext_size_u64, concrete_cpu_glwe_secret_key_size_u64,
     concrete_cpu_lwe_secret_key_size_u64,
@@ -74,14 +75,14 @@ pub unsafe extern "C" fn concrete_cpu_init_lwe_bootstrap_key_u64(
                 &glwe_sk,
                 &mut bsk,
                 Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+                &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
             ),
             Parallelism::Rayon => par_generate_lwe_bootstrap_key(
                 &lwe_sk,
                 &glwe_sk,
                 &mut bsk,
                 Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+                &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
             ),
         }
     });
@@ -221,13 +222,13 @@ pub unsafe extern "C" fn concrete_cpu_decompress_seeded_lwe_bootstrap_key_u64(
         );
         match parallelism {
             Parallelism::No => {
-                decompress_seeded_lwe_bootstrap_key::<_, _, _, SoftwareRandomGenerator>(
+                decompress_seeded_lwe_bootstrap_key::<_, _, _, DynamicRandomGenerator>(
                     &mut output_bsk,
                     &input_bsk,
                 )
             }
             Parallelism::Rayon => {
-                par_decompress_seeded_lwe_bootstrap_key::<_, _, _, SoftwareRandomGenerator>(
+                par_decompress_seeded_lwe_bootstrap_key::<_, _, _, DynamicRandomGenerator>(
                     &mut output_bsk,
                     &input_bsk,
                 )
@@ -413,6 +414,366 @@ pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_u64(
     })
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out_vec: *mut u64,
+    ct_in_vec: *const u64,
+    count: usize,
+    // accumulators, `accumulator_stride` integers apart, 0 to bootstrap all the ciphertexts
+    // with the same one
+    accumulators: *const u64,
+    accumulator_stride: usize,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // side resources
+    fft: *const Fft,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        if count == 0 {
+            return;
+        }
+        let output_lwe_size = glwe_dimension * polynomial_size + 1;
+        let input_lwe_size = input_lwe_dimension + 1;
+        let accumulator_size =
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size);
+
+        let fourier = FourierLweBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_bsk,
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+        let fft = (*fft).as_view();
+
+        let ct_out_vec = slice::from_raw_parts_mut(ct_out_vec, count * output_lwe_size);
+        let ct_in_vec = slice::from_raw_parts(ct_in_vec, count * input_lwe_size);
+        let accumulators = slice::from_raw_parts(
+            accumulators,
+            (count - 1) * accumulator_stride + accumulator_size,
+        );
+
+        let requirement = programmable_bootstrap_lwe_ciphertext_mem_optimized_requirement::<u64>(
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            fft,
+        )
+        .unwrap();
+
+        // The scratch is allocated once per worker and reused by all the ciphertexts it
+        // bootstraps, which then read the same bootstrap key one after the other.
+        let bootstrap =
+            |stack: &mut GlobalPodBuffer, (i, (ct_out, ct_in)): (usize, (&mut [u64], &[u64]))| {
+                let lwe_in = LweCiphertext::from_container(ct_in, CiphertextModulus::new_native());
+                let mut lwe_out =
+                    LweCiphertext::from_container(ct_out, CiphertextModulus::new_native());
+                let offset = i * accumulator_stride;
+                let accumulator = GlweCiphertext::from_container(
+                    &accumulators[offset..offset + accumulator_size],
+                    PolynomialSize(polynomial_size),
+                    CiphertextModulus::new_native(),
+                );
+                programmable_bootstrap_lwe_ciphertext_mem_optimized(
+                    &lwe_in,
+                    &mut lwe_out,
+                    &accumulator,
+                    &fourier,
+                    fft,
+                    PodStack::new(stack),
+                );
+            };
+
+        match parallelism {
+            Parallelism::No => {
+                let mut stack = GlobalPodBuffer::new(requirement);
+                ct_out_vec
+                    .chunks_exact_mut(output_lwe_size)
+                    .zip(ct_in_vec.chunks_exact(input_lwe_size))
+                    .enumerate()
+                    .for_each(|item| bootstrap(&mut stack, item));
+            }
+            Parallelism::Rayon => ct_out_vec
+                .par_chunks_exact_mut(output_lwe_size)
+                .zip(ct_in_vec.par_chunks_exact(input_lwe_size))
+                .enumerate()
+                .for_each_init(|| GlobalPodBuffer::new(requirement), bootstrap),
+        }
+    })
+}
+
+// Bytes of fourier bootstrap key expanded from its compact form at once, small enough to
+// stay in the L2 cache while blind rotated with
+const COMPACT_BSK_TILE_BYTES: usize = 256 * 1024;
+
+// Number of ggsw ciphertexts of a fourier bootstrap key expanded at once from its compact
+// form, and the size of one in complex coefficients
+fn compact_bsk_tile(
+    decomposition_level_count: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+) -> (usize, usize) {
+    let ggsw_size = fourier_ggsw_ciphertext_size(
+        GlweDimension(glwe_dimension).to_glwe_size(),
+        PolynomialSize(polynomial_size).to_fourier_polynomial_size(),
+        DecompositionLevelCount(decomposition_level_count),
+    );
+    let ggsws = (COMPACT_BSK_TILE_BYTES / (ggsw_size * core::mem::size_of::<c64>())).max(1);
+    (ggsws, ggsw_size)
+}
+
+#[no_mangle]
+#[must_use]
+pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_compact_u64_scratch(
+    stack_size: *mut usize,
+    stack_align: *mut usize,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    // side resources
+    fft: *const Fft,
+) -> ScratchStatus {
+    nounwind(|| {
+        let (ggsws, ggsw_size) =
+            compact_bsk_tile(decomposition_level_count, glwe_dimension, polynomial_size);
+        let scratch = programmable_bootstrap_lwe_ciphertext_mem_optimized_requirement::<u64>(
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            (*fft).as_view(),
+        )
+        .and_then(|bootstrap| {
+            StackReq::try_all_of([
+                bootstrap,
+                StackReq::try_new_aligned::<c64>(ggsws * ggsw_size, CACHELINE_ALIGN)?,
+                StackReq::try_new_aligned::<u64>(ggsws + 1, CACHELINE_ALIGN)?,
+            ])
+        });
+        if let Ok(scratch) = scratch {
+            *stack_size = scratch.size_bytes();
+            *stack_align = scratch.align_bytes();
+            ScratchStatus::Valid
+        } else {
+            ScratchStatus::SizeOverflow
+        }
+    })
+}
+
+// Bootstraps with a fourier bootstrap key stored compactly, each complex coefficient as two
+// f32. The key is expanded a tile of ggsw ciphertexts at a time in the scratch, the blind
+// rotation of the tile reading it from the cache, so that only half of the bytes of a full
+// precision key are read from memory.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_compact_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    // compact bootstrap key
+    compact_fourier_bsk: *const f32,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        let output_lwe_dimension = glwe_dimension * polynomial_size;
+        let (ggsws, ggsw_size) =
+            compact_bsk_tile(decomposition_level_count, glwe_dimension, polynomial_size);
+
+        let compact = slice::from_raw_parts(
+            compact_fourier_bsk,
+            2 * concrete_cpu_fourier_bootstrap_key_size_u64(
+                decomposition_level_count,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+            ),
+        );
+        let ct_in = slice::from_raw_parts(ct_in, input_lwe_dimension + 1);
+        let mut lwe_out = LweCiphertext::from_container(
+            slice::from_raw_parts_mut(ct_out, output_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+        let accumulator = slice::from_raw_parts(
+            accumulator,
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+        );
+        let fft = (*fft).as_view();
+
+        let stack = PodStack::new(slice::from_raw_parts_mut(stack as _, stack_size));
+        let (local_accumulator_data, stack) =
+            stack.collect_aligned(CACHELINE_ALIGN, accumulator.iter().copied());
+        let mut local_accumulator = GlweCiphertext::from_container(
+            &mut *local_accumulator_data,
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+        let (tile_bsk, stack) = stack.make_aligned_raw::<c64>(ggsws * ggsw_size, CACHELINE_ALIGN);
+        let (tile_lwe, mut stack) = stack.make_aligned_raw::<u64>(ggsws + 1, CACHELINE_ALIGN);
+
+        // The blind rotation of a tile is that of the part of the input mask it multiplies,
+        // with a body rotating the accumulator only for the first tile. The rotations by
+        // monomials commute, so the successive tiles add up to the full blind rotation.
+        for first in (0..input_lwe_dimension).step_by(ggsws) {
+            let last = (first + ggsws).min(input_lwe_dimension);
+            let dimension = last - first;
+
+            let tile_bsk = &mut tile_bsk[..dimension * ggsw_size];
+            for (coefficient, compact) in tile_bsk
+                .iter_mut()
+                .zip(compact[2 * first * ggsw_size..2 * last * ggsw_size].chunks_exact(2))
+            {
+                *coefficient = c64::new(compact[0] as f64, compact[1] as f64);
+            }
+            let tile_lwe = &mut tile_lwe[..dimension + 1];
+            tile_lwe[..dimension].copy_from_slice(&ct_in[first..last]);
+            tile_lwe[dimension] = if first == 0 {
+                ct_in[input_lwe_dimension]
+            } else {
+                0
+            };
+
+            let fourier = FourierLweBootstrapKey::from_container(
+                &*tile_bsk,
+                LweDimension(dimension),
+                GlweDimension(glwe_dimension).to_glwe_size(),
+                PolynomialSize(polynomial_size),
+                DecompositionBaseLog(decomposition_base_log),
+                DecompositionLevelCount(decomposition_level_count),
+            );
+            blind_rotate_assign_mem_optimized(
+                &LweCiphertext::from_container(&*tile_lwe, CiphertextModulus::new_native()),
+                &mut local_accumulator,
+                &fourier,
+                fft,
+                stack.rb_mut(),
+            );
+        }
+
+        extract_lwe_sample_from_glwe_ciphertext(
+            &local_accumulator,
+            &mut lwe_out,
+            MonomialDegree(0),
+        );
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_many_lut_u64(
+    // ciphertexts
+    ct_out_vec: *mut u64,
+    ct_in: *const u64,
+    // accumulator packing `lut_count` lookup tables, `lut_stride` coefficients apart
+    accumulator: *const u64,
+    lut_count: usize,
+    lut_stride: usize,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        let output_lwe_size = glwe_dimension * polynomial_size + 1;
+
+        assert!(lut_count >= 1);
+        assert!((lut_count - 1) * lut_stride < polynomial_size);
+
+        let fourier = FourierLweBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_bsk,
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+
+        let lwe_in = LweCiphertext::from_container(
+            slice::from_raw_parts(ct_in, input_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let accumulator = slice::from_raw_parts(
+            accumulator,
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+        );
+
+        // The scratch of a regular bootstrap already accounts for the local copy of the
+        // accumulator followed by the blind rotation.
+        let stack = PodStack::new(slice::from_raw_parts_mut(stack as _, stack_size));
+        let (local_accumulator_data, stack) =
+            stack.collect_aligned(CACHELINE_ALIGN, accumulator.iter().copied());
+        let mut local_accumulator = GlweCiphertext::from_container(
+            &mut *local_accumulator_data,
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        // A single blind rotation brings all the packed lookup tables in front of the
+        // accumulator, each one is then extracted at its own offset.
+        blind_rotate_assign_mem_optimized(
+            &lwe_in,
+            &mut local_accumulator,
+            &fourier,
+            (*fft).as_view(),
+            stack,
+        );
+
+        for (lut_idx, ct_out) in slice::from_raw_parts_mut(ct_out_vec, lut_count * output_lwe_size)
+            .chunks_exact_mut(output_lwe_size)
+            .enumerate()
+        {
+            let mut lwe_out =
+                LweCiphertext::from_container(ct_out, CiphertextModulus::new_native());
+            extract_lwe_sample_from_glwe_ciphertext(
+                &local_accumulator,
+                &mut lwe_out,
+                MonomialDegree(lut_idx * lut_stride),
+            );
+        }
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_bootstrap_key_size_u64(
     decomposition_level_count: usize,
@@ -457,3 +818,371 @@ pub unsafe extern "C" fn concrete_cpu_seeded_bootstrap_key_size_u64(
             DecompositionLevelCount(decomposition_level_count),
         )
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // Not a multiple of the tiles of the compact bootstrap, whose last tile is partial
+    const LWE_DIMENSION: usize = 601;
+    const GLWE_DIMENSION: usize = 1;
+    const POLYNOMIAL_SIZE: usize = 1024;
+    // A small decomposition base, so that the bootstraps with the single precision key are
+    // exact as well
+    const LEVEL_COUNT: usize = 4;
+    const BASE_LOG: usize = 5;
+
+    // Keys with a small noise, so that the bootstraps are exact
+    struct Keys {
+        lwe_sk: LweSecretKeyOwned<u64>,
+        glwe_sk: GlweSecretKeyOwned<u64>,
+        fourier_bsk: FourierLweBootstrapKeyOwned,
+        fft: Fft,
+        encryption: EncryptionRandomGenerator<DynamicRandomGenerator>,
+    }
+
+    impl Keys {
+        fn new() -> Self {
+            let mut secret = SecretRandomGenerator::<DynamicRandomGenerator>::new(Seed(0));
+            let mut encryption = EncryptionRandomGenerator::new(Seed(1), new_dyn_seeder().as_mut());
+            let lwe_sk = allocate_and_generate_new_binary_lwe_secret_key(
+                LweDimension(LWE_DIMENSION),
+                &mut secret,
+            );
+            let glwe_sk = allocate_and_generate_new_binary_glwe_secret_key(
+                GlweDimension(GLWE_DIMENSION),
+                PolynomialSize(POLYNOMIAL_SIZE),
+                &mut secret,
+            );
+            let bsk = allocate_and_generate_new_lwe_bootstrap_key(
+                &lwe_sk,
+                &glwe_sk,
+                DecompositionBaseLog(BASE_LOG),
+                DecompositionLevelCount(LEVEL_COUNT),
+                Self::noise(),
+                CiphertextModulus::new_native(),
+                &mut encryption,
+            );
+            let mut fourier_bsk = FourierLweBootstrapKey::new(
+                bsk.input_lwe_dimension(),
+                bsk.glwe_size(),
+                bsk.polynomial_size(),
+                bsk.decomposition_base_log(),
+                bsk.decomposition_level_count(),
+            );
+            convert_standard_lwe_bootstrap_key_to_fourier(&bsk, &mut fourier_bsk);
+            Self {
+                lwe_sk,
+                glwe_sk,
+                fourier_bsk,
+                fft: Fft::new(PolynomialSize(POLYNOMIAL_SIZE)),
+                encryption,
+            }
+        }
+
+        fn noise() -> Gaussian<f64> {
+            Gaussian::from_dispersion_parameter(Variance::from_variance(2f64.powi(-80)), 0.0)
+        }
+
+        // Encrypts `message` of `bits` bits, with a padding bit, under the input key
+        fn encrypt(&mut self, message: u64, bits: u32) -> Vec<u64> {
+            allocate_and_encrypt_new_lwe_ciphertext(
+                &self.lwe_sk,
+                Plaintext(message << (63 - bits)),
+                Self::noise(),
+                CiphertextModulus::new_native(),
+                &mut self.encryption,
+            )
+            .into_container()
+        }
+
+        // Decrypts a message of `bits` bits, with a padding bit, under the output key
+        fn decrypt(&self, ct: &[u64], bits: u32) -> u64 {
+            let lwe_sk = self.glwe_sk.as_lwe_secret_key();
+            let ct = LweCiphertext::from_container(ct, CiphertextModulus::new_native());
+            let plaintext = decrypt_lwe_ciphertext(&lwe_sk, &ct).0;
+            (plaintext.wrapping_add(1 << (62 - bits)) >> (63 - bits)) % (1 << bits)
+        }
+
+        fn bootstrap_scratch(&self) -> Vec<u8> {
+            let mut stack_size = 0;
+            let mut stack_align = 0;
+            unsafe {
+                assert!(matches!(
+                    concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+                        &mut stack_size,
+                        &mut stack_align,
+                        GLWE_DIMENSION,
+                        POLYNOMIAL_SIZE,
+                        &self.fft,
+                    ),
+                    ScratchStatus::Valid
+                ));
+            }
+            // Over-allocate so that the scratch can be aligned by the callee
+            vec![0; stack_size + stack_align]
+        }
+    }
+
+    // Trivial accumulator of the lookup table `table` of `bits` bits output values, each
+    // value filling a box of `POLYNOMIAL_SIZE / table.len()` coefficients
+    fn accumulator(table: &[u64], bits: u32) -> Vec<u64> {
+        let box_size = POLYNOMIAL_SIZE / table.len();
+        let encode = |v: u64| v << (63 - bits);
+        let mut body = vec![0u64; POLYNOMIAL_SIZE];
+        for (i, coefficient) in body.iter_mut().enumerate() {
+            // The first box is centered over zero, its upper half being negated at the end
+            let shifted = i + box_size / 2;
+            *coefficient = if shifted / box_size < table.len() {
+                encode(table[shifted / box_size])
+            } else {
+                encode(table[0]).wrapping_neg()
+            };
+        }
+        let mut accumulator = vec![0u64; GLWE_DIMENSION * POLYNOMIAL_SIZE];
+        accumulator.extend(body);
+        accumulator
+    }
+
+    fn bootstrap(keys: &Keys, ct: &[u64], accumulator: &[u64]) -> Vec<u64> {
+        let mut out = vec![0u64; GLWE_DIMENSION * POLYNOMIAL_SIZE + 1];
+        let mut scratch = keys.bootstrap_scratch();
+        unsafe {
+            concrete_cpu_bootstrap_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                ct.as_ptr(),
+                accumulator.as_ptr(),
+                keys.fourier_bsk.as_view().data().as_ptr(),
+                LEVEL_COUNT,
+                BASE_LOG,
+                GLWE_DIMENSION,
+                POLYNOMIAL_SIZE,
+                LWE_DIMENSION,
+                &keys.fft,
+                scratch.as_mut_ptr(),
+                scratch.len(),
+            );
+        }
+        out
+    }
+
+    fn batched_bootstrap(
+        keys: &Keys,
+        cts: &[u64],
+        accumulators: &[u64],
+        accumulator_stride: usize,
+        parallelism: Parallelism,
+    ) -> Vec<u64> {
+        let count = cts.len() / (LWE_DIMENSION + 1);
+        let mut out = vec![0u64; count * (GLWE_DIMENSION * POLYNOMIAL_SIZE + 1)];
+        unsafe {
+            concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                cts.as_ptr(),
+                count,
+                accumulators.as_ptr(),
+                accumulator_stride,
+                keys.fourier_bsk.as_view().data().as_ptr(),
+                LEVEL_COUNT,
+                BASE_LOG,
+                GLWE_DIMENSION,
+                POLYNOMIAL_SIZE,
+                LWE_DIMENSION,
+                &keys.fft,
+                parallelism,
+            );
+        }
+        out
+    }
+
+    fn compact_bootstrap(keys: &Keys, ct: &[u64], accumulator: &[u64]) -> Vec<u64> {
+        let compact: Vec<f32> = keys
+            .fourier_bsk
+            .as_view()
+            .data()
+            .iter()
+            .flat_map(|coefficient| [coefficient.re as f32, coefficient.im as f32])
+            .collect();
+        let mut stack_size = 0;
+        let mut stack_align = 0;
+        let mut out = vec![0u64; GLWE_DIMENSION * POLYNOMIAL_SIZE + 1];
+        unsafe {
+            assert!(matches!(
+                concrete_cpu_bootstrap_lwe_ciphertext_compact_u64_scratch(
+                    &mut stack_size,
+                    &mut stack_align,
+                    LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    &keys.fft,
+                ),
+                ScratchStatus::Valid
+            ));
+            let mut scratch = vec![0u8; stack_size + stack_align];
+            concrete_cpu_bootstrap_lwe_ciphertext_compact_u64(
+                out.as_mut_ptr(),
+                ct.as_ptr(),
+                accumulator.as_ptr(),
+                compact.as_ptr(),
+                LEVEL_COUNT,
+                BASE_LOG,
+                GLWE_DIMENSION,
+                POLYNOMIAL_SIZE,
+                LWE_DIMENSION,
+                &keys.fft,
+                scratch.as_mut_ptr(),
+                scratch.len(),
+            );
+        }
+        out
+    }
+
+    fn many_lut_bootstrap(
+        keys: &Keys,
+        ct: &[u64],
+        accumulator: &[u64],
+        lut_count: usize,
+        lut_stride: usize,
+    ) -> Vec<u64> {
+        let mut out = vec![0u64; lut_count * (GLWE_DIMENSION * POLYNOMIAL_SIZE + 1)];
+        let mut scratch = keys.bootstrap_scratch();
+        unsafe {
+            concrete_cpu_bootstrap_lwe_ciphertext_many_lut_u64(
+                out.as_mut_ptr(),
+                ct.as_ptr(),
+                accumulator.as_ptr(),
+                lut_count,
+                lut_stride,
+                keys.fourier_bsk.as_view().data().as_ptr(),
+                LEVEL_COUNT,
+                BASE_LOG,
+                GLWE_DIMENSION,
+                POLYNOMIAL_SIZE,
+                LWE_DIMENSION,
+                &keys.fft,
+                scratch.as_mut_ptr(),
+                scratch.len(),
+            );
+        }
+        out
+    }
+
+    #[test]
+    fn test_many_lut_bootstrap() {
+        let mut keys = Keys::new();
+        let bits = 2;
+        let functions: [fn(u64) -> u64; 2] = [|m| (m + 1) % 4, |m| (3 * m) % 4];
+        let lut_count = functions.len();
+
+        // The tables are interleaved, the `j`-th function being evaluated in the `j`-th
+        // sub-box of each message
+        let table: Vec<u64> = (0..1 << bits)
+            .flat_map(|m| functions.iter().map(move |f| f(m)))
+            .collect();
+        let accumulator = accumulator(&table, bits);
+        let lut_stride = POLYNOMIAL_SIZE / table.len();
+
+        for message in 0..1 << bits {
+            let ct = keys.encrypt(message, bits);
+            let out = many_lut_bootstrap(&keys, &ct, &accumulator, lut_count, lut_stride);
+            for (f, ct_out) in functions
+                .iter()
+                .zip(out.chunks_exact(GLWE_DIMENSION * POLYNOMIAL_SIZE + 1))
+            {
+                assert_eq!(keys.decrypt(ct_out, bits), f(message));
+            }
+        }
+    }
+
+    #[test]
+    fn test_many_lut_bootstrap_single_lut() {
+        let mut keys = Keys::new();
+        let bits = 3;
+        let table: Vec<u64> = (0..1 << bits).map(|m| (m * m) % 8).collect();
+        let accumulator = accumulator(&table, bits);
+
+        // A single lookup table is exactly a regular bootstrap
+        for message in 0..1 << bits {
+            let ct = keys.encrypt(message, bits);
+            let expected = bootstrap(&keys, &ct, &accumulator);
+            assert_eq!(many_lut_bootstrap(&keys, &ct, &accumulator, 1, 0), expected);
+            assert_eq!(keys.decrypt(&expected, bits), table[message as usize]);
+        }
+    }
+
+    #[test]
+    fn test_batched_bootstrap() {
+        let mut keys = Keys::new();
+        let bits = 3;
+        let tables: Vec<Vec<u64>> = (0..3)
+            .map(|t| (0..1 << bits).map(|m| (m * (t + 1) + t) % 8).collect())
+            .collect();
+        let messages: Vec<u64> = (0..6).map(|i| (i * 5) % 8).collect();
+        let cts: Vec<u64> = messages
+            .iter()
+            .flat_map(|&message| keys.encrypt(message, bits))
+            .collect();
+        let output_size = GLWE_DIMENSION * POLYNOMIAL_SIZE + 1;
+        let accumulator_size = (GLWE_DIMENSION + 1) * POLYNOMIAL_SIZE;
+
+        // A null stride bootstraps all the ciphertexts with the same accumulator, otherwise
+        // each ciphertext has its own. Either way, the batch is exactly the bootstraps of its
+        // ciphertexts one by one.
+        let shared = accumulator(&tables[0], bits);
+        let accumulators: Vec<u64> = (0..messages.len())
+            .flat_map(|i| accumulator(&tables[i % tables.len()], bits))
+            .collect();
+        for (accumulators, accumulator_stride) in [(&shared, 0), (&accumulators, accumulator_size)]
+        {
+            let expected: Vec<u64> = cts
+                .chunks_exact(LWE_DIMENSION + 1)
+                .enumerate()
+                .flat_map(|(i, ct)| {
+                    let offset = i * accumulator_stride;
+                    bootstrap(&keys, ct, &accumulators[offset..offset + accumulator_size])
+                })
+                .collect();
+            for parallelism in [Parallelism::No, Parallelism::Rayon] {
+                assert_eq!(
+                    batched_bootstrap(&keys, &cts, accumulators, accumulator_stride, parallelism),
+                    expected
+                );
+            }
+            for (i, ct_out) in expected.chunks_exact(output_size).enumerate() {
+                let table = if accumulator_stride == 0 {
+                    &tables[0]
+                } else {
+                    &tables[i % tables.len()]
+                };
+                assert_eq!(keys.decrypt(ct_out, bits), table[messages[i] as usize]);
+            }
+        }
+    }
+
+    #[test]
+    fn test_compact_bootstrap() {
+        let mut keys = Keys::new();
+        let bits = 3;
+        let table: Vec<u64> = (0..1 << bits).map(|m| (5 * m + 3) % 8).collect();
+        let accumulator = accumulator(&table, bits);
+
+        // The blind rotations of the tiles of the single precision key add up to that of the
+        // full key, up to the rounding of the key, which only adds a small noise
+        let max_error = 1u64 << (63 - bits - 4);
+        for message in 0..1 << bits {
+            let ct = keys.encrypt(message, bits);
+            let expected = bootstrap(&keys, &ct, &accumulator);
+            let compact = compact_bootstrap(&keys, &ct, &accumulator);
+            assert_eq!(keys.decrypt(&compact, bits), table[message as usize]);
+            assert_eq!(keys.decrypt(&expected, bits), table[message as usize]);
+
+            let lwe_sk = keys.glwe_sk.as_lwe_secret_key();
+            let decrypt = |ct: &[u64]| {
+                let ct = LweCiphertext::from_container(ct, CiphertextModulus::new_native());
+                decrypt_lwe_ciphertext(&lwe_sk, &ct).0
+            };
+            let error = decrypt(&compact).wrapping_sub(decrypt(&expected));
+            assert!(error.min(error.wrapping_neg()) < max_error);
+        }
+    }
+}
@@ -1,11 +1,19 @@
 use std::io::Read;
+use std::sync::atomic::{AtomicU32, Ordering};
 
-use super::types::{Csprng, EncCsprng, SecCsprng, Uint128};
-use concrete_csprng::generators::SoftwareRandomGenerator;
+use super::types::{Csprng, CsprngBackend, EncCsprng, SecCsprng, Uint128};
+use concrete_csprng::generators::{
+    ByteCount, BytesPerChild, ChildrenCount, ForkError, ParallelRandomGenerator,
+    RandomGenerator as ByteRandomGenerator, SoftwareRandomGenerator,
+};
 use concrete_csprng::seeders::Seed;
 use libc::c_int;
+use rayon::iter::{Either, Map, ParallelIterator};
 use tfhe::core_crypto::commons::math::random::RandomGenerator;
-use tfhe::core_crypto::prelude::{EncryptionRandomGenerator, SecretRandomGenerator};
+use tfhe::core_crypto::prelude::{
+    encrypt_lwe_ciphertext, CiphertextModulus, EncryptionRandomGenerator, Gaussian, LweCiphertext,
+    LweDimension, LweSecretKey, LweSize, Plaintext, SecretRandomGenerator, Variance,
+};
 use tfhe::core_crypto::seeders::Seeder;
 
 pub struct DynamicSeeder;
@@ -30,67 +38,301 @@ pub fn new_dyn_seeder() -> Box<dyn Seeder> {
     Box::new(DynamicSeeder)
 }
 
+// The generator using the AES instructions of the cpu, if any. All the
+// backends implement the same AES-CTR stream, so the masks generated by one can
+// be decompressed by another.
+#[cfg(target_arch = "x86_64")]
+type HardwareRandomGenerator = concrete_csprng::generators::AesniRandomGenerator;
+#[cfg(target_arch = "x86_64")]
+const HARDWARE_BACKEND: CsprngBackend = CsprngBackend::AesNi;
+
+#[cfg(target_arch = "aarch64")]
+type HardwareRandomGenerator = concrete_csprng::generators::NeonAesRandomGenerator;
+#[cfg(target_arch = "aarch64")]
+const HARDWARE_BACKEND: CsprngBackend = CsprngBackend::ArmAes;
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+type HardwareRandomGenerator = SoftwareRandomGenerator;
+#[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+const HARDWARE_BACKEND: CsprngBackend = CsprngBackend::Software;
+
+fn is_hardware_backend_available() -> bool {
+    #[cfg(target_arch = "x86_64")]
+    {
+        is_x86_feature_detected!("aes") && is_x86_feature_detected!("sse2")
+    }
+    #[cfg(target_arch = "aarch64")]
+    {
+        std::arch::is_aarch64_feature_detected!("aes")
+            && std::arch::is_aarch64_feature_detected!("neon")
+    }
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    {
+        false
+    }
+}
+
+fn is_backend_available(backend: CsprngBackend) -> bool {
+    backend == CsprngBackend::Software
+        || (backend == HARDWARE_BACKEND && is_hardware_backend_available())
+}
+
+const UNSELECTED_BACKEND: u32 = u32::MAX;
+
+static ACTIVE_BACKEND: AtomicU32 = AtomicU32::new(UNSELECTED_BACKEND);
+
+// The backend of the generators constructed from now on. It is selected on
+// first use as the hardware one if available, unless overridden with the
+// `CONCRETE_CSPRNG_BACKEND` environment variable (`software`, `aesni` or
+// `armaes`) or with `concrete_cpu_set_csprng_backend`.
+fn active_backend() -> CsprngBackend {
+    match ACTIVE_BACKEND.load(Ordering::Relaxed) {
+        0 => CsprngBackend::Software,
+        1 => CsprngBackend::AesNi,
+        2 => CsprngBackend::ArmAes,
+        _ => {
+            let requested = match std::env::var("CONCRETE_CSPRNG_BACKEND").as_deref() {
+                Ok("software") => Some(CsprngBackend::Software),
+                Ok("aesni") => Some(CsprngBackend::AesNi),
+                Ok("armaes") => Some(CsprngBackend::ArmAes),
+                _ => None,
+            };
+            let backend = match requested {
+                Some(backend) if is_backend_available(backend) => backend,
+                _ if is_hardware_backend_available() => HARDWARE_BACKEND,
+                _ => CsprngBackend::Software,
+            };
+            // Another thread may have selected one in the meantime
+            match ACTIVE_BACKEND.compare_exchange(
+                UNSELECTED_BACKEND,
+                backend as u32,
+                Ordering::Relaxed,
+                Ordering::Relaxed,
+            ) {
+                Ok(_) => backend,
+                Err(_) => active_backend(),
+            }
+        }
+    }
+}
+
+// The byte generator of all the csprngs of this crate, implemented with the
+// backend active when it was constructed. Its children use the same backend.
+pub enum DynamicRandomGenerator {
+    Software(SoftwareRandomGenerator),
+    Hardware(HardwareRandomGenerator),
+}
+
+impl DynamicRandomGenerator {
+    pub fn backend(&self) -> CsprngBackend {
+        match self {
+            Self::Software(_) => CsprngBackend::Software,
+            Self::Hardware(_) => HARDWARE_BACKEND,
+        }
+    }
+}
+
+impl Iterator for DynamicRandomGenerator {
+    type Item = u8;
+
+    #[inline]
+    fn next(&mut self) -> Option<u8> {
+        match self {
+            Self::Software(generator) => generator.next(),
+            Self::Hardware(generator) => generator.next(),
+        }
+    }
+}
+
+pub enum DynamicChildrenIterator {
+    Software(<SoftwareRandomGenerator as ByteRandomGenerator>::ChildrenIter),
+    Hardware(<HardwareRandomGenerator as ByteRandomGenerator>::ChildrenIter),
+}
+
+impl Iterator for DynamicChildrenIterator {
+    type Item = DynamicRandomGenerator;
+
+    fn next(&mut self) -> Option<DynamicRandomGenerator> {
+        match self {
+            Self::Software(children) => children.next().map(DynamicRandomGenerator::Software),
+            Self::Hardware(children) => children.next().map(DynamicRandomGenerator::Hardware),
+        }
+    }
+}
+
+impl ByteRandomGenerator for DynamicRandomGenerator {
+    type ChildrenIter = DynamicChildrenIterator;
+
+    fn new(seed: Seed) -> Self {
+        match active_backend() {
+            CsprngBackend::Software => Self::Software(SoftwareRandomGenerator::new(seed)),
+            _ => Self::Hardware(HardwareRandomGenerator::new(seed)),
+        }
+    }
+
+    fn remaining_bytes(&self) -> ByteCount {
+        match self {
+            Self::Software(generator) => generator.remaining_bytes(),
+            Self::Hardware(generator) => generator.remaining_bytes(),
+        }
+    }
+
+    fn try_fork(
+        &mut self,
+        n_children: ChildrenCount,
+        n_bytes: BytesPerChild,
+    ) -> Result<Self::ChildrenIter, ForkError> {
+        match self {
+            Self::Software(generator) => generator
+                .try_fork(n_children, n_bytes)
+                .map(DynamicChildrenIterator::Software),
+            Self::Hardware(generator) => generator
+                .try_fork(n_children, n_bytes)
+                .map(DynamicChildrenIterator::Hardware),
+        }
+    }
+}
+
+type ParChildren<G> =
+    Map<<G as ParallelRandomGenerator>::ParChildrenIter, fn(G) -> DynamicRandomGenerator>;
+
+impl ParallelRandomGenerator for DynamicRandomGenerator {
+    type ParChildrenIter =
+        Either<ParChildren<DynamicRandomGenerator>, ParChildren<HardwareRandomGenerator>>;
+
+    fn par_try_fork(
+        &mut self,
+        n_children: ChildrenCount,
+        n_bytes: BytesPerChild,
+    ) -> Result<Self::ParChildrenIter, ForkError> {
+        match self {
+            Self::Software(generator) => {
+                generator.par_try_fork(n_children, n_bytes).map(|children| {
+                    Either::Left(children.map(DynamicRandomGenerator::Software as fn(_) -> _))
+                })
+            }
+            Self::Hardware(generator) => {
+                generator.par_try_fork(n_children, n_bytes).map(|children| {
+                    Either::Right(children.map(DynamicRandomGenerator::Hardware as fn(_) -> _))
+                })
+            }
+        }
+    }
+}
+
+// Select the backend of the csprngs constructed from now on, the ones already
+// constructed keep theirs. Returns 1 if selected, 0 if it is not available on
+// this cpu.
 #[no_mangle]
-pub static CSPRNG_SIZE: usize = core::mem::size_of::<RandomGenerator<SoftwareRandomGenerator>>();
+pub unsafe extern "C" fn concrete_cpu_set_csprng_backend(backend: CsprngBackend) -> c_int {
+    if !is_backend_available(backend) {
+        return 0;
+    }
+    ACTIVE_BACKEND.store(backend as u32, Ordering::Relaxed);
+    1
+}
+
+// Returns the backend of the csprngs constructed from now on.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_get_csprng_backend() -> CsprngBackend {
+    active_backend()
+}
+
+// Returns true if `backend` can be selected on this cpu.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_is_csprng_backend_available(backend: CsprngBackend) -> bool {
+    is_backend_available(backend)
+}
+
+#[no_mangle]
+pub static CSPRNG_SIZE: usize = core::mem::size_of::<RandomGenerator<DynamicRandomGenerator>>();
 
 #[no_mangle]
-pub static CSPRNG_ALIGN: usize = core::mem::align_of::<RandomGenerator<SoftwareRandomGenerator>>();
+pub static CSPRNG_ALIGN: usize = core::mem::align_of::<RandomGenerator<DynamicRandomGenerator>>();
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_construct_csprng(mem: *mut Csprng, seed: Uint128) {
-    let mem = mem as *mut RandomGenerator<SoftwareRandomGenerator>;
+    let mem = mem as *mut RandomGenerator<DynamicRandomGenerator>;
     let seed = Seed(u128::from_le_bytes(seed.little_endian_bytes));
     mem.write(RandomGenerator::new(seed));
 }
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_destroy_csprng(mem: *mut Csprng) {
-    core::ptr::drop_in_place(mem as *mut RandomGenerator<SoftwareRandomGenerator>);
+    core::ptr::drop_in_place(mem as *mut RandomGenerator<DynamicRandomGenerator>);
 }
 
 #[no_mangle]
 pub static SECRET_CSPRNG_SIZE: usize =
-    core::mem::size_of::<SecretRandomGenerator<SoftwareRandomGenerator>>();
+    core::mem::size_of::<SecretRandomGenerator<DynamicRandomGenerator>>();
 
 #[no_mangle]
 pub static SECRET_CSPRNG_ALIGN: usize =
-    core::mem::align_of::<SecretRandomGenerator<SoftwareRandomGenerator>>();
+    core::mem::align_of::<SecretRandomGenerator<DynamicRandomGenerator>>();
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_construct_secret_csprng(mem: *mut SecCsprng, seed: Uint128) {
-    let mem = mem as *mut SecretRandomGenerator<SoftwareRandomGenerator>;
+    let mem = mem as *mut SecretRandomGenerator<DynamicRandomGenerator>;
     let seed = Seed(u128::from_le_bytes(seed.little_endian_bytes));
     mem.write(SecretRandomGenerator::new(seed));
 }
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_destroy_secret_csprng(mem: *mut SecCsprng) {
-    core::ptr::drop_in_place(mem as *mut SecretRandomGenerator<SoftwareRandomGenerator>);
+    core::ptr::drop_in_place(mem as *mut SecretRandomGenerator<DynamicRandomGenerator>);
 }
 
 #[no_mangle]
 pub static ENCRYPTION_CSPRNG_SIZE: usize =
-    core::mem::size_of::<EncryptionRandomGenerator<SoftwareRandomGenerator>>();
+    core::mem::size_of::<EncryptionRandomGenerator<DynamicRandomGenerator>>();
 
 #[no_mangle]
 pub static ENCRYPTION_CSPRNG_ALIGN: usize =
-    core::mem::align_of::<EncryptionRandomGenerator<SoftwareRandomGenerator>>();
+    core::mem::align_of::<EncryptionRandomGenerator<DynamicRandomGenerator>>();
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_construct_encryption_csprng(
     mem: *mut EncCsprng,
     seed: Uint128,
 ) {
-    let mem = mem as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>;
+    let mem = mem as *mut EncryptionRandomGenerator<DynamicRandomGenerator>;
     let seed = Seed(u128::from_le_bytes(seed.little_endian_bytes));
     let mut boxed_seeder = new_dyn_seeder();
     let seeder = boxed_seeder.as_mut();
     mem.write(EncryptionRandomGenerator::new(seed, seeder));
 }
 
+// Construct in `mem` a generator seeded from the mask stream of `parent`. The
+// generators forked in sequence from a parent depend only on its seed, so they
+// can then be used concurrently and still produce the same masks.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_fork_encryption_csprng(
+    mem: *mut EncCsprng,
+    parent: *mut EncCsprng,
+) {
+    let parent = &mut *(parent as *mut EncryptionRandomGenerator<DynamicRandomGenerator>);
+    // The mask of a ciphertext is drawn uniformly from the mask stream, the
+    // 128 bits of a 2 dimensional mask are the seed of the child.
+    let key = LweSecretKey::new_empty_key(0u64, LweDimension(2));
+    let mut ct = LweCiphertext::new(0u64, LweSize(3), CiphertextModulus::new_native());
+    encrypt_lwe_ciphertext(
+        &key,
+        &mut ct,
+        Plaintext(0),
+        Gaussian::from_dispersion_parameter(Variance::from_variance(0.0), 0.0),
+        parent,
+    );
+    let mask = ct.get_mask();
+    let seed = Seed(mask.as_ref()[0] as u128 | (mask.as_ref()[1] as u128) << 64);
+    let mem = mem as *mut EncryptionRandomGenerator<DynamicRandomGenerator>;
+    let mut boxed_seeder = new_dyn_seeder();
+    let seeder = boxed_seeder.as_mut();
+    mem.write(EncryptionRandomGenerator::new(seed, seeder));
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_destroy_encryption_csprng(mem: *mut EncCsprng) {
-    core::ptr::drop_in_place(mem as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>);
+    core::ptr::drop_in_place(mem as *mut EncryptionRandomGenerator<DynamicRandomGenerator>);
 }
 
 // Randomly fill a uint128.
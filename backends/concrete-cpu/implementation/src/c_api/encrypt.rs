@@ -1,5 +1,5 @@
+use crate::c_api::csprng::DynamicRandomGenerator;
 use crate::c_api::types::Csprng;
-use concrete_csprng::generators::SoftwareRandomGenerator;
 use std::slice;
 use tfhe::core_crypto::commons::math::random::RandomGenerator;
 
@@ -12,7 +12,7 @@ pub unsafe extern "C" fn concrete_cpu_fill_with_random_gaussian(
 ) {
     unsafe {
         let buff: &mut [u64] = slice::from_raw_parts_mut(buffer, size);
-        let csprng = &mut *(csprng as *mut RandomGenerator<SoftwareRandomGenerator>);
+        let csprng = &mut *(csprng as *mut RandomGenerator<DynamicRandomGenerator>);
         csprng.fill_slice_with_random_gaussian(buff, 0.0, variance)
     }
 }
@@ -1,3 +1,4 @@
+use super::types::FftBackend;
 use tfhe::core_crypto::commons::parameters::PolynomialSize;
 
 type FftImpl = tfhe::core_crypto::fft_impl::fft64::math::fft::Fft;
@@ -25,3 +26,20 @@ pub unsafe extern "C" fn concrete_cpu_construct_concrete_fft(
 pub unsafe extern "C" fn concrete_cpu_destroy_concrete_fft(mem: *mut Fft) {
     core::ptr::drop_in_place(mem);
 }
+
+// Returns the kernels the FFTs run on, chosen by concrete-fft when the plans are
+// created as the widest ones both built in this crate and supported by this cpu: the
+// AVX-512 ones are only built with the `nightly` feature, and there are no SIMD ones
+// outside of x86_64.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_get_fft_backend() -> FftBackend {
+    #[cfg(all(target_arch = "x86_64", feature = "nightly"))]
+    if pulp::x86::V4::try_new().is_some() {
+        return FftBackend::Avx512;
+    }
+    #[cfg(target_arch = "x86_64")]
+    if pulp::x86::V3::try_new().is_some() {
+        return FftBackend::Avx2;
+    }
+    FftBackend::Scalar
+}
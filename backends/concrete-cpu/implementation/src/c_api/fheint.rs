@@ -1,5 +1,6 @@
 use super::utils::nounwind;
 use core::slice;
+use rayon::prelude::*;
 use tfhe::core_crypto::prelude::*;
 use tfhe::integer::ciphertext::Expandable;
 use tfhe::integer::IntegerCiphertext;
@@ -182,11 +183,15 @@ unsafe fn tfhers_uint8_to_lwe_array(
 unsafe fn tfhers_uint8_array_to_lwe_array(
     buffer: *const u8,
     buffer_len: usize,
-    mut lwe_vec_buffer: *mut u64,
+    lwe_vec_buffer: *mut u64,
+    n_elem: usize,
     desc: TfhersFheIntDescription,
 ) -> i64 {
     nounwind(|| {
         let fheuint_array: Vec<FheUint8> = super::utils::unsafe_deserialize(buffer, buffer_len);
+        if fheuint_array.len() != n_elem {
+            return 1;
+        }
         // TODO - Use conformance check
         let fheuint_desc = tfhers_uint8_description(fheuint_array[0].clone());
         if !fheuint_desc.is_similar(&desc) {
@@ -196,20 +201,19 @@ unsafe fn tfhers_uint8_array_to_lwe_array(
         let lwe_size: usize = desc.lwe_size;
         let n_cts: usize = desc.n_cts;
         let blocks_size = n_cts * lwe_size;
-        // collect LWEs from fheuint
-        for fheuint in fheuint_array {
-            let (radix, _, _) = fheuint.into_raw_parts();
-            let blocks = radix.blocks();
-            // copy LWEs to C buffer. Note that lsb is cts[0]
-            let lwe_vector: &mut [u64] =
-                slice::from_raw_parts_mut(lwe_vec_buffer, n_cts * lwe_size);
-            for (i, block) in blocks.iter().enumerate() {
-                lwe_vector[i * lwe_size..(i + 1) * lwe_size]
-                    .copy_from_slice(block.ct.clone().into_container().as_slice());
-            }
-            // shift to next block
-            lwe_vec_buffer = lwe_vec_buffer.add(blocks_size);
-        }
+        let lwe_vector: &mut [u64] =
+            slice::from_raw_parts_mut(lwe_vec_buffer, n_elem * blocks_size);
+        // copy LWEs of each fheuint to its own part of the C buffer, in parallel
+        fheuint_array
+            .into_par_iter()
+            .zip(lwe_vector.par_chunks_mut(blocks_size))
+            .for_each(|(fheuint, lwe_elem)| {
+                let (radix, _, _) = fheuint.into_raw_parts();
+                // Note that lsb is cts[0]
+                for (block, lwe) in radix.blocks().iter().zip(lwe_elem.chunks_mut(lwe_size)) {
+                    lwe.copy_from_slice(block.ct.as_ref());
+                }
+            });
         0
     })
 }
@@ -226,7 +230,7 @@ pub unsafe extern "C" fn concrete_cpu_tfhers_uint8_to_lwe_array(
     if n_elem == 1 {
         tfhers_uint8_to_lwe_array(buffer, buffer_len, lwe_vec_buffer, desc)
     } else {
-        tfhers_uint8_array_to_lwe_array(buffer, buffer_len, lwe_vec_buffer, desc)
+        tfhers_uint8_array_to_lwe_array(buffer, buffer_len, lwe_vec_buffer, n_elem, desc)
     }
 }
 
@@ -262,11 +266,15 @@ unsafe fn tfhers_int8_to_lwe_array(
 unsafe fn tfhers_int8_array_to_lwe_array(
     buffer: *const u8,
     buffer_len: usize,
-    mut lwe_vec_buffer: *mut u64,
+    lwe_vec_buffer: *mut u64,
+    n_elem: usize,
     desc: TfhersFheIntDescription,
 ) -> i64 {
     nounwind(|| {
         let fheint_array: Vec<FheInt8> = super::utils::unsafe_deserialize(buffer, buffer_len);
+        if fheint_array.len() != n_elem {
+            return 1;
+        }
         // TODO - Use conformance check
         let fheint_desc = tfhers_int8_description(fheint_array[0].clone());
         if !fheint_desc.is_similar(&desc) {
@@ -276,20 +284,19 @@ unsafe fn tfhers_int8_array_to_lwe_array(
         let lwe_size: usize = desc.lwe_size;
         let n_cts: usize = desc.n_cts;
         let blocks_size = n_cts * lwe_size;
-        // collect LWEs from fheint
-        for fheint in fheint_array {
-            let (radix, _, _) = fheint.into_raw_parts();
-            let blocks = radix.blocks();
-            // copy LWEs to C buffer. Note that lsb is cts[0]
-            let lwe_vector: &mut [u64] =
-                slice::from_raw_parts_mut(lwe_vec_buffer, n_cts * lwe_size);
-            for (i, block) in blocks.iter().enumerate() {
-                lwe_vector[i * lwe_size..(i + 1) * lwe_size]
-                    .copy_from_slice(block.ct.clone().into_container().as_slice());
-            }
-            // shift to next block
-            lwe_vec_buffer = lwe_vec_buffer.add(blocks_size);
-        }
+        let lwe_vector: &mut [u64] =
+            slice::from_raw_parts_mut(lwe_vec_buffer, n_elem * blocks_size);
+        // copy LWEs of each fheint to its own part of the C buffer, in parallel
+        fheint_array
+            .into_par_iter()
+            .zip(lwe_vector.par_chunks_mut(blocks_size))
+            .for_each(|(fheint, lwe_elem)| {
+                let (radix, _, _) = fheint.into_raw_parts();
+                // Note that lsb is cts[0]
+                for (block, lwe) in radix.blocks().iter().zip(lwe_elem.chunks_mut(lwe_size)) {
+                    lwe.copy_from_slice(block.ct.as_ref());
+                }
+            });
         0
     })
 }
@@ -306,7 +313,7 @@ pub unsafe extern "C" fn concrete_cpu_tfhers_int8_to_lwe_array(
     if n_elem == 1 {
         tfhers_int8_to_lwe_array(buffer, buffer_len, lwe_vec_buffer, desc)
     } else {
-        tfhers_int8_array_to_lwe_array(buffer, buffer_len, lwe_vec_buffer, desc)
+        tfhers_int8_array_to_lwe_array(buffer, buffer_len, lwe_vec_buffer, n_elem, desc)
     }
 }
 
@@ -394,26 +401,28 @@ unsafe fn lwe_array_to_tfhers_uint8_array(
         let n_cts = desc.n_cts;
         // construct fheuint from LWEs
         let lwe_vector: &[u64] = slice::from_raw_parts(lwe_vec_buffer, n_elem * n_cts * lwe_size);
-        let mut fheuint_array: Vec<FheUint8> = Vec::with_capacity(n_elem);
-        for i in 0..n_elem {
-            let elem_offset = i * n_cts * lwe_size;
-            let mut blocks: Vec<Ciphertext> = Vec::with_capacity(n_cts);
-            for j in 0..n_cts {
-                let lwe_ct = LweCiphertext::<Vec<u64>>::from_container(
-                    lwe_vector[elem_offset + j * lwe_size..elem_offset + (j + 1) * lwe_size]
-                        .to_vec(),
-                    CiphertextModulus::new_native(),
-                );
-                blocks.push(desc.ct_from_lwe(lwe_ct));
+        // construct the fheuints of the different elements in parallel
+        let fheuint_array: Result<Vec<FheUint8>, _> = lwe_vector
+            .par_chunks(n_cts * lwe_size)
+            .map(|lwe_elem| {
+                let blocks: Vec<Ciphertext> = lwe_elem
+                    .chunks(lwe_size)
+                    .map(|lwe| {
+                        desc.ct_from_lwe(LweCiphertext::from_container(
+                            lwe.to_vec(),
+                            CiphertextModulus::new_native(),
+                        ))
+                    })
+                    .collect();
+                FheUint8::from_expanded_blocks(blocks, desc.data_kind())
+            })
+            .collect();
+        let fheuint_array = match fheuint_array {
+            Ok(value) => value,
+            Err(_) => {
+                return 0;
             }
-            let fheuint = match FheUint8::from_expanded_blocks(blocks, desc.data_kind()) {
-                Ok(value) => value,
-                Err(_) => {
-                    return 0;
-                }
-            };
-            fheuint_array.push(fheuint);
-        }
+        };
         super::utils::unsafe_serialize(&fheuint_array, buffer, buffer_len)
     })
 }
@@ -498,26 +507,28 @@ unsafe fn lwe_array_to_tfhers_int8_array(
         let n_cts = desc.n_cts;
         // construct fheint from LWEs
         let lwe_vector: &[u64] = slice::from_raw_parts(lwe_vec_buffer, n_elem * n_cts * lwe_size);
-        let mut fheint_array: Vec<FheInt8> = Vec::with_capacity(n_elem);
-        for i in 0..n_elem {
-            let elem_offset = i * n_cts * lwe_size;
-            let mut blocks: Vec<Ciphertext> = Vec::with_capacity(n_cts);
-            for j in 0..n_cts {
-                let lwe_ct = LweCiphertext::<Vec<u64>>::from_container(
-                    lwe_vector[elem_offset + j * lwe_size..elem_offset + (j + 1) * lwe_size]
-                        .to_vec(),
-                    CiphertextModulus::new_native(),
-                );
-                blocks.push(desc.ct_from_lwe(lwe_ct));
+        // construct the fheints of the different elements in parallel
+        let fheint_array: Result<Vec<FheInt8>, _> = lwe_vector
+            .par_chunks(n_cts * lwe_size)
+            .map(|lwe_elem| {
+                let blocks: Vec<Ciphertext> = lwe_elem
+                    .chunks(lwe_size)
+                    .map(|lwe| {
+                        desc.ct_from_lwe(LweCiphertext::from_container(
+                            lwe.to_vec(),
+                            CiphertextModulus::new_native(),
+                        ))
+                    })
+                    .collect();
+                FheInt8::from_expanded_blocks(blocks, desc.data_kind())
+            })
+            .collect();
+        let fheint_array = match fheint_array {
+            Ok(value) => value,
+            Err(_) => {
+                return 0;
             }
-            let fheint = match FheInt8::from_expanded_blocks(blocks, desc.data_kind()) {
-                Ok(value) => value,
-                Err(_) => {
-                    return 0;
-                }
-            };
-            fheint_array.push(fheint);
-        }
+        };
 
         super::utils::unsafe_serialize(&fheint_array, buffer, buffer_len)
     })
@@ -1,11 +1,13 @@
-use concrete_csprng::generators::SoftwareRandomGenerator;
+use tfhe::core_crypto::algorithms::slice_algorithms::slice_wrapping_sub_scalar_mul_assign;
+use tfhe::core_crypto::commons::math::decomposition::SignedDecomposer;
 use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
-use super::csprng::new_dyn_seeder;
+use super::csprng::{new_dyn_seeder, DynamicRandomGenerator};
 use super::types::{EncCsprng, Uint128};
 use super::utils::nounwind;
 use crate::c_api::types::Parallelism;
+use rayon::prelude::*;
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_init_lwe_keyswitch_key_u64(
@@ -54,7 +56,7 @@ pub unsafe extern "C" fn concrete_cpu_init_lwe_keyswitch_key_u64(
             &output_key,
             &mut ksk,
             Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-            &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
         )
     });
 }
@@ -166,13 +168,13 @@ pub unsafe extern "C" fn concrete_cpu_decompress_seeded_lwe_keyswitch_key_u64(
         );
         match parallelism {
             Parallelism::No => {
-                decompress_seeded_lwe_keyswitch_key::<_, _, _, SoftwareRandomGenerator>(
+                decompress_seeded_lwe_keyswitch_key::<_, _, _, DynamicRandomGenerator>(
                     &mut output_ksk,
                     &input_ksk,
                 )
             }
             Parallelism::Rayon => {
-                par_decompress_seeded_lwe_keyswitch_key::<_, _, _, SoftwareRandomGenerator>(
+                par_decompress_seeded_lwe_keyswitch_key::<_, _, _, DynamicRandomGenerator>(
                     &mut output_ksk,
                     &input_ksk,
                 )
@@ -222,6 +224,119 @@ pub unsafe extern "C" fn concrete_cpu_keyswitch_lwe_ciphertext_u64(
     })
 }
 
+// Bytes of keyswitch key applied to a tile of ciphertexts before moving to the next part of
+// the key, small enough to stay in the L2 cache along with the outputs of the tile
+const KEYSWITCH_KEY_TILE_BYTES: usize = 256 * 1024;
+// Ciphertexts keyswitched together, each part of the key being read once per tile
+const KEYSWITCH_BATCH_TILE: usize = 16;
+
+// Keyswitches a tile of ciphertexts key-major: rather than streaming the whole key for each
+// ciphertext, the key is read a few input mask elements at a time, each part being applied
+// to all the ciphertexts of the tile before moving on.
+fn keyswitch_tile_key_major(
+    keyswitch_key: &[u64],
+    decomposer: &SignedDecomposer<u64>,
+    decomposition_level_count: usize,
+    ct_out_tile: &mut [u64],
+    ct_in_tile: &[u64],
+    input_dimension: usize,
+    output_dimension: usize,
+) {
+    let input_size = input_dimension + 1;
+    let output_size = output_dimension + 1;
+    // The keyswitch key of an input mask element, one output ciphertext per level
+    let block_size = decomposition_level_count * output_size;
+    let blocks_per_tile = (KEYSWITCH_KEY_TILE_BYTES / (block_size.max(1) * 8)).max(1);
+
+    // The outputs start from the bodies of the inputs
+    for (ct_out, ct_in) in ct_out_tile
+        .chunks_exact_mut(output_size)
+        .zip(ct_in_tile.chunks_exact(input_size))
+    {
+        ct_out.fill(0);
+        ct_out[output_dimension] = ct_in[input_dimension];
+    }
+
+    for first in (0..input_dimension).step_by(blocks_per_tile) {
+        let last = (first + blocks_per_tile).min(input_dimension);
+        let key_tile = &keyswitch_key[first * block_size..last * block_size];
+        for (ct_out, ct_in) in ct_out_tile
+            .chunks_exact_mut(output_size)
+            .zip(ct_in_tile.chunks_exact(input_size))
+        {
+            for (block, &mask_element) in key_tile.chunks_exact(block_size).zip(&ct_in[first..last])
+            {
+                for (level_key, decomposed) in block
+                    .chunks_exact(output_size)
+                    .zip(decomposer.decompose(mask_element))
+                {
+                    slice_wrapping_sub_scalar_mul_assign(ct_out, level_key, decomposed.value());
+                }
+            }
+        }
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out_vec: *mut u64,
+    ct_in_vec: *const u64,
+    count: usize,
+    // keyswitch key
+    keyswitch_key: *const u64,
+    // keyswitch parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    input_dimension: usize,
+    output_dimension: usize,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        let ct_out_vec =
+            core::slice::from_raw_parts_mut(ct_out_vec, count * (output_dimension + 1));
+        let ct_in_vec = core::slice::from_raw_parts(ct_in_vec, count * (input_dimension + 1));
+        let keyswitch_key = core::slice::from_raw_parts(
+            keyswitch_key,
+            concrete_cpu_keyswitch_key_size_u64(
+                decomposition_level_count,
+                input_dimension,
+                output_dimension,
+            ),
+        );
+        let decomposer = SignedDecomposer::new(
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+
+        let keyswitch = |(ct_out_tile, ct_in_tile): (&mut [u64], &[u64])| {
+            keyswitch_tile_key_major(
+                keyswitch_key,
+                &decomposer,
+                decomposition_level_count,
+                ct_out_tile,
+                ct_in_tile,
+                input_dimension,
+                output_dimension,
+            )
+        };
+
+        let output_tile_size = KEYSWITCH_BATCH_TILE * (output_dimension + 1);
+        let input_tile_size = KEYSWITCH_BATCH_TILE * (input_dimension + 1);
+        match parallelism {
+            Parallelism::No => ct_out_vec
+                .chunks_mut(output_tile_size)
+                .zip(ct_in_vec.chunks(input_tile_size))
+                .for_each(keyswitch),
+            Parallelism::Rayon => ct_out_vec
+                .par_chunks_mut(output_tile_size)
+                .zip(ct_in_vec.par_chunks(input_tile_size))
+                .for_each(keyswitch),
+        }
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_keyswitch_key_size_u64(
     decomposition_level_count: usize,
@@ -245,3 +360,242 @@ pub unsafe extern "C" fn concrete_cpu_seeded_keyswitch_key_size_u64(
             decomposition_level_count,
         ))
 }
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_init_glwe_packing_keyswitch_key_u64(
+    // packing keyswitch key
+    glwe_pksk: *mut u64,
+    // secret keys
+    input_lwe_sk: *const u64,
+    output_glwe_sk: *const u64,
+    // secret key dimensions
+    input_lwe_dimension: usize,
+    output_glwe_dimension: usize,
+    output_polynomial_size: usize,
+    // packing keyswitch key parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    // noise parameters
+    variance: f64,
+    // csprng
+    csprng: *mut EncCsprng,
+) {
+    nounwind(|| {
+        let input_key = LweSecretKey::from_container(core::slice::from_raw_parts(
+            input_lwe_sk,
+            input_lwe_dimension,
+        ));
+        let output_key = GlweSecretKey::from_container(
+            core::slice::from_raw_parts(
+                output_glwe_sk,
+                output_glwe_dimension * output_polynomial_size,
+            ),
+            PolynomialSize(output_polynomial_size),
+        );
+        let mut pksk = LwePackingKeyswitchKey::from_container(
+            core::slice::from_raw_parts_mut(
+                glwe_pksk,
+                concrete_cpu_glwe_packing_keyswitch_key_size_u64(
+                    decomposition_level_count,
+                    input_lwe_dimension,
+                    output_glwe_dimension,
+                    output_polynomial_size,
+                ),
+            ),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            GlweDimension(output_glwe_dimension).to_glwe_size(),
+            PolynomialSize(output_polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        generate_lwe_packing_keyswitch_key(
+            &input_key,
+            &output_key,
+            &mut pksk,
+            Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
+            &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
+        )
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_keyswitch_and_pack_lwe_ciphertext_list_u64(
+    // ciphertexts
+    glwe_ct_out: *mut u64,
+    lwe_ct_list_in: *const u64,
+    lwe_ct_count: usize,
+    // packing keyswitch key
+    glwe_pksk: *const u64,
+    // packing keyswitch parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    input_dimension: usize,
+    output_glwe_dimension: usize,
+    output_polynomial_size: usize,
+) {
+    nounwind(|| {
+        assert!(lwe_ct_count <= output_polynomial_size);
+        let mut glwe_ct_out = GlweCiphertext::from_container(
+            core::slice::from_raw_parts_mut(
+                glwe_ct_out,
+                (output_glwe_dimension + 1) * output_polynomial_size,
+            ),
+            PolynomialSize(output_polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+        let lwe_ct_list_in = LweCiphertextList::from_container(
+            core::slice::from_raw_parts(lwe_ct_list_in, lwe_ct_count * (input_dimension + 1)),
+            LweDimension(input_dimension).to_lwe_size(),
+            CiphertextModulus::new_native(),
+        );
+
+        let pksk = LwePackingKeyswitchKey::from_container(
+            core::slice::from_raw_parts(
+                glwe_pksk,
+                concrete_cpu_glwe_packing_keyswitch_key_size_u64(
+                    decomposition_level_count,
+                    input_dimension,
+                    output_glwe_dimension,
+                    output_polynomial_size,
+                ),
+            ),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            GlweDimension(output_glwe_dimension).to_glwe_size(),
+            PolynomialSize(output_polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+        keyswitch_lwe_ciphertext_list_and_pack_in_glwe_ciphertext(
+            &pksk,
+            &lwe_ct_list_in,
+            &mut glwe_ct_out,
+        );
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_glwe_packing_keyswitch_key_size_u64(
+    decomposition_level_count: usize,
+    input_dimension: usize,
+    output_glwe_dimension: usize,
+    output_polynomial_size: usize,
+) -> usize {
+    input_dimension
+        * lwe_packing_keyswitch_key_input_key_element_encrypted_size(
+            DecompositionLevelCount(decomposition_level_count),
+            GlweDimension(output_glwe_dimension).to_glwe_size(),
+            PolynomialSize(output_polynomial_size),
+        )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // An input key larger than the keyswitch key tiles, and a batch larger than the tiles of
+    // ciphertexts, neither being a multiple of the tiles
+    const INPUT_DIMENSION: usize = 2048;
+    const OUTPUT_DIMENSION: usize = 600;
+    const LEVEL_COUNT: usize = 3;
+    const BASE_LOG: usize = 4;
+    const COUNT: usize = 2 * KEYSWITCH_BATCH_TILE + 5;
+
+    fn keyswitch(keyswitch_key: &[u64], ct: &[u64]) -> Vec<u64> {
+        let mut out = vec![0u64; OUTPUT_DIMENSION + 1];
+        unsafe {
+            concrete_cpu_keyswitch_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                ct.as_ptr(),
+                keyswitch_key.as_ptr(),
+                LEVEL_COUNT,
+                BASE_LOG,
+                INPUT_DIMENSION,
+                OUTPUT_DIMENSION,
+            );
+        }
+        out
+    }
+
+    fn batched_keyswitch(keyswitch_key: &[u64], cts: &[u64], parallelism: Parallelism) -> Vec<u64> {
+        let count = cts.len() / (INPUT_DIMENSION + 1);
+        let mut out = vec![0u64; count * (OUTPUT_DIMENSION + 1)];
+        unsafe {
+            concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+                out.as_mut_ptr(),
+                cts.as_ptr(),
+                count,
+                keyswitch_key.as_ptr(),
+                LEVEL_COUNT,
+                BASE_LOG,
+                INPUT_DIMENSION,
+                OUTPUT_DIMENSION,
+                parallelism,
+            );
+        }
+        out
+    }
+
+    #[test]
+    fn test_batched_keyswitch() {
+        let mut secret = SecretRandomGenerator::<DynamicRandomGenerator>::new(Seed(0));
+        let mut encryption = EncryptionRandomGenerator::<DynamicRandomGenerator>::new(
+            Seed(1),
+            new_dyn_seeder().as_mut(),
+        );
+        let noise =
+            Gaussian::from_dispersion_parameter(Variance::from_variance(2f64.powi(-80)), 0.0);
+        let input_sk = allocate_and_generate_new_binary_lwe_secret_key(
+            LweDimension(INPUT_DIMENSION),
+            &mut secret,
+        );
+        let output_sk = allocate_and_generate_new_binary_lwe_secret_key(
+            LweDimension(OUTPUT_DIMENSION),
+            &mut secret,
+        );
+        let keyswitch_key = allocate_and_generate_new_lwe_keyswitch_key(
+            &input_sk,
+            &output_sk,
+            DecompositionBaseLog(BASE_LOG),
+            DecompositionLevelCount(LEVEL_COUNT),
+            noise,
+            CiphertextModulus::new_native(),
+            &mut encryption,
+        );
+        let keyswitch_key: &[u64] = keyswitch_key.as_ref();
+
+        let messages: Vec<u64> = (0..COUNT as u64).map(|i| (i * 5) % 8).collect();
+        let cts: Vec<u64> = messages
+            .iter()
+            .flat_map(|&message| {
+                allocate_and_encrypt_new_lwe_ciphertext(
+                    &input_sk,
+                    Plaintext(message << 60),
+                    noise,
+                    CiphertextModulus::new_native(),
+                    &mut encryption,
+                )
+                .into_container()
+            })
+            .collect();
+
+        // The key-major keyswitch of the batch only reorders the operations of the keyswitches
+        // of its ciphertexts one by one, which are exactly the same
+        let expected: Vec<u64> = cts
+            .chunks_exact(INPUT_DIMENSION + 1)
+            .flat_map(|ct| keyswitch(keyswitch_key, ct))
+            .collect();
+        for parallelism in [Parallelism::No, Parallelism::Rayon] {
+            assert_eq!(
+                batched_keyswitch(keyswitch_key, &cts, parallelism),
+                expected
+            );
+        }
+
+        for (ct_out, &message) in expected.chunks_exact(OUTPUT_DIMENSION + 1).zip(&messages) {
+            let ct_out = LweCiphertext::from_container(ct_out, CiphertextModulus::new_native());
+            let plaintext = decrypt_lwe_ciphertext(&output_sk, &ct_out).0;
+            assert_eq!(plaintext.wrapping_add(1 << 59) >> 60, message);
+        }
+    }
+}
@@ -1,11 +1,11 @@
-use concrete_csprng::generators::SoftwareRandomGenerator;
 use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
-use super::csprng::new_dyn_seeder;
-use super::types::{EncCsprng, SecCsprng, Uint128};
+use super::csprng::{new_dyn_seeder, DynamicRandomGenerator};
+use super::types::{EncCsprng, Parallelism, SecCsprng, Uint128};
 use super::utils::nounwind;
 use core::slice;
+use rayon::prelude::*;
 
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_init_secret_key_u64(
@@ -20,7 +20,7 @@ pub unsafe extern "C" fn concrete_cpu_init_secret_key_u64(
         ));
         tfhe::core_crypto::algorithms::generate_binary_lwe_secret_key(
             &mut sk,
-            &mut *(csprng as *mut SecretRandomGenerator<SoftwareRandomGenerator>),
+            &mut *(csprng as *mut SecretRandomGenerator<DynamicRandomGenerator>),
         );
     })
 }
@@ -54,11 +54,167 @@ pub unsafe extern "C" fn concrete_cpu_encrypt_lwe_ciphertext_u64(
             &mut lwe_out,
             Plaintext(input),
             Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-            &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
         );
     });
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_encrypt_lwe_ciphertext_vector_u64(
+    // secret key
+    lwe_sk: *const u64,
+    // ciphertexts
+    lwe_out: *mut u64,
+    // plaintexts
+    input: *const u64,
+    // number of ciphertexts
+    count: usize,
+    // lwe dimension
+    lwe_dimension: usize,
+    // encryption parameters
+    variance: f64,
+    // csprng
+    csprng: *mut EncCsprng,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        if count == 0 {
+            return;
+        }
+        let lwe_sk = LweSecretKey::from_container(slice::from_raw_parts(
+            lwe_sk,
+            concrete_cpu_lwe_secret_key_size_u64(lwe_dimension),
+        ));
+        let mut lwe_out = LweCiphertextList::from_container(
+            slice::from_raw_parts_mut(
+                lwe_out,
+                count * concrete_cpu_lwe_ciphertext_size_u64(lwe_dimension),
+            ),
+            LweDimension(lwe_dimension).to_lwe_size(),
+            CiphertextModulus::new_native(),
+        );
+        let input = PlaintextList::from_container(slice::from_raw_parts(input, count));
+        let noise = Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0);
+        // The generator is forked into one stream per ciphertext, so that the
+        // result does not depend on the parallelism
+        let generator = &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>);
+        match parallelism {
+            Parallelism::No => {
+                encrypt_lwe_ciphertext_list(&lwe_sk, &mut lwe_out, &input, noise, generator)
+            }
+            Parallelism::Rayon => {
+                par_encrypt_lwe_ciphertext_list(&lwe_sk, &mut lwe_out, &input, noise, generator)
+            }
+        }
+    });
+}
+
+// Fill `randomness_out` with the randomness of `count` encryptions, i.e. their
+// masks and noises, laid out as encryptions of zero under the zero key. The
+// encryptions are completed later with
+// `concrete_cpu_encrypt_lwe_ciphertext_vector_with_randomness_u64`, to the same
+// ciphertexts as `concrete_cpu_encrypt_lwe_ciphertext_vector_u64` with the same
+// generator.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_fill_lwe_encryption_randomness_u64(
+    // randomness
+    randomness_out: *mut u64,
+    // number of ciphertexts
+    count: usize,
+    // lwe dimension
+    lwe_dimension: usize,
+    // encryption parameters
+    variance: f64,
+    // csprng
+    csprng: *mut EncCsprng,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        if count == 0 {
+            return;
+        }
+        let zero_key = LweSecretKey::new_empty_key(0u64, LweDimension(lwe_dimension));
+        let mut randomness_out = LweCiphertextList::from_container(
+            slice::from_raw_parts_mut(
+                randomness_out,
+                count * concrete_cpu_lwe_ciphertext_size_u64(lwe_dimension),
+            ),
+            LweDimension(lwe_dimension).to_lwe_size(),
+            CiphertextModulus::new_native(),
+        );
+        let zeros = PlaintextList::new(0u64, PlaintextCount(count));
+        let noise = Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0);
+        let generator = &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>);
+        match parallelism {
+            Parallelism::No => encrypt_lwe_ciphertext_list(
+                &zero_key,
+                &mut randomness_out,
+                &zeros,
+                noise,
+                generator,
+            ),
+            Parallelism::Rayon => par_encrypt_lwe_ciphertext_list(
+                &zero_key,
+                &mut randomness_out,
+                &zeros,
+                noise,
+                generator,
+            ),
+        }
+    });
+}
+
+// Complete in place the encryptions of `count` plaintexts from their
+// randomness, filled by `concrete_cpu_fill_lwe_encryption_randomness_u64`, by
+// adding the dot products of their masks with the secret key and the plaintexts
+// to their bodies.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_encrypt_lwe_ciphertext_vector_with_randomness_u64(
+    // secret key
+    lwe_sk: *const u64,
+    // randomness in, ciphertexts out
+    lwe_inout: *mut u64,
+    // plaintexts
+    input: *const u64,
+    // number of ciphertexts
+    count: usize,
+    // lwe dimension
+    lwe_dimension: usize,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        if count == 0 {
+            return;
+        }
+        let lwe_sk =
+            slice::from_raw_parts(lwe_sk, concrete_cpu_lwe_secret_key_size_u64(lwe_dimension));
+        let lwe_size = concrete_cpu_lwe_ciphertext_size_u64(lwe_dimension);
+        let lwe_inout = slice::from_raw_parts_mut(lwe_inout, count * lwe_size);
+        let input = slice::from_raw_parts(input, count);
+        let encrypt = |(ct, plaintext): (&mut [u64], &u64)| {
+            let (mask, body) = ct.split_at_mut(lwe_dimension);
+            let dot = mask
+                .iter()
+                .zip(lwe_sk)
+                .fold(0u64, |acc, (a, s)| acc.wrapping_add(a.wrapping_mul(*s)));
+            body[0] = body[0].wrapping_add(dot).wrapping_add(*plaintext);
+        };
+        match parallelism {
+            Parallelism::No => lwe_inout
+                .chunks_exact_mut(lwe_size)
+                .zip(input)
+                .for_each(encrypt),
+            Parallelism::Rayon => lwe_inout
+                .par_chunks_exact_mut(lwe_size)
+                .zip(input.par_iter())
+                .for_each(encrypt),
+        }
+    });
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_encrypt_seeded_lwe_ciphertext_u64(
     // secret key
@@ -146,7 +302,7 @@ pub unsafe extern "C" fn concrete_cpu_encrypt_ggsw_ciphertext_u64(
             &mut ggsw_out,
             Cleartext(input),
             Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-            &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
         );
     });
 }
@@ -204,7 +360,7 @@ pub unsafe extern "C" fn concrete_cpu_decompress_seeded_lwe_ciphertext_u64(
             CiphertextModulus::new_native(),
         );
 
-        decompress_seeded_lwe_ciphertext::<_, _, SoftwareRandomGenerator>(
+        decompress_seeded_lwe_ciphertext::<_, _, DynamicRandomGenerator>(
             &mut lwe_out,
             &seeded_lwe_in,
         )
@@ -367,3 +523,67 @@ pub unsafe extern "C" fn concrete_cpu_ggsw_ciphertext_size_u64(
         DecompositionLevelCount(decomposition_level_count),
     )
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const LWE_DIMENSION: usize = 600;
+    const COUNT: usize = 64;
+
+    // Encrypts `COUNT` messages under `lwe_sk` with a generator seeded with
+    // `seed` and the given parallelism
+    fn encrypt_vector(lwe_sk: &[u64], seed: u128, parallelism: Parallelism) -> Vec<u64> {
+        let mut generator = EncryptionRandomGenerator::<DynamicRandomGenerator>::new(
+            Seed(seed),
+            new_dyn_seeder().as_mut(),
+        );
+        let input: Vec<u64> = (0..COUNT as u64).map(|i| i << 58).collect();
+        let lwe_size = unsafe { concrete_cpu_lwe_ciphertext_size_u64(LWE_DIMENSION) };
+        let mut output = vec![0u64; COUNT * lwe_size];
+        unsafe {
+            concrete_cpu_encrypt_lwe_ciphertext_vector_u64(
+                lwe_sk.as_ptr(),
+                output.as_mut_ptr(),
+                input.as_ptr(),
+                COUNT,
+                LWE_DIMENSION,
+                2f64.powi(-80),
+                &mut generator as *mut _ as *mut EncCsprng,
+                parallelism,
+            );
+        }
+        output
+    }
+
+    #[test]
+    fn test_encrypt_vector_does_not_depend_on_parallelism() {
+        let mut secret = SecretRandomGenerator::<DynamicRandomGenerator>::new(Seed(0));
+        let lwe_sk = allocate_and_generate_new_binary_lwe_secret_key(
+            LweDimension(LWE_DIMENSION),
+            &mut secret,
+        );
+        let sequential = encrypt_vector(lwe_sk.as_ref(), 1, Parallelism::No);
+        let parallel = encrypt_vector(lwe_sk.as_ref(), 1, Parallelism::Rayon);
+        assert_eq!(sequential, parallel);
+        assert_ne!(
+            sequential,
+            encrypt_vector(lwe_sk.as_ref(), 2, Parallelism::Rayon)
+        );
+
+        let lwe_size = unsafe { concrete_cpu_lwe_ciphertext_size_u64(LWE_DIMENSION) };
+        for (i, ct) in parallel.chunks(lwe_size).enumerate() {
+            let mut plaintext = 0u64;
+            unsafe {
+                concrete_cpu_decrypt_lwe_ciphertext_u64(
+                    lwe_sk.as_ref().as_ptr(),
+                    ct.as_ptr(),
+                    LWE_DIMENSION,
+                    &mut plaintext,
+                );
+            }
+            let decoded = plaintext.wrapping_add(1 << 57) >> 58;
+            assert_eq!(decoded, i as u64);
+        }
+    }
+}
@@ -36,3 +36,19 @@ pub enum Parallelism {
     No = 0,
     Rayon = 1,
 }
+
+#[repr(u32)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum CsprngBackend {
+    Software = 0,
+    AesNi = 1,
+    ArmAes = 2,
+}
+
+#[repr(u32)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum FftBackend {
+    Scalar = 0,
+    Avx2 = 1,
+    Avx512 = 2,
+}
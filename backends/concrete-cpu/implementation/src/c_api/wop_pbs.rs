@@ -1,4 +1,4 @@
-use concrete_csprng::generators::SoftwareRandomGenerator;
+use crate::c_api::csprng::DynamicRandomGenerator;
 use concrete_fft::c64;
 use tfhe::core_crypto::prelude::*;
 
@@ -72,14 +72,14 @@ pub unsafe extern "C" fn concrete_cpu_init_lwe_circuit_bootstrap_private_functio
                 &input_key,
                 &output_key,
                 Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+                &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
             ),
             Parallelism::Rayon => par_generate_circuit_bootstrap_lwe_pfpksk_list(
                 &mut fpksk_list,
                 &input_key,
                 &output_key,
                 Gaussian::from_dispersion_parameter(Variance::from_variance(variance), 0.0),
-                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+                &mut *(csprng as *mut EncryptionRandomGenerator<DynamicRandomGenerator>),
             ),
         }
     })
@@ -1,8 +1,8 @@
+use crate::c_api::csprng::DynamicRandomGenerator;
 use crate::c_api::utils::nounwind;
 use crate::implementation::wop_simulation::{
     circuit_bootstrap_boolean_vertical_packing, extract_bits,
 };
-use concrete_csprng::generators::SoftwareRandomGenerator;
 use core::slice;
 use tfhe::core_crypto::commons::math::random::RandomGenerator;
 
@@ -28,7 +28,7 @@ pub unsafe extern "C" fn simulation_extract_bit_lwe_ciphertext_u64(
     nounwind(|| {
         assert!(64 <= number_of_bits_to_extract + delta_log);
 
-        let csprng = &mut *(csprng as *mut RandomGenerator<SoftwareRandomGenerator>);
+        let csprng = &mut *(csprng as *mut RandomGenerator<DynamicRandomGenerator>);
 
         extract_bits(
             slice::from_raw_parts_mut(lwe_list_out, number_of_bits_to_extract),
@@ -82,7 +82,7 @@ pub unsafe extern "C" fn simulation_circuit_bootstrap_boolean_vertical_packing_l
 
         let lwe_list_in = slice::from_raw_parts(lwe_list_in, ct_in_count);
 
-        let csprng = &mut *(csprng as *mut RandomGenerator<SoftwareRandomGenerator>);
+        let csprng = &mut *(csprng as *mut RandomGenerator<DynamicRandomGenerator>);
 
         circuit_bootstrap_boolean_vertical_packing(
             lwe_list_in,
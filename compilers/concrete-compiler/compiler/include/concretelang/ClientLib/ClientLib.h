@@ -25,9 +25,14 @@
 
 using concretelang::error::Result;
 using concretelang::keysets::ClientKeyset;
+using concretelang::protocol::SharedReader;
+using concretelang::transformers::BatchInputTransformer;
+using concretelang::transformers::BatchOutputTransformer;
 using concretelang::transformers::InputTransformer;
 using concretelang::transformers::OutputTransformer;
+using concretelang::transformers::StreamInputTransformer;
 using concretelang::transformers::TransformerFactory;
+using concretelang::transformers::TransportValueStream;
 using concretelang::values::TransportValue;
 using concretelang::values::Value;
 
@@ -55,37 +60,112 @@ public:
   createSimulated(const Message<concreteprotocol::CircuitInfo> &info,
                   std::shared_ptr<csprng::EncryptionCSPRNG> csprng);
 
+  /// Prepares the value of the input `pos`. The ciphertexts of the inputs
+  /// with encryptions of zero precomputed are obtained by adding the encoded
+  /// value to them.
   Result<TransportValue> prepareInput(Value arg, size_t pos);
 
+  /// Precomputes `count` more encryptions of zero for the ciphertexts of the
+  /// input `pos`, e.g. in idle time or on a background thread, concurrently
+  /// with the preparation of the inputs. A value of the input holding n
+  /// ciphertexts consumes n of them. The encryptions are kept in the pool of
+  /// their key dimension and noise of the generator of the circuit, which the
+  /// first precomputation for them creates, forking the generator: this one
+  /// must not run concurrently with the preparation of the inputs.
+  Result<void> precomputeInputEncryptions(size_t pos, size_t count);
+
+  /// Returns the number of encryptions of zero precomputed for the input
+  /// `pos` and not consumed yet.
+  Result<size_t> getPrecomputedInputEncryptions(size_t pos);
+
+  /// Prepares a ciphertext input to be sent in chunks of the ciphertexts of
+  /// at most `chunkSize` elements of `arg`. The chunks are encrypted when
+  /// pulled from the stream, so that they can be sent as they are produced,
+  /// and consumed on the server side by `ServerCircuit::prepareArgStream`.
+  Result<TransportValueStream> prepareInputStream(Value arg, size_t pos,
+                                                  size_t chunkSize);
+
   Result<Value> processOutput(TransportValue result, size_t pos);
 
+  /// Prepares the values of many samples of the input `pos`, one transport
+  /// value per sample. The ciphertexts of all the samples are encoded and
+  /// encrypted at once, in parallel.
+  Result<std::vector<TransportValue>> prepareInputs(std::vector<Value> args,
+                                                    size_t pos);
+
+  /// Processes the transport values of many samples of the output `pos`, one
+  /// value per sample. The ciphertexts of all the samples are decrypted and
+  /// decoded at once, in parallel.
+  Result<std::vector<Value>> processOutputs(std::vector<TransportValue> results,
+                                            size_t pos);
+
   Result<TransportValue> simulatePrepareInput(Value arg, size_t pos);
 
   Result<Value> simulateProcessOutput(TransportValue result, size_t pos);
 
   std::string getName();
 
-  const Message<concreteprotocol::CircuitInfo> &getCircuitInfo();
+  const SharedReader<concreteprotocol::CircuitInfo> &getCircuitInfo();
 
   bool isSimulated();
 
 private:
+  /// The encryption of the ciphertexts of an input, under the secret key
+  /// `key`, of dimension `lweDimension` and noise `variance`
+  struct PrecomputableEncryption {
+    std::shared_ptr<const std::vector<uint64_t>> key;
+    size_t lweDimension;
+    double variance;
+  };
+
+  /// Returns the pool of the encryptions of zero of the input `pos`, creating
+  /// it if `create`, or nullptr.
+  csprng::EncryptionRandomnessPool *getPrecomputationPool(size_t pos,
+                                                          bool create);
+
   ClientCircuit() = delete;
-  ClientCircuit(const Message<concreteprotocol::CircuitInfo> &circuitInfo,
+  ClientCircuit(const SharedReader<concreteprotocol::CircuitInfo> &circuitInfo,
                 std::vector<InputTransformer> inputTransformers,
+                std::vector<StreamInputTransformer> streamInputTransformers,
+                std::vector<BatchInputTransformer> batchInputTransformers,
                 std::vector<OutputTransformer> outputTransformers,
+                std::vector<BatchOutputTransformer> batchOutputTransformers,
+                std::shared_ptr<csprng::EncryptionCSPRNG> csprng,
+                std::vector<std::optional<PrecomputableEncryption>>
+                    precomputableEncryptions,
+                std::vector<InputTransformer> precomputedInputTransformers,
                 bool simulated)
       : circuitInfo(circuitInfo), inputTransformers(inputTransformers),
-        outputTransformers(outputTransformers), simulated(simulated){};
+        streamInputTransformers(streamInputTransformers),
+        batchInputTransformers(batchInputTransformers),
+        outputTransformers(outputTransformers),
+        batchOutputTransformers(batchOutputTransformers),
+        csprng(csprng), precomputableEncryptions(precomputableEncryptions),
+        precomputedInputTransformers(precomputedInputTransformers),
+        simulated(simulated){};
   static Result<ClientCircuit>
-  create(const Message<concreteprotocol::CircuitInfo> &info,
+  create(const SharedReader<concreteprotocol::CircuitInfo> &info,
          const ClientKeyset &keyset,
          std::shared_ptr<csprng::EncryptionCSPRNG> csprng, bool useSimulation);
 
 private:
-  Message<concreteprotocol::CircuitInfo> circuitInfo;
+  /// A view on the program info shared by the circuits of the program.
+  SharedReader<concreteprotocol::CircuitInfo> circuitInfo;
   std::vector<InputTransformer> inputTransformers;
+  /// Empty for the inputs which cannot be streamed
+  std::vector<StreamInputTransformer> streamInputTransformers;
+  /// Empty for the inputs which are prepared one sample at a time
+  std::vector<BatchInputTransformer> batchInputTransformers;
   std::vector<OutputTransformer> outputTransformers;
+  /// Empty for the outputs which are processed one sample at a time
+  std::vector<BatchOutputTransformer> batchOutputTransformers;
+  std::shared_ptr<csprng::EncryptionCSPRNG> csprng;
+  /// The encryption of the ciphertexts of each input, whose encryptions of
+  /// zero are precomputed in the pools of `csprng`, none for the inputs which
+  /// cannot use them
+  std::vector<std::optional<PrecomputableEncryption>> precomputableEncryptions;
+  /// Empty for the inputs without encryptions of zero
+  std::vector<InputTransformer> precomputedInputTransformers;
   bool simulated;
 };
 
@@ -31,9 +31,28 @@ std::vector<int64_t> crt(std::vector<int64_t> moduli, uint64_t val);
 /// \param remainders The remainders of the decomposition.
 uint64_t iCrt(std::vector<int64_t> moduli, std::vector<int64_t> remainders);
 
+/// Compute the coefficients of the inverse of the crt decomposition, i.e. the
+/// inverse of `remainders` is the sum of `remainders[i] * coefficients[i]`
+/// modulo the product of moduli.
+///
+/// \param moduli The moduli used to compute the inverse decomposition.
+/// \returns The coefficients, one per modulus.
+std::vector<int64_t> iCrtCoefficients(const std::vector<int64_t> &moduli);
+
 /// Encode the plaintext with the given modulus and the product of moduli of the
 /// crt decomposition
-uint64_t encode(int64_t plaintext, uint64_t modulus, uint64_t product);
+///
+/// This is inline, as it is also used by the header only lookup table
+/// encodings, see `LutEncoding.h`.
+inline uint64_t encode(int64_t plaintext, uint64_t modulus, uint64_t product) {
+  // values are represented on the interval [0; product[ so we represent
+  // plaintext on this interval
+  if (plaintext < 0) {
+    plaintext = product + plaintext;
+  }
+  __uint128_t m = plaintext % modulus;
+  return m * ((__uint128_t)(1) << 64) / modulus;
+}
 
 /// Decode follow the crt encoding
 uint64_t decode(uint64_t val, uint64_t modulus);
@@ -8,13 +8,31 @@
 
 #include "concrete-cpu.h"
 #include <cassert>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace concretelang {
 namespace csprng {
 
 void getRandomSeed(struct Uint128 *u128);
 
+/// Returns the backend of the csprngs constructed from now on, that is the
+/// fastest one available on this cpu (AES-NI, ARMv8 AES or software), unless
+/// another one was selected with `setCsprngBackend` or with the
+/// `CONCRETE_CSPRNG_BACKEND` environment variable.
+CsprngBackend getCsprngBackend();
+
+/// Selects the backend of the csprngs constructed from now on, the ones
+/// already constructed keep theirs. Returns false if it is not available on
+/// this cpu.
+bool setCsprngBackend(CsprngBackend backend);
+
+/// Returns the name of `backend`, e.g. to report the active one.
+const char *getCsprngBackendName(CsprngBackend backend);
+
 template <typename Csprng> class CSPRNG {
 public:
   Csprng *ptr;
@@ -48,6 +66,8 @@ public:
   ~SecretCSPRNG();
 };
 
+class EncryptionRandomnessPool;
+
 class EncryptionCSPRNG : public CSPRNG<EncCsprng> {
 public:
   EncryptionCSPRNG(__uint128_t seed);
@@ -55,10 +75,109 @@ public:
   EncryptionCSPRNG(EncryptionCSPRNG &) = delete;
   EncryptionCSPRNG(EncryptionCSPRNG &&other);
   ~EncryptionCSPRNG();
+
+  /// Returns a generator seeded from the stream of this one. The generators
+  /// forked in sequence only depend on the seed of this one, so they can then
+  /// be used concurrently, with the same result whatever the scheduling.
+  EncryptionCSPRNG fork();
+
+  /// Enables the buffered mode, where the randomness of the encryptions made
+  /// with this generator is generated ahead of time, in blocks of
+  /// `blockSize` ciphertexts, on a background thread if `background`.
+  void enableBuffering(size_t blockSize, bool background = true);
+
+  /// Returns the pool of randomness of the encryptions of dimension
+  /// `lweDimension` with noise `variance`, created on first use, or nullptr
+  /// if the buffered mode is disabled.
+  EncryptionRandomnessPool *getRandomnessPool(size_t lweDimension,
+                                              double variance);
+
+  /// Returns the pool of the encryptions of dimension `lweDimension` with
+  /// noise `variance`, to precompute encryptions of zero with, whether the
+  /// buffered mode is enabled or not, or nullptr if there is none yet and not
+  /// `create`. Without the buffered mode, the pool generates its randomness
+  /// on demand. Creating a pool forks this generator, and thus must not run
+  /// concurrently with the encryptions made with it.
+  EncryptionRandomnessPool *getPrecomputationPool(size_t lweDimension,
+                                                  double variance,
+                                                  bool create);
+
+private:
+  EncryptionCSPRNG(EncCsprng *ptr);
+
+  EncryptionRandomnessPool *getPool(size_t lweDimension, double variance,
+                                    bool onlyBuffered, bool create);
+
+  struct Pools;
+  std::unique_ptr<Pools> pools;
+};
+
+/// The randomness of the encryptions of LWE ciphertexts of a given dimension
+/// and noise, i.e. their masks and noises, generated ahead of time in blocks
+/// with its own generator, so that encrypting at request time mostly costs
+/// the dot products of the masks with the key.
+class EncryptionRandomnessPool {
+public:
+  /// The next block is generated on a background thread while the current
+  /// one is consumed if `background`, on demand otherwise. The randomness
+  /// taken from the pool does not depend on it.
+  EncryptionRandomnessPool(EncryptionCSPRNG csprng, size_t lweDimension,
+                           double variance, size_t blockSize,
+                           bool background);
+  EncryptionRandomnessPool(EncryptionRandomnessPool &) = delete;
+
+  /// Writes the randomness of the next `count` ciphertexts to `output`, laid
+  /// out as encryptions of zero under the zero key, to be completed with
+  /// `concrete_cpu_encrypt_lwe_ciphertext_vector_with_randomness_u64`.
+  void take(uint64_t *output, size_t count);
+
+  /// Encrypts `count` more ciphertexts of zero under the secret key `key`
+  /// ahead of time, e.g. in idle time or on a background thread,
+  /// concurrently with `takeEncryptions`. The encryption of a message is an
+  /// encryption of zero whose body is added the encoded message, so that the
+  /// dot products of the masks with the key are paid offline too.
+  void precomputeEncryptions(std::shared_ptr<const std::vector<uint64_t>> key,
+                             size_t count);
+
+  /// Writes `count` encryptions of zero under `key` to `output`, the ones
+  /// missing from the pool being encrypted on the spot.
+  void takeEncryptions(std::shared_ptr<const std::vector<uint64_t>> key,
+                       uint64_t *output, size_t count);
+
+  /// Returns the number of encryptions of zero under `key` in the pool.
+  size_t
+  getPrecomputedEncryptions(std::shared_ptr<const std::vector<uint64_t>> key);
+
+private:
+  std::vector<uint64_t> generateBlock();
+
+  void encrypt(const uint64_t *key, uint64_t *output, size_t count);
+
+  /// The encryptions of zero precomputed under a secret key, which are
+  /// dropped with it, as the address of a freed key may be reused
+  struct Encryptions {
+    std::weak_ptr<const std::vector<uint64_t>> key;
+    std::vector<uint64_t> ciphertexts;
+  };
+  std::vector<uint64_t> &
+  getEncryptions(std::shared_ptr<const std::vector<uint64_t>> key);
+
+  std::mutex mutex;
+  EncryptionCSPRNG csprng;
+  size_t lweDimension;
+  double variance;
+  size_t blockSize;
+  bool background;
+  std::vector<uint64_t> block;
+  size_t offset = 0;
+  /// The next block, generated on the background thread
+  std::future<std::vector<uint64_t>> nextBlock;
+  std::mutex encryptionsMutex;
+  std::map<const std::vector<uint64_t> *, Encryptions> encryptions;
 };
 
 void writeSeed(struct Uint128 seed, uint64_t *buffer);
-void readSeed(struct Uint128 &seed, uint64_t *buffer);
+void readSeed(struct Uint128 &seed, const uint64_t *buffer);
 
 } // namespace csprng
 } // namespace concretelang
@@ -0,0 +1,103 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_COMMON_HUGEPAGES_H
+#define CONCRETELANG_COMMON_HUGEPAGES_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+
+namespace concretelang {
+namespace huge_pages {
+
+/// How the large buffers of the keys and of the ciphertexts are backed.
+enum class Policy {
+  /// Regular pages.
+  NONE,
+  /// Transparent huge pages, which the kernel may back with 2MB pages.
+  TRANSPARENT,
+  /// Pages of 2MB reserved in the hugetlb pool of the kernel.
+  EXPLICIT_2MB,
+  /// Pages of 1GB reserved in the hugetlb pool of the kernel, for the
+  /// buffers of 1GB or more, the smaller ones taking 2MB pages.
+  EXPLICIT_1GB,
+};
+
+/// The size from which buffers are worth backing with huge pages.
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/// Returns the policy of the buffers allocated from now on, which is set with
+/// `setPolicy` or with the `CONCRETE_HUGE_PAGES` environment variable
+/// (`off`, `transparent`, `2mb` or `1gb`, `off` by default).
+Policy getPolicy();
+
+/// Sets the policy of the buffers allocated from now on, the ones already
+/// allocated keep theirs.
+void setPolicy(Policy policy);
+
+/// Returns the name of `policy`, as accepted by `CONCRETE_HUGE_PAGES`.
+const char *getPolicyName(Policy policy);
+
+/// Returns the policy named `name`, as in `CONCRETE_HUGE_PAGES`, if any.
+std::optional<Policy> getPolicyByName(const char *name);
+
+/// Allocates `size` bytes following the current policy, page aligned. The
+/// explicit huge pages fall back to transparent ones when the hugetlb pool
+/// of the kernel is exhausted. Returns nullptr if the allocation failed.
+void *allocate(size_t size);
+
+/// Allocates `size` bytes following `policy` rather than the current one.
+void *allocate(size_t size, Policy policy);
+
+/// Frees a buffer allocated by `allocate`.
+void deallocate(void *ptr, size_t size);
+
+/// Advises the kernel to back the buffer of `size` bytes at `ptr`, allocated
+/// elsewhere, with transparent huge pages unless the policy is `NONE`. Only
+/// the huge pages fully inside the buffer are affected.
+void advise(void *ptr, size_t size);
+
+/// Allocator of the containers of the large buffers, e.g. the Fourier
+/// bootstrap keys, which takes its buffers of `HUGE_PAGE_SIZE` bytes or more
+/// from `allocate`.
+template <typename T> class Allocator {
+public:
+  using value_type = T;
+
+  Allocator() = default;
+  template <typename U> Allocator(const Allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    size_t size = n * sizeof(T);
+    if (size < HUGE_PAGE_SIZE)
+      return std::allocator<T>().allocate(n);
+    void *ptr = huge_pages::allocate(size);
+    if (ptr == nullptr)
+      throw std::bad_alloc();
+    return static_cast<T *>(ptr);
+  }
+
+  void deallocate(T *ptr, size_t n) {
+    size_t size = n * sizeof(T);
+    if (size < HUGE_PAGE_SIZE)
+      std::allocator<T>().deallocate(ptr, n);
+    else
+      huge_pages::deallocate(ptr, size);
+  }
+
+  template <typename U> bool operator==(const Allocator<U> &) const {
+    return true;
+  }
+  template <typename U> bool operator!=(const Allocator<U> &) const {
+    return false;
+  }
+};
+
+} // namespace huge_pages
+} // namespace concretelang
+
+#endif
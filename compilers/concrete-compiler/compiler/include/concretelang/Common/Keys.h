@@ -9,8 +9,11 @@
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Protocol.h"
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdlib.h>
 #include <vector>
 
@@ -32,6 +35,37 @@ inline void getApproval() {
 namespace concretelang {
 namespace keys {
 
+/// Returns the number of seeded keys decompressed by this process so far.
+uint64_t getKeyDecompressionCount();
+
+/// A read-only view over the words of a key buffer, which either lives on the
+/// heap or points directly into a read-only mapping of a serialized keyset.
+/// The view keeps its backing storage alive.
+class KeyBuffer {
+public:
+  KeyBuffer(std::shared_ptr<std::vector<uint64_t>> vector)
+      : owner(vector), ptr(vector->data()), length(vector->size()){};
+  KeyBuffer(std::shared_ptr<const void> owner, const uint64_t *ptr,
+            size_t length)
+      : owner(owner), ptr(ptr), length(length){};
+
+  const uint64_t *data() const { return ptr; }
+  size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+  const uint64_t *begin() const { return ptr; }
+  const uint64_t *end() const { return ptr + length; }
+
+  bool operator==(const KeyBuffer &other) const {
+    return length == other.length && std::equal(begin(), end(), other.begin());
+  }
+  bool operator!=(const KeyBuffer &other) const { return !(*this == other); }
+
+private:
+  std::shared_ptr<const void> owner;
+  const uint64_t *ptr;
+  size_t length;
+};
+
 /// An object representing an lwe Secret key
 class LweSecretKey {
   friend class Keyset;
@@ -39,6 +73,7 @@ class LweSecretKey {
   friend class LweBootstrapKey;
   friend class LweKeyswitchKey;
   friend class PackingKeyswitchKey;
+  friend class GlwePackingKeyswitchKey;
 
 public:
   typedef Message<concreteprotocol::LweSecretKeyInfo> InfoType;
@@ -69,6 +104,12 @@ public:
     return getBuffer();
   };
 
+  /// Returns the buffer shared by the copies of the key, which identifies
+  /// them.
+  std::shared_ptr<const std::vector<uint64_t>> getSharedBuffer() const {
+    return buffer;
+  }
+
 private:
   std::shared_ptr<std::vector<uint64_t>> buffer;
   Message<concreteprotocol::LweSecretKeyInfo> info;
@@ -91,7 +132,7 @@ public:
                   Message<concreteprotocol::LweBootstrapKeyInfo> info)
       : seededBuffer(std::make_shared<std::vector<uint64_t>>()), buffer(buffer),
         info(info), decompress_mutext(std::make_shared<std::mutex>()),
-        decompressed(std::make_shared<bool>(false)){};
+        decompressed(std::make_shared<std::atomic<bool>>(false)){};
 
   /// @brief Initialize the key from the protocol message.
   static LweBootstrapKey
@@ -101,23 +142,45 @@ public:
   static LweBootstrapKey
   fromProto(concreteprotocol::LweBootstrapKey::Reader reader);
 
+  /// @brief Initialize the key from a reader over a mapped message, the
+  /// payload is used in place when it is contiguous, `mapping` being kept
+  /// alive as long as the key.
+  static LweBootstrapKey
+  fromProto(concreteprotocol::LweBootstrapKey::Reader reader,
+            std::shared_ptr<const void> mapping);
+
   /// @brief Returns the serialized form of the key.
   Message<concreteprotocol::LweBootstrapKey> toProto() const;
 
   const Message<concreteprotocol::LweBootstrapKeyInfo> &getInfo() const;
 
-  const std::vector<uint64_t> &getBuffer();
+  KeyBuffer getBuffer();
 
-  const std::vector<uint64_t> &getTransportBuffer() const;
+  KeyBuffer getTransportBuffer() const;
 
+  /// @brief Expands a seeded key, once, on the threads of the concrete-cpu
+  /// pool. The key can be used concurrently, the users wait for the end of
+  /// a decompression in progress.
   void decompress();
 
+  /// @brief Drops the standard and seeded buffers of this copy of the key,
+  /// once converted to the forms it is used in. The key keeps its info and
+  /// its identity, the buffers are freed with their last copy.
+  void releaseBuffers();
+
+  /// @brief Returns the state shared by the copies of the key, which
+  /// identifies them even once their buffers are released.
+  std::shared_ptr<const void> getIdentity() const { return decompressed; }
+
+  /// @brief Whether `other` is a copy of this key or holds the same buffer.
+  bool isSameKey(const LweBootstrapKey &other) const;
+
 private:
   LweBootstrapKey(Message<concreteprotocol::LweBootstrapKeyInfo> info)
       : seededBuffer(std::make_shared<std::vector<uint64_t>>()),
         buffer(std::make_shared<std::vector<uint64_t>>()), info(info),
         decompress_mutext(std::make_shared<std::mutex>()),
-        decompressed(std::make_shared<bool>(false)){};
+        decompressed(std::make_shared<std::atomic<bool>>(false)){};
   LweBootstrapKey() = delete;
 
   /// @brief  The buffer of the seeded key if needed.
@@ -126,6 +189,9 @@ private:
   /// @brief The buffer of the actual bootstrap key.
   std::shared_ptr<std::vector<uint64_t>> buffer;
 
+  /// @brief The serialized buffer when it points into a mapped keyset.
+  std::optional<KeyBuffer> mapped;
+
   /// @brief The metadata of the bootrap key.
   Message<concreteprotocol::LweBootstrapKeyInfo> info;
 
@@ -133,7 +199,7 @@ private:
   std::shared_ptr<std::mutex> decompress_mutext;
 
   /// @brief A boolean that indicates if the decompression is done or not
-  std::shared_ptr<bool> decompressed;
+  std::shared_ptr<std::atomic<bool>> decompressed;
 };
 
 class LweKeyswitchKey {
@@ -147,7 +213,7 @@ public:
                   Message<concreteprotocol::LweKeyswitchKeyInfo> info)
       : seededBuffer(std::make_shared<std::vector<uint64_t>>()), buffer(buffer),
         info(info), decompress_mutext(std::make_shared<std::mutex>()),
-        decompressed(std::make_shared<bool>(false)){};
+        decompressed(std::make_shared<std::atomic<bool>>(false)){};
 
   /// @brief Initialize the key from the protocol message.
   static LweKeyswitchKey
@@ -157,15 +223,25 @@ public:
   static LweKeyswitchKey
   fromProto(concreteprotocol::LweKeyswitchKey::Reader reader);
 
+  /// @brief Initialize the key from a reader over a mapped message, the
+  /// payload is used in place when it is contiguous, `mapping` being kept
+  /// alive as long as the key.
+  static LweKeyswitchKey
+  fromProto(concreteprotocol::LweKeyswitchKey::Reader reader,
+            std::shared_ptr<const void> mapping);
+
   /// @brief Returns the serialized form of the key.
   Message<concreteprotocol::LweKeyswitchKey> toProto() const;
 
   const Message<concreteprotocol::LweKeyswitchKeyInfo> &getInfo() const;
 
-  const std::vector<uint64_t> &getBuffer();
+  KeyBuffer getBuffer();
 
-  const std::vector<uint64_t> &getTransportBuffer() const;
+  KeyBuffer getTransportBuffer() const;
 
+  /// @brief Expands a seeded key, once, on the threads of the concrete-cpu
+  /// pool. The key can be used concurrently, the users wait for the end of
+  /// a decompression in progress.
   void decompress();
 
 private:
@@ -173,7 +249,7 @@ private:
       : seededBuffer(std::make_shared<std::vector<uint64_t>>()),
         buffer(std::make_shared<std::vector<uint64_t>>()), info(info),
         decompress_mutext(std::make_shared<std::mutex>()),
-        decompressed(std::make_shared<bool>(false)){};
+        decompressed(std::make_shared<std::atomic<bool>>(false)){};
 
   /// @brief  The buffer of the seeded key if needed.
   std::shared_ptr<std::vector<uint64_t>> seededBuffer;
@@ -181,6 +257,9 @@ private:
   /// @brief The buffer of the actual bootstrap key.
   std::shared_ptr<std::vector<uint64_t>> buffer;
 
+  /// @brief The serialized buffer when it points into a mapped keyset.
+  std::optional<KeyBuffer> mapped;
+
   /// @brief The metadata of the bootrap key.
   Message<concreteprotocol::LweKeyswitchKeyInfo> info;
 
@@ -188,7 +267,7 @@ private:
   std::shared_ptr<std::mutex> decompress_mutext;
 
   /// @brief A boolean that indicates if the decompression is done or not
-  std::shared_ptr<bool> decompressed;
+  std::shared_ptr<std::atomic<bool>> decompressed;
 };
 
 class PackingKeyswitchKey {
@@ -212,6 +291,10 @@ public:
   static PackingKeyswitchKey
   fromProto(concreteprotocol::PackingKeyswitchKey::Reader reader);
 
+  static PackingKeyswitchKey
+  fromProto(concreteprotocol::PackingKeyswitchKey::Reader reader,
+            std::shared_ptr<const void> mapping);
+
   Message<concreteprotocol::PackingKeyswitchKey> toProto() const;
 
   const uint64_t *getRawPtr() const;
@@ -220,17 +303,76 @@ public:
 
   const Message<concreteprotocol::PackingKeyswitchKeyInfo> &getInfo() const;
 
-  const std::vector<uint64_t> &getBuffer() const;
+  KeyBuffer getBuffer() const;
 
-  const std::vector<uint64_t> &getTransportBuffer() const {
-    return getBuffer();
-  };
+  KeyBuffer getTransportBuffer() const { return getBuffer(); };
 
 private:
+  PackingKeyswitchKey(KeyBuffer mapped,
+                      Message<concreteprotocol::PackingKeyswitchKeyInfo> info)
+      : buffer(std::make_shared<std::vector<uint64_t>>()), mapped(mapped),
+        info(info){};
+
   std::shared_ptr<std::vector<uint64_t>> buffer;
+  std::optional<KeyBuffer> mapped;
   Message<concreteprotocol::PackingKeyswitchKeyInfo> info;
 };
 
+/// A keyswitch key packing up to `polynomialSize` lwe ciphertexts in a single
+/// glwe ciphertext, used to compress the ciphertexts returned to the client.
+class GlwePackingKeyswitchKey {
+public:
+  typedef Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> InfoType;
+
+  GlwePackingKeyswitchKey(
+      Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> info,
+      const LweSecretKey &inputKey, const LweSecretKey &outputKey,
+      concretelang::csprng::EncryptionCSPRNG &csprng);
+  GlwePackingKeyswitchKey() = delete;
+  GlwePackingKeyswitchKey(
+      std::shared_ptr<std::vector<uint64_t>> buffer,
+      Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> info)
+      : buffer(buffer), info(info){};
+
+  static GlwePackingKeyswitchKey
+  fromProto(const Message<concreteprotocol::GlwePackingKeyswitchKey> &proto);
+
+  static GlwePackingKeyswitchKey
+  fromProto(concreteprotocol::GlwePackingKeyswitchKey::Reader reader);
+
+  static GlwePackingKeyswitchKey
+  fromProto(concreteprotocol::GlwePackingKeyswitchKey::Reader reader,
+            std::shared_ptr<const void> mapping);
+
+  Message<concreteprotocol::GlwePackingKeyswitchKey> toProto() const;
+
+  const uint64_t *getRawPtr() const;
+
+  size_t getSize() const;
+
+  const Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> &
+  getInfo() const;
+
+  KeyBuffer getBuffer() const;
+
+  KeyBuffer getTransportBuffer() const { return getBuffer(); };
+
+  /// Packs the `count` lwe ciphertexts of `input` in `output`, a list of
+  /// `ceil(count / polynomialSize)` glwe ciphertexts.
+  void pack(const uint64_t *input, size_t count, uint64_t *output) const;
+
+private:
+  GlwePackingKeyswitchKey(
+      KeyBuffer mapped,
+      Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> info)
+      : buffer(std::make_shared<std::vector<uint64_t>>()), mapped(mapped),
+        info(info){};
+
+  std::shared_ptr<std::vector<uint64_t>> buffer;
+  std::optional<KeyBuffer> mapped;
+  Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> info;
+};
+
 } // namespace keys
 } // namespace concretelang
 
@@ -12,6 +12,7 @@
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keys.h"
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <stdlib.h>
@@ -19,6 +20,7 @@
 
 using concretelang::error::Result;
 using concretelang::error::StringError;
+using concretelang::keys::GlwePackingKeyswitchKey;
 using concretelang::keys::LweBootstrapKey;
 using concretelang::keys::LweKeyswitchKey;
 using concretelang::keys::LweSecretKey;
@@ -42,11 +44,32 @@ struct ServerKeyset {
   std::vector<LweBootstrapKey> lweBootstrapKeys;
   std::vector<LweKeyswitchKey> lweKeyswitchKeys;
   std::vector<PackingKeyswitchKey> packingKeyswitchKeys;
+  std::vector<GlwePackingKeyswitchKey> glwePackingKeyswitchKeys;
 
   static ServerKeyset
   fromProto(const Message<concreteprotocol::ServerKeyset> &proto);
   static ServerKeyset fromProto(concreteprotocol::ServerKeyset::Reader reader);
 
+  /// @brief Initialize the keyset from a reader over a mapped message, the
+  /// key payloads point into `mapping` whenever they are contiguous.
+  static ServerKeyset fromProto(concreteprotocol::ServerKeyset::Reader reader,
+                                std::shared_ptr<const void> mapping);
+
+  /// @brief Loads a serialized server keyset by mapping the file read-only,
+  /// so that the key buffers are not copied to the heap and the pages are
+  /// shared through the page cache by all the processes loading the same
+  /// file. The file must not be modified while the keyset is in use.
+  static Result<ServerKeyset> fromMappedFile(const std::string &path);
+
+  /// @brief Decompresses the seeded keys, concurrently, instead of on their
+  /// first use by a call.
+  void decompress();
+
+  /// @brief Starts decompressing the seeded keys on a background thread, the
+  /// calls using a key in the meantime wait for its decompression. The keys
+  /// are kept alive until it is done.
+  std::shared_future<void> decompressInBackground();
+
   Message<concreteprotocol::ServerKeyset> toProto() const;
 };
 
@@ -81,6 +104,12 @@ struct Keyset {
   Message<concreteprotocol::Keyset> toProto() const;
 };
 
+/// A cache of generated keysets in a directory, which can be shared by
+/// concurrent processes. Each evaluation key is stored in its own entry,
+/// named after the SHA-256 hash of everything its generation depends on
+/// except the key identifiers. The keys are derived from the seeds and their
+/// parameters, so that when a keyset changes, only the keys which changed
+/// are generated, the others being shared with the previous keyset.
 class KeysetCache {
   std::string backingDirectoryPath;
 
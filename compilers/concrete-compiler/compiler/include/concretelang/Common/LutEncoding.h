@@ -0,0 +1,215 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_COMMON_LUT_ENCODING_H_
+#define CONCRETELANG_COMMON_LUT_ENCODING_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "concretelang/Common/CRT.h"
+
+namespace concretelang {
+namespace lut {
+
+/// Encode and expand the lookup table `input` of `input_size` elements into
+/// `output` of `output_size` elements, so that it can be used as the body of
+/// the accumulator of a bootstrap.
+///
+/// Values are duplicated to fill mega cases, taking care of the encoding and
+/// the half mega case shift in the process as well. All sizes should be powers
+/// of 2.
+///
+/// This is header only, as it is shared by the runtime (for lookup tables
+/// only known at execution time) and the compiler (to fold the encoding of
+/// constant lookup tables).
+inline void encodeExpandLutForBootstrap(uint64_t *output, size_t output_size,
+                                        const uint64_t *input,
+                                        size_t input_size,
+                                        uint32_t out_MESSAGE_BITS,
+                                        bool is_signed) {
+  size_t mega_case_size = output_size / input_size;
+
+  assert((mega_case_size % 2) == 0);
+
+  // When the bootstrap is executed on encrypted signed integers, the lut must
+  // be half-rotated. This map takes care about properly indexing into the input
+  // lut depending on what bootstrap gets executed.
+  size_t halfInputSize = input_size / 2;
+  auto indexMap = [=](size_t idx) {
+    if (!is_signed)
+      return idx;
+    if (idx < halfInputSize)
+      return idx + halfInputSize;
+    return idx - halfInputSize;
+  };
+
+  // The first lut value should be centered over zero. This means that half of
+  // it should appear at the beginning of the output lut, and half of it at the
+  // end (but negated).
+  for (size_t idx = 0; idx < mega_case_size / 2; ++idx) {
+    output[idx] = input[indexMap(0)] << (64 - out_MESSAGE_BITS - 1);
+  }
+  for (size_t idx = (input_size - 1) * mega_case_size + mega_case_size / 2;
+       idx < output_size; ++idx) {
+    output[idx] = -(input[indexMap(0)] << (64 - out_MESSAGE_BITS - 1));
+  }
+
+  // Treats the other ut values.
+  for (size_t lut_idx = 1; lut_idx < input_size; ++lut_idx) {
+    uint64_t lut_value = input[indexMap(lut_idx)]
+                         << (64 - out_MESSAGE_BITS - 1);
+    size_t start = mega_case_size * (lut_idx - 1) + mega_case_size / 2;
+    for (size_t output_idx = start; output_idx < start + mega_case_size;
+         ++output_idx) {
+      output[output_idx] = lut_value;
+    }
+  }
+}
+
+/// Encode, interleave and expand the `lut_count` lookup tables of `input`,
+/// stored row-major as `lut_count` rows of `input_size` elements, into the
+/// single lookup table `output` of `output_size` elements evaluated by a
+/// many-LUT bootstrap.
+///
+/// The box of each message is split into `lut_count` sub-boxes, the `j`-th
+/// one holding the value of the `j`-th function, so this is the regular
+/// encoding of the interleaved table `f_0(0), f_1(0), ..., f_0(1), ...`. After
+/// the blind rotation, the `j`-th function is found at coefficient
+/// `j * manyLutStride(output_size, input_size, lut_count)`.
+inline void encodeExpandManyLutForBootstrap(
+    uint64_t *output, size_t output_size, const uint64_t *input,
+    size_t lut_count, size_t input_size, uint32_t out_MESSAGE_BITS,
+    bool is_signed) {
+  std::vector<uint64_t> interleaved(lut_count * input_size);
+  for (size_t lut_idx = 0; lut_idx < lut_count; ++lut_idx) {
+    for (size_t msg = 0; msg < input_size; ++msg) {
+      interleaved[msg * lut_count + lut_idx] =
+          input[lut_idx * input_size + msg];
+    }
+  }
+  encodeExpandLutForBootstrap(output, output_size, interleaved.data(),
+                              interleaved.size(), out_MESSAGE_BITS, is_signed);
+}
+
+/// Distance, in coefficients, between two consecutive functions packed by
+/// `encodeExpandManyLutForBootstrap`.
+inline size_t manyLutStride(size_t poly_size, size_t input_size,
+                            size_t lut_count) {
+  return poly_size / (input_size * lut_count);
+}
+
+/// Encode the lookup table `input` of `input_size` elements for a wop-pbs
+/// on CRT ciphertexts into `output`, made of `output_size0` rows of
+/// `output_size1` elements, one row per block of the `crt_decomp_size`
+/// blocks of the decomposition `crt_decomp`, of `crt_bits` bits each.
+inline void encodeLutForCrtWopPBS(uint64_t *output, size_t output_size0,
+                                  size_t output_size1, const uint64_t *input,
+                                  size_t input_size, const uint64_t *crt_decomp,
+                                  const uint64_t *crt_bits,
+                                  size_t crt_decomp_size,
+                                  uint64_t modulus_product, bool is_signed) {
+  // Initialize lut cases not supposed to be reached
+  for (size_t i = 0; i < output_size0 * output_size1; i++) {
+    output[i] = 0;
+  }
+
+  // When the woppbs is executed on encrypted signed integers, the index of the
+  // lut elements must be adapted to fit the way signed are encrypted in CRT
+  // (to ensure the lookup falls into the proper case).
+  //
+  // When not signed, the integer values are encoded in increasing order. That
+  // is (example of 9 bits values, using crt decomposition [5,7,16]):
+  //
+  // |0     511|
+  // |---------|
+  // |0     511|
+  //
+  // is encoded as
+  //
+  // |0   511|  INVALID  |
+  // |-------|-----------|
+  // |0   511|512     559|
+  //
+  // Where on top are represented the semantic values, and below, the actual
+  // encoding of values, either on uint64_t or as increasing crt values.
+  //
+  // As a consequence, there is nothing particular to do to map the index of
+  // the input lut to an index of the output lut.
+  //
+  // When signed, the integer values are encoded in a way that resembles 2s
+  // complement. That is (example of 9 bits values, using crt decomposition
+  // [5,7,16]):
+  //
+  // |0     255|-256    -1|
+  // |---------|----------|
+  // |0     255|256    511|
+  //
+  // is encoded as
+  //
+  // |0     255|   INVALID   |-256    -1|
+  // |---------|-------------|----------|
+  // |0     255|256       303|304    559|
+  //
+  // As a consequence, to map the index of the input lut to an index of the
+  // output lut we must take care of crossing the invalid range in between
+  // positive values and negative values.
+  auto indexMap = [=](uint64_t plaintext) {
+    if (is_signed && plaintext >= (input_size / 2)) {
+      plaintext += modulus_product - input_size;
+    }
+    return plaintext;
+  };
+
+  uint64_t log_lut_crt_size = 0;
+  for (size_t in_block = 0; in_block < crt_decomp_size; in_block++) {
+    log_lut_crt_size += crt_bits[in_block];
+  }
+
+  uint64_t lut_crt_size = uint64_t(1) << log_lut_crt_size;
+  assert(lut_crt_size == output_size1);
+  assert(crt_decomp_size == output_size0);
+
+  for (uint64_t in_index = 0; in_index < input_size; in_index++) {
+    uint64_t out_index = 0;
+
+    {
+      uint64_t total_bit_count = 0;
+      for (size_t in_block = 0; in_block < crt_decomp_size; in_block++) {
+        auto in_base = crt_decomp[in_block];
+        auto bits_count = crt_bits[in_block];
+        out_index += (((indexMap(in_index) % in_base) << bits_count) / in_base)
+                     << total_bit_count;
+        total_bit_count += bits_count;
+      }
+    }
+
+    for (size_t out_block = 0; out_block < crt_decomp_size; out_block++) {
+      output[out_block * lut_crt_size + out_index] = concretelang::crt::encode(
+          input[in_index], crt_decomp[out_block], modulus_product);
+    }
+  }
+}
+
+/// Write the trivial GLWE encryption of the (already encoded and expanded)
+/// lookup table `lut` of `poly_size` elements into `glwe_ct`, i.e. the
+/// accumulator of a bootstrap, made of `glwe_dim` zero masks followed by the
+/// lookup table as body.
+inline void trivialGlweAccumulator(uint64_t *glwe_ct, const uint64_t *lut,
+                                   size_t glwe_dim, size_t poly_size) {
+  for (size_t i = 0; i < poly_size * glwe_dim; i++) {
+    glwe_ct[i] = 0;
+  }
+  for (size_t i = 0; i < poly_size; i++) {
+    glwe_ct[poly_size * glwe_dim + i] = lut[i];
+  }
+}
+
+} // namespace lut
+} // namespace concretelang
+
+#endif
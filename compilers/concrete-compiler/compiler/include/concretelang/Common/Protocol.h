@@ -35,6 +35,21 @@ const uint64_t MAX_SEGMENT_SIZE = capnp::MAX_SEGMENT_WORDS;
 namespace concretelang {
 namespace protocol {
 
+/// The number of words of the scratch segments of the messages.
+const size_t SCRATCH_SEGMENT_WORDS = capnp::SUGGESTED_FIRST_SEGMENT_WORDS;
+
+/// Returns a zeroed segment of `SCRATCH_SEGMENT_WORDS` words, taken from the
+/// segments released by the current thread if any.
+///
+/// The small messages, e.g. the transport values of the scalar arguments, are
+/// built in such a segment instead of allocating the first segment of their
+/// arena, so that serving many calls reuses the same few segments.
+kj::ArrayPtr<capnp::word> takeScratchSegment();
+
+/// Releases `segment`, taken by `takeScratchSegment` and zeroed again, to be
+/// reused by the next messages of the current thread.
+void releaseScratchSegment(kj::ArrayPtr<capnp::word> segment);
+
 /// Arena carrying capnp messages.
 ///
 /// This type packs a message with an arena used to store the data in a single
@@ -65,35 +80,26 @@ namespace protocol {
 template <typename MessageType> struct Message {
 
   Message() : message(nullptr) {
-    regionBuilder = new capnp::MallocMessageBuilder();
+    allocate(0);
     message = regionBuilder->initRoot<MessageType>();
   }
 
   explicit Message(const typename MessageType::Reader &reader)
       : message(nullptr) {
-    regionBuilder = new capnp::MallocMessageBuilder(
-        std::min(reader.totalSize().wordCount, MAX_SEGMENT_SIZE),
-        capnp::AllocationStrategy::FIXED_SIZE);
+    allocate(reader.totalSize().wordCount);
     regionBuilder->setRoot(reader);
     message = regionBuilder->getRoot<MessageType>();
   }
 
   Message(const Message &input) : message(nullptr) {
-    regionBuilder = new capnp::MallocMessageBuilder(
-        std::min(input.message.asReader().totalSize().wordCount,
-                 MAX_SEGMENT_SIZE),
-        capnp::AllocationStrategy::FIXED_SIZE);
+    allocate(input.message.asReader().totalSize().wordCount);
     regionBuilder->setRoot(input.message.asReader());
     message = regionBuilder->getRoot<MessageType>();
   }
 
   Message &operator=(const typename MessageType::Reader &reader) {
-    if (regionBuilder) {
-      delete regionBuilder;
-    }
-    regionBuilder = new capnp::MallocMessageBuilder(
-        std::min(reader.totalSize().wordCount, MAX_SEGMENT_SIZE),
-        capnp::AllocationStrategy::FIXED_SIZE);
+    release();
+    allocate(reader.totalSize().wordCount);
     regionBuilder->setRoot(reader);
     message = regionBuilder->getRoot<MessageType>();
     return *this;
@@ -101,13 +107,8 @@ template <typename MessageType> struct Message {
 
   Message &operator=(const Message &input) {
     if (this != &input) {
-      if (regionBuilder) {
-        delete regionBuilder;
-      }
-      regionBuilder = new capnp::MallocMessageBuilder(
-          std::min(input.message.asReader().totalSize().wordCount,
-                   MAX_SEGMENT_SIZE),
-          capnp::AllocationStrategy::FIXED_SIZE);
+      release();
+      allocate(input.message.asReader().totalSize().wordCount);
       regionBuilder->setRoot(input.message.asReader());
       message = regionBuilder->getRoot<MessageType>();
     }
@@ -129,27 +130,25 @@ template <typename MessageType> struct Message {
 
   Message(Message &&input) : message(nullptr) {
     regionBuilder = input.regionBuilder;
+    scratch = input.scratch;
     message = input.message;
     input.regionBuilder = nullptr;
+    input.scratch = nullptr;
   }
 
   Message &operator=(Message &&input) {
     if (this != &input) {
-      if (regionBuilder) {
-        delete regionBuilder;
-      }
+      release();
       regionBuilder = input.regionBuilder;
+      scratch = input.scratch;
       message = input.message;
       input.regionBuilder = nullptr;
+      input.scratch = nullptr;
     }
     return *this;
   }
 
-  ~Message() {
-    if (regionBuilder) {
-      delete regionBuilder;
-    }
-  }
+  ~Message() { release(); }
 
   typename MessageType::Reader asReader() const { return message.asReader(); }
 
@@ -191,6 +190,29 @@ template <typename MessageType> struct Message {
     return outcome::success(ostream.str());
   }
 
+  /// Returns the size of the message written by `writeBinaryToStream`.
+  size_t computeSerializedSizeInWords() const {
+    return capnp::computeSerializedSizeInWords(*regionBuilder);
+  }
+
+  /// Writes the message to `stream`, throwing a `kj::Exception` on failure.
+  void writeBinaryToStream(kj::OutputStream &stream) const {
+    capnp::writeMessage(stream, *regionBuilder);
+  }
+
+  /// Writes the message in a single array of words, copying its segments
+  /// once, to be handed out as a buffer without further copies.
+  Result<kj::Array<capnp::word>> writeBinaryToFlatArray() const {
+    try {
+      return outcome::success(capnp::messageToFlatArray(*regionBuilder));
+    } catch (const kj::Exception &e) {
+      return StringError("Failed to write message to flat array: ")
+             << e.getDescription().cStr();
+    } catch (...) {
+      return StringError("Failed to write message to flat array.");
+    }
+  }
+
   Result<std::string> writeJsonToString() const {
     try {
       capnp::JsonCodec json;
@@ -242,6 +264,24 @@ template <typename MessageType> struct Message {
     return this->readBinaryFromIstream(istream, options);
   }
 
+  /// Reads the message from `words`, which is read in place and copied once
+  /// in the arena of the message.
+  Result<void> readBinaryFromFlatArray(
+      kj::ArrayPtr<const capnp::word> words,
+      capnp::ReaderOptions options = capnp::ReaderOptions()) {
+    try {
+      capnp::FlatArrayMessageReader reader(words, options);
+      regionBuilder->setRoot(reader.getRoot<MessageType>());
+      this->message = regionBuilder->getRoot<MessageType>();
+      return outcome::success();
+    } catch (const kj::Exception &e) {
+      return StringError("Failed to read message from flat array: ")
+             << e.getDescription().cStr();
+    } catch (...) {
+      return StringError("Failed to read message from flat array.");
+    }
+  }
+
   Result<void> readJsonFromString(const std::string &input) {
     try {
       capnp::JsonCodec json;
@@ -260,29 +300,136 @@ template <typename MessageType> struct Message {
   std::string debugString() const { return writeJsonToString().value(); }
 
 private:
-  capnp::MallocMessageBuilder *regionBuilder;
+  /// Allocates the arena of a message of about `words` words, in a scratch
+  /// segment if they fit in one, or else in a single segment of their size.
+  void allocate(size_t words) {
+    if (words < SCRATCH_SEGMENT_WORDS) {
+      scratch = takeScratchSegment();
+      regionBuilder = new capnp::MallocMessageBuilder(scratch);
+    } else {
+      regionBuilder = new capnp::MallocMessageBuilder(
+          std::min(words, MAX_SEGMENT_SIZE),
+          capnp::AllocationStrategy::FIXED_SIZE);
+    }
+  }
+
+  /// Frees the arena, the builder zeroing the scratch segment beforehand.
+  void release() {
+    if (regionBuilder) {
+      delete regionBuilder;
+      regionBuilder = nullptr;
+    }
+    if (scratch.size() > 0) {
+      releaseScratchSegment(scratch);
+      scratch = nullptr;
+    }
+  }
+
+  capnp::MallocMessageBuilder *regionBuilder = nullptr;
+  kj::ArrayPtr<capnp::word> scratch = nullptr;
   typename MessageType::Builder message;
 };
 
+/// Writes `messages` one after the other in a single array of words, e.g. the
+/// transport values of all the arguments of a call, copying their segments
+/// once. The messages are only read, they are passed by pointer such that the
+/// callers don't copy them to gather them. The array is read back with
+/// `readBinaryFromFlatArray`.
+template <typename MessageType>
+Result<kj::Array<capnp::word>>
+writeBinaryToFlatArray(const std::vector<Message<MessageType> *> &messages) {
+  try {
+    size_t size = 0;
+    for (auto message : messages)
+      size += message->computeSerializedSizeInWords();
+    auto words = kj::heapArray<capnp::word>(size);
+    kj::ArrayOutputStream stream(words.asBytes());
+    for (auto message : messages)
+      message->writeBinaryToStream(stream);
+    return outcome::success(std::move(words));
+  } catch (const kj::Exception &e) {
+    return StringError("Failed to write messages to flat array: ")
+           << e.getDescription().cStr();
+  } catch (...) {
+    return StringError("Failed to write messages to flat array.");
+  }
+}
+
+/// Reads the messages written one after the other in `words` by
+/// `writeBinaryToFlatArray`, which are read in place and copied once in the
+/// arenas of the messages.
+template <typename MessageType>
+Result<std::vector<Message<MessageType>>>
+readBinaryFromFlatArray(kj::ArrayPtr<const capnp::word> words,
+                        capnp::ReaderOptions options = capnp::ReaderOptions()) {
+  try {
+    std::vector<Message<MessageType>> messages;
+    while (words.size() > 0) {
+      capnp::FlatArrayMessageReader reader(words, options);
+      messages.emplace_back(reader.getRoot<MessageType>());
+      words = kj::arrayPtr(reader.getEnd(), words.end());
+    }
+    return outcome::success(std::move(messages));
+  } catch (const kj::Exception &e) {
+    return StringError("Failed to read messages from flat array: ")
+           << e.getDescription().cStr();
+  } catch (...) {
+    return StringError("Failed to read messages from flat array.");
+  }
+}
+
+/// Read-only view on a message shared by several owners.
+///
+/// Deep copying a message allocates a new arena and copies all its words, so
+/// the information of a program, read by each of its circuits for every call,
+/// is rather moved once in a shared message, of which the circuits hold views
+/// on their part. A view keeps the whole message alive, and is cheap to copy.
+template <typename MessageType> struct SharedReader {
+
+  SharedReader() = default;
+
+  /// Moves `message` in a new shared message.
+  explicit SharedReader(Message<MessageType> &&message) {
+    auto shared =
+        std::make_shared<const Message<MessageType>>(std::move(message));
+    reader = shared->asReader();
+    owner = std::move(shared);
+  }
+
+  /// Creates a view on `reader`, a part of the message shared by `parent`.
+  template <typename ParentType>
+  SharedReader(const SharedReader<ParentType> &parent,
+               typename MessageType::Reader reader)
+      : owner(parent.getOwner()), reader(reader) {}
+
+  typename MessageType::Reader asReader() const { return reader; }
+
+  const std::shared_ptr<const void> &getOwner() const { return owner; }
+
+private:
+  std::shared_ptr<const void> owner;
+  typename MessageType::Reader reader;
+};
+
 template struct Message<concreteprotocol::ProgramInfo>;
 template struct Message<concreteprotocol::CircuitEncodingInfo>;
 template struct Message<concreteprotocol::ProgramEncodingInfo>;
 template struct Message<concreteprotocol::Value>;
 template struct Message<concreteprotocol::GateInfo>;
 
-/// Helper function turning a vector of integers to a payload.
+/// Helper function writing an array of `size` integers to the payload
+/// `builder`.
 template <typename T>
-Message<concreteprotocol::Payload>
-vectorToProtoPayload(const std::vector<T> &input) {
-  auto output = Message<concreteprotocol::Payload>();
+void arrayToProtoPayload(const T *input, size_t size,
+                         concreteprotocol::Payload::Builder builder) {
   auto elmsPerBlob = capnp::MAX_TEXT_SIZE / sizeof(T);
-  auto remainingElms = input.size() % elmsPerBlob;
-  auto nbCompleteBlobs = (input.size() / elmsPerBlob);
-  auto nbBlobs = (input.size() / elmsPerBlob) + (remainingElms > 0);
-  auto dataBuilder = output.asBuilder().initData(nbBlobs);
+  auto remainingElms = size % elmsPerBlob;
+  auto nbCompleteBlobs = (size / elmsPerBlob);
+  auto nbBlobs = (size / elmsPerBlob) + (remainingElms > 0);
+  auto dataBuilder = builder.initData(nbBlobs);
   // Process all but the last blob, which store as much as `Data` allow.
   for (size_t blobIndex = 0; blobIndex < nbCompleteBlobs; blobIndex++) {
-    auto blobPtr = input.data() + blobIndex * elmsPerBlob;
+    auto blobPtr = input + blobIndex * elmsPerBlob;
     auto blobLen = elmsPerBlob * sizeof(T);
     dataBuilder.set(
         blobIndex,
@@ -293,14 +440,28 @@ vectorToProtoPayload(const std::vector<T> &input) {
   if (remainingElms > 0) {
     assert(nbCompleteBlobs == nbBlobs - 1);
     auto lastBlobIndex = nbBlobs - 1;
-    auto lastBlobPtr = input.data() + lastBlobIndex * elmsPerBlob;
+    auto lastBlobPtr = input + lastBlobIndex * elmsPerBlob;
     auto lastBlobLen = remainingElms * sizeof(T);
     dataBuilder.set(
         lastBlobIndex,
         capnp::Data::Reader(
             reinterpret_cast<const unsigned char *>(lastBlobPtr), lastBlobLen));
   }
+}
+
+/// Helper function writing a vector of integers to the payload `builder`.
+template <typename T>
+void vectorToProtoPayload(const std::vector<T> &input,
+                          concreteprotocol::Payload::Builder builder) {
+  arrayToProtoPayload(input.data(), input.size(), builder);
+}
 
+/// Helper function turning a vector of integers to a payload.
+template <typename T>
+Message<concreteprotocol::Payload>
+vectorToProtoPayload(const std::vector<T> &input) {
+  auto output = Message<concreteprotocol::Payload>();
+  vectorToProtoPayload(input, output.asBuilder());
   return output;
 }
 
@@ -331,6 +492,32 @@ std::vector<T> protoPayloadToVector(concreteprotocol::Payload::Reader reader) {
   return output;
 }
 
+/// Helper function allocating a payload of `size` integers in `builder` and
+/// returning a pointer to its data, to be filled in place. Returns `nullptr`,
+/// leaving `builder` untouched, if the payload does not fit in a single blob.
+template <typename T>
+T *initProtoPayloadArray(size_t size,
+                         concreteprotocol::Payload::Builder builder) {
+  if (size * sizeof(T) > capnp::MAX_TEXT_SIZE) {
+    return nullptr;
+  }
+  auto blob = builder.initData(1).init(0, size * sizeof(T));
+  return reinterpret_cast<T *>(blob.begin());
+}
+
+/// Helper function returning a pointer to the integers of a payload stored in
+/// a single blob, or `nullptr` if the payload is empty or spans several blobs
+/// and must be copied with `protoPayloadToVector`.
+template <typename T>
+const T *protoPayloadArray(concreteprotocol::Payload::Reader reader) {
+  auto payloadData = reader.getData();
+  if (payloadData.size() != 1) {
+    return nullptr;
+  }
+  assert(payloadData[0].size() % sizeof(T) == 0);
+  return reinterpret_cast<const T *>(payloadData[0].begin());
+}
+
 /// Helper function turning a payload to a shared vector of integers on the
 /// heap.
 template <typename T>
@@ -7,16 +7,22 @@
 #define CONCRETELANG_COMMON_TRANSFORMERS_H
 
 #include "concrete-protocol.capnp.h"
+#include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
 #include "concretelang/Common/Values.h"
 #include <memory>
+#include <mutex>
 #include <stdlib.h>
+#include <vector>
 
 using concretelang::error::Result;
+using concretelang::keys::GlwePackingKeyswitchKey;
+using concretelang::keys::LweSecretKey;
 using concretelang::keysets::ClientKeyset;
 using concretelang::values::Tensor;
 using concretelang::values::TransportValue;
+using concretelang::values::TransportValueChunk;
 using concretelang::values::Value;
 
 namespace concretelang {
@@ -29,18 +35,72 @@ typedef std::function<Result<TransportValue>(Value)> InputTransformer;
 /// A type for output transformers, that is, functions running on the client
 /// side, that process a TransportValue fetched from the server to be used as a
 /// Value.
-typedef std::function<Result<Value>(TransportValue)> OutputTransformer;
+typedef std::function<Result<Value>(const TransportValue &)>
+    OutputTransformer;
+
+/// A type for batch input transformers, that is, functions running on the
+/// client side, that prepare the values of many samples of the same input to
+/// be sent to the server, one TransportValue per sample.
+typedef std::function<Result<std::vector<TransportValue>>(
+    const std::vector<Value> &)>
+    BatchInputTransformer;
+
+/// A type for batch output transformers, that is, functions running on the
+/// client side, that process the TransportValues of many samples of the same
+/// output fetched from the server, one Value per sample.
+typedef std::function<Result<std::vector<Value>>(
+    const std::vector<TransportValue> &)>
+    BatchOutputTransformer;
 
 /// A type for arguments transformers, that is, functions running on the server
 /// side, that transform a TransportValue fetched from the client, to be used as
 /// argument in a circuit call.
-typedef std::function<Result<Value>(TransportValue)> ArgTransformer;
+typedef std::function<Result<Value>(const TransportValue &)> ArgTransformer;
 
 /// A type for return transformers, that is, functions running on the server
 /// side, that transform a value returned from circuit call into a
 /// TransportValue to be sent to the client.
 typedef std::function<Result<TransportValue>(Value)> ReturnTransformer;
 
+/// A type for packing return transformers, that is, functions running on the
+/// server side, that transform a value returned from a circuit call into a
+/// TransportValue where its ciphertexts are packed with the key of the call.
+typedef std::function<Result<TransportValue>(Value,
+                                             const GlwePackingKeyswitchKey &)>
+    PackingReturnTransformer;
+
+/// A TransportValue prepared in chunks, so that its whole payload never has to
+/// be held in memory at once.
+struct TransportValueStream {
+  /// The transport value without its payload, to be sent before the chunks.
+  TransportValue header;
+  /// The number of chunks of the payload.
+  size_t chunkCount;
+  /// Prepares the chunk `index`. The chunks are prepared on demand, in order
+  /// and from one thread at a time.
+  std::function<Result<TransportValueChunk>(size_t index)> getChunk;
+};
+
+/// A type for streaming input transformers, that is, functions running on the
+/// client side, that prepare a Value to be sent to the server in chunks, each
+/// holding the transport data of at most `chunkSize` elements of the value.
+typedef std::function<Result<TransportValueStream>(Value, size_t chunkSize)>
+    StreamInputTransformer;
+
+/// An argument of a circuit received in chunks, transformed as they arrive.
+struct ArgStream {
+  /// Transforms the next chunk of the argument.
+  std::function<Result<void>(const TransportValueChunk &)> push;
+  /// Returns the argument once all its chunks have been pushed.
+  std::function<Result<Value>()> finish;
+};
+
+/// A type for streaming argument transformers, that is, functions running on
+/// the server side, that return the stream transforming the chunks of a
+/// TransportValue fetched from the client, from its header.
+typedef std::function<Result<ArgStream>(const TransportValue &)>
+    StreamArgTransformer;
+
 /// A factory static class that generates transformers.
 class TransformerFactory {
 public:
@@ -77,12 +137,40 @@ public:
       ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
       bool useSimulation);
 
+  static Result<BatchInputTransformer> getLweCiphertextBatchInputTransformer(
+      ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+      std::shared_ptr<concretelang::csprng::EncryptionCSPRNG> csprng,
+      bool useSimulation);
+
+  static Result<BatchOutputTransformer> getLweCiphertextBatchOutputTransformer(
+      ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+      bool useSimulation);
+
+  /// Returns the input transformer of a ciphertext input gate which takes the
+  /// encryptions of zero of its ciphertexts from the precomputation pool of
+  /// `csprng`, see `EncryptionCSPRNG::getPrecomputationPool`, and only adds
+  /// the encoded values to them.
+  static Result<InputTransformer> getLweCiphertextPrecomputedInputTransformer(
+      ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+      std::shared_ptr<concretelang::csprng::EncryptionCSPRNG> csprng);
+
+  static Result<StreamInputTransformer> getLweCiphertextStreamInputTransformer(
+      ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+      std::shared_ptr<concretelang::csprng::EncryptionCSPRNG> csprng);
+
   static Result<ArgTransformer>
   getLweCiphertextArgTransformer(Message<concreteprotocol::GateInfo> gateInfo,
                                  bool useSimulation);
 
+  static Result<StreamArgTransformer> getLweCiphertextStreamArgTransformer(
+      Message<concreteprotocol::GateInfo> gateInfo, bool useSimulation);
+
   static Result<ReturnTransformer> getLweCiphertextReturnTransformer(
       Message<concreteprotocol::GateInfo> gateInfo, bool useSimulation);
+
+  static Result<PackingReturnTransformer>
+  getLweCiphertextPackingReturnTransformer(
+      Message<concreteprotocol::GateInfo> gateInfo);
 };
 
 } // namespace transformers
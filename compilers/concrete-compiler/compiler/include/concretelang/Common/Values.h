@@ -9,12 +9,16 @@
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Protocol.h"
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <memory>
 #include <optional>
 #include <stdlib.h>
 #include <variant>
+#include <vector>
 
 using concretelang::error::Result;
 using concretelang::error::StringError;
@@ -31,14 +35,127 @@ namespace values {
 /// between client and server to for execution.
 typedef Message<concreteprotocol::Value> TransportValue;
 
+/// A type for the chunks of a TransportValue streamed in several messages, sent
+/// after the TransportValue without payload.
+typedef Message<concreteprotocol::ValueChunk> TransportValueChunk;
+
+/// A vector whose elements are shared by its copies and its slices, and copied
+/// on the first write to a vector sharing them (copy-on-write). The tensors of
+/// ciphertexts are thus passed between the client, the server and the bindings
+/// without copying their elements.
+///
+/// Reading the elements never copies them, even from several threads. The
+/// first write to a vector sharing its elements copies them, so it must not
+/// race with other accesses to the same vector object, e.g. the vector is
+/// written once before being written in parallel.
+template <typename T> class SharedVector {
+public:
+  typedef T value_type;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+
+  SharedVector() = default;
+  SharedVector(std::vector<T> values)
+      : storage(std::make_shared<std::vector<T>>(std::move(values))),
+        offset(0), length(storage->size()) {}
+
+  size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+
+  const T *data() const {
+    return storage ? storage->data() + offset : nullptr;
+  }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + length; }
+  const T &operator[](size_t index) const { return data()[index]; }
+  const T &front() const { return data()[0]; }
+  const T &back() const { return data()[length - 1]; }
+
+  T *data() { return vector().data(); }
+  iterator begin() { return data(); }
+  iterator end() { return data() + length; }
+  T &operator[](size_t index) { return data()[index]; }
+  T &front() { return data()[0]; }
+  T &back() { return data()[length - 1]; }
+
+  void resize(size_t count) {
+    vector().resize(count);
+    length = count;
+  }
+  void reserve(size_t capacity) { vector().reserve(capacity); }
+  void clear() { *this = SharedVector(); }
+  void push_back(T value) {
+    vector().push_back(value);
+    length++;
+  }
+  template <typename InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    size_t index = pos - begin();
+    auto &values = vector();
+    auto it = values.insert(values.begin() + index, first, last);
+    length = values.size();
+    return values.data() + (it - values.begin());
+  }
+
+  /// Returns the elements `first` to `last`, which share their storage with
+  /// this vector.
+  SharedVector slice(size_t first, size_t last) const {
+    assert(first <= last && last <= length);
+    SharedVector output = *this;
+    output.offset += first;
+    output.length = last - first;
+    return output;
+  }
+
+  /// Returns the elements as a `std::vector`, which takes the storage of this
+  /// vector if it is not shared with another.
+  std::vector<T> toVector() && {
+    if (isExclusive()) {
+      std::vector<T> output = std::move(*storage);
+      *this = SharedVector();
+      return output;
+    }
+    return std::vector<T>(begin(), end());
+  }
+
+  bool operator==(const SharedVector &b) const {
+    return length == b.length && std::equal(begin(), end(), b.begin());
+  }
+  bool operator!=(const SharedVector &b) const { return !(*this == b); }
+
+private:
+  /// Returns true if the storage only holds the elements of this vector.
+  bool isExclusive() const {
+    return storage && storage.use_count() == 1 && offset == 0 &&
+           length == storage->size();
+  }
+
+  /// Returns the storage, after copying the elements to a storage of their
+  /// own if they are shared.
+  std::vector<T> &vector() {
+    if (!isExclusive()) {
+      const SharedVector &shared = *this;
+      storage = std::make_shared<std::vector<T>>(shared.begin(), shared.end());
+      offset = 0;
+    }
+    return *storage;
+  }
+
+  std::shared_ptr<std::vector<T>> storage;
+  size_t offset = 0;
+  size_t length = 0;
+};
+
 /// A type for tensor data.
 template <typename T> struct Tensor {
-  std::vector<T> values;
+  SharedVector<T> values;
   std::vector<size_t> dimensions;
 
   Tensor<T>() = default;
   Tensor<T>(std::vector<T> values, std::vector<size_t> dimensions)
-      : values(values), dimensions(dimensions) {}
+      : values(std::move(values)), dimensions(std::move(dimensions)) {}
+  Tensor<T>(SharedVector<T> values, std::vector<size_t> dimensions)
+      : values(std::move(values)), dimensions(std::move(dimensions)) {}
 
   /// Creates an tensor with the shape described by the input dimensions, filled
   /// with zeros.
@@ -48,7 +165,7 @@ template <typename T> struct Tensor {
       length *= dim;
     }
     auto values = std::vector<T>(length, 0);
-    return Tensor{values, dimensions};
+    return Tensor{std::move(values), dimensions};
   }
 
   /// Conversion constructor from a scalar value.
@@ -76,64 +193,71 @@ template <typename T> struct Tensor {
 
   Tensor<T> operator-(T b) const {
     Tensor<T> out = *this;
+    T *data = out.values.data();
     for (size_t i = 0; i < out.values.size(); i++) {
-      out.values[i] -= b;
+      data[i] -= b;
     }
     return out;
   }
 
-  Tensor<T> operator-(Tensor<T> b) const {
+  Tensor<T> operator-(const Tensor<T> &b) const {
     assert(this->dimensions == b.dimensions);
     Tensor<T> out = *this;
+    T *data = out.values.data();
     for (size_t i = 0; i < out.values.size(); i++) {
-      out.values[i] -= b.values[i];
+      data[i] -= b.values[i];
     }
     return out;
   }
 
   Tensor<T> operator+(T b) const {
     Tensor<T> out = *this;
+    T *data = out.values.data();
     for (size_t i = 0; i < out.values.size(); i++) {
-      out.values[i] += b;
+      data[i] += b;
     }
     return out;
   }
 
-  Tensor<T> operator+(Tensor<T> b) const {
+  Tensor<T> operator+(const Tensor<T> &b) const {
     assert(this->dimensions == b.dimensions);
     Tensor<T> out = *this;
+    T *data = out.values.data();
     for (size_t i = 0; i < out.values.size(); i++) {
-      out.values[i] += b.values[i];
+      data[i] += b.values[i];
     }
     return out;
   }
 
   Tensor<T> operator*(T b) const {
     Tensor<T> out = *this;
+    T *data = out.values.data();
     for (size_t i = 0; i < out.values.size(); i++) {
-      out.values[i] *= b;
+      data[i] *= b;
     }
     return out;
   }
 
-  Tensor<T> operator*(Tensor<T> b) const {
+  Tensor<T> operator*(const Tensor<T> &b) const {
     assert(this->dimensions == b.dimensions);
     Tensor<T> out = *this;
+    T *data = out.values.data();
     for (size_t i = 0; i < out.values.size(); i++) {
-      out.values[i] *= b.values[i];
+      data[i] *= b.values[i];
     }
     return out;
   }
 
   T &operator[](int index) { return this->values[index]; }
+  const T &operator[](int index) const { return this->values[index]; }
 
   template <typename U> explicit operator Tensor<U>() const {
-    Tensor<U> output;
-    output.dimensions = this->dimensions;
+    std::vector<U> values;
+    values.reserve(this->values.size());
     for (auto v : this->values) {
-      output.values.push_back((U)v);
+      values.push_back((U)v);
     }
-    return output;
+    return Tensor<U>(std::move(values), this->dimensions);
   }
 
   bool isScalar() const { return dimensions.empty(); }
@@ -148,18 +272,18 @@ struct Value {
                Tensor<uint64_t>, Tensor<int64_t>>
       inner;
   Value() = default;
-  Value(Tensor<uint8_t> inner) : inner(inner){};
-  Value(Tensor<uint16_t> inner) : inner(inner){};
-  Value(Tensor<uint32_t> inner) : inner(inner){};
-  Value(Tensor<uint64_t> inner) : inner(inner){};
-  Value(Tensor<int8_t> inner) : inner(inner){};
-  Value(Tensor<int16_t> inner) : inner(inner){};
-  Value(Tensor<int32_t> inner) : inner(inner){};
-  Value(Tensor<int64_t> inner) : inner(inner){};
+  Value(Tensor<uint8_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<uint16_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<uint32_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<uint64_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<int8_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<int16_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<int32_t> inner) : inner(std::move(inner)){};
+  Value(Tensor<int64_t> inner) : inner(std::move(inner)){};
 
   /// Turns a server value to a client value, without interpreting the kind of
   /// value.
-  static Value fromRawTransportValue(TransportValue transportVal);
+  static Value fromRawTransportValue(const TransportValue &transportVal);
 
   /// Turns a client value to a raw (without kind info attached) server value.
   TransportValue intoRawTransportValue() const;
@@ -172,6 +296,10 @@ struct Value {
 
   Message<concreteprotocol::Payload> intoProtoPayload() const;
 
+  /// Writes the payload directly into `builder`, sparing the intermediate
+  /// message.
+  void intoProtoPayload(concreteprotocol::Payload::Builder builder) const;
+
   Message<concreteprotocol::Shape> intoProtoShape() const;
 
   std::vector<size_t> getDimensions() const;
@@ -10,9 +10,11 @@
 
 namespace mlir {
 namespace concretelang {
-/// Create a pass to convert `Concrete` dialect to CAPI calls.
+/// Create a pass to convert `Concrete` dialect to CAPI calls. With
+/// `asyncOffload`, independent CPU keyswitches and bootstraps are issued
+/// asynchronously to overlap them.
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertConcreteToCAPIPass(bool gpu);
+createConvertConcreteToCAPIPass(bool gpu, bool asyncOffload = false);
 } // namespace concretelang
 } // namespace mlir
 
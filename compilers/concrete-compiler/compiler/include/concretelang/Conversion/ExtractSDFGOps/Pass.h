@@ -12,7 +12,7 @@
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<OperationPass<mlir::func::FuncOp>>
-createExtractSDFGOpsPass(bool unroll);
+createExtractSDFGOpsPass(bool unroll, unsigned unrollFactor);
 } // namespace concretelang
 } // namespace mlir
 
@@ -12,9 +12,17 @@
 namespace mlir {
 namespace concretelang {
 /// Create a pass to convert `FHE` tensor operators to linal.generic
-/// operators.
+/// operators. With `treeReduction`, sums, dot products and matrix
+/// multiplications are reduced by trees of additions of logarithmic depth,
+/// instead of sequential accumulations. With `im2colConv2d`, the
+/// convolutions without groups are lowered to matrix multiplications on the
+/// patches of their input. With `maxpool2dTree`, the maxima of the windows
+/// of the maxpools are computed by trees of maxima shared between
+/// overlapping windows.
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
-createConvertFHETensorOpsToLinalg();
+createConvertFHETensorOpsToLinalg(bool treeReduction = false,
+                                  bool im2colConv2d = false,
+                                  bool maxpool2dTree = false);
 } // namespace concretelang
 } // namespace mlir
 
@@ -21,8 +21,13 @@ struct CrtLoweringParameters {
   size_t modsProd;
   size_t bitsTotal;
   size_t singleLutSize;
+  /// Whether the leveled operations on the blocks are lowered to batched
+  /// operations rather than to loops over the blocks
+  bool batchBlocks;
 
-  CrtLoweringParameters(mlir::SmallVector<int64_t> mods) : mods(mods) {
+  CrtLoweringParameters(mlir::SmallVector<int64_t> mods,
+                        bool batchBlocks = false)
+      : mods(mods), batchBlocks(batchBlocks) {
     nMods = mods.size();
     modsProd = 1;
     bitsTotal = 0;
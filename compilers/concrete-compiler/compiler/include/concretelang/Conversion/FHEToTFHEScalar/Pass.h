@@ -9,13 +9,20 @@
 #include "mlir/Pass/Pass.h"
 #include "llvm/Support/Casting.h"
 #include <list>
+#include <set>
 
 namespace mlir {
 namespace concretelang {
 
 struct ScalarLoweringParameters {
   size_t polynomialSize;
+  /// The optimizer ids of the lookup tables that bootstrap and then
+  /// keyswitch, instead of keyswitching and then bootstrapping
+  std::set<int32_t> pbsKsLookupTables;
   ScalarLoweringParameters(size_t polySize) : polynomialSize(polySize){};
+  ScalarLoweringParameters(size_t polySize,
+                           std::set<int32_t> pbsKsLookupTables)
+      : polynomialSize(polySize), pbsKsLookupTables(pbsKsLookupTables){};
 };
 
 /// Create a pass to convert `FHE` dialect to `TFHE` dialect with the scalar
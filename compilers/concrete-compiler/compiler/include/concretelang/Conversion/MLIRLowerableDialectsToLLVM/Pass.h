@@ -11,9 +11,11 @@
 namespace mlir {
 template <typename T> class OperationPass;
 namespace concretelang {
-/// Create a pass to convert MLIR lowerable dialects to LLVM.
+/// Create a pass to convert MLIR lowerable dialects to LLVM. With
+/// `checkedAllocations`, heap allocations go through the runtime's
+/// `concrete_checked_malloc` and `concrete_checked_free`.
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertMLIRLowerableDialectsToLLVMPass();
+createConvertMLIRLowerableDialectsToLLVMPass(bool checkedAllocations = false);
 } // namespace concretelang
 } // namespace mlir
 
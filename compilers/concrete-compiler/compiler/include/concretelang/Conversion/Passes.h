@@ -28,6 +28,7 @@
 #include "concretelang/Conversion/TracingToCAPI/Pass.h"
 #include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
 #include "concretelang/Dialect/FHE/IR/FHEDialect.h"
+#include "concretelang/Dialect/RT/IR/RTDialect.h"
 #include "concretelang/Dialect/SDFG/IR/SDFGDialect.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEDialect.h"
 #include "concretelang/Dialect/Tracing/IR/TracingDialect.h"
@@ -10,9 +10,14 @@
 
 namespace mlir {
 namespace concretelang {
-/// Create a pass that simulates TFHE operations
+/// Create a pass that simulates TFHE operations. The bootstraps are told the
+/// `precision` of their messages, 0 if unknown, and the probability of error
+/// `pError` of the parameters, to measure their noise in the simulation
+/// statistics. Without `enableNoise`, the operations are simulated without
+/// noise: the keyswitches are removed and the bootstraps are exact.
 std::unique_ptr<OperationPass<ModuleOp>>
-createSimulateTFHEPass(bool enableOverflowDetection);
+createSimulateTFHEPass(bool enableOverflowDetection, uint32_t precision = 0,
+                       double pError = 0, bool enableNoise = true);
 } // namespace concretelang
 } // namespace mlir
 
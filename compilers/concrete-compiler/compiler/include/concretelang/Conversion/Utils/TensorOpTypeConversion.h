@@ -42,6 +42,17 @@ populateWithTensorTypeConverterPatterns(mlir::RewritePatternSet &patterns,
       patterns.getContext(), typeConverter);
   addDynamicallyLegalTypeOp<mlir::tensor::InsertSliceOp>(target, typeConverter);
 
+  // GatherOp
+  patterns.add<
+      TypeConvertingReinstantiationPattern<mlir::tensor::GatherOp, true>>(
+      patterns.getContext(), typeConverter);
+  addDynamicallyLegalTypeOp<mlir::tensor::GatherOp>(target, typeConverter);
+  // ScatterOp
+  patterns.add<
+      TypeConvertingReinstantiationPattern<mlir::tensor::ScatterOp, true>>(
+      patterns.getContext(), typeConverter);
+  addDynamicallyLegalTypeOp<mlir::tensor::ScatterOp>(target, typeConverter);
+
   // FromElementsOp
   patterns
       .add<TypeConvertingReinstantiationPattern<mlir::tensor::FromElementsOp>>(
@@ -17,6 +17,11 @@ namespace concretelang {
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 createMemoryUsagePass(ProgramCompilationFeedback &feedback);
 
+/// Computes the peak memory usage of the circuits and the bytes they allocate
+/// per call, from the liveness of their buffers.
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createBufferUsagePass(ProgramCompilationFeedback &feedback);
+
 } // namespace concretelang
 } // namespace mlir
 
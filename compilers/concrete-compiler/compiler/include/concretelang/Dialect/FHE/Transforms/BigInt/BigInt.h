@@ -15,8 +15,15 @@
 namespace mlir {
 namespace concretelang {
 
+/// Lowers the additions, multiplications and maxima of encrypted integers
+/// wider than `chunkSize` to operations on chunks. The multiplications by
+/// encrypted integers and the maxima need chunks holding two digits.
+///
+/// With `carryLookahead`, the carries of the additions are computed by a
+/// parallel prefix, of logarithmic depth in the number of chunks.
 std::unique_ptr<mlir::OperationPass<>>
-createFHEBigIntTransformPass(unsigned int chunkSize, unsigned int chunkWidth);
+createFHEBigIntTransformPass(unsigned int chunkSize, unsigned int chunkWidth,
+                             bool carryLookahead = false);
 
 } // namespace concretelang
 } // namespace mlir
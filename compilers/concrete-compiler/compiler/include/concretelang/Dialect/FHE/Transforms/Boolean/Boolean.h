@@ -7,6 +7,7 @@
 #define CONCRETELANG_FHE_BOOLEAN_PASS_H
 
 #include <concretelang/Dialect/FHE/IR/FHEDialect.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Pass/Pass.h>
 
 #define GEN_PASS_CLASSES
@@ -17,6 +18,10 @@ namespace concretelang {
 
 std::unique_ptr<mlir::OperationPass<>> createFHEBooleanTransformPass();
 
+/// Fuses the gates depending on at most `maxInputs` booleans, which is 2 or 3
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createFHEBooleanGateFusionPass(unsigned int maxInputs = 2);
+
 } // namespace concretelang
 } // namespace mlir
 
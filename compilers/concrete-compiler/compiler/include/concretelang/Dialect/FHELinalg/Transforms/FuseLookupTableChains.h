@@ -0,0 +1,31 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_FHELINALG_FUSE_LOOKUP_TABLE_CHAINS_PASS_H
+#define CONCRETELANG_FHELINALG_FUSE_LOOKUP_TABLE_CHAINS_PASS_H
+
+#include <concretelang/Dialect/FHE/IR/FHEDialect.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Pass/Pass.h>
+
+#include <map>
+#include <string>
+
+#define GEN_PASS_CLASSES
+#include <concretelang/Dialect/FHELinalg/Transforms/FuseLookupTableChains.h.inc>
+
+namespace mlir {
+namespace concretelang {
+/// If `counts` is given, the number of bootstraps saved by the fusions in
+/// each function is recorded there, by function name.
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createFuseLookupTableChainsPass(
+    std::map<std::string, uint64_t> *counts = nullptr);
+} // namespace concretelang
+} // namespace mlir
+
+#endif
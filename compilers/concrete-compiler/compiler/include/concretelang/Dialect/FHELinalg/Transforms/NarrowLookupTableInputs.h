@@ -0,0 +1,25 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_FHELINALG_NARROW_LOOKUP_TABLE_INPUTS_PASS_H
+#define CONCRETELANG_FHELINALG_NARROW_LOOKUP_TABLE_INPUTS_PASS_H
+
+#include <concretelang/Dialect/FHE/IR/FHEDialect.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Pass/Pass.h>
+
+#define GEN_PASS_CLASSES
+#include <concretelang/Dialect/FHELinalg/Transforms/NarrowLookupTableInputs.h.inc>
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createNarrowLookupTableInputsPass();
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -18,6 +18,23 @@ namespace concretelang {
 std::unique_ptr<mlir::OperationPass<>>
 createFHELinalgTilingMarkerPass(llvm::ArrayRef<int64_t> tileSizes);
 
+/// Parameters of the cost model selecting the tile sizes automatically
+struct AutoTilingParameters {
+  /// Number of tiles processed concurrently, 0 for the number of hardware
+  /// threads
+  int64_t parallelism = 0;
+  /// Minimum number of PBS per tile, e.g. to saturate the batches of a GPU
+  int64_t minPbsPerTile = 0;
+  /// Maximum size in bytes of the ciphertexts of all the tiles of an
+  /// operation, 0 for no limit
+  int64_t maxMemory = 0;
+  /// Size in bytes of an encrypted integer
+  int64_t ciphertextSize = (2048 + 1) * 8;
+};
+
+std::unique_ptr<mlir::OperationPass<>> createFHELinalgAutoTilingMarkerPass(
+    AutoTilingParameters parameters = AutoTilingParameters());
+
 std::unique_ptr<mlir::OperationPass<>> createLinalgTilingPass();
 } // namespace concretelang
 } // namespace mlir
@@ -17,8 +17,13 @@ class BufferizeTypeConverter;
 class RewritePatternSet;
 
 namespace concretelang {
+/// The loops with a static trip count holding candidates for tasks are
+/// first unrolled by at most `unrollFactor` iterations, 0 or 1 disabling the
+/// unrolling.
 std::unique_ptr<mlir::Pass>
-createBuildDataflowTaskGraphPass(bool debug = false);
+createBuildDataflowTaskGraphPass(bool debug = false, int64_t unrollFactor = 0);
+std::unique_ptr<mlir::Pass>
+createCoarsenDataflowTasksPass(int64_t minTaskWork, bool debug = false);
 std::unique_ptr<mlir::Pass> createLowerDataflowTasksPass(bool debug = false);
 std::unique_ptr<mlir::Pass>
 createBufferizeDataflowTaskOpsPass(bool debug = false);
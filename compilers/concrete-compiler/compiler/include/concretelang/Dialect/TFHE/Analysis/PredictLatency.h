@@ -0,0 +1,27 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_DIALECT_TFHE_ANALYSIS_PREDICT_LATENCY_H
+#define CONCRETELANG_DIALECT_TFHE_ANALYSIS_PREDICT_LATENCY_H
+
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/Pass/Pass.h>
+
+#include <concretelang/Support/CompilationFeedback.h>
+#include <concretelang/Support/LatencyModel.h>
+
+namespace mlir {
+namespace concretelang {
+
+/// Predicts the latency and the throughput of the circuits of the feedback
+/// from the costs of their primitives, leaving the circuits using a primitive
+/// without cost, or a loop without static trip count, unpredicted.
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createLatencyPredictionPass(ProgramCompilationFeedback &feedback,
+                            LatencyModel model);
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -10,17 +10,34 @@
 #include "concretelang/Dialect/TFHE/IR/TFHEDialect.h"
 #include "mlir/Pass/Pass.h"
 
+#include <map>
+#include <string>
+
 #define GEN_PASS_CLASSES
 #include "concretelang/Dialect/TFHE/Transforms/Transforms.h.inc"
 
 namespace mlir {
 namespace concretelang {
+
+/// The number of operations of a function removed by the deduplication.
+struct TFHEDeduplicationCounts {
+  uint64_t bootstraps = 0;
+  uint64_t keyswitches = 0;
+};
+
 std::unique_ptr<mlir::OperationPass<>> createTFHEOptimizationPass();
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
 createTFHEOperationTransformationsPass();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
     createTFHECircuitSolutionParametrizationPass(
         std::optional<concrete_optimizer::dag::CircuitSolution>);
+/// If `counts` is given, the number of operations removed from each function
+/// is recorded there, by function name.
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createTFHEDeduplicationPass(
+    std::map<std::string, TFHEDeduplicationCounts> *counts = nullptr);
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createTFHELutEncodingHoistingPass();
 } // namespace concretelang
 } // namespace mlir
 
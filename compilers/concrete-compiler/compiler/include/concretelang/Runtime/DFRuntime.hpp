@@ -8,6 +8,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <dlfcn.h>
 #include <memory>
 #include <utility>
@@ -28,6 +29,38 @@ bool _dfr_is_distributed();
 void _dfr_run_remote_scheduler();
 void _dfr_register_lib(void *dlh);
 
+/// Sharing of the cores of a node between the HPX workers running the
+/// dataflow tasks and the OpenMP threads running the parallel loops.
+typedef enum _dfr_thread_policy {
+  /// ncores + 1 - OMP_NUM_THREADS workers, OpenMP threads left unbound.
+  _DFR_THREAD_POLICY_DEFAULT = 0,
+  /// Disjoint sets of cores: OpenMP threads are bound to the first ones
+  /// and HPX workers to the others.
+  _DFR_THREAD_POLICY_PARTITION = 1,
+  /// HPX workers on all the cores, loops within tasks run sequentially.
+  _DFR_THREAD_POLICY_SHARED = 2
+} _dfr_thread_policy;
+
+/// Select the thread policy and the number of HPX workers (0 for the
+/// default of the policy) used when the runtime starts.  The
+/// `DFR_THREAD_POLICY` and `DFR_NUM_THREADS` environment variables take
+/// precedence.
+void _dfr_set_thread_policy(_dfr_thread_policy policy, size_t hpx_threads);
+/// Parse a policy name ("default", "partition" or "shared"), returns
+/// false if it is not one.
+static inline bool _dfr_parse_thread_policy(const char *name,
+                                            _dfr_thread_policy &policy) {
+  if (!strcmp(name, "default"))
+    policy = _DFR_THREAD_POLICY_DEFAULT;
+  else if (!strcmp(name, "partition"))
+    policy = _DFR_THREAD_POLICY_PARTITION;
+  else if (!strcmp(name, "shared"))
+    policy = _DFR_THREAD_POLICY_SHARED;
+  else
+    return false;
+  return true;
+}
+
 typedef enum _dfr_task_arg_type {
   _DFR_TASK_ARG_BASE = 0,
   _DFR_TASK_ARG_MEMREF = 1,
@@ -14,6 +14,10 @@
 
 #endif
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace mlir {
 namespace concretelang {
 namespace gpu_dfg {
@@ -21,6 +25,28 @@ namespace gpu_dfg {
 bool check_cuda_device_available();
 bool check_cuda_runtime_enabled();
 
+/// The timing predicted by the timing simulation of the SDFG runtime,
+/// enabled by setting SDFG_SIMULATED_GPUS to the number of GPUs to
+/// simulate.
+struct TimingSimulationReport {
+  /// Predicted duration of the executions, in seconds
+  double makespan = 0;
+  /// Predicted time the host cores were busy, summed over the cores, in
+  /// seconds
+  double host_busy = 0;
+  /// Predicted time each simulated GPU was busy with kernels or
+  /// transfers, in seconds
+  std::vector<double> device_busy;
+  uint64_t transfer_bytes = 0;
+  size_t subgraphs = 0;
+};
+
+/// Sets `report` to the timing predicted for the dataflow graphs executed
+/// by the process since the last reset, or returns false if the timing
+/// simulation is disabled.
+bool get_timing_simulation_report(TimingSimulationReport &report);
+void reset_timing_simulation_report();
+
 } // namespace gpu_dfg
 } // namespace concretelang
 } // namespace mlir
@@ -0,0 +1,36 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_ASYNC_EXECUTOR_H
+#define CONCRETELANG_RUNTIME_ASYNC_EXECUTOR_H
+
+#include <functional>
+
+namespace mlir {
+namespace concretelang {
+namespace async {
+
+/// Completion state of a task submitted to the executor, opaque to the
+/// callers.
+struct Future;
+
+/// Runs `task` on the process wide work-stealing thread pool and returns
+/// the future of its completion, which must be passed to `await` exactly
+/// once.
+///
+/// The pool has one worker per hardware thread, the number can be
+/// overridden with the `CONCRETE_ASYNC_THREADS` environment variable.
+Future *submit(std::function<void()> task);
+
+/// Blocks until the task of `future` completed and releases the future.
+/// While waiting, the calling thread runs pending tasks itself so that
+/// awaiting from within a task cannot deadlock the pool.
+void await(Future *future);
+
+} // namespace async
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -8,25 +8,41 @@
 
 #include "concrete-cpu.h"
 #include "concretelang/Common/Error.h"
+#include "concretelang/Common/HugePages.h"
 #include "concretelang/Common/Keysets.h"
+#include "concretelang/Runtime/tracing.h"
 #include <assert.h>
+#include <atomic>
 #include <complex>
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <pthread.h>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 using ::concretelang::keysets::ServerKeyset;
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
+#include "bit_extraction.h"
 #include "device.h"
 #include "keyswitch.h"
 #include "programmable_bootstrap.h"
+#include "programmable_bootstrap_multibit.h"
+#include "wop_bootstrap.h"
 #endif
 
 namespace mlir {
 namespace concretelang {
 
+/// A bootstrap key in the Fourier domain, whose buffer follows the huge pages
+/// policy, see `::concretelang::huge_pages`.
+using FourierBootstrapKey =
+    std::vector<std::complex<double>,
+                ::concretelang::huge_pages::Allocator<std::complex<double>>>;
+
 typedef struct FFT {
   FFT() = delete;
   FFT(size_t polynomial_size);
@@ -39,12 +55,134 @@ typedef struct FFT {
   size_t polynomial_size;
 } FFT;
 
+/// Returns the kernels the FFTs of the bootstraps run on, the widest ones both
+/// built in the CPU backend and supported by this cpu (AVX-512, AVX2 or
+/// scalar).
+FftBackend getFftBackend();
+
+/// Returns the name of `backend`, e.g. to report the active one.
+const char *getFftBackendName(FftBackend backend);
+
+/// Per-thread, grow-only scratch buffers reused across calls of the CPU
+/// wrappers. Buffers are sized on first use for a given set of crypto
+/// parameters and then reused, so that the bootstrap and wop-pbs hot path
+/// does not hit the heap allocator.
+struct ScratchArena {
+  enum Slot : size_t {
+    GLWE_ACCUMULATOR,
+    BOOTSTRAP,
+    KEYSWITCH_OUTPUT,
+    WOP_PBS_BITS_PER_BLOCK,
+    WOP_PBS_INPUT,
+    WOP_PBS_EXTRACTED_BITS,
+    WOP_PBS_EXTRACT_BITS,
+    WOP_PBS_VERTICAL_PACKING,
+    NUM_SLOTS
+  };
+
+  ScratchArena() = default;
+  ScratchArena(const ScratchArena &other) = delete;
+  ~ScratchArena();
+
+  /// Returns a buffer of at least `size` bytes aligned on `align` for the
+  /// given slot. The content of the buffer is unspecified.
+  uint8_t *get(Slot slot, size_t size, size_t align = alignof(max_align_t));
+
+  template <typename T> T *get(Slot slot, size_t count) {
+    return reinterpret_cast<T *>(get(slot, count * sizeof(T), alignof(T)));
+  }
+
+  /// Returns the scratch arena of the calling thread.
+  static ScratchArena &local();
+
+private:
+  struct Buffer {
+    uint8_t *data = nullptr;
+    size_t size = 0;
+    size_t align = 0;
+  };
+  Buffer buffers[NUM_SLOTS];
+};
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+/// Device resources of the direct CUDA wrappers, reused across calls: a
+/// stream, a grow-only PBS scratch buffer and grow-only device buffers, the
+/// `KEYSWITCHED` one holding the intermediate ciphertexts of the fused
+/// keyswitch and bootstrap. A state is used by a single wrapper call at a
+/// time, see `RuntimeContext::acquire_gpu_state`.
+struct GPUWrapperState {
+  enum Buffer : size_t {
+    INPUT,
+    OUTPUT,
+    ACCUMULATOR,
+    KEYSWITCHED,
+    NUM_BUFFERS
+  };
+
+  GPUWrapperState(uint32_t gpu_idx);
+  GPUWrapperState(const GPUWrapperState &other) = delete;
+  ~GPUWrapperState();
+
+  /// Returns a device buffer of at least `size` bytes for the given slot,
+  /// its content is unspecified.
+  void *get_buffer(Buffer buffer, size_t size);
+
+  /// Returns the PBS scratch buffer for the given parameters and at least
+  /// `num_samples` ciphertexts, of the multi-bit PBS if `grouping_factor` is
+  /// more than 1.
+  int8_t *get_pbs_buffer(uint32_t glwe_dim, uint32_t poly_size,
+                         uint32_t level, uint32_t num_samples,
+                         uint32_t lwe_dim = 0, uint32_t grouping_factor = 0);
+
+  /// Returns device arrays of `num_samples` 64 bits indexes, respectively
+  /// 0, 1, ..., num_samples - 1 and all zeros.
+  void *get_identity_indexes(uint32_t num_samples);
+  void *get_zero_indexes(uint32_t num_samples);
+
+  const uint32_t gpu_idx;
+  void *const stream;
+
+private:
+  void *get_indexes(void *&indexes, uint32_t &count, uint32_t num_samples,
+                    bool identity);
+  void release_pbs_buffer();
+
+  struct DeviceBuffer {
+    void *data = nullptr;
+    size_t size = 0;
+  };
+  DeviceBuffer buffers[NUM_BUFFERS];
+  int8_t *pbs_buffer = nullptr;
+  uint32_t pbs_glwe_dim = 0;
+  uint32_t pbs_poly_size = 0;
+  uint32_t pbs_level = 0;
+  uint32_t pbs_lwe_dim = 0;
+  uint32_t pbs_grouping_factor = 0;
+  uint32_t pbs_max_samples = 0;
+  void *identity_indexes = nullptr;
+  uint32_t identity_indexes_count = 0;
+  void *zero_indexes = nullptr;
+  uint32_t zero_indexes_count = 0;
+};
+#endif
+
 typedef struct RuntimeContext {
 
   RuntimeContext() = delete;
-  RuntimeContext(ServerKeyset serverKeyset);
+  /// Fourier bootstrap keys already converted elsewhere can be passed in
+  /// `fourierBootstrapKeys`, indexed as the bootstrap keys, they are then
+  /// used as is instead of being converted again. Null entries are
+  /// converted as usual.
+  RuntimeContext(ServerKeyset serverKeyset,
+                 std::vector<std::shared_ptr<FourierBootstrapKey>>
+                     fourierBootstrapKeys = {});
   virtual ~RuntimeContext() {
+    release_sdfg_graphs();
+    release_numa_replicas();
 #ifdef CONCRETELANG_CUDA_SUPPORT
+    for (auto &resident : device_resident)
+      cuda_drop(resident.second.data, resident.second.gpu_idx);
+    gpu_states.clear();
     for (int i = 0; i < num_devices; ++i) {
       for (auto k : bsk_gpu[i])
         if (k != nullptr)
@@ -52,6 +190,11 @@ typedef struct RuntimeContext {
       for (auto k : ksk_gpu[i])
         if (k != nullptr)
           cuda_drop(k, i);
+      for (auto k : fpksk_gpu[i])
+        if (k != nullptr)
+          cuda_drop(k, i);
+      for (auto &acc : accumulator_gpu[i])
+        cuda_drop(acc.second.data, i);
     }
 #endif
   };
@@ -62,27 +205,267 @@ typedef struct RuntimeContext {
 
   virtual const std::complex<double> *
   fourier_bootstrap_key_buffer(size_t keyId) {
-    return fourier_bootstrap_keys[keyId]->data();
+    ensure_full_fourier_bootstrap_key(keyId);
+    return numa_local_fourier_bootstrap_key(
+        keyId, fourier_bootstrap_keys[keyId]->data());
+  }
+
+  /// Returns the fourier bootstrap key `keyId` stored in single precision,
+  /// each complex coefficient being two floats, or nullptr if it is stored
+  /// in double precision. The bootstraps should use this form when present,
+  /// as `fourier_bootstrap_key_buffer` expands a double precision copy of it.
+  virtual const float *compact_fourier_bootstrap_key_buffer(size_t keyId) {
+    ensure_fourier_bootstrap_key(keyId);
+    auto &compact = compact_fourier_bootstrap_keys[keyId];
+    if (compact == nullptr)
+      return nullptr;
+    return numa_local_compact_fourier_bootstrap_key(keyId, compact->data());
+  }
+
+  /// Returns the replica on the NUMA node of the calling thread of the
+  /// fourier bootstrap key `keyId`, `key` being the key in double precision
+  /// returned by `fourier_bootstrap_key_buffer`, or `key` itself if the
+  /// replication is disabled. The key is not fetched, so that the OpenMP
+  /// workers of a batch can each look up the replica of their node of the
+  /// key fetched by the calling thread.
+  const std::complex<double> *
+  numa_local_fourier_bootstrap_key(size_t keyId,
+                                   const std::complex<double> *key) {
+    if (numa_cpu_nodes.empty())
+      return key;
+    return (const std::complex<double> *)numa_local_replica(
+        keyId, false, key, bsk_standard_size(keyId) * sizeof(double));
+  }
+
+  /// As `numa_local_fourier_bootstrap_key`, for the key in single precision
+  /// returned by `compact_fourier_bootstrap_key_buffer`.
+  const float *numa_local_compact_fourier_bootstrap_key(size_t keyId,
+                                                        const float *key) {
+    if (numa_cpu_nodes.empty())
+      return key;
+    return (const float *)numa_local_replica(
+        keyId, true, key, bsk_standard_size(keyId) * sizeof(float));
   }
 
   virtual const uint64_t *fp_keyswitch_key_buffer(size_t keyId) {
     return serverKeyset.packingKeyswitchKeys[keyId].getRawPtr();
   }
 
-  virtual const struct Fft *fft(size_t keyId) { return ffts[keyId].fft; }
+  virtual const struct Fft *fft(size_t keyId) {
+    ensure_fourier_bootstrap_key(keyId);
+    return ffts[keyId]->fft;
+  }
 
   const ServerKeyset getKeys() const { return serverKeyset; }
 
+  /// Adds an evaluation key to a context created with a keyset in which it
+  /// is a placeholder, i.e. a key with an empty buffer, e.g. as the keys are
+  /// streamed from the client. A bootstrap key is converted to the fourier
+  /// domain right away, and the keys are uploaded to the devices with
+  /// `upload_to_gpus`. A key must be added once, before it is used by a
+  /// call, and `getKeys` must not be called meanwhile.
+  void add_bootstrap_key(size_t keyId, LweBootstrapKey key,
+                         bool upload_to_gpus = false);
+  void add_keyswitch_key(size_t keyId, LweKeyswitchKey key,
+                         bool upload_to_gpus = false);
+  void add_packing_keyswitch_key(size_t keyId, PackingKeyswitchKey key,
+                                 bool upload_to_gpus = false);
+  void add_glwe_packing_keyswitch_key(size_t keyId,
+                                      GlwePackingKeyswitchKey key);
+
+  /// Returns the key packing the output ciphertexts returned to the client,
+  /// or null if the keyset has no such key.
+  const GlwePackingKeyswitchKey *glwe_packing_keyswitch_key(size_t keyId) {
+    if (keyId >= serverKeyset.glwePackingKeyswitchKeys.size())
+      return nullptr;
+    return &serverKeyset.glwePackingKeyswitchKeys[keyId];
+  }
+
+  /// Drops the standard and seeded buffers of the bootstrap keys already
+  /// converted to the fourier domain, and uploaded to the devices if any, so
+  /// that only the forms used by the bootstraps are kept. The buffers are
+  /// freed with their last copy, the keyset should thus be moved into the
+  /// context. The fourier forms are shared with the other contexts of the
+  /// keyset, which cannot convert the released keys. Done once the keys are
+  /// converted and uploaded if the `CONCRETE_RELEASE_STANDARD_BSK`
+  /// environment variable is set. Must not be called concurrently with
+  /// `getKeys`.
+  void release_standard_bootstrap_keys();
+
+  /// Returns the fourier form of the bootstrap key `keyId`, converting it
+  /// first if needed.
+  std::shared_ptr<FourierBootstrapKey>
+  get_fourier_bootstrap_key(size_t keyId) {
+    ensure_full_fourier_bootstrap_key(keyId);
+    return fourier_bootstrap_keys[keyId];
+  }
+
+  /// Number of input key bits blind rotated at once with the bootstrap key
+  /// `keyId`. Keys with a grouping factor over 1 are multi-bit keys, which
+  /// only the CUDA wrappers can use.
+  uint32_t bsk_grouping_factor(size_t keyId) const {
+    return serverKeyset.lweBootstrapKeys[keyId]
+        .getInfo()
+        .asReader()
+        .getParams()
+        .getGroupingFactor();
+  }
+
+  /// Bits of mantissa the fourier form of the bootstrap key `keyId` is
+  /// stored with, 0 for the full precision of doubles. Keys of up to 24 bits
+  /// are stored in single precision.
+  uint32_t bsk_fourier_precision(size_t keyId) const {
+    return serverKeyset.lweBootstrapKeys[keyId]
+        .getInfo()
+        .asReader()
+        .getParams()
+        .getFourierPrecision();
+  }
+
+  /// Returns the number of keys uploaded to a device by the contexts of this
+  /// process so far, 0 without CUDA support.
+  static uint64_t get_gpu_key_upload_count();
+
+  /// Returns an idle graph of the stream emulator built by an earlier call
+  /// of the circuit `graphId` with this context, or nullptr if there is
+  /// none. A graph is taken by one call at a time, concurrent calls of a
+  /// circuit each building their own.
+  void *acquire_sdfg_graph(uint64_t graphId);
+  /// Keeps `graph` for the next calls of the circuit `graphId`, the graphs
+  /// left are deleted with `deleter` with the context.
+  void release_sdfg_graph(uint64_t graphId, void *graph,
+                          void (*deleter)(void *));
+
 protected:
   ServerKeyset serverKeyset;
-  std::vector<std::shared_ptr<std::vector<std::complex<double>>>>
-      fourier_bootstrap_keys;
-  std::vector<FFT> ffts;
-  std::pair<FFT, std::shared_ptr<std::vector<std::complex<double>>>>
+  std::vector<std::shared_ptr<FourierBootstrapKey>> fourier_bootstrap_keys;
+  /// The fourier bootstrap keys stored in single precision, null for the
+  /// keys stored in double precision in `fourier_bootstrap_keys`
+  std::vector<std::shared_ptr<std::vector<float>>>
+      compact_fourier_bootstrap_keys;
+  std::vector<std::unique_ptr<FFT>> ffts;
+
+  /// The fourier bootstrap keys are converted in parallel when the context
+  /// is created, or on their first use if the `CONCRETE_LAZY_BSK_CONVERSION`
+  /// environment variable is set.
+  void ensure_fourier_bootstrap_key(size_t keyId) {
+    if (!fourier_bootstrap_keys_ready[keyId].load(std::memory_order_acquire))
+      convert_fourier_bootstrap_key(keyId);
+  }
+  void convert_fourier_bootstrap_key(size_t keyId);
+  /// Adopts the fourier form of the bootstrap key `keyId` converted by
+  /// another context of the process, returns false if there is none. Only
+  /// called by `convert_fourier_bootstrap_key`, under the mutex of the key.
+  bool adopt_shared_fourier_bootstrap_key(size_t keyId);
+  std::unique_ptr<std::atomic<bool>[]> fourier_bootstrap_keys_ready;
+  std::vector<std::unique_ptr<std::mutex>> fourier_bootstrap_keys_mutex;
+
+  /// The keys stored in single precision are only expanded to double
+  /// precision on the first use needing it, e.g. by a wop-pbs or a GPU.
+  void ensure_full_fourier_bootstrap_key(size_t keyId) {
+    ensure_fourier_bootstrap_key(keyId);
+    if (!fourier_bootstrap_keys_full[keyId].load(std::memory_order_acquire))
+      expand_fourier_bootstrap_key(keyId);
+  }
+  void expand_fourier_bootstrap_key(size_t keyId);
+  std::unique_ptr<std::atomic<bool>[]> fourier_bootstrap_keys_full;
+  /// Whether the standard bootstrap keys are released once converted, see
+  /// `release_standard_bootstrap_keys`
+  bool release_standard_bsks;
+  void release_standard_bootstrap_key(size_t keyId);
+  /// Size of the standard form of the bootstrap key `keyId` in words, which
+  /// is known once it is released.
+  size_t bsk_standard_size(size_t keyId);
+
+  /// Converts a bootstrap key to the fourier domain. If the
+  /// `CONCRETE_FOURIER_BSK_CACHE_DIR` environment variable is set, converted
+  /// keys are persisted in that directory and loaded back by later runs.
+  std::pair<FFT, std::shared_ptr<FourierBootstrapKey>>
   convert_to_fourier_domain(LweBootstrapKey &bsk);
 
+  /// NUMA replication of the fourier bootstrap keys, enabled with the
+  /// `CONCRETE_NUMA_REPLICATE_BSK` environment variable on hosts with more
+  /// than one node. The replica of a key on a node is created on the first
+  /// lookup from a thread running on that node, so that its pages are first
+  /// touched there, by copying the `size` bytes of `key`. The keys stored in
+  /// single precision are replicated in this form, `compact`, without
+  /// expanding them. The replicas are aligned on and backed by huge pages,
+  /// transparent ones unless `CONCRETE_HUGE_PAGES` asks for explicit ones.
+  const void *numa_local_replica(size_t keyId, bool compact, const void *key,
+                                 size_t size);
+  void init_numa_replicas();
+  void release_numa_replicas();
+  /// Node of each cpu, empty if the replication is disabled
+  std::vector<uint32_t> numa_cpu_nodes;
+  size_t numa_nodes = 1;
+  /// Replica of the form `c` (1 for the compact one) of key `k` on node `n`
+  /// at `(n * fourier_bootstrap_keys.size() + k) * 2 + c`
+  std::unique_ptr<std::atomic<void *>[]> numa_replicas;
+  std::mutex numa_replicas_mutex;
+
+  /// Idle stream emulator graphs by circuit, deleted before the keys they
+  /// use
+  struct SDFGGraph {
+    void *graph;
+    void (*deleter)(void *);
+  };
+  void release_sdfg_graphs();
+  std::unordered_map<uint64_t, std::vector<SDFGGraph>> sdfg_graphs;
+  std::mutex sdfg_graphs_mutex;
+
 #ifdef CONCRETELANG_CUDA_SUPPORT
 public:
+  /// Number of devices the batched CUDA wrappers distribute their batches
+  /// over, capped by the `SDFG_NUM_GPUS` environment variable.
+  int get_num_devices() const { return num_devices; }
+
+  /// Returns an idle wrapper state of the device `gpu_idx`, created on
+  /// first need, which must be given back with `release_gpu_state` once the
+  /// work queued on its stream completed.
+  GPUWrapperState *acquire_gpu_state(uint32_t gpu_idx);
+  void release_gpu_state(GPUWrapperState *state);
+
+  /// Device copy of a ciphertext buffer produced by a CUDA wrapper and kept
+  /// on the device for the next ones, the host buffer being stale.
+  struct DeviceResidentBuffer {
+    uint32_t gpu_idx;
+    void *data;
+    size_t size;
+  };
+
+  /// Requests the next CUDA wrapper writing `host` to keep its result on
+  /// the device.
+  void keep_on_device(const uint64_t *host);
+  /// Returns and clears the request of `keep_on_device` for `host`.
+  bool take_keep_on_device(const uint64_t *host);
+  /// Looks up the device copy of `host`, returns false if it has none.
+  bool find_on_device(const uint64_t *host, DeviceResidentBuffer &buffer);
+  /// Records `buffer` as the device copy of `host`, replacing the previous.
+  void set_on_device(const uint64_t *host, DeviceResidentBuffer buffer);
+  /// Copies back the device copy of `host`, if any, and releases it.
+  void copy_to_host(uint64_t *host);
+  /// Releases the device copy of `host`, if any, without copying it back.
+  void release_on_device(const uint64_t *host);
+
+  /// Converts and uploads all the bootstrap, keyswitch and packing keyswitch
+  /// keys to all the devices, from one thread and stream per device, so that
+  /// the first GPU ops do not wait for them. Done at construction if the
+  /// `CONCRETE_EAGER_GPU_KEY_UPLOAD` environment variable is set. The
+  /// standard bootstrap keys are then released if requested.
+  void upload_keys_to_gpus();
+  /// Device memory used by the keys uploaded to `gpu_idx` so far, in bytes.
+  size_t get_gpu_keys_memory(uint32_t gpu_idx);
+
+  /// Returns the bootstrap accumulators, i.e. the trivial GLWE encryptions,
+  /// of the `num_lut_vectors` contiguous lookup tables of `poly_size`
+  /// elements of `tlu` on the device `gpu_idx`. They are built and uploaded
+  /// once per distinct lookup tables and device, and cached by content for
+  /// the lifetime of the context. Returns nullptr once the cache of the
+  /// device is full, the caller then has to upload the accumulators itself.
+  void *get_accumulator_gpu(const uint64_t *tlu, uint32_t num_lut_vectors,
+                            uint32_t glwe_dim, uint32_t poly_size,
+                            uint32_t gpu_idx, void *stream);
+
   void *get_bsk_gpu(uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
                     uint32_t glwe_dim, uint32_t gpu_idx, void *stream,
                     uint32_t bsk_idx) {
@@ -100,16 +483,28 @@ public:
 
     size_t bsk_buffer_len = bsk.getBuffer().size();
     size_t bsk_gpu_buffer_size = bsk_buffer_len * sizeof(double);
+    tracing::TraceScope trace("keys", "bootstrap key upload",
+                              {{"key", bsk_idx},
+                               {"device", gpu_idx},
+                               {"bytes", (int64_t)bsk_gpu_buffer_size}});
 
     void *bsk_gpu_tmp =
         cuda_malloc_async(bsk_gpu_buffer_size, (cudaStream_t)stream, gpu_idx);
-    cuda_convert_lwe_programmable_bootstrap_key_64(
-        (cudaStream_t)stream, gpu_idx, bsk_gpu_tmp,
-        const_cast<uint64_t *>(bsk.getBuffer().data()), input_lwe_dim, glwe_dim,
-        level, poly_size);
+    uint32_t grouping_factor = bsk_grouping_factor(bsk_idx);
+    if (grouping_factor > 1)
+      cuda_convert_lwe_multi_bit_programmable_bootstrap_key_64(
+          (cudaStream_t)stream, gpu_idx, bsk_gpu_tmp,
+          const_cast<uint64_t *>(bsk.getBuffer().data()), input_lwe_dim,
+          glwe_dim, level, poly_size, grouping_factor);
+    else
+      cuda_convert_lwe_programmable_bootstrap_key_64(
+          (cudaStream_t)stream, gpu_idx, bsk_gpu_tmp,
+          const_cast<uint64_t *>(bsk.getBuffer().data()), input_lwe_dim,
+          glwe_dim, level, poly_size);
     // Synchronization here is not optional as it works with mutex to
     // prevent other GPU streams from reading partially copied keys.
     cudaStreamSynchronize((cudaStream_t)stream);
+    count_gpu_key_upload();
     bsk_gpu[gpu_idx][bsk_idx] = bsk_gpu_tmp;
     return bsk_gpu[gpu_idx][bsk_idx];
   }
@@ -130,6 +525,10 @@ public:
     auto ksk = serverKeyset.lweKeyswitchKeys[ksk_idx];
 
     size_t ksk_buffer_size = sizeof(uint64_t) * ksk.getBuffer().size();
+    tracing::TraceScope trace("keys", "keyswitch key upload",
+                              {{"key", ksk_idx},
+                               {"device", gpu_idx},
+                               {"bytes", (int64_t)ksk_buffer_size}});
 
     void *ksk_gpu_tmp =
         cuda_malloc_async(ksk_buffer_size, (cudaStream_t)stream, gpu_idx);
@@ -140,33 +539,103 @@ public:
     // Synchronization here is not optional as it works with mutex to
     // prevent other GPU streams from reading partially copied keys.
     cudaStreamSynchronize((cudaStream_t)stream);
+    count_gpu_key_upload();
     ksk_gpu[gpu_idx][ksk_idx] = ksk_gpu_tmp;
     return ksk_gpu[gpu_idx][ksk_idx];
   }
 
+  void *get_fpksk_gpu(uint32_t gpu_idx, void *stream, uint32_t fpksk_idx) {
+
+    if (fpksk_gpu[gpu_idx][fpksk_idx] != nullptr) {
+      return fpksk_gpu[gpu_idx][fpksk_idx];
+    }
+
+    const std::lock_guard<std::mutex> guard(*fpksk_gpu_mutex[gpu_idx]);
+    if (fpksk_gpu[gpu_idx][fpksk_idx] != nullptr) {
+      return fpksk_gpu[gpu_idx][fpksk_idx];
+    }
+
+    auto &fpksk = serverKeyset.packingKeyswitchKeys[fpksk_idx];
+
+    size_t fpksk_buffer_size = sizeof(uint64_t) * fpksk.getSize();
+    tracing::TraceScope trace("keys", "packing keyswitch key upload",
+                              {{"key", fpksk_idx},
+                               {"device", gpu_idx},
+                               {"bytes", (int64_t)fpksk_buffer_size}});
+
+    void *fpksk_gpu_tmp =
+        cuda_malloc_async(fpksk_buffer_size, (cudaStream_t)stream, gpu_idx);
+
+    cuda_memcpy_async_to_gpu(fpksk_gpu_tmp,
+                             const_cast<uint64_t *>(fpksk.getRawPtr()),
+                             fpksk_buffer_size, (cudaStream_t)stream, gpu_idx);
+    // Synchronization here is not optional as it works with mutex to
+    // prevent other GPU streams from reading partially copied keys.
+    cudaStreamSynchronize((cudaStream_t)stream);
+    count_gpu_key_upload();
+    fpksk_gpu[gpu_idx][fpksk_idx] = fpksk_gpu_tmp;
+    return fpksk_gpu[gpu_idx][fpksk_idx];
+  }
+
 private:
+  static void count_gpu_key_upload();
+
   std::vector<std::unique_ptr<std::mutex>> bsk_gpu_mutex;
   std::vector<std::vector<void *>> bsk_gpu;
   std::vector<std::unique_ptr<std::mutex>> ksk_gpu_mutex;
   std::vector<std::vector<void *>> ksk_gpu;
+  std::vector<std::unique_ptr<std::mutex>> fpksk_gpu_mutex;
+  std::vector<std::vector<void *>> fpksk_gpu;
+  /// Accumulators uploaded by `get_accumulator_gpu`, with the lookup tables
+  /// they were built from, by hash of the lookup tables
+  struct DeviceAccumulator {
+    std::vector<uint64_t> tlu;
+    uint32_t glwe_dim;
+    uint32_t poly_size;
+    void *data;
+  };
+  std::vector<std::unique_ptr<std::mutex>> accumulator_gpu_mutex;
+  std::vector<std::unordered_multimap<uint64_t, DeviceAccumulator>>
+      accumulator_gpu;
+  std::vector<size_t> accumulator_gpu_size;
+  std::vector<std::unique_ptr<std::mutex>> gpu_states_mutex;
+  /// All the wrapper states of each device, and the idle ones
+  std::vector<std::vector<std::unique_ptr<GPUWrapperState>>> gpu_states;
+  std::vector<std::vector<GPUWrapperState *>> idle_gpu_states;
+  std::mutex device_resident_mutex;
+  std::map<const uint64_t *, DeviceResidentBuffer> device_resident;
+  std::set<const uint64_t *> keep_on_device_requests;
   int num_devices;
 #endif
 } RuntimeContext;
 
 struct DistributedRuntimeContext : public RuntimeContext {
 
-  using RuntimeContext::RuntimeContext;
+  /// `contextId` identifies the keys to fetch from the root node, see
+  /// `dfr::RuntimeContextManager`.
+  DistributedRuntimeContext(ServerKeyset serverKeyset, uint64_t contextId = 0)
+      : RuntimeContext(serverKeyset), contextId(contextId) {}
   const uint64_t *keyswitch_key_buffer(size_t keyId) override;
   const std::complex<double> *
   fourier_bootstrap_key_buffer(size_t keyId) override;
+  const float *compact_fourier_bootstrap_key_buffer(size_t keyId) override;
   const uint64_t *fp_keyswitch_key_buffer(size_t keyId) override;
   const struct Fft *fft(size_t keyId) override;
 
 private:
+  uint64_t contextId;
   void getBSKonNode(size_t keyId);
-  std::mutex cm_guard;
+  /// Returns the mutex serializing the transfer of the key `keyId` of one
+  /// kind, so that transfers of different keys proceed in parallel.
+  std::mutex &key_guard(std::map<size_t, std::unique_ptr<std::mutex>> &guards,
+                        size_t keyId);
+  // Guards the key maps and the guard maps, never held during a transfer
+  std::mutex maps_guard;
+  std::map<size_t, std::unique_ptr<std::mutex>> ksk_guards;
+  std::map<size_t, std::unique_ptr<std::mutex>> bsk_guards;
+  std::map<size_t, std::unique_ptr<std::mutex>> pksk_guards;
   std::map<size_t, LweKeyswitchKey> ksks;
-  std::map<size_t, std::shared_ptr<std::vector<std::complex<double>>>> fbks;
+  std::map<size_t, std::shared_ptr<FourierBootstrapKey>> fbks;
   std::map<size_t, FFT> dffts;
   std::map<size_t, PackingKeyswitchKey> pksks;
 };
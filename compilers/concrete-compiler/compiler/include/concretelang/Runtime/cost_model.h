@@ -0,0 +1,61 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_COST_MODEL_H
+#define CONCRETELANG_RUNTIME_COST_MODEL_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+/// The cost model with which the SDFG scheduler splits the batches of its
+/// subgraphs between the host cores and the GPUs.
+
+namespace mlir {
+namespace concretelang {
+namespace gpu_dfg {
+
+/// Calibrated execution cost of a kernel on one location. The time to run a
+/// batch of n samples is approximated as latency + n * per_sample seconds.
+struct KernelCost {
+  double latency = 0;
+  double per_sample = 0;
+  double time(size_t n) const { return n ? latency + n * per_sample : 0; }
+};
+
+/// How to split a batch between the host cores and the devices.
+struct SplitPlan {
+  /// False if the whole batch should run on the host.
+  bool offload = false;
+  /// The number of host chunks, possibly 0.
+  size_t cpu_chunks = 0;
+  /// The size ratio of the device chunks to the host chunks.
+  size_t gpu_chunk_factor = 1;
+  /// The smallest device chunk worth its latency, which takes as long to
+  /// compute as the latency of its kernels.
+  size_t min_gpu_chunk_samples = 1;
+};
+
+/// Splits `num_samples` samples of a subgraph costing `cpu` per sample on a
+/// host core and `gpu` on the slowest of the `devices` devices between
+/// `num_cores` host cores and the devices, so as to minimize the makespan.
+SplitPlan plan_split(const KernelCost &cpu, const KernelCost &gpu,
+                     size_t num_samples, size_t num_cores, size_t devices);
+
+/// Reads the costs of the kernels cached in the file at `path` into `costs`,
+/// by kernel and location. A missing file is an empty cache.
+void load_kernel_costs(const char *path,
+                       std::map<std::string, KernelCost> &costs);
+
+/// Appends the cost of `key`, the kernel and location, to the cache at
+/// `path`. Returns false if the file could not be written.
+bool save_kernel_cost(const char *path, const std::string &key,
+                      const KernelCost &cost);
+
+} // namespace gpu_dfg
+} // namespace concretelang
+} // namespace mlir
+
+#endif
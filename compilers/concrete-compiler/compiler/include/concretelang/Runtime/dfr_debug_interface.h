@@ -13,6 +13,9 @@ extern "C" {
 size_t _dfr_debug_get_node_id();
 size_t _dfr_debug_get_worker_id();
 void _dfr_debug_print_task(const char *name, size_t inputs, size_t outputs);
+void _dfr_debug_print_speculation_stats();
+void _dfr_debug_get_speculation_stats(size_t *reexecutions, size_t *wins,
+                                      size_t *failures);
 void _dfr_print_debug(size_t val);
 }
 #endif
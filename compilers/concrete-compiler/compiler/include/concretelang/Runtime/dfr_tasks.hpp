@@ -16,18 +16,403 @@ typedef struct dfr_refcounted_future {
   hpx::shared_future<void *> *future;
   std::atomic<std::size_t> count;
   bool cloned_memref_p;
+  // Task of the task graph of the call computing the future, -1 if none
+  int64_t producer = -1;
   dfr_refcounted_future(hpx::shared_future<void *> *f, size_t c, bool clone_p)
       : future(f), count(c), cloned_memref_p(clone_p) {}
 } dfr_refcounted_future_t, *dfr_refcounted_future_p;
 
-// Determine where new task should run.  For now just round-robin
-// distribution - TODO: optimise.
-static inline size_t dfr_get_next_execution_locality() {
+// Size of a task argument or output, including the data of the memrefs
+static inline size_t dfr_get_arg_bytes(void *arg, size_t size,
+                                       uint64_t type) {
+  if (_dfr_get_arg_type(type) != _DFR_TASK_ARG_MEMREF)
+    return size;
+  size_t rank = _dfr_get_memref_rank(size);
+  UnrankedMemRefType<char> umref = {(int64_t)rank, arg};
+  DynamicMemRefType<char> mref(umref);
+  size_t bytes = _dfr_get_memref_element_size(type);
+  for (size_t r = 0; r < rank; ++r)
+    bytes *= mref.sizes[r];
+  return size + bytes;
+}
+
+// Estimate the amount of data that must be shipped along with a task
+// running on a remote locality.  Inputs that are not computed yet are
+// accounted by the size of their descriptor only.
+static inline size_t
+dfr_estimate_input_bytes(std::vector<void *> &refcounted_futures,
+                         std::vector<size_t> &param_sizes,
+                         std::vector<uint64_t> &param_types) {
+  size_t bytes = 0;
+  for (size_t p = 0; p < refcounted_futures.size(); ++p) {
+    auto future = ((dfr_refcounted_future_p)refcounted_futures[p])->future;
+    if (future->is_ready())
+      bytes += dfr_get_arg_bytes(future->get(), param_sizes[p], param_types[p]);
+    else
+      bytes += param_sizes[p];
+  }
+  return bytes;
+}
+
+// The key placement of key_placement.h, on the state of the runtime
+static inline bool dfr_key_partition_allows(uint64_t wfn_id, size_t loc) {
+  return key_partition_allows(wfn_id, loc, num_nodes, key_partition_nodes);
+}
+
+static inline size_t dfr_key_fetch_cost(uint64_t wfn_id, size_t loc) {
+  std::lock_guard<std::mutex> guard(key_localities_guard);
+  return key_fetch_cost(key_localities, wfn_id, loc, key_fetch_tasks);
+}
+
+static inline void dfr_key_localities_add(uint64_t wfn_id, size_t loc) {
+  std::lock_guard<std::mutex> guard(key_localities_guard);
+  key_localities_add(key_localities, wfn_id, loc, num_nodes);
+}
+
+// Determine where new task should run.  Task outputs are always sent
+// back to the root node, so the root holds all the inputs and running
+// elsewhere costs a transfer proportional to the size of the inputs.
+// Each locality is scored by the number of tasks it has pending plus,
+// for remote ones, that transfer cost and the cost of fetching the keys
+// of the work function if they do not hold them yet, and the lowest score
+// wins.  Ties are broken round-robin so that idle nodes pick up the work.
+static inline size_t
+dfr_get_next_execution_locality(uint64_t wfn_id,
+                                std::vector<void *> &refcounted_futures,
+                                std::vector<size_t> &param_sizes,
+                                std::vector<uint64_t> &param_types) {
   static std::atomic<std::size_t> next_locality{1};
 
-  size_t next_loc = next_locality.fetch_add(1);
+  size_t first = next_locality.fetch_add(1) % num_nodes;
+  if (num_nodes == 1)
+    return 0;
+
+  size_t transfer_cost =
+      dfr_estimate_input_bytes(refcounted_futures, param_sizes, param_types) /
+      transfer_bytes_per_task;
+  size_t best_loc = first;
+  size_t best_score = SIZE_MAX;
+  for (size_t n = 0; n < num_nodes; ++n) {
+    size_t loc = (first + n) % num_nodes;
+    if (!dfr_key_partition_allows(wfn_id, loc))
+      continue;
+    size_t score = pending_tasks[loc].load(std::memory_order_relaxed);
+    if (loc != 0)
+      score += transfer_cost + dfr_key_fetch_cost(wfn_id, loc);
+    if (score < best_score) {
+      best_loc = loc;
+      best_score = score;
+    }
+  }
+  pending_tasks[best_loc].fetch_add(1, std::memory_order_relaxed);
+  dfr_key_localities_add(wfn_id, best_loc);
+  return best_loc;
+}
+
+// Account a new task in the job of the calling thread, if any
+static inline DFRJob *dfr_job_task_created() {
+  DFRJob *job = current_job;
+  if (job != nullptr) {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->pending++;
+  }
+  return job;
+}
+
+// Completion of a task created at `created`, in the time of the trace
+static inline void dfr_task_completed(size_t loc, DFRJob *job,
+                                      uint64_t wfn_id, uint64_t created) {
+  if (tracing::isEnabled()) {
+    static std::atomic<uint64_t> traced_tasks{0};
+    tracing::asyncSpan("dfr", "task lifetime", traced_tasks.fetch_add(1),
+                       created,
+                       {{"work_function", (int64_t)wfn_id},
+                        {"locality", (int64_t)loc}});
+  }
+  pending_tasks[loc].fetch_sub(1, std::memory_order_relaxed);
+  if (job != nullptr) {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (--job->pending == 0)
+      job->cv.notify_all();
+  }
+}
+
+// Record of a task in the task graph of its call, if any
+struct dfr_task_trace {
+  std::shared_ptr<DFRTaskGraph> graph;
+  size_t id = 0;
+};
+
+static inline dfr_task_trace
+dfr_trace_task_created(uint64_t wfn_id, size_t loc,
+                       std::vector<void *> &refcounted_futures) {
+  std::shared_ptr<DFRTaskGraph> graph = current_task_graph;
+  if (graph == nullptr)
+    return {};
+  DFRTaskRecord record;
+  record.wfn_id = wfn_id;
+  record.loc = loc;
+  record.created = graph->now();
+  for (auto rcf : refcounted_futures)
+    record.producers.push_back(((dfr_refcounted_future_p)rcf)->producer);
+  std::lock_guard<std::mutex> guard(graph->mutex);
+  graph->tasks.push_back(std::move(record));
+  return {graph, graph->tasks.size() - 1};
+}
+
+static inline void
+dfr_trace_task_started(const dfr_task_trace &trace,
+                       const std::vector<void *> &params,
+                       const std::vector<size_t> &param_sizes,
+                       const std::vector<uint64_t> &param_types) {
+  if (trace.graph == nullptr)
+    return;
+  std::vector<size_t> bytes;
+  for (size_t p = 0; p < param_sizes.size(); ++p)
+    bytes.push_back(
+        dfr_get_arg_bytes(params[p], param_sizes[p], param_types[p]));
+  uint64_t start = trace.graph->now();
+  std::lock_guard<std::mutex> guard(trace.graph->mutex);
+  DFRTaskRecord &record = trace.graph->tasks[trace.id];
+  record.start = start;
+  record.input_bytes = std::move(bytes);
+}
+
+static inline void dfr_trace_task_completed(const dfr_task_trace &trace,
+                                            const OpaqueOutputData &ood) {
+  if (trace.graph == nullptr)
+    return;
+  std::vector<size_t> bytes;
+  for (size_t p = 0; p < ood.outputs.size(); ++p)
+    bytes.push_back(dfr_get_arg_bytes(ood.outputs[p], ood.output_sizes[p],
+                                      ood.output_types[p]));
+  uint64_t end = trace.graph->now();
+  std::lock_guard<std::mutex> guard(trace.graph->mutex);
+  DFRTaskRecord &record = trace.graph->tasks[trace.id];
+  record.end = end;
+  record.output_bytes = std::move(bytes);
+  record.completed = true;
+}
+
+// Where a task runs.  Remote tasks that may be speculatively
+// re-executed keep a reference on their inputs in `refcounted_futures`.
+struct dfr_task_target {
+  size_t loc;
+  bool speculate;
+  std::vector<void *> refcounted_futures;
+  dfr_task_trace trace;
+};
+
+// Average completion time, in seconds, of the executions of a work
+// function on remote localities (0 if unknown yet).
+static inline double dfr_get_expected_task_time(uint64_t wfn_id) {
+  std::lock_guard<std::mutex> guard(task_times_guard);
+  auto it = task_times.find(wfn_id);
+  return (it == task_times.end()) ? 0 : it->second;
+}
+
+static inline void dfr_record_task_time(uint64_t wfn_id, double seconds) {
+  std::lock_guard<std::mutex> guard(task_times_guard);
+  auto it = task_times.find(wfn_id);
+  if (it == task_times.end())
+    task_times[wfn_id] = seconds;
+  else
+    it->second = 0.875 * it->second + 0.125 * seconds;
+}
 
-  return next_loc % num_nodes;
+// Release the outputs of the losing execution of a speculated task
+static inline void dfr_free_task_outputs(OpaqueOutputData &ood) {
+  for (size_t p = 0; p < ood.outputs.size(); ++p) {
+    if (_dfr_get_arg_type(ood.output_types[p]) == _DFR_TASK_ARG_MEMREF) {
+      auto mref = static_cast<StridedMemRefType<char, 1> *>(ood.outputs[p]);
+      concrete_checked_free(mref->basePtr != nullptr ? mref->basePtr
+                                                     : mref->data);
+    }
+    concrete_checked_free(ood.outputs[p]);
+  }
+}
+
+// Run a task on locality `loc`, the root node running it as a new HPX
+// thread.
+static inline hpx::future<OpaqueOutputData>
+dfr_run_task_on(size_t loc, wfnptr wfn, uint64_t wfn_id,
+                std::vector<void *> params, std::vector<size_t> param_sizes,
+                std::vector<uint64_t> param_types,
+                std::vector<size_t> output_sizes,
+                std::vector<uint64_t> output_types, void *ctx) {
+  if (loc == 0)
+    return hpx::async([=]() mutable {
+      if (ctx)
+        params.push_back(ctx);
+      return OpaqueOutputData(
+          _dfr_invoke_work_function(wfn, wfn_id, params, output_sizes),
+          output_sizes, output_types);
+    });
+  OpaqueInputData oid(wfn_id, params, param_sizes, param_types, output_sizes,
+                      output_types, ctx);
+  return gcc[loc].execute_task(oid);
+}
+
+// State of a remote task that may be re-executed on another locality if
+// it fails or runs for longer than `speculation_factor` times its
+// expected time.  The first result is kept, the inputs are released once
+// no execution nor watchdog refers to them anymore.
+struct dfr_speculative_task {
+  wfnptr wfn;
+  uint64_t wfn_id;
+  std::vector<void *> params;
+  std::vector<size_t> param_sizes;
+  std::vector<uint64_t> param_types;
+  std::vector<size_t> output_sizes;
+  std::vector<uint64_t> output_types;
+  void *ctx;
+  size_t loc;
+  std::vector<void *> refcounted_futures;
+  hpx::promise<OpaqueOutputData> result;
+  std::atomic<bool> done{false};
+  std::atomic<bool> reissued{false};
+  std::atomic<size_t> holders{1};
+  std::mutex error_guard;
+  std::exception_ptr error;
+};
+typedef std::shared_ptr<dfr_speculative_task> dfr_speculative_task_p;
+
+static inline void dfr_speculation_release(dfr_speculative_task_p task) {
+  if (task->holders.fetch_sub(1) != 1)
+    return;
+  // All executions failed
+  if (!task->done.exchange(true)) {
+    std::lock_guard<std::mutex> guard(task->error_guard);
+    task->result.set_exception(task->error);
+  }
+  for (auto rcf : task->refcounted_futures)
+    _dfr_deallocate_future(rcf);
+}
+
+static inline bool dfr_speculation_reissue(dfr_speculative_task_p task);
+
+static inline void dfr_speculation_attempt(dfr_speculative_task_p task,
+                                           size_t loc, bool backup) {
+  task->holders.fetch_add(1);
+  auto start = std::chrono::steady_clock::now();
+  dfr_run_task_on(loc, task->wfn, task->wfn_id, task->params,
+                  task->param_sizes, task->param_types, task->output_sizes,
+                  task->output_types, task->ctx)
+      .then([task, loc, backup, start](hpx::future<OpaqueOutputData> f) {
+        if (backup)
+          pending_tasks[loc].fetch_sub(1, std::memory_order_relaxed);
+        if (f.has_exception()) {
+          remote_task_failures.fetch_add(1, std::memory_order_relaxed);
+          {
+            std::lock_guard<std::mutex> guard(task->error_guard);
+            task->error = f.get_exception_ptr();
+          }
+          dfr_speculation_reissue(task);
+        } else {
+          OpaqueOutputData ood = f.get();
+          if (!task->done.exchange(true)) {
+            dfr_record_task_time(
+                task->wfn_id, std::chrono::duration<double>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count());
+            if (backup)
+              speculative_wins.fetch_add(1, std::memory_order_relaxed);
+            task->result.set_value(std::move(ood));
+          } else {
+            dfr_free_task_outputs(ood);
+          }
+        }
+        dfr_speculation_release(task);
+      });
+}
+
+// Execute the task again on the least loaded other locality, at most
+// once.
+static inline bool dfr_speculation_reissue(dfr_speculative_task_p task) {
+  if (task->done.load() || task->reissued.exchange(true))
+    return false;
+  size_t best_loc = 0;
+  size_t best_score = SIZE_MAX;
+  for (size_t loc = 0; loc < num_nodes; ++loc) {
+    if (!dfr_key_partition_allows(task->wfn_id, loc))
+      continue;
+    size_t score = pending_tasks[loc].load(std::memory_order_relaxed) +
+                   dfr_key_fetch_cost(task->wfn_id, loc);
+    if (loc != task->loc && score < best_score) {
+      best_loc = loc;
+      best_score = score;
+    }
+  }
+  pending_tasks[best_loc].fetch_add(1, std::memory_order_relaxed);
+  dfr_key_localities_add(task->wfn_id, best_loc);
+  speculative_tasks.fetch_add(1, std::memory_order_relaxed);
+  dfr_speculation_attempt(task, best_loc, true);
+  return true;
+}
+
+static inline hpx::future<OpaqueOutputData>
+dfr_execute_speculative_task(const dfr_task_target &target, wfnptr wfn,
+                             uint64_t wfn_id, std::vector<void *> &params,
+                             const std::vector<size_t> &param_sizes,
+                             const std::vector<uint64_t> &param_types,
+                             const std::vector<size_t> &output_sizes,
+                             const std::vector<uint64_t> &output_types,
+                             void *ctx) {
+  auto task = std::make_shared<dfr_speculative_task>();
+  task->wfn = wfn;
+  task->wfn_id = wfn_id;
+  task->params = params;
+  task->param_sizes = param_sizes;
+  task->param_types = param_types;
+  task->output_sizes = output_sizes;
+  task->output_types = output_types;
+  task->ctx = ctx;
+  task->loc = target.loc;
+  task->refcounted_futures = target.refcounted_futures;
+  hpx::future<OpaqueOutputData> result = task->result.get_future();
+
+  dfr_speculation_attempt(task, target.loc, false);
+  double expected = dfr_get_expected_task_time(wfn_id);
+  if (expected > 0) {
+    task->holders.fetch_add(1);
+    auto timeout = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::duration<double>(expected * speculation_factor));
+    hpx::post([task, timeout]() {
+      hpx::this_thread::sleep_for(timeout);
+      dfr_speculation_reissue(task);
+      dfr_speculation_release(task);
+    });
+  }
+  dfr_speculation_release(task);
+  return result;
+}
+
+// Execute a task once its inputs are available.  Tasks placed on the
+// root node call their work function directly on the current worker
+// thread, on the input pointers, while the others are packed and sent to
+// the compute server of their locality.
+static inline hpx::future<OpaqueOutputData>
+dfr_execute_task(const dfr_task_target &target, wfnptr wfn, uint64_t wfn_id,
+                 std::vector<void *> &params,
+                 const std::vector<size_t> &param_sizes,
+                 const std::vector<uint64_t> &param_types,
+                 const std::vector<size_t> &output_sizes,
+                 const std::vector<uint64_t> &output_types, void *ctx) {
+  dfr_trace_task_started(target.trace, params, param_sizes, param_types);
+  if (target.loc == 0) {
+    if (ctx)
+      params.push_back(ctx);
+    return hpx::make_ready_future(OpaqueOutputData(
+        _dfr_invoke_work_function(wfn, wfn_id, params, output_sizes),
+        output_sizes, output_types));
+  }
+  if (target.speculate)
+    return dfr_execute_speculative_task(target, wfn, wfn_id, params,
+                                        param_sizes, param_types, output_sizes,
+                                        output_types, ctx);
+  OpaqueInputData oid(wfn_id, params, param_sizes, param_types, output_sizes,
+                      output_types, ctx);
+  return gcc[target.loc].execute_task(oid);
 }
 
 void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
@@ -41,12 +426,12 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
   for (auto rcf : refcounted_futures)
     ((dfr_refcounted_future_p)rcf)->count.fetch_add(1);
 
-  // We pass functions by name - which is not strictly necessary in
+  // We pass functions by id - which is not strictly necessary in
   // shared memory as pointers suffice, but is needed in the
   // distributed case where the functions need to be located/loaded on
   // the node.
-  auto wfnname =
-      _dfr_node_level_work_function_registry->getWorkFunctionName((void *)wfn);
+  auto wfn_id =
+      _dfr_node_level_work_function_registry->getWorkFunctionId((void *)wfn);
   hpx::future<hpx::future<OpaqueOutputData>> oodf;
 
   // In order to allow complete dataflow semantics for
@@ -55,7 +440,20 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
   // satisfied, which generates a future on a tuple of outputs, which
   // is then further split into a tuple of futures and provide
   // individual synchronization for each return independently.
-  GenericComputeClient *gcc_target = &gcc[dfr_get_next_execution_locality()];
+  size_t exec_loc = dfr_get_next_execution_locality(
+      wfn_id, refcounted_futures, param_sizes, param_types);
+  dfr_task_target target = {
+      exec_loc, false, {},
+      dfr_trace_task_created(wfn_id, exec_loc, refcounted_futures)};
+  if (exec_loc != 0 && speculation_factor > 0) {
+    // Keep the inputs for a re-execution until all executions completed
+    target.speculate = true;
+    target.refcounted_futures = refcounted_futures;
+    for (auto rcf : refcounted_futures)
+      ((dfr_refcounted_future_p)rcf)->count.fetch_add(1);
+  }
+  DFRJob *job = dfr_job_task_created();
+  uint64_t created = tracing::now();
   switch (refcounted_futures.size()) {
 
 #include "concretelang/Runtime/generated/dfr_dataflow_inputs_cases.h"
@@ -69,9 +467,13 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
   case 1:
     *((void **)outputs[0]) = (void *)new dfr_refcounted_future_t(
         new hpx::shared_future<void *>(hpx::dataflow(
-            [refcounted_futures](
+            [refcounted_futures, exec_loc, job, wfn_id, created,
+             trace = target.trace](
                 hpx::future<OpaqueOutputData> oodf_in) -> void * {
-              void *ret = oodf_in.get().outputs[0];
+              OpaqueOutputData ood = oodf_in.get();
+              dfr_trace_task_completed(trace, ood);
+              void *ret = ood.outputs[0];
+              dfr_task_completed(exec_loc, job, wfn_id, created);
               for (auto rcf : refcounted_futures)
                 _dfr_deallocate_future(rcf);
               return ret;
@@ -82,9 +484,13 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
 
   case 2: {
     hpx::future<hpx::tuple<void *, void *>> &&ft = hpx::dataflow(
-        [refcounted_futures](hpx::future<OpaqueOutputData> oodf_in)
+        [refcounted_futures, exec_loc, job, wfn_id, created,
+         trace = target.trace](hpx::future<OpaqueOutputData> oodf_in)
             -> hpx::tuple<void *, void *> {
-          std::vector<void *> outputs = std::move(oodf_in.get().outputs);
+          OpaqueOutputData ood = oodf_in.get();
+          dfr_trace_task_completed(trace, ood);
+          std::vector<void *> outputs = std::move(ood.outputs);
+          dfr_task_completed(exec_loc, job, wfn_id, created);
           for (auto rcf : refcounted_futures)
             _dfr_deallocate_future(rcf);
           return hpx::make_tuple<>(outputs[0], outputs[1]);
@@ -103,9 +509,13 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
 
   case 3: {
     hpx::future<hpx::tuple<void *, void *, void *>> &&ft = hpx::dataflow(
-        [refcounted_futures](hpx::future<OpaqueOutputData> oodf_in)
+        [refcounted_futures, exec_loc, job, wfn_id, created,
+         trace = target.trace](hpx::future<OpaqueOutputData> oodf_in)
             -> hpx::tuple<void *, void *, void *> {
-          std::vector<void *> outputs = std::move(oodf_in.get().outputs);
+          OpaqueOutputData ood = oodf_in.get();
+          dfr_trace_task_completed(trace, ood);
+          std::vector<void *> outputs = std::move(ood.outputs);
+          dfr_task_completed(exec_loc, job, wfn_id, created);
           for (auto rcf : refcounted_futures)
             _dfr_deallocate_future(rcf);
           return hpx::make_tuple<>(outputs[0], outputs[1], outputs[2]);
@@ -129,6 +539,10 @@ void dfr_create_async_task_impl(wfnptr wfn, void *ctx,
     HPX_THROW_EXCEPTION(hpx::error::no_success, "_dfr_create_async_task",
                         "Error: number of task outputs not supported.");
   }
+
+  if (target.trace.graph != nullptr)
+    for (auto output : outputs)
+      (*(dfr_refcounted_future_p *)output)->producer = target.trace.id;
 }
 
 } // namespace dfr
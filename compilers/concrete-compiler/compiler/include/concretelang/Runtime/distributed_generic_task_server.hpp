@@ -9,7 +9,10 @@
 #include <cstdarg>
 #include <cstdlib>
 #include <malloc.h>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <hpx/async_colocated/get_colocation_id.hpp>
 #include <hpx/include/actions.hpp>
@@ -34,6 +37,7 @@
 #include "concretelang/Runtime/dfr_debug_interface.h"
 #include "concretelang/Runtime/key_manager.hpp"
 #include "concretelang/Runtime/runtime_api.h"
+#include "concretelang/Runtime/tracing.h"
 #include "concretelang/Runtime/workfunction_registry.hpp"
 
 using namespace hpx::components;
@@ -60,34 +64,116 @@ static inline void _dfr_checked_aligned_alloc(void **out, size_t align,
                         "Error: invalid memory alignment.");
 }
 
+/// Pool of the buffers receiving the memref payloads of the tasks executed
+/// on a remote node. The payloads are deserialized directly into buffers
+/// released by completed tasks when one of the same size class is
+/// available, rather than into fresh allocations. Up to
+/// `DFR_BUFFER_POOL_BYTES` bytes (256 MiB by default) are kept per node.
+struct MemrefBufferPool {
+  static void *acquire(size_t size) {
+    MemrefBufferPool &pool = get();
+    size = sizeClass(size);
+    {
+      std::lock_guard<std::mutex> guard(pool.mutex);
+      auto it = pool.buffers.find(size);
+      if (it != pool.buffers.end() && !it->second.empty()) {
+        void *buffer = it->second.back();
+        it->second.pop_back();
+        pool.pooled_bytes -= size;
+        return buffer;
+      }
+    }
+    void *buffer;
+    _dfr_checked_aligned_alloc(&buffer, 512, size);
+    return buffer;
+  }
+
+  static void release(void *buffer, size_t size) {
+    MemrefBufferPool &pool = get();
+    size = sizeClass(size);
+    {
+      std::lock_guard<std::mutex> guard(pool.mutex);
+      if (pool.pooled_bytes + size <= pool.capacity) {
+        pool.buffers[size].push_back(buffer);
+        pool.pooled_bytes += size;
+        return;
+      }
+    }
+    free(buffer);
+  }
+
+private:
+  MemrefBufferPool() {
+    char *env = getenv("DFR_BUFFER_POOL_BYTES");
+    if (env != nullptr)
+      capacity = strtoull(env, NULL, 10);
+  }
+  ~MemrefBufferPool() {
+    for (auto &size_buffers : buffers)
+      for (void *buffer : size_buffers.second)
+        free(buffer);
+  }
+
+  static MemrefBufferPool &get() {
+    static MemrefBufferPool pool;
+    return pool;
+  }
+
+  // Sizes are rounded up to whole pages so that buffers of close sizes
+  // can be reused for one another
+  static size_t sizeClass(size_t size) { return (size + 4095) & ~(size_t)4095; }
+
+  std::mutex mutex;
+  std::map<size_t, std::vector<void *>> buffers;
+  size_t pooled_bytes = 0;
+  size_t capacity = 256 << 20;
+};
+
+/// Size of the buffer holding the data of a memref, including its offset.
+static inline size_t _dfr_get_memref_alloc_size(void *memref, size_t size,
+                                                uint64_t type) {
+  size_t rank = _dfr_get_memref_rank(size);
+  UnrankedMemRefType<char> umref = {(int64_t)rank, memref};
+  DynamicMemRefType<char> mref(umref);
+  size_t elements = 1;
+  for (size_t r = 0; r < rank; ++r)
+    elements *= mref.sizes[r];
+  return (elements + mref.offset) * _dfr_get_memref_element_size(type);
+}
+
 struct OpaqueInputData {
   OpaqueInputData() = default;
 
-  OpaqueInputData(std::string _wfn_name, std::vector<void *> _params,
+  OpaqueInputData(uint64_t _wfn_id, std::vector<void *> _params,
                   std::vector<size_t> _param_sizes,
                   std::vector<uint64_t> _param_types,
                   std::vector<size_t> _output_sizes,
                   std::vector<uint64_t> _output_types, void *_context = nullptr)
-      : wfn_name(_wfn_name), params(std::move(_params)),
+      : wfn_id(_wfn_id), params(std::move(_params)),
         param_sizes(std::move(_param_sizes)),
         param_types(std::move(_param_types)),
         output_sizes(std::move(_output_sizes)),
         output_types(std::move(_output_types)), context(_context) {
-    if (_context)
+    if (_context) {
       params.push_back(_context);
+      // Remote nodes use their copy of the keys of the call
+      context_id =
+          _dfr_node_level_runtime_context_manager->getContextId(_context);
+    }
   }
 
   OpaqueInputData(const OpaqueInputData &oid)
-      : wfn_name(std::move(oid.wfn_name)), params(std::move(oid.params)),
+      : wfn_id(oid.wfn_id), params(std::move(oid.params)),
         param_sizes(std::move(oid.param_sizes)),
         param_types(std::move(oid.param_types)),
         output_sizes(std::move(oid.output_sizes)),
-        output_types(std::move(oid.output_types)), context(oid.context) {}
+        output_types(std::move(oid.output_types)), context(oid.context),
+        context_id(oid.context_id) {}
 
   friend class hpx::serialization::access;
   template <class Archive> void load(Archive &ar, const unsigned int version) {
     bool has_context;
-    ar >> wfn_name >> has_context;
+    ar >> wfn_id >> has_context >> context_id;
     ar >> param_sizes >> param_types;
     ar >> output_sizes >> output_types;
     for (size_t p = 0; p < param_sizes.size(); ++p) {
@@ -109,8 +195,7 @@ struct OpaqueInputData {
         for (size_t r = 0; r < rank; ++r)
           size *= mref.sizes[r];
         size_t alloc_size = (size + mref.offset) * elementSize;
-        char *data;
-        _dfr_checked_aligned_alloc((void **)&data, 512, alloc_size);
+        char *data = (char *)MemrefBufferPool::acquire(alloc_size);
         ar >> hpx::serialization::make_array(data + mref.offset * elementSize,
                                              size * elementSize);
         static_cast<StridedMemRefType<char, 1> *>(params[p])->basePtr = nullptr;
@@ -122,13 +207,13 @@ struct OpaqueInputData {
       }
     }
     if (has_context)
-      params.push_back(
-          (void *)_dfr_node_level_runtime_context_manager->getContext());
+      params.push_back((void *)_dfr_node_level_runtime_context_manager
+                           ->getContext(context_id));
   }
   template <class Archive>
   void save(Archive &ar, const unsigned int version) const {
     bool has_context = (bool)(context != nullptr);
-    ar << wfn_name << has_context;
+    ar << wfn_id << has_context << context_id;
     ar << param_sizes << param_types;
     ar << output_sizes << output_types;
     for (size_t p = 0; p < param_sizes.size(); ++p) {
@@ -157,13 +242,14 @@ struct OpaqueInputData {
   }
   HPX_SERIALIZATION_SPLIT_MEMBER()
 
-  std::string wfn_name;
+  uint64_t wfn_id;
   std::vector<void *> params;
   std::vector<size_t> param_sizes;
   std::vector<uint64_t> param_types;
   std::vector<size_t> output_sizes;
   std::vector<uint64_t> output_types;
   void *context;
+  uint64_t context_id = 0;
 };
 
 struct OpaqueOutputData {
@@ -248,32 +334,49 @@ struct OpaqueOutputData {
   std::vector<uint64_t> output_types;
 };
 
+// Call the work function `wfn`, of id `wfn_id`, on `params`, returning
+// its freshly allocated outputs.
+static inline std::vector<void *>
+_dfr_invoke_work_function(wfnptr wfn, uint64_t wfn_id,
+                          const std::vector<void *> &params,
+                          const std::vector<size_t> &output_sizes) {
+  tracing::TraceScope trace("dfr", "task",
+                            {{"work_function", (int64_t)wfn_id}});
+  std::vector<void *> outputs;
+
+  switch (output_sizes.size()) {
+
+#include "concretelang/Runtime/generated/dfr_task_work_function_calls.h"
+
+  default:
+    HPX_THROW_EXCEPTION(hpx::error::no_success, "_dfr_invoke_work_function",
+                        "Error: number of task outputs not supported.");
+  }
+  return outputs;
+}
+
 struct GenericComputeServer : component_base<GenericComputeServer> {
   GenericComputeServer() = default;
 
   // Component actions exposed
   OpaqueOutputData execute_task(const OpaqueInputData &inputs) {
     auto wfn = _dfr_node_level_work_function_registry->getWorkFunctionPointer(
-        inputs.wfn_name);
-    std::vector<void *> outputs;
-
-    switch (inputs.output_sizes.size()) {
-
-#include "concretelang/Runtime/generated/dfr_task_work_function_calls.h"
-
-    default:
-      HPX_THROW_EXCEPTION(hpx::error::no_success,
-                          "GenericComputeServer::execute_task",
-                          "Error: number of task outputs not supported.");
-    }
+        inputs.wfn_id);
+    std::vector<void *> outputs = _dfr_invoke_work_function(
+        wfn, inputs.wfn_id, inputs.params, inputs.output_sizes);
 
-    // Deallocate input data buffers from OID deserialization (load)
+    // Release input data buffers from OID deserialization (load), the
+    // memref payloads go back to the pool for the next tasks
     if (!_dfr_is_root_node()) {
       for (size_t p = 0; p < inputs.param_sizes.size(); ++p) {
         if (_dfr_get_arg_type(inputs.param_types[p]) == _DFR_TASK_ARG_MEMREF)
-          delete (static_cast<StridedMemRefType<char, 1> *>(inputs.params[p])
-                      ->data);
-        delete ((char *)inputs.params[p]);
+          MemrefBufferPool::release(
+              static_cast<StridedMemRefType<char, 1> *>(inputs.params[p])
+                  ->data,
+              _dfr_get_memref_alloc_size(inputs.params[p],
+                                         inputs.param_sizes[p],
+                                         inputs.param_types[p]));
+        free(inputs.params[p]);
       }
     }
 
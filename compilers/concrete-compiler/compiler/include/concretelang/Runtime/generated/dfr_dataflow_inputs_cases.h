@@ -1,39 +1,38 @@
 case 0:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx]() -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx]()
+        -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     }));
 break;
 
 case 1:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future));
 break;
 
 case 2:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future));
@@ -41,15 +40,15 @@ break;
 
 case 3:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -58,16 +57,17 @@ break;
 
 case 4:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -77,17 +77,18 @@ break;
 
 case 5:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get(), param4.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -98,17 +99,19 @@ break;
 
 case 6:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get(), param4.get(), param5.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -120,19 +123,21 @@ break;
 
 case 7:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get(), param4.get(), param5.get(),
                                     param6.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -145,19 +150,22 @@ break;
 
 case 8:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6, hpx::shared_future<void *> param7)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get(), param4.get(), param5.get(),
                                     param6.get(), param7.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -171,20 +179,23 @@ break;
 
 case 9:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-          hpx::shared_future<void *> param8)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get(), param4.get(), param5.get(),
                                     param6.get(), param7.get(), param8.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -199,20 +210,24 @@ break;
 
 case 10:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-          hpx::shared_future<void *> param8, hpx::shared_future<void *> param9)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(), param1.get(), param2.get(), param3.get(), param4.get(),
           param5.get(), param6.get(), param7.get(), param8.get(), param9.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -228,22 +243,26 @@ break;
 
 case 11:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-          hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-          hpx::shared_future<void *> param10)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(), param2.get(),
                                     param3.get(), param4.get(), param5.get(),
                                     param6.get(), param7.get(), param8.get(),
                                     param9.get(), param10.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -260,23 +279,27 @@ break;
 
 case 12:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-          hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-          hpx::shared_future<void *> param10,
-          hpx::shared_future<void *> param11)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(),  param2.get(),
                                     param3.get(), param4.get(),  param5.get(),
                                     param6.get(), param7.get(),  param8.get(),
                                     param9.get(), param10.get(), param11.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -294,25 +317,29 @@ break;
 
 case 13:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-          hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-          hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-          hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-          hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-          hpx::shared_future<void *> param10,
-          hpx::shared_future<void *> param11,
-          hpx::shared_future<void *> param12)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(), param1.get(),  param2.get(),
                                     param3.get(), param4.get(),  param5.get(),
                                     param6.get(), param7.get(),  param8.get(),
                                     param9.get(), param10.get(), param11.get(),
                                     param12.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -331,25 +358,30 @@ break;
 
 case 14:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(),  param1.get(),  param2.get(),
                                     param3.get(),  param4.get(),  param5.get(),
                                     param6.get(),  param7.get(),  param8.get(),
                                     param9.get(),  param10.get(), param11.get(),
                                     param12.get(), param13.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -369,26 +401,31 @@ break;
 
 case 15:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
           param4.get(),  param5.get(),  param6.get(),  param7.get(),
           param8.get(),  param9.get(),  param10.get(), param11.get(),
           param12.get(), param13.get(), param14.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -409,26 +446,32 @@ break;
 
 case 16:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
           param4.get(),  param5.get(),  param6.get(),  param7.get(),
           param8.get(),  param9.get(),  param10.get(), param11.get(),
           param12.get(), param13.get(), param14.get(), param15.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -450,17 +493,24 @@ break;
 
 case 17:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {param0.get(),  param1.get(),  param2.get(),
                                     param3.get(),  param4.get(),  param5.get(),
@@ -468,10 +518,9 @@ oodf = std::move(hpx::dataflow(
                                     param9.get(),  param10.get(), param11.get(),
                                     param12.get(), param13.get(), param14.get(),
                                     param15.get(), param16.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -494,17 +543,25 @@ break;
 
 case 18:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -512,10 +569,9 @@ oodf = std::move(hpx::dataflow(
           param8.get(),  param9.get(),  param10.get(), param11.get(),
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -539,18 +595,26 @@ break;
 
 case 19:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -558,10 +622,9 @@ oodf = std::move(hpx::dataflow(
           param8.get(),  param9.get(),  param10.get(), param11.get(),
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get(), param18.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -586,18 +649,27 @@ break;
 
 case 20:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -605,10 +677,9 @@ oodf = std::move(hpx::dataflow(
           param8.get(),  param9.get(),  param10.get(), param11.get(),
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get(), param18.get(), param19.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -634,19 +705,28 @@ break;
 
 case 21:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -655,10 +735,9 @@ oodf = std::move(hpx::dataflow(
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -685,19 +764,29 @@ break;
 
 case 22:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -706,10 +795,9 @@ oodf = std::move(hpx::dataflow(
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -737,20 +825,30 @@ break;
 
 case 23:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -759,10 +857,9 @@ oodf = std::move(hpx::dataflow(
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get(), param22.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -791,20 +888,31 @@ break;
 
 case 24:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -813,10 +921,9 @@ oodf = std::move(hpx::dataflow(
           param12.get(), param13.get(), param14.get(), param15.get(),
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get(), param22.get(), param23.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -846,21 +953,32 @@ break;
 
 case 25:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -870,10 +988,9 @@ oodf = std::move(hpx::dataflow(
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -904,21 +1021,33 @@ break;
 
 case 26:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -928,10 +1057,9 @@ oodf = std::move(hpx::dataflow(
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -963,22 +1091,34 @@ break;
 
 case 27:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -988,10 +1128,9 @@ oodf = std::move(hpx::dataflow(
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get(), param26.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1024,22 +1163,35 @@ break;
 
 case 28:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1049,10 +1201,9 @@ oodf = std::move(hpx::dataflow(
           param16.get(), param17.get(), param18.get(), param19.get(),
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get(), param26.get(), param27.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1086,23 +1237,36 @@ break;
 
 case 29:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1113,10 +1277,9 @@ oodf = std::move(hpx::dataflow(
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1151,23 +1314,37 @@ break;
 
 case 30:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1178,10 +1355,9 @@ oodf = std::move(hpx::dataflow(
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1217,24 +1393,38 @@ break;
 
 case 31:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1245,10 +1435,9 @@ oodf = std::move(hpx::dataflow(
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get(), param30.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1285,24 +1474,39 @@ break;
 
 case 32:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1313,10 +1517,9 @@ oodf = std::move(hpx::dataflow(
           param20.get(), param21.get(), param22.get(), param23.get(),
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get(), param30.get(), param31.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1354,25 +1557,40 @@ break;
 
 case 33:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1384,10 +1602,9 @@ oodf = std::move(hpx::dataflow(
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1426,25 +1643,41 @@ break;
 
 case 34:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1456,10 +1689,9 @@ oodf = std::move(hpx::dataflow(
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1499,26 +1731,42 @@ break;
 
 case 35:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1530,10 +1778,9 @@ oodf = std::move(hpx::dataflow(
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get(), param34.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1574,26 +1821,43 @@ break;
 
 case 36:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1605,10 +1869,9 @@ oodf = std::move(hpx::dataflow(
           param24.get(), param25.get(), param26.get(), param27.get(),
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get(), param34.get(), param35.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1650,27 +1913,44 @@ break;
 
 case 37:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1683,10 +1963,9 @@ oodf = std::move(hpx::dataflow(
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1729,27 +2008,45 @@ break;
 
 case 38:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1762,10 +2059,9 @@ oodf = std::move(hpx::dataflow(
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1809,28 +2105,46 @@ break;
 
 case 39:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1843,10 +2157,9 @@ oodf = std::move(hpx::dataflow(
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get(), param38.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1891,28 +2204,47 @@ break;
 
 case 40:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -1925,10 +2257,9 @@ oodf = std::move(hpx::dataflow(
           param28.get(), param29.get(), param30.get(), param31.get(),
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get(), param38.get(), param39.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -1974,29 +2305,48 @@ break;
 
 case 41:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2010,10 +2360,9 @@ oodf = std::move(hpx::dataflow(
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2060,29 +2409,49 @@ break;
 
 case 42:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2096,10 +2465,9 @@ oodf = std::move(hpx::dataflow(
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2147,30 +2515,50 @@ break;
 
 case 43:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2184,10 +2572,9 @@ oodf = std::move(hpx::dataflow(
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get(), param42.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2236,30 +2623,51 @@ break;
 
 case 44:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2273,10 +2681,9 @@ oodf = std::move(hpx::dataflow(
           param32.get(), param33.get(), param34.get(), param35.get(),
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get(), param42.get(), param43.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2326,31 +2733,52 @@ break;
 
 case 45:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43,
-        hpx::shared_future<void *> param44)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43,
+                  hpx::shared_future<void *> param44)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2365,10 +2793,9 @@ oodf = std::move(hpx::dataflow(
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get(), param42.get(), param43.get(),
           param44.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2419,31 +2846,53 @@ break;
 
 case 46:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43,
-        hpx::shared_future<void *> param44, hpx::shared_future<void *> param45)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43,
+                  hpx::shared_future<void *> param44,
+                  hpx::shared_future<void *> param45)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2458,10 +2907,9 @@ oodf = std::move(hpx::dataflow(
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get(), param42.get(), param43.get(),
           param44.get(), param45.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2513,32 +2961,54 @@ break;
 
 case 47:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43,
-        hpx::shared_future<void *> param44, hpx::shared_future<void *> param45,
-        hpx::shared_future<void *> param46)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43,
+                  hpx::shared_future<void *> param44,
+                  hpx::shared_future<void *> param45,
+                  hpx::shared_future<void *> param46)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2553,10 +3023,9 @@ oodf = std::move(hpx::dataflow(
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get(), param42.get(), param43.get(),
           param44.get(), param45.get(), param46.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2609,32 +3078,55 @@ break;
 
 case 48:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43,
-        hpx::shared_future<void *> param44, hpx::shared_future<void *> param45,
-        hpx::shared_future<void *> param46, hpx::shared_future<void *> param47)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43,
+                  hpx::shared_future<void *> param44,
+                  hpx::shared_future<void *> param45,
+                  hpx::shared_future<void *> param46,
+                  hpx::shared_future<void *> param47)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2649,10 +3141,9 @@ oodf = std::move(hpx::dataflow(
           param36.get(), param37.get(), param38.get(), param39.get(),
           param40.get(), param41.get(), param42.get(), param43.get(),
           param44.get(), param45.get(), param46.get(), param47.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2706,33 +3197,56 @@ break;
 
 case 49:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43,
-        hpx::shared_future<void *> param44, hpx::shared_future<void *> param45,
-        hpx::shared_future<void *> param46, hpx::shared_future<void *> param47,
-        hpx::shared_future<void *> param48)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43,
+                  hpx::shared_future<void *> param44,
+                  hpx::shared_future<void *> param45,
+                  hpx::shared_future<void *> param46,
+                  hpx::shared_future<void *> param47,
+                  hpx::shared_future<void *> param48)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2748,10 +3262,9 @@ oodf = std::move(hpx::dataflow(
           param40.get(), param41.get(), param42.get(), param43.get(),
           param44.get(), param45.get(), param46.get(), param47.get(),
           param48.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -2806,33 +3319,57 @@ break;
 
 case 50:
 oodf = std::move(hpx::dataflow(
-    [wfnname, param_sizes, param_types, output_sizes, output_types, gcc_target,
-     ctx](
-        hpx::shared_future<void *> param0, hpx::shared_future<void *> param1,
-        hpx::shared_future<void *> param2, hpx::shared_future<void *> param3,
-        hpx::shared_future<void *> param4, hpx::shared_future<void *> param5,
-        hpx::shared_future<void *> param6, hpx::shared_future<void *> param7,
-        hpx::shared_future<void *> param8, hpx::shared_future<void *> param9,
-        hpx::shared_future<void *> param10, hpx::shared_future<void *> param11,
-        hpx::shared_future<void *> param12, hpx::shared_future<void *> param13,
-        hpx::shared_future<void *> param14, hpx::shared_future<void *> param15,
-        hpx::shared_future<void *> param16, hpx::shared_future<void *> param17,
-        hpx::shared_future<void *> param18, hpx::shared_future<void *> param19,
-        hpx::shared_future<void *> param20, hpx::shared_future<void *> param21,
-        hpx::shared_future<void *> param22, hpx::shared_future<void *> param23,
-        hpx::shared_future<void *> param24, hpx::shared_future<void *> param25,
-        hpx::shared_future<void *> param26, hpx::shared_future<void *> param27,
-        hpx::shared_future<void *> param28, hpx::shared_future<void *> param29,
-        hpx::shared_future<void *> param30, hpx::shared_future<void *> param31,
-        hpx::shared_future<void *> param32, hpx::shared_future<void *> param33,
-        hpx::shared_future<void *> param34, hpx::shared_future<void *> param35,
-        hpx::shared_future<void *> param36, hpx::shared_future<void *> param37,
-        hpx::shared_future<void *> param38, hpx::shared_future<void *> param39,
-        hpx::shared_future<void *> param40, hpx::shared_future<void *> param41,
-        hpx::shared_future<void *> param42, hpx::shared_future<void *> param43,
-        hpx::shared_future<void *> param44, hpx::shared_future<void *> param45,
-        hpx::shared_future<void *> param46, hpx::shared_future<void *> param47,
-        hpx::shared_future<void *> param48, hpx::shared_future<void *> param49)
+    [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+     target, ctx](hpx::shared_future<void *> param0,
+                  hpx::shared_future<void *> param1,
+                  hpx::shared_future<void *> param2,
+                  hpx::shared_future<void *> param3,
+                  hpx::shared_future<void *> param4,
+                  hpx::shared_future<void *> param5,
+                  hpx::shared_future<void *> param6,
+                  hpx::shared_future<void *> param7,
+                  hpx::shared_future<void *> param8,
+                  hpx::shared_future<void *> param9,
+                  hpx::shared_future<void *> param10,
+                  hpx::shared_future<void *> param11,
+                  hpx::shared_future<void *> param12,
+                  hpx::shared_future<void *> param13,
+                  hpx::shared_future<void *> param14,
+                  hpx::shared_future<void *> param15,
+                  hpx::shared_future<void *> param16,
+                  hpx::shared_future<void *> param17,
+                  hpx::shared_future<void *> param18,
+                  hpx::shared_future<void *> param19,
+                  hpx::shared_future<void *> param20,
+                  hpx::shared_future<void *> param21,
+                  hpx::shared_future<void *> param22,
+                  hpx::shared_future<void *> param23,
+                  hpx::shared_future<void *> param24,
+                  hpx::shared_future<void *> param25,
+                  hpx::shared_future<void *> param26,
+                  hpx::shared_future<void *> param27,
+                  hpx::shared_future<void *> param28,
+                  hpx::shared_future<void *> param29,
+                  hpx::shared_future<void *> param30,
+                  hpx::shared_future<void *> param31,
+                  hpx::shared_future<void *> param32,
+                  hpx::shared_future<void *> param33,
+                  hpx::shared_future<void *> param34,
+                  hpx::shared_future<void *> param35,
+                  hpx::shared_future<void *> param36,
+                  hpx::shared_future<void *> param37,
+                  hpx::shared_future<void *> param38,
+                  hpx::shared_future<void *> param39,
+                  hpx::shared_future<void *> param40,
+                  hpx::shared_future<void *> param41,
+                  hpx::shared_future<void *> param42,
+                  hpx::shared_future<void *> param43,
+                  hpx::shared_future<void *> param44,
+                  hpx::shared_future<void *> param45,
+                  hpx::shared_future<void *> param46,
+                  hpx::shared_future<void *> param47,
+                  hpx::shared_future<void *> param48,
+                  hpx::shared_future<void *> param49)
         -> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
       std::vector<void *> params = {
           param0.get(),  param1.get(),  param2.get(),  param3.get(),
@@ -2848,10 +3385,9 @@ oodf = std::move(hpx::dataflow(
           param40.get(), param41.get(), param42.get(), param43.get(),
           param44.get(), param45.get(), param46.get(), param47.get(),
           param48.get(), param49.get()};
-      mlir::concretelang::dfr::OpaqueInputData oid(wfnname, params, param_sizes,
-                                                   param_types, output_sizes,
-                                                   output_types, ctx);
-      return gcc_target->execute_task(oid);
+      return dfr_execute_task(target, wfn, wfn_id, params, param_sizes,
+                              param_types, output_sizes, output_types,
+                              ctx);
     },
     *((dfr_refcounted_future_p)refcounted_futures[0])->future,
     *((dfr_refcounted_future_p)refcounted_futures[1])->future,
@@ -18,14 +18,12 @@ for i in $(eval echo {$1..$2}); do
     fi
     echo "case $i:
     	 oodf = std::move(hpx::dataflow(
-        [wfnname, param_sizes, param_types, output_sizes, output_types,
-         gcc_target, ctx]($p1)"
+        [wfn, wfn_id, param_sizes, param_types, output_sizes, output_types,
+         target, ctx]($p1)"
     echo "-> hpx::future<mlir::concretelang::dfr::OpaqueOutputData> {
           std::vector<void *> params = {$p2};"
-    echo "          mlir::concretelang::dfr::OpaqueInputData oid(
-              wfnname, params, param_sizes, param_types, output_sizes,
-              output_types, ctx);
-          return gcc_target->execute_task(oid);
+    echo "          return dfr_execute_task(target, wfn, wfn_id, params,
+              param_sizes, param_types, output_sizes, output_types, ctx);
         } $p3));
     	 break;
 	 "
@@ -8,19 +8,19 @@ for i in $(eval echo {$1..$2}); do
     echo "case $i: {"
     for j in $(eval echo {1..$i}); do
 	echo " void *output$j;
-	      _dfr_checked_aligned_alloc(&output$j, 512, inputs.output_sizes[$(($j-1))]);"
+	      _dfr_checked_aligned_alloc(&output$j, 512, output_sizes[$(($j-1))]);"
 	if ((j == 1)); then
 	   outs="$outs output$j"
 	else
 	    outs="$outs, output$j"
 	fi
     done;
-    echo "      switch (inputs.params.size()) {"
+    echo "      switch (params.size()) {"
 
     ins=""
     for j in $(eval echo {$3..$4}); do
 	if ((j > 0)); then
-		ins="$ins, inputs.params[$(($j - 1))]"
+		ins="$ins, params[$(($j - 1))]"
 	fi
 	echo "case $j:
 	     wfn($outs$ins); break;"
@@ -6,11 +6,14 @@
 #ifndef CONCRETELANG_DFR_KEY_MANAGER_HPP
 #define CONCRETELANG_DFR_KEY_MANAGER_HPP
 
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdlib.h>
 #include <utility>
 
+#include <hpx/future.hpp>
 #include <hpx/include/runtime.hpp>
 #include <hpx/modules/collectives.hpp>
 #include <hpx/modules/serialization.hpp>
@@ -98,30 +101,126 @@ bool operator==(const KeyWrapper<LweKeyType> &lhs,
   return true;
 }
 
+/// Evaluation keys sent by a node to its children in the key distribution
+/// tree, see `RuntimeContextManager`. The fourier bootstrap keys are only
+/// filled when they are transferred, null entries are left to the
+/// receiving node to convert.
+struct KeysetWrapper {
+  KeyWrapper<LweKeyswitchKey> kskw;
+  KeyWrapper<LweBootstrapKey> bskw;
+  KeyWrapper<PackingKeyswitchKey> pkskw;
+  std::vector<std::shared_ptr<FourierBootstrapKey>> fbsks;
+
+  friend class hpx::serialization::access;
+  template <class Archive>
+  void save(Archive &ar, const unsigned int version) const {
+    ar << kskw << bskw << pkskw;
+    ar << (size_t)fbsks.size();
+    for (auto fbsk : fbsks) {
+      size_t fbsk_size = (fbsk == nullptr) ? 0 : fbsk->size();
+      ar << fbsk_size;
+      if (fbsk_size > 0)
+        ar << hpx::serialization::make_array((const double *)fbsk->data(),
+                                             2 * fbsk_size);
+    }
+  }
+  template <class Archive> void load(Archive &ar, const unsigned int version) {
+    size_t num_fbsks;
+    ar >> kskw >> bskw >> pkskw;
+    ar >> num_fbsks;
+    for (size_t i = 0; i < num_fbsks; ++i) {
+      size_t fbsk_size;
+      ar >> fbsk_size;
+      if (fbsk_size == 0) {
+        fbsks.push_back(nullptr);
+        continue;
+      }
+      auto fbsk = std::make_shared<FourierBootstrapKey>();
+      fbsk->resize(fbsk_size);
+      ar >> hpx::serialization::make_array((double *)fbsk->data(),
+                                           2 * fbsk_size);
+      fbsks.push_back(fbsk);
+    }
+  }
+  HPX_SERIALIZATION_SPLIT_MEMBER()
+};
+
+KeysetWrapper fetchParentKeyset(uint64_t contextId);
+
+/// Whether both keysets share the buffers of all their keys.
+static inline bool _dfr_hold_same_keys(const ServerKeyset &lhs,
+                                       const ServerKeyset &rhs) {
+  if (lhs.lweBootstrapKeys.size() != rhs.lweBootstrapKeys.size() ||
+      lhs.lweKeyswitchKeys.size() != rhs.lweKeyswitchKeys.size() ||
+      lhs.packingKeyswitchKeys.size() != rhs.packingKeyswitchKeys.size())
+    return false;
+  // The bootstrap keys may have been released by the contexts
+  for (size_t i = 0; i < lhs.lweBootstrapKeys.size(); i++)
+    if (!lhs.lweBootstrapKeys[i].isSameKey(rhs.lweBootstrapKeys[i]))
+      return false;
+  for (size_t i = 0; i < lhs.lweKeyswitchKeys.size(); i++)
+    if (lhs.lweKeyswitchKeys[i].getTransportBuffer().data() !=
+        rhs.lweKeyswitchKeys[i].getTransportBuffer().data())
+      return false;
+  for (size_t i = 0; i < lhs.packingKeyswitchKeys.size(); i++)
+    if (lhs.packingKeyswitchKeys[i].getRawPtr() !=
+        rhs.packingKeyswitchKeys[i].getRawPtr())
+      return false;
+  return true;
+}
+
 /************************/
 /* Context management.  */
 /************************/
 
 struct RuntimeContextManager {
-  // TODO: this is only ok so long as we don't change keys. Once we
-  // use multiple keys, should have a map.
-  RuntimeContext *context;
-  bool allocated = false;
+  /// A set of evaluation keys installed on the node, identified by the
+  /// same id on all the nodes. Calls synchronized by the phase barriers
+  /// all use the entry 0, the persistent runtime installs one entry per
+  /// keyset used by its calls so that calls with different keys can run
+  /// concurrently.
+  struct Entry {
+    RuntimeContext *context = nullptr;
+    // Keys of the context, served to the other nodes. On the root node
+    // they outlive the context of the call that installed them.
+    ServerKeyset keys;
+    bool installed = false;
+    bool allocated = false;
+    // Set once the context is ready to be served to the children of the
+    // node in the key distribution tree
+    hpx::promise<void> ready;
+    hpx::shared_future<void> ready_future = ready.get_future();
+  };
+
   bool lazy_key_transfer = false;
+  bool fourier_key_transfer = false;
 
-  RuntimeContextManager(bool lazy = false)
-      : context(nullptr), lazy_key_transfer(lazy) {}
+  RuntimeContextManager(bool lazy = false, bool fourier = false)
+      : lazy_key_transfer(lazy), fourier_key_transfer(fourier) {}
 
-  void setContext(void *ctx) {
-    assert(context == nullptr &&
+  /// Returns the entry `id`, created empty if it is not installed yet.
+  Entry &getEntry(uint64_t id) {
+    std::lock_guard<std::mutex> lock(guard);
+    auto &entry = entries[id];
+    if (entry == nullptr)
+      entry = std::make_unique<Entry>();
+    return *entry;
+  }
+
+  void setContext(void *ctx, uint64_t id = 0) {
+    Entry &entry = getEntry(id);
+    assert(!entry.installed &&
            "Only one RuntimeContext can be used at a time.");
-    context = (RuntimeContext *)ctx;
+    entry.context = (RuntimeContext *)ctx;
 
+    entry.installed = true;
     if (lazy_key_transfer) {
       if (!_dfr_is_root_node()) {
-        context =
-            new mlir::concretelang::DistributedRuntimeContext(ServerKeyset());
-        allocated = true;
+        entry.context = new mlir::concretelang::DistributedRuntimeContext(
+            ServerKeyset(), id);
+        entry.allocated = true;
+      } else if (entry.context != nullptr) {
+        entry.keys = entry.context->getKeys();
       }
       return;
     }
@@ -131,56 +230,113 @@ struct RuntimeContextManager {
     // ahead of time and avoid waiting for the broadcast. Instantiate
     // an empty context for this.
     if (_dfr_is_root_node() && ctx == nullptr) {
-      context = new mlir::concretelang::RuntimeContext(ServerKeyset());
-      allocated = true;
+      entry.context = new mlir::concretelang::RuntimeContext(ServerKeyset());
+      entry.allocated = true;
     }
 
-    // Root node broadcasts the evaluation keys and each remote
-    // instantiates a local RuntimeContext.
-    if (_dfr_is_root_node()) {
-      KeyWrapper<LweKeyswitchKey> kskw(context->getKeys().lweKeyswitchKeys);
-      KeyWrapper<LweBootstrapKey> bskw(context->getKeys().lweBootstrapKeys);
-      KeyWrapper<PackingKeyswitchKey> pkskw(
-          context->getKeys().packingKeyswitchKeys);
-      hpx::collectives::broadcast_to("ksk_keystore", kskw);
-      hpx::collectives::broadcast_to("bsk_keystore", bskw);
-      hpx::collectives::broadcast_to("pksk_keystore", pkskw);
-    } else {
-      auto kskFut =
-          hpx::collectives::broadcast_from<KeyWrapper<LweKeyswitchKey>>(
-              "ksk_keystore");
-      auto bskFut =
-          hpx::collectives::broadcast_from<KeyWrapper<LweBootstrapKey>>(
-              "bsk_keystore");
-      auto pkskFut =
-          hpx::collectives::broadcast_from<KeyWrapper<PackingKeyswitchKey>>(
-              "pksk_keystore");
-      KeyWrapper<LweKeyswitchKey> kskw = kskFut.get();
-      KeyWrapper<LweBootstrapKey> bskw = bskFut.get();
-      KeyWrapper<PackingKeyswitchKey> pkskw = pkskFut.get();
-      context = new mlir::concretelang::RuntimeContext(
-          ServerKeyset{bskw.keys, kskw.keys, pkskw.keys});
+    // Remote nodes fetch the evaluation keys from their parent in the
+    // distribution tree, rather than all from the root node, and
+    // instantiate a local RuntimeContext.
+    if (!_dfr_is_root_node()) {
+      KeysetWrapper ksw = fetchParentKeyset(id);
+      entry.context = new mlir::concretelang::RuntimeContext(
+          ServerKeyset{ksw.bskw.keys, ksw.kskw.keys, ksw.pkskw.keys},
+          ksw.fbsks);
     }
+    entry.keys = entry.context->getKeys();
+    entry.ready.set_value();
   }
 
-  RuntimeContext *getContext() { return context; }
+  RuntimeContext *getContext(uint64_t id = 0) { return getEntry(id).context; }
+
+  ServerKeyset &getKeys(uint64_t id) { return getEntry(id).keys; }
 
-  void clearContext() {
-    if (context != nullptr)
+  void clearContext(uint64_t id = 0) {
+    std::unique_ptr<Entry> entry;
+    {
+      std::lock_guard<std::mutex> lock(guard);
+      auto it = entries.find(id);
+      if (it == entries.end())
+        return;
+      entry = std::move(it->second);
+      entries.erase(it);
+    }
+    if (entry->context != nullptr)
       // On root node deallocate only if allocated independently here
-      if (!_dfr_is_root_node() || allocated)
-        delete context;
-    context = nullptr;
+      if (!_dfr_is_root_node() || entry->allocated)
+        delete entry->context;
+  }
+
+  /// Root node, persistent runtime: returns the id of the installed entry
+  /// holding the keys of the context `ctx`, if any.
+  std::optional<uint64_t> findContext(void *ctx) {
+    ServerKeyset keys =
+        ctx ? ((RuntimeContext *)ctx)->getKeys() : ServerKeyset();
+    std::lock_guard<std::mutex> lock(guard);
+    for (auto &entry : entries)
+      if (entry.first != 0 && entry.second->installed &&
+          _dfr_hold_same_keys(keys, entry.second->keys))
+        return entry.first;
+    return std::nullopt;
+  }
+
+  /// Root node, persistent runtime: returns a new entry id, to install
+  /// with `setContext` on all the nodes.
+  uint64_t newContextId() {
+    std::lock_guard<std::mutex> lock(guard);
+    return next_id++;
   }
+
+  /// Root node, persistent runtime: the keys of entry `id` no longer need
+  /// to be served from the context that installed them, which belongs to
+  /// a call.
+  void detachContext(uint64_t id) {
+    Entry &entry = getEntry(id);
+    if (!entry.allocated)
+      entry.context = nullptr;
+  }
+
+  /// Root node: records that the tasks of a call in flight with context
+  /// `ctx` use the entry `id` on the remote nodes.
+  void registerCall(void *ctx, uint64_t id) {
+    std::lock_guard<std::mutex> lock(guard);
+    auto &call = call_contexts[ctx];
+    call.first = id;
+    call.second++;
+  }
+
+  void unregisterCall(void *ctx) {
+    std::lock_guard<std::mutex> lock(guard);
+    auto it = call_contexts.find(ctx);
+    if (it != call_contexts.end() && --it->second.second == 0)
+      call_contexts.erase(it);
+  }
+
+  /// Root node: id of the entry to use on the remote nodes for the tasks
+  /// of a call with context `ctx`.
+  uint64_t getContextId(void *ctx) {
+    std::lock_guard<std::mutex> lock(guard);
+    auto it = call_contexts.find(ctx);
+    return (it == call_contexts.end()) ? 0 : it->second.first;
+  }
+
+private:
+  std::mutex guard;
+  std::map<uint64_t, std::unique_ptr<Entry>> entries;
+  // Contexts of the calls in flight, with their entry id and count
+  std::map<void *, std::pair<uint64_t, size_t>> call_contexts;
+  uint64_t next_id = 1;
 };
 
-KeyWrapper<LweKeyswitchKey> getKsk(size_t keyId);
-KeyWrapper<LweBootstrapKey> getBsk(size_t keyId);
-KeyWrapper<PackingKeyswitchKey> getPKsk(size_t keyId);
+KeyWrapper<LweKeyswitchKey> getKsk(uint64_t contextId, size_t keyId);
+KeyWrapper<LweBootstrapKey> getBsk(uint64_t contextId, size_t keyId);
+KeyWrapper<PackingKeyswitchKey> getPKsk(uint64_t contextId, size_t keyId);
+KeysetWrapper getKeyset(uint64_t contextId);
 
 HPX_DEFINE_PLAIN_ACTION(getKsk, _get_ksk_action);
 HPX_DEFINE_PLAIN_ACTION(getBsk, _get_bsk_action);
 HPX_DEFINE_PLAIN_ACTION(getPKsk, _get_pksk_action);
+HPX_DEFINE_PLAIN_ACTION(getKeyset, _get_keyset_action);
 
 } // namespace dfr
 } // namespace concretelang
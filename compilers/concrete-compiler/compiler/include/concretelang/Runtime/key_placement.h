@@ -0,0 +1,73 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_KEY_PLACEMENT_H
+#define CONCRETELANG_RUNTIME_KEY_PLACEMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// How the distributed runtime weighs the keys held by the localities when
+/// placing the tasks. The key indices used by a work function are fixed at
+/// compilation, so a locality that was sent a task of a work function holds
+/// the keys of its next ones.
+
+namespace mlir {
+namespace concretelang {
+namespace dfr {
+
+/// The localities holding the keys of each work function, by work function.
+using KeyLocalities = std::unordered_map<uint64_t, std::vector<bool>>;
+
+/// The cost, in pending tasks, of sending a task to a locality that does not
+/// hold the keys of its work function, unless DFR_KEY_FETCH_COST is set.
+constexpr size_t default_key_fetch_cost = 4;
+
+/// Whether the tasks of the work function `wfn_id` may run on locality `loc`
+/// out of `num_nodes`. With `partition_nodes` set, they run on the root,
+/// which holds all the keys, or on `partition_nodes` consecutive remote
+/// localities. 0, or at least as many nodes as there are remote localities,
+/// lets them run anywhere.
+inline bool key_partition_allows(uint64_t wfn_id, size_t loc,
+                                 size_t num_nodes, size_t partition_nodes) {
+  size_t remote_nodes = num_nodes - 1;
+  if (loc == 0 || partition_nodes == 0 || partition_nodes >= remote_nodes)
+    return true;
+  size_t home = wfn_id % remote_nodes;
+  return (loc - 1 + remote_nodes - home) % remote_nodes < partition_nodes;
+}
+
+/// The cost, in pending tasks, of the keys that locality `loc` must fetch to
+/// run a task of the work function `wfn_id`: `fetch_cost` unless `loc` is
+/// the root or already holds them.
+inline size_t key_fetch_cost(const KeyLocalities &localities,
+                             uint64_t wfn_id, size_t loc, size_t fetch_cost) {
+  if (loc == 0 || fetch_cost == 0)
+    return 0;
+  auto it = localities.find(wfn_id);
+  if (it != localities.end() && it->second[loc])
+    return 0;
+  return fetch_cost;
+}
+
+/// Records that locality `loc`, out of `num_nodes`, holds, or is about to
+/// fetch, the keys of the work function `wfn_id`.
+inline void key_localities_add(KeyLocalities &localities, uint64_t wfn_id,
+                               size_t loc, size_t num_nodes) {
+  if (loc == 0)
+    return;
+  std::vector<bool> &holders = localities[wfn_id];
+  if (holders.empty())
+    holders.resize(num_nodes, false);
+  holders[loc] = true;
+}
+
+} // namespace dfr
+} // namespace concretelang
+} // namespace mlir
+
+#endif
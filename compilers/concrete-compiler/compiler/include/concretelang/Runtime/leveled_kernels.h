@@ -0,0 +1,43 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_LEVELED_KERNELS_H
+#define CONCRETELANG_RUNTIME_LEVELED_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mlir {
+namespace concretelang {
+namespace leveled {
+
+/// Element-wise kernels working on `n` contiguous 64 bits words with
+/// wrapping arithmetic, i.e. on a whole batch of LWE ciphertexts at once.
+///
+/// The implementation (scalar, AVX2 or AVX-512) is selected once at runtime
+/// depending on the features of the host CPU. `out` may alias the inputs.
+
+/// out[i] = lhs[i] + rhs[i]
+void add(uint64_t *out, const uint64_t *lhs, const uint64_t *rhs, size_t n);
+
+/// out[i] = in[i] * cleartext
+void mul(uint64_t *out, const uint64_t *in, uint64_t cleartext, size_t n);
+
+/// out[i] = -in[i]
+void negate(uint64_t *out, const uint64_t *in, size_t n);
+
+/// out[i] = in[i] * cleartext + acc[i], in a single pass over the buffers
+void mulAdd(uint64_t *out, const uint64_t *in, uint64_t cleartext,
+            const uint64_t *acc, size_t n);
+
+/// Name of the implementation selected for the host CPU, for diagnostics
+/// and tests.
+const char *implementationName();
+
+} // namespace leveled
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -0,0 +1,50 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_LEVELED_LOOPS_H
+#define CONCRETELANG_RUNTIME_LEVELED_LOOPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mlir {
+namespace concretelang {
+namespace leveled {
+
+/// Plain loops of the leveled kernels, with the semantics of the ones of
+/// leveled_kernels.h. They are the scalar implementation of the runtime
+/// library and the tails of its vectorized ones, and the bodies of the
+/// wrappers compiled to LLVM bitcode, which the compiler vectorizes for the
+/// target. This header is included by the bitcode, it must only depend on
+/// the standard headers.
+
+inline void addScalar(uint64_t *out, const uint64_t *lhs, const uint64_t *rhs,
+                      size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = lhs[i] + rhs[i];
+}
+
+inline void mulScalar(uint64_t *out, const uint64_t *in, uint64_t cleartext,
+                      size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = in[i] * cleartext;
+}
+
+inline void negateScalar(uint64_t *out, const uint64_t *in, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = -in[i];
+}
+
+inline void mulAddScalar(uint64_t *out, const uint64_t *in,
+                         uint64_t cleartext, const uint64_t *acc, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = in[i] * cleartext + acc[i];
+}
+
+} // namespace leveled
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -0,0 +1,44 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_MEMORY_POOL_H
+#define CONCRETELANG_RUNTIME_MEMORY_POOL_H
+
+#include <cstddef>
+
+namespace mlir {
+namespace concretelang {
+namespace memory_pool {
+
+/// Pool of the host buffers allocated by the compiled circuits, so that the
+/// intermediate tensors of each call reuse the buffers of the previous ones
+/// instead of going through `malloc` and faulting fresh pages.
+///
+/// Released buffers are cached per size class, four classes per power of two,
+/// and handed out again by later allocations of the same class, from any call
+/// or keyset of the process. The cache holds at most
+/// `CONCRETE_HOST_MEMORY_POOL_MB` megabytes (1024 by default), buffers
+/// released beyond that are freed. The buffers of 2MB or more follow the huge
+/// pages policy set with `CONCRETE_HUGE_PAGES`, see
+/// `::concretelang::huge_pages`.
+
+/// Whether host buffers should be allocated from the pool, which is enabled
+/// with the `CONCRETE_HOST_MEMORY_POOL` environment variable.
+bool enabled();
+
+/// Allocates `size` bytes from the pool, returns nullptr if the pool is
+/// disabled, `size` is too small to be worth caching or the allocation
+/// failed.
+void *allocate(size_t size);
+
+/// Returns `ptr` to the pool and returns true if it was allocated by
+/// `allocate`, otherwise leaves it untouched and returns false.
+bool release(void *ptr);
+
+} // namespace memory_pool
+} // namespace concretelang
+} // namespace mlir
+
+#endif
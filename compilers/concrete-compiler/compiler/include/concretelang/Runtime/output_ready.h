@@ -0,0 +1,33 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_OUTPUT_READY_H
+#define CONCRETELANG_RUNTIME_OUTPUT_READY_H
+
+#include <functional>
+
+namespace mlir {
+namespace concretelang {
+
+/// Called with the aligned pointer of an output buffer of a circuit compiled
+/// in destination-passing mode, as soon as the circuit has computed it.
+using OutputReadyListener = std::function<void(void *)>;
+
+/// Makes `listener` the listener of the outputs of the circuits called on
+/// this thread for its lifetime. The listener is called on the thread of the
+/// call, while the circuit computes its other outputs.
+class OutputReadyScope {
+public:
+  OutputReadyScope(OutputReadyListener *listener);
+  ~OutputReadyScope();
+
+private:
+  OutputReadyListener *previous;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
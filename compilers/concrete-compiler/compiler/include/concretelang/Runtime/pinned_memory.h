@@ -0,0 +1,42 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_PINNED_MEMORY_H
+#define CONCRETELANG_RUNTIME_PINNED_MEMORY_H
+
+#include <cstddef>
+
+namespace mlir {
+namespace concretelang {
+namespace pinned {
+
+/// Pool of page-locked host buffers, so that the transfers of ciphertexts
+/// to and from the GPUs are truly asynchronous and run at full bandwidth.
+///
+/// Buffers are registered with the CUDA driver once and keep their
+/// registration when released: they are cached per power of two size class
+/// and handed out again by later allocations. The cache holds at most
+/// `CONCRETE_PINNED_HOST_POOL_MB` megabytes (1024 by default), buffers
+/// released beyond that are unregistered and freed.
+
+/// Whether host buffers should be allocated from the pool, which requires
+/// CUDA support and is enabled with the `CONCRETE_PINNED_HOST_MEMORY`
+/// environment variable.
+bool enabled();
+
+/// Allocates `size` bytes of page-locked host memory, returns nullptr if
+/// the pool is disabled, `size` is less than a page (not worth pinning) or
+/// the allocation failed.
+void *allocate(size_t size);
+
+/// Returns `ptr` to the pool and returns true if it was allocated by
+/// `allocate`, otherwise leaves it untouched and returns false.
+bool release(void *ptr);
+
+} // namespace pinned
+} // namespace concretelang
+} // namespace mlir
+
+#endif
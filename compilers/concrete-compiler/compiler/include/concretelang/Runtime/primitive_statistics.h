@@ -0,0 +1,204 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_PRIMITIVE_STATISTICS_H
+#define CONCRETELANG_RUNTIME_PRIMITIVE_STATISTICS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+/// The primitives whose calls to the runtime are recorded.
+enum class RuntimePrimitive {
+  KEYSWITCH,
+  BOOTSTRAP,
+  KEYSWITCH_BOOTSTRAP,
+  WOP_PBS,
+  LEVELED,
+};
+
+std::string runtimePrimitiveName(RuntimePrimitive primitive);
+
+/// The number of buckets of the latency histograms, the bucket `i` counting
+/// the calls which took between 2^i and 2^(i+1) nanoseconds.
+const size_t PRIMITIVE_LATENCY_BUCKETS = 40;
+
+/// The statistics of the calls of a primitive with the same keys, on the same
+/// device.
+struct PrimitiveStatistic {
+  RuntimePrimitive primitive;
+  /// The index of the keyswitch key, or -1 if none
+  int64_t kskIndex;
+  /// The index of the bootstrap key, or -1 if none
+  int64_t bskIndex;
+  bool gpu;
+  uint64_t calls = 0;
+  /// The number of ciphertexts processed by the calls, i.e. the sum of their
+  /// batch sizes
+  uint64_t ciphertexts = 0;
+  /// The total latency of the calls. The kernels scheduled on a GPU by the
+  /// SDFG runtime run asynchronously, their latency is that of the submission
+  uint64_t nanoseconds = 0;
+  std::array<uint64_t, PRIMITIVE_LATENCY_BUCKETS> latencyHistogram{};
+
+  /// The hardware events of the calls on the CPU, if counted, see
+  /// `PrimitiveStatistics`: `countedCalls` is the number of calls they were
+  /// counted for
+  uint64_t countedCalls = 0;
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cacheReferences = 0;
+  uint64_t cacheMisses = 0;
+};
+
+/// The hardware events counted by the performance counters of a thread.
+struct HardwareCounts {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cacheReferences = 0;
+  uint64_t cacheMisses = 0;
+};
+
+/// Reads the performance counters of the calling thread, opening them on its
+/// first call. Returns false if they are not available, e.g. on another OS
+/// than Linux or if perf_event_paranoid forbids them.
+bool readHardwareCounters(HardwareCounts &counts);
+
+/// Aggregates the calls of the primitives recorded while it is the current
+/// statistics of the calling thread. Recording is thread safe, so the same
+/// statistics can be shared by concurrent calls.
+///
+/// With `hardwareCounters`, the cycles, instructions and last level cache
+/// references and misses of the calls on the CPU are counted as well, e.g. to
+/// tell whether a primitive is bound by the compute or by the memory.
+class PrimitiveStatistics {
+public:
+  PrimitiveStatistics(bool hardwareCounters = false)
+      : hardwareCounters(hardwareCounters) {}
+
+  bool countsHardwareEvents() { return hardwareCounters; }
+
+  void record(RuntimePrimitive primitive, int64_t kskIndex, int64_t bskIndex,
+              bool gpu, uint64_t batchSize, uint64_t nanoseconds,
+              const HardwareCounts *counts = nullptr);
+
+  /// Returns the statistics recorded so far, ordered by primitive and keys.
+  std::vector<PrimitiveStatistic> get();
+
+  void reset();
+
+private:
+  bool hardwareCounters;
+  std::mutex mutex;
+  std::map<std::tuple<RuntimePrimitive, int64_t, int64_t, bool>,
+           PrimitiveStatistic>
+      statistics;
+};
+
+#if CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED
+
+/// Returns the statistics recording the primitives called by this thread, null
+/// if not recording.
+PrimitiveStatistics *getCurrentPrimitiveStatistics();
+
+/// Sets the statistics recording the primitives called by this thread.
+void setCurrentPrimitiveStatistics(PrimitiveStatistics *statistics);
+
+/// Makes `statistics` the current statistics of this thread for its lifetime,
+/// e.g. on the threads running the primitives on behalf of a circuit call.
+class PrimitiveStatisticsScope {
+public:
+  PrimitiveStatisticsScope(PrimitiveStatistics *statistics);
+  ~PrimitiveStatisticsScope();
+
+private:
+  PrimitiveStatistics *previous;
+};
+
+/// Records the call of a primitive in the current statistics, if any, on
+/// destruction. Without current statistics, the cost is a thread local load.
+///
+/// The primitives called by a recorded one on the same thread, e.g. the
+/// single ciphertext operations making a batched one, are not recorded.
+class PrimitiveTimer {
+public:
+  PrimitiveTimer(RuntimePrimitive primitive, int64_t kskIndex,
+                 int64_t bskIndex, uint64_t batchSize = 1, bool gpu = false)
+      : statistics(getCurrentPrimitiveStatistics()) {
+    if (statistics == nullptr)
+      return;
+    this->primitive = primitive;
+    this->kskIndex = kskIndex;
+    this->bskIndex = bskIndex;
+    this->batchSize = batchSize;
+    this->gpu = gpu;
+    setCurrentPrimitiveStatistics(nullptr);
+    counting = !gpu && statistics->countsHardwareEvents() &&
+               readHardwareCounters(startCounts);
+    start = std::chrono::steady_clock::now();
+  }
+
+  ~PrimitiveTimer() {
+    if (statistics == nullptr)
+      return;
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    HardwareCounts counts;
+    if (counting && readHardwareCounters(counts)) {
+      counts.cycles -= startCounts.cycles;
+      counts.instructions -= startCounts.instructions;
+      counts.cacheReferences -= startCounts.cacheReferences;
+      counts.cacheMisses -= startCounts.cacheMisses;
+    } else {
+      counting = false;
+    }
+    setCurrentPrimitiveStatistics(statistics);
+    statistics->record(primitive, kskIndex, bskIndex, gpu, batchSize,
+                       nanoseconds, counting ? &counts : nullptr);
+  }
+
+private:
+  PrimitiveStatistics *statistics;
+  RuntimePrimitive primitive;
+  int64_t kskIndex;
+  int64_t bskIndex;
+  uint64_t batchSize;
+  bool gpu;
+  bool counting;
+  HardwareCounts startCounts;
+  std::chrono::steady_clock::time_point start;
+};
+
+#else // CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED
+
+inline PrimitiveStatistics *getCurrentPrimitiveStatistics() { return nullptr; }
+
+class PrimitiveStatisticsScope {
+public:
+  PrimitiveStatisticsScope(PrimitiveStatistics *) {}
+};
+
+class PrimitiveTimer {
+public:
+  PrimitiveTimer(RuntimePrimitive, int64_t, int64_t, uint64_t = 1,
+                 bool = false) {}
+};
+
+#endif // CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -0,0 +1,44 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_PROBES_H
+#define CONCRETELANG_RUNTIME_PROBES_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// The probes placed in the circuits with `Tracing.probe`, which record when
+/// they are reached at a low and steady cost, to profile regions of the
+/// circuits in production.
+///
+/// The probes are recorded if the `CONCRETE_PROBE_FILE` environment variable
+/// names the file to write them to, one JSON object per line. Each thread
+/// records its probes without locking in a ring buffer of its own, which a
+/// background thread appends to the file. The probes reached while the ring
+/// buffer of their thread is full are dropped, and their number written
+/// instead. The timestamps are in nanoseconds since the epoch, like those of
+/// the trace of the runtime.
+
+namespace mlir {
+namespace concretelang {
+namespace probes {
+
+/// Returns true if the probes are recorded.
+bool isEnabled();
+
+/// Records that this thread reached the probe `name` of `length` bytes, along
+/// with the precision and the noise variance of the ciphertexts at the probe,
+/// or 0 if unknown.
+void record(const char *name, size_t length, uint32_t precision,
+            double noiseVariance);
+
+/// Writes the probes recorded so far to the file.
+void flush();
+
+} // namespace probes
+} // namespace concretelang
+} // namespace mlir
+
+#endif
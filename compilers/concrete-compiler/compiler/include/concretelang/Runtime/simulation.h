@@ -62,6 +62,14 @@ uint64_t sim_keyswitch_lwe_u64(uint64_t plaintext, uint32_t level,
                                uint32_t base_log, uint32_t input_lwe_dim,
                                uint32_t output_lwe_dim);
 
+/// \brief simulate a keyswitch on a noisy plaintext, with the standard
+/// deviation of its noise computed beforehand from the parameters
+///
+/// \param plaintext noisy plaintext
+/// \param std_dev standard deviation of the keyswitch noise
+/// \return uint64_t
+uint64_t sim_keyswitch_lwe_std_dev_u64(uint64_t plaintext, double std_dev);
+
 /// \brief simulate a bootstrap on a noisy plaintext
 ///
 /// \param plaintext noisy plaintext
@@ -76,6 +84,8 @@ uint64_t sim_keyswitch_lwe_u64(uint64_t plaintext, uint32_t level,
 /// \param base_log
 /// \param glwe_dim
 /// \param overflow_detection enable overflow detection
+/// \param precision bits of the message, to measure its noise, or 0
+/// \param p_error probability of error the parameters were optimized for
 /// \param loc
 /// \return uint64_t
 uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
@@ -84,7 +94,122 @@ uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
                                uint32_t input_lwe_dim, uint32_t poly_size,
                                uint32_t level, uint32_t base_log,
                                uint32_t glwe_dim, bool overflow_detection,
-                               char *loc);
+                               uint32_t precision, double p_error, char *loc);
+
+/// \brief simulate a bootstrap on a noisy plaintext, with the standard
+/// deviations of its noise computed beforehand from the parameters
+///
+/// \param plaintext noisy plaintext
+/// \param tlu_allocated
+/// \param tlu_aligned
+/// \param tlu_offset
+/// \param tlu_size
+/// \param tlu_stride
+/// \param poly_size
+/// \param ms_std_dev standard deviation of the modulus switching noise
+/// \param br_std_dev standard deviation of the blind rotation noise
+/// \param overflow_detection enable overflow detection
+/// \param precision bits of the message, to measure its noise, or 0
+/// \param p_error probability of error the parameters were optimized for
+/// \param loc
+/// \return uint64_t
+uint64_t sim_bootstrap_lwe_std_dev_u64(
+    uint64_t plaintext, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t poly_size, double ms_std_dev, double br_std_dev,
+    bool overflow_detection, uint32_t precision, double p_error, char *loc);
+
+/// \brief simulate the negation of a batch of noisy plaintexts
+void sim_batched_neg_lwe_u64(
+    // Output 1D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride,
+    // Input 1D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size, uint64_t in_stride);
+
+/// \brief simulate the element-wise addition of a batch of noisy plaintexts
+/// with a batch of plaintexts (noisy or not)
+///
+/// An operand with a single element is broadcast to the whole batch. The
+/// overflows are reported as in sim_add_lwe_u64 if `overflow_detection` is
+/// set.
+void sim_batched_add_lwe_u64(
+    // Output 1D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride,
+    // Left operand 1D memref
+    uint64_t *lhs_allocated, uint64_t *lhs_aligned, uint64_t lhs_offset,
+    uint64_t lhs_size, uint64_t lhs_stride,
+    // Right operand 1D memref
+    uint64_t *rhs_allocated, uint64_t *rhs_aligned, uint64_t rhs_offset,
+    uint64_t rhs_size, uint64_t rhs_stride, char *loc, bool is_signed,
+    bool overflow_detection);
+
+/// \brief simulate the element-wise multiplication of a batch of noisy
+/// plaintexts with a batch of integers
+///
+/// An operand with a single element is broadcast to the whole batch. The
+/// overflows are reported as in sim_mul_lwe_u64 if `overflow_detection` is
+/// set.
+void sim_batched_mul_lwe_u64(
+    // Output 1D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride,
+    // Left operand 1D memref
+    uint64_t *lhs_allocated, uint64_t *lhs_aligned, uint64_t lhs_offset,
+    uint64_t lhs_size, uint64_t lhs_stride,
+    // Right operand 1D memref
+    uint64_t *rhs_allocated, uint64_t *rhs_aligned, uint64_t rhs_offset,
+    uint64_t rhs_size, uint64_t rhs_stride, char *loc, bool is_signed,
+    bool overflow_detection);
+
+/// \brief simulate a keyswitch on a batch of noisy plaintexts, drawing the
+/// noise of the whole batch at once
+///
+/// \param std_dev standard deviation of the keyswitch noise
+void sim_batched_keyswitch_lwe_u64(
+    // Output 1D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride,
+    // Input 1D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size, uint64_t in_stride, double std_dev);
+
+/// \brief simulate a bootstrap on a batch of noisy plaintexts with the same
+/// lookup table, drawing the noise of the whole batch at once
+///
+/// The parameters are those of sim_bootstrap_lwe_std_dev_u64.
+void sim_batched_bootstrap_lwe_u64(
+    // Output 1D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride,
+    // Input 1D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size, uint64_t in_stride,
+    // Lookup table 1D memref
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t poly_size,
+    double ms_std_dev, double br_std_dev, bool overflow_detection,
+    uint32_t precision, double p_error, char *loc);
+
+/// \brief simulate a bootstrap on a batch of noisy plaintexts, each with its
+/// own lookup table, drawing the noise of the whole batch at once
+///
+/// The parameters are those of sim_bootstrap_lwe_std_dev_u64.
+void sim_batched_mapped_bootstrap_lwe_u64(
+    // Output 1D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride,
+    // Input 1D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size, uint64_t in_stride,
+    // Lookup tables 2D memref
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size0, uint64_t tlu_size1, uint64_t tlu_stride0,
+    uint64_t tlu_stride1, uint32_t poly_size, double ms_std_dev,
+    double br_std_dev, bool overflow_detection, uint32_t precision,
+    double p_error, char *loc);
 
 /// simulate a WoP PBS
 void sim_wop_pbs_crt(
@@ -108,6 +233,31 @@ void sim_wop_pbs_crt(
     uint32_t bsk_base_log, uint32_t polynomial_size, uint32_t pksk_base_log,
     uint32_t pksk_level_count, uint32_t glwe_dim);
 
+/// simulate the WoP PBS of a batch of CRT ciphertexts, one per row of the 2D
+/// input and output memrefs, with the same lookup tables
+void sim_batched_wop_pbs_crt(
+    // Output 2D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1,
+    // Input 2D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size0, uint64_t in_size1, uint64_t in_stride0,
+    uint64_t in_stride1,
+    // clear text lut 2D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t polynomial_size, uint32_t pksk_base_log,
+    uint32_t pksk_level_count, uint32_t glwe_dim);
+
 void sim_encode_expand_lut_for_boostrap(
     uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
     uint64_t in_size, uint64_t in_stride, uint64_t *out_allocated,
@@ -145,4 +295,15 @@ void sim_encode_lut_for_crt_woppbs(
     uint32_t modulus_product, bool is_signed);
 }
 
+namespace mlir {
+namespace concretelang {
+
+/// Reseeds the csprng of the calling thread, which draws the noise of the
+/// operations it simulates, so that they are reproducible. With `seed` 0, a
+/// random seed is used.
+void setSimulationSeed(__uint128_t seed);
+
+} // namespace concretelang
+} // namespace mlir
+
 #endif
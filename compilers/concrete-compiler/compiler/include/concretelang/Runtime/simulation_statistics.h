@@ -0,0 +1,86 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_SIMULATION_STATISTICS_H
+#define CONCRETELANG_RUNTIME_SIMULATION_STATISTICS_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+/// The statistics of the simulated operations at a location of the circuit.
+///
+/// The noise is in the torus, i.e. as a fraction of the ciphertext modulus. It
+/// is measured at the input of the bootstraps, modulus switching included, as
+/// the distance of the noisy plaintext to the closest encoded message, which
+/// is only possible when the precision of the message is known.
+struct SimulationStatistic {
+  std::string location;
+  uint64_t bootstraps = 0;
+  /// The precision of the messages the bootstraps apply to, 0 if unknown
+  uint32_t precision = 0;
+  /// The variance of the noise measured at the input of the bootstraps
+  double noiseVariance = 0;
+  /// The largest noise measured at the input of the bootstraps
+  double maxNoise = 0;
+  /// The variance the optimizer bounded the noise to, for the bootstraps to
+  /// fail with its probability of error, 0 if unknown
+  double maxVariance = 0;
+  /// The number of overflows detected by the simulated operations
+  uint64_t overflows = 0;
+};
+
+/// Aggregates the noise and the overflows of the operations simulated while it
+/// is the current statistics, by location. Recording is thread safe.
+class SimulationStatistics {
+public:
+  /// Records a bootstrap at `location` of a message of `precision` bits with
+  /// `noise` at its input, for a probability of error of `pError`.
+  void recordBootstrap(const char *location, uint32_t precision, double noise,
+                       double pError);
+
+  void recordOverflow(const char *location);
+
+  /// Returns the statistics recorded so far, ordered by location.
+  std::vector<SimulationStatistic> get();
+
+  void reset();
+
+private:
+  struct Accumulator {
+    SimulationStatistic statistic;
+    uint64_t measured = 0;
+    double squaredNoise = 0;
+  };
+
+  std::mutex mutex;
+  std::map<std::string, Accumulator> statistics;
+};
+
+/// Returns the statistics recording the simulated operations, null if not
+/// recording. The simulated operations of a call may run on the worker threads
+/// of its parallel loops, the current statistics are those of the process.
+SimulationStatistics *getCurrentSimulationStatistics();
+
+/// Makes `statistics` the current statistics for its lifetime.
+class SimulationStatisticsScope {
+public:
+  SimulationStatisticsScope(SimulationStatistics *statistics);
+  ~SimulationStatisticsScope();
+
+private:
+  SimulationStatistics *statistics;
+  SimulationStatistics *previous;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -28,6 +28,20 @@ template <size_t N> struct MemRefDescriptor {
 
 extern "C" {
 void *stream_emulator_init();
+/// Returns a graph of the circuit `graph_id` built by an earlier call with
+/// the runtime context `context` if one is idle, whose construction by the
+/// control program is then replayed, or a new graph kept by the context
+/// for the next calls once deleted.
+void *stream_emulator_init_persistent(void *context, uint64_t graph_id);
+/// Returns a session whose calls share one graph per circuit, the items
+/// of a call following on each stream those of the calls started before
+/// it so that concurrent calls pipeline through the graph, or null if the
+/// runtime cannot share its graphs. The graphs are deleted with the
+/// session, once its calls completed.
+void *stream_emulator_open_session();
+/// Sets the session of the calls made by this thread, none if null.
+void stream_emulator_set_session(void *session);
+void stream_emulator_close_session(void *session);
 void stream_emulator_run(void *dfg);
 void stream_emulator_delete(void *dfg);
 
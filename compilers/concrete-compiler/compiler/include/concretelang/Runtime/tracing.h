@@ -0,0 +1,118 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_RUNTIME_TRACING_H
+#define CONCRETELANG_RUNTIME_TRACING_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/// Tracing of the runtime in the Chrome trace event format, which can be
+/// loaded in Perfetto or `chrome://tracing`.
+///
+/// The events are recorded if the `CONCRETE_TRACE_FILE` environment variable
+/// names the file to write them to, at exit or on `flush`. The processes of a
+/// distributed execution write their events to the file suffixed with their
+/// node id, the root node excepted, with timestamps in microseconds since the
+/// epoch so that the files can be loaded together.
+///
+/// The spans of the GPU operations, which run asynchronously on their
+/// stream, cover their submission only, unless they synchronize.
+
+namespace mlir {
+namespace concretelang {
+namespace tracing {
+
+/// An argument of an event, shown in the details of its span.
+struct TraceArg {
+  TraceArg(const char *name, int64_t value) : name(name), value(value) {}
+  TraceArg(const char *name, std::string value)
+      : name(name), value(std::move(value)) {}
+
+  const char *name;
+  std::variant<int64_t, std::string> value;
+};
+
+using TraceArgs = std::initializer_list<TraceArg>;
+
+#if CONCRETELANG_TRACING_ENABLED
+
+/// Returns true if the events are recorded.
+bool isEnabled();
+
+/// Returns the current time of the trace, in nanoseconds.
+uint64_t now();
+
+/// Records a span of this thread, from `start` to now. The `category` and the
+/// argument names must be literals, the `name` is copied.
+void complete(const char *category, const char *name, uint64_t start,
+              TraceArgs args = {});
+
+/// Records a span from `start` to now which is not bound to this thread, e.g.
+/// the lifetime of a task, shown on its own track. The spans with the same
+/// `category` must have distinct `id`s while they overlap.
+void asyncSpan(const char *category, const char *name, uint64_t id,
+               uint64_t start, TraceArgs args = {});
+
+/// Names the track of the events of this thread.
+void setThreadName(const char *name);
+
+/// Sets the id of this process in the trace, i.e. its node id in a
+/// distributed execution.
+void setProcessId(uint64_t id);
+
+/// Writes the events recorded so far to the trace file.
+void flush();
+
+/// Records a span of this thread over the lifetime of the scope.
+class TraceScope {
+public:
+  TraceScope(const char *category, const char *name, TraceArgs args = {})
+      : category(category), name(name) {
+    if (!isEnabled())
+      return;
+    this->args = args;
+    start = now();
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  ~TraceScope();
+
+private:
+  const char *category;
+  const char *name;
+  std::vector<TraceArg> args;
+  uint64_t start = 0;
+};
+
+#else // CONCRETELANG_TRACING_ENABLED
+
+inline bool isEnabled() { return false; }
+inline uint64_t now() { return 0; }
+inline void complete(const char *, const char *, uint64_t, TraceArgs = {}) {}
+inline void asyncSpan(const char *, const char *, uint64_t, uint64_t,
+                      TraceArgs = {}) {}
+inline void setThreadName(const char *) {}
+inline void setProcessId(uint64_t) {}
+inline void flush() {}
+
+class TraceScope {
+public:
+  TraceScope(const char *, const char *, TraceArgs = {}) {}
+};
+
+#endif // CONCRETELANG_TRACING_ENABLED
+
+} // namespace tracing
+} // namespace concretelang
+} // namespace mlir
+
+#endif
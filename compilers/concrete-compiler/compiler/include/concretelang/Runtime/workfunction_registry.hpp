@@ -8,7 +8,10 @@
 
 #include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <hpx/include/runtime.hpp>
 #include <hpx/modules/collectives.hpp>
@@ -24,9 +27,31 @@ struct WorkFunctionRegistry;
 extern WorkFunctionRegistry *_dfr_node_level_work_function_registry;
 extern void *dl_handle;
 
+/// Name of the work function `id` of the root node registry, fetched from
+/// the root node.
+std::string _dfr_fetch_work_function_name(uint64_t id);
+
+/// Work functions are identified by an integer id, assigned by the root
+/// node registry in order of registration, so that task creation and
+/// execution do not handle their names. Remote nodes resolve the name of
+/// an id from the root node once, on the first task using it.
 struct WorkFunctionRegistry {
   WorkFunctionRegistry() = default;
 
+  wfnptr getWorkFunctionPointer(uint64_t id) {
+    {
+      std::lock_guard<std::mutex> guard(registry_guard);
+      auto fnptrit = id_to_ptr_registry.find(id);
+      if (fnptrit != id_to_ptr_registry.end())
+        return (wfnptr)fnptrit->second;
+    }
+    std::string name = _dfr_fetch_work_function_name(id);
+    wfnptr ptr = getWorkFunctionPointer(name);
+    std::lock_guard<std::mutex> guard(registry_guard);
+    id_to_ptr_registry.insert(std::pair<uint64_t, const void *>(id, ptr));
+    return ptr;
+  }
+
   wfnptr getWorkFunctionPointer(const std::string &name) {
     std::lock_guard<std::mutex> guard(registry_guard);
 
@@ -44,6 +69,26 @@ struct WorkFunctionRegistry {
     return (wfnptr)ptr;
   }
 
+  /// Returns the id of the work function `fn`, registering it if needed.
+  uint64_t getWorkFunctionId(const void *fn) {
+    {
+      std::lock_guard<std::mutex> guard(registry_guard);
+      auto fnidit = ptr_to_id_registry.find(fn);
+      if (fnidit != ptr_to_id_registry.end())
+        return fnidit->second;
+    }
+    getWorkFunctionName(fn);
+    std::lock_guard<std::mutex> guard(registry_guard);
+    return ptr_to_id_registry[fn];
+  }
+
+  /// Root node: name of the work function `id`.
+  std::string getWorkFunctionName(uint64_t id) {
+    std::lock_guard<std::mutex> guard(registry_guard);
+    assert(id < id_to_name_registry.size() && "Unknown work function id");
+    return id_to_name_registry[id];
+  }
+
   std::string getWorkFunctionName(const void *fn) {
     std::lock_guard<std::mutex> guard(registry_guard);
 
@@ -70,6 +115,9 @@ struct WorkFunctionRegistry {
 
     ptr_to_name_registry.clear();
     name_to_ptr_registry.clear();
+    ptr_to_id_registry.clear();
+    id_to_ptr_registry.clear();
+    id_to_name_registry.clear();
     fnid = 0;
   }
 
@@ -85,6 +133,18 @@ private:
     if (fnptrit == name_to_ptr_registry.end())
       name_to_ptr_registry.insert(
           std::pair<std::string, const void *>(name, fn));
+
+    // Only the root node creates tasks and assigns ids, remote nodes
+    // learn them from the root node.
+    if (!_dfr_is_root_node())
+      return;
+    auto fnidit = ptr_to_id_registry.find(fn);
+    if (fnidit == ptr_to_id_registry.end()) {
+      uint64_t id = id_to_name_registry.size();
+      ptr_to_id_registry.insert(std::pair<const void *, uint64_t>(fn, id));
+      id_to_ptr_registry.insert(std::pair<uint64_t, const void *>(id, fn));
+      id_to_name_registry.push_back(name);
+    }
   }
 
   std::string registerAnonymousWorkFunction(const void *fn) {
@@ -98,6 +158,9 @@ private:
   std::atomic<unsigned int> fnid{0};
   std::map<const void *, std::string> ptr_to_name_registry;
   std::map<std::string, const void *> name_to_ptr_registry;
+  std::unordered_map<const void *, uint64_t> ptr_to_id_registry;
+  std::unordered_map<uint64_t, const void *> id_to_ptr_registry;
+  std::vector<std::string> id_to_name_registry;
 };
 
 } // namespace dfr
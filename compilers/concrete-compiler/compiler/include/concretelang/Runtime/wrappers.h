@@ -7,6 +7,7 @@
 #define CONCRETELANG_RUNTIME_WRAPPERS_H
 
 #include "concretelang/Runtime/context.h"
+#include <mlir/ExecutionEngine/CRunnerUtils.h>
 
 extern "C" {
 
@@ -29,6 +30,15 @@ void memref_encode_expand_lut_for_bootstrap(
     uint64_t input_lut_size, uint64_t input_lut_stride, uint32_t poly_size,
     uint32_t out_MESSAGE_BITS, bool is_signed);
 
+void memref_encode_expand_many_lut_for_bootstrap(
+    uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
+    uint64_t output_lut_offset, uint64_t output_lut_size,
+    uint64_t output_lut_stride, uint64_t *input_luts_allocated,
+    uint64_t *input_luts_aligned, uint64_t input_luts_offset,
+    uint64_t input_luts_size0, uint64_t input_luts_size1,
+    uint64_t input_luts_stride0, uint64_t input_luts_stride1,
+    uint32_t poly_size, uint32_t out_MESSAGE_BITS, bool is_signed);
+
 void memref_encode_lut_for_crt_woppbs(
     uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
     uint64_t output_lut_offset, uint64_t output_lut_size0,
@@ -126,6 +136,32 @@ void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext);
 
+/// Computes `ct0 * cleartexts + ct1` in a single pass, without
+/// materializing the product.
+void memref_batched_mul_cleartext_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *cleartexts_allocated,
+    uint64_t *cleartexts_aligned, uint64_t cleartexts_offset,
+    uint64_t cleartexts_size, uint64_t cleartexts_stride,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1);
+
+/// Computes `ct0 * cleartext + ct1` in a single pass, without
+/// materializing the product.
+void memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1);
+
 void memref_batched_negate_lwe_ciphertext_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -133,6 +169,31 @@ void memref_batched_negate_lwe_ciphertext_u64(
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1);
 
+/// Copies the row `positions[i]` of `ct0` to the row `i` of `out`, for each
+/// row of `out`.
+void memref_gather_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *positions_allocated,
+    uint64_t *positions_aligned, uint64_t positions_offset,
+    uint64_t positions_size, uint64_t positions_stride);
+
+/// Copies `ct0` to `out`, unless they are the same buffer, then the row `i`
+/// of `values` to the row `positions[i]` of `out`, for each row of `values`.
+void memref_scatter_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *values_allocated,
+    uint64_t *values_aligned, uint64_t values_offset, uint64_t values_size0,
+    uint64_t values_size1, uint64_t values_stride0, uint64_t values_stride1,
+    uint64_t *positions_allocated, uint64_t *positions_aligned,
+    uint64_t positions_offset, uint64_t positions_size,
+    uint64_t positions_stride);
+
 void memref_batched_keyswitch_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -142,12 +203,6 @@ void memref_batched_keyswitch_lwe_u64(
     uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
     uint32_t ksk_index, mlir::concretelang::RuntimeContext *context);
 
-void *memref_keyswitch_async_lwe_u64(
-    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, mlir::concretelang::RuntimeContext *context);
-
 void memref_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
@@ -181,6 +236,136 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+// Keyswitch followed by a bootstrap of the keyswitched ciphertext, without
+// materializing the intermediate ciphertext in a memref.
+void memref_keyswitch_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+void memref_batched_keyswitch_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t ks_level, uint32_t ks_base_log,
+    uint32_t ks_input_lwe_dim, uint32_t ks_output_lwe_dim, uint32_t ksk_index,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context);
+
+void memref_keyswitch_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+void memref_batched_keyswitch_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *acc_allocated,
+    uint64_t *acc_aligned, uint64_t acc_offset, uint64_t acc_size,
+    uint64_t acc_stride, uint32_t ks_level, uint32_t ks_base_log,
+    uint32_t ks_input_lwe_dim, uint32_t ks_output_lwe_dim, uint32_t ksk_index,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context);
+
+// Bootstrap variants taking a precomputed trivial GLWE accumulator of
+// `(glwe_dim + 1) * poly_size` words instead of a lookup table.
+void memref_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+void memref_batched_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *acc_allocated,
+    uint64_t *acc_aligned, uint64_t acc_offset, uint64_t acc_size,
+    uint64_t acc_stride, uint32_t input_lwe_dim, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+// Evaluates the `out_size0` lookup tables packed in `tlu` by
+// `memref_encode_expand_many_lut_for_bootstrap` with a single blind rotation,
+// the lookup tables being `lut_stride` coefficients apart.
+void memref_many_lut_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t lut_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+// Compact variants of the keyswitch and bootstrap wrappers, called by the
+// compiled circuits through the C interface of MLIR: the memrefs are passed
+// as pointers to their descriptors, and the parameters of the operation, in
+// the order of the scalar arguments of the regular wrapper, as a constant
+// memref emitted once per distinct operation.
+void _mlir_ciface_memref_keyswitch_lwe_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context);
+
+void _mlir_ciface_memref_bootstrap_lwe_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *tlu,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context);
+
+void _mlir_ciface_memref_bootstrap_lwe_with_accumulator_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *acc,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context);
+
+void _mlir_ciface_memref_keyswitch_bootstrap_lwe_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *tlu,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context);
+
+void _mlir_ciface_memref_keyswitch_bootstrap_lwe_with_accumulator_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *acc,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context);
+
+// Asynchronous variants of the keyswitch and bootstrap wrappers, taking the
+// same arguments and returning a future of their completion. The buffers
+// must stay alive and unmodified until the future is awaited.
+void *memref_keyswitch_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint32_t level, uint32_t base_log,
+    uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t ksk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 void *memref_bootstrap_async_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
@@ -191,6 +376,40 @@ void *memref_bootstrap_async_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+void *memref_bootstrap_async_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+void *memref_keyswitch_bootstrap_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+void *memref_keyswitch_bootstrap_async_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+// Waits for `future` then copies the ciphertext it produced in `in` to `out`,
+// unless both are the same buffer.
 void memref_await_future(uint64_t *out_allocated, uint64_t *out_aligned,
                          uint64_t out_offset, uint64_t out_size,
                          uint64_t out_stride, void *future,
@@ -227,6 +446,35 @@ void memref_wop_pbs_crt_buffer(
     // runtime context that hold evaluation keys
     mlir::concretelang::RuntimeContext *context);
 
+// Batched version of memref_wop_pbs_crt_buffer over 3D memrefs of CRT
+// ciphertexts, applying the same lookup tables to all of them.
+void memref_batched_wop_pbs_crt_buffer(
+    // Output 3D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_size_2,
+    uint64_t out_stride_0, uint64_t out_stride_1, uint64_t out_stride_2,
+    // Input 3D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_size_2,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t in_stride_2,
+    // clear text lut
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_size, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key indices
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evaluation keys
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
                           uint64_t src_offset, uint64_t src_size,
                           uint64_t src_stride, uint64_t *dst_allocated,
@@ -261,6 +509,22 @@ void memref_bootstrap_lwe_cuda_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+/// \brief Run a keyswitch followed by a bootstrap of the keyswitched
+/// ciphertext on GPU.
+///
+/// Both run on the same stream and the intermediate ciphertext stays in
+/// device memory, so only the input and the output are copied.
+void memref_keyswitch_bootstrap_lwe_cuda_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 // Batched CUDA function //////////////////////////////////////////////////////
 
 void memref_batched_keyswitch_lwe_cuda_u64(
@@ -294,6 +558,61 @@ void memref_batched_mapped_bootstrap_lwe_cuda_u64(
     uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
+
+void memref_batched_keyswitch_bootstrap_lwe_cuda_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t ks_level, uint32_t ks_base_log,
+    uint32_t ks_input_lwe_dim, uint32_t ks_output_lwe_dim, uint32_t ksk_index,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context);
+
+// WoP-PBS CUDA function /////////////////////////////////////////////////////
+
+/// \brief Run the WoP-PBS of a CRT ciphertext on GPU, i.e. the bit extraction
+/// of its blocks followed by the circuit bootstrapping and vertical packing of
+/// the lookup tables, with the same arguments as `memref_wop_pbs_crt_buffer`.
+void memref_wop_pbs_crt_buffer_cuda(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_stride_0,
+    uint64_t out_stride_1, uint64_t *in_allocated, uint64_t *in_aligned,
+    uint64_t in_offset, uint64_t in_size_0, uint64_t in_size_1,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t *lut_ct_allocated,
+    uint64_t *lut_ct_aligned, uint64_t lut_ct_offset, uint64_t lut_ct_size0,
+    uint64_t lut_ct_size1, uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride, uint32_t lwe_small_dim,
+    uint32_t cbs_level_count, uint32_t cbs_base_log, uint32_t ksk_level_count,
+    uint32_t ksk_base_log, uint32_t bsk_level_count, uint32_t bsk_base_log,
+    uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size, uint32_t ksk_index, uint32_t bsk_index,
+    uint32_t pksk_index, mlir::concretelang::RuntimeContext *context);
+
+// Device residency of ciphertext buffers ////////////////////////////////////
+
+/// \brief Requests the next CUDA wrapper writing the given buffer to keep its
+/// result on the GPU, without copying it back to the host buffer.
+void memref_keep_on_device_cuda_u64(
+    uint64_t *allocated, uint64_t *aligned, uint64_t offset, uint64_t size,
+    uint64_t stride, mlir::concretelang::RuntimeContext *context);
+
+/// \brief Copies back to the given buffer the result a CUDA wrapper kept on
+/// the GPU, if any, and releases the device copy.
+void memref_copy_to_host_cuda_u64(
+    uint64_t *allocated, uint64_t *aligned, uint64_t offset, uint64_t size,
+    uint64_t stride, mlir::concretelang::RuntimeContext *context);
+
+/// \brief Releases the device copy of the given buffer, if any, without
+/// copying it back.
+void memref_release_on_device_cuda_u64(
+    uint64_t *allocated, uint64_t *aligned, uint64_t offset, uint64_t size,
+    uint64_t stride, mlir::concretelang::RuntimeContext *context);
+
 // Tracing ////////////////////////////////////////////////////////////////////
 void memref_trace_ciphertext(uint64_t *ct0_allocated, uint64_t *ct0_aligned,
                              uint64_t ct0_offset, uint64_t ct0_size,
@@ -306,10 +625,37 @@ void memref_trace_plaintext(uint64_t input, uint64_t input_width,
 
 void memref_trace_message(char *message_ptr, uint32_t message_len);
 
+/// \brief Records that the probe `name_ptr` is reached, see `probes.h`.
+void memref_trace_probe(char *name_ptr, uint32_t name_len, uint32_t precision,
+                        double noise_variance);
+
 /// @brief Allocate memory using malloc and check for nullptr
+///
+/// The memory is page-locked if the pinned host pool is enabled, see
+/// `pinned_memory.h`, so that it can be transferred asynchronously to GPUs,
+/// or otherwise comes from the host memory pool if it is enabled, see
+/// `memory_pool.h`.
 /// @param size number of bytes to allocate
 /// @return pointer to the allocated memory or nullptr
 void *concrete_checked_malloc(size_t size);
+
+/// @brief Free memory allocated by `concrete_checked_malloc` or `malloc`
+/// @param ptr pointer to the memory to free
+void concrete_checked_free(void *ptr);
+
+/// @brief Returns the x86-64 microarchitecture level supported by the cpu
+///
+/// Called by the circuits of the libraries generated for several x86-64
+/// levels to select their variant, see `CodegenOptions::cpuVariants`.
+/// @return 0 to 3 for x86-64 to x86-64-v4
+uint64_t concrete_x86_64_level();
+
+/// @brief Signals that the output buffer at `aligned_ptr` is computed
+///
+/// Called by the circuits compiled in destination-passing mode after the
+/// last write of each output, see `output_ready.h`.
+/// @param aligned_ptr the aligned pointer of the output buffer
+void concrete_output_ready(uint64_t aligned_ptr);
 }
 
 #endif
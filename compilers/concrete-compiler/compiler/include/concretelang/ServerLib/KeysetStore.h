@@ -0,0 +1,131 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SERVERLIB_KEYSET_STORE_H
+#define CONCRETELANG_SERVERLIB_KEYSET_STORE_H
+
+#include "concretelang/Common/Error.h"
+#include "concretelang/Common/Keysets.h"
+#include "concretelang/ServerLib/ServerLib.h"
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace concretelang {
+namespace serverlib {
+
+/// Memory used by the keys of a server keyset, in bytes.
+struct KeysetFootprint {
+  /// The seeded keys, as they are serialized.
+  size_t compressed = 0;
+  /// The keys used by the evaluation, once the seeded ones are decompressed.
+  size_t decompressed = 0;
+  /// The bootstrap keys converted to the fourier domain by the runtime
+  /// context of the keyset.
+  size_t fourier = 0;
+
+  size_t total() const { return compressed + decompressed + fourier; }
+};
+
+/// Evaluation keysets of the tenants of a server, loaded on demand and kept
+/// resident under a memory budget, the least recently used tenants being
+/// evicted first.
+///
+/// The footprint of a keyset accounts for all its keys once used, i.e.
+/// decompressed and converted to the fourier domain. Evicting a keyset drops
+/// the reference of the store only, the calls in flight and the contexts
+/// cached by the server programs keep their keys until they are done with
+/// them.
+class KeysetStore {
+public:
+  /// Loads the keyset of a tenant, called without holding any lock of the
+  /// store so that several tenants can be loaded concurrently.
+  typedef std::function<Result<ServerKeyset>(const std::string &tenantId)>
+      Loader;
+
+  /// Creates a store keeping its resident keysets under `memoryBudget` bytes.
+  /// A keyset larger than the budget is still kept, alone.
+  ///
+  /// With `decompressOnLoad`, the seeded keys are decompressed as part of the
+  /// load, i.e. in the background for a prefetch, instead of on the first
+  /// call using them.
+  KeysetStore(Loader loader, size_t memoryBudget, bool decompressOnLoad = true)
+      : loader(loader), memoryBudget(memoryBudget),
+        decompressOnLoad(decompressOnLoad) {}
+
+  /// Waits for the pending prefetches.
+  ~KeysetStore();
+
+  KeysetStore(const KeysetStore &) = delete;
+  KeysetStore &operator=(const KeysetStore &) = delete;
+
+  /// Returns the keyset of `tenantId`, loading it if it is not resident. If
+  /// it is already being loaded, e.g. by a prefetch, waits for it instead.
+  Result<ServerKeyset> get(const std::string &tenantId);
+
+  /// Starts loading the keyset of `tenantId` in the background if it is not
+  /// resident, so that the next `get` does not wait for it. A failed
+  /// prefetch is reported by the `get` waiting for it, if any.
+  void prefetch(const std::string &tenantId);
+
+  /// Drops the keyset of `tenantId` from the store.
+  void evict(const std::string &tenantId);
+
+  /// Returns true if the keyset of `tenantId` is resident.
+  bool isResident(const std::string &tenantId);
+
+  /// Call `circuit` with the keyset of `tenantId`.
+  Result<std::vector<TransportValue>> call(ServerCircuit &circuit,
+                                           const std::string &tenantId,
+                                           std::vector<TransportValue> &args);
+
+  /// Returns the footprint of the resident keysets.
+  KeysetFootprint getFootprint();
+
+  /// Returns the footprint of `keyset`.
+  static KeysetFootprint footprintOf(const ServerKeyset &keyset);
+
+private:
+  struct Entry {
+    ServerKeyset keyset;
+    KeysetFootprint footprint;
+    /// Position of the tenant in `lru`
+    std::list<std::string>::iterator position;
+  };
+
+  typedef std::promise<Result<ServerKeyset>> Promise;
+
+  /// Loads the keyset of `tenantId` and fulfills `promise` with it.
+  void load(const std::string &tenantId, Promise &promise);
+
+  /// Adds the keyset of `tenantId` and evicts the least recently used ones
+  /// above the budget, called with the lock held.
+  void insert(const std::string &tenantId, const ServerKeyset &keyset);
+
+  /// Removes a resident tenant, called with the lock held.
+  void remove(const std::string &tenantId);
+
+  Loader loader;
+  size_t memoryBudget;
+  bool decompressOnLoad;
+  size_t memoryUsage = 0;
+  std::mutex mutex;
+  /// Most recently used first
+  std::list<std::string> lru;
+  std::unordered_map<std::string, Entry> resident;
+  std::unordered_map<std::string, std::shared_future<Result<ServerKeyset>>>
+      loading;
+  std::list<std::future<void>> prefetches;
+};
+
+} // namespace serverlib
+} // namespace concretelang
+
+#endif
@@ -13,88 +13,632 @@
 #include "concretelang/Common/Protocol.h"
 #include "concretelang/Common/Transformers.h"
 #include "concretelang/Common/Values.h"
+#include "concretelang/Runtime/primitive_statistics.h"
+#include "concretelang/Runtime/simulation_statistics.h"
+#include "concretelang/ServerLib/ServerMetrics.h"
 #include "llvm/ADT/ArrayRef.h"
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <dlfcn.h>
 #include <functional>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
 using concretelang::keysets::ServerKeyset;
+using concretelang::protocol::SharedReader;
+using concretelang::transformers::ArgStream;
 using concretelang::transformers::ArgTransformer;
+using concretelang::transformers::PackingReturnTransformer;
 using concretelang::transformers::ReturnTransformer;
+using concretelang::transformers::StreamArgTransformer;
 using concretelang::transformers::TransformerFactory;
 using concretelang::values::Value;
 
+namespace mlir {
+namespace concretelang {
+struct RuntimeContext;
+} // namespace concretelang
+} // namespace mlir
+
 namespace concretelang {
 namespace serverlib {
 
-/// A smart pointer to a dynamic module.
+/// A smart pointer to a dynamic module, i.e. to the code of the circuits of a
+/// program, opened from a shared library or compiled in memory by a JIT.
 class DynamicModule {
   friend class ServerCircuit;
 
 public:
-  ~DynamicModule();
+  DynamicModule() = default;
+  virtual ~DynamicModule();
   static Result<std::shared_ptr<DynamicModule>>
   open(const std::string &outputPath);
 
+  /// Returns the address of the symbol `name` of the module.
+  virtual Result<void *> lookup(const std::string &name);
+
 private:
-  void *libraryHandle;
+  void *libraryHandle = nullptr;
+};
+
+/// Runtime contexts built for the keysets used to call the circuits of a
+/// program, so that the preparation of the keys (e.g. their conversion to
+/// the fourier domain) is done once per keyset instead of once per call.
+/// Keysets are identified by the keys they share, and the least recently
+/// used context is dropped when more than `capacity` keysets are in use.
+/// The contexts created are counted in `metrics`, if any.
+class RuntimeContextCache {
+public:
+  RuntimeContextCache(size_t capacity,
+                      std::shared_ptr<ServerMetrics> metrics = nullptr)
+      : capacity(capacity), metrics(metrics) {}
+
+  /// Returns the context of `serverKeyset`, creating it if needed.
+  std::shared_ptr<mlir::concretelang::RuntimeContext>
+  get(const ServerKeyset &serverKeyset);
+
+  /// Adds a context prepared beforehand.
+  void insert(std::shared_ptr<mlir::concretelang::RuntimeContext> context);
+
+private:
+  std::shared_ptr<mlir::concretelang::RuntimeContext>
+  lookup(const ServerKeyset &serverKeyset);
+
+  std::mutex mutex;
+  size_t capacity;
+  std::shared_ptr<ServerMetrics> metrics;
+  /// Most recently used first
+  std::list<std::shared_ptr<mlir::concretelang::RuntimeContext>> contexts;
+};
+
+/// A caller-owned buffer receiving the raw data of one output of a circuit.
+struct OutputBuffer {
+  void *data;
+  size_t size;
 };
 
+class CircuitStream;
+
 class ServerCircuit {
   friend class ServerProgram;
+  friend class CallGraph;
+  friend class CallBatcher;
+  friend class KeysetStream;
 
 public:
   /// Call the circuit with public arguments.
+  ///
+  /// A circuit holds no state specific to a call, so it can be called
+  /// concurrently from several threads.
   Result<std::vector<TransportValue>> call(const ServerKeyset &serverKeyset,
                                            std::vector<TransportValue> &args);
 
+  /// Call the circuit on each set of public arguments of `batch`, with the
+  /// same keys. The keys are prepared once for the whole batch, and the
+  /// calls run concurrently on the threads of the async executor.
+  Result<std::vector<std::vector<TransportValue>>>
+  callBatch(const ServerKeyset &serverKeyset,
+            std::vector<std::vector<TransportValue>> &batch);
+
+  /// Call the circuit `n` times in a row with the same keys, each call taking
+  /// the outputs of the previous one as arguments, and return the outputs of
+  /// the last call, e.g. to iterate a composable circuit. The intermediate
+  /// outputs stay in memory instead of going through transport values, and
+  /// the runtime context is looked up once. Each output must then have the
+  /// type, shape and key of the argument at the same position.
+  Result<std::vector<TransportValue>>
+  callRepeated(const ServerKeyset &serverKeyset,
+               std::vector<TransportValue> &args, size_t n);
+
+  /// Call the circuit asynchronously on the server call pool, and invoke
+  /// `callback` with the result on the pool thread that made the call.
+  ///
+  /// The pool has one thread per hardware thread and queues at most four
+  /// calls per thread, which can be overridden with the
+  /// `CONCRETE_SERVER_THREADS` and `CONCRETE_SERVER_QUEUE_DEPTH`
+  /// environment variables. When the queue is full, the caller blocks
+  /// until a call completes, except on the threads of the pool, e.g. in
+  /// `callback`, which make the call inline instead.
+  void callAsync(
+      const ServerKeyset &serverKeyset, std::vector<TransportValue> args,
+      std::function<void(Result<std::vector<TransportValue>>)> callback);
+
+  /// Same as above, returns a future on the result instead.
+  std::future<Result<std::vector<TransportValue>>>
+  callAsync(const ServerKeyset &serverKeyset, std::vector<TransportValue> args);
+
+  /// Open a stream of calls of the circuit with the keys of `serverKeyset`,
+  /// in which consecutive calls pipeline through the SDFG graph of the
+  /// circuit (see `CircuitStream`).
+  std::unique_ptr<CircuitStream> openStream(const ServerKeyset &serverKeyset);
+
+  /// Call the circuit with public arguments, and write the raw data of its
+  /// outputs (i.e. the payloads of the transport values returned by `call`)
+  /// to caller-owned buffers, sized with `getOutputBufferSize`.
+  ///
+  /// If the circuit was compiled in destination-passing mode, it computes
+  /// its tensor outputs directly in those buffers, which must then be
+  /// aligned on the element size. Otherwise the outputs are copied there.
+  /// The ciphertexts of the outputs are never packed.
+  Result<void> callInto(const ServerKeyset &serverKeyset,
+                        std::vector<TransportValue> &args,
+                        std::vector<OutputBuffer> &outputs);
+
+  /// Call the circuit with public arguments, and pass each of its outputs to
+  /// `onOutput` along with its position, as soon as it is computed.
+  ///
+  /// If the circuit was compiled in destination-passing mode, its tensor
+  /// outputs are delivered while it computes the others, from the thread of
+  /// the call. The other outputs are delivered once the call completes.
+  Result<void> callWithEarlyOutputs(
+      const ServerKeyset &serverKeyset, std::vector<TransportValue> &args,
+      std::function<void(size_t, Result<TransportValue>)> onOutput);
+
+  /// Returns the size in bytes of the buffer receiving the output `pos` in
+  /// `callInto`.
+  size_t getOutputBufferSize(size_t pos);
+
+  /// Prepares the ciphertext argument `pos` of a call streamed in chunks,
+  /// from its header, i.e. its transport value without payload. The chunks
+  /// pushed to the returned stream are transformed as they arrive, so that
+  /// the serialized argument is never held in memory as a whole.
+  Result<ArgStream> prepareArgStream(size_t pos, const TransportValue &header);
+
+  /// Transforms the argument `pos` of a call from its transport value, to be
+  /// passed to `callWithArgs` along with the streamed ones.
+  Result<Value> prepareArg(size_t pos, const TransportValue &arg);
+
+  /// Call the circuit with arguments already transformed, i.e. returned by
+  /// `prepareArg` or by the `finish` of argument streams.
+  Result<std::vector<TransportValue>>
+  callWithArgs(const ServerKeyset &serverKeyset, std::vector<Value> &args);
+
   /// Simulate the circuit with public arguments.
   Result<std::vector<TransportValue>>
   simulate(std::vector<TransportValue> &args);
 
+  /// Simulate the circuit on each set of public arguments of `dataset`, the
+  /// simulations running concurrently on the threads of the async executor.
+  ///
+  /// With a non zero `seed`, the noise of each set of arguments is drawn from
+  /// a stream seeded from `seed` and its index, so that the results do not
+  /// depend on the threads, nor on the size of the dataset. The operations
+  /// simulated on the worker threads of the parallel loops of the circuit
+  /// draw from the streams of those threads, and are not reproducible.
+  Result<std::vector<std::vector<TransportValue>>>
+  simulateDataset(std::vector<std::vector<TransportValue>> &dataset,
+                  uint64_t seed = 0);
+
   /// Returns the name of this circuit.
   std::string getName();
 
+  /// Returns the names of the execution variants the circuit was compiled
+  /// with besides its default code (see
+  /// `CompilationOptions::executionVariants`).
+  std::vector<std::string> getVariants();
+
+  /// Returns the name of the execution variant run by the calls of this
+  /// circuit, empty for its default code.
+  std::string getSelectedVariant();
+
+  /// Runs the calls of this circuit, and of its copies made afterwards, with
+  /// the execution variant `name`, or with the default code if empty. The
+  /// calls in flight on other threads finish with the variant they started
+  /// with.
+  ///
+  /// A variant is selected for the host when the circuit is loaded: the
+  /// first gpu variant if a GPU is available, else the first parallel one if
+  /// the host has several cores, else the first sequential one, else the
+  /// default code. The `CONCRETE_EXECUTION_VARIANT` environment variable
+  /// overrides this selection with the variant it names, if the circuit has
+  /// it, `default` naming the default code.
+  Result<void> selectVariant(const std::string &name);
+
+  /// Calls the circuit `repetitions` times on `args` with its default code
+  /// and with each of its execution variants which can run on this host,
+  /// after a first call which is not timed, and selects the fastest. Returns
+  /// the name of the selected variant. The calls made meanwhile from other
+  /// threads run with any of the variants, which all compute the same
+  /// results.
+  Result<std::string> calibrateVariants(const ServerKeyset &serverKeyset,
+                                        std::vector<TransportValue> &args,
+                                        size_t repetitions = 1);
+
+  /// Starts recording the calls of the runtime primitives made by the calls of
+  /// this circuit, and of its copies made afterwards, until disabled. Nothing
+  /// is recorded by a runtime built without
+  /// `CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED`, nor by the dataflow workers.
+  /// With `hardwareCounters`, the hardware events of the primitives on the
+  /// CPU are counted as well.
+  void enablePrimitiveStatistics(bool enable = true,
+                                 bool hardwareCounters = false);
+
+  /// Returns the statistics of the primitives called since enabled or reset,
+  /// by primitive, keys and device.
+  std::vector<mlir::concretelang::PrimitiveStatistic> getPrimitiveStatistics();
+
+  void resetPrimitiveStatistics();
+
+  /// Starts recording the noise and the overflows of the operations simulated
+  /// by the calls of this circuit, and of its copies made afterwards, until
+  /// disabled. Only the simulated circuits record anything, the overflows
+  /// being only detected when compiled with overflow detection.
+  void enableSimulationStatistics(bool enable = true);
+
+  /// Returns the statistics of the operations simulated since enabled or
+  /// reset, by location.
+  std::vector<mlir::concretelang::SimulationStatistic>
+  getSimulationStatistics();
+
+  void resetSimulationStatistics();
+
 private:
   ServerCircuit() = default;
 
-  static Result<ServerCircuit>
-  fromDynamicModule(const Message<concreteprotocol::CircuitInfo> &circuitInfo,
-                    std::shared_ptr<DynamicModule> dynamicModule,
-                    bool useSimulation);
+  static Result<ServerCircuit> fromDynamicModule(
+      const SharedReader<concreteprotocol::CircuitInfo> &circuitInfo,
+      std::shared_ptr<DynamicModule> dynamicModule, bool useSimulation);
+
+  Result<std::vector<TransportValue>>
+  callWithContext(mlir::concretelang::RuntimeContext *runtimeContext,
+                  std::vector<TransportValue> &args);
+
+  /// Calls the circuit on each set of arguments of `batch` as `callBatch`
+  /// does, and returns the result of each call.
+  std::vector<Result<std::vector<TransportValue>>>
+  callEach(const ServerKeyset &serverKeyset,
+           std::vector<std::vector<TransportValue>> &batch);
+
+  /// Same as above, with arguments already transformed.
+  Result<std::vector<TransportValue>>
+  callWithContext(mlir::concretelang::RuntimeContext *runtimeContext,
+                  std::vector<Value> &argsBuffer);
+
+  /// Transforms the outputs of a call into transport values, packing the
+  /// ciphertexts if the context holds the packing key of their gate.
+  Result<std::vector<TransportValue>>
+  transformReturns(mlir::concretelang::RuntimeContext *runtimeContext,
+                   std::vector<Value> &returnsBuffer);
+
+  /// Transforms the output `pos` of a call into a transport value, as
+  /// `transformReturns` does.
+  Result<TransportValue>
+  transformReturn(mlir::concretelang::RuntimeContext *runtimeContext,
+                  size_t pos, Value &&value);
+
+  /// Registers the circuit library to the dataflow runtime, and returns true
+  /// if this process is not the root node, after running the remote scheduler.
+  bool runRemoteScheduler();
+
+  Result<std::vector<Value>> transformArgs(std::vector<TransportValue> &args);
+
+  /// Invokes the circuit function. In destination-passing mode, the tensor
+  /// outputs with a non null pointer in `destinations` are written there,
+  /// the others are allocated in `returnsBuffer`.
+  void invoke(mlir::concretelang::RuntimeContext *runtimeContext,
+              std::vector<Value> &argsBuffer,
+              std::vector<Value> &returnsBuffer,
+              llvm::ArrayRef<void *> destinations = {});
+
+  /// Returns true if the output `pos` is passed to the circuit function as a
+  /// destination buffer instead of being returned.
+  bool isPassedAsDestination(size_t pos);
+
+  /// Returns the name of the execution variant selected for this host by
+  /// default, see `selectVariant`.
+  std::string getHostVariant();
 
-  void invoke(const ServerKeyset &serverKeyset);
+  /// Returns true if the execution variant `variant` can run on this host.
+  bool isVariantAvailable(const concreteprotocol::ExecutionVariant::Reader
+                              &variant);
 
-  Message<concreteprotocol::CircuitInfo> circuitInfo;
+  /// A view on the program info shared by the circuits of the program.
+  SharedReader<concreteprotocol::CircuitInfo> circuitInfo;
   bool useSimulation;
-  void (*func)(void *...);
+  bool destinationPassing;
+  /// The circuit functions of the default code and of each execution
+  /// variant, in the order of the variants of the circuit info
+  void (*defaultFunc)(void *...);
+  std::vector<void (*)(void *...)> variantFuncs;
+  /// The selected execution variant, 0 for the default code and `i + 1` for
+  /// the variant `i`. It is atomic as `selectVariant` may change it while
+  /// calls are in flight on other threads, each call running the variant
+  /// selected when it is invoked. The copies of the circuit take the variant
+  /// selected when they are made.
+  struct SelectedVariant {
+    SelectedVariant() = default;
+    SelectedVariant(const SelectedVariant &other)
+        : index(other.index.load()) {}
+    SelectedVariant &operator=(const SelectedVariant &other) {
+      index.store(other.index.load());
+      return *this;
+    }
+    std::atomic<size_t> index{0};
+  } selectedVariant;
   std::shared_ptr<DynamicModule> dynamicModule;
   std::vector<ArgTransformer> argTransformers;
+  /// Empty for the arguments which cannot be streamed
+  std::vector<StreamArgTransformer> streamArgTransformers;
   std::vector<ReturnTransformer> returnTransformers;
-  std::vector<Value> argsBuffer;
-  std::vector<Value> returnsBuffer;
+  /// Empty for the outputs which are not packed
+  std::vector<PackingReturnTransformer> packingReturnTransformers;
   std::vector<size_t> argDescriptorSizes;
   std::vector<size_t> returnDescriptorSizes;
+  std::vector<std::vector<size_t>> returnShapes;
   size_t argRawSize;
   size_t returnRawSize;
+  size_t destinationRawSize;
+  std::shared_ptr<RuntimeContextCache> contextCache;
+  /// Null if the primitive statistics are not enabled
+  std::shared_ptr<mlir::concretelang::PrimitiveStatistics> primitiveStatistics;
+  /// Null if the simulation statistics are not enabled
+  std::shared_ptr<mlir::concretelang::SimulationStatistics>
+      simulationStatistics;
+  /// The metrics of the calls of this circuit, null if not recorded
+  std::shared_ptr<CircuitMetrics> metrics;
+};
+
+/// A composition of calls of circuits, e.g. of the functions of a module, of
+/// which each argument is an argument of the graph or an output of another
+/// call. The calls run on the server call pool as soon as their arguments are
+/// computed, so that the independent calls overlap.
+class CallGraph {
+public:
+  /// Marks the sources taken from the arguments of the graph.
+  static constexpr size_t GRAPH_ARGUMENT = SIZE_MAX;
+
+  /// The source of an argument of a call: the output `pos` of the call
+  /// `call`, or the argument `pos` of the graph if `call` is `GRAPH_ARGUMENT`.
+  struct Source {
+    size_t call;
+    size_t pos;
+  };
+
+  /// Adds a call of `circuit` taking its arguments from `sources`, and
+  /// returns its index. The sources can only be calls added before, so that
+  /// the graph has no cycle.
+  Result<size_t> addCall(ServerCircuit circuit, std::vector<Source> sources);
+
+  /// Runs the calls of the graph on `args`, and returns the outputs of each
+  /// call. No call is started after one fails, and the error of the failed
+  /// call is returned once the running ones complete.
+  Result<std::vector<std::vector<TransportValue>>>
+  run(const ServerKeyset &serverKeyset, const std::vector<TransportValue> &args);
+
+  size_t size() const { return calls.size(); }
+
+private:
+  struct Call {
+    ServerCircuit circuit;
+    std::vector<Source> sources;
+  };
+
+  std::vector<Call> calls;
+  size_t argumentCount = 0;
+};
+
+/// Coalesces the calls of a circuit made concurrently, e.g. by the threads of
+/// a web server handling one request each, into batches run with
+/// `ServerCircuit::callBatch`. A call waits at most `window` for other calls
+/// made with the same keys, or until `maxBatchSize` calls are pending, and
+/// the batch runs on the thread of the batcher while the next calls are
+/// collected. Keysets hold the same keys when they are copies of each other,
+/// e.g. the keys of a client loaded once, not deserialized on each call.
+class CallBatcher {
+public:
+  CallBatcher(ServerCircuit circuit, std::chrono::microseconds window,
+              size_t maxBatchSize);
+
+  /// Runs the pending calls before returning.
+  ~CallBatcher();
+
+  CallBatcher(const CallBatcher &) = delete;
+  CallBatcher &operator=(const CallBatcher &) = delete;
+
+  /// Queues a call of the circuit and returns a future on its result. The
+  /// calls of a batch fail independently.
+  std::future<Result<std::vector<TransportValue>>>
+  submit(const ServerKeyset &serverKeyset, std::vector<TransportValue> args);
+
+  /// Same as above, waits for the result.
+  Result<std::vector<TransportValue>> call(const ServerKeyset &serverKeyset,
+                                           std::vector<TransportValue> args);
+
+private:
+  struct Request {
+    ServerKeyset serverKeyset;
+    std::vector<TransportValue> args;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<Result<std::vector<TransportValue>>> promise;
+  };
+
+  void work();
+
+  ServerCircuit circuit;
+  std::chrono::microseconds window;
+  size_t maxBatchSize;
+  std::mutex mutex;
+  std::condition_variable pending;
+  std::deque<Request> requests;
+  bool stopping = false;
+  std::thread worker;
+};
+
+/// Runs a stream of calls of a circuit with the same keys on the server call
+/// pool. When the circuit was compiled with `emitSDFGOps` for the CPU stream
+/// emulator, the calls of the stream share one dataflow graph: the first call
+/// builds it, and the inputs of each following call enter the streams right
+/// behind those of the previous one, so that e.g. the keyswitches of a call
+/// overlap the bootstraps of the calls before it. Otherwise, e.g. on the GPU,
+/// the calls of the stream simply run concurrently.
+class CircuitStream {
+public:
+  CircuitStream(ServerCircuit circuit, ServerKeyset serverKeyset);
+
+  /// Waits for the pending calls before returning.
+  ~CircuitStream();
+
+  CircuitStream(const CircuitStream &) = delete;
+  CircuitStream &operator=(const CircuitStream &) = delete;
+
+  /// Starts a call of the circuit and returns a future on its result. The
+  /// results are those of separate calls, a failed call does not stop the
+  /// stream.
+  std::future<Result<std::vector<TransportValue>>>
+  submit(std::vector<TransportValue> args);
+
+  /// Same as above, waits for the result.
+  Result<std::vector<TransportValue>> call(std::vector<TransportValue> args);
+
+private:
+  ServerCircuit circuit;
+  ServerKeyset serverKeyset;
+  /// The stream emulator session shared by the calls, null when the runtime
+  /// cannot share its graphs
+  void *session;
+  std::mutex mutex;
+  std::condition_variable idle;
+  size_t pending = 0;
 };
 
 /// ServerProgram contains multiple
 class ServerProgram {
 public:
   /// Loads a server program from a shared lib path essentially.
+  ///
+  /// If `serverKeyset` is given, the runtime context (e.g. the fourier
+  /// bootstrap keys) is prepared once here and reused by the calls made with
+  /// the same keys, instead of being rebuilt on each call. With
+  /// `uploadKeysToGpus`, the keys are also uploaded to all the devices
+  /// before returning, so that the first call does not pay for it.
+  ///
+  /// The contexts of the last `contextCacheSize` keysets used to call the
+  /// circuits are kept for the next calls, 0 rebuilds the context on each
+  /// call made with other keys than the preloaded ones.
+  ///
+  /// The program info is copied once, and shared by the circuits.
+  ///
+  /// The circuits are built concurrently, along with the preloaded context.
+  /// With `lazyCircuits`, each circuit is only built on its first
+  /// `getServerCircuit` instead.
   static Result<ServerProgram>
   load(const Message<concreteprotocol::ProgramInfo> &programInfo,
-       const std::string &outputPath, bool useSimulation);
+       const std::string &outputPath, bool useSimulation,
+       std::optional<ServerKeyset> serverKeyset = std::nullopt,
+       bool uploadKeysToGpus = false, size_t contextCacheSize = 4,
+       bool lazyCircuits = false);
+
+  /// Same as above, with the code of the circuits held by `dynamicModule`
+  /// instead of a shared library, e.g. compiled in memory by a JIT.
+  static Result<ServerProgram>
+  load(const Message<concreteprotocol::ProgramInfo> &programInfo,
+       std::shared_ptr<DynamicModule> dynamicModule, bool useSimulation,
+       std::optional<ServerKeyset> serverKeyset = std::nullopt,
+       bool uploadKeysToGpus = false, size_t contextCacheSize = 4,
+       bool lazyCircuits = false);
 
   Result<ServerCircuit> getServerCircuit(const std::string &circuitName);
 
+  /// Returns the device memory used by the keys uploaded to the device
+  /// `gpuIdx`, in bytes, or 0 if no keys were preloaded.
+  size_t getGpuKeysMemory(uint32_t gpuIdx);
+
+  /// Returns the cumulative metrics of the calls of the circuits of this
+  /// program since it was loaded, shared by its copies, e.g. to be exported
+  /// with `ServerMetrics::toPrometheusText` or visited by a monitoring bridge.
+  std::shared_ptr<ServerMetrics> getMetrics() { return metrics; }
+
 private:
+  friend class KeysetStream;
+
   ServerProgram() = default;
 
+  /// The circuits of a program loaded lazily, shared by its copies.
+  struct LazyCircuits {
+    std::mutex mutex;
+    std::vector<SharedReader<concreteprotocol::CircuitInfo>> circuitInfos;
+    std::vector<std::optional<ServerCircuit>> circuits;
+    std::shared_ptr<DynamicModule> dynamicModule;
+    std::shared_ptr<RuntimeContextCache> contextCache;
+    std::shared_ptr<ServerMetrics> metrics;
+    bool useSimulation;
+  };
+
   std::vector<ServerCircuit> serverCircuits;
+  std::shared_ptr<LazyCircuits> lazyCircuits;
+  std::shared_ptr<mlir::concretelang::RuntimeContext> preloadedContext;
+  std::shared_ptr<ServerMetrics> metrics;
+};
+
+/// The evaluation keys of a program added one by one, e.g. as they are
+/// streamed from the client, so that the calls do not wait for the whole
+/// keyset to be uploaded. Each key is prepared as soon as it is added, the
+/// bootstrap keys being converted to the fourier domain, and a circuit can be
+/// called as soon as the keys it uses are there. The keys can be added
+/// concurrently from several threads, while circuits are called.
+class KeysetStream {
+public:
+  /// Opens a stream of the keys described by `keysetInfo`, i.e. the keyset
+  /// info of the program. With `uploadKeysToGpus`, the keys are also
+  /// uploaded to all the devices as they are added.
+  KeysetStream(concreteprotocol::KeysetInfo::Reader keysetInfo,
+               bool uploadKeysToGpus = false);
+
+  /// Adds a key, at the position given by the id of its info. A key can
+  /// only be added once.
+  Result<void> addBootstrapKey(LweBootstrapKey key);
+  Result<void> addKeyswitchKey(LweKeyswitchKey key);
+  Result<void> addPackingKeyswitchKey(PackingKeyswitchKey key);
+  Result<void> addGlwePackingKeyswitchKey(GlwePackingKeyswitchKey key);
+
+  /// Returns true if the keys used by `circuit` were all added, i.e. if it
+  /// can be called right away. The circuits compiled without the list of
+  /// their keys need the whole keyset, as do the packed outputs.
+  bool isReady(const ServerCircuit &circuit);
+
+  /// Returns true if all the keys were added.
+  bool isComplete();
+
+  /// Calls `circuit` with public arguments, once the keys it uses are added.
+  Result<std::vector<TransportValue>> call(ServerCircuit &circuit,
+                                           std::vector<TransportValue> &args);
+
+  /// Waits for all the keys to be added, and returns the complete keyset.
+  /// Its prepared keys are shared with the calls of the circuits of
+  /// `program` made with this keyset afterwards.
+  ServerKeyset finish(ServerProgram &program);
+
+private:
+  bool isReadyLocked(const ServerCircuit &circuit);
+
+  /// Reserves the key `id` of a kind, before it is added.
+  Result<void> claim(std::vector<bool> &pending, size_t id, const char *kind);
+
+  /// Marks the key `id` of a kind as added, and wakes up the waiting calls.
+  void markAdded(std::vector<bool> &added, size_t id);
+
+  std::shared_ptr<mlir::concretelang::RuntimeContext> context;
+  bool uploadKeysToGpus;
+  std::mutex mutex;
+  std::condition_variable keyAdded;
+  /// Whether each key was added, by kind and id
+  std::vector<bool> bootstrapKeys;
+  std::vector<bool> keyswitchKeys;
+  std::vector<bool> packingKeyswitchKeys;
+  std::vector<bool> glwePackingKeyswitchKeys;
+  /// Whether each key is being added, so that it is not added twice
+  std::vector<bool> bootstrapKeysPending;
+  std::vector<bool> keyswitchKeysPending;
+  std::vector<bool> packingKeyswitchKeysPending;
+  std::vector<bool> glwePackingKeyswitchKeysPending;
 };
 
 } // namespace serverlib
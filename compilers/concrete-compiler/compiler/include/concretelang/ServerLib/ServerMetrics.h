@@ -0,0 +1,123 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SERVERLIB_SERVER_METRICS_H
+#define CONCRETELANG_SERVERLIB_SERVER_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace concretelang {
+namespace serverlib {
+
+enum class MetricType { COUNTER, GAUGE, SUMMARY };
+
+/// A value of a metric for a set of labels, in the Prometheus data model: the
+/// quantiles of a summary have a `quantile` label, and its sum and count are
+/// named with the `_sum` and `_count` suffixes.
+struct MetricSample {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> labels;
+  double value;
+};
+
+struct Metric {
+  std::string name;
+  std::string help;
+  MetricType type;
+  std::vector<MetricSample> samples;
+};
+
+/// The number of buckets of the call latency histograms: each power of two of
+/// nanoseconds is split in `CALL_LATENCY_SUB_BUCKETS`, so that the quantiles
+/// are estimated within 25%.
+const size_t CALL_LATENCY_SUB_BUCKETS = 4;
+const size_t CALL_LATENCY_BUCKETS = 64 * CALL_LATENCY_SUB_BUCKETS;
+
+/// The cumulative metrics of the calls of a circuit, updated without locking.
+class CircuitMetrics {
+public:
+  /// Records a call which took `nanoseconds`, with `argumentBytes` and
+  /// `returnBytes` the size of its serialized arguments and results.
+  void recordCall(bool success, uint64_t nanoseconds, uint64_t argumentBytes,
+                  uint64_t returnBytes);
+
+  uint64_t getCalls() const { return calls.load(std::memory_order_relaxed); }
+  uint64_t getErrors() const { return errors.load(std::memory_order_relaxed); }
+  uint64_t getNanoseconds() const {
+    return nanoseconds.load(std::memory_order_relaxed);
+  }
+  uint64_t getArgumentBytes() const {
+    return argumentBytes.load(std::memory_order_relaxed);
+  }
+  uint64_t getReturnBytes() const {
+    return returnBytes.load(std::memory_order_relaxed);
+  }
+
+  /// Returns an estimate of the `quantile` of the latency of the calls, in
+  /// nanoseconds, or 0 if there was no call.
+  double getLatencyQuantile(double quantile) const;
+
+private:
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> errors{0};
+  std::atomic<uint64_t> nanoseconds{0};
+  std::atomic<uint64_t> argumentBytes{0};
+  std::atomic<uint64_t> returnBytes{0};
+  std::array<std::atomic<uint64_t>, CALL_LATENCY_BUCKETS> latencyHistogram{};
+};
+
+/// The registry of the cumulative metrics of a server program and of its
+/// circuits, shared by their copies, to be bridged into a monitoring system.
+///
+/// The key decompressions and the key uploads to the GPUs are counted for the
+/// whole process, as the keysets may be shared by several programs.
+class ServerMetrics {
+public:
+  /// Returns the metrics of the circuit `name`, created on the first call.
+  std::shared_ptr<CircuitMetrics> getCircuitMetrics(const std::string &name);
+
+  void recordContextCreation() {
+    contextCreations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t getContextCreations() const {
+    return contextCreations.load(std::memory_order_relaxed);
+  }
+
+  /// Registers `collector` to add metrics to the collected ones, e.g. those
+  /// of the application serving the program, so that they are exported
+  /// together.
+  void addCollector(std::function<void(std::vector<Metric> &)> collector);
+
+  /// Returns the current value of the metrics.
+  std::vector<Metric> collect();
+
+  /// Calls `visitor` with the current value of each metric.
+  void visit(const std::function<void(const Metric &)> &visitor);
+
+  /// Returns the metrics in the Prometheus text exposition format.
+  std::string toPrometheusText();
+
+private:
+  std::mutex mutex;
+  std::map<std::string, std::shared_ptr<CircuitMetrics>> circuits;
+  std::vector<std::function<void(std::vector<Metric> &)>> collectors;
+  std::atomic<uint64_t> contextCreations{0};
+};
+
+} // namespace serverlib
+} // namespace concretelang
+
+#endif
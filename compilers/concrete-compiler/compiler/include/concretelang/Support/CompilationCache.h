@@ -0,0 +1,86 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_COMPILATION_CACHE_H
+#define CONCRETELANG_SUPPORT_COMPILATION_CACHE_H
+
+#include "concretelang/Support/CompilerEngine.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include <optional>
+#include <string>
+
+namespace mlir {
+namespace concretelang {
+
+/// Returns a description of all the options changing the artifacts of a
+/// compilation, or nothing if the compilation cannot be cached with these
+/// options, i.e. if they cannot be described or if the compilation reports
+/// something else than its artifacts.
+std::optional<std::string>
+getCompilationOptionsKey(const CompilationOptions &options);
+
+/// Returns the key of the cache entry of the compilation of `sources`,
+/// hashing them with `optionsKey`, the build of the compiler and the host
+/// cpu, or nothing if the build of the compiler cannot be identified.
+std::optional<std::string>
+getCompilationCacheKey(llvm::ArrayRef<std::string> sources,
+                       llvm::StringRef optionsKey);
+
+/// Copies the requested artifacts of the cache entry `key` of `cacheDir` to
+/// the output directory of `library`. Returns false if the entry does not
+/// hold all of them, the library having then to be compiled.
+bool loadCachedArtifacts(llvm::StringRef cacheDir, llvm::StringRef key,
+                         CompilerEngine::Library &library, bool sharedLib,
+                         bool staticLib, bool clientParameters,
+                         bool compilationFeedback);
+
+/// Stores the artifacts emitted by `library` as the cache entry `key` of
+/// `cacheDir`. Failing to store them only leaves the entry missing.
+void storeCachedArtifacts(llvm::StringRef cacheDir, llvm::StringRef key,
+                          const CompilerEngine::Library &library);
+
+/// Returns the key of the cached solution of the optimization of `dag` with
+/// `config`, hashing the dag with the options of the optimization and the
+/// build of the compiler, or nothing if it cannot be cached.
+std::optional<std::string>
+getOptimizerCacheKey(const optimizer::Dag &dag,
+                     const optimizer::Config &config);
+
+/// Reads the solution `key` from the solution cache of `config`, or else from
+/// its shared caches. Returns false if none holds a valid entry.
+bool loadCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                        optimizer::DagSolution &solution);
+bool loadCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                        optimizer::CircuitSolution &solution);
+
+/// Stores `solution` as the entry `key` of the solution cache of `config`.
+/// Failing to store it only leaves the entry missing.
+void storeCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                         optimizer::DagSolution solution);
+void storeCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                         optimizer::CircuitSolution solution);
+
+/// Returns the key of the cached object generated from the LLVM IR `ir` for
+/// `cpu`, hashing them with the build of the compiler and, for the host cpu,
+/// its features, or nothing if the build of the compiler cannot be
+/// identified.
+std::optional<std::string> getObjectCacheKey(llvm::StringRef ir,
+                                             llvm::StringRef cpu);
+
+/// Copies the object `key` of `cacheDir` to `objectPath`. Returns false if
+/// there is no such object, the object having then to be generated.
+bool loadCachedObject(llvm::StringRef cacheDir, llvm::StringRef key,
+                      llvm::StringRef objectPath);
+
+/// Stores the object `objectPath` as the entry `key` of `cacheDir`. Failing
+/// to store it only leaves the entry missing.
+void storeCachedObject(llvm::StringRef cacheDir, llvm::StringRef key,
+                       llvm::StringRef objectPath);
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
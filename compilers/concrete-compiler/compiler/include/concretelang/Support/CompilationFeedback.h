@@ -7,6 +7,7 @@
 #define CONCRETELANG_SUPPORT_COMPILATIONFEEDBACK_H_
 
 #include <cstddef>
+#include <optional>
 #include <vector>
 
 #include "boost/outcome.h"
@@ -67,6 +68,48 @@ struct CircuitCompilationFeedback {
   /// @brief memory usage per location
   std::map<std::string, std::optional<int64_t>> memoryUsagePerLoc;
 
+  /// @brief the number of bootstraps removed as duplicates of others
+  uint64_t removedPbsCount = 0;
+
+  /// @brief the number of keyswitches removed as duplicates of others
+  uint64_t removedKeySwitchCount = 0;
+
+  /// @brief the number of bootstraps saved by fusing chains of table lookups
+  uint64_t fusedPbsCount = 0;
+
+  /// @brief the peak memory usage of a call, in bytes: the arguments, the
+  /// live buffers, the server keys and the runtime scratch of a thread,
+  /// unknown if a loop has no static trip count
+  std::optional<int64_t> peakMemoryUsage;
+
+  /// @brief the bytes allocated for the buffers of a call
+  std::optional<int64_t> allocatedMemory;
+
+  /// @brief the bytes allocated for the buffers of a call, without the
+  /// reuse of the buffers
+  std::optional<int64_t> allocatedMemoryWithoutBufferReuse;
+
+  /// @brief the number of bootstraps on the critical path of the circuit,
+  /// unknown if a loop has no static trip count
+  std::optional<int64_t> pbsDepth;
+
+  /// @brief the average number of bootstraps which can run at the same time,
+  /// i.e. the bootstraps of the circuit divided by its PBS depth
+  std::optional<double> averagePbsParallelism;
+
+  /// @brief the number of bootstraps in loops with independent iterations, or
+  /// already batched, which can be batched with others
+  std::optional<int64_t> batchablePbsCount;
+
+  /// @brief the predicted latency of a call, in seconds, if the circuit was
+  /// compiled with a primitive cost table covering its primitives
+  std::optional<double> predictedLatency;
+
+  /// @brief the predicted number of calls per second, on all the cores of the
+  /// target, if the circuit was compiled with a primitive cost table covering
+  /// its primitives
+  std::optional<double> predictedThroughput;
+
   /// Fill the sizes from the program info.
   void fillFromCircuitInfo(concreteprotocol::CircuitInfo::Reader params);
 };
@@ -89,6 +132,9 @@ struct ProgramCompilationFeedback {
   /// @brief the total number of bytes of keyswitch keys
   uint64_t totalKeyswitchKeysSize;
 
+  /// @brief the bytes of the scratch buffers of the runtime, per thread
+  uint64_t runtimeScratchSize = 0;
+
   /// @brief the feedback for each circuit
   std::vector<CircuitCompilationFeedback> circuitFeedbacks;
 
@@ -0,0 +1,97 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_COMPILATIONPROFILE_H_
+#define CONCRETELANG_SUPPORT_COMPILATIONPROFILE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mlir/Pass/PassManager.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/JSON.h"
+
+namespace mlir {
+namespace concretelang {
+
+struct PassProfile {
+  /// @brief the name of the pass
+  std::string name;
+
+  /// @brief the seconds spent in the pass, summed over the operations it ran
+  /// on, possibly in parallel
+  double seconds;
+};
+
+struct StageProfile {
+  /// @brief the name of the stage, i.e. of its pipeline
+  std::string name;
+
+  /// @brief the wall-clock seconds spent in the stage
+  double seconds;
+
+  /// @brief the resident memory of the compiler at the end of the stage, in
+  /// bytes
+  uint64_t residentMemory;
+
+  /// @brief the peak resident memory of the compiler at the end of the stage,
+  /// in bytes, its growth over the previous stage being the stage's own peak
+  uint64_t peakResidentMemory;
+
+  /// @brief the passes of the stage, for the stages run as MLIR pipelines
+  std::vector<PassProfile> passes;
+};
+
+/// Time and memory spent by each stage of the compilation of a library, in
+/// the order they ran
+struct CompilationProfile {
+  std::vector<StageProfile> stages;
+};
+
+/// Sets the profile the compilation stages run by the current thread are
+/// recorded in, nullptr disabling the profiling.
+void setCurrentCompilationProfile(CompilationProfile *profile);
+
+/// Get the profile the compilation stages run by the current thread are
+/// recorded in, if any.
+CompilationProfile *getCurrentCompilationProfile();
+
+/// Records the passes run by `pm` as the stage `name` of the current
+/// compilation profile, if any.
+void profilePipeline(llvm::StringRef name, mlir::PassManager &pm);
+
+/// Records the stage `name` of the current compilation profile, if any, from
+/// the construction to the destruction of the scope. Used for the stages
+/// which are not MLIR pipelines.
+class ProfiledStage {
+public:
+  explicit ProfiledStage(llvm::StringRef name);
+  ~ProfiledStage();
+
+private:
+  CompilationProfile *profile;
+  std::string name;
+  std::chrono::steady_clock::time_point start;
+};
+
+/// Sets the current compilation profile to `profile` for the lifetime of the
+/// scope, restoring the previous one on destruction.
+class CompilationProfileScope {
+public:
+  explicit CompilationProfileScope(CompilationProfile *profile);
+  ~CompilationProfileScope();
+
+private:
+  CompilationProfile *previous;
+};
+
+llvm::json::Value toJSON(const mlir::concretelang::CompilationProfile &);
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
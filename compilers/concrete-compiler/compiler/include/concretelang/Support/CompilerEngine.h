@@ -10,7 +10,9 @@
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Protocol.h"
 #include "concretelang/Conversion/Utils/GlobalFHEContext.h"
+#include "concretelang/Support/CompilationProfile.h"
 #include "concretelang/Support/Encodings.h"
+#include "concretelang/Support/LLVMEmitFile.h"
 #include "concretelang/Support/ProgramInfoGeneration.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/MLIRContext.h"
@@ -68,14 +70,47 @@ struct CompilationOptions {
   /// Enable overflow detection during simulation
   bool enableOverflowDetectionInSimulation;
 
+  /// Add the noise of the operations during simulation. Without it, the
+  /// table lookups are exact and the keyswitches do nothing, to test the
+  /// functional behavior of the circuits quickly.
+  bool enableNoiseInSimulation;
+
   /// Parallelization options
   bool autoParallelize;
   bool loopParallelize;
   bool dataflowParallelize;
+  /// Minimum estimated work of a dataflow task, in leveled operations on a
+  /// ciphertext (a table lookup counts for 1000), smaller tasks are merged
+  /// with the next ones. 0 keeps one task per eligible operation.
+  int64_t dataflowMinTaskWork;
+  /// Maximum number of iterations of the loops with a static trip count
+  /// holding table lookups which are unrolled before building the dataflow
+  /// tasks, such that each iteration gets its own tasks. 0 disables the
+  /// unrolling.
+  int64_t dataflowUnrollFactor;
+  /// Sharing of the cores between the dataflow runtime workers and the
+  /// OpenMP threads of parallel loops: "default", "partition" (disjoint
+  /// sets of cores) or "shared" (a single pool of dataflow workers)
+  std::string dataflowThreadPolicy;
+  /// Number of dataflow runtime workers per node, 0 for the default of
+  /// the thread policy
+  int64_t dataflowThreads;
+  /// Run independent CPU table lookups concurrently on the async executor
+  bool asyncOffload;
 
   /// Compression options
   bool compressEvaluationKeys;
   bool compressInputCiphertexts;
+  /// Pack the ciphertext outputs in glwe ciphertexts, with a packing key
+  /// added to the keyset
+  bool compressOutputCiphertexts;
+  /// Store the fourier bootstrap keys of the server in single precision, the
+  /// optimizer accounting for the noise of the less precise transform
+  bool compactFourierBootstrapKeys;
+
+  /// Pass the tensor outputs of the circuits as caller-provided buffers to
+  /// write to, instead of returning them in buffers allocated by the circuit
+  bool destinationPassing;
 
   /// Optimizer options
   optimizer::Config optimizerConfig;
@@ -88,10 +123,75 @@ struct CompilationOptions {
   int64_t maxBatchSize;
   bool emitSDFGOps;
   bool unrollLoopsWithSDFGConvertibleOps;
+  /// Unroll the innermost loops around SDFG-convertible operations by at
+  /// most this factor instead of unrolling all the loops entirely, the
+  /// iterations left streaming their items through the same processes. 0
+  /// unrolls entirely.
+  unsigned sdfgLoopUnrollFactor;
   bool optimizeTFHE;
 
   std::optional<std::vector<int64_t>> fhelinalgTileSizes;
 
+  /// Tile the FHELinalg operations not tiled by `fhelinalgTileSizes` with
+  /// tile sizes selected from the number of cores, the minimum number of PBS
+  /// per tile and the maximum memory in bytes used by the tiles (0 for the
+  /// number of hardware threads, no minimum and no limit respectively)
+  bool fhelinalgAutoTiling;
+  int64_t fhelinalgAutoTilingCores;
+  int64_t fhelinalgAutoTilingMinPbs;
+  int64_t fhelinalgAutoTilingMaxMemory;
+
+  /// Lower the sums, dot products and matrix multiplications of FHELinalg to
+  /// trees of additions instead of sequential accumulations, exposing their
+  /// parallelism to the loop parallelization and the dataflow runtime
+  bool fhelinalgTreeReduction;
+
+  /// Lower the FHELinalg convolutions without groups to matrix
+  /// multiplications on the patches of their input (im2col)
+  bool fhelinalgIm2colConv2d;
+
+  /// Lower the FHELinalg maxpools to trees of maxima, shared between the
+  /// overlapping windows, instead of sequential maxima per window
+  bool fhelinalgMaxpool2dTree;
+
+  /// Compute the encrypted by encrypted matrix multiplications with table
+  /// lookups shared between the products of a same row or column, instead of
+  /// a double table lookup per product
+  bool fhelinalgMatMulSharedTLU;
+
+  /// Specializes the matrix multiplications by constant weights on the
+  /// values of the weights, skipping the zero weights, sharing the
+  /// multiplications by a same weight and replacing the multiplications by 1
+  /// and -1 with additions and subtractions
+  bool specializeConstantMatMul;
+
+  /// Fuses the chains of table lookups, through the additions, subtractions
+  /// and multiplications by constants between them, into single table
+  /// lookups. The number of bootstraps saved is reported per circuit in the
+  /// compilation feedback
+  bool fuseTLUChains;
+
+  /// When set, lowers the precision of the inputs of the table lookups to
+  /// the bits their values are proven to use, before choosing the crypto
+  /// parameters
+  bool narrowTLUInputs;
+
+  /// When non zero, removes the last bits of the roundings with a single
+  /// table lookup of at most roundTLUMaxPrecision bits, instead of one table
+  /// lookup per bit
+  unsigned int roundTLUMaxPrecision;
+
+  /// Chooses the maximum precision of the table lookups of the roundings,
+  /// or to round bit by bit, as the one lowering the most the complexity of
+  /// the parameters found by the optimizer
+  bool roundTLUByCost;
+
+  /// Fuses the trees of boolean gates depending on at most
+  /// booleanGateFusionMaxInputs booleans, 2 or 3, into single table lookups.
+  /// With 3 inputs, the fused lookups need 3 bits of precision.
+  bool fuseBooleanGates;
+  unsigned int booleanGateFusionMaxInputs;
+
   /// When decomposing big integers into chunks, chunkSize is the total number
   /// of bits used for the message, including the carry, while chunkWidth is
   /// only the number of bits used during encoding and decoding of a big integer
@@ -99,6 +199,21 @@ struct CompilationOptions {
   unsigned int chunkSize;
   unsigned int chunkWidth;
 
+  /// Compute the carries of the additions of chunked integers with a parallel
+  /// prefix instead of a ripple, trading more table lookups for a depth
+  /// logarithmic in the number of chunks
+  bool chunkCarryLookahead;
+
+  /// Decompose the big integers into chunks only if it lowers the complexity
+  /// of the parameters found by the optimizer, compared to their native or
+  /// crt encoding
+  bool chunkIntegersByCost;
+
+  /// Lowers the leveled operations on the blocks of the crt encoded integers
+  /// to single batched operations over the blocks, instead of loops of
+  /// operations on single blocks
+  bool batchCrtBlocks;
+
   /// When compiling from a dialect lower than FHE, one needs to provide
   /// encodings info manually to allow the client lib to be generated.
   std::optional<Message<concreteprotocol::ProgramEncodingInfo>> encodings;
@@ -108,15 +223,77 @@ struct CompilationOptions {
   bool enableTluFusing;
   bool printTluFusing;
 
+  /// Number of threads generating the code of the libraries in parallel, on
+  /// partitions of their LLVM modules, 0 for the number of hardware threads
+  unsigned int codegenThreads;
+
+  /// The cpu the code of the libraries is generated for: "host" for the cpu
+  /// and the features of the compiling machine, or a cpu name such as
+  /// "x86-64-v3" or "neoverse-n1" for its default features
+  std::string targetCpu;
+  /// When not empty, the x86-64 levels, from "x86-64" to "x86-64-v4", the
+  /// code of the libraries is generated for, instead of `targetCpu`, with
+  /// the circuits dispatching at runtime to the variant of the highest level
+  /// supported by the cpu running them
+  std::vector<std::string> targetCpuVariants;
+
+  /// Directory of the on-disk cache of the libraries compiled to an output
+  /// directory, keyed by the sources, the options, the build of the compiler
+  /// and the host cpu. The cache is disabled when empty
+  std::string compilationCacheDir;
+
+  /// Directory of the on-disk cache of the objects of the circuits of the
+  /// libraries, keyed by their LLVM IR and their target, such that a
+  /// recompilation only generates the code of the circuits which changed.
+  /// The cache is disabled when empty
+  std::string objectCacheDir;
+
+  /// Whether the time and the memory spent by each stage of the compilation
+  /// of the libraries, and by the passes of their pipelines, are reported in
+  /// a compilation_profile.json artifact
+  bool compilationProfile;
+
+  /// When set, the path of a primitive cost table the latency and the
+  /// throughput of the circuits are predicted from, on the device
+  /// `latencyTargetDevice` of the table, with `latencyTargetCores` cores
+  /// instead of the parallelism of the table when not 0
+  std::optional<std::string> latencyCostTable;
+  std::string latencyTargetDevice;
+  unsigned int latencyTargetCores;
+
+  /// Whether the buffers deallocated by the circuits are reused by their
+  /// next allocations of the same type, and the buffers of the iterations of
+  /// the sequential loops allocated once for all the iterations
+  bool reuseBuffers;
+
+  /// Path of the LLVM bitcode of the leveled wrappers of the runtime, which
+  /// is linked into the circuits before their optimization such that the
+  /// leveled operations are inlined and fused with the loops of the
+  /// circuits. The wrappers are called from the runtime library when empty
+  std::string runtimeBitcode;
+
+  /// The execution variants compiled into the libraries besides the default
+  /// code of the circuits, among "cpu" (sequential), "loop" (parallel
+  /// loops), "dataflow" (dataflow tasks) and "gpu" (GPU offloading), the
+  /// server running the variant it selects for its host. The variants share
+  /// the parameters of the default code, the gpu constraints of the
+  /// optimizer being used by all of them if one variant runs on GPU
+  std::vector<std::string> executionVariants;
+
   CompilationOptions()
       : v0FHEConstraints(std::nullopt), verifyDiagnostics(false),
         /// Simulate options
         simulate(false), enableOverflowDetectionInSimulation(false),
+        enableNoiseInSimulation(true),
         // Parallelization options
         autoParallelize(false), loopParallelize(true),
-        dataflowParallelize(false),
+        dataflowParallelize(false), dataflowMinTaskWork(0),
+        dataflowUnrollFactor(0), dataflowThreadPolicy("default"),
+        dataflowThreads(0), asyncOffload(false),
         /// Compression options
         compressEvaluationKeys(false), compressInputCiphertexts(false),
+        compressOutputCiphertexts(false), compactFourierBootstrapKeys(false),
+        destinationPassing(false),
         /// Optimizer options
         optimizerConfig(optimizer::DEFAULT_CONFIG),
         /// GPU
@@ -124,8 +301,23 @@ struct CompilationOptions {
         /// Other options
         batchTFHEOps(false), maxBatchSize(std::numeric_limits<int64_t>::max()),
         emitSDFGOps(false), unrollLoopsWithSDFGConvertibleOps(false),
-        optimizeTFHE(true), chunkIntegers(false), chunkSize(4), chunkWidth(2),
-        encodings(std::nullopt), enableTluFusing(true), printTluFusing(false){};
+        sdfgLoopUnrollFactor(0), optimizeTFHE(true), fhelinalgAutoTiling(false),
+        fhelinalgAutoTilingCores(0), fhelinalgAutoTilingMinPbs(0),
+        fhelinalgAutoTilingMaxMemory(0), fhelinalgTreeReduction(false),
+        fhelinalgIm2colConv2d(false), fhelinalgMaxpool2dTree(false),
+        fhelinalgMatMulSharedTLU(false), specializeConstantMatMul(false),
+        fuseTLUChains(false), narrowTLUInputs(false),
+        roundTLUMaxPrecision(0), roundTLUByCost(false),
+        fuseBooleanGates(false), booleanGateFusionMaxInputs(2),
+        chunkIntegers(false), chunkSize(4), chunkWidth(2),
+        chunkCarryLookahead(false), chunkIntegersByCost(false),
+        batchCrtBlocks(false),
+        encodings(std::nullopt), enableTluFusing(true),
+        printTluFusing(false), codegenThreads(1), targetCpu("host"),
+        compilationCacheDir(""), objectCacheDir(""),
+        compilationProfile(false), latencyCostTable(std::nullopt),
+        latencyTargetDevice("cpu"), latencyTargetCores(0),
+        reuseBuffers(false), runtimeBitcode(""), executionVariants(){};
 
   /// @brief Constructor for CompilationOptions with default parameters for a
   /// specific backend.
@@ -160,6 +352,8 @@ CompilationOptions getCurrentCompilationOptions();
 /// Print table lookup fusing.
 void printTluFusing(mlir::Value v1, mlir::Value v2, mlir::Value v1v2);
 
+class JITModule;
+
 class CompilerEngine {
 public:
   /// Result of an invocation of the `CompilerEngine` with optional
@@ -188,6 +382,7 @@ public:
     bool cleanUp;
     mlir::concretelang::ProgramCompilationFeedback compilationFeedback;
     std::optional<Message<concreteprotocol::ProgramInfo>> programInfo;
+    std::optional<mlir::concretelang::CompilationProfile> compilationProfile;
 
   public:
     /// Create a library instance on which you can add compilation results.
@@ -197,9 +392,11 @@ public:
             bool cleanUp = true)
         : outputDirPath(outputDirPath), runtimeLibraryPath(runtimeLibraryPath),
           cleanUp(cleanUp), programInfo() {}
-    /// Sets the compilation result used by the library
-    llvm::Expected<std::string>
-    setCompilationResult(CompilationResult &compilation);
+    /// Sets the compilation result used by the library, generating its code
+    /// with `codegen`, and returns the paths of its objects
+    llvm::Expected<std::vector<std::string>>
+    setCompilationResult(CompilationResult &compilation,
+                         const CodegenOptions &codegen = {});
     /// Emit the library artifacts with the previously added compilation result
     llvm::Error emitArtifacts(bool sharedLib, bool staticLib,
                               bool clientParameters, bool compilationFeedback);
@@ -226,6 +423,17 @@ public:
     /// Returns the path of the compilation feedback
     std::string getCompilationFeedbackPath() const;
 
+    /// Returns the path of the compilation profile
+    std::string getCompilationProfilePath() const;
+
+    /// Enables the profiling of the compilations of the library, the profile
+    /// being emitted with its artifacts
+    void enableCompilationProfile();
+
+    /// Returns the profile of the compilations of the library, or nullptr if
+    /// the profiling is not enabled
+    mlir::concretelang::CompilationProfile *getCompilationProfile();
+
     // For advanced use
     const static std::string OBJECT_EXT, LINKER, LINKER_SHARED_OPT, AR,
         AR_STATIC_OPT, DOT_STATIC_LIB_EXT, DOT_SHARED_LIB_EXT;
@@ -244,6 +452,15 @@ public:
     llvm::Expected<std::string> emitProgramInfoJSON();
     /// Emit a json CompilationFeedback corresponding to library content
     llvm::Expected<std::string> emitCompilationFeedbackJSON();
+    /// Emit a json CompilationProfile of the compilations of the library
+    llvm::Expected<std::string> emitCompilationProfileJSON();
+  };
+
+  /// A program compiled in memory, to be loaded by a `ServerProgram` from
+  /// its module instead of a shared library
+  struct JITProgram {
+    Message<concreteprotocol::ProgramInfo> programInfo;
+    std::shared_ptr<JITModule> module;
   };
 
   /// Specification of the exit stage of the compilation pipeline
@@ -319,7 +536,7 @@ public:
       : overrideMaxEintPrecision(), overrideMaxMANP(), compilerOptions(),
         generateProgramInfo(true),
         enablePass([](mlir::Pass *pass) { return true; }),
-        compilationContext(compilationContext) {}
+        customEnablePass(false), compilationContext(compilationContext) {}
 
   llvm::Expected<CompilationResult>
   compile(llvm::StringRef s, Target target,
@@ -357,6 +574,13 @@ public:
           bool generateStaticLib = true, bool generateClientParameters = true,
           bool generateCompilationFeedback = true);
 
+  /// Compiles the sources of `sm` in memory with a JIT, without emitting a
+  /// library, each function of the circuits being only compiled on its first
+  /// call. The runtime functions are resolved in `runtimeLibraryPath`, if
+  /// any, or else in the current process.
+  llvm::Expected<JITProgram> compileJIT(llvm::SourceMgr &sm,
+                                        std::string runtimeLibraryPath = "");
+
   void setCompilationOptions(CompilationOptions options) {
     setCurrentCompilationOptions(options);
     compilerOptions = std::move(options);
@@ -373,19 +597,40 @@ public:
   void setGenerateProgramInfo(bool v);
   void setEnablePass(std::function<bool(mlir::Pass *)> enablePass);
 
+  /// Returns the key of the compilation cache of `sources` compiled by this
+  /// engine to a library linked to `runtimeLibraryPath`, or nothing if the
+  /// compilation cannot be cached.
+  std::optional<std::string>
+  getCompilationCacheKey(llvm::ArrayRef<std::string> sources,
+                         llvm::StringRef runtimeLibraryPath);
+
 protected:
   std::optional<size_t> overrideMaxEintPrecision;
   std::optional<size_t> overrideMaxMANP;
   CompilationOptions compilerOptions;
   bool generateProgramInfo;
   std::function<bool(mlir::Pass *)> enablePass;
+  /// Whether `enablePass` was set, the selected passes being then unknown
+  bool customEnablePass;
 
   std::shared_ptr<CompilationContext> compilationContext;
 
 private:
+  /// The suffix of the symbols of the execution variant being compiled,
+  /// empty when compiling the default code
+  std::string symbolSuffix;
+  /// Whether the execution variants of a library are being compiled
+  bool compilingVariants = false;
+
+  /// Compiles `module` into `lib` with the options of each of its execution
+  /// variants, then with the default options, and records the variants in
+  /// the program info of the library
+  llvm::Expected<CompilationResult>
+  compileExecutionVariants(mlir::ModuleOp module, std::shared_ptr<Library> lib);
   llvm::Expected<std::optional<optimizer::Description>>
   getConcreteOptimizerDescription(CompilationResult &res);
   llvm::Error determineFHEParameters(CompilationResult &res);
+  double getOptimizedComplexity(mlir::ModuleOp module);
   mlir::LogicalResult
   materializeOptimizerPartitionFrontiers(CompilationResult &res);
 };
@@ -0,0 +1,51 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_JITMODULE_H
+#define CONCRETELANG_SUPPORT_JITMODULE_H
+
+#include <memory>
+#include <string>
+
+#include "concretelang/ServerLib/ServerLib.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+
+namespace mlir {
+namespace concretelang {
+
+/// A dynamic module holding the code of the circuits of a program compiled
+/// in memory by an ORC JIT, instead of linked to a shared library. Each
+/// function is only compiled on its first call, and the module can be loaded
+/// as any other by a `ServerProgram`.
+///
+/// The code is generated for the host cpu. The circuits cannot be
+/// distributed by the dataflow runtime, which loads them from a shared
+/// library on the remote nodes.
+class JITModule : public ::concretelang::serverlib::DynamicModule {
+public:
+  ~JITModule() override;
+
+  /// Creates the module of the circuits of `module`, which is copied such
+  /// that it can be released, and whose external symbols are resolved in
+  /// the runtime library `runtimeLibraryPath`, if any, and in the current
+  /// process.
+  static llvm::Expected<std::shared_ptr<JITModule>>
+  create(const llvm::Module &module, const std::string &runtimeLibraryPath);
+
+  /// Returns the address of the symbol `name`, compiling it if needed.
+  Result<void *> lookup(const std::string &name) override;
+
+private:
+  JITModule() = default;
+
+  std::unique_ptr<llvm::orc::LLLazyJIT> jit;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
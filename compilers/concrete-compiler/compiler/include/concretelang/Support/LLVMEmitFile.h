@@ -7,11 +7,51 @@
 #define CONCRETELANG_SUPPORT_LLVMEMITFILE
 
 #include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace mlir {
 namespace concretelang {
 
-llvm::Error emitObject(llvm::Module &module, std::string objectPath);
+/// Options of the generation of the objects of a module
+struct CodegenOptions {
+  /// Number of threads generating the code in parallel, on partitions of the
+  /// module
+  unsigned int threads = 1;
+  /// The cpu the code is generated for, "host" for the cpu and the features
+  /// of the current machine
+  std::string cpu = "host";
+  /// When not empty, the x86-64 levels, from "x86-64" to "x86-64-v4", the
+  /// code is generated for, instead of `cpu`. The exported functions then
+  /// dispatch to the variant of the highest level supported by the cpu
+  /// running them.
+  std::vector<std::string> cpuVariants;
+  /// When not empty, the directory caching the object of each circuit of
+  /// the module, keyed by its IR and its target, the objects of the
+  /// unchanged circuits being reused instead of generated again
+  std::string cacheDir;
+  /// The suffix of the exported symbols of the module, which tells the code
+  /// of an execution variant of the circuits from their default code linked
+  /// in the same library
+  std::string symbolSuffix;
+};
+
+/// Wraps the functions of `module` into interface functions taking their
+/// arguments and results as a single array of pointers, named after
+/// `makePackedFunctionName`, which are the symbols called by the server.
+/// The exported symbols are suffixed by `symbolSuffix`.
+void packFunctionArguments(llvm::Module *module,
+                           llvm::StringRef symbolSuffix = "");
+
+/// Emits the object files of `module` and returns their paths. With more
+/// than one thread, several cpu variants or a cache directory, the objects
+/// are named after `objectPath`.
+llvm::Expected<std::vector<std::string>>
+emitObjects(llvm::Module &module, std::string objectPath,
+            const CodegenOptions &options = {});
 
 llvm::Error callCmd(std::string cmd);
 
@@ -0,0 +1,83 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_SUPPORT_LATENCYMODEL_H_
+#define CONCRETELANG_SUPPORT_LATENCYMODEL_H_
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "boost/outcome.h"
+#include "concretelang/Common/Error.h"
+
+namespace mlir {
+namespace concretelang {
+
+using StringError = ::concretelang::error::StringError;
+
+// The work of the primitives, in the units the costs of the primitive cost
+// tables are calibrated in, such that the latency of a primitive is its work
+// times the cost of its kind.
+
+/// The work of a bootstrap of a ciphertext of dimension `inputLweDimension`,
+/// i.e. of its external products by FFT.
+inline double bootstrapWork(uint64_t inputLweDimension, uint64_t levels,
+                            uint64_t glweDimension, uint64_t polynomialSize) {
+  double glweSize = glweDimension + 1;
+  return (double)inputLweDimension * levels * glweSize * glweSize *
+         polynomialSize * std::log2((double)polynomialSize);
+}
+
+/// The work of a keyswitch.
+inline double keyswitchWork(uint64_t inputLweDimension, uint64_t levels,
+                            uint64_t outputLweDimension) {
+  return (double)inputLweDimension * levels * (outputLweDimension + 1);
+}
+
+/// The work of a leveled operation on a ciphertext of dimension `lweDimension`.
+inline double leveledWork(uint64_t lweDimension) {
+  return (double)lweDimension + 1;
+}
+
+/// The costs of the primitives on a device, in nanoseconds per unit of work,
+/// as measured by `concrete.compiler.latency_calibration`. A primitive without
+/// cost cannot be predicted.
+struct PrimitiveCostTable {
+  /// The number of primitives the device runs at the same time, e.g. its
+  /// cores, or 1 for a GPU whose cost is that of the batched kernels
+  unsigned int parallelism = 1;
+
+  std::optional<double> bootstrap;
+  std::optional<double> keyswitch;
+  /// The cost of a wop_pbs per unit of work of a bootstrap with its key
+  std::optional<double> wopPbs;
+  std::optional<double> leveled;
+
+  /// Loads the costs of `device` from a JSON file mapping the names of the
+  /// devices, e.g. "cpu" or a GPU model, to their costs.
+  static outcome::checked<PrimitiveCostTable, StringError>
+  load(std::string path, std::string device);
+};
+
+/// How the latency of the circuits is predicted from the costs of their
+/// primitives.
+struct LatencyModel {
+  PrimitiveCostTable costs;
+
+  /// Whether the operations of a block without dependencies between them run
+  /// in parallel, i.e. with the dataflow parallelization
+  bool overlapOperations = false;
+
+  /// Whether the iterations of the loops run in parallel, i.e. with the loop
+  /// parallelization or the batching of the operations
+  bool parallelLoops = false;
+};
+
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -6,18 +6,28 @@
 #ifndef CONCRETELANG_SUPPORT_PIPELINE_H_
 #define CONCRETELANG_SUPPORT_PIPELINE_H_
 
+#include "concretelang/Support/LatencyModel.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "mlir/Dialect/LLVMIR/LLVMTypes.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Transforms/Passes.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+
+#include <map>
+#include <string>
 
 namespace mlir {
 namespace concretelang {
+struct TFHEDeduplicationCounts;
+struct AutoTilingParameters;
+
 namespace pipeline {
 
 mlir::LogicalResult autopar(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                            std::function<bool(mlir::Pass *)> enablePass);
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            int64_t minTaskWork = 0,
+                            int64_t unrollFactor = 0);
 
 mlir::LogicalResult materializeOptimizerPartitionFrontiers(
     mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -36,13 +46,42 @@ markFHELinalgForTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
                        llvm::ArrayRef<int64_t> tileSizes,
                        std::function<bool(mlir::Pass *)> enablePass);
 
+mlir::LogicalResult
+markFHELinalgForAutoTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                           AutoTilingParameters parameters,
+                           std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+shareEncryptedMatMulTLUs(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                         std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+specializeConstantMatMul(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                         std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+fuseLookupTableChains(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass,
+                      std::map<std::string, uint64_t> &counts);
+
+mlir::LogicalResult
+narrowLookupTableInputs(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                        std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+roundWithLookupTables(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass,
+                      unsigned maxPrecision);
+
 mlir::LogicalResult
 transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
                          std::function<bool(mlir::Pass *)> enablePass);
 
 mlir::LogicalResult
 lowerFHELinalgToLinalg(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                       std::function<bool(mlir::Pass *)> enablePass);
+                       std::function<bool(mlir::Pass *)> enablePass,
+                       bool treeReduction = false, bool im2colConv2d = false,
+                       bool maxpool2dTree = false);
 
 mlir::LogicalResult
 tileMarkedLinalg(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -55,17 +94,20 @@ lowerLinalgToLoops(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 transformFHEBoolean(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass);
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    bool fuseGates = false, unsigned int fusionMaxInputs = 2);
 
 mlir::LogicalResult
 transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
                    std::function<bool(mlir::Pass *)> enablePass,
-                   unsigned int chunkSize, unsigned int chunkWidth);
+                   unsigned int chunkSize, unsigned int chunkWidth,
+                   bool carryLookahead = false);
 
 mlir::LogicalResult
 lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                std::optional<V0FHEContext> &fheContext,
-               std::function<bool(mlir::Pass *)> enablePass);
+               std::function<bool(mlir::Pass *)> enablePass,
+               bool batchCrtBlocks = false);
 
 mlir::LogicalResult
 parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -75,7 +117,7 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult batchTFHE(mlir::MLIRContext &context,
                               mlir::ModuleOp &module,
                               std::function<bool(mlir::Pass *)> enablePass,
-                              int64_t maxBatchSize);
+                              int64_t maxBatchSize, bool batchWopPBS = false);
 
 mlir::LogicalResult
 normalizeTFHEKeys(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -86,6 +128,11 @@ extractTFHEStatistics(mlir::MLIRContext &context, mlir::ModuleOp &module,
                       std::function<bool(mlir::Pass *)> enablePass,
                       ProgramCompilationFeedback &feedback);
 
+mlir::LogicalResult
+predictTFHELatency(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                   std::function<bool(mlir::Pass *)> enablePass,
+                   ProgramCompilationFeedback &feedback, LatencyModel model);
+
 mlir::LogicalResult
 lowerTFHEToConcrete(mlir::MLIRContext &context, mlir::ModuleOp &module,
                     std::function<bool(mlir::Pass *)> enablePass);
@@ -95,6 +142,15 @@ computeMemoryUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
                    std::function<bool(mlir::Pass *)> enablePass,
                    ProgramCompilationFeedback &feedback);
 
+mlir::LogicalResult reuseBuffers(mlir::MLIRContext &context,
+                                 mlir::ModuleOp &module,
+                                 std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+computeBufferUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                   std::function<bool(mlir::Pass *)> enablePass,
+                   ProgramCompilationFeedback &feedback);
+
 mlir::LogicalResult
 lowerConcreteLinalgToLoops(mlir::MLIRContext &context, mlir::ModuleOp &module,
                            std::function<bool(mlir::Pass *)> enablePass,
@@ -104,20 +160,28 @@ mlir::LogicalResult optimizeTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::function<bool(mlir::Pass *)> enablePass);
 
+mlir::LogicalResult
+deduplicateTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                std::function<bool(mlir::Pass *)> enablePass,
+                std::map<std::string, TFHEDeduplicationCounts> &counts);
+
 mlir::LogicalResult
 transformTFHEOperations(mlir::MLIRContext &context, mlir::ModuleOp &module,
                         std::function<bool(mlir::Pass *)> enablePass);
 
+/// Lowers the TFHE operations to their simulation. `pError` is the
+/// probability of error per bootstrap the parameters were optimized for.
 mlir::LogicalResult simulateTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::optional<V0FHEContext> &fheContext,
-                                 bool enableOverflowDetection,
+                                 bool enableOverflowDetection, bool enableNoise,
+                                 double pError,
                                  std::function<bool(mlir::Pass *)> enablePass);
 
 mlir::LogicalResult extractSDFGOps(mlir::MLIRContext &context,
                                    mlir::ModuleOp &module,
                                    std::function<bool(mlir::Pass *)> enablePass,
-                                   bool unrollLoops);
+                                   bool unrollLoops, unsigned unrollFactor);
 
 mlir::LogicalResult
 addRuntimeContext(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -134,16 +198,22 @@ lowerStdToLLVMDialect(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
                                mlir::ModuleOp &module,
                                std::function<bool(mlir::Pass *)> enablePass,
-                               bool parallelizeLoops);
+                               bool parallelizeLoops, bool destinationPassing);
 
 mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
                                 mlir::ModuleOp &module,
                                 std::function<bool(mlir::Pass *)> enablePass,
-                                bool gpu);
+                                bool gpu, bool asyncOffload);
 
 mlir::LogicalResult optimizeLLVMModule(llvm::LLVMContext &llvmContext,
                                        llvm::Module &module);
 
+/// Links the functions of the LLVM bitcode at `path` called by `module` into
+/// it, as internal functions taking the target of the module, so that they
+/// are inlined by its optimization.
+llvm::Error linkRuntimeBitcode(llvm::LLVMContext &llvmContext,
+                               llvm::Module &module, llvm::StringRef path);
+
 std::unique_ptr<llvm::Module>
 lowerLLVMDialectToLLVMIR(mlir::MLIRContext &context,
                          llvm::LLVMContext &llvmContext,
@@ -23,7 +23,8 @@ llvm::Expected<Message<concreteprotocol::ProgramInfo>>
 createProgramInfoFromTfheDialect(
     mlir::ModuleOp module, int bitsOfSecurity,
     const Message<concreteprotocol::ProgramEncodingInfo> &encodings,
-    bool compressEvaluationKeys, bool compressInputCiphertexts);
+    bool compressEvaluationKeys, bool compressInputCiphertexts,
+    bool compressOutputCiphertexts, double pError, uint32_t fourierPrecision);
 
 } // namespace concretelang
 } // namespace mlir
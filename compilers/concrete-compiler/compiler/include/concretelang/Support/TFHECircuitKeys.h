@@ -29,7 +29,9 @@ struct TFHECircuitKeys {
 
 llvm::raw_ostream &operator<<(llvm::raw_ostream &OS, const TFHECircuitKeys cks);
 
-TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp);
+/// Gathers the keys used by the operations nested in `root`, e.g. a module
+/// or a function.
+TFHECircuitKeys extractCircuitKeys(mlir::Operation *root);
 
 } // namespace TFHE
 } // namespace concretelang
@@ -6,9 +6,14 @@
 #ifndef CONCRETELANG_SUPPORT_V0Parameter_H_
 #define CONCRETELANG_SUPPORT_V0Parameter_H_
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <optional>
+#include <set>
+#include <string>
 #include <variant>
+#include <vector>
 
 #include "llvm/ADT/Optional.h"
 
@@ -82,6 +87,9 @@ const concrete_optimizer::Encoding DEFAULT_ENCODING =
 const bool DEFAULT_CACHE_ON_DISK = true;
 const uint32_t DEFAULT_CIPHERTEXT_MODULUS_LOG = 64;
 const uint32_t DEFAULT_FFT_PRECISION = 53;
+/// The bits of mantissa of the fourier bootstrap keys stored in single
+/// precision
+const uint32_t COMPACT_FOURIER_PRECISION = 24;
 const std::shared_ptr<concrete_optimizer::restriction::RangeRestriction>
     DEFAULT_RANGE_RESTRICTION = {};
 const std::shared_ptr<concrete_optimizer::restriction::KeysetRestriction>
@@ -115,6 +123,19 @@ struct CompositionRule {
 
 const std::vector<CompositionRule> DEFAULT_COMPOSITION_RULES = {};
 const bool DEFAULT_COMPOSABLE = false;
+const std::string DEFAULT_SOLUTION_CACHE_DIR = "";
+const std::vector<std::string> DEFAULT_SHARED_SOLUTION_CACHE_DIRS = {};
+const uint32_t DEFAULT_NB_THREADS = 1;
+const concrete_optimizer::CostModel DEFAULT_COST_MODEL =
+    concrete_optimizer::CostModel::Auto;
+const uint32_t DEFAULT_GPU_NUMBER_OF_SM = 1;
+const double DEFAULT_COST_FACTOR = 0.;
+const double DEFAULT_KEY_SIZE_WEIGHT = 0.;
+const double DEFAULT_KEY_REUSE_THRESHOLD = 0.;
+const bool DEFAULT_ALLOW_PBS_KS_ORDER = false;
+const uint32_t DEFAULT_MANY_LUT_MAX_COUNT = 1;
+/// The largest grouping factor of the multi-bit bootstrap of the CUDA backend
+const uint32_t DEFAULT_MAX_GROUPING_FACTOR = 4;
 
 struct Config {
   double p_error;
@@ -136,6 +157,43 @@ struct Config {
       keyset_restriction;
   std::vector<CompositionRule> composition_rules;
   bool composable;
+  /// The directory where the solutions are cached, an empty path disabling
+  /// the cache
+  std::string solution_cache_dir;
+  /// The directories where the solutions are looked up after
+  /// `solution_cache_dir`, without ever being written, e.g. a pre-warmed
+  /// cache shared between machines
+  std::vector<std::string> shared_solution_cache_dirs;
+  /// The number of threads of the search of the dag-multi parameters, 0 for
+  /// all the available threads
+  uint32_t nb_threads;
+  /// The cost model minimized by the search of the parameters, `Auto` using
+  /// the gpu one when compiling for gpu
+  concrete_optimizer::CostModel cost_model;
+  /// The number of streaming multiprocessors of the gpu cost models
+  uint32_t gpu_number_of_sm;
+  /// The measured times of a keyswitch and a bootstrap per unit of complexity
+  /// of the cost model on the target, 0 keeping the cost model unscaled
+  double ks_cost_factor;
+  double pbs_cost_factor;
+  /// The complexity added per byte of bootstrap and keyswitch keys, trading
+  /// some complexity for smaller keysets, 0 ignoring the key sizes
+  double key_size_weight;
+  /// The relative complexity increase accepted by the dag-multi optimizer to
+  /// merge two partitions, sharing their keys between all the circuits of the
+  /// program, 0 only merging when it does not cost anything
+  double key_reuse_threshold;
+  /// Whether the dag-multi optimizer may choose to bootstrap and then
+  /// keyswitch in a partition, its levelled operations then using the small
+  /// key
+  bool allow_pbs_ks_order;
+  /// The maximum number of lookup tables of the same input evaluated by a
+  /// single many-LUT bootstrap, 1 evaluating each one with its own bootstrap
+  uint32_t many_lut_max_count;
+  /// The largest grouping factor of the multi-bit bootstraps the dag-multi
+  /// optimizer may use in place of the classic ones on GPU, 0 or 1 keeping
+  /// the classic bootstraps
+  uint32_t max_grouping_factor;
 };
 
 const Config DEFAULT_CONFIG = {UNSPECIFIED_P_ERROR,
@@ -154,7 +212,19 @@ const Config DEFAULT_CONFIG = {UNSPECIFIED_P_ERROR,
                                DEFAULT_RANGE_RESTRICTION,
                                DEFAULT_KEYSET_RESTRICTION,
                                DEFAULT_COMPOSITION_RULES,
-                               DEFAULT_COMPOSABLE};
+                               DEFAULT_COMPOSABLE,
+                               DEFAULT_SOLUTION_CACHE_DIR,
+                               DEFAULT_SHARED_SOLUTION_CACHE_DIRS,
+                               DEFAULT_NB_THREADS,
+                               DEFAULT_COST_MODEL,
+                               DEFAULT_GPU_NUMBER_OF_SM,
+                               DEFAULT_COST_FACTOR,
+                               DEFAULT_COST_FACTOR,
+                               DEFAULT_KEY_SIZE_WEIGHT,
+                               DEFAULT_KEY_REUSE_THRESHOLD,
+                               DEFAULT_ALLOW_PBS_KS_ORDER,
+                               DEFAULT_MANY_LUT_MAX_COUNT,
+                               DEFAULT_MAX_GROUPING_FACTOR};
 
 using Dag = rust::Box<concrete_optimizer::Dag>;
 using DagBuilder = rust::Box<concrete_optimizer::DagBuilder>;
@@ -193,6 +263,25 @@ getCrtDecompositionFromSolution(optimizer::Solution solution) {
   return std::nullopt;
 }
 
+/// Returns the size in bytes of the largest ciphertext of an encrypted
+/// integer using the parameters of `solution`.
+inline size_t getCiphertextSizeFromSolution(optimizer::Solution solution) {
+  size_t lweDimension = 0;
+  if (auto mono = std::get_if<V0Parameter>(&solution); mono != nullptr) {
+    lweDimension = mono->getNBigLweDimension();
+  } else {
+    auto &circuit = std::get<CircuitSolution>(solution);
+    for (auto &key : circuit.circuit_keys.secret_keys)
+      lweDimension =
+          std::max(lweDimension, (size_t)(key.glwe_dimension *
+                                          key.polynomial_size));
+  }
+  size_t size = (lweDimension + 1) * sizeof(uint64_t);
+  if (auto crt = getCrtDecompositionFromSolution(solution); crt.has_value())
+    size *= crt->size();
+  return size;
+}
+
 // Temporary function for hack FHEToScalar
 // TODO: Remove this function
 inline size_t getPolynomialSizeFromSolution(optimizer::Solution solution) {
@@ -202,6 +291,39 @@ inline size_t getPolynomialSizeFromSolution(optimizer::Solution solution) {
   return 42;
 }
 
+/// Returns the error probability of a bootstrap of the circuits compiled with
+/// `solution`, found for `config`.
+inline double getPErrorFromSolution(optimizer::Solution solution,
+                                    optimizer::Config config) {
+  if (auto circuit = std::get_if<CircuitSolution>(&solution))
+    return circuit->p_error;
+  if (!std::isnan(config.p_error))
+    return config.p_error;
+  if (!std::isnan(config.global_p_error))
+    return config.global_p_error;
+  return optimizer::DEFAULT_GLOBAL_P_ERROR;
+}
+
+/// Returns the optimizer ids of the lookup tables of `solution` that bootstrap
+/// and then keyswitch, i.e. whose input key is the input key of their
+/// bootstrap key.
+inline std::set<int32_t>
+getPbsKsLookupTablesFromSolution(optimizer::Solution solution) {
+  std::set<int32_t> lookupTables;
+  auto circuit = std::get_if<CircuitSolution>(&solution);
+  if (circuit == nullptr)
+    return lookupTables;
+  auto &bootstrapKeys = circuit->circuit_keys.bootstrap_keys;
+  for (size_t oid = 0; oid < circuit->instructions_keys.size(); oid++) {
+    auto &keys = circuit->instructions_keys[oid];
+    if (keys.tlu_bootstrap_key < bootstrapKeys.size() &&
+        keys.input_key ==
+            bootstrapKeys[keys.tlu_bootstrap_key].input_key.identifier)
+      lookupTables.insert(oid);
+  }
+  return lookupTables;
+}
+
 concrete_optimizer::Options options_from_config(optimizer::Config config);
 
 } // namespace concretelang
@@ -146,9 +146,16 @@ public:
       OUTCOME_TRY(auto preparedInput, clientCircuit.prepareInput(inputs[i], i));
       preparedArgs.push_back(preparedInput);
     }
-    // Call server multiple times in a row
-    for (size_t i = 0; i < n; i++) {
-      OUTCOME_TRY(preparedArgs, callServer(preparedArgs, name));
+    // Call server multiple times in a row, the intermediate values staying
+    // on the server
+    OUTCOME_TRY(auto serverCircuit, getServerCircuit(name));
+    if (compiler.getCompilationOptions().simulate) {
+      ServerKeyset emptyKeyset;
+      OUTCOME_TRY(preparedArgs,
+                  serverCircuit.callRepeated(emptyKeyset, preparedArgs, n));
+    } else {
+      OUTCOME_TRY(preparedArgs,
+                  serverCircuit.callRepeated(keyset->server, preparedArgs, n));
     }
     // postprocess arguments
     std::vector<Value> processedOutputs(preparedArgs.size());
@@ -203,6 +210,35 @@ public:
 
   bool isSimulation() { return compiler.getCompilationOptions().simulate; }
 
+  Result<Keyset> getKeyset() {
+    if (!keyset.has_value()) {
+      return StringError("TestProgram: keyset has not been generated\n");
+    }
+    return *keyset;
+  }
+
+  Result<Message<concreteprotocol::ProgramInfo>> getProgramInfo() {
+    OUTCOME_TRY(auto lib, getLibrary());
+    return lib.getProgramInfo();
+  }
+
+  /// Returns the path of the shared library of the compiled program, e.g. to
+  /// load it with other options than `getServerCircuit`.
+  Result<std::string> getSharedLibraryPath() {
+    OUTCOME_TRY(auto lib, getLibrary());
+    return lib.getSharedLibraryPath();
+  }
+
+  /// Returns the csprng used to encrypt the inputs of the client circuits.
+  std::shared_ptr<csprng::EncryptionCSPRNG> getEncryptionCsprng() {
+    return encryptionCsprng;
+  }
+
+  /// Sets the csprng used to encrypt the inputs of the next client circuits.
+  void setEncryptionCsprng(std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
+    encryptionCsprng = csprng;
+  }
+
 private:
   std::string getArtifactDirectory() { return artifactDirectory; }
 
@@ -213,13 +249,6 @@ private:
     return *library;
   }
 
-  Result<Keyset> getKeyset() {
-    if (!keyset.has_value()) {
-      return StringError("TestProgram: keyset has not been generated\n");
-    }
-    return *keyset;
-  }
-
   std::string artifactDirectory;
   mlir::concretelang::CompilerEngine compiler;
   std::optional<mlir::concretelang::CompilerEngine::Library> library;
@@ -6,9 +6,11 @@
 #ifndef CONCRETELANG_TRANSFORMS_PASS_H
 #define CONCRETELANG_TRANSFORMS_PASS_H
 
+#include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/Linalg/IR/Linalg.h>
 #include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/OpenMP/OpenMPDialect.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
 #include <mlir/Pass/Pass.h>
 
@@ -22,9 +24,14 @@ std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 createCollapseParallelLoops();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createForLoopToParallel();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
-createBatchingPass(int64_t maxBatchSize = std::numeric_limits<int64_t>::max());
+createOpenMPSchedulePass();
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createBatchingPass(int64_t maxBatchSize = std::numeric_limits<int64_t>::max(),
+                   bool batchWopPBS = false);
 std::unique_ptr<OperationPass<ModuleOp>> createSCFForallToSCFForPass();
 std::unique_ptr<OperationPass<ModuleOp>> createLinalgFillToLinalgGenericPass();
+std::unique_ptr<OperationPass<ModuleOp>> createBufferReusePass();
+std::unique_ptr<OperationPass<ModuleOp>> createFuseLinalgCopiesPass();
 } // namespace concretelang
 } // namespace mlir
 
@@ -16,6 +16,8 @@
 #include "concretelang/ServerLib/ServerLib.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "concretelang/Support/Error.h"
+#include "concretelang/Support/JITModule.h"
+#include "concretelang/Support/LatencyModel.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "concretelang/Support/logging.h"
 #include <filesystem>
@@ -39,6 +41,8 @@ using concretelang::clientlib::ClientProgram;
 using concretelang::keysets::Keyset;
 using concretelang::keysets::KeysetCache;
 using concretelang::keysets::ServerKeyset;
+using concretelang::serverlib::CallBatcher;
+using concretelang::serverlib::CallGraph;
 using concretelang::serverlib::ServerCircuit;
 using concretelang::serverlib::ServerProgram;
 using concretelang::values::TransportValue;
@@ -136,65 +140,43 @@ std::string roundTrip(const char *module) {
   return os.str();
 }
 
+/// Returns `input` with elements of type `T`. The values are only converted if
+/// they have another type, e.g. the values of a numpy array of the type of the
+/// gate are passed through as they are.
+template <typename T> Value castElements(Value input) {
+  if (input.hasElementType<T>())
+    return input;
+  return std::visit(
+      [](auto &tensor) -> Value { return Value{(Tensor<T>)tensor}; },
+      input.inner);
+}
+
 // Every number sent by python through the API has a type `int64` that must be
 // turned into the proper type expected by the ArgTransformers. This allows to
 // get an extra transformer executed right before the ArgTransformer gets
 // called.
 std::function<Value(Value)>
 getPythonTypeTransformer(const Message<concreteprotocol::GateInfo> &info) {
-  if (info.asReader().getTypeInfo().hasIndex()) {
-    return [=](Value input) {
-      Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-      return Value{(Tensor<uint64_t>)tensorInput};
-    };
-  } else if (info.asReader().getTypeInfo().hasPlaintext()) {
-    if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
-        8) {
-      return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint8_t>)tensorInput};
-      };
-    }
-    if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
-        16) {
-      return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint16_t>)tensorInput};
-      };
-    }
-    if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
-        32) {
-      return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint32_t>)tensorInput};
-      };
-    }
-    if (info.asReader().getTypeInfo().getPlaintext().getIntegerPrecision() <=
-        64) {
-      return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint64_t>)tensorInput};
-      };
-    }
+  auto typeInfo = info.asReader().getTypeInfo();
+  if (typeInfo.hasIndex()) {
+    return castElements<uint64_t>;
+  } else if (typeInfo.hasPlaintext()) {
+    auto precision = typeInfo.getPlaintext().getIntegerPrecision();
+    if (precision <= 8)
+      return castElements<uint8_t>;
+    if (precision <= 16)
+      return castElements<uint16_t>;
+    if (precision <= 32)
+      return castElements<uint32_t>;
+    if (precision <= 64)
+      return castElements<uint64_t>;
     assert(false);
-  } else if (info.asReader().getTypeInfo().hasLweCiphertext()) {
-    if (info.asReader()
-            .getTypeInfo()
-            .getLweCiphertext()
-            .getEncoding()
-            .hasInteger() &&
-        info.asReader()
-            .getTypeInfo()
-            .getLweCiphertext()
-            .getEncoding()
-            .getInteger()
-            .getIsSigned()) {
+  } else if (typeInfo.hasLweCiphertext()) {
+    auto encoding = typeInfo.getLweCiphertext().getEncoding();
+    if (encoding.hasInteger() && encoding.getInteger().getIsSigned()) {
       return [=](Value input) { return input; };
     } else {
-      return [=](Value input) {
-        Tensor<int64_t> tensorInput = input.getTensor<int64_t>().value();
-        return Value{(Tensor<uint64_t>)tensorInput};
-      };
+      return castElements<uint64_t>;
     }
   } else {
     assert(false);
@@ -202,8 +184,13 @@ getPythonTypeTransformer(const Message<concreteprotocol::GateInfo> &info) {
 };
 
 template <typename T> Tensor<T> arrayToTensor(pybind11::array &input) {
-  auto data_ptr = (const T *)input.data();
-  std::vector<T> data = std::vector(data_ptr, data_ptr + input.size());
+  // The values are copied at once, after a strided array is made contiguous
+  auto contiguous =
+      pybind11::array_t<T, pybind11::array::c_style>::ensure(input);
+  if (!contiguous)
+    throw pybind11::error_already_set();
+  auto data_ptr = contiguous.data();
+  std::vector<T> data = std::vector(data_ptr, data_ptr + contiguous.size());
   auto dims = std::vector<size_t>(input.ndim(), 0);
   for (ssize_t i = 0; i < input.ndim(); i++) {
     dims[i] = input.shape(i);
@@ -212,8 +199,43 @@ template <typename T> Tensor<T> arrayToTensor(pybind11::array &input) {
 }
 
 template <typename T> pybind11::array tensorToArray(Tensor<T> input) {
-  return pybind11::array(pybind11::array::ShapeContainer(input.dimensions),
-                         input.values.data());
+  // The array takes over the values of the tensor instead of copying them,
+  // unless they are shared with another tensor the array could modify
+  auto values = new std::vector<T>(std::move(input.values).toVector());
+  pybind11::capsule owner(
+      values, [](void *values) { delete (std::vector<T> *)values; });
+  return pybind11::array_t<T>(
+      pybind11::array::ShapeContainer(input.dimensions), values->data(), owner);
+}
+
+/// Returns the serialized words of `buffer`, read in place unless they are not
+/// aligned on words, in which case they are copied in `aligned`.
+kj::ArrayPtr<const capnp::word> bufferToWords(const pybind11::buffer &buffer,
+                                              kj::Array<capnp::word> &aligned) {
+  auto info = buffer.request();
+  auto size = info.size * info.itemsize;
+  kj::ArrayPtr<const capnp::word> words((const capnp::word *)info.ptr,
+                                        size / sizeof(capnp::word));
+  if ((uintptr_t)info.ptr % alignof(capnp::word) != 0 ||
+      size % sizeof(capnp::word) != 0) {
+    aligned = kj::heapArray<capnp::word>(
+        (size + sizeof(capnp::word) - 1) / sizeof(capnp::word));
+    memcpy(aligned.begin(), info.ptr, size);
+    words = aligned;
+  }
+  return words;
+}
+
+/// Returns a memoryview on the serialized `words`, which it keeps alive.
+pybind11::memoryview wordsToMemoryview(kj::Array<capnp::word> &&input) {
+  // The memoryview keeps the serialized words alive, through the array it
+  // views
+  auto words = new kj::Array<capnp::word>(std::move(input));
+  pybind11::capsule owner(
+      words, [](void *words) { delete (kj::Array<capnp::word> *)words; });
+  auto bytes = words->asBytes();
+  return pybind11::memoryview(
+      pybind11::array_t<uint8_t>({bytes.size()}, bytes.begin(), owner));
 }
 } // namespace
 
@@ -227,6 +249,7 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   using pybind11::array;
   using pybind11::init;
   using Library = CompilerEngine::Library;
+  using JITProgram = CompilerEngine::JITProgram;
 
   m.doc() = "Concretelang compiler python API";
 
@@ -244,6 +267,18 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   m.def("check_gpu_runtime_enabled", &checkGPURuntimeEnabled);
   m.def("check_cuda_device_available", &checkCudaDeviceAvailable);
 
+  m.def("bootstrap_work", &mlir::concretelang::bootstrapWork,
+        "The work of a bootstrap, in the units of the primitive cost tables.",
+        arg("input_lwe_dimension"), arg("levels"), arg("glwe_dimension"),
+        arg("polynomial_size"));
+  m.def("keyswitch_work", &mlir::concretelang::keyswitchWork,
+        "The work of a keyswitch, in the units of the primitive cost tables.",
+        arg("input_lwe_dimension"), arg("levels"), arg("output_lwe_dimension"));
+  m.def("leveled_work", &mlir::concretelang::leveledWork,
+        "The work of a leveled operation, in the units of the primitive cost "
+        "tables.",
+        arg("lwe_dimension"));
+
   pybind11::enum_<mlir::concretelang::Backend>(m, "Backend")
       .value("CPU", mlir::concretelang::Backend::CPU,
              "Circuit codegen targets cpu.")
@@ -251,6 +286,38 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
              "Circuit codegen tartgets gpu.")
       .export_values();
 
+  pybind11::enum_<CsprngBackend>(m, "CsprngBackend")
+      .value("SOFTWARE", CsprngBackend::Software,
+             "Csprng implemented in software.")
+      .value("AESNI", CsprngBackend::AesNi,
+             "Csprng using the AES-NI instructions of x86_64 cpus.")
+      .value("ARM_AES", CsprngBackend::ArmAes,
+             "Csprng using the AES instructions of ARMv8 cpus.")
+      .export_values();
+
+  m.def("get_csprng_backend", &::concretelang::csprng::getCsprngBackend,
+        "Return the backend of the csprngs created from now on, the fastest "
+        "one available on this cpu unless selected with "
+        "`set_csprng_backend` or the CONCRETE_CSPRNG_BACKEND environment "
+        "variable.");
+
+  m.def("set_csprng_backend", &::concretelang::csprng::setCsprngBackend,
+        "Select the backend of the csprngs created from now on, returns "
+        "False if it is not available on this cpu.",
+        arg("backend"));
+
+  pybind11::enum_<FftBackend>(m, "FftBackend")
+      .value("SCALAR", FftBackend::Scalar, "FFT kernels without SIMD.")
+      .value("AVX2", FftBackend::Avx2,
+             "FFT kernels using the AVX2 and FMA instructions of x86_64 cpus.")
+      .value("AVX512", FftBackend::Avx512,
+             "FFT kernels using the AVX-512 instructions of x86_64 cpus.")
+      .export_values();
+
+  m.def("get_fft_backend", &concrete_cpu_get_fft_backend,
+        "Return the kernels the FFTs of the bootstraps run on, the widest "
+        "ones both built in the CPU backend and supported by this cpu.");
+
   pybind11::enum_<optimizer::Strategy>(m, "OptimizerStrategy")
       .value("V0", optimizer::Strategy::V0)
       .value("DAG_MONO", optimizer::Strategy::DAG_MONO)
@@ -262,6 +329,14 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .value("PRECISION", concrete_optimizer::MultiParamStrategy::ByPrecision)
       .value("PRECISION_AND_NORM2",
              concrete_optimizer::MultiParamStrategy::ByPrecisionAndNorm2)
+      .value("COST", concrete_optimizer::MultiParamStrategy::ByCost)
+      .export_values();
+
+  pybind11::enum_<concrete_optimizer::CostModel>(m, "OptimizerCostModel")
+      .value("AUTO", concrete_optimizer::CostModel::Auto)
+      .value("CPU", concrete_optimizer::CostModel::Cpu)
+      .value("GPU_AMORTIZED", concrete_optimizer::CostModel::GpuAmortized)
+      .value("GPU_LOWLAT", concrete_optimizer::CostModel::GpuLowlat)
       .export_values();
 
   pybind11::enum_<concrete_optimizer::Encoding>(m, "Encoding")
@@ -364,6 +439,13 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                 concrete_optimizer::MultiParamStrategy::ByPrecisionAndNorm2;
           },
           "Set option for multi param strategy to by-precision-and-norm2.")
+      .def(
+          "set_multi_param_strategy_to_by_cost",
+          [](concrete_optimizer::Options &options) {
+            options.multi_param_strategy =
+                concrete_optimizer::MultiParamStrategy::ByCost;
+          },
+          "Set option for multi param strategy to by-cost.")
       .def(
           "set_default_log_norm2_woppbs",
           [](concrete_optimizer::Options &options,
@@ -474,6 +556,39 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           },
           "Set option for dataflow parallelization.",
           arg("dataflow_parallelize"))
+      .def(
+          "set_dataflow_min_task_work",
+          [](CompilationOptions &options, int64_t work) {
+            options.dataflowMinTaskWork = work;
+          },
+          "Set the minimum estimated work of a dataflow task, smaller tasks "
+          "are merged.",
+          arg("dataflow_min_task_work"))
+      .def(
+          "set_dataflow_unroll_factor",
+          [](CompilationOptions &options, int64_t factor) {
+            options.dataflowUnrollFactor = factor;
+          },
+          "Set the maximum number of iterations of the static loops holding "
+          "table lookups unrolled before building the dataflow tasks.",
+          arg("dataflow_unroll_factor"))
+      .def(
+          "set_dataflow_thread_policy",
+          [](CompilationOptions &options, std::string policy, int64_t threads) {
+            options.dataflowThreadPolicy = policy;
+            options.dataflowThreads = threads;
+          },
+          "Set how the cores are shared between the dataflow runtime workers "
+          "and the OpenMP threads (default, partition or shared), and the "
+          "number of dataflow workers (0 for the default of the policy).",
+          arg("policy"), arg("threads") = 0)
+      .def(
+          "set_async_offload",
+          [](CompilationOptions &options, bool b) {
+            options.asyncOffload = b;
+          },
+          "Set option for running independent table lookups concurrently.",
+          arg("async_offload"))
       .def(
           "set_compress_evaluation_keys",
           [](CompilationOptions &options, bool b) {
@@ -488,6 +603,29 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           },
           "Set option for compression of input ciphertexts.",
           arg("compress_input_ciphertexts"))
+      .def(
+          "set_compress_output_ciphertexts",
+          [](CompilationOptions &options, bool b) {
+            options.compressOutputCiphertexts = b;
+          },
+          "Set option for compression of output ciphertexts.",
+          arg("compress_output_ciphertexts"))
+      .def(
+          "set_compact_fourier_bootstrap_keys",
+          [](CompilationOptions &options, bool b) {
+            options.compactFourierBootstrapKeys = b;
+          },
+          "Set option for storing the fourier bootstrap keys in single "
+          "precision.",
+          arg("compact_fourier_bootstrap_keys"))
+      .def(
+          "set_destination_passing",
+          [](CompilationOptions &options, bool b) {
+            options.destinationPassing = b;
+          },
+          "Set option for passing the tensor outputs of the circuits as "
+          "buffers provided by the caller.",
+          arg("destination_passing"))
       .def(
           "set_optimize_concrete",
           [](CompilationOptions &options, bool b) { options.optimizeTFHE = b; },
@@ -562,6 +700,91 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                  concrete_optimizer::restriction::KeysetRestriction>(
                  restriction);
            })
+      .def(
+          "set_optimizer_threads",
+          [](CompilationOptions &options, uint32_t threads) {
+            options.optimizerConfig.nb_threads = threads;
+          },
+          "Set the number of threads of the search of the dag-multi "
+          "parameters, 0 for all the available threads.",
+          arg("threads"))
+      .def(
+          "set_optimizer_cost_model",
+          [](CompilationOptions &options, concrete_optimizer::CostModel model,
+             uint32_t numberOfSm) {
+            options.optimizerConfig.cost_model = model;
+            options.optimizerConfig.gpu_number_of_sm = numberOfSm;
+          },
+          "Set the cost model minimized by the optimizer and the number of "
+          "streaming multiprocessors of the gpu models.",
+          arg("model"),
+          arg("number_of_sm") = optimizer::DEFAULT_GPU_NUMBER_OF_SM)
+      .def(
+          "set_optimizer_cost_factors",
+          [](CompilationOptions &options, double ksFactor, double pbsFactor) {
+            options.optimizerConfig.ks_cost_factor = ksFactor;
+            options.optimizerConfig.pbs_cost_factor = pbsFactor;
+          },
+          "Set the measured times of a keyswitch and a bootstrap per unit of "
+          "complexity of the cost model, 0 keeping the model unscaled.",
+          arg("ks_factor"), arg("pbs_factor"))
+      .def(
+          "set_optimizer_key_size_weight",
+          [](CompilationOptions &options, double weight) {
+            options.optimizerConfig.key_size_weight = weight;
+          },
+          "Set the complexity added per byte of bootstrap and keyswitch keys "
+          "by the dag-multi optimizer, 0 ignoring the key sizes.",
+          arg("weight"))
+      .def(
+          "set_optimizer_key_reuse_threshold",
+          [](CompilationOptions &options, double threshold) {
+            options.optimizerConfig.key_reuse_threshold = threshold;
+          },
+          "Set the relative complexity increase accepted by the dag-multi "
+          "optimizer to merge two partitions, sharing their keys between the "
+          "circuits of the program.",
+          arg("threshold"))
+      .def(
+          "set_optimizer_allow_pbs_ks_order",
+          [](CompilationOptions &options, bool allow) {
+            options.optimizerConfig.allow_pbs_ks_order = allow;
+          },
+          "Set whether the dag-multi optimizer may bootstrap and then "
+          "keyswitch in the partitions where it is cheaper.",
+          arg("allow"))
+      .def(
+          "set_optimizer_many_lut_max_count",
+          [](CompilationOptions &options, uint32_t count) {
+            options.optimizerConfig.many_lut_max_count = count;
+          },
+          "Set the maximum number of lookup tables of the same input that the "
+          "dag-multi optimizer evaluates with a single many-LUT bootstrap.",
+          arg("count"))
+      .def(
+          "set_optimizer_max_grouping_factor",
+          [](CompilationOptions &options, uint32_t factor) {
+            options.optimizerConfig.max_grouping_factor = factor;
+          },
+          "Set the largest grouping factor of the multi-bit bootstraps that "
+          "the dag-multi optimizer may use on GPU, 0 or 1 disabling them.",
+          arg("factor"))
+      .def(
+          "set_optimizer_solution_cache_dir",
+          [](CompilationOptions &options, std::string cacheDir) {
+            options.optimizerConfig.solution_cache_dir = cacheDir;
+          },
+          "Set the directory of the cache of the solutions of the optimizer, "
+          "an empty path disabling the cache.",
+          arg("cache_dir"))
+      .def(
+          "set_optimizer_shared_solution_cache_dirs",
+          [](CompilationOptions &options, std::vector<std::string> cacheDirs) {
+            options.optimizerConfig.shared_solution_cache_dirs = cacheDirs;
+          },
+          "Set the directories where the solutions of the optimizer are looked "
+          "up after the solution cache, without ever being written.",
+          arg("cache_dirs"))
       .def(
           "set_v0_parameter",
           [](CompilationOptions &options, size_t glweDimension,
@@ -647,6 +870,103 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           },
           "Enable or disable overflow detection during simulation.",
           arg("enable_overflow_detection"))
+      .def(
+          "set_enable_noise_in_simulation",
+          [](CompilationOptions &options, bool enableNoise) {
+            options.enableNoiseInSimulation = enableNoise;
+          },
+          "Enable or disable the noise of the simulated operations. Without "
+          "it, the simulation evaluates the circuit exactly on cleartexts.",
+          arg("enable_noise"))
+      .def(
+          "set_codegen_threads",
+          [](CompilationOptions &options, unsigned int threads) {
+            options.codegenThreads = threads;
+          },
+          "Set the number of threads generating the code of the libraries in "
+          "parallel (0 for the number of hardware threads).",
+          arg("codegen_threads"))
+      .def(
+          "set_target_cpu",
+          [](CompilationOptions &options, std::string cpu) {
+            options.targetCpu = cpu;
+          },
+          "Set the cpu the code of the libraries is generated for, host for "
+          "the cpu and the features of the compiling machine.",
+          arg("cpu"))
+      .def(
+          "set_target_cpu_variants",
+          [](CompilationOptions &options, std::vector<std::string> variants) {
+            options.targetCpuVariants = variants;
+          },
+          "Set the x86-64 levels the code of the libraries is generated for, "
+          "the circuits dispatching at runtime to the highest level "
+          "supported.",
+          arg("variants"))
+      .def(
+          "set_compilation_cache_dir",
+          [](CompilationOptions &options, std::string cacheDir) {
+            options.compilationCacheDir = cacheDir;
+          },
+          "Set the directory of the cache of the compiled libraries, an empty "
+          "path disabling the cache.",
+          arg("cache_dir"))
+      .def(
+          "set_object_cache_dir",
+          [](CompilationOptions &options, std::string cacheDir) {
+            options.objectCacheDir = cacheDir;
+          },
+          "Set the directory of the cache of the objects of the circuits, "
+          "such that only the circuits which changed are generated again, an "
+          "empty path disabling the cache.",
+          arg("cache_dir"))
+      .def(
+          "set_compilation_profile",
+          [](CompilationOptions &options, bool b) {
+            options.compilationProfile = b;
+          },
+          "Set the option for reporting the time and the memory spent by each "
+          "stage of the compilation in compilation_profile.json.",
+          arg("profile"))
+      .def(
+          "set_latency_cost_table",
+          [](CompilationOptions &options, std::string path, std::string device,
+             unsigned int cores) {
+            options.latencyCostTable = path;
+            options.latencyTargetDevice = device;
+            options.latencyTargetCores = cores;
+          },
+          "Set the primitive cost table the latency and the throughput of the "
+          "circuits are predicted from, on the given device of the table, "
+          "with the given number of cores, 0 for the parallelism of the "
+          "table.",
+          arg("path"), arg("device") = "cpu", arg("cores") = 0)
+      .def(
+          "set_reuse_buffers",
+          [](CompilationOptions &options, bool b) {
+            options.reuseBuffers = b;
+          },
+          "Set the option for reusing the buffers deallocated by the circuits "
+          "for their next allocations of the same type.",
+          arg("reuse_buffers"))
+      .def(
+          "set_runtime_bitcode",
+          [](CompilationOptions &options, std::string path) {
+            options.runtimeBitcode = path;
+          },
+          "Set the path of the LLVM bitcode of the leveled wrappers of the "
+          "runtime, linked into the circuits to inline the leveled "
+          "operations, an empty path disabling it.",
+          arg("path"))
+      .def(
+          "set_execution_variants",
+          [](CompilationOptions &options, std::vector<std::string> variants) {
+            options.executionVariants = variants;
+          },
+          "Set the execution variants compiled into the libraries besides "
+          "their default code, among cpu, loop, dataflow and gpu, the server "
+          "running the variant it selects for its host.",
+          arg("variants"))
       .doc() = "Holds different flags and options of the compilation process.";
 
   pybind11::enum_<mlir::concretelang::PrimitiveOperation>(m,
@@ -678,6 +998,67 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .def_readonly("keys", &mlir::concretelang::Statistic::keys)
       .def_readonly("count", &mlir::concretelang::Statistic::count);
 
+  pybind11::enum_<mlir::concretelang::RuntimePrimitive>(m, "RuntimePrimitive")
+      .value("KEYSWITCH", mlir::concretelang::RuntimePrimitive::KEYSWITCH)
+      .value("BOOTSTRAP", mlir::concretelang::RuntimePrimitive::BOOTSTRAP)
+      .value("KEYSWITCH_BOOTSTRAP",
+             mlir::concretelang::RuntimePrimitive::KEYSWITCH_BOOTSTRAP)
+      .value("WOP_PBS", mlir::concretelang::RuntimePrimitive::WOP_PBS)
+      .value("LEVELED", mlir::concretelang::RuntimePrimitive::LEVELED)
+      .export_values();
+
+  pybind11::class_<mlir::concretelang::PrimitiveStatistic>(
+      m, "PrimitiveStatistic")
+      .def_readonly("primitive",
+                    &mlir::concretelang::PrimitiveStatistic::primitive)
+      .def_readonly("ksk_index",
+                    &mlir::concretelang::PrimitiveStatistic::kskIndex)
+      .def_readonly("bsk_index",
+                    &mlir::concretelang::PrimitiveStatistic::bskIndex)
+      .def_readonly("gpu", &mlir::concretelang::PrimitiveStatistic::gpu)
+      .def_readonly("calls", &mlir::concretelang::PrimitiveStatistic::calls)
+      .def_readonly("ciphertexts",
+                    &mlir::concretelang::PrimitiveStatistic::ciphertexts)
+      .def_readonly("nanoseconds",
+                    &mlir::concretelang::PrimitiveStatistic::nanoseconds)
+      .def_readonly("latency_histogram",
+                    &mlir::concretelang::PrimitiveStatistic::latencyHistogram)
+      .def_readonly("counted_calls",
+                    &mlir::concretelang::PrimitiveStatistic::countedCalls)
+      .def_readonly("cycles", &mlir::concretelang::PrimitiveStatistic::cycles)
+      .def_readonly("instructions",
+                    &mlir::concretelang::PrimitiveStatistic::instructions)
+      .def_readonly("cache_references",
+                    &mlir::concretelang::PrimitiveStatistic::cacheReferences)
+      .def_readonly("cache_misses",
+                    &mlir::concretelang::PrimitiveStatistic::cacheMisses)
+      .doc() = "Runtime statistics of the calls of a primitive with the same "
+               "keys, on the same device. The bucket `i` of the latency "
+               "histogram counts the calls which took between 2^i and "
+               "2^(i+1) nanoseconds. The hardware events, if counted, are "
+               "those of the `counted_calls` calls.";
+
+  pybind11::class_<mlir::concretelang::SimulationStatistic>(
+      m, "SimulationStatistic")
+      .def_readonly("location",
+                    &mlir::concretelang::SimulationStatistic::location)
+      .def_readonly("bootstraps",
+                    &mlir::concretelang::SimulationStatistic::bootstraps)
+      .def_readonly("precision",
+                    &mlir::concretelang::SimulationStatistic::precision)
+      .def_readonly("noise_variance",
+                    &mlir::concretelang::SimulationStatistic::noiseVariance)
+      .def_readonly("max_noise",
+                    &mlir::concretelang::SimulationStatistic::maxNoise)
+      .def_readonly("max_variance",
+                    &mlir::concretelang::SimulationStatistic::maxVariance)
+      .def_readonly("overflows",
+                    &mlir::concretelang::SimulationStatistic::overflows)
+      .doc() = "Statistics of the simulated operations at a location. The "
+               "noise is measured at the input of the bootstraps, in the "
+               "torus, when the precision of their messages is known. "
+               "`max_variance` is the variance the optimizer bounded it to.";
+
   pybind11::class_<mlir::concretelang::CircuitCompilationFeedback>(
       m, "CircuitCompilationFeedback")
       .def_readonly("name",
@@ -696,6 +1077,38 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .def_readonly(
           "memory_usage_per_location",
           &mlir::concretelang::CircuitCompilationFeedback::memoryUsagePerLoc)
+      .def_readonly(
+          "removed_pbs_count",
+          &mlir::concretelang::CircuitCompilationFeedback::removedPbsCount)
+      .def_readonly("removed_key_switch_count",
+                    &mlir::concretelang::CircuitCompilationFeedback::
+                        removedKeySwitchCount)
+      .def_readonly(
+          "fused_pbs_count",
+          &mlir::concretelang::CircuitCompilationFeedback::fusedPbsCount)
+      .def_readonly(
+          "peak_memory_usage",
+          &mlir::concretelang::CircuitCompilationFeedback::peakMemoryUsage)
+      .def_readonly(
+          "allocated_memory",
+          &mlir::concretelang::CircuitCompilationFeedback::allocatedMemory)
+      .def_readonly("allocated_memory_without_buffer_reuse",
+                    &mlir::concretelang::CircuitCompilationFeedback::
+                        allocatedMemoryWithoutBufferReuse)
+      .def_readonly("pbs_depth",
+                    &mlir::concretelang::CircuitCompilationFeedback::pbsDepth)
+      .def_readonly("average_pbs_parallelism",
+                    &mlir::concretelang::CircuitCompilationFeedback::
+                        averagePbsParallelism)
+      .def_readonly(
+          "batchable_pbs_count",
+          &mlir::concretelang::CircuitCompilationFeedback::batchablePbsCount)
+      .def_readonly(
+          "predicted_latency",
+          &mlir::concretelang::CircuitCompilationFeedback::predictedLatency)
+      .def_readonly(
+          "predicted_throughput",
+          &mlir::concretelang::CircuitCompilationFeedback::predictedThroughput)
       .doc() = "Compilation feedback for a single circuit.";
 
   pybind11::class_<mlir::concretelang::ProgramCompilationFeedback>(
@@ -716,6 +1129,9 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .def_readonly("total_keyswitch_keys_size",
                     &mlir::concretelang::ProgramCompilationFeedback::
                         totalKeyswitchKeysSize)
+      .def_readonly(
+          "runtime_scratch_size",
+          &mlir::concretelang::ProgramCompilationFeedback::runtimeScratchSize)
       .def_readonly(
           "circuit_feedbacks",
           &mlir::concretelang::ProgramCompilationFeedback::circuitFeedbacks)
@@ -1559,6 +1975,17 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             return ServerKeyset::fromProto(serverKeysetProto.asReader());
           },
           "Deserialize a ServerKeyset from bytes.", arg("bytes"))
+      .def_static(
+          "load_mapped",
+          [](const std::string &path) {
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto serverKeyset,
+                                ServerKeyset::fromMappedFile(path));
+            return serverKeyset;
+          },
+          "Load a serialized ServerKeyset by mapping the file read-only, the "
+          "keys are used in place instead of being copied.",
+          arg("path"))
       .def(
           "serialize",
           [](ServerKeyset &serverKeyset) {
@@ -1573,6 +2000,52 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             return pybind11::bytes(serverKeysetSerialize(serverKeyset));
           },
           "Serialize a ServerKeyset to bytes.")
+      .def_static(
+          "deserialize_from_file",
+          [](const std::string path) {
+            pybind11::gil_scoped_release release;
+            std::ifstream ifs;
+            ifs.open(path);
+            if (!ifs.good()) {
+              throw std::runtime_error("Failed to open server keyset file " +
+                                       path);
+            }
+            auto serverKeysetProto = Message<concreteprotocol::ServerKeyset>();
+            auto maybeError = serverKeysetProto.readBinaryFromIstream(
+                ifs, mlir::concretelang::python::DESER_OPTIONS);
+            if (maybeError.has_failure()) {
+              throw std::runtime_error("Failed to deserialize server keyset." +
+                                       maybeError.as_failure().error().mesg);
+            }
+            return ServerKeyset::fromProto(serverKeysetProto);
+          },
+          "Deserialize a ServerKeyset from a file.", arg("path"))
+      .def(
+          "serialize_to_file",
+          [](ServerKeyset &serverKeyset, const std::string path) {
+            pybind11::gil_scoped_release release;
+            std::ofstream ofs;
+            ofs.open(path);
+            if (!ofs.good()) {
+              throw std::runtime_error("Failed to open server keyset file " +
+                                       path);
+            }
+            auto serverKeysetProto = serverKeyset.toProto();
+            auto maybeBuffer = serverKeysetProto.writeBinaryToOstream(ofs);
+            if (maybeBuffer.has_failure()) {
+              throw std::runtime_error("Failed to serialize server keyset.");
+            }
+          },
+          "Serialize a ServerKeyset to a file, which can be loaded with "
+          "`load_mapped`.",
+          arg("path"))
+      .def(
+          "decompress",
+          [](ServerKeyset &serverKeyset) {
+            pybind11::gil_scoped_release release;
+            serverKeyset.decompress();
+          },
+          "Decompress the seeded keys now instead of on their first use.")
       .doc() = "Server-side / Evaluation keyset";
 
   // ------------------------------------------------------------------------------//
@@ -1594,6 +2067,7 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                    std::optional<std::map<uint32_t, LweSecretKey>>
                        initialLweSecretKeys) {
              SignalGuard const signalGuard;
+             pybind11::gil_scoped_release release;
 
              auto secretSeed =
                  (((__uint128_t)secretSeedMsb) << 64) | secretSeedLsb;
@@ -1753,6 +2227,11 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           "get_program_info_path",
           [](Library &library) { return library.getProgramInfoPath(); },
           "Return the path to the program info file.")
+      .def(
+          "get_compilation_profile_path",
+          [](Library &library) { return library.getCompilationProfilePath(); },
+          "Return the path to the compilation profile, emitted when the "
+          "compilation is profiled.")
       .def(
           "get_program_compilation_feedback",
           [](Library &library) {
@@ -1764,6 +2243,15 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           "Return the associated program compilation feedback.")
       .doc() = "Library object representing the output of a compilation.";
 
+  pybind11::class_<JITProgram>(m, "JITProgram")
+      .def(
+          "get_program_info",
+          [](JITProgram &program) {
+            return ProgramInfo{program.programInfo};
+          },
+          "Return the program info associated to the program.")
+      .doc() = "Program compiled in memory, without a library.";
+
   // ------------------------------------------------------------------------------//
   // COMPILER //
   // ------------------------------------------------------------------------------//
@@ -1818,6 +2306,29 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           },
           "Compile `mlir_program` using the `options` compilation options.",
           arg("mlir_program"), arg("options"))
+      .def(
+          "compile_jit",
+          [](Compiler &support, std::string mlir_program,
+             mlir::concretelang::CompilationOptions options) {
+            SignalGuard signalGuard;
+            llvm::SourceMgr sm;
+            sm.AddNewSourceBuffer(
+                llvm::MemoryBuffer::getMemBuffer(mlir_program.c_str()),
+                llvm::SMLoc());
+
+            auto context = CompilationContext::createShared();
+            concretelang::CompilerEngine engine(context);
+            engine.setCompilationOptions(options);
+
+            // Compile in memory, each function on its first call
+            GET_OR_THROW_EXPECTED(
+                auto program,
+                engine.compileJIT(sm, support.runtimeLibraryPath));
+            return program;
+          },
+          "Compile `mlir_program` in memory using the `options` compilation "
+          "options, without writing a library.",
+          arg("mlir_program"), arg("options"))
       .def(
           "compile",
           [](Compiler &support, pybind11::object mlir_module,
@@ -1853,17 +2364,22 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   pybind11::class_<TransportValue>(m, "TransportValue")
       .def_static(
           "deserialize",
-          [](const pybind11::bytes &buffer) {
+          [](const pybind11::buffer &buffer) {
+            kj::Array<capnp::word> aligned;
+            auto words = bufferToWords(buffer, aligned);
+            pybind11::gil_scoped_release release;
             auto inner = TransportValue();
             if (inner
-                    .readBinaryFromString(
-                        buffer, mlir::concretelang::python::DESER_OPTIONS)
+                    .readBinaryFromFlatArray(
+                        words, mlir::concretelang::python::DESER_OPTIONS)
                     .has_failure()) {
               throw std::runtime_error("Failed to deserialize TransportValue");
             }
-            return TransportValue{inner};
+            return inner;
           },
-          "Deserialize a TransportValue from bytes.", arg("bytes"))
+          "Deserialize a TransportValue from bytes or any object exposing a "
+          "buffer (e.g. a memoryview).",
+          arg("bytes"))
       .def(
           "serialize",
           [](const TransportValue &value) {
@@ -1877,6 +2393,59 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             return pybind11::bytes(valueSerialize(value));
           },
           "Serialize a TransportValue to bytes")
+      .def(
+          "serialize_to_memoryview",
+          [](const TransportValue &value) {
+            auto maybeWords = [&]() {
+              pybind11::gil_scoped_release release;
+              return value.writeBinaryToFlatArray();
+            }();
+            if (maybeWords.has_failure()) {
+              throw std::runtime_error("Failed to serialize TransportValue");
+            }
+            return wordsToMemoryview(std::move(maybeWords.value()));
+          },
+          "Serialize a TransportValue to a memoryview, without copying the "
+          "serialized bytes.")
+      .def_static(
+          "serialize_all",
+          [](const std::vector<TransportValue *> &values) {
+            // The values are taken by pointer, a vector of values would be a
+            // copy of all of them
+            for (auto value : values) {
+              if (value == nullptr) {
+                throw std::invalid_argument("Expected TransportValues");
+              }
+            }
+            auto maybeWords = [&]() {
+              pybind11::gil_scoped_release release;
+              return ::concretelang::protocol::writeBinaryToFlatArray(values);
+            }();
+            if (maybeWords.has_failure()) {
+              throw std::runtime_error("Failed to serialize TransportValues");
+            }
+            return wordsToMemoryview(std::move(maybeWords.value()));
+          },
+          "Serialize TransportValues, e.g. all the arguments or results of a "
+          "call, one after the other in a single memoryview.",
+          arg("values"))
+      .def_static(
+          "deserialize_all",
+          [](const pybind11::buffer &buffer) {
+            kj::Array<capnp::word> aligned;
+            auto words = bufferToWords(buffer, aligned);
+            pybind11::gil_scoped_release release;
+            auto maybeValues =
+                ::concretelang::protocol::readBinaryFromFlatArray<
+                    concreteprotocol::Value>(
+                    words, mlir::concretelang::python::DESER_OPTIONS);
+            if (maybeValues.has_failure()) {
+              throw std::runtime_error("Failed to deserialize TransportValues");
+            }
+            return std::move(maybeValues.value());
+          },
+          "Deserialize the TransportValues serialized by `serialize_all`.",
+          arg("bytes"))
       .doc() = "Public/Transportable value.";
 
   // ------------------------------------------------------------------------------//
@@ -1887,7 +2456,7 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                        uint32_t, uint64_t, array>
       PyValType;
 
-  pybind11::class_<Value>(m, "Value")
+  pybind11::class_<Value>(m, "Value", pybind11::buffer_protocol())
       .def(init([](int64_t scalar) { return Value{Tensor<int64_t>(scalar)}; }),
            arg("input"))
       .def(
@@ -1949,6 +2518,26 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
              throw std::runtime_error(message);
            }),
            arg("input"))
+      // Exposes the values in place, for e.g. `numpy.asarray(value)` to view
+      // them without copy while the value is alive. The view is read-only:
+      // the storage may be shared with the copies of the value, which a write
+      // through the view would modify as well.
+      .def_buffer([](Value &value) -> pybind11::buffer_info {
+        return std::visit(
+            [](const auto &tensor) {
+              using T = typename decltype(tensor.values)::value_type;
+              std::vector<ssize_t> shape(tensor.dimensions.begin(),
+                                         tensor.dimensions.end());
+              std::vector<ssize_t> strides(shape.size(), sizeof(T));
+              for (ssize_t i = (ssize_t)shape.size() - 2; i >= 0; i--)
+                strides[i] = strides[i + 1] * shape[i + 1];
+              return pybind11::buffer_info(
+                  const_cast<T *>(tensor.values.data()), sizeof(T),
+                  pybind11::format_descriptor<T>::format(), shape.size(),
+                  shape, strides, /*readonly=*/true);
+            },
+            value.inner);
+      })
       .def(
           "to_py_val",
           [](Value &value) -> PyValType {
@@ -2034,6 +2623,35 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
           "Perform circuit call with `args` arguments using the `keyset` "
           "ServerKeyset.",
           arg("args"), arg("keyset"))
+      .def(
+          "call_batch",
+          [](ServerCircuit &circuit,
+             std::vector<std::vector<TransportValue>> batch,
+             ServerKeyset keyset) {
+            SignalGuard signalGuard;
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto output, circuit.callBatch(keyset, batch));
+            return output;
+          },
+          "Perform a circuit call for each arguments of `batch`, "
+          "concurrently, using the `keyset` ServerKeyset.",
+          arg("batch"), arg("keyset"))
+      .def(
+          "call_repeated",
+          [](ServerCircuit &circuit, std::vector<TransportValue> args,
+             std::optional<ServerKeyset> keyset, size_t n) {
+            SignalGuard signalGuard;
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(
+                auto output,
+                circuit.callRepeated(keyset.value_or(ServerKeyset()), args, n));
+            return output;
+          },
+          "Perform `n` circuit calls in a row using the `keyset` "
+          "ServerKeyset, or none when simulating, each call taking the "
+          "outputs of the previous one as arguments, and return the outputs "
+          "of the last one.",
+          arg("args"), arg("keyset"), arg("n"))
       .def(
           "simulate",
           [](ServerCircuit &circuit, std::vector<TransportValue> &args) {
@@ -2042,14 +2660,166 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             return output;
           },
           "Perform circuit simulation with `args` arguments.", arg("args"))
+      .def(
+          "simulate_dataset",
+          [](ServerCircuit &circuit,
+             std::vector<std::vector<TransportValue>> &dataset, uint64_t seed) {
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto output,
+                                circuit.simulateDataset(dataset, seed));
+            return output;
+          },
+          "Perform a circuit simulation for each arguments of `dataset`, "
+          "concurrently. With a non zero `seed`, the noise of each simulation "
+          "is reproducible.",
+          arg("dataset"), arg("seed") = 0)
+      .def(
+          "get_variants",
+          [](ServerCircuit &circuit) { return circuit.getVariants(); },
+          "Return the names of the execution variants of the circuit besides "
+          "its default code.")
+      .def(
+          "get_selected_variant",
+          [](ServerCircuit &circuit) { return circuit.getSelectedVariant(); },
+          "Return the name of the execution variant run by the calls, empty "
+          "for the default code.")
+      .def(
+          "select_variant",
+          [](ServerCircuit &circuit, std::string name) {
+            auto maybeError = circuit.selectVariant(name);
+            if (maybeError.has_failure()) {
+              throw std::runtime_error(maybeError.as_failure().error().mesg);
+            }
+          },
+          "Run the calls with the execution variant `name`, or with the "
+          "default code if empty.",
+          arg("name"))
+      .def(
+          "calibrate_variants",
+          [](ServerCircuit &circuit, std::vector<TransportValue> args,
+             ServerKeyset keyset, size_t repetitions) {
+            SignalGuard signalGuard;
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(
+                auto selected,
+                circuit.calibrateVariants(keyset, args, repetitions));
+            return selected;
+          },
+          "Time `repetitions` calls on `args` with the default code and with "
+          "each execution variant which can run on this host, select the "
+          "fastest and return its name.",
+          arg("args"), arg("keyset"), arg("repetitions") = 1)
+      .def(
+          "enable_primitive_statistics",
+          [](ServerCircuit &circuit, bool enable, bool hardwareCounters) {
+            circuit.enablePrimitiveStatistics(enable, hardwareCounters);
+          },
+          "Start (or stop) recording the runtime primitives called by the "
+          "calls of this circuit, with their cycles, instructions and cache "
+          "references and misses on the CPU if `hardware_counters` and the "
+          "performance counters are available.",
+          arg("enable") = true, arg("hardware_counters") = false)
+      .def(
+          "get_primitive_statistics",
+          [](ServerCircuit &circuit) {
+            return circuit.getPrimitiveStatistics();
+          },
+          "Return the statistics of the runtime primitives called since "
+          "enabled or reset.")
+      .def(
+          "reset_primitive_statistics",
+          [](ServerCircuit &circuit) { circuit.resetPrimitiveStatistics(); },
+          "Reset the statistics of the runtime primitives.")
+      .def(
+          "enable_simulation_statistics",
+          [](ServerCircuit &circuit, bool enable) {
+            circuit.enableSimulationStatistics(enable);
+          },
+          "Start (or stop) recording the noise and the overflows of the "
+          "operations simulated by the calls of this circuit.",
+          arg("enable") = true)
+      .def(
+          "get_simulation_statistics",
+          [](ServerCircuit &circuit) {
+            return circuit.getSimulationStatistics();
+          },
+          "Return the statistics of the simulated operations since enabled or "
+          "reset, by location.")
+      .def(
+          "reset_simulation_statistics",
+          [](ServerCircuit &circuit) { circuit.resetSimulationStatistics(); },
+          "Reset the statistics of the simulated operations.")
       .doc() = "Server-side / Evaluation circuit.";
 
+  // ------------------------------------------------------------------------------//
+  // CALL GRAPH //
+  // ------------------------------------------------------------------------------//
+
+  pybind11::class_<CallGraph>(m, "CallGraph")
+      .def(init([]() { return CallGraph(); }))
+      .def(
+          "add_call",
+          [](CallGraph &graph, ServerCircuit circuit,
+             std::vector<std::pair<int64_t, size_t>> sources) {
+            std::vector<CallGraph::Source> graphSources;
+            for (auto [call, pos] : sources) {
+              graphSources.push_back(CallGraph::Source{
+                  call < 0 ? CallGraph::GRAPH_ARGUMENT : (size_t)call, pos});
+            }
+            GET_OR_THROW_RESULT(
+                auto index, graph.addCall(circuit, std::move(graphSources)));
+            return index;
+          },
+          "Add a call of `circuit`, whose arguments are taken from `sources`, "
+          "and return its index. Each source is a pair of the index of an "
+          "earlier call and of the position of its output, or of -1 and of "
+          "the position of an argument of the graph.",
+          arg("circuit"), arg("sources"))
+      .def(
+          "run",
+          [](CallGraph &graph, std::vector<TransportValue> args,
+             ServerKeyset keyset) {
+            SignalGuard signalGuard;
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto outputs, graph.run(keyset, args));
+            return outputs;
+          },
+          "Run the calls of the graph on `args` with the `keyset` "
+          "ServerKeyset, on native threads as soon as the arguments of each "
+          "call are computed, and return the outputs of each call.",
+          arg("args"), arg("keyset"))
+      .def("__len__", [](CallGraph &graph) { return graph.size(); })
+      .doc() = "Server-side composition of circuit calls.";
+
+  pybind11::class_<CallBatcher>(m, "CallBatcher")
+      .def(init([](ServerCircuit circuit, double window, size_t maxBatchSize) {
+             return std::make_unique<CallBatcher>(
+                 circuit,
+                 std::chrono::microseconds((int64_t)(window * 1e6)),
+                 maxBatchSize);
+           }),
+           arg("circuit"), arg("window"), arg("max_batch_size"))
+      .def(
+          "call",
+          [](CallBatcher &batcher, std::vector<TransportValue> args,
+             ServerKeyset keyset) {
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto result,
+                                batcher.call(keyset, std::move(args)));
+            return result;
+          },
+          "Call the circuit with `args` and the `keyset` ServerKeyset, "
+          "together with the calls made with the same keys from other threads "
+          "within `window` seconds, and return the outputs of this call.",
+          arg("args"), arg("keyset"))
+      .doc() = "Server-side coalescing of concurrent circuit calls.";
+
   // ------------------------------------------------------------------------------//
   // SERVER PROGRAM //
   // ------------------------------------------------------------------------------//
 
   pybind11::class_<ServerProgram>(m, "ServerProgram")
-      .def(init([](Library &library, bool useSimulation) {
+      .def(init([](Library &library, bool useSimulation, bool lazyCircuits) {
              auto sharedLibPath = library.getSharedLibraryPath();
 
              GET_OR_THROW_RESULT(auto pi, library.getProgramInfo());
@@ -2057,10 +2827,23 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                  auto result,
                  ServerProgram::load(
                      (Message<concreteprotocol::ProgramInfo>)pi.asReader(),
-                     sharedLibPath, useSimulation));
+                     sharedLibPath, useSimulation, std::nullopt, false, 4,
+                     lazyCircuits));
+             return result;
+           }),
+           arg("library"), arg("use_simulation"),
+           arg("lazy_circuits") = false)
+      .def(init([](JITProgram &program, bool useSimulation,
+                   bool lazyCircuits) {
+             GET_OR_THROW_RESULT(
+                 auto result,
+                 ServerProgram::load(program.programInfo, program.module,
+                                     useSimulation, std::nullopt, false, 4,
+                                     lazyCircuits));
              return result;
            }),
-           arg("library"), arg("use_simulation"))
+           arg("program"), arg("use_simulation"),
+           arg("lazy_circuits") = false)
       .def(
           "get_server_circuit",
           [](ServerProgram &program, const std::string &circuitName) {
@@ -2084,8 +2867,10 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             }
             auto info = circuit.getCircuitInfo().asReader().getInputs()[pos];
             auto typeTransformer = getPythonTypeTransformer((GateInfo)info);
-            GET_OR_THROW_RESULT(
-                auto ok, circuit.prepareInput(typeTransformer(arg), pos));
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto ok,
+                                circuit.prepareInput(
+                                    typeTransformer(std::move(arg)), pos));
             return ok;
           },
           "Prepare a `pos` positional arguments `arg` to be sent to server. ",
@@ -2093,12 +2878,67 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .def(
           "process_output",
           [](ClientCircuit &circuit, TransportValue result, size_t pos) {
+            pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto ok, circuit.processOutput(result, pos));
             return ok;
           },
           "Process a `pos` positional result `result` retrieved from "
           "server. ",
           arg("result"), arg("pos"))
+      .def(
+          "prepare_inputs",
+          [](ClientCircuit &circuit, std::vector<Value> args, size_t pos) {
+            if (pos >= circuit.getCircuitInfo().asReader().getInputs().size()) {
+              throw std::runtime_error("Unknown position.");
+            }
+            auto info = circuit.getCircuitInfo().asReader().getInputs()[pos];
+            auto typeTransformer = getPythonTypeTransformer((GateInfo)info);
+            pybind11::gil_scoped_release release;
+            for (auto &arg : args) {
+              arg = typeTransformer(std::move(arg));
+            }
+            GET_OR_THROW_RESULT(auto ok,
+                                circuit.prepareInputs(std::move(args), pos));
+            return ok;
+          },
+          "Prepare the `pos` positional arguments `args` of many samples to be "
+          "sent to server, encrypting them all at once. ",
+          arg("args"), arg("pos"))
+      .def(
+          "process_outputs",
+          [](ClientCircuit &circuit, std::vector<TransportValue> results,
+             size_t pos) {
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(
+                auto ok, circuit.processOutputs(std::move(results), pos));
+            return ok;
+          },
+          "Process the `pos` positional results `results` of many samples "
+          "retrieved from server, decrypting them all at once. ",
+          arg("results"), arg("pos"))
+      .def(
+          "precompute_input_encryptions",
+          [](ClientCircuit &circuit, size_t pos, size_t count) {
+            pybind11::gil_scoped_release release;
+            auto maybeError = circuit.precomputeInputEncryptions(pos, count);
+            if (maybeError.has_failure()) {
+              throw std::runtime_error(maybeError.as_failure().error().mesg);
+            }
+          },
+          "Precompute `count` encryptions of zero of the ciphertexts of the "
+          "`pos` positional argument, which `prepare_input` then only adds "
+          "the encoded message to. ",
+          arg("pos"), arg("count"))
+      .def(
+          "get_precomputed_input_encryptions",
+          [](ClientCircuit &circuit, size_t pos) {
+            GET_OR_THROW_RESULT(auto count,
+                                circuit.getPrecomputedInputEncryptions(pos));
+            return count;
+          },
+          "Return the number of precomputed encryptions of zero left for the "
+          "ciphertexts of the `pos` positional argument. ",
+          arg("pos"))
       .def(
           "simulate_prepare_input",
           [](ClientCircuit &circuit, Value arg, size_t pos) {
@@ -2107,8 +2947,10 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
             }
             auto info = circuit.getCircuitInfo().asReader().getInputs()[pos];
             auto typeTransformer = getPythonTypeTransformer((GateInfo)info);
-            GET_OR_THROW_RESULT(auto ok, circuit.simulatePrepareInput(
-                                             typeTransformer(arg), pos));
+            pybind11::gil_scoped_release release;
+            GET_OR_THROW_RESULT(auto ok,
+                                circuit.simulatePrepareInput(
+                                    typeTransformer(std::move(arg)), pos));
             return ok;
           },
           "SIMULATE preparation of `pos` positional argument `arg` to be "
@@ -2118,6 +2960,7 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
       .def(
           "simulate_process_output",
           [](ClientCircuit &circuit, TransportValue result, size_t pos) {
+            pybind11::gil_scoped_release release;
             GET_OR_THROW_RESULT(auto ok,
                                 circuit.simulateProcessOutput(result, pos));
             return ok;
@@ -2134,16 +2977,24 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
   pybind11::class_<ClientProgram>(m, "ClientProgram")
       .def_static(
           "create_encrypted",
-          [](ProgramInfo programInfo, Keyset keyset) {
-            GET_OR_THROW_RESULT(
-                auto clientProgram,
-                ClientProgram::createEncrypted(
-                    programInfo.programInfo, keyset.client,
-                    std::make_shared<EncryptionCSPRNG>(EncryptionCSPRNG(0))));
+          [](ProgramInfo programInfo, Keyset keyset,
+             size_t randomnessBlockSize) {
+            auto csprng =
+                std::make_shared<EncryptionCSPRNG>(EncryptionCSPRNG(0));
+            if (randomnessBlockSize > 0) {
+              csprng->enableBuffering(randomnessBlockSize);
+            }
+            GET_OR_THROW_RESULT(auto clientProgram,
+                                ClientProgram::createEncrypted(
+                                    programInfo.programInfo, keyset.client,
+                                    csprng));
             return clientProgram;
           },
-          "Create an encrypted (as opposed to simulated) ClientProgram.",
-          arg("program_info"), arg("keyset"))
+          "Create an encrypted (as opposed to simulated) ClientProgram. With "
+          "a non zero `randomness_block_size`, the randomness of the "
+          "encryptions is generated ahead of time on a background thread, by "
+          "blocks of that many ciphertexts.",
+          arg("program_info"), arg("keyset"), arg("randomness_block_size") = 0)
       .def_static(
           "create_simulated",
           [](ProgramInfo &programInfo) {
@@ -2275,9 +3126,14 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
         [](const pybind11::bytes &serialized_fheuint,
            TfhersFheIntDescription info, uint32_t encryptionKeyId,
            double encryptionVariance, std::vector<size_t> shape) {
-          const std::string &buffer_str = serialized_fheuint;
-          std::vector<uint8_t> buffer(buffer_str.begin(), buffer_str.end());
-          auto arrayRef = llvm::ArrayRef<uint8_t>(buffer);
+          char *data;
+          Py_ssize_t length;
+          if (PyBytes_AsStringAndSize(serialized_fheuint.ptr(), &data,
+                                      &length) != 0) {
+            throw pybind11::error_already_set();
+          }
+          auto arrayRef = llvm::ArrayRef<uint8_t>(
+              reinterpret_cast<const uint8_t *>(data), length);
           auto valueOrError = ::concretelang::clientlib::importTfhersInteger(
               arrayRef, info, encryptionKeyId, encryptionVariance, shape);
           if (valueOrError.has_error()) {
@@ -2292,6 +3148,7 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
     if (result.has_error()) {
       throw std::runtime_error(result.error().mesg);
     }
-    return result.value();
+    auto &buffer = result.value();
+    return pybind11::bytes((char *)buffer.data(), buffer.size());
   });
 }
@@ -23,14 +23,23 @@ from mlir._mlir_libs._concretelang._compiler import (
     Value,
     ServerProgram,
     ServerCircuit,
+    CallBatcher,
+    CallGraph,
     ClientProgram,
     ClientCircuit,
     Backend,
+    CsprngBackend,
+    FftBackend,
     KeyType,
+    OptimizerCostModel,
     OptimizerMultiParameterStrategy,
     OptimizerStrategy,
     PrimitiveOperation,
+    RuntimePrimitive,
+    PrimitiveStatistic,
+    SimulationStatistic,
     Library,
+    JITProgram,
     ProgramCompilationFeedback,
     CircuitCompilationFeedback,
     terminate_df_parallelization as _terminate_df_parallelization,
@@ -40,6 +49,12 @@ from mlir._mlir_libs._concretelang._compiler import (
     round_trip as _round_trip,
     set_llvm_debug_flag,
     set_compiler_logging,
+    get_csprng_backend,
+    set_csprng_backend,
+    get_fft_backend,
+    bootstrap_work,
+    keyswitch_work,
+    leveled_work,
 )
 
 # pylint: enable=no-name-in-module,import-error
@@ -0,0 +1,201 @@
+#  Part of the Concrete Compiler Project, under the BSD3 License with Zama Exceptions.
+#  See https://github.com/zama-ai/concrete/blob/main/LICENSE.txt for license information.
+
+"""Calibration of the primitive cost tables the latency of the circuits is predicted from.
+
+    python -m concrete.compiler.latency_calibration --output costs.json
+
+measures the costs of the primitives on this machine, in nanoseconds per unit of work, and
+writes them to the table under the name of the device, merged with the existing entries of
+the table. The runtime must be built with CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import tempfile
+from typing import Dict, List, Optional, Sequence
+
+import numpy as np
+
+# pylint: disable=no-name-in-module,import-error
+from mlir._mlir_libs._concretelang._compiler import (
+    Backend,
+    ClientProgram,
+    CompilationOptions,
+    Compiler,
+    Keyset,
+    RuntimePrimitive,
+    ServerProgram,
+    Value,
+    bootstrap_work,
+    keyswitch_work,
+    leveled_work,
+)
+
+# pylint: enable=no-name-in-module,import-error
+
+from .utils import lookup_runtime_lib
+
+CALIBRATION_CIRCUIT = """
+func.func @main(%arg0: tensor<{size}x!FHE.eint<{precision}>>,
+                %arg1: tensor<{size}x!FHE.eint<{precision}>>)
+    -> tensor<{size}x!FHE.eint<{precision}>> {{
+  %lut = arith.constant dense<{lut}> : tensor<{entries}xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %lut)
+    : (tensor<{size}x!FHE.eint<{precision}>>, tensor<{entries}xi64>)
+    -> tensor<{size}x!FHE.eint<{precision}>>
+  %1 = "FHELinalg.add_eint"(%0, %arg1)
+    : (tensor<{size}x!FHE.eint<{precision}>>, tensor<{size}x!FHE.eint<{precision}>>)
+    -> tensor<{size}x!FHE.eint<{precision}>>
+  return %1 : tensor<{size}x!FHE.eint<{precision}>>
+}}
+"""
+
+
+def _measure(
+    precision: int, size: int, calls: int, gpu: bool
+) -> Dict[str, List[float]]:
+    """Run a table lookup followed by an addition, returning the measured costs per work."""
+    entries = 2**precision
+    mlir_input = CALIBRATION_CIRCUIT.format(
+        size=size,
+        precision=precision,
+        entries=entries,
+        lut=list(range(entries)),
+    )
+    options = CompilationOptions(Backend.GPU if gpu else Backend.CPU)
+    # the primitives must run one at a time, or batched on the GPU
+    options.set_loop_parallelize(False)
+    options.set_dataflow_parallelize(False)
+    options.set_batch_tfhe_ops(gpu)
+
+    artifact_dir = tempfile.mkdtemp(prefix="concrete_latency_calibration_")
+    try:
+        library = Compiler(artifact_dir, lookup_runtime_lib()).compile(
+            mlir_input, options
+        )
+        program_info = library.get_program_info()
+        keyset = Keyset(program_info, None)
+        client_circuit = ClientProgram.create_encrypted(
+            program_info, keyset
+        ).get_client_circuit("main")
+        server_circuit = ServerProgram(library, False).get_server_circuit("main")
+        args = [
+            client_circuit.prepare_input(Value(np.ones(size, dtype=np.int64)), i)
+            for i in range(2)
+        ]
+        # the first call warms up the keys and the caches
+        server_circuit.call(args, keyset.get_server_keys())
+        server_circuit.enable_primitive_statistics()
+        for _ in range(calls):
+            server_circuit.call(args, keyset.get_server_keys())
+        statistics = server_circuit.get_primitive_statistics()
+    finally:
+        shutil.rmtree(artifact_dir, ignore_errors=True)
+
+    if not statistics:
+        raise RuntimeError(
+            "No primitive was recorded, the runtime must be built with "
+            "CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED"
+        )
+
+    keyset_info = program_info.get_keyset_info()
+    secret_keys = keyset_info.secret_keys()
+    bootstrap_keys = keyset_info.bootstrap_keys()
+    keyswitch_keys = keyset_info.keyswitch_keys()
+
+    def bsk_work(index):
+        bsk = bootstrap_keys[index]
+        return bootstrap_work(
+            bsk.input_lwe_dimension(),
+            bsk.level(),
+            bsk.glwe_dimension(),
+            bsk.polynomial_size(),
+        )
+
+    def ksk_work(index):
+        ksk = keyswitch_keys[index]
+        return keyswitch_work(
+            secret_keys[ksk.input_secret_key_id()].dimension(),
+            ksk.level(),
+            secret_keys[ksk.output_secret_key_id()].dimension(),
+        )
+
+    # the leveled additions are on the output of the bootstraps
+    leveled_key = secret_keys[bootstrap_keys[0].output_secret_key_id()]
+    leveled_dimension = leveled_key.dimension()
+
+    costs: Dict[str, List[float]] = {"bootstrap": [], "keyswitch": [], "leveled": []}
+    for statistic in statistics:
+        nanoseconds = statistic.nanoseconds / statistic.ciphertexts
+        if statistic.primitive == RuntimePrimitive.BOOTSTRAP:
+            costs["bootstrap"].append(nanoseconds / bsk_work(statistic.bsk_index))
+        elif statistic.primitive == RuntimePrimitive.KEYSWITCH:
+            costs["keyswitch"].append(nanoseconds / ksk_work(statistic.ksk_index))
+        elif statistic.primitive == RuntimePrimitive.KEYSWITCH_BOOTSTRAP:
+            # the fused kernels cannot be split, their cost per work is that of both
+            work = bsk_work(statistic.bsk_index) + ksk_work(statistic.ksk_index)
+            costs["bootstrap"].append(nanoseconds / work)
+            costs["keyswitch"].append(nanoseconds / work)
+        elif statistic.primitive == RuntimePrimitive.LEVELED:
+            costs["leveled"].append(nanoseconds / leveled_work(leveled_dimension))
+    return costs
+
+
+def calibrate(
+    gpu: bool = False,
+    parallelism: Optional[int] = None,
+    precisions: Sequence[int] = (2, 4, 6),
+    calls: int = 10,
+) -> dict:
+    """Measure the costs of the primitives, averaged over the precisions."""
+    size = 64 if gpu else 4
+    measured: Dict[str, List[float]] = {"bootstrap": [], "keyswitch": [], "leveled": []}
+    for precision in precisions:
+        for name, costs in _measure(precision, size, calls, gpu).items():
+            measured[name] += costs
+
+    if parallelism is None:
+        parallelism = 1 if gpu else os.cpu_count() or 1
+    table = {"parallelism": parallelism}
+    for name, costs in measured.items():
+        if costs:
+            table[name] = sum(costs) / len(costs)
+    return table
+
+
+def main():
+    """Calibrate the costs of the primitives of a device into a cost table."""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--device",
+        default="cpu",
+        help="the name of the device in the table, e.g. cpu or a GPU model, the "
+        "primitives running on the GPU for any other name than cpu",
+    )
+    parser.add_argument("--output", required=True, help="the cost table to update")
+    parser.add_argument(
+        "--parallelism",
+        type=int,
+        default=None,
+        help="the primitives the device runs at the same time, by default the "
+        "cores of the cpu, or 1 for a GPU",
+    )
+    parser.add_argument("--calls", type=int, default=10)
+    args = parser.parse_args()
+
+    table = {}
+    if os.path.exists(args.output):
+        with open(args.output, encoding="utf-8") as file:
+            table = json.load(file)
+    table[args.device] = calibrate(
+        gpu=args.device != "cpu", parallelism=args.parallelism, calls=args.calls
+    )
+    with open(args.output, "w", encoding="utf-8") as file:
+        json.dump(table, file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+#  Part of the Concrete Compiler Project, under the BSD3 License with Zama Exceptions.
+#  See https://github.com/zama-ai/concrete/blob/main/LICENSE.txt for license information.
+
+"""Analysis of the dataflow task graphs written by the runtime to DFR_TASK_GRAPH_DIR.
+
+    python -m concrete.compiler.task_graph $DFR_TASK_GRAPH_DIR
+
+reports, for each call, the parallelism achieved by its tasks, the bytes they moved between the
+nodes, and the load of each node.
+"""
+
+import argparse
+import glob
+import json
+import os
+from dataclasses import dataclass, field
+from typing import Dict, List
+
+
+@dataclass
+class NodeLoad:
+    """The tasks executed by a node during a call."""
+
+    tasks: int = 0
+    # nanoseconds, from the availability of the inputs of the tasks to that of their outputs
+    busy: int = 0
+    # bytes sent to and received from the root node
+    network_bytes: int = 0
+
+
+@dataclass
+class TaskGraphAnalysis:
+    """The analysis of the task graph of a call, the times in nanoseconds."""
+
+    tasks: int
+    duration: int
+    busy: int
+    critical_path: int
+    network_bytes: int
+    nodes: Dict[int, NodeLoad] = field(default_factory=dict)
+
+    @property
+    def achieved_parallelism(self) -> float:
+        """The average number of tasks executing during the call."""
+        return self.busy / self.duration if self.duration else 0.0
+
+    @property
+    def available_parallelism(self) -> float:
+        """The parallelism of the tasks with unbounded resources, along their critical path."""
+        return self.busy / self.critical_path if self.critical_path else 0.0
+
+    @property
+    def load_imbalance(self) -> float:
+        """The busy time of the most loaded node over the average one, 1 when balanced."""
+        loads = [node.busy for node in self.nodes.values()]
+        mean = sum(loads) / len(loads) if loads else 0
+        return max(loads) / mean if mean else 1.0
+
+
+def analyze(graph: dict) -> TaskGraphAnalysis:
+    """Analyze a task graph, the tasks still running when the call ended being ignored."""
+    nodes = {locality: NodeLoad() for locality in range(graph.get("localities", 1))}
+    busy = 0
+    network_bytes = 0
+    # the longest chain of dependent tasks ending with each task
+    chains: List[int] = []
+    tasks = graph["tasks"]
+    for task in tasks:
+        chain = 0
+        for task_input in task["inputs"]:
+            if 0 <= task_input["producer"] < len(chains):
+                chain = max(chain, chains[task_input["producer"]])
+        if "end" not in task:
+            chains.append(chain)
+            continue
+        time = task["end"] - task["start"]
+        chains.append(chain + time)
+
+        node = nodes.setdefault(task["locality"], NodeLoad())
+        node.tasks += 1
+        node.busy += time
+        busy += time
+        if task["locality"] != 0:
+            moved = sum(task_input.get("bytes", 0) for task_input in task["inputs"])
+            moved += sum(task["outputs"])
+            node.network_bytes += moved
+            network_bytes += moved
+
+    return TaskGraphAnalysis(
+        tasks=len(tasks),
+        duration=graph["end"],
+        busy=busy,
+        critical_path=max(chains, default=0),
+        network_bytes=network_bytes,
+        nodes=nodes,
+    )
+
+
+def report(analysis: TaskGraphAnalysis) -> str:
+    """Format an analysis for the terminal."""
+    lines = [
+        f"{analysis.tasks} tasks in {analysis.duration / 1e6:.3f} ms",
+        f"  achieved parallelism  {analysis.achieved_parallelism:.2f}",
+        f"  available parallelism {analysis.available_parallelism:.2f}",
+        f"  network bytes         {analysis.network_bytes}",
+        f"  load imbalance        {analysis.load_imbalance:.2f}",
+    ]
+    for locality, node in sorted(analysis.nodes.items()):
+        lines.append(
+            f"  node {locality}: {node.tasks} tasks, busy {node.busy / 1e6:.3f} ms, "
+            f"{node.network_bytes} network bytes"
+        )
+    return "\n".join(lines)
+
+
+def main():
+    """Report the analysis of task graph files, or of the directories holding them."""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("paths", nargs="+", help="task graph files or directories")
+    args = parser.parse_args()
+
+    files = []
+    for path in args.paths:
+        if os.path.isdir(path):
+            files += sorted(glob.glob(os.path.join(path, "task_graph.*.json")))
+        else:
+            files.append(path)
+    for path in files:
+        with open(path, encoding="utf-8") as file:
+            print(f"{path}: {report(analyze(json.load(file)))}")
+
+
+if __name__ == "__main__":
+    main()
@@ -26,6 +26,12 @@
 
 using concretelang::error::Result;
 using concretelang::keysets::ClientKeyset;
+using concretelang::protocol::arrayToProtoPayload;
+using concretelang::protocol::dimensionsToProtoShape;
+using concretelang::protocol::initProtoPayloadArray;
+using concretelang::protocol::protoPayloadArray;
+using concretelang::protocol::protoPayloadToVector;
+using concretelang::protocol::protoShapeToDimensions;
 using concretelang::transformers::InputTransformer;
 using concretelang::transformers::OutputTransformer;
 using concretelang::transformers::TransformerFactory;
@@ -38,15 +44,24 @@ namespace clientlib {
 bool ClientCircuit::isSimulated() { return simulated; }
 
 Result<ClientCircuit>
-ClientCircuit::create(const Message<concreteprotocol::CircuitInfo> &info,
+ClientCircuit::create(const SharedReader<concreteprotocol::CircuitInfo> &info,
                       const ClientKeyset &keyset,
                       std::shared_ptr<csprng::EncryptionCSPRNG> csprng,
                       bool useSimulation) {
 
   auto inputTransformers = std::vector<InputTransformer>();
+  auto streamInputTransformers = std::vector<StreamInputTransformer>();
+  auto batchInputTransformers = std::vector<BatchInputTransformer>();
+  auto precomputableEncryptions =
+      std::vector<std::optional<PrecomputableEncryption>>();
+  auto precomputedInputTransformers = std::vector<InputTransformer>();
 
   for (auto gateInfo : info.asReader().getInputs()) {
     InputTransformer transformer;
+    StreamInputTransformer streamTransformer;
+    BatchInputTransformer batchTransformer;
+    std::optional<PrecomputableEncryption> precomputableEncryption;
+    InputTransformer precomputedTransformer;
     if (gateInfo.getTypeInfo().hasIndex()) {
       OUTCOME_TRY(transformer,
                   TransformerFactory::getIndexInputTransformer(
@@ -60,16 +75,45 @@ ClientCircuit::create(const Message<concreteprotocol::CircuitInfo> &info,
                   TransformerFactory::getLweCiphertextInputTransformer(
                       keyset, (Message<concreteprotocol::GateInfo>)gateInfo,
                       csprng, useSimulation));
+      OUTCOME_TRY(batchTransformer,
+                  TransformerFactory::getLweCiphertextBatchInputTransformer(
+                      keyset, (Message<concreteprotocol::GateInfo>)gateInfo,
+                      csprng, useSimulation));
+      if (!useSimulation) {
+        OUTCOME_TRY(streamTransformer,
+                    TransformerFactory::getLweCiphertextStreamInputTransformer(
+                        keyset, (Message<concreteprotocol::GateInfo>)gateInfo,
+                        csprng));
+      }
+      auto lweCiphertext = gateInfo.getTypeInfo().getLweCiphertext();
+      if (!useSimulation && lweCiphertext.getCompression() ==
+                                concreteprotocol::Compression::NONE) {
+        auto encryption = lweCiphertext.getEncryption();
+        precomputableEncryption = PrecomputableEncryption{
+            keyset.lweSecretKeys[encryption.getKeyId()].getSharedBuffer(),
+            encryption.getLweDimension(), encryption.getVariance()};
+        OUTCOME_TRY(
+            precomputedTransformer,
+            TransformerFactory::getLweCiphertextPrecomputedInputTransformer(
+                keyset, (Message<concreteprotocol::GateInfo>)gateInfo,
+                csprng));
+      }
     } else {
       return StringError("Malformed input gate info.");
     }
     inputTransformers.push_back(transformer);
+    streamInputTransformers.push_back(streamTransformer);
+    batchInputTransformers.push_back(batchTransformer);
+    precomputableEncryptions.push_back(precomputableEncryption);
+    precomputedInputTransformers.push_back(precomputedTransformer);
   }
 
   auto outputTransformers = std::vector<OutputTransformer>();
+  auto batchOutputTransformers = std::vector<BatchOutputTransformer>();
 
   for (auto gateInfo : info.asReader().getOutputs()) {
     OutputTransformer transformer;
+    BatchOutputTransformer batchTransformer;
     if (gateInfo.getTypeInfo().hasIndex()) {
       OUTCOME_TRY(transformer,
                   TransformerFactory::getIndexOutputTransformer(
@@ -83,27 +127,41 @@ ClientCircuit::create(const Message<concreteprotocol::CircuitInfo> &info,
                   TransformerFactory::getLweCiphertextOutputTransformer(
                       keyset, (Message<concreteprotocol::GateInfo>)gateInfo,
                       useSimulation));
+      OUTCOME_TRY(batchTransformer,
+                  TransformerFactory::getLweCiphertextBatchOutputTransformer(
+                      keyset, (Message<concreteprotocol::GateInfo>)gateInfo,
+                      useSimulation));
     } else {
       return StringError("Malformed output gate info.");
     }
     outputTransformers.push_back(transformer);
+    batchOutputTransformers.push_back(batchTransformer);
   }
 
-  return ClientCircuit(info, inputTransformers, outputTransformers,
-                       useSimulation);
+  return ClientCircuit(info, inputTransformers, streamInputTransformers,
+                       batchInputTransformers, outputTransformers,
+                       batchOutputTransformers, csprng,
+                       precomputableEncryptions,
+                       precomputedInputTransformers, useSimulation);
 }
 
 Result<ClientCircuit> ClientCircuit::createEncrypted(
     const Message<concreteprotocol::CircuitInfo> &info,
     const ClientKeyset &keyset,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
-  return ClientCircuit::create(info, keyset, csprng, false);
+  return ClientCircuit::create(
+      SharedReader<concreteprotocol::CircuitInfo>(
+          Message<concreteprotocol::CircuitInfo>(info)),
+      keyset, csprng, false);
 }
 
 Result<ClientCircuit> ClientCircuit::createSimulated(
     const Message<concreteprotocol::CircuitInfo> &info,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
-  return ClientCircuit::create(info, ClientKeyset(), csprng, true);
+  return ClientCircuit::create(
+      SharedReader<concreteprotocol::CircuitInfo>(
+          Message<concreteprotocol::CircuitInfo>(info)),
+      ClientKeyset(), csprng, true);
 }
 
 Result<TransportValue> ClientCircuit::prepareInput(Value arg, size_t pos) {
@@ -113,9 +171,69 @@ Result<TransportValue> ClientCircuit::prepareInput(Value arg, size_t pos) {
   if (pos >= inputTransformers.size()) {
     return StringError("Tried to prepare a Value for incorrect position.");
   }
+  auto pool = getPrecomputationPool(pos, false);
+  if (pool != nullptr && pool->getPrecomputedEncryptions(
+                             precomputableEncryptions[pos]->key) > 0) {
+    return precomputedInputTransformers[pos](arg);
+  }
   return inputTransformers[pos](arg);
 }
 
+csprng::EncryptionRandomnessPool *
+ClientCircuit::getPrecomputationPool(size_t pos, bool create) {
+  auto &encryption = precomputableEncryptions[pos];
+  if (!encryption.has_value()) {
+    return nullptr;
+  }
+  return csprng->getPrecomputationPool(encryption->lweDimension,
+                                       encryption->variance, create);
+}
+
+Result<void> ClientCircuit::precomputeInputEncryptions(size_t pos,
+                                                       size_t count) {
+  if (simulated) {
+    return StringError(
+        "Called precomputeInputEncryptions on simulated client circuit.");
+  }
+  if (pos >= inputTransformers.size()) {
+    return StringError("Tried to precompute encryptions for incorrect "
+                       "position.");
+  }
+  auto pool = getPrecomputationPool(pos, true);
+  if (pool == nullptr) {
+    return StringError("Tried to precompute encryptions for an input which "
+                       "is not an uncompressed ciphertext.");
+  }
+  pool->precomputeEncryptions(precomputableEncryptions[pos]->key, count);
+  return outcome::success();
+}
+
+Result<size_t> ClientCircuit::getPrecomputedInputEncryptions(size_t pos) {
+  if (pos >= inputTransformers.size()) {
+    return StringError("Tried to get encryptions for incorrect position.");
+  }
+  auto pool = getPrecomputationPool(pos, false);
+  if (pool == nullptr) {
+    return (size_t)0;
+  }
+  return pool->getPrecomputedEncryptions(precomputableEncryptions[pos]->key);
+}
+
+Result<TransportValueStream>
+ClientCircuit::prepareInputStream(Value arg, size_t pos, size_t chunkSize) {
+  if (simulated) {
+    return StringError(
+        "Called prepareInputStream on simulated client circuit.");
+  }
+  if (pos >= inputTransformers.size()) {
+    return StringError("Tried to prepare a Value for incorrect position.");
+  }
+  if (!streamInputTransformers[pos]) {
+    return StringError("Tried to stream a Value for a non-ciphertext input.");
+  }
+  return streamInputTransformers[pos](arg, chunkSize);
+}
+
 Result<Value> ClientCircuit::processOutput(TransportValue result, size_t pos) {
   if (simulated) {
     return StringError("Called processOutput on simulated client circuit.");
@@ -127,6 +245,47 @@ Result<Value> ClientCircuit::processOutput(TransportValue result, size_t pos) {
   return outputTransformers[pos](result);
 }
 
+Result<std::vector<TransportValue>>
+ClientCircuit::prepareInputs(std::vector<Value> args, size_t pos) {
+  if (simulated) {
+    return StringError("Called prepareInputs on simulated client circuit.");
+  }
+  if (pos >= inputTransformers.size()) {
+    return StringError("Tried to prepare a Value for incorrect position.");
+  }
+  if (batchInputTransformers[pos]) {
+    return batchInputTransformers[pos](args);
+  }
+  std::vector<TransportValue> results;
+  results.reserve(args.size());
+  for (auto &arg : args) {
+    OUTCOME_TRY(auto result, inputTransformers[pos](std::move(arg)));
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+Result<std::vector<Value>>
+ClientCircuit::processOutputs(std::vector<TransportValue> results, size_t pos) {
+  if (simulated) {
+    return StringError("Called processOutputs on simulated client circuit.");
+  }
+  if (pos >= outputTransformers.size()) {
+    return StringError(
+        "Tried to process a TransportValue for incorrect position.");
+  }
+  if (batchOutputTransformers[pos]) {
+    return batchOutputTransformers[pos](results);
+  }
+  std::vector<Value> values;
+  values.reserve(results.size());
+  for (auto &result : results) {
+    OUTCOME_TRY(auto value, outputTransformers[pos](result));
+    values.push_back(std::move(value));
+  }
+  return values;
+}
+
 Result<TransportValue> ClientCircuit::simulatePrepareInput(Value arg,
                                                            size_t pos) {
   if (!simulated) {
@@ -156,7 +315,8 @@ std::string ClientCircuit::getName() {
   return circuitInfo.asReader().getName();
 }
 
-const Message<concreteprotocol::CircuitInfo> &ClientCircuit::getCircuitInfo() {
+const SharedReader<concreteprotocol::CircuitInfo> &
+ClientCircuit::getCircuitInfo() {
   return circuitInfo;
 }
 
@@ -165,11 +325,15 @@ Result<ClientProgram> ClientProgram::createEncrypted(
     const ClientKeyset &keyset,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
   ClientProgram output;
-  for (auto circuitInfo : info.asReader().getCircuits()) {
+  // The circuits hold views on a single copy of the program info
+  auto sharedInfo = SharedReader<concreteprotocol::ProgramInfo>(
+      Message<concreteprotocol::ProgramInfo>(info));
+  for (auto circuitInfo : sharedInfo.asReader().getCircuits()) {
     OUTCOME_TRY(const ClientCircuit clientCircuit,
-                ClientCircuit::createEncrypted(
-                    (Message<concreteprotocol::CircuitInfo>)circuitInfo, keyset,
-                    csprng));
+                ClientCircuit::create(
+                    SharedReader<concreteprotocol::CircuitInfo>(sharedInfo,
+                                                                circuitInfo),
+                    keyset, csprng, false));
     output.circuits.push_back(clientCircuit);
   }
   return output;
@@ -179,18 +343,21 @@ Result<ClientProgram> ClientProgram::createSimulated(
     const Message<concreteprotocol::ProgramInfo> &info,
     std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
   ClientProgram output;
-  for (auto circuitInfo : info.asReader().getCircuits()) {
-    OUTCOME_TRY(
-        const ClientCircuit clientCircuit,
-        ClientCircuit::createSimulated(
-            (Message<concreteprotocol::CircuitInfo>)circuitInfo, csprng));
+  auto sharedInfo = SharedReader<concreteprotocol::ProgramInfo>(
+      Message<concreteprotocol::ProgramInfo>(info));
+  for (auto circuitInfo : sharedInfo.asReader().getCircuits()) {
+    OUTCOME_TRY(const ClientCircuit clientCircuit,
+                ClientCircuit::create(
+                    SharedReader<concreteprotocol::CircuitInfo>(sharedInfo,
+                                                                circuitInfo),
+                    ClientKeyset(), csprng, true));
     output.circuits.push_back(clientCircuit);
   }
   return output;
 }
 
 Result<ClientCircuit> ClientProgram::getClientCircuit(std::string circuitName) {
-  for (auto circuit : circuits) {
+  for (auto &circuit : circuits) {
     if (circuit.getName() == circuitName) {
       return circuit;
     }
@@ -232,16 +399,32 @@ Result<TransportValue> importTfhersInteger(llvm::ArrayRef<uint8_t> buffer,
   std::vector<uint32_t> concreteDims(abstractDims.begin(), abstractDims.end());
   concreteDims.push_back(integerDesc.lwe_size);
   std::vector<size_t> dims(concreteDims.begin(), concreteDims.end());
+  size_t lweArraySize =
+      tensorFlatSize * integerDesc.n_cts * integerDesc.lwe_size;
 
-  auto outputTensor = Tensor<uint64_t>::fromDimensions(dims);
-  auto err =
-      conversion_func(buffer.data(), buffer.size(), outputTensor.values.data(),
-                      tensorFlatSize, integerDesc);
+  auto value = TransportValue();
+  auto rawInfo = value.asBuilder().initRawInfo();
+  rawInfo.setShape(dimensionsToProtoShape(dims).asReader());
+  rawInfo.setIntegerPrecision(64);
+  rawInfo.setIsSigned(false);
+  // the integers are converted straight into the payload of the value, unless
+  // it is too large for a single blob
+  auto payload = value.asBuilder().initPayload();
+  auto lweArray = initProtoPayloadArray<uint64_t>(lweArraySize, payload);
+  std::vector<uint64_t> lweVector;
+  if (lweArray == nullptr) {
+    lweVector.resize(lweArraySize);
+    lweArray = lweVector.data();
+  }
+  auto err = conversion_func(buffer.data(), buffer.size(), lweArray,
+                             tensorFlatSize, integerDesc);
   if (err) {
     return StringError("couldn't convert fheint to lwe array");
   }
+  if (!lweVector.empty()) {
+    arrayToProtoPayload(lweVector.data(), lweVector.size(), payload);
+  }
 
-  auto value = Value{outputTensor}.intoRawTransportValue();
   auto lwe = value.asBuilder().initTypeInfo().initLweCiphertext();
   lwe.setIntegerPrecision(64);
   // dimensions
@@ -288,27 +471,33 @@ exportTfhersInteger(TransportValue value, TfhersFheIntDescription integerDesc) {
     return StringError(errorMsg);
   }
 
-  auto fheuint = Value::fromRawTransportValue(value);
-  if (fheuint.isScalar()) {
-    return StringError("expected a tensor, but value is a scalar");
-  }
-  auto tensorOrError = fheuint.getTensor<uint64_t>();
-  if (!tensorOrError.has_value()) {
+  auto rawInfo = value.asReader().getRawInfo();
+  if (rawInfo.getIntegerPrecision() != 64 || rawInfo.getIsSigned()) {
     return StringError("couldn't get tensor from value");
   }
-  auto concreteShape = tensorOrError.value().dimensions;
-  assert(concreteShape.size() >= 2);
+  auto concreteShape = protoShapeToDimensions(rawInfo.getShape());
+  if (concreteShape.size() < 2) {
+    return StringError("expected a tensor of radix encoded lwe ciphertexts");
+  }
   std::vector<size_t> tensorShape(concreteShape.begin(),
                                   concreteShape.end() -
                                       2 /* remove radix and lwe dims */);
   size_t tensorFlatSize = std::accumulate(
       tensorShape.begin(), tensorShape.end(), 1, std::multiplies<size_t>());
+  // the ciphertexts are read in place from the payload, unless it spans
+  // several blobs
+  auto payload = value.asReader().getPayload();
+  auto lweArray = protoPayloadArray<uint64_t>(payload);
+  std::vector<uint64_t> lweVector;
+  if (lweArray == nullptr) {
+    lweVector = protoPayloadToVector<uint64_t>(payload);
+    lweArray = lweVector.data();
+  }
   // TODO: compute new buffer size of tensor
   size_t buffer_size = concrete_cpu_tfhers_fheint_buffer_size_u64(
       integerDesc.lwe_size, integerDesc.n_cts, tensorFlatSize);
   std::vector<uint8_t> buffer(buffer_size, 0);
-  auto flat_data = tensorOrError.value().values;
-  auto size = conversion_func(flat_data.data(), buffer.data(), buffer.size(),
+  auto size = conversion_func(lweArray, buffer.data(), buffer.size(),
                               tensorFlatSize, integerDesc);
   if (size == 0) {
     return StringError("couldn't convert lwe array to fheint8");
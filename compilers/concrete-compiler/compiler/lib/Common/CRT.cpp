@@ -65,26 +65,26 @@ int64_t modInverse(int64_t a, int64_t m) {
 uint64_t iCrt(std::vector<int64_t> moduli, std::vector<int64_t> remainders) {
   // Compute the product of moduli
   int64_t product = productOfModuli(moduli);
+  auto coefficients = iCrtCoefficients(moduli);
 
   int64_t result = 0;
 
   // Apply above formula
   for (size_t i = 0; i < remainders.size(); i++) {
-    int tmp = product / moduli[i];
-    result += remainders[i] * modInverse(tmp, moduli[i]) * tmp;
+    result += remainders[i] * coefficients[i];
   }
 
   return result % product;
 }
 
-uint64_t encode(int64_t plaintext, uint64_t modulus, uint64_t product) {
-  // values are represented on the interval [0; product[ so we represent
-  // plaintext on this interval
-  if (plaintext < 0) {
-    plaintext = product + plaintext;
+std::vector<int64_t> iCrtCoefficients(const std::vector<int64_t> &moduli) {
+  int64_t product = productOfModuli(moduli);
+  std::vector<int64_t> coefficients(moduli.size());
+  for (size_t i = 0; i < moduli.size(); i++) {
+    int64_t tmp = product / moduli[i];
+    coefficients[i] = modInverse(tmp, moduli[i]) * tmp;
   }
-  __uint128_t m = plaintext % modulus;
-  return m * ((__uint128_t)(1) << 64) / modulus;
+  return coefficients;
 }
 
 uint64_t decode(uint64_t val, uint64_t modulus) {
@@ -3,8 +3,11 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include <algorithm>
 #include <cstddef>
+#include <map>
 #include <stdio.h>
+#include <utility>
 
 #include "concrete-cpu.h"
 #include "concretelang/Common/Csprng.h"
@@ -25,6 +28,25 @@ void getRandomSeed(struct Uint128 *u128) {
   }
 }
 
+CsprngBackend getCsprngBackend() { return concrete_cpu_get_csprng_backend(); }
+
+bool setCsprngBackend(CsprngBackend backend) {
+  return concrete_cpu_set_csprng_backend(backend) == 1;
+}
+
+const char *getCsprngBackendName(CsprngBackend backend) {
+  switch (backend) {
+  case CsprngBackend::Software:
+    return "software";
+  case CsprngBackend::AesNi:
+    return "aesni";
+  case CsprngBackend::ArmAes:
+    return "armaes";
+  }
+  assert(false && "unknown csprng backend");
+  return "unknown";
+}
+
 SoftCSPRNG::SoftCSPRNG(__uint128_t seed) : CSPRNG<Csprng>(nullptr) {
   ptr = (Csprng *)aligned_alloc(CSPRNG_ALIGN, CSPRNG_SIZE);
   struct Uint128 u128;
@@ -76,7 +98,7 @@ SecretCSPRNG::~SecretCSPRNG() {
 }
 
 EncryptionCSPRNG::EncryptionCSPRNG(__uint128_t seed)
-    : CSPRNG<EncCsprng>(nullptr) {
+    : CSPRNG<EncCsprng>(nullptr), pools(std::make_unique<Pools>()) {
   ptr = (EncCsprng *)aligned_alloc(ENCRYPTION_CSPRNG_ALIGN,
                                    ENCRYPTION_CSPRNG_SIZE);
   struct Uint128 u128;
@@ -90,8 +112,11 @@ EncryptionCSPRNG::EncryptionCSPRNG(__uint128_t seed)
   concrete_cpu_construct_encryption_csprng(ptr, u128);
 }
 
+EncryptionCSPRNG::EncryptionCSPRNG(EncCsprng *ptr)
+    : CSPRNG<EncCsprng>(ptr), pools(std::make_unique<Pools>()) {}
+
 EncryptionCSPRNG::EncryptionCSPRNG(EncryptionCSPRNG &&other)
-    : CSPRNG(other.ptr) {
+    : CSPRNG(other.ptr), pools(std::move(other.pools)) {
   assert(ptr != nullptr);
   other.ptr = nullptr;
 }
@@ -103,6 +128,161 @@ EncryptionCSPRNG::~EncryptionCSPRNG() {
   }
 }
 
+EncryptionCSPRNG EncryptionCSPRNG::fork() {
+  auto child = (EncCsprng *)aligned_alloc(ENCRYPTION_CSPRNG_ALIGN,
+                                          ENCRYPTION_CSPRNG_SIZE);
+  concrete_cpu_fork_encryption_csprng(child, ptr);
+  return EncryptionCSPRNG(child);
+}
+
+/// Block size of the pools generating their randomness on demand, in
+/// ciphertexts
+const size_t ON_DEMAND_BLOCK_SIZE = 64;
+
+struct EncryptionCSPRNG::Pools {
+  std::mutex mutex;
+  /// Whether the buffered mode is enabled, the pools created before keeping
+  /// generating their randomness on demand
+  bool buffered = false;
+  size_t blockSize = ON_DEMAND_BLOCK_SIZE;
+  bool background = false;
+  std::map<std::pair<size_t, double>,
+           std::unique_ptr<EncryptionRandomnessPool>>
+      pools;
+};
+
+void EncryptionCSPRNG::enableBuffering(size_t blockSize, bool background) {
+  assert(blockSize > 0);
+  std::lock_guard<std::mutex> guard(pools->mutex);
+  pools->buffered = true;
+  pools->blockSize = blockSize;
+  pools->background = background;
+}
+
+EncryptionRandomnessPool *
+EncryptionCSPRNG::getRandomnessPool(size_t lweDimension, double variance) {
+  return getPool(lweDimension, variance, true, true);
+}
+
+EncryptionRandomnessPool *
+EncryptionCSPRNG::getPrecomputationPool(size_t lweDimension, double variance,
+                                        bool create) {
+  return getPool(lweDimension, variance, false, create);
+}
+
+EncryptionRandomnessPool *EncryptionCSPRNG::getPool(size_t lweDimension,
+                                                    double variance,
+                                                    bool onlyBuffered,
+                                                    bool create) {
+  std::lock_guard<std::mutex> guard(pools->mutex);
+  if (onlyBuffered && !pools->buffered) {
+    return nullptr;
+  }
+  auto &pool = pools->pools[{lweDimension, variance}];
+  if (pool == nullptr && create) {
+    pool = std::make_unique<EncryptionRandomnessPool>(
+        fork(), lweDimension, variance, pools->blockSize, pools->background);
+  }
+  return pool.get();
+}
+
+EncryptionRandomnessPool::EncryptionRandomnessPool(EncryptionCSPRNG csprng,
+                                                   size_t lweDimension,
+                                                   double variance,
+                                                   size_t blockSize,
+                                                   bool background)
+    : csprng(std::move(csprng)), lweDimension(lweDimension),
+      variance(variance), blockSize(blockSize), background(background) {
+  if (background) {
+    // The first block is ready before the first request
+    nextBlock = std::async(std::launch::async,
+                           [this]() { return generateBlock(); });
+  }
+}
+
+std::vector<uint64_t> EncryptionRandomnessPool::generateBlock() {
+  std::vector<uint64_t> output(blockSize * (lweDimension + 1));
+  concrete_cpu_fill_lwe_encryption_randomness_u64(
+      output.data(), blockSize, lweDimension, variance, csprng.ptr,
+      Parallelism::Rayon);
+  return output;
+}
+
+void EncryptionRandomnessPool::take(uint64_t *output, size_t count) {
+  std::lock_guard<std::mutex> guard(mutex);
+  size_t remaining = count * (lweDimension + 1);
+  while (remaining > 0) {
+    if (offset == block.size()) {
+      // Only one block is generated at a time, so the generator is never
+      // used concurrently
+      block = nextBlock.valid() ? nextBlock.get() : generateBlock();
+      offset = 0;
+      if (background) {
+        nextBlock = std::async(std::launch::async,
+                               [this]() { return generateBlock(); });
+      }
+    }
+    size_t size = std::min(remaining, block.size() - offset);
+    std::copy_n(block.begin() + offset, size, output);
+    output += size;
+    offset += size;
+    remaining -= size;
+  }
+}
+
+void EncryptionRandomnessPool::encrypt(const uint64_t *key, uint64_t *output,
+                                       size_t count) {
+  std::vector<uint64_t> zeros(count, 0);
+  auto parallelism = count > 1 ? Parallelism::Rayon : Parallelism::No;
+  take(output, count);
+  concrete_cpu_encrypt_lwe_ciphertext_vector_with_randomness_u64(
+      key, output, zeros.data(), count, lweDimension, parallelism);
+}
+
+std::vector<uint64_t> &EncryptionRandomnessPool::getEncryptions(
+    std::shared_ptr<const std::vector<uint64_t>> key) {
+  auto &entry = encryptions[key.get()];
+  if (entry.key.lock() != key) {
+    entry.key = key;
+    entry.ciphertexts.clear();
+  }
+  return entry.ciphertexts;
+}
+
+void EncryptionRandomnessPool::precomputeEncryptions(
+    std::shared_ptr<const std::vector<uint64_t>> key, size_t count) {
+  // Encrypted outside of the lock of the encryptions, which keeps serving
+  // `takeEncryptions`
+  std::vector<uint64_t> fresh(count * (lweDimension + 1));
+  encrypt(key->data(), fresh.data(), count);
+  std::lock_guard<std::mutex> guard(encryptionsMutex);
+  auto &ciphertexts = getEncryptions(key);
+  ciphertexts.insert(ciphertexts.end(), fresh.begin(), fresh.end());
+}
+
+void EncryptionRandomnessPool::takeEncryptions(
+    std::shared_ptr<const std::vector<uint64_t>> key, uint64_t *output,
+    size_t count) {
+  size_t lweSize = lweDimension + 1;
+  size_t taken;
+  {
+    std::lock_guard<std::mutex> guard(encryptionsMutex);
+    auto &ciphertexts = getEncryptions(key);
+    taken = std::min(count, ciphertexts.size() / lweSize);
+    auto first = ciphertexts.end() - taken * lweSize;
+    std::copy(first, ciphertexts.end(), output);
+    ciphertexts.erase(first, ciphertexts.end());
+  }
+  if (taken < count)
+    encrypt(key->data(), output + taken * lweSize, count - taken);
+}
+
+size_t EncryptionRandomnessPool::getPrecomputedEncryptions(
+    std::shared_ptr<const std::vector<uint64_t>> key) {
+  std::lock_guard<std::mutex> guard(encryptionsMutex);
+  return getEncryptions(key).size() / (lweDimension + 1);
+}
+
 void writeSeed(struct Uint128 seed, uint64_t *buffer) {
   buffer[0] = (uint64_t)seed.little_endian_bytes[0];
   buffer[0] += (uint64_t)seed.little_endian_bytes[1] << 8;
@@ -122,7 +302,7 @@ void writeSeed(struct Uint128 seed, uint64_t *buffer) {
   buffer[1] += (uint64_t)seed.little_endian_bytes[15] << 56;
 }
 
-void readSeed(struct Uint128 &seed, uint64_t *buffer) {
+void readSeed(struct Uint128 &seed, const uint64_t *buffer) {
   seed.little_endian_bytes[0] = buffer[0];
   seed.little_endian_bytes[1] = buffer[0] >> 8;
   seed.little_endian_bytes[2] = buffer[0] >> 16;
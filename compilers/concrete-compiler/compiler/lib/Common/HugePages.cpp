@@ -0,0 +1,194 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <strings.h>
+#include <unordered_map>
+
+#include "concretelang/Common/HugePages.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace concretelang {
+namespace huge_pages {
+
+namespace {
+
+const size_t PAGE_SIZE = 4096;
+const size_t GIGA_PAGE_SIZE = 1024 * 1024 * 1024;
+
+Policy getDefaultPolicy() {
+  const char *env = std::getenv("CONCRETE_HUGE_PAGES");
+  if (env != nullptr)
+    return getPolicyByName(env).value_or(Policy::NONE);
+  // The former switch of the huge pages of the memory pool
+  env = std::getenv("CONCRETE_HOST_MEMORY_POOL_HUGE_PAGES");
+  if (env != nullptr && getPolicyByName(env) == Policy::TRANSPARENT)
+    return Policy::TRANSPARENT;
+  return Policy::NONE;
+}
+
+std::atomic<Policy> &policy() {
+  static std::atomic<Policy> current{getDefaultPolicy()};
+  return current;
+}
+
+size_t roundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+#ifdef __linux__
+/// The lengths of the mappings of the buffers, which are rounded up to their
+/// page size and may not follow the policy the buffers are freed with.
+struct Mappings {
+  std::mutex mutex;
+  std::unordered_map<void *, size_t> lengths;
+};
+
+Mappings &mappings() {
+  // Never destroyed, the keys may be freed at exit after the static objects
+  static Mappings *instance = new Mappings();
+  return *instance;
+}
+
+void *mapHugeTlb(size_t size, size_t pageSize, int pageFlag, size_t &length) {
+#ifdef MAP_HUGETLB
+  length = roundUp(size, pageSize);
+  void *ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | pageFlag, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+#else
+  return nullptr;
+#endif
+}
+
+void *mapTransparent(size_t size, bool huge, size_t &length) {
+  // Mapping one huge page more lets the buffer start on a huge page boundary,
+  // the unaligned ends are unmapped
+  length = roundUp(size, huge ? HUGE_PAGE_SIZE : PAGE_SIZE);
+  size_t mapped = huge ? length + HUGE_PAGE_SIZE : length;
+  void *raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+    return nullptr;
+  if (!huge)
+    return raw;
+  uintptr_t begin = (uintptr_t)raw;
+  uintptr_t aligned = roundUp(begin, HUGE_PAGE_SIZE);
+  if (aligned > begin)
+    munmap(raw, aligned - begin);
+  uintptr_t end = begin + mapped;
+  if (end > aligned + length)
+    munmap((void *)(aligned + length), end - aligned - length);
+#ifdef MADV_HUGEPAGE
+  madvise((void *)aligned, length, MADV_HUGEPAGE);
+#endif
+  return (void *)aligned;
+}
+#endif
+
+} // namespace
+
+Policy getPolicy() { return policy().load(std::memory_order_relaxed); }
+
+void setPolicy(Policy newPolicy) {
+  policy().store(newPolicy, std::memory_order_relaxed);
+}
+
+const char *getPolicyName(Policy policy) {
+  switch (policy) {
+  case Policy::NONE:
+    return "off";
+  case Policy::TRANSPARENT:
+    return "transparent";
+  case Policy::EXPLICIT_2MB:
+    return "2mb";
+  case Policy::EXPLICIT_1GB:
+    return "1gb";
+  }
+  return "unknown";
+}
+
+std::optional<Policy> getPolicyByName(const char *name) {
+  if (!strcasecmp(name, "off") || !strcasecmp(name, "false") ||
+      !strcmp(name, "0"))
+    return Policy::NONE;
+  if (!strcasecmp(name, "transparent") || !strcasecmp(name, "on") ||
+      !strcasecmp(name, "true") || !strcmp(name, "1"))
+    return Policy::TRANSPARENT;
+  if (!strcasecmp(name, "2mb"))
+    return Policy::EXPLICIT_2MB;
+  if (!strcasecmp(name, "1gb"))
+    return Policy::EXPLICIT_1GB;
+  return std::nullopt;
+}
+
+void *allocate(size_t size) { return allocate(size, getPolicy()); }
+
+void *allocate(size_t size, Policy current) {
+#ifdef __linux__
+  size_t length = 0;
+  void *ptr = nullptr;
+#ifdef MAP_HUGE_1GB
+  if (current == Policy::EXPLICIT_1GB && size >= GIGA_PAGE_SIZE)
+    ptr = mapHugeTlb(size, GIGA_PAGE_SIZE, MAP_HUGE_1GB, length);
+#endif
+#ifdef MAP_HUGE_2MB
+  if (ptr == nullptr && (current == Policy::EXPLICIT_2MB ||
+                         current == Policy::EXPLICIT_1GB))
+    ptr = mapHugeTlb(size, HUGE_PAGE_SIZE, MAP_HUGE_2MB, length);
+#endif
+  if (ptr == nullptr)
+    ptr = mapTransparent(size, current != Policy::NONE, length);
+  if (ptr == nullptr)
+    return nullptr;
+  Mappings &registry = mappings();
+  std::lock_guard<std::mutex> guard(registry.mutex);
+  registry.lengths[ptr] = length;
+  return ptr;
+#else
+  return std::aligned_alloc(PAGE_SIZE, roundUp(size, PAGE_SIZE));
+#endif
+}
+
+void deallocate(void *ptr, size_t size) {
+  if (ptr == nullptr)
+    return;
+#ifdef __linux__
+  Mappings &registry = mappings();
+  size_t length = size;
+  {
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    auto it = registry.lengths.find(ptr);
+    if (it != registry.lengths.end()) {
+      length = it->second;
+      registry.lengths.erase(it);
+    }
+  }
+  munmap(ptr, length);
+#else
+  std::free(ptr);
+#endif
+}
+
+void advise(void *ptr, size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (getPolicy() == Policy::NONE || size < HUGE_PAGE_SIZE)
+    return;
+  uintptr_t begin = roundUp((uintptr_t)ptr, HUGE_PAGE_SIZE);
+  uintptr_t end = ((uintptr_t)ptr + size) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (end > begin)
+    madvise((void *)begin, end - begin, MADV_HUGEPAGE);
+#endif
+}
+
+} // namespace huge_pages
+} // namespace concretelang
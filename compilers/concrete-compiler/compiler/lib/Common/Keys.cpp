@@ -9,7 +9,9 @@
 #include "concrete-cpu.h"
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Csprng.h"
+#include "concretelang/Common/HugePages.h"
 #include "concretelang/Common/Protocol.h"
+#include <algorithm>
 #include <climits>
 #include <cstdint>
 #include <memory>
@@ -17,27 +19,65 @@
 
 using concretelang::csprng::EncryptionCSPRNG;
 using concretelang::csprng::SecretCSPRNG;
+using concretelang::protocol::arrayToProtoPayload;
 using concretelang::protocol::Message;
 using concretelang::protocol::protoPayloadToSharedVector;
-using concretelang::protocol::vectorToProtoPayload;
 
 namespace concretelang {
 namespace keys {
 
+namespace {
+std::atomic<uint64_t> keyDecompressions{0};
+
+/// Advises the kernel to back the buffer of a key with huge pages, the keys
+/// being read in full by every bootstrap or keyswitch.
+void adviseHugePages(std::vector<uint64_t> &buffer) {
+  huge_pages::advise(buffer.data(), buffer.size() * sizeof(uint64_t));
+}
+} // namespace
+
+uint64_t getKeyDecompressionCount() {
+  return keyDecompressions.load(std::memory_order_relaxed);
+}
+
 template <typename ProtoKey, typename ProtoKeyInfo, typename Key>
 Message<ProtoKey> keyToProto(const Key &key) {
   Message<ProtoKey> output;
   auto proto = output.asBuilder();
   proto.setInfo(key.getInfo().asReader());
-  proto.setPayload(vectorToProtoPayload(key.getTransportBuffer()).asReader());
+  auto buffer = key.getTransportBuffer();
+  arrayToProtoPayload(buffer.data(), buffer.size(), proto.initPayload());
   return std::move(output);
 }
 
+/// Returns a view over the payload inside of the `mapping` it is read from,
+/// or nothing if its blobs are not contiguous and aligned, in which case the
+/// payload must be copied.
+std::optional<KeyBuffer>
+protoPayloadToMappedBuffer(concreteprotocol::Payload::Reader reader,
+                           std::shared_ptr<const void> mapping) {
+  auto payloadData = reader.getData();
+  if (payloadData.size() == 0)
+    return std::nullopt;
+  auto begin = payloadData[0].begin();
+  auto end = begin;
+  for (auto blob : payloadData) {
+    if (blob.begin() != end)
+      return std::nullopt;
+    end = blob.end();
+  }
+  if (reinterpret_cast<uintptr_t>(begin) % alignof(uint64_t) != 0 ||
+      (end - begin) % sizeof(uint64_t) != 0)
+    return std::nullopt;
+  return KeyBuffer(mapping, reinterpret_cast<const uint64_t *>(begin),
+                   (end - begin) / sizeof(uint64_t));
+}
+
 void writeSeed(struct Uint128 seed, std::vector<uint64_t> &buffer) {
   csprng::writeSeed(seed, buffer.data());
 }
 
-void readSeed(struct Uint128 &seed, std::vector<uint64_t> &buffer) {
+void readSeed(struct Uint128 &seed, const KeyBuffer &buffer) {
   csprng::readSeed(seed, buffer.data());
 }
 
@@ -93,6 +133,37 @@ const std::vector<uint64_t> &LweSecretKey::getBuffer() const {
   return *this->buffer;
 }
 
+/// Initializes a multi-bit bootstrap key: for each group of
+/// `grouping_factor` input key bits, the GGSW encryptions of the
+/// 2^grouping_factor products selecting each bit or its complement, the first
+/// bit of the group being the most significant one of the product index.
+static void initMultiBitBootstrapKey(
+    uint64_t *bsk, const uint64_t *input_sk, const uint64_t *output_sk,
+    concreteprotocol::LweBootstrapKeyParams::Reader params,
+    EncryptionCSPRNG &csprng) {
+  size_t grouping_factor = params.getGroupingFactor();
+  size_t ggsw_size = concrete_cpu_ggsw_ciphertext_size_u64(
+      params.getGlweDimension(), params.getPolynomialSize(),
+      params.getLevelCount());
+  size_t ggsw_per_group = (size_t)1 << grouping_factor;
+  size_t groups = params.getInputLweDimension() / grouping_factor;
+  for (size_t group = 0; group < groups; group++) {
+    const uint64_t *key_bits = input_sk + group * grouping_factor;
+    for (size_t index = 0; index < ggsw_per_group; index++) {
+      uint64_t plaintext = 1;
+      for (size_t bit = 0; bit < grouping_factor; bit++) {
+        bool selected = (index >> (grouping_factor - 1 - bit)) & 1;
+        plaintext *= selected ? key_bits[bit] : 1 - key_bits[bit];
+      }
+      concrete_cpu_encrypt_ggsw_ciphertext_u64(
+          output_sk, bsk + (group * ggsw_per_group + index) * ggsw_size,
+          plaintext, params.getGlweDimension(), params.getPolynomialSize(),
+          params.getLevelCount(), params.getBaseLog(), params.getVariance(),
+          csprng.ptr);
+    }
+  }
+}
+
 LweBootstrapKey::LweBootstrapKey(
     Message<concreteprotocol::LweBootstrapKeyInfo> info,
     const LweSecretKey &inputKey, const LweSecretKey &outputKey,
@@ -107,11 +178,27 @@ LweBootstrapKey::LweBootstrapKey(
   auto params = info.asReader().getParams();
   auto compression = info.asReader().getCompression();
 
+  if (params.getGroupingFactor() > 1) {
+    assert(compression == concreteprotocol::Compression::NONE &&
+           "Multi-bit bootstrap keys cannot be compressed");
+    assert(params.getInputLweDimension() % params.getGroupingFactor() == 0);
+    buffer->resize(params.getInputLweDimension() / params.getGroupingFactor() *
+                   ((size_t)1 << params.getGroupingFactor()) *
+                   concrete_cpu_ggsw_ciphertext_size_u64(
+                       params.getGlweDimension(), params.getPolynomialSize(),
+                       params.getLevelCount()));
+    adviseHugePages(*buffer);
+    initMultiBitBootstrapKey(buffer->data(), inputKey.buffer->data(),
+                             outputKey.buffer->data(), params, csprng);
+    return;
+  }
+
   switch (compression) {
   case concreteprotocol::Compression::NONE:
     buffer->resize(concrete_cpu_bootstrap_key_size_u64(
         params.getLevelCount(), params.getGlweDimension(),
         params.getPolynomialSize(), params.getInputLweDimension()));
+    adviseHugePages(*buffer);
     concrete_cpu_init_lwe_bootstrap_key_u64(
         buffer->data(), inputKey.buffer->data(), outputKey.buffer->data(),
         params.getInputLweDimension(), params.getPolynomialSize(),
@@ -152,6 +239,7 @@ LweBootstrapKey::fromProto(concreteprotocol::LweBootstrapKey::Reader reader) {
   switch (info.asReader().getCompression()) {
   case concreteprotocol::Compression::NONE:
     key.buffer = vector;
+    adviseHugePages(*key.buffer);
     break;
   case concreteprotocol::Compression::SEED:
     key.seededBuffer = vector;
@@ -162,24 +250,40 @@ LweBootstrapKey::fromProto(concreteprotocol::LweBootstrapKey::Reader reader) {
   return key;
 }
 
+LweBootstrapKey
+LweBootstrapKey::fromProto(concreteprotocol::LweBootstrapKey::Reader reader,
+                            std::shared_ptr<const void> mapping) {
+  auto mapped = protoPayloadToMappedBuffer(reader.getPayload(), mapping);
+  if (!mapped.has_value())
+    return fromProto(reader);
+  auto info = Message<concreteprotocol::LweBootstrapKeyInfo>(reader.getInfo());
+  LweBootstrapKey key(info);
+  key.mapped = mapped;
+  return key;
+}
+
 Message<concreteprotocol::LweBootstrapKey> LweBootstrapKey::toProto() const {
   return keyToProto<concreteprotocol::LweBootstrapKey,
                     concreteprotocol::LweBootstrapKeyInfo, LweBootstrapKey>(
       *this);
 }
 
-const std::vector<uint64_t> &LweBootstrapKey::getBuffer() {
+KeyBuffer LweBootstrapKey::getBuffer() {
   decompress();
-  return *buffer;
+  if (info.asReader().getCompression() == concreteprotocol::Compression::NONE)
+    return getTransportBuffer();
+  return KeyBuffer(buffer);
 }
 
-const std::vector<uint64_t> &LweBootstrapKey::getTransportBuffer() const {
+KeyBuffer LweBootstrapKey::getTransportBuffer() const {
+  if (mapped.has_value())
+    return *mapped;
   switch (info.asReader().getCompression()) {
   case concreteprotocol::Compression::NONE:
-    return *buffer;
+    return KeyBuffer(buffer);
   case concreteprotocol::Compression::SEED:
     assert(!seededBuffer->empty());
-    return *seededBuffer;
+    return KeyBuffer(seededBuffer);
   default:
     assert(false && "Unsupported compression type for bootstrap key");
   }
@@ -204,13 +308,16 @@ void LweBootstrapKey::decompress() {
     buffer->resize(concrete_cpu_bootstrap_key_size_u64(
         params.getLevelCount(), params.getGlweDimension(),
         params.getPolynomialSize(), params.getInputLweDimension()));
+    adviseHugePages(*buffer);
+    auto seeded = getTransportBuffer();
     struct Uint128 seed;
-    readSeed(seed, *seededBuffer);
+    readSeed(seed, seeded);
     concrete_cpu_decompress_seeded_lwe_bootstrap_key_u64(
-        buffer->data(), seededBuffer->data() + 2, params.getInputLweDimension(),
+        buffer->data(), seeded.data() + 2, params.getInputLweDimension(),
         params.getPolynomialSize(), params.getGlweDimension(),
         params.getLevelCount(), params.getBaseLog(), seed, Parallelism::Rayon);
     *decompressed = true;
+    keyDecompressions.fetch_add(1, std::memory_order_relaxed);
     return;
   }
   default:
@@ -218,6 +325,20 @@ void LweBootstrapKey::decompress() {
   }
 }
 
+void LweBootstrapKey::releaseBuffers() {
+  seededBuffer = std::make_shared<std::vector<uint64_t>>();
+  buffer = std::make_shared<std::vector<uint64_t>>();
+  mapped.reset();
+}
+
+bool LweBootstrapKey::isSameKey(const LweBootstrapKey &other) const {
+  if (decompressed == other.decompressed)
+    return true;
+  auto transport = getTransportBuffer();
+  return transport.size() > 0 &&
+         transport.data() == other.getTransportBuffer().data();
+}
+
 LweKeyswitchKey::LweKeyswitchKey(
     Message<concreteprotocol::LweKeyswitchKeyInfo> info,
     const LweSecretKey &inputKey, const LweSecretKey &outputKey,
@@ -236,6 +357,7 @@ LweKeyswitchKey::LweKeyswitchKey(
     buffer->resize(concrete_cpu_keyswitch_key_size_u64(
         params.getLevelCount(), params.getInputLweDimension(),
         params.getOutputLweDimension()));
+    adviseHugePages(*buffer);
     concrete_cpu_init_lwe_keyswitch_key_u64(
         buffer->data(), inputKey.buffer->data(), outputKey.buffer->data(),
         params.getInputLweDimension(), params.getOutputLweDimension(),
@@ -275,6 +397,7 @@ LweKeyswitchKey::fromProto(concreteprotocol::LweKeyswitchKey::Reader reader) {
   switch (info.asReader().getCompression()) {
   case concreteprotocol::Compression::NONE:
     key.buffer = vector;
+    adviseHugePages(*key.buffer);
     break;
   case concreteprotocol::Compression::SEED:
     key.seededBuffer = vector;
@@ -285,6 +408,18 @@ LweKeyswitchKey::fromProto(concreteprotocol::LweKeyswitchKey::Reader reader) {
   return key;
 }
 
+LweKeyswitchKey
+LweKeyswitchKey::fromProto(concreteprotocol::LweKeyswitchKey::Reader reader,
+                            std::shared_ptr<const void> mapping) {
+  auto mapped = protoPayloadToMappedBuffer(reader.getPayload(), mapping);
+  if (!mapped.has_value())
+    return fromProto(reader);
+  auto info = Message<concreteprotocol::LweKeyswitchKeyInfo>(reader.getInfo());
+  LweKeyswitchKey key(info);
+  key.mapped = mapped;
+  return key;
+}
+
 Message<concreteprotocol::LweKeyswitchKey> LweKeyswitchKey::toProto() const {
   return keyToProto<concreteprotocol::LweKeyswitchKey,
                     concreteprotocol::LweKeyswitchKeyInfo, LweKeyswitchKey>(
@@ -296,18 +431,22 @@ LweKeyswitchKey::getInfo() const {
   return this->info;
 }
 
-const std::vector<uint64_t> &LweKeyswitchKey::getBuffer() {
+KeyBuffer LweKeyswitchKey::getBuffer() {
   decompress();
-  return *buffer;
+  if (info.asReader().getCompression() == concreteprotocol::Compression::NONE)
+    return getTransportBuffer();
+  return KeyBuffer(buffer);
 }
 
-const std::vector<uint64_t> &LweKeyswitchKey::getTransportBuffer() const {
+KeyBuffer LweKeyswitchKey::getTransportBuffer() const {
+  if (mapped.has_value())
+    return *mapped;
   switch (info.asReader().getCompression()) {
   case concreteprotocol::Compression::NONE:
-    return *buffer;
+    return KeyBuffer(buffer);
   case concreteprotocol::Compression::SEED:
     assert(!seededBuffer->empty());
-    return *seededBuffer;
+    return KeyBuffer(seededBuffer);
   default:
     assert(false && "Unsupported compression type for bootstrap key");
   }
@@ -327,13 +466,16 @@ void LweKeyswitchKey::decompress() {
     buffer->resize(concrete_cpu_keyswitch_key_size_u64(
         params.getLevelCount(), params.getInputLweDimension(),
         params.getOutputLweDimension()));
+    adviseHugePages(*buffer);
+    auto seeded = getTransportBuffer();
     struct Uint128 seed;
-    readSeed(seed, *seededBuffer);
+    readSeed(seed, seeded);
     concrete_cpu_decompress_seeded_lwe_keyswitch_key_u64(
-        buffer->data(), seededBuffer->data() + 2, params.getInputLweDimension(),
+        buffer->data(), seeded.data() + 2, params.getInputLweDimension(),
         params.getOutputLweDimension(), params.getLevelCount(),
         params.getBaseLog(), seed, Parallelism::Rayon);
     *decompressed = true;
+    keyDecompressions.fetch_add(1, std::memory_order_relaxed);
     return;
   }
   default:
@@ -357,6 +499,7 @@ PackingKeyswitchKey::PackingKeyswitchKey(
                     (params.getGlweDimension() + 1);
   buffer = std::make_shared<std::vector<uint64_t>>();
   (*buffer).resize(bufferSize);
+  adviseHugePages(*buffer);
 
   // We copy the information.
   this->info = info;
@@ -382,6 +525,17 @@ PackingKeyswitchKey PackingKeyswitchKey::fromProto(
   return PackingKeyswitchKey(vector, info);
 }
 
+PackingKeyswitchKey PackingKeyswitchKey::fromProto(
+    concreteprotocol::PackingKeyswitchKey::Reader reader,
+    std::shared_ptr<const void> mapping) {
+  auto mapped = protoPayloadToMappedBuffer(reader.getPayload(), mapping);
+  if (!mapped.has_value())
+    return fromProto(reader);
+  auto info =
+      Message<concreteprotocol::PackingKeyswitchKeyInfo>(reader.getInfo());
+  return PackingKeyswitchKey(*mapped, info);
+}
+
 Message<concreteprotocol::PackingKeyswitchKey>
 PackingKeyswitchKey::toProto() const {
   return keyToProto<concreteprotocol::PackingKeyswitchKey,
@@ -390,18 +544,112 @@ PackingKeyswitchKey::toProto() const {
 }
 
 const uint64_t *PackingKeyswitchKey::getRawPtr() const {
-  return this->buffer->data();
+  return getBuffer().data();
 }
 
-size_t PackingKeyswitchKey::getSize() const { return this->buffer->size(); }
+size_t PackingKeyswitchKey::getSize() const { return getBuffer().size(); }
 
 const Message<concreteprotocol::PackingKeyswitchKeyInfo> &
 PackingKeyswitchKey::getInfo() const {
   return this->info;
 }
 
-const std::vector<uint64_t> &PackingKeyswitchKey::getBuffer() const {
-  return *this->buffer;
+KeyBuffer PackingKeyswitchKey::getBuffer() const {
+  if (mapped.has_value())
+    return *mapped;
+  return KeyBuffer(this->buffer);
+}
+
+GlwePackingKeyswitchKey::GlwePackingKeyswitchKey(
+    Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> info,
+    const LweSecretKey &inputKey, const LweSecretKey &outputKey,
+    EncryptionCSPRNG &csprng) {
+  assert(info.asReader().getParams().getGlweDimension() *
+             info.asReader().getParams().getPolynomialSize() ==
+         outputKey.info.asReader().getParams().getLweDimension());
+
+  // Allocate the buffer
+  auto params = info.asReader().getParams();
+  auto bufferSize = concrete_cpu_glwe_packing_keyswitch_key_size_u64(
+      params.getLevelCount(), params.getInputLweDimension(),
+      params.getGlweDimension(), params.getPolynomialSize());
+  buffer = std::make_shared<std::vector<uint64_t>>();
+  (*buffer).resize(bufferSize);
+  adviseHugePages(*buffer);
+
+  // We copy the information.
+  this->info = info;
+
+  // Initialize the packing keyswitch key buffer
+  concrete_cpu_init_glwe_packing_keyswitch_key_u64(
+      buffer->data(), inputKey.buffer->data(), outputKey.buffer->data(),
+      params.getInputLweDimension(), params.getGlweDimension(),
+      params.getPolynomialSize(), params.getLevelCount(), params.getBaseLog(),
+      params.getVariance(), csprng.ptr);
+}
+
+GlwePackingKeyswitchKey GlwePackingKeyswitchKey::fromProto(
+    const Message<concreteprotocol::GlwePackingKeyswitchKey> &proto) {
+  return fromProto(proto.asReader());
+}
+
+GlwePackingKeyswitchKey GlwePackingKeyswitchKey::fromProto(
+    concreteprotocol::GlwePackingKeyswitchKey::Reader reader) {
+  auto info =
+      Message<concreteprotocol::GlwePackingKeyswitchKeyInfo>(reader.getInfo());
+  auto vector = protoPayloadToSharedVector<uint64_t>(reader.getPayload());
+  return GlwePackingKeyswitchKey(vector, info);
+}
+
+GlwePackingKeyswitchKey GlwePackingKeyswitchKey::fromProto(
+    concreteprotocol::GlwePackingKeyswitchKey::Reader reader,
+    std::shared_ptr<const void> mapping) {
+  auto mapped = protoPayloadToMappedBuffer(reader.getPayload(), mapping);
+  if (!mapped.has_value())
+    return fromProto(reader);
+  auto info =
+      Message<concreteprotocol::GlwePackingKeyswitchKeyInfo>(reader.getInfo());
+  return GlwePackingKeyswitchKey(*mapped, info);
+}
+
+Message<concreteprotocol::GlwePackingKeyswitchKey>
+GlwePackingKeyswitchKey::toProto() const {
+  return keyToProto<concreteprotocol::GlwePackingKeyswitchKey,
+                    concreteprotocol::GlwePackingKeyswitchKeyInfo,
+                    GlwePackingKeyswitchKey>(*this);
+}
+
+const uint64_t *GlwePackingKeyswitchKey::getRawPtr() const {
+  return getBuffer().data();
+}
+
+size_t GlwePackingKeyswitchKey::getSize() const { return getBuffer().size(); }
+
+const Message<concreteprotocol::GlwePackingKeyswitchKeyInfo> &
+GlwePackingKeyswitchKey::getInfo() const {
+  return this->info;
+}
+
+KeyBuffer GlwePackingKeyswitchKey::getBuffer() const {
+  if (mapped.has_value())
+    return *mapped;
+  return KeyBuffer(this->buffer);
+}
+
+void GlwePackingKeyswitchKey::pack(const uint64_t *input, size_t count,
+                                   uint64_t *output) const {
+  auto params = info.asReader().getParams();
+  size_t lweSize = params.getInputLweDimension() + 1;
+  size_t polySize = params.getPolynomialSize();
+  size_t glweSize = (params.getGlweDimension() + 1) * polySize;
+  size_t glweCount = (count + polySize - 1) / polySize;
+  for (size_t i = 0; i < glweCount; i++) {
+    size_t packed = std::min(polySize, count - i * polySize);
+    concrete_cpu_keyswitch_and_pack_lwe_ciphertext_list_u64(
+        output + i * glweSize, input + i * polySize * lweSize, packed,
+        getRawPtr(), params.getLevelCount(), params.getBaseLog(),
+        params.getInputLweDimension(), params.getGlweDimension(), polySize);
+  }
 }
 
 } // namespace keys
@@ -5,6 +5,7 @@
 
 #include "concretelang/Common/Keysets.h"
 #include "capnp/message.h"
+#include "capnp/serialize.h"
 #include "concrete-cpu.h"
 #include "concrete-optimizer.hpp"
 #include "concrete-protocol.capnp.h"
@@ -15,20 +16,31 @@
 #include "kj/common.h"
 #include "kj/io.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include <errno.h>
 #include <fcntl.h>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <map>
 #include <stdlib.h>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <type_traits>
 #include <unistd.h>
+#include <utility>
 #include <utime.h>
 
 using concretelang::csprng::EncryptionCSPRNG;
 using concretelang::csprng::SecretCSPRNG;
 using concretelang::error::Result;
 using concretelang::error::StringError;
+using concretelang::keys::GlwePackingKeyswitchKey;
 using concretelang::keys::LweBootstrapKey;
 using concretelang::keys::LweKeyswitchKey;
 using concretelang::keys::LweSecretKey;
@@ -88,9 +100,114 @@ ServerKeyset::fromProto(concreteprotocol::ServerKeyset::Reader reader) {
         PackingKeyswitchKey::fromProto(pkskProto));
   }
 
+  for (auto gpkskProto : reader.getGlwePackingKeyswitchKeys()) {
+    output.glwePackingKeyswitchKeys.push_back(
+        GlwePackingKeyswitchKey::fromProto(gpkskProto));
+  }
+
   return output;
 }
 
+ServerKeyset
+ServerKeyset::fromProto(concreteprotocol::ServerKeyset::Reader reader,
+                        std::shared_ptr<const void> mapping) {
+  auto output = ServerKeyset();
+  for (auto bskProto : reader.getLweBootstrapKeys()) {
+    output.lweBootstrapKeys.push_back(
+        LweBootstrapKey::fromProto(bskProto, mapping));
+  }
+
+  for (auto kskProto : reader.getLweKeyswitchKeys()) {
+    output.lweKeyswitchKeys.push_back(
+        LweKeyswitchKey::fromProto(kskProto, mapping));
+  }
+
+  for (auto pkskProto : reader.getPackingKeyswitchKeys()) {
+    output.packingKeyswitchKeys.push_back(
+        PackingKeyswitchKey::fromProto(pkskProto, mapping));
+  }
+
+  for (auto gpkskProto : reader.getGlwePackingKeyswitchKeys()) {
+    output.glwePackingKeyswitchKeys.push_back(
+        GlwePackingKeyswitchKey::fromProto(gpkskProto, mapping));
+  }
+
+  return output;
+}
+
+Result<ServerKeyset> ServerKeyset::fromMappedFile(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return StringError("Cannot open keyset at path " + path +
+                       " Error: " + strerror(errno));
+  }
+  auto closeFd = llvm::make_scope_exit([&]() { close(fd); });
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0) {
+    return StringError("Cannot stat keyset at path " + path +
+                       " Error: " + strerror(errno));
+  }
+  size_t size = fileStat.st_size;
+  if (size == 0 || size % sizeof(capnp::word) != 0) {
+    return StringError("Invalid keyset file at path " + path +
+                       " Error: size is not a multiple of a word");
+  }
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    return StringError("Cannot map keyset at path " + path +
+                       " Error: " + strerror(errno));
+  }
+  // The mapping outlives the file descriptor, it is released with the last
+  // key pointing into it.
+  std::shared_ptr<const void> mapping(addr, [size](const void *ptr) {
+    munmap(const_cast<void *>(ptr), size);
+  });
+  try {
+    auto words = kj::ArrayPtr<const capnp::word>(
+        reinterpret_cast<const capnp::word *>(addr),
+        size / sizeof(capnp::word));
+    capnp::FlatArrayMessageReader reader(words, KEY_READER_OPTS);
+    return fromProto(reader.getRoot<concreteprotocol::ServerKeyset>(),
+                     mapping);
+  } catch (const kj::Exception &e) {
+    return StringError("Invalid keyset file at path " + path +
+                       " Error: " + e.getDescription().cStr());
+  }
+}
+
+void ServerKeyset::decompress() {
+  // Each key is decompressed in parallel already, decompressing them
+  // concurrently keeps the threads busy on the small keys.
+  std::vector<std::future<void>> pending;
+  for (auto &bsk : lweBootstrapKeys) {
+    if (bsk.getInfo().asReader().getCompression() !=
+        concreteprotocol::Compression::SEED)
+      continue;
+    pending.push_back(
+        std::async(std::launch::async, [&bsk]() { bsk.decompress(); }));
+  }
+  for (auto &ksk : lweKeyswitchKeys) {
+    if (ksk.getInfo().asReader().getCompression() !=
+        concreteprotocol::Compression::SEED)
+      continue;
+    pending.push_back(
+        std::async(std::launch::async, [&ksk]() { ksk.decompress(); }));
+  }
+  for (auto &decompression : pending)
+    decompression.wait();
+}
+
+std::shared_future<void> ServerKeyset::decompressInBackground() {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto done = promise->get_future().share();
+  // The copy of the keyset shares its keys with this one
+  std::thread([keyset = *this, promise]() mutable {
+    keyset.decompress();
+    promise->set_value();
+  }).detach();
+  return done;
+}
+
 Message<concreteprotocol::ServerKeyset> ServerKeyset::toProto() const {
   auto output = Message<concreteprotocol::ServerKeyset>();
   output.asBuilder().initLweBootstrapKeys(lweBootstrapKeys.size());
@@ -111,12 +228,23 @@ Message<concreteprotocol::ServerKeyset> ServerKeyset::toProto() const {
         i, packingKeyswitchKeys[i].toProto().asReader());
   }
 
+  output.asBuilder().initGlwePackingKeyswitchKeys(
+      glwePackingKeyswitchKeys.size());
+  for (size_t i = 0; i < glwePackingKeyswitchKeys.size(); i++) {
+    output.asBuilder().getGlwePackingKeyswitchKeys().setWithCaveats(
+        i, glwePackingKeyswitchKeys[i].toProto().asReader());
+  }
+
   return output;
 }
 
-Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
-               SecretCSPRNG &secretCsprng, EncryptionCSPRNG &encryptionCsprng,
-               std::map<uint32_t, LweSecretKey> lweSecretKeys) {
+/// Returns the secret keys of `info`, the ones not provided in
+/// `lweSecretKeys` being generated in order with `secretCsprng`.
+std::vector<LweSecretKey>
+generateSecretKeys(const Message<concreteprotocol::KeysetInfo> &info,
+                   SecretCSPRNG &secretCsprng,
+                   const std::map<uint32_t, LweSecretKey> &lweSecretKeys) {
+  std::vector<LweSecretKey> secretKeys;
   for (auto keyInfo : info.asReader().getLweSecretKeys()) {
     if (lweSecretKeys.count(keyInfo.getId())) {
       // use provided key
@@ -124,31 +252,54 @@ Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
       assert(keyInfo.toString().flatten() ==
                  lweSk.getInfo().asReader().toString().flatten() &&
              "provided key info doesn't match expected ones");
-      client.lweSecretKeys.push_back(lweSk);
+      secretKeys.push_back(lweSk);
     } else {
       // generate new key
-      client.lweSecretKeys.push_back(LweSecretKey(
+      secretKeys.push_back(LweSecretKey(
           (Message<concreteprotocol::LweSecretKeyInfo>)keyInfo, secretCsprng));
     }
   }
-  for (auto keyInfo : info.asReader().getLweBootstrapKeys()) {
-    server.lweBootstrapKeys.push_back(LweBootstrapKey(
-        (Message<concreteprotocol::LweBootstrapKeyInfo>)keyInfo,
-        client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
-  }
-  for (auto keyInfo : info.asReader().getLweKeyswitchKeys()) {
-    server.lweKeyswitchKeys.push_back(LweKeyswitchKey(
-        (Message<concreteprotocol::LweKeyswitchKeyInfo>)keyInfo,
-        client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
-  }
-  for (auto keyInfo : info.asReader().getPackingKeyswitchKeys()) {
-    server.packingKeyswitchKeys.push_back(PackingKeyswitchKey(
-        (Message<concreteprotocol::PackingKeyswitchKeyInfo>)keyInfo,
-        client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
-  }
+  return secretKeys;
+}
+
+Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
+               SecretCSPRNG &secretCsprng, EncryptionCSPRNG &encryptionCsprng,
+               std::map<uint32_t, LweSecretKey> lweSecretKeys) {
+  client.lweSecretKeys = generateSecretKeys(info, secretCsprng, lweSecretKeys);
+  // The evaluation keys are generated concurrently, each with its own
+  // generator forked in the order of the keyset info, so that they are the
+  // same for a given seed whatever the scheduling.
+  auto generateKeys = [&](auto keyInfos, auto &keys) {
+    using Key = typename std::decay_t<decltype(keys)>::value_type;
+    std::vector<std::future<Key>> pending;
+    for (auto keyInfo : keyInfos) {
+      pending.push_back(std::async(
+          std::launch::async,
+          [&, keyInfo, csprng = encryptionCsprng.fork()]() mutable {
+            return Key((typename Key::InfoType)keyInfo,
+                       client.lweSecretKeys[keyInfo.getInputId()],
+                       client.lweSecretKeys[keyInfo.getOutputId()], csprng);
+          }));
+    }
+    return pending;
+  };
+  auto bootstrapKeys = generateKeys(info.asReader().getLweBootstrapKeys(),
+                                    server.lweBootstrapKeys);
+  auto keyswitchKeys = generateKeys(info.asReader().getLweKeyswitchKeys(),
+                                    server.lweKeyswitchKeys);
+  auto packingKeyswitchKeys = generateKeys(
+      info.asReader().getPackingKeyswitchKeys(), server.packingKeyswitchKeys);
+  auto glwePackingKeyswitchKeys =
+      generateKeys(info.asReader().getGlwePackingKeyswitchKeys(),
+                   server.glwePackingKeyswitchKeys);
+  for (auto &key : bootstrapKeys)
+    server.lweBootstrapKeys.push_back(key.get());
+  for (auto &key : keyswitchKeys)
+    server.lweKeyswitchKeys.push_back(key.get());
+  for (auto &key : packingKeyswitchKeys)
+    server.packingKeyswitchKeys.push_back(key.get());
+  for (auto &key : glwePackingKeyswitchKeys)
+    server.glwePackingKeyswitchKeys.push_back(key.get());
 }
 
 Keyset Keyset::fromProto(const Message<concreteprotocol::Keyset> &proto) {
@@ -184,6 +335,13 @@ Message<concreteprotocol::Keyset> Keyset::toProto() const {
     serverKeyset.getPackingKeyswitchKeys().setWithCaveats(
         i, server.packingKeyswitchKeys[i].toProto().asReader());
   }
+
+  serverKeyset.initGlwePackingKeyswitchKeys(
+      server.glwePackingKeyswitchKeys.size());
+  for (size_t i = 0; i < server.glwePackingKeyswitchKeys.size(); i++) {
+    serverKeyset.getGlwePackingKeyswitchKeys().setWithCaveats(
+        i, server.glwePackingKeyswitchKeys[i].toProto().asReader());
+  }
   // client serialization is not inlined as keys aren't that big
   auto clientProto = client.toProto();
   output.asBuilder().setClient(clientProto.asReader());
@@ -230,230 +388,266 @@ Result<void> saveKey(Key key, std::string path) {
   return outcome::success();
 }
 
-Result<Keyset>
-loadKeysFromFiles(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
-                  __uint128_t secret_seed, __uint128_t encryption_seed,
-                  std::string folderPath) {
-#ifdef CONCRETELANG_GENERATE_UNSECURE_SECRET_KEYS
-  getApproval();
-#endif
-
-  // Mark the folder as recently use.
-  // e.g. so the CI can do some cleanup of unused keys.
-  utime(folderPath.c_str(), nullptr);
+/// Accumulates the identity of a cached key, i.e. everything its generation
+/// depends on. The identifiers of the keys are left out, so that the keys of
+/// keysets which only differ by some of their keys are shared.
+class KeyIdentity {
+public:
+  KeyIdentity(std::string kind) { hasher.update(kind); }
 
-  std::vector<LweSecretKey> secretKeys;
-  std::vector<LweBootstrapKey> bootstrapKeys;
-  std::vector<LweKeyswitchKey> keyswitchKeys;
-  std::vector<PackingKeyswitchKey> packingKeyswitchKeys;
-
-  // Load secret keys
-  for (auto keyInfo : keysetInfo.asReader().getLweSecretKeys()) {
-    // TODO - Check parameters?
-    // auto param = secretKeyParam.second;
-    llvm::SmallString<0> path(folderPath);
-    llvm::sys::path::append(path,
-                            "secretKey_" + std::to_string(keyInfo.getId()));
-    OUTCOME_TRY(auto key, loadKey<concreteprotocol::LweSecretKey, LweSecretKey>(
-                              (std::string)path));
-    secretKeys.push_back(key);
-  }
-  // Load bootstrap keys
-  for (auto keyInfo : keysetInfo.asReader().getLweBootstrapKeys()) {
-    // TODO - Check parameters?
-    // auto param = p.value();
-    llvm::SmallString<0> path(folderPath);
-    llvm::sys::path::append(path, "pbsKey_" + std::to_string(keyInfo.getId()));
-    OUTCOME_TRY(auto key,
-                loadKey<concreteprotocol::LweBootstrapKey, LweBootstrapKey>(
-                    (std::string)path));
-    bootstrapKeys.push_back(key);
-  }
-  // Load keyswitch keys
-  for (auto keyInfo : keysetInfo.asReader().getLweKeyswitchKeys()) {
-    // TODO - Check parameters?
-    // auto param = p.value();
-    llvm::SmallString<0> path(folderPath);
-    llvm::sys::path::append(path, "ksKey_" + std::to_string(keyInfo.getId()));
-    OUTCOME_TRY(auto key,
-                loadKey<concreteprotocol::LweKeyswitchKey, LweKeyswitchKey>(
-                    (std::string)path));
-    keyswitchKeys.push_back(key);
-  }
-  // Load packing keyswitch keys
-  for (auto keyInfo : keysetInfo.asReader().getPackingKeyswitchKeys()) {
-    // TODO - Check parameters?
-    // auto param = p.value();
-    llvm::SmallString<0> path(folderPath);
-    llvm::sys::path::append(path, "pksKey_" + std::to_string(keyInfo.getId()));
-    OUTCOME_TRY(
-        auto key,
-        loadKey<concreteprotocol::PackingKeyswitchKey, PackingKeyswitchKey>(
-            (std::string)path));
-    packingKeyswitchKeys.push_back(key);
-  }
-
-  ClientKeyset clientKeyset = ClientKeyset{secretKeys};
-  ServerKeyset serverKeyset =
-      ServerKeyset{bootstrapKeys, keyswitchKeys, packingKeyswitchKeys};
-  Keyset keyset = Keyset{serverKeyset, clientKeyset};
-
-  return keyset;
-}
-
-Result<void> saveKeys(Keyset &keyset, llvm::SmallString<0> &folderPath) {
-#ifdef CONCRETELANG_GENERATE_UNSECURE_SECRET_KEYS
-  getApproval();
-#endif
-
-  llvm::SmallString<0> folderIncompletePath = folderPath;
-  folderIncompletePath.append(".incomplete");
+  void add(llvm::StringRef data) {
+    // The size delimits the data from the next one
+    auto size = std::to_string(data.size()) + ":";
+    hasher.update(size);
+    hasher.update(data);
+  }
 
-  auto err = llvm::sys::fs::create_directories(folderIncompletePath);
-  if (err) {
-    return StringError("Cannot create directory \"")
-           << std::string(folderIncompletePath) << "\": " << err.message();
-  }
-
-  auto clientKeyset = keyset.client;
-  auto serverKeyset = keyset.server;
-
-  // Save LWE secret keys
-  for (auto key : clientKeyset.lweSecretKeys) {
-    llvm::SmallString<0> path = folderIncompletePath;
-    llvm::sys::path::append(
-        path, "secretKey_" + std::to_string(key.getInfo().asReader().getId()));
-    OUTCOME_TRYV(saveKey<concreteprotocol::LweSecretKey, LweSecretKey>(
-        key, path.c_str()));
-  }
-  // Save bootstrap keys
-  for (auto key : serverKeyset.lweBootstrapKeys) {
-    llvm::SmallString<0> path = folderIncompletePath;
-    llvm::sys::path::append(
-        path, "pbsKey_" + std::to_string(key.getInfo().asReader().getId()));
-    OUTCOME_TRYV(saveKey<concreteprotocol::LweBootstrapKey, LweBootstrapKey>(
-        key, path.c_str()));
-  }
-  // Save keyswitch keys
-  for (auto key : serverKeyset.lweKeyswitchKeys) {
-    llvm::SmallString<0> path = folderIncompletePath;
-    llvm::sys::path::append(
-        path, "ksKey_" + std::to_string(key.getInfo().asReader().getId()));
-    OUTCOME_TRYV(saveKey<concreteprotocol::LweKeyswitchKey, LweKeyswitchKey>(
-        key, path.c_str()));
-  }
-  // Save packing keyswitch keys
-  for (auto key : serverKeyset.packingKeyswitchKeys) {
-    llvm::SmallString<0> path = folderIncompletePath;
-    llvm::sys::path::append(
-        path, "pksKey_" + std::to_string(key.getInfo().asReader().getId()));
-    OUTCOME_TRYV(
-        saveKey<concreteprotocol::PackingKeyswitchKey, PackingKeyswitchKey>(
-            key, path.c_str()));
-  }
-
-  err = llvm::sys::fs::rename(folderIncompletePath, folderPath);
-  if (err) {
-    llvm::sys::fs::remove_directories(folderIncompletePath);
+  void add(__uint128_t seed) {
+    add(llvm::StringRef(reinterpret_cast<const char *>(&seed), sizeof(seed)));
   }
-  if (!llvm::sys::fs::exists(folderPath)) {
-    return StringError("Cannot save directory \"")
-           << std::string(folderPath) << "\"";
+
+  /// Returns the hex encoded SHA-256 digest of the identity, and the seed of
+  /// the generator of the key derived from it.
+  std::pair<std::string, __uint128_t> finish() {
+    auto digest = hasher.final();
+    __uint128_t seed = 0;
+    for (size_t i = 0; i < sizeof(seed); i++)
+      seed |= (__uint128_t)(uint8_t)digest[i] << (8 * i);
+    return {llvm::toHex(digest, true), seed};
   }
 
-  return outcome::success();
+private:
+  llvm::SHA256 hasher;
+};
+
+/// Counts the occurrences of the identities, so that the keys of a keyset
+/// with the same identity, e.g. two secret keys with the same parameters,
+/// are still different keys.
+std::string occurrence(std::map<std::string, size_t> &occurrences,
+                       const std::string &identity) {
+  return std::to_string(occurrences[identity]++);
 }
 
-KeysetCache::KeysetCache(std::string backingDirectoryPath) {
-  // check key;
-  this->backingDirectoryPath = backingDirectoryPath;
+/// Returns the hex encoded SHA-256 digest of the identity of a secret key,
+/// i.e. of its parameters and its buffer.
+std::string secretKeyDigest(const LweSecretKey &key) {
+  KeyIdentity identity("lweSecretKey");
+  identity.add(
+      key.getInfo().asReader().getParams().toString().flatten().cStr());
+  auto &buffer = key.getBuffer();
+  identity.add(llvm::StringRef(reinterpret_cast<const char *>(buffer.data()),
+                               buffer.size() * sizeof(uint64_t)));
+  return identity.finish().first;
 }
 
-Result<Keyset>
-KeysetCache::getKeyset(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
-                       __uint128_t secret_seed, __uint128_t encryption_seed,
-                       std::map<uint32_t, LweSecretKey> lweSecretKeys) {
-  std::string hashString = keysetInfo.asReader().toString().flatten().cStr() +
-                           std::to_string((uint64_t)secret_seed) +
-                           std::to_string((uint64_t)(secret_seed >> 64)) +
-                           std::to_string((uint64_t)encryption_seed) +
-                           std::to_string((uint64_t)(encryption_seed >> 64));
-
-  // hash initial keys if any
-  if (lweSecretKeys.size()) {
-    hashString += "InitSKsSig:";
-    for (auto sk : lweSecretKeys) {
-      // key info
-      hashString += sk.second.getInfo().asReader().toString().flatten().cStr();
-      // key buffer
-      std::vector<uint64_t> buffer = sk.second.getBuffer();
-      size_t hash = std::hash<std::string_view>{}(
-          {reinterpret_cast<const char *>(buffer.data()),
-           buffer.size() * sizeof(uint64_t)});
-      hashString += std::to_string(hash);
-      hashString += ",";
+/// Returns the secret keys of `info`, the ones not provided in
+/// `lweSecretKeys` being generated from a seed derived from `secret_seed` and
+/// their parameters, so that the same parameters give the same key whatever
+/// the other keys of the keyset.
+std::vector<LweSecretKey>
+deriveSecretKeys(const Message<concreteprotocol::KeysetInfo> &info,
+                 __uint128_t secret_seed,
+                 const std::map<uint32_t, LweSecretKey> &lweSecretKeys) {
+  std::vector<LweSecretKey> secretKeys;
+  std::map<std::string, size_t> occurrences;
+  for (auto keyInfo : info.asReader().getLweSecretKeys()) {
+    std::string params = keyInfo.getParams().toString().flatten().cStr();
+    auto ordinal = occurrence(occurrences, params);
+    if (lweSecretKeys.count(keyInfo.getId())) {
+      secretKeys.push_back(lweSecretKeys.at(keyInfo.getId()));
+      continue;
     }
-  }
+    KeyIdentity identity("lweSecretKey");
+    identity.add(secret_seed);
+    identity.add(params);
+    identity.add(ordinal);
+    // A null seed asks for a random key, as for the SecretCSPRNG
+    auto seed = secret_seed == 0 ? 0 : identity.finish().second;
+    auto csprng = SecretCSPRNG(seed);
+    secretKeys.push_back(LweSecretKey(
+        (Message<concreteprotocol::LweSecretKeyInfo>)keyInfo, csprng));
+  }
+  return secretKeys;
+}
 
-  size_t hash = std::hash<std::string>{}(hashString);
-#ifdef CONCRETELANG_GENERATE_UNSECURE_SECRET_KEYS
-  getApproval();
-#endif
+/// Returns the key stored in the cache entry `path`, with `info` as info as
+/// the entry may have been stored for another keyset where the key had other
+/// identifiers.
+template <typename ProtoKey, typename Key>
+Result<Key> loadCachedKey(std::string path,
+                          const typename Key::InfoType &info) {
+  OUTCOME_TRY(auto keyProto, loadKeyProto<ProtoKey>(path));
+  keyProto.asBuilder().setInfo(info.asReader());
+  return Key::fromProto(keyProto);
+}
 
-  llvm::SmallString<0> folderPath =
-      llvm::SmallString<0>(this->backingDirectoryPath);
-  llvm::sys::path::append(folderPath, std::to_string(hash));
+/// Returns the key stored in the cache entry `path`, or generates it and
+/// stores it there if it does not exist yet. The entry is written to a
+/// temporary file then renamed, so that it is never seen incomplete, and its
+/// generation is locked, so that concurrent generators of the same entry, in
+/// this process or in others, wait for the first one instead of generating
+/// the key again.
+template <typename ProtoKey, typename Key>
+Result<Key> loadOrGenerateKey(std::string path,
+                              const typename Key::InfoType &info,
+                              std::function<Key()> generateKey) {
+  if (llvm::sys::fs::exists(path)) {
+    auto key = loadCachedKey<ProtoKey, Key>(path, info);
+    if (key.has_value()) {
+      // Mark the entry as recently used.
+      // e.g. so the CI can do some cleanup of unused keys.
+      utime(path.c_str(), nullptr);
+      return key;
+    }
+  }
 
-  // Creating a lock for concurrent generation
-  llvm::SmallString<0> lockPath(folderPath);
-  lockPath.append("lock");
+  std::string lockPath = path + ".lock";
   int FD_lock;
-  llvm::sys::fs::create_directories(llvm::sys::path::parent_path(lockPath));
-  // Open or create the lock file
   auto err = llvm::sys::fs::openFile(
       lockPath, FD_lock, llvm::sys::fs::CreationDisposition::CD_OpenAlways,
       llvm::sys::fs::FileAccess::FA_Write, llvm::sys::fs::OpenFlags::OF_None);
-
   if (err) {
-    // parent does not exists OR right issue (creation or write)
     return StringError("Cannot access \"")
-           << std::string(lockPath) << "\": " << err.message();
+           << lockPath << "\": " << err.message();
   }
-
-  // The lock is released when the function returns.
-  // => any intermediate state in the function is not visible to others.
+  // The lock file is kept, as removing it would let another generator lock a
+  // new one while the previous one is still locked.
   auto unlockAtReturn = llvm::make_scope_exit([&]() {
-    llvm::sys::fs::closeFile(FD_lock);
     llvm::sys::fs::unlockFile(FD_lock);
-    llvm::sys::fs::remove(lockPath);
+    llvm::sys::fs::closeFile(FD_lock);
   });
-  llvm::sys::fs::lockFile(FD_lock);
-
-  if (llvm::sys::fs::exists(folderPath)) {
-    // Once it has been generated by another process (or was already here)
-    auto keys = loadKeysFromFiles(keysetInfo, secret_seed, encryption_seed,
-                                  std::string(folderPath));
-    if (keys.has_value()) {
-      return keys;
-    } else {
-      std::cerr << std::string(keys.error().mesg) << "\n";
-      std::cerr << "Invalid KeySetCache entry " << std::string(folderPath)
-                << "\n";
-      llvm::sys::fs::remove_directories(folderPath);
-      // Then we can continue as it didn't exist
+  err = llvm::sys::fs::lockFile(FD_lock);
+  if (err) {
+    return StringError("Cannot lock \"")
+           << lockPath << "\": " << err.message();
+  }
+
+  if (llvm::sys::fs::exists(path)) {
+    // Once it has been generated by another generator
+    auto key = loadCachedKey<ProtoKey, Key>(path, info);
+    if (key.has_value()) {
+      return key;
     }
+    std::cerr << std::string(key.error().mesg) << "\n";
+    std::cerr << "Invalid KeySetCache entry " << path << "\n";
+    llvm::sys::fs::remove(path);
+    // Then we can continue as it didn't exist
   }
 
-  std::cerr << "KeySetCache: miss, regenerating " << std::string(folderPath)
-            << "\n";
+  std::cerr << "KeySetCache: miss, regenerating " << path << "\n";
+  Key key = generateKey();
+
+  std::string incompletePath = path + ".incomplete";
+  OUTCOME_TRYV(saveKey<ProtoKey, Key>(key, incompletePath));
+  err = llvm::sys::fs::rename(incompletePath, path);
+  if (err) {
+    llvm::sys::fs::remove(incompletePath);
+    return StringError("Cannot save key at path \"")
+           << path << "\": " << err.message();
+  }
+  return key;
+}
+
+/// Loads the evaluation keys of `keyInfos` from the cache, or generates the
+/// missing ones concurrently. A key is identified by its parameters, its
+/// compression and the identities of its input and output secret keys, and
+/// generated from a seed derived from `encryption_seed` and its identity, so
+/// that only the keys which changed are generated when a keyset changes.
+template <typename ProtoKey, typename Key, typename KeyInfos>
+Result<void>
+loadOrGenerateKeys(KeyInfos keyInfos, std::string kind,
+                   const std::vector<LweSecretKey> &secretKeys,
+                   const std::vector<std::string> &secretKeyDigests,
+                   __uint128_t encryption_seed,
+                   std::string backingDirectoryPath, std::vector<Key> &keys) {
+  std::vector<std::future<Result<Key>>> pending;
+  std::map<std::string, size_t> occurrences;
+  for (auto keyInfo : keyInfos) {
+    KeyIdentity identity(kind);
+    identity.add(keyInfo.getParams().toString().flatten().cStr());
+    identity.add(std::to_string((int)keyInfo.getCompression()));
+    identity.add(secretKeyDigests[keyInfo.getInputId()]);
+    identity.add(secretKeyDigests[keyInfo.getOutputId()]);
+    auto entry = identity.finish().first;
+    KeyIdentity seeded(kind);
+    seeded.add(entry);
+    seeded.add(occurrence(occurrences, entry));
+    seeded.add(encryption_seed);
+    auto seededDigest = seeded.finish();
+    llvm::SmallString<0> path(backingDirectoryPath);
+    llvm::sys::path::append(path, seededDigest.first);
+
+    // A null seed asks for random masks, as for the EncryptionCSPRNG
+    __uint128_t seed = encryption_seed == 0 ? 0 : seededDigest.second;
+    pending.push_back(std::async(
+        std::launch::async,
+        [&, keyInfo, path = std::string(path), seed]() {
+          auto info = (typename Key::InfoType)keyInfo;
+          return loadOrGenerateKey<ProtoKey, Key>(path, info, [&]() {
+            auto csprng = EncryptionCSPRNG(seed);
+            return Key(info, secretKeys[keyInfo.getInputId()],
+                       secretKeys[keyInfo.getOutputId()], csprng);
+          });
+        }));
+  }
+  // Wait for all the keys before returning, as they refer to this frame.
+  std::vector<Result<Key>> results;
+  for (auto &key : pending)
+    results.push_back(key.get());
+  for (auto &key : results) {
+    OUTCOME_TRY(auto value, std::move(key));
+    keys.push_back(std::move(value));
+  }
+  return outcome::success();
+}
 
-  auto encryptionCsprng = csprng::EncryptionCSPRNG(encryption_seed);
-  auto secretCsprng = csprng::SecretCSPRNG(secret_seed);
-  Keyset keyset(keysetInfo, secretCsprng, encryptionCsprng, lweSecretKeys);
+KeysetCache::KeysetCache(std::string backingDirectoryPath) {
+  // check key;
+  this->backingDirectoryPath = backingDirectoryPath;
+}
 
-  OUTCOME_TRYV(saveKeys(keyset, folderPath));
+Result<Keyset>
+KeysetCache::getKeyset(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
+                       __uint128_t secret_seed, __uint128_t encryption_seed,
+                       std::map<uint32_t, LweSecretKey> lweSecretKeys) {
+#ifdef CONCRETELANG_GENERATE_UNSECURE_SECRET_KEYS
+  getApproval();
+#endif
 
-  return std::move(keyset);
+  auto err = llvm::sys::fs::create_directories(backingDirectoryPath);
+  if (err) {
+    return StringError("Cannot create directory \"")
+           << backingDirectoryPath << "\": " << err.message();
+  }
+
+  // The secret keys are cheap to generate, only the evaluation keys are
+  // cached, each in its own entry named after its identity.
+  ClientKeyset client{
+      deriveSecretKeys(keysetInfo, secret_seed, lweSecretKeys)};
+  std::vector<std::string> secretKeyDigests;
+  for (auto &key : client.lweSecretKeys)
+    secretKeyDigests.push_back(secretKeyDigest(key));
+
+  ServerKeyset server;
+  auto info = keysetInfo.asReader();
+  OUTCOME_TRYV((loadOrGenerateKeys<concreteprotocol::LweBootstrapKey>(
+      info.getLweBootstrapKeys(), "pbsKey", client.lweSecretKeys,
+      secretKeyDigests, encryption_seed, backingDirectoryPath,
+      server.lweBootstrapKeys)));
+  OUTCOME_TRYV((loadOrGenerateKeys<concreteprotocol::LweKeyswitchKey>(
+      info.getLweKeyswitchKeys(), "ksKey", client.lweSecretKeys,
+      secretKeyDigests, encryption_seed, backingDirectoryPath,
+      server.lweKeyswitchKeys)));
+  OUTCOME_TRYV((loadOrGenerateKeys<concreteprotocol::PackingKeyswitchKey>(
+      info.getPackingKeyswitchKeys(), "pksKey", client.lweSecretKeys,
+      secretKeyDigests, encryption_seed, backingDirectoryPath,
+      server.packingKeyswitchKeys)));
+  OUTCOME_TRYV((loadOrGenerateKeys<concreteprotocol::GlwePackingKeyswitchKey>(
+      info.getGlwePackingKeyswitchKeys(), "gpksKey", client.lweSecretKeys,
+      secretKeyDigests, encryption_seed, backingDirectoryPath,
+      server.glwePackingKeyswitchKeys)));
+
+  return Keyset{server, client};
 }
 
 Message<concreteprotocol::KeysetInfo>
@@ -487,6 +681,8 @@ generateKeysetInfoFromParameters(CircuitKeys parameters,
         bsk.value().br_decomposition_parameter.level);
     output.asBuilder().getParams().setBaseLog(
         bsk.value().br_decomposition_parameter.log2_base);
+    output.asBuilder().getParams().setGroupingFactor(
+        bsk.value().grouping_factor);
     output.asBuilder().getParams().setGlweDimension(
         bsk.value().output_key.glwe_dimension);
     output.asBuilder().getParams().setPolynomialSize(
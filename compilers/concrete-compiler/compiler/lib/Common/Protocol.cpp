@@ -9,10 +9,58 @@
 #include "llvm/ADT/Hashing.h"
 #include <memory>
 #include <stdlib.h>
+#include <vector>
 
 namespace concretelang {
 namespace protocol {
 
+namespace {
+
+/// The number of scratch segments kept by a thread, beyond which the released
+/// segments are freed.
+const size_t MAX_SCRATCH_SEGMENTS = 32;
+
+/// The scratch segments released by the messages of the thread.
+struct ScratchSegments {
+  std::vector<capnp::word *> segments;
+
+  ~ScratchSegments();
+};
+
+/// Whether the segments of the thread are destroyed, the messages destroyed
+/// after them at the exit of the thread freeing their segments.
+thread_local bool scratchSegmentsDestroyed = false;
+
+thread_local ScratchSegments scratchSegments;
+
+ScratchSegments::~ScratchSegments() {
+  for (auto segment : segments)
+    delete[] segment;
+  scratchSegmentsDestroyed = true;
+}
+
+} // namespace
+
+kj::ArrayPtr<capnp::word> takeScratchSegment() {
+  capnp::word *segment;
+  if (scratchSegmentsDestroyed || scratchSegments.segments.empty()) {
+    segment = new capnp::word[SCRATCH_SEGMENT_WORDS]();
+  } else {
+    segment = scratchSegments.segments.back();
+    scratchSegments.segments.pop_back();
+  }
+  return kj::arrayPtr(segment, SCRATCH_SEGMENT_WORDS);
+}
+
+void releaseScratchSegment(kj::ArrayPtr<capnp::word> segment) {
+  if (scratchSegmentsDestroyed ||
+      scratchSegments.segments.size() >= MAX_SCRATCH_SEGMENTS) {
+    delete[] segment.begin();
+    return;
+  }
+  scratchSegments.segments.push_back(segment.begin());
+}
+
 /// Helper function turning a protocol `Shape` object into a vector of
 /// dimensions.
 std::vector<size_t>
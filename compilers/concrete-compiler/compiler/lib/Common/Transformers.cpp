@@ -13,9 +13,13 @@
 #include "concretelang/Common/Keysets.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Runtime/simulation.h"
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdlib.h>
 #include <string>
+#include <thread>
+#include <vector>
 
 using concretelang::error::Result;
 using concretelang::keysets::ClientKeyset;
@@ -185,6 +189,28 @@ Result<TransportValueVerifier> getObliviousTransportValueVerifier() {
   };
 }
 
+/// Returns the number of lwe ciphertexts of a ciphertext gate.
+size_t getLweCiphertextCount(
+    concreteprotocol::LweCiphertextTypeInfo::Reader lweCiphertext) {
+  auto dimensions = lweCiphertext.getConcreteShape().getDimensions();
+  size_t count = 1;
+  for (size_t i = 0; i + 1 < dimensions.size(); i++) {
+    count *= dimensions[i];
+  }
+  return count;
+}
+
+/// Returns the shape of the lwe ciphertexts of a ciphertext gate packed in
+/// glwe ciphertexts, i.e. the number of glwe ciphertexts and their size.
+std::vector<size_t>
+getPackedShape(concreteprotocol::LweCiphertextTypeInfo::Reader lweCiphertext) {
+  auto packing = lweCiphertext.getPacking();
+  size_t polynomialSize = packing.getPolynomialSize();
+  size_t count = getLweCiphertextCount(lweCiphertext);
+  return {(count + polynomialSize - 1) / polynomialSize,
+          (packing.getGlweDimension() + 1) * polynomialSize};
+}
+
 Message<concreteprotocol::GateInfo>
 updateGateInfoAccordingValue(Message<concreteprotocol::GateInfo> &gate,
                              const TransportValue &value) {
@@ -234,19 +260,35 @@ updateGateInfoAccordingValue(Message<concreteprotocol::GateInfo> &gate,
     concreteShapeDimensions.set(concreteShapeDimensions.size() - 1, 3);
     return (Message<concreteprotocol::GateInfo>)gateBuilder.asReader();
   }
+  if (gateCompression == concreteprotocol::Compression::GLWE_PACKING &&
+      valueCompression == concreteprotocol::Compression::NONE) {
+    // The server returns the ciphertexts unpacked when it has no packing key,
+    // or in simulation.
+    gateBuilder.getTypeInfo().getLweCiphertext().setCompression(
+        concreteprotocol::Compression::NONE);
+    return (Message<concreteprotocol::GateInfo>)gateBuilder.asReader();
+  }
+  if (gateCompression == concreteprotocol::Compression::GLWE_PACKING &&
+      valueCompression == concreteprotocol::Compression::GLWE_PACKING) {
+    // The raw shape of packed ciphertexts is the list of glwe ciphertexts.
+    auto packedShape = getPackedShape(gateCiphertext);
+    auto packedDimensions =
+        gateBuilder.getRawInfo().getShape().initDimensions(2);
+    packedDimensions.set(0, packedShape[0]);
+    packedDimensions.set(1, packedShape[1]);
+    return (Message<concreteprotocol::GateInfo>)gateBuilder.asReader();
+  }
   return gate;
 }
 
-Result<TransportValueVerifier> getTransportValueVerifier(
+/// Returns a verifier of the raw and type infos of a transport value, i.e. of
+/// all of it but its payload, which can be streamed separately.
+Result<TransportValueVerifier> getTransportValueHeaderVerifier(
     Message<concreteprotocol::GateInfo> &originalGateInfo) {
   return [=](const TransportValue &transportVal) -> Result<void> {
     auto copyGateInfo = originalGateInfo;
     auto gateInfo = updateGateInfoAccordingValue(copyGateInfo, transportVal);
 
-    if (!transportVal.asReader().hasPayload()) {
-      return StringError(
-          "Tried to transform a transport value without payload.");
-    }
     if (!transportVal.asReader().hasRawInfo()) {
       return StringError(
           "Tried to transform a transport value without raw infos.");
@@ -261,20 +303,6 @@ Result<TransportValueVerifier> getTransportValueVerifier(
                          "raw info.\nExpected: " +
                          expected + "\nActual: " + actual);
     }
-    size_t expectedPayloadSize =
-        transportVal.asReader().getRawInfo().getIntegerPrecision() / 8;
-    for (auto dim :
-         transportVal.asReader().getRawInfo().getShape().getDimensions()) {
-      expectedPayloadSize *= dim;
-    }
-    size_t actualPayloadSize = 0;
-    for (auto blob : transportVal.asReader().getPayload().getData()) {
-      actualPayloadSize += blob.size();
-    }
-    if (actualPayloadSize != expectedPayloadSize) {
-      return StringError("Tried to transform a transport value with "
-                         "incompatible payload size.");
-    }
     if (!transportVal.asReader().getTypeInfo().hasIndex() &&
         !transportVal.asReader().getTypeInfo().hasPlaintext() &&
         !transportVal.asReader().getTypeInfo().hasLweCiphertext()) {
@@ -295,9 +323,42 @@ Result<TransportValueVerifier> getTransportValueVerifier(
   };
 }
 
+/// Returns the size in bytes of the payload described by `rawInfo`.
+size_t getRawPayloadSize(concreteprotocol::RawInfo::Reader rawInfo) {
+  size_t size = rawInfo.getIntegerPrecision() / 8;
+  for (auto dim : rawInfo.getShape().getDimensions()) {
+    size *= dim;
+  }
+  return size;
+}
+
+Result<TransportValueVerifier> getTransportValueVerifier(
+    Message<concreteprotocol::GateInfo> &originalGateInfo) {
+  OUTCOME_TRY(auto verifyHeader,
+              getTransportValueHeaderVerifier(originalGateInfo));
+  return [=](const TransportValue &transportVal) -> Result<void> {
+    if (!transportVal.asReader().hasPayload()) {
+      return StringError(
+          "Tried to transform a transport value without payload.");
+    }
+    OUTCOME_TRYV(verifyHeader(transportVal));
+    size_t expectedPayloadSize =
+        getRawPayloadSize(transportVal.asReader().getRawInfo());
+    size_t actualPayloadSize = 0;
+    for (auto blob : transportVal.asReader().getPayload().getData()) {
+      actualPayloadSize += blob.size();
+    }
+    if (actualPayloadSize != expectedPayloadSize) {
+      return StringError("Tried to transform a transport value with "
+                         "incompatible payload size.");
+    }
+    return outcome::success();
+  };
+}
+
 Result<Transformer> getBooleanEncodingTransformer() {
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
 
     for (size_t i = 0; i < inputTensor.values.size(); i++) {
@@ -314,12 +375,9 @@ Result<Transformer> getNativeModeIntegerEncodingTransformer(
   auto isSigned = info.asReader().getIsSigned();
 
   return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
+    const Tensor<uint64_t> inputTensor =
+        isSigned ? (Tensor<uint64_t>)input.getTensor<int64_t>().value()
+                 : input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
 
     for (size_t i = 0; i < inputTensor.values.size(); i++) {
@@ -329,13 +387,40 @@ Result<Transformer> getNativeModeIntegerEncodingTransformer(
   };
 }
 
+/// Runs `body` on the indices below `count`, split into contiguous chunks
+/// on up to one thread per hardware thread.
+static void forEachInParallel(size_t count,
+                              std::function<void(size_t)> body) {
+  // Below that, starting the threads costs more than what they save
+  const size_t minChunkSize = 16;
+  size_t threadCount =
+      std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                       count / minChunkSize);
+  if (threadCount <= 1) {
+    for (size_t i = 0; i < count; i++)
+      body(i);
+    return;
+  }
+  std::vector<std::thread> threads;
+  size_t chunkSize = (count + threadCount - 1) / threadCount;
+  for (size_t begin = 0; begin < count; begin += chunkSize) {
+    size_t end = std::min(begin + chunkSize, count);
+    threads.emplace_back([&body, begin, end]() {
+      for (size_t i = begin; i < end; i++)
+        body(i);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+}
+
 Result<Transformer> getNativeModeIntegerDecodingTransformer(
     const Message<concreteprotocol::IntegerCiphertextEncodingInfo> &info) {
   auto precision = info.asReader().getWidth();
   auto isSigned = info.asReader().getIsSigned();
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
 
     for (size_t i = 0; i < inputTensor.values.size(); i++) {
@@ -381,12 +466,9 @@ Result<Transformer> getChunkedModeIntegerEncodingTransformer(
   uint64_t mask = (1 << chunkWidth) - 1;
 
   return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
+    const Tensor<uint64_t> inputTensor =
+        isSigned ? (Tensor<uint64_t>)input.getTensor<int64_t>().value()
+                 : input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     outputTensor.dimensions.push_back(size);
     outputTensor.values.resize(outputTensor.values.size() * size);
@@ -413,7 +495,7 @@ Result<Transformer> getChunkedModeIntegerDecodingTransformer(
   uint64_t mask = (1 << chunkWidth) - 1;
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     outputTensor.dimensions.pop_back();
     outputTensor.values.resize(outputTensor.values.size() / chunkSize);
@@ -469,12 +551,9 @@ Result<Transformer> getCrtModeIntegerEncodingTransformer(
   auto isSigned = info.asReader().getIsSigned();
 
   return [=](Value input) {
-    Tensor<uint64_t> inputTensor;
-    if (isSigned) {
-      inputTensor = (Tensor<uint64_t>)input.getTensor<int64_t>().value();
-    } else {
-      inputTensor = input.getTensor<uint64_t>().value();
-    }
+    const Tensor<uint64_t> inputTensor =
+        isSigned ? (Tensor<uint64_t>)input.getTensor<int64_t>().value()
+                 : input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     outputTensor.dimensions.push_back(size);
     outputTensor.values.resize(outputTensor.values.size() * size);
@@ -497,39 +576,37 @@ Result<Transformer> getCrtModeIntegerDecodingTransformer(
   for (auto modulus : info.asReader().getMode().getCrt().getModuli()) {
     moduli.push_back(modulus);
   }
-  std::vector<int64_t> remainders(
-      info.asReader().getMode().getCrt().getModuli().size());
   auto size = info.asReader().getMode().getCrt().getModuli().size();
   auto isSigned = info.asReader().getIsSigned();
+  // The inverse crt is a weighted sum of the remainders, the weights are
+  // computed once instead of for every element
+  auto coefficients = crt::iCrtCoefficients(moduli);
+  int64_t product = crt::productOfModuli(moduli);
+  uint64_t maxPos = product / 2;
 
-  return [=](Value input) mutable {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+  return [=](Value input) {
+    const auto &inputTensor = *input.getTensorPtr<uint64_t>();
+    Tensor<uint64_t> outputTensor;
+    outputTensor.dimensions = inputTensor.dimensions;
     outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / size);
+    outputTensor.values.resize(inputTensor.values.size() / size);
 
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
+    forEachInParallel(outputTensor.values.size(), [&](size_t i) {
+      // Compute the inverse crt
+      int64_t sum = 0;
       for (size_t j = 0; j < (size_t)size; j++) {
-        remainders[j] =
+        int64_t remainder =
             crt::decode(inputTensor.values[i * size + j], moduli[j]);
+        sum += remainder * coefficients[j];
       }
-
-      // Compute the inverse crt
-      uint64_t output = crt::iCrt(moduli, remainders);
+      uint64_t output = sum % product;
 
       // Further decode signed integers
-      if (isSigned) {
-        uint64_t maxPos = 1;
-        for (auto prime : moduli) {
-          maxPos *= prime;
-        }
-        maxPos /= 2;
-        if (output >= maxPos) {
-          output -= maxPos * 2;
-        }
+      if (isSigned && output >= maxPos) {
+        output -= maxPos * 2;
       }
       outputTensor.values[i] = output;
-    }
+    });
 
     Value output;
     if (isSigned) {
@@ -554,15 +631,28 @@ Result<Transformer> getEncryptionTransformer(
   auto variance = info.asReader().getVariance();
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     outputTensor.dimensions.push_back(lweSize);
     outputTensor.values.resize(outputTensor.values.size() * lweSize);
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      concrete_cpu_encrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &outputTensor.values[i * lweSize],
-          inputTensor.values[i], lweDimension, variance, csprng->ptr);
+    // The whole tensor is encrypted in a single call, the csprng being forked
+    // deterministically into one stream per ciphertext so that they can be
+    // encrypted in parallel. A scalar is not worth dispatching to the pool.
+    size_t count = inputTensor.values.size();
+    auto parallelism = count > 1 ? Parallelism::Rayon : Parallelism::No;
+    auto pool = csprng->getRandomnessPool(lweDimension, variance);
+    if (pool != nullptr) {
+      // In buffered mode, the masks and noises were generated ahead of time
+      pool->take(outputTensor.values.data(), count);
+      concrete_cpu_encrypt_lwe_ciphertext_vector_with_randomness_u64(
+          key.getRawPtr(), outputTensor.values.data(),
+          inputTensor.values.data(), count, lweDimension, parallelism);
+    } else {
+      concrete_cpu_encrypt_lwe_ciphertext_vector_u64(
+          key.getRawPtr(), outputTensor.values.data(),
+          inputTensor.values.data(), count, lweDimension, variance,
+          csprng->ptr, parallelism);
     }
 
     return Value{outputTensor};
@@ -578,14 +668,16 @@ Result<Transformer> getSeededEncryptionTransformer(
   auto variance = info.asReader().getVariance();
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     // 3 = 2 (seed) + 1 (encrypted scalar)
     auto const ciphertextSize = 3;
     outputTensor.dimensions.push_back(ciphertextSize);
     outputTensor.values.resize(outputTensor.values.size() * ciphertextSize);
-    struct Uint128 seed;
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
+    // Each ciphertext has its own seed, so they are encrypted independently
+    // on several threads
+    forEachInParallel(inputTensor.values.size(), [&](size_t i) {
+      struct Uint128 seed;
       csprng::getRandomSeed(&seed);
       // Write seed
       csprng::writeSeed(seed, &outputTensor.values[i * 3]);
@@ -593,7 +685,7 @@ Result<Transformer> getSeededEncryptionTransformer(
       concrete_cpu_encrypt_seeded_lwe_ciphertext_u64(
           key.getRawPtr(), &outputTensor.values[i * 3 + 2],
           inputTensor.values[i], lweDimension, seed, variance);
-    }
+    });
     return Value{outputTensor};
   };
 }
@@ -605,7 +697,7 @@ Result<Transformer> getEncryptionSimulationTransformer(
   auto lweDimension = info.asReader().getLweDimension();
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
 
     for (size_t i = 0; i < inputTensor.values.size(); i++) {
@@ -626,16 +718,59 @@ Result<Transformer> getDecryptionTransformer(
   auto lweSize = lweDimension + 1;
 
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
-    auto outputTensor = Tensor<uint64_t>(inputTensor);
+    // The ciphertexts are only read, they are not copied
+    const auto &inputTensor = *input.getTensorPtr<uint64_t>();
+    Tensor<uint64_t> outputTensor;
+    outputTensor.dimensions = inputTensor.dimensions;
     outputTensor.dimensions.pop_back();
-    outputTensor.values.resize(outputTensor.values.size() / lweSize);
+    outputTensor.values.resize(inputTensor.values.size() / lweSize);
 
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
+    forEachInParallel(outputTensor.values.size(), [&](size_t i) {
       concrete_cpu_decrypt_lwe_ciphertext_u64(
           key.getRawPtr(), &inputTensor.values[i * lweSize], lweDimension,
           &outputTensor.values[i]);
-    }
+    });
+
+    return Value{outputTensor};
+  };
+}
+
+Result<Transformer> getUnpackingDecryptionTransformer(
+    ClientKeyset keyset,
+    const Message<concreteprotocol::LweCiphertextTypeInfo> &info) {
+
+  auto key =
+      keyset.lweSecretKeys[info.asReader().getPacking().getSecretKeyId()];
+  auto glweDimension = info.asReader().getPacking().getGlweDimension();
+  auto polynomialSize = info.asReader().getPacking().getPolynomialSize();
+  auto glweSize = (glweDimension + 1) * polynomialSize;
+  auto count = getLweCiphertextCount(info.asReader());
+  std::vector<size_t> dimensions;
+  for (auto dim : info.asReader().getConcreteShape().getDimensions()) {
+    dimensions.push_back(dim);
+  }
+  dimensions.pop_back();
+
+  return [=](Value input) {
+    // The packing secret key of the ciphertexts is their glwe secret key,
+    // each glwe ciphertext decrypts to the plaintexts of the lwe ciphertexts
+    // it packs, in order.
+    const auto &inputTensor = *input.getTensorPtr<uint64_t>();
+    Tensor<uint64_t> outputTensor;
+    outputTensor.dimensions = dimensions;
+    outputTensor.values.resize(count);
+
+    size_t glweCount = (count + polynomialSize - 1) / polynomialSize;
+    forEachInParallel(glweCount, [&](size_t i) {
+      std::vector<uint64_t> plaintexts(polynomialSize);
+      concrete_cpu_decrypt_glwe_ciphertext_u64(
+          key.getRawPtr(), plaintexts.data(), &inputTensor.values[i * glweSize],
+          glweDimension, polynomialSize);
+      size_t packed =
+          std::min<size_t>(polynomialSize, count - i * polynomialSize);
+      std::copy_n(plaintexts.begin(), packed,
+                  outputTensor.values.begin() + i * polynomialSize);
+    });
 
     return Value{outputTensor};
   };
@@ -655,7 +790,7 @@ Result<Transformer> getNoneDecompressionTransformer() {
 
 Result<Transformer> getBooleanDecodingTransformer() {
   return [=](Value input) {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
 
     for (size_t i = 0; i < inputTensor.values.size(); i++) {
@@ -725,7 +860,7 @@ Result<OutputTransformer> TransformerFactory::getIndexOutputTransformer(
         "Tried to get index output transformer from non-index gate info.");
   }
   OUTCOME_TRY(auto verify, getTransportValueVerifier(gateInfo));
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
     return Value::fromRawTransportValue(transportVal);
   };
@@ -777,7 +912,7 @@ Result<OutputTransformer> TransformerFactory::getPlaintextOutputTransformer(
                        "non-plaintext gate info.");
   }
   OUTCOME_TRY(auto verify, getTransportValueVerifier(gateInfo));
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
     return Value::fromRawTransportValue(transportVal);
   };
@@ -803,27 +938,10 @@ Result<ReturnTransformer> TransformerFactory::getPlaintextReturnTransformer(
   return getPlaintextInputTransformer(std::move(gateInfo));
 }
 
-Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
-    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
-    std::shared_ptr<csprng::EncryptionCSPRNG> csprng, bool useSimulation) {
-  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
-    return StringError("Tried to get lwe ciphertext input transformer from "
-                       "non-ciphertext gate info.");
-  }
-  if (!useSimulation) {
-    auto keyid = gateInfo.asReader()
-                     .getTypeInfo()
-                     .getLweCiphertext()
-                     .getEncryption()
-                     .getKeyId();
-    if (keyid >= keyset.lweSecretKeys.size()) {
-      return StringError(
-          "Tried to generate lwe ciphertext input transformer with "
-          "key id unavailable");
-    }
-  }
-
-  /// Generating the encoding transformer.
+/// Returns the transformer encoding the values of a ciphertext input gate into
+/// the plaintexts of its ciphertexts.
+Result<Transformer> getLweCiphertextEncodingTransformer(
+    Message<concreteprotocol::GateInfo> gateInfo) {
   Transformer encodingTransformer;
   if (gateInfo.asReader()
           .getTypeInfo()
@@ -847,6 +965,29 @@ Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
   } else {
     return StringError("Malformed gate info");
   }
+  return encodingTransformer;
+}
+
+/// Returns the transformer encoding and encrypting the values of a ciphertext
+/// input gate, whose input is not verified.
+Result<Transformer> getLweCiphertextEncryptionPipeline(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    std::shared_ptr<csprng::EncryptionCSPRNG> csprng, bool useSimulation) {
+  if (!useSimulation) {
+    auto keyid = gateInfo.asReader()
+                     .getTypeInfo()
+                     .getLweCiphertext()
+                     .getEncryption()
+                     .getKeyId();
+    if (keyid >= keyset.lweSecretKeys.size()) {
+      return StringError(
+          "Tried to generate lwe ciphertext input transformer with "
+          "key id unavailable");
+    }
+  }
+
+  OUTCOME_TRY(auto encodingTransformer,
+              getLweCiphertextEncodingTransformer(gateInfo));
 
   /// Generating the encryption transformer.
   Transformer encryptionTransformer;
@@ -888,24 +1029,251 @@ Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
     }
   }
 
+  return [=](Value val) {
+    return encryptionTransformer(encodingTransformer(std::move(val)));
+  };
+}
+
+Result<InputTransformer> TransformerFactory::getLweCiphertextInputTransformer(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    std::shared_ptr<csprng::EncryptionCSPRNG> csprng, bool useSimulation) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext input transformer from "
+                       "non-ciphertext gate info.");
+  }
+  OUTCOME_TRY(auto encryptionPipeline,
+              getLweCiphertextEncryptionPipeline(keyset, gateInfo, csprng,
+                                                 useSimulation));
   OUTCOME_TRY(auto verify, getLweCiphertextInputValueVerifier(gateInfo));
   return [=](Value val) -> Result<TransportValue> {
     OUTCOME_TRYV(verify(val));
-    auto output =
-        encryptionTransformer(encodingTransformer(val)).intoRawTransportValue();
+    auto output = encryptionPipeline(val).intoRawTransportValue();
+    output.asBuilder().initTypeInfo().setLweCiphertext(
+        gateInfo.asReader().getTypeInfo().getLweCiphertext());
+    return output;
+  };
+}
+
+Result<InputTransformer>
+TransformerFactory::getLweCiphertextPrecomputedInputTransformer(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext input transformer from "
+                       "non-ciphertext gate info.");
+  }
+  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() !=
+      concreteprotocol::Compression::NONE) {
+    return StringError("Only the uncompressed ciphertexts can be encrypted "
+                       "from encryptions of zero.");
+  }
+  OUTCOME_TRY(auto encodingTransformer,
+              getLweCiphertextEncodingTransformer(gateInfo));
+  OUTCOME_TRY(auto verify, getLweCiphertextInputValueVerifier(gateInfo));
+  auto encryption =
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getEncryption();
+  auto key = keyset.lweSecretKeys[encryption.getKeyId()].getSharedBuffer();
+  size_t lweDimension = encryption.getLweDimension();
+  double variance = encryption.getVariance();
+  return [=](Value val) -> Result<TransportValue> {
+    OUTCOME_TRYV(verify(val));
+    auto encoded = encodingTransformer(std::move(val));
+    const auto inputTensor = encoded.getTensor<uint64_t>().value();
+    size_t lweSize = lweDimension + 1;
+    size_t count = inputTensor.values.size();
+    auto outputTensor = Tensor<uint64_t>(inputTensor);
+    outputTensor.dimensions.push_back(lweSize);
+    outputTensor.values.resize(count * lweSize);
+    uint64_t *ciphertexts = outputTensor.values.data();
+    // The pool was created by the precomputation of the encryptions
+    auto pool = csprng->getPrecomputationPool(lweDimension, variance, true);
+    pool->takeEncryptions(key, ciphertexts, count);
+    // The plaintexts are added to the bodies, the last words of the
+    // ciphertexts
+    for (size_t i = 0; i < count; i++)
+      ciphertexts[i * lweSize + lweSize - 1] += inputTensor.values[i];
+    auto output = Value{outputTensor}.intoRawTransportValue();
     output.asBuilder().initTypeInfo().setLweCiphertext(
         gateInfo.asReader().getTypeInfo().getLweCiphertext());
     return output;
   };
 }
 
+/// Returns the elements `begin` to `end` of the flattened values of `value`,
+/// as a one dimension tensor of the same element type sharing its elements.
+Value sliceFlattenedValue(const Value &value, size_t begin, size_t end) {
+  return std::visit(
+      [&](const auto &tensor) {
+        typedef typename std::decay_t<decltype(tensor.values)>::value_type T;
+        return Value{Tensor<T>(tensor.values.slice(begin, end),
+                               std::vector<size_t>{end - begin})};
+      },
+      value.inner);
+}
+
+/// Returns the values of `values`, whose last `tailRank` dimensions are the
+/// same, concatenated as a tensor of dimensions `{n} + tail` where `n` is the
+/// total number of their elements of the shape `tail` of those dimensions.
+Result<Value> concatBatch(const std::vector<Value> &values, size_t tailRank) {
+  return std::visit(
+      [&](const auto &first) -> Result<Value> {
+        typedef typename std::decay_t<decltype(first.values)>::value_type T;
+        if (first.dimensions.size() < tailRank) {
+          return StringError("Tried to batch values of incompatible shapes.");
+        }
+        std::vector<size_t> tail(first.dimensions.end() - tailRank,
+                                 first.dimensions.end());
+        size_t size = 0;
+        for (auto &value : values) {
+          auto tensor = std::get_if<Tensor<T>>(&value.inner);
+          if (tensor == nullptr) {
+            return StringError(
+                "Tried to batch values of different element types.");
+          }
+          if (tensor->dimensions.size() < tailRank ||
+              !std::equal(tail.begin(), tail.end(),
+                          tensor->dimensions.end() - tailRank)) {
+            return StringError("Tried to batch values of incompatible shapes.");
+          }
+          size += tensor->values.size();
+        }
+        size_t tailSize = 1;
+        for (auto dim : tail)
+          tailSize *= dim;
+        Tensor<T> batch;
+        if (values.size() == 1) {
+          // A single value is batched as is, sharing its elements
+          batch.values = first.values;
+        } else {
+          batch.values.reserve(size);
+          for (auto &value : values) {
+            auto &elements = std::get<Tensor<T>>(value.inner).values;
+            batch.values.insert(batch.values.end(), elements.begin(),
+                                elements.end());
+          }
+        }
+        batch.dimensions.push_back(tailSize == 0 ? 0 : size / tailSize);
+        batch.dimensions.insert(batch.dimensions.end(), tail.begin(),
+                                tail.end());
+        return Value{std::move(batch)};
+      },
+      values.front().inner);
+}
+
+/// Returns the elements `begin` to `end` of the first dimension of `batch`,
+/// as a tensor of dimensions `dimensions` of the same element type.
+Value sliceBatch(const Value &batch, size_t begin, size_t end,
+                 std::vector<size_t> dimensions) {
+  return std::visit(
+      [&](const auto &tensor) {
+        typedef typename std::decay_t<decltype(tensor.values)>::value_type T;
+        size_t stride = 1;
+        for (size_t i = 1; i < tensor.dimensions.size(); i++)
+          stride *= tensor.dimensions[i];
+        return Value{
+            Tensor<T>(tensor.values.slice(begin * stride, end * stride),
+                      std::move(dimensions))};
+      },
+      batch.inner);
+}
+
+Result<BatchInputTransformer>
+TransformerFactory::getLweCiphertextBatchInputTransformer(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    std::shared_ptr<csprng::EncryptionCSPRNG> csprng, bool useSimulation) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext batch input transformer "
+                       "from non-ciphertext gate info.");
+  }
+  OUTCOME_TRY(auto encryptionPipeline,
+              getLweCiphertextEncryptionPipeline(keyset, gateInfo, csprng,
+                                                 useSimulation));
+  OUTCOME_TRY(auto verify, getLweCiphertextInputValueVerifier(gateInfo));
+  return [=](const std::vector<Value> &vals)
+             -> Result<std::vector<TransportValue>> {
+    std::vector<TransportValue> outputs;
+    if (vals.empty()) {
+      return outputs;
+    }
+    for (auto &val : vals) {
+      OUTCOME_TRYV(verify(val));
+    }
+    // The samples are encoded and encrypted at once, as a single tensor, so
+    // that the encryption runs in parallel over all their ciphertexts.
+    OUTCOME_TRY(auto batch, concatBatch(vals, 0));
+    auto encrypted = encryptionPipeline(std::move(batch));
+    auto encryptedDimensions = encrypted.getDimensions();
+    size_t offset = 0;
+    outputs.reserve(vals.size());
+    for (auto &val : vals) {
+      auto dimensions = val.getDimensions();
+      dimensions.insert(dimensions.end(), encryptedDimensions.begin() + 1,
+                        encryptedDimensions.end());
+      size_t length = val.getLength();
+      auto output = sliceBatch(encrypted, offset, offset + length, dimensions)
+                        .intoRawTransportValue();
+      output.asBuilder().initTypeInfo().setLweCiphertext(
+          gateInfo.asReader().getTypeInfo().getLweCiphertext());
+      outputs.push_back(std::move(output));
+      offset += length;
+    }
+    return outputs;
+  };
+}
+
+Result<StreamInputTransformer>
+TransformerFactory::getLweCiphertextStreamInputTransformer(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    std::shared_ptr<csprng::EncryptionCSPRNG> csprng) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext stream input transformer "
+                       "from non-ciphertext gate info.");
+  }
+  OUTCOME_TRY(auto encryptionPipeline, getLweCiphertextEncryptionPipeline(
+                                           keyset, gateInfo, csprng, false));
+  OUTCOME_TRY(auto verify, getLweCiphertextInputValueVerifier(gateInfo));
+  // Every element of the value is transported as the same number of integers
+  size_t payloadSize = getRawPayloadSize(gateInfo.asReader().getRawInfo());
+  return [=](Value val, size_t chunkSize) -> Result<TransportValueStream> {
+    OUTCOME_TRYV(verify(val));
+    if (chunkSize == 0) {
+      return StringError("Tried to stream a value in empty chunks.");
+    }
+    TransportValueStream stream;
+    auto header = stream.header.asBuilder();
+    header.setRawInfo(gateInfo.asReader().getRawInfo());
+    header.initTypeInfo().setLweCiphertext(
+        gateInfo.asReader().getTypeInfo().getLweCiphertext());
+    size_t length = val.getLength();
+    size_t elementSize = length == 0 ? 0 : payloadSize / length;
+    size_t chunkCount = (length + chunkSize - 1) / chunkSize;
+    stream.chunkCount = chunkCount;
+    // The chunks are encrypted on demand, only the cleartext value is kept
+    auto input = std::make_shared<Value>(std::move(val));
+    stream.getChunk = [=](size_t index) -> Result<TransportValueChunk> {
+      if (index >= chunkCount) {
+        return StringError("Tried to prepare a chunk out of the stream.");
+      }
+      size_t begin = index * chunkSize;
+      size_t end = std::min(begin + chunkSize, length);
+      auto encrypted =
+          encryptionPipeline(sliceFlattenedValue(*input, begin, end));
+      TransportValueChunk chunk;
+      chunk.asBuilder().setOffset(begin * elementSize);
+      encrypted.intoProtoPayload(chunk.asBuilder().initPayload());
+      return chunk;
+    };
+    return stream;
+  };
+}
+
 Result<Transformer> getSeededLweCiphertextDecompressionTransformer(
     const Message<concreteprotocol::LweCiphertextEncryptionInfo> &info) {
 
   auto lweDimension = info.asReader().getLweDimension();
   auto lweSize = lweDimension + 1;
   return [=](Value input) -> Value {
-    auto inputTensor = input.getTensor<uint64_t>().value();
+    const auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     outputTensor.dimensions.back() = lweSize;
     auto size = 1;
@@ -932,7 +1300,7 @@ Result<ArgTransformer> getDecompressionTransformer(
   if (useSimulation)
     return Value::fromRawTransportValue;
 
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     auto value = Value::fromRawTransportValue(transportVal);
     auto compression = transportVal.asReader()
                            .getTypeInfo()
@@ -940,7 +1308,7 @@ Result<ArgTransformer> getDecompressionTransformer(
                            .getCompression();
     if (compression == concreteprotocol::Compression::SEED) {
       OUTCOME_TRY(auto d, getSeededLweCiphertextDecompressionTransformer(info));
-      return d(value);
+      return d(std::move(value));
     }
     return value;
   };
@@ -969,12 +1337,112 @@ Result<ArgTransformer> TransformerFactory::getLweCiphertextArgTransformer(
     OUTCOME_TRY(verify, getTransportValueVerifier(gateInfo));
   }
 
-  return [=](TransportValue transportVal) -> Result<Value> {
+  return [=](const TransportValue &transportVal) -> Result<Value> {
     OUTCOME_TRYV(verify(transportVal));
     return decompressionTransformer(transportVal);
   };
 }
 
+Result<StreamArgTransformer>
+TransformerFactory::getLweCiphertextStreamArgTransformer(
+    Message<concreteprotocol::GateInfo> gateInfo, bool useSimulation) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext stream arg transformer "
+                       "from non-ciphertext gate info.");
+  }
+  auto lweDimension = gateInfo.asReader()
+                          .getTypeInfo()
+                          .getLweCiphertext()
+                          .getEncryption()
+                          .getLweDimension();
+  auto lweSize = lweDimension + 1;
+
+  // Generating the verifier, the payload is checked as the chunks arrive.
+  TransportValueVerifier verifyHeader;
+  if (useSimulation) {
+    OUTCOME_TRY(verifyHeader, getObliviousTransportValueVerifier());
+  } else {
+    OUTCOME_TRY(verifyHeader, getTransportValueHeaderVerifier(gateInfo));
+  }
+
+  return [=](const TransportValue &header) -> Result<ArgStream> {
+    OUTCOME_TRYV(verifyHeader(header));
+    auto rawInfo = header.asReader().getRawInfo();
+    if (rawInfo.getIntegerPrecision() != 64 || rawInfo.getIsSigned()) {
+      return StringError("Tried to stream a ciphertext argument which is not "
+                         "made of unsigned 64 bits integers.");
+    }
+    bool seeded = !useSimulation && header.asReader()
+                                            .getTypeInfo()
+                                            .getLweCiphertext()
+                                            .getCompression() ==
+                                        concreteprotocol::Compression::SEED;
+
+    // The chunks are decompressed, if needed, in the argument as they arrive
+    struct State {
+      Tensor<uint64_t> arg;
+      size_t received = 0;
+      size_t expected;
+    };
+    auto state = std::make_shared<State>();
+    state->expected = getRawPayloadSize(rawInfo);
+    auto dimensions = protoShapeToDimensions(rawInfo.getShape());
+    if (seeded) {
+      if (dimensions.empty()) {
+        return StringError("Tried to stream a malformed seeded argument.");
+      }
+      dimensions.back() = lweSize;
+    }
+    state->arg = Tensor<uint64_t>::fromDimensions(dimensions);
+
+    ArgStream stream;
+    stream.push = [=](const TransportValueChunk &chunk) -> Result<void> {
+      auto reader = chunk.asReader();
+      if (reader.getOffset() != state->received) {
+        return StringError("Tried to push an argument chunk out of order.");
+      }
+      size_t size = 0;
+      for (auto blob : reader.getPayload().getData()) {
+        size += blob.size();
+      }
+      if (size % sizeof(uint64_t) != 0 ||
+          state->received + size > state->expected) {
+        return StringError("Tried to push an argument chunk with "
+                           "incompatible payload size.");
+      }
+      auto values = protoPayloadToVector<uint64_t>(reader.getPayload());
+      size_t first = state->received / sizeof(uint64_t);
+      if (seeded) {
+        // 3 = 2 (seed) + 1 (encrypted scalar)
+        if (first % 3 != 0 || values.size() % 3 != 0) {
+          return StringError("Tried to push an argument chunk splitting a "
+                             "seeded ciphertext.");
+        }
+        for (size_t i = 0; i < values.size(); i += 3) {
+          Uint128 seed;
+          csprng::readSeed(seed, &values[i]);
+          concrete_cpu_decompress_seeded_lwe_ciphertext_u64(
+              &state->arg.values[((first + i) / 3) * lweSize], &values[i + 2],
+              lweDimension, seed);
+        }
+      } else {
+        std::copy(values.begin(), values.end(),
+                  state->arg.values.begin() + first);
+      }
+      state->received += size;
+      return outcome::success();
+    };
+    stream.finish = [=]() -> Result<Value> {
+      if (state->received != state->expected) {
+        return StringError(
+            "Tried to finish an argument stream with missing chunks.");
+      }
+      return Value{std::move(state->arg)};
+    };
+    return stream;
+  };
+}
+
 Result<ReturnTransformer> TransformerFactory::getLweCiphertextReturnTransformer(
     Message<concreteprotocol::GateInfo> gateInfo, bool useSimulation) {
   if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
@@ -982,10 +1450,14 @@ Result<ReturnTransformer> TransformerFactory::getLweCiphertextReturnTransformer(
                        "non-ciphertext gate info.");
   }
 
-  /// Generating the compression transformer.
+  /// Generating the compression transformer. Ciphertexts compressed with
+  /// glwe packing are returned unpacked here, they are packed with the keys of
+  /// the call by the packing return transformer.
   Transformer compressionTransformer;
-  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() ==
-      concreteprotocol::Compression::NONE) {
+  auto compression =
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression();
+  if (compression == concreteprotocol::Compression::NONE ||
+      compression == concreteprotocol::Compression::GLWE_PACKING) {
     OUTCOME_TRY(compressionTransformer, getNoneCompressionTransformer());
   } else {
     return StringError(
@@ -1003,20 +1475,96 @@ Result<ReturnTransformer> TransformerFactory::getLweCiphertextReturnTransformer(
 
   return [=](Value val) -> Result<TransportValue> {
     OUTCOME_TRYV(verify(val));
-    auto output = compressionTransformer(val).intoRawTransportValue();
+    auto output =
+        compressionTransformer(std::move(val)).intoRawTransportValue();
     output.asBuilder().initTypeInfo().setLweCiphertext(
         gateInfo.asReader().getTypeInfo().getLweCiphertext());
+    output.asBuilder().getTypeInfo().getLweCiphertext().setCompression(
+        concreteprotocol::Compression::NONE);
     return output;
   };
 }
 
-Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
-    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
-    bool useSimulation) {
-  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
-    return StringError("Tried to get lwe ciphertext output transformer from "
-                       "non-ciphertext gate info.");
+Result<PackingReturnTransformer>
+TransformerFactory::getLweCiphertextPackingReturnTransformer(
+    Message<concreteprotocol::GateInfo> gateInfo) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext() ||
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() !=
+          concreteprotocol::Compression::GLWE_PACKING) {
+    return StringError("Tried to get lwe ciphertext packing return transformer "
+                       "from non-packed ciphertext gate info.");
   }
+
+  // Generating the verifier.
+  OUTCOME_TRY(auto verify, getLweCiphertextOutputValueVerifier(gateInfo));
+
+  auto lweCiphertext = gateInfo.asReader().getTypeInfo().getLweCiphertext();
+  auto lweSize = lweCiphertext.getEncryption().getLweDimension() + 1;
+  auto glweDimension = lweCiphertext.getPacking().getGlweDimension();
+  auto polynomialSize = lweCiphertext.getPacking().getPolynomialSize();
+  auto glweSize = (glweDimension + 1) * polynomialSize;
+  auto packedShape = getPackedShape(lweCiphertext);
+
+  return [=](Value val,
+             const GlwePackingKeyswitchKey &key) -> Result<TransportValue> {
+    OUTCOME_TRYV(verify(val));
+    auto params = key.getInfo().asReader().getParams();
+    if (params.getInputLweDimension() + 1 != lweSize ||
+        params.getGlweDimension() != glweDimension ||
+        params.getPolynomialSize() != polynomialSize) {
+      return StringError(
+          "Tried to pack ciphertext output value with incompatible key.");
+    }
+
+    // The ciphertexts are only read, they are not copied
+    const auto &inputTensor = *val.getTensorPtr<uint64_t>();
+    size_t count = inputTensor.values.size() / lweSize;
+    Tensor<uint64_t> outputTensor;
+    outputTensor.dimensions = packedShape;
+    outputTensor.values.resize(packedShape[0] * packedShape[1]);
+    forEachInParallel(packedShape[0], [&](size_t i) {
+      size_t packed =
+          std::min<size_t>(polynomialSize, count - i * polynomialSize);
+      key.pack(&inputTensor.values[i * polynomialSize * lweSize], packed,
+               &outputTensor.values[i * glweSize]);
+    });
+
+    auto output = Value{outputTensor}.intoRawTransportValue();
+    output.asBuilder().initTypeInfo().setLweCiphertext(
+        gateInfo.asReader().getTypeInfo().getLweCiphertext());
+    return output;
+  };
+}
+
+/// The steps of the processing of the transport values of a ciphertext
+/// output gate.
+struct LweCiphertextOutputPipeline {
+  TransportValueVerifier verify;
+  ArgTransformer decompress;
+  Transformer decrypt;
+  /// Decrypts the ciphertexts packed in glwe ciphertexts, if `packed`.
+  Transformer unpack;
+  bool packed;
+  Transformer decode;
+
+  Result<Value> operator()(const TransportValue &transportVal) const {
+    OUTCOME_TRYV(verify(transportVal));
+    if (packed && transportVal.asReader()
+                          .getTypeInfo()
+                          .getLweCiphertext()
+                          .getCompression() ==
+                      concreteprotocol::Compression::GLWE_PACKING) {
+      return decode(unpack(Value::fromRawTransportValue(transportVal)));
+    }
+    OUTCOME_TRY(auto value, decompress(transportVal));
+    return decode(decrypt(value));
+  }
+};
+
+Result<LweCiphertextOutputPipeline>
+getLweCiphertextOutputPipeline(ClientKeyset keyset,
+                               Message<concreteprotocol::GateInfo> gateInfo,
+                               bool useSimulation) {
   if (!useSimulation) {
     auto keyid = gateInfo.asReader()
                      .getTypeInfo()
@@ -1049,6 +1597,21 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
                 getDecryptionTransformer(keyset, encryptionInfo));
   }
 
+  /// Generating the decryption transformer of packed ciphertexts.
+  Transformer unpackingTransformer;
+  bool packed =
+      !useSimulation &&
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() ==
+          concreteprotocol::Compression::GLWE_PACKING;
+  if (packed) {
+    OUTCOME_TRY(unpackingTransformer,
+                getUnpackingDecryptionTransformer(
+                    keyset, (Message<concreteprotocol::LweCiphertextTypeInfo>)
+                                gateInfo.asReader()
+                                    .getTypeInfo()
+                                    .getLweCiphertext()));
+  }
+
   /// Generating the decoding transformer.
   Transformer decodingTransformer;
   if (gateInfo.asReader()
@@ -1082,10 +1645,88 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
     OUTCOME_TRY(verify, getTransportValueVerifier(gateInfo));
   }
 
-  return [=](TransportValue transportVal) -> Result<Value> {
-    OUTCOME_TRYV(verify(transportVal));
-    OUTCOME_TRY(auto value, decompressionTransformer(transportVal));
-    return decodingTransformer(decryptionTransformer(value));
+  return LweCiphertextOutputPipeline{verify,
+                                     decompressionTransformer,
+                                     decryptionTransformer,
+                                     unpackingTransformer,
+                                     packed,
+                                     decodingTransformer};
+}
+
+Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    bool useSimulation) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext output transformer from "
+                       "non-ciphertext gate info.");
+  }
+  OUTCOME_TRY(auto pipeline, getLweCiphertextOutputPipeline(keyset, gateInfo,
+                                                            useSimulation));
+  return OutputTransformer(pipeline);
+}
+
+Result<BatchOutputTransformer>
+TransformerFactory::getLweCiphertextBatchOutputTransformer(
+    ClientKeyset keyset, Message<concreteprotocol::GateInfo> gateInfo,
+    bool useSimulation) {
+  if (!gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+    return StringError("Tried to get lwe ciphertext batch output transformer "
+                       "from non-ciphertext gate info.");
+  }
+  OUTCOME_TRY(auto pipeline, getLweCiphertextOutputPipeline(keyset, gateInfo,
+                                                            useSimulation));
+  // The dimensions of the ciphertexts of an element follow those of the
+  // value: the lwe size, preceded by the number of moduli in crt mode or of
+  // chunks in chunked mode.
+  auto encoding =
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getEncoding();
+  size_t tailRank = useSimulation ? 0 : 1;
+  if (encoding.hasInteger() && !encoding.getInteger().getMode().hasNative()) {
+    tailRank++;
+  }
+  return [=](const std::vector<TransportValue> &transportVals)
+             -> Result<std::vector<Value>> {
+    std::vector<Value> outputs;
+    outputs.reserve(transportVals.size());
+    if (pipeline.packed) {
+      // Each sample has its own glwe ciphertexts, unpacked on their own
+      for (auto &transportVal : transportVals) {
+        OUTCOME_TRY(auto output, pipeline(transportVal));
+        outputs.push_back(std::move(output));
+      }
+      return outputs;
+    }
+    if (transportVals.empty()) {
+      return outputs;
+    }
+    std::vector<Value> values;
+    std::vector<std::vector<size_t>> dimensions;
+    values.reserve(transportVals.size());
+    for (auto &transportVal : transportVals) {
+      OUTCOME_TRYV(pipeline.verify(transportVal));
+      OUTCOME_TRY(auto value, pipeline.decompress(transportVal));
+      auto valueDimensions = value.getDimensions();
+      if (valueDimensions.size() < tailRank) {
+        return StringError("Tried to process a malformed TransportValue.");
+      }
+      valueDimensions.resize(valueDimensions.size() - tailRank);
+      dimensions.push_back(std::move(valueDimensions));
+      values.push_back(std::move(value));
+    }
+    // The ciphertexts of all the samples are decrypted and decoded at once
+    OUTCOME_TRY(auto batch, concatBatch(values, tailRank));
+    values.clear();
+    auto decoded = pipeline.decode(pipeline.decrypt(std::move(batch)));
+    size_t offset = 0;
+    for (auto &valueDimensions : dimensions) {
+      size_t length = 1;
+      for (auto dim : valueDimensions)
+        length *= dim;
+      outputs.push_back(
+          sliceBatch(decoded, offset, offset + length, valueDimensions));
+      offset += length;
+    }
+    return outputs;
   };
 }
 
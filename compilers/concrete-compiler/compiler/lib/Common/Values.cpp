@@ -16,16 +16,16 @@
 
 using concretelang::error::Result;
 using concretelang::error::StringError;
+using concretelang::protocol::arrayToProtoPayload;
 using concretelang::protocol::dimensionsToProtoShape;
 using concretelang::protocol::Message;
 using concretelang::protocol::protoPayloadToVector;
 using concretelang::protocol::protoShapeToDimensions;
-using concretelang::protocol::vectorToProtoPayload;
 
 namespace concretelang {
 namespace values {
 
-Value Value::fromRawTransportValue(TransportValue transportVal) {
+Value Value::fromRawTransportValue(const TransportValue &transportVal) {
   Value output;
   auto integerPrecision =
       transportVal.asReader().getRawInfo().getIntegerPrecision();
@@ -35,28 +35,28 @@ Value Value::fromRawTransportValue(TransportValue transportVal) {
   auto data = transportVal.asReader().getPayload();
   if (integerPrecision == 8 && isSigned) {
     auto values = protoPayloadToVector<int8_t>(data);
-    output.inner = Tensor<int8_t>{values, dimensions};
+    output.inner = Tensor<int8_t>{std::move(values), dimensions};
   } else if (integerPrecision == 16 && isSigned) {
     auto values = protoPayloadToVector<int16_t>(data);
-    output.inner = Tensor<int16_t>{values, dimensions};
+    output.inner = Tensor<int16_t>{std::move(values), dimensions};
   } else if (integerPrecision == 32 && isSigned) {
     auto values = protoPayloadToVector<int32_t>(data);
-    output.inner = Tensor<int32_t>{values, dimensions};
+    output.inner = Tensor<int32_t>{std::move(values), dimensions};
   } else if (integerPrecision == 64 && isSigned) {
     auto values = protoPayloadToVector<int64_t>(data);
-    output.inner = Tensor<int64_t>{values, dimensions};
+    output.inner = Tensor<int64_t>{std::move(values), dimensions};
   } else if (integerPrecision == 8 && !isSigned) {
     auto values = protoPayloadToVector<uint8_t>(data);
-    output.inner = Tensor<uint8_t>{values, dimensions};
+    output.inner = Tensor<uint8_t>{std::move(values), dimensions};
   } else if (integerPrecision == 16 && !isSigned) {
     auto values = protoPayloadToVector<uint16_t>(data);
-    output.inner = Tensor<uint16_t>{values, dimensions};
+    output.inner = Tensor<uint16_t>{std::move(values), dimensions};
   } else if (integerPrecision == 32 && !isSigned) {
     auto values = protoPayloadToVector<uint32_t>(data);
-    output.inner = Tensor<uint32_t>{values, dimensions};
+    output.inner = Tensor<uint32_t>{std::move(values), dimensions};
   } else if (integerPrecision == 64 && !isSigned) {
     auto values = protoPayloadToVector<uint64_t>(data);
-    output.inner = Tensor<uint64_t>{values, dimensions};
+    output.inner = Tensor<uint64_t>{std::move(values), dimensions};
   } else {
     assert(false);
   }
@@ -70,7 +70,7 @@ TransportValue Value::intoRawTransportValue() const {
   rawInfo.setShape(intoProtoShape().asReader());
   rawInfo.setIntegerPrecision(getIntegerPrecision());
   rawInfo.setIsSigned(isSigned());
-  output.asBuilder().setPayload(intoProtoPayload().asReader());
+  intoProtoPayload(output.asBuilder().initPayload());
   return output;
 }
 
@@ -102,25 +102,18 @@ bool Value::isSigned() const {
 }
 
 Message<concreteprotocol::Payload> Value::intoProtoPayload() const {
-  if (hasElementType<uint8_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint8_t>>(inner).values);
-  } else if (hasElementType<uint16_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint16_t>>(inner).values);
-  } else if (hasElementType<uint32_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint32_t>>(inner).values);
-  } else if (hasElementType<uint64_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<uint64_t>>(inner).values);
-  } else if (hasElementType<int8_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int8_t>>(inner).values);
-  } else if (hasElementType<int16_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int16_t>>(inner).values);
-  } else if (hasElementType<int32_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int32_t>>(inner).values);
-  } else if (hasElementType<int64_t>()) {
-    return vectorToProtoPayload(std::get<Tensor<int64_t>>(inner).values);
-  } else {
-    assert(false);
-  }
+  auto output = Message<concreteprotocol::Payload>();
+  intoProtoPayload(output.asBuilder());
+  return output;
+}
+
+void Value::intoProtoPayload(concreteprotocol::Payload::Builder builder) const {
+  std::visit(
+      [&](const auto &tensor) {
+        arrayToProtoPayload(tensor.values.data(), tensor.values.size(),
+                            builder);
+      },
+      inner);
 }
 
 Message<concreteprotocol::Shape> Value::intoProtoShape() const {
@@ -128,25 +121,8 @@ Message<concreteprotocol::Shape> Value::intoProtoShape() const {
 }
 
 std::vector<size_t> Value::getDimensions() const {
-  if (auto tensor = getTensor<uint8_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<uint16_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<uint32_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<uint64_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<int8_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<int16_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<int32_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else if (auto tensor = getTensor<int64_t>(); tensor) {
-    return tensor.value().dimensions;
-  } else {
-    assert(false);
-  }
+  return std::visit([](const auto &tensor) { return tensor.dimensions; },
+                    inner);
 }
 
 size_t Value::getLength() const {
@@ -267,7 +243,8 @@ Value Value::toSigned() const {
 }
 
 template <typename T>
-std::string printTypeWithScalarTensor(std::string type, Tensor<T> tensor) {
+std::string printTypeWithScalarTensor(std::string type,
+                                      const Tensor<T> &tensor) {
   std::stringstream str;
   if (tensor.isScalar()) {
     str << type << "(" << tensor.values[0] << ")";
@@ -3,9 +3,13 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include <mlir/Dialect/Utils/StaticValueUtils.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
+#include <mlir/Interfaces/ViewLikeInterface.h>
 #include <mlir/Pass/Pass.h>
 #include <mlir/Transforms/DialectConversion.h>
 
+#include "concretelang/Common/LutEncoding.h"
 #include "concretelang/Conversion/Passes.h"
 #include "concretelang/Conversion/Tools.h"
 #include "concretelang/Conversion/Utils/Utils.h"
@@ -38,16 +42,52 @@ char memref_batched_mul_cleartext_lwe_ciphertext_u64[] =
     "memref_batched_mul_cleartext_lwe_ciphertext_u64";
 char memref_batched_mul_cleartext_cst_lwe_ciphertext_u64[] =
     "memref_batched_mul_cleartext_cst_lwe_ciphertext_u64";
+char memref_batched_mul_cleartext_add_lwe_ciphertexts_u64[] =
+    "memref_batched_mul_cleartext_add_lwe_ciphertexts_u64";
+char memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64[] =
+    "memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64";
 char memref_batched_negate_lwe_ciphertext_u64[] =
     "memref_batched_negate_lwe_ciphertext_u64";
+char memref_gather_lwe_ciphertexts_u64[] =
+    "memref_gather_lwe_ciphertexts_u64";
+char memref_scatter_lwe_ciphertexts_u64[] =
+    "memref_scatter_lwe_ciphertexts_u64";
 char memref_batched_keyswitch_lwe_u64[] = "memref_batched_keyswitch_lwe_u64";
 char memref_batched_bootstrap_lwe_u64[] = "memref_batched_bootstrap_lwe_u64";
 char memref_batched_mapped_bootstrap_lwe_u64[] =
     "memref_batched_mapped_bootstrap_lwe_u64";
+char memref_bootstrap_lwe_with_accumulator_u64[] =
+    "memref_bootstrap_lwe_with_accumulator_u64";
+char memref_batched_bootstrap_lwe_with_accumulator_u64[] =
+    "memref_batched_bootstrap_lwe_with_accumulator_u64";
+char memref_many_lut_bootstrap_lwe_u64[] = "memref_many_lut_bootstrap_lwe_u64";
+char memref_keyswitch_bootstrap_lwe_u64[] =
+    "memref_keyswitch_bootstrap_lwe_u64";
+char memref_batched_keyswitch_bootstrap_lwe_u64[] =
+    "memref_batched_keyswitch_bootstrap_lwe_u64";
+char memref_keyswitch_bootstrap_lwe_with_accumulator_u64[] =
+    "memref_keyswitch_bootstrap_lwe_with_accumulator_u64";
+char memref_batched_keyswitch_bootstrap_lwe_with_accumulator_u64[] =
+    "memref_batched_keyswitch_bootstrap_lwe_with_accumulator_u64";
 
 char memref_keyswitch_async_lwe_u64[] = "memref_keyswitch_async_lwe_u64";
 char memref_bootstrap_async_lwe_u64[] = "memref_bootstrap_async_lwe_u64";
+char memref_bootstrap_async_lwe_with_accumulator_u64[] =
+    "memref_bootstrap_async_lwe_with_accumulator_u64";
+char memref_keyswitch_bootstrap_async_lwe_u64[] =
+    "memref_keyswitch_bootstrap_async_lwe_u64";
+char memref_keyswitch_bootstrap_async_lwe_with_accumulator_u64[] =
+    "memref_keyswitch_bootstrap_async_lwe_with_accumulator_u64";
 char memref_await_future[] = "memref_await_future";
+char concrete_output_ready[] = "concrete_output_ready";
+char memref_keyswitch_lwe_compact_u64[] = "memref_keyswitch_lwe_compact_u64";
+char memref_bootstrap_lwe_compact_u64[] = "memref_bootstrap_lwe_compact_u64";
+char memref_bootstrap_lwe_with_accumulator_compact_u64[] =
+    "memref_bootstrap_lwe_with_accumulator_compact_u64";
+char memref_keyswitch_bootstrap_lwe_compact_u64[] =
+    "memref_keyswitch_bootstrap_lwe_compact_u64";
+char memref_keyswitch_bootstrap_lwe_with_accumulator_compact_u64[] =
+    "memref_keyswitch_bootstrap_lwe_with_accumulator_compact_u64";
 char memref_keyswitch_lwe_cuda_u64[] = "memref_keyswitch_lwe_cuda_u64";
 char memref_bootstrap_lwe_cuda_u64[] = "memref_bootstrap_lwe_cuda_u64";
 char memref_batched_keyswitch_lwe_cuda_u64[] =
@@ -56,14 +96,26 @@ char memref_batched_bootstrap_lwe_cuda_u64[] =
     "memref_batched_bootstrap_lwe_cuda_u64";
 char memref_batched_mapped_bootstrap_lwe_cuda_u64[] =
     "memref_batched_mapped_bootstrap_lwe_cuda_u64";
+char memref_keyswitch_bootstrap_lwe_cuda_u64[] =
+    "memref_keyswitch_bootstrap_lwe_cuda_u64";
+char memref_batched_keyswitch_bootstrap_lwe_cuda_u64[] =
+    "memref_batched_keyswitch_bootstrap_lwe_cuda_u64";
+char memref_keep_on_device_cuda_u64[] = "memref_keep_on_device_cuda_u64";
+char memref_copy_to_host_cuda_u64[] = "memref_copy_to_host_cuda_u64";
+char memref_release_on_device_cuda_u64[] =
+    "memref_release_on_device_cuda_u64";
 char memref_expand_lut_in_trivial_glwe_ct_u64[] =
     "memref_expand_lut_in_trivial_glwe_ct_u64";
 
 char memref_wop_pbs_crt_buffer[] = "memref_wop_pbs_crt_buffer";
+char memref_wop_pbs_crt_buffer_cuda[] = "memref_wop_pbs_crt_buffer_cuda";
+char memref_batched_wop_pbs_crt_buffer[] = "memref_batched_wop_pbs_crt_buffer";
 
 char memref_encode_plaintext_with_crt[] = "memref_encode_plaintext_with_crt";
 char memref_encode_expand_lut_for_bootstrap[] =
     "memref_encode_expand_lut_for_bootstrap";
+char memref_encode_expand_many_lut_for_bootstrap[] =
+    "memref_encode_expand_many_lut_for_bootstrap";
 char memref_encode_lut_for_crt_woppbs[] = "memref_encode_lut_for_crt_woppbs";
 char memref_trace[] = "memref_trace";
 
@@ -74,6 +126,8 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 1);
   auto memref2DType =
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 2);
+  auto memref3DType =
+      mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 3);
   auto futureType =
       mlir::concretelang::RT::FutureType::get(rewriter.getIndexType());
   auto contextType =
@@ -110,12 +164,20 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                         memref1DType, i32Type, i32Type, i32Type,
                                         i32Type, i32Type, i32Type, contextType},
                                        {});
+  } else if (funcName == memref_bootstrap_lwe_with_accumulator_u64) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref1DType, memref1DType,
+                                        memref1DType, i32Type, i32Type, i32Type,
+                                        i32Type, i32Type, i32Type, contextType},
+                                       {});
   } else if (funcName == memref_keyswitch_async_lwe_u64) {
-    // Todo Answer this question: Isn't it dead ?
-    funcType = mlir::FunctionType::get(
-        rewriter.getContext(), {memref1DType, memref1DType, contextType},
-        {futureType});
-  } else if (funcName == memref_bootstrap_async_lwe_u64) {
+    funcType =
+        mlir::FunctionType::get(rewriter.getContext(),
+                                {memref1DType, memref1DType, i32Type, i32Type,
+                                 i32Type, i32Type, i32Type, contextType},
+                                {futureType});
+  } else if (funcName == memref_bootstrap_async_lwe_u64 ||
+             funcName == memref_bootstrap_async_lwe_with_accumulator_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref1DType, memref1DType,
                                         memref1DType, i32Type, i32Type, i32Type,
@@ -138,9 +200,27 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
     funcType = mlir::FunctionType::get(
         rewriter.getContext(),
         {memref2DType, memref2DType, rewriter.getI64Type()}, {});
+  } else if (funcName ==
+             memref_batched_mul_cleartext_add_lwe_ciphertexts_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DType, memref2DType, memref1DType, memref2DType}, {});
+  } else if (funcName ==
+             memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DType, memref2DType, rewriter.getI64Type(), memref2DType},
+        {});
   } else if (funcName == memref_batched_negate_lwe_ciphertext_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref2DType, memref2DType}, {});
+  } else if (funcName == memref_gather_lwe_ciphertexts_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(), {memref2DType, memref2DType, memref1DType}, {});
+  } else if (funcName == memref_scatter_lwe_ciphertexts_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DType, memref2DType, memref2DType, memref1DType}, {});
   } else if (funcName == memref_batched_keyswitch_lwe_u64 ||
              funcName == memref_batched_keyswitch_lwe_cuda_u64) {
     funcType =
@@ -155,6 +235,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                         memref1DType, i32Type, i32Type, i32Type,
                                         i32Type, i32Type, i32Type, contextType},
                                        {});
+  } else if (funcName == memref_batched_bootstrap_lwe_with_accumulator_u64) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref2DType, memref2DType,
+                                        memref1DType, i32Type, i32Type, i32Type,
+                                        i32Type, i32Type, i32Type, contextType},
+                                       {});
   } else if (funcName == memref_batched_mapped_bootstrap_lwe_u64 ||
              funcName == memref_batched_mapped_bootstrap_lwe_cuda_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
@@ -162,10 +248,48 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                         memref2DType, i32Type, i32Type, i32Type,
                                         i32Type, i32Type, i32Type, contextType},
                                        {});
-  } else if (funcName == memref_await_future) {
+  } else if (funcName == memref_keep_on_device_cuda_u64 ||
+             funcName == memref_copy_to_host_cuda_u64 ||
+             funcName == memref_release_on_device_cuda_u64) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref1DType, contextType}, {});
+  } else if (funcName == memref_many_lut_bootstrap_lwe_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DType, memref1DType, memref1DType, i32Type, i32Type, i32Type,
+         i32Type, i32Type, i32Type, i32Type, contextType},
+        {});
+  } else if (funcName == memref_keyswitch_bootstrap_lwe_u64 ||
+             funcName == memref_keyswitch_bootstrap_lwe_with_accumulator_u64 ||
+             funcName == memref_keyswitch_bootstrap_lwe_cuda_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref1DType, memref1DType, memref1DType, i32Type, i32Type, i32Type,
+         i32Type, i32Type, i32Type, i32Type, i32Type, i32Type, i32Type,
+         contextType},
+        {});
+  } else if (funcName == memref_batched_keyswitch_bootstrap_lwe_u64 ||
+             funcName ==
+                 memref_batched_keyswitch_bootstrap_lwe_with_accumulator_u64 ||
+             funcName == memref_batched_keyswitch_bootstrap_lwe_cuda_u64) {
     funcType = mlir::FunctionType::get(
         rewriter.getContext(),
-        {memref1DType, futureType, memref1DType, memref1DType}, {});
+        {memref2DType, memref2DType, memref1DType, i32Type, i32Type, i32Type,
+         i32Type, i32Type, i32Type, i32Type, i32Type, i32Type, i32Type,
+         contextType},
+        {});
+  } else if (funcName == memref_keyswitch_bootstrap_async_lwe_u64 ||
+             funcName ==
+                 memref_keyswitch_bootstrap_async_lwe_with_accumulator_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref1DType, memref1DType, memref1DType, i32Type, i32Type, i32Type,
+         i32Type, i32Type, i32Type, i32Type, i32Type, i32Type, i32Type,
+         contextType},
+        {futureType});
+  } else if (funcName == memref_await_future) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(), {memref1DType, futureType, memref1DType}, {});
   } else if (funcName == memref_expand_lut_in_trivial_glwe_ct_u64) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {
@@ -176,7 +300,8 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                            memref1DType,
                                        },
                                        {});
-  } else if (funcName == memref_wop_pbs_crt_buffer) {
+  } else if (funcName == memref_wop_pbs_crt_buffer ||
+             funcName == memref_wop_pbs_crt_buffer_cuda) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {
                                            memref2DType,
@@ -200,6 +325,29 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                        },
                                        {});
 
+  } else if (funcName == memref_batched_wop_pbs_crt_buffer) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {
+                                           memref3DType,
+                                           memref3DType,
+                                           memref2DType,
+                                           memref1DType,
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           rewriter.getI32Type(),
+                                           contextType,
+                                       },
+                                       {});
   } else if (funcName == memref_encode_plaintext_with_crt) {
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {memref1DType, rewriter.getI64Type(),
@@ -211,6 +359,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
         {memref1DType, memref1DType, rewriter.getI32Type(),
          rewriter.getI32Type(), rewriter.getI1Type()},
         {});
+  } else if (funcName == memref_encode_expand_many_lut_for_bootstrap) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref1DType, memref2DType, rewriter.getI32Type(),
+         rewriter.getI32Type(), rewriter.getI1Type()},
+        {});
   } else if (funcName == memref_encode_lut_for_crt_woppbs) {
     funcType = mlir::FunctionType::get(
         rewriter.getContext(),
@@ -332,8 +486,290 @@ void bootstrapAddOperands(BootstrapOp op,
   operands.push_back(getContextArgument(op));
 }
 
-void wopPBSAddOperands(Concrete::WopPBSCRTLweBufferOp op,
-                       mlir::SmallVector<mlir::Value> &operands,
+void manyLutBootstrapAddOperands(Concrete::ManyLutBootstrapLweBufferOp op,
+                                 mlir::SmallVector<mlir::Value> &operands,
+                                 mlir::RewriterBase &rewriter) {
+  // lut_stride, the lut count is the number of output ciphertexts
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getLutStrideAttr()));
+  bootstrapAddOperands(op, operands, rewriter);
+}
+
+/// Returns the value of the constant global `value` is loaded from, looking
+/// through casts, or null if `value` is not a constant global.
+mlir::DenseIntElementsAttr getConstantGlobalValue(mlir::Value value) {
+  while (auto castOp = value.getDefiningOp<memref::CastOp>())
+    value = castOp.getSource();
+
+  auto getGlobalOp = value.getDefiningOp<memref::GetGlobalOp>();
+  if (getGlobalOp == nullptr)
+    return nullptr;
+
+  auto globalOp = mlir::SymbolTable::lookupNearestSymbolFrom<memref::GlobalOp>(
+      getGlobalOp, getGlobalOp.getNameAttr());
+  if (globalOp == nullptr)
+    return nullptr;
+
+  return globalOp.getConstantInitValue()
+      .dyn_cast_or_null<mlir::DenseIntElementsAttr>();
+}
+
+/// Returns a constant global holding the trivial GLWE accumulator of the
+/// lookup table of `bOp`, or null if the lookup table is not a constant
+/// global.
+template <typename BootstrapOp>
+mlir::Value getConstantAccumulator(BootstrapOp bOp,
+                                   mlir::RewriterBase &rewriter) {
+  auto lut = getConstantGlobalValue(bOp.getLookupTable());
+  if (lut == nullptr)
+    return nullptr;
+
+  uint64_t polySize = bOp.getPolySize();
+  uint64_t glweDim = bOp.getGlweDimension();
+  if (lut.getNumElements() != (int64_t)polySize)
+    return nullptr;
+
+  std::vector<uint64_t> body;
+  for (const llvm::APInt &v : lut.getValues<llvm::APInt>())
+    body.push_back(v.getZExtValue());
+  std::vector<uint64_t> accumulator((glweDim + 1) * polySize);
+  concretelang::lut::trivialGlweAccumulator(accumulator.data(), body.data(),
+                                            glweDim, polySize);
+
+  auto attr = rewriter.getI64TensorAttr(llvm::ArrayRef<int64_t>(
+      (const int64_t *)accumulator.data(), accumulator.size()));
+  auto cst = rewriter.create<mlir::arith::ConstantOp>(bOp.getLoc(), attr);
+  auto globalMemref = mlir::bufferization::getGlobalFor(cst, 0);
+  rewriter.eraseOp(cst);
+  assert(!failed(globalMemref));
+  return rewriter.create<memref::GetGlobalOp>(bOp.getLoc(),
+                                              (*globalMemref).getType(),
+                                              (*globalMemref).getName());
+}
+
+/// Lowers a bootstrap whose lookup table is a constant global to a call to
+/// the `callee` variant taking the trivial GLWE accumulator, which is then
+/// built once at compile time instead of on every call.
+template <typename BootstrapOp, char const *callee>
+struct BootstrapWithConstantLutToCAPICallPattern
+    : public mlir::OpRewritePattern<BootstrapOp> {
+  BootstrapWithConstantLutToCAPICallPattern(::mlir::MLIRContext *context,
+                                            mlir::PatternBenefit benefit = 2)
+      : ::mlir::OpRewritePattern<BootstrapOp>(context, benefit) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(BootstrapOp bOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    mlir::Value accumulator = getConstantAccumulator(bOp, rewriter);
+    if (accumulator == nullptr)
+      return mlir::failure();
+
+    // Same operands as the lookup table variant, with the accumulator in
+    // place of the lookup table
+    mlir::SmallVector<mlir::Value> operands;
+    for (auto &operand : bOp->getOpOperands()) {
+      mlir::Value buffer = operand.get() == bOp.getLookupTable()
+                               ? accumulator
+                               : operand.get();
+      operands.push_back(mlir::concretelang::getCastedMemRef(rewriter, buffer));
+    }
+    bootstrapAddOperands<BootstrapOp>(bOp, operands, rewriter);
+
+    if (insertForwardDeclarationOfTheCAPI(bOp, rewriter, callee).failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.replaceOpWithNewOp<func::CallOp>(bOp, callee, mlir::TypeRange{},
+                                              operands);
+
+    return ::mlir::success();
+  };
+};
+
+/// Returns true if `op` cannot write to a buffer that was live before
+/// `ksOp`, i.e. it has no memory effect or only writes to buffers
+/// allocated after `ksOp`. Concrete buffer operations only write to their
+/// first operand.
+bool onlyWritesFreshBuffers(mlir::Operation *op, mlir::Operation *ksOp) {
+  if (mlir::isMemoryEffectFree(op) || mlir::isa<memref::AllocOp>(op))
+    return true;
+  if (!llvm::isa_and_nonnull<Concrete::ConcreteDialect>(op->getDialect()) ||
+      op->getNumOperands() == 0 || op->getNumRegions() != 0)
+    return false;
+  auto alloc = op->getOperand(0).getDefiningOp<memref::AllocOp>();
+  return alloc != nullptr && alloc->getBlock() == ksOp->getBlock() &&
+         ksOp->isBeforeInBlock(alloc);
+}
+
+/// Lowers a keyswitch whose result buffer is only read by a bootstrap to a
+/// single call to `callee` (or `accumulatorCallee` if the lookup table is
+/// constant and it is a distinct variant), so that the small intermediate
+/// ciphertext never goes through a memref. The pattern is rooted on the
+/// keyswitch since the conversion visits it first.
+template <typename KeySwitchOp, typename BootstrapOp, char const *callee,
+          char const *accumulatorCallee>
+struct KeySwitchBootstrapToCAPICallPattern
+    : public mlir::OpRewritePattern<KeySwitchOp> {
+  KeySwitchBootstrapToCAPICallPattern(::mlir::MLIRContext *context,
+                                      mlir::PatternBenefit benefit = 3)
+      : ::mlir::OpRewritePattern<KeySwitchOp>(context, benefit) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(KeySwitchOp ksOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    auto alloc = ksOp.getResult().template getDefiningOp<memref::AllocOp>();
+    if (alloc == nullptr)
+      return mlir::failure();
+
+    // The intermediate buffer must only be written by the keyswitch, read by
+    // a single bootstrap and deallocated
+    BootstrapOp bOp;
+    llvm::SmallVector<memref::DeallocOp> deallocs;
+    for (mlir::OpOperand &use : alloc->getUses()) {
+      mlir::Operation *user = use.getOwner();
+      if (user == ksOp && use.getOperandNumber() == 0)
+        continue;
+      if (auto dealloc = mlir::dyn_cast<memref::DeallocOp>(user)) {
+        deallocs.push_back(dealloc);
+        continue;
+      }
+      auto userBOp = mlir::dyn_cast<BootstrapOp>(user);
+      if (userBOp == nullptr || bOp != nullptr ||
+          use.get() != userBOp.getInputCiphertext())
+        return mlir::failure();
+      bOp = userBOp;
+    }
+    if (bOp == nullptr || bOp->getBlock() != ksOp->getBlock() ||
+        bOp.getInputLweDim() != ksOp.getLweDimOut())
+      return mlir::failure();
+
+    // The keyswitch is delayed to the bootstrap, so its input must not be
+    // overwritten in between
+    for (mlir::Operation *op = ksOp->getNextNode(); op != bOp;
+         op = op->getNextNode()) {
+      if (!onlyWritesFreshBuffers(op, ksOp))
+        return mlir::failure();
+    }
+
+    rewriter.setInsertionPoint(bOp);
+    mlir::Value lut = nullptr;
+    if (accumulatorCallee != callee)
+      lut = getConstantAccumulator(bOp, rewriter);
+    const char *calleeName = accumulatorCallee;
+    if (lut == nullptr) {
+      lut = bOp.getLookupTable();
+      calleeName = callee;
+    }
+
+    mlir::SmallVector<mlir::Value> operands{
+        mlir::concretelang::getCastedMemRef(rewriter, bOp.getResult()),
+        mlir::concretelang::getCastedMemRef(rewriter, ksOp.getCiphertext()),
+        mlir::concretelang::getCastedMemRef(rewriter, lut)};
+    mlir::Location loc = bOp.getLoc();
+    for (mlir::IntegerAttr attr :
+         {ksOp.getLevelAttr(), ksOp.getBaseLogAttr(), ksOp.getLweDimInAttr(),
+          ksOp.getLweDimOutAttr(), ksOp.getKskIndexAttr(),
+          bOp.getPolySizeAttr(), bOp.getLevelAttr(), bOp.getBaseLogAttr(),
+          bOp.getGlweDimensionAttr(), bOp.getBskIndexAttr()}) {
+      operands.push_back(rewriter.create<arith::ConstantOp>(loc, attr));
+    }
+    operands.push_back(getContextArgument(bOp));
+
+    if (insertForwardDeclarationOfTheCAPI(bOp, rewriter, calleeName)
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.replaceOpWithNewOp<func::CallOp>(bOp, calleeName,
+                                              mlir::TypeRange{}, operands);
+    rewriter.eraseOp(ksOp);
+    for (auto dealloc : deallocs)
+      rewriter.eraseOp(dealloc);
+    rewriter.eraseOp(alloc);
+
+    return ::mlir::success();
+  };
+};
+
+/// Lowers a batched multiplication by cleartexts whose result buffer is
+/// only read by a batched addition to a single call to `callee`, computing
+/// the sum of the products in one pass over the ciphertexts instead of
+/// writing the products to memory and reading them back. This fuses the
+/// multiply-accumulate chains of the linear layers. The pattern is rooted
+/// on the multiplication since the conversion visits it first.
+template <typename MulOp, char const *callee>
+struct MulCleartextAddToCAPICallPattern : public mlir::OpRewritePattern<MulOp> {
+  MulCleartextAddToCAPICallPattern(::mlir::MLIRContext *context,
+                                   mlir::PatternBenefit benefit = 2)
+      : ::mlir::OpRewritePattern<MulOp>(context, benefit) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(MulOp mulOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    auto alloc = mulOp.getResult().template getDefiningOp<memref::AllocOp>();
+    if (alloc == nullptr)
+      return mlir::failure();
+
+    // The products must only be written by the multiplication, read by a
+    // single addition and deallocated
+    Concrete::BatchedAddLweBufferOp addOp;
+    llvm::SmallVector<memref::DeallocOp> deallocs;
+    for (mlir::OpOperand &use : alloc->getUses()) {
+      mlir::Operation *user = use.getOwner();
+      if (user == mulOp && use.getOperandNumber() == 0)
+        continue;
+      if (auto dealloc = mlir::dyn_cast<memref::DeallocOp>(user)) {
+        deallocs.push_back(dealloc);
+        continue;
+      }
+      auto userAddOp = mlir::dyn_cast<Concrete::BatchedAddLweBufferOp>(user);
+      if (userAddOp == nullptr || addOp != nullptr ||
+          use.get() == userAddOp.getResult())
+        return mlir::failure();
+      addOp = userAddOp;
+    }
+    if (addOp == nullptr || addOp->getBlock() != mulOp->getBlock())
+      return mlir::failure();
+
+    // The multiplication is delayed to the addition, so its inputs must not
+    // be overwritten in between
+    for (mlir::Operation *op = mulOp->getNextNode(); op != addOp;
+         op = op->getNextNode()) {
+      if (!onlyWritesFreshBuffers(op, mulOp))
+        return mlir::failure();
+    }
+
+    rewriter.setInsertionPoint(addOp);
+    mlir::Value accumulator = addOp.getLhs() == alloc->getResult(0)
+                                  ? addOp.getRhs()
+                                  : addOp.getLhs();
+    mlir::Value cleartexts = mulOp.getRhs();
+    if (cleartexts.getType().template isa<mlir::MemRefType>())
+      cleartexts = mlir::concretelang::getCastedMemRef(rewriter, cleartexts);
+
+    mlir::SmallVector<mlir::Value> operands{
+        mlir::concretelang::getCastedMemRef(rewriter, addOp.getResult()),
+        mlir::concretelang::getCastedMemRef(rewriter, mulOp.getLhs()),
+        cleartexts,
+        mlir::concretelang::getCastedMemRef(rewriter, accumulator)};
+
+    if (insertForwardDeclarationOfTheCAPI(addOp, rewriter, callee).failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.replaceOpWithNewOp<func::CallOp>(addOp, callee, mlir::TypeRange{},
+                                              operands);
+    rewriter.eraseOp(mulOp);
+    for (auto dealloc : deallocs)
+      rewriter.eraseOp(dealloc);
+    rewriter.eraseOp(alloc);
+
+    return ::mlir::success();
+  };
+};
+
+template <typename WopPBSOp>
+void wopPBSAddOperands(WopPBSOp op, mlir::SmallVector<mlir::Value> &operands,
                        mlir::RewriterBase &rewriter) {
   mlir::Type crtType = mlir::RankedTensorType::get(
       {(int)op.getCrtDecompositionAttr().size()}, rewriter.getI64Type());
@@ -440,6 +876,20 @@ void encodeExpandLutForBootstrapAddOperands(
       op.getLoc(), op.getIsSignedAttr()));
 }
 
+void encodeExpandManyLutForBootstrapAddOperands(
+    Concrete::EncodeExpandManyLutForBootstrapBufferOp op,
+    mlir::SmallVector<mlir::Value> &operands, mlir::RewriterBase &rewriter) {
+  // poly_size
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getPolySizeAttr()));
+  // output bits
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getOutputBitsAttr()));
+  // is_signed
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getIsSignedAttr()));
+}
+
 void encodeLutForWopPBSAddOperands(Concrete::EncodeLutForCrtWopPBSBufferOp op,
                                    mlir::SmallVector<mlir::Value> &operands,
                                    mlir::RewriterBase &rewriter) {
@@ -492,9 +942,610 @@ void encodeLutForWopPBSAddOperands(Concrete::EncodeLutForCrtWopPBSBufferOp op,
       op.getLoc(), op.getIsSignedAttr()));
 }
 
+/// The runtime calls that can be offloaded to the async executor, with their
+/// async counterpart taking the same operands and returning a future.
+const std::pair<const char *, const char *> asyncCallees[] = {
+    {memref_keyswitch_lwe_u64, memref_keyswitch_async_lwe_u64},
+    {memref_bootstrap_lwe_u64, memref_bootstrap_async_lwe_u64},
+    {memref_bootstrap_lwe_with_accumulator_u64,
+     memref_bootstrap_async_lwe_with_accumulator_u64},
+    {memref_keyswitch_bootstrap_lwe_u64,
+     memref_keyswitch_bootstrap_async_lwe_u64},
+    {memref_keyswitch_bootstrap_lwe_with_accumulator_u64,
+     memref_keyswitch_bootstrap_async_lwe_with_accumulator_u64},
+};
+
+/// Returns the async counterpart of the callee of `call`, or null if it
+/// cannot be offloaded.
+const char *getAsyncCallee(func::CallOp call) {
+  for (auto &callees : asyncCallees) {
+    if (call.getCallee() == callees.first)
+      return callees.second;
+  }
+  return nullptr;
+}
+
+bool isAsyncCall(func::CallOp call) {
+  for (auto &callees : asyncCallees) {
+    if (call.getCallee() == callees.second)
+      return true;
+  }
+  return false;
+}
+
+/// Returns the buffer `value` is a view of.
+mlir::Value getRootBuffer(mlir::Value value) {
+  while (auto view = value.getDefiningOp<mlir::ViewLikeOpInterface>())
+    value = view.getViewSource();
+  return value;
+}
+
+/// Returns true if `type` is a row-major contiguous buffer, which the
+/// runtime wrappers can write as a dense block.
+bool isContiguous(mlir::MemRefType type) {
+  if (!type.hasStaticShape())
+    return false;
+  llvm::SmallVector<int64_t> strides;
+  int64_t offset;
+  if (mlir::failed(mlir::getStridesAndOffset(type, strides, offset)))
+    return false;
+  int64_t expected = 1;
+  for (int64_t d = type.getRank() - 1; d >= 0; d--) {
+    if (strides[d] != expected)
+      return false;
+    expected *= type.getDimSize(d);
+  }
+  return true;
+}
+
+/// Returns true if `type` is a batch of contiguous ciphertexts whose rows may
+/// be apart, e.g. a slice of a bigger batch along its second dimension.
+bool hasContiguousRows(mlir::MemRefType type) {
+  llvm::SmallVector<int64_t> strides;
+  int64_t offset;
+  return type.hasStaticShape() && type.getRank() == 2 &&
+         mlir::succeeded(mlir::getStridesAndOffset(type, strides, offset)) &&
+         strides[1] == 1 && strides[0] >= type.getDimSize(1);
+}
+
+/// Returns true if the runtime wrapper of `op` honours the row stride of its
+/// output batch.
+bool acceptsStridedRows(mlir::Operation *op) {
+  return mlir::isa<
+      Concrete::BatchedAddLweBufferOp, Concrete::BatchedAddPlaintextLweBufferOp,
+      Concrete::BatchedAddPlaintextCstLweBufferOp,
+      Concrete::BatchedMulCleartextLweBufferOp,
+      Concrete::BatchedMulCleartextCstLweBufferOp,
+      Concrete::BatchedNegateLweBufferOp, Concrete::BatchedKeySwitchLweBufferOp,
+      Concrete::BatchedBootstrapLweBufferOp,
+      Concrete::BatchedMappedBootstrapLweBufferOp, Concrete::GatherLweBufferOp,
+      Concrete::ScatterLweBufferOp>(op);
+}
+
+/// Makes the Concrete operations whose result buffer is only copied to
+/// another one, e.g. to insert a ciphertext in a tensor, write their result
+/// directly to the destination of the copy, which removes the temporary
+/// buffer and the copy. The destination must be a dense view, or a view with
+/// contiguous rows for the batched operations, available before the
+/// operation, not accessed between the operation and the copy and not read by
+/// the operation. This makes e.g. the concatenations free, each operand being
+/// written in its slice of the result.
+void forwardResultsToCopyTargets(mlir::ModuleOp module) {
+  llvm::SmallVector<memref::CopyOp> copies;
+  module.walk([&](memref::CopyOp copy) { copies.push_back(copy); });
+
+  for (memref::CopyOp copy : copies) {
+    auto alloc = copy.getSource().getDefiningOp<memref::AllocOp>();
+    if (alloc == nullptr)
+      continue;
+
+    // The buffer must only be written by a Concrete operation, copied and
+    // deallocated
+    mlir::Operation *producer = nullptr;
+    llvm::SmallVector<memref::DeallocOp> deallocs;
+    bool forwardable = true;
+    for (mlir::OpOperand &use : alloc->getUses()) {
+      mlir::Operation *user = use.getOwner();
+      if (user == copy && use.getOperandNumber() == 0)
+        continue;
+      if (auto dealloc = mlir::dyn_cast<memref::DeallocOp>(user)) {
+        deallocs.push_back(dealloc);
+        continue;
+      }
+      if (producer != nullptr || use.getOperandNumber() != 0 ||
+          !llvm::isa<Concrete::ConcreteDialect>(user->getDialect())) {
+        forwardable = false;
+        break;
+      }
+      producer = user;
+    }
+    if (!forwardable || producer == nullptr ||
+        producer->getBlock() != copy->getBlock() ||
+        !producer->isBeforeInBlock(copy))
+      continue;
+    for (mlir::Operation *op = producer->getNextNode(); op != copy;
+         op = op->getNextNode()) {
+      forwardable &= mlir::isMemoryEffectFree(op);
+    }
+
+    mlir::Value target = copy.getTarget();
+    mlir::Value root = getRootBuffer(target);
+    auto targetType = target.getType().cast<mlir::MemRefType>();
+    forwardable &=
+        isContiguous(targetType) ||
+        (acceptsStridedRows(producer) && hasContiguousRows(targetType));
+    for (mlir::Value operand : producer->getOperands().drop_front()) {
+      forwardable &= getRootBuffer(operand) != root;
+    }
+    if (!forwardable)
+      continue;
+
+    // The view of the destination, and the static allocation it is a view
+    // of, may be created after the operation, in which case they are moved
+    // before it
+    auto isAfterProducer = [&](mlir::Operation *op) {
+      return op != nullptr && op->getBlock() == producer->getBlock() &&
+             producer->isBeforeInBlock(op);
+    };
+    mlir::Operation *view = target.getDefiningOp();
+    llvm::SmallVector<mlir::Operation *> moved;
+    if (isAfterProducer(view)) {
+      for (mlir::Value v : view->getOperands()) {
+        mlir::Operation *def = v.getDefiningOp();
+        if (!isAfterProducer(def))
+          continue;
+        if (!mlir::isa<memref::AllocOp>(def) || def->getNumOperands() != 0) {
+          forwardable = false;
+          break;
+        }
+        moved.push_back(def);
+      }
+      if (!forwardable)
+        continue;
+      moved.push_back(view);
+    }
+    for (mlir::Operation *op : moved)
+      op->moveBefore(producer);
+
+    producer->setOperand(0, target);
+    copy->erase();
+    for (auto dealloc : deallocs)
+      dealloc->erase();
+    alloc->erase();
+  }
+}
+
+/// Returns true if `op` is a call to a runtime wrapper, which only writes to
+/// its first operand.
+bool isRuntimeCall(mlir::Operation *op) {
+  auto call = mlir::dyn_cast<func::CallOp>(op);
+  if (call == nullptr || call.getCallee().take_front(7) != "memref_")
+    return false;
+  auto callee = mlir::SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+      call, call.getCalleeAttr());
+  return callee != nullptr && callee.isExternal();
+}
+
+/// Returns the first operation following `call` in its block that may
+/// access its output or write one of its inputs, i.e. before which an async
+/// version of `call` must be awaited. Sets `overlaps` if an other
+/// offloadable call comes first, so that offloading `call` lets them run
+/// concurrently.
+mlir::Operation *getAwaitPoint(func::CallOp call, bool &overlaps) {
+  mlir::Value output = getRootBuffer(call.getOperand(0));
+  llvm::SmallDenseSet<mlir::Value> inputs;
+  for (mlir::Value operand : call.getOperands().drop_front()) {
+    if (operand.getType().isa<mlir::MemRefType>())
+      inputs.insert(getRootBuffer(operand));
+  }
+
+  auto conflicts = [&](mlir::Operation *op) {
+    // Views are checked through their users
+    if (mlir::isMemoryEffectFree(op))
+      return false;
+    bool readOnly = isRuntimeCall(op);
+    for (mlir::OpOperand &operand : op->getOpOperands()) {
+      mlir::Value root = getRootBuffer(operand.get());
+      if (root == output)
+        return true;
+      if (inputs.contains(root) &&
+          (!readOnly || operand.getOperandNumber() == 0))
+        return true;
+    }
+    return false;
+  };
+
+  overlaps = false;
+  for (mlir::Operation *op = call->getNextNode(); op != nullptr;
+       op = op->getNextNode()) {
+    if (op->hasTrait<mlir::OpTrait::IsTerminator>())
+      return op;
+    bool conflict = false;
+    op->walk([&](mlir::Operation *nested) {
+      conflict = conflicts(nested);
+      return conflict ? mlir::WalkResult::interrupt()
+                      : mlir::WalkResult::advance();
+    });
+    if (conflict)
+      return op;
+    if (auto other = mlir::dyn_cast<func::CallOp>(op))
+      overlaps |= getAsyncCallee(other) != nullptr || isAsyncCall(other);
+  }
+  return nullptr;
+}
+
+/// Replaces the keyswitch and bootstrap calls that are followed by another
+/// one independent of their result by their async counterpart, awaited
+/// right before the first operation accessing their buffers. Independent
+/// table lookups of straight-line code then run concurrently on the async
+/// executor.
+mlir::LogicalResult offloadToAsyncCalls(mlir::ModuleOp module) {
+  llvm::SmallVector<func::CallOp> calls;
+  module.walk([&](func::CallOp call) {
+    if (getAsyncCallee(call) != nullptr)
+      calls.push_back(call);
+  });
+
+  mlir::IRRewriter rewriter(module.getContext());
+  auto futureType =
+      mlir::concretelang::RT::FutureType::get(rewriter.getIndexType());
+  for (func::CallOp call : calls) {
+    bool overlaps;
+    mlir::Operation *awaitPoint = getAwaitPoint(call, overlaps);
+    if (awaitPoint == nullptr || !overlaps)
+      continue;
+
+    const char *asyncCallee = getAsyncCallee(call);
+    if (insertForwardDeclarationOfTheCAPI(call, rewriter, asyncCallee)
+            .failed() ||
+        insertForwardDeclarationOfTheCAPI(call, rewriter, memref_await_future)
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.setInsertionPoint(call);
+    auto asyncCall = rewriter.create<func::CallOp>(
+        call.getLoc(), asyncCallee, mlir::TypeRange{futureType},
+        call.getOperands());
+    // The result is written in place by the async call
+    mlir::Value out = call.getOperand(0);
+    rewriter.setInsertionPoint(awaitPoint);
+    rewriter.create<func::CallOp>(
+        call.getLoc(), memref_await_future, mlir::TypeRange{},
+        mlir::ValueRange{out, asyncCall.getResult(0), out});
+    rewriter.eraseOp(call);
+  }
+  return mlir::success();
+}
+
+/// The CUDA wrappers, which read their ciphertexts from their second operand
+const char *const gpuCallees[] = {
+    memref_keyswitch_lwe_cuda_u64,
+    memref_bootstrap_lwe_cuda_u64,
+    memref_batched_keyswitch_lwe_cuda_u64,
+    memref_batched_bootstrap_lwe_cuda_u64,
+    memref_batched_mapped_bootstrap_lwe_cuda_u64,
+    memref_keyswitch_bootstrap_lwe_cuda_u64,
+    memref_batched_keyswitch_bootstrap_lwe_cuda_u64,
+};
+
+bool isGPUCall(mlir::Operation *op) {
+  auto call = mlir::dyn_cast<func::CallOp>(op);
+  if (call == nullptr)
+    return false;
+  for (auto callee : gpuCallees) {
+    if (call.getCallee() == callee)
+      return true;
+  }
+  return false;
+}
+
+/// Creates a call to a device residency runtime function on the 1D view of
+/// `buffer`.
+void createDeviceResidencyCall(mlir::RewriterBase &rewriter,
+                               mlir::Location loc, const char *callee,
+                               mlir::Value buffer, mlir::Value context) {
+  auto type = buffer.getType().cast<mlir::MemRefType>();
+  if (type.getRank() > 1) {
+    mlir::ReassociationIndices dims;
+    for (int64_t i = 0; i < type.getRank(); i++)
+      dims.push_back(i);
+    buffer = rewriter.create<memref::CollapseShapeOp>(
+        loc, buffer, llvm::ArrayRef<mlir::ReassociationIndices>{dims});
+  }
+  rewriter.create<func::CallOp>(
+      loc, callee, mlir::TypeRange{},
+      mlir::ValueRange{mlir::concretelang::getCastedMemRef(rewriter, buffer),
+                       context});
+}
+
+/// Returns true if `value` is `root` or a view of all of `root` starting at
+/// its first element, so that the runtime wrappers see the same host address
+/// for both. Views at an offset, or of a part of the buffer, are not.
+bool isFullView(mlir::Value value, mlir::Value root) {
+  while (value != root) {
+    auto view = value.getDefiningOp<mlir::ViewLikeOpInterface>();
+    if (view == nullptr)
+      return false;
+    if (auto subview = mlir::dyn_cast<memref::SubViewOp>(*view)) {
+      auto sourceType = subview.getSourceType();
+      if (!sourceType.hasStaticShape() ||
+          llvm::any_of(subview.getStaticOffsets(),
+                       [](int64_t offset) { return offset != 0; }) ||
+          llvm::any_of(subview.getStaticStrides(),
+                       [](int64_t stride) { return stride != 1; }) ||
+          subview.getStaticSizes() != sourceType.getShape())
+        return false;
+    } else if (!mlir::isa<memref::CastOp, memref::CollapseShapeOp,
+                          memref::ExpandShapeOp>(*view)) {
+      return false;
+    }
+    value = view.getViewSource();
+  }
+  return true;
+}
+
+/// Keeps the results of the CUDA wrappers on the device when they are
+/// consumed by other CUDA wrappers, so that chains of GPU operations do not
+/// round-trip through the host. The result is copied back right before the
+/// first other access to its buffer, and the device copy is released when
+/// the buffer is deallocated.
+mlir::LogicalResult keepGPUResultsOnDevice(mlir::ModuleOp module) {
+  llvm::SmallVector<func::CallOp> calls;
+  module.walk([&](func::CallOp call) {
+    if (isGPUCall(call))
+      calls.push_back(call);
+  });
+
+  mlir::IRRewriter rewriter(module.getContext());
+  for (func::CallOp call : calls) {
+    auto alloc =
+        getRootBuffer(call.getOperand(0)).getDefiningOp<memref::AllocOp>();
+    if (alloc == nullptr || alloc->getBlock() != call->getBlock() ||
+        !isFullView(call.getOperand(0), alloc.getResult()))
+      continue;
+    mlir::Block *block = call->getBlock();
+
+    // Collect the accesses to the buffer, through its views
+    llvm::SmallVector<mlir::OpOperand *> uses;
+    llvm::SmallVector<mlir::Value> worklist{alloc.getResult()};
+    while (!worklist.empty()) {
+      mlir::Value value = worklist.pop_back_val();
+      for (mlir::OpOperand &use : value.getUses()) {
+        auto view = mlir::dyn_cast<mlir::ViewLikeOpInterface>(use.getOwner());
+        if (view != nullptr && view.getViewSource() == value)
+          worklist.push_back(view->getResult(0));
+        else
+          uses.push_back(&use);
+      }
+    }
+
+    // The first access that is neither a dealloc nor a CUDA wrapper reading
+    // the buffer requires it on the host
+    mlir::Operation *hostAccess = nullptr;
+    llvm::SmallVector<mlir::Operation *> deviceReads;
+    llvm::SmallVector<memref::DeallocOp> deallocs;
+    bool valid = true;
+    for (mlir::OpOperand *use : uses) {
+      mlir::Operation *user = use->getOwner();
+      if (user == call.getOperation())
+        continue;
+      mlir::Operation *ancestor = block->findAncestorOpInBlock(*user);
+      if (ancestor == nullptr || ancestor->isBeforeInBlock(call)) {
+        valid = false;
+        break;
+      }
+      if (auto dealloc = mlir::dyn_cast<memref::DeallocOp>(user)) {
+        if (ancestor == user) {
+          deallocs.push_back(dealloc);
+          continue;
+        }
+      }
+      // The device copy is looked up by the address of the buffer, so only
+      // reads through the buffer itself or a full view of it find it
+      if (ancestor == user && isGPUCall(user) &&
+          use->getOperandNumber() == 1 &&
+          isFullView(use->get(), alloc.getResult())) {
+        deviceReads.push_back(user);
+        continue;
+      }
+      if (hostAccess == nullptr || ancestor->isBeforeInBlock(hostAccess))
+        hostAccess = ancestor;
+    }
+    if (!valid)
+      continue;
+    bool deviceReadFirst = llvm::any_of(deviceReads, [&](mlir::Operation *op) {
+      return hostAccess == nullptr || op->isBeforeInBlock(hostAccess);
+    });
+    if (!deviceReadFirst)
+      continue;
+
+    if (insertForwardDeclarationOfTheCAPI(call, rewriter,
+                                          memref_keep_on_device_cuda_u64)
+            .failed() ||
+        insertForwardDeclarationOfTheCAPI(call, rewriter,
+                                          memref_copy_to_host_cuda_u64)
+            .failed() ||
+        insertForwardDeclarationOfTheCAPI(call, rewriter,
+                                          memref_release_on_device_cuda_u64)
+            .failed()) {
+      return mlir::failure();
+    }
+
+    mlir::Value context = getContextArgument(call);
+    rewriter.setInsertionPoint(call);
+    createDeviceResidencyCall(rewriter, call.getLoc(),
+                              memref_keep_on_device_cuda_u64, alloc, context);
+    if (hostAccess != nullptr) {
+      rewriter.setInsertionPoint(hostAccess);
+      createDeviceResidencyCall(rewriter, call.getLoc(),
+                                memref_copy_to_host_cuda_u64, alloc, context);
+    }
+    for (auto dealloc : deallocs) {
+      rewriter.setInsertionPoint(dealloc);
+      createDeviceResidencyCall(rewriter, call.getLoc(),
+                                memref_release_on_device_cuda_u64, alloc,
+                                context);
+    }
+  }
+  return mlir::success();
+}
+
+/// The runtime calls with a compact counterpart, which takes the memrefs
+/// by descriptor pointer and the `numParams` integer parameters preceding
+/// the context as a single constant memref.
+struct CompactCallee {
+  const char *callee;
+  const char *compactCallee;
+  unsigned numParams;
+};
+
+const CompactCallee compactCallees[] = {
+    {memref_keyswitch_lwe_u64, memref_keyswitch_lwe_compact_u64, 5},
+    {memref_bootstrap_lwe_u64, memref_bootstrap_lwe_compact_u64, 6},
+    {memref_bootstrap_lwe_with_accumulator_u64,
+     memref_bootstrap_lwe_with_accumulator_compact_u64, 6},
+    {memref_keyswitch_bootstrap_lwe_u64,
+     memref_keyswitch_bootstrap_lwe_compact_u64, 10},
+    {memref_keyswitch_bootstrap_lwe_with_accumulator_u64,
+     memref_keyswitch_bootstrap_lwe_with_accumulator_compact_u64, 10},
+};
+
+/// Rewrites the synchronous keyswitch and bootstrap calls to their compact
+/// counterpart. The parameters of each distinct operation are emitted once
+/// as a constant global and the memrefs are passed through the C interface
+/// of MLIR, so that a call site passes a handful of pointers instead of
+/// unpacking every descriptor into 20 to 30 scalar arguments.
+mlir::LogicalResult compactRuntimeCalls(mlir::ModuleOp module) {
+  llvm::SmallVector<std::pair<func::CallOp, const CompactCallee *>> calls;
+  module.walk([&](func::CallOp call) {
+    for (auto &compact : compactCallees) {
+      if (call.getCallee() == compact.callee)
+        calls.push_back({call, &compact});
+    }
+  });
+
+  mlir::IRRewriter rewriter(module.getContext());
+  for (auto [call, compact] : calls) {
+    // The parameters are the integer operands preceding the context, which
+    // must all be constants to be emitted as a global
+    unsigned numOperands = call.getNumOperands();
+    unsigned firstParam = numOperands - 1 - compact->numParams;
+    llvm::SmallVector<int32_t> params;
+    for (unsigned i = firstParam; i < numOperands - 1; i++) {
+      std::optional<int64_t> param =
+          mlir::getConstantIntValue(call.getOperand(i));
+      if (!param.has_value())
+        break;
+      params.push_back(*param);
+    }
+    if (params.size() != compact->numParams)
+      continue;
+
+    rewriter.setInsertionPoint(call);
+    auto cst = rewriter.create<arith::ConstantOp>(
+        call.getLoc(), rewriter.getI32TensorAttr(params));
+    auto globalMemref = mlir::bufferization::getGlobalFor(cst, 0);
+    rewriter.eraseOp(cst);
+    if (failed(globalMemref))
+      return mlir::failure();
+    mlir::Value paramsBuffer = rewriter.create<memref::GetGlobalOp>(
+        call.getLoc(), (*globalMemref).getType(), (*globalMemref).getName());
+
+    llvm::SmallVector<mlir::Value> operands(
+        call.getOperands().take_front(firstParam));
+    operands.push_back(paramsBuffer);
+    operands.push_back(call.getOperands().back());
+
+    auto funcType = mlir::FunctionType::get(
+        rewriter.getContext(), mlir::ValueRange(operands).getTypes(), {});
+    if (insertForwardDeclaration(call, rewriter, compact->compactCallee,
+                                 funcType)
+            .failed()) {
+      return mlir::failure();
+    }
+    auto callee = mlir::SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+        call, rewriter.getStringAttr(compact->compactCallee));
+    callee->setAttr(mlir::LLVM::LLVMDialect::getEmitCWrapperAttrName(),
+                    rewriter.getUnitAttr());
+
+    llvm::SmallVector<mlir::Operation *> paramOps;
+    for (unsigned i = firstParam; i < numOperands - 1; i++)
+      paramOps.push_back(call.getOperand(i).getDefiningOp());
+    rewriter.replaceOpWithNewOp<func::CallOp>(call, compact->compactCallee,
+                                              mlir::TypeRange{}, operands);
+    for (mlir::Operation *paramOp : paramOps) {
+      if (paramOp != nullptr && paramOp->use_empty())
+        rewriter.eraseOp(paramOp);
+    }
+  }
+  return mlir::success();
+}
+
+/// Signals each output buffer of the public functions compiled in
+/// destination-passing mode to the runtime, right after the last operation
+/// accessing it, so that the caller can forward the outputs computed early
+/// while the circuit computes the others. The destination buffers are the
+/// arguments following the runtime context.
+mlir::LogicalResult signalReadyOutputs(mlir::ModuleOp module) {
+  mlir::IRRewriter rewriter(module.getContext());
+  for (auto funcOp : module.getOps<func::FuncOp>()) {
+    if (funcOp.isExternal() || funcOp.isPrivate() ||
+        !funcOp.getBody().hasOneBlock())
+      continue;
+    mlir::Block &entry = funcOp.getBody().front();
+    auto context = llvm::find_if(entry.getArguments(), [](auto arg) {
+      return arg.getType().template isa<Concrete::ContextType>();
+    });
+    if (context == entry.getArguments().end())
+      continue;
+
+    for (mlir::BlockArgument destination :
+         llvm::make_range(std::next(context), entry.args_end())) {
+      if (!destination.getType().isa<mlir::MemRefType>())
+        continue;
+      // The awaits of the async calls writing the buffer take it as operand,
+      // so the last access is the last operation using one of its views
+      mlir::Operation *lastAccess = nullptr;
+      for (mlir::Operation &op : entry.without_terminator()) {
+        mlir::WalkResult result = op.walk([&](mlir::Operation *nested) {
+          for (mlir::Value operand : nested->getOperands()) {
+            if (getRootBuffer(operand) == destination)
+              return mlir::WalkResult::interrupt();
+          }
+          return mlir::WalkResult::advance();
+        });
+        if (result.wasInterrupted())
+          lastAccess = &op;
+      }
+      if (lastAccess == nullptr)
+        continue;
+
+      auto funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                              {rewriter.getI64Type()}, {});
+      if (insertForwardDeclaration(funcOp, rewriter, concrete_output_ready,
+                                   funcType)
+              .failed()) {
+        return mlir::failure();
+      }
+      rewriter.setInsertionPointAfter(lastAccess);
+      mlir::Location loc = lastAccess->getLoc();
+      mlir::Value pointer =
+          rewriter.create<memref::ExtractAlignedPointerAsIndexOp>(loc,
+                                                                  destination);
+      pointer = rewriter.create<arith::IndexCastOp>(
+          loc, rewriter.getI64Type(), pointer);
+      rewriter.create<func::CallOp>(loc, concrete_output_ready,
+                                    mlir::TypeRange{}, pointer);
+    }
+  }
+  return mlir::success();
+}
+
 struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
 
-  ConcreteToCAPIPass(bool gpu) : gpu(gpu) {}
+  ConcreteToCAPIPass(bool gpu, bool asyncOffload)
+      : gpu(gpu), asyncOffload(asyncOffload) {}
 
   void runOnOperation() override {
     auto op = this->getOperation();
@@ -534,6 +1585,10 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
         ConcreteToCAPICallPattern<Concrete::EncodeExpandLutForBootstrapBufferOp,
                                   memref_encode_expand_lut_for_bootstrap>>(
         &getContext(), encodeExpandLutForBootstrapAddOperands);
+    patterns.add<ConcreteToCAPICallPattern<
+        Concrete::EncodeExpandManyLutForBootstrapBufferOp,
+        memref_encode_expand_many_lut_for_bootstrap>>(
+        &getContext(), encodeExpandManyLutForBootstrapAddOperands);
     patterns
         .add<ConcreteToCAPICallPattern<Concrete::EncodeLutForCrtWopPBSBufferOp,
                                        memref_encode_lut_for_crt_woppbs>>(
@@ -558,6 +1613,19 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
         ConcreteToCAPICallPattern<Concrete::BatchedNegateLweBufferOp,
                                   memref_batched_negate_lwe_ciphertext_u64>>(
         &getContext());
+    patterns.add<MulCleartextAddToCAPICallPattern<
+        Concrete::BatchedMulCleartextLweBufferOp,
+        memref_batched_mul_cleartext_add_lwe_ciphertexts_u64>>(&getContext());
+    patterns.add<MulCleartextAddToCAPICallPattern<
+        Concrete::BatchedMulCleartextCstLweBufferOp,
+        memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64>>(
+        &getContext());
+    patterns.add<ConcreteToCAPICallPattern<Concrete::GatherLweBufferOp,
+                                           memref_gather_lwe_ciphertexts_u64>>(
+        &getContext());
+    patterns.add<ConcreteToCAPICallPattern<Concrete::ScatterLweBufferOp,
+                                           memref_scatter_lwe_ciphertexts_u64>>(
+        &getContext());
     if (gpu) {
       patterns.add<ConcreteToCAPICallPattern<Concrete::KeySwitchLweBufferOp,
                                              memref_keyswitch_lwe_cuda_u64>>(
@@ -580,6 +1648,17 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
           memref_batched_mapped_bootstrap_lwe_cuda_u64>>(
           &getContext(),
           bootstrapAddOperands<Concrete::BatchedMappedBootstrapLweBufferOp>);
+      // The device accumulators are cached per lookup table, so there is no
+      // constant accumulator variant
+      patterns.add<KeySwitchBootstrapToCAPICallPattern<
+          Concrete::KeySwitchLweBufferOp, Concrete::BootstrapLweBufferOp,
+          memref_keyswitch_bootstrap_lwe_cuda_u64,
+          memref_keyswitch_bootstrap_lwe_cuda_u64>>(&getContext());
+      patterns.add<KeySwitchBootstrapToCAPICallPattern<
+          Concrete::BatchedKeySwitchLweBufferOp,
+          Concrete::BatchedBootstrapLweBufferOp,
+          memref_batched_keyswitch_bootstrap_lwe_cuda_u64,
+          memref_batched_keyswitch_bootstrap_lwe_cuda_u64>>(&getContext());
     } else {
       patterns.add<ConcreteToCAPICallPattern<Concrete::KeySwitchLweBufferOp,
                                              memref_keyswitch_lwe_u64>>(
@@ -587,6 +1666,9 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
       patterns.add<ConcreteToCAPICallPattern<Concrete::BootstrapLweBufferOp,
                                              memref_bootstrap_lwe_u64>>(
           &getContext(), bootstrapAddOperands<Concrete::BootstrapLweBufferOp>);
+      patterns.add<BootstrapWithConstantLutToCAPICallPattern<
+          Concrete::BootstrapLweBufferOp,
+          memref_bootstrap_lwe_with_accumulator_u64>>(&getContext());
       patterns
           .add<ConcreteToCAPICallPattern<Concrete::BatchedKeySwitchLweBufferOp,
                                          memref_batched_keyswitch_lwe_u64>>(
@@ -597,26 +1679,78 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
                                          memref_batched_bootstrap_lwe_u64>>(
               &getContext(),
               bootstrapAddOperands<Concrete::BatchedBootstrapLweBufferOp>);
+      patterns.add<BootstrapWithConstantLutToCAPICallPattern<
+          Concrete::BatchedBootstrapLweBufferOp,
+          memref_batched_bootstrap_lwe_with_accumulator_u64>>(&getContext());
       patterns.add<
           ConcreteToCAPICallPattern<Concrete::BatchedMappedBootstrapLweBufferOp,
                                     memref_batched_mapped_bootstrap_lwe_u64>>(
           &getContext(),
           bootstrapAddOperands<Concrete::BatchedMappedBootstrapLweBufferOp>);
+      patterns.add<KeySwitchBootstrapToCAPICallPattern<
+          Concrete::KeySwitchLweBufferOp, Concrete::BootstrapLweBufferOp,
+          memref_keyswitch_bootstrap_lwe_u64,
+          memref_keyswitch_bootstrap_lwe_with_accumulator_u64>>(&getContext());
+      patterns.add<KeySwitchBootstrapToCAPICallPattern<
+          Concrete::BatchedKeySwitchLweBufferOp,
+          Concrete::BatchedBootstrapLweBufferOp,
+          memref_batched_keyswitch_bootstrap_lwe_u64,
+          memref_batched_keyswitch_bootstrap_lwe_with_accumulator_u64>>(
+          &getContext());
+      patterns.add<
+          ConcreteToCAPICallPattern<Concrete::ManyLutBootstrapLweBufferOp,
+                                    memref_many_lut_bootstrap_lwe_u64>>(
+          &getContext(), manyLutBootstrapAddOperands);
     }
 
-    patterns.add<ConcreteToCAPICallPattern<Concrete::WopPBSCRTLweBufferOp,
-                                           memref_wop_pbs_crt_buffer>>(
-        &getContext(), wopPBSAddOperands);
+    if (gpu) {
+      patterns.add<ConcreteToCAPICallPattern<Concrete::WopPBSCRTLweBufferOp,
+                                             memref_wop_pbs_crt_buffer_cuda>>(
+          &getContext(), wopPBSAddOperands<Concrete::WopPBSCRTLweBufferOp>);
+    } else {
+      patterns.add<ConcreteToCAPICallPattern<Concrete::WopPBSCRTLweBufferOp,
+                                             memref_wop_pbs_crt_buffer>>(
+          &getContext(), wopPBSAddOperands<Concrete::WopPBSCRTLweBufferOp>);
+    }
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::BatchedWopPBSCRTLweBufferOp,
+                                  memref_batched_wop_pbs_crt_buffer>>(
+        &getContext(),
+        wopPBSAddOperands<Concrete::BatchedWopPBSCRTLweBufferOp>);
+
+    // The device residency of the GPU results is tracked per allocation
+    if (!gpu)
+      forwardResultsToCopyTargets(op);
 
     // Apply conversion
     if (mlir::applyPartialConversion(op, target, std::move(patterns))
             .failed()) {
       this->signalPassFailure();
+      return;
+    }
+
+    if (asyncOffload && !gpu && offloadToAsyncCalls(op).failed()) {
+      this->signalPassFailure();
+    }
+
+    // The calls left synchronous by the offload take the compact convention
+    if (!gpu && compactRuntimeCalls(op).failed()) {
+      this->signalPassFailure();
+    }
+
+    if (gpu && keepGPUResultsOnDevice(op).failed()) {
+      this->signalPassFailure();
+    }
+
+    // Last, so that the awaits and copies back from the device are accounted
+    if (signalReadyOutputs(op).failed()) {
+      this->signalPassFailure();
     }
   }
 
 private:
   bool gpu;
+  bool asyncOffload;
 };
 
 } // namespace
@@ -624,8 +1758,8 @@ private:
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertConcreteToCAPIPass(bool gpu) {
-  return std::make_unique<ConcreteToCAPIPass>(gpu);
+createConvertConcreteToCAPIPass(bool gpu, bool asyncOffload) {
+  return std::make_unique<ConcreteToCAPIPass>(gpu, asyncOffload);
 }
 } // namespace concretelang
 } // namespace mlir
@@ -42,9 +42,37 @@ SDFG::MakeStream makeStream(mlir::ImplicitLocOpBuilder &builder,
   return builder.create<SDFG::MakeStream>(streamType, dfg, name, kind);
 }
 
-/// Unrolls entirely all scf loops, which directly contain an
-/// SDFG-convertible operation and whose bounds are static.
-void unrollLoopsWithSDFGConvertibleOps(mlir::func::FuncOp func) {
+/// Returns the static trip count of `forOp`, or 0 if its bounds are not
+/// static or not positive.
+int64_t getStaticTripCount(mlir::scf::ForOp forOp) {
+  mlir::arith::ConstantIndexOp lb =
+      forOp.getLowerBound().getDefiningOp<mlir::arith::ConstantIndexOp>();
+  mlir::arith::ConstantIndexOp ub =
+      forOp.getUpperBound().getDefiningOp<mlir::arith::ConstantIndexOp>();
+  mlir::arith::ConstantIndexOp step =
+      forOp.getStep().getDefiningOp<mlir::arith::ConstantIndexOp>();
+
+  if (!lb || !ub || !step)
+    return 0;
+
+  int64_t ilb = lb.value();
+  int64_t iub = ub.value();
+  int64_t istep = step.value();
+
+  // Unrolling requires positive bounds and step
+  if (ilb < 0 || iub < 0 || istep <= 0)
+    return 0;
+
+  return ((iub - ilb) + (istep - 1)) / istep;
+}
+
+/// Unrolls the scf loops with static bounds containing an
+/// SDFG-convertible operation. With an `unrollFactor` of 0, all these
+/// loops are unrolled entirely. Otherwise, only the innermost loop around
+/// each SDFG-convertible operation is unrolled, by at most `unrollFactor`,
+/// and the iterations left stream their items through the same processes.
+void unrollLoopsWithSDFGConvertibleOps(mlir::func::FuncOp func,
+                                       unsigned unrollFactor) {
   mlir::DenseSet<mlir::scf::ForOp> unrollCandidates;
 
   // Identify loops with SDFG-convertible ops
@@ -53,41 +81,45 @@ void unrollLoopsWithSDFGConvertibleOps(mlir::func::FuncOp func) {
          parent = parent->getParentOp()) {
       if (mlir::scf::ForOp forOp = llvm::dyn_cast<mlir::scf::ForOp>(parent)) {
         unrollCandidates.insert(forOp);
+        if (unrollFactor != 0)
+          break;
       }
     }
   });
 
-  // Fully unroll all the loops if its bounds are static
+  // Unroll the loops if their bounds are static
   for (mlir::scf::ForOp forOp : unrollCandidates) {
-    mlir::arith::ConstantIndexOp lb =
-        forOp.getLowerBound().getDefiningOp<mlir::arith::ConstantIndexOp>();
-    mlir::arith::ConstantIndexOp ub =
-        forOp.getUpperBound().getDefiningOp<mlir::arith::ConstantIndexOp>();
-    mlir::arith::ConstantIndexOp step =
-        forOp.getStep().getDefiningOp<mlir::arith::ConstantIndexOp>();
-
-    if (!lb || !ub || !step)
-      continue;
-
-    int64_t ilb = lb.value();
-    int64_t iub = ub.value();
-    int64_t istep = step.value();
+    int64_t tripCount = getStaticTripCount(forOp);
 
-    // Unrolling requires positive bounds and step
-    if (ilb < 0 || iub < 0 || istep <= 0)
+    if (tripCount == 0)
       continue;
 
-    int64_t unrollFactor = ((iub - ilb) + (istep - 1)) / istep;
+    int64_t factor = (unrollFactor == 0)
+                         ? tripCount
+                         : std::min<int64_t>(tripCount, unrollFactor);
 
-    if (unrollFactor == 0)
+    if (mlir::loopUnrollByFactor(forOp, (uint64_t)factor).failed())
       continue;
+  }
+}
 
-    if (mlir::loopUnrollByFactor(forOp, (uint64_t)unrollFactor).failed())
-      continue;
+/// Returns true if the loops around `user` all contain the definition of
+/// `v`, such that `user` reads exactly one value of `v` per value of `v`
+/// written and the two can be connected by a stream.
+bool isDefinedInLoopsOf(mlir::Value v, mlir::Operation *user) {
+  mlir::Region *defRegion = v.getParentRegion();
+  for (mlir::Operation *parent = user->getParentOp(); parent;
+       parent = parent->getParentOp()) {
+    if (mlir::scf::ForOp forOp = llvm::dyn_cast<mlir::scf::ForOp>(parent))
+      if (!forOp.getRegion().isAncestor(defRegion))
+        return false;
   }
+  return true;
 }
 
-StreamMappingKind determineStreamMappingKind(mlir::Value v) {
+StreamMappingKind determineStreamMappingKind(
+    mlir::Value v, llvm::function_ref<bool(mlir::Operation *)> isExtracted,
+    llvm::function_ref<bool(mlir::OpOperand &)> isStreamedUse) {
   // Determine stream type for operands:
   //
   //  - If an operand is produced by a non-convertible op, there
@@ -101,20 +133,16 @@ StreamMappingKind determineStreamMappingKind(mlir::Value v) {
   //    at least one other non-convertible consumer, there needs
   //    to be a device-to-host stream, and a host-to-device stream
   //
-  if (llvm::dyn_cast_or_null<SDFG::SDFGConvertibleOpInterface>(
-          v.getDefiningOp())) {
+  // A convertible consumer in a loop not containing the producer reads
+  // the operand once per iteration from a stream of its own, and counts
+  // as a non-convertible consumer here.
+  if (v.getDefiningOp() && isExtracted(v.getDefiningOp())) {
     // All convertible consumers?
-    if (llvm::all_of(v.getUses(), [](mlir::OpOperand &o) {
-          return !!llvm::dyn_cast_or_null<SDFG::SDFGConvertibleOpInterface>(
-              o.getOwner());
-        })) {
+    if (llvm::all_of(v.getUses(), isStreamedUse)) {
       return StreamMappingKind::ON_DEVICE;
     }
     // All non-convertible consumers?
-    else if (llvm::all_of(v.getUses(), [](mlir::OpOperand &o) {
-               return !llvm::dyn_cast_or_null<SDFG::SDFGConvertibleOpInterface>(
-                   o.getOwner());
-             })) {
+    else if (llvm::none_of(v.getUses(), isStreamedUse)) {
       return StreamMappingKind::TO_HOST;
     }
     // Mix of convertible and non-convertible users
@@ -122,10 +150,7 @@ StreamMappingKind determineStreamMappingKind(mlir::Value v) {
       return StreamMappingKind::SPLICE;
     }
   } else {
-    if (llvm::any_of(v.getUses(), [](mlir::OpOperand &o) {
-          return !!llvm::dyn_cast_or_null<SDFG::SDFGConvertibleOpInterface>(
-              o.getOwner());
-        })) {
+    if (llvm::any_of(v.getUses(), isStreamedUse)) {
       return StreamMappingKind::TO_DEVICE;
     } else {
       return StreamMappingKind::NONE;
@@ -136,23 +161,31 @@ StreamMappingKind determineStreamMappingKind(mlir::Value v) {
 void setInsertionPointAfterValueOrRestore(mlir::OpBuilder &builder,
                                           mlir::Value v,
                                           mlir::OpBuilder::InsertPoint &pos) {
-  if (v.isa<mlir::BlockArgument>())
-    builder.restoreInsertionPoint(pos);
-  else
+  if (mlir::BlockArgument arg = v.dyn_cast<mlir::BlockArgument>()) {
+    // The arguments of the function are available once the graph is
+    // started, those of a loop body at the start of each iteration
+    if (llvm::isa<mlir::func::FuncOp>(arg.getOwner()->getParentOp()))
+      builder.restoreInsertionPoint(pos);
+    else
+      builder.setInsertionPointToStart(arg.getOwner());
+  } else {
     builder.setInsertionPointAfterValue(v);
+  }
 }
 
 struct ExtractSDFGOpsPass : public ExtractSDFGOpsBase<ExtractSDFGOpsPass> {
   bool unroll;
+  unsigned unrollFactor;
 
-  ExtractSDFGOpsPass(bool unroll) : unroll(unroll) {}
+  ExtractSDFGOpsPass(bool unroll, unsigned unrollFactor)
+      : unroll(unroll), unrollFactor(unrollFactor) {}
 
   void runOnOperation() override {
     mlir::func::FuncOp func = getOperation();
     mlir::IRRewriter rewriter(func.getContext());
 
     if (unroll)
-      unrollLoopsWithSDFGConvertibleOps(func);
+      unrollLoopsWithSDFGConvertibleOps(func, unrollFactor);
 
     mlir::DenseMap<mlir::Value, SDFG::MakeStream> processOutMapping;
     mlir::DenseMap<mlir::Value, SDFG::MakeStream> processInMapping;
@@ -205,6 +238,17 @@ struct ExtractSDFGOpsPass : public ExtractSDFGOpsBase<ExtractSDFGOpsPass> {
     if (convertibleOps.size() == 0)
       return;
 
+    mlir::DenseSet<mlir::Operation *> extractedOps;
+    for (SDFG::SDFGConvertibleOpInterface op : convertibleOps)
+      extractedOps.insert(op);
+    auto isExtracted = [&](mlir::Operation *op) {
+      return extractedOps.contains(op);
+    };
+    auto isStreamedUse = [&](mlir::OpOperand &o) {
+      return isExtracted(o.getOwner()) &&
+             isDefinedInLoopsOf(o.get(), o.getOwner());
+    };
+
     // Insert Prelude
     rewriter.setInsertionPointToStart(&func.getBlocks().front());
     mlir::Value dfg = rewriter.create<SDFG::Init>(
@@ -221,7 +265,8 @@ struct ExtractSDFGOpsPass : public ExtractSDFGOpsBase<ExtractSDFGOpsPass> {
           processOutMapping.find(v) != processOutMapping.end())
         return;
 
-      StreamMappingKind smk = determineStreamMappingKind(v);
+      StreamMappingKind smk =
+          determineStreamMappingKind(v, isExtracted, isStreamedUse);
 
       SDFG::MakeStream prodOutStream;
       SDFG::MakeStream consInStream;
@@ -277,9 +322,22 @@ struct ExtractSDFGOpsPass : public ExtractSDFGOpsBase<ExtractSDFGOpsPass> {
         outs.push_back(processOutMapping.find(res)->second.getResult());
       }
 
-      for (mlir::Value operand : convertibleOp->getOperands()) {
-        mapValueToStreams(operand);
-        ins.push_back(processInMapping.find(operand)->second.getResult());
+      for (mlir::OpOperand &operand : convertibleOp->getOpOperands()) {
+        mapValueToStreams(operand.get());
+        if (isStreamedUse(operand)) {
+          ins.push_back(
+              processInMapping.find(operand.get())->second.getResult());
+          continue;
+        }
+        // The operand is defined outside of a loop around the operation,
+        // it is put again on a stream of the operation at each iteration
+        ilb.setInsertionPoint(start);
+        SDFG::MakeStream loopInStream =
+            makeStream(ilb, SDFG::StreamKind::host_to_device,
+                       operand.get().getType(), dfg, streamNumber);
+        ilb.setInsertionPoint(convertibleOp);
+        ilb.create<SDFG::Put>(loopInStream.getResult(), operand.get());
+        ins.push_back(loopInStream.getResult());
       }
 
       ilb.setInsertionPoint(start);
@@ -301,8 +359,8 @@ namespace mlir {
 namespace concretelang {
 
 std::unique_ptr<OperationPass<mlir::func::FuncOp>>
-createExtractSDFGOpsPass(bool unroll) {
-  return std::make_unique<ExtractSDFGOpsPass>(unroll);
+createExtractSDFGOpsPass(bool unroll, unsigned unrollFactor) {
+  return std::make_unique<ExtractSDFGOpsPass>(unroll, unrollFactor);
 }
 } // namespace concretelang
 } // namespace mlir
@@ -9,6 +9,7 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Tensor/Utils/Utils.h"
+#include "mlir/Dialect/Utils/ReshapeOpsUtils.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/OperationSupport.h"
@@ -26,6 +27,7 @@
 #include "concretelang/Support/Constants.h"
 #include "concretelang/Support/logging.h"
 
+#include <optional>
 #include <unordered_set>
 
 namespace arith = mlir::arith;
@@ -46,6 +48,110 @@ inline void forwardOptimizerID(mlir::Operation *source,
   destination->setAttr("TFHE.OId", optimizerIdAttr);
 }
 
+/// Reduces the dimension `dim` of the tensor of encrypted integers `input`
+/// to a single element with a tree of additions, and returns the reduced
+/// tensor, with a size of 1 along `dim`.
+///
+/// Each level of the tree adds the first half of the elements to the second
+/// half with a `linalg.generic` of parallel iterators, such that the
+/// additions of a level can run concurrently and the depth of the reduction
+/// is logarithmic in the size of `dim`, instead of the linear chain of a
+/// `reduction` iterator. When the size is odd, the middle element is left
+/// for the next level.
+///
+/// `onAddition` is called on each created `FHE.add_eint`.
+mlir::Value
+buildTreeReduction(mlir::PatternRewriter &rewriter, mlir::Location location,
+                   mlir::Value input, int64_t dim,
+                   std::function<void(FHE::AddEintOp)> onAddition) {
+  auto inputType = input.getType().cast<mlir::RankedTensorType>();
+  int64_t rank = inputType.getRank();
+
+  auto foldResults = [&](llvm::ArrayRef<int64_t> values) {
+    return llvm::to_vector(
+        llvm::map_range(values, [&](int64_t value) -> mlir::OpFoldResult {
+          return rewriter.getIndexAttr(value);
+        }));
+  };
+  llvm::SmallVector<int64_t> zeros(rank, 0);
+  llvm::SmallVector<int64_t> ones(rank, 1);
+
+  auto slice = [&](mlir::Value tensor, int64_t offset, int64_t size) {
+    auto type = tensor.getType().cast<mlir::RankedTensorType>();
+    llvm::SmallVector<int64_t> offsets(rank, 0);
+    llvm::SmallVector<int64_t> sizes(type.getShape());
+    offsets[dim] = offset;
+    sizes[dim] = size;
+    return rewriter
+        .create<tensor::ExtractSliceOp>(
+            location, type.clone(sizes), tensor, foldResults(offsets),
+            foldResults(sizes), foldResults(ones))
+        .getResult();
+  };
+
+  mlir::AffineMap identity =
+      mlir::AffineMap::getMultiDimIdentityMap(rank, rewriter.getContext());
+  auto maps = llvm::SmallVector<mlir::AffineMap, 3>{identity, identity,
+                                                    identity};
+  auto iteratorTypes = llvm::SmallVector<mlir::utils::IteratorType, 3>(
+      rank, mlir::utils::IteratorType::parallel);
+
+  mlir::Value current = input;
+  int64_t size = inputType.getDimSize(dim);
+  while (size > 1) {
+    int64_t half = size / 2;
+    int64_t remaining = size - half;
+
+    mlir::Value lhs = slice(current, 0, half);
+    mlir::Value rhs = slice(current, remaining, half);
+    auto halfType = lhs.getType().cast<mlir::RankedTensorType>();
+    mlir::Value init =
+        rewriter.create<FHE::ZeroTensorOp>(location, halfType).getResult();
+
+    auto regionBuilder = [&](mlir::OpBuilder &nestedBuilder,
+                             mlir::Location nestedLoc,
+                             mlir::ValueRange blockArgs) {
+      auto addition = nestedBuilder.create<FHE::AddEintOp>(
+          location, blockArgs[0], blockArgs[1]);
+      onAddition(addition);
+      nestedBuilder.create<linalg::YieldOp>(location, addition.getResult());
+    };
+
+    mlir::Value sum = rewriter
+                          .create<linalg::GenericOp>(
+                              location, mlir::TypeRange{halfType},
+                              mlir::ValueRange{lhs, rhs},
+                              mlir::ValueRange{init}, maps, iteratorTypes,
+                              regionBuilder)
+                          .getResult(0);
+
+    if (remaining != half) {
+      // Keep the middle element after the partial sums
+      sum = rewriter
+                .create<tensor::InsertSliceOp>(
+                    location, sum, slice(current, 0, remaining),
+                    foldResults(zeros), foldResults(halfType.getShape()),
+                    foldResults(ones))
+                .getResult();
+    }
+
+    current = sum;
+    size = remaining;
+  }
+
+  return current;
+}
+
+/// Gives the optimizer identifier of the first addition of `additions` to
+/// the other ones, which all replace the same accumulation.
+void forwardOptimizerID(llvm::ArrayRef<FHE::AddEintOp> additions) {
+  auto optimizerIdAttr = additions.front()->getAttr("TFHE.OId");
+  if (optimizerIdAttr == nullptr)
+    return;
+  for (FHE::AddEintOp addition : additions.drop_front())
+    addition->setAttr("TFHE.OId", optimizerIdAttr);
+}
+
 template <typename DotOp, typename FHEMulOp>
 struct DotToLinalgGeneric : public ::mlir::OpRewritePattern<DotOp> {
   DotToLinalgGeneric(
@@ -54,10 +160,12 @@ struct DotToLinalgGeneric : public ::mlir::OpRewritePattern<DotOp> {
                              mlir::Value, mlir::Value)>
           createMulOp,
       std::function<void(DotOp &, FHE::AddEintOp &, FHEMulOp &)>
-          forwardOptimizerID)
+          forwardOptimizerID,
+      bool treeReduction = false)
       : ::mlir::OpRewritePattern<DotOp>(
             context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
-        createMulOp(createMulOp), forwardOptimizerID(forwardOptimizerID) {}
+        createMulOp(createMulOp), forwardOptimizerID(forwardOptimizerID),
+        treeReduction(treeReduction) {}
 
   /// This rewrite pattern transforms any instance of
   /// `FHELinalg.dot_eint_int` to an instance of `linalg.generic` with an
@@ -94,10 +202,17 @@ struct DotToLinalgGeneric : public ::mlir::OpRewritePattern<DotOp> {
   ///   %c0 = constant 0 : index
   ///   %o = tensor.extract %1[%c0] : tensor<1x!FHE.eint<0>>
   ///
+  /// With `treeReduction`, the products are computed by a parallel
+  /// `linalg.generic` instead, and summed with a tree of additions (see
+  /// `buildTreeReduction`).
   ::mlir::LogicalResult
   matchAndRewrite(DotOp dotOp,
                   ::mlir::PatternRewriter &rewriter) const override {
 
+    auto lhsType = dotOp.getLhs().getType().template cast<mlir::TensorType>();
+    if (treeReduction && lhsType.getDimSize(0) >= 2)
+      return rewriteAsTreeReduction(dotOp, rewriter);
+
     auto zeroTensorOp = rewriter.create<mlir::concretelang::FHE::ZeroTensorOp>(
         dotOp.getLoc(), mlir::RankedTensorType::get({1}, dotOp.getType()));
 
@@ -149,10 +264,59 @@ struct DotToLinalgGeneric : public ::mlir::OpRewritePattern<DotOp> {
   };
 
 private:
+  ::mlir::LogicalResult
+  rewriteAsTreeReduction(DotOp dotOp, ::mlir::PatternRewriter &rewriter) const {
+    mlir::Location location = dotOp.getLoc();
+    auto lhsType = dotOp.getLhs().getType().template cast<mlir::TensorType>();
+    auto productsType =
+        mlir::RankedTensorType::get(lhsType.getShape(), dotOp.getType());
+
+    mlir::Value zeros =
+        rewriter.create<FHE::ZeroTensorOp>(location, productsType).getResult();
+    mlir::AffineMap identity =
+        mlir::AffineMap::getMultiDimIdentityMap(1, this->getContext());
+    llvm::SmallVector<mlir::AffineMap, 3> maps{identity, identity, identity};
+    llvm::SmallVector<mlir::utils::IteratorType, 1> itTypes{
+        mlir::utils::IteratorType::parallel};
+
+    std::optional<FHEMulOp> multiplication;
+    auto regBuilder = [&](mlir::OpBuilder &nestedBuilder,
+                          mlir::Location nestedLoc,
+                          mlir::ValueRange blockArgs) {
+      multiplication = this->createMulOp(nestedBuilder, location,
+                                         dotOp.getType(), blockArgs[0],
+                                         blockArgs[1]);
+      nestedBuilder.create<mlir::linalg::YieldOp>(location,
+                                                  multiplication->getResult());
+    };
+
+    mlir::Value products =
+        rewriter
+            .create<mlir::linalg::GenericOp>(
+                location, mlir::TypeRange{productsType},
+                mlir::ValueRange{dotOp.getLhs(), dotOp.getRhs()},
+                mlir::ValueRange{zeros}, maps, itTypes, regBuilder)
+            .getResult(0);
+
+    llvm::SmallVector<FHE::AddEintOp> additions;
+    mlir::Value sum = buildTreeReduction(
+        rewriter, location, products, 0,
+        [&](FHE::AddEintOp add) { additions.push_back(add); });
+    forwardOptimizerID(dotOp, additions.front(), *multiplication);
+    ::forwardOptimizerID(additions);
+
+    mlir::Value idx0 =
+        rewriter.create<mlir::arith::ConstantIndexOp>(location, 0);
+    rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(
+        dotOp, sum, mlir::ValueRange{idx0});
+    return ::mlir::success();
+  }
+
   std::function<FHEMulOp(mlir::OpBuilder &, mlir::Location, mlir::Type,
                          mlir::Value, mlir::Value)>
       createMulOp;
   std::function<void(DotOp &, FHE::AddEintOp &, FHEMulOp &)> forwardOptimizerID;
+  bool treeReduction;
 };
 
 mlir::AffineMap
@@ -752,6 +916,11 @@ struct FHELinalgApplyLookupTableToLinalgGeneric
 ///        linalg.yield %e : !FHE.eint<p>
 ///   }
 ///
+/// With `treeReduction`, the products are computed by a `linalg.generic`
+/// with parallel iterators only, in a tensor with an additional last
+/// dimension for the reduced one, which is summed with a tree of additions
+/// (see `buildTreeReduction`) and collapsed.
+///
 template <typename FHELinalgMatmulOp, typename FHEMulOp>
 struct FHELinalgMatmulToLinalgGeneric
     : public mlir::OpRewritePattern<FHELinalgMatmulOp> {
@@ -762,10 +931,12 @@ struct FHELinalgMatmulToLinalgGeneric
           createMulOp,
       std::function<void(FHELinalgMatmulOp &, FHE::AddEintOp &, FHEMulOp &)>
           forwardOptimizerID,
+      bool treeReduction = false,
       mlir::PatternBenefit benefit =
           mlir::concretelang::DEFAULT_PATTERN_BENEFIT)
       : mlir::OpRewritePattern<FHELinalgMatmulOp>(context, benefit),
-        createMulOp(createMulOp), forwardOptimizerID(forwardOptimizerID) {}
+        createMulOp(createMulOp), forwardOptimizerID(forwardOptimizerID),
+        treeReduction(treeReduction) {}
 
   mlir::LogicalResult
   matchAndRewrite(FHELinalgMatmulOp matmulOp,
@@ -983,6 +1154,28 @@ struct FHELinalgMatmulToLinalgGeneric
       }
     }
 
+    // The reduced dimension is the last one of lhs in all cases
+    int64_t reductionSize = lhsShape.back();
+    bool useTreeReduction = treeReduction && reductionSize >= 2 &&
+                            !matmulOp->hasAttr("tile-sizes");
+
+    if (useTreeReduction) {
+      // Compute all the products in a tensor with an additional last
+      // dimension for the reduced one, which is then summed by a tree
+      auto reductionIterator = llvm::find(iteratorTypes,
+                                          mlir::utils::IteratorType::reduction);
+      outAffineExpressions.push_back(rewriter.getAffineDimExpr(
+          std::distance(iteratorTypes.begin(), reductionIterator)));
+      *reductionIterator = mlir::utils::IteratorType::parallel;
+
+      llvm::SmallVector<int64_t> productsShape(outShape);
+      productsShape.push_back(reductionSize);
+      outs[0] = rewriter
+                    .create<FHE::ZeroTensorOp>(location,
+                                               outType.clone(productsShape))
+                    .getResult();
+    }
+
     auto maps = llvm::SmallVector<mlir::AffineMap, 3>{
         mlir::AffineMap::get(iteratorTypes.size(), 0, lhsAffineExpressions,
                              rewriter.getContext()),
@@ -993,6 +1186,42 @@ struct FHELinalgMatmulToLinalgGeneric
     };
 
     mlir::Type outElementType = outType.getElementType();
+    if (useTreeReduction) {
+      std::optional<FHEMulOp> multiplication;
+      auto productBuilder = [&](mlir::OpBuilder &nestedBuilder,
+                                mlir::Location nestedLoc,
+                                mlir::ValueRange blockArgs) {
+        multiplication = createMulOp(nestedBuilder, location, outElementType,
+                                     blockArgs[0], blockArgs[1]);
+        nestedBuilder.create<linalg::YieldOp>(location,
+                                              multiplication->getResult());
+      };
+
+      mlir::Value products =
+          rewriter
+              .create<linalg::GenericOp>(location,
+                                         mlir::TypeRange{outs[0].getType()},
+                                         ins, outs, maps, iteratorTypes,
+                                         productBuilder)
+              .getResult(0);
+
+      llvm::SmallVector<FHE::AddEintOp> additions;
+      mlir::Value sum = buildTreeReduction(
+          rewriter, location, products, outDims,
+          [&](FHE::AddEintOp add) { additions.push_back(add); });
+      forwardOptimizerID(matmulOp, additions.front(), *multiplication);
+      ::forwardOptimizerID(additions);
+
+      // Drop the reduced dimension, which now has a size of 1
+      llvm::SmallVector<mlir::ReassociationIndices> reassociation;
+      for (int64_t i = 0; i < outDims; i++)
+        reassociation.push_back({i});
+      reassociation.back().push_back(outDims);
+      rewriter.replaceOpWithNewOp<tensor::CollapseShapeOp>(
+          matmulOp, outType, sum, reassociation);
+      return mlir::success();
+    }
+
     auto regionBuilder = [&](mlir::OpBuilder &nestedBuilder,
                              mlir::Location nestedLoc,
                              mlir::ValueRange blockArgs) {
@@ -1023,6 +1252,7 @@ private:
       createMulOp;
   std::function<void(FHELinalgMatmulOp &, FHE::AddEintOp &, FHEMulOp &)>
       forwardOptimizerID;
+  bool treeReduction;
 };
 
 /// This rewrite pattern transforms any instance of operators
@@ -1056,11 +1286,15 @@ private:
 ///   %index = arith.constant 0 : index
 ///   %result = tensor.extract %index : tensor<1x!FHE.eint<7>>
 ///
+/// With `treeReduction`, each summed axis is reduced by a tree of additions
+/// instead (see `buildTreeReduction`).
+///
 struct SumToLinalgGeneric
     : public ::mlir::OpRewritePattern<mlir::concretelang::FHELinalg::SumOp> {
-  SumToLinalgGeneric(::mlir::MLIRContext *context)
+  SumToLinalgGeneric(::mlir::MLIRContext *context, bool treeReduction = false)
       : ::mlir::OpRewritePattern<::mlir::concretelang::FHELinalg::SumOp>(
-            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        treeReduction(treeReduction) {}
 
   ::mlir::LogicalResult
   matchAndRewrite(::mlir::concretelang::FHELinalg::SumOp sumOp,
@@ -1104,6 +1338,41 @@ struct SumToLinalgGeneric
       }
     }
 
+    if (treeReduction && !sumOp->hasAttr("tile-sizes")) {
+      mlir::Value sum = input;
+      llvm::SmallVector<int64_t> axes(axesToDestroy.begin(),
+                                      axesToDestroy.end());
+      llvm::sort(axes);
+      for (int64_t axis : axes) {
+        sum = buildTreeReduction(
+            rewriter, location, sum, axis,
+            [&](FHE::AddEintOp add) { forwardOptimizerID(sumOp, add); });
+      }
+
+      // The summed axes now have a size of 1
+      mlir::Value result = sum;
+      if (!outputIsTensor) {
+        llvm::SmallVector<mlir::Value> indices(
+            inputDimensions,
+            rewriter.create<arith::ConstantIndexOp>(location, 0).getResult());
+        result = rewriter.create<tensor::ExtractOp>(location, sum, indices)
+                     .getResult();
+      } else if (!sumOp.getKeepDims()) {
+        auto reassociation = mlir::getReassociationIndicesForReshape(
+            sum.getType().cast<mlir::ShapedType>(),
+            outputType.cast<mlir::ShapedType>());
+        if (!reassociation.has_value())
+          return mlir::failure();
+        result = rewriter
+                     .create<tensor::CollapseShapeOp>(location, outputType, sum,
+                                                      *reassociation)
+                     .getResult();
+      }
+
+      rewriter.replaceOp(sumOp, {result});
+      return mlir::success();
+    }
+
     mlir::Type accumulatorType = outputType;
     if (!outputIsTensor) {
       int64_t accumulatorShape[1] = {1};
@@ -1180,6 +1449,9 @@ struct SumToLinalgGeneric
     rewriter.replaceOp(sumOp, {result});
     return mlir::success();
   };
+
+private:
+  bool treeReduction;
 };
 
 /// This rewrite pattern transforms any instance of operators
@@ -1598,6 +1870,120 @@ mlir::LogicalResult createGroupedConv2D(
   return mlir::success();
 }
 
+/// Create operations for a convolution lowered to a matrix multiplication on
+/// the patches of the input (im2col).
+///
+/// The patches of the padded input, of shape N x C x H x W, are copied to a
+/// tensor of shape N x (C*KH*KW) x (OH*OW), such that each column holds the
+/// elements multiplied by the weights to compute an output element. The
+/// convolution is then a multiplication of the weights, reshaped to
+/// F x (C*KH*KW), by the patches, accumulated to the output tensor reshaped
+/// to N x F x (OH*OW). This results in a single contiguous reduction per
+/// output element instead of the nested loops of the convolution.
+mlir::LogicalResult createIm2colConv2D(
+    mlir::PatternRewriter &rewriter,
+    mlir::concretelang::FHELinalg::Conv2dOp &conv2dOp, mlir::Value paddedInput,
+    mlir::Value weight, mlir::Value outputTensor,
+    llvm::ArrayRef<int64_t> strides, llvm::ArrayRef<int64_t> dilations) {
+  mlir::Location loc = conv2dOp.getLoc();
+  mlir::MLIRContext *context = rewriter.getContext();
+
+  auto inputTy = paddedInput.getType().cast<mlir::RankedTensorType>();
+  auto weightTy = weight.getType().cast<mlir::RankedTensorType>();
+  auto outputTy = outputTensor.getType().cast<mlir::RankedTensorType>();
+  llvm::ArrayRef<int64_t> inputShape = inputTy.getShape();
+  llvm::ArrayRef<int64_t> weightShape = weightTy.getShape();
+  llvm::ArrayRef<int64_t> outputShape = outputTy.getShape();
+
+  int64_t batch = inputShape[0];
+  int64_t channels = inputShape[1];
+  int64_t filters = weightShape[0];
+  int64_t kernelH = weightShape[2];
+  int64_t kernelW = weightShape[3];
+  int64_t outputH = outputShape[2];
+  int64_t outputW = outputShape[3];
+
+  // patches[n][c][kh][kw][oh][ow] = input[n][c][oh*sh + kh*dh][ow*sw + kw*dw]
+  auto d = [&](unsigned i) { return rewriter.getAffineDimExpr(i); };
+  llvm::SmallVector<mlir::AffineMap, 2> patchesMaps = {
+      mlir::AffineMap::get(6, 0,
+                           {d(0), d(1), d(4) * strides[0] + d(2) * dilations[0],
+                            d(5) * strides[1] + d(3) * dilations[1]},
+                           context),
+      rewriter.getMultiDimIdentityMap(6)};
+  mlir::SmallVector<mlir::utils::IteratorType> patchesIteratorTypes(
+      6, mlir::utils::IteratorType::parallel);
+
+  auto patchesTy = mlir::RankedTensorType::get(
+      {batch, channels, kernelH, kernelW, outputH, outputW},
+      inputTy.getElementType());
+  mlir::Value patchesInit =
+      rewriter.create<mlir::tensor::EmptyOp>(loc, patchesTy, mlir::ValueRange{})
+          .getResult();
+  mlir::Value patches =
+      rewriter
+          .create<mlir::linalg::GenericOp>(
+              loc, patchesTy, paddedInput, patchesInit, patchesMaps,
+              patchesIteratorTypes,
+              [&](mlir::OpBuilder &b, mlir::Location loc,
+                  mlir::ValueRange args) {
+                b.create<mlir::linalg::YieldOp>(loc, args[0]);
+              })
+          .getResult(0);
+
+  int64_t patchSize = channels * kernelH * kernelW;
+  int64_t outputSize = outputH * outputW;
+
+  mlir::Value patchesMatrix = rewriter.create<mlir::tensor::CollapseShapeOp>(
+      loc, mlir::RankedTensorType::get({batch, patchSize, outputSize},
+                                       inputTy.getElementType()),
+      patches,
+      llvm::SmallVector<mlir::ReassociationIndices>{{0}, {1, 2, 3}, {4, 5}});
+  mlir::Value weightMatrix = rewriter.create<mlir::tensor::CollapseShapeOp>(
+      loc,
+      mlir::RankedTensorType::get({filters, patchSize},
+                                  weightTy.getElementType()),
+      weight, llvm::SmallVector<mlir::ReassociationIndices>{{0}, {1, 2, 3}});
+  auto resultMatrixTy = mlir::RankedTensorType::get(
+      {batch, filters, outputSize}, outputTy.getElementType());
+  llvm::SmallVector<mlir::ReassociationIndices> outputReassociation = {
+      {0}, {1}, {2, 3}};
+  mlir::Value outputMatrix = rewriter.create<mlir::tensor::CollapseShapeOp>(
+      loc, resultMatrixTy, outputTensor, outputReassociation);
+
+  // output[n][f][p] += patches[n][k][p] * weight[f][k]
+  llvm::SmallVector<mlir::AffineMap, 3> matmulMaps = {
+      mlir::AffineMap::get(4, 0, {d(0), d(3), d(2)}, context),
+      mlir::AffineMap::get(4, 0, {d(1), d(3)}, context),
+      mlir::AffineMap::get(4, 0, {d(0), d(1), d(2)}, context)};
+  mlir::SmallVector<mlir::utils::IteratorType> matmulIteratorTypes = {
+      mlir::utils::IteratorType::parallel, mlir::utils::IteratorType::parallel,
+      mlir::utils::IteratorType::parallel,
+      mlir::utils::IteratorType::reduction};
+
+  mlir::Value resultMatrix =
+      rewriter
+          .create<mlir::linalg::GenericOp>(
+              loc, resultMatrixTy,
+              mlir::ValueRange{patchesMatrix, weightMatrix}, outputMatrix,
+              matmulMaps, matmulIteratorTypes,
+              [&](mlir::OpBuilder &b, mlir::Location loc,
+                  mlir::ValueRange args) {
+                auto mul = b.create<mlir::concretelang::FHE::MulEintIntOp>(
+                    loc, outputTy.getElementType(), args[0], args[1]);
+                forwardOptimizerID(conv2dOp, mul);
+                auto add = b.create<mlir::concretelang::FHE::AddEintOp>(
+                    loc, args[2], mul);
+                forwardOptimizerID(conv2dOp, add);
+                b.create<mlir::linalg::YieldOp>(loc, add.getResult());
+              })
+          .getResult(0);
+
+  rewriter.replaceOpWithNewOp<mlir::tensor::ExpandShapeOp>(
+      conv2dOp, outputTy, resultMatrix, outputReassociation);
+  return mlir::success();
+}
+
 bool isZeroConstant(mlir::Value value) {
   auto cst =
       mlir::dyn_cast_or_null<mlir::arith::ConstantOp>(value.getDefiningOp());
@@ -1619,11 +2005,17 @@ bool isZeroConstant(mlir::Value value) {
 /// tensor, and initializing the output tensor with bias values if any. Multiple
 /// linalng conv operations can be generated, and their output concatenated in
 /// the case of grouped convolution
+///
+/// With `im2col`, a convolution without groups is lowered to a matrix
+/// multiplication on the patches of the input instead (see
+/// `createIm2colConv2D`).
 struct FHELinalgConv2dToLinalgConv2d
     : public ::mlir::OpRewritePattern<mlir::concretelang::FHELinalg::Conv2dOp> {
-  FHELinalgConv2dToLinalgConv2d(::mlir::MLIRContext *context)
+  FHELinalgConv2dToLinalgConv2d(::mlir::MLIRContext *context,
+                                bool im2col = false)
       : ::mlir::OpRewritePattern<::mlir::concretelang::FHELinalg::Conv2dOp>(
-            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+            context, mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        im2col(im2col) {}
 
   ::mlir::LogicalResult
   matchAndRewrite(::mlir::concretelang::FHELinalg::Conv2dOp conv2dOp,
@@ -1742,6 +2134,10 @@ struct FHELinalgConv2dToLinalgConv2d
     // but since there is no support for groups in linalg conv operations, we
     // need to slice the different tensors and apply multiple convolution in
     // case group is greater than 1
+    if (group == 1 && im2col) {
+      return createIm2colConv2D(rewriter, conv2dOp, paddedInput, weight,
+                                biasInitTensor, stridesInts, dilationsInts);
+    }
     if (group == 1) {
       rewriter.replaceOpWithNewOp<mlir::linalg::Conv2DNchwFchwOp>(
           conv2dOp, biasInitTensor.getType(),
@@ -1753,15 +2149,77 @@ struct FHELinalgConv2dToLinalgConv2d
                                biasInitTensor, stridesAttr, dilationsAttr,
                                namedAttr, group);
   };
+
+private:
+  bool im2col;
 };
 
+/// Returns the maximum of the tensors of encrypted integers `operands`,
+/// which have the same shape, computed element-wise by a tree of
+/// `FHE.max_eint`. Each maximum of a level of the tree is a `linalg.generic`
+/// of parallel iterators, independent of the other ones of the level.
+///
+/// `init` builds the unused initial value of the generics, and `onMax` is
+/// called on each created `FHE.max_eint`.
+mlir::Value
+buildMaxTree(mlir::PatternRewriter &rewriter, mlir::Location location,
+             llvm::SmallVector<mlir::Value> operands, mlir::Type elementType,
+             std::function<mlir::Value(mlir::RankedTensorType)> init,
+             std::function<void(FHE::MaxEintOp)> onMax) {
+  while (operands.size() > 1) {
+    llvm::SmallVector<mlir::Value> maxima;
+    for (size_t i = 0; i + 1 < operands.size(); i += 2) {
+      auto type = operands[i]
+                      .getType()
+                      .cast<mlir::RankedTensorType>()
+                      .clone(elementType);
+      mlir::AffineMap identity = mlir::AffineMap::getMultiDimIdentityMap(
+          type.getRank(), rewriter.getContext());
+      auto maps = llvm::SmallVector<mlir::AffineMap, 3>{identity, identity,
+                                                        identity};
+      auto iteratorTypes = llvm::SmallVector<mlir::utils::IteratorType, 3>(
+          type.getRank(), mlir::utils::IteratorType::parallel);
+
+      auto regionBuilder = [&](mlir::OpBuilder &nestedBuilder,
+                               mlir::Location nestedLoc,
+                               mlir::ValueRange blockArgs) {
+        auto max = nestedBuilder.create<FHE::MaxEintOp>(
+            location, elementType, blockArgs[0], blockArgs[1]);
+        onMax(max);
+        nestedBuilder.create<linalg::YieldOp>(location, max.getResult());
+      };
+
+      maxima.push_back(rewriter
+                           .create<linalg::GenericOp>(
+                               location, mlir::TypeRange{type},
+                               mlir::ValueRange{operands[i], operands[i + 1]},
+                               mlir::ValueRange{init(type)}, maps,
+                               iteratorTypes, regionBuilder)
+                           .getResult(0));
+    }
+    if (operands.size() % 2 == 1)
+      maxima.push_back(operands.back());
+    operands = maxima;
+  }
+  return operands.front();
+}
+
 /// This rewrite pattern transforms all instances
 /// of `FHELinalg.maxpool2d` to `linalg.pooling_ncw_max`.
+///
+/// With `maxTree`, the maximum of each window is computed by a tree of
+/// maxima on strided slices of the input instead (see `buildMaxTree`). When
+/// the windows overlap, the maxima of the rows of the windows are computed
+/// first and shared between the windows of a same column, which takes
+/// `(kw - 1)` maxima per row of the input and `(kh - 1)` per output element
+/// instead of `kh * kw` per output element.
 struct FHELinalgMaxpool2dToLinalgMaxpool2d
     : public mlir::OpRewritePattern<FHELinalg::Maxpool2dOp> {
 
-  FHELinalgMaxpool2dToLinalgMaxpool2d(mlir::MLIRContext *context)
-      : mlir::OpRewritePattern<FHELinalg::Maxpool2dOp>(context) {}
+  FHELinalgMaxpool2dToLinalgMaxpool2d(mlir::MLIRContext *context,
+                                      bool maxTree = false)
+      : mlir::OpRewritePattern<FHELinalg::Maxpool2dOp>(context),
+        maxTree(maxTree) {}
 
   mlir::LogicalResult
   matchAndRewrite(FHELinalg::Maxpool2dOp maxpool2dOp,
@@ -1771,6 +2229,13 @@ struct FHELinalgMaxpool2dToLinalgMaxpool2d
 
     const mlir::Location loc = maxpool2dOp->getLoc();
 
+    if (maxTree) {
+      rewriter.replaceOp(
+          maxpool2dOp,
+          buildMaxpool2dTree(maxpool2dOp, optimizerIdAttr, rewriter));
+      return mlir::success();
+    }
+
     std::vector<mlir::NamedAttribute> maxOpDict = {rewriter.getNamedAttr(
         "op", rewriter.getStringAttr(
                   mlir::concretelang::FHE::MaxEintOp::getOperationName()))};
@@ -1853,6 +2318,100 @@ struct FHELinalgMaxpool2dToLinalgMaxpool2d
 
     return mlir::success();
   };
+
+private:
+  static mlir::Value
+  buildMaxpool2dTree(FHELinalg::Maxpool2dOp maxpool2dOp,
+                     mlir::DenseI32ArrayAttr optimizerIdAttr,
+                     mlir::PatternRewriter &rewriter) {
+    const mlir::Location loc = maxpool2dOp->getLoc();
+    mlir::Value input = maxpool2dOp.getInput();
+    const auto outputTy =
+        maxpool2dOp->getResult(0).getType().cast<mlir::RankedTensorType>();
+    const mlir::Type outputElementTy = outputTy.getElementType();
+
+    const mlir::DenseIntElementsAttr defaultAttr =
+        rewriter.getI64VectorAttr({1, 1});
+    auto values = [](mlir::DenseIntElementsAttr attr) {
+      return llvm::SmallVector<int64_t, 2>(attr.value_begin<int64_t>(),
+                                           attr.value_end<int64_t>());
+    };
+    auto kernel = values(maxpool2dOp.getKernelShape());
+    auto strides = values(maxpool2dOp.getStrides().value_or(defaultAttr));
+    auto dilations = values(maxpool2dOp.getDilations().value_or(defaultAttr));
+
+    const int64_t n = outputTy.getDimSize(0);
+    const int64_t c = outputTy.getDimSize(1);
+    const int64_t outH = outputTy.getDimSize(2);
+    const int64_t outW = outputTy.getDimSize(3);
+    // The rows of the input covered by the windows
+    const int64_t rows =
+        (outH - 1) * strides[0] + (kernel[0] - 1) * dilations[0] + 1;
+
+    auto foldResults = [&](llvm::ArrayRef<int64_t> values) {
+      return llvm::to_vector(
+          llvm::map_range(values, [&](int64_t value) -> mlir::OpFoldResult {
+            return rewriter.getIndexAttr(value);
+          }));
+    };
+    auto slice = [&](mlir::Value tensor, int64_t h, int64_t w,
+                     llvm::ArrayRef<int64_t> sizes,
+                     llvm::ArrayRef<int64_t> steps) {
+      auto type = tensor.getType().cast<mlir::RankedTensorType>();
+      return rewriter
+          .create<tensor::ExtractSliceOp>(
+              loc, type.clone(sizes), tensor, foldResults({0, 0, h, w}),
+              foldResults(sizes), foldResults(steps))
+          .getResult();
+    };
+
+    // The optimizer sees the maxpool as a single max, whose identifiers are
+    // given to each of the maxima
+    auto init = [&](mlir::RankedTensorType type) -> mlir::Value {
+      auto zero = rewriter.create<FHE::ZeroTensorOp>(loc, type);
+      if (optimizerIdAttr != nullptr) {
+        bool isSigned =
+            outputElementTy.cast<FHE::FheIntegerInterface>().isSigned();
+        zero->setAttr("TFHE.OId", rewriter.getI32IntegerAttr(
+                                      optimizerIdAttr[isSigned ? 2 : 0]));
+      }
+      return zero;
+    };
+    auto onMax = [&](FHE::MaxEintOp max) {
+      if (optimizerIdAttr != nullptr)
+        max->setAttr("TFHE.OId", optimizerIdAttr);
+    };
+
+    const int64_t windowMaxima =
+        n * c * outH * outW * (kernel[0] * kernel[1] - 1);
+    const int64_t separableMaxima =
+        n * c * (rows * outW * (kernel[1] - 1) + outH * outW * (kernel[0] - 1));
+
+    llvm::SmallVector<mlir::Value> operands;
+    if (separableMaxima >= windowMaxima) {
+      for (int64_t i = 0; i < kernel[0]; i++)
+        for (int64_t j = 0; j < kernel[1]; j++)
+          operands.push_back(slice(input, i * dilations[0], j * dilations[1],
+                                   {n, c, outH, outW},
+                                   {1, 1, strides[0], strides[1]}));
+      return buildMaxTree(rewriter, loc, operands, outputElementTy, init,
+                          onMax);
+    }
+
+    for (int64_t j = 0; j < kernel[1]; j++)
+      operands.push_back(slice(input, 0, j * dilations[1], {n, c, rows, outW},
+                               {1, 1, 1, strides[1]}));
+    mlir::Value rowMaxima = buildMaxTree(rewriter, loc, operands,
+                                         outputElementTy, init, onMax);
+
+    operands.clear();
+    for (int64_t i = 0; i < kernel[0]; i++)
+      operands.push_back(slice(rowMaxima, i * dilations[0], 0,
+                               {n, c, outH, outW}, {1, 1, strides[0], 1}));
+    return buildMaxTree(rewriter, loc, operands, outputElementTy, init, onMax);
+  }
+
+  bool maxTree;
 };
 
 /// This template rewrite pattern transforms any instance of
@@ -2033,8 +2592,130 @@ struct TensorPartitionFrontierOpToLinalgGeneric
   };
 };
 
+/// Returns `value` reshaped to `shape`, which must have the same number of
+/// elements, with a `tensor.collapse_shape` or a `tensor.expand_shape`.
+static mlir::Value reshapeTensor(mlir::OpBuilder &builder,
+                                 mlir::Location location, mlir::Value value,
+                                 llvm::ArrayRef<int64_t> shape) {
+  auto type = value.getType().cast<mlir::RankedTensorType>();
+  if (type.getShape() == shape)
+    return value;
+
+  auto targetType = mlir::RankedTensorType::get(shape, type.getElementType());
+  auto reassociation = mlir::getReassociationIndicesForReshape(
+      type.cast<mlir::ShapedType>(), targetType.cast<mlir::ShapedType>());
+  assert(reassociation.has_value() && "shapes cannot be reassociated");
+
+  if (targetType.getRank() < type.getRank())
+    return builder
+        .create<tensor::CollapseShapeOp>(location, targetType, value,
+                                         *reassociation)
+        .getResult();
+  return builder
+      .create<tensor::ExpandShapeOp>(location, targetType, value,
+                                     *reassociation)
+      .getResult();
+}
+
+/// Returns the positions, in the row-major order of a tensor of shape
+/// `shape`, of the elements designated by the `indices` of a fancy indexing
+/// op, as a `tensor<Nx1xi64>` of the N designated elements, suitable for the
+/// indices of a `tensor.gather` or a `tensor.scatter` on the flattened
+/// tensor.
+static mlir::Value linearizeFancyIndices(mlir::OpBuilder &builder,
+                                         mlir::Location location,
+                                         mlir::Value indices,
+                                         llvm::ArrayRef<int64_t> shape) {
+  auto indicesShape =
+      indices.getType().cast<mlir::RankedTensorType>().getShape();
+  auto isVector = shape.size() == 1;
+  auto batchShape = isVector ? indicesShape : indicesShape.drop_back();
+
+  llvm::SmallVector<int64_t> generateShape(batchShape.begin(),
+                                           batchShape.end());
+  generateShape.push_back(1);
+  auto generateType =
+      mlir::RankedTensorType::get(generateShape, builder.getI64Type());
+
+  auto body = [=](mlir::OpBuilder &nested, mlir::Location loc,
+                  mlir::ValueRange args) {
+    auto batchArgs = args.drop_back();
+    mlir::Value position;
+    if (isVector) {
+      position =
+          nested.create<tensor::ExtractOp>(loc, indices, batchArgs).getResult();
+    } else {
+      auto baseArgs =
+          llvm::SmallVector<mlir::Value>(batchArgs.begin(), batchArgs.end());
+      for (size_t i = 0; i < shape.size(); i++) {
+        baseArgs.push_back(
+            nested.create<arith::ConstantIndexOp>(loc, i).getResult());
+        mlir::Value index =
+            nested.create<tensor::ExtractOp>(loc, indices, baseArgs)
+                .getResult();
+        baseArgs.pop_back();
+        if (i == 0) {
+          position = index;
+          continue;
+        }
+        auto size = nested.create<arith::ConstantIndexOp>(loc, shape[i]);
+        position = nested.create<arith::MulIOp>(loc, position, size);
+        position = nested.create<arith::AddIOp>(loc, position, index);
+      }
+    }
+    auto result = nested.create<arith::IndexCastOp>(loc, nested.getI64Type(),
+                                                    position);
+    nested.create<tensor::YieldOp>(loc, result.getResult());
+  };
+  mlir::Value positions =
+      builder
+          .create<tensor::GenerateOp>(location, generateType,
+                                      mlir::ValueRange(), body)
+          .getResult();
+
+  int64_t count = mlir::ShapedType::getNumElements(batchShape);
+  return reshapeTensor(builder, location, positions, {count, 1});
+}
+
+/// Returns the positions computed by `linearizeFancyIndices` when `indices`
+/// is a constant whose positions are evenly spaced, in increasing order, as
+/// the first position and the stride between consecutive positions, such
+/// that the designated elements form a strided slice of the flattened tensor.
+static std::optional<std::pair<int64_t, int64_t>>
+getStridedFancyIndices(mlir::Value indices, llvm::ArrayRef<int64_t> shape) {
+  mlir::DenseIntElementsAttr attr;
+  if (!mlir::matchPattern(indices, mlir::m_Constant(&attr)))
+    return std::nullopt;
+
+  llvm::SmallVector<int64_t> positions;
+  int64_t position = 0;
+  size_t dimension = 0;
+  for (auto index : attr.getValues<llvm::APInt>()) {
+    position = position * shape[dimension] + index.getSExtValue();
+    if (++dimension == shape.size()) {
+      positions.push_back(position);
+      position = 0;
+      dimension = 0;
+    }
+  }
+
+  if (positions.empty())
+    return std::nullopt;
+  int64_t stride = positions.size() > 1 ? positions[1] - positions[0] : 1;
+  if (stride < 1)
+    return std::nullopt;
+  for (size_t i = 1; i < positions.size(); i++) {
+    if (positions[i] - positions[i - 1] != stride)
+      return std::nullopt;
+  }
+  return std::make_pair(positions[0], stride);
+}
+
 /// This rewrite pattern transforms any instance of operators
-/// `FHELinalg.fancy_index` to an instance of `tensor.generate`.
+/// `FHELinalg.fancy_index` on encrypted tensors to a `tensor.gather` of the
+/// flattened input, which moves whole ciphertexts at once, or to a strided
+/// `tensor.extract_slice` view of the flattened input when the indices are
+/// constant and evenly spaced.
 ///
 /// Example:
 ///
@@ -2043,6 +2724,17 @@ struct TensorPartitionFrontierOpToLinalgGeneric
 ///
 /// becomes:
 ///
+///   %positions = tensor.generate  {
+///     ^bb0(%i: index, %j: index):
+///       %index = tensor.extract %indices[%i] : tensor<3xindex>
+///       %position = arith.index_cast %index : index to i64
+///       tensor.yield %position : i64
+///     } : tensor<3x1xi64>
+///   %output = tensor.gather %input[%positions] gather_dims([0]) :
+///     (tensor<5x!FHE.eint<6>>, tensor<3x1xi64>) -> tensor<3x!FHE.eint<6>>
+///
+/// The other tensors are lowered to an instance of `tensor.generate`:
+///
 ///   %output = tensor.generate  {
 ///     ^bb0(%i: index):
 ///       %index = tensor.extract %indices[%i] : tensor<3xindex>
@@ -2074,6 +2766,43 @@ struct FancyIndexToTensorGenerate
     auto inputIsVector = inputDimensions == 1;
     auto inputElementType = inputType.getElementType();
 
+    if (inputElementType.isa<FHE::FheIntegerInterface>() &&
+        outputType.getRank() > 0) {
+      auto flatInput = reshapeTensor(rewriter, location, input,
+                                     {inputType.getNumElements()});
+      int64_t outputSize = outputType.getNumElements();
+
+      mlir::Value flatOutput;
+      if (auto strided = getStridedFancyIndices(indices, inputShape)) {
+        llvm::SmallVector<mlir::OpFoldResult, 1> offsets{
+            rewriter.getIndexAttr(strided->first)};
+        llvm::SmallVector<mlir::OpFoldResult, 1> sizes{
+            rewriter.getIndexAttr(outputSize)};
+        llvm::SmallVector<mlir::OpFoldResult, 1> strides{
+            rewriter.getIndexAttr(strided->second)};
+        flatOutput = rewriter
+                         .create<tensor::ExtractSliceOp>(
+                             location, flatInput, offsets, sizes, strides)
+                         .getResult();
+      } else {
+        auto positions =
+            linearizeFancyIndices(rewriter, location, indices, inputShape);
+        auto gatherType =
+            mlir::RankedTensorType::get({outputSize}, inputElementType);
+        auto gatherOp = rewriter.create<tensor::GatherOp>(
+            location, gatherType, flatInput, positions,
+            rewriter.getDenseI64ArrayAttr({0}), mlir::UnitAttr());
+        for (auto attr : fancyIndexOp->getAttrs())
+          gatherOp->setAttr(attr.getName(), attr.getValue());
+        flatOutput = gatherOp.getResult();
+      }
+
+      rewriter.replaceOp(fancyIndexOp,
+                         {reshapeTensor(rewriter, location, flatOutput,
+                                        outputType.getShape())});
+      return mlir::success();
+    }
+
     auto dynamicExtents = mlir::ValueRange();
     auto body = [=](mlir::OpBuilder &builder, mlir::Location location,
                     mlir::ValueRange args) {
@@ -2114,7 +2843,9 @@ struct FancyIndexToTensorGenerate
 };
 
 /// This rewrite pattern transforms any instance of operators
-/// `FHELinalg.fancy_assign` to an instance of `scf.forall`.
+/// `FHELinalg.fancy_assign` on encrypted tensors to a `tensor.scatter` into
+/// the flattened input, which moves whole ciphertexts at once, or to a strided
+/// `tensor.insert_slice` when the indices are constant and evenly spaced.
 ///
 /// Example:
 ///
@@ -2124,6 +2855,23 @@ struct FancyIndexToTensorGenerate
 ///
 /// becomes:
 ///
+///   %positions = tensor.generate  {
+///     ^bb0(%i: index, %j: index):
+///       %index = tensor.extract %indices[%i] : tensor<3xindex>
+///       %position = arith.index_cast %index : index to i64
+///       tensor.yield %position : i64
+///     } : tensor<3x1xi64>
+///   %output = tensor.scatter %values into %input[%positions]
+///       scatter_dims([0]) unique :
+///     (tensor<3x!FHE.eint<6>>, tensor<5x!FHE.eint<6>>, tensor<3x1xi64>) ->
+///     tensor<5x!FHE.eint<6>>
+///
+/// The scatter is marked `unique` as required by its verifier; as with the
+/// element by element lowering, the value written at an index that appears
+/// several times is unspecified.
+///
+/// The other tensors are lowered to an instance of `scf.forall`:
+///
 ///   %0 = scf.forall (%i) in (3) shared_outs(%output = %input)
 ///       -> (tensor<5x!FHE.eint<6>>) {
 ///     %index = tensor.extract %indices[%i] : tensor<3xindex>
@@ -2159,6 +2907,45 @@ struct FancyAssignToSfcForall
     auto inputIsVector = inputDimensions == 1;
     auto inputElementType = inputType.getElementType();
 
+    if (inputElementType.isa<FHE::FheIntegerInterface>() &&
+        valuesType.getRank() > 0) {
+      auto location = fancyAssignOp.getLoc();
+      auto flatInput = reshapeTensor(rewriter, location, input,
+                                     {inputType.getNumElements()});
+      int64_t valuesSize = valuesType.getNumElements();
+      auto flatValues =
+          reshapeTensor(rewriter, location, values, {valuesSize});
+
+      mlir::Value flatOutput;
+      if (auto strided = getStridedFancyIndices(indices, inputShape)) {
+        llvm::SmallVector<mlir::OpFoldResult, 1> offsets{
+            rewriter.getIndexAttr(strided->first)};
+        llvm::SmallVector<mlir::OpFoldResult, 1> sizes{
+            rewriter.getIndexAttr(valuesSize)};
+        llvm::SmallVector<mlir::OpFoldResult, 1> strides{
+            rewriter.getIndexAttr(strided->second)};
+        flatOutput = rewriter
+                         .create<tensor::InsertSliceOp>(location, flatValues,
+                                                        flatInput, offsets,
+                                                        sizes, strides)
+                         .getResult();
+      } else {
+        auto positions =
+            linearizeFancyIndices(rewriter, location, indices, inputShape);
+        flatOutput = rewriter
+                         .create<tensor::ScatterOp>(
+                             location, flatInput.getType(), flatValues,
+                             flatInput, positions,
+                             rewriter.getDenseI64ArrayAttr({0}),
+                             rewriter.getUnitAttr())
+                         .getResult();
+      }
+
+      auto output = reshapeTensor(rewriter, location, flatOutput, inputShape);
+      rewriter.replaceOp(fancyAssignOp, {output});
+      return mlir::success();
+    }
+
     auto upperBounds = llvm::SmallVector<mlir::OpFoldResult>();
     for (auto dimension : valuesType.getShape()) {
       upperBounds.push_back(
@@ -2423,8 +3210,17 @@ struct BroadcastToLinalgGeneric
 namespace {
 struct FHETensorOpsToLinalg
     : public FHETensorOpsToLinalgBase<FHETensorOpsToLinalg> {
+  FHETensorOpsToLinalg(bool treeReduction, bool im2colConv2d,
+                       bool maxpool2dTree)
+      : treeReduction(treeReduction), im2colConv2d(im2colConv2d),
+        maxpool2dTree(maxpool2dTree) {}
 
   void runOnOperation() final;
+
+private:
+  bool treeReduction;
+  bool im2colConv2d;
+  bool maxpool2dTree;
 };
 
 void FHETensorOpsToLinalg::runOnOperation() {
@@ -2475,7 +3271,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
       [](FHELinalg::Dot &dot, FHE::AddEintOp &add, FHE::MulEintIntOp &mul) {
         forwardOptimizerID(dot, add);
         forwardOptimizerID(dot, mul);
-      });
+      },
+      treeReduction);
   patterns.insert<DotToLinalgGeneric<mlir::concretelang::FHELinalg::DotEint,
                                      mlir::concretelang::FHE::MulEintOp>>(
       &getContext(),
@@ -2497,7 +3294,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
                      builder.getI32IntegerAttr(optimizerIds.back()));
         mul->setAttr("TFHE.OId",
                      builder.getDenseI32ArrayAttr(optimizerIds.drop_back()));
-      });
+      },
+      treeReduction);
   patterns.insert<
       FHELinalgOpToLinalgGeneric<mlir::concretelang::FHELinalg::AddEintOp,
                                  mlir::concretelang::FHE::AddEintOp>>(
@@ -2567,7 +3365,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
          FHE::MulEintIntOp &mul) {
         forwardOptimizerID(dot, add);
         forwardOptimizerID(dot, mul);
-      });
+      },
+      treeReduction);
   patterns.insert<FHELinalgMatmulToLinalgGeneric<
       mlir::concretelang::FHELinalg::MatMulIntEintOp,
       mlir::concretelang::FHE::MulEintIntOp>>(
@@ -2581,7 +3380,8 @@ void FHETensorOpsToLinalg::runOnOperation() {
          FHE::MulEintIntOp &mul) {
         forwardOptimizerID(dot, add);
         forwardOptimizerID(dot, mul);
-      });
+      },
+      treeReduction);
   patterns.insert<FHELinalgMatmulToLinalgGeneric<
       mlir::concretelang::FHELinalg::MatMulEintEintOp,
       mlir::concretelang::FHE::MulEintOp>>(
@@ -2605,14 +3405,16 @@ void FHETensorOpsToLinalg::runOnOperation() {
                      builder.getI32IntegerAttr(optimizerIds.back()));
         mul->setAttr("TFHE.OId",
                      builder.getDenseI32ArrayAttr(optimizerIds.drop_back()));
-      });
+      },
+      treeReduction);
   patterns.insert<FHELinalgApplyMultiLookupTableToLinalgGeneric>(&getContext());
   patterns.insert<FHELinalgApplyMappedLookupTableToLinalgGeneric>(
       &getContext());
-  patterns.insert<SumToLinalgGeneric>(&getContext());
+  patterns.insert<SumToLinalgGeneric>(&getContext(), treeReduction);
   patterns.insert<ConcatRewritePattern>(&getContext());
-  patterns.insert<FHELinalgConv2dToLinalgConv2d>(&getContext());
-  patterns.insert<FHELinalgMaxpool2dToLinalgMaxpool2d>(&getContext());
+  patterns.insert<FHELinalgConv2dToLinalgConv2d>(&getContext(), im2colConv2d);
+  patterns.insert<FHELinalgMaxpool2dToLinalgMaxpool2d>(&getContext(),
+                                                       maxpool2dTree);
   patterns.insert<TransposeToLinalgGeneric>(&getContext());
   patterns.insert<FromElementToTensorFromElements>(&getContext());
   patterns.insert<TensorPartitionFrontierOpToLinalgGeneric>(&getContext());
@@ -2634,8 +3436,10 @@ void FHETensorOpsToLinalg::runOnOperation() {
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
-createConvertFHETensorOpsToLinalg() {
-  return std::make_unique<FHETensorOpsToLinalg>();
+createConvertFHETensorOpsToLinalg(bool treeReduction, bool im2colConv2d,
+                                  bool maxpool2dTree) {
+  return std::make_unique<FHETensorOpsToLinalg>(treeReduction, im2colConv2d,
+                                                maxpool2dTree);
 }
 } // namespace concretelang
 } // namespace mlir
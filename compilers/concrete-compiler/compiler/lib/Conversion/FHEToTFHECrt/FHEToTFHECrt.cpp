@@ -122,7 +122,9 @@ namespace lowering {
 template <typename T>
 struct CrtOpPattern : public mlir::OpConversionPattern<T> {
 
-  /// The lowering parameters are bound to the op rewriter.
+  /// The lowering parameters are bound to the op rewriter. With
+  /// `batchBlocks`, the leveled operations are lowered to batched operations
+  /// over the blocks instead of loops written by `writeUnaryTensorLoop`.
   mlir::concretelang::CrtLoweringParameters loweringParameters;
 
   CrtOpPattern(mlir::MLIRContext *context,
@@ -204,6 +206,12 @@ struct AddEintIntOpPattern : public CrtOpPattern<FHE::AddEintIntOp> {
     mlir::Value encodedPlaintextTensor =
         writePlaintextCrtEncoding(op.getLoc(), intOperand, rewriter);
 
+    if (loweringParameters.batchBlocks) {
+      rewriter.replaceOpWithNewOp<TFHE::ABatchedAddGLWEIntOp>(
+          op, eintOperand.getType(), eintOperand, encodedPlaintextTensor);
+      return mlir::success();
+    }
+
     // Write add loop.
     mlir::Type ciphertextScalarType =
         converter->convertType(eintOperand.getType())
@@ -251,6 +259,14 @@ struct SubIntEintOpPattern : public CrtOpPattern<FHE::SubIntEintOp> {
     mlir::Value encodedPlaintextTensor =
         writePlaintextCrtEncoding(op.getLoc(), intOperand, rewriter);
 
+    if (loweringParameters.batchBlocks) {
+      mlir::Value negated = rewriter.create<TFHE::BatchedNegGLWEOp>(
+          location, eintOperand.getType(), eintOperand);
+      rewriter.replaceOpWithNewOp<TFHE::ABatchedAddGLWEIntOp>(
+          op, eintOperand.getType(), negated, encodedPlaintextTensor);
+      return mlir::success();
+    }
+
     // Write add loop.
     mlir::Type ciphertextScalarType =
         converter->convertType(eintOperand.getType())
@@ -308,6 +324,12 @@ struct SubEintIntOpPattern : public CrtOpPattern<FHE::SubEintIntOp> {
     mlir::Value encodedPlaintextTensor =
         writePlaintextCrtEncoding(op.getLoc(), negative, rewriter);
 
+    if (loweringParameters.batchBlocks) {
+      rewriter.replaceOpWithNewOp<TFHE::ABatchedAddGLWEIntOp>(
+          op, eintOperand.getType(), eintOperand, encodedPlaintextTensor);
+      return mlir::success();
+    }
+
     // Write add loop.
     mlir::Type ciphertextScalarType =
         converter->convertType(eintOperand.getType())
@@ -351,6 +373,12 @@ struct AddEintOpPattern : CrtOpPattern<FHE::AddEintOp> {
     mlir::Value lhsOperand = adaptor.getA();
     mlir::Value rhsOperand = adaptor.getB();
 
+    if (loweringParameters.batchBlocks) {
+      rewriter.replaceOpWithNewOp<TFHE::ABatchedAddGLWEOp>(
+          op, lhsOperand.getType(), lhsOperand, rhsOperand);
+      return mlir::success();
+    }
+
     // Write add loop.
     mlir::Type ciphertextScalarType =
         converter->convertType(lhsOperand.getType())
@@ -394,6 +422,14 @@ struct SubEintOpPattern : CrtOpPattern<FHE::SubEintOp> {
     mlir::Value lhsOperand = adaptor.getA();
     mlir::Value rhsOperand = adaptor.getB();
 
+    if (loweringParameters.batchBlocks) {
+      mlir::Value negatedRhs = rewriter.create<TFHE::BatchedNegGLWEOp>(
+          location, rhsOperand.getType(), rhsOperand);
+      rewriter.replaceOpWithNewOp<TFHE::ABatchedAddGLWEOp>(
+          op, lhsOperand.getType(), lhsOperand, negatedRhs);
+      return mlir::success();
+    }
+
     // Write sub loop.
     mlir::Type ciphertextScalarType =
         converter->convertType(lhsOperand.getType())
@@ -438,6 +474,12 @@ struct NegEintOpPattern : CrtOpPattern<FHE::NegEintOp> {
     mlir::Location location = op.getLoc();
     mlir::Value operand = adaptor.getA();
 
+    if (loweringParameters.batchBlocks) {
+      rewriter.replaceOpWithNewOp<TFHE::BatchedNegGLWEOp>(
+          op, operand.getType(), operand);
+      return mlir::success();
+    }
+
     // Write the loop nest.
     mlir::Type ciphertextScalarType = converter->convertType(operand.getType())
                                           .cast<mlir::RankedTensorType>()
@@ -518,6 +560,12 @@ struct MulEintIntOpPattern : CrtOpPattern<FHE::MulEintIntOp> {
     mlir::Value encodedCleartext = rewriter.create<mlir::arith::ExtSIOp>(
         location, rewriter.getI64Type(), intOperand);
 
+    if (loweringParameters.batchBlocks) {
+      rewriter.replaceOpWithNewOp<TFHE::BatchedMulGLWEIntCstOp>(
+          op, eintOperand.getType(), eintOperand, encodedCleartext);
+      return mlir::success();
+    }
+
     // Write the loop nest.
     mlir::Type ciphertextScalarType =
         converter->convertType(eintOperand.getType())
@@ -588,7 +636,7 @@ struct ApplyLookupTableEintOpPattern
                                         TFHE::GLWESecretKey(), -1, -1, -1),
         TFHE::GLWEBootstrapKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
                                         TFHE::GLWESecretKey(), -1, -1, -1, -1,
-                                        -1),
+                                        -1, 0),
         TFHE::GLWEPackingKeyswitchKeyAttr::get(
             op.getContext(), TFHE::GLWESecretKey(), TFHE::GLWESecretKey(), -1,
             -1, -1, -1, -1, -1),
@@ -964,7 +1012,9 @@ struct FHEToTFHECrtPass : public FHEToTFHECrtBase<FHEToTFHECrtPass> {
               converter.isLegal(op->getRegion(0).front().getArgumentTypes()));
         });
     target.addDynamicallyLegalOp<mlir::tensor::InsertOp,
-                                 mlir::tensor::ExtractOp, mlir::scf::YieldOp>(
+                                 mlir::tensor::ExtractOp,
+                                 mlir::tensor::GatherOp,
+                                 mlir::tensor::ScatterOp, mlir::scf::YieldOp>(
         [&](mlir::Operation *op) {
           return (converter.isLegal(op->getOperandTypes()) &&
                   converter.isLegal(op->getResultTypes()));
@@ -1073,6 +1123,12 @@ struct FHEToTFHECrtPass : public FHEToTFHECrtBase<FHEToTFHECrtPass> {
         patterns.getContext(), loweringParameters);
     patterns.add<lowering::TraceCiphertextOpPattern>(patterns.getContext(),
                                                      loweringParameters);
+    // The CRT dimension of the gathered and scattered ciphertexts is a
+    // trailing dimension of the tensors, which only needs converted types
+    patterns.add<mlir::concretelang::TypeConvertingReinstantiationPattern<
+                     mlir::tensor::GatherOp, true>,
+                 mlir::concretelang::TypeConvertingReinstantiationPattern<
+                     mlir::tensor::ScatterOp, true>>(&getContext(), converter);
     patterns.add<mlir::concretelang::TypeConvertingReinstantiationPattern<
         mlir::tensor::GenerateOp, true>>(&getContext(), converter);
 
@@ -8,8 +8,10 @@
 #include <mlir/Dialect/Bufferization/IR/Bufferization.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/Linalg/IR/Linalg.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
 #include <mlir/IR/Operation.h>
 
+#include "concretelang/Common/LutEncoding.h"
 #include "concretelang/Dialect/Optimizer/IR/OptimizerOps.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -367,6 +369,10 @@ struct ApplyLookupTableEintOpPattern
                   FHE::ApplyLookupTableEintOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
+    auto group = getManyLutGroup(op);
+    if (group.size() > 1)
+      return rewriteManyLut(group, adaptor.getA(), rewriter);
+
     auto inputType = op.getA().getType().cast<FHE::FheIntegerInterface>();
     size_t outputBits =
         op.getResult().getType().cast<FHE::FheIntegerInterface>().getWidth();
@@ -417,33 +423,174 @@ struct ApplyLookupTableEintOpPattern
       input = inputOp;
     }
 
+    auto ksKey =
+        TFHE::GLWEKeyswitchKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
+                                        TFHE::GLWESecretKey(), -1, -1, -1);
+    auto bsKey = TFHE::GLWEBootstrapKeyAttr::get(
+        op.getContext(), TFHE::GLWESecretKey(), TFHE::GLWESecretKey(), -1, -1,
+        -1, -1, -1, 0);
+    auto setLookupTableIndex = [&](mlir::Operation *newOp) {
+      if (operatorIndexes != nullptr) {
+        newOp->setAttr("TFHE.OId",
+                       rewriter.getI32IntegerAttr(
+                           operatorIndexes[operatorIndexes.size() - 1]));
+      }
+    };
+
+    // The optimizer can keep the ciphertexts of the lookup table partition on
+    // the small key, the lookup table then bootstraps and keyswitches back
+    if (operatorIndexes != nullptr &&
+        loweringParameters.pbsKsLookupTables.count(
+            operatorIndexes[operatorIndexes.size() - 1])) {
+      auto bsOp = rewriter.create<TFHE::BootstrapGLWEOp>(
+          op.getLoc(), getTypeConverter()->convertType(op.getType()), input,
+          newLut, bsKey);
+      setLookupTableIndex(bsOp);
+      auto ksOp = rewriter.replaceOpWithNewOp<TFHE::KeySwitchGLWEOp>(
+          op, getTypeConverter()->convertType(op.getType()), bsOp, ksKey);
+      setLookupTableIndex(ksOp);
+      return mlir::success();
+    }
+
     // Insert keyswitch
     auto ksOp = rewriter.create<TFHE::KeySwitchGLWEOp>(
         op.getLoc(), getTypeConverter()->convertType(adaptor.getA().getType()),
-        input,
-        TFHE::GLWEKeyswitchKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
-                                        TFHE::GLWESecretKey(), -1, -1, -1));
-    if (operatorIndexes != nullptr) {
-      ksOp->setAttr("TFHE.OId",
-                    rewriter.getI32IntegerAttr(
-                        operatorIndexes[operatorIndexes.size() - 1]));
-    }
+        input, ksKey);
+    setLookupTableIndex(ksOp);
 
     // Insert bootstrap
     auto bsOp = rewriter.replaceOpWithNewOp<TFHE::BootstrapGLWEOp>(
         op, getTypeConverter()->convertType(op.getType()), ksOp, newLut,
-        TFHE::GLWEBootstrapKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
-                                        TFHE::GLWESecretKey(), -1, -1, -1, -1,
-                                        -1));
-    if (operatorIndexes != nullptr) {
-      bsOp->setAttr("TFHE.OId",
-                    rewriter.getI32IntegerAttr(
-                        operatorIndexes[operatorIndexes.size() - 1]));
-    }
+        bsKey);
+    setLookupTableIndex(bsOp);
     return mlir::success();
   };
 
 private:
+  /// Returns the lookup tables of the input of `op` evaluated by the same
+  /// many-LUT bootstrap, in block order, i.e. those the optimizer assigned
+  /// the same operators, or only `op` if it is not the first of them.
+  llvm::SmallVector<FHE::ApplyLookupTableEintOp>
+  getManyLutGroup(FHE::ApplyLookupTableEintOp op) const {
+    llvm::SmallVector<FHE::ApplyLookupTableEintOp> group{op};
+    auto operatorIndexes =
+        op->getAttrOfType<mlir::DenseI32ArrayAttr>("TFHE.OId");
+    if (operatorIndexes == nullptr ||
+        loweringParameters.pbsKsLookupTables.count(
+            operatorIndexes[operatorIndexes.size() - 1]))
+      return group;
+
+    for (auto user : op.getA().getUsers()) {
+      auto other = llvm::dyn_cast<FHE::ApplyLookupTableEintOp>(user);
+      if (other == nullptr || other == op ||
+          other->getBlock() != op->getBlock() ||
+          other->getAttr("TFHE.OId") != operatorIndexes)
+        continue;
+      if (other->isBeforeInBlock(op))
+        return {op};
+      group.push_back(other);
+    }
+    llvm::sort(group, [](FHE::ApplyLookupTableEintOp a,
+                         FHE::ApplyLookupTableEintOp b) {
+      return a->isBeforeInBlock(b);
+    });
+    return group;
+  }
+
+  /// Replaces the lookup tables of `group` by a keyswitch of `input` followed
+  /// by a many-LUT bootstrap, whose results are extracted in the order of the
+  /// group.
+  mlir::LogicalResult
+  rewriteManyLut(llvm::ArrayRef<FHE::ApplyLookupTableEintOp> group,
+                 mlir::Value input,
+                 mlir::ConversionPatternRewriter &rewriter) const {
+    auto op = group.front();
+    auto loc = op.getLoc();
+    int64_t lutCount = group.size();
+    int64_t lutSize =
+        op.getLut().getType().cast<mlir::RankedTensorType>().getDimSize(0);
+    auto lutsType = mlir::RankedTensorType::get({lutCount, lutSize},
+                                                rewriter.getI64Type());
+
+    // Stack the tables, the constant ones being encoded at compile time if
+    // all of them are. The later tables are only known before `op` if they
+    // are constants, which are then materialized again.
+    mlir::Value luts;
+    llvm::SmallVector<llvm::APInt> values;
+    for (auto lut : group) {
+      auto cst = lut.getLut().getDefiningOp<mlir::arith::ConstantOp>();
+      auto attr = cst ? cst.getValue().dyn_cast<mlir::DenseIntElementsAttr>()
+                      : nullptr;
+      if (attr == nullptr) {
+        values.clear();
+        break;
+      }
+      values.append(attr.value_begin<llvm::APInt>(),
+                    attr.value_end<llvm::APInt>());
+    }
+    if (!values.empty()) {
+      luts = rewriter.create<mlir::arith::ConstantOp>(
+          loc, mlir::DenseIntElementsAttr::get(lutsType, values));
+    } else {
+      luts = rewriter.create<mlir::tensor::EmptyOp>(
+          loc, lutsType.getShape(), rewriter.getI64Type());
+      for (auto [i, lut] : llvm::enumerate(group)) {
+        mlir::Value table = lut.getLut();
+        if (auto cst = table.getDefiningOp<mlir::arith::ConstantOp>())
+          table = rewriter.clone(*cst)->getResult(0);
+        luts = rewriter.create<mlir::tensor::InsertSliceOp>(
+            loc, table, luts,
+            llvm::ArrayRef<mlir::OpFoldResult>{
+                rewriter.getIndexAttr(i), rewriter.getIndexAttr(0)},
+            llvm::ArrayRef<mlir::OpFoldResult>{rewriter.getIndexAttr(1),
+                                               rewriter.getIndexAttr(lutSize)},
+            llvm::ArrayRef<mlir::OpFoldResult>{rewriter.getIndexAttr(1),
+                                               rewriter.getIndexAttr(1)});
+      }
+    }
+
+    size_t outputBits =
+        op.getResult().getType().cast<FHE::FheIntegerInterface>().getWidth();
+    size_t polySize = loweringParameters.polynomialSize;
+    mlir::Value newLut =
+        rewriter.create<TFHE::EncodeExpandManyLutForBootstrapOp>(
+            loc,
+            mlir::RankedTensorType::get({(int64_t)polySize},
+                                        rewriter.getI64Type()),
+            luts, rewriter.getI32IntegerAttr(polySize),
+            rewriter.getI32IntegerAttr(outputBits),
+            rewriter.getBoolAttr(false));
+
+    // The stride is computed again once the polynomial size is known
+    auto operatorIndexes =
+        op->getAttrOfType<mlir::DenseI32ArrayAttr>("TFHE.OId");
+    auto lutIndex = rewriter.getI32IntegerAttr(
+        operatorIndexes[operatorIndexes.size() - 1]);
+    auto ksKey =
+        TFHE::GLWEKeyswitchKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
+                                        TFHE::GLWESecretKey(), -1, -1, -1);
+    auto bsKey = TFHE::GLWEBootstrapKeyAttr::get(
+        op.getContext(), TFHE::GLWESecretKey(), TFHE::GLWESecretKey(), -1, -1,
+        -1, -1, -1, 0);
+    auto ksOp = rewriter.create<TFHE::KeySwitchGLWEOp>(
+        loc, getTypeConverter()->convertType(input.getType()), input, ksKey);
+    ksOp->setAttr("TFHE.OId", lutIndex);
+    auto resultType = getTypeConverter()->convertType(op.getType());
+    auto bsOp = rewriter.create<TFHE::ManyLutBootstrapGLWEOp>(
+        loc, mlir::RankedTensorType::get({lutCount}, resultType), ksOp, newLut,
+        bsKey, rewriter.getI32IntegerAttr(lutCount),
+        rewriter.getI32IntegerAttr(concretelang::lut::manyLutStride(
+            polySize, lutSize, lutCount)));
+    bsOp->setAttr("TFHE.OId", lutIndex);
+
+    for (auto [i, lut] : llvm::enumerate(group)) {
+      mlir::Value index =
+          rewriter.create<mlir::arith::ConstantIndexOp>(loc, i);
+      rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(lut, bsOp, index);
+    }
+    return mlir::success();
+  }
+
   mlir::concretelang::ScalarLoweringParameters loweringParameters;
 };
 
@@ -553,7 +700,7 @@ std::vector<mlir::Value> extractBitWithClearedLowerBits(
   auto ksk = TFHE::GLWEKeyswitchKeyAttr::get(context, secretKey, secretKey, -1,
                                              -1, -1);
   auto bsk = TFHE::GLWEBootstrapKeyAttr::get(context, secretKey, secretKey, -1,
-                                             -1, -1, -1, -1);
+                                             -1, -1, -1, -1, 0);
 
   auto keyswitched = rewriter.create<TFHE::KeySwitchGLWEOp>(
       loc, cInputTy, shiftedRotatedInput, ksk);
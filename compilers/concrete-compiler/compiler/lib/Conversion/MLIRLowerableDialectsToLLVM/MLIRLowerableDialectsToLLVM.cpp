@@ -40,13 +40,38 @@
 namespace {
 struct MLIRLowerableDialectsToLLVMPass
     : public MLIRLowerableDialectsToLLVMBase<MLIRLowerableDialectsToLLVMPass> {
+  MLIRLowerableDialectsToLLVMPass(bool checkedAllocations)
+      : checkedAllocations(checkedAllocations) {}
+
   void runOnOperation() final;
 
   /// Convert types to the LLVM dialect-compatible type
   static std::optional<mlir::Type> convertTypes(mlir::Type type);
+
+private:
+  bool checkedAllocations;
 };
 } // namespace
 
+/// Redirects the `malloc` and `free` calls of the module to the
+/// `concrete_checked_malloc` and `concrete_checked_free` runtime functions,
+/// which may serve them from the pinned or host memory pools.
+static mlir::LogicalResult redirectToCheckedAllocations(mlir::ModuleOp module) {
+  std::pair<llvm::StringRef, llvm::StringRef> redirections[] = {
+      {"malloc", "concrete_checked_malloc"}, {"free", "concrete_checked_free"}};
+  for (auto [from, to] : redirections) {
+    auto func = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(from);
+    if (!func || module.lookupSymbol(to))
+      continue;
+    if (mlir::SymbolTable::replaceAllSymbolUses(
+            func, mlir::StringAttr::get(module.getContext(), to), module)
+            .failed())
+      return mlir::failure();
+    func.setSymName(to);
+  }
+  return mlir::success();
+}
+
 /// This rewrite pattern transforms any instance of `memref.copy`
 /// operators on 1D memref.
 /// This is introduced to avoid the MLIR lowering of `memref.copy` of ranked
@@ -145,7 +170,11 @@ void MLIRLowerableDialectsToLLVMPass::runOnOperation() {
   auto module = getOperation();
   if (mlir::applyFullConversion(module, target, std::move(patterns)).failed()) {
     signalPassFailure();
+    return;
   }
+
+  if (checkedAllocations && redirectToCheckedAllocations(module).failed())
+    signalPassFailure();
 }
 
 std::optional<mlir::Type>
@@ -174,8 +203,8 @@ namespace concretelang {
 /// Create a pass for lowering operations the remaining mlir dialects
 /// operations, to the LLVM dialect for codegen.
 std::unique_ptr<OperationPass<ModuleOp>>
-createConvertMLIRLowerableDialectsToLLVMPass() {
-  return std::make_unique<MLIRLowerableDialectsToLLVMPass>();
+createConvertMLIRLowerableDialectsToLLVMPass(bool checkedAllocations) {
+  return std::make_unique<MLIRLowerableDialectsToLLVMPass>(checkedAllocations);
 }
 } // namespace concretelang
 } // namespace mlir
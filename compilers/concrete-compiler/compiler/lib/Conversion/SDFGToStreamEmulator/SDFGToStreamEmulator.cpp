@@ -22,7 +22,7 @@ struct SDFGToStreamEmulatorPass
   void runOnOperation() final;
 };
 
-char stream_emulator_init[] = "stream_emulator_init";
+char stream_emulator_init_persistent[] = "stream_emulator_init_persistent";
 char stream_emulator_run[] = "stream_emulator_run";
 char stream_emulator_delete[] = "stream_emulator_delete";
 char stream_emulator_make_memref_add_lwe_ciphertexts_u64_process[] =
@@ -122,25 +122,39 @@ void castDynamicTensorOps(mlir::Operation *op, mlir::OpBuilder &rewriter,
   }
 }
 
+/// The graphs are kept by the runtime context across the calls, each graph
+/// of the module being identified by the index of its init.
 struct LowerSDFGInit
     : public mlir::OpRewritePattern<mlir::concretelang::SDFG::Init> {
-  LowerSDFGInit(::mlir::MLIRContext *context, mlir::PatternBenefit benefit = 1)
+  LowerSDFGInit(::mlir::MLIRContext *context,
+                const llvm::DenseMap<mlir::Operation *, uint64_t> &graphIds,
+                mlir::PatternBenefit benefit = 1)
       : ::mlir::OpRewritePattern<mlir::concretelang::SDFG::Init>(context,
-                                                                 benefit) {}
+                                                                 benefit),
+        graphIds(graphIds) {}
   ::mlir::LogicalResult
   matchAndRewrite(mlir::concretelang::SDFG::Init initOp,
                   ::mlir::PatternRewriter &rewriter) const override {
+    mlir::Value context = getContextArgument(initOp);
     mlir::FunctionType funcType = mlir::FunctionType::get(
-        rewriter.getContext(), {}, {SDFG::DFGType::get(rewriter.getContext())});
-    if (insertForwardDeclaration(initOp, rewriter, stream_emulator_init,
-                                 funcType)
+        rewriter.getContext(), {context.getType(), rewriter.getI64Type()},
+        {SDFG::DFGType::get(rewriter.getContext())});
+    if (insertForwardDeclaration(initOp, rewriter,
+                                 stream_emulator_init_persistent, funcType)
             .failed())
       return ::mlir::failure();
+    mlir::Value graphId = rewriter.create<mlir::arith::ConstantOp>(
+        initOp.getLoc(), rewriter.getI64IntegerAttr(
+                             graphIds.lookup(initOp.getOperation())));
     rewriter.replaceOpWithNewOp<mlir::func::CallOp>(
-        initOp, stream_emulator_init,
-        mlir::TypeRange{SDFG::DFGType::get(rewriter.getContext())});
+        initOp, stream_emulator_init_persistent,
+        mlir::TypeRange{SDFG::DFGType::get(rewriter.getContext())},
+        mlir::ValueRange{context, graphId});
     return ::mlir::success();
   };
+
+private:
+  const llvm::DenseMap<mlir::Operation *, uint64_t> &graphIds;
 };
 
 struct LowerSDFGStart
@@ -461,9 +475,15 @@ void SDFGToStreamEmulatorPass::runOnOperation() {
   mlir::ConversionTarget target(getContext());
   mlir::RewritePatternSet patterns(&getContext());
 
-  patterns.insert<LowerSDFGInit, LowerSDFGStart, LowerSDFGShutdown,
-                  LowerSDFGMakeProcess, LowerSDFGMakeStream, LowerSDFGPut,
-                  LowerSDFGGet>(&getContext());
+  llvm::DenseMap<mlir::Operation *, uint64_t> graphIds;
+  op.walk([&](SDFG::Init initOp) {
+    graphIds.try_emplace(initOp.getOperation(), graphIds.size());
+  });
+
+  patterns.insert<LowerSDFGInit>(&getContext(), graphIds);
+  patterns.insert<LowerSDFGStart, LowerSDFGShutdown, LowerSDFGMakeProcess,
+                  LowerSDFGMakeStream, LowerSDFGPut, LowerSDFGGet>(
+      &getContext());
 
   target.addIllegalOp<SDFG::Init, SDFG::Start, SDFG::Shutdown,
                       SDFG::MakeProcess, SDFG::MakeStream, SDFG::Put>();
@@ -8,6 +8,8 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "concrete-cpu-noise-model.h"
+#include "concretelang/Common/Security.h"
 #include "concretelang/Conversion/Passes.h"
 #include "concretelang/Conversion/Tools.h"
 #include "concretelang/Conversion/Utils/FuncConstOpConversion.h"
@@ -19,6 +21,9 @@
 #include "concretelang/Dialect/RT/IR/RTOps.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEOps.h"
 #include "concretelang/Support/Constants.h"
+#include "concretelang/Support/V0Parameters.h"
+
+#include <cmath>
 
 namespace TFHE = mlir::concretelang::TFHE;
 namespace Tracing = mlir::concretelang::Tracing;
@@ -57,6 +62,13 @@ public:
 
 namespace {
 
+/// The curve of the keys the noise of the simulated operations derives from,
+/// as in the simulation runtime.
+concretelang::security::SecurityCurve *securityCurve() {
+  return concretelang::security::getSecurityCurve(
+      128, concretelang::security::BINARY);
+}
+
 mlir::RankedTensorType toDynamicTensorType(mlir::TensorType staticSizedTensor) {
   std::vector<int64_t> dynSizedShape(staticSizedTensor.getShape().size(),
                                      mlir::ShapedType::kDynamic);
@@ -64,6 +76,48 @@ mlir::RankedTensorType toDynamicTensorType(mlir::TensorType staticSizedTensor) {
                                      staticSizedTensor.getElementType());
 }
 
+/// Returns the standard deviation of the noise of a keyswitch with `key`. The
+/// parameters are static, so the noise is computed once here instead of on
+/// each simulated keyswitch.
+double keyswitchStdDev(TFHE::GLWEKeyswitchKeyAttr key) {
+  auto inputDim = key.getInputKey().getNormalized().value().dimension;
+  auto outputDim = key.getOutputKey().getNormalized().value().dimension;
+  double varianceKsk = securityCurve()->getVariance(1, outputDim, 64);
+  double variance = concrete_cpu_variance_keyswitch(
+      inputDim, key.getBaseLog(), key.getLevels(), 64, varianceKsk);
+  return std::sqrt(variance);
+}
+
+/// Returns the standard deviations of the noise of the modulus switching and
+/// of the blind rotation of a bootstrap with `key`, computed once as for the
+/// keyswitches.
+std::pair<double, double> bootstrapStdDevs(TFHE::GLWEBootstrapKeyAttr key) {
+  auto inputLweDimension = key.getInputKey().getNormalized().value().dimension;
+  auto polySize = key.getPolySize();
+  auto glweDimension = key.getGlweDim();
+  double varianceMs =
+      concrete_cpu_estimate_modulus_switching_noise_with_binary_key(
+          inputLweDimension, log2(polySize), 64);
+  double varianceBsk =
+      securityCurve()->getVariance(glweDimension, polySize, 64);
+  double varianceBr = concrete_cpu_variance_blind_rotate(
+      inputLweDimension, glweDimension, polySize, key.getBaseLog(),
+      key.getLevels(), 64, mlir::concretelang::optimizer::DEFAULT_FFT_PRECISION,
+      varianceBsk);
+  return {std::sqrt(varianceMs), std::sqrt(varianceBr)};
+}
+
+/// Returns `value` casted to a tensor of dynamic size, as expected by the
+/// simulation runtime, the scalars being turned into tensors of one element.
+mlir::Value toDynamicTensor(mlir::ConversionPatternRewriter &rewriter,
+                            mlir::Location loc, mlir::Value value) {
+  if (!value.getType().isa<mlir::RankedTensorType>())
+    value = rewriter.create<mlir::tensor::FromElementsOp>(loc, value);
+  return rewriter.create<mlir::tensor::CastOp>(
+      loc, toDynamicTensorType(value.getType().cast<mlir::TensorType>()),
+      value);
+}
+
 struct NegOpPattern : public mlir::OpConversionPattern<TFHE::NegGLWEOp> {
 
   NegOpPattern(mlir::MLIRContext *context, mlir::TypeConverter &typeConverter)
@@ -412,40 +466,43 @@ struct EncodePlaintextWithCrtOpPattern
   }
 };
 
-struct WopPBSGLWEOpPattern
-    : public mlir::OpConversionPattern<TFHE::WopPBSGLWEOp> {
+template <typename WopPBSOp>
+struct WopPBSGLWEOpPattern : public mlir::OpConversionPattern<WopPBSOp> {
+
+  std::string funcName;
 
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
-                      mlir::TypeConverter &typeConverter)
-      : mlir::OpConversionPattern<TFHE::WopPBSGLWEOp>(
+                      mlir::TypeConverter &typeConverter, std::string funcName)
+      : mlir::OpConversionPattern<WopPBSOp>(
             typeConverter, context,
-            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        funcName(funcName) {}
 
   ::mlir::LogicalResult
-  matchAndRewrite(TFHE::WopPBSGLWEOp wopPbs,
-                  TFHE::WopPBSGLWEOp::Adaptor adaptor,
+  matchAndRewrite(WopPBSOp wopPbs, typename WopPBSOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
-    const std::string funcName = "sim_wop_pbs_crt";
-
-    auto resultType = wopPbs.getType().cast<mlir::RankedTensorType>();
-    auto inputType =
-        wopPbs.getCiphertexts().getType().cast<mlir::RankedTensorType>();
+    auto resultType = wopPbs.getType().template cast<mlir::RankedTensorType>();
+    auto inputType = wopPbs.getCiphertexts()
+                         .getType()
+                         .template cast<mlir::RankedTensorType>();
 
     mlir::Value outputBuffer =
         rewriter.create<mlir::bufferization::AllocTensorOp>(
             wopPbs.getLoc(),
             this->getTypeConverter()
                 ->convertType(resultType)
-                .cast<mlir::RankedTensorType>(),
+                .template cast<mlir::RankedTensorType>(),
             mlir::ValueRange{});
 
-    auto dynamicResultType = toDynamicTensorType(this->getTypeConverter()
-                                                     ->convertType(resultType)
-                                                     .cast<mlir::TensorType>());
-    auto dynamicInputType = toDynamicTensorType(this->getTypeConverter()
-                                                    ->convertType(inputType)
-                                                    .cast<mlir::TensorType>());
+    auto dynamicResultType = toDynamicTensorType(
+        this->getTypeConverter()
+            ->convertType(resultType)
+            .template cast<mlir::TensorType>());
+    auto dynamicInputType = toDynamicTensorType(
+        this->getTypeConverter()
+            ->convertType(inputType)
+            .template cast<mlir::TensorType>());
     auto dynamicLutType =
         toDynamicTensorType(wopPbs.getLookupTable().getType());
 
@@ -515,46 +572,46 @@ struct BootstrapGLWEOpPattern
     : public mlir::OpConversionPattern<TFHE::BootstrapGLWEOp> {
 
   bool overflowDetection;
+  uint32_t precision;
+  double pError;
+  bool enableNoise;
 
   BootstrapGLWEOpPattern(mlir::MLIRContext *context,
                          mlir::TypeConverter &typeConverter,
-                         bool overflowDetection)
+                         bool overflowDetection, uint32_t precision,
+                         double pError, bool enableNoise)
       : mlir::OpConversionPattern<TFHE::BootstrapGLWEOp>(
             typeConverter, context,
             mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
-        overflowDetection(overflowDetection) {}
+        overflowDetection(overflowDetection), precision(precision),
+        pError(pError), enableNoise(enableNoise) {}
 
   ::mlir::LogicalResult
   matchAndRewrite(TFHE::BootstrapGLWEOp bsOp,
                   TFHE::BootstrapGLWEOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
-    const std::string funcName = "sim_bootstrap_lwe_u64";
+    const std::string funcName = "sim_bootstrap_lwe_std_dev_u64";
 
     TFHE::GLWECipherTextType resultType =
         bsOp.getType().cast<TFHE::GLWECipherTextType>();
-    TFHE::GLWECipherTextType inputType =
-        bsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
 
-    auto polySize = adaptor.getKey().getPolySize();
-    auto glweDimension = adaptor.getKey().getGlweDim();
-    auto levels = adaptor.getKey().getLevels();
-    auto baseLog = adaptor.getKey().getBaseLog();
-    auto inputLweDimension =
-        inputType.getKey().getNormalized().value().dimension;
+    auto [msStdDev, brStdDev] = enableNoise
+                                    ? bootstrapStdDevs(adaptor.getKey())
+                                    : std::pair<double, double>(0, 0);
 
     auto polySizeCst = rewriter.create<mlir::arith::ConstantIntOp>(
-        bsOp.getLoc(), polySize, 32);
-    auto glweDimensionCst = rewriter.create<mlir::arith::ConstantIntOp>(
-        bsOp.getLoc(), glweDimension, 32);
-    auto levelsCst =
-        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), levels, 32);
-    auto baseLogCst =
-        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), baseLog, 32);
-    auto inputLweDimensionCst = rewriter.create<mlir::arith::ConstantIntOp>(
-        bsOp.getLoc(), inputLweDimension, 32);
+        bsOp.getLoc(), adaptor.getKey().getPolySize(), 32);
+    auto msStdDevCst = rewriter.create<mlir::arith::ConstantFloatOp>(
+        bsOp.getLoc(), llvm::APFloat(msStdDev), rewriter.getF64Type());
+    auto brStdDevCst = rewriter.create<mlir::arith::ConstantFloatOp>(
+        bsOp.getLoc(), llvm::APFloat(brStdDev), rewriter.getF64Type());
     auto overflowDetectionCst = rewriter.create<mlir::arith::ConstantIntOp>(
         bsOp.getLoc(), overflowDetection, 1);
+    auto precisionCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), precision, 32);
+    auto pErrorCst = rewriter.create<mlir::arith::ConstantFloatOp>(
+        bsOp.getLoc(), llvm::APFloat(pError), rewriter.getF64Type());
 
     auto dynamicLutType = toDynamicTensorType(bsOp.getLookupTable().getType());
 
@@ -563,18 +620,18 @@ struct BootstrapGLWEOpPattern
 
     auto locString = globalStringValueFromLoc(rewriter, bsOp.getLoc());
 
-    // uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t
+    // uint64_t sim_bootstrap_lwe_std_dev_u64(uint64_t plaintext, uint64_t
     // *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t
-    // tlu_size, uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t
-    // poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim, bool
-    // overflow_detection, char* loc)
+    // tlu_size, uint64_t tlu_stride, uint32_t poly_size, double ms_std_dev,
+    // double br_std_dev, bool overflow_detection, uint32_t precision, double
+    // p_error, char* loc)
     if (insertForwardDeclaration(
             bsOp, rewriter, funcName,
             rewriter.getFunctionType(
                 {rewriter.getIntegerType(64), dynamicLutType,
-                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
-                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
-                 rewriter.getIntegerType(32), rewriter.getIntegerType(1),
+                 rewriter.getIntegerType(32), rewriter.getF64Type(),
+                 rewriter.getF64Type(), rewriter.getIntegerType(1),
+                 rewriter.getIntegerType(32), rewriter.getF64Type(),
                  mlir::LLVM::LLVMPointerType::get(rewriter.getI8Type())},
                 {rewriter.getIntegerType(64)}))
             .failed()) {
@@ -583,10 +640,9 @@ struct BootstrapGLWEOpPattern
 
     rewriter.replaceOpWithNewOp<mlir::func::CallOp>(
         bsOp, funcName, this->getTypeConverter()->convertType(resultType),
-        mlir::ValueRange({adaptor.getCiphertext(), castedLUT,
-                          inputLweDimensionCst, polySizeCst, levelsCst,
-                          baseLogCst, glweDimensionCst, overflowDetectionCst,
-                          locString}));
+        mlir::ValueRange({adaptor.getCiphertext(), castedLUT, polySizeCst,
+                          msStdDevCst, brStdDevCst, overflowDetectionCst,
+                          precisionCst, pErrorCst, locString}));
 
     return mlir::success();
   }
@@ -606,35 +662,21 @@ struct KeySwitchGLWEOpPattern
                   TFHE::KeySwitchGLWEOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
-    const std::string funcName = "sim_keyswitch_lwe_u64";
+    const std::string funcName = "sim_keyswitch_lwe_std_dev_u64";
 
     TFHE::GLWECipherTextType resultType =
         ksOp.getType().cast<TFHE::GLWECipherTextType>();
-    TFHE::GLWECipherTextType inputType =
-        ksOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
-
-    auto levels = adaptor.getKey().getLevels();
-    auto baseLog = adaptor.getKey().getBaseLog();
-    auto inputDim = inputType.getKey().getNormalized().value().dimension;
-    auto outputDim = resultType.getKey().getNormalized().value().dimension;
-
-    mlir::Value levelCst =
-        rewriter.create<mlir::arith::ConstantIntOp>(ksOp.getLoc(), levels, 32);
-    mlir::Value baseLogCst =
-        rewriter.create<mlir::arith::ConstantIntOp>(ksOp.getLoc(), baseLog, 32);
-    mlir::Value inputDimCst = rewriter.create<mlir::arith::ConstantIntOp>(
-        ksOp.getLoc(), inputDim, 32);
-    mlir::Value outputDimCst = rewriter.create<mlir::arith::ConstantIntOp>(
-        ksOp.getLoc(), outputDim, 32);
-
-    // uint64_t sim_keyswitch_lwe_u64(uint64_t plaintext, uint32_t level,
-    // uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim)
+
+    mlir::Value stdDevCst = rewriter.create<mlir::arith::ConstantFloatOp>(
+        ksOp.getLoc(), llvm::APFloat(keyswitchStdDev(adaptor.getKey())),
+        rewriter.getF64Type());
+
+    // uint64_t sim_keyswitch_lwe_std_dev_u64(uint64_t plaintext, double
+    // std_dev)
     if (insertForwardDeclaration(
             ksOp, rewriter, funcName,
             rewriter.getFunctionType(
-                {rewriter.getIntegerType(64), rewriter.getIntegerType(32),
-                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
-                 rewriter.getIntegerType(32)},
+                {rewriter.getIntegerType(64), rewriter.getF64Type()},
                 {rewriter.getIntegerType(64)}))
             .failed()) {
       return mlir::failure();
@@ -642,13 +684,218 @@ struct KeySwitchGLWEOpPattern
 
     rewriter.replaceOpWithNewOp<mlir::func::CallOp>(
         ksOp, funcName, this->getTypeConverter()->convertType(resultType),
-        mlir::ValueRange({adaptor.getCiphertext(), levelCst, baseLogCst,
-                          inputDimCst, outputDimCst}));
+        mlir::ValueRange({adaptor.getCiphertext(), stdDevCst}));
 
     return mlir::success();
   }
 };
 
+/// Lowers a batched arithmetic operation to a call to `funcName`, one of the
+/// `sim_batched_*` functions of the runtime, with its scalar operand
+/// broadcast.
+template <typename BatchedOp>
+struct BatchedArithOpPattern : public mlir::OpConversionPattern<BatchedOp> {
+
+  std::string funcName;
+  bool overflowDetection;
+
+  BatchedArithOpPattern(mlir::MLIRContext *context,
+                        mlir::TypeConverter &typeConverter,
+                        std::string funcName, bool overflowDetection)
+      : mlir::OpConversionPattern<BatchedOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        funcName(funcName), overflowDetection(overflowDetection) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(BatchedOp op, typename BatchedOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    auto resultType = this->getTypeConverter()
+                          ->convertType(op.getResult().getType())
+                          .template cast<mlir::RankedTensorType>();
+    mlir::Value outputBuffer =
+        rewriter.create<mlir::bufferization::AllocTensorOp>(
+            op.getLoc(), resultType, mlir::ValueRange{});
+
+    llvm::SmallVector<mlir::Value> operands{
+        toDynamicTensor(rewriter, op.getLoc(), outputBuffer)};
+    for (mlir::Value operand : adaptor.getOperands())
+      operands.push_back(toDynamicTensor(rewriter, op.getLoc(), operand));
+
+    // the binary operations check the overflows as their scalar versions
+    if (operands.size() == 3) {
+      auto signedAttr = op->template getAttrOfType<mlir::BoolAttr>("signed");
+      bool isSigned = signedAttr && signedAttr.getValue();
+      operands.push_back(globalStringValueFromLoc(rewriter, op.getLoc()));
+      operands.push_back(rewriter.create<mlir::arith::ConstantIntOp>(
+          op.getLoc(), isSigned, 1));
+      operands.push_back(rewriter.create<mlir::arith::ConstantIntOp>(
+          op.getLoc(), overflowDetection, 1));
+    }
+
+    if (insertForwardDeclaration(
+            op, rewriter, funcName,
+            rewriter.getFunctionType(
+                mlir::TypeRange(mlir::ValueRange(operands)), {}))
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.create<mlir::func::CallOp>(op.getLoc(), funcName,
+                                        mlir::TypeRange{}, operands);
+
+    rewriter.replaceOp(op, outputBuffer);
+
+    return mlir::success();
+  }
+};
+
+struct BatchedKeySwitchGLWEOpPattern
+    : public mlir::OpConversionPattern<TFHE::BatchedKeySwitchGLWEOp> {
+
+  BatchedKeySwitchGLWEOpPattern(mlir::MLIRContext *context,
+                                mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::BatchedKeySwitchGLWEOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::BatchedKeySwitchGLWEOp ksOp,
+                  TFHE::BatchedKeySwitchGLWEOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    const std::string funcName = "sim_batched_keyswitch_lwe_u64";
+
+    auto resultType = this->getTypeConverter()
+                          ->convertType(ksOp.getResult().getType())
+                          .cast<mlir::RankedTensorType>();
+    mlir::Value outputBuffer =
+        rewriter.create<mlir::bufferization::AllocTensorOp>(
+            ksOp.getLoc(), resultType, mlir::ValueRange{});
+
+    mlir::Value castedOutputBuffer =
+        toDynamicTensor(rewriter, ksOp.getLoc(), outputBuffer);
+    mlir::Value castedCiphertexts =
+        toDynamicTensor(rewriter, ksOp.getLoc(), adaptor.getCiphertexts());
+    mlir::Value stdDevCst = rewriter.create<mlir::arith::ConstantFloatOp>(
+        ksOp.getLoc(), llvm::APFloat(keyswitchStdDev(adaptor.getKey())),
+        rewriter.getF64Type());
+
+    if (insertForwardDeclaration(
+            ksOp, rewriter, funcName,
+            rewriter.getFunctionType({castedOutputBuffer.getType(),
+                                      castedCiphertexts.getType(),
+                                      rewriter.getF64Type()},
+                                     {}))
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.create<mlir::func::CallOp>(
+        ksOp.getLoc(), funcName, mlir::TypeRange{},
+        mlir::ValueRange({castedOutputBuffer, castedCiphertexts, stdDevCst}));
+
+    rewriter.replaceOp(ksOp, outputBuffer);
+
+    return mlir::success();
+  }
+};
+
+/// Lowers a batched bootstrap, with a single lookup table or with one per
+/// ciphertext, to a call to `funcName`.
+template <typename BatchedOp>
+struct BatchedBootstrapGLWEOpPattern
+    : public mlir::OpConversionPattern<BatchedOp> {
+
+  std::string funcName;
+  bool overflowDetection;
+  uint32_t precision;
+  double pError;
+  bool enableNoise;
+
+  BatchedBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                                mlir::TypeConverter &typeConverter,
+                                std::string funcName, bool overflowDetection,
+                                uint32_t precision, double pError,
+                                bool enableNoise)
+      : mlir::OpConversionPattern<BatchedOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        funcName(funcName), overflowDetection(overflowDetection),
+        precision(precision), pError(pError), enableNoise(enableNoise) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(BatchedOp bsOp, typename BatchedOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    auto resultType = this->getTypeConverter()
+                          ->convertType(bsOp.getResult().getType())
+                          .template cast<mlir::RankedTensorType>();
+    mlir::Value outputBuffer =
+        rewriter.create<mlir::bufferization::AllocTensorOp>(
+            bsOp.getLoc(), resultType, mlir::ValueRange{});
+
+    auto [msStdDev, brStdDev] = enableNoise
+                                    ? bootstrapStdDevs(adaptor.getKey())
+                                    : std::pair<double, double>(0, 0);
+
+    llvm::SmallVector<mlir::Value> operands{
+        toDynamicTensor(rewriter, bsOp.getLoc(), outputBuffer),
+        toDynamicTensor(rewriter, bsOp.getLoc(), adaptor.getCiphertexts()),
+        toDynamicTensor(rewriter, bsOp.getLoc(), adaptor.getLookupTable()),
+        rewriter.create<mlir::arith::ConstantIntOp>(
+            bsOp.getLoc(), adaptor.getKey().getPolySize(), 32),
+        rewriter.create<mlir::arith::ConstantFloatOp>(
+            bsOp.getLoc(), llvm::APFloat(msStdDev), rewriter.getF64Type()),
+        rewriter.create<mlir::arith::ConstantFloatOp>(
+            bsOp.getLoc(), llvm::APFloat(brStdDev), rewriter.getF64Type()),
+        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(),
+                                                    overflowDetection, 1),
+        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), precision,
+                                                    32),
+        rewriter.create<mlir::arith::ConstantFloatOp>(
+            bsOp.getLoc(), llvm::APFloat(pError), rewriter.getF64Type()),
+        globalStringValueFromLoc(rewriter, bsOp.getLoc())};
+
+    if (insertForwardDeclaration(
+            bsOp, rewriter, funcName,
+            rewriter.getFunctionType(
+                mlir::TypeRange(mlir::ValueRange(operands)), {}))
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.create<mlir::func::CallOp>(bsOp.getLoc(), funcName,
+                                        mlir::TypeRange{}, operands);
+
+    rewriter.replaceOp(bsOp, outputBuffer);
+
+    return mlir::success();
+  }
+};
+
+/// Removes a keyswitch, scalar or batched, when simulating without noise: the
+/// plaintext is the same under both keys.
+template <typename KeySwitchOp>
+struct NoiselessKeySwitchOpPattern
+    : public mlir::OpConversionPattern<KeySwitchOp> {
+
+  NoiselessKeySwitchOpPattern(mlir::MLIRContext *context,
+                              mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<KeySwitchOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(KeySwitchOp ksOp, typename KeySwitchOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    // the ciphertext, or the batch of them, is the first operand
+    rewriter.replaceOp(ksOp, adaptor.getOperands().front());
+    return mlir::success();
+  }
+};
+
 struct ZeroOpPattern : public mlir::OpConversionPattern<TFHE::ZeroGLWEOp> {
   ZeroOpPattern(mlir::MLIRContext *context, mlir::TypeConverter &typeConverter)
       : mlir::OpConversionPattern<TFHE::ZeroGLWEOp>(
@@ -720,8 +967,13 @@ struct TraceCiphertextOpPattern
 
 struct SimulateTFHEPass : public SimulateTFHEBase<SimulateTFHEPass> {
   bool enableOverflowDetection;
-  SimulateTFHEPass(bool enableOverflowDetection)
-      : enableOverflowDetection(enableOverflowDetection) {}
+  uint32_t precision;
+  double pError;
+  bool enableNoise;
+  SimulateTFHEPass(bool enableOverflowDetection, uint32_t precision,
+                   double pError, bool enableNoise)
+      : enableOverflowDetection(enableOverflowDetection), precision(precision),
+        pError(pError), enableNoise(enableNoise) {}
 
   void runOnOperation() final;
 };
@@ -764,6 +1016,10 @@ void SimulateTFHEPass::runOnOperation() {
                       mlir::tensor::ExpandShapeOp>,
                   mlir::concretelang::TypeConvertingReinstantiationPattern<
                       mlir::tensor::CollapseShapeOp>,
+                  mlir::concretelang::TypeConvertingReinstantiationPattern<
+                      mlir::tensor::GatherOp, true>,
+                  mlir::concretelang::TypeConvertingReinstantiationPattern<
+                      mlir::tensor::ScatterOp, true>,
                   mlir::concretelang::TypeConvertingReinstantiationPattern<
                       mlir::tensor::YieldOp>,
                   mlir::concretelang::TypeConvertingReinstantiationPattern<
@@ -775,6 +1031,7 @@ void SimulateTFHEPass::runOnOperation() {
       mlir::tensor::InsertOp, mlir::tensor::InsertSliceOp,
       mlir::tensor::ParallelInsertSliceOp, mlir::tensor::FromElementsOp,
       mlir::tensor::ExpandShapeOp, mlir::tensor::CollapseShapeOp,
+      mlir::tensor::GatherOp, mlir::tensor::ScatterOp,
       mlir::bufferization::AllocTensorOp, mlir::tensor::EmptyOp,
       Tracing::TraceCiphertextOp>([&](mlir::Operation *op) {
     return converter.isLegal(op->getResultTypes()) &&
@@ -806,11 +1063,51 @@ void SimulateTFHEPass::runOnOperation() {
         return converter.isLegal(forallOp.getResults().getTypes());
       });
 
-  patterns.insert<EncodeExpandLutForBootstrapOpPattern, BootstrapGLWEOpPattern>(
+  patterns.insert<EncodeExpandLutForBootstrapOpPattern>(
       &getContext(), converter, enableOverflowDetection);
+  patterns.insert<BootstrapGLWEOpPattern>(&getContext(), converter,
+                                          enableOverflowDetection, precision,
+                                          pError, enableNoise);
+  patterns.insert<
+      BatchedBootstrapGLWEOpPattern<TFHE::BatchedBootstrapGLWEOp>>(
+      &getContext(), converter, "sim_batched_bootstrap_lwe_u64",
+      enableOverflowDetection, precision, pError, enableNoise);
+  patterns.insert<
+      BatchedBootstrapGLWEOpPattern<TFHE::BatchedMappedBootstrapGLWEOp>>(
+      &getContext(), converter, "sim_batched_mapped_bootstrap_lwe_u64",
+      enableOverflowDetection, precision, pError, enableNoise);
+  if (enableNoise) {
+    patterns.insert<KeySwitchGLWEOpPattern, BatchedKeySwitchGLWEOpPattern>(
+        &getContext(), converter);
+  } else {
+    patterns.insert<NoiselessKeySwitchOpPattern<TFHE::KeySwitchGLWEOp>,
+                    NoiselessKeySwitchOpPattern<TFHE::BatchedKeySwitchGLWEOp>>(
+        &getContext(), converter);
+  }
 
-  patterns.insert<ZeroOpPattern, ZeroTensorOpPattern, KeySwitchGLWEOpPattern,
-                  WopPBSGLWEOpPattern, EncodeLutForCrtWopPBSOpPattern,
+  // the operations batched by the batching pass, checking the overflows only
+  // if the detection is enabled
+  patterns.insert<BatchedArithOpPattern<TFHE::BatchedNegGLWEOp>>(
+      &getContext(), converter, "sim_batched_neg_lwe_u64",
+      enableOverflowDetection);
+  patterns.insert<BatchedArithOpPattern<TFHE::ABatchedAddGLWEOp>,
+                  BatchedArithOpPattern<TFHE::ABatchedAddGLWEIntOp>,
+                  BatchedArithOpPattern<TFHE::ABatchedAddGLWEIntCstOp>,
+                  BatchedArithOpPattern<TFHE::ABatchedAddGLWECstIntOp>>(
+      &getContext(), converter, "sim_batched_add_lwe_u64",
+      enableOverflowDetection);
+  patterns.insert<BatchedArithOpPattern<TFHE::BatchedMulGLWEIntOp>,
+                  BatchedArithOpPattern<TFHE::BatchedMulGLWEIntCstOp>,
+                  BatchedArithOpPattern<TFHE::BatchedMulGLWECstIntOp>>(
+      &getContext(), converter, "sim_batched_mul_lwe_u64",
+      enableOverflowDetection);
+
+  patterns.insert<WopPBSGLWEOpPattern<TFHE::WopPBSGLWEOp>>(
+      &getContext(), converter, "sim_wop_pbs_crt");
+  patterns.insert<WopPBSGLWEOpPattern<TFHE::BatchedWopPBSGLWEOp>>(
+      &getContext(), converter, "sim_batched_wop_pbs_crt");
+  patterns.insert<ZeroOpPattern, ZeroTensorOpPattern,
+                  EncodeLutForCrtWopPBSOpPattern,
                   EncodePlaintextWithCrtOpPattern, NegOpPattern,
                   TraceCiphertextOpPattern>(&getContext(), converter);
   patterns.insert<SubIntGLWEOpPattern>(&getContext());
@@ -874,8 +1171,10 @@ void SimulateTFHEPass::runOnOperation() {
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<OperationPass<ModuleOp>>
-createSimulateTFHEPass(bool enableOverflowDetection) {
-  return std::make_unique<SimulateTFHEPass>(enableOverflowDetection);
+createSimulateTFHEPass(bool enableOverflowDetection, uint32_t precision,
+                       double pError, bool enableNoise) {
+  return std::make_unique<SimulateTFHEPass>(enableOverflowDetection, precision,
+                                            pError, enableNoise);
 }
 } // namespace concretelang
 } // namespace mlir
@@ -156,7 +156,7 @@ struct BootstrapGLWEOpPattern
     auto bootstrapKey = TFHE::GLWEBootstrapKeyAttr::get(
         bsOp->getContext(), newInputKey, newOutputKey,
         cryptoParameters.getPolynomialSize(), cryptoParameters.glweDimension,
-        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1);
+        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1, 0);
     auto newOp = rewriter.replaceOpWithNewOp<TFHE::BootstrapGLWEOp>(
         bsOp, newOutputTy, bsOp.getCiphertext(), bsOp.getLookupTable(),
         bootstrapKey);
@@ -197,7 +197,7 @@ struct WopPBSGLWEOpPattern : public mlir::OpRewritePattern<TFHE::WopPBSGLWEOp> {
     auto bootstrapKey = TFHE::GLWEBootstrapKeyAttr::get(
         wopPBSOp->getContext(), intraKey, interKey,
         cryptoParameters.getPolynomialSize(), cryptoParameters.glweDimension,
-        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1);
+        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1, 0);
     auto packingKeyswitchKey = TFHE::GLWEPackingKeyswitchKeyAttr::get(
         wopPBSOp->getContext(), interKey, interKey,
         cryptoParameters.largeInteger->wopPBS.packingKeySwitch
@@ -259,6 +259,20 @@ void populateWithTFHEOpTypeConversionPatterns(
       patterns, target, typeConverter);
   populateWithTFHEOpTypeConversionPattern<
       mlir::concretelang::TFHE::MulGLWEIntOp>(patterns, target, typeConverter);
+  // Batched leveled operations, as emitted on the blocks of crt encoded
+  // integers
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::ABatchedAddGLWEIntOp>(patterns, target,
+                                                      typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::ABatchedAddGLWEOp>(patterns, target,
+                                                   typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::BatchedNegGLWEOp>(patterns, target,
+                                                  typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::BatchedMulGLWEIntCstOp>(patterns, target,
+                                                        typeConverter);
 }
 
 void TFHEGlobalParametrizationPass::runOnOperation() {
@@ -51,7 +51,8 @@ public:
         bsk.getContext(), convertSecretKey(bsk.getInputKey()),
         convertSecretKey(bsk.getOutputKey()), bsk.getPolySize(),
         bsk.getGlweDim(), bsk.getLevels(), bsk.getBaseLog(),
-        circuitKeys.getBootstrapKeyIndex(bsk).value());
+        circuitKeys.getBootstrapKeyIndex(bsk).value(),
+        bsk.getGroupingFactor());
   }
 
   TFHE::GLWEKeyswitchKeyAttr
@@ -204,6 +205,37 @@ private:
   conversion::TypeConverter &typeConverter;
 };
 
+struct ManyLutBootstrapGLWEOpPattern
+    : public mlir::OpRewritePattern<TFHE::ManyLutBootstrapGLWEOp> {
+  ManyLutBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                                conversion::TypeConverter &typeConverter,
+                                conversion::KeyConverter &keyConverter,
+                                mlir::PatternBenefit benefit =
+                                    mlir::concretelang::DEFAULT_PATTERN_BENEFIT)
+      : mlir::OpRewritePattern<TFHE::ManyLutBootstrapGLWEOp>(context, benefit),
+        keyConverter(keyConverter), typeConverter(typeConverter) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyLutBootstrapGLWEOp bsOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    auto newInputTy = typeConverter.convertType(bsOp.getCiphertext().getType())
+                          .cast<GLWECipherTextType>();
+    auto newOutputTy = typeConverter.convertType(bsOp.getResult().getType());
+    auto newBootstrapKey = keyConverter.convertBootstrapKey(bsOp.getKeyAttr());
+    auto newOp = rewriter.replaceOpWithNewOp<TFHE::ManyLutBootstrapGLWEOp>(
+        bsOp, newOutputTy, bsOp.getCiphertext(), bsOp.getLookupTable(),
+        newBootstrapKey, bsOp.getLutCount(), bsOp.getLutStride());
+    rewriter.startRootUpdate(newOp);
+    newOp.getCiphertext().setType(newInputTy);
+    rewriter.finalizeRootUpdate(newOp);
+    return mlir::success();
+  };
+
+private:
+  conversion::KeyConverter &keyConverter;
+  conversion::TypeConverter &typeConverter;
+};
+
 struct WopPBSGLWEOpPattern : public mlir::OpRewritePattern<TFHE::WopPBSGLWEOp> {
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
                       conversion::TypeConverter &typeConverter,
@@ -280,6 +312,20 @@ void populateWithTFHEOpTypeConversionPatterns(
       patterns, target, typeConverter);
   populateWithTFHEOpTypeConversionPattern<
       mlir::concretelang::TFHE::MulGLWEIntOp>(patterns, target, typeConverter);
+  // Batched leveled operations, as emitted on the blocks of crt encoded
+  // integers
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::ABatchedAddGLWEIntOp>(patterns, target,
+                                                      typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::ABatchedAddGLWEOp>(patterns, target,
+                                                   typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::BatchedNegGLWEOp>(patterns, target,
+                                                  typeConverter);
+  populateWithTFHEOpTypeConversionPattern<
+      mlir::concretelang::TFHE::BatchedMulGLWEIntCstOp>(patterns, target,
+                                                        typeConverter);
 }
 } // namespace
 
@@ -341,6 +387,15 @@ void TFHEKeyNormalizationPass::runOnOperation() {
                  op.getKeyAttr().getIndex() != -1;
         });
 
+    patterns.add<patterns::ManyLutBootstrapGLWEOpPattern>(
+        &getContext(), typeConverter, keyConverter);
+    target.addDynamicallyLegalOp<TFHE::ManyLutBootstrapGLWEOp>(
+        [&](TFHE::ManyLutBootstrapGLWEOp op) {
+          return op.getKeyAttr().getInputKey().isNormalized() &&
+                 op.getKeyAttr().getOutputKey().isNormalized() &&
+                 op.getKeyAttr().getIndex() != -1;
+        });
+
     // Parametrize wop pbs
     patterns.add<patterns::WopPBSGLWEOpPattern>(&getContext(), typeConverter,
                                                 keyConverter);
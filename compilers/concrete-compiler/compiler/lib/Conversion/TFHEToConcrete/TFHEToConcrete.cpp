@@ -145,17 +145,17 @@ struct BootstrapGLWEOpPattern
   }
 };
 
-struct WopPBSGLWEOpPattern
-    : public mlir::OpConversionPattern<TFHE::WopPBSGLWEOp> {
+template <typename WopPBSOp, typename ConcreteWopPBSOp>
+struct WopPBSGLWEOpPattern : public mlir::OpConversionPattern<WopPBSOp> {
 
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
                       mlir::TypeConverter &typeConverter)
-      : mlir::OpConversionPattern<TFHE::WopPBSGLWEOp>(
+      : mlir::OpConversionPattern<WopPBSOp>(
             typeConverter, context,
             mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
 
   ::mlir::LogicalResult
-  matchAndRewrite(TFHE::WopPBSGLWEOp op, TFHE::WopPBSGLWEOp::Adaptor adaptor,
+  matchAndRewrite(WopPBSOp op, typename WopPBSOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
     auto bsBaseLog = adaptor.getBsk().getBaseLog();
@@ -174,7 +174,7 @@ struct WopPBSGLWEOpPattern
     auto bskIndex = op.getBskAttr().getIndex();
     auto pkskIndex = op.getPkskAttr().getIndex();
 
-    rewriter.replaceOpWithNewOp<Concrete::WopPBSCRTLweTensorOp>(
+    rewriter.replaceOpWithNewOp<ConcreteWopPBSOp>(
         op, this->getTypeConverter()->convertType(resultType),
         adaptor.getCiphertexts(), adaptor.getLookupTable(), bsLevels, bsBaseLog,
         ksLevels, ksBaseLog, pksInnerLweDim, pksOutputPolySize, pksLevels,
@@ -259,6 +259,40 @@ struct BatchedMappedBootstrapGLWEOpPattern
   }
 };
 
+struct ManyLutBootstrapGLWEOpPattern
+    : public mlir::OpConversionPattern<TFHE::ManyLutBootstrapGLWEOp> {
+
+  ManyLutBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                                mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::ManyLutBootstrapGLWEOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyLutBootstrapGLWEOp mlbsOp,
+                  TFHE::ManyLutBootstrapGLWEOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    TFHE::GLWECipherTextType inputType =
+        mlbsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
+
+    auto polySize = adaptor.getKey().getPolySize();
+    auto glweDimension = adaptor.getKey().getGlweDim();
+    auto levels = adaptor.getKey().getLevels();
+    auto baseLog = adaptor.getKey().getBaseLog();
+    auto inputLweDimension =
+        inputType.getKey().getNormalized().value().dimension;
+    auto bskIndex = mlbsOp.getKeyAttr().getIndex();
+
+    rewriter.replaceOpWithNewOp<Concrete::ManyLutBootstrapLweTensorOp>(
+        mlbsOp, this->getTypeConverter()->convertType(mlbsOp.getType()),
+        adaptor.getCiphertext(), adaptor.getLookupTable(),
+        adaptor.getLutCount(), adaptor.getLutStride(), inputLweDimension,
+        polySize, levels, baseLog, glweDimension, bskIndex);
+
+    return mlir::success();
+  }
+};
+
 struct KeySwitchGLWEOpPattern
     : public mlir::OpConversionPattern<TFHE::KeySwitchGLWEOp> {
 
@@ -706,6 +740,178 @@ struct FromElementsOpPattern
   };
 };
 
+/// Returns whether `type` is a static tensor of 64-bits words, i.e. a tensor
+/// of lwe ciphertexts once converted, or of simulated ciphertexts.
+bool isStaticWordTensor(mlir::Type type) {
+  auto tensorType = type.dyn_cast<mlir::RankedTensorType>();
+  return tensorType && tensorType.hasStaticShape() &&
+         tensorType.getRank() > 0 &&
+         tensorType.getElementType().isInteger(64);
+}
+
+/// Reshapes the tensor of words `value` to a 2D tensor, whose rows are the
+/// elements along its first dimension.
+mlir::Value reshapeToRows(mlir::OpBuilder &builder, mlir::Location loc,
+                          mlir::Value value) {
+  auto type = value.getType().cast<mlir::RankedTensorType>();
+  if (type.getRank() == 2)
+    return value;
+
+  auto rowSize = mlir::ShapedType::getNumElements(type.getShape().drop_front());
+  auto rowsType = mlir::RankedTensorType::get({type.getDimSize(0), rowSize},
+                                              type.getElementType());
+  if (type.getRank() == 1) {
+    mlir::ReassociationIndices all{0, 1};
+    return builder.create<mlir::tensor::ExpandShapeOp>(
+        loc, rowsType, value, llvm::ArrayRef<mlir::ReassociationIndices>{all});
+  }
+  mlir::ReassociationIndices first{0}, rest;
+  for (int64_t i = 1; i < type.getRank(); i++)
+    rest.push_back(i);
+  return builder.create<mlir::tensor::CollapseShapeOp>(
+      loc, rowsType, value,
+      llvm::ArrayRef<mlir::ReassociationIndices>{first, rest});
+}
+
+/// Reshapes the 2D tensor of rows `rows` to `type`, the inverse of
+/// `reshapeToRows`.
+mlir::Value reshapeFromRows(mlir::OpBuilder &builder, mlir::Location loc,
+                            mlir::Value rows, mlir::RankedTensorType type) {
+  if (type.getRank() == 2)
+    return rows;
+
+  if (type.getRank() == 1) {
+    mlir::ReassociationIndices all{0, 1};
+    return builder.create<mlir::tensor::CollapseShapeOp>(
+        loc, type, rows, llvm::ArrayRef<mlir::ReassociationIndices>{all});
+  }
+  mlir::ReassociationIndices first{0}, rest;
+  for (int64_t i = 1; i < type.getRank(); i++)
+    rest.push_back(i);
+  return builder.create<mlir::tensor::ExpandShapeOp>(
+      loc, type, rows, llvm::ArrayRef<mlir::ReassociationIndices>{first, rest});
+}
+
+/// Returns the positions of a `tensor.gather` or `tensor.scatter` along the
+/// single dimension 0 of its tensor of words, as a 1D tensor, or nullptr if
+/// the op, of dimensions `dims`, does not have this form.
+mlir::Value getRowPositions(mlir::OpBuilder &builder, mlir::Location loc,
+                            llvm::ArrayRef<int64_t> dims,
+                            mlir::Value indices) {
+  auto indicesType = indices.getType().cast<mlir::RankedTensorType>();
+  if (dims.size() != 1 || dims[0] != 0 || indicesType.getRank() != 2 ||
+      indicesType.getDimSize(1) != 1 ||
+      !indicesType.getElementType().isInteger(64))
+    return nullptr;
+  mlir::ReassociationIndices all{0, 1};
+  return builder.create<mlir::tensor::CollapseShapeOp>(
+      loc, indices, llvm::ArrayRef<mlir::ReassociationIndices>{all});
+}
+
+/// Rewrites the `tensor.gather` of ciphertexts, generated by the lowering of
+/// `FHELinalg.fancy_index`, to a `Concrete.gather_lwe_tensor` of the rows of
+/// words of the ciphertexts, with the CRT blocks of a ciphertext in the same
+/// row.
+///
+/// Example:
+///
+/// ```mlir
+/// %0 = tensor.gather %arg0[%arg1] gather_dims([0])
+///        : (tensor<5x!TFHE.glwe<sk[1]<1,2048>>>, tensor<3x1xi64>)
+///          -> tensor<3x!TFHE.glwe<sk[1]<1,2048>>>
+/// ```
+///
+/// becomes:
+///
+/// ```mlir
+/// %positions = tensor.collapse_shape %arg1 [[0, 1]]
+///                : tensor<3x1xi64> into tensor<3xi64>
+/// %0 = "Concrete.gather_lwe_tensor"(%arg0, %positions)
+///        : (tensor<5x2049xi64>, tensor<3xi64>) -> tensor<3x2049xi64>
+/// ```
+struct GatherOpPattern
+    : public mlir::OpConversionPattern<mlir::tensor::GatherOp> {
+  GatherOpPattern(mlir::MLIRContext *context,
+                  mlir::TypeConverter &typeConverter)
+      : ::mlir::OpConversionPattern<mlir::tensor::GatherOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(mlir::tensor::GatherOp gatherOp,
+                  mlir::tensor::GatherOp::Adaptor adaptor,
+                  ::mlir::ConversionPatternRewriter &rewriter) const override {
+    auto resultType = this->getTypeConverter()
+                          ->convertType(gatherOp.getType())
+                          .cast<mlir::RankedTensorType>();
+    auto sourceType =
+        adaptor.getSource().getType().cast<mlir::RankedTensorType>();
+    // Only the rank-reduced form moves whole rows
+    if (!isStaticWordTensor(resultType) || !isStaticWordTensor(sourceType) ||
+        resultType.getRank() != sourceType.getRank())
+      return mlir::failure();
+
+    auto loc = gatherOp.getLoc();
+    auto positions = getRowPositions(rewriter, loc, gatherOp.getGatherDims(),
+                                     adaptor.getIndices());
+    if (positions == nullptr)
+      return mlir::failure();
+
+    auto source = reshapeToRows(rewriter, loc, adaptor.getSource());
+    auto rowsType = mlir::RankedTensorType::get(
+        {resultType.getDimSize(0),
+         source.getType().cast<mlir::RankedTensorType>().getDimSize(1)},
+        resultType.getElementType());
+    mlir::Value rows = rewriter.create<Concrete::GatherLweTensorOp>(
+        loc, rowsType, source, positions);
+
+    rewriter.replaceOp(gatherOp,
+                       reshapeFromRows(rewriter, loc, rows, resultType));
+    return ::mlir::success();
+  };
+};
+
+/// Rewrites the `tensor.scatter` of ciphertexts, generated by the lowering of
+/// `FHELinalg.fancy_assign`, to a `Concrete.scatter_lwe_tensor` of the rows
+/// of words of the ciphertexts, as `GatherOpPattern`.
+struct ScatterOpPattern
+    : public mlir::OpConversionPattern<mlir::tensor::ScatterOp> {
+  ScatterOpPattern(mlir::MLIRContext *context,
+                   mlir::TypeConverter &typeConverter)
+      : ::mlir::OpConversionPattern<mlir::tensor::ScatterOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(mlir::tensor::ScatterOp scatterOp,
+                  mlir::tensor::ScatterOp::Adaptor adaptor,
+                  ::mlir::ConversionPatternRewriter &rewriter) const override {
+    auto resultType = this->getTypeConverter()
+                          ->convertType(scatterOp.getType())
+                          .cast<mlir::RankedTensorType>();
+    auto sourceType =
+        adaptor.getSource().getType().cast<mlir::RankedTensorType>();
+    if (!isStaticWordTensor(resultType) || !isStaticWordTensor(sourceType) ||
+        resultType.getRank() != sourceType.getRank())
+      return mlir::failure();
+
+    auto loc = scatterOp.getLoc();
+    auto positions = getRowPositions(rewriter, loc, scatterOp.getScatterDims(),
+                                     adaptor.getIndices());
+    if (positions == nullptr)
+      return mlir::failure();
+
+    auto dest = reshapeToRows(rewriter, loc, adaptor.getDest());
+    auto values = reshapeToRows(rewriter, loc, adaptor.getSource());
+    mlir::Value rows = rewriter.create<Concrete::ScatterLweTensorOp>(
+        loc, dest.getType(), dest, values, positions);
+
+    rewriter.replaceOp(scatterOp,
+                       reshapeFromRows(rewriter, loc, rows, resultType));
+    return ::mlir::success();
+  };
+};
+
 // This template rewrite pattern transforms any instance of
 // `ShapeOp` operators that operates on tensor of lwe ciphertext by adding
 // the lwe size as a size of the tensor result and by adding a trivial
@@ -866,6 +1072,11 @@ void TFHEToConcretePass::runOnOperation() {
           mlir::concretelang::TFHE::EncodeExpandLutForBootstrapOp,
           mlir::concretelang::Concrete::EncodeExpandLutForBootstrapTensorOp,
           true>,
+      mlir::concretelang::GenericOneToOneOpConversionPattern<
+          mlir::concretelang::TFHE::EncodeExpandManyLutForBootstrapOp,
+          mlir::concretelang::Concrete::
+              EncodeExpandManyLutForBootstrapTensorOp,
+          true>,
       mlir::concretelang::GenericOneToOneOpConversionPattern<
           mlir::concretelang::TFHE::EncodeLutForCrtWopPBSOp,
           mlir::concretelang::Concrete::EncodeLutForCrtWopPBSTensorOp, true>,
@@ -899,8 +1110,13 @@ void TFHEToConcretePass::runOnOperation() {
                   ZeroOpPattern<mlir::concretelang::TFHE::ZeroTensorGLWEOp>,
                   SubIntGLWEOpPattern, BootstrapGLWEOpPattern,
                   BatchedBootstrapGLWEOpPattern,
-                  BatchedMappedBootstrapGLWEOpPattern, KeySwitchGLWEOpPattern,
-                  BatchedKeySwitchGLWEOpPattern, WopPBSGLWEOpPattern>(
+                  BatchedMappedBootstrapGLWEOpPattern,
+                  ManyLutBootstrapGLWEOpPattern, KeySwitchGLWEOpPattern,
+                  BatchedKeySwitchGLWEOpPattern,
+                  WopPBSGLWEOpPattern<TFHE::WopPBSGLWEOp,
+                                      Concrete::WopPBSCRTLweTensorOp>,
+                  WopPBSGLWEOpPattern<TFHE::BatchedWopPBSGLWEOp,
+                                      Concrete::BatchedWopPBSCRTLweTensorOp>>(
       &getContext(), converter);
 
   // Add patterns to rewrite tensor operators that works on tensors of TFHE GLWE
@@ -910,6 +1126,15 @@ void TFHEToConcretePass::runOnOperation() {
                   InsertSliceOpPattern<mlir::tensor::ParallelInsertSliceOp>,
                   InsertOpPattern, FromElementsOpPattern>(&getContext(),
                                                           converter);
+  // The gathers and scatters of ciphertexts, including of the simulated ones
+  // which are already words, move whole rows with the Concrete operations
+  patterns.insert<GatherOpPattern, ScatterOpPattern>(&getContext(), converter);
+  target.addDynamicallyLegalOp<mlir::tensor::GatherOp, mlir::tensor::ScatterOp>(
+      [&](mlir::Operation *op) {
+        return converter.isLegal(op->getResultTypes()) &&
+               converter.isLegal(op->getOperandTypes()) &&
+               !isStaticWordTensor(op->getResult(0).getType());
+      });
   // Add patterns to rewrite some of tensor ops that were introduced by the
   // linalg bufferization of encrypted tensor
   insertTensorShapeOpPattern<mlir::tensor::ExpandShapeOp,
@@ -22,6 +22,7 @@ namespace memref = mlir::memref;
 char memref_trace_ciphertext[] = "memref_trace_ciphertext";
 char memref_trace_plaintext[] = "memref_trace_plaintext";
 char memref_trace_message[] = "memref_trace_message";
+char memref_trace_probe[] = "memref_trace_probe";
 
 mlir::Type getDynamicMemrefWithUnknownOffset(mlir::RewriterBase &rewriter,
                                              size_t rank) {
@@ -76,6 +77,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
         {mlir::LLVM::LLVMPointerType::get(rewriter.getI8Type()),
          rewriter.getI32Type()},
         {});
+  } else if (funcName == memref_trace_probe) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {mlir::LLVM::LLVMPointerType::get(rewriter.getI8Type()),
+         rewriter.getI32Type(), rewriter.getI32Type(), rewriter.getF64Type()},
+        {});
   } else {
     op->emitError("unknwon external function") << funcName;
     return mlir::failure();
@@ -190,6 +197,29 @@ void traceMessageAddOperands(Tracing::TraceMessageOp op,
       op.getLoc(), rewriter.getI32IntegerAttr(msg.size())));
 }
 
+void traceProbeAddOperands(Tracing::ProbeOp op,
+                           mlir::SmallVector<mlir::Value> &operands,
+                           mlir::RewriterBase &rewriter) {
+  auto label = op.getLabel();
+  double noiseVariance = 0;
+  if (auto variance = op.getNoiseVariance())
+    noiseVariance = variance->convertToDouble();
+  std::string labelName;
+  std::stringstream stream;
+  stream << rand();
+  stream >> labelName;
+  auto labelVal = mlir::LLVM::createGlobalString(
+      op.getLoc(), rewriter, labelName, label,
+      mlir::LLVM::linkage::Linkage::Linkonce, false);
+  operands.push_back(labelVal);
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), rewriter.getI32IntegerAttr(label.size())));
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), rewriter.getI32IntegerAttr(op.getPrecision().value_or(0))));
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), rewriter.getF64FloatAttr(noiseVariance)));
+}
+
 struct TracingToCAPIPass : public TracingToCAPIBase<TracingToCAPIPass> {
 
   TracingToCAPIPass() {}
@@ -219,6 +249,9 @@ struct TracingToCAPIPass : public TracingToCAPIBase<TracingToCAPIPass> {
     patterns.add<TracingToCAPICallPattern<Tracing::TraceMessageOp,
                                           memref_trace_message>>(
         &getContext(), traceMessageAddOperands);
+    patterns.add<
+        TracingToCAPICallPattern<Tracing::ProbeOp, memref_trace_probe>>(
+        &getContext(), traceProbeAddOperands);
 
     // Apply conversion
     if (mlir::applyPartialConversion(op, target, std::move(patterns))
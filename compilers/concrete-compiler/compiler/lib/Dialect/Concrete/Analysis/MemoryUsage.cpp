@@ -291,6 +291,130 @@ struct MemoryUsagePass
   std::map<std::string, std::vector<mlir::Value>> visitedValuesPerLoc;
 };
 
+/// Computes the peak size of the live buffers of the circuits, from their
+/// allocations and deallocations in program order, and the bytes they
+/// allocate per call.
+///
+/// The iterations of a loop run in sequence, the buffers they do not
+/// deallocate adding up, while the regions of the other operations run once.
+/// The parallel loops are therefore accounted for a single thread.
+struct BufferUsagePass
+    : public PassWrapper<BufferUsagePass, OperationPass<ModuleOp>> {
+
+  ProgramCompilationFeedback &feedback;
+
+  BufferUsagePass(ProgramCompilationFeedback &feedback) : feedback{feedback} {};
+
+  struct Usage {
+    /// the peak of the live bytes, relative to the start
+    int64_t peak = 0;
+    /// the live bytes at the end, relative to the start
+    int64_t live = 0;
+    /// the allocated bytes
+    int64_t allocated = 0;
+  };
+
+  void runOnOperation() override {
+    auto module = getOperation();
+    auto funcs = module.getOps<mlir::func::FuncOp>();
+    for (CircuitCompilationFeedback &circuitFeedback :
+         feedback.circuitFeedbacks) {
+      auto funcOp = llvm::find_if(funcs, [&](mlir::func::FuncOp op) {
+        return op.getName() == circuitFeedback.name;
+      });
+      assert(funcOp != funcs.end());
+
+      circuitFeedback.peakMemoryUsage = std::nullopt;
+      circuitFeedback.allocatedMemory = std::nullopt;
+      if ((*funcOp).isExternal())
+        continue;
+
+      // The arguments are allocated by the caller
+      int64_t arguments = 0;
+      for (auto argumentType : (*funcOp).getArgumentTypes()) {
+        auto bufferType = argumentType.dyn_cast<mlir::MemRefType>();
+        if (!bufferType)
+          continue;
+        auto bufferSize = getBufferSize(bufferType);
+        if (!bufferSize) {
+          (*funcOp).emitError() << bufferSize.error().mesg;
+          signalPassFailure();
+          return;
+        }
+        arguments += bufferSize.value();
+      }
+
+      auto usage = evaluate((*funcOp).getBody().front());
+      if (!usage) {
+        (*funcOp).emitError() << usage.error().mesg;
+        signalPassFailure();
+        return;
+      }
+      if (!usage.value().has_value())
+        continue;
+
+      // The server keys and the scratch of a thread are live during the
+      // whole call
+      circuitFeedback.peakMemoryUsage =
+          arguments + usage.value()->peak + feedback.totalBootstrapKeysSize +
+          feedback.totalKeyswitchKeysSize + feedback.runtimeScratchSize;
+      circuitFeedback.allocatedMemory = usage.value()->allocated;
+    }
+  }
+
+  /// Returns no usage for the loops without static trip count.
+  outcome::checked<std::optional<Usage>, StringError>
+  evaluate(mlir::Block &block) {
+    Usage usage;
+    for (mlir::Operation &op : block) {
+      if (auto allocOp = llvm::dyn_cast<memref::AllocOp>(op)) {
+        auto bufferSize = getBufferSize(allocOp.getType());
+        if (!bufferSize)
+          return bufferSize.error();
+        usage.live += bufferSize.value();
+        usage.allocated += bufferSize.value();
+        usage.peak = std::max(usage.peak, usage.live);
+        continue;
+      }
+      if (auto deallocOp = llvm::dyn_cast<memref::DeallocOp>(op)) {
+        auto bufferType =
+            deallocOp.getMemref().getType().dyn_cast<mlir::MemRefType>();
+        if (!bufferType)
+          continue;
+        auto bufferSize = getBufferSize(bufferType);
+        if (!bufferSize)
+          return bufferSize.error();
+        usage.live -= bufferSize.value();
+        continue;
+      }
+
+      int64_t tripCount = 1;
+      if (auto forOp = llvm::dyn_cast<scf::ForOp>(op)) {
+        std::optional<int64_t> staticTripCount = tryGetStaticTripCount(forOp);
+        if (!staticTripCount.has_value())
+          return std::optional<Usage>();
+        tripCount = staticTripCount.value();
+      }
+      for (mlir::Region &region : op.getRegions()) {
+        for (mlir::Block &regionBlock : region) {
+          auto regionUsage = evaluate(regionBlock);
+          if (!regionUsage || !regionUsage.value().has_value())
+            return regionUsage;
+          Usage iteration = *regionUsage.value();
+          // The buffers not deallocated by an iteration are live in the next
+          usage.peak = std::max(usage.peak,
+                                usage.live + iteration.peak +
+                                    std::max<int64_t>(0, tripCount - 1) *
+                                        std::max<int64_t>(0, iteration.live));
+          usage.live += tripCount * iteration.live;
+          usage.allocated += tripCount * iteration.allocated;
+        }
+      }
+    }
+    return std::optional<Usage>(usage);
+  }
+};
+
 } // namespace Concrete
 
 std::unique_ptr<OperationPass<ModuleOp>>
@@ -298,5 +422,10 @@ createMemoryUsagePass(ProgramCompilationFeedback &feedback) {
   return std::make_unique<Concrete::MemoryUsagePass>(feedback);
 }
 
+std::unique_ptr<OperationPass<ModuleOp>>
+createBufferUsagePass(ProgramCompilationFeedback &feedback) {
+  return std::make_unique<Concrete::BufferUsagePass>(feedback);
+}
+
 } // namespace concretelang
 } // namespace mlir
@@ -33,9 +33,48 @@ namespace {
 namespace Tracing = mlir::concretelang::Tracing;
 namespace Concrete = mlir::concretelang::Concrete;
 
-template <typename TensorOp, typename MemrefOp>
-struct TensorToMemrefOp : public BufferizableOpInterface::ExternalModel<
-                              TensorToMemrefOp<TensorOp, MemrefOp>, TensorOp> {
+/// Marks the leveled operations whose result the analysis decided to write
+/// in the buffer of their first operand, see `resolveConflicts`.
+const char *const IN_PLACE_ATTR = "concrete.in_place";
+
+/// Returns whether the leveled operation `op` may write its result in the
+/// buffer of `opOperand`. This is only considered for the first ciphertext
+/// operand, when it is computed by another Concrete operation: its buffer is
+/// then allocated by the circuit, or is itself the buffer of such an operand,
+/// and never a buffer of the caller. The batched multiplications read by a
+/// batched addition are kept out of place, so that they can be fused with it
+/// when lowered to calls.
+bool mayBufferizeInPlace(Operation *op, OpOperand &opOperand) {
+  if (opOperand.getOperandNumber() != 0 ||
+      opOperand.get().getType() != op->getResult(0).getType())
+    return false;
+  Operation *producer = opOperand.get().getDefiningOp();
+  if (!llvm::isa_and_nonnull<Concrete::ConcreteDialect>(
+          producer ? producer->getDialect() : nullptr))
+    return false;
+  auto isBatchedMul = [](Operation *candidate) {
+    return llvm::isa_and_nonnull<Concrete::BatchedMulCleartextLweTensorOp,
+                                 Concrete::BatchedMulCleartextCstLweTensorOp>(
+        candidate);
+  };
+  if (isBatchedMul(op))
+    return llvm::none_of(op->getUsers(), [](Operation *user) {
+      return llvm::isa<Concrete::BatchedAddLweTensorOp>(user);
+    });
+  if (llvm::isa<Concrete::BatchedAddLweTensorOp>(op))
+    return !isBatchedMul(producer);
+  return true;
+}
+
+/// Bufferizes `TensorOp` to `MemrefOp`, whose first operand is the buffer
+/// receiving the result. The result of the `leveled` operations, which
+/// compute each word of the result from the same word of their operands, is
+/// written in place in the buffer of their first ciphertext operand when it
+/// is not read afterwards.
+template <typename TensorOp, typename MemrefOp, bool leveled = false>
+struct TensorToMemrefOp
+    : public BufferizableOpInterface::ExternalModel<
+          TensorToMemrefOp<TensorOp, MemrefOp, leveled>, TensorOp> {
   bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
                               const AnalysisState &state) const {
     return true;
@@ -43,51 +82,78 @@ struct TensorToMemrefOp : public BufferizableOpInterface::ExternalModel<
 
   bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
                                const AnalysisState &state) const {
-    return false;
+    return leveled && mayBufferizeInPlace(op, opOperand);
   }
 
   AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
                                             const AnalysisState &state) const {
+    if (leveled && mayBufferizeInPlace(op, opOperand))
+      return {{op->getOpResult(0), BufferRelation::Equivalent}};
     return {};
   }
 
   BufferRelation bufferRelation(Operation *op, OpResult opResult,
                                 const AnalysisState &state) const {
+    if (leveled && mayBufferizeInPlace(op, op->getOpOperand(0)))
+      return BufferRelation::Equivalent;
     return BufferRelation::Unknown;
   }
 
+  /// An operand that cannot be written in place gets no copy: the result is
+  /// then written to a new buffer, as for the other operations.
+  LogicalResult resolveConflicts(Operation *op, RewriterBase &rewriter,
+                                 const AnalysisState &state) const {
+    if (leveled && mayBufferizeInPlace(op, op->getOpOperand(0)) &&
+        state.isInPlace(op->getOpOperand(0)))
+      op->setAttr(IN_PLACE_ATTR, rewriter.getUnitAttr());
+    return success();
+  }
+
   LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
                           const BufferizationOptions &options) const {
 
     auto loc = op->getLoc();
     auto castOp = cast<TensorOp>(op);
 
-    auto resTensorType =
-        castOp.getResult().getType().template cast<mlir::TensorType>();
-
-    auto outMemrefType = MemRefType::get(resTensorType.getShape(),
-                                         resTensorType.getElementType());
-    auto outMemref = options.createAlloc(rewriter, loc, outMemrefType, {});
-    if (mlir::failed(outMemref)) {
-      return mlir::failure();
-    }
-
-    // The first operand is the result
-    mlir::SmallVector<mlir::Value, 3> operands{
-        *outMemref,
-    };
+    mlir::SmallVector<mlir::Value, 3> buffers;
     for (auto &operand : op->getOpOperands()) {
       if (!operand.get().getType().isa<mlir::RankedTensorType>()) {
-        operands.push_back(operand.get());
+        buffers.push_back(operand.get());
       } else {
-        operands.push_back(
+        buffers.push_back(
             *bufferization::getBuffer(rewriter, operand.get(), options));
       }
     }
 
-    rewriter.create<MemrefOp>(loc, mlir::TypeRange{}, operands, op->getAttrs());
+    mlir::Value outMemref;
+    if (op->hasAttr(IN_PLACE_ATTR)) {
+      outMemref = buffers.front();
+    } else {
+      auto resTensorType =
+          castOp.getResult().getType().template cast<mlir::TensorType>();
 
-    replaceOpWithBufferizedValues(rewriter, op, *outMemref);
+      auto outMemrefType = MemRefType::get(resTensorType.getShape(),
+                                           resTensorType.getElementType());
+      auto alloc = options.createAlloc(rewriter, loc, outMemrefType, {});
+      if (mlir::failed(alloc)) {
+        return mlir::failure();
+      }
+      outMemref = *alloc;
+    }
+
+    // The first operand is the result
+    mlir::SmallVector<mlir::Value, 3> operands{outMemref};
+    operands.append(buffers.begin(), buffers.end());
+
+    mlir::SmallVector<mlir::NamedAttribute> attrs;
+    for (auto attr : op->getAttrs()) {
+      if (attr.getName() != IN_PLACE_ATTR)
+        attrs.push_back(attr);
+    }
+
+    rewriter.create<MemrefOp>(loc, mlir::TypeRange{}, operands, attrs);
+
+    replaceOpWithBufferizedValues(rewriter, op, outMemref);
 
     return success();
   }
@@ -100,23 +166,22 @@ void mlir::concretelang::Concrete::
   registry.addExtension(+[](MLIRContext *ctx,
                             Concrete::ConcreteDialect *dialect) {
     // add_lwe_tensor => add_lwe_buffer
-    Concrete::AddLweTensorOp::attachInterface<
-        TensorToMemrefOp<Concrete::AddLweTensorOp, Concrete::AddLweBufferOp>>(
-        *ctx);
+    Concrete::AddLweTensorOp::attachInterface<TensorToMemrefOp<
+        Concrete::AddLweTensorOp, Concrete::AddLweBufferOp, true>>(*ctx);
     // add_plaintext_lwe_tensor => add_plaintext_lwe_buffer
-    Concrete::AddPlaintextLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::AddPlaintextLweTensorOp, Concrete::AddPlaintextLweBufferOp>>(
-        *ctx);
+    Concrete::AddPlaintextLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::AddPlaintextLweTensorOp,
+                         Concrete::AddPlaintextLweBufferOp, true>>(*ctx);
     // mul_cleartext_lwe_tensor => mul_cleartext_lwe_buffer
-    Concrete::MulCleartextLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::MulCleartextLweTensorOp, Concrete::MulCleartextLweBufferOp>>(
-        *ctx);
+    Concrete::MulCleartextLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::MulCleartextLweTensorOp,
+                         Concrete::MulCleartextLweBufferOp, true>>(*ctx);
     // negate_cleartext_lwe_tensor => negate_cleartext_lwe_buffer
     Concrete::NegateLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::NegateLweTensorOp, Concrete::NegateLweBufferOp>>(*ctx);
+        Concrete::NegateLweTensorOp, Concrete::NegateLweBufferOp, true>>(*ctx);
     // negate_cleartext_lwe_tensor => negate_cleartext_lwe_buffer
     Concrete::NegateLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::NegateLweTensorOp, Concrete::NegateLweBufferOp>>(*ctx);
+        Concrete::NegateLweTensorOp, Concrete::NegateLweBufferOp, true>>(*ctx);
     // keyswitch_lwe_tensor => keyswitch_lwe_buffer
     Concrete::KeySwitchLweTensorOp::attachInterface<TensorToMemrefOp<
         Concrete::KeySwitchLweTensorOp, Concrete::KeySwitchLweBufferOp>>(*ctx);
@@ -125,31 +190,33 @@ void mlir::concretelang::Concrete::
         Concrete::BootstrapLweTensorOp, Concrete::BootstrapLweBufferOp>>(*ctx);
 
     // batched_add_lwe_tensor => batched_add_lwe_buffer
-    Concrete::BatchedAddLweTensorOp::attachInterface<TensorToMemrefOp<
-        Concrete::BatchedAddLweTensorOp, Concrete::BatchedAddLweBufferOp>>(
-        *ctx);
+    Concrete::BatchedAddLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::BatchedAddLweTensorOp,
+                         Concrete::BatchedAddLweBufferOp, true>>(*ctx);
     // batched_add_plaintext_lwe_tensor => batched_add_plaintext_lwe_buffer
     Concrete::BatchedAddPlaintextLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedAddPlaintextLweTensorOp,
-                         Concrete::BatchedAddPlaintextLweBufferOp>>(*ctx);
+                         Concrete::BatchedAddPlaintextLweBufferOp, true>>(*ctx);
     // batched_add_plaintext_cst_lwe_tensor =>
     // batched_add_plaintext_cst_lwe_buffer
     Concrete::BatchedAddPlaintextCstLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedAddPlaintextCstLweTensorOp,
-                         Concrete::BatchedAddPlaintextCstLweBufferOp>>(*ctx);
+                         Concrete::BatchedAddPlaintextCstLweBufferOp, true>>(
+        *ctx);
     // batched_mul_cleartext_lwe_tensor => batched_mul_cleartext_lwe_buffer
     Concrete::BatchedMulCleartextLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedMulCleartextLweTensorOp,
-                         Concrete::BatchedMulCleartextLweBufferOp>>(*ctx);
+                         Concrete::BatchedMulCleartextLweBufferOp, true>>(*ctx);
     // batched_mul_cleartext_cst_lwe_tensor =>
     // batched_mul_cleartext_cst_lwe_buffer
     Concrete::BatchedMulCleartextCstLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedMulCleartextCstLweTensorOp,
-                         Concrete::BatchedMulCleartextCstLweBufferOp>>(*ctx);
+                         Concrete::BatchedMulCleartextCstLweBufferOp, true>>(
+        *ctx);
     // batched_negate_lwe_tensor => batched_negate_lwe_buffer
     Concrete::BatchedNegateLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedNegateLweTensorOp,
-                         Concrete::BatchedNegateLweBufferOp>>(*ctx);
+                         Concrete::BatchedNegateLweBufferOp, true>>(*ctx);
 
     // batched_keyswitch_lwe_tensor => batched_keyswitch_lwe_buffer
     Concrete::BatchedKeySwitchLweTensorOp::attachInterface<
@@ -164,9 +231,17 @@ void mlir::concretelang::Concrete::
     Concrete::BatchedMappedBootstrapLweTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::BatchedMappedBootstrapLweTensorOp,
                          Concrete::BatchedMappedBootstrapLweBufferOp>>(*ctx);
+    // many_lut_bootstrap_lwe_tensor => many_lut_bootstrap_lwe_buffer
+    Concrete::ManyLutBootstrapLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::ManyLutBootstrapLweTensorOp,
+                         Concrete::ManyLutBootstrapLweBufferOp>>(*ctx);
     // wop_pbs_crt_lwe_tensor => wop_pbs_crt_lwe_buffer
     Concrete::WopPBSCRTLweTensorOp::attachInterface<TensorToMemrefOp<
         Concrete::WopPBSCRTLweTensorOp, Concrete::WopPBSCRTLweBufferOp>>(*ctx);
+    // batched_wop_pbs_crt_lwe_tensor => batched_wop_pbs_crt_lwe_buffer
+    Concrete::BatchedWopPBSCRTLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::BatchedWopPBSCRTLweTensorOp,
+                         Concrete::BatchedWopPBSCRTLweBufferOp>>(*ctx);
     // encode_plaintext_with_crt_tensor => encode_plaintext_with_crt_buffer
     Concrete::EncodePlaintextWithCrtTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::EncodePlaintextWithCrtTensorOp,
@@ -176,10 +251,24 @@ void mlir::concretelang::Concrete::
     Concrete::EncodeExpandLutForBootstrapTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::EncodeExpandLutForBootstrapTensorOp,
                          Concrete::EncodeExpandLutForBootstrapBufferOp>>(*ctx);
+    // encode_expand_many_lut_for_bootstrap_tensor =>
+    // encode_expand_many_lut_for_bootstrap_buffer
+    Concrete::EncodeExpandManyLutForBootstrapTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::EncodeExpandManyLutForBootstrapTensorOp,
+                         Concrete::EncodeExpandManyLutForBootstrapBufferOp>>(
+        *ctx);
     // encode_lut_for_crt_woppbs_tensor =>
     // encode_lut_for_crt_woppbs_buffer
     Concrete::EncodeLutForCrtWopPBSTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::EncodeLutForCrtWopPBSTensorOp,
                          Concrete::EncodeLutForCrtWopPBSBufferOp>>(*ctx);
+    // gather_lwe_tensor => gather_lwe_buffer
+    Concrete::GatherLweTensorOp::attachInterface<TensorToMemrefOp<
+        Concrete::GatherLweTensorOp, Concrete::GatherLweBufferOp>>(*ctx);
+    // scatter_lwe_tensor => scatter_lwe_buffer, which only replaces the rows
+    // at the positions, in place as the leveled operations
+    Concrete::ScatterLweTensorOp::attachInterface<TensorToMemrefOp<
+        Concrete::ScatterLweTensorOp, Concrete::ScatterLweBufferOp, true>>(
+        *ctx);
   });
 }
@@ -19,6 +19,7 @@
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Pass/PassManager.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -66,6 +67,8 @@ struct FunctionToDag {
   llvm::DenseMap<mlir::Value, concrete_optimizer::dag::OperatorIndex> index;
   bool setOptimizerID;
   concrete_optimizer::DagBuilder &dagBuilder;
+  // The lookup tables evaluated by a many-LUT bootstrap
+  llvm::DenseSet<mlir::Operation *> manyLutOps;
 
   FunctionToDag(mlir::func::FuncOp func, optimizer::Config config,
                 concrete_optimizer::DagBuilder &dagBuilder)
@@ -220,6 +223,17 @@ struct FunctionToDag {
     auto val = op.getResult(0);
     auto loc = loc_to_location(op.getLoc());
     assert(encrypted_inputs.size() == 1);
+    if (manyLutOps.contains(&op)) {
+      // Already added with the first lookup table of its many-LUT bootstrap
+      return;
+    }
+    if (auto lut = llvm::dyn_cast<FHE::ApplyLookupTableEintOp>(op)) {
+      auto group = manyLutGroup(lut);
+      if (group.size() > 1) {
+        addManyLut(group, encrypted_inputs, precision);
+        return;
+      }
+    }
     // No need to distinguish different lut kind until we do approximate
     // paradigm on outputs
     auto encrypted_input = encrypted_inputs[0];
@@ -242,6 +256,70 @@ struct FunctionToDag {
     index[val] = lutIndex;
   }
 
+  /// Returns the lookup tables of the input of `op` that a single many-LUT
+  /// bootstrap evaluates along with it, `op` first: the following unsigned
+  /// lookup tables of the same block and result type whose tables are known
+  /// before `op`, up to `many_lut_max_count` rounded down to a power of 2.
+  std::vector<FHE::ApplyLookupTableEintOp>
+  manyLutGroup(FHE::ApplyLookupTableEintOp op) {
+    std::vector<FHE::ApplyLookupTableEintOp> group{op};
+    auto inputType = op.getA().getType().cast<FHE::FheIntegerInterface>();
+    if (!setOptimizerID || config.many_lut_max_count < 2 ||
+        inputType.isSigned())
+      return group;
+
+    auto isKnownBefore = [&](mlir::Value table) {
+      auto def = table.getDefiningOp();
+      return def == nullptr || mlir::isa<mlir::arith::ConstantOp>(def) ||
+             def->getBlock() != op->getBlock() || def->isBeforeInBlock(op);
+    };
+    if (!isKnownBefore(op.getLut()))
+      return group;
+    for (auto user : op.getA().getUsers()) {
+      auto other = llvm::dyn_cast<FHE::ApplyLookupTableEintOp>(user);
+      if (other == nullptr || other == op ||
+          other->getBlock() != op->getBlock() ||
+          !op->isBeforeInBlock(other) || manyLutOps.contains(other) ||
+          other.getType() != op.getType() || !isKnownBefore(other.getLut()))
+        continue;
+      group.push_back(other);
+    }
+    std::sort(group.begin(), group.end(), [](auto a, auto b) {
+      return a->isBeforeInBlock(b);
+    });
+
+    size_t count = 1;
+    while (2 * count <= group.size() && 2 * count <= config.many_lut_max_count)
+      count *= 2;
+    group.resize(count);
+    return group;
+  }
+
+  /// Adds the lookup tables of `group` as a single lookup table. Each message
+  /// box is split between the packed tables, so the input noise must fit in
+  /// a box `group.size()` times smaller, which is modeled by multiplying the
+  /// input by the number of tables.
+  void addManyLut(std::vector<FHE::ApplyLookupTableEintOp> &group,
+                  Inputs &encrypted_inputs, int precision) {
+    auto loc = loc_to_location(group.front().getLoc());
+    auto dotIndex = dagBuilder.add_dot(
+        slice(encrypted_inputs),
+        concrete_optimizer::weights::number((int64_t)group.size()), *loc);
+    std::vector<std::uint64_t> unknowFunction;
+    auto lutIndex = dagBuilder.add_lut(dotIndex, slice(unknowFunction),
+                                       precision, *loc);
+    // The lookup tables share their optimizer ids, which is how the
+    // lowering finds them back
+    std::vector<int32_t> operatorIndexes{(int32_t)dotIndex.index,
+                                         (int32_t)lutIndex.index};
+    mlir::Builder builder(group.front().getContext());
+    for (auto lut : group) {
+      lut->setAttr("TFHE.OId", builder.getDenseI32ArrayAttr(operatorIndexes));
+      index[lut.getResult()] = lutIndex;
+      manyLutOps.insert(lut);
+    }
+  }
+
   concrete_optimizer::dag::OperatorIndex
   addRound(mlir::Value &val, Inputs &encrypted_inputs, int rounded_precision) {
     assert(encrypted_inputs.size() == 1);
@@ -15,8 +15,10 @@
 
 #include <limits>
 #include <llvm/ADT/APInt.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/Optional.h>
 #include <llvm/ADT/SmallString.h>
+#include <llvm/Support/MathExtras.h>
 #include <mlir/Analysis/DataFlow/DeadCodeAnalysis.h>
 #include <mlir/Analysis/DataFlow/SparseAnalysis.h>
 #include <mlir/Dialect/Arith/IR/Arith.h>
@@ -364,88 +366,115 @@ static llvm::APInt sqMANP_mul_eint(llvm::APInt a, llvm::APInt b) {
   return result;
 }
 
-/// Computes the squared vector norm as the maximum of all dot products over the
-/// destroyed dimension. The computation is recursive and can be seen as folding
-/// a tree of values where leaves compute the dot products and nodes choose the
-/// maximum of the children. There is a branching node at every shape dimension
-/// with the fanout equal to that dimension range, except for the destroyed
-/// dimension (where the fanout is 1).
-///
-/// This function is expected to behave correctly on clear tensor shapes with
-/// any dimensionality, for example:
-///
-///     MxN @ N ->     M
-///   LxMxN @ N ->   LxM
-/// KxLxMxN @ N -> KxLxM
-///
-/// N @     NxP ->     P
-/// N @   LxNxP ->   LxP
-/// N @ KxLxNxP -> KxLxP
-///
-/// KxLxMxN @   NxP -> KxLxMxP
-/// KxLxMxN @ LxNxP -> KxLxMxP
-/// Kx1xMxN @ LxNxP -> KxLxMxP
-///
-///   MxN @ KxLxNxP -> KxLxMxP
-/// LxMxN @ KxLxNxP -> KxLxMxP
-/// 1xMxN @ KxLxNxP -> KxLxMxP
-///
-/// N @     NxP ->     P
-/// N @   LxNxP ->   LxP
-/// N @ KxLxNxP -> KxLxP
-///
-///     MxN @ N ->     M
-///   LxMxN @ N ->   LxM
-/// KxLxMxN @ N -> KxLxM
+/// The squared 2-norms of the slices of constant clear operands, indexed by
+/// the attribute holding the constant and by the length and stride of the
+/// slices. The same weights are usually shared by several operations, and the
+/// operations are visited again as the analysis iterates, so the norms are
+/// computed once per run of the pass.
+using SliceSqNormCache =
+    llvm::DenseMap<std::tuple<const void *, uint64_t, uint64_t>, llvm::APInt>;
+
+static thread_local SliceSqNormCache *currentSliceSqNormCache = nullptr;
+
+/// Caches the squared 2-norms of the slices of the constant clear operands
+/// computed on the current thread during its lifetime.
+class SliceSqNormCacheScope {
+public:
+  SliceSqNormCacheScope() : previous(currentSliceSqNormCache) {
+    currentSliceSqNormCache = &cache;
+  }
+  ~SliceSqNormCacheScope() { currentSliceSqNormCache = previous; }
+
+private:
+  SliceSqNormCache cache;
+  SliceSqNormCache *previous;
+};
+
+/// Returns the values of the operand `opNum` of `op` if it is defined by a
+/// constant.
+static std::optional<mlir::DenseIntElementsAttr>
+getConstantOperandValues(mlir::Operation *op, unsigned opNum) {
+  auto cstOp = llvm::dyn_cast_or_null<mlir::arith::ConstantOp>(
+      op->getOperand(opNum).getDefiningOp());
+  if (!cstOp)
+    return std::nullopt;
+  auto values = cstOp.getValue().dyn_cast<mlir::DenseIntElementsAttr>();
+  if (!values)
+    return std::nullopt;
+  return values;
+}
+
+/// Computes the maximum of the squared 2-norms of the slices of `values`,
+/// where a slice holds `length` elements spaced by `stride` in the flattened
+/// tensor, i.e. the elements along a dimension of size `length` for which the
+/// following dimensions amount to `stride` elements.
 ///
-/// MxN @ NxP -> MxP
-
-static llvm::APInt sqMANP_matmul_internal(
-    llvm::ArrayRef<int64_t> shape, size_t destroyedDimension,
-    llvm::SmallVector<uint64_t, /*size-hint=*/4> iterPoint,
-    mlir::detail::ElementsAttrRange<mlir::DenseElementsAttr::IntElementIterator>
-        clearValues,
-    llvm::APInt encryptedOperandNorm) {
-  assert(iterPoint.size() >= shape.size() &&
-         "Tensor shape dimensionality is larger than iteration space "
-         "dimensionality");
-  assert(destroyedDimension < iterPoint.size() &&
-         "Destroyed dimension outside of iteration space dimensionality");
-  size_t currentDimension = iterPoint.size() - shape.size();
-
-  if (currentDimension == destroyedDimension) {
-    // the dot product over destroyed dimension will sum products counting down
-    // from the largest index
-    iterPoint[currentDimension] = shape[0] - 1;
-    return sqMANP_matmul_internal(shape.drop_front(1), destroyedDimension,
-                                  iterPoint, clearValues, encryptedOperandNorm);
+/// The values are visited once in their storage order and the sums are
+/// accumulated on 64 bits, falling back to `APInt`s only if a sum overflows.
+static llvm::APInt maxSliceSqNorm(mlir::DenseIntElementsAttr values,
+                                  uint64_t length, uint64_t stride) {
+  auto key = std::make_tuple(values.getAsOpaquePointer(), length, stride);
+  if (currentSliceSqNormCache != nullptr) {
+    auto cached = currentSliceSqNormCache->find(key);
+    if (cached != currentSliceSqNormCache->end())
+      return cached->second;
   }
 
-  if (shape.size() == 0) { // `iterPoint` is defined in all indices, let's
-                           // compute the dot product
-    llvm::APInt accumulationNorm = llvm::APInt{1, 0, false};
-    for (int64_t i = iterPoint[destroyedDimension]; i >= 0; i--) {
-      iterPoint[destroyedDimension] = i;
-
-      llvm::APInt weight = clearValues[iterPoint];
-      llvm::APInt weightNorm = APIntWidthExtendSqForConstant(weight);
-      llvm::APInt multiplicationNorm =
-          APIntWidthExtendUMul(encryptedOperandNorm, weightNorm);
-      accumulationNorm =
-          APIntWidthExtendUAdd(multiplicationNorm, accumulationNorm);
+  uint64_t numElements = values.getNumElements();
+  uint64_t numSlices = length == 0 ? 0 : numElements / length;
+
+  // Calls `f(slice, value)` for all the values in their storage order
+  auto forEachValue = [&](auto f) {
+    uint64_t base = 0, offset = 0, position = 0;
+    for (const llvm::APInt &value : values.getValues<llvm::APInt>()) {
+      if (!f(base + offset, value))
+        return;
+      if (++offset == stride) {
+        offset = 0;
+        if (++position == length) {
+          position = 0;
+          base += stride;
+        }
+      }
     }
-    return accumulationNorm;
-  } else { // descend into all indices in current dimension
-    llvm::APInt maximumNorm = llvm::APInt{1, 1, false};
-    for (int64_t i = 0; i < shape[0]; i++) {
-      iterPoint[currentDimension] = i;
-      llvm::APInt accumulationNorm =
-          sqMANP_matmul_internal(shape.drop_front(1), destroyedDimension,
-                                 iterPoint, clearValues, encryptedOperandNorm);
-      maximumNorm = APIntUMax(maximumNorm, accumulationNorm);
+  };
+
+  llvm::APInt maxNorm{1, 0, false};
+  std::vector<uint64_t> sums(numSlices, 0);
+  bool overflowed = false;
+  forEachValue([&](uint64_t slice, const llvm::APInt &value) {
+    // The square of a value on 32 bits fits on 64 bits
+    if (value.getSignificantBits() > 32) {
+      overflowed = true;
+      return false;
     }
-    return maximumNorm;
+    int64_t v = value.getSExtValue();
+    sums[slice] = llvm::SaturatingAdd(sums[slice], (uint64_t)(v * v),
+                                      &overflowed);
+    return !overflowed;
+  });
+
+  if (!overflowed) {
+    uint64_t max = 0;
+    for (uint64_t sum : sums)
+      max = std::max(max, sum);
+    maxNorm = llvm::APInt{64, max, false};
+  } else {
+    // The squares take twice the width of the values, and the sums of less
+    // than 2^64 of them fit in 64 more bits
+    unsigned width = 2 * values.getElementType().getIntOrFloatBitWidth() + 64;
+    std::vector<llvm::APInt> wideSums(numSlices, llvm::APInt{width, 0, false});
+    forEachValue([&](uint64_t slice, const llvm::APInt &value) {
+      wideSums[slice] += APIntWidthExtendSqForConstant(value).zext(width);
+      return true;
+    });
+    for (const llvm::APInt &sum : wideSums)
+      maxNorm = APIntUMax(maxNorm, sum);
   }
+
+  if (currentSliceSqNormCache != nullptr)
+    currentSliceSqNormCache->try_emplace(key, maxNorm);
+  return maxNorm;
 }
 
 /// Calculates the squared Minimal Arithmetic Noise Padding of a dot operation
@@ -453,9 +482,7 @@ static llvm::APInt sqMANP_matmul_internal(
 static llvm::APInt
 sqMANP_matmul(llvm::APInt encryptedOperandNorm,
               mlir::RankedTensorType clearOperandType,
-              std::optional<mlir::detail::ElementsAttrRange<
-                  mlir::DenseElementsAttr::IntElementIterator>>
-                  clearVals,
+              std::optional<mlir::DenseIntElementsAttr> clearVals,
               unsigned clearOpNum) {
 
   assert(clearOperandType.getElementType().isSignlessInteger() &&
@@ -473,13 +500,20 @@ sqMANP_matmul(llvm::APInt encryptedOperandNorm,
 
   llvm::APInt accNorm = llvm::APInt{1, 0, false};
 
-  if (clearVals.has_value())
-    accNorm =
-        sqMANP_matmul_internal(clearOperandShape, destroyedDimension,
-                               llvm::SmallVector<uint64_t, /*size-hint=*/4>(
-                                   clearOperandShape.size(), 0),
-                               clearVals.value(), encryptedOperandNorm);
-  else {
+  if (clearVals.has_value()) {
+    // The squared 2-norm of a dot product over the destroyed dimension is the
+    // norm of the encrypted operand times the sum of the squared weights, so
+    // only the largest sum of squared weights matters. The result of a
+    // matrix product is at least 1, as for a product with a zero matrix.
+    uint64_t stride = 1;
+    for (size_t i = destroyedDimension + 1; i < clearOperandDims; i++)
+      stride *= clearOperandShape[i];
+    llvm::APInt weightsNorm = maxSliceSqNorm(
+        clearVals.value(), clearOperandShape[destroyedDimension], stride);
+    accNorm = APIntWidthExtendUMul(encryptedOperandNorm, weightsNorm);
+    if (clearOperandDims > 1)
+      accNorm = APIntUMax(llvm::APInt{1, 1, false}, accNorm);
+  } else {
     llvm::APInt clearOperandNorm =
         conservativeIntNorm2Sq(clearOperandType.getElementType());
     llvm::APInt mulNorm =
@@ -701,9 +735,7 @@ getSqMANP(mlir::concretelang::FHELinalg::FancyAssignOp op,
 
 static llvm::APInt
 sqMANP_conv2d(llvm::APInt inputNorm, mlir::RankedTensorType weightTy,
-              std::optional<mlir::detail::ElementsAttrRange<
-                  mlir::DenseElementsAttr::IntElementIterator>>
-                  weightVals) {
+              std::optional<mlir::DenseIntElementsAttr> weightVals) {
   // Initial value of the accumulator to 0
   llvm::APInt accNorm = llvm::APInt{1, 0, false};
 
@@ -714,22 +746,14 @@ sqMANP_conv2d(llvm::APInt inputNorm, mlir::RankedTensorType weightTy,
   uint64_t W = weightTy.getShape()[3];
   if (weightVals.has_value()) {
     // For a constant weight kernel use actual constant to calculate 2-norm
-    // input windows are being multiplied by a kernel and summed up
-    for (uint64_t f = 0; f < F; f++) {
-      llvm::APInt tmpNorm = inputNorm;
-
-      for (uint64_t c = 0; c < C; c++) {
-        for (uint64_t h = 0; h < H; h++) {
-          for (uint64_t w = 0; w < W; w++) {
-            llvm::APInt cst = weightVals.value()[{f, c, h, w}];
-            llvm::APInt weightNorm = APIntWidthExtendSqForConstant(cst);
-            llvm::APInt mulNorm = APIntWidthExtendUMul(inputNorm, weightNorm);
-            tmpNorm = APIntWidthExtendUAdd(mulNorm, tmpNorm);
-          }
-        }
-      }
-      // Take the max of the 2-norm on the filter
-      accNorm = APIntUMax(accNorm, tmpNorm);
+    // input windows are being multiplied by a kernel and summed up, on top of
+    // the input norm, so the 2-norm of a filter is the input norm times one
+    // plus the sum of its squared weights. Take the max over the filters.
+    if (F > 0) {
+      llvm::APInt filterNorm = APIntWidthExtendUAdd(
+          maxSliceSqNorm(weightVals.value(), C * H * W, 1),
+          llvm::APInt{1, 1, false});
+      accNorm = APIntWidthExtendUMul(inputNorm, filterNorm);
     }
   } else {
     // For a dynamic operand conservatively assume that the value is
@@ -738,11 +762,9 @@ sqMANP_conv2d(llvm::APInt inputNorm, mlir::RankedTensorType weightTy,
     // For a weight (kernel) of shape tensor<FxCxHxW>, there is C*H*W
     // FHE.mul_eint_int and FHE.add_eint operations for each elements of the
     // result
-    int64_t n_mul = C * H * W;
+    uint64_t n_mul = C * H * W;
     llvm::APInt mulNorm = APIntWidthExtendUMul(inputNorm, weightNorm);
-    for (int64_t i = 0; i < n_mul; i++) {
-      accNorm = APIntWidthExtendUAdd(mulNorm, accNorm);
-    }
+    accNorm = APIntWidthExtendUMul(mulNorm, llvm::APInt{64, n_mul, false});
   }
   return accNorm;
 }
@@ -1066,6 +1088,53 @@ public:
     std::vector<llvm::APInt> outputMANPs(
         outputSize, fetchOrFallbackToAnalysis(outputArg)->getMANP().value());
 
+    // The indexing maps, the operations of the body and the lattices of
+    // their operands are set up once for all the iterations, the number of
+    // iterations being the size of the iteration domain, which can be large
+    llvm::SmallVector<mlir::AffineMap> indexingMaps =
+        genericOpClone.getIndexingMapsArray();
+
+    // if a linalg genric input is constant, replace the uses of its
+    // respective block argument with a constant value, set to the accessed
+    // element at each iteration. This avoids the computation of the MANP to
+    // use conservative values.
+    llvm::SmallVector<std::pair<arith::ConstantOp, unsigned int>>
+        constantInputs;
+    auto opBuilder = mlir::OpBuilder::atBlockBegin(genericOpClone.getBlock());
+    for (auto arg : genericOpClone.getBlock()->getArguments()) {
+      auto argIndex = arg.getArgNumber();
+      auto inputs = genericOpClone.getInputs();
+      // don't consider outputs
+      if (argIndex >= inputs.size())
+        continue;
+      auto input = inputs[argIndex];
+      auto definingOp = input.getDefiningOp();
+      if (definingOp && mlir::isa<mlir::arith::ConstantOp>(definingOp)) {
+        auto constantOp = mlir::dyn_cast<mlir::arith::ConstantOp>(definingOp);
+        mlir::DenseIntElementsAttr denseAttr =
+            constantOp.getValueAttr().dyn_cast<mlir::DenseIntElementsAttr>();
+        auto newConstantOp = opBuilder.create<arith::ConstantOp>(
+            mlir::UnknownLoc::get(genericOpClone.getContext()),
+            mlir::IntegerAttr::get(denseAttr.getType().getElementType(),
+                                   *denseAttr.getValues<APInt>().begin()));
+        // replace uses of the block argument with the constant value
+        arg.replaceAllUsesWith(newConstantOp.getResult());
+        constantInputs.push_back({newConstantOp, argIndex});
+      }
+    }
+
+    llvm::SmallVector<mlir::Operation *> bodyOps;
+    llvm::SmallVector<llvm::SmallVector<const MANPLattice *>> bodyLattices;
+    std::vector<std::unique_ptr<MANPLattice>> lattices;
+    genericOpClone.getBody()->walk([&](mlir::Operation *op) {
+      bodyOps.push_back(op);
+      bodyLattices.emplace_back();
+      for (auto operand : op->getOperands()) {
+        lattices.push_back(std::make_unique<MANPLattice>(operand));
+        bodyLattices.back().push_back(lattices.back().get());
+      }
+    });
+
     // indices at a specific iteration
     llvm::SmallVector<int64_t> indices(loopRange.size(), 0);
     for (auto i = 0; i < iterCount; i++) {
@@ -1073,70 +1142,40 @@ public:
         indices[iterPos] = (i / strides[iterPos]) % loopRange[iterPos];
       }
 
-      // if a linalg genric input is constant, replace the uses of its
-      // respective block argument with a constant value. This avoids the
-      // computation of the MANP to use conservative values.
-      // we also have to replace them back for the next iteration to be able to
-      // update them again with new values
-      mlir::DenseMap<mlir::BlockArgument, arith::ConstantOp> toReplaceBack;
-      for (auto arg : genericOpClone.getBlock()->getArguments()) {
-        auto argIndex = arg.getArgNumber();
-        auto inputs = genericOpClone.getInputs();
-        // don't consider outputs
-        if (argIndex >= inputs.size())
-          continue;
-        auto input = inputs[argIndex];
-        auto definingOp = input.getDefiningOp();
-        if (definingOp && mlir::isa<mlir::arith::ConstantOp>(definingOp)) {
-          // fetch constant value
-          auto constantOp = mlir::dyn_cast<mlir::arith::ConstantOp>(definingOp);
-          mlir::DenseIntElementsAttr denseAttr =
-              constantOp.getValueAttr().dyn_cast<mlir::DenseIntElementsAttr>();
-          auto constantTensor = denseAttr.getValues<APInt>();
-          auto constantIndex = indexFromLoopRange(
-              indices, genericOpClone.getIndexingMapsArray()[argIndex],
-              denseAttr.getType().getShape());
-          APInt constantValue = constantTensor[constantIndex];
-          // create new constant op with constant value
-          auto opBuilder = mlir::OpBuilder(genericOpClone.getContext());
-          auto opState = mlir::OperationState(
-              mlir::UnknownLoc::get(genericOpClone.getContext()),
-              arith::ConstantOp::getOperationName());
-          arith::ConstantOp::build(
-              opBuilder, opState,
-              mlir::IntegerAttr::get(denseAttr.getType().getElementType(),
-                                     constantValue));
-          auto newConstantOp =
-              arith::ConstantOp(mlir::Operation::create(opState));
-          genericOpClone.getBlock()->push_front(newConstantOp);
-          // replace uses of the block argument with the constant value
-          arg.replaceAllUsesWith(newConstantOp.getResult());
-          toReplaceBack[arg] = newConstantOp;
-        }
+      for (auto [newConstantOp, argIndex] : constantInputs) {
+        // fetch constant value
+        auto constantOp = mlir::dyn_cast<mlir::arith::ConstantOp>(
+            genericOpClone.getInputs()[argIndex].getDefiningOp());
+        mlir::DenseIntElementsAttr denseAttr =
+            constantOp.getValueAttr().cast<mlir::DenseIntElementsAttr>();
+        auto constantIndex =
+            indexFromLoopRange(indices, indexingMaps[argIndex],
+                               denseAttr.getType().getShape());
+        APInt constantValue = denseAttr.getValues<APInt>()[constantIndex];
+        newConstantOp.setValueAttr(mlir::IntegerAttr::get(
+            denseAttr.getType().getElementType(), constantValue));
       }
 
       // we want to replace the MANP of the block argument corresponding to the
       // output with the MANP value corresponding to the currently accessed
       // tensor element
-      size_t outputIndex = indexFromLoopRange(
-          indices,
-          genericOpClone.getIndexingMapsArray()[outputArg.getArgNumber()],
-          outputType.getShape());
+      size_t outputIndex =
+          indexFromLoopRange(indices, indexingMaps[outputArg.getArgNumber()],
+                             outputType.getShape());
       valueToManp[outputArg] = MANPLatticeValue(outputMANPs[outputIndex]);
-      genericOpClone.getBody()->walk([&](mlir::Operation *op) {
+      for (auto [op, latticeOperands] : llvm::zip(bodyOps, bodyLattices)) {
         // we update the appropriate element's MANP value using the index of the
         // currently accessed output element
         if (auto yieldOp = mlir::dyn_cast<mlir::linalg::YieldOp>(op)) {
           auto manp = fetchOrFallbackToAnalysis(yieldOp->getOperand(0));
           outputMANPs[outputIndex] = manp->getMANP().value();
-          return;
+          continue;
         }
         // compute using the op and operand manp values
-        mlir::SmallVector<const MANPLattice *> latticeOperands;
-        for (auto operand : op->getOperands()) {
-          auto lattice = new MANPLattice(operand);
-          lattice->join(*fetchOrFallbackToAnalysis(operand));
-          latticeOperands.push_back(lattice);
+        for (auto [operand, lattice] :
+             llvm::zip(op->getOperands(), latticeOperands)) {
+          const_cast<MANPLattice *>(lattice)->getValue() =
+              *fetchOrFallbackToAnalysis(operand);
         }
         std::optional<llvm::APInt> norm2SqEquiv =
             norm2SqEquivFromOp(op, latticeOperands);
@@ -1145,21 +1184,6 @@ public:
           valueToManp[op->getResult(0).cast<mlir::Value>()] =
               MANPLatticeValue(norm2SqEquiv);
         }
-        // free space of lattice elements
-        for (auto toFree : latticeOperands) {
-          delete toFree;
-        }
-      });
-
-      // replace back the uses of block arguments which were replaced by
-      // constant values
-      for (auto replacement : toReplaceBack) {
-        auto blockArg = replacement.first;
-        auto constantOp = replacement.second;
-        auto constantValue = constantOp.getResult();
-        constantValue.replaceAllUsesWith(blockArg);
-        constantOp->remove();
-        constantOp->destroy();
       }
     }
     genericOpClone->destroy();
@@ -1242,8 +1266,9 @@ llvm::APInt Dot::sqMANP(llvm::APInt a) {
                               .get()
                               .getType()
                               .cast<mlir::RankedTensorType>();
-  return sqMANP_matmul(a, clearOperandType, this->opTensorConstant(clearOpNum),
-                       clearOpNum);
+  return sqMANP_matmul(
+      a, clearOperandType,
+      getConstantOperandValues(this->getOperation(), clearOpNum), clearOpNum);
 }
 
 llvm::APInt MatMulEintIntOp::sqMANP(llvm::APInt a) {
@@ -1253,8 +1278,9 @@ llvm::APInt MatMulEintIntOp::sqMANP(llvm::APInt a) {
                          .get()
                          .getType()
                          .cast<mlir::RankedTensorType>();
-  return sqMANP_matmul(a, clearOpType, this->opTensorConstant(clearOpNum),
-                       clearOpNum);
+  return sqMANP_matmul(
+      a, clearOpType,
+      getConstantOperandValues(this->getOperation(), clearOpNum), clearOpNum);
 }
 
 llvm::APInt MatMulIntEintOp::sqMANP(llvm::APInt a) {
@@ -1265,8 +1291,9 @@ llvm::APInt MatMulIntEintOp::sqMANP(llvm::APInt a) {
                          .get()
                          .getType()
                          .cast<mlir::RankedTensorType>();
-  return sqMANP_matmul(a, clearOpType, this->opTensorConstant(clearOpNum),
-                       clearOpNum);
+  return sqMANP_matmul(
+      a, clearOpType,
+      getConstantOperandValues(this->getOperation(), clearOpNum), clearOpNum);
 }
 
 llvm::APInt Conv2dOp::sqMANP(llvm::APInt a) {
@@ -1276,7 +1303,8 @@ llvm::APInt Conv2dOp::sqMANP(llvm::APInt a) {
                          .get()
                          .getType()
                          .cast<mlir::RankedTensorType>();
-  return sqMANP_conv2d(a, clearOpType, this->opTensorConstant(clearOpNum));
+  return sqMANP_conv2d(
+      a, clearOpType, getConstantOperandValues(this->getOperation(), clearOpNum));
 }
 
 llvm::APInt Maxpool2dOp::sqMANP(llvm::APInt a) {
@@ -1324,6 +1352,7 @@ struct MANPPass : public MANPBase<MANPPass> {
   void runOnOperation() override {
     mlir::func::FuncOp func = getOperation();
 
+    SliceSqNormCacheScope sliceSqNormCache;
     mlir::DataFlowSolver solver;
     solver.load<mlir::dataflow::DeadCodeAnalysis>();
     solver.load<MANPAnalysis>(debug);
@@ -7,6 +7,7 @@
 #include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Matchers.h>
 #include <mlir/IR/PatternMatch.h>
 #include <mlir/Transforms/DialectConversion.h>
 
@@ -18,6 +19,8 @@
 #include <concretelang/Dialect/FHE/Transforms/BigInt/BigInt.h>
 #include <concretelang/Support/Constants.h>
 
+#include <functional>
+
 namespace mlir {
 namespace concretelang {
 
@@ -43,6 +46,22 @@ mlir::Value getTruthTableCarryExtract(mlir::PatternRewriter &rewriter,
   return truthTable.getResult();
 }
 
+/// Construct a table lookup of `chunkSize` bits computing `f`
+mlir::Value getTruthTable(mlir::PatternRewriter &rewriter, mlir::Location loc,
+                          unsigned int chunkSize,
+                          std::function<uint64_t(uint64_t)> f) {
+  auto tableSize = 1 << chunkSize;
+  std::vector<llvm::APInt> values;
+  values.reserve(tableSize);
+  for (auto i = 0; i < tableSize; i++)
+    values.push_back(llvm::APInt(64, f(i), false));
+  auto truthTableAttr = mlir::DenseElementsAttr::get(
+      mlir::RankedTensorType::get({tableSize}, rewriter.getIntegerType(64)),
+      values);
+  return rewriter.create<mlir::arith::ConstantOp>(loc, truthTableAttr)
+      .getResult();
+}
+
 namespace {
 
 namespace typing {
@@ -82,76 +101,229 @@ public:
 
 } // namespace typing
 
-class AddEintPattern
-    : public mlir::OpConversionPattern<mlir::concretelang::FHE::AddEintOp> {
+/// The status of the carry out of a range of chunks, in the carry-lookahead
+/// addition
+enum CarryStatus : uint64_t {
+  /// No carry out of the range
+  KILL = 0,
+  /// A carry out of the range
+  GENERATE = 1,
+  /// A carry out of the range if there is a carry into it
+  PROPAGATE = 2,
+};
+
+/// The order of two ranges of chunks, combined like the carry statuses: the
+/// order of the most significant chunks prevails unless they are equal
+enum OrderStatus : uint64_t {
+  LESS = KILL,
+  GREATER = GENERATE,
+  EQUAL = PROPAGATE,
+};
+
+/// Builds the operations on chunked integers, i.e. 1-D tensors of chunks of
+/// `chunkSize` bits holding `chunkWidth` bits of the integer each, least
+/// significant chunk first. The table lookups on the chunks are made in loops
+/// of independent iterations, which can be batched.
+class ChunkedIntegerBuilder {
 public:
-  AddEintPattern(mlir::TypeConverter &converter, mlir::MLIRContext *context,
-                 unsigned int chunkSize, unsigned int chunkWidth)
-      : mlir::OpConversionPattern<mlir::concretelang::FHE::AddEintOp>(
-            converter, context, ::mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
-        chunkSize(chunkSize), chunkWidth(chunkWidth) {}
+  ChunkedIntegerBuilder(mlir::PatternRewriter &rewriter, mlir::Location loc,
+                        mlir::RankedTensorType type, unsigned int chunkSize,
+                        unsigned int chunkWidth, bool carryLookahead)
+      : rewriter(rewriter), loc(loc), type(type),
+        chunkType(FHE::EncryptedUnsignedIntegerType::get(
+            rewriter.getContext(), chunkSize)),
+        numberOfChunks(type.getDimSize(0)), chunkSize(chunkSize),
+        chunkWidth(chunkWidth), base(1 << chunkWidth),
+        carryLookahead(carryLookahead) {}
 
-  mlir::LogicalResult
-  matchAndRewrite(FHE::AddEintOp op, FHE::AddEintOp::Adaptor adaptor,
-                  mlir::ConversionPatternRewriter &rewriter) const override {
-    auto tensorType =
-        adaptor.getA().getType().dyn_cast<mlir::RankedTensorType>();
-    auto shape = tensorType.getShape();
-    assert(shape.size() == 1 &&
-           "chunked integer should be converted to flat tensors, but tensor "
-           "have more than one dimension");
-    auto eintChunkWidth = tensorType.getElementType()
-                              .dyn_cast<FHE::EncryptedUnsignedIntegerType>()
-                              .getWidth();
-    assert(eintChunkWidth == chunkSize && "wrong tensor elements width");
-    auto numberOfChunks = shape[0];
+  /// Returns true if two chunks can be packed in a single one, which the
+  /// products and the comparisons of chunks need.
+  bool canPackChunks() { return chunkSize >= 2 * chunkWidth; }
 
-    mlir::Value carry =
-        rewriter
-            .create<FHE::ZeroEintOp>(op.getLoc(),
-                                     FHE::EncryptedUnsignedIntegerType::get(
-                                         rewriter.getContext(), chunkSize))
+  /// Returns true if the orders of chunks can be computed, combined with the
+  /// table of the carry statuses, and packed with a chunk.
+  bool canCompareChunks() {
+    return canPackChunks() && chunkSize >= 4 && chunkSize >= chunkWidth + 2;
+  }
+
+  mlir::Value add(mlir::Value a, mlir::Value b) {
+    // The combination of two statuses needs 9 values
+    if (carryLookahead && chunkSize >= 4)
+      return carryLookaheadAdd(a, b);
+    return rippleCarryAdd(a, b);
+  }
+
+  /// Multiplies `a` by `b` modulo 2^(chunkWidth * numberOfChunks), summing
+  /// the low and high digits of the products of their chunks, which are
+  /// computed by table lookups on the packed chunks.
+  mlir::Value mul(mlir::Value a, mlir::Value b) {
+    mlir::Value lowTable = table([&](uint64_t packed) {
+      return ((packed / base) * (packed % base)) % base;
+    });
+    mlir::Value highTable = table([&](uint64_t packed) {
+      return ((packed / base) * (packed % base)) / base;
+    });
+    mlir::Value shift = constant(base);
+
+    // The products of the chunk `i` of `a` with the chunks of `b`, in the
+    // columns of their digits
+    llvm::SmallVector<mlir::Value> rows;
+    for (int64_t i = 0; i < numberOfChunks; i++) {
+      mlir::Value aChunk = extract(rewriter, a, index(rewriter, i));
+      mlir::Value shifted =
+          rewriter.create<FHE::MulEintIntOp>(loc, aChunk, shift);
+      auto packed = [&](mlir::OpBuilder &builder, mlir::Value j) {
+        return builder
+            .create<FHE::AddEintOp>(loc, shifted, extract(builder, b, j))
             .getResult();
+      };
+      rows.push_back(digits(i, [&](mlir::OpBuilder &builder, mlir::Value j) {
+        return lookup(builder, packed(builder, j), lowTable);
+      }));
+      if (i + 1 < numberOfChunks)
+        rows.push_back(
+            digits(i + 1, [&](mlir::OpBuilder &builder, mlir::Value j) {
+              return lookup(builder, packed(builder, j), highTable);
+            }));
+    }
+    return sum(rows);
+  }
+
+  /// Multiplies `a` by the constant `c` modulo 2^(chunkWidth *
+  /// numberOfChunks), with a table lookup per digit of the products of the
+  /// chunks of `a` with the digits of `c`.
+  mlir::Value mulByConstant(mlir::Value a, const llvm::APInt &c) {
+    llvm::SmallVector<mlir::Value> rows;
+    for (int64_t i = 0; i < numberOfChunks; i++) {
+      uint64_t digit =
+          c.zextOrTrunc(chunkWidth * numberOfChunks)
+              .extractBitsAsZExtValue(chunkWidth, chunkWidth * i);
+      if (digit == 0)
+        continue;
+      if (digit == 1) {
+        rows.push_back(digits(i, [&](mlir::OpBuilder &builder, mlir::Value j) {
+          return extract(builder, a, j);
+        }));
+        continue;
+      }
+
+      mlir::Value lowTable =
+          table([&](uint64_t x) { return (x * digit) % base; });
+      mlir::Value highTable =
+          table([&](uint64_t x) { return (x * digit) / base; });
+      rows.push_back(digits(i, [&](mlir::OpBuilder &builder, mlir::Value j) {
+        return lookup(builder, extract(builder, a, j), lowTable);
+      }));
+      if (i + 1 < numberOfChunks)
+        rows.push_back(
+            digits(i + 1, [&](mlir::OpBuilder &builder, mlir::Value j) {
+              return lookup(builder, extract(builder, a, j), highTable);
+            }));
+    }
+    if (rows.empty())
+      return rewriter.create<FHE::ZeroTensorOp>(loc, type).getResult();
+    return sum(rows);
+  }
+
+  /// Returns the maximum of `a` and `b`, from the order of their chunks
+  /// reduced by a tree from the most significant ones.
+  mlir::Value max(mlir::Value a, mlir::Value b) {
+    mlir::Value orderTable = table([&](uint64_t packed) {
+      uint64_t x = packed / base, y = packed % base;
+      return x == y ? EQUAL : x > y ? GREATER : LESS;
+    });
+    mlir::Value shift = constant(base);
+    mlir::Value orders =
+        map(0, numberOfChunks, [&](mlir::OpBuilder &builder, mlir::Value i) {
+          mlir::Value packed = builder.create<FHE::AddEintOp>(
+              loc,
+              builder.create<FHE::MulEintIntOp>(loc, extract(builder, a, i),
+                                                shift),
+              extract(builder, b, i));
+          return lookup(builder, packed, orderTable);
+        });
+
+    // Each level combines the orders of pairs of adjacent ranges of chunks
+    mlir::Value three = constant(3);
+    mlir::Value combineTable = getCombineTable();
+    for (int64_t size = numberOfChunks; size > 1; size = (size + 1) / 2) {
+      mlir::Value previous = orders;
+      mlir::Value combined =
+          map(0, size / 2, [&](mlir::OpBuilder &builder, mlir::Value i) {
+            mlir::Value low = builder.create<mlir::arith::MulIOp>(
+                loc, i, index(builder, 2));
+            mlir::Value high = builder.create<mlir::arith::AddIOp>(
+                loc, low, index(builder, 1));
+            return combine(builder, extract(builder, previous, high),
+                           extract(builder, previous, low), three,
+                           combineTable);
+          });
+      if (size % 2 == 1) {
+        combined = rewriter.create<mlir::tensor::InsertOp>(
+            loc, extract(rewriter, previous, index(rewriter, size - 1)),
+            combined, index(rewriter, size / 2));
+      }
+      orders = combined;
+    }
+    mlir::Value order = extract(rewriter, orders, index(rewriter, 0));
+
+    // Each chunk of the result is the one of `a` if a >= b, of `b` otherwise
+    mlir::Value selectA = table([&](uint64_t packed) {
+      return packed / base != LESS ? packed % base : 0;
+    });
+    mlir::Value selectB = table([&](uint64_t packed) {
+      return packed / base != LESS ? 0 : packed % base;
+    });
+    mlir::Value shiftedOrder =
+        rewriter.create<FHE::MulEintIntOp>(loc, order, shift);
+    return map(0, numberOfChunks, [&](mlir::OpBuilder &builder, mlir::Value i) {
+      auto select = [&](mlir::Value x, mlir::Value selectTable) {
+        mlir::Value packed = builder.create<FHE::AddEintOp>(
+            loc, shiftedOrder, extract(builder, x, i));
+        return lookup(builder, packed, selectTable);
+      };
+      return builder
+          .create<FHE::AddEintOp>(loc, select(a, selectA), select(b, selectB))
+          .getResult();
+    });
+  }
 
+private:
+  typedef std::function<mlir::Value(mlir::OpBuilder &, mlir::Value)>
+      ChunkBuilder;
+
+  /// Adds the chunks of `a` and `b` with a carry propagated from the least
+  /// significant chunk to the most significant one.
+  mlir::Value rippleCarryAdd(mlir::Value a, mlir::Value b) {
+    mlir::Value carry =
+        rewriter.create<FHE::ZeroEintOp>(loc, chunkType).getResult();
     mlir::Value resultTensor =
-        rewriter
-            .create<FHE::ZeroTensorOp>(op.getLoc(), adaptor.getA().getType())
-            .getResult();
+        rewriter.create<FHE::ZeroTensorOp>(loc, type).getResult();
+    mlir::Value carryTable = getTruthTableCarryExtract(rewriter, loc,
+                                                       chunkSize, chunkWidth);
     // used to shift the carry bit to the left
-    mlir::Value twoPowerChunkSizeCst =
-        rewriter
-            .create<mlir::arith::ConstantIntOp>(op.getLoc(), 1 << chunkWidth,
-                                                chunkSize + 1)
-            .getResult();
+    mlir::Value twoPowerChunkSizeCst = constant(base);
     // Create the loop
     int64_t lb = 0, step = 1;
     auto forOp = rewriter.create<mlir::AffineForOp>(
-        op.getLoc(), lb, numberOfChunks, step, resultTensor,
+        loc, lb, numberOfChunks, step, mlir::ValueRange{resultTensor, carry},
         [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::Value iter,
             mlir::ValueRange args) {
           // add inputs with the previous carry (init to 0)
-          mlir::Value leftEint = builder.create<mlir::tensor::ExtractOp>(
-              loc, adaptor.getA(), iter);
-          mlir::Value rightEint = builder.create<mlir::tensor::ExtractOp>(
-              loc, adaptor.getB(), iter);
           mlir::Value result =
-              builder.create<FHE::AddEintOp>(loc, leftEint, rightEint)
+              builder
+                  .create<FHE::AddEintOp>(loc, extract(builder, a, iter),
+                                          extract(builder, b, iter))
                   .getResult();
           mlir::Value resultWithCarry =
-              builder.create<FHE::AddEintOp>(loc, result, carry).getResult();
+              builder.create<FHE::AddEintOp>(loc, result, args[1]).getResult();
           // compute the new carry: either 1 or 0
-          carry =
-              rewriter.create<mlir::concretelang::FHE::ApplyLookupTableEintOp>(
-                  op.getLoc(),
-                  FHE::EncryptedUnsignedIntegerType::get(rewriter.getContext(),
-                                                         chunkSize),
-                  resultWithCarry,
-                  getTruthTableCarryExtract(rewriter, op.getLoc(), chunkSize,
-                                            chunkWidth));
+          mlir::Value newCarry = lookup(builder, resultWithCarry, carryTable);
           // remove the carry bit from the result
           mlir::Value shiftedCarry =
               builder
-                  .create<FHE::MulEintIntOp>(loc, carry, twoPowerChunkSizeCst)
+                  .create<FHE::MulEintIntOp>(loc, newCarry,
+                                             twoPowerChunkSizeCst)
                   .getResult();
           mlir::Value finalResult =
               builder.create<FHE::SubEintOp>(loc, resultWithCarry, shiftedCarry)
@@ -159,22 +331,281 @@ public:
           // insert the result in the result tensor
           mlir::Value tensorResult = builder.create<mlir::tensor::InsertOp>(
               loc, finalResult, args[0], iter);
-          builder.create<mlir::AffineYieldOp>(loc, tensorResult);
+          builder.create<mlir::AffineYieldOp>(
+              loc, mlir::ValueRange{tensorResult, newCarry});
         });
-    rewriter.replaceOp(op, forOp.getResult(0));
+    return forOp.getResult(0);
+  }
+
+  /// Adds the chunks of `a` and `b` with the carries computed by a
+  /// Kogge-Stone parallel prefix on the carry statuses of the chunks, which
+  /// takes `log2(numberOfChunks)` dependent table lookups instead of one
+  /// per chunk, for about `numberOfChunks * log2(numberOfChunks)` table
+  /// lookups in total instead of `numberOfChunks`. Each step is a loop whose
+  /// iterations are independent.
+  mlir::Value carryLookaheadAdd(mlir::Value a, mlir::Value b) {
+    // The carry status of a single chunk from the sum of its digits. The
+    // first chunk has no carry in, so it never propagates.
+    mlir::Value firstStatusTable = table([&](uint64_t sum) {
+      return sum >= base ? GENERATE : KILL;
+    });
+    mlir::Value statusTable = table([&](uint64_t sum) {
+      return sum >= base ? GENERATE : sum == base - 1 ? PROPAGATE : KILL;
+    });
+    mlir::Value combineTable = getCombineTable();
+    mlir::Value three = constant(3);
+    mlir::Value twoPowerChunkWidth = constant(base);
+
+    // The sums of the digits, without carries, and their statuses
+    mlir::Value zeros =
+        rewriter.create<FHE::ZeroTensorOp>(loc, type).getResult();
+    mlir::Value zero = index(rewriter, 0);
+    mlir::Value firstSum = rewriter.create<FHE::AddEintOp>(
+        loc, extract(rewriter, a, zero), extract(rewriter, b, zero));
+    mlir::Value sums =
+        rewriter.create<mlir::tensor::InsertOp>(loc, firstSum, zeros, zero);
+    mlir::Value statuses = rewriter.create<mlir::tensor::InsertOp>(
+        loc, lookup(rewriter, firstSum, firstStatusTable), zeros, zero);
+    auto digitsLoop = rewriter.create<mlir::AffineForOp>(
+        loc, 1, numberOfChunks, 1, mlir::ValueRange{sums, statuses},
+        [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::Value iter,
+            mlir::ValueRange args) {
+          mlir::Value sum = builder.create<FHE::AddEintOp>(
+              loc, extract(builder, a, iter), extract(builder, b, iter));
+          mlir::Value status = lookup(builder, sum, statusTable);
+          builder.create<mlir::AffineYieldOp>(
+              loc, mlir::ValueRange{
+                       builder.create<mlir::tensor::InsertOp>(loc, sum,
+                                                              args[0], iter),
+                       builder.create<mlir::tensor::InsertOp>(loc, status,
+                                                              args[1], iter)});
+        });
+    sums = digitsLoop.getResult(0);
+    statuses = digitsLoop.getResult(1);
+
+    // After the step of `distance`, the status of a chunk is the one of the
+    // range of the `2 * distance` chunks ending with it
+    for (int64_t distance = 1; distance < numberOfChunks; distance *= 2) {
+      mlir::Value previous = statuses;
+      statuses = map(
+          distance, numberOfChunks,
+          [&](mlir::OpBuilder &builder, mlir::Value i) {
+            mlir::Value lowIndex = builder.create<mlir::arith::SubIOp>(
+                loc, i, index(builder, distance));
+            return combine(builder, extract(builder, previous, i),
+                           extract(builder, previous, lowIndex), three,
+                           combineTable);
+          },
+          previous);
+    }
+
+    // The statuses are now the carries out of the chunks, the result chunks
+    // are the sums with the carry in, minus the carry out
+    auto carryOut = [&](mlir::OpBuilder &builder, mlir::Value i) {
+      return builder
+          .create<FHE::MulEintIntOp>(loc, extract(builder, statuses, i),
+                                     twoPowerChunkWidth)
+          .getResult();
+    };
+    mlir::Value firstResult = rewriter.create<FHE::SubEintOp>(
+        loc, extract(rewriter, sums, zero), carryOut(rewriter, zero));
+    return map(
+        1, numberOfChunks,
+        [&](mlir::OpBuilder &builder, mlir::Value i) {
+          mlir::Value previousIndex =
+              builder.create<mlir::arith::SubIOp>(loc, i, index(builder, 1));
+          mlir::Value carryIn = extract(builder, statuses, previousIndex);
+          mlir::Value sum = builder.create<FHE::AddEintOp>(
+              loc, extract(builder, sums, i), carryIn);
+          return builder.create<FHE::SubEintOp>(loc, sum, carryOut(builder, i))
+              .getResult();
+        },
+        rewriter.create<mlir::tensor::InsertOp>(loc, firstResult, zeros,
+                                                zero));
+  }
+
+  /// Returns the sum of `rows`, added by a tree.
+  mlir::Value sum(llvm::SmallVector<mlir::Value> rows) {
+    while (rows.size() > 1) {
+      llvm::SmallVector<mlir::Value> sums;
+      for (size_t i = 0; i + 1 < rows.size(); i += 2)
+        sums.push_back(add(rows[i], rows[i + 1]));
+      if (rows.size() % 2 == 1)
+        sums.push_back(rows.back());
+      rows = sums;
+    }
+    return rows.front();
+  }
+
+  /// Returns a chunked integer whose chunks from `first` are built by
+  /// `chunk` from the indices of the chunks from 0, i.e. shifted by `first`
+  /// chunks, and whose other chunks are zeros.
+  mlir::Value digits(int64_t first, ChunkBuilder chunk) {
+    return map(first, numberOfChunks,
+               [&](mlir::OpBuilder &builder, mlir::Value i) {
+                 mlir::Value shifted = builder.create<mlir::arith::SubIOp>(
+                     loc, i, index(builder, first));
+                 return chunk(builder, shifted);
+               });
+  }
+
+  /// Returns a chunked integer whose chunks from `lb` to `ub` are built by
+  /// `chunk` from their index, in a loop of independent iterations, and whose
+  /// other chunks are the ones of `init`, zeros by default.
+  mlir::Value map(int64_t lb, int64_t ub, ChunkBuilder chunk,
+                  mlir::Value init = nullptr) {
+    mlir::Value tensor =
+        init ? init : rewriter.create<FHE::ZeroTensorOp>(loc, type).getResult();
+    if (lb >= ub)
+      return tensor;
+    auto forOp = rewriter.create<mlir::AffineForOp>(
+        loc, lb, ub, 1, tensor,
+        [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::Value iter,
+            mlir::ValueRange args) {
+          mlir::Value value = chunk(builder, iter);
+          builder.create<mlir::AffineYieldOp>(
+              loc,
+              builder.create<mlir::tensor::InsertOp>(loc, value, args[0], iter)
+                  .getResult());
+        });
+    return forOp.getResult(0);
+  }
+
+  /// Returns the status of two adjacent ranges of chunks
+  mlir::Value combine(mlir::OpBuilder &builder, mlir::Value high,
+                      mlir::Value low, mlir::Value three,
+                      mlir::Value combineTable) {
+    mlir::Value shifted = builder.create<FHE::MulEintIntOp>(loc, high, three);
+    mlir::Value packed = builder.create<FHE::AddEintOp>(loc, shifted, low);
+    return lookup(builder, packed, combineTable);
+  }
+
+  /// Returns the table combining two statuses, from `3 * high + low`
+  mlir::Value getCombineTable() {
+    return table([](uint64_t statuses) {
+      uint64_t high = statuses / 3, low = statuses % 3;
+      if (high > PROPAGATE)
+        return (uint64_t)KILL;
+      return high == PROPAGATE ? low : high;
+    });
+  }
+
+  mlir::Value table(std::function<uint64_t(uint64_t)> f) {
+    return getTruthTable(rewriter, loc, chunkSize, f);
+  }
+
+  /// Returns a clear constant to be multiplied with chunks
+  mlir::Value constant(int64_t value) {
+    return rewriter.create<mlir::arith::ConstantIntOp>(loc, value,
+                                                       chunkSize + 1);
+  }
+
+  mlir::Value index(mlir::OpBuilder &builder, int64_t value) {
+    return builder.create<mlir::arith::ConstantIndexOp>(loc, value)
+        .getResult();
+  }
+
+  mlir::Value extract(mlir::OpBuilder &builder, mlir::Value tensor,
+                      mlir::Value i) {
+    return builder.create<mlir::tensor::ExtractOp>(loc, tensor, i).getResult();
+  }
+
+  mlir::Value lookup(mlir::OpBuilder &builder, mlir::Value input,
+                     mlir::Value table) {
+    return builder
+        .create<FHE::ApplyLookupTableEintOp>(loc, chunkType, input, table)
+        .getResult();
+  }
+
+  mlir::PatternRewriter &rewriter;
+  mlir::Location loc;
+  mlir::RankedTensorType type;
+  FHE::EncryptedUnsignedIntegerType chunkType;
+  int64_t numberOfChunks;
+  unsigned int chunkSize, chunkWidth;
+  uint64_t base;
+  bool carryLookahead;
+};
+
+/// Lowers a binary operation on chunked integers with a
+/// `ChunkedIntegerBuilder`
+template <typename Op>
+class ChunkedIntegerPattern : public mlir::OpConversionPattern<Op> {
+public:
+  ChunkedIntegerPattern(mlir::TypeConverter &converter,
+                        mlir::MLIRContext *context, unsigned int chunkSize,
+                        unsigned int chunkWidth, bool carryLookahead)
+      : mlir::OpConversionPattern<Op>(
+            converter, context, ::mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        chunkSize(chunkSize), chunkWidth(chunkWidth),
+        carryLookahead(carryLookahead) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(Op op, typename Op::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    auto tensorType = adaptor.getOperands()[0]
+                          .getType()
+                          .template dyn_cast<mlir::RankedTensorType>();
+    auto shape = tensorType.getShape();
+    assert(shape.size() == 1 &&
+           "chunked integer should be converted to flat tensors, but tensor "
+           "have more than one dimension");
+    auto eintChunkWidth =
+        tensorType.getElementType()
+            .template dyn_cast<FHE::EncryptedUnsignedIntegerType>()
+            .getWidth();
+    assert(eintChunkWidth == chunkSize && "wrong tensor elements width");
+    (void)eintChunkWidth;
+
+    ChunkedIntegerBuilder builder(rewriter, op.getLoc(), tensorType,
+                                  chunkSize, chunkWidth, carryLookahead);
+    mlir::Value result = build(op, adaptor, builder);
+    if (!result)
+      return rewriter.notifyMatchFailure(op, "cannot be lowered to chunks");
+    rewriter.replaceOp(op, result);
     return mlir::success();
   }
 
 private:
+  mlir::Value build(FHE::AddEintOp op, FHE::AddEintOp::Adaptor adaptor,
+                    ChunkedIntegerBuilder &builder) const {
+    return builder.add(adaptor.getA(), adaptor.getB());
+  }
+
+  mlir::Value build(FHE::MulEintOp op, FHE::MulEintOp::Adaptor adaptor,
+                    ChunkedIntegerBuilder &builder) const {
+    if (!builder.canPackChunks())
+      return nullptr;
+    return builder.mul(adaptor.getRhs(), adaptor.getLhs());
+  }
+
+  mlir::Value build(FHE::MulEintIntOp op, FHE::MulEintIntOp::Adaptor adaptor,
+                    ChunkedIntegerBuilder &builder) const {
+    llvm::APInt constant;
+    if (!mlir::matchPattern(adaptor.getB(), mlir::m_ConstantInt(&constant)))
+      return nullptr;
+    return builder.mulByConstant(adaptor.getA(), constant);
+  }
+
+  mlir::Value build(FHE::MaxEintOp op, FHE::MaxEintOp::Adaptor adaptor,
+                    ChunkedIntegerBuilder &builder) const {
+    if (!builder.canCompareChunks())
+      return nullptr;
+    return builder.max(adaptor.getX(), adaptor.getY());
+  }
+
   unsigned int chunkSize, chunkWidth;
+  bool carryLookahead;
 };
 
 /// Performs the transformation of big integer operations
 class FHEBigIntTransformPass
     : public FHEBigIntTransformBase<FHEBigIntTransformPass> {
 public:
-  FHEBigIntTransformPass(unsigned int chunkSize, unsigned int chunkWidth)
-      : chunkSize(chunkSize), chunkWidth(chunkWidth){};
+  FHEBigIntTransformPass(unsigned int chunkSize, unsigned int chunkWidth,
+                         bool carryLookahead)
+      : chunkSize(chunkSize), chunkWidth(chunkWidth),
+        carryLookahead(carryLookahead){};
 
   void runOnOperation() override {
     mlir::Operation *op = getOperation();
@@ -185,11 +616,16 @@ public:
     // Legal ops created during pattern application
     target.addLegalOp<mlir::AffineForOp, mlir::AffineYieldOp,
                       mlir::arith::ConstantOp, mlir::arith::ConstantIndexOp,
-                      FHE::ZeroEintOp, FHE::ZeroTensorOp, FHE::AddEintOp,
-                      FHE::MulEintIntOp, FHE::SubEintOp,
+                      mlir::arith::AddIOp, mlir::arith::MulIOp,
+                      mlir::arith::SubIOp, FHE::ZeroEintOp, FHE::ZeroTensorOp,
+                      FHE::AddEintOp, FHE::MulEintIntOp, FHE::SubEintOp,
                       FHE::ApplyLookupTableEintOp, mlir::tensor::ExtractOp,
                       mlir::tensor::InsertOp>();
     concretelang::addDynamicallyLegalTypeOp<FHE::AddEintOp>(target, converter);
+    concretelang::addDynamicallyLegalTypeOp<FHE::MulEintOp>(target, converter);
+    concretelang::addDynamicallyLegalTypeOp<FHE::MulEintIntOp>(target,
+                                                               converter);
+    concretelang::addDynamicallyLegalTypeOp<FHE::MaxEintOp>(target, converter);
     // Func ops are only legal with converted types
     target.addDynamicallyLegalOp<mlir::func::FuncOp>(
         [&](mlir::func::FuncOp funcOp) {
@@ -203,8 +639,11 @@ public:
     concretelang::addDynamicallyLegalTypeOp<mlir::func::ReturnOp>(target,
                                                                   converter);
 
-    patterns.add<AddEintPattern>(converter, &getContext(), chunkSize,
-                                 chunkWidth);
+    patterns.add<ChunkedIntegerPattern<FHE::AddEintOp>,
+                 ChunkedIntegerPattern<FHE::MulEintOp>,
+                 ChunkedIntegerPattern<FHE::MulEintIntOp>,
+                 ChunkedIntegerPattern<FHE::MaxEintOp>>(
+        converter, &getContext(), chunkSize, chunkWidth, carryLookahead);
 
     if (mlir::applyPartialConversion(op, target, std::move(patterns))
             .failed()) {
@@ -214,15 +653,18 @@ public:
 
 private:
   unsigned int chunkSize, chunkWidth;
+  bool carryLookahead;
 };
 
 } // end anonymous namespace
 
 std::unique_ptr<mlir::OperationPass<>>
-createFHEBigIntTransformPass(unsigned int chunkSize, unsigned int chunkWidth) {
+createFHEBigIntTransformPass(unsigned int chunkSize, unsigned int chunkWidth,
+                             bool carryLookahead) {
   assert(chunkSize >= chunkWidth + 1 &&
          "chunkSize must be greater than chunkWidth");
-  return std::make_unique<FHEBigIntTransformPass>(chunkSize, chunkWidth);
+  return std::make_unique<FHEBigIntTransformPass>(chunkSize, chunkWidth,
+                                                  carryLookahead);
 }
 
 } // namespace concretelang
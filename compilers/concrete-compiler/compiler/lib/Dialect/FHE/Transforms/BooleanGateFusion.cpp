@@ -0,0 +1,259 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/IR/Matchers.h>
+#include <mlir/IR/PatternMatch.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHE/Transforms/Boolean/Boolean.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// A boolean function of a few boolean inputs, computed by a tree of gates.
+/// The bit `i` of `table` is the value of the function when the inputs are
+/// the bits of `i`, the first input being the most significant bit.
+struct Cone {
+  llvm::SmallVector<mlir::Value, 3> inputs;
+  uint64_t table;
+  /// The gates computing the function, in program order
+  llvm::SmallVector<mlir::Operation *> gates;
+
+  /// Returns the function of a single input
+  static Cone input(mlir::Value value) { return Cone{{value}, 0b10, {}}; }
+
+  /// Returns the value of the function when `inputs` take the values of the
+  /// bits of `assignment`, the first of `inputs` being the most significant
+  /// bit.
+  bool evaluate(llvm::ArrayRef<mlir::Value> allInputs,
+                uint64_t assignment) const {
+    uint64_t index = 0;
+    for (mlir::Value value : inputs) {
+      size_t position = llvm::find(allInputs, value) - allInputs.begin();
+      uint64_t bit = (assignment >> (allInputs.size() - 1 - position)) & 1;
+      index = (index << 1) | bit;
+    }
+    return (table >> index) & 1;
+  }
+};
+
+class FHEBooleanGateFusionPass
+    : public FHEBooleanGateFusionBase<FHEBooleanGateFusionPass> {
+public:
+  FHEBooleanGateFusionPass(unsigned int maxInputs) : maxInputs(maxInputs){};
+
+  void runOnOperation() override {
+    mlir::func::FuncOp func = getOperation();
+    llvm::DenseMap<mlir::Value, Cone> cones;
+    llvm::DenseSet<mlir::Operation *> fused;
+    llvm::SmallVector<mlir::Operation *> gates;
+
+    func.walk([&](mlir::Operation *op) {
+      std::optional<uint64_t> gateTable = getGateTable(op);
+      if (!gateTable.has_value())
+        return;
+      gates.push_back(op);
+
+      // A single input gate is applied on both inputs of the table
+      mlir::Value left = op->getOperand(0);
+      mlir::Value right =
+          llvm::isa<FHE::BoolNotOp>(op) ? left : op->getOperand(1);
+
+      Cone cone = fuse(op, *gateTable, left, right, cones, fused);
+      cones.try_emplace(op->getResult(0), cone);
+    });
+
+    // The gates whose results are not fused into other gates are the roots of
+    // the trees to rewrite
+    for (mlir::Operation *op : gates) {
+      if (fused.contains(op))
+        continue;
+      Cone &cone = cones.find(op->getResult(0))->second;
+      if (cone.gates.size() < 2)
+        continue;
+
+      mlir::IRRewriter rewriter(op->getContext());
+      rewriter.setInsertionPoint(op);
+      mlir::Value result = buildLookup(rewriter, op->getLoc(), cone);
+      op->getResult(0).replaceAllUsesWith(result);
+      for (mlir::Operation *gate : llvm::reverse(cone.gates))
+        gate->erase();
+    }
+  }
+
+private:
+  /// Returns the function of the gate `op` on the functions of its operands,
+  /// fusing the gates of the operands which are only used by `op` as long as
+  /// the result depends on at most `maxInputs` booleans.
+  Cone fuse(mlir::Operation *op, uint64_t gateTable, mlir::Value left,
+            mlir::Value right, llvm::DenseMap<mlir::Value, Cone> &cones,
+            llvm::DenseSet<mlir::Operation *> &fused) {
+    auto fusable = [&](mlir::Value value) -> std::optional<Cone> {
+      auto cone = cones.find(value);
+      if (cone == cones.end() ||
+          value.getDefiningOp()->getBlock() != op->getBlock() ||
+          llvm::any_of(value.getUsers(),
+                       [&](mlir::Operation *user) { return user != op; }))
+        return std::nullopt;
+      return cone->second;
+    };
+    std::optional<Cone> leftGates = fusable(left);
+    std::optional<Cone> rightGates = fusable(right);
+
+    // Fuses as many gates as possible, the larger trees first
+    llvm::SmallVector<std::pair<Cone, Cone>, 4> candidates;
+    if (left == right) {
+      if (leftGates)
+        candidates.push_back({*leftGates, *leftGates});
+      leftGates = rightGates = std::nullopt;
+    } else if (leftGates && rightGates) {
+      candidates.push_back({*leftGates, *rightGates});
+    }
+    auto larger = [](const std::optional<Cone> &a,
+                     const std::optional<Cone> &b) {
+      return a && (!b || a->gates.size() >= b->gates.size());
+    };
+    if (larger(leftGates, rightGates)) {
+      candidates.push_back({*leftGates, Cone::input(right)});
+      if (rightGates)
+        candidates.push_back({Cone::input(left), *rightGates});
+    } else if (rightGates) {
+      candidates.push_back({Cone::input(left), *rightGates});
+      if (leftGates)
+        candidates.push_back({*leftGates, Cone::input(right)});
+    }
+    candidates.push_back({Cone::input(left), Cone::input(right)});
+
+    for (auto &[leftCone, rightCone] : candidates) {
+      llvm::SmallVector<mlir::Value, 3> inputs;
+      for (mlir::Value value : leftCone.inputs)
+        inputs.push_back(value);
+      for (mlir::Value value : rightCone.inputs)
+        if (!llvm::is_contained(inputs, value))
+          inputs.push_back(value);
+      if (inputs.size() > maxInputs)
+        continue;
+
+      Cone cone{inputs, 0, {}};
+      for (uint64_t assignment = 0; assignment < (1u << inputs.size());
+           assignment++) {
+        uint64_t index = leftCone.evaluate(inputs, assignment) << 1 |
+                         rightCone.evaluate(inputs, assignment);
+        cone.table |= ((gateTable >> index) & 1) << assignment;
+      }
+      for (Cone *operand : {&leftCone, &rightCone}) {
+        if (operand->gates.empty() ||
+            fused.contains(operand->gates.back()))
+          continue;
+        fused.insert(operand->gates.back());
+        cone.gates.append(operand->gates);
+      }
+      cone.gates.push_back(op);
+      return cone;
+    }
+    llvm_unreachable("the gate alone has at most 2 inputs");
+  }
+
+  /// Returns the truth table of a gate, indexed by `2 * left + right`, or
+  /// nothing if `op` is not a gate with a constant table.
+  static std::optional<uint64_t> getGateTable(mlir::Operation *op) {
+    if (llvm::isa<FHE::BoolAndOp>(op))
+      return 0b1000;
+    if (llvm::isa<FHE::BoolNandOp>(op))
+      return 0b0111;
+    if (llvm::isa<FHE::BoolOrOp>(op))
+      return 0b1110;
+    if (llvm::isa<FHE::BoolXorOp>(op))
+      return 0b0110;
+    // The not of `x` is the gate `not(left)` on `(x, x)`
+    if (llvm::isa<FHE::BoolNotOp>(op))
+      return 0b0001;
+    if (auto genGate = llvm::dyn_cast<FHE::GenGateOp>(op)) {
+      mlir::DenseIntElementsAttr truthTable;
+      if (!mlir::matchPattern(genGate.getTruthTable(),
+                              mlir::m_Constant(&truthTable)) ||
+          truthTable.getNumElements() != 4)
+        return std::nullopt;
+      uint64_t table = 0;
+      auto values = truthTable.getValues<llvm::APInt>();
+      for (int64_t index = 0; index < 4; index++)
+        table |= (uint64_t)!values[index].isZero() << index;
+      return table;
+    }
+    return std::nullopt;
+  }
+
+  /// Builds the table lookup of `cone` on its inputs
+  static mlir::Value buildLookup(mlir::IRRewriter &rewriter,
+                                 mlir::Location loc, const Cone &cone) {
+    auto boolType = FHE::EncryptedBooleanType::get(rewriter.getContext());
+    auto tableOf = [&](llvm::ArrayRef<uint64_t> entries) {
+      llvm::SmallVector<llvm::APInt> values;
+      for (uint64_t entry : entries)
+        values.push_back(llvm::APInt(64, entry, false));
+      return rewriter.create<mlir::arith::ConstantOp>(
+          loc, mlir::DenseElementsAttr::get(
+                   mlir::RankedTensorType::get({(int64_t)entries.size()},
+                                               rewriter.getIntegerType(64)),
+                   values));
+    };
+    auto bit = [&](uint64_t index) { return (cone.table >> index) & 1; };
+
+    // Up to 2 inputs, the lookup is a generic gate, lowered like the others
+    if (cone.inputs.size() == 1) {
+      mlir::Value input = cone.inputs[0];
+      return rewriter.create<FHE::GenGateOp>(
+          loc, boolType, input, input, tableOf({bit(0), 0, 0, bit(1)}));
+    }
+    if (cone.inputs.size() == 2) {
+      return rewriter.create<FHE::GenGateOp>(
+          loc, boolType, cone.inputs[0], cone.inputs[1],
+          tableOf({bit(0), bit(1), bit(2), bit(3)}));
+    }
+
+    // The index of the lookup is `4 * a + 2 * b + c`
+    auto eint3 =
+        FHE::EncryptedUnsignedIntegerType::get(rewriter.getContext(), 3);
+    mlir::Value index;
+    for (size_t position = 0; position < cone.inputs.size(); position++) {
+      mlir::Value term =
+          rewriter.create<FHE::FromBoolOp>(loc, eint3, cone.inputs[position]);
+      uint64_t weight = 1 << (cone.inputs.size() - 1 - position);
+      if (weight > 1) {
+        mlir::Value weightCst =
+            rewriter.create<mlir::arith::ConstantIntOp>(loc, weight, 4);
+        term = rewriter.create<FHE::MulEintIntOp>(loc, term, weightCst);
+      }
+      index = index ? rewriter.create<FHE::AddEintOp>(loc, index, term)
+                          .getResult()
+                    : term;
+    }
+    llvm::SmallVector<uint64_t> entries;
+    for (uint64_t i = 0; i < 8; i++)
+      entries.push_back(bit(i));
+    mlir::Value lookup = rewriter.create<FHE::ApplyLookupTableEintOp>(
+        loc, eint3, index, tableOf(entries));
+    return rewriter.create<FHE::ToBoolOp>(loc, boolType, lookup);
+  }
+
+  unsigned int maxInputs;
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createFHEBooleanGateFusionPass(unsigned int maxInputs) {
+  assert((maxInputs == 2 || maxInputs == 3) &&
+         "boolean gates can only be fused on 2 or 3 inputs");
+  return std::make_unique<FHEBooleanGateFusionPass>(maxInputs);
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -11,6 +11,7 @@
 #include <mlir/Dialect/Bufferization/IR/Bufferization.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/Linalg/IR/Linalg.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
 #include <mlir/IR/PatternMatch.h>
 #include <mlir/Support/LLVM.h>
 #include <mlir/Transforms/DialectConversion.h>
@@ -22,12 +23,19 @@ namespace mlir {
 namespace concretelang {
 namespace {
 
+/// The tables extended to 64 bits, by original table and signedness of the
+/// extension.
+typedef llvm::DenseMap<std::pair<mlir::Value, bool>, mlir::Value>
+    ExtendedLuts;
+
 struct ApplyLookupTableEintOpPattern
     : public mlir::OpConversionPattern<FHE::ApplyLookupTableEintOp> {
 
-  ApplyLookupTableEintOpPattern(mlir::MLIRContext *context)
+  ApplyLookupTableEintOpPattern(mlir::MLIRContext *context,
+                                ExtendedLuts &extendedLuts)
       : mlir::OpConversionPattern<FHE::ApplyLookupTableEintOp>(
-            context, ::mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+            context, ::mlir::concretelang::DEFAULT_PATTERN_BENEFIT),
+        extendedLuts(extendedLuts) {}
 
   mlir::LogicalResult
   matchAndRewrite(FHE::ApplyLookupTableEintOp op,
@@ -41,28 +49,65 @@ struct ApplyLookupTableEintOpPattern
 
     bool outputIsSigned =
         op.getResult().getType().cast<FHE::FheIntegerInterface>().isSigned();
-    auto inputLutType = op.getLut().getType();
 
+    mlir::Value extendedLut =
+        extendLut(adaptor.getLut(), outputIsSigned, rewriter);
+
+    auto newOp = rewriter.replaceOpWithNewOp<FHE::ApplyLookupTableEintOp>(
+        op, op.getResult().getType(), op.getA(), extendedLut);
+
+    // Propagating the Oid if any ...
+    auto optimizerIdAttr = op->getAttr("TFHE.OId");
+    if (optimizerIdAttr != nullptr)
+      newOp->setAttr("TFHE.OId", optimizerIdAttr);
+
+    return mlir::success();
+  };
+
+private:
+  /// Returns `lut` extended to 64 bits. The extension is made right after the
+  /// definition of the table and shared by all its lookups, such that the
+  /// lookups made in loops on a table defined outside can be batched. The
+  /// tables sliced out of a tensor of tables, e.g. by the lookups of a
+  /// `FHELinalg.apply_mapped_lookup_table`, are sliced out of the extended
+  /// tensor instead, which lets the bootstraps be batched with a table per
+  /// ciphertext.
+  mlir::Value extendLut(mlir::Value lut, bool isSigned,
+                        mlir::ConversionPatternRewriter &rewriter) const {
+    auto lutType = lut.getType().cast<mlir::RankedTensorType>();
+    if (lutType.getElementType().getIntOrFloatBitWidth() == 64)
+      return lut;
+
+    auto cached = extendedLuts.find({lut, isSigned});
+    if (cached != extendedLuts.end())
+      return cached->second;
+
+    mlir::OpBuilder::InsertionGuard guard(rewriter);
+    mlir::Type extendedType = lutType.clone(rewriter.getI64Type());
     mlir::Value extendedLut;
-    if (inputLutType.getElementType().getIntOrFloatBitWidth() == 64) {
-      extendedLut = adaptor.getLut();
+
+    if (auto slice = lut.getDefiningOp<mlir::tensor::ExtractSliceOp>()) {
+      mlir::Value source = extendLut(slice.getSource(), isSigned, rewriter);
+      rewriter.setInsertionPoint(slice);
+      extendedLut = rewriter.create<mlir::tensor::ExtractSliceOp>(
+          slice.getLoc(), extendedType, source, slice.getMixedOffsets(),
+          slice.getMixedSizes(), slice.getMixedStrides());
     } else {
       // This is implemented as a map since the `arith.extsi` is not
       // bufferizable :(
+      rewriter.setInsertionPointAfterValue(lut);
+      mlir::Location loc = lut.getLoc();
       mlir::Value init = rewriter.create<mlir::bufferization::AllocTensorOp>(
-          op.getLoc(),
-          mlir::RankedTensorType::get(inputLutType.getShape(),
-                                      rewriter.getI64Type()),
-          mlir::ValueRange{});
+          loc, extendedType, mlir::ValueRange{});
 
       extendedLut =
           rewriter
               .create<mlir::linalg::MapOp>(
-                  op.getLoc(), mlir::ValueRange{adaptor.getLut()}, init,
+                  loc, mlir::ValueRange{lut}, init,
                   [&](mlir::OpBuilder &builder, mlir::Location loc,
                       mlir::ValueRange args) {
                     mlir::Value extended;
-                    if (outputIsSigned) {
+                    if (isSigned) {
                       extended = builder.create<mlir::arith::ExtSIOp>(
                           loc, builder.getI64Type(), args[0]);
                     } else {
@@ -75,16 +120,11 @@ struct ApplyLookupTableEintOpPattern
               ->getResult(0);
     }
 
-    auto newOp = rewriter.replaceOpWithNewOp<FHE::ApplyLookupTableEintOp>(
-        op, op.getResult().getType(), op.getA(), extendedLut);
-
-    // Propagating the Oid if any ...
-    auto optimizerIdAttr = op->getAttr("TFHE.OId");
-    if (optimizerIdAttr != nullptr)
-      newOp->setAttr("TFHE.OId", optimizerIdAttr);
+    extendedLuts[{lut, isSigned}] = extendedLut;
+    return extendedLut;
+  }
 
-    return mlir::success();
-  };
+  ExtendedLuts &extendedLuts;
 };
 
 } // namespace
@@ -98,7 +138,8 @@ public:
 
     target.addLegalDialect<mlir::arith::ArithDialect>();
     target.addLegalOp<mlir::linalg::MapOp, mlir::linalg::YieldOp,
-                      mlir::bufferization::AllocTensorOp>();
+                      mlir::bufferization::AllocTensorOp,
+                      mlir::tensor::ExtractSliceOp>();
     target.addLegalDialect<FHE::FHEDialect>();
     target.addDynamicallyLegalOp<FHE::ApplyLookupTableEintOp>(
         [&](FHE::ApplyLookupTableEintOp op) {
@@ -110,7 +151,9 @@ public:
 
     mlir::RewritePatternSet patterns(funcOp->getContext());
 
-    patterns.add<ApplyLookupTableEintOpPattern>(funcOp->getContext());
+    ExtendedLuts extendedLuts;
+    patterns.add<ApplyLookupTableEintOpPattern>(funcOp->getContext(),
+                                                extendedLuts);
 
     if (mlir::applyPartialConversion(funcOp, target, std::move(patterns))
             .failed()) {
@@ -0,0 +1,265 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/PatternMatch.h"
+
+#include "concretelang/Dialect/FHE/IR/FHEOps.h"
+#include "concretelang/Dialect/FHE/Transforms/SplitReductions/SplitReductions.h"
+
+#include <cmath>
+
+namespace arith = mlir::arith;
+namespace scf = mlir::scf;
+namespace tensor = mlir::tensor;
+
+namespace FHE = mlir::concretelang::FHE;
+
+namespace {
+
+/// The trip count under which a reduction loop is left sequential, the
+/// additions of its partial sums costing about as much as those they save.
+constexpr int64_t MIN_TRIP_COUNT = 4;
+
+static bool isMarkedParallel(scf::ForOp forOp, bool parallel) {
+  auto attr = forOp->getAttrOfType<mlir::BoolAttr>("parallel");
+  return attr != nullptr && attr.getValue() == parallel;
+}
+
+/// Returns true if the accumulator `acc`, a tensor of encrypted integers
+/// yielded as the operand `position` of `terminator`, is only updated by
+/// adding values independent of it to its elements, i.e. by chains of
+/// `tensor.extract`, `FHE.add_eint` and `tensor.insert` at the same indices,
+/// possibly in nested loops. The additions are appended to `additions`.
+static bool isAccumulation(mlir::Value acc, mlir::Operation *terminator,
+                           unsigned position,
+                           llvm::SmallVectorImpl<FHE::AddEintOp> &additions) {
+  while (true) {
+    if (acc.hasOneUse()) {
+      mlir::OpOperand &use = *acc.getUses().begin();
+      if (use.getOwner() == terminator)
+        return use.getOperandNumber() == position;
+
+      auto forOp = llvm::dyn_cast<scf::ForOp>(use.getOwner());
+      if (!forOp || use.getOperandNumber() < forOp.getNumControlOperands())
+        return false;
+      unsigned iterArg = use.getOperandNumber() - forOp.getNumControlOperands();
+      if (!isAccumulation(forOp.getRegionIterArgs()[iterArg],
+                          forOp.getBody()->getTerminator(), iterArg,
+                          additions))
+        return false;
+      acc = forOp.getResult(iterArg);
+      continue;
+    }
+
+    // An element is read, added to and written back at the same indices
+    tensor::ExtractOp extract;
+    tensor::InsertOp insert;
+    for (mlir::Operation *user : acc.getUsers()) {
+      if (auto extractOp = llvm::dyn_cast<tensor::ExtractOp>(user))
+        extract = extractOp;
+      else if (auto insertOp = llvm::dyn_cast<tensor::InsertOp>(user))
+        insert = insertOp;
+    }
+    if (!extract || !insert || !llvm::hasNItems(acc.getUses(), 2) ||
+        insert.getDest() != acc ||
+        !llvm::equal(extract.getIndices(), insert.getIndices()) ||
+        !extract.getResult().hasOneUse())
+      return false;
+
+    auto addition =
+        llvm::dyn_cast<FHE::AddEintOp>(*extract.getResult().user_begin());
+    if (!addition || addition.getA() == addition.getB() ||
+        !addition.getResult().hasOneUse() ||
+        insert.getScalar() != addition.getResult())
+      return false;
+
+    additions.push_back(addition);
+    acc = insert.getResult();
+  }
+}
+
+/// Returns true if `forOp` is a reduction loop which can be split, i.e. a
+/// sequential loop with a static trip count of at least `MIN_TRIP_COUNT`,
+/// not nested in a parallel loop, accumulating into a tensor of encrypted
+/// integers with `FHE.add_eint`.
+static bool
+isSplittableReduction(scf::ForOp forOp,
+                      llvm::SmallVectorImpl<FHE::AddEintOp> &additions) {
+  if (!isMarkedParallel(forOp, false) || forOp.getNumRegionIterArgs() != 1)
+    return false;
+
+  for (auto parent = forOp->getParentOfType<scf::ForOp>(); parent;
+       parent = parent->getParentOfType<scf::ForOp>())
+    if (isMarkedParallel(parent, true))
+      return false;
+
+  auto accType =
+      forOp.getRegionIterArgs()[0].getType().dyn_cast<mlir::RankedTensorType>();
+  if (!accType || !accType.hasStaticShape() ||
+      !accType.getElementType().isa<FHE::FheIntegerInterface>())
+    return false;
+
+  std::optional<int64_t> lb = mlir::getConstantIntValue(forOp.getLowerBound());
+  std::optional<int64_t> ub = mlir::getConstantIntValue(forOp.getUpperBound());
+  std::optional<int64_t> step = mlir::getConstantIntValue(forOp.getStep());
+  if (!lb.has_value() || !ub.has_value() || !step.has_value() || *step <= 0 ||
+      (*ub - *lb + *step - 1) / *step < MIN_TRIP_COUNT)
+    return false;
+
+  return isAccumulation(forOp.getRegionIterArgs()[0],
+                        forOp.getBody()->getTerminator(), 0, additions) &&
+         !additions.empty();
+}
+
+/// Splits the reduction loop `forOp` into chunks of consecutive iterations
+/// accumulating into partial tensors, computed by a parallel loop, and adds
+/// the partial tensors to the initial accumulator. `addition` is one of the
+/// additions of the accumulation, whose optimizer identifier is given to
+/// the additions of the partial tensors.
+///
+/// About the square root of the trip count of chunks are created, such that
+/// the additions of the partial tensors are about as many as those of a
+/// chunk.
+static void splitReduction(mlir::RewriterBase &rewriter, scf::ForOp forOp,
+                           FHE::AddEintOp addition) {
+  mlir::Location loc = forOp.getLoc();
+  rewriter.setInsertionPoint(forOp);
+
+  int64_t lb = *mlir::getConstantIntValue(forOp.getLowerBound());
+  int64_t ub = *mlir::getConstantIntValue(forOp.getUpperBound());
+  int64_t step = *mlir::getConstantIntValue(forOp.getStep());
+  int64_t tripCount = (ub - lb + step - 1) / step;
+  int64_t numChunks = (int64_t)std::ceil(std::sqrt((double)tripCount));
+  int64_t chunkSize = (tripCount + numChunks - 1) / numChunks;
+  numChunks = (tripCount + chunkSize - 1) / chunkSize;
+
+  auto accType =
+      forOp.getRegionIterArgs()[0].getType().cast<mlir::RankedTensorType>();
+  llvm::SmallVector<int64_t> partialsShape{numChunks};
+  partialsShape.append(accType.getShape().begin(), accType.getShape().end());
+  auto partialsType = accType.clone(partialsShape);
+
+  // The partial tensor of the chunk `chunk`, as a slice of the partials
+  llvm::SmallVector<mlir::OpFoldResult> sizes{rewriter.getIndexAttr(1)};
+  llvm::SmallVector<mlir::OpFoldResult> strides{rewriter.getIndexAttr(1)};
+  for (int64_t size : accType.getShape()) {
+    sizes.push_back(rewriter.getIndexAttr(size));
+    strides.push_back(rewriter.getIndexAttr(1));
+  }
+  auto offsets = [&](mlir::Value chunk) {
+    llvm::SmallVector<mlir::OpFoldResult> offsets{chunk};
+    offsets.append(accType.getRank(), rewriter.getIndexAttr(0));
+    return offsets;
+  };
+
+  mlir::Value c0 = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  mlir::Value c1 = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+  mlir::Value zeros =
+      rewriter.create<FHE::ZeroTensorOp>(loc, partialsType).getResult();
+
+  auto chunksLoop = rewriter.create<scf::ForOp>(
+      loc, c0, rewriter.create<arith::ConstantIndexOp>(loc, numChunks), c1,
+      mlir::ValueRange{zeros},
+      [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::Value chunk,
+          mlir::ValueRange partials) {
+        mlir::Value chunkStep =
+            builder.create<arith::ConstantIndexOp>(loc, chunkSize * step);
+        mlir::Value lower = builder.create<arith::AddIOp>(
+            loc, forOp.getLowerBound(),
+            builder.create<arith::MulIOp>(loc, chunk, chunkStep));
+        mlir::Value upper = builder.create<arith::MinSIOp>(
+            loc, builder.create<arith::AddIOp>(loc, lower, chunkStep),
+            forOp.getUpperBound());
+        mlir::Value partial = builder.create<tensor::ExtractSliceOp>(
+            loc, accType, partials[0], offsets(chunk), sizes, strides);
+
+        auto chunkLoop = builder.create<scf::ForOp>(
+            loc, lower, upper, forOp.getStep(), mlir::ValueRange{partial},
+            [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::Value iv,
+                mlir::ValueRange acc) {
+              mlir::IRMapping mapping;
+              mapping.map(forOp.getInductionVar(), iv);
+              mapping.map(forOp.getRegionIterArgs()[0], acc[0]);
+              for (mlir::Operation &op : forOp.getBody()->without_terminator())
+                builder.clone(op, mapping);
+              auto yield =
+                  llvm::cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+              builder.create<scf::YieldOp>(
+                  loc, mapping.lookupOrDefault(yield.getOperand(0)));
+            });
+        chunkLoop->setAttr("parallel", builder.getBoolAttr(false));
+
+        mlir::Value updated = builder.create<tensor::InsertSliceOp>(
+            loc, chunkLoop.getResult(0), partials[0], offsets(chunk), sizes,
+            strides);
+        builder.create<scf::YieldOp>(loc, updated);
+      });
+  chunksLoop->setAttr("parallel", rewriter.getBoolAttr(true));
+
+  // Add the partial tensors to the initial accumulator
+  llvm::SmallVector<mlir::Value> lbs(partialsType.getRank(), c0);
+  llvm::SmallVector<mlir::Value> steps(partialsType.getRank(), c1);
+  llvm::SmallVector<mlir::Value> ubs;
+  for (int64_t size : partialsShape)
+    ubs.push_back(rewriter.create<arith::ConstantIndexOp>(loc, size));
+  auto optimizerId = addition->getAttr("TFHE.OId");
+  scf::LoopNest combination = scf::buildLoopNest(
+      rewriter, loc, lbs, ubs, steps, forOp.getInitArgs(),
+      [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::ValueRange ivs,
+          mlir::ValueRange acc) -> scf::ValueVector {
+        mlir::Value partial = builder.create<tensor::ExtractOp>(
+            loc, chunksLoop.getResult(0), ivs);
+        mlir::Value current =
+            builder.create<tensor::ExtractOp>(loc, acc[0], ivs.drop_front());
+        auto sum = builder.create<FHE::AddEintOp>(loc, current, partial);
+        if (optimizerId != nullptr)
+          sum->setAttr("TFHE.OId", optimizerId);
+        mlir::Value updated = builder.create<tensor::InsertOp>(
+            loc, sum.getResult(), acc[0], ivs.drop_front());
+        return {updated};
+      });
+
+  rewriter.replaceOp(forOp, combination.results);
+}
+
+struct FHESplitReductionsPass
+    : public FHESplitReductionsBase<FHESplitReductionsPass> {
+
+  void runOnOperation() final {
+    // The outermost reductions are split first, and the loops nested in a
+    // split reduction are skipped, as they are then nested in its parallel
+    // loop over the chunks
+    llvm::SmallVector<std::pair<scf::ForOp, FHE::AddEintOp>> reductions;
+    this->getOperation()->walk<mlir::WalkOrder::PreOrder>(
+        [&](scf::ForOp forOp) {
+          llvm::SmallVector<FHE::AddEintOp> additions;
+          if (!isSplittableReduction(forOp, additions))
+            return mlir::WalkResult::advance();
+          reductions.push_back({forOp, additions.front()});
+          return mlir::WalkResult::skip();
+        });
+
+    mlir::IRRewriter rewriter(&this->getContext());
+    for (auto [forOp, addition] : reductions)
+      splitReduction(rewriter, forOp, addition);
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+
+std::unique_ptr<mlir::OperationPass<>> createFHESplitReductionsPass() {
+  return std::make_unique<FHESplitReductionsPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,130 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Builders.h>
+
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/EncryptedMatMulToSharedTLU.h>
+
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+class EncryptedMatMulToSharedTLUPass
+    : public EncryptedMatMulToSharedTLUBase<EncryptedMatMulToSharedTLUPass> {
+public:
+  void runOnOperation() override {
+    std::vector<FHELinalg::MatMulEintEintOp> matmuls;
+    getOperation().walk(
+        [&](FHELinalg::MatMulEintEintOp op) { matmuls.push_back(op); });
+
+    for (FHELinalg::MatMulEintEintOp op : matmuls)
+      rewrite(op);
+  }
+
+private:
+  /// Replaces `matmul(lhs, rhs)`, with lhs of shape MxK and rhs of shape
+  /// KxN, by:
+  ///
+  ///   sum(T(expand(lhs, MxKx1) + rhs), axis 1)
+  ///     - sum(T(lhs), axis 1, keep dims)
+  ///     - sum(T(rhs), axis 0, keep dims)
+  static void rewrite(FHELinalg::MatMulEintEintOp op) {
+    auto lhsType = op.getLhs().getType().cast<mlir::RankedTensorType>();
+    auto rhsType = op.getRhs().getType().cast<mlir::RankedTensorType>();
+    auto outType = op.getResult().getType().cast<mlir::RankedTensorType>();
+
+    if (lhsType.getRank() != 2 || rhsType.getRank() != 2 ||
+        lhsType.getElementType() != outType.getElementType() ||
+        rhsType.getElementType() != outType.getElementType())
+      return;
+
+    int64_t m = lhsType.getDimSize(0);
+    int64_t k = lhsType.getDimSize(1);
+    int64_t n = rhsType.getDimSize(1);
+
+    // A double table lookup per product otherwise
+    if (m * k + k * n >= m * n * k)
+      return;
+
+    mlir::OpBuilder builder(op);
+    mlir::Location loc = op.getLoc();
+    mlir::Type elementType = outType.getElementType();
+    auto integerType = elementType.cast<FHE::FheIntegerInterface>();
+
+    mlir::Value lut = builder.create<mlir::arith::ConstantOp>(
+        loc, triangularLut(integerType.getWidth(), integerType.isSigned(),
+                           builder));
+    auto lookup = [&](mlir::Value tensor) {
+      return builder
+          .create<FHELinalg::ApplyLookupTableEintOp>(loc, tensor.getType(),
+                                                     tensor, lut)
+          .getResult();
+    };
+    auto sum = [&](mlir::Value tensor, int64_t axis, bool keepDims,
+                   llvm::ArrayRef<int64_t> shape) {
+      return builder
+          .create<FHELinalg::SumOp>(
+              loc, mlir::RankedTensorType::get(shape, elementType), tensor,
+              builder.getI64ArrayAttr({axis}), builder.getBoolAttr(keepDims))
+          .getResult();
+    };
+
+    // The sums of each row of lhs with each column of rhs, broadcasted as a
+    // MxKxN tensor
+    mlir::Value lhsColumns = builder.create<mlir::tensor::ExpandShapeOp>(
+        loc, mlir::RankedTensorType::get({m, k, 1}, elementType), op.getLhs(),
+        llvm::SmallVector<mlir::ReassociationIndices>{{0}, {1, 2}});
+    mlir::Value sums = builder.create<FHELinalg::AddEintOp>(
+        loc, mlir::RankedTensorType::get({m, k, n}, elementType), lhsColumns,
+        op.getRhs());
+
+    mlir::Value sumsTerms = sum(lookup(sums), 1, false, {m, n});
+    mlir::Value lhsTerms = sum(lookup(op.getLhs()), 1, true, {m, 1});
+    mlir::Value rhsTerms = sum(lookup(op.getRhs()), 0, true, {1, n});
+
+    mlir::Value result =
+        builder.create<FHELinalg::SubEintOp>(loc, outType, sumsTerms, lhsTerms);
+    result =
+        builder.create<FHELinalg::SubEintOp>(loc, outType, result, rhsTerms);
+
+    op.getResult().replaceAllUsesWith(result);
+    op.erase();
+  }
+
+  /// Returns the table of `T(x) = x*(x-1)/2` modulo 2^width, indexed by the
+  /// encoding of x. Since `T(a+b) - T(a) - T(b) = a*b` in the integers, the
+  /// products are exact modulo 2^width as long as `a+b` fits in the width.
+  static mlir::DenseIntElementsAttr
+  triangularLut(unsigned width, bool isSigned, mlir::OpBuilder &builder) {
+    int64_t size = (int64_t)1 << width;
+    llvm::SmallVector<uint64_t> table;
+    for (int64_t i = 0; i < size; i++) {
+      int64_t x = (isSigned && i >= size / 2) ? i - size : i;
+      int64_t t = (x * (x - 1) / 2) % size;
+      table.push_back(t < 0 ? t + size : t);
+    }
+    return mlir::DenseIntElementsAttr::get(
+        mlir::RankedTensorType::get({size}, builder.getIntegerType(64)),
+        table);
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createEncryptedMatMulToSharedTLUPass() {
+  return std::make_unique<EncryptedMatMulToSharedTLUPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
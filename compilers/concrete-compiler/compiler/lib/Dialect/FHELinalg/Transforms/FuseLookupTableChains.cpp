@@ -0,0 +1,229 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Matchers.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/FuseLookupTableChains.h>
+
+#include <optional>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// A leveled operation by a constant, computing `scale * x + offset` modulo
+/// `2^width` on its encrypted operand `x`.
+struct AffineStep {
+  uint64_t scale;
+  uint64_t offset;
+  unsigned int width;
+};
+
+class FuseLookupTableChainsPass
+    : public FuseLookupTableChainsBase<FuseLookupTableChainsPass> {
+public:
+  FuseLookupTableChainsPass(std::map<std::string, uint64_t> *counts)
+      : counts(counts){};
+
+  void runOnOperation() override {
+    for (auto func : getOperation().getOps<mlir::func::FuncOp>()) {
+      std::vector<mlir::Operation *> lookups;
+      func.walk([&](mlir::Operation *op) {
+        if (isLookup(op))
+          lookups.push_back(op);
+      });
+
+      // The fused lookups replace the last lookup of their chain, so they
+      // can be fused again with the lookups of their users
+      uint64_t saved = 0;
+      for (mlir::Operation *op : lookups)
+        saved += fuse(op);
+
+      if (counts != nullptr)
+        (*counts)[func.getName().str()] = saved;
+    }
+  }
+
+private:
+  static bool isLookup(mlir::Operation *op) {
+    return llvm::isa<FHE::ApplyLookupTableEintOp,
+                     FHELinalg::ApplyLookupTableEintOp>(op);
+  }
+
+  /// Returns the width of the encrypted integers of `type`, or of its
+  /// elements for a tensor.
+  static unsigned int widthOf(mlir::Type type) {
+    if (auto tensor = type.dyn_cast<mlir::RankedTensorType>())
+      type = tensor.getElementType();
+    return type.cast<FHE::FheIntegerInterface>().getWidth();
+  }
+
+  /// Returns the value of a constant integer or splat tensor of integers,
+  /// modulo `2^64`.
+  static std::optional<uint64_t> constantValue(mlir::Value value) {
+    mlir::Attribute attr;
+    if (!mlir::matchPattern(value, mlir::m_Constant(&attr)))
+      return std::nullopt;
+    if (auto integer = attr.dyn_cast<mlir::IntegerAttr>())
+      return integer.getValue().sextOrTrunc(64).getZExtValue();
+    auto dense = attr.dyn_cast<mlir::DenseIntElementsAttr>();
+    if (!dense || !dense.isSplat())
+      return std::nullopt;
+    return dense.getSplatValue<llvm::APInt>().sextOrTrunc(64).getZExtValue();
+  }
+
+  /// Returns the step computed by the leveled operation `op`, and sets
+  /// `operand` to its encrypted operand, or nothing if `op` is not a leveled
+  /// operation by a constant which can be fused.
+  static std::optional<AffineStep> affineStep(mlir::Operation *op,
+                                              mlir::Value &operand) {
+    if (op->getNumResults() != 1)
+      return std::nullopt;
+    mlir::Type type = op->getResult(0).getType();
+    std::optional<uint64_t> constant;
+    AffineStep step;
+
+    if (llvm::isa<FHE::NegEintOp, FHELinalg::NegEintOp>(op)) {
+      operand = op->getOperand(0);
+      constant = 0;
+      step = {(uint64_t)-1, 0, 0};
+    } else if (llvm::isa<FHE::SubIntEintOp, FHELinalg::SubIntEintOp>(op)) {
+      operand = op->getOperand(1);
+      constant = constantValue(op->getOperand(0));
+      step = {(uint64_t)-1, constant.value_or(0), 0};
+    } else if (llvm::isa<FHE::AddEintIntOp, FHELinalg::AddEintIntOp>(op)) {
+      operand = op->getOperand(0);
+      constant = constantValue(op->getOperand(1));
+      step = {1, constant.value_or(0), 0};
+    } else if (llvm::isa<FHE::SubEintIntOp, FHELinalg::SubEintIntOp>(op)) {
+      operand = op->getOperand(0);
+      constant = constantValue(op->getOperand(1));
+      step = {1, -constant.value_or(0), 0};
+    } else if (llvm::isa<FHE::MulEintIntOp, FHELinalg::MulEintIntOp>(op)) {
+      operand = op->getOperand(0);
+      constant = constantValue(op->getOperand(1));
+      step = {constant.value_or(0), 0, 0};
+    } else {
+      return std::nullopt;
+    }
+
+    // A broadcast would map an element to several ones, which cannot be
+    // expressed by an elementwise lookup
+    if (!constant || operand.getType() != type)
+      return std::nullopt;
+    step.width = widthOf(type);
+    return step;
+  }
+
+  /// Returns the entries of the constant table of the lookup `op`, or
+  /// nothing if it is not a constant table of `2^width` entries.
+  static std::optional<std::vector<llvm::APInt>>
+  tableOf(mlir::Operation *op, unsigned int width) {
+    mlir::DenseIntElementsAttr table;
+    if (!mlir::matchPattern(op->getOperand(1), mlir::m_Constant(&table)) ||
+        width >= 32 || table.getNumElements() != ((int64_t)1 << width))
+      return std::nullopt;
+    return std::vector<llvm::APInt>(table.value_begin<llvm::APInt>(),
+                                    table.value_end<llvm::APInt>());
+  }
+
+  /// Fuses the lookup `op` with the lookup computing its input through
+  /// leveled operations by constants, and returns the number of bootstraps
+  /// saved.
+  uint64_t fuse(mlir::Operation *op) {
+    std::vector<mlir::Operation *> chain;
+    std::vector<AffineStep> steps;
+    mlir::Value value = op->getOperand(0);
+    mlir::Operation *first = nullptr;
+    while (true) {
+      mlir::Operation *def = value.getDefiningOp();
+      if (def == nullptr || def->getBlock() != op->getBlock() ||
+          !value.hasOneUse())
+        return 0;
+      if (isLookup(def)) {
+        first = def;
+        break;
+      }
+      mlir::Value operand;
+      std::optional<AffineStep> step = affineStep(def, operand);
+      if (!step)
+        return 0;
+      chain.push_back(def);
+      steps.push_back(*step);
+      value = operand;
+    }
+
+    mlir::Value input = first->getOperand(0);
+    unsigned int inputWidth = widthOf(input.getType());
+    unsigned int intermediateWidth = widthOf(first->getResult(0).getType());
+    unsigned int lastWidth = widthOf(op->getOperand(0).getType());
+    std::optional<std::vector<llvm::APInt>> firstTable =
+        tableOf(first, inputWidth);
+    std::optional<std::vector<llvm::APInt>> lastTable = tableOf(op, lastWidth);
+    if (!firstTable || !lastTable)
+      return 0;
+
+    // The arithmetic modulo 2^64 is the same as modulo the smaller powers of
+    // two, so the values are only truncated to the width of each result
+    auto truncate = [](uint64_t x, unsigned int width) {
+      return x & (((uint64_t)1 << width) - 1);
+    };
+    std::vector<int64_t> entries;
+    entries.reserve(firstTable->size());
+    for (const llvm::APInt &entry : *firstTable) {
+      uint64_t x =
+          truncate(entry.sextOrTrunc(64).getZExtValue(), intermediateWidth);
+      for (const AffineStep &step : llvm::reverse(steps))
+        x = truncate(step.scale * x + step.offset, step.width);
+      entries.push_back((*lastTable)[x].sextOrTrunc(64).getSExtValue());
+    }
+
+    mlir::OpBuilder builder(op);
+    mlir::Value lut = builder.create<mlir::arith::ConstantOp>(
+        op->getLoc(),
+        mlir::DenseIntElementsAttr::get(
+            mlir::RankedTensorType::get({(int64_t)entries.size()},
+                                        builder.getIntegerType(64)),
+            entries));
+    mlir::Type resultType = op->getResult(0).getType();
+    mlir::Operation *fused;
+    if (llvm::isa<FHE::ApplyLookupTableEintOp>(op))
+      fused = builder.create<FHE::ApplyLookupTableEintOp>(
+          op->getLoc(), resultType, input, lut);
+    else
+      fused = builder.create<FHELinalg::ApplyLookupTableEintOp>(
+          op->getLoc(), resultType, input, lut);
+
+    op->getResult(0).replaceAllUsesWith(fused->getResult(0));
+    op->erase();
+    for (mlir::Operation *leveled : chain)
+      leveled->erase();
+    first->erase();
+
+    if (auto tensor = resultType.dyn_cast<mlir::RankedTensorType>())
+      return tensor.getNumElements();
+    return 1;
+  }
+
+  std::map<std::string, uint64_t> *counts;
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createFuseLookupTableChainsPass(std::map<std::string, uint64_t> *counts) {
+  return std::make_unique<FuseLookupTableChainsPass>(counts);
+}
+
+} // namespace concretelang
+} // namespace mlir
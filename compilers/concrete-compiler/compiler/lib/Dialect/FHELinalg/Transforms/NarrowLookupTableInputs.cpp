@@ -0,0 +1,365 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <llvm/Support/MathExtras.h>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Matchers.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/NarrowLookupTableInputs.h>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// The bounds of the value of an encrypted integer, or of the values of all
+/// the elements of a tensor of encrypted integers.
+struct Range {
+  int64_t min;
+  int64_t max;
+};
+
+class NarrowLookupTableInputsPass
+    : public NarrowLookupTableInputsBase<NarrowLookupTableInputsPass> {
+public:
+  void runOnOperation() override {
+    ranges.clear();
+    narrowed.clear();
+
+    std::vector<mlir::Operation *> lookups;
+    getOperation().walk([&](mlir::Operation *op) {
+      if (op->getNumResults() == 1) {
+        mlir::Value result = op->getResult(0);
+        std::optional<Range> declared = declaredRange(result.getType());
+        std::optional<Range> range = inferRange(op);
+        // The values out of the declared precision wrap around
+        if (declared && range && range->min >= declared->min &&
+            range->max <= declared->max)
+          ranges[result] = *range;
+      }
+      if (llvm::isa<FHE::ApplyLookupTableEintOp,
+                    FHELinalg::ApplyLookupTableEintOp>(op))
+        lookups.push_back(op);
+    });
+
+    for (mlir::Operation *op : lookups)
+      narrow(op);
+  }
+
+private:
+  /// Returns the range of the values of the encrypted integers of `type`,
+  /// or nothing if `type` is not encrypted.
+  static std::optional<Range> declaredRange(mlir::Type type) {
+    if (auto tensor = type.dyn_cast<mlir::RankedTensorType>())
+      type = tensor.getElementType();
+    auto integer = type.dyn_cast<FHE::FheIntegerInterface>();
+    if (!integer || integer.getWidth() >= 63)
+      return std::nullopt;
+
+    int64_t size = (int64_t)1 << integer.getWidth();
+    if (integer.isSigned())
+      return Range{-size / 2, size / 2 - 1};
+    return Range{0, size - 1};
+  }
+
+  std::optional<Range> rangeOf(mlir::Value value) {
+    auto range = ranges.find(value);
+    if (range != ranges.end())
+      return range->second;
+    return declaredRange(value.getType());
+  }
+
+  /// Returns the bounds of a constant integer or tensor of integers.
+  static std::optional<Range> constantRange(mlir::Value value) {
+    mlir::Attribute attr;
+    if (!mlir::matchPattern(value, mlir::m_Constant(&attr)))
+      return std::nullopt;
+
+    std::optional<Range> range;
+    auto extend = [&](const llvm::APInt &element) {
+      int64_t x = element.getSExtValue();
+      range = range ? Range{std::min(range->min, x), std::max(range->max, x)}
+                    : Range{x, x};
+    };
+    if (auto integer = attr.dyn_cast<mlir::IntegerAttr>())
+      extend(integer.getValue());
+    else if (auto dense = attr.dyn_cast<mlir::DenseIntElementsAttr>())
+      for (llvm::APInt element : dense)
+        extend(element);
+    return range;
+  }
+
+  static std::optional<Range> add(std::optional<Range> a,
+                                  std::optional<Range> b) {
+    Range r;
+    if (!a || !b || llvm::AddOverflow(a->min, b->min, r.min) ||
+        llvm::AddOverflow(a->max, b->max, r.max))
+      return std::nullopt;
+    return r;
+  }
+
+  static std::optional<Range> sub(std::optional<Range> a,
+                                  std::optional<Range> b) {
+    Range r;
+    if (!a || !b || llvm::SubOverflow(a->min, b->max, r.min) ||
+        llvm::SubOverflow(a->max, b->min, r.max))
+      return std::nullopt;
+    return r;
+  }
+
+  static std::optional<Range> mul(std::optional<Range> a,
+                                  std::optional<Range> b) {
+    if (!a || !b)
+      return std::nullopt;
+    std::optional<Range> r;
+    for (int64_t x : {a->min, a->max}) {
+      for (int64_t y : {b->min, b->max}) {
+        int64_t product;
+        if (llvm::MulOverflow(x, y, product))
+          return std::nullopt;
+        r = r ? Range{std::min(r->min, product), std::max(r->max, product)}
+              : Range{product, product};
+      }
+    }
+    return r;
+  }
+
+  /// Returns the range of the sums of `count` values of `range`.
+  static std::optional<Range> sum(std::optional<Range> range, int64_t count) {
+    return mul(range, Range{count, count});
+  }
+
+  /// Returns the union of the ranges of the encrypted operands of `op`.
+  std::optional<Range> unionOfOperands(mlir::Operation *op) {
+    std::optional<Range> r;
+    for (mlir::Value operand : op->getOperands()) {
+      if (!declaredRange(operand.getType()))
+        continue;
+      std::optional<Range> range = rangeOf(operand);
+      r = r ? Range{std::min(r->min, range->min),
+                    std::max(r->max, range->max)}
+            : range;
+    }
+    return r;
+  }
+
+  /// Returns the range of the entries of a constant table `lut` which can be
+  /// looked up by an input of `inputRange`, as values of encrypted integers
+  /// of `resultType`. The tables of a tensor of tables are contiguous.
+  static std::optional<Range> lookupRange(mlir::Value lut,
+                                          std::optional<Range> inputRange,
+                                          mlir::Type inputType,
+                                          mlir::Type resultType) {
+    mlir::DenseIntElementsAttr table;
+    std::optional<Range> declared = declaredRange(resultType);
+    if (!inputRange || !declared ||
+        !mlir::matchPattern(lut, mlir::m_Constant(&table)))
+      return std::nullopt;
+
+    bool inputSigned = declaredRange(inputType)->min < 0;
+    bool resultSigned = declared->min < 0;
+    int64_t tableSize = table.getType().getShape().back();
+    int64_t modulus = declared->max - declared->min + 1;
+
+    std::optional<Range> r;
+    int64_t index = 0;
+    for (llvm::APInt entry : table) {
+      int64_t i = index++ % tableSize;
+      int64_t x = (inputSigned && i >= tableSize / 2) ? i - tableSize : i;
+      if (x < inputRange->min || x > inputRange->max)
+        continue;
+
+      int64_t y = entry.getSExtValue() % modulus;
+      if (y < 0)
+        y += modulus;
+      if (resultSigned && y > declared->max)
+        y -= modulus;
+      r = r ? Range{std::min(r->min, y), std::max(r->max, y)} : Range{y, y};
+    }
+    return r;
+  }
+
+  /// Returns the range of the result of `op` computed from the ranges of its
+  /// operands, or nothing if it is unknown.
+  std::optional<Range> inferRange(mlir::Operation *op) {
+    if (llvm::isa<FHE::ZeroEintOp, FHE::ZeroTensorOp>(op))
+      return Range{0, 0};
+
+    if (llvm::isa<FHE::AddEintOp, FHELinalg::AddEintOp>(op))
+      return add(rangeOf(op->getOperand(0)), rangeOf(op->getOperand(1)));
+    if (llvm::isa<FHE::SubEintOp, FHELinalg::SubEintOp>(op))
+      return sub(rangeOf(op->getOperand(0)), rangeOf(op->getOperand(1)));
+    if (llvm::isa<FHE::AddEintIntOp, FHELinalg::AddEintIntOp>(op))
+      return add(rangeOf(op->getOperand(0)), constantRange(op->getOperand(1)));
+    if (llvm::isa<FHE::SubEintIntOp, FHELinalg::SubEintIntOp>(op))
+      return sub(rangeOf(op->getOperand(0)), constantRange(op->getOperand(1)));
+    if (llvm::isa<FHE::MulEintIntOp, FHELinalg::MulEintIntOp>(op))
+      return mul(rangeOf(op->getOperand(0)), constantRange(op->getOperand(1)));
+
+    if (llvm::isa<FHE::ApplyLookupTableEintOp,
+                  FHELinalg::ApplyLookupTableEintOp,
+                  FHELinalg::ApplyMultiLookupTableEintOp,
+                  FHELinalg::ApplyMappedLookupTableEintOp>(op)) {
+      mlir::Value input = op->getOperand(0);
+      return lookupRange(op->getOperand(1), rangeOf(input), input.getType(),
+                         op->getResult(0).getType());
+    }
+
+    if (auto sumOp = llvm::dyn_cast<FHELinalg::SumOp>(op)) {
+      auto inputType = sumOp.getInput().getType().cast<mlir::ShapedType>();
+      int64_t outputElements = 1;
+      if (auto outputType =
+              sumOp.getResult().getType().dyn_cast<mlir::ShapedType>())
+        outputElements = outputType.getNumElements();
+      if (outputElements == 0)
+        return std::nullopt;
+      return sum(rangeOf(sumOp.getInput()),
+                 inputType.getNumElements() / outputElements);
+    }
+
+    // The products summed by a dot product or a matrix multiplication are
+    // bounded by the ones of the encrypted operand and the clear constant
+    if (llvm::isa<FHELinalg::Dot, FHELinalg::MatMulEintIntOp>(op)) {
+      auto lhsType = op->getOperand(0).getType().cast<mlir::ShapedType>();
+      return sum(
+          mul(rangeOf(op->getOperand(0)), constantRange(op->getOperand(1))),
+          lhsType.getShape().back());
+    }
+    if (auto matmul = llvm::dyn_cast<FHELinalg::MatMulIntEintOp>(op)) {
+      auto rhsType = matmul.getRhs().getType().cast<mlir::ShapedType>();
+      int64_t rank = rhsType.getRank();
+      int64_t k = rhsType.getDimSize(rank == 1 ? 0 : rank - 2);
+      return sum(mul(constantRange(matmul.getLhs()), rangeOf(matmul.getRhs())),
+                 k);
+    }
+
+    // The operations moving encrypted integers around
+    if (llvm::isa<mlir::tensor::ExtractOp, mlir::tensor::FromElementsOp,
+                  mlir::tensor::InsertOp, mlir::tensor::ExtractSliceOp,
+                  mlir::tensor::InsertSliceOp, mlir::tensor::CollapseShapeOp,
+                  mlir::tensor::ExpandShapeOp, FHELinalg::TransposeOp,
+                  FHELinalg::ConcatOp>(op))
+      return unionOfOperands(op);
+
+    return std::nullopt;
+  }
+
+  /// Lowers the precision of the input of the table lookup `op` to the bits
+  /// its values can use, if it is lower than the declared one.
+  void narrow(mlir::Operation *op) {
+    mlir::Value input = op->getOperand(0);
+    mlir::DenseIntElementsAttr table;
+    std::optional<Range> range = rangeOf(input);
+    if (!range || range->min < 0 ||
+        !mlir::matchPattern(op->getOperand(1), mlir::m_Constant(&table)))
+      return;
+
+    mlir::Type elementType = input.getType();
+    if (auto tensor = elementType.dyn_cast<mlir::RankedTensorType>())
+      elementType = tensor.getElementType();
+    unsigned width = elementType.cast<FHE::FheIntegerInterface>().getWidth();
+    unsigned narrowWidth =
+        std::max(1u, llvm::Log2_64_Ceil((uint64_t)range->max + 1));
+    if (narrowWidth >= width)
+      return;
+
+    mlir::OpBuilder builder(op);
+    mlir::Location loc = op->getLoc();
+
+    // Only the entries indexed by the narrowed input are kept
+    int64_t narrowSize = (int64_t)1 << narrowWidth;
+    auto entries = llvm::to_vector(table.getValues<llvm::APInt>());
+    entries.resize(narrowSize);
+    mlir::Value lut = builder.create<mlir::arith::ConstantOp>(
+        loc, mlir::DenseIntElementsAttr::get(
+                 mlir::RankedTensorType::get({narrowSize},
+                                             table.getType().getElementType()),
+                 entries));
+
+    mlir::Value narrowInput = narrowPrecision(input, narrowWidth);
+    mlir::Value result;
+    if (llvm::isa<FHE::ApplyLookupTableEintOp>(op))
+      result = builder.create<FHE::ApplyLookupTableEintOp>(
+          loc, op->getResult(0).getType(), narrowInput, lut);
+    else
+      result = builder.create<FHELinalg::ApplyLookupTableEintOp>(
+          loc, op->getResult(0).getType(), narrowInput, lut);
+
+    op->getResult(0).replaceAllUsesWith(result);
+    op->erase();
+  }
+
+  /// Returns `input` reinterpreted with a precision of `width` bits, after
+  /// moving its value to the most significant bits. The narrowed values are
+  /// shared between the table lookups of a same input.
+  mlir::Value narrowPrecision(mlir::Value input, unsigned width) {
+    auto key = std::make_pair(input, width);
+    auto cached = narrowed.find(key);
+    if (cached != narrowed.end())
+      return cached->second;
+
+    mlir::OpBuilder builder(&getContext());
+    builder.setInsertionPointAfterValue(input);
+    mlir::Location loc = input.getLoc();
+
+    auto tensorType = input.getType().dyn_cast<mlir::RankedTensorType>();
+    mlir::Type elementType =
+        tensorType ? tensorType.getElementType() : input.getType();
+    unsigned inputWidth =
+        elementType.cast<FHE::FheIntegerInterface>().getWidth();
+    mlir::IntegerType clearType = builder.getIntegerType(inputWidth + 1);
+    llvm::APInt shift(inputWidth + 1, (uint64_t)1 << (inputWidth - width));
+    mlir::Type narrowType =
+        FHE::EncryptedUnsignedIntegerType::get(&getContext(), width);
+
+    mlir::Value result;
+    if (tensorType) {
+      mlir::Value factor = builder.create<mlir::arith::ConstantOp>(
+          loc, mlir::DenseElementsAttr::get(
+                   mlir::RankedTensorType::get(tensorType.getShape(),
+                                               clearType),
+                   shift));
+      mlir::Value shifted = builder.create<FHELinalg::MulEintIntOp>(
+          loc, input.getType(), input, factor);
+      result = builder.create<FHELinalg::ReinterpretPrecisionEintOp>(
+          loc, mlir::RankedTensorType::get(tensorType.getShape(), narrowType),
+          shifted);
+    } else {
+      mlir::Value factor = builder.create<mlir::arith::ConstantOp>(
+          loc, builder.getIntegerAttr(clearType, shift));
+      mlir::Value shifted = builder.create<FHE::MulEintIntOp>(
+          loc, input.getType(), input, factor);
+      result = builder.create<FHE::ReinterpretPrecisionEintOp>(loc, narrowType,
+                                                               shifted);
+    }
+
+    narrowed[key] = result;
+    return result;
+  }
+
+  llvm::DenseMap<mlir::Value, Range> ranges;
+  llvm::DenseMap<std::pair<mlir::Value, unsigned>, mlir::Value> narrowed;
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createNarrowLookupTableInputsPass() {
+  return std::make_unique<NarrowLookupTableInputsPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,151 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/IR/Builders.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/RoundWithLookupTables.h>
+
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+class RoundWithLookupTablesPass
+    : public RoundWithLookupTablesBase<RoundWithLookupTablesPass> {
+public:
+  RoundWithLookupTablesPass(unsigned maxPrecision)
+      : maxPrecision(maxPrecision){};
+
+  void runOnOperation() override {
+    std::vector<mlir::Operation *> rounds;
+    getOperation().walk([&](mlir::Operation *op) {
+      if (llvm::isa<FHE::RoundEintOp, FHELinalg::RoundOp>(op))
+        rounds.push_back(op);
+    });
+
+    for (mlir::Operation *op : rounds)
+      rewrite(op);
+  }
+
+private:
+  static FHE::FheIntegerInterface getElementType(mlir::Type type) {
+    if (auto tensor = type.dyn_cast<mlir::RankedTensorType>())
+      type = tensor.getElementType();
+    return type.cast<FHE::FheIntegerInterface>();
+  }
+
+  /// Returns `elementType`, as the type of the elements of a tensor if
+  /// `like` is a tensor type.
+  static mlir::Type getTypeLike(mlir::Type like, mlir::Type elementType) {
+    if (auto tensor = like.dyn_cast<mlir::RankedTensorType>())
+      return mlir::RankedTensorType::get(tensor.getShape(), elementType);
+    return elementType;
+  }
+
+  void rewrite(mlir::Operation *op) {
+    mlir::Value input = op->getOperand(0);
+    mlir::Type resultType = op->getResult(0).getType();
+    FHE::FheIntegerInterface inputType = getElementType(input.getType());
+    unsigned inputWidth = inputType.getWidth();
+    unsigned outputWidth = getElementType(resultType).getWidth();
+    bool isSigned = inputType.isSigned();
+
+    // The lowest bits are removed bit by bit, down to the maximum precision
+    // of the table lookup removing the others
+    unsigned removed = inputWidth - outputWidth;
+    unsigned truncated =
+        inputWidth > maxPrecision ? inputWidth - maxPrecision : 0;
+    if (removed < truncated + 2)
+      return;
+    unsigned lookupWidth = inputWidth - truncated;
+    unsigned lookupRemoved = removed - truncated;
+    bool isTensor = input.getType().isa<mlir::RankedTensorType>();
+
+    mlir::OpBuilder builder(op);
+    mlir::Location loc = op->getLoc();
+    mlir::Value value = input;
+    uint64_t lookupCarry = (uint64_t)1 << (removed - 1);
+
+    if (truncated > 0) {
+      // The bit by bit rounding adds the carry of the bits it removes, the
+      // carry of the whole rounding is completed beforehand
+      uint64_t carry = ((uint64_t)1 << (removed - 1)) -
+                       ((uint64_t)1 << (truncated - 1));
+      mlir::IntegerType clearType = builder.getIntegerType(inputWidth + 1);
+      llvm::APInt rawCarry(inputWidth + 1, carry);
+      if (isTensor) {
+        mlir::Value carryCst = builder.create<mlir::arith::ConstantOp>(
+            loc, mlir::DenseElementsAttr::get(
+                     getTypeLike(input.getType(), clearType)
+                         .cast<mlir::RankedTensorType>(),
+                     rawCarry));
+        value = builder.create<FHELinalg::AddEintIntOp>(loc, input.getType(),
+                                                        value, carryCst);
+      } else {
+        mlir::Value carryCst = builder.create<mlir::arith::ConstantOp>(
+            loc, builder.getIntegerAttr(clearType, rawCarry));
+        value = builder.create<FHE::AddEintIntOp>(loc, input.getType(), value,
+                                                  carryCst);
+      }
+
+      mlir::Type truncatedElementType =
+          isSigned ? (mlir::Type)FHE::EncryptedSignedIntegerType::get(
+                         &getContext(), lookupWidth)
+                   : (mlir::Type)FHE::EncryptedUnsignedIntegerType::get(
+                         &getContext(), lookupWidth);
+      mlir::Type truncatedType =
+          getTypeLike(input.getType(), truncatedElementType);
+      if (isTensor)
+        value = builder.create<FHELinalg::RoundOp>(loc, truncatedType, value);
+      else
+        value = builder.create<FHE::RoundEintOp>(loc, truncatedType, value);
+      lookupCarry = 0;
+    }
+
+    // The table is indexed by the bits of the input, the signed values being
+    // in two's complement, and the signed results are encoded as such
+    std::vector<int64_t> table;
+    uint64_t outputSize = (uint64_t)1 << outputWidth;
+    for (uint64_t bits = 0; bits < ((uint64_t)1 << lookupWidth); bits++) {
+      uint64_t rounded = ((bits + lookupCarry) >> lookupRemoved) % outputSize;
+      if (isSigned && rounded >= outputSize / 2)
+        table.push_back((int64_t)rounded - (int64_t)outputSize);
+      else
+        table.push_back((int64_t)rounded);
+    }
+    mlir::Value lut = builder.create<mlir::arith::ConstantOp>(
+        loc, builder.getI64TensorAttr(table));
+
+    mlir::Operation *lookup;
+    if (isTensor)
+      lookup = builder.create<FHELinalg::ApplyLookupTableEintOp>(
+          loc, resultType, value, lut);
+    else
+      lookup = builder.create<FHE::ApplyLookupTableEintOp>(loc, resultType,
+                                                           value, lut);
+
+    op->getResult(0).replaceAllUsesWith(lookup->getResult(0));
+    op->erase();
+  }
+
+  unsigned maxPrecision;
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createRoundWithLookupTablesPass(unsigned maxPrecision) {
+  return std::make_unique<RoundWithLookupTablesPass>(maxPrecision);
+}
+
+} // namespace concretelang
+} // namespace mlir
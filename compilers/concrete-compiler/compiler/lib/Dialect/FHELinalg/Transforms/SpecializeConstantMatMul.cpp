@@ -0,0 +1,191 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Matchers.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/SpecializeConstantMatMul.h>
+
+#include <map>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// The maximum number of leveled operations on columns a multiplication is
+/// specialized into, bounding the size of the unrolled IR
+static const int64_t MAX_SPECIALIZED_OPS = 4096;
+
+class SpecializeConstantMatMulPass
+    : public SpecializeConstantMatMulBase<SpecializeConstantMatMulPass> {
+public:
+  void runOnOperation() override {
+    std::vector<FHELinalg::MatMulEintIntOp> matmuls;
+    getOperation().walk(
+        [&](FHELinalg::MatMulEintIntOp op) { matmuls.push_back(op); });
+
+    for (FHELinalg::MatMulEintIntOp op : matmuls)
+      rewrite(op);
+  }
+
+private:
+  /// The indexes of the rows of the weights of a column of the result,
+  /// grouped by their weight, without the zero weights
+  typedef std::map<int64_t, std::vector<int64_t>> WeightGroups;
+
+  /// Replaces `matmul(lhs, rhs)`, with lhs of shape MxK and a constant rhs
+  /// of shape KxN, by the sums of the columns of lhs grouped by weight, each
+  /// multiplied once by its weight.
+  static void rewrite(FHELinalg::MatMulEintIntOp op) {
+    auto lhsType = op.getLhs().getType().cast<mlir::RankedTensorType>();
+    auto rhsType = op.getRhs().getType().cast<mlir::RankedTensorType>();
+    auto outType = op.getResult().getType().cast<mlir::RankedTensorType>();
+
+    mlir::DenseIntElementsAttr weights;
+    if (lhsType.getRank() != 2 || rhsType.getRank() != 2 ||
+        !lhsType.hasStaticShape() || !rhsType.hasStaticShape() ||
+        !mlir::matchPattern(op.getRhs(), mlir::m_Constant(&weights)))
+      return;
+
+    int64_t m = lhsType.getDimSize(0);
+    int64_t k = lhsType.getDimSize(1);
+    int64_t n = rhsType.getDimSize(1);
+
+    std::vector<int64_t> values;
+    for (const llvm::APInt &value : weights.getValues<llvm::APInt>())
+      values.push_back(value.getSExtValue());
+
+    std::vector<WeightGroups> columns(n);
+    for (int64_t row = 0; row < k; row++) {
+      for (int64_t col = 0; col < n; col++) {
+        int64_t weight = values[row * n + col];
+        if (weight != 0)
+          columns[col][weight].push_back(row);
+      }
+    }
+
+    // Each group costs an addition per row but the first, a multiplication
+    // unless the weight is 1 or -1, and its addition to the other groups
+    int64_t specializedOps = 0;
+    for (const WeightGroups &groups : columns) {
+      for (auto &group : groups) {
+        specializedOps += group.second.size();
+        if (group.first != 1 && group.first != -1)
+          specializedOps++;
+      }
+    }
+
+    // The generic computation makes K multiplications and K-1 additions per
+    // column
+    if (specializedOps >= n * (2 * k - 1) ||
+        specializedOps > MAX_SPECIALIZED_OPS)
+      return;
+
+    mlir::OpBuilder builder(op);
+    mlir::Location loc = op.getLoc();
+    auto columnType =
+        mlir::RankedTensorType::get({m}, outType.getElementType());
+    auto weightType =
+        mlir::RankedTensorType::get({m}, rhsType.getElementType());
+    llvm::SmallVector<mlir::OpFoldResult> ones(2, builder.getIndexAttr(1));
+    llvm::SmallVector<mlir::OpFoldResult> columnSizes{builder.getIndexAttr(m),
+                                                      builder.getIndexAttr(1)};
+
+    // The columns of lhs are shared by the columns of the result
+    std::map<int64_t, mlir::Value> lhsColumns;
+    auto lhsColumn = [&](int64_t row) {
+      mlir::Value &column = lhsColumns[row];
+      if (!column) {
+        column = builder
+                     .create<mlir::tensor::ExtractSliceOp>(
+                         loc, columnType, op.getLhs(),
+                         llvm::SmallVector<mlir::OpFoldResult>{
+                             builder.getIndexAttr(0),
+                             builder.getIndexAttr(row)},
+                         columnSizes, ones)
+                     .getResult();
+      }
+      return column;
+    };
+    auto add = [&](mlir::Value lhs, mlir::Value rhs) {
+      return builder.create<FHELinalg::AddEintOp>(loc, columnType, lhs, rhs)
+          .getResult();
+    };
+    auto sub = [&](mlir::Value lhs, mlir::Value rhs) {
+      return builder.create<FHELinalg::SubEintOp>(loc, columnType, lhs, rhs)
+          .getResult();
+    };
+    auto neg = [&](mlir::Value value) {
+      return builder.create<FHELinalg::NegEintOp>(loc, columnType, value)
+          .getResult();
+    };
+    auto weightOf = [&](int64_t weight) {
+      llvm::APInt value(weightType.getElementTypeBitWidth(), weight, true);
+      return builder
+          .create<mlir::arith::ConstantOp>(
+              loc, mlir::DenseIntElementsAttr::get(weightType, value))
+          .getResult();
+    };
+
+    mlir::Value result =
+        builder.create<FHE::ZeroTensorOp>(loc, outType).getResult();
+    for (int64_t col = 0; col < n; col++) {
+      if (columns[col].empty())
+        continue;
+
+      // The terms subtracted from the column, for the weight -1, are only
+      // negated if there is no other term to subtract them from
+      mlir::Value column;
+      llvm::SmallVector<mlir::Value> subtracted;
+      for (auto &group : columns[col]) {
+        mlir::Value term;
+        for (int64_t row : group.second)
+          term = term ? add(term, lhsColumn(row)) : lhsColumn(row);
+
+        if (group.first == -1) {
+          subtracted.push_back(term);
+          continue;
+        }
+        if (group.first != 1) {
+          term = builder
+                     .create<FHELinalg::MulEintIntOp>(loc, columnType, term,
+                                                      weightOf(group.first))
+                     .getResult();
+        }
+        column = column ? add(column, term) : term;
+      }
+      for (mlir::Value term : subtracted)
+        column = column ? sub(column, term) : neg(term);
+
+      result = builder
+                   .create<mlir::tensor::InsertSliceOp>(
+                       loc, column, result,
+                       llvm::SmallVector<mlir::OpFoldResult>{
+                           builder.getIndexAttr(0), builder.getIndexAttr(col)},
+                       columnSizes, ones)
+                   .getResult();
+    }
+
+    op.getResult().replaceAllUsesWith(result);
+    op.erase();
+  }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createSpecializeConstantMatMulPass() {
+  return std::make_unique<SpecializeConstantMatMulPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -23,6 +23,10 @@
 #include <concretelang/Dialect/FHELinalg/Transforms/Tiling.h>
 #include <concretelang/Support/Constants.h>
 
+#include <algorithm>
+#include <optional>
+#include <thread>
+
 namespace mlir {
 namespace concretelang {
 
@@ -218,6 +222,125 @@ protected:
   std::vector<int64_t> tileSizes;
 };
 
+/// Marks the `FHELinalg` matrix multiplications with a "tile-sizes"
+/// attribute tiling their reduction, with a tile size selected from the
+/// cost model described by `AutoTilingParameters`.
+///
+/// The reduction of a multiplication of K elements tiled with a size
+/// tK yields ceil(K / tK) tiles computing partial results concurrently,
+/// each holding a whole output of partial sums. The tile size is the
+/// smallest one such that there are no more tiles than the available
+/// parallelism, each tile has at least the minimum number of PBS and
+/// the ciphertexts of all tiles fit in the memory limit.
+///
+/// The multiplications of a vector by a matrix, and other operations
+/// such as dot products or convolutions, are not marked as their
+/// reduction is not supported by the tiling.
+class FHELinalgAutoTilingMarkerPass
+    : public FHELinalgAutoTilingMarkerBase<FHELinalgAutoTilingMarkerPass> {
+public:
+  FHELinalgAutoTilingMarkerPass(AutoTilingParameters parameters)
+      : parameters(parameters) {
+    if (this->parameters.parallelism <= 0)
+      this->parameters.parallelism =
+          std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  void runOnOperation() override {
+    mlir::Operation *op = getOperation();
+    mlir::Builder builder(&this->getContext());
+
+    op->walk([&](mlir::Operation *op) {
+      if (!llvm::isa<mlir::concretelang::FHELinalg::MatMulEintIntOp,
+                     mlir::concretelang::FHELinalg::MatMulIntEintOp,
+                     mlir::concretelang::FHELinalg::MatMulEintEintOp>(op) ||
+          op->hasAttr("tile-sizes"))
+        return;
+
+      std::optional<int64_t> tileSize = selectReductionTileSize(op);
+
+      if (!tileSize.has_value())
+        return;
+
+      // The reduction is the last of the iterators, after the ones of
+      // the dimensions of the output
+      int64_t outputRank =
+          op->getResult(0).getType().cast<mlir::RankedTensorType>().getRank();
+      llvm::SmallVector<int64_t> tileSizes(outputRank + 1, 0);
+      tileSizes.back() = *tileSize;
+
+      op->setAttr("tile-sizes", builder.getI64ArrayAttr(tileSizes));
+    });
+  }
+
+protected:
+  /// Returns the tile size of the reduction of the matrix multiplication
+  /// `op`, or `std::nullopt` if it should not be tiled.
+  std::optional<int64_t> selectReductionTileSize(mlir::Operation *op) {
+    mlir::RankedTensorType lhsType =
+        op->getOperand(0).getType().dyn_cast<mlir::RankedTensorType>();
+    mlir::RankedTensorType rhsType =
+        op->getOperand(1).getType().dyn_cast<mlir::RankedTensorType>();
+    mlir::RankedTensorType outputType =
+        op->getResult(0).getType().dyn_cast<mlir::RankedTensorType>();
+
+    if (!lhsType || !rhsType || !outputType || lhsType.getRank() < 2 ||
+        !lhsType.hasStaticShape() || !rhsType.hasStaticShape() ||
+        !outputType.hasStaticShape())
+      return std::nullopt;
+
+    int64_t reductionSize = lhsType.getShape().back();
+    int64_t outputs = outputType.getNumElements();
+
+    if (reductionSize < 2)
+      return std::nullopt;
+
+    auto isEncrypted = [](mlir::RankedTensorType type) {
+      return type.getElementType()
+          .isa<mlir::concretelang::FHE::FheIntegerInterface>();
+    };
+
+    // Each product of two encrypted integers is computed with two PBS,
+    // the other products and the sums do not need any
+    int64_t pbsPerProduct =
+        llvm::isa<mlir::concretelang::FHELinalg::MatMulEintEintOp>(op) ? 2
+                                                                        : 0;
+    int64_t encryptedInputs =
+        (isEncrypted(lhsType) ? lhsType.getNumElements() : 0) +
+        (isEncrypted(rhsType) ? rhsType.getNumElements() : 0);
+
+    int64_t maxTiles = parameters.parallelism;
+
+    // Each tile holds the partial sums of a whole output, while the
+    // inputs are split between the tiles
+    if (parameters.maxMemory > 0) {
+      int64_t availableCiphertexts =
+          parameters.maxMemory / parameters.ciphertextSize - encryptedInputs;
+      maxTiles = std::min(maxTiles, availableCiphertexts / outputs);
+    }
+
+    if (maxTiles < 2)
+      return std::nullopt;
+
+    int64_t tileSize = ceilDiv(reductionSize, maxTiles);
+
+    if (pbsPerProduct > 0 && parameters.minPbsPerTile > 0) {
+      tileSize = std::max(tileSize, ceilDiv(parameters.minPbsPerTile,
+                                            outputs * pbsPerProduct));
+    }
+
+    if (tileSize >= reductionSize)
+      return std::nullopt;
+
+    // Balance the reduction between the tiles
+    return ceilDiv(reductionSize, ceilDiv(reductionSize, tileSize));
+  }
+
+  static int64_t ceilDiv(int64_t a, int64_t b) { return (a + b - 1) / b; }
+
+  AutoTilingParameters parameters;
+};
+
 std::unique_ptr<mlir::OperationPass<>> createLinalgTilingPass() {
   return std::make_unique<LinalgTilingPass>();
 }
@@ -226,5 +349,10 @@ std::unique_ptr<mlir::OperationPass<>>
 createFHELinalgTilingMarkerPass(llvm::ArrayRef<int64_t> tileSizes) {
   return std::make_unique<FHELinalgTilingMarkerPass>(tileSizes);
 }
+
+std::unique_ptr<mlir::OperationPass<>>
+createFHELinalgAutoTilingMarkerPass(AutoTilingParameters parameters) {
+  return std::make_unique<FHELinalgAutoTilingMarkerPass>(parameters);
+}
 } // namespace concretelang
 } // namespace mlir
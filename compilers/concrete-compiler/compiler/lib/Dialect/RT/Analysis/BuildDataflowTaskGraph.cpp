@@ -3,9 +3,11 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include <algorithm>
 #include <iostream>
 
 #include "concretelang/Dialect/FHE/Interfaces/FHEInterfaces.h"
+#include <concretelang/Analysis/StaticLoops.h>
 #include <concretelang/Dialect/FHE/IR/FHEDialect.h>
 #include <concretelang/Dialect/FHE/IR/FHEOps.h>
 #include <concretelang/Dialect/FHE/IR/FHETypes.h>
@@ -19,6 +21,7 @@
 
 #include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/SCF/Utils/Utils.h>
 #include <mlir/IR/Attributes.h>
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/BuiltinAttributes.h>
@@ -133,6 +136,10 @@ LogicalResult coarsenDFTask(RT::DataflowTaskOp taskOp) {
   return success();
 }
 
+/// Maximum number of operations of the body of a loop once unrolled, to
+/// bound the compile time of the programs with large loops.
+static const int64_t MAX_UNROLLED_OPS = 4096;
+
 /// For documentation see Autopar.td
 struct BuildDataflowTaskGraphPass
     : public BuildDataflowTaskGraphBase<BuildDataflowTaskGraphPass> {
@@ -141,10 +148,13 @@ struct BuildDataflowTaskGraphPass
     auto module = getOperation();
 
     module.walk([&](mlir::func::FuncOp func) {
-      if (!func->getAttr("_dfr_work_function_attribute"))
+      if (!func->getAttr("_dfr_work_function_attribute")) {
+        if (unrollFactor > 1)
+          unrollTaskLoops(func);
         func.walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *childOp) {
           return this->processOperation(childOp);
         });
+      }
 
       // Perform simplifications, in particular DCE here in case some
       // of the operations sunk in tasks are no longer needed in the
@@ -157,9 +167,49 @@ struct BuildDataflowTaskGraphPass
       (void)mlir::simplifyRegions(rewriter, func->getRegions());
     });
   }
-  BuildDataflowTaskGraphPass(bool debug) : debug(debug){};
+  BuildDataflowTaskGraphPass(bool debug, int64_t unrollFactor)
+      : debug(debug), unrollFactor(unrollFactor){};
 
 protected:
+  /// Unrolls the loops with a static trip count which hold candidates for
+  /// tasks, by at most `unrollFactor` iterations and `MAX_UNROLLED_OPS`
+  /// operations, such that the tasks of the unrolled iterations are
+  /// independent tasks of the graph.
+  void unrollTaskLoops(mlir::func::FuncOp func) {
+    // The inner loops come first, and are unrolled before the loops holding
+    // them are sized
+    SmallVector<scf::ForOp> loops;
+    func.walk([&](scf::ForOp forOp) { loops.push_back(forOp); });
+
+    for (scf::ForOp forOp : loops) {
+      std::optional<int64_t> tripCount = tryGetStaticTripCount(forOp);
+      if (!tripCount || *tripCount < 2)
+        continue;
+
+      int64_t bodySize = 0;
+      bool holdsCandidates = false;
+      forOp.getBody()->walk([&](Operation *op) {
+        bodySize++;
+        holdsCandidates |= isCandidateForTask(op);
+      });
+      if (!holdsCandidates)
+        continue;
+
+      int64_t factor =
+          std::min({*tripCount, unrollFactor,
+                    MAX_UNROLLED_OPS / std::max<int64_t>(bodySize, 1)});
+      if (factor < 2)
+        continue;
+
+      Location loc = forOp.getLoc();
+      if (failed(mlir::loopUnrollByFactor(forOp, (uint64_t)factor)))
+        continue;
+      if (debug)
+        mlir::emitRemark(loc) << "loop unrolled by " << factor
+                              << " iterations for dataflow tasks";
+    }
+  }
+
   mlir::WalkResult processOperation(mlir::Operation *op) {
     if (isCandidateForTask(op)) {
       IRMapping map;
@@ -198,11 +248,182 @@ protected:
   }
 
   bool debug;
+  int64_t unrollFactor;
+};
+
+/// Estimated work of an operation, in units of leveled operations on one
+/// ciphertext, a table lookup weighing `TLU_WORK` units.  Loops whose trip
+/// count is not known statically are accounted for one iteration.
+static const int64_t TLU_WORK = 1000;
+
+static int64_t numElements(Type type) {
+  if (auto shapedType = type.dyn_cast<ShapedType>())
+    return shapedType.hasStaticShape() ? shapedType.getNumElements() : 1;
+  return 1;
+}
+
+static int64_t estimateWork(Operation *op) {
+  if (auto genericOp = mlir::dyn_cast<mlir::linalg::GenericOp>(op)) {
+    int64_t iterations = 1;
+    for (int64_t range : genericOp.getStaticLoopRanges())
+      if (!ShapedType::isDynamic(range))
+        iterations *= range;
+    int64_t work = 0;
+    for (Operation &bodyOp : genericOp.getBody()->getOperations())
+      work += estimateWork(&bodyOp);
+    return iterations * work;
+  }
+  if (isa<FHE::ApplyLookupTableEintOp>(op))
+    return TLU_WORK * numElements(op->getResult(0).getType());
+
+  // The results of an operation with regions, such as a task or a loop, are
+  // computed by the operations of its regions, which are counted instead
+  int64_t work = 0;
+  if (op->getNumRegions() > 0) {
+    for (Region &region : op->getRegions())
+      for (Operation &childOp : region.getOps())
+        work += estimateWork(&childOp);
+    return work;
+  }
+  for (Type type : op->getResultTypes()) {
+    Type elementType = type;
+    if (auto shapedType = type.dyn_cast<ShapedType>())
+      elementType = shapedType.getElementType();
+    if (elementType.isa<FHE::FheIntegerInterface>())
+      work += numElements(type);
+  }
+  return work;
+}
+
+static bool usesResultsOf(Operation *op, Operation *producer) {
+  return op
+      ->walk([&](Operation *nestedOp) {
+        for (Value operand : nestedOp->getOperands())
+          if (operand.getDefiningOp() == producer)
+            return WalkResult::interrupt();
+        return WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+/// Merge the task `first` with the task `second`, which must follow it in
+/// the same block without any use of the results of `first` in between.
+/// The merged task replaces `second`, results of `first` that were only
+/// used by `second` are no longer yielded.
+static RT::DataflowTaskOp mergeDFTasks(RT::DataflowTaskOp first,
+                                       RT::DataflowTaskOp second) {
+  SmallVector<Value> firstResults;
+  for (Value result : first->getResults())
+    if (llvm::any_of(result.getUsers(), [&](Operation *user) {
+          return !second->isAncestor(user);
+        }))
+      firstResults.push_back(result);
+
+  SmallVector<Type> resultTypes;
+  for (Value result : firstResults)
+    resultTypes.push_back(result.getType());
+  resultTypes.append(second->result_type_begin(), second->result_type_end());
+
+  OpBuilder builder(second);
+  auto merged = builder.create<RT::DataflowTaskOp>(
+      second.getLoc(), resultTypes, mlir::ValueRange());
+  OpBuilder tbbuilder = OpBuilder::atBlockEnd(&merged.getBody().front());
+
+  // Clone both bodies, uses of the results of `first` in `second` are
+  // mapped to the values it yields
+  IRMapping map;
+  SmallVector<Value> yielded;
+  for (Operation &op : first.getBody().front()) {
+    if (auto yieldOp = mlir::dyn_cast<RT::DataflowYieldOp>(op)) {
+      for (auto pair : llvm::zip(first->getResults(), yieldOp.getOperands()))
+        map.map(std::get<0>(pair), map.lookupOrDefault(std::get<1>(pair)));
+      continue;
+    }
+    tbbuilder.clone(op, map);
+  }
+  for (Value result : firstResults)
+    yielded.push_back(map.lookup(result));
+  for (Operation &op : second.getBody().front()) {
+    if (auto yieldOp = mlir::dyn_cast<RT::DataflowYieldOp>(op)) {
+      for (Value operand : yieldOp.getOperands())
+        yielded.push_back(map.lookupOrDefault(operand));
+      continue;
+    }
+    tbbuilder.clone(op, map);
+  }
+  tbbuilder.create<RT::DataflowYieldOp>(merged.getLoc(), mlir::TypeRange(),
+                                        yielded);
+
+  for (auto pair : llvm::zip(firstResults, merged->getResults()))
+    std::get<0>(pair).replaceAllUsesWith(std::get<1>(pair));
+  for (auto pair : llvm::zip(second->getResults(),
+                             merged->getResults().drop_front(
+                                 firstResults.size())))
+    std::get<0>(pair).replaceAllUsesWith(std::get<1>(pair));
+  second->erase();
+  first->erase();
+
+  SetVector<Value> deps;
+  getUsedValuesDefinedAbove(merged.getBody(), deps);
+  merged->setOperands(deps.takeVector());
+  return merged;
+}
+
+/// For documentation see Autopar.td
+struct CoarsenDataflowTasksPass
+    : public CoarsenDataflowTasksBase<CoarsenDataflowTasksPass> {
+
+  void runOnOperation() override {
+    if (minTaskWork <= 0)
+      return;
+
+    SetVector<Block *> blocks;
+    getOperation().walk(
+        [&](RT::DataflowTaskOp taskOp) { blocks.insert(taskOp->getBlock()); });
+    for (Block *block : blocks)
+      coarsenBlock(*block);
+  }
+  CoarsenDataflowTasksPass(int64_t minTaskWork, bool debug)
+      : minTaskWork(minTaskWork), debug(debug){};
+
+protected:
+  // Merge each task below the work threshold with the next task of the
+  // block, until the merged task reaches the threshold.
+  void coarsenBlock(Block &block) {
+    RT::DataflowTaskOp pending = nullptr;
+    int64_t pendingWork = 0;
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      auto taskOp = mlir::dyn_cast<RT::DataflowTaskOp>(op);
+      if (!taskOp) {
+        if (pending && usesResultsOf(&op, pending))
+          pending = nullptr;
+        continue;
+      }
+      int64_t work = estimateWork(taskOp);
+      if (pending) {
+        taskOp = mergeDFTasks(pending, taskOp);
+        work += pendingWork;
+      }
+      if (debug)
+        taskOp->emitRemark() << "dataflow task estimated work: " << work;
+      pending = (work < minTaskWork) ? taskOp : nullptr;
+      pendingWork = work;
+    }
+  }
+
+  int64_t minTaskWork;
+  bool debug;
 };
 } // end anonymous namespace
 
-std::unique_ptr<mlir::Pass> createBuildDataflowTaskGraphPass(bool debug) {
-  return std::make_unique<BuildDataflowTaskGraphPass>(debug);
+std::unique_ptr<mlir::Pass>
+createBuildDataflowTaskGraphPass(bool debug, int64_t unrollFactor) {
+  return std::make_unique<BuildDataflowTaskGraphPass>(debug, unrollFactor);
+}
+
+std::unique_ptr<mlir::Pass> createCoarsenDataflowTasksPass(int64_t minTaskWork,
+                                                           bool debug) {
+  return std::make_unique<CoarsenDataflowTasksPass>(minTaskWork, debug);
 }
 
 } // end namespace concretelang
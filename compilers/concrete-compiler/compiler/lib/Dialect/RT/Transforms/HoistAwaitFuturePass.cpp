@@ -16,55 +16,58 @@
 #include <optional>
 
 namespace {
-bool isClonableIVExpression(mlir::Value v, mlir::scf::ForallOp forallOp);
+bool isClonableIVExpression(mlir::Value v, mlir::ValueRange ivs,
+                            mlir::Region &body);
 
 // Checks if the operation `op` can be cloned safely for insertion
-// into a new loop. That is, it must be above `forallOp` or if all of
-// its operands only reference loop IVs from `forallOp`, values
-// defined above `forallOp` or intermediate values within the body of
-// `forallOp` with the same properties. Operations with regions are
+// into a new loop. That is, it must be above the loop with the body
+// `body` or if all of its operands only reference the loop IVs
+// `ivs`, values defined above the loop or intermediate values within
+// `body` with the same properties. Operations with regions are
 // currently not supported.
-bool isClonableIVOp(mlir::Operation *op, mlir::scf::ForallOp forallOp) {
-  return op->getParentRegion()->isAncestor(&forallOp.getRegion()) ||
+bool isClonableIVOp(mlir::Operation *op, mlir::ValueRange ivs,
+                    mlir::Region &body) {
+  return op->getParentRegion()->isAncestor(&body) ||
          (mlir::isPure(op) && op->getNumRegions() == 0 &&
-          llvm::all_of(op->getOperands(), [=](mlir::Value operand) {
-            return isClonableIVExpression(operand, forallOp);
+          llvm::all_of(op->getOperands(), [&](mlir::Value operand) {
+            return isClonableIVExpression(operand, ivs, body);
           }));
 }
 
-// Checks if a value `v` is a loop IV, a value defined above
-// `forallOp` or if the defining operation fulfills the conditions of
+// Checks if a value `v` is a loop IV, a value defined above the loop
+// or if the defining operation fulfills the conditions of
 // `isClonableIVOp`.
-bool isClonableIVExpression(mlir::Value v, mlir::scf::ForallOp forallOp) {
-  if (llvm::any_of(forallOp.getInductionVars(),
-                   [=](mlir::Value iv) { return v == iv; }))
+bool isClonableIVExpression(mlir::Value v, mlir::ValueRange ivs,
+                            mlir::Region &body) {
+  if (llvm::any_of(ivs, [=](mlir::Value iv) { return v == iv; }))
     return true;
 
-  if (mlir::areValuesDefinedAbove(mlir::ValueRange{v},
-                                  forallOp.getBodyRegion()))
+  if (mlir::areValuesDefinedAbove(mlir::ValueRange{v}, body))
     return true;
 
   if (v.getDefiningOp())
-    return isClonableIVOp(v.getDefiningOp(), forallOp);
+    return isClonableIVOp(v.getDefiningOp(), ivs, body);
 
   return false;
 }
 
+bool isClonableIVExpression(mlir::Value v, mlir::scf::ForallOp forallOp) {
+  return isClonableIVExpression(v, forallOp.getInductionVars(),
+                                forallOp.getBodyRegion());
+}
+
 mlir::Value cloneIVExpression(mlir::IRRewriter &rewriter, mlir::Value v,
-                              mlir::IRMapping &mapping,
-                              mlir::scf::ForallOp forallOp);
+                              mlir::IRMapping &mapping, mlir::Region &body);
 
 // Clones an operation `op` for insertion into a new loop
 mlir::Operation *cloneIVOp(mlir::IRRewriter &rewriter, mlir::Operation *op,
-                           mlir::IRMapping &mapping,
-                           mlir::scf::ForallOp forallOp) {
+                           mlir::IRMapping &mapping, mlir::Region &body) {
   assert(mlir::isPure(op));
 
   for (mlir::Value operand : op->getOperands()) {
     if (!mapping.contains(operand) &&
-        !mlir::areValuesDefinedAbove(mlir::ValueRange{operand},
-                                     forallOp.getBodyRegion())) {
-      cloneIVExpression(rewriter, operand, mapping, forallOp);
+        !mlir::areValuesDefinedAbove(mlir::ValueRange{operand}, body)) {
+      cloneIVExpression(rewriter, operand, mapping, body);
     }
   }
 
@@ -74,13 +77,11 @@ mlir::Operation *cloneIVOp(mlir::IRRewriter &rewriter, mlir::Operation *op,
 // If `v` can be referenced safely from a new loop, `v` is returned
 // directly. If not, its defining ops are recursively cloned.
 mlir::Value cloneIVExpression(mlir::IRRewriter &rewriter, mlir::Value v,
-                              mlir::IRMapping &mapping,
-                              mlir::scf::ForallOp forallOp) {
+                              mlir::IRMapping &mapping, mlir::Region &body) {
   if (mapping.contains(v))
     return mapping.lookup(v);
 
-  if (mlir::areValuesDefinedAbove(mlir::ValueRange{v},
-                                  forallOp.getBodyRegion())) {
+  if (mlir::areValuesDefinedAbove(mlir::ValueRange{v}, body)) {
     return v;
   }
 
@@ -88,8 +89,7 @@ mlir::Value cloneIVExpression(mlir::IRRewriter &rewriter, mlir::Value v,
 
   assert(definingOp);
 
-  mlir::Operation *clonedOp =
-      cloneIVOp(rewriter, definingOp, mapping, forallOp);
+  mlir::Operation *clonedOp = cloneIVOp(rewriter, definingOp, mapping, body);
 
   for (auto [res, cloneRes] :
        llvm::zip_equal(definingOp->getResults(), clonedOp->getResults())) {
@@ -111,6 +111,12 @@ struct HoistAwaitFuturePass
     mlir::func::FuncOp func = getOperation();
 
     llvm::SmallVector<mlir::Operation *> opsToErase;
+    llvm::SmallVector<mlir::concretelang::RT::AwaitFutureOp> sequentialAwaits;
+
+    func.walk([&](mlir::concretelang::RT::AwaitFutureOp awaitFutureOp) {
+      if (llvm::isa<mlir::scf::ForOp>(awaitFutureOp->getParentOp()))
+        sequentialAwaits.push_back(awaitFutureOp);
+    });
 
     func.walk([&](mlir::concretelang::RT::AwaitFutureOp awaitFutureOp) {
       // Make sure there are no other consumers that rely on the
@@ -313,8 +319,8 @@ struct HoistAwaitFuturePass
       auto addMapping = [&](llvm::ArrayRef<mlir::OpFoldResult> ofrs) {
         for (mlir::OpFoldResult ofr : ofrs) {
           if (mlir::Value v = ofr.dyn_cast<mlir::Value>())
-            syncMapping.map(
-                v, cloneIVExpression(rewriter, v, syncMapping, forallOp));
+            syncMapping.map(v, cloneIVExpression(rewriter, v, syncMapping,
+                                                 forallOp.getBodyRegion()));
         }
       };
 
@@ -361,6 +367,164 @@ struct HoistAwaitFuturePass
 
     for (mlir::Operation *op : opsToErase)
       op->erase();
+
+    // The loops are rebuilt for each hoisted await, so the parent
+    // loop of each await is only looked up once the previous ones
+    // have been hoisted
+    for (mlir::concretelang::RT::AwaitFutureOp awaitFutureOp :
+         sequentialAwaits)
+      hoistOutOfForLoop(awaitFutureOp);
+  }
+
+  // Hoists an `RT.await_future` operation whose result is inserted
+  // into a tensor carried by an `scf.for` loop out of the loop. An
+  // iteration of the loop then no longer waits for the task created
+  // by the iteration before creating the task of the next iteration,
+  // such that all tasks of the loop can be in flight at the same
+  // time.
+  //
+  // The futures are stored in a tensor of futures carried by the
+  // loop instead, and a second loop following the first one awaits
+  // the futures and inserts their values into the original tensor.
+  void hoistOutOfForLoop(mlir::concretelang::RT::AwaitFutureOp awaitFutureOp) {
+    mlir::scf::ForOp forOp =
+        llvm::dyn_cast<mlir::scf::ForOp>(awaitFutureOp->getParentOp());
+
+    if (!forOp || !awaitFutureOp.getResult().hasOneUse())
+      return;
+
+    // The result must be inserted into a tensor carried by the loop,
+    // which is not used otherwise within the loop
+    mlir::Operation *insertOp =
+        awaitFutureOp.getResult().getUses().begin()->getOwner();
+
+    if (!llvm::isa<mlir::tensor::InsertOp, mlir::tensor::InsertSliceOp>(
+            insertOp) ||
+        insertOp->getBlock() != forOp.getBody() ||
+        insertOp->getOperand(0) != awaitFutureOp.getResult())
+      return;
+
+    mlir::Value dst = insertOp->getOperand(1);
+    auto iterArg = llvm::find(forOp.getRegionIterArgs(), dst);
+
+    if (iterArg == forOp.getRegionIterArgs().end() || !dst.hasOneUse() ||
+        !insertOp->getResult(0).hasOneUse() ||
+        !llvm::isa<mlir::scf::YieldOp>(
+            insertOp->getResult(0).getUses().begin()->getOwner()))
+      return;
+
+    size_t idx = iterArg - forOp.getRegionIterArgs().begin();
+
+    if (insertOp->getResult(0).getUses().begin()->getOperandNumber() != idx)
+      return;
+
+    // Make sure that the indexes, offsets, sizes and strides of the
+    // insertion only depend on the IV of the loop, on intermediate
+    // values produced in the body or on values defined above
+    mlir::Value iv = forOp.getInductionVar();
+
+    if (!llvm::all_of(insertOp->getOperands().drop_front(2),
+                      [&](mlir::Value v) {
+                        return isClonableIVExpression(v, iv,
+                                                      forOp.getRegion());
+                      }))
+      return;
+
+    // The tensor storing the futures must have a static shape
+    std::optional<int64_t> tripCount =
+        mlir::concretelang::tryGetStaticTripCount(forOp);
+
+    if (!tripCount.has_value())
+      return;
+
+    mlir::IRRewriter rewriter(&getContext());
+    rewriter.setInsertionPoint(forOp);
+
+    mlir::Value tensorOfFutures = rewriter.create<mlir::tensor::EmptyOp>(
+        forOp.getLoc(), llvm::ArrayRef<int64_t>{*tripCount},
+        awaitFutureOp.getInput().getType());
+
+    // Create a new loop carrying the tensor of futures in addition
+    // to the original values. The original tensor is left unchanged
+    // by the new loop and only passed through until canonicalization.
+    llvm::SmallVector<mlir::Value> newInits =
+        llvm::to_vector(forOp.getInitArgs());
+    newInits.push_back(tensorOfFutures);
+
+    rewriter.setInsertionPointAfter(forOp);
+    mlir::scf::ForOp newForOp = rewriter.create<mlir::scf::ForOp>(
+        forOp.getLoc(), forOp.getLowerBound(), forOp.getUpperBound(),
+        forOp.getStep(), newInits);
+
+    // Create a new loop, that invokes `RT.await_future` on all
+    // futures stored in the tensor of futures and inserts the
+    // contents into the original tensor
+    mlir::Value resultTensorOfFutures = newForOp.getResults().back();
+
+    auto syncForOp = rewriter.create<mlir::scf::ForOp>(
+        forOp.getLoc(), forOp.getLowerBound(), forOp.getUpperBound(),
+        forOp.getStep(), mlir::ValueRange{forOp.getInitArgs()[idx]},
+        [&](mlir::OpBuilder &builder, mlir::Location loc, mlir::Value syncIV,
+            mlir::ValueRange syncIterArgs) {
+          mlir::ImplicitLocOpBuilder ilob(loc, builder);
+          mlir::Value extractedFuture = ilob.create<mlir::tensor::ExtractOp>(
+              resultTensorOfFutures,
+              mlir::concretelang::normalizeInductionVar(
+                  ilob, syncIV, forOp.getLowerBound(), forOp.getStep()));
+          mlir::Value awaited =
+              ilob.create<mlir::concretelang::RT::AwaitFutureOp>(
+                  awaitFutureOp.getResult().getType(), extractedFuture);
+
+          mlir::IRMapping syncMapping;
+          syncMapping.map(iv, syncIV);
+          syncMapping.map(dst, syncIterArgs.front());
+          syncMapping.map(awaitFutureOp.getResult(), awaited);
+
+          mlir::IRRewriter syncRewriter(builder);
+          for (mlir::Value v : insertOp->getOperands().drop_front(2))
+            syncMapping.map(v, cloneIVExpression(syncRewriter, v, syncMapping,
+                                                 forOp.getRegion()));
+
+          mlir::Operation *syncInsertOp =
+              syncRewriter.clone(*insertOp, syncMapping);
+          builder.create<mlir::scf::YieldOp>(loc, syncInsertOp->getResults());
+        });
+
+    // Move the body of the original loop into the new one, storing
+    // the futures into the tensor of futures instead of awaiting them
+    llvm::SmallVector<mlir::Value> blockArgs(
+        newForOp.getBody()->args_begin(),
+        std::prev(newForOp.getBody()->args_end()));
+    rewriter.mergeBlocks(forOp.getBody(), newForOp.getBody(), blockArgs);
+
+    mlir::Value newIterArg = newForOp.getRegionIterArgs()[idx];
+    mlir::Value tensorOfFuturesIterArg = newForOp.getRegionIterArgs().back();
+
+    rewriter.setInsertionPoint(awaitFutureOp);
+    mlir::ImplicitLocOpBuilder ilob(awaitFutureOp.getLoc(), rewriter);
+    mlir::Value insertedFuture = ilob.create<mlir::tensor::InsertOp>(
+        awaitFutureOp.getInput(), tensorOfFuturesIterArg,
+        mlir::concretelang::normalizeInductionVar(
+            ilob, newForOp.getInductionVar(), newForOp.getLowerBound(),
+            newForOp.getStep()));
+
+    mlir::Operation *yieldOp = newForOp.getBody()->getTerminator();
+    yieldOp->setOperand(idx, newIterArg);
+    yieldOp->insertOperands(yieldOp->getNumOperands(), insertedFuture);
+
+    insertOp->erase();
+    awaitFutureOp.erase();
+
+    // Replace the uses of the results of the original loop with the
+    // results of the new loop, the result with the awaited values
+    // being replaced by the result of the synchronizing loop
+    for (size_t i = 0; i < forOp.getNumResults(); i++) {
+      forOp.getResult(i).replaceAllUsesWith(i == idx
+                                                ? syncForOp.getResult(0)
+                                                : newForOp.getResult(i));
+    }
+
+    forOp.erase();
   }
 };
 } // namespace
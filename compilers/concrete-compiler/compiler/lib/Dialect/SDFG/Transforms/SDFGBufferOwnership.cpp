@@ -14,6 +14,7 @@
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/Dominance.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 
 #include "concretelang/Conversion/Tools.h"
 #include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
@@ -54,6 +55,62 @@ static func::FuncOp getCalledFunction(CallOpInterface callOp) {
       SymbolTable::lookupNearestSymbolFrom(callOp, sym));
 }
 
+// Returns `op` as a call to a runtime function whose name starts with
+// `prefix`, or null.
+static func::CallOp getRuntimeCall(Operation *op, llvm::StringRef prefix) {
+  auto callOp = dyn_cast<func::CallOp>(op);
+  if (!callOp)
+    return nullptr;
+  func::FuncOp funcOp = getCalledFunction(callOp);
+  if (!funcOp ||
+      funcOp.getName().str().compare(0, prefix.size(), prefix.str()) != 0)
+    return nullptr;
+  return callOp;
+}
+
+// Returns true if `op` is before `point`, i.e. does not run between
+// `point` and the end of its block.
+static bool isBefore(Operation *op, Operation *point, DominanceInfo &domInfo) {
+  if (Operation *ancestor = point->getBlock()->findAncestorOpInBlock(*op))
+    return ancestor->isBeforeInBlock(point);
+  return domInfo.properlyDominates(op, point);
+}
+
+// Returns true if the memref type describes a row-major contiguous
+// buffer, which the runtimes can write as a dense block.
+static bool isContiguous(MemRefType type) {
+  if (!type.hasStaticShape())
+    return false;
+  SmallVector<int64_t> strides;
+  int64_t offset;
+  if (failed(getStridesAndOffset(type, strides, offset)))
+    return false;
+  int64_t expected = 1;
+  for (int64_t d = type.getRank() - 1; d >= 0; d--) {
+    if (strides[d] != expected)
+      return false;
+    expected *= type.getDimSize(d);
+  }
+  return true;
+}
+
+// Moves the side-effect free operations computing `value` before
+// `point` if needed. Returns false if `value` cannot be made available
+// at `point`.
+static bool hoistBefore(Value value, Operation *point, DominanceInfo &domInfo) {
+  if (domInfo.properlyDominates(value, point))
+    return true;
+  Operation *def = value.getDefiningOp();
+  if (def == nullptr || def->getBlock() != point->getBlock() ||
+      def->getNumRegions() != 0 || !isMemoryEffectFree(def))
+    return false;
+  for (Value operand : def->getOperands())
+    if (!hoistBefore(operand, point, domInfo))
+      return false;
+  def->moveBefore(point);
+  return true;
+}
+
 struct SDFGBufferOwnershipPass
     : public SDFGBufferOwnershipBase<SDFGBufferOwnershipPass> {
 
@@ -72,34 +129,118 @@ struct SDFGBufferOwnershipPass
       DenseSet<OpOperand *> aliasedUses;
       getAliasedUses(alloc, aliasedUses);
 
-      // Check if this memref is used in a SDFG put operation
+      // The buffer, or a view of it, must be put in a single stream
+      // as the runtime frees the whole allocation with the item.
+      func::CallOp callOp;
       for (auto use : aliasedUses) {
-        if (isa<mlir::func::CallOp>(use->getOwner())) {
-          mlir::func::CallOp callOp = cast<func::CallOp>(use->getOwner());
-          mlir::func::FuncOp funcOp = getCalledFunction(callOp);
-          std::string putName = "stream_emulator_put_memref";
-          if (funcOp.getName().str().compare(0, putName.size(), putName) == 0) {
-            // If the put operation dominates the deallocation, then
-            // ownership of the data can be transferred to the runtime
-            // and deallocation can be removed. We mark the ownership
-            // flag in the PUT operation to notify the runtime that it
-            // gets ownership.
-            if (domInfo.properlyDominates(callOp, op)) {
-              deallocOps.push_back(op);
-              OpBuilder builder(callOp);
-              mlir::Value cst1 = builder.create<mlir::arith::ConstantOp>(
-                  callOp.getLoc(), builder.getI64IntegerAttr(1));
-              callOp->setOperand(2, cst1);
-            }
+        if (func::CallOp putOp = getRuntimeCall(use->getOwner(),
+                                                "stream_emulator_put_memref")) {
+          if (callOp)
             return;
-          }
+          callOp = putOp;
         }
       }
+      if (!callOp)
+        return;
+      // The put must precede the deallocation in its block, so that it
+      // runs once per allocation, and the producer must be done with
+      // the buffer: no other use may read or write it after the put.
+      if (callOp->getBlock() != op->getBlock() || !callOp->isBeforeInBlock(op))
+        return;
+      for (auto use : aliasedUses) {
+        Operation *owner = use->getOwner();
+        if (owner == callOp || owner == op ||
+            isa<ViewLikeOpInterface>(owner))
+          continue;
+        if (!isBefore(owner, callOp, domInfo))
+          return;
+      }
+      // We mark the ownership flag in the PUT operation to notify the
+      // runtime that it gets ownership.
+      deallocOps.push_back(op);
+      OpBuilder builder(callOp);
+      mlir::Value cst1 = builder.create<mlir::arith::ConstantOp>(
+          callOp.getLoc(), builder.getI64IntegerAttr(1));
+      callOp->setOperand(2, cst1);
     });
 
     for (auto dop : deallocOps) {
       dop->erase();
     }
+
+    // Find all SDFG get operations whose result buffer is only copied
+    // to its final destination, e.g. an output of the function or a
+    // slice of a larger tensor, then deallocated. The get can then
+    // write to the destination directly, removing the buffer and the
+    // copy.
+    std::vector<func::CallOp> getOps;
+    module.walk([&](func::CallOp callOp) {
+      if (getRuntimeCall(callOp, "stream_emulator_get_memref"))
+        getOps.push_back(callOp);
+    });
+    for (auto getOp : getOps)
+      forwardToDestination(getOp);
+  }
+
+  void forwardToDestination(func::CallOp getOp) {
+    // The result buffer of the get is passed as its last operand,
+    // casted to a memref with a dynamic layout
+    Value out = getOp->getOperands().back();
+    auto castOp = out.getDefiningOp<memref::CastOp>();
+    if (!castOp || !castOp->hasOneUse())
+      return;
+    auto allocOp = castOp.getSource().getDefiningOp<memref::AllocOp>();
+    if (!allocOp)
+      return;
+    memref::CopyOp copyOp;
+    memref::DeallocOp deallocOp;
+    for (Operation *user : allocOp->getUsers()) {
+      if (user == castOp)
+        continue;
+      if (auto copy = dyn_cast<memref::CopyOp>(user)) {
+        if (copyOp || copy.getSource() != allocOp.getResult())
+          return;
+        copyOp = copy;
+      } else if (auto dealloc = dyn_cast<memref::DeallocOp>(user)) {
+        if (deallocOp)
+          return;
+        deallocOp = dealloc;
+      } else {
+        return;
+      }
+    }
+    if (!copyOp || copyOp->getBlock() != getOp->getBlock() ||
+        !getOp->isBeforeInBlock(copyOp))
+      return;
+    Value dst = copyOp.getTarget();
+    auto dstType = dst.getType().dyn_cast<MemRefType>();
+    if (!dstType || !isContiguous(dstType))
+      return;
+    // The destination is written earlier than by the copy, so nothing
+    // in between may access memory.
+    for (Operation *op = getOp->getNextNode(); op != copyOp;
+         op = op->getNextNode()) {
+      if (auto dealloc = dyn_cast<memref::DeallocOp>(op)) {
+        if (dealloc.getMemref() == dst)
+          return;
+        continue;
+      }
+      if (op->getNumRegions() != 0 || !isMemoryEffectFree(op))
+        return;
+    }
+    DominanceInfo domInfo(getOp);
+    if (!hoistBefore(dst, getOp, domInfo))
+      return;
+
+    OpBuilder builder(getOp);
+    Value casted = builder.create<memref::CastOp>(getOp.getLoc(),
+                                                  castOp.getType(), dst);
+    getOp->setOperand(getOp->getNumOperands() - 1, casted);
+    copyOp->erase();
+    if (deallocOp)
+      deallocOp->erase();
+    castOp->erase();
+    allocOp->erase();
   }
 };
 } // end anonymous namespace
@@ -3,7 +3,9 @@
 #include <concretelang/Analysis/Utils.h>
 #include <concretelang/Dialect/TFHE/Analysis/ExtractStatistics.h>
 
+#include <llvm/ADT/DenseMap.h>
 #include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
 #include <mlir/IR/BuiltinOps.h>
 #include <mlir/IR/Operation.h>
@@ -17,6 +19,135 @@ namespace mlir {
 namespace concretelang {
 namespace TFHE {
 
+/// Computes the PBS depth of a circuit, i.e. the number of bootstraps on its
+/// critical path, and how many of its bootstraps can run at the same time.
+///
+/// The depths are propagated through the SSA values. The loops are evaluated
+/// once with their iteration arguments at an offset depth, to find how the
+/// depth grows from an iteration to the next, then once to count their
+/// bootstraps: the iterations of a loop are independent if the depth does
+/// not grow, and their bootstraps can then be batched.
+class DependencyProfile {
+public:
+  /// Returns false if the profile cannot be computed, i.e. for a loop without
+  /// static trip count.
+  bool run(mlir::func::FuncOp func) {
+    return evaluate(func.getBody().front(), 1, false, true);
+  }
+
+  int64_t pbsDepth = 0;
+  int64_t pbsCount = 0;
+  int64_t batchablePbsCount = 0;
+
+private:
+  /// The offset of the depth of the iteration arguments of a loop when
+  /// looking for the growth of the depth between its iterations
+  static constexpr int64_t PROBE_OFFSET = 1ll << 32;
+
+  int64_t depthOf(mlir::Value value) {
+    auto depth = depths.find(value);
+    return depth == depths.end() ? 0 : depth->second;
+  }
+
+  bool evaluate(mlir::Block &block, int64_t multiplicity, bool batchable,
+                bool count) {
+    for (mlir::Operation &op : block) {
+      if (!evaluate(&op, multiplicity, batchable, count))
+        return false;
+    }
+    return true;
+  }
+
+  bool evaluate(mlir::Operation *op, int64_t multiplicity, bool batchable,
+                bool count) {
+    int64_t depth = 0;
+    for (mlir::Value operand : op->getOperands())
+      depth = std::max(depth, depthOf(operand));
+
+    if (auto forOp = llvm::dyn_cast<scf::ForOp>(op))
+      return evaluate(forOp, multiplicity, batchable, count);
+
+    std::optional<int64_t> bootstraps = bootstrapCount(op);
+    if (bootstraps.has_value()) {
+      depth += 1;
+      if (count) {
+        pbsCount += multiplicity * *bootstraps;
+        if (batchable || *bootstraps > 1)
+          batchablePbsCount += multiplicity * *bootstraps;
+        pbsDepth = std::max(pbsDepth, depth);
+      }
+    }
+
+    // The regions of the other operations, e.g. of the conditionals, run
+    // after their operands and before their results
+    for (mlir::Region &region : op->getRegions()) {
+      for (mlir::Block &block : region) {
+        for (mlir::Value argument : block.getArguments())
+          depths[argument] = depth;
+        if (!evaluate(block, multiplicity, batchable, count))
+          return false;
+        for (mlir::Value result : block.getTerminator()->getOperands())
+          depth = std::max(depth, depthOf(result));
+      }
+    }
+    for (mlir::Value result : op->getResults())
+      depths[result] = depth;
+    return true;
+  }
+
+  bool evaluate(scf::ForOp forOp, int64_t multiplicity, bool batchable,
+                bool count) {
+    std::optional<int64_t> tripCount = tryGetStaticTripCount(forOp);
+    if (!tripCount.has_value())
+      return false;
+
+    mlir::Block &body = *forOp.getBody();
+    auto yielded = body.getTerminator()->getOperands();
+
+    // The growth of the depth from an iteration to the next
+    for (mlir::Value argument : forOp.getRegionIterArgs())
+      depths[argument] = PROBE_OFFSET;
+    if (!evaluate(body, multiplicity, batchable, false))
+      return false;
+    int64_t growth = 0;
+    for (mlir::Value value : yielded)
+      growth = std::max(growth, depthOf(value) - PROBE_OFFSET);
+
+    for (auto [argument, init] :
+         llvm::zip(forOp.getRegionIterArgs(), forOp.getInitArgs()))
+      depths[argument] = depthOf(init);
+    if (!evaluate(body, multiplicity * *tripCount,
+                  batchable || (growth == 0 && *tripCount > 1), count))
+      return false;
+
+    for (auto [result, value, init] :
+         llvm::zip(forOp.getResults(), yielded, forOp.getInitArgs())) {
+      depths[result] = *tripCount == 0
+                           ? depthOf(init)
+                           : depthOf(value) + (*tripCount - 1) * growth;
+      if (count)
+        pbsDepth = std::max(pbsDepth, depths[result]);
+    }
+    return true;
+  }
+
+  /// The number of bootstraps computed by an operation, if it bootstraps.
+  static std::optional<int64_t> bootstrapCount(mlir::Operation *op) {
+    if (llvm::isa<TFHE::BootstrapGLWEOp, TFHE::ManyLutBootstrapGLWEOp,
+                  TFHE::WopPBSGLWEOp>(op))
+      return 1;
+    if (llvm::isa<TFHE::BatchedBootstrapGLWEOp,
+                  TFHE::BatchedMappedBootstrapGLWEOp>(op))
+      return op->getResult(0)
+          .getType()
+          .cast<mlir::RankedTensorType>()
+          .getNumElements();
+    return std::nullopt;
+  }
+
+  llvm::DenseMap<mlir::Value, int64_t> depths;
+};
+
 #define DISPATCH_ENTER(type)                                                   \
   if (auto typedOp = llvm::dyn_cast<type>(op)) {                               \
     std::optional<StringError> error = on_enter(typedOp, *this);               \
@@ -79,6 +210,16 @@ struct ExtractTFHEStatisticsPass
         signalPassFailure();
         return;
       }
+
+      DependencyProfile profile;
+      if (profile.run(*funcOp)) {
+        circuitFeedback.pbsDepth = profile.pbsDepth;
+        circuitFeedback.averagePbsParallelism =
+            profile.pbsDepth == 0
+                ? 0
+                : (double)profile.pbsCount / profile.pbsDepth;
+        circuitFeedback.batchablePbsCount = profile.batchablePbsCount;
+      }
     }
   }
 
@@ -88,10 +229,15 @@ struct ExtractTFHEStatisticsPass
     DISPATCH_ENTER(TFHE::AddGLWEIntOp)
     DISPATCH_ENTER(TFHE::BootstrapGLWEOp)
     DISPATCH_ENTER(TFHE::KeySwitchGLWEOp)
+    DISPATCH_ENTER(TFHE::ManyLutBootstrapGLWEOp)
     DISPATCH_ENTER(TFHE::MulGLWEIntOp)
     DISPATCH_ENTER(TFHE::NegGLWEOp)
     DISPATCH_ENTER(TFHE::SubGLWEIntOp)
     DISPATCH_ENTER(TFHE::WopPBSGLWEOp)
+    DISPATCH_ENTER(TFHE::ABatchedAddGLWEOp)
+    DISPATCH_ENTER(TFHE::ABatchedAddGLWEIntOp)
+    DISPATCH_ENTER(TFHE::BatchedMulGLWEIntCstOp)
+    DISPATCH_ENTER(TFHE::BatchedNegGLWEOp)
     return std::nullopt;
   }
 
@@ -202,6 +348,34 @@ struct ExtractTFHEStatisticsPass
     return std::nullopt;
   }
 
+  // ############################
+  // TFHE.many_lut_bootstrap_glwe
+  // ############################
+
+  static std::optional<StringError> on_enter(TFHE::ManyLutBootstrapGLWEOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    auto bsk = op.getKey();
+
+    auto location = locationString(op.getLoc());
+    // All the packed lookup tables are evaluated by a single PBS
+    auto operation = PrimitiveOperation::PBS;
+    auto keys = std::vector<std::pair<KeyType, int64_t>>();
+    auto count = pass.getTripCount();
+
+    std::pair<KeyType, int64_t> key =
+        std::make_pair(KeyType::BOOTSTRAP, (int64_t)bsk.getIndex());
+    keys.push_back(key);
+
+    pass.circuitFeedback->statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    return std::nullopt;
+  }
+
   // ###################
   // TFHE.keyswitch_glwe
   // ###################
@@ -354,6 +528,62 @@ struct ExtractTFHEStatisticsPass
 
     return std::nullopt;
   }
+
+  // ##########################
+  // Batched leveled operations
+  // ##########################
+
+  static std::optional<StringError> on_enter(TFHE::ABatchedAddGLWEOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    return on_enter_batched(op, PrimitiveOperation::ENCRYPTED_ADDITION, pass);
+  }
+
+  static std::optional<StringError> on_enter(TFHE::ABatchedAddGLWEIntOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    return on_enter_batched(op, PrimitiveOperation::CLEAR_ADDITION, pass);
+  }
+
+  static std::optional<StringError>
+  on_enter(TFHE::BatchedMulGLWEIntCstOp &op, ExtractTFHEStatisticsPass &pass) {
+    return on_enter_batched(op, PrimitiveOperation::CLEAR_MULTIPLICATION,
+                            pass);
+  }
+
+  static std::optional<StringError> on_enter(TFHE::BatchedNegGLWEOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    return on_enter_batched(op, PrimitiveOperation::ENCRYPTED_NEGATION, pass);
+  }
+
+  /// Counts a batched leveled operation once per ciphertext of its batch
+  template <typename Op>
+  static std::optional<StringError>
+  on_enter_batched(Op &op, PrimitiveOperation operation,
+                   ExtractTFHEStatisticsPass &pass) {
+    auto resultType = op.getType().template cast<mlir::RankedTensorType>();
+    auto resultingKey = resultType.getElementType()
+                            .template cast<TFHE::GLWECipherTextType>()
+                            .getKey()
+                            .getNormalized();
+
+    auto location = locationString(op.getLoc());
+    auto keys = std::vector<std::pair<KeyType, int64_t>>();
+    auto count = pass.getTripCount();
+    if (count.has_value())
+      count = count.value() * resultType.getNumElements();
+
+    std::pair<KeyType, int64_t> key =
+        std::make_pair(KeyType::SECRET, (int64_t)resultingKey->index);
+    keys.push_back(key);
+
+    pass.circuitFeedback->statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    return std::nullopt;
+  }
 };
 
 } // namespace TFHE
@@ -0,0 +1,220 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <cmath>
+
+#include <concretelang/Analysis/StaticLoops.h>
+#include <concretelang/Dialect/TFHE/Analysis/PredictLatency.h>
+#include <concretelang/Dialect/TFHE/IR/TFHEOps.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/IR/Operation.h>
+
+namespace mlir {
+namespace concretelang {
+namespace TFHE {
+
+namespace {
+
+/// The estimated cost of a piece of code, in nanoseconds: the sum of the
+/// costs of its primitives, and the length of its critical path with an
+/// unbounded number of cores, bounded by the iterations of the loops on the
+/// cores of the model.
+struct Cost {
+  double work = 0;
+  double criticalPath = 0;
+};
+
+struct PredictLatencyPass
+    : public PassWrapper<PredictLatencyPass, OperationPass<ModuleOp>> {
+
+  ProgramCompilationFeedback &feedback;
+  LatencyModel model;
+
+  PredictLatencyPass(ProgramCompilationFeedback &feedback, LatencyModel model)
+      : feedback{feedback}, model{model} {};
+
+  void runOnOperation() override {
+    auto module = getOperation();
+    auto funcs = module.getOps<mlir::func::FuncOp>();
+    double parallelism = model.costs.parallelism;
+    for (CircuitCompilationFeedback &circuitFeedback :
+         feedback.circuitFeedbacks) {
+      auto funcOp = llvm::find_if(funcs, [&](mlir::func::FuncOp op) {
+        return op.getName() == circuitFeedback.name;
+      });
+      assert(funcOp != funcs.end());
+
+      circuitFeedback.predictedLatency = std::nullopt;
+      circuitFeedback.predictedThroughput = std::nullopt;
+      if ((*funcOp).isExternal())
+        continue;
+      std::optional<Cost> cost = estimate((*funcOp).getBody().front());
+      if (!cost.has_value())
+        continue;
+
+      double nanoseconds =
+          std::max(cost->criticalPath, cost->work / parallelism);
+      circuitFeedback.predictedLatency = nanoseconds * 1e-9;
+      if (cost->work > 0)
+        circuitFeedback.predictedThroughput = parallelism * 1e9 / cost->work;
+    }
+  }
+
+  /// Estimates the cost of a block, whose operations run in the order of
+  /// their dependencies if they can overlap, in sequence otherwise.
+  std::optional<Cost> estimate(mlir::Block &block) {
+    Cost cost;
+    llvm::DenseMap<mlir::Value, double> readyTimes;
+    for (mlir::Operation &op : block) {
+      std::optional<Cost> opCost = estimate(&op);
+      if (!opCost.has_value())
+        return std::nullopt;
+      cost.work += opCost->work;
+      if (!model.overlapOperations) {
+        cost.criticalPath += opCost->criticalPath;
+        continue;
+      }
+      double start = 0;
+      for (mlir::Value operand : op.getOperands()) {
+        auto ready = readyTimes.find(operand);
+        if (ready != readyTimes.end())
+          start = std::max(start, ready->second);
+      }
+      double end = start + opCost->criticalPath;
+      for (mlir::Value result : op.getResults())
+        readyTimes[result] = end;
+      cost.criticalPath = std::max(cost.criticalPath, end);
+    }
+    return cost;
+  }
+
+  std::optional<Cost> estimate(mlir::Operation *op) {
+    if (auto forOp = llvm::dyn_cast<scf::ForOp>(op)) {
+      std::optional<int64_t> tripCount = tryGetStaticTripCount(forOp);
+      if (!tripCount.has_value()) {
+        emitWarning(forOp.getLoc(), "Cannot determine static trip count");
+        return std::nullopt;
+      }
+      std::optional<Cost> body = estimate(*forOp.getBody());
+      if (!body.has_value())
+        return std::nullopt;
+      double work = body->work * *tripCount;
+      if (!model.parallelLoops)
+        return Cost{work, body->criticalPath * *tripCount};
+      if (*tripCount == 0)
+        return Cost{};
+      return Cost{work, std::max(body->criticalPath,
+                                 work / model.costs.parallelism)};
+    }
+
+    if (auto bootstrap = llvm::dyn_cast<TFHE::BootstrapGLWEOp>(op))
+      return bootstrapCost(bootstrap.getKey(), op);
+    if (auto bootstrap = llvm::dyn_cast<TFHE::BatchedBootstrapGLWEOp>(op))
+      return bootstrapCost(bootstrap.getKey(), op);
+    if (auto bootstrap =
+            llvm::dyn_cast<TFHE::BatchedMappedBootstrapGLWEOp>(op))
+      return bootstrapCost(bootstrap.getKey(), op);
+    // All the packed lookup tables are evaluated by a single bootstrap
+    if (auto bootstrap = llvm::dyn_cast<TFHE::ManyLutBootstrapGLWEOp>(op))
+      return primitiveCost(model.costs.bootstrap,
+                           bootstrapWork(bootstrap.getKey()), 1);
+    if (auto wopPbs = llvm::dyn_cast<TFHE::WopPBSGLWEOp>(op))
+      return primitiveCost(model.costs.wopPbs, bootstrapWork(wopPbs.getBsk()),
+                           1);
+    if (auto keyswitch = llvm::dyn_cast<TFHE::KeySwitchGLWEOp>(op))
+      return keyswitchCost(keyswitch.getKey(), op);
+    if (auto keyswitch = llvm::dyn_cast<TFHE::BatchedKeySwitchGLWEOp>(op))
+      return keyswitchCost(keyswitch.getKey(), op);
+
+    if (llvm::isa<TFHE::AddGLWEOp, TFHE::AddGLWEIntOp, TFHE::MulGLWEIntOp,
+                  TFHE::NegGLWEOp, TFHE::SubGLWEIntOp, TFHE::ABatchedAddGLWEOp,
+                  TFHE::ABatchedAddGLWEIntOp, TFHE::ABatchedAddGLWEIntCstOp,
+                  TFHE::ABatchedAddGLWECstIntOp, TFHE::BatchedMulGLWEIntOp,
+                  TFHE::BatchedMulGLWEIntCstOp, TFHE::BatchedMulGLWECstIntOp,
+                  TFHE::BatchedNegGLWEOp>(op)) {
+      auto key = ciphertextType(op->getResult(0).getType())
+                     .getKey()
+                     .getNormalized();
+      return primitiveCost(model.costs.leveled, leveledWork(key->dimension),
+                           batchSize(op));
+    }
+
+    // The other operations, e.g. on the clear values, are free, their
+    // regions running in sequence
+    Cost cost;
+    for (mlir::Region &region : op->getRegions()) {
+      for (mlir::Block &block : region) {
+        std::optional<Cost> blockCost = estimate(block);
+        if (!blockCost.has_value())
+          return std::nullopt;
+        cost.work += blockCost->work;
+        cost.criticalPath += blockCost->criticalPath;
+      }
+    }
+    return cost;
+  }
+
+  /// The cost of `batchSize` primitives of `work` each, run in parallel on
+  /// the cores of the model.
+  std::optional<Cost> primitiveCost(std::optional<double> costPerWork,
+                                    double work, int64_t batchSize) {
+    if (!costPerWork.has_value())
+      return std::nullopt;
+    double parallelism = model.costs.parallelism;
+    double latency = *costPerWork * work;
+    return Cost{latency * batchSize,
+                latency * std::ceil(batchSize / parallelism)};
+  }
+
+  std::optional<Cost> bootstrapCost(GLWEBootstrapKeyAttr key,
+                                    mlir::Operation *op) {
+    return primitiveCost(model.costs.bootstrap, bootstrapWork(key),
+                         batchSize(op));
+  }
+
+  std::optional<Cost> keyswitchCost(GLWEKeyswitchKeyAttr key,
+                                    mlir::Operation *op) {
+    double work = keyswitchWork(key.getInputKey().getNormalized()->dimension,
+                                key.getLevels(),
+                                key.getOutputKey().getNormalized()->dimension);
+    return primitiveCost(model.costs.keyswitch, work, batchSize(op));
+  }
+
+  static double bootstrapWork(GLWEBootstrapKeyAttr key) {
+    return concretelang::bootstrapWork(
+        key.getInputKey().getNormalized()->dimension, key.getLevels(),
+        key.getGlweDim(), key.getPolySize());
+  }
+
+  /// The number of ciphertexts computed by a scalar or a batched operation.
+  static int64_t batchSize(mlir::Operation *op) {
+    auto tensorType =
+        op->getResult(0).getType().dyn_cast<mlir::RankedTensorType>();
+    return tensorType ? tensorType.getNumElements() : 1;
+  }
+
+  static GLWECipherTextType ciphertextType(mlir::Type type) {
+    if (auto tensorType = type.dyn_cast<mlir::RankedTensorType>())
+      return tensorType.getElementType().cast<GLWECipherTextType>();
+    return type.cast<GLWECipherTextType>();
+  }
+};
+
+} // namespace
+
+} // namespace TFHE
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createLatencyPredictionPass(ProgramCompilationFeedback &feedback,
+                            LatencyModel model) {
+  return std::make_unique<TFHE::PredictLatencyPass>(feedback, model);
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -3,8 +3,11 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/Region.h"
 
+#include "concretelang/Common/LutEncoding.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEAttrs.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEDialect.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEOps.h"
@@ -135,6 +138,108 @@ mlir::LogicalResult EncodeExpandLutForBootstrapOp::verify() {
   return mlir::success();
 }
 
+void EncodeExpandLutForBootstrapOp::getCanonicalizationPatterns(
+    mlir::RewritePatternSet &patterns, mlir::MLIRContext *context) {
+
+  // Encode and expand constant lookup tables at compile time, so that the
+  // runtime does not redo it on every call
+  class ConstantLutPattern
+      : public mlir::OpRewritePattern<EncodeExpandLutForBootstrapOp> {
+  public:
+    ConstantLutPattern(mlir::MLIRContext *context)
+        : mlir::OpRewritePattern<EncodeExpandLutForBootstrapOp>(context, 0) {}
+
+    mlir::LogicalResult
+    matchAndRewrite(EncodeExpandLutForBootstrapOp op,
+                    mlir::PatternRewriter &rewriter) const override {
+      auto cstOp = op.getInputLookupTable().getDefiningOp<arith::ConstantOp>();
+      if (cstOp == nullptr)
+        return mlir::failure();
+      auto inputAttr = cstOp.getValue().dyn_cast<mlir::DenseIntElementsAttr>();
+      if (inputAttr == nullptr)
+        return mlir::failure();
+
+      mlir::RankedTensorType resultType =
+          op.getResult().getType().cast<mlir::RankedTensorType>();
+
+      std::vector<uint64_t> input;
+      for (const llvm::APInt &v : inputAttr.getValues<llvm::APInt>())
+        input.push_back(v.getZExtValue());
+      std::vector<uint64_t> output(resultType.getNumElements());
+
+      concretelang::lut::encodeExpandLutForBootstrap(
+          output.data(), output.size(), input.data(), input.size(),
+          op.getOutputBits(), op.getIsSigned());
+
+      auto outputAttr = mlir::DenseIntElementsAttr::get(
+          resultType, llvm::ArrayRef<uint64_t>(output));
+      rewriter.replaceOpWithNewOp<arith::ConstantOp>(op, outputAttr);
+      return mlir::success();
+    }
+  };
+
+  patterns.add<ConstantLutPattern>(context);
+}
+
+void EncodeLutForCrtWopPBSOp::getCanonicalizationPatterns(
+    mlir::RewritePatternSet &patterns, mlir::MLIRContext *context) {
+
+  // Encode constant lookup tables at compile time, as for the bootstrap
+  class ConstantLutPattern
+      : public mlir::OpRewritePattern<EncodeLutForCrtWopPBSOp> {
+  public:
+    ConstantLutPattern(mlir::MLIRContext *context)
+        : mlir::OpRewritePattern<EncodeLutForCrtWopPBSOp>(context, 0) {}
+
+    mlir::LogicalResult
+    matchAndRewrite(EncodeLutForCrtWopPBSOp op,
+                    mlir::PatternRewriter &rewriter) const override {
+      auto cstOp = op.getInputLookupTable().getDefiningOp<arith::ConstantOp>();
+      if (cstOp == nullptr)
+        return mlir::failure();
+      auto inputAttr = cstOp.getValue().dyn_cast<mlir::DenseIntElementsAttr>();
+      if (inputAttr == nullptr)
+        return mlir::failure();
+
+      std::vector<uint64_t> crtDecomposition;
+      for (mlir::Attribute attr : op.getCrtDecomposition())
+        crtDecomposition.push_back(attr.cast<mlir::IntegerAttr>().getInt());
+      std::vector<uint64_t> crtBits;
+      for (mlir::Attribute attr : op.getCrtBits())
+        crtBits.push_back(attr.cast<mlir::IntegerAttr>().getInt());
+
+      // The result must have a row of `2^sum(crtBits)` cases per block
+      mlir::RankedTensorType resultType =
+          op.getResult().getType().cast<mlir::RankedTensorType>();
+      uint64_t logLutCrtSize = 0;
+      for (uint64_t bits : crtBits)
+        logLutCrtSize += bits;
+      if (crtBits.size() != crtDecomposition.size() || logLutCrtSize >= 64 ||
+          resultType.getDimSize(0) != (int64_t)crtDecomposition.size() ||
+          resultType.getDimSize(1) != (int64_t)(uint64_t(1) << logLutCrtSize) ||
+          (int64_t)op.getModulusProduct() < inputAttr.getNumElements())
+        return mlir::failure();
+
+      std::vector<uint64_t> input;
+      for (const llvm::APInt &v : inputAttr.getValues<llvm::APInt>())
+        input.push_back(v.getZExtValue());
+      std::vector<uint64_t> output(resultType.getNumElements());
+
+      concretelang::lut::encodeLutForCrtWopPBS(
+          output.data(), resultType.getDimSize(0), resultType.getDimSize(1),
+          input.data(), input.size(), crtDecomposition.data(), crtBits.data(),
+          crtDecomposition.size(), op.getModulusProduct(), op.getIsSigned());
+
+      auto outputAttr = mlir::DenseIntElementsAttr::get(
+          resultType, llvm::ArrayRef<uint64_t>(output));
+      rewriter.replaceOpWithNewOp<arith::ConstantOp>(op, outputAttr);
+      return mlir::success();
+    }
+  };
+
+  patterns.add<ConstantLutPattern>(context);
+}
+
 template <typename BootstrapOpT>
 mlir::LogicalResult verifyBootstrapSingleLUTConstraints(BootstrapOpT &op) {
   GLWEBootstrapKeyAttr keyAttr = op.getKeyAttr();
@@ -202,6 +307,109 @@ mlir::LogicalResult BatchedMappedBootstrapGLWEOp::verify() {
   return mlir::success();
 }
 
+mlir::LogicalResult EncodeExpandManyLutForBootstrapOp::verify() {
+  mlir::IntegerAttr polySizeAttr = this->getPolySizeAttr();
+
+  mlir::RankedTensorType rtt =
+      this->getResult().getType().template cast<mlir::RankedTensorType>();
+
+  if (rtt.getNumElements() != polySizeAttr.getInt()) {
+    this->emitError("The number of elements of the output tensor of ")
+        << rtt.getNumElements()
+        << " does not match the size of the polynomial of "
+        << polySizeAttr.getInt();
+
+    return mlir::failure();
+  }
+
+  // The packing of the tables is not checked here, as the polynomial size is
+  // a placeholder until the circuit is parametrized with several sets of
+  // parameters, but when the lookup tables are resized to the actual one
+
+  return mlir::success();
+}
+
+void EncodeExpandManyLutForBootstrapOp::getCanonicalizationPatterns(
+    mlir::RewritePatternSet &patterns, mlir::MLIRContext *context) {
+
+  // Encode, interleave and expand constant lookup tables at compile time
+  class ConstantLutsPattern
+      : public mlir::OpRewritePattern<EncodeExpandManyLutForBootstrapOp> {
+  public:
+    ConstantLutsPattern(mlir::MLIRContext *context)
+        : mlir::OpRewritePattern<EncodeExpandManyLutForBootstrapOp>(context,
+                                                                    0) {}
+
+    mlir::LogicalResult
+    matchAndRewrite(EncodeExpandManyLutForBootstrapOp op,
+                    mlir::PatternRewriter &rewriter) const override {
+      auto cstOp =
+          op.getInputLookupTables().getDefiningOp<arith::ConstantOp>();
+      if (cstOp == nullptr)
+        return mlir::failure();
+      auto inputAttr = cstOp.getValue().dyn_cast<mlir::DenseIntElementsAttr>();
+      if (inputAttr == nullptr)
+        return mlir::failure();
+
+      mlir::RankedTensorType inputType =
+          inputAttr.getType().cast<mlir::RankedTensorType>();
+      mlir::RankedTensorType resultType =
+          op.getResult().getType().cast<mlir::RankedTensorType>();
+
+      // Do not encode for a placeholder polynomial size
+      if (resultType.getNumElements() % (2 * inputType.getNumElements()) != 0)
+        return mlir::failure();
+
+      std::vector<uint64_t> input;
+      for (const llvm::APInt &v : inputAttr.getValues<llvm::APInt>())
+        input.push_back(v.getZExtValue());
+      std::vector<uint64_t> output(resultType.getNumElements());
+
+      concretelang::lut::encodeExpandManyLutForBootstrap(
+          output.data(), output.size(), input.data(), inputType.getDimSize(0),
+          inputType.getDimSize(1), op.getOutputBits(), op.getIsSigned());
+
+      auto outputAttr = mlir::DenseIntElementsAttr::get(
+          resultType, llvm::ArrayRef<uint64_t>(output));
+      rewriter.replaceOpWithNewOp<arith::ConstantOp>(op, outputAttr);
+      return mlir::success();
+    }
+  };
+
+  patterns.add<ConstantLutsPattern>(context);
+}
+
+mlir::LogicalResult ManyLutBootstrapGLWEOp::verify() {
+  mlir::RankedTensorType resultRtt =
+      this->getResult().getType().cast<mlir::RankedTensorType>();
+
+  if (resultRtt.getDimSize(0) != (int64_t)this->getLutCount()) {
+    this->emitError("Number of results of ")
+        << resultRtt.getDimSize(0)
+        << " does not match the lookup table count of " << this->getLutCount();
+
+    return mlir::failure();
+  }
+
+  if (verifyBootstrapSingleLUTConstraints(*this).failed())
+    return mlir::failure();
+
+  GLWEBootstrapKeyAttr keyAttr = this->getKeyAttr();
+
+  if (keyAttr && keyAttr.getPolySize() != kUndefined &&
+      ((int64_t)this->getLutCount() - 1) * this->getLutStride() >=
+          keyAttr.getPolySize()) {
+    this->emitError("Lookup tables packed ")
+        << this->getLutStride() << " coefficients apart do not fit "
+        << this->getLutCount() << " times in the polynom of size "
+        << keyAttr.getPolySize();
+
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
 } // namespace TFHE
 } // namespace concretelang
 } // namespace mlir
@@ -0,0 +1,228 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Dominance.h>
+#include <mlir/IR/Matchers.h>
+
+#include <concretelang/Dialect/TFHE/IR/TFHEOps.h>
+#include <concretelang/Dialect/TFHE/Transforms/Transforms.h>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// A key identifying the computation of an operation, made of the uniqued
+/// storage of its name, attributes, result type and operands.
+typedef llvm::SmallVector<const void *, 8> OperationKey;
+
+class TFHEDeduplicationPass
+    : public TFHEDeduplicationBase<TFHEDeduplicationPass> {
+public:
+  TFHEDeduplicationPass(std::map<std::string, TFHEDeduplicationCounts> *counts)
+      : counts(counts){};
+
+  void runOnOperation() override {
+    mlir::ModuleOp module = this->getOperation();
+    mlir::DominanceInfo dominance(module);
+
+    for (auto func : module.getOps<mlir::func::FuncOp>()) {
+      TFHEDeduplicationCounts funcCounts;
+      shareKeyswitches(func, funcCounts);
+      replacements.clear();
+      std::map<OperationKey, std::vector<mlir::Operation *>> candidates;
+      std::vector<mlir::Operation *> duplicates;
+
+      func.walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *op) {
+        if (!llvm::isa<TFHE::KeySwitchGLWEOp, TFHE::BootstrapGLWEOp>(op))
+          return;
+
+        OperationKey key = operationKey(op);
+        std::vector<mlir::Operation *> &previous = candidates[key];
+        auto original = llvm::find_if(previous, [&](mlir::Operation *prev) {
+          return isReplaceableBy(op, prev, dominance);
+        });
+        if (original == previous.end()) {
+          previous.push_back(op);
+          return;
+        }
+
+        replacements[op->getResult(0)] = (*original)->getResult(0);
+        duplicates.push_back(op);
+        if (llvm::isa<TFHE::BootstrapGLWEOp>(op))
+          funcCounts.bootstraps++;
+        else
+          funcCounts.keyswitches++;
+      });
+
+      // The duplicates may use each other, so they are all replaced before
+      // being erased.
+      for (mlir::Operation *op : duplicates)
+        op->getResult(0).replaceAllUsesWith(replacements[op->getResult(0)]);
+      for (mlir::Operation *op : llvm::reverse(duplicates))
+        op->erase();
+
+      if (counts != nullptr)
+        (*counts)[func.getName().str()] = funcCounts;
+    }
+  }
+
+private:
+  /// Replaces the keyswitches of a same ciphertext with the same key, which
+  /// are usually made before the different bootstraps of that ciphertext, by
+  /// a single one right after the definition of the ciphertext. Unlike the
+  /// merge of the dominated duplicates, this also shares the keyswitches of
+  /// different branches or loops.
+  static void shareKeyswitches(mlir::func::FuncOp func,
+                               TFHEDeduplicationCounts &funcCounts) {
+    std::map<std::tuple<const void *, const void *, const void *>,
+             std::vector<TFHE::KeySwitchGLWEOp>>
+        groups;
+    func.walk([&](TFHE::KeySwitchGLWEOp op) {
+      groups[{op.getCiphertext().getAsOpaquePointer(),
+              op.getKeyAttr().getAsOpaquePointer(),
+              op.getType().getAsOpaquePointer()}]
+          .push_back(op);
+    });
+
+    for (auto &group : groups) {
+      std::vector<TFHE::KeySwitchGLWEOp> &keyswitches = group.second;
+      if (keyswitches.size() < 2)
+        continue;
+
+      // The keyswitches cannot be hoisted out of an isolated region
+      mlir::Value ciphertext = keyswitches.front().getCiphertext();
+      mlir::Operation *scope = isolatedScope(ciphertext.getParentBlock());
+      bool hoistable = llvm::all_of(keyswitches, [&](mlir::Operation *op) {
+        return isolatedScope(op->getBlock()) == scope;
+      });
+      if (!hoistable)
+        continue;
+
+      mlir::OpBuilder builder(func.getContext());
+      builder.setInsertionPointAfterValue(ciphertext);
+      mlir::Operation *shared = builder.clone(*keyswitches.front());
+      shared->setLoc(builder.getFusedLoc(llvm::to_vector(llvm::map_range(
+          keyswitches, [](mlir::Operation *op) { return op->getLoc(); }))));
+      for (TFHE::KeySwitchGLWEOp op : keyswitches) {
+        op.getResult().replaceAllUsesWith(shared->getResult(0));
+        op.erase();
+      }
+      funcCounts.keyswitches += keyswitches.size() - 1;
+    }
+  }
+
+  /// Returns the closest isolated from above operation holding `block`.
+  static mlir::Operation *isolatedScope(mlir::Block *block) {
+    mlir::Operation *parent = block->getParentOp();
+    if (parent->hasTrait<mlir::OpTrait::IsIsolatedFromAbove>())
+      return parent;
+    return parent->getParentWithTrait<mlir::OpTrait::IsIsolatedFromAbove>();
+  }
+
+  /// Returns true if the results of `op` can be replaced by the ones of
+  /// `original`, i.e. if `original` dominates `op` and is not out of reach
+  /// of its region, like the one of an isolated task.
+  static bool isReplaceableBy(mlir::Operation *op, mlir::Operation *original,
+                              mlir::DominanceInfo &dominance) {
+    return dominance.properlyDominates(original, op) &&
+           op->getParentWithTrait<mlir::OpTrait::IsIsolatedFromAbove>() ==
+               original
+                   ->getParentWithTrait<mlir::OpTrait::IsIsolatedFromAbove>();
+  }
+
+  OperationKey operationKey(mlir::Operation *op) {
+    OperationKey key;
+    key.push_back(op->getName().getAsOpaquePointer());
+    key.push_back(op->getAttrDictionary().getAsOpaquePointer());
+    key.push_back(op->getResult(0).getType().getAsOpaquePointer());
+    valueKey(op->getOperand(0), key);
+    if (auto bootstrap = llvm::dyn_cast<TFHE::BootstrapGLWEOp>(op)) {
+      // Lookup tables with equal values share the same uniqued attribute
+      mlir::DenseElementsAttr lut;
+      if (mlir::matchPattern(bootstrap.getLookupTable(),
+                             mlir::m_Constant(&lut)))
+        key.push_back(lut.getAsOpaquePointer());
+      else
+        valueKey(bootstrap.getLookupTable(), key);
+    }
+    return key;
+  }
+
+  /// Appends the key of `value` to `key`, seeing through the tensor
+  /// insertions and extractions, such that a ciphertext extracted at the
+  /// indices where it was inserted is identified with the inserted one.
+  void valueKey(mlir::Value value, OperationKey &key) {
+    auto replacement = replacements.find(value);
+    if (replacement != replacements.end())
+      value = replacement->second;
+
+    auto extract = value.getDefiningOp<mlir::tensor::ExtractOp>();
+    if (extract == nullptr) {
+      key.push_back(value.getAsOpaquePointer());
+      return;
+    }
+
+    mlir::Value tensor = extract.getTensor();
+    while (auto insert = tensor.getDefiningOp<mlir::tensor::InsertOp>()) {
+      bool sameIndices = true;
+      bool disjointIndices = false;
+      for (auto [extracted, inserted] :
+           llvm::zip(extract.getIndices(), insert.getIndices())) {
+        const void *extractedKey = indexKey(extracted);
+        const void *insertedKey = indexKey(inserted);
+        if (extractedKey == insertedKey)
+          continue;
+        sameIndices = false;
+        // Different constants never designate the same element
+        if (mlir::matchPattern(extracted, mlir::m_Constant()) &&
+            mlir::matchPattern(inserted, mlir::m_Constant()))
+          disjointIndices = true;
+      }
+      if (sameIndices) {
+        valueKey(insert.getScalar(), key);
+        return;
+      }
+      if (!disjointIndices)
+        break;
+      tensor = insert.getDest();
+    }
+
+    key.push_back(extract->getName().getAsOpaquePointer());
+    key.push_back(tensor.getAsOpaquePointer());
+    for (mlir::Value index : extract.getIndices())
+      key.push_back(indexKey(index));
+  }
+
+  /// Returns the key of an index, which is the same for equal constants.
+  static const void *indexKey(mlir::Value index) {
+    mlir::Attribute constant;
+    if (mlir::matchPattern(index, mlir::m_Constant(&constant)))
+      return constant.getAsOpaquePointer();
+    return index.getAsOpaquePointer();
+  }
+
+  std::map<std::string, TFHEDeduplicationCounts> *counts;
+  /// The results of the duplicates, mapped to the ones replacing them
+  llvm::DenseMap<mlir::Value, mlir::Value> replacements;
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createTFHEDeduplicationPass(
+    std::map<std::string, TFHEDeduplicationCounts> *counts) {
+  return std::make_unique<TFHEDeduplicationPass>(counts);
+}
+
+} // namespace concretelang
+} // namespace mlir
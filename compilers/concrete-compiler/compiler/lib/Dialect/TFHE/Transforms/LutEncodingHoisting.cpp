@@ -0,0 +1,58 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Interfaces/LoopLikeInterface.h>
+
+#include <concretelang/Dialect/TFHE/IR/TFHEOps.h>
+#include <concretelang/Dialect/TFHE/Transforms/Transforms.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Returns true if `op` encodes a lookup table, or is a constant such an
+/// encoding may depend on.
+bool isLutEncoding(mlir::Operation *op) {
+  return llvm::isa<TFHE::EncodeExpandLutForBootstrapOp,
+                   TFHE::EncodeExpandManyLutForBootstrapOp,
+                   TFHE::EncodeLutForCrtWopPBSOp, arith::ConstantOp>(op);
+}
+
+/// Hoists the encodings of the loop-invariant lookup tables out of the loops,
+/// so that they are encoded once instead of on every iteration. The encodings
+/// of the constant lookup tables are then folded by the canonicalization.
+class TFHELutEncodingHoistingPass
+    : public TFHELutEncodingHoistingBase<TFHELutEncodingHoistingPass> {
+public:
+  void runOnOperation() override {
+    // The walk visits the inner loops first, so the encodings hoisted out of
+    // a loop are considered again for the enclosing ones
+    getOperation()->walk([&](mlir::LoopLikeOpInterface loop) {
+      for (mlir::Block &block : loop.getLoopBody()) {
+        for (mlir::Operation &op : llvm::make_early_inc_range(block)) {
+          if (!isLutEncoding(&op))
+            continue;
+          bool invariant =
+              llvm::all_of(op.getOperands(), [&](mlir::Value operand) {
+                return loop.isDefinedOutsideOfLoop(operand);
+              });
+          if (invariant)
+            loop.moveOutOfLoop(&op);
+        }
+      }
+    });
+  }
+};
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createTFHELutEncodingHoistingPass() {
+  return std::make_unique<TFHELutEncodingHoistingPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
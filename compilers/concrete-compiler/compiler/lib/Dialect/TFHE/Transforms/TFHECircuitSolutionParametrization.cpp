@@ -4,6 +4,7 @@
 // for license information.
 
 #include "concrete-optimizer.hpp"
+#include "concretelang/Common/LutEncoding.h"
 #include "concretelang/Dialect/RT/IR/RTOps.h"
 #include "concretelang/Dialect/RT/IR/RTTypes.h"
 #include "concretelang/Dialect/RT/TypeInference.h"
@@ -115,7 +116,7 @@ public:
         ctx, toGLWESecretKey(bsk.input_key), toGLWESecretKey(bsk.output_key),
         bsk.output_key.polynomial_size, bsk.output_key.glwe_dimension,
         bsk.br_decomposition_parameter.level,
-        bsk.br_decomposition_parameter.log2_base, -1);
+        bsk.br_decomposition_parameter.log2_base, -1, bsk.grouping_factor);
   }
 
   // Looks up the keyswitch key for an operation tagged with a given
@@ -338,22 +339,50 @@ public:
     return nullptr;
   }
 
-  // Returns the function operation for the function with the name
-  // `funcName`.
-  mlir::func::FuncOp lookupFunction(mlir::ModuleOp module,
-                                    llvm::StringRef funcName) {
-    mlir::func::FuncOp ret;
+  // The functions of a module and the operations referring to them
+  // through their symbol, in the order of a walk of the module
+  struct FunctionIndex {
+    llvm::DenseMap<mlir::StringAttr, mlir::func::FuncOp> functions;
+    llvm::DenseMap<mlir::StringAttr, llvm::SmallVector<mlir::func::CallOp>>
+        calls;
+    llvm::DenseMap<mlir::StringAttr, llvm::SmallVector<RT::CreateAsyncTaskOp>>
+        tasks;
+  };
 
-    module.walk([&](mlir::func::FuncOp funcOp) {
-      if (funcOp.getName() == funcName) {
-        ret = funcOp;
-        return mlir::WalkResult::interrupt();
-      }
+  // Returns the index of the functions of `module`, built by a single
+  // walk on the first call, instead of walking the whole module each
+  // time a call or a function is resolved. The rewriter only resolves
+  // the operations of the original module, which remain in place
+  // until all functions have been rewritten, so the index built
+  // before rewriting stays valid.
+  const FunctionIndex &getFunctionIndex(mlir::ModuleOp module) const {
+    if (indexedModule != module) {
+      functionIndex = FunctionIndex();
+      module.walk([&](mlir::Operation *op) {
+        if (mlir::func::FuncOp funcOp = llvm::dyn_cast<mlir::func::FuncOp>(op))
+          functionIndex.functions.try_emplace(funcOp.getSymNameAttr(), funcOp);
+        else if (mlir::func::CallOp callOp =
+                     llvm::dyn_cast<mlir::func::CallOp>(op))
+          functionIndex.calls[callOp.getCalleeAttr().getAttr()].push_back(
+              callOp);
+        else if (RT::CreateAsyncTaskOp taskOp =
+                     llvm::dyn_cast<RT::CreateAsyncTaskOp>(op))
+          functionIndex.tasks[taskOp.getWorkfn().getRootReference()].push_back(
+              taskOp);
+      });
+      indexedModule = module;
+    }
 
-      return mlir::WalkResult::advance();
-    });
+    return functionIndex;
+  }
 
-    return ret;
+  // Returns the function operation for the function with the name
+  // `funcName`.
+  mlir::func::FuncOp lookupFunction(mlir::ModuleOp module,
+                                    llvm::StringRef funcName) const {
+    const FunctionIndex &index = getFunctionIndex(module);
+    return index.functions.lookup(
+        mlir::StringAttr::get(module.getContext(), funcName));
   }
 
   LocalInferenceState
@@ -388,19 +417,19 @@ public:
           mlir::ModuleOp module =
               op->template getParentOfType<mlir::ModuleOp>();
 
-          module.walk([&](RT::CreateAsyncTaskOp createAsyncTaskOp) {
-            mlir::SymbolRefAttr workfnSymbol = createAsyncTaskOp.getWorkfn();
+          const FunctionIndex &index = getFunctionIndex(module);
 
-            if (workfnSymbol.getRootReference() == op.getName()) {
+          auto tasks = index.tasks.find(op.getSymNameAttr());
+          if (tasks != index.tasks.end()) {
+            for (RT::CreateAsyncTaskOp createAsyncTaskOp : tasks->second)
               addFuncAndCreateTaskConstraints(cs, op, createAsyncTaskOp);
-            }
-          });
+          }
 
-          module.walk([&](mlir::func::CallOp callOp) {
-            if (callOp.getCallee() == op.getName()) {
+          auto calls = index.calls.find(op.getSymNameAttr());
+          if (calls != index.calls.end()) {
+            for (mlir::func::CallOp callOp : calls->second)
               addFuncAndCallConstraints(cs, op, callOp);
-            }
-          });
+          }
 
           // Make sure that all return operations have the same operand types
           mlir::func::ReturnOp firstReturnOp;
@@ -441,7 +470,9 @@ public:
         .Case<TFHE::ZeroGLWEOp, TFHE::ZeroTensorGLWEOp,
               mlir::bufferization::AllocTensorOp, TFHE::KeySwitchGLWEOp,
               TFHE::BootstrapGLWEOp, TFHE::BatchedKeySwitchGLWEOp,
-              TFHE::BatchedBootstrapGLWEOp, TFHE::EncodeExpandLutForBootstrapOp,
+              TFHE::BatchedBootstrapGLWEOp, TFHE::ManyLutBootstrapGLWEOp,
+              TFHE::EncodeExpandLutForBootstrapOp,
+              TFHE::EncodeExpandManyLutForBootstrapOp,
               TFHE::EncodeLutForCrtWopPBSOp, TFHE::EncodePlaintextWithCrtOp,
               TFHE::WopPBSGLWEOp, mlir::func::ReturnOp,
               Tracing::TraceCiphertextOp, mlir::tensor::EmptyOp,
@@ -497,21 +528,22 @@ public:
           cs.converge(op, *this, state, inferredTypes);
         })
 
-        .Case<mlir::tensor::InsertOp, mlir::tensor::InsertSliceOp>(
-            [&](auto op) {
-              converge<SameOperandElementTypeConstraint<0, 1>,
-                       SameOperandAndResultTypeConstraint<1, 0>>(op, state,
-                                                                 inferredTypes);
-            })
+        .Case<mlir::tensor::InsertOp, mlir::tensor::InsertSliceOp,
+              mlir::tensor::ScatterOp>([&](auto op) {
+          converge<SameOperandElementTypeConstraint<0, 1>,
+                   SameOperandAndResultTypeConstraint<1, 0>>(op, state,
+                                                             inferredTypes);
+        })
         .Case<mlir::tensor::ParallelInsertSliceOp>([&](auto op) {
           converge<SameOperandElementTypeConstraint<0, 1>>(op, state,
                                                            inferredTypes);
         })
         .Case<mlir::tensor::ExtractOp, mlir::tensor::ExtractSliceOp,
-              mlir::tensor::CollapseShapeOp>([&](auto op) {
-          converge<SameOperandAndResultElementTypeConstraint<0, 0>>(
-              op, state, inferredTypes);
-        })
+              mlir::tensor::CollapseShapeOp, mlir::tensor::GatherOp>(
+            [&](auto op) {
+              converge<SameOperandAndResultElementTypeConstraint<0, 0>>(
+                  op, state, inferredTypes);
+            })
         .Case<mlir::scf::ForOp>([&](mlir::scf::ForOp op) {
           TypeConstraintSet<> cs;
 
@@ -712,59 +744,48 @@ public:
               mlir::ModuleOp module =
                   op->template getParentOfType<mlir::ModuleOp>();
 
-              if (module
-                      .walk([&](mlir::func::FuncOp func) {
-                        if (func.getName() == funcName) {
-                          for (mlir::Value arg : func.getArguments()) {
-                            if (!fn(arg))
-                              return mlir::WalkResult::interrupt();
-                          }
-
-                          for (mlir::Block &block :
-                               func.getRegion().getBlocks()) {
-                            if (mlir::func::ReturnOp returnOp =
-                                    llvm::dyn_cast<mlir::func::ReturnOp>(
-                                        block.getTerminator())) {
-                              for (mlir::Value res : returnOp->getOperands()) {
-                                if (!fn(res))
-                                  return mlir::WalkResult::interrupt();
-                              }
-                            }
-                          }
-                        }
-
-                        return mlir::WalkResult::advance();
-                      })
-                      .wasInterrupted()) {
-                return false;
-              } else {
+              mlir::func::FuncOp func = lookupFunction(module, funcName);
+
+              if (!func)
                 return true;
+
+              for (mlir::Value arg : func.getArguments()) {
+                if (!fn(arg))
+                  return false;
               }
+
+              for (mlir::Block &block : func.getRegion().getBlocks()) {
+                if (mlir::func::ReturnOp returnOp =
+                        llvm::dyn_cast<mlir::func::ReturnOp>(
+                            block.getTerminator())) {
+                  for (mlir::Value res : returnOp->getOperands()) {
+                    if (!fn(res))
+                      return false;
+                  }
+                }
+              }
+
+              return true;
             })
         .Case<mlir::func::FuncOp>([&](auto op) {
           mlir::ModuleOp module =
               op->template getParentOfType<mlir::ModuleOp>();
 
-          if (module
-                  .walk([&](RT::CreateAsyncTaskOp createAsyncTaskOp) {
-                    mlir::SymbolRefAttr workfnSymbol =
-                        createAsyncTaskOp.getWorkfn();
-
-                    if (workfnSymbol.getRootReference() == op.getName()) {
-                      for (mlir::Value operand :
-                           createAsyncTaskOp.getOperands().drop_front(3)) {
-                        if (!fn(operand))
-                          return mlir::WalkResult::interrupt();
-                      }
-                    }
-
-                    return mlir::WalkResult::advance();
-                  })
-                  .wasInterrupted()) {
-            return false;
-          } else {
+          const FunctionIndex &index = getFunctionIndex(module);
+          auto tasks = index.tasks.find(op.getSymNameAttr());
+
+          if (tasks == index.tasks.end())
             return true;
+
+          for (RT::CreateAsyncTaskOp createAsyncTaskOp : tasks->second) {
+            for (mlir::Value operand :
+                 createAsyncTaskOp.getOperands().drop_front(3)) {
+              if (!fn(operand))
+                return false;
+            }
           }
+
+          return true;
         })
         .Default([&](auto _op) { return true; });
   }
@@ -792,11 +813,10 @@ protected:
                 applyKeyswitch(op, resolver, currState, prevState,
                                oid.getInt());
               })
-          .Case<TFHE::BootstrapGLWEOp, TFHE::BatchedBootstrapGLWEOp>(
-              [&](auto op) {
-                applyBootstrap(op, resolver, currState, prevState,
-                               oid.getInt());
-              })
+          .Case<TFHE::BootstrapGLWEOp, TFHE::BatchedBootstrapGLWEOp,
+                TFHE::ManyLutBootstrapGLWEOp>([&](auto op) {
+            applyBootstrap(op, resolver, currState, prevState, oid.getInt());
+          })
           .Default([&](auto op) {
             applyGeneric(op, resolver, currState, prevState, oid.getInt());
           });
@@ -945,6 +965,9 @@ protected:
   }
 
   std::optional<CircuitSolutionWrapper> solution;
+
+  mutable mlir::ModuleOp indexedModule;
+  mutable FunctionIndex functionIndex;
 };
 
 // TFHE-specific rewriter that handles conflicts of contradicting TFHE
@@ -997,6 +1020,15 @@ public:
         return mlir::failure();
     }
 
+    if (TFHE::ManyLutBootstrapGLWEOp newBSOp =
+            llvm::dyn_cast<TFHE::ManyLutBootstrapGLWEOp>(newOp)) {
+      TFHE::ManyLutBootstrapGLWEOp oldBSOp =
+          llvm::cast<TFHE::ManyLutBootstrapGLWEOp>(oldOp);
+
+      if (checkFixupManyLutBootstrapLUTs(rewriter, oldBSOp, newBSOp).failed())
+        return mlir::failure();
+    }
+
     if (oldOp->getAttr("_dfr_work_function_attribute"))
       newOp->setAttr("_dfr_work_function_attribute", rewriter.getUnitAttr());
 
@@ -1171,6 +1203,65 @@ protected:
     return mlir::success();
   }
 
+  // Resizes the lookup tables of a freshly rewritten many-LUT
+  // bootstrap operation to the polynomial size of its key and
+  // updates the distance between the packed functions accordingly.
+  mlir::LogicalResult
+  checkFixupManyLutBootstrapLUTs(mlir::IRRewriter &rewriter,
+                                 TFHE::ManyLutBootstrapGLWEOp oldBSOp,
+                                 TFHE::ManyLutBootstrapGLWEOp newBSOp) {
+    TFHE::GLWEBootstrapKeyAttr newBSKeyAttr =
+        newBSOp->getAttrOfType<TFHE::GLWEBootstrapKeyAttr>("key");
+
+    assert(newBSKeyAttr);
+
+    TFHE::EncodeExpandManyLutForBootstrapOp oldEncodeOp =
+        newBSOp.getLookupTable()
+            .getDefiningOp<TFHE::EncodeExpandManyLutForBootstrapOp>();
+
+    if (!oldEncodeOp) {
+      oldBSOp->emitError(
+          "Cannot update lookup table after parametrization, only tables "
+          "generated through TFHE.encode_expand_many_lut_for_bootstrap are "
+          "supported");
+
+      return mlir::failure();
+    }
+
+    int64_t polySize = newBSKeyAttr.getPolySize();
+    int64_t lutCount = newBSOp.getLutCount();
+    int64_t lutSize = oldEncodeOp.getInputLookupTables()
+                          .getType()
+                          .cast<mlir::RankedTensorType>()
+                          .getDimSize(1);
+
+    if (polySize % (2 * lutCount * lutSize) != 0) {
+      oldBSOp->emitError("The ")
+          << lutCount << " lookup tables of " << lutSize
+          << " elements cannot be packed in a polynomial of size " << polySize;
+
+      return mlir::failure();
+    }
+
+    if (oldEncodeOp.getPolySize() != polySize) {
+      rewriter.setInsertionPointAfter(oldEncodeOp);
+
+      TFHE::EncodeExpandManyLutForBootstrapOp newEncodeOp =
+          rewriter.create<TFHE::EncodeExpandManyLutForBootstrapOp>(
+              oldEncodeOp.getLoc(),
+              mlir::RankedTensorType::get({polySize}, rewriter.getI64Type()),
+              oldEncodeOp.getInputLookupTables(), polySize,
+              oldEncodeOp.getOutputBits(), oldEncodeOp.getIsSigned());
+
+      newBSOp.setOperand(1, newEncodeOp);
+    }
+
+    newBSOp.setLutStride(
+        concretelang::lut::manyLutStride(polySize, lutSize, lutCount));
+
+    return mlir::success();
+  }
+
   TFHEParametrizationTypeResolver &typeResolver;
   const std::optional<CircuitSolutionWrapper> &solution;
 };
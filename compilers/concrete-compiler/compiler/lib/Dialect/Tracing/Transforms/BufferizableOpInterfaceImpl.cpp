@@ -82,6 +82,9 @@ void registerBufferizableOpInterfaceExternalModels(DialectRegistry &registry) {
     // trace_message
     Tracing::TraceMessageOp::attachInterface<
         TrivialBufferizableInterface<Tracing::TraceMessageOp>>(*ctx);
+    // probe
+    Tracing::ProbeOp::attachInterface<
+        TrivialBufferizableInterface<Tracing::ProbeOp>>(*ctx);
   });
 }
 } // namespace Tracing
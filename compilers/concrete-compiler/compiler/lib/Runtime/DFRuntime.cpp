@@ -12,6 +12,14 @@
 #ifdef CONCRETELANG_DATAFLOW_EXECUTION_ENABLED
 
 #include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <err.h>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <unistd.h>
+#include <unordered_map>
 #include <hpx/barrier.hpp>
 #include <hpx/future.hpp>
 #include <hpx/hpx_start.hpp>
@@ -21,8 +29,10 @@
 
 #include "concretelang/Runtime/DFRuntime.hpp"
 #include "concretelang/Runtime/distributed_generic_task_server.hpp"
+#include "concretelang/Runtime/key_placement.h"
 #include "concretelang/Runtime/runtime_api.h"
-#include "concretelang/Runtime/time_util.h"
+#include "concretelang/Runtime/tracing.h"
+#include "concretelang/Runtime/wrappers.h"
 
 namespace mlir {
 namespace concretelang {
@@ -32,9 +42,76 @@ static std::vector<GenericComputeClient> gcc;
 static hpx::distributed::barrier *_dfr_jit_phase_barrier;
 static hpx::distributed::barrier *_dfr_startup_barrier;
 static size_t num_nodes = 0;
-#if CONCRETELANG_TIMING_ENABLED
-static struct timespec init_timer, broadcast_timer, compute_timer, whole_timer;
-#endif
+// Number of tasks dispatched to each locality and not completed yet
+static std::unique_ptr<std::atomic<size_t>[]> pending_tasks;
+// Amount of input data whose transfer to a remote locality is deemed as
+// costly as waiting for one more task to complete
+static size_t transfer_bytes_per_task = 1 << 20;
+// Remote tasks running for longer than this multiple of the average
+// time of their work function are executed again on another locality,
+// 0 disables the speculative re-execution
+static double speculation_factor = 0;
+// Sending a task to a locality that does not hold the keys of its work
+// function costs this many more pending tasks, as the keys are fetched and
+// converted there, 0 disables the key affinity
+static size_t key_fetch_tasks = default_key_fetch_cost;
+// Number of remote localities the tasks of a work function may run on, 0
+// for all of them.  Each locality then only holds the keys of the work
+// functions of its partitions
+static size_t key_partition_nodes = 0;
+static std::mutex key_localities_guard;
+// Localities holding the keys of each work function
+static KeyLocalities key_localities;
+static std::mutex task_times_guard;
+static std::unordered_map<uint64_t, double> task_times;
+// Speculative re-execution statistics, see the debug interface
+static std::atomic<size_t> speculative_tasks{0};
+static std::atomic<size_t> speculative_wins{0};
+static std::atomic<size_t> remote_task_failures{0};
+// Completion tracking of the tasks created by one call in the persistent
+// runtime, which replaces the phase barriers
+struct DFRJob {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t pending = 0;
+  void *context;
+};
+static thread_local DFRJob *current_job = nullptr;
+// Start of the traced spans of a call, calls may run concurrently in the
+// persistent runtime
+static thread_local uint64_t execution_start, compute_start;
+// Graph of the tasks executed by one call, written to a file of
+// DFR_TASK_GRAPH_DIR when the call ends.  The times are in nanoseconds
+// since the start of the call, as observed by the root node: the
+// execution of a task starts once its inputs are available and ends once
+// its outputs are back on the root node.
+struct DFRTaskRecord {
+  uint64_t wfn_id;
+  size_t loc;
+  // Task computing each input, -1 for the inputs of the call
+  std::vector<int64_t> producers;
+  std::vector<size_t> input_bytes;
+  std::vector<size_t> output_bytes;
+  uint64_t created;
+  uint64_t start = 0;
+  uint64_t end = 0;
+  bool completed = false;
+};
+struct DFRTaskGraph {
+  std::mutex mutex;
+  std::chrono::steady_clock::time_point origin =
+      std::chrono::steady_clock::now();
+  std::vector<DFRTaskRecord> tasks;
+
+  uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - origin)
+        .count();
+  }
+};
+static std::string task_graph_dir;
+static std::atomic<size_t> task_graph_runs{0};
+static thread_local std::shared_ptr<DFRTaskGraph> current_task_graph;
 } // namespace
 
 void *dl_handle = nullptr;
@@ -47,6 +124,7 @@ WorkFunctionRegistry *_dfr_node_level_work_function_registry;
 #include "concretelang/Runtime/dfr_tasks.hpp"
 using namespace hpx;
 using namespace mlir::concretelang::dfr;
+namespace tracing = mlir::concretelang::tracing;
 
 // Ready futures are only used as inputs to tasks (never passed to
 // await_future), so we only need to track the references in task
@@ -67,10 +145,10 @@ void _dfr_deallocate_future(void *in) {
   if (prev_count == 1) {
     // If this was a memref for which a clone was needed, deallocate first.
     if (drf->cloned_memref_p)
-      free(
+      concrete_checked_free(
           (void *)(static_cast<StridedMemRefType<char, 1> *>(drf->future->get())
                        ->data));
-    free(drf->future->get());
+    concrete_checked_free(drf->future->get());
     delete (drf->future);
     delete drf;
   }
@@ -168,6 +246,13 @@ static bool dfr_required_p = false;
 static bool is_jit_p = false;
 static bool is_root_node_p = true;
 static bool use_omp_p = false;
+static bool persistent_p = false;
+static _dfr_thread_policy thread_policy = _DFR_THREAD_POLICY_DEFAULT;
+static size_t thread_policy_hpx_threads = 0;
+// Serializes the installation of new keys in the persistent runtime
+static std::mutex install_guard;
+static std::once_flag persistent_startup;
+static std::promise<void> persistent_release;
 } // namespace
 
 void _dfr_set_required(bool is_required) {
@@ -178,6 +263,10 @@ void _dfr_set_required(bool is_required) {
 }
 void _dfr_set_jit(bool is_jit) { is_jit_p = is_jit; }
 void _dfr_set_use_omp(bool use_omp) { use_omp_p = use_omp; }
+void _dfr_set_thread_policy(_dfr_thread_policy policy, size_t hpx_threads) {
+  thread_policy = policy;
+  thread_policy_hpx_threads = hpx_threads;
+}
 bool _dfr_is_jit() { return is_jit_p; }
 bool _dfr_is_root_node() { return is_root_node_p; }
 bool _dfr_use_omp() { return use_omp_p; }
@@ -191,6 +280,28 @@ void _dfr_register_work_function(wfnptr wfn) {
   _dfr_node_level_work_function_registry->getWorkFunctionName((void *)wfn);
 }
 
+namespace mlir {
+namespace concretelang {
+namespace dfr {
+std::string _dfr_get_work_function_name(uint64_t id) {
+  return _dfr_node_level_work_function_registry->getWorkFunctionName(id);
+}
+} // namespace dfr
+} // namespace concretelang
+} // namespace mlir
+
+HPX_PLAIN_ACTION(mlir::concretelang::dfr::_dfr_get_work_function_name,
+                 _dfr_get_work_function_name_action)
+
+std::string mlir::concretelang::dfr::_dfr_fetch_work_function_name(
+    uint64_t id) {
+  if (_dfr_is_root_node())
+    return _dfr_get_work_function_name(id);
+  return hpx::async<_dfr_get_work_function_name_action>(
+             hpx::find_root_locality(), id)
+      .get();
+}
+
 /************************************/
 /*  Initialization & Finalization.  */
 /************************************/
@@ -213,15 +324,10 @@ static inline void _dfr_stop_impl() {
   exit(EXIT_SUCCESS);
 }
 
-static inline void _dfr_start_impl(int argc, char *argv[]) {
-  CONCRETELANG_ENABLE_TIMING();
-  BEGIN_TIME(&init_timer);
-  if (dl_handle == nullptr)
-    dl_handle = dlopen(nullptr, RTLD_NOW);
-
-  // If OpenMP is to be used, we need to force its initialization
-  // before thread binding occurs. Otherwise OMP threads will be bound
-  // to the core of the thread initializing the OMP runtime.
+// If OpenMP is to be used, we need to force its initialization before
+// thread binding occurs. Otherwise OMP threads will be bound to the
+// core of the thread initializing the OMP runtime.
+static inline void _dfr_initialize_omp() {
   if (_dfr_use_omp()) {
 #pragma omp parallel shared(use_omp_p)
     {
@@ -229,10 +335,28 @@ static inline void _dfr_start_impl(int argc, char *argv[]) {
       use_omp_p = true;
     }
   }
+}
+
+static inline const char *_dfr_thread_policy_name(_dfr_thread_policy policy) {
+  switch (policy) {
+  case _DFR_THREAD_POLICY_PARTITION:
+    return "partition";
+  case _DFR_THREAD_POLICY_SHARED:
+    return "shared";
+  default:
+    return "default";
+  }
+}
+
+static inline void _dfr_start_impl(int argc, char *argv[]) {
+  uint64_t init_start = tracing::now();
+  if (dl_handle == nullptr)
+    dl_handle = dlopen(nullptr, RTLD_NOW);
 
+  std::string threadReport;
   if (argc == 0) {
-    int nCores, nOMPThreads, nHPXThreads;
-    std::string hpxThreadNum;
+    int nCores, nPUs, nOMPThreads, nHPXThreads;
+    std::string hpxThreadNum, hpxPUOffset, hpxPUStep;
 
     std::vector<char *> parameters;
     parameters.push_back(const_cast<char *>("__dummy_dfr_HPX_program_name__"));
@@ -246,36 +370,111 @@ static inline void _dfr_start_impl(int argc, char *argv[]) {
     nCores = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_CORE);
     if (nCores < 1)
       nCores = 1;
-
-    // We do not directly handle this, but we should take into account
-    // the choices made by the OpenMP runtime if we would be mixing
-    // loop & dataflow parallelism.
-    char *env = getenv("OMP_NUM_THREADS");
-    if (_dfr_use_omp() && env != nullptr)
-      nOMPThreads = strtoul(env, NULL, 10);
-    else if (_dfr_use_omp())
-      nOMPThreads = nCores;
-    else
-      nOMPThreads = 1;
-
-    // Unless specified, we will consider that within each node loop
-    // parallelism is the priority, so we would allocate either
-    // ncores/OMP_NUM_THREADS or ncores-OMP_NUM_THREADS+1.  Both make
-    // sense depending on whether we have very regular computation or
-    // not - the latter being more conservative in that we will
-    // exploit all cores, at the risk of oversubscribing.  Ideally the
-    // distribution of hardware resources to the runtime systems
-    // should be explicitly defined by the user.
+    nPUs = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_PU);
+    if (nPUs < nCores)
+      nPUs = nCores;
+    hwloc_topology_destroy(topology);
+
+    char *env = getenv("DFR_THREAD_POLICY");
+    if (env != nullptr && !_dfr_parse_thread_policy(env, thread_policy))
+      HPX_THROW_EXCEPTION(hpx::error::bad_parameter, "DFR: thread policy",
+                          "Error: invalid DFR_THREAD_POLICY, expected "
+                          "default, partition or shared.");
     env = getenv("DFR_NUM_THREADS");
-    if (env != nullptr) {
-      nHPXThreads = strtoul(env, NULL, 10);
+    if (env != nullptr)
+      thread_policy_hpx_threads = strtoul(env, NULL, 10);
+
+    switch (thread_policy) {
+    case _DFR_THREAD_POLICY_DEFAULT:
+      // We do not directly handle this, but we should take into account
+      // the choices made by the OpenMP runtime if we would be mixing
+      // loop & dataflow parallelism.
+      env = getenv("OMP_NUM_THREADS");
+      if (_dfr_use_omp() && env != nullptr)
+        nOMPThreads = strtoul(env, NULL, 10);
+      else if (_dfr_use_omp())
+        nOMPThreads = nCores;
+      else
+        nOMPThreads = 1;
+
+      // Unless specified, we will consider that within each node loop
+      // parallelism is the priority, so we would allocate either
+      // ncores/OMP_NUM_THREADS or ncores-OMP_NUM_THREADS+1.  Both make
+      // sense depending on whether we have very regular computation or
+      // not - the latter being more conservative in that we will
+      // exploit all cores, at the risk of oversubscribing.  The
+      // partition and shared policies avoid the oversubscription.
+      if (thread_policy_hpx_threads > 0) {
+        nHPXThreads = thread_policy_hpx_threads;
+        parameters.push_back(const_cast<char *>("--hpx:threads"));
+        hpxThreadNum = std::to_string(nHPXThreads);
+        parameters.push_back(const_cast<char *>(hpxThreadNum.c_str()));
+      } else
+        nHPXThreads = nCores + 1 - nOMPThreads;
+      if (nHPXThreads < 1)
+        nHPXThreads = 1;
+      break;
+
+    case _DFR_THREAD_POLICY_PARTITION: {
+      // OpenMP threads take the first cores and HPX workers one core
+      // each among the remaining ones.  Without loop parallelism all
+      // the cores go to HPX.
+      int pusPerCore = nPUs / nCores;
+      if (!_dfr_use_omp())
+        nHPXThreads = nCores;
+      else if (thread_policy_hpx_threads > 0)
+        nHPXThreads = thread_policy_hpx_threads;
+      else if ((env = getenv("OMP_NUM_THREADS")) != nullptr)
+        nHPXThreads = nCores - (int)strtoul(env, NULL, 10);
+      else
+        nHPXThreads = nCores / 2;
+      if (_dfr_use_omp() && nHPXThreads > nCores - 1)
+        nHPXThreads = nCores - 1;
+      if (nHPXThreads < 1)
+        nHPXThreads = 1;
+      nOMPThreads = _dfr_use_omp() ? std::max(nCores - nHPXThreads, 1) : 1;
+      if (_dfr_use_omp()) {
+        setenv("OMP_NUM_THREADS", std::to_string(nOMPThreads).c_str(), 1);
+        std::string places = "cores(" + std::to_string(nOMPThreads) + ")";
+        setenv("OMP_PLACES", places.c_str(), 0);
+        setenv("OMP_PROC_BIND", "close", 0);
+        omp_set_num_threads(nOMPThreads);
+      }
+      parameters.push_back(const_cast<char *>("--hpx:threads"));
+      hpxThreadNum = std::to_string(nHPXThreads);
+      parameters.push_back(const_cast<char *>(hpxThreadNum.c_str()));
+      if (_dfr_use_omp()) {
+        hpxPUOffset =
+            "--hpx:pu-offset=" + std::to_string(nOMPThreads * pusPerCore);
+        parameters.push_back(const_cast<char *>(hpxPUOffset.c_str()));
+      }
+      hpxPUStep = "--hpx:pu-step=" + std::to_string(pusPerCore);
+      parameters.push_back(const_cast<char *>(hpxPUStep.c_str()));
+    } break;
+
+    case _DFR_THREAD_POLICY_SHARED:
+      // A single pool: HPX workers on all the cores, and loops nested
+      // in the tasks do not start OpenMP teams of their own.
+      nHPXThreads = thread_policy_hpx_threads > 0 ? thread_policy_hpx_threads
+                                                  : nCores;
+      nOMPThreads = 1;
+      if (_dfr_use_omp()) {
+        setenv("OMP_NUM_THREADS", "1", 1);
+        omp_set_num_threads(1);
+      }
       parameters.push_back(const_cast<char *>("--hpx:threads"));
       hpxThreadNum = std::to_string(nHPXThreads);
       parameters.push_back(const_cast<char *>(hpxThreadNum.c_str()));
-    } else
-      nHPXThreads = nCores + 1 - nOMPThreads;
-    if (nHPXThreads < 1)
-      nHPXThreads = 1;
+      break;
+    }
+
+    threadReport = std::string("thread policy ") +
+                   _dfr_thread_policy_name(thread_policy) + ", " +
+                   std::to_string(nHPXThreads) + " HPX / " +
+                   std::to_string(nOMPThreads) + " OMP threads on " +
+                   std::to_string(nCores) + " cores";
+
+    _dfr_initialize_omp();
 
     // If the user does not provide their own config file, one is by
     // default located at the root of the concrete-compiler directory.
@@ -297,8 +496,9 @@ static inline void _dfr_start_impl(int argc, char *argv[]) {
       // sense for homomorphic computations (stacks need to reflect
       // the size of ciphertexts rather than simple cleartext
       // scalars).
-      if (std::find(parameters.begin(), parameters.end(), "--hpx:threads") ==
-          parameters.end()) {
+      if (std::find_if(parameters.begin(), parameters.end(), [](char *p) {
+            return !strcmp(p, "--hpx:threads");
+          }) == parameters.end()) {
         parameters.push_back(const_cast<char *>("--hpx:threads"));
         hpxThreadNum = std::to_string(nHPXThreads);
         parameters.push_back(const_cast<char *>(hpxThreadNum.c_str()));
@@ -314,23 +514,32 @@ static inline void _dfr_start_impl(int argc, char *argv[]) {
       hpx::start(nullptr, parameters.size(), parameters.data());
     }
   } else {
+    _dfr_initialize_omp();
     hpx::start(nullptr, argc, argv);
   }
 
   // Instantiate and initialise on each node
   is_root_node_p = (hpx::find_here() == hpx::find_root_locality());
   num_nodes = hpx::get_num_localities().get();
+  tracing::setProcessId(hpx::get_locality_id());
 
   _dfr_node_level_work_function_registry = new WorkFunctionRegistry();
 
-  char *env = getenv("DFR_LAZY_KEY_TRANSFER");
-  bool lazy = false;
-  if (env != nullptr)
-    if (!strncmp(env, "True", 4) || !strncmp(env, "true", 4) ||
-        !strncmp(env, "On", 2) || !strncmp(env, "on", 2) ||
-        !strncmp(env, "1", 1))
-      lazy = true;
-  _dfr_node_level_runtime_context_manager = new RuntimeContextManager(lazy);
+  auto envFlag = [](const char *name) {
+    char *env = getenv(name);
+    return env != nullptr &&
+           (!strncmp(env, "True", 4) || !strncmp(env, "true", 4) ||
+            !strncmp(env, "On", 2) || !strncmp(env, "on", 2) ||
+            !strncmp(env, "1", 1));
+  };
+  // Keys are either fetched by each node on first use, or distributed
+  // along a tree when the computation starts, optionally in fourier form
+  // to save their conversion on every node
+  bool lazy = envFlag("DFR_LAZY_KEY_TRANSFER");
+  bool fourier = envFlag("DFR_FOURIER_KEY_TRANSFER");
+  persistent_p = envFlag("DFR_PERSISTENT_RUNTIME");
+  _dfr_node_level_runtime_context_manager =
+      new RuntimeContextManager(lazy, fourier);
 
   _dfr_jit_phase_barrier = new hpx::distributed::barrier(
       "phase_barrier", num_nodes, hpx::get_locality_id());
@@ -344,16 +553,147 @@ static inline void _dfr_start_impl(int argc, char *argv[]) {
     gcc = hpx::new_<GenericComputeClient[]>(
               hpx::default_layout(hpx::find_all_localities()), num_nodes)
               .get();
+    pending_tasks.reset(new std::atomic<size_t>[num_nodes]);
+    for (size_t n = 0; n < num_nodes; ++n)
+      pending_tasks[n] = 0;
+    char *env = getenv("DFR_TRANSFER_BYTES_PER_TASK");
+    if (env != nullptr && strtoull(env, NULL, 10) > 0)
+      transfer_bytes_per_task = strtoull(env, NULL, 10);
+    env = getenv("DFR_SPECULATION_FACTOR");
+    if (env != nullptr && strtod(env, NULL) > 0)
+      speculation_factor = strtod(env, NULL);
+    env = getenv("DFR_KEY_FETCH_COST");
+    if (env != nullptr)
+      key_fetch_tasks = strtoull(env, NULL, 10);
+    env = getenv("DFR_KEY_PARTITION_NODES");
+    if (env != nullptr)
+      key_partition_nodes = strtoull(env, NULL, 10);
+    env = getenv("DFR_TASK_GRAPH_DIR");
+    if (env != nullptr)
+      task_graph_dir = env;
+  }
+  if (threadReport.empty())
+    tracing::complete("dfr", "initialization", init_start);
+  else
+    tracing::complete("dfr", "initialization", init_start,
+                      {{"threads", threadReport}});
+}
+
+/*  Persistent runtime.  With DFR_PERSISTENT_RUNTIME set, the remote
+    nodes keep serving tasks and their keys across calls of a same
+    program, instead of synchronizing with the root node on every call.
+    Each keyset used by a call is installed once on all the nodes, along
+    the distribution tree, under its own context id: calls, with the
+    same keys or not, can then run concurrently.  */
+namespace mlir {
+namespace concretelang {
+namespace dfr {
+// Install the keys of the parent node on this node, then on its children
+void _dfr_install_keyset(uint64_t contextId);
+void _dfr_release_remote_scheduler() { persistent_release.set_value(); }
+} // namespace dfr
+} // namespace concretelang
+} // namespace mlir
+
+HPX_PLAIN_ACTION(mlir::concretelang::dfr::_dfr_install_keyset,
+                 _dfr_install_keyset_action)
+HPX_PLAIN_ACTION(mlir::concretelang::dfr::_dfr_release_remote_scheduler,
+                 _dfr_release_remote_scheduler_action)
+
+static void _dfr_install_keyset_on_children(uint64_t contextId) {
+  size_t id = hpx::get_locality_id();
+  std::vector<hpx::future<void>> children;
+  for (size_t child = 2 * id + 1; child <= 2 * id + 2 && child < num_nodes;
+       ++child)
+    children.push_back(hpx::async<_dfr_install_keyset_action>(
+        hpx::naming::get_id_from_locality_id(child), contextId));
+  hpx::wait_all(children);
+}
+
+void mlir::concretelang::dfr::_dfr_install_keyset(uint64_t contextId) {
+  _dfr_node_level_runtime_context_manager->setContext(nullptr, contextId);
+  _dfr_install_keyset_on_children(contextId);
+}
+
+static void _dfr_start_persistent(void *ctx) {
+  if (num_nodes > 1)
+    std::call_once(persistent_startup,
+                   []() { _dfr_startup_barrier->wait(); });
+  if (!_dfr_is_root_node())
+    return;
+
+  auto manager = _dfr_node_level_runtime_context_manager;
+  std::optional<uint64_t> contextId = manager->findContext(ctx);
+  if (!contextId.has_value()) {
+    std::lock_guard<std::mutex> guard(install_guard);
+    contextId = manager->findContext(ctx);
+    if (!contextId.has_value()) {
+      tracing::TraceScope trace("keys", "key broadcasting");
+      contextId = manager->newContextId();
+      manager->setContext(ctx, *contextId);
+      _dfr_install_keyset_on_children(*contextId);
+      manager->detachContext(*contextId);
+    }
+  }
+  manager->registerCall(ctx, *contextId);
+  current_job = new DFRJob();
+  current_job->context = ctx;
+}
+
+static void _dfr_stop_persistent() {
+  if (current_job == nullptr)
+    return;
+  {
+    std::unique_lock<std::mutex> lock(current_job->mutex);
+    current_job->cv.wait(lock, []() { return current_job->pending == 0; });
+  }
+  _dfr_node_level_runtime_context_manager->unregisterCall(
+      current_job->context);
+  delete current_job;
+  current_job = nullptr;
+}
+
+// Write the graph of the tasks executed by a call to a new file of
+// DFR_TASK_GRAPH_DIR, for the analysis of concrete.compiler.task_graph
+static void _dfr_write_task_graph(DFRTaskGraph &graph) {
+  std::string path = task_graph_dir + "/task_graph." +
+                     std::to_string(getpid()) + "." +
+                     std::to_string(task_graph_runs.fetch_add(1)) + ".json";
+  std::ofstream os(path);
+  if (!os) {
+    warnx("WARNING: cannot write the task graph to %s", path.c_str());
+    return;
+  }
+  std::lock_guard<std::mutex> guard(graph.mutex);
+  os << "{\"localities\":" << num_nodes << ",\"end\":" << graph.now()
+     << ",\"tasks\":[";
+  for (size_t t = 0; t < graph.tasks.size(); ++t) {
+    DFRTaskRecord &task = graph.tasks[t];
+    os << (t == 0 ? "\n" : ",\n") << "{\"id\":" << t << ",\"name\":\""
+       << _dfr_get_work_function_name(task.wfn_id)
+       << "\",\"locality\":" << task.loc << ",\"inputs\":[";
+    for (size_t p = 0; p < task.producers.size(); ++p) {
+      os << (p == 0 ? "" : ",") << "{\"producer\":" << task.producers[p];
+      if (p < task.input_bytes.size())
+        os << ",\"bytes\":" << task.input_bytes[p];
+      os << "}";
+    }
+    os << "],\"outputs\":[";
+    for (size_t p = 0; p < task.output_bytes.size(); ++p)
+      os << (p == 0 ? "" : ",") << task.output_bytes[p];
+    os << "],\"created\":" << task.created;
+    if (task.completed)
+      os << ",\"start\":" << task.start << ",\"end\":" << task.end;
+    os << "}";
   }
-  END_TIME(&init_timer, "Initialization");
+  os << "\n]}\n";
 }
 
 /*  Start/stop functions to be called from within user code (or during
     JIT invocation).  These serve to pause/resume the runtime
     scheduler and to clean up used resources.  */
 void _dfr_start(int64_t use_dfr_p, void *ctx) {
-  CONCRETELANG_ENABLE_TIMING();
-  BEGIN_TIME(&whole_timer);
+  execution_start = tracing::now();
   if (use_dfr_p) {
     // The first invocation will initialise the runtime. As each call to
     // _dfr_start is matched with _dfr_stop, if this is not the first,
@@ -367,18 +707,21 @@ void _dfr_start(int64_t use_dfr_p, void *ctx) {
 
     assert(init_guard == active && "DFR runtime failed to initialise");
 
-    // If execution is distributed, then broadcast (possibly an empty)
-    // context from root to all compute nodes.
-    if (num_nodes > 1) {
-      BEGIN_TIME(&broadcast_timer);
+    if (persistent_p) {
+      _dfr_start_persistent(ctx);
+    } else if (num_nodes > 1) {
+      // If execution is distributed, then broadcast (possibly an empty)
+      // context from root to all compute nodes.
+      uint64_t broadcast_start = tracing::now();
       _dfr_node_level_runtime_context_manager->setContext(ctx);
       _dfr_startup_barrier->wait();
-      if (ctx) {
-        END_TIME(&broadcast_timer, "Key broadcasting");
-      }
+      if (ctx)
+        tracing::complete("keys", "key broadcasting", broadcast_start);
     }
   }
-  BEGIN_TIME(&compute_timer);
+  if (use_dfr_p && _dfr_is_root_node() && !task_graph_dir.empty())
+    current_task_graph = std::make_shared<DFRTaskGraph>();
+  compute_start = tracing::now();
 }
 
 // This function cannot be used to terminate the runtime as it is
@@ -387,7 +730,9 @@ void _dfr_start(int64_t use_dfr_p, void *ctx) {
 // called on exit from "main" when not using the main wrapper library.
 void _dfr_stop(int64_t use_dfr_p) {
   if (use_dfr_p) {
-    if (num_nodes > 1) {
+    if (persistent_p) {
+      _dfr_stop_persistent();
+    } else if (num_nodes > 1) {
       // The barrier is only needed to synchronize the different
       // computation phases when the compute nodes need to generate and
       // register new work functions in each phase.
@@ -397,8 +742,12 @@ void _dfr_stop(int64_t use_dfr_p) {
       _dfr_jit_phase_barrier->wait();
     }
   }
-  END_TIME(&compute_timer, "Compute");
-  END_TIME(&whole_timer, "Total execution");
+  if (current_task_graph != nullptr) {
+    _dfr_write_task_graph(*current_task_graph);
+    current_task_graph = nullptr;
+  }
+  tracing::complete("dfr", "compute", compute_start);
+  tracing::complete("dfr", "execution", execution_start);
 }
 
 namespace mlir {
@@ -406,6 +755,14 @@ namespace concretelang {
 namespace dfr {
 void _dfr_run_remote_scheduler() {
   _dfr_start(1, nullptr);
+  // In the persistent runtime, remote nodes serve tasks until the root
+  // node terminates instead of following each of its calls
+  if (persistent_p) {
+    static std::shared_future<void> released =
+        persistent_release.get_future().share();
+    released.wait();
+    return;
+  }
   _dfr_stop(1);
 }
 } // namespace dfr
@@ -423,8 +780,13 @@ void _dfr_try_initialize() {
 
 void _dfr_terminate() {
   uint64_t expected = active;
-  if (init_guard.compare_exchange_strong(expected, terminated))
+  if (init_guard.compare_exchange_strong(expected, terminated)) {
+    if (persistent_p && _dfr_is_root_node())
+      for (size_t n = 1; n < num_nodes; ++n)
+        hpx::post<_dfr_release_remote_scheduler_action>(
+            hpx::naming::get_id_from_locality_id(n));
     _dfr_stop_impl();
+  }
 
   assert((init_guard == terminated || init_guard == uninitialised) &&
          "DFR runtime failed to terminate");
@@ -465,6 +827,20 @@ void _dfr_debug_print_task(const char *name, size_t inputs, size_t outputs) {
   // clang-format on
 }
 
+void _dfr_debug_print_speculation_stats() {
+  hpx::cout << "Speculative re-executions: " << speculative_tasks.load()
+            << " (" << speculative_wins.load() << " completed first), "
+            << "remote task failures: " << remote_task_failures.load() << "\n"
+            << std::flush;
+}
+
+void _dfr_debug_get_speculation_stats(size_t *reexecutions, size_t *wins,
+                                      size_t *failures) {
+  *reexecutions = speculative_tasks.load();
+  *wins = speculative_wins.load();
+  *failures = remote_task_failures.load();
+}
+
 /// Generic utility function for printing debug info
 void _dfr_print_debug(size_t val) {
   hpx::cout << "_dfr_print_debug : " << val << "\n" << std::flush;
@@ -473,7 +849,6 @@ void _dfr_print_debug(size_t val) {
 #else // CONCRETELANG_DATAFLOW_EXECUTION_ENABLED
 
 #include "concretelang/Runtime/DFRuntime.hpp"
-#include "concretelang/Runtime/time_util.h"
 
 namespace mlir {
 namespace concretelang {
@@ -482,14 +857,12 @@ namespace {
 static bool is_jit_p = false;
 static bool use_omp_p = false;
 static size_t num_nodes = 1;
-#if CONCRETELANG_TIMING_ENABLED
-static struct timespec compute_timer;
-#endif
 } // namespace
 
 void _dfr_set_required(bool is_required) {}
 void _dfr_set_jit(bool p) { is_jit_p = p; }
 void _dfr_set_use_omp(bool use_omp) { use_omp_p = use_omp; }
+void _dfr_set_thread_policy(_dfr_thread_policy policy, size_t hpx_threads) {}
 bool _dfr_is_jit() { return is_jit_p; }
 bool _dfr_is_root_node() { return true; }
 bool _dfr_use_omp() { return use_omp_p; }
@@ -4,24 +4,31 @@
 // for license information.
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdarg>
 #include <err.h>
 #include <hwloc.h>
 #include <iostream>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <queue>
 #include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include <concretelang/Common/LutEncoding.h>
 #include <concretelang/Runtime/GPUDFG.hpp>
+#include <concretelang/Runtime/cost_model.h>
+#include <concretelang/Runtime/primitive_statistics.h>
 #include <concretelang/Runtime/stream_emulator_api.h>
-#include <concretelang/Runtime/time_util.h>
+#include <concretelang/Runtime/tracing.h>
 #include <concretelang/Runtime/wrappers.h>
 
 using RuntimeContext = mlir::concretelang::RuntimeContext;
@@ -35,16 +42,15 @@ void *alloc_and_memcpy_async_to_gpu(uint64_t *buf_ptr, uint64_t buf_offset,
                                     uint64_t buf_size, uint32_t gpu_idx,
                                     void *stream) {
   size_t buf_size_ = buf_size * sizeof(uint64_t);
+  tracing::TraceScope trace(
+      "gpu", "transfer to device",
+      {{"bytes", (int64_t)buf_size_}, {"device", (int64_t)gpu_idx}});
   void *ct_gpu = cuda_malloc_async(buf_size_, (cudaStream_t)stream, gpu_idx);
   cuda_memcpy_async_to_gpu(ct_gpu, buf_ptr + buf_offset, buf_size_,
                            (cudaStream_t)stream, gpu_idx);
   return ct_gpu;
 }
 
-#if CONCRETELANG_TIMING_ENABLED
-static struct timespec init_timer, blocking_get_timer, acc1, acc2;
-#endif
-
 using MemRef2 = MemRefDescriptor<2>;
 
 // When not using all accelerators on the machine, we distribute work
@@ -58,8 +64,43 @@ static std::atomic<size_t> next_device = {0};
 static size_t num_devices = 0;            // Set SDFG_NUM_GPUS to configure
 static size_t num_cores = 1;              // Set SDFG_NUM_THREADS to configure
 static size_t device_compute_factor = 16; // Set SDFG_DEVICE_TO_CORE_RATIO
+// Split batches according to the calibrated costs of the kernels
+// rather than device_compute_factor, disabled when a ratio is set.
+static bool use_cost_model = true;
+// Batch size used to calibrate the throughput of the devices
+static size_t gpu_calibration_samples = 256;
 // How much more memory than just input size is required on GPU to execute
 static float gpu_memory_inflation_factor = 1.5;
+// Number of streams per device through which the chunks of a batch are
+// pipelined, so that the transfers of a chunk overlap with the kernels of
+// the previous ones. Set SDFG_STREAMS_PER_GPU to configure.
+static size_t streams_per_gpu = 1;
+// Budget of device memory for the data of the streams, in bytes per
+// device, 0 for none. Set SDFG_GPU_MEMORY_BUDGET_MB to configure.
+// Whatever the budget, the data is also spilled to the host when the
+// free memory of a device gets below device_memory_reserve of its
+// total memory, which is left to the keys, the PBS scratch and the
+// buffers of the kernels.
+static size_t device_memory_budget = 0;
+static double device_memory_reserve = 0.1;
+// Bytes of stream data held on each device by all the DFGs
+static std::unique_ptr<std::atomic<size_t>[]> device_memory_used;
+// Stream slot used by the calling thread on each device, set by the
+// device schedulers for each chunk they process.
+static thread_local size_t current_stream_slot = 0;
+// Replay the bootstraps from CUDA graphs, captured the first time a
+// bootstrap of their shape runs on a stream. Set SDFG_CUDA_GRAPHS to
+// configure. The graphs are kept with the DFG, so they are only used
+// with persistent DFGs, which replay them across the calls.
+static bool use_cuda_graphs = false;
+// Largest bootstrap replayed from a graph, each graph holding buffers
+// of its own for its inputs and output
+static const size_t cuda_graph_max_samples = 1024;
+// Graphs kept per stream, and graphs captured per stream, beyond
+// which the bootstraps are launched directly. Graphs are captured
+// again when the PBS buffer of their stream is reallocated.
+static const size_t cuda_graphs_per_stream = 16;
+static const size_t cuda_graph_captures_per_stream = 64;
 
 // Get the byte size of a rank 2 MemRef
 static inline size_t memref_get_data_size(MemRef2 &m) {
@@ -81,7 +122,8 @@ static inline void memref_copy_contiguous(MemRef2 &out, MemRef2 &in) {
 
 // Copy contiguous rank 2 MemRef to a newly allocated, returned MemRef
 static inline MemRef2 memref_copy_alloc(MemRef2 &m) {
-  uint64_t *data = (uint64_t *)malloc(memref_get_data_size(m));
+  uint64_t *data =
+      (uint64_t *)concrete_checked_malloc(memref_get_data_size(m));
   MemRef2 ret = {
       data, data, 0, {m.sizes[0], m.sizes[1]}, {m.strides[0], m.strides[1]}};
   memref_copy_contiguous(ret, m);
@@ -110,8 +152,33 @@ static const int32_t invalid_location = -3;
 // this dependence is split further.
 static const int32_t single_chunk = -1;
 static const int32_t split_chunks = -2;
+// Timing simulation, enabled by setting SDFG_SIMULATED_GPUS: the
+// subgraphs are planned as for that many devices of the model
+// SDFG_SIMULATED_GPU_MODEL, which need not be on the machine. The
+// kernels and transfers of the device chunks are costed with the cost
+// model rather than executed, and all the work runs on the host cores
+// so that the results are still computed.
+static size_t simulated_devices = 0;
+static std::string simulated_device_model;
+// Index of a device of the model on the machine, on which it is
+// calibrated if the cost model cache has no measurement for it.
+static int32_t simulated_device_location = invalid_location;
+// Free memory of the simulated devices, in bytes. Set
+// SDFG_SIMULATED_GPU_MEMORY_MB to configure.
+static size_t simulated_device_memory = (size_t)16 << 30;
+// Bandwidth of the transfers to and from the simulated devices, in
+// bytes per second. Set SDFG_SIMULATED_TRANSFER_GBPS to configure.
+static double simulated_transfer_bandwidth = 12e9;
+// Timing predicted for the DFGs deleted so far
+static TimingSimulationReport simulation_totals;
+static std::mutex simulation_totals_guard;
+// Number of devices the subgraphs are planned for
+static inline size_t planned_devices() {
+  return (simulated_devices > 0) ? simulated_devices : num_devices;
+}
 struct Stream;
 struct Dependence;
+struct Process;
 // Track buffer/scratchpad for the PBS to avoid re-allocating it on
 // the device. Reuse where possible or reallocate if a larger buffer
 // is required.
@@ -152,28 +219,71 @@ struct PBS_buffer {
   uint32_t gpu_index;
 };
 
+// A bootstrap captured in a CUDA graph, which launches all its
+// kernels at once. The graph works on buffers of its own, the
+// bootstraps replaying it copying their inputs in and their output
+// out. Its executable graph is null if the capture failed.
+struct PBS_graph {
+  cudaGraphExec_t exec = nullptr;
+  void *in_gpu = nullptr;
+  void *out_gpu = nullptr;
+  void *lut_gpu = nullptr;
+  void *lut_indexes_gpu = nullptr;
+  void *indexes_gpu = nullptr;
+  void release(void *stream, uint32_t gpu_idx) {
+    if (exec != nullptr)
+      cudaGraphExecDestroy(exec);
+    for (void *buffer :
+         {in_gpu, out_gpu, lut_gpu, lut_indexes_gpu, indexes_gpu})
+      if (buffer != nullptr)
+        cuda_drop_async(buffer, (cudaStream_t)stream, gpu_idx);
+  }
+};
+// The shape of the bootstraps replaying a graph: the number of
+// samples, the parameters, the size of the accumulators, the key and
+// its device copy.
+typedef std::tuple<uint64_t, uint64_t, uint64_t, uint64_t, uint64_t,
+                   uint64_t, uint64_t, uint64_t, uintptr_t>
+    PBS_graph_key;
+
 // Keep track of the GPU/CUDA streams used for each accelerator and
-// associated PBS buffer.
+// associated PBS buffer. Each stream slot has its own PBS buffer, as
+// bootstraps may run concurrently on the different streams, and an
+// event marking the end of the last chunk queued on it.
 struct GPU_state {
   uint32_t gpu_idx;
-  void *gpu_stream;
-  PBS_buffer *pbs_buffer;
+  std::vector<void *> gpu_streams;
+  std::vector<PBS_buffer *> pbs_buffers;
+  std::vector<cudaEvent_t> events;
+  // The bootstraps captured on each stream, which use its PBS buffer
+  std::vector<std::map<PBS_graph_key, PBS_graph>> pbs_graphs;
+  std::vector<size_t> pbs_graph_captures;
   GPU_state(uint32_t idx)
-      : gpu_idx(idx), gpu_stream(nullptr), pbs_buffer(nullptr) {}
+      : gpu_idx(idx), gpu_streams(streams_per_gpu, nullptr),
+        pbs_buffers(streams_per_gpu, nullptr),
+        events(streams_per_gpu, nullptr), pbs_graphs(streams_per_gpu),
+        pbs_graph_captures(streams_per_gpu, 0) {}
   ~GPU_state() {
-    if (pbs_buffer != nullptr)
-      delete pbs_buffer;
-    if (gpu_stream != nullptr)
-      cuda_destroy_stream((cudaStream_t)gpu_stream, gpu_idx);
+    for (size_t slot = 0; slot < gpu_streams.size(); ++slot) {
+      free_pbs_graphs(slot);
+      if (pbs_buffers[slot] != nullptr)
+        delete pbs_buffers[slot];
+      if (events[slot] != nullptr)
+        cudaEventDestroy(events[slot]);
+      if (gpu_streams[slot] != nullptr)
+        cuda_destroy_stream((cudaStream_t)gpu_streams[slot], gpu_idx);
+    }
   }
   inline int8_t *get_pbs_buffer(uint32_t glwe_dimension,
                                 uint32_t polynomial_size, uint32_t level_count,
                                 uint32_t input_lwe_ciphertext_count) {
+    PBS_buffer *&pbs_buffer = pbs_buffers[current_stream_slot];
     if (pbs_buffer != nullptr && (pbs_buffer->glwe_dim != glwe_dimension ||
                                   pbs_buffer->poly_size != polynomial_size ||
                                   pbs_buffer->_level_count != level_count ||
                                   pbs_buffer->get_max_pbs_buffer_samples() <
                                       input_lwe_ciphertext_count)) {
+      free_pbs_graphs(current_stream_slot);
       delete pbs_buffer;
       pbs_buffer = nullptr;
     }
@@ -185,10 +295,34 @@ struct GPU_state {
                                       polynomial_size, level_count,
                                       input_lwe_ciphertext_count);
   }
-  inline void *get_gpu_stream() {
-    if (gpu_stream == nullptr)
-      gpu_stream = cuda_create_stream(gpu_idx);
-    return gpu_stream;
+  inline void *get_gpu_stream() { return get_gpu_stream(current_stream_slot); }
+  inline void *get_gpu_stream(size_t slot) {
+    if (gpu_streams[slot] == nullptr)
+      gpu_streams[slot] = cuda_create_stream(gpu_idx);
+    return gpu_streams[slot];
+  }
+  // Mark the end of the work queued so far on the stream `slot`
+  inline void record(size_t slot) {
+    if (events[slot] == nullptr)
+      cudaEventCreateWithFlags(&events[slot], cudaEventDisableTiming);
+    cudaEventRecord(events[slot], (cudaStream_t)get_gpu_stream(slot));
+  }
+  // Wait for the work last recorded on the stream `slot`
+  inline void wait(size_t slot) {
+    if (events[slot] != nullptr)
+      cudaEventSynchronize(events[slot]);
+  }
+  inline void synchronize() {
+    for (auto stream : gpu_streams)
+      if (stream != nullptr)
+        cudaStreamSynchronize((cudaStream_t)stream);
+  }
+  // Free the graphs captured on the stream `slot`, which point to its
+  // PBS buffer
+  inline void free_pbs_graphs(size_t slot) {
+    for (auto &graph : pbs_graphs[slot])
+      graph.second.release(gpu_streams[slot], gpu_idx);
+    pbs_graphs[slot].clear();
   }
 };
 
@@ -197,14 +331,39 @@ struct GPU_state {
 // streams and memory allocated which depends on execution progress on
 // accelerators before it can be freed.  As execution on accelerators
 // is asynchronous, this must wait for the next synchronization point.
+//
+// A persistent DFG is kept by its runtime context between the calls
+// of its circuit. As the values of the streams are recomputed when
+// the generation of their inputs changes, the next calls only replay
+// its construction, getting back the streams of the first call in the
+// order they were made, and put new values on the control program
+// streams.
 struct GPU_DFG {
   std::vector<GPU_state> gpus;
   uint32_t gpu_idx;
   void *gpu_stream;
-  GPU_DFG(uint32_t idx) : gpu_idx(idx), pbs_buffer(nullptr) {
+  // Start of the construction of the graph, in the time of the trace
+  uint64_t build_start;
+  // Timing predicted by the timing simulation
+  TimingSimulationReport timing;
+  // Set once the DFG runs, its construction being replayed by the
+  // next calls
+  bool built = false;
+  // The streams of the DFG in the order they were made, and how many
+  // of them were given back by the replay so far
+  std::vector<Stream *> made_streams;
+  size_t replayed_streams = 0;
+  // The context keeping the DFG between the calls of the circuit
+  // graph_id, null if the DFG is deleted after its call
+  RuntimeContext *owner = nullptr;
+  uint64_t graph_id = 0;
+  GPU_DFG(uint32_t idx) : gpu_idx(idx), build_start(tracing::now()) {
     for (uint32_t i = 0; i < num_devices; ++i)
       gpus.push_back(std::move(GPU_state(i)));
-    gpu_stream = gpus[idx].get_gpu_stream();
+    // The default device of a simulated DFG may not be on the machine
+    gpu_stream = (idx < gpus.size()) ? gpus[idx].get_gpu_stream() : nullptr;
+    timing.device_busy.resize(simulated_devices, 0);
+    resident.resize(num_devices);
   }
   ~GPU_DFG() {
     free_streams();
@@ -218,35 +377,44 @@ struct GPU_DFG {
   inline void free_stream_order_dependent_data() {
     std::lock_guard<std::mutex> guard(free_list_guard);
     for (auto p : to_free_list)
-      free(p);
+      concrete_checked_free(p);
     to_free_list.clear();
   }
   inline int8_t *get_pbs_buffer(uint32_t glwe_dimension,
                                 uint32_t polynomial_size, uint32_t level_count,
                                 uint32_t input_lwe_ciphertext_count) {
-    if (pbs_buffer == nullptr) {
-      int8_t *ret =
-          gpus[gpu_idx].get_pbs_buffer(glwe_dimension, polynomial_size,
-                                       level_count, input_lwe_ciphertext_count);
-      pbs_buffer = gpus[gpu_idx].pbs_buffer;
-      return ret;
-    }
-    return pbs_buffer->get_pbs_buffer(gpu_stream, gpu_idx, glwe_dimension,
-                                      polynomial_size, level_count,
-                                      input_lwe_ciphertext_count);
+    return gpus[gpu_idx].get_pbs_buffer(glwe_dimension, polynomial_size,
+                                        level_count,
+                                        input_lwe_ciphertext_count);
   }
   inline void *get_gpu_stream(int32_t loc) {
     if (loc < 0)
       return nullptr;
     return gpus[loc].get_gpu_stream();
   }
+  inline void synchronize_device(int32_t loc) { gpus[loc].synchronize(); }
   void free_streams();
+  // Track the data of a dependence held on a device, counting it in
+  // the memory used there, or stop tracking it when it leaves the
+  // device. Only whole dependences are tracked: the chunks of batches
+  // are sized to fit on the devices when the batches are split.
+  void track_device_data(Dependence *d);
+  void untrack_device_data(Dependence *d);
+  // Make room on the device `loc` for the inputs and the output of
+  // `p`, by spilling to the host the data of this DFG least recently
+  // used there. Returns false if it still does not fit, the process
+  // then running on the host.
+  bool make_room(Process *p, int32_t loc);
 
 private:
+  void spill_device_data(Dependence *d);
+  // The dependences of this DFG held on each device, least recently
+  // used first
+  std::vector<std::list<Dependence *>> resident;
+  std::mutex residency_guard;
   std::list<void *> to_free_list;
   std::mutex free_list_guard;
   std::list<Stream *> streams;
-  PBS_buffer *pbs_buffer;
 };
 
 struct Dependence;
@@ -255,6 +423,34 @@ static MemRef2 sdfg_gpu_debug_dependence(Dependence *d, cudaStream_t s);
 static bool sdfg_gpu_debug_compare_memref(MemRef2 &a, MemRef2 &b,
                                           char const *msg);
 
+// Number of samples of each chunk when splitting `num_samples` samples
+// into `num_chunks` host chunks followed by `num_gpu_chunks` device
+// chunks, each `gpu_chunk_factor` times larger than a host chunk.
+static std::vector<size_t> chunk_sizes(size_t num_samples, size_t num_chunks,
+                                       size_t num_gpu_chunks,
+                                       size_t gpu_chunk_factor) {
+  size_t chunk_size =
+      num_samples / (num_chunks + num_gpu_chunks * gpu_chunk_factor);
+  size_t gpu_chunk_size = chunk_size * gpu_chunk_factor;
+  size_t chunk_remainder = 0;
+  size_t gpu_chunk_remainder = 0;
+  // Without host chunks, the remainder goes to the device chunks
+  if (num_chunks > 0) {
+    chunk_size = (num_samples - gpu_chunk_size * num_gpu_chunks) / num_chunks;
+    chunk_remainder =
+        (num_samples - gpu_chunk_size * num_gpu_chunks) % num_chunks;
+  } else {
+    gpu_chunk_remainder = num_samples - gpu_chunk_size * num_gpu_chunks;
+  }
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i < num_chunks; ++i)
+    sizes.push_back((i < chunk_remainder) ? chunk_size + 1 : chunk_size);
+  for (size_t i = 0; i < num_gpu_chunks; ++i)
+    sizes.push_back((i < gpu_chunk_remainder) ? gpu_chunk_size + 1
+                                              : gpu_chunk_size);
+  return sizes;
+}
+
 // Dependences track the location and state of each block of memory
 // used as input/output to processes to allow either moving it on/off
 // devices or determining when deallocation is possible.
@@ -268,6 +464,11 @@ struct Dependence {
   size_t stream_generation;
   std::vector<Dependence *> chunks;
   std::vector<size_t> chunking_schedule;
+  // Device and position in its residency list of the data, when
+  // tracked by the DFG
+  bool resident = false;
+  int32_t resident_location = invalid_location;
+  std::list<Dependence *>::iterator residency;
   Dependence(int32_t l, MemRef2 hd, void *dd, bool ohr, bool alloc = false,
              int32_t chunk_id = single_chunk, size_t gen = 0)
       : location(l), host_data(hd), device_data(dd), onHostReady(ohr),
@@ -300,7 +501,7 @@ struct Dependence {
           }
           host_data = chunks[0]->host_data;
           host_data.allocated = host_data.aligned =
-              (uint64_t *)malloc(data_size);
+              (uint64_t *)concrete_checked_malloc(data_size);
           host_data.sizes[chunk_dim] = num_samples;
           size_t pos = 0;
           for (auto c : chunks) {
@@ -339,15 +540,11 @@ struct Dependence {
       }
       return;
     }
-    size_t chunk_size =
-        num_samples / (num_chunks + num_gpu_chunks * gpu_chunk_factor);
-    size_t gpu_chunk_size = chunk_size * gpu_chunk_factor;
-    chunk_size = (num_samples - gpu_chunk_size * num_gpu_chunks) / num_chunks;
-    size_t chunk_remainder =
-        (num_samples - gpu_chunk_size * num_gpu_chunks) % num_chunks;
+    std::vector<size_t> sizes = chunk_sizes(num_samples, num_chunks,
+                                            num_gpu_chunks, gpu_chunk_factor);
     uint64_t offset = 0;
-    for (size_t i = 0; i < num_chunks; ++i) {
-      size_t chunk_size_ = (i < chunk_remainder) ? chunk_size + 1 : chunk_size;
+    for (size_t i = 0; i < num_chunks + num_gpu_chunks; ++i) {
+      size_t chunk_size_ = sizes[i];
       MemRef2 m = host_data;
       m.sizes[chunk_dim] = chunk_size_;
       m.offset = offset + host_data.offset;
@@ -357,16 +554,6 @@ struct Dependence {
       chunks[i] = new Dependence(location, m, dd, onHostReady, false, i,
                                  stream_generation);
     }
-    for (size_t i = num_chunks; i < num_chunks + num_gpu_chunks; ++i) {
-      MemRef2 m = host_data;
-      m.sizes[chunk_dim] = gpu_chunk_size;
-      m.offset = offset + host_data.offset;
-      void *dd = (device_data == nullptr) ? device_data
-                                          : (uint64_t *)device_data + offset;
-      offset += gpu_chunk_size * host_data.strides[chunk_dim];
-      chunks[i] = new Dependence(location, m, dd, onHostReady, false, i,
-                                 stream_generation);
-    }
     chunk_id = split_chunks;
     location = split_location;
   }
@@ -404,6 +591,10 @@ struct Dependence {
     size_t csize = memref_get_data_size(chunks[chunk_id]->host_data);
     cudaStream_t s =
         (cudaStream_t)dfg->get_gpu_stream(chunks[chunk_id]->location);
+    tracing::TraceScope trace(
+        "gpu", "transfer to host",
+        {{"bytes", (int64_t)csize},
+         {"device", (int64_t)chunks[chunk_id]->location}});
     cuda_memcpy_async_to_cpu(((char *)host_data.aligned) + data_offset,
                              chunks[chunk_id]->device_data, csize, s,
                              chunks[chunk_id]->location);
@@ -411,7 +602,7 @@ struct Dependence {
   void free_chunk_host_data(int32_t chunk_id, GPU_DFG *dfg) {
     assert(chunks[chunk_id]->location == host_location &&
            chunks[chunk_id]->onHostReady && chunks[chunk_id]->hostAllocated);
-    free(chunks[chunk_id]->host_data.allocated);
+    concrete_checked_free(chunks[chunk_id]->host_data.allocated);
     chunks[chunk_id]->host_data.allocated = nullptr;
     chunks[chunk_id]->hostAllocated = false;
     chunks[chunk_id]->onHostReady = false;
@@ -429,6 +620,8 @@ struct Dependence {
   }
   inline void free_data(GPU_DFG *dfg, bool immediate = false) {
     if (device_data != nullptr) {
+      if (resident)
+        dfg->untrack_device_data(this);
       cuda_drop_async(device_data, (cudaStream_t)dfg->get_gpu_stream(location),
                       location);
     }
@@ -437,7 +630,7 @@ struct Dependence {
       // we cannot free host-side data until after the synchronization
       // point as it could still be used by an asynchronous operation.
       if (immediate) {
-        free(host_data.allocated);
+        concrete_checked_free(host_data.allocated);
         host_data.allocated = nullptr;
       } else {
         dfg->register_stream_order_dependent_allocation(host_data.allocated);
@@ -456,10 +649,14 @@ struct Dependence {
       if (onHostReady)
         return;
       if (host_data.allocated == nullptr) {
-        host_data.allocated = host_data.aligned = (uint64_t *)malloc(data_size);
+        host_data.allocated = host_data.aligned =
+            (uint64_t *)concrete_checked_malloc(data_size);
         hostAllocated = true;
       }
       cudaStream_t s = (cudaStream_t)dfg->get_gpu_stream(location);
+      tracing::TraceScope trace(
+          "gpu", "transfer to host",
+          {{"bytes", (int64_t)data_size}, {"device", (int64_t)location}});
       cuda_memcpy_async_to_cpu(host_data.aligned, device_data, data_size, s,
                                location);
       if (synchronize)
@@ -469,12 +666,20 @@ struct Dependence {
       assert(onHostReady &&
              "Device-to-device data transfers not supported yet.");
       cudaStream_t s = (cudaStream_t)dfg->get_gpu_stream(loc);
-      if (device_data != nullptr)
+      tracing::TraceScope trace(
+          "gpu", "transfer to device",
+          {{"bytes", (int64_t)data_size}, {"device", (int64_t)loc}});
+      if (device_data != nullptr) {
+        if (resident)
+          dfg->untrack_device_data(this);
         cuda_drop_async(device_data, s, location);
+      }
       device_data = cuda_malloc_async(data_size, s, loc);
       cuda_memcpy_async_to_gpu(
           device_data, host_data.aligned + host_data.offset, data_size, s, loc);
       location = loc;
+      if (chunk_id == single_chunk)
+        dfg->track_device_data(this);
     }
   }
 };
@@ -518,8 +723,364 @@ void memref_negate_lwe_ciphertext_u64_process(Process *p, int32_t loc,
                                               uint64_t *out_ptr);
 static inline void schedule_kernel(Process *p, int32_t loc, int32_t chunk_id,
                                    uint64_t *out_ptr) {
+  if (loc >= 0 && chunk_id == single_chunk && !p->dfg->make_room(p, loc))
+    loc = host_location;
+  tracing::TraceScope trace("sdfg", p->name,
+                            {{"location", loc}, {"chunk", chunk_id}});
   p->fun(p, loc, chunk_id, out_ptr);
 }
+
+// Cost model of the KS and PBS kernels, measured once per parameter
+// set on one host core and on each device by running the kernels on
+// trivial inputs. If SDFG_COST_MODEL_CACHE is set to a file path, the
+// measurements are persisted there and reused by later runs on the
+// same machine.
+class CostModel {
+public:
+  // Return the cost of the process' kernel on `loc`, calibrating it on
+  // first use. Processes which neither keyswitch nor bootstrap are
+  // assumed to have a negligible cost.
+  KernelCost get(Process *p, int32_t loc) {
+    return get(p, location_name(loc), loc);
+  }
+  // Return the cost of the process' kernel on a device of the model
+  // `location`, which may not be on the machine: the cost is then
+  // taken from the cache, as `loc` is invalid_location.
+  KernelCost get(Process *p, const std::string &location, int32_t loc) {
+    bool ks = p->fun == memref_keyswitch_lwe_u64_process;
+    if (!ks && p->fun != memref_bootstrap_lwe_u64_process)
+      return KernelCost();
+    std::string key = kernel_key(p, ks) + " " + location;
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!loaded)
+      load();
+    auto it = costs.find(key);
+    if (it != costs.end())
+      return it->second;
+    if (loc == invalid_location)
+      errx(1, "No calibration of %s in the SDFG cost model cache.",
+           key.c_str());
+    KernelCost cost = (loc == host_location)
+                          ? calibrate_on_host(p, ks)
+                          : calibrate_on_device(p, ks, loc);
+    costs[key] = cost;
+    save(key, cost);
+    return cost;
+  }
+  static std::string location_name(int32_t loc) {
+    if (loc == host_location)
+      return "cpu";
+    cudaDeviceProp properties;
+    cudaError_t error = cudaGetDeviceProperties(&properties, loc);
+    // Without its model, the device is calibrated under its index, which
+    // is not reused by other machines sharing the cache
+    if (error != cudaSuccess) {
+      warnx("WARNING: could not query the model of GPU %d: %s", loc,
+            cudaGetErrorString(error));
+      return "gpu-" + std::to_string(loc);
+    }
+    std::string name = properties.name;
+    std::replace(name.begin(), name.end(), ' ', '_');
+    return name;
+  }
+
+private:
+  static std::string kernel_key(Process *p, bool ks) {
+    char key[128];
+    if (ks)
+      snprintf(key, sizeof(key), "ks-%u-%u-%u-%u", p->level.val,
+               p->base_log.val, p->input_lwe_dim.val, p->output_lwe_dim.val);
+    else
+      snprintf(key, sizeof(key), "pbs-%u-%u-%u-%u-%u", p->level.val,
+               p->base_log.val, p->input_lwe_dim.val, p->poly_size.val,
+               p->glwe_dim.val);
+    return key;
+  }
+  template <typename F> static double best_time(F run) {
+    // Warm up first, this also moves/converts the keys if needed
+    run();
+    double best = 0;
+    for (int i = 0; i < 3; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      run();
+      std::chrono::duration<double> t =
+          std::chrono::steady_clock::now() - start;
+      if (i == 0 || t.count() < best)
+        best = t.count();
+    }
+    return best;
+  }
+  // A single sample on a single core as this is how host chunks execute
+  static KernelCost calibrate_on_host(Process *p, bool ks) {
+    std::vector<uint64_t> in(p->input_lwe_dim.val + 1, 0);
+    std::vector<uint64_t> out(p->output_size.val, 0);
+    std::vector<uint64_t> tlu(p->poly_size.val, 0);
+    KernelCost cost;
+    cost.per_sample = best_time([&]() {
+      if (ks)
+        memref_keyswitch_lwe_u64(
+            out.data(), out.data(), 0, out.size(), 1, in.data(), in.data(), 0,
+            in.size(), 1, p->level.val, p->base_log.val, p->input_lwe_dim.val,
+            p->output_lwe_dim.val, p->sk_index.val, p->ctx.val);
+      else
+        memref_bootstrap_lwe_u64(
+            out.data(), out.data(), 0, out.size(), 1, in.data(), in.data(), 0,
+            in.size(), 1, tlu.data(), tlu.data(), 0, tlu.size(), 1,
+            p->input_lwe_dim.val, p->poly_size.val, p->level.val,
+            p->base_log.val, p->glwe_dim.val, p->sk_index.val, p->ctx.val);
+    });
+    return cost;
+  }
+  // Fit the latency and throughput of the device from a single sample
+  // and a full calibration batch
+  static KernelCost calibrate_on_device(Process *p, bool ks, int32_t loc) {
+    size_t n = gpu_calibration_samples;
+    cudaStream_t s = (cudaStream_t)p->dfg->get_gpu_stream(loc);
+    std::vector<uint64_t> zeros(
+        n * std::max<size_t>(p->input_lwe_dim.val + 1, p->output_size.val), 0);
+    std::vector<uint64_t> indexes(n);
+    std::iota(indexes.begin(), indexes.end(), 0);
+    void *in_gpu = alloc_and_memcpy_async_to_gpu(
+        zeros.data(), 0, n * (p->input_lwe_dim.val + 1), loc, s);
+    void *out_gpu =
+        cuda_malloc_async(n * p->output_size.val * sizeof(uint64_t), s, loc);
+    void *indexes_gpu =
+        alloc_and_memcpy_async_to_gpu(indexes.data(), 0, n, loc, s);
+    // Zero LUT and LUT indexes
+    void *lut_gpu = nullptr;
+    void *lut_indexes_gpu = nullptr;
+    if (!ks) {
+      lut_gpu = alloc_and_memcpy_async_to_gpu(
+          zeros.data(), 0, (p->glwe_dim.val + 1) * p->poly_size.val, loc, s);
+      lut_indexes_gpu =
+          alloc_and_memcpy_async_to_gpu(zeros.data(), 0, n, loc, s);
+    }
+    auto run = [&](size_t samples) {
+      if (ks) {
+        void *ksk_gpu = p->ctx.val->get_ksk_gpu(
+            p->level.val, p->input_lwe_dim.val, p->output_lwe_dim.val, loc, s,
+            p->sk_index.val);
+        cuda_keyswitch_lwe_ciphertext_vector_64(
+            s, loc, out_gpu, indexes_gpu, in_gpu, indexes_gpu, ksk_gpu,
+            p->input_lwe_dim.val, p->output_lwe_dim.val, p->base_log.val,
+            p->level.val, samples);
+      } else {
+        int8_t *pbs_buffer = p->dfg->gpus[loc].get_pbs_buffer(
+            p->glwe_dim.val, p->poly_size.val, p->level.val, samples);
+        void *fbsk_gpu = p->ctx.val->get_bsk_gpu(
+            p->input_lwe_dim.val, p->poly_size.val, p->level.val,
+            p->glwe_dim.val, loc, s, p->sk_index.val);
+        cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
+            s, loc, out_gpu, indexes_gpu, lut_gpu, lut_indexes_gpu, in_gpu,
+            indexes_gpu, fbsk_gpu, pbs_buffer, p->input_lwe_dim.val,
+            p->glwe_dim.val, p->poly_size.val, p->base_log.val, p->level.val,
+            samples, 1, 1);
+      }
+      cudaStreamSynchronize(s);
+    };
+    // Calibrate the full batch first so that the PBS buffer is not
+    // reallocated between the measurements
+    double batch = best_time([&]() { run(n); });
+    double single = best_time([&]() { run(1); });
+    KernelCost cost;
+    cost.per_sample = std::max(batch - single, 0.0) / (n - 1);
+    cost.latency = std::max(single - cost.per_sample, 0.0);
+    cuda_drop_async(in_gpu, s, loc);
+    cuda_drop_async(out_gpu, s, loc);
+    cuda_drop_async(indexes_gpu, s, loc);
+    if (!ks) {
+      cuda_drop_async(lut_gpu, s, loc);
+      cuda_drop_async(lut_indexes_gpu, s, loc);
+    }
+    cudaStreamSynchronize(s);
+    return cost;
+  }
+  void load() {
+    loaded = true;
+    const char *path = getenv("SDFG_COST_MODEL_CACHE");
+    if (path == nullptr)
+      return;
+    load_kernel_costs(path, costs);
+  }
+  void save(const std::string &key, const KernelCost &cost) {
+    const char *path = getenv("SDFG_COST_MODEL_CACHE");
+    if (path == nullptr)
+      return;
+    if (!save_kernel_cost(path, key, cost))
+      warnx("WARNING: could not update the SDFG cost model cache %s", path);
+  }
+
+  std::mutex mutex;
+  bool loaded = false;
+  std::map<std::string, KernelCost> costs;
+};
+
+static CostModel cost_model;
+
+// Return the cost of the process' kernel on the device `dev`, or on
+// a simulated device in the timing simulation.
+static KernelCost device_cost(Process *p, size_t dev) {
+  if (simulated_devices > 0)
+    return cost_model.get(p, simulated_device_model,
+                          simulated_device_location);
+  return cost_model.get(p, dev);
+}
+
+// Device scratch memory of the bootstraps, in bytes per sample, for
+// each (glwe dimension, polynomial size, level count). It depends on
+// the variant of the PBS the backend picks for the parameters on the
+// device, so it is measured once by allocating the scratch of a
+// calibration batch.
+static std::map<std::tuple<uint32_t, uint32_t, uint32_t>, size_t>
+    pbs_scratch_sizes;
+static std::mutex pbs_scratch_sizes_guard;
+
+// Return the scratch memory per sample of the bootstrap process `p` on
+// the devices, or 0 when there is no device of the model to measure
+// it on.
+static size_t pbs_scratch_bytes_per_sample(Process *p) {
+  int32_t dev = (simulated_devices > 0) ? simulated_device_location : 0;
+  if (dev < 0 || (size_t)dev >= num_devices)
+    return 0;
+  auto key = std::make_tuple(p->glwe_dim.val, p->poly_size.val, p->level.val);
+  std::lock_guard<std::mutex> guard(pbs_scratch_sizes_guard);
+  auto it = pbs_scratch_sizes.find(key);
+  if (it != pbs_scratch_sizes.end())
+    return it->second;
+  // Large enough for the allocation granularity of the device not to
+  // skew the measurement
+  size_t samples = std::max<size_t>(gpu_calibration_samples, 1024);
+  size_t free_before, free_after, total;
+  int8_t *buffer = nullptr;
+  auto status = cudaSetDevice(dev);
+  assert(status == cudaSuccess);
+  void *stream = cuda_create_stream(dev);
+  cudaStreamSynchronize((cudaStream_t)stream);
+  cudaMemGetInfo(&free_before, &total);
+  scratch_cuda_programmable_bootstrap_64(stream, dev, &buffer, p->glwe_dim.val,
+                                         p->poly_size.val, p->level.val,
+                                         samples, true);
+  cudaStreamSynchronize((cudaStream_t)stream);
+  cudaMemGetInfo(&free_after, &total);
+  cleanup_cuda_programmable_bootstrap(stream, dev, &buffer);
+  cuda_destroy_stream((cudaStream_t)stream, dev);
+  size_t bytes = (free_before > free_after)
+                     ? (free_before - free_after + samples - 1) / samples
+                     : 0;
+  pbs_scratch_sizes[key] = bytes;
+  return bytes;
+}
+
+// Split `num_samples` samples of the subgraph made of the processes in
+// `queue` between `num_cores` host cores and the devices so as to
+// minimize the makespan. Returns false if the whole batch should run on
+// the host, otherwise sets the number of host chunks (possibly 0), the
+// size ratio of device chunks to host chunks and the smallest device
+// chunk worth its latency, which takes as long to compute as the
+// latency of its kernels.
+static bool plan_split_with_cost_model(std::list<Process *> &queue,
+                                       size_t num_samples, size_t &cpu_chunks,
+                                       size_t &gpu_chunk_factor,
+                                       size_t &min_gpu_chunk_samples) {
+  size_t devices = planned_devices();
+  KernelCost cpu, gpu;
+  for (auto p : queue) {
+    KernelCost c = cost_model.get(p, host_location);
+    cpu.per_sample += c.per_sample;
+    // The devices get equal shares of the batch, so plan for the
+    // slowest one
+    KernelCost slowest;
+    for (size_t dev = 0; dev < devices; ++dev) {
+      KernelCost g = device_cost(p, dev);
+      slowest.latency = std::max(slowest.latency, g.latency);
+      slowest.per_sample = std::max(slowest.per_sample, g.per_sample);
+    }
+    gpu.latency += slowest.latency;
+    gpu.per_sample += slowest.per_sample;
+  }
+  SplitPlan plan = plan_split(cpu, gpu, num_samples, num_cores, devices);
+  if (!plan.offload)
+    return false;
+  cpu_chunks = plan.cpu_chunks;
+  gpu_chunk_factor = plan.gpu_chunk_factor;
+  min_gpu_chunk_samples = plan.min_gpu_chunk_samples;
+  return true;
+}
+
+// Add to the timing of `dfg` the time predicted for the subgraph made
+// of the processes in `queue`, split into `num_chunks` host chunks and
+// `num_gpu_chunks` device chunks of the simulated devices. The device
+// chunks are dealt round-robin from the last one, starting with the
+// device `first_device`, as by the device schedulers. Each device chunk
+// transfers `in_bytes_per_sample` bytes per sample and `const_bytes`
+// bytes to the device, and `out_bytes_per_sample` bytes per sample
+// back. The upload of the keys, done once per device, is not counted.
+static void simulate_subgraph_timing(std::list<Process *> &queue,
+                                     GPU_DFG *dfg, size_t num_samples,
+                                     size_t num_chunks, size_t num_gpu_chunks,
+                                     size_t gpu_chunk_factor,
+                                     size_t in_bytes_per_sample,
+                                     size_t const_bytes,
+                                     size_t out_bytes_per_sample,
+                                     size_t first_device = 0) {
+  KernelCost cpu, gpu;
+  for (auto p : queue) {
+    cpu.per_sample += cost_model.get(p, host_location).per_sample;
+    KernelCost g = device_cost(p, 0);
+    gpu.latency += g.latency;
+    gpu.per_sample += g.per_sample;
+  }
+  std::vector<size_t> sizes =
+      chunk_sizes(num_samples, num_chunks, num_gpu_chunks, gpu_chunk_factor);
+  // The host chunks run concurrently on the cores
+  double host_busy = 0;
+  double host_longest = 0;
+  for (size_t c = 0; c < num_chunks; ++c) {
+    host_busy += cpu.time(sizes[c]);
+    host_longest = std::max(host_longest, cpu.time(sizes[c]));
+  }
+  double makespan = std::max(host_longest, host_busy / num_cores);
+
+  size_t devices = simulated_devices;
+  std::vector<double> kernels(devices, 0);
+  std::vector<double> transfers(devices, 0);
+  std::vector<double> first_in(devices, -1);
+  std::vector<double> last_out(devices, 0);
+  std::vector<double> shortest_kernel(devices, 0);
+  size_t dev = first_device;
+  for (size_t c = num_chunks + num_gpu_chunks; c-- > num_chunks;) {
+    size_t d = dev++ % devices;
+    size_t in_bytes = sizes[c] * in_bytes_per_sample + const_bytes;
+    size_t out_bytes = sizes[c] * out_bytes_per_sample;
+    double kernel = gpu.time(sizes[c]);
+    double in = in_bytes / simulated_transfer_bandwidth;
+    double out = out_bytes / simulated_transfer_bandwidth;
+    if (first_in[d] < 0 || kernel < shortest_kernel[d])
+      shortest_kernel[d] = kernel;
+    if (first_in[d] < 0)
+      first_in[d] = in;
+    last_out[d] = out;
+    kernels[d] += kernel;
+    transfers[d] += in + out;
+    dfg->timing.transfer_bytes += in_bytes + out_bytes;
+  }
+  for (size_t d = 0; d < devices; ++d) {
+    if (first_in[d] < 0)
+      continue;
+    double busy = kernels[d] + transfers[d];
+    // With several streams, the transfers of a chunk overlap with the
+    // kernels of the others, so only the first upload and the last
+    // download are exposed, unless the transfers dominate.
+    if (streams_per_gpu > 1)
+      busy = std::max(kernels[d] + first_in[d] + last_out[d],
+                      transfers[d] + shortest_kernel[d]);
+    dfg->timing.device_busy[d] += busy;
+    makespan = std::max(makespan, busy);
+  }
+  dfg->timing.host_busy += host_busy;
+  dfg->timing.makespan += makespan;
+  dfg->timing.subgraphs++;
+}
 struct Stream {
   Dependence *dep;
   Dependence *saved_dependence;
@@ -571,6 +1132,8 @@ struct Stream {
       if (dep != nullptr)
         dep->free_data(dfg);
       dep = d;
+      if (d->location >= 0 && d->device_data != nullptr)
+        dfg->track_device_data(d);
     }
     dep->stream_generation = generation;
     uses = 0;
@@ -616,6 +1179,20 @@ struct Stream {
     // the host.
     if (!is_batched_subgraph) {
       int32_t loc = (subgraph_bootstraps > 0) ? dfg->gpu_idx : host_location;
+      if (simulated_devices > 0 && loc != host_location) {
+        // Cost the subgraph on the default device, its inputs from
+        // outside the subgraph being uploaded and its result downloaded
+        size_t in_bytes = 0;
+        for (auto p : queue)
+          for (auto s : p->input_streams)
+            if (std::find(queue.begin(), queue.end(), s->producer) ==
+                    queue.end() &&
+                s->dep != nullptr)
+              in_bytes += memref_get_data_size(s->dep->host_data);
+        simulate_subgraph_timing(queue, dfg, 1, 0, 1, 1, in_bytes, 0,
+                                 memref_get_data_size(out), dfg->gpu_idx);
+        loc = host_location;
+      }
       for (auto p : queue)
         schedule_kernel(p, loc, single_chunk,
                         (p == producer) ? out.aligned : nullptr);
@@ -680,6 +1257,7 @@ struct Stream {
         mem_per_sample += sizeof(uint64_t);
       }
     }
+    size_t in_bytes_per_sample = mem_per_sample;
     // Approximate the memory required for intermediate values and outputs
     mem_per_sample += mem_per_sample *
                       (outputs.size() + intermediate_values.size()) /
@@ -687,52 +1265,128 @@ struct Stream {
     size_t num_chunks = 1;
     size_t num_gpu_chunks = 0;
     size_t gpu_chunk_factor = device_compute_factor;
+    size_t devices = planned_devices();
     // If the subgraph does not have sufficient computational
     // intensity (which we approximate by whether it bootstraps), then
     // we assume (TODO: confirm with profiling) that it is not
     // beneficial to offload to GPU.
     if (subgraph_bootstraps) {
       // Determine maximum GPU granulariry
-      size_t gpu_free_mem;
+      size_t gpu_free_mem = simulated_device_memory;
       size_t gpu_total_mem;
       // TODO: this could be improved
       // Force deallocation with a synchronization point
-      for (size_t g = 0; g < num_devices; ++g)
-        cudaStreamSynchronize((cudaStream_t)dfg->get_gpu_stream(g));
-      auto status = cudaMemGetInfo(&gpu_free_mem, &gpu_total_mem);
-      assert(status == cudaSuccess);
+      if (simulated_devices == 0) {
+        for (size_t g = 0; g < devices; ++g)
+          dfg->synchronize_device(g);
+        auto status = cudaMemGetInfo(&gpu_free_mem, &gpu_total_mem);
+        assert(status == cudaSuccess);
+      }
       // TODO - for now assume each device on the system has roughly same
-      // available memory.
-      size_t available_mem = gpu_free_mem;
+      // available memory. It is shared by the chunks in flight on the
+      // different streams of a device.
+      size_t available_mem = gpu_free_mem / streams_per_gpu;
       // Further assume (TODO) that kernel execution requires some
-      // magic factor more meory per sample to execute
+      // magic factor more meory per sample to execute, on top of the
+      // scratch of the bootstraps. Those of a chunk run one after the
+      // other on the scratch of its stream, sized for the largest one.
+      size_t scratch_per_sample = 0;
+      for (auto p : queue)
+        if (p->fun == memref_bootstrap_lwe_u64_process)
+          scratch_per_sample =
+              std::max(scratch_per_sample, pbs_scratch_bytes_per_sample(p));
+      size_t chunk_mem_per_sample =
+          (mem_per_sample ? mem_per_sample : 1) * gpu_memory_inflation_factor +
+          scratch_per_sample;
       size_t max_samples_per_chunk =
-          (available_mem - const_mem_per_sample) /
-          ((mem_per_sample ? mem_per_sample : 1) * gpu_memory_inflation_factor);
-
-      while (gpu_chunk_factor > 4) {
-        if (num_samples < num_cores + gpu_chunk_factor * num_devices)
-          gpu_chunk_factor >>= 1;
-        else
-          break;
+          (available_mem > const_mem_per_sample)
+              ? (available_mem - const_mem_per_sample) / chunk_mem_per_sample
+              : 0;
+      max_samples_per_chunk = std::max<size_t>(max_samples_per_chunk, 1);
+
+      size_t cpu_chunks = num_cores;
+      size_t min_gpu_chunk_samples = 1;
+      bool offload;
+      if (use_cost_model) {
+        offload = plan_split_with_cost_model(queue, num_samples, cpu_chunks,
+                                             gpu_chunk_factor,
+                                             min_gpu_chunk_samples);
+      } else {
+        while (gpu_chunk_factor > 4) {
+          if (num_samples < num_cores + gpu_chunk_factor * devices)
+            gpu_chunk_factor >>= 1;
+          else
+            break;
+        }
+        offload = num_samples >= num_cores + gpu_chunk_factor * devices;
       }
 
-      if (num_samples < num_cores + gpu_chunk_factor * num_devices) {
+      if (!offload) {
         num_chunks = std::min(num_cores, num_samples);
       } else {
-        size_t compute_resources = num_cores + num_devices * gpu_chunk_factor;
+        size_t compute_resources = cpu_chunks + devices * gpu_chunk_factor;
         size_t gpu_chunk_size =
             std::ceil((double)num_samples / compute_resources) *
             gpu_chunk_factor;
         size_t scale_factor =
             std::ceil((double)gpu_chunk_size / max_samples_per_chunk);
-        num_chunks = num_cores * scale_factor;
-        num_gpu_chunks = num_devices * scale_factor;
+        num_chunks = cpu_chunks * scale_factor;
+        num_gpu_chunks = devices * scale_factor;
+        // Cut the device chunks further so that each device has a
+        // chunk in flight on each of its streams, as long as the
+        // pieces stay large enough to amortize the kernel latencies
+        size_t pipeline = std::min(
+            {streams_per_gpu, gpu_chunk_factor,
+             std::max<size_t>(1, gpu_chunk_size / scale_factor /
+                                     min_gpu_chunk_samples)});
+        if (pipeline > 1 && scale_factor < streams_per_gpu) {
+          num_gpu_chunks *= pipeline;
+          gpu_chunk_factor = std::max<size_t>(
+              1, std::lround((double)gpu_chunk_factor / pipeline));
+        }
       }
     } else {
       num_chunks = std::min(num_cores, num_samples);
     }
 
+    std::function<uint64_t(Stream *)> get_output_size =
+        [&](Stream *s) -> uint64_t {
+      uint64_t res = 0;
+      // If this stream is not produced within SDFG, we could use
+      // the input size. For now return 0.
+      if (s->producer == nullptr)
+        return 0;
+      // If the producer process has an output size registered,
+      // return it.
+      if (s->producer->output_size.val > 0)
+        return s->producer->output_size.val;
+      // Finally we look for sizes from inputs to the producer if
+      // we don't have it registered as poly size does not change
+      // in operators that do not register size.
+      for (auto p : s->producer->input_streams) {
+        uint64_t p_size = get_output_size(p);
+        if (p_size == 0)
+          continue;
+        if (res == 0)
+          res = get_output_size(p);
+        else
+          assert(res == p_size);
+      }
+      return res;
+    };
+    // In the timing simulation, cost the planned split then run the
+    // whole batch on the host cores
+    if (simulated_devices > 0 && subgraph_bootstraps) {
+      Stream *o = outputs.front();
+      size_t output_size = (o == this) ? out.sizes[1] : get_output_size(o);
+      simulate_subgraph_timing(queue, dfg, num_samples, num_chunks,
+                               num_gpu_chunks, gpu_chunk_factor,
+                               in_bytes_per_sample, const_mem_per_sample,
+                               output_size * sizeof(uint64_t));
+      num_chunks = std::min(num_cores, num_samples);
+      num_gpu_chunks = 0;
+    }
+
     for (auto i : inputs)
       i->dep->split_dependence(num_chunks, num_gpu_chunks,
                                (i->ct_stream) ? 0 : 1, i->const_stream,
@@ -748,31 +1402,6 @@ struct Stream {
     for (auto o : outputs) {
       if (!o->need_new_gen())
         continue;
-      std::function<uint64_t(Stream *)> get_output_size =
-          [&](Stream *s) -> uint64_t {
-        uint64_t res = 0;
-        // If this stream is not produced within SDFG, we could use
-        // the input size. For now return 0.
-        if (s->producer == nullptr)
-          return 0;
-        // If the producer process has an output size registered,
-        // return it.
-        if (s->producer->output_size.val > 0)
-          return s->producer->output_size.val;
-        // Finally we look for sizes from inputs to the producer if
-        // we don't have it registered as poly size does not change
-        // in operators that do not register size.
-        for (auto p : s->producer->input_streams) {
-          uint64_t p_size = get_output_size(p);
-          if (p_size == 0)
-            continue;
-          if (res == 0)
-            res = get_output_size(p);
-          else
-            assert(res == p_size);
-        }
-        return res;
-      };
       MemRef2 out_mref;
       bool allocated = false;
       if (o == this) {
@@ -781,7 +1410,8 @@ struct Stream {
         uint64_t output_size = get_output_size(o);
         out_mref = {0, 0, 0, {num_samples, output_size}, {output_size, 1}};
         size_t data_size = memref_get_data_size(out_mref);
-        out_mref.allocated = out_mref.aligned = (uint64_t *)malloc(data_size);
+        out_mref.allocated = out_mref.aligned =
+            (uint64_t *)concrete_checked_malloc(data_size);
         allocated = true;
       }
 
@@ -800,7 +1430,9 @@ struct Stream {
         }
       }
     }
-    // Execute graph
+    // Execute graph, the workers recording the primitives in the statistics
+    // of the caller, if any
+    auto *statistics = getCurrentPrimitiveStatistics();
     std::list<std::thread> workers;
     std::list<std::thread> gpu_schedulers;
     std::vector<std::list<size_t>> gpu_chunk_list;
@@ -810,6 +1442,8 @@ struct Stream {
       if (!subgraph_bootstraps) {
         workers.push_back(std::thread(
             [&](std::list<Process *> queue, size_t c, int32_t host_location) {
+              PrimitiveStatisticsScope scope(statistics);
+              tracing::setThreadName("sdfg cpu worker");
               for (auto p : queue)
                 schedule_kernel(p, host_location, c, nullptr);
               for (auto iv : intermediate_values)
@@ -821,6 +1455,8 @@ struct Stream {
         if (c < num_chunks) {
           workers.push_back(std::thread(
               [&](std::list<Process *> queue, size_t c, int32_t host_location) {
+                PrimitiveStatisticsScope scope(statistics);
+                tracing::setThreadName("sdfg cpu worker");
                 for (auto p : queue) {
                   Stream *os = p->output_streams[0];
                   auto it = std::find(outputs.begin(), outputs.end(), os);
@@ -852,7 +1488,16 @@ struct Stream {
     for (dev = 0; dev < num_devices; ++dev) {
       gpu_schedulers.push_back(std::thread(
           [&](std::list<Process *> queue, int32_t dev) {
+            PrimitiveStatisticsScope scope(statistics);
+            tracing::setThreadName("sdfg gpu scheduler");
+            size_t chunk_index = 0;
             for (size_t c : gpu_chunk_list[dev]) {
+              // Chunks go round-robin through the streams of the
+              // device. A stream is reused once its previous chunk is
+              // done, while the chunks queued on other streams still
+              // run, which bounds the memory used on the device.
+              current_stream_slot = chunk_index++ % streams_per_gpu;
+              dfg->gpus[dev].wait(current_stream_slot);
               size_t gpu_free_mem;
               size_t gpu_total_mem;
               auto status = cudaSetDevice(dev);
@@ -888,8 +1533,9 @@ struct Stream {
                 iv->dep->free_chunk_device_data(c, dfg);
               for (auto o : outputs)
                 o->dep->free_chunk_device_data(c, dfg);
-              cudaStreamSynchronize((cudaStream_t)dfg->get_gpu_stream(dev));
+              dfg->gpus[dev].record(current_stream_slot);
             }
+            current_stream_slot = 0;
           },
           queue, dev));
     }
@@ -903,7 +1549,7 @@ struct Stream {
     for (auto o : outputs)
       o->dep->finalize_merged_dependence(dfg);
     for (dev = 0; dev < num_devices; ++dev)
-      cudaStreamSynchronize((cudaStream_t)dfg->get_gpu_stream(dev));
+      dfg->synchronize_device(dev);
     // We will assume that only one subgraph is being processed per
     // DFG at a time, so we can safely free these here.
     dfg->free_stream_order_dependent_data();
@@ -919,14 +1565,15 @@ struct Stream {
     // in schedule_work).
     assert(dep != nullptr && dep->onHostReady);
 
-    // For now we make a copy of this dependence for future use as we
+    // Processes consuming this value later need a copy of it, as we
     // can't assume that the output location will remain live until
-    // the next use.
-    // TODO: eliminate this copy.
-    if (!dep->hostAllocated)
+    // the next use. A value only read by the control program stays in
+    // the output location, which its next computation overwrites.
+    if (!dep->hostAllocated && !consumers.empty()) {
       dep->host_data = memref_copy_alloc(out);
+      dep->hostAllocated = true;
+    }
     dep->onHostReady = true;
-    dep->hostAllocated = true;
   }
   Dependence *get(int32_t location, int32_t chunk_id = single_chunk) {
     assert(dep != nullptr && "Dependence could not be computed.");
@@ -937,6 +1584,9 @@ struct Stream {
       return d;
     }
     dep->copy(location, dfg, false);
+    // Mark the data as just used on its device
+    if (dep->resident)
+      dfg->track_device_data(dep);
     return dep;
   }
   inline bool need_new_gen(int32_t chunk_id = single_chunk) {
@@ -962,6 +1612,103 @@ void GPU_DFG::free_streams() {
     delete s;
 }
 
+void GPU_DFG::track_device_data(Dependence *d) {
+  std::lock_guard<std::mutex> guard(residency_guard);
+  if (d->resident) {
+    auto &list = resident[d->resident_location];
+    list.splice(list.end(), list, d->residency);
+    return;
+  }
+  auto &list = resident[d->location];
+  d->residency = list.insert(list.end(), d);
+  d->resident = true;
+  d->resident_location = d->location;
+  device_memory_used[d->location] += memref_get_data_size(d->host_data);
+}
+
+void GPU_DFG::untrack_device_data(Dependence *d) {
+  std::lock_guard<std::mutex> guard(residency_guard);
+  if (!d->resident)
+    return;
+  resident[d->resident_location].erase(d->residency);
+  d->resident = false;
+  device_memory_used[d->resident_location] -=
+      memref_get_data_size(d->host_data);
+}
+
+void GPU_DFG::spill_device_data(Dependence *d) {
+  int32_t loc = d->location;
+  size_t data_size = memref_get_data_size(d->host_data);
+  tracing::TraceScope trace(
+      "gpu", "spill to host",
+      {{"bytes", (int64_t)data_size}, {"device", (int64_t)loc}});
+  // The host buffer comes from the pinned pool when it is enabled
+  d->copy(host_location, this, true);
+  untrack_device_data(d);
+  cuda_drop_async(d->device_data, (cudaStream_t)get_gpu_stream(loc), loc);
+  d->device_data = nullptr;
+  d->location = host_location;
+}
+
+bool GPU_DFG::make_room(Process *p, int32_t loc) {
+  // Device memory needed by the inputs to upload and by the output,
+  // which has as many samples as the first input
+  size_t need = 0;
+  Dependence *first = p->input_streams[0]->dep;
+  if (first != nullptr) {
+    need = (p->output_size.val > 0)
+               ? first->host_data.sizes[0] * p->output_size.val *
+                     sizeof(uint64_t)
+               : memref_get_data_size(first->host_data);
+  }
+  for (auto s : p->input_streams)
+    if (s->dep != nullptr && s->dep->location != loc)
+      need += memref_get_data_size(s->dep->host_data);
+  size_t free_mem, total_mem;
+  auto status = cudaSetDevice(loc);
+  assert(status == cudaSuccess);
+  cudaMemGetInfo(&free_mem, &total_mem);
+  size_t reserve = total_mem * device_memory_reserve;
+  // The spilled data is freed in the order of the stream, so its
+  // memory is counted as free right away
+  size_t released = 0;
+  auto fits = [&](size_t used) {
+    if (device_memory_budget > 0 && used + need > device_memory_budget)
+      return false;
+    return free_mem + released >= need + reserve;
+  };
+  std::list<Dependence *> victims;
+  {
+    std::lock_guard<std::mutex> guard(residency_guard);
+    size_t used = device_memory_used[loc];
+    for (auto d : resident[loc]) {
+      if (fits(used))
+        break;
+      // The inputs of the process stay, and so does the data of
+      // split dependences as their chunks point into it
+      if (d->chunk_id != single_chunk ||
+          std::any_of(p->input_streams.begin(), p->input_streams.end(),
+                      [d](Stream *s) { return s->dep == d; }))
+        continue;
+      size_t data_size = memref_get_data_size(d->host_data);
+      victims.push_back(d);
+      used -= data_size;
+      released += data_size;
+    }
+  }
+  for (auto d : victims)
+    spill_device_data(d);
+  if (fits(device_memory_used[loc]))
+    return true;
+  static std::once_flag warned;
+  std::call_once(warned, [&]() {
+    warnx("WARNING: not enough memory on GPU %d for %s, running it on the "
+          "host. Set SDFG_GPU_MEMORY_BUDGET_MB to spill earlier.",
+          loc, p->name);
+  });
+  return false;
+}
+
 static inline mlir::concretelang::gpu_dfg::Process *
 make_process_1_1(void *dfg, void *sin1, void *sout,
                  void (*fun)(Process *, int32_t, int32_t, uint64_t *)) {
@@ -1025,7 +1772,7 @@ make_process_2_1(void *dfg, void *sin1, void *sin2, void *sout,
   if (d->onHostReady)
     return d->host_data;
   size_t data_size = memref_get_data_size(d->host_data);
-  uint64_t *data = (uint64_t *)malloc(data_size);
+  uint64_t *data = (uint64_t *)concrete_checked_malloc(data_size);
   MemRef2 ret = {data,
                  data,
                  0,
@@ -1067,7 +1814,9 @@ void memref_keyswitch_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
     if (loc == host_location) {
       // If it is not profitable to offload, schedule kernel on CPU
       out.allocated = out.aligned =
-          (uint64_t *)((out_ptr != nullptr) ? out_ptr : malloc(data_size));
+          (uint64_t *)((out_ptr != nullptr)
+                           ? out_ptr
+                           : concrete_checked_malloc(data_size));
       memref_batched_keyswitch_lwe_u64(
           out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
           out.strides[0], out.strides[1], d->host_data.allocated,
@@ -1081,6 +1830,11 @@ void memref_keyswitch_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
       return dep;
     } else {
       // Schedule the keyswitch kernel on the GPU
+      PrimitiveTimer timer(RuntimePrimitive::KEYSWITCH, p->sk_index.val, -1,
+                           num_samples, true);
+      tracing::TraceScope trace(
+          "gpu", "keyswitch kernel",
+          {{"samples", (int64_t)num_samples}, {"device", loc}});
       cudaStream_t s = (cudaStream_t)p->dfg->get_gpu_stream(loc);
       void *ct0_gpu = d->device_data;
       void *out_gpu = cuda_malloc_async(data_size, s, loc);
@@ -1088,7 +1842,8 @@ void memref_keyswitch_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
           p->level.val, p->input_lwe_dim.val, p->output_lwe_dim.val, loc, s,
           p->sk_index.val);
       // Initialize indexes
-      uint64_t *indexes = (uint64_t *)malloc(num_samples * sizeof(uint64_t));
+      uint64_t *indexes = (uint64_t *)concrete_checked_malloc(
+          num_samples * sizeof(uint64_t));
       for (uint32_t i = 0; i < num_samples; i++) {
         indexes[i] = i;
       }
@@ -1111,9 +1866,122 @@ void memref_keyswitch_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
     p->output_streams[0]->put(sched(idep), chunk_id);
 }
 
+// Capture in a CUDA graph the bootstrap of `num_samples` ciphertexts
+// by `p` on the stream `s` of the device `loc`, on buffers allocated
+// for the graph.
+static PBS_graph capture_bootstrap_graph(Process *p, int32_t loc,
+                                         cudaStream_t s, uint64_t num_samples,
+                                         size_t glwe_ct_size,
+                                         int8_t *pbs_buffer, void *fbsk_gpu) {
+  tracing::TraceScope trace(
+      "gpu", "bootstrap graph capture",
+      {{"samples", (int64_t)num_samples}, {"device", loc}});
+  PBS_graph graph;
+  size_t indexes_size = num_samples * sizeof(uint64_t);
+  graph.in_gpu = cuda_malloc_async(
+      num_samples * (p->input_lwe_dim.val + 1) * sizeof(uint64_t), s, loc);
+  graph.out_gpu = cuda_malloc_async(
+      num_samples * p->output_size.val * sizeof(uint64_t), s, loc);
+  graph.lut_gpu = cuda_malloc_async(glwe_ct_size, s, loc);
+  graph.lut_indexes_gpu = cuda_malloc_async(indexes_size, s, loc);
+  std::vector<uint64_t> indexes(num_samples);
+  std::iota(indexes.begin(), indexes.end(), 0);
+  graph.indexes_gpu = cuda_malloc_async(indexes_size, s, loc);
+  cuda_memcpy_async_to_gpu(graph.indexes_gpu, indexes.data(), indexes_size, s,
+                           loc);
+  cudaStreamSynchronize(s);
+
+  // Only this thread may use the CUDA API unsafely while capturing, a
+  // synchronization in the bootstrap making the capture fail
+  cudaGraph_t captured = nullptr;
+  if (cudaStreamBeginCapture(s, cudaStreamCaptureModeThreadLocal) ==
+      cudaSuccess) {
+    cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
+        s, loc, graph.out_gpu, graph.indexes_gpu, graph.lut_gpu,
+        graph.lut_indexes_gpu, graph.in_gpu, graph.indexes_gpu, fbsk_gpu,
+        pbs_buffer, p->input_lwe_dim.val, p->glwe_dim.val, p->poly_size.val,
+        p->base_log.val, p->level.val, num_samples, 1, 1);
+    if (cudaStreamEndCapture(s, &captured) == cudaSuccess &&
+        cudaGraphInstantiateWithFlags(&graph.exec, captured, 0) !=
+            cudaSuccess)
+      graph.exec = nullptr;
+    if (captured != nullptr)
+      cudaGraphDestroy(captured);
+  }
+  if (graph.exec == nullptr) {
+    // Clear the error of the capture, the bootstraps of this shape
+    // being launched directly
+    cudaGetLastError();
+    graph.release(s, loc);
+    graph = PBS_graph();
+  }
+  return graph;
+}
+
+// Run the bootstrap of the `num_samples` ciphertexts `ct0_gpu` by `p`
+// to `out_gpu` on the stream `s` of the device `loc`, by replaying
+// the graph of its shape captured on the stream, or capturing it.
+// The accumulators `glwe_ct` are on the device or on the host, and
+// the test vector indexes on the host. Returns false if the bootstrap
+// is not replayed, and is to be launched directly.
+static bool replay_bootstrap_graph(Process *p, int32_t loc, cudaStream_t s,
+                                   uint64_t num_samples, void *ct0_gpu,
+                                   void *out_gpu, const void *glwe_ct,
+                                   bool glwe_ct_on_device, size_t glwe_ct_size,
+                                   const uint64_t *test_vector_idxes) {
+  if (!use_cuda_graphs || num_samples > cuda_graph_max_samples)
+    return false;
+  GPU_state &gpu = p->dfg->gpus[loc];
+  size_t slot = current_stream_slot;
+  int8_t *pbs_buffer = gpu.get_pbs_buffer(p->glwe_dim.val, p->poly_size.val,
+                                          p->level.val, num_samples);
+  void *fbsk_gpu = p->ctx.val->get_bsk_gpu(
+      p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->glwe_dim.val,
+      loc, s, p->sk_index.val);
+  PBS_graph_key key{num_samples,       p->input_lwe_dim.val,
+                    p->glwe_dim.val,   p->poly_size.val,
+                    p->level.val,      p->base_log.val,
+                    glwe_ct_size,      p->sk_index.val,
+                    (uintptr_t)fbsk_gpu};
+  auto &graphs = gpu.pbs_graphs[slot];
+  auto it = graphs.find(key);
+  if (it == graphs.end()) {
+    if (graphs.size() >= cuda_graphs_per_stream ||
+        gpu.pbs_graph_captures[slot] >= cuda_graph_captures_per_stream)
+      return false;
+    gpu.pbs_graph_captures[slot]++;
+    it = graphs
+             .emplace(key, capture_bootstrap_graph(p, loc, s, num_samples,
+                                                   glwe_ct_size, pbs_buffer,
+                                                   fbsk_gpu))
+             .first;
+  }
+  PBS_graph &graph = it->second;
+  if (graph.exec == nullptr)
+    return false;
+
+  cudaSetDevice(loc);
+  cudaMemcpyAsync(graph.in_gpu, ct0_gpu,
+                  num_samples * (p->input_lwe_dim.val + 1) * sizeof(uint64_t),
+                  cudaMemcpyDeviceToDevice, s);
+  cudaMemcpyAsync(graph.lut_gpu, glwe_ct, glwe_ct_size,
+                  glwe_ct_on_device ? cudaMemcpyDeviceToDevice
+                                    : cudaMemcpyHostToDevice,
+                  s);
+  cudaMemcpyAsync(graph.lut_indexes_gpu, test_vector_idxes,
+                  num_samples * sizeof(uint64_t), cudaMemcpyHostToDevice, s);
+  cudaGraphLaunch(graph.exec, s);
+  cudaMemcpyAsync(out_gpu, graph.out_gpu,
+                  num_samples * p->output_size.val * sizeof(uint64_t),
+                  cudaMemcpyDeviceToDevice, s);
+  return true;
+}
+
 void memref_bootstrap_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
                                       uint64_t *out_ptr) {
   assert(p->output_size.val == p->glwe_dim.val * p->poly_size.val + 1);
+  assert(p->ctx.val->bsk_grouping_factor(p->sk_index.val) <= 1 &&
+         "Multi-bit bootstrap keys are not supported by the SDFG runtime");
   if (!p->output_streams[0]->need_new_gen(chunk_id))
     return;
   Dependence *idep1 = p->input_streams[1]->get(host_location, chunk_id);
@@ -1122,20 +1990,9 @@ void memref_bootstrap_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
   uint64_t glwe_ct_len =
       p->poly_size.val * (p->glwe_dim.val + 1) * num_lut_vectors;
   uint64_t glwe_ct_size = glwe_ct_len * sizeof(uint64_t);
-  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size);
   auto tlu = mtlu.aligned + mtlu.offset;
-  // Glwe trivial encryption
-  size_t pos = 0, postlu = 0;
-  for (size_t l = 0; l < num_lut_vectors; ++l) {
-    for (size_t i = 0; i < p->poly_size.val * p->glwe_dim.val; i++) {
-      glwe_ct[pos++] = 0;
-    }
-    for (size_t i = 0; i < p->poly_size.val; i++) {
-      glwe_ct[pos++] = tlu[postlu++];
-    }
-  }
 
-  auto sched = [&](Dependence *d0, Dependence *d1, uint64_t *glwe_ct,
+  auto sched = [&](Dependence *d0, Dependence *d1,
                    std::vector<size_t> &lut_indexes, cudaStream_t s,
                    int32_t loc) {
     uint64_t num_samples = d0->host_data.sizes[0];
@@ -1149,7 +2006,8 @@ void memref_bootstrap_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
     // Move test vector indexes to the GPU, the test vector indexes is set of 0
     uint32_t lwe_idx = 0,
              test_vector_idxes_size = num_samples * sizeof(uint64_t);
-    uint64_t *test_vector_idxes = (uint64_t *)malloc(test_vector_idxes_size);
+    uint64_t *test_vector_idxes =
+        (uint64_t *)concrete_checked_malloc(test_vector_idxes_size);
     if (lut_indexes.size() == 1) {
       memset((void *)test_vector_idxes, lut_indexes[0], test_vector_idxes_size);
     } else {
@@ -1160,7 +2018,9 @@ void memref_bootstrap_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
     if (loc == host_location) {
       // If it is not profitable to offload, schedule kernel on CPU
       out.allocated = out.aligned =
-          (uint64_t *)((out_ptr != nullptr) ? out_ptr : malloc(data_size));
+          (uint64_t *)((out_ptr != nullptr)
+                           ? out_ptr
+                           : concrete_checked_malloc(data_size));
       if (lut_indexes.size() == 1)
         memref_batched_bootstrap_lwe_u64(
             out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
@@ -1186,47 +2046,74 @@ void memref_bootstrap_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
             p->ctx.val);
       Dependence *dep = new Dependence(loc, out, nullptr, true,
                                        (out_ptr == nullptr), d0->chunk_id);
-      free(glwe_ct);
       return dep;
     } else {
-      // Schedule the bootstrap kernel on the GPU
-      void *glwe_ct_gpu = cuda_malloc_async(glwe_ct_size, s, loc);
-      cuda_memcpy_async_to_gpu(glwe_ct_gpu, glwe_ct, glwe_ct_size, s, loc);
-      void *test_vector_idxes_gpu =
-          cuda_malloc_async(test_vector_idxes_size, s, loc);
-      cuda_memcpy_async_to_gpu(test_vector_idxes_gpu, (void *)test_vector_idxes,
-                               test_vector_idxes_size, s, loc);
-      // Initialize indexes
-      uint64_t *indexes = (uint64_t *)malloc(num_samples * sizeof(uint64_t));
-      for (uint32_t i = 0; i < num_samples; i++) {
-        indexes[i] = i;
+      // Schedule the bootstrap kernel on the GPU, the glwe accumulators are
+      // uploaded once per distinct lookup tables and device
+      PrimitiveTimer timer(RuntimePrimitive::BOOTSTRAP, -1, p->sk_index.val,
+                           num_samples, true);
+      tracing::TraceScope trace(
+          "gpu", "bootstrap kernel",
+          {{"samples", (int64_t)num_samples}, {"device", loc}});
+      void *glwe_ct_gpu = p->ctx.val->get_accumulator_gpu(
+          tlu, num_lut_vectors, p->glwe_dim.val, p->poly_size.val, loc, s);
+      uint64_t *glwe_ct = nullptr;
+      if (glwe_ct_gpu == nullptr) {
+        // The cache is full, upload the accumulators for this call only
+        glwe_ct = (uint64_t *)concrete_checked_malloc(glwe_ct_size);
+        for (size_t l = 0; l < num_lut_vectors; ++l)
+          ::concretelang::lut::trivialGlweAccumulator(
+              glwe_ct + l * p->poly_size.val * (p->glwe_dim.val + 1),
+              tlu + l * p->poly_size.val, p->glwe_dim.val, p->poly_size.val);
       }
-      void *indexes_gpu =
-          alloc_and_memcpy_async_to_gpu(indexes, 0, num_samples, loc, s);
-
-      int8_t *pbs_buffer = p->dfg->gpus[loc].get_pbs_buffer(
-          p->glwe_dim.val, p->poly_size.val, p->level.val, num_samples);
       void *ct0_gpu = d0->device_data;
       void *out_gpu = cuda_malloc_async(data_size, s, loc);
-      void *fbsk_gpu = p->ctx.val->get_bsk_gpu(
-          p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->glwe_dim.val,
-          loc, s, p->sk_index.val);
-      cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
-          s, loc, out_gpu, indexes_gpu, glwe_ct_gpu, test_vector_idxes_gpu,
-          ct0_gpu, indexes_gpu, fbsk_gpu, (int8_t *)pbs_buffer,
-          p->input_lwe_dim.val, p->glwe_dim.val, p->poly_size.val,
-          p->base_log.val, p->level.val, num_samples, 1, 1);
-      cuda_drop_async(test_vector_idxes_gpu, s, loc);
-      cuda_drop_async(glwe_ct_gpu, s, loc);
-      cuda_drop_async(indexes_gpu, s, loc);
+      if (!replay_bootstrap_graph(
+              p, loc, s, num_samples, ct0_gpu, out_gpu,
+              (glwe_ct != nullptr) ? (void *)glwe_ct : glwe_ct_gpu,
+              glwe_ct == nullptr, glwe_ct_size, test_vector_idxes)) {
+        if (glwe_ct != nullptr) {
+          glwe_ct_gpu = cuda_malloc_async(glwe_ct_size, s, loc);
+          cuda_memcpy_async_to_gpu(glwe_ct_gpu, glwe_ct, glwe_ct_size, s, loc);
+        }
+        void *test_vector_idxes_gpu =
+            cuda_malloc_async(test_vector_idxes_size, s, loc);
+        cuda_memcpy_async_to_gpu(test_vector_idxes_gpu,
+                                 (void *)test_vector_idxes,
+                                 test_vector_idxes_size, s, loc);
+        // Initialize indexes
+        uint64_t *indexes = (uint64_t *)concrete_checked_malloc(
+            num_samples * sizeof(uint64_t));
+        for (uint32_t i = 0; i < num_samples; i++) {
+          indexes[i] = i;
+        }
+        void *indexes_gpu =
+            alloc_and_memcpy_async_to_gpu(indexes, 0, num_samples, loc, s);
+
+        int8_t *pbs_buffer = p->dfg->gpus[loc].get_pbs_buffer(
+            p->glwe_dim.val, p->poly_size.val, p->level.val, num_samples);
+        void *fbsk_gpu = p->ctx.val->get_bsk_gpu(
+            p->input_lwe_dim.val, p->poly_size.val, p->level.val,
+            p->glwe_dim.val, loc, s, p->sk_index.val);
+        cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
+            s, loc, out_gpu, indexes_gpu, glwe_ct_gpu, test_vector_idxes_gpu,
+            ct0_gpu, indexes_gpu, fbsk_gpu, (int8_t *)pbs_buffer,
+            p->input_lwe_dim.val, p->glwe_dim.val, p->poly_size.val,
+            p->base_log.val, p->level.val, num_samples, 1, 1);
+        cuda_drop_async(test_vector_idxes_gpu, s, loc);
+        if (glwe_ct != nullptr)
+          cuda_drop_async(glwe_ct_gpu, s, loc);
+        cuda_drop_async(indexes_gpu, s, loc);
+        p->dfg->register_stream_order_dependent_allocation(indexes);
+      }
       Dependence *dep =
           new Dependence(loc, out, out_gpu, false, false, d0->chunk_id);
       // As streams are not synchronized, we can only free this vector
       // after a later synchronization point where we are guaranteed that
       // this vector is no longer needed.
       p->dfg->register_stream_order_dependent_allocation(test_vector_idxes);
-      p->dfg->register_stream_order_dependent_allocation(glwe_ct);
-      p->dfg->register_stream_order_dependent_allocation(indexes);
+      if (glwe_ct != nullptr)
+        p->dfg->register_stream_order_dependent_allocation(glwe_ct);
       return dep;
     }
   };
@@ -1246,7 +2133,7 @@ void memref_bootstrap_lwe_u64_process(Process *p, int32_t loc, int32_t chunk_id,
   Dependence *idep0 = p->input_streams[0]->get(loc, chunk_id);
   if (p->output_streams[0]->need_new_gen(chunk_id))
     p->output_streams[0]->put(
-        sched(idep0, idep1, glwe_ct, lut_indexes, cstream, loc), chunk_id);
+        sched(idep0, idep1, lut_indexes, cstream, loc), chunk_id);
 }
 
 void memref_add_lwe_ciphertexts_u64_process(Process *p, int32_t loc,
@@ -1267,7 +2154,9 @@ void memref_add_lwe_ciphertexts_u64_process(Process *p, int32_t loc,
     if (loc == host_location) {
       // If it is not profitable to offload, schedule kernel on CPU
       out.allocated = out.aligned =
-          (uint64_t *)((out_ptr != nullptr) ? out_ptr : malloc(data_size));
+          (uint64_t *)((out_ptr != nullptr)
+                           ? out_ptr
+                           : concrete_checked_malloc(data_size));
       memref_batched_add_lwe_ciphertexts_u64(
           out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
           out.strides[0], out.strides[1], d0->host_data.allocated,
@@ -1317,7 +2206,9 @@ void memref_add_plaintext_lwe_ciphertext_u64_process(Process *p, int32_t loc,
     if (loc == host_location) {
       // If it is not profitable to offload, schedule kernel on CPU
       out.allocated = out.aligned =
-          (uint64_t *)((out_ptr != nullptr) ? out_ptr : malloc(data_size));
+          (uint64_t *)((out_ptr != nullptr)
+                           ? out_ptr
+                           : concrete_checked_malloc(data_size));
       if (d1->host_data.sizes[1] == 1) // Constant case - or single sample
         memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
             out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
@@ -1375,7 +2266,9 @@ void memref_mul_cleartext_lwe_ciphertext_u64_process(Process *p, int32_t loc,
     if (loc == host_location) {
       // If it is not profitable to offload, schedule kernel on CPU
       out.allocated = out.aligned =
-          (uint64_t *)((out_ptr != nullptr) ? out_ptr : malloc(data_size));
+          (uint64_t *)((out_ptr != nullptr)
+                           ? out_ptr
+                           : concrete_checked_malloc(data_size));
       if (d1->host_data.sizes[1] == 1) // Constant case
         memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
             out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
@@ -1429,7 +2322,9 @@ void memref_negate_lwe_ciphertext_u64_process(Process *p, int32_t loc,
     if (loc == host_location) {
       // If it is not profitable to offload, schedule kernel on CPU
       out.allocated = out.aligned =
-          (uint64_t *)((out_ptr != nullptr) ? out_ptr : malloc(data_size));
+          (uint64_t *)((out_ptr != nullptr)
+                           ? out_ptr
+                           : concrete_checked_malloc(data_size));
       memref_batched_negate_lwe_ciphertext_u64(
           out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
           out.strides[0], out.strides[1], d0->host_data.allocated,
@@ -1456,18 +2351,85 @@ void memref_negate_lwe_ciphertext_u64_process(Process *p, int32_t loc,
         sched(idep0, (cudaStream_t)p->dfg->get_gpu_stream(loc), loc), chunk_id);
 }
 
+// Print the timing predicted for the execution of `dfg` and add it to
+// the totals of the process.
+static void report_timing_simulation(GPU_DFG *dfg) {
+  TimingSimulationReport &timing = dfg->timing;
+  if (timing.subgraphs == 0)
+    return;
+  fprintf(stderr,
+          "SDFG timing simulation: %zu subgraphs on %zu %s, predicted makespan "
+          "%.6fs, %llu bytes transferred\n",
+          timing.subgraphs, simulated_devices, simulated_device_model.c_str(),
+          timing.makespan, (unsigned long long)timing.transfer_bytes);
+  double makespan = (timing.makespan > 0) ? timing.makespan : 1;
+  fprintf(stderr, "  host utilization: %.1f%% of %zu cores\n",
+          100 * timing.host_busy / (makespan * num_cores), num_cores);
+  for (size_t dev = 0; dev < simulated_devices; ++dev)
+    fprintf(stderr, "  device %zu utilization: %.1f%%\n", dev,
+            100 * timing.device_busy[dev] / makespan);
+
+  std::lock_guard<std::mutex> guard(simulation_totals_guard);
+  simulation_totals.makespan += timing.makespan;
+  simulation_totals.host_busy += timing.host_busy;
+  simulation_totals.device_busy.resize(simulated_devices, 0);
+  for (size_t dev = 0; dev < simulated_devices; ++dev)
+    simulation_totals.device_busy[dev] += timing.device_busy[dev];
+  simulation_totals.transfer_bytes += timing.transfer_bytes;
+  simulation_totals.subgraphs += timing.subgraphs;
+}
+
+// The DFG whose construction the control program of this thread runs,
+// from its init to its run, which owns the streams it makes.
+static thread_local GPU_DFG *building_dfg = nullptr;
+
+// Make a stream for the DFG under construction, or give back the next
+// stream of the first call when replaying it.
+static void *make_stream(stream_type stype, const char *name) {
+  GPU_DFG *dfg = building_dfg;
+  if (dfg != nullptr && dfg->built) {
+    assert(dfg->replayed_streams < dfg->made_streams.size() &&
+           "Persistent DFG replayed with more streams.");
+    return dfg->made_streams[dfg->replayed_streams++];
+  }
+  Stream *s = new Stream(stype, name);
+  if (dfg != nullptr) {
+    s->dfg = dfg;
+    dfg->register_stream(s);
+    dfg->made_streams.push_back(s);
+  }
+  return s;
+}
+
+// The processes of a replayed DFG are already there.
+static inline bool replaying(void *dfg) { return ((GPU_DFG *)dfg)->built; }
+
+// DFGs are kept across the calls unless the SDFG_PERSISTENT_GRAPHS
+// environment variable is set to 0.
+static bool persistent_graphs_enabled() {
+  static const bool enabled = [] {
+    char *env = getenv("SDFG_PERSISTENT_GRAPHS");
+    return env == nullptr || strtoul(env, NULL, 10) != 0;
+  }();
+  return enabled;
+}
+
+static void delete_dfg(void *dfg) { delete (GPU_DFG *)dfg; }
 } // namespace
 } // namespace gpu_dfg
 } // namespace concretelang
 } // namespace mlir
 
 using namespace mlir::concretelang::gpu_dfg;
+namespace tracing = mlir::concretelang::tracing;
 
 // Code generation interface
 void stream_emulator_make_memref_add_lwe_ciphertexts_u64_process(void *dfg,
                                                                  void *sin1,
                                                                  void *sin2,
                                                                  void *sout) {
+  if (replaying(dfg))
+    return;
   Process *p = make_process_2_1(dfg, sin1, sin2, sout,
                                 memref_add_lwe_ciphertexts_u64_process);
   static int count = 0;
@@ -1476,6 +2438,8 @@ void stream_emulator_make_memref_add_lwe_ciphertexts_u64_process(void *dfg,
 
 void stream_emulator_make_memref_add_plaintext_lwe_ciphertext_u64_process(
     void *dfg, void *sin1, void *sin2, void *sout) {
+  if (replaying(dfg))
+    return;
   Process *p = make_process_2_1(
       dfg, sin1, sin2, sout, memref_add_plaintext_lwe_ciphertext_u64_process);
   static int count = 0;
@@ -1484,6 +2448,8 @@ void stream_emulator_make_memref_add_plaintext_lwe_ciphertext_u64_process(
 
 void stream_emulator_make_memref_mul_cleartext_lwe_ciphertext_u64_process(
     void *dfg, void *sin1, void *sin2, void *sout) {
+  if (replaying(dfg))
+    return;
   Process *p = make_process_2_1(
       dfg, sin1, sin2, sout, memref_mul_cleartext_lwe_ciphertext_u64_process);
   static int count = 0;
@@ -1493,6 +2459,8 @@ void stream_emulator_make_memref_mul_cleartext_lwe_ciphertext_u64_process(
 void stream_emulator_make_memref_negate_lwe_ciphertext_u64_process(void *dfg,
                                                                    void *sin1,
                                                                    void *sout) {
+  if (replaying(dfg))
+    return;
   Process *p = make_process_1_1(dfg, sin1, sout,
                                 memref_negate_lwe_ciphertext_u64_process);
   static int count = 0;
@@ -1503,6 +2471,8 @@ void stream_emulator_make_memref_keyswitch_lwe_u64_process(
     void *dfg, void *sin1, void *sout, uint32_t level, uint32_t base_log,
     uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t output_size,
     uint32_t ksk_index, void *context) {
+  if (replaying(dfg))
+    return;
   Process *p =
       make_process_1_1(dfg, sin1, sout, memref_keyswitch_lwe_u64_process);
   p->level.val = level;
@@ -1520,6 +2490,8 @@ void stream_emulator_make_memref_bootstrap_lwe_u64_process(
     void *dfg, void *sin1, void *sin2, void *sout, uint32_t input_lwe_dim,
     uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
     uint32_t output_size, uint32_t bsk_index, void *context) {
+  if (replaying(dfg))
+    return;
   // The TLU does not need to be sent to GPU
   ((Stream *)sin2)->type = TS_STREAM_TYPE_X86_TO_X86_LSAP;
   Process *p =
@@ -1648,11 +2620,11 @@ void stream_emulator_make_memref_batched_mapped_bootstrap_lwe_u64_process(
 }
 
 void *stream_emulator_make_uint64_stream(const char *name, stream_type stype) {
-  return (void *)new Stream(stype, name);
+  return make_stream(stype, name);
 }
 void stream_emulator_put_uint64(void *stream, uint64_t e) {
   Stream *s = (Stream *)stream;
-  uint64_t *data = (uint64_t *)malloc(sizeof(uint64_t));
+  uint64_t *data = (uint64_t *)concrete_checked_malloc(sizeof(uint64_t));
   *data = e;
   MemRef2 m = {data, data, 0, {1, 1}, {1, 1}};
   Dependence *dep = new Dependence(host_location, m, nullptr, true, true);
@@ -1668,7 +2640,7 @@ uint64_t stream_emulator_get_uint64(void *stream) {
 }
 
 void *stream_emulator_make_memref_stream(const char *name, stream_type stype) {
-  return (void *)new Stream(stype, name);
+  return make_stream(stype, name);
 }
 void stream_emulator_put_memref(void *stream, uint64_t *allocated,
                                 uint64_t *aligned, uint64_t offset,
@@ -1687,9 +2659,11 @@ void stream_emulator_get_memref(void *stream, uint64_t *out_allocated,
                                 uint64_t *out_aligned, uint64_t out_offset,
                                 uint64_t out_size, uint64_t out_stride) {
   assert(out_stride == 1 && "Strided memrefs not supported");
+  // The output may be a slice of a larger buffer, which the processes
+  // write from its aligned pointer
   MemRef2 mref = {out_allocated,
-                  out_aligned,
-                  out_offset,
+                  out_aligned + out_offset,
+                  0,
                   {1, out_size},
                   {out_size, out_stride}};
   auto s = (Stream *)stream;
@@ -1698,7 +2672,7 @@ void stream_emulator_get_memref(void *stream, uint64_t *out_allocated,
 
 void *stream_emulator_make_memref_batch_stream(const char *name,
                                                stream_type stype) {
-  return (void *)new Stream(stype, name);
+  return make_stream(stype, name);
 }
 void stream_emulator_put_memref_batch(void *stream, uint64_t *allocated,
                                       uint64_t *aligned, uint64_t offset,
@@ -1719,31 +2693,34 @@ void stream_emulator_get_memref_batch(void *stream, uint64_t *out_allocated,
                                       uint64_t out_offset, uint64_t out_size0,
                                       uint64_t out_size1, uint64_t out_stride0,
                                       uint64_t out_stride1) {
-  static size_t count = 0;
-  END_TIME_C_ACC(&blocking_get_timer, "Non-GPU section execution", count,
-                 &acc1);
-  BEGIN_TIME(&blocking_get_timer);
-  assert(out_stride1 == 1 && "Strided memrefs not supported");
+  assert(out_stride1 == 1 && out_stride0 == out_size1 &&
+         "Strided memrefs not supported");
   MemRef2 mref = {out_allocated,
-                  out_aligned,
-                  out_offset,
+                  out_aligned + out_offset,
+                  0,
                   {out_size0, out_size1},
                   {out_stride0, out_stride1}};
   auto s = (Stream *)stream;
+  tracing::TraceScope trace("sdfg", "execution");
   s->get_on_host(mref);
-  END_TIME_C_ACC(&blocking_get_timer, "GPU section execution", count++, &acc2);
-  BEGIN_TIME(&blocking_get_timer);
 }
 
-void *stream_emulator_init() {
-  CONCRETELANG_ENABLE_TIMING();
-  BEGIN_TIME(&init_timer);
+// The devices and the topology of the machine are probed once per
+// process, by the first DFG.
+static std::once_flag resources_probed;
+static void probe_resources() {
+  uint64_t init_start = tracing::now();
   int num;
-  assert(cudaGetDeviceCount(&num) == cudaSuccess);
+  if (cudaGetDeviceCount(&num) != cudaSuccess)
+    num = 0;
   num_devices = num;
-  assert(num_devices > 0 && "No GPUs available on system.");
-  char *env = getenv("SDFG_NUM_GPUS");
-  if (env != nullptr) {
+  char *env = getenv("SDFG_SIMULATED_GPUS");
+  if (env != nullptr)
+    simulated_devices = strtoul(env, NULL, 10);
+  assert((num_devices > 0 || simulated_devices > 0) &&
+         "No GPUs available on system.");
+  env = getenv("SDFG_NUM_GPUS");
+  if (env != nullptr && num_devices > 0) {
     size_t requested_gpus = strtoul(env, NULL, 10);
     if (requested_gpus == 0)
       warnx("WARNING: no GPUs requested (%lu available) - "
@@ -1759,18 +2736,60 @@ void *stream_emulator_init() {
 
   // If the user has specified a ratio, use that. Otherwise we
   // estimate the ratio based on the number of multiprocessors
-  // available per GPU.
+  // available per GPU, and refine it with the calibrated cost model
+  // when scheduling bootstrapping subgraphs.
   env = getenv("SDFG_DEVICE_TO_CORE_RATIO");
   if (env != nullptr) {
     device_compute_factor = strtoul(env, NULL, 10);
-  } else {
+    use_cost_model = false;
+  } else if (num_devices > 0) {
     cudaDeviceProp properties;
     // For now we only querry one GPU, assuming all are the same.
-    assert(cudaGetDeviceProperties(&properties, 0) == cudaSuccess);
-    int smpc = properties.multiProcessorCount;
-    // Rough estimate - each SM has ballpark similar compute
-    // capability as a CPU core (so 2 HW threads generally).
-    device_compute_factor = smpc * 2;
+    cudaError_t error = cudaGetDeviceProperties(&properties, 0);
+    if (error == cudaSuccess) {
+      int smpc = properties.multiProcessorCount;
+      // Rough estimate - each SM has ballpark similar compute
+      // capability as a CPU core (so 2 HW threads generally).
+      device_compute_factor = smpc * 2;
+      // Enough samples to occupy all SMs when calibrating
+      gpu_calibration_samples = std::max(smpc * 8, 2);
+    } else {
+      warnx("WARNING: could not query the properties of GPU 0: %s - "
+            "using the default device to core ratio.",
+            cudaGetErrorString(error));
+    }
+  }
+
+  // The simulated devices are of the model of the first device unless
+  // set otherwise, in which case we calibrate on a device of the model
+  // if there is one.
+  if (simulated_devices > 0) {
+    env = getenv("SDFG_SIMULATED_GPU_MODEL");
+    if (env != nullptr) {
+      simulated_device_model = env;
+      for (size_t dev = 0; dev < num_devices; ++dev)
+        if (CostModel::location_name(dev) == simulated_device_model) {
+          simulated_device_location = dev;
+          break;
+        }
+    } else if (num_devices > 0) {
+      simulated_device_model = CostModel::location_name(0);
+      simulated_device_location = 0;
+    } else {
+      errx(1, "SDFG_SIMULATED_GPU_MODEL must be set to simulate GPUs on a "
+              "machine without any.");
+    }
+    size_t gpu_free_mem, gpu_total_mem;
+    env = getenv("SDFG_SIMULATED_GPU_MEMORY_MB");
+    if (env != nullptr && strtoul(env, NULL, 10) != 0)
+      simulated_device_memory = strtoul(env, NULL, 10) << 20;
+    else if (simulated_device_location >= 0 &&
+             cudaSetDevice(simulated_device_location) == cudaSuccess &&
+             cudaMemGetInfo(&gpu_free_mem, &gpu_total_mem) == cudaSuccess)
+      simulated_device_memory = gpu_free_mem;
+    env = getenv("SDFG_SIMULATED_TRANSFER_GBPS");
+    if (env != nullptr && strtod(env, NULL) > 0)
+      simulated_transfer_bandwidth = strtod(env, NULL) * 1e9;
   }
 
   hwloc_topology_t topology;
@@ -1779,24 +2798,79 @@ void *stream_emulator_init() {
   hwloc_topology_set_type_filter(topology, HWLOC_OBJ_CORE,
                                  HWLOC_TYPE_FILTER_KEEP_ALL);
   hwloc_topology_load(topology);
-  num_cores = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_PU) - num_devices;
+  num_cores =
+      hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_PU) - planned_devices();
   env = getenv("SDFG_NUM_THREADS");
   if (env != nullptr && strtoul(env, NULL, 10) != 0)
     num_cores = strtoul(env, NULL, 10);
   if (num_cores < 1)
     num_cores = 1;
+  env = getenv("SDFG_STREAMS_PER_GPU");
+  if (env != nullptr && strtoul(env, NULL, 10) != 0)
+    streams_per_gpu = strtoul(env, NULL, 10);
+  env = getenv("SDFG_GPU_MEMORY_BUDGET_MB");
+  if (env != nullptr)
+    device_memory_budget = strtoul(env, NULL, 10) << 20;
+  env = getenv("SDFG_CUDA_GRAPHS");
+  if (env != nullptr)
+    use_cuda_graphs =
+        strtoul(env, NULL, 10) != 0 && persistent_graphs_enabled();
+  device_memory_used.reset(new std::atomic<size_t>[num_devices]());
+
+  tracing::complete("sdfg", "initialization", init_start);
+}
 
-  END_TIME(&init_timer, "Initialization of the SDFG runtime");
-  BEGIN_TIME(&init_timer);
-
-  int device = next_device.fetch_add(1) % num_devices;
-  return new GPU_DFG(device);
+void *stream_emulator_init() {
+  std::call_once(resources_probed, probe_resources);
+  int device = next_device.fetch_add(1) % planned_devices();
+  GPU_DFG *dfg = new GPU_DFG(device);
+  building_dfg = dfg;
+  return dfg;
+}
+void *stream_emulator_init_persistent(void *context, uint64_t graph_id) {
+  if (context == nullptr || !persistent_graphs_enabled())
+    return stream_emulator_init();
+  RuntimeContext *owner = (RuntimeContext *)context;
+  GPU_DFG *dfg = (GPU_DFG *)owner->acquire_sdfg_graph(graph_id);
+  if (dfg == nullptr) {
+    dfg = (GPU_DFG *)stream_emulator_init();
+    dfg->owner = owner;
+    dfg->graph_id = graph_id;
+  }
+  dfg->replayed_streams = 0;
+  dfg->build_start = tracing::now();
+  building_dfg = dfg;
+  return dfg;
 }
 void stream_emulator_run(void *dfg) {
-  END_TIME(&init_timer, "Building the SDFG graph");
-  BEGIN_TIME(&blocking_get_timer);
+  GPU_DFG *d = (GPU_DFG *)dfg;
+  building_dfg = nullptr;
+  assert((!d->built || d->replayed_streams == d->made_streams.size()) &&
+         "Persistent DFG replayed with other streams.");
+  d->built = true;
+  tracing::complete("sdfg", "graph construction", d->build_start);
+}
+void stream_emulator_delete(void *dfg) {
+  GPU_DFG *d = (GPU_DFG *)dfg;
+  if (simulated_devices > 0)
+    report_timing_simulation(d);
+  if (d->owner == nullptr || !d->built) {
+    delete d;
+    return;
+  }
+  // The timing and the memory of a call end with it, the values of
+  // the streams are replaced by the next call
+  d->timing = TimingSimulationReport();
+  d->timing.device_busy.resize(simulated_devices, 0);
+  d->free_stream_order_dependent_data();
+  d->owner->release_sdfg_graph(d->graph_id, d, delete_dfg);
 }
-void stream_emulator_delete(void *dfg) { delete (GPU_DFG *)dfg; }
+// A stream holds a single value recomputed on demand, so the calls
+// cannot share a DFG. They run concurrently on DFGs of their own,
+// which overlap on the devices.
+void *stream_emulator_open_session() { return nullptr; }
+void stream_emulator_set_session(void *session) {}
+void stream_emulator_close_session(void *session) {}
 #endif
 
 namespace mlir {
@@ -1822,6 +2896,26 @@ bool check_cuda_runtime_enabled() {
 #endif
 }
 
+bool get_timing_simulation_report(TimingSimulationReport &report) {
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (simulated_devices == 0)
+    return false;
+  std::lock_guard<std::mutex> guard(simulation_totals_guard);
+  report = simulation_totals;
+  report.device_busy.resize(simulated_devices, 0);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void reset_timing_simulation_report() {
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  std::lock_guard<std::mutex> guard(simulation_totals_guard);
+  simulation_totals = TimingSimulationReport();
+#endif
+}
+
 } // namespace gpu_dfg
 } // namespace concretelang
 } // namespace mlir
@@ -5,14 +5,20 @@
 
 #include "concretelang/Runtime/stream_emulator_api.h"
 #include "concretelang/Runtime/wrappers.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdlib>
+#include <deque>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <queue>
-#include <sched.h>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -21,26 +27,135 @@ namespace concretelang {
 namespace stream_emulator {
 namespace {
 
-template <typename T> struct StreamBase {
-  void put(T e) { q.push(e); }
-  T get() {
-    while (q.empty())
-      sched_yield();
-    T ret = q.front();
-    q.pop();
-    return ret;
+/// Number of items a stream between two processes buffers, a process whose
+/// output stream is full waiting for its consumers to catch up. The streams
+/// of the host are unbounded, as it puts all the inputs before getting the
+/// outputs.
+const size_t STREAM_CAPACITY = 16;
+
+/// Items a process handles in a row before yielding its worker to the other
+/// ready processes.
+const size_t PROCESS_BATCH = 16;
+
+struct Process;
+struct DFGraph;
+struct Session;
+
+/// The part of the streams independent of their items, to schedule the
+/// processes on their state. Each reader of a stream, the processes taking
+/// it as input and the host for the streams it gets, has its own queue of
+/// the items, so that a value used by several processes is put once.
+struct StreamState {
+  StreamState(stream_type type)
+      : capacity(type == TS_STREAM_TYPE_TOPO_TO_TOPO_LSAP
+                     ? STREAM_CAPACITY
+                     : std::numeric_limits<size_t>::max()) {}
+  virtual ~StreamState() {}
+  /// Adds the process `p` as a reader of the stream, or the host if null,
+  /// and returns the index of its queue.
+  size_t add_reader(Process *p) {
+    if (p != nullptr)
+      consumers.push_back(p);
+    items.push_back(0);
+    add_queue();
+    return items.size() - 1;
+  }
+  bool empty(size_t reader) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return items[reader] == 0;
+  }
+  /// True once all the readers got all the items put.
+  bool drained() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return std::all_of(items.begin(), items.end(),
+                       [](size_t n) { return n == 0; });
+  }
+  /// The stream is full once a process lags `capacity` items behind, the
+  /// queue of the host never holding its producer back.
+  bool full() {
+    std::lock_guard<std::mutex> guard(mutex);
+    for (size_t reader = first_process_reader(); reader < items.size();
+         reader++)
+      if (items[reader] >= capacity)
+        return true;
+    return false;
   }
-  bool empty() { return q.empty(); }
+  size_t readers() { return items.size(); }
+  void notify_consumers();
+  void notify_producer();
 
-private:
-  std::queue<T> q;
+  const size_t capacity;
+  /// The items put and got by the host in each call of a shared graph,
+  /// counted by its first call, and the calls whose turn it is to put or
+  /// get them, guarded by the turn mutex of the graph
+  size_t host_puts = 0;
+  size_t host_gets = 0;
+  uint64_t put_turn = 0;
+  uint64_t get_turn = 0;
+  size_t turn_puts = 0;
+  size_t turn_gets = 0;
+  /// The process writing the stream, null for the host
+  Process *producer = nullptr;
+  std::vector<Process *> consumers;
+  /// The graph of the processes of the stream, which owns its items
+  DFGraph *dfg = nullptr;
+
+protected:
+  virtual void add_queue() = 0;
+  /// The queues of the processes follow the one of the host, if any
+  size_t first_process_reader() { return items.size() - consumers.size(); }
+
+  std::mutex mutex;
+  std::condition_variable available;
+  std::vector<size_t> items;
 };
-union Stream {
-  StreamBase<uint64_t> *uint64_stream;
-  StreamBase<MemRefDescriptor<1>> *memref_stream;
 
-  Stream(StreamBase<uint64_t> *s) : uint64_stream(s) {}
-  Stream(StreamBase<MemRefDescriptor<1>> *s) : memref_stream(s) {}
+/// Registers the buffer of `item` as read `readers` times, nothing to do
+/// for the items held by value.
+void share(DFGraph *dfg, uint64_t item, size_t readers) {}
+template <size_t N>
+void share(DFGraph *dfg, const MemRefDescriptor<N> &item, size_t readers);
+
+template <typename T> struct StreamBase : StreamState {
+  StreamBase(stream_type type) : StreamState(type) {
+    if (type == TS_STREAM_TYPE_TOPO_TO_X86_LSAP ||
+        type == TS_STREAM_TYPE_TOPO_TO_BOTH ||
+        type == TS_STREAM_TYPE_X86_TO_X86_LSAP)
+      add_reader(nullptr);
+  }
+  void put(T e) {
+    if (readers() > 1)
+      share(dfg, e, readers());
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      for (size_t reader = 0; reader < queues.size(); reader++) {
+        queues[reader].push(e);
+        items[reader]++;
+      }
+    }
+    available.notify_all();
+    notify_consumers();
+  }
+  /// Waits for an item of the queue `reader`, only the host ever waits as
+  /// the processes are run once their inputs are available.
+  T get(size_t reader) {
+    T ret;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [&] { return items[reader] > 0; });
+      ret = queues[reader].front();
+      queues[reader].pop();
+      items[reader]--;
+    }
+    notify_producer();
+    return ret;
+  }
+
+protected:
+  void add_queue() override { queues.emplace_back(); }
+
+private:
+  std::vector<std::queue<T>> queues;
 };
 
 struct Void {};
@@ -52,11 +167,39 @@ union Context {
   Void _;
   mlir::concretelang::RuntimeContext *val;
 };
+
+/// A process of the graph, fired once per item on the workers of the graph
+/// whenever its input streams hold an item and its output streams have
+/// room for one.
 struct Process {
-  void terminate() { terminate_p = true; }
-  bool terminate_p = false;
-  std::vector<Stream> input_streams;
-  std::vector<Stream> output_streams;
+  /// Returns the next item of the input `i`.
+  template <typename T> T get(size_t i) {
+    return static_cast<StreamBase<T> *>(input_streams[i])->get(
+        input_readers[i]);
+  }
+  template <typename T> void put(size_t i, T e) {
+    static_cast<StreamBase<T> *>(output_streams[i])->put(e);
+  }
+  bool ready() {
+    for (size_t i = 0; i < input_streams.size(); i++)
+      if (input_streams[i]->empty(input_readers[i]))
+        return false;
+    for (auto s : output_streams)
+      if (s->full())
+        return false;
+    return true;
+  }
+  /// Fires the process while it is ready, returns true if it is still ready
+  /// after a batch of items and should be queued again.
+  bool run();
+
+  /// Returns a buffer of `size` integers for an output item.
+  uint64_t *allocate(size_t size);
+
+  std::vector<StreamState *> input_streams;
+  /// The queue of the process in each of its input streams
+  std::vector<size_t> input_readers;
+  std::vector<StreamState *> output_streams;
   Param level;
   Param base_log;
   Param input_lwe_dim;
@@ -69,127 +212,712 @@ struct Process {
   Param bsk_index;
   Context ctx;
   void (*fun)(Process *);
+  DFGraph *dfg = nullptr;
+  /// Changes of its streams since the process was last found not ready,
+  /// the process being queued or running while it is not 0
+  std::atomic<uint64_t> notifications{0};
 };
 
+/// Grow-only pool of the buffers of the items passed between processes,
+/// by size. The buffer of an item read by several processes is given back
+/// by the last of them.
+struct BufferPool {
+  ~BufferPool() {
+    for (auto &buffers : free_buffers)
+      for (auto buffer : buffers.second)
+        concrete_checked_free(buffer);
+  }
+  uint64_t *acquire(size_t size) {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      auto &buffers = free_buffers[size];
+      if (!buffers.empty()) {
+        uint64_t *buffer = buffers.back();
+        buffers.pop_back();
+        return buffer;
+      }
+    }
+    return (uint64_t *)malloc(size * sizeof(uint64_t));
+  }
+  void share(uint64_t *buffer, size_t readers) {
+    std::lock_guard<std::mutex> guard(mutex);
+    shared_buffers[buffer] = readers;
+  }
+  void release(uint64_t *buffer, size_t size) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto shared = shared_buffers.find(buffer);
+    if (shared != shared_buffers.end()) {
+      if (--shared->second != 0)
+        return;
+      shared_buffers.erase(shared);
+    }
+    free_buffers[size].push_back(buffer);
+  }
+
+private:
+  std::mutex mutex;
+  std::unordered_map<size_t, std::vector<uint64_t *>> free_buffers;
+  std::unordered_map<uint64_t *, size_t> shared_buffers;
+};
+
+/// The graph whose construction the control program of this thread runs,
+/// from its init to its run, which owns the streams it makes, and the
+/// streams given back so far when replaying it.
+thread_local DFGraph *building_graph = nullptr;
+thread_local size_t replayed_streams = 0;
+
+/// The processes of a graph run on a fixed pool of workers, one per
+/// hardware thread unless set by the `SDFG_NUM_THREADS` environment
+/// variable, which take the ready processes from a queue.
+///
+/// A persistent graph is kept by its runtime context between the calls of
+/// its circuit, its workers waiting for the items of the next call. The
+/// control program of these calls makes the same streams and processes in
+/// the same order, the streams made being then those of the first call and
+/// the processes already there.
+///
+/// The graph of a session is shared by the calls of the session, which run
+/// concurrently: the items of a call follow on each stream those of the
+/// calls started before it, so that the calls pipeline through the
+/// processes.
 struct DFGraph {
   ~DFGraph() {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto &worker : workers)
+      worker.join();
     for (auto p : dfg_processes)
-      p->terminate();
+      delete p;
+    for (auto s : dfg_streams)
+      delete s;
   }
   void run() {
-    for (auto p : dfg_processes) {
-      std::thread process_thread(p->fun, p);
-      process_thread.detach();
+    if (built) {
+      assert(replayed_streams == dfg_streams.size() &&
+             "Persistent graph replayed with other streams.");
+      return;
     }
+    built = true;
+    size_t threads = std::thread::hardware_concurrency();
+    if (char *env = getenv("SDFG_NUM_THREADS"))
+      if (strtoul(env, NULL, 10) != 0)
+        threads = strtoul(env, NULL, 10);
+    threads = std::max<size_t>(1, std::min(threads, dfg_processes.size()));
+    for (size_t i = 0; i < threads; i++)
+      workers.emplace_back([this] { work(); });
+    for (auto p : dfg_processes)
+      notify(p);
   }
+  /// Queues `p` to check whether it is ready, unless it already is queued
+  /// or running.
+  void notify(Process *p) {
+    if (p->notifications.fetch_add(1, std::memory_order_acq_rel) != 0)
+      return;
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      ready.push_back(p);
+    }
+    wakeup.notify_one();
+  }
+
   std::vector<Process *> dfg_processes;
+  /// The streams of the graph, in the order they were made, deleted with
+  /// the graph
+  std::vector<StreamState *> dfg_streams;
+  BufferPool buffers;
+  /// Set once the graph runs, its construction being replayed by the next
+  /// calls
+  bool built = false;
+  /// The context keeping the graph between the calls of the circuit
+  /// `graph_id`, null if the graph is deleted after its call
+  mlir::concretelang::RuntimeContext *owner = nullptr;
+  uint64_t graph_id = 0;
+  /// The session sharing the graph between its calls, null otherwise. The
+  /// calls are numbered as they start, the next ones waiting for the first
+  /// to build the graph and to count the items of the host on its streams.
+  Session *session = nullptr;
+  std::mutex turn_mutex;
+  std::condition_variable turn_changed;
+  uint64_t next_call = 0;
+  bool recorded = false;
+
+private:
+  void work() {
+    while (true) {
+      Process *p;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeup.wait(lock, [this] { return stopping || !ready.empty(); });
+        if (stopping)
+          return;
+        p = ready.front();
+        ready.pop_front();
+      }
+      if (p->run()) {
+        std::lock_guard<std::mutex> guard(mutex);
+        ready.push_back(p);
+      }
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  std::deque<Process *> ready;
+  std::vector<std::thread> workers;
+  bool stopping = false;
 };
 
-// Stream emulator processes
-void memref_keyswitch_lwe_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> out;
-    out.sizes[0] = p->output_size.val;
-    out.strides[0] = 1;
-    out.offset = 0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(out.sizes[0] * sizeof(uint64_t));
-    memref_keyswitch_lwe_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        p->level.val, p->base_log.val, p->input_lwe_dim.val,
-        p->output_lwe_dim.val, p->ksk_index.val, p->ctx.val);
-    (p->output_streams[0]).memref_stream->put(out);
+void StreamState::notify_consumers() {
+  for (auto consumer : consumers)
+    consumer->dfg->notify(consumer);
+}
+
+void StreamState::notify_producer() {
+  if (producer != nullptr && capacity != std::numeric_limits<size_t>::max())
+    producer->dfg->notify(producer);
+}
+
+bool Process::run() {
+  for (size_t fired = 0;; fired++) {
+    uint64_t seen = notifications.load(std::memory_order_acquire);
+    if (!ready()) {
+      // A change of the streams after the check is seen by the exchange,
+      // and a later one queues the process again
+      if (notifications.compare_exchange_strong(seen, 0,
+                                                std::memory_order_acq_rel))
+        return false;
+      continue;
+    }
+    if (fired == PROCESS_BATCH)
+      return true;
+    fun(this);
   }
-  delete p;
 }
 
-void memref_bootstrap_lwe_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> tlu = (p->input_streams[1]).memref_stream->get();
-    MemRefDescriptor<1> out;
-    out.sizes[0] = p->output_size.val;
-    out.strides[0] = 1;
-    out.offset = 0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(out.sizes[0] * sizeof(uint64_t));
-    memref_bootstrap_lwe_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        tlu.allocated, tlu.aligned, tlu.offset, tlu.sizes[0], tlu.strides[0],
-        p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->base_log.val,
-        p->glwe_dim.val, p->bsk_index.val, p->ctx.val);
-    (p->output_streams[0]).memref_stream->put(out);
+uint64_t *Process::allocate(size_t size) { return dfg->buffers.acquire(size); }
+
+template <size_t N> size_t num_elements(const MemRefDescriptor<N> &mref) {
+  size_t size = 1;
+  for (size_t d = 0; d < N; d++)
+    size *= mref.sizes[d];
+  return size;
+}
+
+template <size_t N>
+void share(DFGraph *dfg, const MemRefDescriptor<N> &item, size_t readers) {
+  if (dfg != nullptr)
+    dfg->buffers.share(item.allocated, readers);
+}
+
+/// Gives back the buffer of the item `mref` read from `stream`. The items
+/// are all owned by the graph once put, the buffers of the host being
+/// either copied or adopted.
+template <size_t N>
+void release(StreamState *stream, MemRefDescriptor<N> &mref) {
+  if (stream->dfg != nullptr)
+    stream->dfg->buffers.release(mref.allocated, num_elements(mref));
+  else
+    concrete_checked_free(mref.allocated);
+}
+
+/// Returns an output item of `size` integers in a buffer of the pool.
+MemRefDescriptor<1> make_output(Process *p, size_t size) {
+  MemRefDescriptor<1> out;
+  out.sizes[0] = size;
+  out.strides[0] = 1;
+  out.offset = 0;
+  out.allocated = out.aligned = p->allocate(size);
+  return out;
+}
+
+/// Returns an output batch of `samples` items of `size` integers.
+MemRefDescriptor<2> make_batch_output(Process *p, size_t samples,
+                                      size_t size) {
+  MemRefDescriptor<2> out;
+  out.sizes[0] = samples;
+  out.sizes[1] = size;
+  out.strides[0] = size;
+  out.strides[1] = 1;
+  out.offset = 0;
+  out.allocated = out.aligned = p->allocate(samples * size);
+  return out;
+}
+
+/// Copies the integers of `from` to `to`, of the same sizes.
+void copy_item(const MemRefDescriptor<1> &from, MemRefDescriptor<1> &to) {
+  for (size_t i = 0; i < from.sizes[0]; i++)
+    to.aligned[to.offset + i * to.strides[0]] =
+        from.aligned[from.offset + i * from.strides[0]];
+}
+
+void copy_item(const MemRefDescriptor<2> &from, MemRefDescriptor<2> &to) {
+  for (size_t i = 0; i < from.sizes[0]; i++)
+    for (size_t j = 0; j < from.sizes[1]; j++)
+      to.aligned[to.offset + i * to.strides[0] + j * to.strides[1]] =
+          from.aligned[from.offset + i * from.strides[0] +
+                       j * from.strides[1]];
+}
+
+/// Returns the item of the host described by `mref` as owned by the graph
+/// of `stream`, a copy of it in a buffer of the pool unless the host gives
+/// away its buffer.
+template <size_t N>
+MemRefDescriptor<N> adopt_item(StreamState *stream, MemRefDescriptor<N> mref,
+                               uint64_t data_ownership) {
+  if (data_ownership != 0)
+    return mref;
+  size_t size = num_elements(mref);
+  MemRefDescriptor<N> item;
+  item.offset = 0;
+  item.allocated = item.aligned =
+      stream->dfg != nullptr ? stream->dfg->buffers.acquire(size)
+                             : (uint64_t *)malloc(size * sizeof(uint64_t));
+  for (size_t d = N; d-- > 0;) {
+    item.sizes[d] = mref.sizes[d];
+    item.strides[d] =
+        (d == N - 1) ? 1 : item.strides[d + 1] * mref.sizes[d + 1];
   }
-  delete p;
+  copy_item(mref, item);
+  return item;
+}
+
+// Stream emulator processes, each handling one item of its input streams
+void memref_keyswitch_lwe_u64_process(Process *p) {
+  MemRefDescriptor<1> ct0 = p->get<MemRefDescriptor<1>>(0);
+  MemRefDescriptor<1> out = make_output(p, p->output_size.val);
+  memref_keyswitch_lwe_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+      ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
+      p->level.val, p->base_log.val, p->input_lwe_dim.val,
+      p->output_lwe_dim.val, p->ksk_index.val, p->ctx.val);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
+}
+
+void memref_bootstrap_lwe_u64_process(Process *p) {
+  MemRefDescriptor<1> ct0 = p->get<MemRefDescriptor<1>>(0);
+  MemRefDescriptor<1> tlu = p->get<MemRefDescriptor<1>>(1);
+  MemRefDescriptor<1> out = make_output(p, p->output_size.val);
+  memref_bootstrap_lwe_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+      ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
+      tlu.allocated, tlu.aligned, tlu.offset, tlu.sizes[0], tlu.strides[0],
+      p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->base_log.val,
+      p->glwe_dim.val, p->bsk_index.val, p->ctx.val);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], tlu);
+  p->put(0, out);
 }
 
 void memref_add_lwe_ciphertexts_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> ct1 = (p->input_streams[1]).memref_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_add_lwe_ciphertexts_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        ct1.allocated, ct1.aligned, ct1.offset, ct1.sizes[0], ct1.strides[0]);
-    (p->output_streams[0]).memref_stream->put(out);
-  }
-  delete p;
+  MemRefDescriptor<1> ct0 = p->get<MemRefDescriptor<1>>(0);
+  MemRefDescriptor<1> ct1 = p->get<MemRefDescriptor<1>>(1);
+  MemRefDescriptor<1> out = make_output(p, ct0.sizes[0]);
+  memref_add_lwe_ciphertexts_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+      ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
+      ct1.allocated, ct1.aligned, ct1.offset, ct1.sizes[0], ct1.strides[0]);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], ct1);
+  p->put(0, out);
 }
 
 void memref_add_plaintext_lwe_ciphertext_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    uint64_t plaintext = (p->input_streams[1]).uint64_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_add_plaintext_lwe_ciphertext_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        plaintext);
-    (p->output_streams[0]).memref_stream->put(out);
-  }
-  delete p;
+  MemRefDescriptor<1> ct0 = p->get<MemRefDescriptor<1>>(0);
+  uint64_t plaintext = p->get<uint64_t>(1);
+  MemRefDescriptor<1> out = make_output(p, ct0.sizes[0]);
+  memref_add_plaintext_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+      ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
+      plaintext);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
 }
 
 void memref_mul_cleartext_lwe_ciphertext_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    uint64_t cleartext = (p->input_streams[1]).uint64_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
-        cleartext);
-    (p->output_streams[0]).memref_stream->put(out);
-  }
-  delete p;
+  MemRefDescriptor<1> ct0 = p->get<MemRefDescriptor<1>>(0);
+  uint64_t cleartext = p->get<uint64_t>(1);
+  MemRefDescriptor<1> out = make_output(p, ct0.sizes[0]);
+  memref_mul_cleartext_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+      ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0],
+      cleartext);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
 }
 
 void memref_negate_lwe_ciphertext_u64_process(Process *p) {
-  while (!p->terminate_p) {
-    MemRefDescriptor<1> ct0 = (p->input_streams[0]).memref_stream->get();
-    MemRefDescriptor<1> out = ct0;
-    out.allocated = out.aligned =
-        (uint64_t *)malloc(ct0.sizes[0] * sizeof(uint64_t));
-    out.offset = 0;
-    memref_negate_lwe_ciphertext_u64(
-        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
-        ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0]);
-    (p->output_streams[0]).memref_stream->put(out);
+  MemRefDescriptor<1> ct0 = p->get<MemRefDescriptor<1>>(0);
+  MemRefDescriptor<1> out = make_output(p, ct0.sizes[0]);
+  memref_negate_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+      ct0.allocated, ct0.aligned, ct0.offset, ct0.sizes[0], ct0.strides[0]);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
+}
+
+// Batched processes, each handling one batch of ciphertexts of its input
+// streams with the batched wrappers, which spread the batch over the
+// OpenMP workers
+void memref_batched_keyswitch_lwe_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<2> out =
+      make_batch_output(p, ct0.sizes[0], p->output_size.val);
+  memref_batched_keyswitch_lwe_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1],
+      p->level.val, p->base_log.val, p->input_lwe_dim.val,
+      p->output_lwe_dim.val, p->ksk_index.val, p->ctx.val);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
+}
+
+void memref_batched_bootstrap_lwe_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<1> tlu = p->get<MemRefDescriptor<1>>(1);
+  MemRefDescriptor<2> out =
+      make_batch_output(p, ct0.sizes[0], p->output_size.val);
+  memref_batched_bootstrap_lwe_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1],
+      tlu.allocated, tlu.aligned, tlu.offset, tlu.sizes[0], tlu.strides[0],
+      p->input_lwe_dim.val, p->poly_size.val, p->level.val, p->base_log.val,
+      p->glwe_dim.val, p->bsk_index.val, p->ctx.val);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], tlu);
+  p->put(0, out);
+}
+
+void memref_batched_mapped_bootstrap_lwe_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<2> tlu = p->get<MemRefDescriptor<2>>(1);
+  MemRefDescriptor<2> out =
+      make_batch_output(p, ct0.sizes[0], p->output_size.val);
+  if (tlu.sizes[0] == 1)
+    // A single lookup table for the whole batch
+    memref_batched_bootstrap_lwe_u64(
+        out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+        out.strides[0], out.strides[1], ct0.allocated, ct0.aligned,
+        ct0.offset, ct0.sizes[0], ct0.sizes[1], ct0.strides[0],
+        ct0.strides[1], tlu.allocated, tlu.aligned, tlu.offset, tlu.sizes[1],
+        tlu.strides[1], p->input_lwe_dim.val, p->poly_size.val, p->level.val,
+        p->base_log.val, p->glwe_dim.val, p->bsk_index.val, p->ctx.val);
+  else
+    memref_batched_mapped_bootstrap_lwe_u64(
+        out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+        out.strides[0], out.strides[1], ct0.allocated, ct0.aligned,
+        ct0.offset, ct0.sizes[0], ct0.sizes[1], ct0.strides[0],
+        ct0.strides[1], tlu.allocated, tlu.aligned, tlu.offset, tlu.sizes[0],
+        tlu.sizes[1], tlu.strides[0], tlu.strides[1], p->input_lwe_dim.val,
+        p->poly_size.val, p->level.val, p->base_log.val, p->glwe_dim.val,
+        p->bsk_index.val, p->ctx.val);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], tlu);
+  p->put(0, out);
+}
+
+void memref_batched_add_lwe_ciphertexts_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<2> ct1 = p->get<MemRefDescriptor<2>>(1);
+  MemRefDescriptor<2> out = make_batch_output(p, ct0.sizes[0], ct0.sizes[1]);
+  memref_batched_add_lwe_ciphertexts_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1],
+      ct1.allocated, ct1.aligned, ct1.offset, ct1.sizes[0], ct1.sizes[1],
+      ct1.strides[0], ct1.strides[1]);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], ct1);
+  p->put(0, out);
+}
+
+void memref_batched_add_plaintext_lwe_ciphertext_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<1> ct1 = p->get<MemRefDescriptor<1>>(1);
+  MemRefDescriptor<2> out = make_batch_output(p, ct0.sizes[0], ct0.sizes[1]);
+  memref_batched_add_plaintext_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1],
+      ct1.allocated, ct1.aligned, ct1.offset, ct1.sizes[0], ct1.strides[0]);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], ct1);
+  p->put(0, out);
+}
+
+void memref_batched_add_plaintext_cst_lwe_ciphertext_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  uint64_t plaintext = p->get<uint64_t>(1);
+  MemRefDescriptor<2> out = make_batch_output(p, ct0.sizes[0], ct0.sizes[1]);
+  memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1], plaintext);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
+}
+
+void memref_batched_mul_cleartext_lwe_ciphertext_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<1> ct1 = p->get<MemRefDescriptor<1>>(1);
+  MemRefDescriptor<2> out = make_batch_output(p, ct0.sizes[0], ct0.sizes[1]);
+  memref_batched_mul_cleartext_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1],
+      ct1.allocated, ct1.aligned, ct1.offset, ct1.sizes[0], ct1.strides[0]);
+  release(p->input_streams[0], ct0);
+  release(p->input_streams[1], ct1);
+  p->put(0, out);
+}
+
+void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  uint64_t cleartext = p->get<uint64_t>(1);
+  MemRefDescriptor<2> out = make_batch_output(p, ct0.sizes[0], ct0.sizes[1]);
+  memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1], cleartext);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
+}
+
+void memref_batched_negate_lwe_ciphertext_u64_process(Process *p) {
+  MemRefDescriptor<2> ct0 = p->get<MemRefDescriptor<2>>(0);
+  MemRefDescriptor<2> out = make_batch_output(p, ct0.sizes[0], ct0.sizes[1]);
+  memref_batched_negate_lwe_ciphertext_u64(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1]);
+  release(p->input_streams[0], ct0);
+  p->put(0, out);
+}
+
+/// Returns the stream of items `T` created as `stream`.
+template <typename T> StreamBase<T> *as_stream(void *stream) {
+  return static_cast<StreamBase<T> *>((StreamState *)stream);
+}
+
+/// Adds `stream` to `dfg` when a first process of `dfg` uses it.
+void attach_stream(DFGraph *dfg, StreamState *stream) {
+  if (stream->dfg != nullptr)
+    return;
+  stream->dfg = dfg;
+  dfg->dfg_streams.push_back(stream);
+}
+
+/// Makes a stream of items `T` for the graph under construction, or gives
+/// back the next stream of the first call when replaying it.
+template <typename T> void *make_stream(stream_type stype) {
+  DFGraph *dfg = building_graph;
+  if (dfg != nullptr && dfg->built) {
+    assert(replayed_streams < dfg->dfg_streams.size() &&
+           "Persistent graph replayed with more streams.");
+    return dfg->dfg_streams[replayed_streams++];
+  }
+  StreamState *stream = new StreamBase<T>(stype);
+  if (dfg != nullptr)
+    attach_stream(dfg, stream);
+  return stream;
+}
+
+/// Graphs are kept across the calls unless the `SDFG_PERSISTENT_GRAPHS`
+/// environment variable is set to 0.
+bool persistent_graphs_enabled() {
+  static const bool enabled = [] {
+    char *env = getenv("SDFG_PERSISTENT_GRAPHS");
+    return env == nullptr || strtoul(env, NULL, 10) != 0;
+  }();
+  return enabled;
+}
+
+void delete_graph(void *dfg) { delete (DFGraph *)dfg; }
+
+/// The number of each call of a shared graph running on this thread
+thread_local std::unordered_map<DFGraph *, uint64_t> call_numbers;
+
+/// The calls of a session, e.g. of a stream of calls of a circuit opened
+/// by the server, share one graph per circuit, built by the first call.
+struct Session {
+  ~Session() {
+    for (auto &graph : graphs)
+      delete graph.second;
   }
-  delete p;
+  /// Starts a call of the circuit `graph_id` on the graph of the session.
+  DFGraph *start_call(uint64_t graph_id) {
+    DFGraph *dfg;
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      DFGraph *&shared = graphs[graph_id];
+      if (shared == nullptr) {
+        shared = new DFGraph;
+        shared->session = this;
+        shared->graph_id = graph_id;
+      }
+      dfg = shared;
+    }
+    uint64_t call;
+    {
+      std::unique_lock<std::mutex> lock(dfg->turn_mutex);
+      call = dfg->next_call++;
+      dfg->turn_changed.wait(lock, [&] { return call == 0 || dfg->recorded; });
+    }
+    call_numbers[dfg] = call;
+    return dfg;
+  }
+  /// Ends the call of this thread on `dfg`, the first one handing the
+  /// streams over to the second.
+  void end_call(DFGraph *dfg) {
+    auto number = call_numbers.find(dfg);
+    uint64_t call = number->second;
+    call_numbers.erase(number);
+    if (call != 0)
+      return;
+    {
+      std::lock_guard<std::mutex> guard(dfg->turn_mutex);
+      for (auto stream : dfg->dfg_streams)
+        stream->put_turn = stream->get_turn = 1;
+      dfg->recorded = true;
+    }
+    dfg->turn_changed.notify_all();
+  }
+
+private:
+  std::mutex mutex;
+  std::unordered_map<uint64_t, DFGraph *> graphs;
+};
+
+thread_local Session *current_session = nullptr;
+
+/// Waits for the turn of the call of this thread to put (or get) an item
+/// on `stream` of a shared graph, and passes the turn to the next call once
+/// it put (or got) as many items as the first call did.
+struct HostTurn {
+  HostTurn(StreamState *stream, bool put) : stream(stream), put(put) {
+    if (stream->dfg == nullptr || stream->dfg->session == nullptr)
+      return;
+    dfg = stream->dfg;
+    assert(call_numbers.count(dfg) && "Shared stream used outside a call.");
+    call = call_numbers[dfg];
+    if (call == 0)
+      return;
+    std::unique_lock<std::mutex> lock(dfg->turn_mutex);
+    dfg->turn_changed.wait(lock, [&] { return turn() == call; });
+  }
+  ~HostTurn() {
+    if (dfg == nullptr)
+      return;
+    {
+      std::lock_guard<std::mutex> guard(dfg->turn_mutex);
+      size_t &per_call = put ? stream->host_puts : stream->host_gets;
+      if (call == 0) {
+        per_call++;
+        return;
+      }
+      size_t &done = put ? stream->turn_puts : stream->turn_gets;
+      if (++done < per_call)
+        return;
+      done = 0;
+      turn()++;
+    }
+    dfg->turn_changed.notify_all();
+  }
+
+private:
+  uint64_t &turn() { return put ? stream->put_turn : stream->get_turn; }
+
+  StreamState *stream;
+  bool put;
+  DFGraph *dfg = nullptr;
+  uint64_t call = 0;
+};
+
+/// Creates a process of `dfg` reading the streams `inputs` and writing the
+/// streams `outputs`, or returns null if the process already is in the
+/// replayed graph.
+Process *make_process(void *dfg, std::vector<void *> inputs,
+                      std::vector<void *> outputs, void (*fun)(Process *)) {
+  if (((DFGraph *)dfg)->built)
+    return nullptr;
+  Process *p = new Process;
+  p->fun = fun;
+  p->dfg = (DFGraph *)dfg;
+  for (auto s : inputs) {
+    auto stream = (StreamState *)s;
+    attach_stream(p->dfg, stream);
+    p->input_readers.push_back(stream->add_reader(p));
+    p->input_streams.push_back(stream);
+  }
+  for (auto s : outputs) {
+    auto stream = (StreamState *)s;
+    attach_stream(p->dfg, stream);
+    stream->producer = p;
+    p->output_streams.push_back(stream);
+  }
+  p->dfg->dfg_processes.push_back(p);
+  return p;
+}
+
+/// Creates a keyswitch process of `dfg`, scalar or batched by `fun`.
+void make_keyswitch_process(void *dfg, void *sin1, void *sout,
+                            void (*fun)(Process *), uint32_t level,
+                            uint32_t base_log, uint32_t input_lwe_dim,
+                            uint32_t output_lwe_dim, uint32_t output_size,
+                            uint32_t ksk_index, void *context) {
+  Process *p = make_process(dfg, {sin1}, {sout}, fun);
+  if (p == nullptr)
+    return;
+  p->level.val = level;
+  p->base_log.val = base_log;
+  p->input_lwe_dim.val = input_lwe_dim;
+  p->output_lwe_dim.val = output_lwe_dim;
+  p->output_size.val = output_size;
+  p->ksk_index.val = ksk_index;
+  p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
+}
+
+/// Creates a bootstrap process of `dfg`, scalar or batched by `fun`.
+void make_bootstrap_process(void *dfg, void *sin1, void *sin2, void *sout,
+                            void (*fun)(Process *), uint32_t input_lwe_dim,
+                            uint32_t poly_size, uint32_t level,
+                            uint32_t base_log, uint32_t glwe_dim,
+                            uint32_t output_size, uint32_t bsk_index,
+                            void *context) {
+  Process *p = make_process(dfg, {sin1, sin2}, {sout}, fun);
+  if (p == nullptr)
+    return;
+  p->input_lwe_dim.val = input_lwe_dim;
+  p->poly_size.val = poly_size;
+  p->level.val = level;
+  p->base_log.val = base_log;
+  p->glwe_dim.val = glwe_dim;
+  p->output_size.val = output_size;
+  p->bsk_index.val = bsk_index;
+  p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
+}
+
+/// Puts the item of the host `mref` to `stream`.
+template <size_t N>
+void put_item(void *stream, MemRefDescriptor<N> mref,
+              uint64_t data_ownership) {
+  auto s = as_stream<MemRefDescriptor<N>>(stream);
+  HostTurn turn(s, true);
+  s->put(adopt_item(s, mref, data_ownership));
+}
+
+/// Gets the next item of `stream` for the host in `out`.
+template <size_t N> void get_item(void *stream, MemRefDescriptor<N> out) {
+  auto s = as_stream<MemRefDescriptor<N>>(stream);
+  HostTurn turn(s, false);
+  MemRefDescriptor<N> mref = s->get(0);
+  copy_item(mref, out);
+  release(s, mref);
 }
 
 } // namespace
@@ -202,181 +930,200 @@ void stream_emulator_make_memref_add_lwe_ciphertexts_u64_process(void *dfg,
                                                                  void *sin1,
                                                                  void *sin2,
                                                                  void *sout) {
-  mlir::concretelang::stream_emulator::Process *p =
-      new mlir::concretelang::stream_emulator::Process;
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin1);
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin2);
-  p->output_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sout);
-  p->fun = mlir::concretelang::stream_emulator::
-      memref_add_lwe_ciphertexts_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_add_lwe_ciphertexts_u64_process);
 }
 
 void stream_emulator_make_memref_add_plaintext_lwe_ciphertext_u64_process(
     void *dfg, void *sin1, void *sin2, void *sout) {
-  mlir::concretelang::stream_emulator::Process *p =
-      new mlir::concretelang::stream_emulator::Process;
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin1);
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<uint64_t> *)sin2);
-  p->output_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sout);
-  p->fun = mlir::concretelang::stream_emulator::
-      memref_add_plaintext_lwe_ciphertext_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_add_plaintext_lwe_ciphertext_u64_process);
 }
 
 void stream_emulator_make_memref_mul_cleartext_lwe_ciphertext_u64_process(
     void *dfg, void *sin1, void *sin2, void *sout) {
-  mlir::concretelang::stream_emulator::Process *p =
-      new mlir::concretelang::stream_emulator::Process;
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin1);
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<uint64_t> *)sin2);
-  p->output_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sout);
-  p->fun = mlir::concretelang::stream_emulator::
-      memref_mul_cleartext_lwe_ciphertext_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_mul_cleartext_lwe_ciphertext_u64_process);
 }
 
 void stream_emulator_make_memref_negate_lwe_ciphertext_u64_process(void *dfg,
                                                                    void *sin1,
                                                                    void *sout) {
-  mlir::concretelang::stream_emulator::Process *p =
-      new mlir::concretelang::stream_emulator::Process;
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin1);
-  p->output_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sout);
-  p->fun = mlir::concretelang::stream_emulator::
-      memref_negate_lwe_ciphertext_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_negate_lwe_ciphertext_u64_process);
 }
 
 void stream_emulator_make_memref_keyswitch_lwe_u64_process(
     void *dfg, void *sin1, void *sout, uint32_t level, uint32_t base_log,
     uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t output_size,
     uint32_t ksk_index, void *context) {
-  mlir::concretelang::stream_emulator::Process *p =
-      new mlir::concretelang::stream_emulator::Process;
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin1);
-  p->output_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sout);
-  p->level.val = level;
-  p->base_log.val = base_log;
-  p->input_lwe_dim.val = input_lwe_dim;
-  p->output_lwe_dim.val = output_lwe_dim;
-  p->output_size.val = output_size;
-  p->ksk_index.val = ksk_index;
-  p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
-  p->fun =
-      mlir::concretelang::stream_emulator::memref_keyswitch_lwe_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  mlir::concretelang::stream_emulator::make_keyswitch_process(
+      dfg, sin1, sout,
+      mlir::concretelang::stream_emulator::memref_keyswitch_lwe_u64_process,
+      level, base_log, input_lwe_dim, output_lwe_dim, output_size, ksk_index,
+      context);
 }
 
 void stream_emulator_make_memref_bootstrap_lwe_u64_process(
     void *dfg, void *sin1, void *sin2, void *sout, uint32_t input_lwe_dim,
     uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
     uint32_t output_size, uint32_t bsk_index, void *context) {
-  mlir::concretelang::stream_emulator::Process *p =
-      new mlir::concretelang::stream_emulator::Process;
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin1);
-  p->input_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sin2);
-  p->output_streams.push_back(
-      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-          sout);
-  p->input_lwe_dim.val = input_lwe_dim;
-  p->poly_size.val = poly_size;
-  p->level.val = level;
-  p->base_log.val = base_log;
-  p->glwe_dim.val = glwe_dim;
-  p->output_size.val = output_size;
-  p->bsk_index.val = bsk_index;
-  p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
-  p->fun =
-      mlir::concretelang::stream_emulator::memref_bootstrap_lwe_u64_process;
-  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
-      ->dfg_processes.push_back(p);
+  mlir::concretelang::stream_emulator::make_bootstrap_process(
+      dfg, sin1, sin2, sout,
+      mlir::concretelang::stream_emulator::memref_bootstrap_lwe_u64_process,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, output_size,
+      bsk_index, context);
+}
+
+void stream_emulator_make_memref_batched_add_lwe_ciphertexts_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout) {
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_batched_add_lwe_ciphertexts_u64_process);
+}
+
+void stream_emulator_make_memref_batched_add_plaintext_lwe_ciphertext_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout) {
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_batched_add_plaintext_lwe_ciphertext_u64_process);
+}
+
+void stream_emulator_make_memref_batched_add_plaintext_cst_lwe_ciphertext_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout) {
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_batched_add_plaintext_cst_lwe_ciphertext_u64_process);
+}
+
+void stream_emulator_make_memref_batched_mul_cleartext_lwe_ciphertext_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout) {
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_batched_mul_cleartext_lwe_ciphertext_u64_process);
+}
+
+void stream_emulator_make_memref_batched_mul_cleartext_cst_lwe_ciphertext_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout) {
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1, sin2}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_batched_mul_cleartext_cst_lwe_ciphertext_u64_process);
+}
+
+void stream_emulator_make_memref_batched_negate_lwe_ciphertext_u64_process(
+    void *dfg, void *sin1, void *sout) {
+  mlir::concretelang::stream_emulator::make_process(
+      dfg, {sin1}, {sout},
+      mlir::concretelang::stream_emulator::
+          memref_batched_negate_lwe_ciphertext_u64_process);
+}
+
+void stream_emulator_make_memref_batched_keyswitch_lwe_u64_process(
+    void *dfg, void *sin1, void *sout, uint32_t level, uint32_t base_log,
+    uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t output_size,
+    uint32_t ksk_index, void *context) {
+  mlir::concretelang::stream_emulator::make_keyswitch_process(
+      dfg, sin1, sout,
+      mlir::concretelang::stream_emulator::
+          memref_batched_keyswitch_lwe_u64_process,
+      level, base_log, input_lwe_dim, output_lwe_dim, output_size, ksk_index,
+      context);
+}
+
+void stream_emulator_make_memref_batched_bootstrap_lwe_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout, uint32_t input_lwe_dim,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t output_size, uint32_t bsk_index, void *context) {
+  mlir::concretelang::stream_emulator::make_bootstrap_process(
+      dfg, sin1, sin2, sout,
+      mlir::concretelang::stream_emulator::
+          memref_batched_bootstrap_lwe_u64_process,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, output_size,
+      bsk_index, context);
+}
+
+void stream_emulator_make_memref_batched_mapped_bootstrap_lwe_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout, uint32_t input_lwe_dim,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t output_size, uint32_t bsk_index, void *context) {
+  mlir::concretelang::stream_emulator::make_bootstrap_process(
+      dfg, sin1, sin2, sout,
+      mlir::concretelang::stream_emulator::
+          memref_batched_mapped_bootstrap_lwe_u64_process,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, output_size,
+      bsk_index, context);
 }
 
 void *stream_emulator_make_uint64_stream(const char *name, stream_type stype) {
-  return (void *)new mlir::concretelang::stream_emulator::StreamBase<uint64_t>;
+  return mlir::concretelang::stream_emulator::make_stream<uint64_t>(stype);
 }
 void stream_emulator_put_uint64(void *stream, uint64_t e) {
-  ((mlir::concretelang::stream_emulator::StreamBase<uint64_t> *)stream)->put(e);
+  auto s = mlir::concretelang::stream_emulator::as_stream<uint64_t>(stream);
+  mlir::concretelang::stream_emulator::HostTurn turn(s, true);
+  s->put(e);
 }
 uint64_t stream_emulator_get_uint64(void *stream) {
-  return ((mlir::concretelang::stream_emulator::StreamBase<uint64_t> *)stream)
-      ->get();
+  auto s = mlir::concretelang::stream_emulator::as_stream<uint64_t>(stream);
+  mlir::concretelang::stream_emulator::HostTurn turn(s, false);
+  return s->get(0);
 }
 
 void *stream_emulator_make_memref_stream(const char *name, stream_type stype) {
-  return (void *)new mlir::concretelang::stream_emulator::StreamBase<
-      MemRefDescriptor<1>>;
+  return mlir::concretelang::stream_emulator::make_stream<MemRefDescriptor<1>>(stype);
 }
 void stream_emulator_put_memref(void *stream, uint64_t *allocated,
                                 uint64_t *aligned, uint64_t offset,
-                                uint64_t size, uint64_t stride) {
-  ((mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-       stream)
-      ->put({allocated, aligned, offset, {size}, {stride}});
+                                uint64_t size, uint64_t stride,
+                                uint64_t data_ownership) {
+  mlir::concretelang::stream_emulator::put_item<1>(
+      stream, {allocated, aligned, offset, {size}, {stride}}, data_ownership);
 }
 void stream_emulator_get_memref(void *stream, uint64_t *out_allocated,
                                 uint64_t *out_aligned, uint64_t out_offset,
                                 uint64_t out_size, uint64_t out_stride) {
-  MemRefDescriptor<1> mref =
-      ((mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
-           stream)
-          ->get();
-  memref_copy_one_rank(mref.allocated, mref.aligned, mref.offset, mref.sizes[0],
-                       mref.strides[0], out_allocated, out_aligned, out_offset,
-                       out_size, out_stride);
-  free(mref.allocated);
+  mlir::concretelang::stream_emulator::get_item<1>(
+      stream,
+      {out_allocated, out_aligned, out_offset, {out_size}, {out_stride}});
 }
 
 void *stream_emulator_make_memref_batch_stream(const char *name,
                                                stream_type stype) {
-  assert(0 && "Batched operations not implemented in the StreamEmulator.");
+  return mlir::concretelang::stream_emulator::make_stream<MemRefDescriptor<2>>(stype);
 }
 void stream_emulator_put_memref_batch(void *stream, uint64_t *allocated,
                                       uint64_t *aligned, uint64_t offset,
                                       uint64_t size0, uint64_t size1,
-                                      uint64_t stride0, uint64_t stride1) {
-  assert(0 && "Batched operations not implemented in the StreamEmulator.");
+                                      uint64_t stride0, uint64_t stride1,
+                                      uint64_t data_ownership) {
+  mlir::concretelang::stream_emulator::put_item<2>(
+      stream,
+      {allocated, aligned, offset, {size0, size1}, {stride0, stride1}},
+      data_ownership);
 }
 void stream_emulator_get_memref_batch(void *stream, uint64_t *out_allocated,
                                       uint64_t *out_aligned,
                                       uint64_t out_offset, uint64_t out_size0,
                                       uint64_t out_size1, uint64_t out_stride0,
                                       uint64_t out_stride1) {
-  assert(0 && "Batched operations not implemented in the StreamEmulator.");
+  mlir::concretelang::stream_emulator::get_item<2>(
+      stream, {out_allocated,
+               out_aligned,
+               out_offset,
+               {out_size0, out_size1},
+               {out_stride0, out_stride1}});
 }
 
 void *stream_emulator_init() {
@@ -386,7 +1133,37 @@ void *stream_emulator_init() {
   pfhestream->initTopology();
   return (void *)pfhestream;
 #else
-  return (void *)new mlir::concretelang::stream_emulator::DFGraph;
+  auto graph = new mlir::concretelang::stream_emulator::DFGraph;
+  mlir::concretelang::stream_emulator::building_graph = graph;
+  return (void *)graph;
+#endif
+}
+
+void *stream_emulator_init_persistent(void *context, uint64_t graph_id) {
+#ifdef CORNAMI_AVAILABLE
+  return stream_emulator_init();
+#else
+  using mlir::concretelang::stream_emulator::DFGraph;
+  using mlir::concretelang::stream_emulator::current_session;
+  if (current_session != nullptr) {
+    DFGraph *graph = current_session->start_call(graph_id);
+    mlir::concretelang::stream_emulator::building_graph = graph;
+    mlir::concretelang::stream_emulator::replayed_streams = 0;
+    return (void *)graph;
+  }
+  if (context == nullptr ||
+      !mlir::concretelang::stream_emulator::persistent_graphs_enabled())
+    return stream_emulator_init();
+  auto owner = (mlir::concretelang::RuntimeContext *)context;
+  auto graph = (DFGraph *)owner->acquire_sdfg_graph(graph_id);
+  if (graph == nullptr) {
+    graph = new DFGraph;
+    graph->owner = owner;
+    graph->graph_id = graph_id;
+  }
+  mlir::concretelang::stream_emulator::building_graph = graph;
+  mlir::concretelang::stream_emulator::replayed_streams = 0;
+  return (void *)graph;
 #endif
 }
 
@@ -394,6 +1171,7 @@ void stream_emulator_run(void *dfg) {
 #ifdef CORNAMI_AVAILABLE
   ((fhestream *)dfg)->FinalizeAndRun();
 #else
+  mlir::concretelang::stream_emulator::building_graph = nullptr;
   ((mlir::concretelang::stream_emulator::DFGraph *)dfg)->run();
 #endif
 }
@@ -402,6 +1180,44 @@ void stream_emulator_delete(void *dfg) {
 #ifdef CORNAMI_AVAILABLE
   delete ((fhestream *)dfg);
 #else
-  delete ((mlir::concretelang::stream_emulator::DFGraph *)dfg);
+  auto graph = (mlir::concretelang::stream_emulator::DFGraph *)dfg;
+  if (graph->session != nullptr) {
+    graph->session->end_call(graph);
+    return;
+  }
+  // The items of a call are all got by its end, a graph left with items,
+  // e.g. by a failed call, is not reused
+  bool drained =
+      std::all_of(graph->dfg_streams.begin(), graph->dfg_streams.end(),
+                  [](mlir::concretelang::stream_emulator::StreamState *s) {
+                    return s->drained();
+                  });
+  if (graph->owner != nullptr && graph->built && drained)
+    graph->owner->release_sdfg_graph(
+        graph->graph_id, graph,
+        mlir::concretelang::stream_emulator::delete_graph);
+  else
+    delete graph;
+#endif
+}
+
+void *stream_emulator_open_session() {
+#ifdef CORNAMI_AVAILABLE
+  return nullptr;
+#else
+  return (void *)new mlir::concretelang::stream_emulator::Session;
+#endif
+}
+
+void stream_emulator_set_session(void *session) {
+#ifndef CORNAMI_AVAILABLE
+  mlir::concretelang::stream_emulator::current_session =
+      (mlir::concretelang::stream_emulator::Session *)session;
+#endif
+}
+
+void stream_emulator_close_session(void *session) {
+#ifndef CORNAMI_AVAILABLE
+  delete (mlir::concretelang::stream_emulator::Session *)session;
 #endif
 }
@@ -0,0 +1,187 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/async_executor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+namespace async {
+
+struct Future {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+};
+
+namespace {
+
+struct Task {
+  std::function<void()> fn;
+  Future *future;
+};
+
+/// Index of the calling thread in the pool, or -1 if it is not a worker
+thread_local int workerIndex = -1;
+
+/// Thread pool with one task deque per worker. Workers push and pop their
+/// own tasks at the back of their deque and steal from the front of the
+/// others when they run out of work.
+class Executor {
+public:
+  Executor() {
+    size_t count = threadCount();
+    for (size_t i = 0; i < count; i++)
+      queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < count; i++)
+      threads.emplace_back([this, i] { work(i); });
+  }
+
+  ~Executor() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    sleepCv.notify_all();
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  void push(Task task) {
+    size_t index = workerIndex >= 0
+                       ? (size_t)workerIndex
+                       : nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                             queues.size();
+    {
+      std::lock_guard<std::mutex> lock(queues[index]->mutex);
+      queues[index]->tasks.push_back(std::move(task));
+    }
+    pending.fetch_add(1);
+    // Taking the lock orders the increment with the predicate check of the
+    // sleeping workers, so the notification cannot be lost
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    sleepCv.notify_one();
+  }
+
+  /// Runs one pending task on the calling thread, returns false if there
+  /// was none.
+  bool runOne() {
+    Task task;
+    if (!pop(task))
+      return false;
+    pending.fetch_sub(1);
+    task.fn();
+    // Notify with the lock held, as the waiter releases the future as soon
+    // as it sees it done
+    std::lock_guard<std::mutex> lock(task.future->mutex);
+    task.future->done = true;
+    task.future->cv.notify_all();
+    return true;
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  static size_t threadCount() {
+    if (const char *env = std::getenv("CONCRETE_ASYNC_THREADS")) {
+      long count = std::strtol(env, nullptr, 10);
+      if (count > 0)
+        return count;
+    }
+    size_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+  }
+
+  bool pop(Task &task) {
+    size_t count = queues.size();
+    size_t first = workerIndex >= 0 ? (size_t)workerIndex : 0;
+    if (workerIndex >= 0) {
+      Queue &own = *queues[first];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+    for (size_t i = 0; i < count; i++) {
+      Queue &victim = *queues[(first + i) % count];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(size_t index) {
+    workerIndex = index;
+    while (true) {
+      if (runOne())
+        continue;
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      sleepCv.wait(lock, [this] { return stopping || pending.load() > 0; });
+      if (stopping && pending.load() <= 0)
+        return;
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> nextQueue{0};
+  // Signed since a task may be popped before its push is accounted
+  std::atomic<int64_t> pending{0};
+  std::mutex sleepMutex;
+  std::condition_variable sleepCv;
+  bool stopping = false;
+};
+
+Executor &executor() {
+  static Executor instance;
+  return instance;
+}
+
+} // namespace
+
+Future *submit(std::function<void()> task) {
+  Future *future = new Future();
+  executor().push(Task{std::move(task), future});
+  return future;
+}
+
+void await(Future *future) {
+  Executor &pool = executor();
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(future->mutex);
+      if (future->done)
+        break;
+    }
+    if (pool.runOne())
+      continue;
+    // Nothing left to help with, the task is running on another thread
+    std::unique_lock<std::mutex> lock(future->mutex);
+    future->cv.wait(lock, [future] { return future->done; });
+    break;
+  }
+  delete future;
+}
+
+} // namespace async
+} // namespace concretelang
+} // namespace mlir
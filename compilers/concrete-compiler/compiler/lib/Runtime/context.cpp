@@ -6,8 +6,22 @@
 #include "concretelang/Runtime/context.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
+#include "concretelang/Common/LutEncoding.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/SHA256.h"
+#include <algorithm>
+#include <array>
 #include <assert.h>
+#include <fstream>
+#include <map>
 #include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 namespace mlir {
 namespace concretelang {
@@ -29,34 +43,856 @@ FFT::~FFT() {
   }
 }
 
-RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
-    : serverKeyset(serverKeyset) {
+FftBackend getFftBackend() { return concrete_cpu_get_fft_backend(); }
+
+const char *getFftBackendName(FftBackend backend) {
+  switch (backend) {
+  case FftBackend::Scalar:
+    return "scalar";
+  case FftBackend::Avx2:
+    return "avx2";
+  case FftBackend::Avx512:
+    return "avx512";
+  }
+  assert(false && "unknown fft backend");
+  return "unknown";
+}
+
+ScratchArena::~ScratchArena() {
+  for (auto &buffer : buffers)
+    free(buffer.data);
+}
+
+uint8_t *ScratchArena::get(Slot slot, size_t size, size_t align) {
+  assert(slot < NUM_SLOTS);
+  auto &buffer = buffers[slot];
+  if (buffer.data != nullptr && buffer.size >= size &&
+      buffer.align % align == 0)
+    return buffer.data;
+
+  free(buffer.data);
+  // aligned_alloc requires the size to be a multiple of the alignment
+  size_t alloc_align = std::max(align, buffer.align);
+  size_t alloc_size = (std::max(size, buffer.size) + alloc_align - 1) /
+                      alloc_align * alloc_align;
+  buffer.data = (uint8_t *)aligned_alloc(alloc_align, alloc_size);
+  assert(buffer.data != nullptr && "Runtime: scratch allocation failed");
+  buffer.size = alloc_size;
+  buffer.align = alloc_align;
+  return buffer.data;
+}
+
+ScratchArena &ScratchArena::local() {
+  static thread_local ScratchArena arena;
+  return arena;
+}
+
+namespace {
+/// Returns whether the environment variable `name` is set to a true value
+bool envFlag(const char *name) {
+  char *env = getenv(name);
+  return env != nullptr &&
+         (!strncmp(env, "True", 4) || !strncmp(env, "true", 4) ||
+          !strncmp(env, "On", 2) || !strncmp(env, "on", 2) ||
+          !strncmp(env, "1", 1));
+}
+
+std::atomic<uint64_t> gpu_key_uploads{0};
+
+/// The fourier forms of a bootstrap key converted by a context of the
+/// process, and the identity of the key they were converted from.
+struct SharedFourierKey {
+  std::weak_ptr<const void> identity;
+  std::weak_ptr<FourierBootstrapKey> full;
+  std::weak_ptr<std::vector<float>> compact;
+};
+
+struct SharedFourierKeys {
+  std::mutex mutex;
+  std::map<const void *, SharedFourierKey> keys;
+};
+
+SharedFourierKeys &sharedFourierKeys() {
+  // Never destroyed, the contexts may be destroyed at exit after the static
+  // objects
+  static SharedFourierKeys *instance = new SharedFourierKeys();
+  return *instance;
+}
+
+/// Shares the fourier forms of the key `identity` with the other contexts,
+/// they are freed with the last context using them.
+void shareFourierKey(const std::shared_ptr<const void> &identity,
+                     const std::shared_ptr<FourierBootstrapKey> &full,
+                     const std::shared_ptr<std::vector<float>> &compact) {
+  auto &shared = sharedFourierKeys();
+  const std::lock_guard<std::mutex> guard(shared.mutex);
+  // The entries of the keys freed since are dropped
+  for (auto it = shared.keys.begin(); it != shared.keys.end();)
+    it = it->second.identity.expired() ? shared.keys.erase(it) : std::next(it);
+  auto &entry = shared.keys[identity.get()];
+  entry.identity = identity;
+  if (full != nullptr)
+    entry.full = full;
+  if (compact != nullptr)
+    entry.compact = compact;
+}
+} // namespace
+
+uint64_t RuntimeContext::get_gpu_key_upload_count() {
+  return gpu_key_uploads.load(std::memory_order_relaxed);
+}
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+void RuntimeContext::count_gpu_key_upload() {
+  gpu_key_uploads.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+RuntimeContext::RuntimeContext(
+    ServerKeyset serverKeyset,
+    std::vector<std::shared_ptr<FourierBootstrapKey>> fourierBootstrapKeys)
+    : serverKeyset(serverKeyset),
+      release_standard_bsks(envFlag("CONCRETE_RELEASE_STANDARD_BSK")) {
+
+  size_t bsk_count = serverKeyset.lweBootstrapKeys.size();
+  fourier_bootstrap_keys.resize(bsk_count);
+  compact_fourier_bootstrap_keys.resize(bsk_count);
+  ffts.resize(bsk_count);
+  fourier_bootstrap_keys_ready.reset(new std::atomic<bool>[bsk_count]);
+  fourier_bootstrap_keys_full.reset(new std::atomic<bool>[bsk_count]);
+  for (size_t i = 0; i < bsk_count; i++) {
+    fourier_bootstrap_keys_ready[i] = false;
+    fourier_bootstrap_keys_full[i] = false;
+    fourier_bootstrap_keys_mutex.push_back(std::make_unique<std::mutex>());
+  }
 
-  // Initialize for each bootstrap key the fourier one
-  for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++) {
-    auto fdbsk = convert_to_fourier_domain(serverKeyset.lweBootstrapKeys[i]);
-    // Store the fourier_bootstrap_key in the context
-    fourier_bootstrap_keys.push_back(fdbsk.second);
-    ffts.push_back(std::move(fdbsk.first));
+  // Adopt the fourier keys converted elsewhere, in double precision
+  for (size_t i = 0; i < fourierBootstrapKeys.size() && i < bsk_count; i++) {
+    if (fourierBootstrapKeys[i] == nullptr)
+      continue;
+    auto params =
+        serverKeyset.lweBootstrapKeys[i].getInfo().asReader().getParams();
+    fourier_bootstrap_keys[i] = fourierBootstrapKeys[i];
+    ffts[i] = std::make_unique<FFT>(params.getPolynomialSize());
+    fourier_bootstrap_keys_ready[i] = true;
+    fourier_bootstrap_keys_full[i] = true;
+    shareFourierKey(serverKeyset.lweBootstrapKeys[i].getIdentity(),
+                    fourierBootstrapKeys[i], nullptr);
   }
 
+  // Initialize for each bootstrap key the fourier one, unless they are
+  // converted on first use
+  if (!envFlag("CONCRETE_LAZY_BSK_CONVERSION")) {
+#pragma omp parallel for if (bsk_count > 1)
+    for (size_t i = 0; i < bsk_count; i++)
+      if (bsk_grouping_factor(i) <= 1)
+        convert_fourier_bootstrap_key(i);
+  }
+
+  init_numa_replicas();
+
 #ifdef CONCRETELANG_CUDA_SUPPORT
   if (cudaGetDeviceCount(&num_devices) == cudaSuccess) {
+    char *env = getenv("SDFG_NUM_GPUS");
+    if (env != nullptr) {
+      int requested_gpus = strtol(env, NULL, 10);
+      if (requested_gpus > 0 && requested_gpus < num_devices)
+        num_devices = requested_gpus;
+    }
     bsk_gpu.resize(num_devices);
     ksk_gpu.resize(num_devices);
+    fpksk_gpu.resize(num_devices);
+    accumulator_gpu.resize(num_devices);
+    accumulator_gpu_size.resize(num_devices, 0);
     for (int i = 0; i < num_devices; ++i) {
       bsk_gpu[i].resize(serverKeyset.lweBootstrapKeys.size(), nullptr);
       ksk_gpu[i].resize(serverKeyset.lweKeyswitchKeys.size(), nullptr);
+      fpksk_gpu[i].resize(serverKeyset.packingKeyswitchKeys.size(), nullptr);
       bsk_gpu_mutex.push_back(std::make_unique<std::mutex>());
       ksk_gpu_mutex.push_back(std::make_unique<std::mutex>());
+      fpksk_gpu_mutex.push_back(std::make_unique<std::mutex>());
+      accumulator_gpu_mutex.push_back(std::make_unique<std::mutex>());
+      gpu_states_mutex.push_back(std::make_unique<std::mutex>());
     }
+    gpu_states.resize(num_devices);
+    idle_gpu_states.resize(num_devices);
+    if (envFlag("CONCRETE_EAGER_GPU_KEY_UPLOAD"))
+      upload_keys_to_gpus();
   } else {
     num_devices = 0;
   }
 #endif
+
+  if (release_standard_bsks)
+    release_standard_bootstrap_keys();
+}
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+GPUWrapperState::GPUWrapperState(uint32_t gpu_idx)
+    : gpu_idx(gpu_idx), stream(cuda_create_stream(gpu_idx)) {}
+
+GPUWrapperState::~GPUWrapperState() {
+  cudaStreamSynchronize((cudaStream_t)stream);
+  for (auto &buffer : buffers)
+    if (buffer.data != nullptr)
+      cuda_drop(buffer.data, gpu_idx);
+  if (identity_indexes != nullptr)
+    cuda_drop(identity_indexes, gpu_idx);
+  if (zero_indexes != nullptr)
+    cuda_drop(zero_indexes, gpu_idx);
+  release_pbs_buffer();
+  cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+}
+
+void *GPUWrapperState::get_buffer(Buffer slot, size_t size) {
+  assert(slot < NUM_BUFFERS);
+  auto &buffer = buffers[slot];
+  if (buffer.data != nullptr && buffer.size >= size)
+    return buffer.data;
+  // Buffers are only used by work queued on the stream, so the old one can
+  // be released asynchronously
+  if (buffer.data != nullptr)
+    cuda_drop_async(buffer.data, (cudaStream_t)stream, gpu_idx);
+  buffer.data = cuda_malloc_async(size, (cudaStream_t)stream, gpu_idx);
+  buffer.size = size;
+  return buffer.data;
+}
+
+int8_t *GPUWrapperState::get_pbs_buffer(uint32_t glwe_dim, uint32_t poly_size,
+                                        uint32_t level, uint32_t num_samples,
+                                        uint32_t lwe_dim,
+                                        uint32_t grouping_factor) {
+  bool multi_bit = grouping_factor > 1;
+  if (pbs_buffer != nullptr &&
+      (pbs_glwe_dim != glwe_dim || pbs_poly_size != poly_size ||
+       pbs_level != level || pbs_max_samples < num_samples ||
+       pbs_grouping_factor != grouping_factor ||
+       (multi_bit && pbs_lwe_dim != lwe_dim)))
+    release_pbs_buffer();
+  if (pbs_buffer == nullptr) {
+    if (multi_bit)
+      scratch_cuda_multi_bit_programmable_bootstrap_64(
+          stream, gpu_idx, &pbs_buffer, lwe_dim, glwe_dim, poly_size, level,
+          grouping_factor, num_samples, true);
+    else
+      scratch_cuda_programmable_bootstrap_64(stream, gpu_idx, &pbs_buffer,
+                                             glwe_dim, poly_size, level,
+                                             num_samples, true);
+    pbs_glwe_dim = glwe_dim;
+    pbs_poly_size = poly_size;
+    pbs_level = level;
+    pbs_max_samples = num_samples;
+    pbs_lwe_dim = lwe_dim;
+    pbs_grouping_factor = grouping_factor;
+  }
+  return pbs_buffer;
+}
+
+void GPUWrapperState::release_pbs_buffer() {
+  if (pbs_buffer == nullptr)
+    return;
+  if (pbs_grouping_factor > 1)
+    cleanup_cuda_multi_bit_programmable_bootstrap(stream, gpu_idx, &pbs_buffer);
+  else
+    cleanup_cuda_programmable_bootstrap(stream, gpu_idx, &pbs_buffer);
+  pbs_buffer = nullptr;
+}
+
+void *GPUWrapperState::get_indexes(void *&indexes, uint32_t &count,
+                                   uint32_t num_samples, bool identity) {
+  if (indexes != nullptr && count >= num_samples)
+    return indexes;
+  if (indexes != nullptr)
+    cuda_drop_async(indexes, (cudaStream_t)stream, gpu_idx);
+  std::vector<uint64_t> host(num_samples, 0);
+  if (identity)
+    for (uint32_t i = 0; i < num_samples; i++)
+      host[i] = i;
+  size_t size = num_samples * sizeof(uint64_t);
+  indexes = cuda_malloc_async(size, (cudaStream_t)stream, gpu_idx);
+  cuda_memcpy_async_to_gpu(indexes, host.data(), size, (cudaStream_t)stream,
+                           gpu_idx);
+  // The host array must outlive the copy
+  cudaStreamSynchronize((cudaStream_t)stream);
+  count = num_samples;
+  return indexes;
+}
+
+void *GPUWrapperState::get_identity_indexes(uint32_t num_samples) {
+  return get_indexes(identity_indexes, identity_indexes_count, num_samples,
+                     true);
+}
+
+void *GPUWrapperState::get_zero_indexes(uint32_t num_samples) {
+  return get_indexes(zero_indexes, zero_indexes_count, num_samples, false);
+}
+
+GPUWrapperState *RuntimeContext::acquire_gpu_state(uint32_t gpu_idx) {
+  assert(gpu_idx < (uint32_t)num_devices);
+  const std::lock_guard<std::mutex> guard(*gpu_states_mutex[gpu_idx]);
+  auto &idle = idle_gpu_states[gpu_idx];
+  if (!idle.empty()) {
+    auto state = idle.back();
+    idle.pop_back();
+    return state;
+  }
+  gpu_states[gpu_idx].push_back(std::make_unique<GPUWrapperState>(gpu_idx));
+  return gpu_states[gpu_idx].back().get();
+}
+
+void RuntimeContext::release_gpu_state(GPUWrapperState *state) {
+  const std::lock_guard<std::mutex> guard(*gpu_states_mutex[state->gpu_idx]);
+  idle_gpu_states[state->gpu_idx].push_back(state);
+}
+
+void RuntimeContext::keep_on_device(const uint64_t *host) {
+  const std::lock_guard<std::mutex> guard(device_resident_mutex);
+  keep_on_device_requests.insert(host);
+}
+
+bool RuntimeContext::take_keep_on_device(const uint64_t *host) {
+  const std::lock_guard<std::mutex> guard(device_resident_mutex);
+  return keep_on_device_requests.erase(host) > 0;
+}
+
+bool RuntimeContext::find_on_device(const uint64_t *host,
+                                    DeviceResidentBuffer &buffer) {
+  const std::lock_guard<std::mutex> guard(device_resident_mutex);
+  auto it = device_resident.find(host);
+  if (it == device_resident.end())
+    return false;
+  buffer = it->second;
+  return true;
+}
+
+void RuntimeContext::set_on_device(const uint64_t *host,
+                                   DeviceResidentBuffer buffer) {
+  const std::lock_guard<std::mutex> guard(device_resident_mutex);
+  auto it = device_resident.find(host);
+  if (it != device_resident.end()) {
+    cuda_drop(it->second.data, it->second.gpu_idx);
+    it->second = buffer;
+  } else {
+    device_resident.insert({host, buffer});
+  }
+}
+
+void RuntimeContext::copy_to_host(uint64_t *host) {
+  DeviceResidentBuffer buffer;
+  {
+    const std::lock_guard<std::mutex> guard(device_resident_mutex);
+    auto it = device_resident.find(host);
+    if (it == device_resident.end())
+      return;
+    buffer = it->second;
+    device_resident.erase(it);
+  }
+  auto *gpu = acquire_gpu_state(buffer.gpu_idx);
+  cuda_memcpy_async_to_cpu(host, buffer.data, buffer.size,
+                           (cudaStream_t)gpu->stream, buffer.gpu_idx);
+  cudaStreamSynchronize((cudaStream_t)gpu->stream);
+  release_gpu_state(gpu);
+  cuda_drop(buffer.data, buffer.gpu_idx);
+}
+
+void RuntimeContext::release_on_device(const uint64_t *host) {
+  const std::lock_guard<std::mutex> guard(device_resident_mutex);
+  keep_on_device_requests.erase(host);
+  auto it = device_resident.find(host);
+  if (it == device_resident.end())
+    return;
+  cuda_drop(it->second.data, it->second.gpu_idx);
+  device_resident.erase(it);
+}
+
+void RuntimeContext::upload_keys_to_gpus() {
+  std::vector<std::thread> uploaders;
+  for (int gpu_idx = 0; gpu_idx < num_devices; ++gpu_idx) {
+    uploaders.emplace_back([this, gpu_idx]() {
+      void *stream = cuda_create_stream(gpu_idx);
+      // The placeholders of the keys not added yet are skipped
+      auto &bsks = serverKeyset.lweBootstrapKeys;
+      for (size_t i = 0; i < bsks.size(); ++i) {
+        if (bsks[i].getTransportBuffer().size() == 0)
+          continue;
+        auto params = bsks[i].getInfo().asReader().getParams();
+        get_bsk_gpu(params.getInputLweDimension(), params.getPolynomialSize(),
+                    params.getLevelCount(), params.getGlweDimension(),
+                    gpu_idx, stream, i);
+      }
+      auto &ksks = serverKeyset.lweKeyswitchKeys;
+      for (size_t i = 0; i < ksks.size(); ++i) {
+        if (ksks[i].getTransportBuffer().size() == 0)
+          continue;
+        auto params = ksks[i].getInfo().asReader().getParams();
+        get_ksk_gpu(params.getLevelCount(), params.getInputLweDimension(),
+                    params.getOutputLweDimension(), gpu_idx, stream, i);
+      }
+      for (size_t i = 0; i < serverKeyset.packingKeyswitchKeys.size(); ++i)
+        if (serverKeyset.packingKeyswitchKeys[i].getSize() > 0)
+          get_fpksk_gpu(gpu_idx, stream, i);
+      cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+    });
+  }
+  for (auto &uploader : uploaders)
+    uploader.join();
+
+  if (release_standard_bsks)
+    release_standard_bootstrap_keys();
+}
+
+namespace {
+/// Device memory the accumulators cached by a context may use on a device
+const size_t MAX_ACCUMULATOR_CACHE_SIZE = 256 * 1024 * 1024;
+} // namespace
+
+void *RuntimeContext::get_accumulator_gpu(const uint64_t *tlu,
+                                          uint32_t num_lut_vectors,
+                                          uint32_t glwe_dim, uint32_t poly_size,
+                                          uint32_t gpu_idx, void *stream) {
+  size_t tlu_len = (size_t)num_lut_vectors * poly_size;
+  // FNV-1a over the words of the lookup tables and the glwe dimension
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto mix = [&hash](uint64_t word) {
+    hash ^= word;
+    hash *= 0x100000001b3ULL;
+  };
+  mix(glwe_dim);
+  mix(poly_size);
+  for (size_t i = 0; i < tlu_len; i++)
+    mix(tlu[i]);
+
+  const std::lock_guard<std::mutex> guard(*accumulator_gpu_mutex[gpu_idx]);
+  auto &cache = accumulator_gpu[gpu_idx];
+  auto range = cache.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto &acc = it->second;
+    if (acc.glwe_dim == glwe_dim && acc.poly_size == poly_size &&
+        acc.tlu.size() == tlu_len &&
+        std::equal(acc.tlu.begin(), acc.tlu.end(), tlu))
+      return acc.data;
+  }
+
+  size_t glwe_ct_len = tlu_len * (glwe_dim + 1);
+  size_t glwe_ct_size = glwe_ct_len * sizeof(uint64_t);
+  if (accumulator_gpu_size[gpu_idx] + glwe_ct_size > MAX_ACCUMULATOR_CACHE_SIZE)
+    return nullptr;
+  std::vector<uint64_t> glwe_ct(glwe_ct_len);
+  for (size_t l = 0; l < num_lut_vectors; ++l)
+    ::concretelang::lut::trivialGlweAccumulator(
+        glwe_ct.data() + l * poly_size * (glwe_dim + 1), tlu + l * poly_size,
+        glwe_dim, poly_size);
+  void *data = cuda_malloc_async(glwe_ct_size, (cudaStream_t)stream, gpu_idx);
+  cuda_memcpy_async_to_gpu(data, glwe_ct.data(), glwe_ct_size,
+                           (cudaStream_t)stream, gpu_idx);
+  // As for the keys, the accumulator must be complete before other streams
+  // can find it in the cache, this also keeps the host copy alive long enough
+  cudaStreamSynchronize((cudaStream_t)stream);
+  std::vector<uint64_t> tlu_copy(tlu, tlu + tlu_len);
+  cache.emplace(hash, DeviceAccumulator{std::move(tlu_copy), glwe_dim,
+                                        poly_size, data});
+  accumulator_gpu_size[gpu_idx] += glwe_ct_size;
+  return data;
+}
+
+size_t RuntimeContext::get_gpu_keys_memory(uint32_t gpu_idx) {
+  assert(gpu_idx < (uint32_t)num_devices);
+  size_t size = 0;
+  {
+    const std::lock_guard<std::mutex> guard(*bsk_gpu_mutex[gpu_idx]);
+    for (size_t i = 0; i < bsk_gpu[gpu_idx].size(); ++i)
+      if (bsk_gpu[gpu_idx][i] != nullptr)
+        size += bsk_standard_size(i) * sizeof(double);
+  }
+  {
+    const std::lock_guard<std::mutex> guard(*ksk_gpu_mutex[gpu_idx]);
+    for (size_t i = 0; i < ksk_gpu[gpu_idx].size(); ++i)
+      if (ksk_gpu[gpu_idx][i] != nullptr)
+        size += serverKeyset.lweKeyswitchKeys[i].getBuffer().size() *
+                sizeof(uint64_t);
+  }
+  {
+    const std::lock_guard<std::mutex> guard(*fpksk_gpu_mutex[gpu_idx]);
+    for (size_t i = 0; i < fpksk_gpu[gpu_idx].size(); ++i)
+      if (fpksk_gpu[gpu_idx][i] != nullptr)
+        size += serverKeyset.packingKeyswitchKeys[i].getSize() *
+                sizeof(uint64_t);
+  }
+  return size;
+}
+#endif
+
+#ifdef __linux__
+namespace {
+/// Returns the node of each cpu as described in sysfs, or an empty vector if
+/// the host has a single node.
+std::vector<uint32_t> readNumaCpuNodes(size_t &nodes) {
+  std::vector<uint32_t> cpuNodes;
+  for (nodes = 0;; nodes++) {
+    std::ifstream cpulist("/sys/devices/system/node/node" +
+                          std::to_string(nodes) + "/cpulist");
+    if (!cpulist)
+      break;
+    // Ranges list, e.g. "0-15,32-47"
+    std::string range;
+    while (std::getline(cpulist, range, ',')) {
+      unsigned first, last;
+      int matched = sscanf(range.c_str(), "%u-%u", &first, &last);
+      if (matched < 1)
+        continue;
+      if (matched == 1)
+        last = first;
+      if (cpuNodes.size() <= last)
+        cpuNodes.resize(last + 1, 0);
+      for (unsigned cpu = first; cpu <= last; cpu++)
+        cpuNodes[cpu] = nodes;
+    }
+  }
+  if (nodes <= 1)
+    cpuNodes.clear();
+  return cpuNodes;
+}
+
+/// The replicas are backed by huge pages, transparent ones unless the policy
+/// asks for explicit ones.
+::concretelang::huge_pages::Policy replicaPolicy() {
+  auto policy = ::concretelang::huge_pages::getPolicy();
+  if (policy == ::concretelang::huge_pages::Policy::NONE)
+    return ::concretelang::huge_pages::Policy::TRANSPARENT;
+  return policy;
 }
+} // namespace
+#endif
 
-std::pair<FFT, std::shared_ptr<std::vector<std::complex<double>>>>
+void *RuntimeContext::acquire_sdfg_graph(uint64_t graphId) {
+  const std::lock_guard<std::mutex> guard(sdfg_graphs_mutex);
+  auto graphs = sdfg_graphs.find(graphId);
+  if (graphs == sdfg_graphs.end() || graphs->second.empty())
+    return nullptr;
+  void *graph = graphs->second.back().graph;
+  graphs->second.pop_back();
+  return graph;
+}
+
+void RuntimeContext::release_sdfg_graph(uint64_t graphId, void *graph,
+                                        void (*deleter)(void *)) {
+  const std::lock_guard<std::mutex> guard(sdfg_graphs_mutex);
+  sdfg_graphs[graphId].push_back({graph, deleter});
+}
+
+void RuntimeContext::release_sdfg_graphs() {
+  const std::lock_guard<std::mutex> guard(sdfg_graphs_mutex);
+  for (auto &graphs : sdfg_graphs)
+    for (auto &graph : graphs.second)
+      graph.deleter(graph.graph);
+  sdfg_graphs.clear();
+}
+
+void RuntimeContext::init_numa_replicas() {
+#ifdef __linux__
+  if (fourier_bootstrap_keys.empty() || !envFlag("CONCRETE_NUMA_REPLICATE_BSK"))
+    return;
+  numa_cpu_nodes = readNumaCpuNodes(numa_nodes);
+  if (numa_cpu_nodes.empty())
+    return;
+  size_t count = numa_nodes * fourier_bootstrap_keys.size() * 2;
+  numa_replicas.reset(new std::atomic<void *>[count]);
+  for (size_t i = 0; i < count; i++)
+    numa_replicas[i] = nullptr;
+#endif
+}
+
+void RuntimeContext::release_numa_replicas() {
+#ifdef __linux__
+  if (numa_replicas == nullptr)
+    return;
+  size_t keys = fourier_bootstrap_keys.size();
+  for (size_t i = 0; i < numa_nodes * keys * 2; i++) {
+    auto replica = numa_replicas[i].load();
+    if (replica == nullptr)
+      continue;
+    bool compact = i % 2 == 1;
+    size_t size = bsk_standard_size(i / 2 % keys) *
+                  (compact ? sizeof(float) : sizeof(double));
+    ::concretelang::huge_pages::deallocate(replica, size);
+  }
+  numa_replicas.reset();
+#endif
+}
+
+const void *RuntimeContext::numa_local_replica(size_t keyId, bool compact,
+                                               const void *key, size_t size) {
+#ifdef __linux__
+  int cpu = sched_getcpu();
+  if (cpu < 0 || (size_t)cpu >= numa_cpu_nodes.size())
+    return key;
+  size_t key_on_node =
+      numa_cpu_nodes[cpu] * fourier_bootstrap_keys.size() + keyId;
+  auto &slot = numa_replicas[key_on_node * 2 + compact];
+  if (auto replica = slot.load(std::memory_order_acquire))
+    return replica;
+
+  const std::lock_guard<std::mutex> guard(numa_replicas_mutex);
+  if (auto replica = slot.load(std::memory_order_relaxed))
+    return replica;
+
+  void *replica = ::concretelang::huge_pages::allocate(size, replicaPolicy());
+  if (replica == nullptr)
+    return key;
+  // The pages are allocated on the node of the thread first touching them
+  memcpy(replica, key, size);
+  slot.store(replica, std::memory_order_release);
+  return replica;
+#else
+  return key;
+#endif
+}
+
+void RuntimeContext::add_bootstrap_key(size_t keyId, LweBootstrapKey key,
+                                       bool upload_to_gpus) {
+  assert(keyId < serverKeyset.lweBootstrapKeys.size());
+  serverKeyset.lweBootstrapKeys[keyId] = key;
+  if (bsk_grouping_factor(keyId) <= 1)
+    convert_fourier_bootstrap_key(keyId);
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (upload_to_gpus) {
+    auto params = key.getInfo().asReader().getParams();
+    for (int gpu_idx = 0; gpu_idx < num_devices; ++gpu_idx) {
+      void *stream = cuda_create_stream(gpu_idx);
+      get_bsk_gpu(params.getInputLweDimension(), params.getPolynomialSize(),
+                  params.getLevelCount(), params.getGlweDimension(), gpu_idx,
+                  stream, keyId);
+      cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+    }
+  }
+#endif
+  if (release_standard_bsks)
+    release_standard_bootstrap_key(keyId);
+}
+
+void RuntimeContext::release_standard_bootstrap_keys() {
+  for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++)
+    release_standard_bootstrap_key(i);
+}
+
+void RuntimeContext::release_standard_bootstrap_key(size_t keyId) {
+  // The multi-bit keys are only converted by the devices
+  if (bsk_grouping_factor(keyId) > 1 ||
+      !fourier_bootstrap_keys_ready[keyId].load(std::memory_order_acquire))
+    return;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  for (int gpu_idx = 0; gpu_idx < num_devices; ++gpu_idx) {
+    const std::lock_guard<std::mutex> guard(*bsk_gpu_mutex[gpu_idx]);
+    if (bsk_gpu[gpu_idx][keyId] == nullptr)
+      return;
+  }
+#endif
+  const std::lock_guard<std::mutex> guard(
+      *fourier_bootstrap_keys_mutex[keyId]);
+  serverKeyset.lweBootstrapKeys[keyId].releaseBuffers();
+}
+
+size_t RuntimeContext::bsk_standard_size(size_t keyId) {
+  if (bsk_grouping_factor(keyId) > 1)
+    return serverKeyset.lweBootstrapKeys[keyId].getBuffer().size();
+  auto params =
+      serverKeyset.lweBootstrapKeys[keyId].getInfo().asReader().getParams();
+  return concrete_cpu_bootstrap_key_size_u64(
+      params.getLevelCount(), params.getGlweDimension(),
+      params.getPolynomialSize(), params.getInputLweDimension());
+}
+
+void RuntimeContext::add_keyswitch_key(size_t keyId, LweKeyswitchKey key,
+                                       bool upload_to_gpus) {
+  assert(keyId < serverKeyset.lweKeyswitchKeys.size());
+  serverKeyset.lweKeyswitchKeys[keyId] = key;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (!upload_to_gpus)
+    return;
+  auto params = key.getInfo().asReader().getParams();
+  for (int gpu_idx = 0; gpu_idx < num_devices; ++gpu_idx) {
+    void *stream = cuda_create_stream(gpu_idx);
+    get_ksk_gpu(params.getLevelCount(), params.getInputLweDimension(),
+                params.getOutputLweDimension(), gpu_idx, stream, keyId);
+    cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+  }
+#endif
+}
+
+void RuntimeContext::add_packing_keyswitch_key(size_t keyId,
+                                               PackingKeyswitchKey key,
+                                               bool upload_to_gpus) {
+  assert(keyId < serverKeyset.packingKeyswitchKeys.size());
+  serverKeyset.packingKeyswitchKeys[keyId] = key;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (!upload_to_gpus)
+    return;
+  for (int gpu_idx = 0; gpu_idx < num_devices; ++gpu_idx) {
+    void *stream = cuda_create_stream(gpu_idx);
+    get_fpksk_gpu(gpu_idx, stream, keyId);
+    cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+  }
+#endif
+}
+
+void RuntimeContext::add_glwe_packing_keyswitch_key(
+    size_t keyId, GlwePackingKeyswitchKey key) {
+  assert(keyId < serverKeyset.glwePackingKeyswitchKeys.size());
+  serverKeyset.glwePackingKeyswitchKeys[keyId] = key;
+}
+
+void RuntimeContext::convert_fourier_bootstrap_key(size_t keyId) {
+  const std::lock_guard<std::mutex> guard(
+      *fourier_bootstrap_keys_mutex[keyId]);
+  if (fourier_bootstrap_keys_ready[keyId].load(std::memory_order_relaxed))
+    return;
+  assert(bsk_grouping_factor(keyId) <= 1 &&
+         "Multi-bit bootstrap keys can only be used on GPU");
+  if (adopt_shared_fourier_bootstrap_key(keyId))
+    return;
+  // The keys released by other contexts can only be adopted from them
+  if (serverKeyset.lweBootstrapKeys[keyId].getTransportBuffer().size() == 0)
+    return;
+
+  auto fdbsk = convert_to_fourier_domain(serverKeyset.lweBootstrapKeys[keyId]);
+  // Store the fourier_bootstrap_key in the context, rounded to single
+  // precision if its fourier precision allows it
+  uint32_t precision = bsk_fourier_precision(keyId);
+  if (precision > 0 && precision <= 24) {
+    auto &fourier = *fdbsk.second;
+    auto compact = std::make_shared<std::vector<float>>(2 * fourier.size());
+    for (size_t i = 0; i < fourier.size(); i++) {
+      (*compact)[2 * i] = (float)fourier[i].real();
+      (*compact)[2 * i + 1] = (float)fourier[i].imag();
+    }
+    compact_fourier_bootstrap_keys[keyId] = compact;
+  } else {
+    fourier_bootstrap_keys[keyId] = fdbsk.second;
+    fourier_bootstrap_keys_full[keyId].store(true, std::memory_order_release);
+  }
+  ffts[keyId] = std::make_unique<FFT>(std::move(fdbsk.first));
+  shareFourierKey(serverKeyset.lweBootstrapKeys[keyId].getIdentity(),
+                  fourier_bootstrap_keys[keyId],
+                  compact_fourier_bootstrap_keys[keyId]);
+  fourier_bootstrap_keys_ready[keyId].store(true, std::memory_order_release);
+}
+
+bool RuntimeContext::adopt_shared_fourier_bootstrap_key(size_t keyId) {
+  auto &bsk = serverKeyset.lweBootstrapKeys[keyId];
+  auto identity = bsk.getIdentity();
+  std::shared_ptr<FourierBootstrapKey> full;
+  std::shared_ptr<std::vector<float>> compact;
+  {
+    auto &shared = sharedFourierKeys();
+    const std::lock_guard<std::mutex> guard(shared.mutex);
+    auto entry = shared.keys.find(identity.get());
+    // The address of a freed key may be reused by another one
+    if (entry == shared.keys.end() || entry->second.identity.lock() != identity)
+      return false;
+    full = entry->second.full.lock();
+    compact = entry->second.compact.lock();
+  }
+  if (full == nullptr && compact == nullptr)
+    return false;
+
+  auto params = bsk.getInfo().asReader().getParams();
+  ffts[keyId] = std::make_unique<FFT>(params.getPolynomialSize());
+  compact_fourier_bootstrap_keys[keyId] = compact;
+  if (full != nullptr) {
+    fourier_bootstrap_keys[keyId] = full;
+    fourier_bootstrap_keys_full[keyId].store(true, std::memory_order_release);
+  }
+  fourier_bootstrap_keys_ready[keyId].store(true, std::memory_order_release);
+  return true;
+}
+
+void RuntimeContext::expand_fourier_bootstrap_key(size_t keyId) {
+  const std::lock_guard<std::mutex> guard(
+      *fourier_bootstrap_keys_mutex[keyId]);
+  if (fourier_bootstrap_keys_full[keyId].load(std::memory_order_relaxed))
+    return;
+
+  auto &compact = *compact_fourier_bootstrap_keys[keyId];
+  auto fourier = std::make_shared<FourierBootstrapKey>(compact.size() / 2);
+  for (size_t i = 0; i < fourier->size(); i++)
+    (*fourier)[i] = std::complex<double>(compact[2 * i], compact[2 * i + 1]);
+  fourier_bootstrap_keys[keyId] = fourier;
+  shareFourierKey(serverKeyset.lweBootstrapKeys[keyId].getIdentity(), fourier,
+                  nullptr);
+  fourier_bootstrap_keys_full[keyId].store(true, std::memory_order_release);
+}
+
+namespace {
+/// Version of the fourier bootstrap key cache files, to bump whenever the
+/// fourier representation of the keys changes
+const uint64_t FOURIER_BSK_CACHE_VERSION = 2;
+
+struct FourierBskCacheHeader {
+  char magic[8];
+  uint64_t version;
+  uint64_t parameters[5];
+  uint64_t fourier_size;
+  /// SHA-256 digest of the standard key, checked on load so that a file is
+  /// never taken for the one of another key
+  std::array<uint8_t, 32> digest;
+};
+
+/// Returns the path of the cache file of a fourier key, named after the
+/// SHA-256 digest of the standard key, which is set in `header`, and its
+/// polynomial size. Returns an empty string if the
+/// `CONCRETE_FOURIER_BSK_CACHE_DIR` environment variable is not set.
+std::string
+fourierBskCachePath(const ::concretelang::keys::KeyBuffer &bsk_buffer,
+                    FourierBskCacheHeader &header) {
+  char *dir = getenv("CONCRETE_FOURIER_BSK_CACHE_DIR");
+  if (dir == nullptr || *dir == '\0')
+    return "";
+  header.digest = llvm::SHA256::hash(
+      llvm::ArrayRef<uint8_t>((const uint8_t *)bsk_buffer.data(),
+                              bsk_buffer.size() * sizeof(uint64_t)));
+  return std::string(dir) + "/" + llvm::toHex(header.digest, true) + "-" +
+         std::to_string(header.parameters[3]) + ".fbsk";
+}
+
+bool loadFourierBsk(const std::string &path,
+                    const FourierBskCacheHeader &expected,
+                    FourierBootstrapKey &fourier_data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  FourierBskCacheHeader header;
+  if (!file.read((char *)&header, sizeof(header)) ||
+      memcmp(&header, &expected, sizeof(header)) != 0)
+    return false;
+  return (bool)file.read((char *)fourier_data.data(),
+                         fourier_data.size() * sizeof(std::complex<double>));
+}
+
+void storeFourierBsk(const std::string &path,
+                     const FourierBskCacheHeader &header,
+                     const FourierBootstrapKey &fourier_data) {
+  // Written aside then renamed, so that concurrent servers never read a
+  // partial file
+  std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      return;
+    file.write((const char *)&header, sizeof(header));
+    file.write((const char *)fourier_data.data(),
+               fourier_data.size() * sizeof(std::complex<double>));
+    if (!file) {
+      file.close();
+      remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0)
+    remove(tmp_path.c_str());
+}
+} // namespace
+
+std::pair<FFT, std::shared_ptr<FourierBootstrapKey>>
 RuntimeContext::convert_to_fourier_domain(LweBootstrapKey &bsk) {
   auto info = bsk.getInfo().asReader();
 
@@ -69,6 +905,27 @@ RuntimeContext::convert_to_fourier_domain(LweBootstrapKey &bsk) {
   // Create the FFT
   FFT fft(polynomial_size);
 
+  // Allocate the fourier_bootstrap_key
+  auto bsk_buffer = bsk.getBuffer();
+  auto fourier_data = std::make_shared<FourierBootstrapKey>();
+  fourier_data->resize(bsk_buffer.size() / 2);
+  auto bsk_data = bsk_buffer.data();
+
+  // Load the key converted by a previous run if it was persisted
+  FourierBskCacheHeader header = {
+      {'C', 'F', 'B', 'S', 'K', 0, 0, 0},
+      FOURIER_BSK_CACHE_VERSION,
+      {decomposition_level_count, decomposition_base_log, glwe_dimension,
+       polynomial_size, input_lwe_dimension},
+      fourier_data->size(),
+      {}};
+  auto cache_path = fourierBskCachePath(bsk_buffer, header);
+  if (!cache_path.empty() &&
+      loadFourierBsk(cache_path, header, *fourier_data)) {
+    return std::pair<FFT, std::shared_ptr<FourierBootstrapKey>>(
+        std::move(fft), fourier_data);
+  }
+
   // Allocate scratch for key conversion
   size_t scratch_size;
   size_t scratch_align;
@@ -76,12 +933,6 @@ RuntimeContext::convert_to_fourier_domain(LweBootstrapKey &bsk) {
       &scratch_size, &scratch_align, fft.fft);
   auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
 
-  // Allocate the fourier_bootstrap_key
-  auto &bsk_buffer = bsk.getBuffer();
-  auto fourier_data = std::make_shared<std::vector<std::complex<double>>>();
-  fourier_data->resize(bsk_buffer.size() / 2);
-  auto bsk_data = bsk_buffer.data();
-
   // Convert bootstrap_key to the fourier domain
   concrete_cpu_bootstrap_key_convert_u64_to_fourier(
       bsk_data, fourier_data->data(), decomposition_level_count,
@@ -89,7 +940,10 @@ RuntimeContext::convert_to_fourier_domain(LweBootstrapKey &bsk) {
       input_lwe_dimension, fft.fft, scratch, scratch_size);
   free(scratch);
 
-  return std::pair<FFT, std::shared_ptr<std::vector<std::complex<double>>>>(
+  if (!cache_path.empty())
+    storeFourierBsk(cache_path, header, *fourier_data);
+
+  return std::pair<FFT, std::shared_ptr<FourierBootstrapKey>>(
       std::move(fft), fourier_data);
 }
 } // namespace concretelang
@@ -103,37 +957,72 @@ RuntimeContext::convert_to_fourier_domain(LweBootstrapKey &bsk) {
 HPX_PLAIN_ACTION(mlir::concretelang::dfr::getKsk, _dfr_get_ksk_action)
 HPX_PLAIN_ACTION(mlir::concretelang::dfr::getBsk, _dfr_get_bsk_action)
 HPX_PLAIN_ACTION(mlir::concretelang::dfr::getPKsk, _dfr_get_pksk_action)
+HPX_PLAIN_ACTION(mlir::concretelang::dfr::getKeyset, _dfr_get_keyset_action)
 
 namespace mlir {
 namespace concretelang {
+namespace dfr {
+KeysetWrapper fetchParentKeyset(uint64_t contextId) {
+  // Nodes form a binary tree rooted at the root node, so that each node
+  // serves at most two others and the keys reach all the nodes in a
+  // logarithmic number of steps.
+  uint32_t parent = (hpx::get_locality_id() - 1) / 2;
+  _dfr_get_keyset_action getKeysetAction;
+  return getKeysetAction(hpx::naming::get_id_from_locality_id(parent),
+                         contextId);
+}
+} // namespace dfr
+
+std::mutex &DistributedRuntimeContext::key_guard(
+    std::map<size_t, std::unique_ptr<std::mutex>> &guards, size_t keyId) {
+  std::lock_guard<std::mutex> maps(maps_guard);
+  auto &guard = guards[keyId];
+  if (guard == nullptr)
+    guard = std::make_unique<std::mutex>();
+  return *guard;
+}
+
 const uint64_t *DistributedRuntimeContext::keyswitch_key_buffer(size_t keyId) {
   if (dfr::_dfr_is_root_node())
     return RuntimeContext::keyswitch_key_buffer(keyId);
 
-  std::lock_guard<std::mutex> guard(cm_guard);
-  if (ksks.find(keyId) == ksks.end()) {
+  {
+    std::lock_guard<std::mutex> maps(maps_guard);
+    auto it = ksks.find(keyId);
+    if (it != ksks.end())
+      return it->second.getBuffer().data();
+  }
+  std::lock_guard<std::mutex> guard(key_guard(ksk_guards, keyId));
+  std::unique_lock<std::mutex> maps(maps_guard);
+  auto it = ksks.find(keyId);
+  if (it == ksks.end()) {
+    maps.unlock();
     _dfr_get_ksk_action getKskAction;
     dfr::KeyWrapper<LweKeyswitchKey> kskw =
-        getKskAction(hpx::find_root_locality(), keyId);
-    ksks.insert(std::pair<size_t, LweKeyswitchKey>(keyId, kskw.keys[0]));
+        getKskAction(hpx::find_root_locality(), contextId, keyId);
+    maps.lock();
+    it = ksks.insert(std::pair<size_t, LweKeyswitchKey>(keyId, kskw.keys[0]))
+             .first;
   }
-  auto it = ksks.find(keyId);
-  assert(it != ksks.end());
   return it->second.getBuffer().data();
 }
 
 void DistributedRuntimeContext::getBSKonNode(size_t keyId) {
-  assert(fbks.find(keyId) == fbks.end());
-  assert(dffts.find(keyId) == dffts.end());
+  std::lock_guard<std::mutex> guard(key_guard(bsk_guards, keyId));
+  {
+    std::lock_guard<std::mutex> maps(maps_guard);
+    if (fbks.find(keyId) != fbks.end())
+      return;
+  }
   _dfr_get_bsk_action getBskAction;
   dfr::KeyWrapper<LweBootstrapKey> bskw =
-      getBskAction(hpx::find_root_locality(), keyId);
+      getBskAction(hpx::find_root_locality(), contextId, keyId);
 
   auto fdbsk = convert_to_fourier_domain(bskw.keys[0]);
-  fbks.insert(
-      std::pair<size_t, std::shared_ptr<std::vector<std::complex<double>>>>(
-          keyId, fdbsk.second));
+  std::lock_guard<std::mutex> maps(maps_guard);
   dffts.insert(std::pair<size_t, FFT>(keyId, std::move(fdbsk.first)));
+  fbks.insert(std::pair<size_t, std::shared_ptr<FourierBootstrapKey>>(
+      keyId, fdbsk.second));
 }
 
 const std::complex<double> *
@@ -141,28 +1030,52 @@ DistributedRuntimeContext::fourier_bootstrap_key_buffer(size_t keyId) {
   if (dfr::_dfr_is_root_node())
     return RuntimeContext::fourier_bootstrap_key_buffer(keyId);
 
-  std::lock_guard<std::mutex> guard(cm_guard);
-  if (fbks.find(keyId) == fbks.end())
-    getBSKonNode(keyId);
+  {
+    std::lock_guard<std::mutex> maps(maps_guard);
+    auto it = fbks.find(keyId);
+    if (it != fbks.end())
+      return it->second->data();
+  }
+  getBSKonNode(keyId);
+  std::lock_guard<std::mutex> maps(maps_guard);
   auto it = fbks.find(keyId);
   assert(it != fbks.end());
   return it->second->data();
 }
 
+const float *
+DistributedRuntimeContext::compact_fourier_bootstrap_key_buffer(size_t keyId) {
+  // The keys of the other nodes are converted in double precision
+  if (dfr::_dfr_is_root_node())
+    return RuntimeContext::compact_fourier_bootstrap_key_buffer(keyId);
+  return nullptr;
+}
+
 const uint64_t *
 DistributedRuntimeContext::fp_keyswitch_key_buffer(size_t keyId) {
   if (dfr::_dfr_is_root_node())
     return RuntimeContext::fp_keyswitch_key_buffer(keyId);
 
-  std::lock_guard<std::mutex> guard(cm_guard);
-  if (ksks.find(keyId) == ksks.end()) {
+  {
+    std::lock_guard<std::mutex> maps(maps_guard);
+    auto it = pksks.find(keyId);
+    if (it != pksks.end())
+      return it->second.getRawPtr();
+  }
+  std::lock_guard<std::mutex> guard(key_guard(pksk_guards, keyId));
+  std::unique_lock<std::mutex> maps(maps_guard);
+  auto it = pksks.find(keyId);
+  if (it == pksks.end()) {
+    maps.unlock();
     _dfr_get_pksk_action getPKskAction;
     dfr::KeyWrapper<PackingKeyswitchKey> pkskw =
-        getPKskAction(hpx::find_root_locality(), keyId);
-    pksks.insert(std::pair<size_t, PackingKeyswitchKey>(keyId, pkskw.keys[0]));
+        getPKskAction(hpx::find_root_locality(), contextId, keyId);
+    maps.lock();
+    it = pksks
+             .insert(std::pair<size_t, PackingKeyswitchKey>(keyId,
+                                                            pkskw.keys[0]))
+             .first;
   }
-  auto it = pksks.find(keyId);
-  assert(it != pksks.end());
   return it->second.getRawPtr();
 }
 
@@ -170,9 +1083,14 @@ const struct Fft *DistributedRuntimeContext::fft(size_t keyId) {
   if (dfr::_dfr_is_root_node())
     return RuntimeContext::fft(keyId);
 
-  std::lock_guard<std::mutex> guard(cm_guard);
-  if (dffts.find(keyId) == dffts.end())
-    getBSKonNode(keyId);
+  {
+    std::lock_guard<std::mutex> maps(maps_guard);
+    auto it = dffts.find(keyId);
+    if (it != dffts.end())
+      return it->second.fft;
+  }
+  getBSKonNode(keyId);
+  std::lock_guard<std::mutex> maps(maps_guard);
   auto it = dffts.find(keyId);
   assert(it != dffts.end());
   return it->second.fft;
@@ -0,0 +1,76 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "concretelang/Runtime/cost_model.h"
+
+namespace mlir {
+namespace concretelang {
+namespace gpu_dfg {
+
+SplitPlan plan_split(const KernelCost &cpu, const KernelCost &gpu,
+                     size_t num_samples, size_t num_cores, size_t devices) {
+  SplitPlan plan;
+  if (cpu.per_sample <= 0 || gpu.per_sample <= 0 || devices == 0 ||
+      num_cores == 0 || num_samples == 0)
+    return plan;
+  plan.min_gpu_chunk_samples =
+      std::max<size_t>(1, std::ceil(gpu.latency / gpu.per_sample));
+  size_t n = num_samples;
+  size_t cores = std::min(num_cores, n);
+  double cpu_only = cpu.time((n + cores - 1) / cores);
+  double gpu_only = gpu.time((n + devices - 1) / devices);
+  // Makespan when all resources finish together:
+  //   n = num_cores * M / cpu + devices * (M - latency) / gpu
+  double makespan = (n + devices * gpu.latency / gpu.per_sample) /
+                    (num_cores / cpu.per_sample + devices / gpu.per_sample);
+  size_t cpu_share = makespan / cpu.per_sample;
+  double gpu_share = (makespan - gpu.latency) / gpu.per_sample;
+  if (cpu_share >= 1 && gpu_share >= 1 && n >= num_cores + devices) {
+    size_t factor = std::llround(gpu_share / cpu_share);
+    // Each chunk needs at least one sample
+    factor = std::max<size_t>(1, std::min(factor, (n - num_cores) / devices));
+    size_t unit = n / (num_cores + devices * factor);
+    size_t cpu_samples = n - devices * unit * factor;
+    double mixed = std::max(cpu.time((cpu_samples + num_cores - 1) / num_cores),
+                            gpu.time(unit * factor));
+    if (mixed < cpu_only && mixed < gpu_only) {
+      plan.offload = true;
+      plan.cpu_chunks = num_cores;
+      plan.gpu_chunk_factor = factor;
+      return plan;
+    }
+  }
+  if (cpu_only <= gpu_only)
+    return plan;
+  plan.offload = true;
+  plan.cpu_chunks = 0;
+  plan.gpu_chunk_factor = 1;
+  return plan;
+}
+
+void load_kernel_costs(const char *path,
+                       std::map<std::string, KernelCost> &costs) {
+  std::ifstream file(path);
+  std::string kernel, location;
+  KernelCost cost;
+  while (file >> kernel >> location >> cost.latency >> cost.per_sample)
+    costs[kernel + " " + location] = cost;
+}
+
+bool save_kernel_cost(const char *path, const std::string &key,
+                      const KernelCost &cost) {
+  std::ofstream file(path, std::ios::app);
+  file.precision(17);
+  file << key << " " << cost.latency << " " << cost.per_sample << "\n";
+  return bool(file);
+}
+
+} // namespace gpu_dfg
+} // namespace concretelang
+} // namespace mlir
@@ -15,22 +15,44 @@ namespace dfr {
 
 RuntimeContextManager *_dfr_node_level_runtime_context_manager;
 
-KeyWrapper<LweKeyswitchKey> getKsk(size_t keyId) {
-  return KeyWrapper<LweKeyswitchKey>(std::vector<LweKeyswitchKey>{
-      _dfr_node_level_runtime_context_manager->context->getKeys()
-          .lweKeyswitchKeys[keyId]});
+KeyWrapper<LweKeyswitchKey> getKsk(uint64_t contextId, size_t keyId) {
+  auto &keys = _dfr_node_level_runtime_context_manager->getKeys(contextId);
+  return KeyWrapper<LweKeyswitchKey>(
+      std::vector<LweKeyswitchKey>{keys.lweKeyswitchKeys[keyId]});
 }
 
-KeyWrapper<LweBootstrapKey> getBsk(size_t keyId) {
-  return KeyWrapper<LweBootstrapKey>(std::vector<LweBootstrapKey>{
-      _dfr_node_level_runtime_context_manager->context->getKeys()
-          .lweBootstrapKeys[keyId]});
+KeyWrapper<LweBootstrapKey> getBsk(uint64_t contextId, size_t keyId) {
+  auto &keys = _dfr_node_level_runtime_context_manager->getKeys(contextId);
+  return KeyWrapper<LweBootstrapKey>(
+      std::vector<LweBootstrapKey>{keys.lweBootstrapKeys[keyId]});
 }
 
-KeyWrapper<PackingKeyswitchKey> getPKsk(size_t keyId) {
-  return KeyWrapper<PackingKeyswitchKey>(std::vector<PackingKeyswitchKey>{
-      _dfr_node_level_runtime_context_manager->context->getKeys()
-          .packingKeyswitchKeys[keyId]});
+KeyWrapper<PackingKeyswitchKey> getPKsk(uint64_t contextId, size_t keyId) {
+  auto &keys = _dfr_node_level_runtime_context_manager->getKeys(contextId);
+  return KeyWrapper<PackingKeyswitchKey>(
+      std::vector<PackingKeyswitchKey>{keys.packingKeyswitchKeys[keyId]});
+}
+
+KeysetWrapper getKeyset(uint64_t contextId) {
+  // Wait for this node to have received its own keys
+  auto &entry = _dfr_node_level_runtime_context_manager->getEntry(contextId);
+  entry.ready_future.get();
+  RuntimeContext *context = entry.context;
+  auto &keys = entry.keys;
+  KeysetWrapper ksw{KeyWrapper<LweKeyswitchKey>(keys.lweKeyswitchKeys),
+                    KeyWrapper<LweBootstrapKey>(keys.lweBootstrapKeys),
+                    KeyWrapper<PackingKeyswitchKey>(keys.packingKeyswitchKeys),
+                    {}};
+  // The keys released by the context can only be sent in the fourier domain
+  bool transfer = _dfr_node_level_runtime_context_manager->fourier_key_transfer;
+  for (size_t i = 0; i < keys.lweBootstrapKeys.size(); ++i) {
+    bool released = keys.lweBootstrapKeys[i].getTransportBuffer().size() == 0;
+    ksw.fbsks.push_back((transfer || released) &&
+                                context->bsk_grouping_factor(i) <= 1
+                            ? context->get_fourier_bootstrap_key(i)
+                            : nullptr);
+  }
+  return ksw;
 }
 
 } // namespace dfr
@@ -0,0 +1,175 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+// The leveled wrappers of wrappers.cpp, with the same signatures, as plain
+// loops the compiler can inline into the circuits. This file is not part of
+// the runtime library, it is compiled to the LLVM bitcode the compiler links
+// into the circuits when `CompilationOptions::runtimeBitcode` is set: the
+// loops are then unrolled, vectorized for the target and fused with the
+// loops of the circuits. The calls inlined are not timed by the primitive
+// statistics.
+
+#include "concretelang/Runtime/leveled_loops.h"
+
+namespace {
+
+using namespace mlir::concretelang::leveled;
+
+inline void addPlaintext(uint64_t *out, const uint64_t *in,
+                         uint64_t plaintext, size_t n) {
+  for (size_t i = 0; i + 1 < n; i++)
+    out[i] = in[i];
+  out[n - 1] = in[n - 1] + plaintext;
+}
+
+} // namespace
+
+extern "C" {
+
+void memref_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *ct1_allocated, uint64_t *ct1_aligned,
+    uint64_t ct1_offset, uint64_t ct1_size, uint64_t ct1_stride) {
+  addScalar(out_aligned + out_offset, ct0_aligned + ct0_offset,
+            ct1_aligned + ct1_offset, out_size);
+}
+
+void memref_add_plaintext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t plaintext) {
+  addPlaintext(out_aligned + out_offset, ct0_aligned + ct0_offset, plaintext,
+               out_size);
+}
+
+void memref_mul_cleartext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t cleartext) {
+  mulScalar(out_aligned + out_offset, ct0_aligned + ct0_offset, cleartext,
+            out_size);
+}
+
+void memref_negate_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride) {
+  negateScalar(out_aligned + out_offset, ct0_aligned + ct0_offset, out_size);
+}
+
+void memref_batched_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size0,
+    uint64_t ct1_size1, uint64_t ct1_stride0, uint64_t ct1_stride1) {
+  for (size_t i = 0; i < out_size0; i++)
+    addScalar(out_aligned + out_offset + i * out_stride0,
+              ct0_aligned + ct0_offset + i * ct0_stride0,
+              ct1_aligned + ct1_offset + i * ct1_stride0, out_size1);
+}
+
+void memref_batched_add_plaintext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
+    uint64_t ct1_stride) {
+  for (size_t i = 0; i < out_size0; i++)
+    addPlaintext(out_aligned + out_offset + i * out_stride0,
+                 ct0_aligned + ct0_offset + i * ct0_stride0,
+                 ct1_aligned[ct1_offset + i * ct1_stride], out_size1);
+}
+
+void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t plaintext) {
+  for (size_t i = 0; i < out_size0; i++)
+    addPlaintext(out_aligned + out_offset + i * out_stride0,
+                 ct0_aligned + ct0_offset + i * ct0_stride0, plaintext,
+                 out_size1);
+}
+
+void memref_batched_mul_cleartext_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
+    uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
+    uint64_t ct1_stride) {
+  for (size_t i = 0; i < out_size0; i++)
+    mulScalar(out_aligned + out_offset + i * out_stride0,
+              ct0_aligned + ct0_offset + i * ct0_stride0,
+              ct1_aligned[ct1_offset + i * ct1_stride], out_size1);
+}
+
+void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext) {
+  for (size_t i = 0; i < out_size0; i++)
+    mulScalar(out_aligned + out_offset + i * out_stride0,
+              ct0_aligned + ct0_offset + i * ct0_stride0, cleartext, out_size1);
+}
+
+void memref_batched_mul_cleartext_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *cleartexts_allocated,
+    uint64_t *cleartexts_aligned, uint64_t cleartexts_offset,
+    uint64_t cleartexts_size, uint64_t cleartexts_stride,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1) {
+  for (size_t i = 0; i < out_size0; i++)
+    mulAddScalar(out_aligned + out_offset + i * out_stride0,
+                 ct0_aligned + ct0_offset + i * ct0_stride0,
+                 cleartexts_aligned[cleartexts_offset + i * cleartexts_stride],
+                 ct1_aligned + ct1_offset + i * ct1_stride0, out_size1);
+}
+
+void memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1) {
+  for (size_t i = 0; i < out_size0; i++)
+    mulAddScalar(out_aligned + out_offset + i * out_stride0,
+                 ct0_aligned + ct0_offset + i * ct0_stride0, cleartext,
+                 ct1_aligned + ct1_offset + i * ct1_stride0, out_size1);
+}
+
+void memref_batched_negate_lwe_ciphertext_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1) {
+  for (size_t i = 0; i < out_size0; i++)
+    negateScalar(out_aligned + out_offset + i * out_stride0,
+                 ct0_aligned + ct0_offset + i * ct0_stride0, out_size1);
+}
+}
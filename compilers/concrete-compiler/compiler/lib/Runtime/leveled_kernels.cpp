@@ -0,0 +1,179 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/leveled_kernels.h"
+#include "concretelang/Runtime/leveled_loops.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CONCRETELANG_LEVELED_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace mlir {
+namespace concretelang {
+namespace leveled {
+
+namespace {
+
+struct Kernels {
+  void (*add)(uint64_t *, const uint64_t *, const uint64_t *, size_t);
+  void (*mul)(uint64_t *, const uint64_t *, uint64_t, size_t);
+  void (*negate)(uint64_t *, const uint64_t *, size_t);
+  void (*mulAdd)(uint64_t *, const uint64_t *, uint64_t, const uint64_t *,
+                 size_t);
+  const char *name;
+};
+
+#ifdef CONCRETELANG_LEVELED_KERNELS_X86
+
+__attribute__((target("avx2"))) void
+addAvx2(uint64_t *out, const uint64_t *lhs, const uint64_t *rhs, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(lhs + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(rhs + i));
+    _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi64(a, b));
+  }
+  addScalar(out + i, lhs + i, rhs + i, n - i);
+}
+
+// AVX2 has no 64 bits low multiplication, it is rebuilt from 32x32->64
+// products: lo(a * b) = lo(a)lo(b) + ((hi(a)lo(b) + lo(a)hi(b)) << 32)
+__attribute__((target("avx2"))) inline __m256i
+mulLoAvx2(__m256i a, __m256i b, __m256i bHi) {
+  __m256i aHi = _mm256_srli_epi64(a, 32);
+  __m256i loLo = _mm256_mul_epu32(a, b);
+  __m256i cross =
+      _mm256_add_epi64(_mm256_mul_epu32(aHi, b), _mm256_mul_epu32(a, bHi));
+  return _mm256_add_epi64(loLo, _mm256_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2"))) void
+mulAvx2(uint64_t *out, const uint64_t *in, uint64_t cleartext, size_t n) {
+  const __m256i b = _mm256_set1_epi64x((long long)cleartext);
+  const __m256i bHi = _mm256_srli_epi64(b, 32);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    _mm256_storeu_si256((__m256i *)(out + i), mulLoAvx2(a, b, bHi));
+  }
+  mulScalar(out + i, in + i, cleartext, n - i);
+}
+
+__attribute__((target("avx2"))) void negateAvx2(uint64_t *out,
+                                                const uint64_t *in, size_t n) {
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    _mm256_storeu_si256((__m256i *)(out + i), _mm256_sub_epi64(zero, a));
+  }
+  negateScalar(out + i, in + i, n - i);
+}
+
+__attribute__((target("avx2"))) void
+mulAddAvx2(uint64_t *out, const uint64_t *in, uint64_t cleartext,
+           const uint64_t *acc, size_t n) {
+  const __m256i b = _mm256_set1_epi64x((long long)cleartext);
+  const __m256i bHi = _mm256_srli_epi64(b, 32);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    __m256i c = _mm256_loadu_si256((const __m256i *)(acc + i));
+    _mm256_storeu_si256((__m256i *)(out + i),
+                        _mm256_add_epi64(mulLoAvx2(a, b, bHi), c));
+  }
+  mulAddScalar(out + i, in + i, cleartext, acc + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void
+addAvx512(uint64_t *out, const uint64_t *lhs, const uint64_t *rhs, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(lhs + i));
+    __m512i b = _mm512_loadu_si512((const void *)(rhs + i));
+    _mm512_storeu_si512((void *)(out + i), _mm512_add_epi64(a, b));
+  }
+  addScalar(out + i, lhs + i, rhs + i, n - i);
+}
+
+__attribute__((target("avx512f,avx512dq"))) void
+mulAvx512(uint64_t *out, const uint64_t *in, uint64_t cleartext, size_t n) {
+  const __m512i b = _mm512_set1_epi64((long long)cleartext);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    _mm512_storeu_si512((void *)(out + i), _mm512_mullo_epi64(a, b));
+  }
+  mulScalar(out + i, in + i, cleartext, n - i);
+}
+
+__attribute__((target("avx512f"))) void
+negateAvx512(uint64_t *out, const uint64_t *in, size_t n) {
+  const __m512i zero = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    _mm512_storeu_si512((void *)(out + i), _mm512_sub_epi64(zero, a));
+  }
+  negateScalar(out + i, in + i, n - i);
+}
+
+__attribute__((target("avx512f,avx512dq"))) void
+mulAddAvx512(uint64_t *out, const uint64_t *in, uint64_t cleartext,
+             const uint64_t *acc, size_t n) {
+  const __m512i b = _mm512_set1_epi64((long long)cleartext);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    __m512i c = _mm512_loadu_si512((const void *)(acc + i));
+    _mm512_storeu_si512((void *)(out + i),
+                        _mm512_add_epi64(_mm512_mullo_epi64(a, b), c));
+  }
+  mulAddScalar(out + i, in + i, cleartext, acc + i, n - i);
+}
+
+#endif
+
+Kernels selectKernels() {
+#ifdef CONCRETELANG_LEVELED_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+    return {addAvx512, mulAvx512, negateAvx512, mulAddAvx512, "avx512"};
+  if (__builtin_cpu_supports("avx2"))
+    return {addAvx2, mulAvx2, negateAvx2, mulAddAvx2, "avx2"};
+#endif
+  return {addScalar, mulScalar, negateScalar, mulAddScalar, "scalar"};
+}
+
+const Kernels &kernels() {
+  static const Kernels selected = selectKernels();
+  return selected;
+}
+
+} // namespace
+
+void add(uint64_t *out, const uint64_t *lhs, const uint64_t *rhs, size_t n) {
+  kernels().add(out, lhs, rhs, n);
+}
+
+void mul(uint64_t *out, const uint64_t *in, uint64_t cleartext, size_t n) {
+  kernels().mul(out, in, cleartext, n);
+}
+
+void negate(uint64_t *out, const uint64_t *in, size_t n) {
+  kernels().negate(out, in, n);
+}
+
+void mulAdd(uint64_t *out, const uint64_t *in, uint64_t cleartext,
+            const uint64_t *acc, size_t n) {
+  kernels().mulAdd(out, in, cleartext, acc, n);
+}
+
+const char *implementationName() { return kernels().name; }
+
+} // namespace leveled
+} // namespace concretelang
+} // namespace mlir
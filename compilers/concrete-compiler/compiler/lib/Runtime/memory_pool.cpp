@@ -0,0 +1,155 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/memory_pool.h"
+#include "concretelang/Common/HugePages.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+namespace memory_pool {
+
+namespace {
+
+// Smaller buffers are served well enough by malloc
+const size_t pageSize = 4096;
+const size_t minBlockSize = 4 * pageSize;
+const size_t hugePageSize = ::concretelang::huge_pages::HUGE_PAGE_SIZE;
+
+bool envFlag(const char *name) {
+  const char *env = std::getenv(name);
+  return env != nullptr &&
+         (!strcmp(env, "True") || !strcmp(env, "true") ||
+          !strcmp(env, "On") || !strcmp(env, "on") || !strcmp(env, "1"));
+}
+
+bool hugePages() {
+  return ::concretelang::huge_pages::getPolicy() !=
+         ::concretelang::huge_pages::Policy::NONE;
+}
+
+/// Rounds `size` up to its size class, four classes per power of two so that
+/// at most a fifth of a block is wasted.
+size_t sizeClass(size_t size) {
+  if (size <= minBlockSize)
+    return minBlockSize;
+  size_t octave = (size_t)1 << (63 - __builtin_clzll(size - 1));
+  size_t step = octave / 4;
+  if (hugePages() && size >= hugePageSize && step < hugePageSize)
+    step = hugePageSize;
+  return (size + step - 1) / step * step;
+}
+
+struct Block {
+  size_t size;
+  // Whether the block is allocated on huge pages, following the policy of
+  // `::concretelang::huge_pages`
+  bool mapped;
+};
+
+void *allocateBlock(size_t size, bool &mapped) {
+  mapped = hugePages() && size >= hugePageSize;
+  if (mapped)
+    return ::concretelang::huge_pages::allocate(size);
+  return std::aligned_alloc(pageSize, size);
+}
+
+void freeBlock(void *ptr, const Block &block) {
+  if (block.mapped)
+    ::concretelang::huge_pages::deallocate(ptr, block.size);
+  else
+    std::free(ptr);
+}
+
+class Pool {
+public:
+  Pool() {
+    limit = 1024ULL * 1024 * 1024;
+    if (const char *env = std::getenv("CONCRETE_HOST_MEMORY_POOL_MB"))
+      limit = std::strtoull(env, nullptr, 10) * 1024 * 1024;
+  }
+
+  void *allocate(size_t size) {
+    size_t block = sizeClass(size);
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      auto &cached = available[block];
+      if (!cached.empty()) {
+        void *ptr = cached.back();
+        cached.pop_back();
+        cachedBytes -= block;
+        return ptr;
+      }
+    }
+    bool mapped;
+    void *ptr = allocateBlock(block, mapped);
+    if (ptr == nullptr)
+      return nullptr;
+    std::lock_guard<std::mutex> guard(mutex);
+    blocks[ptr] = {block, mapped};
+    return ptr;
+  }
+
+  bool release(void *ptr) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = blocks.find(ptr);
+    if (it == blocks.end())
+      return false;
+    size_t block = it->second.size;
+    if (cachedBytes + block <= limit) {
+      available[block].push_back(ptr);
+      cachedBytes += block;
+      return true;
+    }
+    freeBlock(ptr, it->second);
+    blocks.erase(it);
+    return true;
+  }
+
+private:
+  std::mutex mutex;
+  // Buffers of the pool, in use or cached
+  std::unordered_map<void *, Block> blocks;
+  // Cached buffers per size class
+  std::map<size_t, std::vector<void *>> available;
+  size_t cachedBytes = 0;
+  size_t limit;
+};
+
+Pool &pool() {
+  // Never destroyed, the buffers of the circuits may be released at exit
+  // after the static objects
+  static Pool *instance = new Pool();
+  return *instance;
+}
+
+} // namespace
+
+bool enabled() {
+  static const bool enabled = envFlag("CONCRETE_HOST_MEMORY_POOL");
+  return enabled;
+}
+
+void *allocate(size_t size) {
+  if (!enabled() || size < minBlockSize)
+    return nullptr;
+  return pool().allocate(size);
+}
+
+bool release(void *ptr) {
+  if (!enabled() || ptr == nullptr)
+    return false;
+  return pool().release(ptr);
+}
+
+} // namespace memory_pool
+} // namespace concretelang
+} // namespace mlir
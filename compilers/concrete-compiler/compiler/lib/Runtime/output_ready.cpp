@@ -0,0 +1,28 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/output_ready.h"
+#include "concretelang/Runtime/wrappers.h"
+
+namespace mlir {
+namespace concretelang {
+
+static thread_local OutputReadyListener *currentListener = nullptr;
+
+OutputReadyScope::OutputReadyScope(OutputReadyListener *listener)
+    : previous(currentListener) {
+  currentListener = listener;
+}
+
+OutputReadyScope::~OutputReadyScope() { currentListener = previous; }
+
+} // namespace concretelang
+} // namespace mlir
+
+void concrete_output_ready(uint64_t aligned_ptr) {
+  auto listener = mlir::concretelang::currentListener;
+  if (listener != nullptr && *listener)
+    (*listener)(reinterpret_cast<void *>(aligned_ptr));
+}
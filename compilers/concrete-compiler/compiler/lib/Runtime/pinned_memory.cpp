@@ -0,0 +1,152 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/pinned_memory.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+#include "device.h"
+#endif
+
+namespace mlir {
+namespace concretelang {
+namespace pinned {
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+
+namespace {
+
+// Buffers smaller than a page are not worth the cost of a registration
+const size_t pageSize = 4096;
+const size_t minBlockSize = 4 * pageSize;
+
+bool envFlag(const char *name) {
+  const char *env = std::getenv(name);
+  return env != nullptr &&
+         (!strcmp(env, "True") || !strcmp(env, "true") ||
+          !strcmp(env, "On") || !strcmp(env, "on") || !strcmp(env, "1"));
+}
+
+size_t sizeClass(size_t size) {
+  size_t block = minBlockSize;
+  while (block < size)
+    block <<= 1;
+  return block;
+}
+
+class Pool {
+public:
+  Pool() {
+    limit = 1024ULL * 1024 * 1024;
+    if (const char *env = std::getenv("CONCRETE_PINNED_HOST_POOL_MB"))
+      limit = std::strtoull(env, nullptr, 10) * 1024 * 1024;
+  }
+
+  ~Pool() {
+    // Buffers still in use are left registered, they may be released
+    // after the pool is destroyed
+    for (auto &cached : available) {
+      for (void *ptr : cached.second) {
+        cudaHostUnregister(ptr);
+        std::free(ptr);
+      }
+    }
+  }
+
+  void *allocate(size_t size) {
+    size_t block = sizeClass(size);
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      auto &cached = available[block];
+      if (!cached.empty()) {
+        void *ptr = cached.back();
+        cached.pop_back();
+        cachedBytes -= block;
+        return ptr;
+      }
+    }
+    void *ptr = std::aligned_alloc(pageSize, block);
+    if (ptr == nullptr)
+      return nullptr;
+    if (cudaHostRegister(ptr, block, cudaHostRegisterPortable) !=
+        cudaSuccess) {
+      // Still usable as pageable memory, but not tracked by the pool
+      return ptr;
+    }
+    std::lock_guard<std::mutex> guard(mutex);
+    blocks[ptr] = block;
+    return ptr;
+  }
+
+  bool release(void *ptr) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = blocks.find(ptr);
+    if (it == blocks.end())
+      return false;
+    size_t block = it->second;
+    if (cachedBytes + block <= limit) {
+      available[block].push_back(ptr);
+      cachedBytes += block;
+      return true;
+    }
+    blocks.erase(it);
+    cudaHostUnregister(ptr);
+    std::free(ptr);
+    return true;
+  }
+
+private:
+  std::mutex mutex;
+  // Registered buffers, in use or cached, and their size class
+  std::unordered_map<void *, size_t> blocks;
+  // Cached buffers per size class
+  std::map<size_t, std::vector<void *>> available;
+  size_t cachedBytes = 0;
+  size_t limit;
+};
+
+Pool &pool() {
+  static Pool instance;
+  return instance;
+}
+
+} // namespace
+
+bool enabled() {
+  static const bool enabled = envFlag("CONCRETE_PINNED_HOST_MEMORY");
+  return enabled;
+}
+
+void *allocate(size_t size) {
+  if (!enabled() || size < pageSize)
+    return nullptr;
+  return pool().allocate(size);
+}
+
+bool release(void *ptr) {
+  if (!enabled() || ptr == nullptr)
+    return false;
+  return pool().release(ptr);
+}
+
+#else
+
+bool enabled() { return false; }
+
+void *allocate(size_t) { return nullptr; }
+
+bool release(void *) { return false; }
+
+#endif
+
+} // namespace pinned
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,170 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/primitive_statistics.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mlir {
+namespace concretelang {
+
+std::string runtimePrimitiveName(RuntimePrimitive primitive) {
+  switch (primitive) {
+  case RuntimePrimitive::KEYSWITCH:
+    return "KEYSWITCH";
+  case RuntimePrimitive::BOOTSTRAP:
+    return "BOOTSTRAP";
+  case RuntimePrimitive::KEYSWITCH_BOOTSTRAP:
+    return "KEYSWITCH_BOOTSTRAP";
+  case RuntimePrimitive::WOP_PBS:
+    return "WOP_PBS";
+  case RuntimePrimitive::LEVELED:
+    return "LEVELED";
+  }
+  return "UNKNOWN";
+}
+
+void PrimitiveStatistics::record(RuntimePrimitive primitive, int64_t kskIndex,
+                                 int64_t bskIndex, bool gpu,
+                                 uint64_t batchSize, uint64_t nanoseconds,
+                                 const HardwareCounts *counts) {
+  size_t bucket = 0;
+  while (bucket + 1 < PRIMITIVE_LATENCY_BUCKETS &&
+         (nanoseconds >> (bucket + 1)) != 0)
+    bucket++;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto inserted = statistics.try_emplace(
+      std::make_tuple(primitive, kskIndex, bskIndex, gpu),
+      PrimitiveStatistic{primitive, kskIndex, bskIndex, gpu});
+  auto &statistic = inserted.first->second;
+  statistic.calls++;
+  statistic.ciphertexts += batchSize;
+  statistic.nanoseconds += nanoseconds;
+  statistic.latencyHistogram[bucket]++;
+  if (counts != nullptr) {
+    statistic.countedCalls++;
+    statistic.cycles += counts->cycles;
+    statistic.instructions += counts->instructions;
+    statistic.cacheReferences += counts->cacheReferences;
+    statistic.cacheMisses += counts->cacheMisses;
+  }
+}
+
+std::vector<PrimitiveStatistic> PrimitiveStatistics::get() {
+  std::lock_guard<std::mutex> guard(mutex);
+  std::vector<PrimitiveStatistic> output;
+  for (auto &entry : statistics)
+    output.push_back(entry.second);
+  return output;
+}
+
+void PrimitiveStatistics::reset() {
+  std::lock_guard<std::mutex> guard(mutex);
+  statistics.clear();
+}
+
+#ifdef __linux__
+
+namespace {
+
+/// The performance counters of a thread, counted by a perf_event group led by
+/// the cycles, in user space only.
+struct ThreadCounters {
+  ThreadCounters() {
+    const uint64_t configs[] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+    for (uint64_t config : configs) {
+      struct perf_event_attr attr = {};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.disabled = fds.empty();
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      int fd = syscall(SYS_perf_event_open, &attr, 0, -1,
+                       fds.empty() ? -1 : fds.front(), 0);
+      if (fd < 0) {
+        close();
+        return;
+      }
+      fds.push_back(fd);
+    }
+    ioctl(fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadCounters() { close(); }
+
+  void close() {
+    for (int fd : fds)
+      ::close(fd);
+    fds.clear();
+  }
+
+  bool read(HardwareCounts &counts) {
+    if (fds.empty())
+      return false;
+    struct {
+      uint64_t nr;
+      uint64_t values[4];
+    } group;
+    if (::read(fds.front(), &group, sizeof(group)) != sizeof(group))
+      return false;
+    counts.cycles = group.values[0];
+    counts.instructions = group.values[1];
+    counts.cacheReferences = group.values[2];
+    counts.cacheMisses = group.values[3];
+    return true;
+  }
+
+  std::vector<int> fds;
+};
+
+} // namespace
+
+bool readHardwareCounters(HardwareCounts &counts) {
+  static thread_local ThreadCounters counters;
+  return counters.read(counts);
+}
+
+#else
+
+bool readHardwareCounters(HardwareCounts &counts) { return false; }
+
+#endif
+
+#if CONCRETELANG_PRIMITIVE_STATISTICS_ENABLED
+
+static thread_local PrimitiveStatistics *currentStatistics = nullptr;
+
+PrimitiveStatistics *getCurrentPrimitiveStatistics() {
+  return currentStatistics;
+}
+
+void setCurrentPrimitiveStatistics(PrimitiveStatistics *statistics) {
+  currentStatistics = statistics;
+}
+
+PrimitiveStatisticsScope::PrimitiveStatisticsScope(
+    PrimitiveStatistics *statistics)
+    : previous(currentStatistics) {
+  currentStatistics = statistics;
+}
+
+PrimitiveStatisticsScope::~PrimitiveStatisticsScope() {
+  currentStatistics = previous;
+}
+
+#endif
+
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,195 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/probes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <err.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mlir {
+namespace concretelang {
+namespace probes {
+namespace {
+
+const size_t RING_CAPACITY = 1 << 14;
+const size_t NAME_SIZE = 48;
+const auto DUMP_PERIOD = std::chrono::milliseconds(10);
+
+struct Probe {
+  uint64_t timestamp;
+  uint32_t precision;
+  double noiseVariance;
+  char name[NAME_SIZE];
+};
+
+/// The probes of a thread, written by the thread and read by the dumper only.
+struct Ring {
+  uint64_t tid;
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  std::unique_ptr<Probe[]> probes{new Probe[RING_CAPACITY]};
+};
+
+struct Probes {
+  Probes() {
+    char *env = getenv("CONCRETE_PROBE_FILE");
+    if (env == nullptr || *env == '\0')
+      return;
+    file.open(env);
+    if (!file) {
+      warnx("WARNING: cannot write the probes to %s", env);
+      return;
+    }
+    auto system = std::chrono::system_clock::now().time_since_epoch();
+    originSteady = std::chrono::steady_clock::now();
+    originNanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(system).count();
+    enabled = true;
+    dumper = std::thread([this]() {
+      std::unique_lock<std::mutex> lock(stopGuard);
+      while (!stopping) {
+        stopped.wait_for(lock, DUMP_PERIOD);
+        flush();
+      }
+    });
+  }
+
+  uint64_t now() {
+    return originNanoseconds +
+           std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - originSteady)
+               .count();
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> guard(stopGuard);
+      stopping = true;
+    }
+    stopped.notify_all();
+    dumper.join();
+  }
+
+  void flush();
+
+  bool enabled = false;
+  std::chrono::steady_clock::time_point originSteady;
+  uint64_t originNanoseconds = 0;
+  // Guards the rings and the file
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Ring>> rings;
+  std::ofstream file;
+  std::thread dumper;
+  std::mutex stopGuard;
+  std::condition_variable stopped;
+  bool stopping = false;
+};
+
+Probes &getProbes() {
+  static Probes probes;
+  // Registered once the probes are constructed, to be called before their
+  // destruction
+  static bool stopAtExit =
+      probes.enabled && atexit([]() { getProbes().stop(); }) == 0;
+  (void)stopAtExit;
+  return probes;
+}
+
+Ring &getThreadRing() {
+  static thread_local std::shared_ptr<Ring> ring = []() {
+    auto &probes = getProbes();
+    auto ring = std::make_shared<Ring>();
+    std::lock_guard<std::mutex> guard(probes.mutex);
+    ring->tid = probes.rings.size();
+    probes.rings.push_back(ring);
+    return ring;
+  }();
+  return *ring;
+}
+
+void writeString(std::ostream &os, const char *str) {
+  os << '"';
+  for (; *str != '\0'; str++) {
+    if (*str == '"' || *str == '\\')
+      os << '\\' << *str;
+    else if ((unsigned char)*str < 0x20)
+      os << ' ';
+    else
+      os << *str;
+  }
+  os << '"';
+}
+
+void Probes::flush() {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto &ring : rings) {
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    for (uint64_t i = ring->tail.load(std::memory_order_relaxed); i < head;
+         i++) {
+      Probe &probe = ring->probes[i % RING_CAPACITY];
+      file << "{\"probe\":";
+      writeString(file, probe.name);
+      file << ",\"thread\":" << ring->tid << ",\"ts\":" << probe.timestamp;
+      if (probe.precision != 0)
+        file << ",\"precision\":" << probe.precision;
+      if (probe.noiseVariance != 0)
+        file << ",\"noise_variance\":" << probe.noiseVariance;
+      file << "}\n";
+    }
+    ring->tail.store(head, std::memory_order_release);
+    uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0)
+      file << "{\"dropped\":" << dropped << ",\"thread\":" << ring->tid
+           << "}\n";
+  }
+  file.flush();
+}
+
+} // namespace
+
+bool isEnabled() { return getProbes().enabled; }
+
+void record(const char *name, size_t length, uint32_t precision,
+            double noiseVariance) {
+  auto &probes = getProbes();
+  if (!probes.enabled)
+    return;
+  Ring &ring = getThreadRing();
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  if (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Probe &probe = ring.probes[head % RING_CAPACITY];
+  probe.timestamp = probes.now();
+  probe.precision = precision;
+  probe.noiseVariance = noiseVariance;
+  length = std::min(length, NAME_SIZE - 1);
+  memcpy(probe.name, name, length);
+  probe.name[length] = '\0';
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+void flush() {
+  auto &probes = getProbes();
+  if (probes.enabled)
+    probes.flush();
+}
+
+} // namespace probes
+} // namespace concretelang
+} // namespace mlir
@@ -8,17 +8,27 @@
 #include "concrete-cpu.h"
 #include "concretelang/Common/Csprng.h"
 #include "concretelang/Common/Security.h"
+#include "concretelang/Runtime/simulation_statistics.h"
 #include "concretelang/Runtime/wrappers.h"
 #include "concretelang/Support/V0Parameters.h"
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <random>
+#include <utility>
+#include <vector>
 
 using concretelang::csprng::SoftCSPRNG;
 
 thread_local auto default_csprng = SoftCSPRNG(0);
 const uint64_t UINT63_MAX = UINT64_MAX >> 1;
 
+void mlir::concretelang::setSimulationSeed(__uint128_t seed) {
+  // the former csprng is destroyed with `reseeded`
+  SoftCSPRNG reseeded(seed);
+  std::swap(default_csprng.ptr, reseeded.ptr);
+}
+
 inline concretelang::security::SecurityCurve *security_curve() {
   return concretelang::security::getSecurityCurve(
       128, concretelang::security::BINARY);
@@ -29,15 +39,46 @@ uint64_t from_torus(double torus) {
   return (uint64_t)round(torus * pow(2, 64));
 }
 
-uint64_t gaussian_noise(double variance, Csprng *csprng = default_csprng.ptr) {
+uint64_t gaussian_noise_std_dev(double std_dev,
+                               Csprng *csprng = default_csprng.ptr) {
+  // the simulations without noise do not pay for sampling
+  if (std_dev == 0)
+    return 0;
   uint64_t random_gaussian_buff[2];
 
-  double std_dev = std::sqrt(variance);
   concrete_cpu_fill_with_random_gaussian(random_gaussian_buff, 2, std_dev,
                                          csprng);
   return random_gaussian_buff[0];
 }
 
+uint64_t gaussian_noise(double variance, Csprng *csprng = default_csprng.ptr) {
+  return gaussian_noise_std_dev(std::sqrt(variance), csprng);
+}
+
+// fills `buffer` with `count` samples of noise, drawn at once
+void fill_gaussian_noise_std_dev(uint64_t *buffer, size_t count,
+                                 double std_dev,
+                                 Csprng *csprng = default_csprng.ptr) {
+  if (std_dev == 0)
+    std::fill(buffer, buffer + count, 0);
+  else
+    concrete_cpu_fill_with_random_gaussian(buffer, count, std_dev, csprng);
+}
+
+// the element `index` of a 1D memref, whose single element is broadcast if it
+// has only one
+inline uint64_t broadcast_at(uint64_t *aligned, uint64_t offset, uint64_t size,
+                             uint64_t stride, uint64_t index) {
+  return aligned[offset + (size == 1 ? 0 : index * stride)];
+}
+
+void warn_overflow(const char *msg_f, char *loc) {
+  printf(msg_f, loc);
+  auto statistics = mlir::concretelang::getCurrentSimulationStatistics();
+  if (statistics != nullptr)
+    statistics->recordOverflow(loc);
+}
+
 uint64_t sim_encrypt_lwe_u64(uint64_t message, uint32_t lwe_dim,
                              Csprng *csprng) {
   double variance = security_curve()->getVariance(1, lwe_dim, 64);
@@ -51,7 +92,11 @@ uint64_t sim_keyswitch_lwe_u64(uint64_t plaintext, uint32_t level,
   double variance_ksk = security_curve()->getVariance(1, output_lwe_dim, 64);
   double variance = concrete_cpu_variance_keyswitch(input_lwe_dim, base_log,
                                                     level, 64, variance_ksk);
-  uint64_t ks_noise = gaussian_noise(variance);
+  return sim_keyswitch_lwe_std_dev_u64(plaintext, std::sqrt(variance));
+}
+
+uint64_t sim_keyswitch_lwe_std_dev_u64(uint64_t plaintext, double std_dev) {
+  uint64_t ks_noise = gaussian_noise_std_dev(std_dev);
   return plaintext + ks_noise;
 }
 
@@ -61,16 +106,43 @@ uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
                                uint32_t input_lwe_dim, uint32_t poly_size,
                                uint32_t level, uint32_t base_log,
                                uint32_t glwe_dim, bool overflow_detection,
-                               char *loc) {
-  auto tlu = tlu_aligned + tlu_offset;
-
-  // modulus switching
+                               uint32_t precision, double p_error, char *loc) {
   double variance_ms =
       concrete_cpu_estimate_modulus_switching_noise_with_binary_key(
           input_lwe_dim, log2(poly_size), 64);
-  uint64_t shift = (64 - log2(poly_size) - 2);
+  double variance_bsk = security_curve()->getVariance(glwe_dim, poly_size, 64);
+  double variance_br = concrete_cpu_variance_blind_rotate(
+      input_lwe_dim, glwe_dim, poly_size, base_log, level, 64,
+      mlir::concretelang::optimizer::DEFAULT_FFT_PRECISION, variance_bsk);
+  return sim_bootstrap_lwe_std_dev_u64(
+      plaintext, tlu_allocated, tlu_aligned, tlu_offset, tlu_size, tlu_stride,
+      poly_size, std::sqrt(variance_ms), std::sqrt(variance_br),
+      overflow_detection, precision, p_error, loc);
+}
+
+// the bootstrap of `plaintext` with `ms_noise` and `br_noise` the noise of its
+// modulus switching and of its blind rotation
+uint64_t bootstrap_with_noise(uint64_t plaintext, uint64_t *tlu,
+                              uint32_t poly_size, uint64_t ms_noise,
+                              uint64_t br_noise, bool overflow_detection,
+                              uint32_t precision, double p_error, char *loc) {
+  // modulus switching, the polynomial size being a power of two
+  uint64_t shift = 64 - __builtin_ctz(poly_size) - 2;
   // mod_switch noise
-  auto noise = gaussian_noise(variance_ms);
+  auto noise = ms_noise;
+
+  auto statistics = mlir::concretelang::getCurrentSimulationStatistics();
+  if (statistics != nullptr) {
+    double input_noise = 0;
+    if (precision != 0) {
+      // the distance to the closest multiple of delta, with the padding bit
+      uint64_t delta = uint64_t(1) << (63 - precision);
+      uint64_t noisy = plaintext + noise;
+      uint64_t message = (noisy + delta / 2) & ~(delta - 1);
+      input_noise = std::ldexp((double)(int64_t)(noisy - message), -64);
+    }
+    statistics->recordBootstrap(loc, precision, input_noise, p_error);
+  }
   noise >>= shift;
   noise += noise & 1;
   noise >>= 1;
@@ -98,27 +170,93 @@ uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
     out = out & 18446744073709551612U;
 
     if (!is_signed && out > UINT63_MAX) {
-      printf("WARNING at %s: overflow (padding bit) happened during LUT in "
-             "simulation\n",
-             loc);
+      warn_overflow("WARNING at %s: overflow (padding bit) happened during LUT "
+                    "in simulation\n",
+                    loc);
     }
     if (is_overflow) {
-      printf("WARNING at %s: overflow (original value didn't fit, so a modulus "
-             "was applied) happened "
-             "during LUT in "
-             "simulation\n",
-             loc);
+      warn_overflow("WARNING at %s: overflow (original value didn't fit, so a "
+                    "modulus was applied) happened during LUT in simulation\n",
+                    loc);
     }
   }
 
-  double variance_bsk = security_curve()->getVariance(glwe_dim, poly_size, 64);
-  double variance = concrete_cpu_variance_blind_rotate(
-      input_lwe_dim, glwe_dim, poly_size, base_log, level, 64,
-      mlir::concretelang::optimizer::DEFAULT_FFT_PRECISION, variance_bsk);
-  out = out + gaussian_noise(variance);
+  out = out + br_noise;
   return out;
 }
 
+uint64_t sim_bootstrap_lwe_std_dev_u64(
+    uint64_t plaintext, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t poly_size, double ms_std_dev, double br_std_dev,
+    bool overflow_detection, uint32_t precision, double p_error, char *loc) {
+  uint64_t ms_noise = gaussian_noise_std_dev(ms_std_dev);
+  uint64_t br_noise = gaussian_noise_std_dev(br_std_dev);
+  return bootstrap_with_noise(plaintext, tlu_aligned + tlu_offset, poly_size,
+                              ms_noise, br_noise, overflow_detection,
+                              precision, p_error, loc);
+}
+
+// the layout of the bits extracted from the blocks of a CRT ciphertext, which
+// are in the order
+//
+// [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
+// is the size of the crt decomposition
+struct CrtBitLayout {
+  // the number of bits extracted from each block, and the offset of its bits
+  std::vector<uint64_t> bits;
+  std::vector<uint64_t> offsets;
+  uint64_t total = 0;
+
+  CrtBitLayout(uint64_t *crt_decomp, uint64_t crt_decomp_size)
+      : bits(crt_decomp_size), offsets(crt_decomp_size) {
+    for (int64_t i = crt_decomp_size - 1; i >= 0; i--) {
+      bits[i] = static_cast<uint64_t>(
+          ceil(log2(static_cast<double>(crt_decomp[i]))));
+      offsets[i] = total;
+      total += bits[i];
+    }
+  }
+};
+
+// simulates the wop pbs of the CRT ciphertext `in`, whose blocks are `stride`
+// apart, into the `lut_count` contiguous blocks of `out`, `extracted_bits`
+// being a scratch buffer of `layout.total` words
+void wop_pbs_crt_with_noise(
+    uint64_t *out, uint64_t *in, uint64_t stride, const CrtBitLayout &layout,
+    uint64_t *extracted_bits, uint64_t *lut, uint64_t lut_count,
+    uint64_t lut_size, uint32_t lwe_small_dim, uint32_t cbs_level_count,
+    uint32_t cbs_base_log, uint32_t ksk_level_count, uint32_t ksk_base_log,
+    uint32_t bsk_level_count, uint32_t bsk_base_log, uint64_t log_poly_size,
+    uint32_t pksk_base_log, uint32_t pksk_level_count, uint32_t glwe_dim) {
+  // Extraction of each bit for each block
+  for (size_t i = 0; i < layout.bits.size(); i++) {
+    auto nb_bits_to_extract = layout.bits[i];
+
+    size_t delta_log = 64 - nb_bits_to_extract;
+
+    // trick ( ct - delta/2 + delta/2^4  )
+    uint64_t sub = (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
+                   (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
+    uint64_t in_block = in[i * stride] - sub;
+
+    simulation_extract_bit_lwe_ciphertext_u64(
+        &extracted_bits[layout.offsets[i]], in_block, delta_log,
+        nb_bits_to_extract, log_poly_size, glwe_dim, lwe_small_dim,
+        ksk_base_log, ksk_level_count, bsk_base_log, bsk_level_count, 64, 128,
+        default_csprng.ptr);
+  }
+
+  assert(lut_size == (uint64_t(1) << layout.total));
+
+  // Vertical packing
+  simulation_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
+      extracted_bits, out, layout.total, lut_count, lut_size, lut_count, lut,
+      glwe_dim, log_poly_size, lwe_small_dim, bsk_level_count, bsk_base_log,
+      cbs_level_count, cbs_base_log, pksk_level_count, pksk_base_log, 64, 128,
+      default_csprng.ptr);
+}
+
 void sim_wop_pbs_crt(
     // Output 1D memref
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
@@ -142,67 +280,65 @@ void sim_wop_pbs_crt(
 
   // Check number of blocks
   assert(out_size == in_size && out_size == crt_decomp_size);
+  assert(out_stride == 1);
+  assert(lut_ct_size0 == out_size);
 
   uint64_t log_poly_size =
       static_cast<uint64_t>(ceil(log2(static_cast<double>(polynomial_size))));
+  CrtBitLayout layout(crt_decomp_aligned + crt_decomp_offset, crt_decomp_size);
+  std::vector<uint64_t> extracted_bits(layout.total, 0);
+
+  wop_pbs_crt_with_noise(
+      out_aligned + out_offset, in_aligned + in_offset, in_stride, layout,
+      extracted_bits.data(), lut_ct_aligned + lut_ct_offset, lut_ct_size0,
+      lut_ct_size1, lwe_small_dim, cbs_level_count, cbs_base_log,
+      ksk_level_count, ksk_base_log, bsk_level_count, bsk_base_log,
+      log_poly_size, pksk_base_log, pksk_level_count, glwe_dim);
+}
 
-  // Compute the numbers of bits to extract for each block and the total one.
-  uint64_t total_number_of_bits_per_block = 0;
-  auto number_of_bits_per_block = new uint64_t[crt_decomp_size]();
-  for (uint64_t i = 0; i < crt_decomp_size; i++) {
-    uint64_t modulus = crt_decomp_aligned[i + crt_decomp_offset];
-    uint64_t nb_bit_to_extract =
-        static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
-    number_of_bits_per_block[i] = nb_bit_to_extract;
-
-    total_number_of_bits_per_block += nb_bit_to_extract;
-  }
-
-  // Create the buffer of ciphertexts for storing the total number of bits to
-  // extract.
-  // The extracted bit should be in the following order:
-  //
-  // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
-  // is the size of the crt decomposition
-  auto extract_bits_output_buffer =
-      new uint64_t[total_number_of_bits_per_block]{0};
-
-  // Extraction of each bit for each block
-  for (int64_t i = crt_decomp_size - 1, extract_bits_output_offset = 0; i >= 0;
-       extract_bits_output_offset += number_of_bits_per_block[i--]) {
-    auto nb_bits_to_extract = number_of_bits_per_block[i];
-
-    size_t delta_log = 64 - nb_bits_to_extract;
-
-    auto in_block = in_aligned[in_offset + i];
-
-    // trick ( ct - delta/2 + delta/2^4  )
-    uint64_t sub = (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
-                   (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
-    in_block -= sub;
-
-    simulation_extract_bit_lwe_ciphertext_u64(
-        &extract_bits_output_buffer[extract_bits_output_offset], in_block,
-        delta_log, nb_bits_to_extract, log_poly_size, glwe_dim, lwe_small_dim,
-        ksk_base_log, ksk_level_count, bsk_base_log, bsk_level_count, 64, 128,
-        default_csprng.ptr);
-  }
-
-  size_t ct_in_count = total_number_of_bits_per_block;
-  size_t lut_size = 1 << ct_in_count;
-  size_t ct_out_count = out_size;
-  size_t lut_count = ct_out_count;
+void sim_batched_wop_pbs_crt(
+    // Output 2D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1,
+    // Input 2D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size0, uint64_t in_size1, uint64_t in_stride0,
+    uint64_t in_stride1,
+    // clear text lut 2D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t polynomial_size, uint32_t pksk_base_log,
+    uint32_t pksk_level_count, uint32_t glwe_dim) {
 
-  assert(lut_ct_size0 == lut_count);
-  assert(lut_ct_size1 == lut_size);
+  // Check the batch and the number of blocks
+  assert(out_size0 == in_size0);
+  assert(out_size1 == in_size1 && out_size1 == crt_decomp_size);
+  assert(out_stride1 == 1);
+  assert(lut_ct_size0 == out_size1);
 
-  // Vertical packing
-  simulation_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
-      extract_bits_output_buffer, out_aligned + out_offset, ct_in_count,
-      ct_out_count, lut_size, lut_count, lut_ct_aligned + lut_ct_offset,
-      glwe_dim, log_poly_size, lwe_small_dim, bsk_level_count, bsk_base_log,
-      cbs_level_count, cbs_base_log, pksk_level_count, pksk_base_log, 64, 128,
-      default_csprng.ptr);
+  // the layout of the extracted bits and their buffer are shared by the batch
+  uint64_t log_poly_size =
+      static_cast<uint64_t>(ceil(log2(static_cast<double>(polynomial_size))));
+  CrtBitLayout layout(crt_decomp_aligned + crt_decomp_offset, crt_decomp_size);
+  std::vector<uint64_t> extracted_bits(layout.total, 0);
+
+  for (uint64_t i = 0; i < in_size0; i++)
+    wop_pbs_crt_with_noise(
+        out_aligned + out_offset + i * out_stride0,
+        in_aligned + in_offset + i * in_stride0, in_stride1, layout,
+        extracted_bits.data(), lut_ct_aligned + lut_ct_offset, lut_ct_size0,
+        lut_ct_size1, lwe_small_dim, cbs_level_count, cbs_base_log,
+        ksk_level_count, ksk_base_log, bsk_level_count, bsk_base_log,
+        log_poly_size, pksk_base_log, pksk_level_count, glwe_dim);
 }
 
 uint64_t sim_neg_lwe_u64(uint64_t plaintext) { return ~plaintext + 1; }
@@ -220,11 +356,11 @@ uint64_t sim_add_lwe_u64(uint64_t lhs, uint64_t rhs, char *loc,
     int64_t lhs_signed = (int64_t)lhs << 1;
     int64_t rhs_signed = (int64_t)rhs << 1;
     if (lhs_signed > 0 && rhs_signed > INT64_MAX - lhs_signed)
-      printf(msg_f, loc);
+      warn_overflow(msg_f, loc);
     else if (lhs_signed < 0 && rhs_signed < INT64_MIN - lhs_signed)
-      printf(msg_f, loc);
+      warn_overflow(msg_f, loc);
   } else if (lhs > UINT63_MAX - rhs || result > UINT63_MAX) {
-    printf(msg_f, loc);
+    warn_overflow(msg_f, loc);
   }
   return result;
 }
@@ -242,15 +378,116 @@ uint64_t sim_mul_lwe_u64(uint64_t lhs, uint64_t rhs, char *loc,
     int64_t lhs_signed = (int64_t)lhs << 1;
     int64_t rhs_signed = (int64_t)rhs << 1;
     if (lhs_signed != 0 && rhs_signed > INT64_MAX / lhs_signed)
-      printf(msg_f, loc);
+      warn_overflow(msg_f, loc);
     else if (lhs_signed != 0 && rhs_signed < INT64_MIN / lhs_signed)
-      printf(msg_f, loc);
+      warn_overflow(msg_f, loc);
   } else if (rhs != 0 && lhs > UINT63_MAX / rhs) {
-    printf(msg_f, loc);
+    warn_overflow(msg_f, loc);
   }
   return result;
 }
 
+void sim_batched_neg_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
+                             uint64_t out_offset, uint64_t out_size,
+                             uint64_t out_stride, uint64_t *in_allocated,
+                             uint64_t *in_aligned, uint64_t in_offset,
+                             uint64_t in_size, uint64_t in_stride) {
+  assert(out_size == in_size);
+  for (uint64_t i = 0; i < out_size; i++)
+    out_aligned[out_offset + i * out_stride] =
+        sim_neg_lwe_u64(in_aligned[in_offset + i * in_stride]);
+}
+
+void sim_batched_add_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *lhs_allocated,
+    uint64_t *lhs_aligned, uint64_t lhs_offset, uint64_t lhs_size,
+    uint64_t lhs_stride, uint64_t *rhs_allocated, uint64_t *rhs_aligned,
+    uint64_t rhs_offset, uint64_t rhs_size, uint64_t rhs_stride, char *loc,
+    bool is_signed, bool overflow_detection) {
+  for (uint64_t i = 0; i < out_size; i++) {
+    uint64_t lhs =
+        broadcast_at(lhs_aligned, lhs_offset, lhs_size, lhs_stride, i);
+    uint64_t rhs =
+        broadcast_at(rhs_aligned, rhs_offset, rhs_size, rhs_stride, i);
+    out_aligned[out_offset + i * out_stride] =
+        overflow_detection ? sim_add_lwe_u64(lhs, rhs, loc, is_signed)
+                           : lhs + rhs;
+  }
+}
+
+void sim_batched_mul_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *lhs_allocated,
+    uint64_t *lhs_aligned, uint64_t lhs_offset, uint64_t lhs_size,
+    uint64_t lhs_stride, uint64_t *rhs_allocated, uint64_t *rhs_aligned,
+    uint64_t rhs_offset, uint64_t rhs_size, uint64_t rhs_stride, char *loc,
+    bool is_signed, bool overflow_detection) {
+  for (uint64_t i = 0; i < out_size; i++) {
+    uint64_t lhs =
+        broadcast_at(lhs_aligned, lhs_offset, lhs_size, lhs_stride, i);
+    uint64_t rhs =
+        broadcast_at(rhs_aligned, rhs_offset, rhs_size, rhs_stride, i);
+    out_aligned[out_offset + i * out_stride] =
+        overflow_detection ? sim_mul_lwe_u64(lhs, rhs, loc, is_signed)
+                           : lhs * rhs;
+  }
+}
+
+void sim_batched_keyswitch_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *in_allocated,
+    uint64_t *in_aligned, uint64_t in_offset, uint64_t in_size,
+    uint64_t in_stride, double std_dev) {
+  assert(out_size == in_size);
+  std::vector<uint64_t> noise(in_size);
+  fill_gaussian_noise_std_dev(noise.data(), in_size, std_dev);
+  for (uint64_t i = 0; i < in_size; i++)
+    out_aligned[out_offset + i * out_stride] =
+        in_aligned[in_offset + i * in_stride] + noise[i];
+}
+
+void sim_batched_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *in_allocated,
+    uint64_t *in_aligned, uint64_t in_offset, uint64_t in_size,
+    uint64_t in_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t poly_size, double ms_std_dev, double br_std_dev,
+    bool overflow_detection, uint32_t precision, double p_error, char *loc) {
+  assert(out_size == in_size);
+  std::vector<uint64_t> ms_noise(in_size), br_noise(in_size);
+  fill_gaussian_noise_std_dev(ms_noise.data(), in_size, ms_std_dev);
+  fill_gaussian_noise_std_dev(br_noise.data(), in_size, br_std_dev);
+  for (uint64_t i = 0; i < in_size; i++)
+    out_aligned[out_offset + i * out_stride] = bootstrap_with_noise(
+        in_aligned[in_offset + i * in_stride], tlu_aligned + tlu_offset,
+        poly_size, ms_noise[i], br_noise[i], overflow_detection, precision,
+        p_error, loc);
+}
+
+void sim_batched_mapped_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *in_allocated,
+    uint64_t *in_aligned, uint64_t in_offset, uint64_t in_size,
+    uint64_t in_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size0, uint64_t tlu_size1,
+    uint64_t tlu_stride0, uint64_t tlu_stride1, uint32_t poly_size,
+    double ms_std_dev, double br_std_dev, bool overflow_detection,
+    uint32_t precision, double p_error, char *loc) {
+  assert(out_size == in_size && tlu_size0 == in_size);
+  assert(tlu_stride1 == 1 && "Runtime: stride not equal to 1, check "
+                             "sim_batched_mapped_bootstrap_lwe_u64");
+  std::vector<uint64_t> ms_noise(in_size), br_noise(in_size);
+  fill_gaussian_noise_std_dev(ms_noise.data(), in_size, ms_std_dev);
+  fill_gaussian_noise_std_dev(br_noise.data(), in_size, br_std_dev);
+  for (uint64_t i = 0; i < in_size; i++)
+    out_aligned[out_offset + i * out_stride] = bootstrap_with_noise(
+        in_aligned[in_offset + i * in_stride],
+        tlu_aligned + tlu_offset + i * tlu_stride0, poly_size, ms_noise[i],
+        br_noise[i], overflow_detection, precision, p_error, loc);
+}
+
 // a copy of memref_encode_expand_lut_for_bootstrap but which encodes overflow
 // and sign info into the LUT. Those information should later be discarder by
 // the LUT function
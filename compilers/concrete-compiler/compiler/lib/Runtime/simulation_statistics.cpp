@@ -0,0 +1,105 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/simulation_statistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Returns the x for which erfc(x) = y, for y in (0, 1).
+double inverseErfc(double y) {
+  double low = 0, high = 40;
+  for (int i = 0; i < 100; i++) {
+    double middle = (low + high) / 2;
+    if (std::erfc(middle) > y)
+      low = middle;
+    else
+      high = middle;
+  }
+  return (low + high) / 2;
+}
+
+/// Returns the largest variance of a centered gaussian noise exceeding half
+/// of the distance between two messages of `precision` bits, plus the padding
+/// bit, with a probability of `pError`.
+double getMaxVariance(uint32_t precision, double pError) {
+  if (precision == 0 || pError <= 0 || pError >= 1)
+    return 0;
+  double halfDelta = std::ldexp(1, -(int)precision - 2);
+  double deviation = halfDelta / (std::sqrt(2) * inverseErfc(pError));
+  return deviation * deviation;
+}
+
+std::atomic<SimulationStatistics *> currentStatistics{nullptr};
+
+} // namespace
+
+void SimulationStatistics::recordBootstrap(const char *location,
+                                           uint32_t precision, double noise,
+                                           double pError) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto &accumulator = statistics[location];
+  auto &statistic = accumulator.statistic;
+  statistic.bootstraps++;
+  if (precision == 0)
+    return;
+  if (statistic.precision != precision) {
+    statistic.precision = precision;
+    statistic.maxVariance = getMaxVariance(precision, pError);
+  }
+  accumulator.measured++;
+  accumulator.squaredNoise += noise * noise;
+  statistic.maxNoise = std::max(statistic.maxNoise, std::abs(noise));
+}
+
+void SimulationStatistics::recordOverflow(const char *location) {
+  std::lock_guard<std::mutex> guard(mutex);
+  statistics[location].statistic.overflows++;
+}
+
+std::vector<SimulationStatistic> SimulationStatistics::get() {
+  std::lock_guard<std::mutex> guard(mutex);
+  std::vector<SimulationStatistic> result;
+  for (auto &[location, accumulator] : statistics) {
+    SimulationStatistic statistic = accumulator.statistic;
+    statistic.location = location;
+    if (accumulator.measured != 0)
+      statistic.noiseVariance =
+          accumulator.squaredNoise / accumulator.measured;
+    result.push_back(statistic);
+  }
+  return result;
+}
+
+void SimulationStatistics::reset() {
+  std::lock_guard<std::mutex> guard(mutex);
+  statistics.clear();
+}
+
+SimulationStatistics *getCurrentSimulationStatistics() {
+  return currentStatistics.load(std::memory_order_relaxed);
+}
+
+SimulationStatisticsScope::SimulationStatisticsScope(
+    SimulationStatistics *statistics)
+    : statistics(statistics), previous(nullptr) {
+  // Without statistics, the scope leaves those of a concurrent call current
+  if (statistics != nullptr)
+    previous = currentStatistics.exchange(statistics);
+}
+
+SimulationStatisticsScope::~SimulationStatisticsScope() {
+  if (statistics != nullptr)
+    currentStatistics.store(previous);
+}
+
+} // namespace concretelang
+} // namespace mlir
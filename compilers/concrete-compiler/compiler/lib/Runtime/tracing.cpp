@@ -0,0 +1,219 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Runtime/tracing.h"
+
+#if CONCRETELANG_TRACING_ENABLED
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <err.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace mlir {
+namespace concretelang {
+namespace tracing {
+namespace {
+
+struct Event {
+  char phase;
+  const char *category;
+  std::string name;
+  uint64_t timestamp;
+  uint64_t duration;
+  uint64_t id;
+  std::vector<TraceArg> args;
+};
+
+/// The events of a thread, only contended when flushing.
+struct ThreadEvents {
+  std::mutex mutex;
+  uint64_t tid;
+  std::vector<Event> events;
+};
+
+struct Trace {
+  Trace() {
+    char *env = getenv("CONCRETE_TRACE_FILE");
+    if (env == nullptr || *env == '\0')
+      return;
+    path = env;
+    auto system = std::chrono::system_clock::now().time_since_epoch();
+    originSteady = std::chrono::steady_clock::now();
+    originNanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(system).count();
+    enabled = true;
+  }
+
+  bool enabled = false;
+  std::string path;
+  std::chrono::steady_clock::time_point originSteady;
+  uint64_t originNanoseconds = 0;
+  std::atomic<uint64_t> processId{0};
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadEvents>> threads;
+};
+
+Trace &getTrace() {
+  static Trace trace;
+  // Registered once the trace is constructed, to be called before its
+  // destruction
+  static bool flushAtExit = trace.enabled && atexit([]() { flush(); }) == 0;
+  (void)flushAtExit;
+  return trace;
+}
+
+ThreadEvents &getThreadEvents() {
+  static thread_local std::shared_ptr<ThreadEvents> events = []() {
+    auto &trace = getTrace();
+    auto events = std::make_shared<ThreadEvents>();
+    std::lock_guard<std::mutex> guard(trace.mutex);
+    events->tid = trace.threads.size();
+    trace.threads.push_back(events);
+    return events;
+  }();
+  return *events;
+}
+
+void record(char phase, const char *category, const char *name,
+            uint64_t timestamp, uint64_t duration, uint64_t id,
+            std::vector<TraceArg> args) {
+  auto &events = getThreadEvents();
+  std::lock_guard<std::mutex> guard(events.mutex);
+  events.events.push_back(
+      {phase, category, name, timestamp, duration, id, std::move(args)});
+}
+
+void writeString(std::ostream &os, const std::string &str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      os << '\\' << c;
+    else if ((unsigned char)c < 0x20)
+      os << ' ';
+    else
+      os << c;
+  }
+  os << '"';
+}
+
+/// Writes nanoseconds as the microseconds of the trace format.
+void writeMicroseconds(std::ostream &os, uint64_t nanoseconds) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+           (unsigned long long)(nanoseconds / 1000),
+           (unsigned long long)(nanoseconds % 1000));
+  os << buffer;
+}
+
+void writeEvent(std::ostream &os, const Event &event, uint64_t pid,
+                uint64_t tid) {
+  os << "{\"ph\":\"" << event.phase << "\",\"cat\":\"" << event.category
+     << "\",\"name\":";
+  writeString(os, event.name);
+  os << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":";
+  writeMicroseconds(os, event.timestamp);
+  if (event.phase == 'X') {
+    os << ",\"dur\":";
+    writeMicroseconds(os, event.duration);
+  }
+  if (event.phase == 'b' || event.phase == 'e')
+    os << ",\"id\":" << event.id;
+  if (!event.args.empty()) {
+    os << ",\"args\":{";
+    for (size_t i = 0; i < event.args.size(); i++) {
+      if (i != 0)
+        os << ",";
+      os << "\"" << event.args[i].name << "\":";
+      if (auto *value = std::get_if<int64_t>(&event.args[i].value))
+        os << *value;
+      else
+        writeString(os, std::get<std::string>(event.args[i].value));
+    }
+    os << "}";
+  }
+  os << "}";
+}
+
+} // namespace
+
+bool isEnabled() { return getTrace().enabled; }
+
+uint64_t now() {
+  auto &trace = getTrace();
+  return trace.originNanoseconds +
+         std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - trace.originSteady)
+             .count();
+}
+
+void complete(const char *category, const char *name, uint64_t start,
+              TraceArgs args) {
+  if (!isEnabled())
+    return;
+  uint64_t end = now();
+  record('X', category, name, start, end - start, 0, args);
+}
+
+void asyncSpan(const char *category, const char *name, uint64_t id,
+               uint64_t start, TraceArgs args) {
+  if (!isEnabled())
+    return;
+  uint64_t end = now();
+  record('b', category, name, start, 0, id, args);
+  record('e', category, name, end, 0, id, {});
+}
+
+void setThreadName(const char *name) {
+  if (!isEnabled())
+    return;
+  record('M', "__metadata", "thread_name", 0, 0, 0, {{"name", name}});
+}
+
+void setProcessId(uint64_t id) { getTrace().processId = id; }
+
+void flush() {
+  auto &trace = getTrace();
+  if (!trace.enabled)
+    return;
+  uint64_t pid = trace.processId;
+  std::string path = trace.path;
+  if (pid != 0)
+    path += "." + std::to_string(pid);
+  std::ofstream os(path);
+  if (!os) {
+    warnx("WARNING: cannot write the trace to %s", path.c_str());
+    return;
+  }
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  std::lock_guard<std::mutex> guard(trace.mutex);
+  for (auto &thread : trace.threads) {
+    std::lock_guard<std::mutex> threadGuard(thread->mutex);
+    for (auto &event : thread->events) {
+      os << (first ? "\n" : ",\n");
+      writeEvent(os, event, pid, thread->tid);
+      first = false;
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+TraceScope::~TraceScope() {
+  if (start == 0)
+    return;
+  uint64_t end = now();
+  record('X', category, name, start, end - start, 0, std::move(args));
+}
+
+} // namespace tracing
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -12,14 +12,53 @@
 #include <execinfo.h>
 #include <functional>
 #include <iostream>
+#include <omp.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <vector>
 
 #include "concretelang/Common/CRT.h"
+#include "concretelang/Common/LutEncoding.h"
+#include "concretelang/Runtime/async_executor.h"
+#include "concretelang/Runtime/leveled_kernels.h"
+#include "concretelang/Runtime/memory_pool.h"
+#include "concretelang/Runtime/pinned_memory.h"
+#include "concretelang/Runtime/primitive_statistics.h"
+#include "concretelang/Runtime/probes.h"
 #include "concretelang/Runtime/wrappers.h"
 
+/// Computes, for each block of a CRT ciphertext, the number of bits to
+/// extract and the offset of its extracted bits, and returns the total number
+/// of bits.
+///
+/// The extracted bit should be in the following order:
+///
+/// [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
+/// is the size of the crt decomposition
+static uint64_t crt_bits_to_extract(const uint64_t *crt_decomp,
+                                    uint64_t crt_decomp_size,
+                                    uint64_t *number_of_bits_per_block,
+                                    uint64_t *extract_bits_output_offsets) {
+  uint64_t total_number_of_bits_per_block = 0;
+  for (int64_t i = crt_decomp_size - 1; i >= 0; i--) {
+    uint64_t modulus = crt_decomp[i];
+    uint64_t nb_bit_to_extract =
+        static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
+    number_of_bits_per_block[i] = nb_bit_to_extract;
+    extract_bits_output_offsets[i] = total_number_of_bits_per_block;
+    total_number_of_bits_per_block += nb_bit_to_extract;
+  }
+  return total_number_of_bits_per_block;
+}
+
+/// The value subtracted from the body of a block before extracting its
+/// `nb_bits_to_extract` bits: ( ct - delta/2 + delta/2^4 )
+static uint64_t bit_extraction_shift(uint64_t nb_bits_to_extract) {
+  return (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
+         (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
+}
+
 #ifdef CONCRETELANG_CUDA_SUPPORT
 
 // CUDA memory utils function /////////////////////////////////////////////////
@@ -103,8 +142,277 @@ void memref_bootstrap_lwe_cuda_u64(
       input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index, context);
 }
 
+void memref_keyswitch_bootstrap_lwe_cuda_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  memref_batched_keyswitch_bootstrap_lwe_cuda_u64(
+      // Output 1D memref as 2D memref
+      out_allocated, out_aligned, out_offset, 1, out_size, out_size, out_stride,
+      // Input 1D memref as 2D memref
+      ct0_allocated, ct0_aligned, ct0_offset, 1, ct0_size, ct0_size, ct0_stride,
+      // Table lookup memref
+      tlu_allocated, tlu_aligned, tlu_offset, tlu_size, tlu_stride,
+      // Keyswitch and bootstrap additional arguments
+      ks_level, ks_base_log, ks_input_lwe_dim, ks_output_lwe_dim, ksk_index,
+      poly_size, level, base_log, glwe_dim, bsk_index, context);
+}
+
 // Batched CUDA function //////////////////////////////////////////////////////
 
+/// Splits a batch of `num_samples` ciphertexts in contiguous chunks, one per
+/// device used by the context, and runs `chunk(gpu_idx, first, count, keep)`
+/// for each of them from its own host thread.
+///
+/// Batches reading or producing ciphertexts kept on a device are not split
+/// and run on that device, as device copies are tracked per whole buffer.
+/// `keep` tells whether the result must stay on the device.
+template <typename ChunkFn>
+static void split_batch_across_gpus(mlir::concretelang::RuntimeContext *context,
+                                    const uint64_t *out, const uint64_t *in,
+                                    uint32_t num_samples, ChunkFn chunk) {
+  bool keep = context->take_keep_on_device(out);
+  // A previous device copy of the output would be stale once it is written
+  if (!keep)
+    context->release_on_device(out);
+  mlir::concretelang::RuntimeContext::DeviceResidentBuffer resident;
+  if (context->find_on_device(in, resident)) {
+    chunk(resident.gpu_idx, 0, num_samples, keep);
+    return;
+  }
+  uint32_t num_gpus = std::max(context->get_num_devices(), 1);
+  num_gpus = std::max(std::min(num_gpus, num_samples), 1u);
+  if (num_gpus == 1 || keep) {
+    chunk(0, 0, num_samples, keep);
+    return;
+  }
+  uint32_t chunk_size = (num_samples + num_gpus - 1) / num_gpus;
+#pragma omp parallel for num_threads(num_gpus)
+  for (uint32_t gpu_idx = 0; gpu_idx < num_gpus; gpu_idx++) {
+    uint32_t first = gpu_idx * chunk_size;
+    if (first < num_samples)
+      chunk(gpu_idx, first, std::min(chunk_size, num_samples - first), false);
+  }
+}
+
+/// Returns the device copy of the input batch `ct0`, uploading it unless a
+/// previous wrapper kept it on the device.
+static void *get_input_on_gpu(mlir::concretelang::RuntimeContext *context,
+                              mlir::concretelang::GPUWrapperState *gpu,
+                              uint64_t *ct0, size_t size) {
+  mlir::concretelang::RuntimeContext::DeviceResidentBuffer resident;
+  if (context->find_on_device(ct0, resident)) {
+    if (resident.gpu_idx == gpu->gpu_idx && resident.size == size)
+      return resident.data;
+    context->copy_to_host(ct0);
+  }
+  void *ct0_gpu =
+      gpu->get_buffer(mlir::concretelang::GPUWrapperState::INPUT, size);
+  cuda_memcpy_async_to_gpu(ct0_gpu, ct0, size, (cudaStream_t)gpu->stream,
+                           gpu->gpu_idx);
+  return ct0_gpu;
+}
+
+/// Returns the device buffer for the output batch `out`, which is a fresh
+/// allocation if the result is kept on the device.
+static void *get_output_on_gpu(mlir::concretelang::GPUWrapperState *gpu,
+                               size_t size, bool keep) {
+  if (keep)
+    return cuda_malloc_async(size, (cudaStream_t)gpu->stream, gpu->gpu_idx);
+  return gpu->get_buffer(mlir::concretelang::GPUWrapperState::OUTPUT, size);
+}
+
+/// Copies back the output batch to `out`, or records it as kept on the
+/// device.
+static void finish_output_on_gpu(mlir::concretelang::RuntimeContext *context,
+                                 mlir::concretelang::GPUWrapperState *gpu,
+                                 uint64_t *out, void *out_gpu, size_t size,
+                                 bool keep) {
+  if (!keep)
+    cuda_memcpy_async_to_cpu(out, out_gpu, size, (cudaStream_t)gpu->stream,
+                             gpu->gpu_idx);
+  cudaStreamSynchronize((cudaStream_t)gpu->stream);
+  if (keep)
+    context->set_on_device(out, {gpu->gpu_idx, out_gpu, size});
+}
+
+/// Keyswitches `num_samples` contiguous ciphertexts on the device `gpu_idx`.
+static void
+keyswitch_lwe_cuda_u64(uint64_t *out, uint64_t *ct0, uint32_t num_samples,
+                       uint32_t level, uint32_t base_log,
+                       uint32_t input_lwe_dim, uint32_t output_lwe_dim,
+                       uint32_t ksk_index, uint32_t gpu_idx, bool keep,
+                       mlir::concretelang::RuntimeContext *context) {
+  size_t ct0_batch_size = num_samples * (input_lwe_dim + 1) * sizeof(uint64_t);
+  size_t out_batch_size =
+      num_samples * (output_lwe_dim + 1) * sizeof(uint64_t);
+
+  // The stream and device buffers are reused across calls
+  auto *gpu = context->acquire_gpu_state(gpu_idx);
+  auto stream = (cudaStream_t)gpu->stream;
+  // Get the pointer on the keyswitching key on the GPU
+  void *ksk_gpu =
+      memcpy_async_ksk_to_gpu(context, level, input_lwe_dim, output_lwe_dim,
+                              gpu_idx, stream, ksk_index);
+  // Move the input batch of ciphertexts to the GPU
+  void *ct0_gpu = get_input_on_gpu(context, gpu, ct0, ct0_batch_size);
+  void *indexes_gpu = gpu->get_identity_indexes(num_samples);
+  void *out_gpu = get_output_on_gpu(gpu, out_batch_size, keep);
+  // Run the keyswitch kernel on the GPU
+  cuda_keyswitch_lwe_ciphertext_vector_64(
+      stream, gpu_idx, out_gpu, indexes_gpu, ct0_gpu, indexes_gpu, ksk_gpu,
+      input_lwe_dim, output_lwe_dim, base_log, level, num_samples);
+  // Copy the output batch of ciphertext back to CPU
+  finish_output_on_gpu(context, gpu, out, out_gpu, out_batch_size, keep);
+  context->release_gpu_state(gpu);
+}
+
+/// Queues the bootstrap of the `num_samples` ciphertexts of `ct0_gpu` into
+/// `out_gpu` on the stream of `gpu`, `tlu` holding either a single lookup
+/// table or one per ciphertext. Returns the host copy of the glwe
+/// accumulators to free once the stream is synchronized, if they could not
+/// be cached on the device.
+static uint64_t *
+enqueue_bootstrap_lwe_cuda_u64(mlir::concretelang::GPUWrapperState *gpu,
+                               void *out_gpu, void *ct0_gpu,
+                               const uint64_t *tlu, uint32_t num_lut_vectors,
+                               uint32_t num_samples, uint32_t input_lwe_dim,
+                               uint32_t poly_size, uint32_t level,
+                               uint32_t base_log, uint32_t glwe_dim,
+                               uint32_t bsk_index,
+                               mlir::concretelang::RuntimeContext *context) {
+  using mlir::concretelang::GPUWrapperState;
+  uint32_t gpu_idx = gpu->gpu_idx;
+  auto stream = (cudaStream_t)gpu->stream;
+  // Get the pointer on the bootstraping key on the GPU
+  void *fbsk_gpu =
+      memcpy_async_bsk_to_gpu(context, input_lwe_dim, poly_size, level,
+                              glwe_dim, gpu_idx, stream, bsk_index);
+  // The glwe accumulators are uploaded once per distinct lookup tables
+  void *glwe_ct_gpu = context->get_accumulator_gpu(
+      tlu, num_lut_vectors, glwe_dim, poly_size, gpu_idx, stream);
+  uint64_t *glwe_ct = nullptr;
+  if (glwe_ct_gpu == nullptr) {
+    // The cache is full, construct the glwe accumulator on CPU for this call
+    uint64_t glwe_ct_size = poly_size * (glwe_dim + 1) * num_lut_vectors;
+    glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
+    for (size_t l = 0; l < num_lut_vectors; ++l)
+      concretelang::lut::trivialGlweAccumulator(
+          glwe_ct + l * poly_size * (glwe_dim + 1), tlu + l * poly_size,
+          glwe_dim, poly_size);
+    // Move the glwe accumulator to the GPU
+    glwe_ct_gpu = gpu->get_buffer(GPUWrapperState::ACCUMULATOR,
+                                  glwe_ct_size * sizeof(uint64_t));
+    cuda_memcpy_async_to_gpu(glwe_ct_gpu, glwe_ct,
+                             glwe_ct_size * sizeof(uint64_t), stream, gpu_idx);
+  }
+
+  // The test vector indexes are all 0 for a single lookup table
+  void *test_vector_idxes_gpu;
+  if (num_lut_vectors == 1) {
+    test_vector_idxes_gpu = gpu->get_zero_indexes(num_samples);
+  } else {
+    assert(num_lut_vectors == num_samples);
+    test_vector_idxes_gpu = gpu->get_identity_indexes(num_samples);
+  }
+  void *indexes_gpu = gpu->get_identity_indexes(num_samples);
+
+  // Get the PBS buffer on GPU, multi-bit keys have their own bootstrap
+  uint32_t grouping_factor = context->bsk_grouping_factor(bsk_index);
+  int8_t *pbs_buffer =
+      gpu->get_pbs_buffer(glwe_dim, poly_size, level, num_samples,
+                          input_lwe_dim, grouping_factor);
+  // Run the bootstrap kernel on the GPU
+  if (grouping_factor > 1)
+    cuda_multi_bit_programmable_bootstrap_lwe_ciphertext_vector_64(
+        stream, gpu_idx, out_gpu, indexes_gpu, glwe_ct_gpu,
+        test_vector_idxes_gpu, ct0_gpu, indexes_gpu, fbsk_gpu, pbs_buffer,
+        input_lwe_dim, glwe_dim, poly_size, grouping_factor, base_log, level,
+        num_samples, 1, 1);
+  else
+    cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
+        stream, gpu_idx, out_gpu, indexes_gpu, glwe_ct_gpu,
+        test_vector_idxes_gpu, ct0_gpu, indexes_gpu, fbsk_gpu, pbs_buffer,
+        input_lwe_dim, glwe_dim, poly_size, base_log, level, num_samples, 1,
+        1);
+  return glwe_ct;
+}
+
+/// Bootstraps `num_samples` contiguous ciphertexts on the device `gpu_idx`,
+/// `tlu` holding either a single lookup table or one per ciphertext.
+static void
+bootstrap_lwe_cuda_u64(uint64_t *out, uint64_t *ct0, const uint64_t *tlu,
+                       uint32_t num_lut_vectors, uint32_t num_samples,
+                       uint32_t input_lwe_dim, uint32_t poly_size,
+                       uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+                       uint32_t bsk_index, uint32_t gpu_idx, bool keep,
+                       mlir::concretelang::RuntimeContext *context) {
+  size_t ct0_batch_size = num_samples * (input_lwe_dim + 1) * sizeof(uint64_t);
+  size_t out_batch_size =
+      num_samples * (glwe_dim * poly_size + 1) * sizeof(uint64_t);
+
+  // The stream and device buffers are reused across calls
+  auto *gpu = context->acquire_gpu_state(gpu_idx);
+  // Move the input batch of ciphertext to the GPU
+  void *ct0_gpu = get_input_on_gpu(context, gpu, ct0, ct0_batch_size);
+  void *out_gpu = get_output_on_gpu(gpu, out_batch_size, keep);
+  uint64_t *glwe_ct = enqueue_bootstrap_lwe_cuda_u64(
+      gpu, out_gpu, ct0_gpu, tlu, num_lut_vectors, num_samples, input_lwe_dim,
+      poly_size, level, base_log, glwe_dim, bsk_index, context);
+  // Copy the output batch of ciphertext back to CPU
+  finish_output_on_gpu(context, gpu, out, out_gpu, out_batch_size, keep);
+  context->release_gpu_state(gpu);
+  // Free the glwe accumulator (on CPU)
+  free(glwe_ct);
+}
+
+/// Keyswitches then bootstraps `num_samples` contiguous ciphertexts on the
+/// device `gpu_idx`. Both kernels are queued on the same stream and the
+/// keyswitched ciphertexts stay in device memory, so the input and the
+/// output are the only transfers and the stream is synchronized once.
+static void keyswitch_bootstrap_lwe_cuda_u64(
+    uint64_t *out, uint64_t *ct0, const uint64_t *tlu, uint32_t num_samples,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    uint32_t gpu_idx, bool keep, mlir::concretelang::RuntimeContext *context) {
+  using mlir::concretelang::GPUWrapperState;
+  size_t ct0_batch_size =
+      num_samples * (ks_input_lwe_dim + 1) * sizeof(uint64_t);
+  size_t ks_batch_size =
+      num_samples * (ks_output_lwe_dim + 1) * sizeof(uint64_t);
+  size_t out_batch_size =
+      num_samples * (glwe_dim * poly_size + 1) * sizeof(uint64_t);
+
+  // The stream and device buffers are reused across calls
+  auto *gpu = context->acquire_gpu_state(gpu_idx);
+  auto stream = (cudaStream_t)gpu->stream;
+  void *ksk_gpu =
+      memcpy_async_ksk_to_gpu(context, ks_level, ks_input_lwe_dim,
+                              ks_output_lwe_dim, gpu_idx, stream, ksk_index);
+  void *ct0_gpu = get_input_on_gpu(context, gpu, ct0, ct0_batch_size);
+  void *ks_gpu = gpu->get_buffer(GPUWrapperState::KEYSWITCHED, ks_batch_size);
+  void *indexes_gpu = gpu->get_identity_indexes(num_samples);
+  cuda_keyswitch_lwe_ciphertext_vector_64(
+      stream, gpu_idx, ks_gpu, indexes_gpu, ct0_gpu, indexes_gpu, ksk_gpu,
+      ks_input_lwe_dim, ks_output_lwe_dim, ks_base_log, ks_level, num_samples);
+  // The bootstrap reads the keyswitched ciphertexts after the keyswitch, as
+  // the kernels run in the order of the stream
+  void *out_gpu = get_output_on_gpu(gpu, out_batch_size, keep);
+  uint64_t *glwe_ct = enqueue_bootstrap_lwe_cuda_u64(
+      gpu, out_gpu, ks_gpu, tlu, 1, num_samples, ks_output_lwe_dim, poly_size,
+      level, base_log, glwe_dim, bsk_index, context);
+  finish_output_on_gpu(context, gpu, out, out_gpu, out_batch_size, keep);
+  context->release_gpu_state(gpu);
+  free(glwe_ct);
+}
+
 void memref_batched_keyswitch_lwe_cuda_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -113,50 +421,20 @@ void memref_batched_keyswitch_lwe_cuda_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
     uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
     uint32_t ksk_index, mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH, ksk_index, -1, out_size0,
+      true);
   assert(out_size0 == ct0_size0);
   assert(out_size1 == output_lwe_dim + 1);
   assert(ct0_size1 == input_lwe_dim + 1);
-  // TODO: Multi GPU
-  uint32_t gpu_idx = 0;
-  uint32_t num_samples = out_size0;
-  uint64_t ct0_batch_size = ct0_size0 * ct0_size1;
-  uint64_t out_batch_size = out_size0 * out_size1;
-
-  // Create the cuda stream
-  // TODO: Should be created by the compiler codegen
-  void *stream = cuda_create_stream(gpu_idx);
-  // Get the pointer on the keyswitching key on the GPU
-  void *ksk_gpu =
-      memcpy_async_ksk_to_gpu(context, level, input_lwe_dim, output_lwe_dim,
-                              gpu_idx, stream, ksk_index);
-  // Move the input and output batch of ciphertexts to the GPU
-  // TODO: The allocation should be done by the compiler codegen
-  void *ct0_gpu = alloc_and_memcpy_async_to_gpu(
-      ct0_aligned, ct0_offset, ct0_batch_size, gpu_idx, (cudaStream_t)stream);
-  // Initialize indexes
-  uint64_t *indexes = (uint64_t *)malloc(num_samples * sizeof(uint64_t));
-  for (uint32_t i = 0; i < num_samples; i++) {
-    indexes[i] = i;
-  }
-  void *indexes_gpu =
-      alloc_and_memcpy_async_to_gpu(indexes, 0, num_samples * sizeof(uint64_t),
-                                    gpu_idx, (cudaStream_t)stream);
-  void *out_gpu = cuda_malloc_async(out_batch_size * sizeof(uint64_t),
-                                    (cudaStream_t)stream, gpu_idx);
-  // Run the keyswitch kernel on the GPU
-  cuda_keyswitch_lwe_ciphertext_vector_64(
-      stream, gpu_idx, out_gpu, indexes_gpu, ct0_gpu, indexes_gpu, ksk_gpu,
-      input_lwe_dim, output_lwe_dim, base_log, level, num_samples);
-  // Copy the output batch of ciphertext back to CPU
-  memcpy_async_to_cpu(out_aligned, out_offset, out_batch_size, out_gpu, gpu_idx,
-                      stream);
-  cuda_synchronize_device(gpu_idx);
-  // free memory that we allocated on gpu
-  cuda_drop(indexes_gpu, gpu_idx);
-  cuda_drop(ct0_gpu, gpu_idx);
-  cuda_drop(out_gpu, gpu_idx);
-  cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
-  free(indexes);
+  split_batch_across_gpus(
+      context, out_aligned + out_offset, ct0_aligned + ct0_offset, out_size0,
+      [&](uint32_t gpu_idx, uint32_t first, uint32_t n, bool keep) {
+        keyswitch_lwe_cuda_u64(out_aligned + out_offset + first * out_size1,
+                               ct0_aligned + ct0_offset + first * ct0_size1, n,
+                               level, base_log, input_lwe_dim, output_lwe_dim,
+                               ksk_index, gpu_idx, keep, context);
+      });
 }
 
 void memref_batched_bootstrap_lwe_cuda_u64(
@@ -169,88 +447,20 @@ void memref_batched_bootstrap_lwe_cuda_u64(
     uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
     uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index, out_size0,
+      true);
   assert(out_size0 == ct0_size0);
   assert(out_size1 == glwe_dim * poly_size + 1);
-  // TODO: Multi GPU
-  uint32_t gpu_idx = 0;
-  uint32_t num_samples = out_size0;
-  uint64_t ct0_batch_size = ct0_size0 * ct0_size1;
-  uint64_t out_batch_size = out_size0 * out_size1;
-  int8_t *pbs_buffer = nullptr;
-
-  // Create the cuda stream
-  // TODO: Should be created by the compiler codegen
-  void *stream = cuda_create_stream(gpu_idx);
-  // Get the pointer on the bootstraping key on the GPU
-  void *fbsk_gpu =
-      memcpy_async_bsk_to_gpu(context, input_lwe_dim, poly_size, level,
-                              glwe_dim, gpu_idx, stream, bsk_index);
-  // Move the input and output batch of ciphertext to the GPU
-  // TODO: The allocation should be done by the compiler codegen
-  void *ct0_gpu = alloc_and_memcpy_async_to_gpu(
-      ct0_aligned, ct0_offset, ct0_batch_size, gpu_idx, (cudaStream_t)stream);
-  void *out_gpu = cuda_malloc_async(out_batch_size * sizeof(uint64_t),
-                                    (cudaStream_t)stream, gpu_idx);
-  // Construct the glwe accumulator (on CPU)
-  // TODO: Should be done outside of the bootstrap call, compile time if
-  // possible. Refactor in progress
-  uint64_t glwe_ct_size = poly_size * (glwe_dim + 1);
-  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
-  auto tlu = tlu_aligned + tlu_offset;
-
-  // Glwe trivial encryption
-  for (size_t i = 0; i < poly_size * glwe_dim; i++) {
-    glwe_ct[i] = 0;
-  }
-  for (size_t i = 0; i < poly_size; i++) {
-    glwe_ct[poly_size * glwe_dim + i] = tlu[i];
-  }
-
-  // Move the glwe accumulator to the GPU
-  void *glwe_ct_gpu = alloc_and_memcpy_async_to_gpu(
-      glwe_ct, 0, glwe_ct_size, gpu_idx, (cudaStream_t)stream);
-
-  // Move test vector indexes to the GPU, the test vector indexes is set of 0
-  uint32_t num_test_vectors = 1, lwe_idx = 0,
-           test_vector_idxes_size = num_samples * sizeof(uint64_t);
-  void *test_vector_idxes = malloc(test_vector_idxes_size);
-  memset(test_vector_idxes, 0, test_vector_idxes_size);
-  void *test_vector_idxes_gpu =
-      cuda_malloc_async(test_vector_idxes_size, (cudaStream_t)stream, gpu_idx);
-  cuda_memcpy_async_to_gpu(test_vector_idxes_gpu, test_vector_idxes,
-                           test_vector_idxes_size, (cudaStream_t)stream,
-                           gpu_idx);
-  // Initialize indexes
-  uint64_t *indexes = (uint64_t *)malloc(num_samples * sizeof(uint64_t));
-  for (uint32_t i = 0; i < num_samples; i++) {
-    indexes[i] = i;
-  }
-  void *indexes_gpu =
-      alloc_and_memcpy_async_to_gpu(indexes, 0, num_samples * sizeof(uint64_t),
-                                    gpu_idx, (cudaStream_t)stream);
-  // Allocate PBS buffer on GPU
-  scratch_cuda_programmable_bootstrap_64(stream, gpu_idx, &pbs_buffer, glwe_dim,
-                                         poly_size, level, num_samples, true);
-  // Run the bootstrap kernel on the GPU
-  cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
-      stream, gpu_idx, out_gpu, indexes_gpu, glwe_ct_gpu, test_vector_idxes_gpu,
-      ct0_gpu, indexes_gpu, fbsk_gpu, pbs_buffer, input_lwe_dim, glwe_dim,
-      poly_size, base_log, level, num_samples, 1, 1);
-  cleanup_cuda_programmable_bootstrap(stream, gpu_idx, &pbs_buffer);
-  // Copy the output batch of ciphertext back to CPU
-  memcpy_async_to_cpu(out_aligned, out_offset, out_batch_size, out_gpu, gpu_idx,
-                      stream);
-  // free memory that we allocated on gpu
-  cuda_drop_async(indexes_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(ct0_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(out_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(glwe_ct_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(test_vector_idxes_gpu, (cudaStream_t)stream, gpu_idx);
-  cudaStreamSynchronize((cudaStream_t)stream);
-  // Free the glwe accumulator (on CPU)
-  free(glwe_ct);
-  free(indexes);
-  cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+  split_batch_across_gpus(
+      context, out_aligned + out_offset, ct0_aligned + ct0_offset, out_size0,
+      [&](uint32_t gpu_idx, uint32_t first, uint32_t n, bool keep) {
+        bootstrap_lwe_cuda_u64(out_aligned + out_offset + first * out_size1,
+                               ct0_aligned + ct0_offset + first * ct0_size1,
+                               tlu_aligned + tlu_offset, 1, n, input_lwe_dim,
+                               poly_size, level, base_log, glwe_dim, bsk_index,
+                               gpu_idx, keep, context);
+      });
 }
 
 void memref_batched_mapped_bootstrap_lwe_cuda_u64(
@@ -264,100 +474,209 @@ void memref_batched_mapped_bootstrap_lwe_cuda_u64(
     uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index, out_size0,
+      true);
   assert(out_size0 == ct0_size0);
   assert(out_size1 == glwe_dim * poly_size + 1);
   assert((out_size0 == tlu_size0 || tlu_size0 == 1) &&
          "Number of LUTs does not match batch size");
-  // TODO: Multi GPU
+  // With one lookup table per ciphertext, each device gets the ones of its
+  // chunk
+  bool shared_lut = tlu_size0 == 1;
+  split_batch_across_gpus(
+      context, out_aligned + out_offset, ct0_aligned + ct0_offset, out_size0,
+      [&](uint32_t gpu_idx, uint32_t first, uint32_t n, bool keep) {
+        bootstrap_lwe_cuda_u64(
+            out_aligned + out_offset + first * out_size1,
+            ct0_aligned + ct0_offset + first * ct0_size1,
+            tlu_aligned + tlu_offset + (shared_lut ? 0 : first * tlu_size1),
+            shared_lut ? 1 : n, n, input_lwe_dim, poly_size, level, base_log,
+            glwe_dim, bsk_index, gpu_idx, keep, context);
+      });
+}
+
+void memref_batched_keyswitch_bootstrap_lwe_cuda_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t ks_level, uint32_t ks_base_log,
+    uint32_t ks_input_lwe_dim, uint32_t ks_output_lwe_dim, uint32_t ksk_index,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH_BOOTSTRAP, ksk_index,
+      bsk_index, out_size0, true);
+  assert(out_size0 == ct0_size0);
+  assert(out_size1 == glwe_dim * poly_size + 1);
+  assert(ct0_size1 == ks_input_lwe_dim + 1);
+  split_batch_across_gpus(
+      context, out_aligned + out_offset, ct0_aligned + ct0_offset, out_size0,
+      [&](uint32_t gpu_idx, uint32_t first, uint32_t n, bool keep) {
+        keyswitch_bootstrap_lwe_cuda_u64(
+            out_aligned + out_offset + first * out_size1,
+            ct0_aligned + ct0_offset + first * ct0_size1,
+            tlu_aligned + tlu_offset, n, ks_level, ks_base_log,
+            ks_input_lwe_dim, ks_output_lwe_dim, ksk_index, poly_size, level,
+            base_log, glwe_dim, bsk_index, gpu_idx, keep, context);
+      });
+}
+
+// WoP-PBS CUDA function /////////////////////////////////////////////////////
+
+void memref_wop_pbs_crt_buffer_cuda(
+    // Output 2D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_stride_0,
+    uint64_t out_stride_1,
+    // Input 2D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_stride_0,
+    uint64_t in_stride_1,
+    // clear text lut 1D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key Indices,
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evaluation keys
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::WOP_PBS, ksk_index, bsk_index, 1,
+      true);
+  // Same layout as memref_wop_pbs_crt_buffer
+  assert(out_stride_1 == 1);
+  assert(out_stride_0 == out_size_1);
+  assert(in_stride_0 == in_size_1 && in_stride_1 == 1);
+  assert(out_size_0 == in_size_0 && out_size_0 == crt_decomp_size);
+  assert(out_size_1 == in_size_1);
+  assert(lut_ct_size0 == out_size_0 && lut_ct_stride0 == lut_ct_size1);
+
+  uint64_t *in = in_aligned + in_offset;
+  uint64_t *out = out_aligned + out_offset;
+  const uint64_t *crt_decomp = crt_decomp_aligned + crt_decomp_offset;
+  uint32_t lwe_big_dim = in_size_1 - 1;
+  uint64_t lwe_big_size = lwe_big_dim + 1;
+  uint64_t lwe_small_size = lwe_small_dim + 1;
+  assert(lwe_big_dim % polynomial_size == 0);
+  uint32_t glwe_dim = lwe_big_dim / polynomial_size;
+
+  std::vector<uint64_t> number_of_bits_per_block(crt_decomp_size);
+  std::vector<uint64_t> extract_bits_output_offsets(crt_decomp_size);
+  uint64_t total_number_of_bits_per_block =
+      crt_bits_to_extract(crt_decomp, crt_decomp_size,
+                          number_of_bits_per_block.data(),
+                          extract_bits_output_offsets.data());
+  assert(lut_ct_size1 == (size_t)1 << total_number_of_bits_per_block);
+
+  // The shift of the bit extraction is applied to a host copy of the input,
+  // which must then be up to date
+  context->copy_to_host(in);
+  context->release_on_device(out);
+  std::vector<uint64_t> in_copy(in, in + crt_decomp_size * lwe_big_size);
+  for (size_t i = 0; i < crt_decomp_size; i++)
+    in_copy[lwe_big_size * i + lwe_big_size - 1] -=
+        bit_extraction_shift(number_of_bits_per_block[i]);
+
   uint32_t gpu_idx = 0;
-  uint32_t num_samples = out_size0;
-  uint32_t num_lut_vectors = tlu_size0;
-  uint64_t ct0_batch_size = ct0_size0 * ct0_size1;
-  uint64_t out_batch_size = out_size0 * out_size1;
-  int8_t *pbs_buffer = nullptr;
-
-  // Create the cuda stream
-  // TODO: Should be created by the compiler codegen
-  void *stream = cuda_create_stream(gpu_idx);
-  // Get the pointer on the bootstraping key on the GPU
+  auto *gpu = context->acquire_gpu_state(gpu_idx);
+  auto stream = (cudaStream_t)gpu->stream;
+  uint32_t max_shared_memory = cuda_get_max_shared_memory(gpu_idx);
   void *fbsk_gpu =
-      memcpy_async_bsk_to_gpu(context, input_lwe_dim, poly_size, level,
-                              glwe_dim, gpu_idx, stream, bsk_index);
-  // Move the input and output batch of ciphertext to the GPU
-  // TODO: The allocation should be done by the compiler codegen
-  void *ct0_gpu = alloc_and_memcpy_async_to_gpu(
-      ct0_aligned, ct0_offset, ct0_batch_size, gpu_idx, (cudaStream_t)stream);
-  void *out_gpu = cuda_malloc_async(out_batch_size * sizeof(uint64_t),
-                                    (cudaStream_t)stream, gpu_idx);
-  // Construct the glwe accumulator (on CPU)
-  // TODO: Should be done outside of the bootstrap call, compile time if
-  // possible. Refactor in progress
-  uint64_t glwe_ct_size = poly_size * (glwe_dim + 1) * num_lut_vectors;
-  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
-  auto tlu = tlu_aligned + tlu_offset;
-
-  // Glwe trivial encryption
-  size_t pos = 0, postlu = 0;
-  for (size_t l = 0; l < num_lut_vectors; ++l) {
-    for (size_t i = 0; i < poly_size * glwe_dim; i++) {
-      glwe_ct[pos++] = 0;
-    }
-    for (size_t i = 0; i < poly_size; i++) {
-      glwe_ct[pos++] = tlu[postlu++];
-    }
+      memcpy_async_bsk_to_gpu(context, lwe_small_dim, polynomial_size,
+                              bsk_level_count, glwe_dim, gpu_idx, stream,
+                              bsk_index);
+  void *ksk_gpu =
+      memcpy_async_ksk_to_gpu(context, ksk_level_count, lwe_big_dim,
+                              lwe_small_dim, gpu_idx, stream, ksk_index);
+  void *fpksk_gpu = context->get_fpksk_gpu(gpu_idx, stream, pksk_index);
+
+  size_t in_size = in_copy.size() * sizeof(uint64_t);
+  void *in_gpu =
+      gpu->get_buffer(mlir::concretelang::GPUWrapperState::INPUT, in_size);
+  cuda_memcpy_async_to_gpu(in_gpu, in_copy.data(), in_size, stream, gpu_idx);
+  void *lut_gpu = alloc_and_memcpy_async_to_gpu(
+      lut_ct_aligned, lut_ct_offset, lut_ct_size0 * lut_ct_size1, gpu_idx,
+      stream);
+  uint64_t *bits_gpu = (uint64_t *)cuda_malloc_async(
+      lwe_small_size * total_number_of_bits_per_block * sizeof(uint64_t),
+      stream, gpu_idx);
+
+  // Extraction of the bits of each block, the blocks have their own numbers
+  // of bits hence one kernel per block
+  int8_t *bit_extract_buffer = nullptr;
+  scratch_cuda_extract_bits_64(stream, gpu_idx, &bit_extract_buffer, glwe_dim,
+                               lwe_small_dim, polynomial_size, bsk_level_count,
+                               1, max_shared_memory, true);
+  for (size_t i = 0; i < crt_decomp_size; i++) {
+    uint32_t nb_bits_to_extract = number_of_bits_per_block[i];
+    cuda_extract_bits_64(
+        stream, gpu_idx,
+        bits_gpu + lwe_small_size * extract_bits_output_offsets[i],
+        (uint64_t *)in_gpu + lwe_big_size * i, bit_extract_buffer, ksk_gpu,
+        fbsk_gpu, nb_bits_to_extract, 64 - nb_bits_to_extract, lwe_big_dim,
+        lwe_small_dim, glwe_dim, polynomial_size, bsk_base_log,
+        bsk_level_count, ksk_base_log, ksk_level_count, 1, max_shared_memory);
   }
+  cleanup_cuda_extract_bits(stream, gpu_idx, &bit_extract_buffer);
+
+  // Circuit bootstrapping of the extracted bits and vertical packing of the
+  // lookup tables, one per output block
+  int8_t *cbs_vp_buffer = nullptr;
+  uint32_t cbs_delta_log;
+  scratch_cuda_circuit_bootstrap_vertical_packing_64(
+      stream, gpu_idx, &cbs_vp_buffer, &cbs_delta_log, glwe_dim, lwe_small_dim,
+      polynomial_size, cbs_level_count, total_number_of_bits_per_block,
+      lut_ct_size0, max_shared_memory, true);
+  size_t out_size = crt_decomp_size * lwe_big_size * sizeof(uint64_t);
+  void *out_gpu =
+      gpu->get_buffer(mlir::concretelang::GPUWrapperState::OUTPUT, out_size);
+  cuda_circuit_bootstrap_vertical_packing_64(
+      stream, gpu_idx, out_gpu, bits_gpu, fbsk_gpu, fpksk_gpu, lut_gpu,
+      cbs_vp_buffer, cbs_delta_log, polynomial_size, glwe_dim, lwe_small_dim,
+      bsk_level_count, bsk_base_log, fpksk_level_count, fpksk_base_log,
+      cbs_level_count, cbs_base_log, total_number_of_bits_per_block,
+      lut_ct_size0, max_shared_memory);
+  cleanup_cuda_circuit_bootstrap_vertical_packing(stream, gpu_idx,
+                                                  &cbs_vp_buffer);
+
+  cuda_memcpy_async_to_cpu(out, out_gpu, out_size, stream, gpu_idx);
+  cuda_drop_async(bits_gpu, stream, gpu_idx);
+  cuda_drop_async(lut_gpu, stream, gpu_idx);
+  cudaStreamSynchronize(stream);
+  context->release_gpu_state(gpu);
+}
 
-  // Move the glwe accumulator to the GPU
-  void *glwe_ct_gpu = alloc_and_memcpy_async_to_gpu(
-      glwe_ct, 0, glwe_ct_size, gpu_idx, (cudaStream_t)stream);
+// Device residency of ciphertext buffers ////////////////////////////////////
 
-  // Move test vector indexes to the GPU, the test vector indexes is set of 0
-  uint32_t lwe_idx = 0, test_vector_idxes_size = num_samples * sizeof(uint64_t);
-  uint64_t *test_vector_idxes = (uint64_t *)malloc(test_vector_idxes_size);
-  if (num_lut_vectors == 1) {
-    memset((void *)test_vector_idxes, 0, test_vector_idxes_size);
-  } else {
-    assert(num_lut_vectors == num_samples);
-    for (size_t i = 0; i < num_lut_vectors; ++i)
-      test_vector_idxes[i] = i;
-  }
-  void *test_vector_idxes_gpu =
-      cuda_malloc_async(test_vector_idxes_size, (cudaStream_t)stream, gpu_idx);
-  cuda_memcpy_async_to_gpu(test_vector_idxes_gpu, (void *)test_vector_idxes,
-                           test_vector_idxes_size, (cudaStream_t)stream,
-                           gpu_idx);
-  // Initialize indexes
-  uint64_t *indexes = (uint64_t *)malloc(num_samples * sizeof(uint64_t));
-  for (uint32_t i = 0; i < num_samples; i++) {
-    indexes[i] = i;
-  }
-  void *indexes_gpu =
-      alloc_and_memcpy_async_to_gpu(indexes, 0, num_samples * sizeof(uint64_t),
-                                    gpu_idx, (cudaStream_t)stream);
+void memref_keep_on_device_cuda_u64(
+    uint64_t *allocated, uint64_t *aligned, uint64_t offset, uint64_t size,
+    uint64_t stride, mlir::concretelang::RuntimeContext *context) {
+  context->keep_on_device(aligned + offset);
+}
 
-  // Allocate PBS buffer on GPU
-  scratch_cuda_programmable_bootstrap_64(stream, gpu_idx, &pbs_buffer, glwe_dim,
-                                         poly_size, level, num_samples, true);
-  // Run the bootstrap kernel on the GPU
-  cuda_programmable_bootstrap_lwe_ciphertext_vector_64(
-      stream, gpu_idx, out_gpu, indexes_gpu, glwe_ct_gpu, test_vector_idxes_gpu,
-      ct0_gpu, indexes_gpu, fbsk_gpu, pbs_buffer, input_lwe_dim, glwe_dim,
-      poly_size, base_log, level, num_samples, 1, 1);
-  cleanup_cuda_programmable_bootstrap(stream, gpu_idx, &pbs_buffer);
-  // Copy the output batch of ciphertext back to CPU
-  memcpy_async_to_cpu(out_aligned, out_offset, out_batch_size, out_gpu, gpu_idx,
-                      stream);
-  // free memory that we allocated on gpu
-  cuda_drop_async(indexes_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(ct0_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(out_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(glwe_ct_gpu, (cudaStream_t)stream, gpu_idx);
-  cuda_drop_async(test_vector_idxes_gpu, (cudaStream_t)stream, gpu_idx);
-  cudaStreamSynchronize((cudaStream_t)stream);
-  // Free the glwe accumulator (on CPU)
-  free(indexes);
-  free(glwe_ct);
-  cuda_destroy_stream((cudaStream_t)stream, gpu_idx);
+void memref_copy_to_host_cuda_u64(
+    uint64_t *allocated, uint64_t *aligned, uint64_t offset, uint64_t size,
+    uint64_t stride, mlir::concretelang::RuntimeContext *context) {
+  context->copy_to_host(aligned + offset);
+}
+
+void memref_release_on_device_cuda_u64(
+    uint64_t *allocated, uint64_t *aligned, uint64_t offset, uint64_t size,
+    uint64_t stride, mlir::concretelang::RuntimeContext *context) {
+  context->release_on_device(aligned + offset);
 }
 
 #endif
@@ -397,54 +716,33 @@ void memref_encode_expand_lut_for_bootstrap(
   assert(output_lut_stride == 1 && "Runtime: stride not equal to 1, check "
                                    "memref_encode_expand_lut_bootstrap");
 
-  size_t mega_case_size = output_lut_size / input_lut_size;
-
-  assert((mega_case_size % 2) == 0);
-
-  // When the bootstrap is executed on encrypted signed integers, the lut must
-  // be half-rotated. This map takes care about properly indexing into the input
-  // lut depending on what bootstrap gets executed.
-  std::function<size_t(size_t)> indexMap;
-  if (is_signed) {
-    size_t halfInputSize = input_lut_size / 2;
-    indexMap = [=](size_t idx) {
-      if (idx < halfInputSize) {
-        return idx + halfInputSize;
-      } else {
-        return idx - halfInputSize;
-      }
-    };
-  } else {
-    indexMap = [=](size_t idx) { return idx; };
-  }
-
-  // The first lut value should be centered over zero. This means that half of
-  // it should appear at the beginning of the output lut, and half of it at the
-  // end (but negated).
-  for (size_t idx = 0; idx < mega_case_size / 2; ++idx) {
-    output_lut_aligned[output_lut_offset + idx] =
-        input_lut_aligned[input_lut_offset + indexMap(0)]
-        << (64 - out_MESSAGE_BITS - 1);
-  }
-  for (size_t idx = (input_lut_size - 1) * mega_case_size + mega_case_size / 2;
-       idx < output_lut_size; ++idx) {
-    output_lut_aligned[output_lut_offset + idx] =
-        -(input_lut_aligned[input_lut_offset + indexMap(0)]
-          << (64 - out_MESSAGE_BITS - 1));
-  }
-
-  // Treats the other ut values.
-  for (size_t lut_idx = 1; lut_idx < input_lut_size; ++lut_idx) {
-    uint64_t lut_value = input_lut_aligned[input_lut_offset + indexMap(lut_idx)]
-                         << (64 - out_MESSAGE_BITS - 1);
-    size_t start = mega_case_size * (lut_idx - 1) + mega_case_size / 2;
-    for (size_t output_idx = start; output_idx < start + mega_case_size;
-         ++output_idx) {
-      output_lut_aligned[output_lut_offset + output_idx] = lut_value;
-    }
-  }
+  concretelang::lut::encodeExpandLutForBootstrap(
+      output_lut_aligned + output_lut_offset, output_lut_size,
+      input_lut_aligned + input_lut_offset, input_lut_size, out_MESSAGE_BITS,
+      is_signed);
+}
 
-  return;
+void memref_encode_expand_many_lut_for_bootstrap(
+    uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
+    uint64_t output_lut_offset, uint64_t output_lut_size,
+    uint64_t output_lut_stride, uint64_t *input_luts_allocated,
+    uint64_t *input_luts_aligned, uint64_t input_luts_offset,
+    uint64_t input_luts_size0, uint64_t input_luts_size1,
+    uint64_t input_luts_stride0, uint64_t input_luts_stride1,
+    uint32_t poly_size, uint32_t out_MESSAGE_BITS, bool is_signed) {
+
+  assert(input_luts_stride1 == 1 && input_luts_stride0 == input_luts_size1 &&
+         "Runtime: input luts are not contiguous, check "
+         "memref_encode_expand_many_lut_for_bootstrap");
+
+  assert(output_lut_stride == 1 &&
+         "Runtime: stride not equal to 1, check "
+         "memref_encode_expand_many_lut_for_bootstrap");
+
+  concretelang::lut::encodeExpandManyLutForBootstrap(
+      output_lut_aligned + output_lut_offset, output_lut_size,
+      input_luts_aligned + input_luts_offset, input_luts_size0,
+      input_luts_size1, out_MESSAGE_BITS, is_signed);
 }
 
 void memref_encode_lut_for_crt_woppbs(
@@ -477,102 +775,12 @@ void memref_encode_lut_for_crt_woppbs(
 
   assert(modulus_product >= input_lut_size);
 
-  // Initialize lut cases not supposed to be reached
-  for (uint64_t i = 0; i < output_lut_size0 * output_lut_size1; i++) {
-    output_lut_aligned[output_lut_offset + i] = 0;
-  }
-
-  // When the woppbs is executed on encrypted signed integers, the index of the
-  // lut elements must be adapted to fit the way signed are encrypted in CRT
-  // (to ensure the lookup falls into the proper case).
-  // This map takes care about properly indexing into the output lut depending
-  // on what bootstrap gets executed.
-  std::function<uint64_t(uint64_t)> indexMap;
-  if (!is_signed) {
-    // When not signed, the integer values are encoded in increasing order. That
-    // is (example of 9 bits values, using crt decomposition [5,7,16]):
-    //
-    // |0     511|
-    // |---------|
-    // |0     511|
-    //
-    // is encoded as
-    //
-    // |0   511|  INVALID  |
-    // |-------|-----------|
-    // |0   511|512     559|
-    //
-    // Where on top are represented the semantic values, and below, the actual
-    // encoding of values, either on uint64_t or as increasing crt values.
-    //
-    // As a consequence, there is nothing particular to do to map the index of
-    // the input lut to an index of the output lut.
-    indexMap = [=](uint64_t plaintext) { return plaintext; };
-  } else {
-    // When signed, the integer values are encoded in a way that resembles 2s
-    // complement. That is (example of 9 bits values, using crt decomposition
-    // [5,7,16]):
-    //
-    // |0     255|-256    -1|
-    // |---------|----------|
-    // |0     255|256    511|
-    //
-    // is encoded as
-    //
-    // |0     255|   INVALID   |-256    -1|
-    // |---------|-------------|----------|
-    // |0     255|256       303|304    559|
-    //
-    // Where on top are represented the semantic values, and below, the actual
-    // encoding of values, either on uint64_t or as increasing crt values.
-    //
-    // As a consequence, to map the index of the input lut to an index of the
-    // output lut we must take care of crossing the invalid range in between
-    // positive values and negative values.
-    indexMap = [=](uint64_t plaintext) {
-      if (plaintext >= (input_lut_size / 2)) {
-        plaintext += modulus_product - input_lut_size;
-      }
-      return plaintext;
-    };
-  }
-
-  uint64_t log_lut_crt_size = 0;
-
-  for (size_t in_block = 0; in_block < crt_decomposition_size; in_block++) {
-    auto bits_count = crt_bits_aligned[crt_bits_offset + in_block];
-    log_lut_crt_size += bits_count;
-  }
-
-  uint64_t lut_crt_size = 1 << log_lut_crt_size;
-  assert(lut_crt_size == output_lut_size1);
-  assert(crt_decomposition_size == output_lut_size0);
-
-  for (uint64_t in_index = 0; in_index < input_lut_size; in_index++) {
-    uint64_t out_index = 0;
-
-    {
-      uint64_t total_bit_count = 0;
-      for (size_t in_block = 0; in_block < crt_decomposition_size; in_block++) {
-        auto in_base =
-            crt_decomposition_aligned[crt_decomposition_offset + in_block];
-        auto bits_count = crt_bits_aligned[crt_bits_offset + in_block];
-        out_index += (((indexMap(in_index) % in_base) << bits_count) / in_base)
-                     << total_bit_count;
-        total_bit_count += bits_count;
-      }
-    }
-
-    for (size_t out_block = 0; out_block < crt_decomposition_size;
-         out_block++) {
-      auto out_base =
-          crt_decomposition_aligned[crt_decomposition_offset + out_block];
-      auto v = encode_crt(input_lut_aligned[input_lut_offset + in_index],
-                          out_base, modulus_product);
-      output_lut_aligned[output_lut_offset + out_block * lut_crt_size +
-                         out_index] = v;
-    }
-  }
+  concretelang::lut::encodeLutForCrtWopPBS(
+      output_lut_aligned + output_lut_offset, output_lut_size0,
+      output_lut_size1, input_lut_aligned + input_lut_offset, input_lut_size,
+      crt_decomposition_aligned + crt_decomposition_offset,
+      crt_bits_aligned + crt_bits_offset, crt_decomposition_size,
+      modulus_product, is_signed);
 }
 
 void memref_add_lwe_ciphertexts_u64(
@@ -581,12 +789,13 @@ void memref_add_lwe_ciphertexts_u64(
     uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
     uint64_t ct0_stride, uint64_t *ct1_allocated, uint64_t *ct1_aligned,
     uint64_t ct1_offset, uint64_t ct1_size, uint64_t ct1_stride) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1);
   assert(out_size == ct0_size && out_size == ct1_size &&
          "size of lwe buffer are incompatible");
-  size_t lwe_dimension = out_size - 1;
-  concrete_cpu_add_lwe_ciphertext_u64(out_aligned + out_offset,
-                                      ct0_aligned + ct0_offset,
-                                      ct1_aligned + ct1_offset, lwe_dimension);
+  mlir::concretelang::leveled::add(out_aligned + out_offset,
+                                   ct0_aligned + ct0_offset,
+                                   ct1_aligned + ct1_offset, out_size);
 }
 
 void memref_add_plaintext_lwe_ciphertext_u64(
@@ -594,11 +803,14 @@ void memref_add_plaintext_lwe_ciphertext_u64(
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
     uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
     uint64_t ct0_stride, uint64_t plaintext) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1);
   assert(out_size == ct0_size && "size of lwe buffer are incompatible");
-  size_t lwe_dimension = out_size - 1;
-  concrete_cpu_add_plaintext_lwe_ciphertext_u64(out_aligned + out_offset,
-                                                ct0_aligned + ct0_offset,
-                                                plaintext, lwe_dimension);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  if (out != ct0)
+    memcpy(out, ct0, out_size * sizeof(uint64_t));
+  out[out_size - 1] += plaintext;
 }
 
 void memref_mul_cleartext_lwe_ciphertext_u64(
@@ -606,11 +818,12 @@ void memref_mul_cleartext_lwe_ciphertext_u64(
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
     uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
     uint64_t ct0_stride, uint64_t cleartext) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1);
   assert(out_size == ct0_size && "size of lwe buffer are incompatible");
-  size_t lwe_dimension = out_size - 1;
-  concrete_cpu_mul_cleartext_lwe_ciphertext_u64(out_aligned + out_offset,
-                                                ct0_aligned + ct0_offset,
-                                                cleartext, lwe_dimension);
+  mlir::concretelang::leveled::mul(out_aligned + out_offset,
+                                   ct0_aligned + ct0_offset, cleartext,
+                                   out_size);
 }
 
 void memref_negate_lwe_ciphertext_u64(
@@ -618,10 +831,11 @@ void memref_negate_lwe_ciphertext_u64(
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
     uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
     uint64_t ct0_stride) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1);
   assert(out_size == ct0_size && "size of lwe buffer are incompatible");
-  size_t lwe_dimension = {out_size - 1};
-  concrete_cpu_negate_lwe_ciphertext_u64(
-      out_aligned + out_offset, ct0_aligned + ct0_offset, lwe_dimension);
+  mlir::concretelang::leveled::negate(out_aligned + out_offset,
+                                      ct0_aligned + ct0_offset, out_size);
 }
 
 void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
@@ -634,6 +848,8 @@ void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
                               uint32_t input_dimension,
                               uint32_t output_dimension, uint32_t ksk_index,
                               mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH, ksk_index, -1);
   assert(out_stride == 1 && ct0_stride == 1);
   // Get keyswitch key
   const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
@@ -652,13 +868,24 @@ void memref_batched_add_lwe_ciphertexts_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
     uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size0,
     uint64_t ct1_size1, uint64_t ct1_stride0, uint64_t ct1_stride1) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_add_lwe_ciphertexts_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        ct1_allocated + i * ct1_size1, ct1_aligned + i * ct1_size1, ct1_offset,
-        ct1_size1, ct1_stride1);
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size0 &&
+         out_size1 == ct0_size1 && out_size1 == ct1_size1 &&
+         "size of lwe buffers are incompatible");
+  assert(out_stride1 == 1 && ct0_stride1 == 1 && ct1_stride1 == 1);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  uint64_t *ct1 = ct1_aligned + ct1_offset;
+  if (out_stride0 == out_size1 && ct0_stride0 == ct0_size1 &&
+      ct1_stride0 == ct1_size1) {
+    mlir::concretelang::leveled::add(out, ct0, ct1, out_size0 * out_size1);
+    return;
+  }
+  for (size_t i = 0; i < out_size0; i++) {
+    mlir::concretelang::leveled::add(out + i * out_stride0,
+                                     ct0 + i * ct0_stride0,
+                                     ct1 + i * ct1_stride0, out_size1);
   }
 }
 
@@ -670,12 +897,13 @@ void memref_batched_add_plaintext_lwe_ciphertext_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
     uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
     uint64_t ct1_stride) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
   for (size_t i = 0; i < ct0_size0; i++) {
     memref_add_plaintext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        *(ct1_aligned + ct1_offset + i * ct1_stride));
+        out_allocated, out_aligned, out_offset + i * out_stride0, out_size1,
+        out_stride1, ct0_allocated, ct0_aligned, ct0_offset + i * ct0_stride0,
+        ct0_size1, ct0_stride1, *(ct1_aligned + ct1_offset + i * ct1_stride));
   }
 }
 
@@ -685,12 +913,13 @@ void memref_batched_add_plaintext_cst_lwe_ciphertext_u64(
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t plaintext) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
   for (size_t i = 0; i < ct0_size0; i++) {
     memref_add_plaintext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        plaintext);
+        out_allocated, out_aligned, out_offset + i * out_stride0, out_size1,
+        out_stride1, ct0_allocated, ct0_aligned, ct0_offset + i * ct0_stride0,
+        ct0_size1, ct0_stride1, plaintext);
   }
 }
 
@@ -702,12 +931,17 @@ void memref_batched_mul_cleartext_lwe_ciphertext_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *ct1_allocated,
     uint64_t *ct1_aligned, uint64_t ct1_offset, uint64_t ct1_size,
     uint64_t ct1_stride) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        *(ct1_aligned + ct1_offset + i * ct1_stride));
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size &&
+         out_size1 == ct0_size1 && "size of lwe buffers are incompatible");
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  for (size_t i = 0; i < out_size0; i++) {
+    mlir::concretelang::leveled::mul(
+        out + i * out_stride0, ct0 + i * ct0_stride0,
+        *(ct1_aligned + ct1_offset + i * ct1_stride), out_size1);
   }
 }
 
@@ -717,110 +951,446 @@ void memref_batched_mul_cleartext_cst_lwe_ciphertext_u64(
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_mul_cleartext_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1,
-        cleartext);
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
+  assert(out_size0 == ct0_size0 && out_size1 == ct0_size1 &&
+         "size of lwe buffers are incompatible");
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  if (out_stride0 == out_size1 && ct0_stride0 == ct0_size1) {
+    mlir::concretelang::leveled::mul(out, ct0, cleartext,
+                                     out_size0 * out_size1);
+    return;
+  }
+  for (size_t i = 0; i < out_size0; i++) {
+    mlir::concretelang::leveled::mul(out + i * out_stride0,
+                                     ct0 + i * ct0_stride0, cleartext,
+                                     out_size1);
   }
 }
 
-void memref_batched_negate_lwe_ciphertext_u64(
+void memref_batched_mul_cleartext_add_lwe_ciphertexts_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_negate_lwe_ciphertext_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1);
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *cleartexts_allocated,
+    uint64_t *cleartexts_aligned, uint64_t cleartexts_offset,
+    uint64_t cleartexts_size, uint64_t cleartexts_stride,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
+  assert(out_size0 == ct0_size0 && out_size0 == cleartexts_size &&
+         out_size0 == ct1_size0 && out_size1 == ct0_size1 &&
+         out_size1 == ct1_size1 && "size of lwe buffers are incompatible");
+  assert(out_stride1 == 1 && ct0_stride1 == 1 && ct1_stride1 == 1);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  uint64_t *ct1 = ct1_aligned + ct1_offset;
+  for (size_t i = 0; i < out_size0; i++) {
+    mlir::concretelang::leveled::mulAdd(
+        out + i * out_stride0, ct0 + i * ct0_stride0,
+        *(cleartexts_aligned + cleartexts_offset + i * cleartexts_stride),
+        ct1 + i * ct1_stride0, out_size1);
   }
 }
 
-void memref_batched_keyswitch_lwe_u64(
+void memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
-    uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
-    uint32_t ksk_index, mlir::concretelang::RuntimeContext *context) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_keyswitch_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1, level,
-        base_log, input_lwe_dim, output_lwe_dim, ksk_index, context);
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t cleartext,
+    uint64_t *ct1_allocated, uint64_t *ct1_aligned, uint64_t ct1_offset,
+    uint64_t ct1_size0, uint64_t ct1_size1, uint64_t ct1_stride0,
+    uint64_t ct1_stride1) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
+  assert(out_size0 == ct0_size0 && out_size0 == ct1_size0 &&
+         out_size1 == ct0_size1 && out_size1 == ct1_size1 &&
+         "size of lwe buffers are incompatible");
+  assert(out_stride1 == 1 && ct0_stride1 == 1 && ct1_stride1 == 1);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  uint64_t *ct1 = ct1_aligned + ct1_offset;
+  if (out_stride0 == out_size1 && ct0_stride0 == ct0_size1 &&
+      ct1_stride0 == ct1_size1) {
+    mlir::concretelang::leveled::mulAdd(out, ct0, cleartext, ct1,
+                                        out_size0 * out_size1);
+    return;
+  }
+  for (size_t i = 0; i < out_size0; i++) {
+    mlir::concretelang::leveled::mulAdd(out + i * out_stride0,
+                                        ct0 + i * ct0_stride0, cleartext,
+                                        ct1 + i * ct1_stride0, out_size1);
   }
 }
 
-void memref_bootstrap_lwe_u64(
+void memref_batched_negate_lwe_ciphertext_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
-    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
-    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
-    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
-    uint32_t input_lwe_dimension, uint32_t polynomial_size,
-    uint32_t decomposition_level_count, uint32_t decomposition_base_log,
-    uint32_t glwe_dimension, uint32_t bsk_index,
-    mlir::concretelang::RuntimeContext *context) {
-
-  uint64_t glwe_ct_size = polynomial_size * (glwe_dimension + 1);
-  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
-  auto tlu = tlu_aligned + tlu_offset;
-
-  // Glwe trivial encryption
-  for (size_t i = 0; i < polynomial_size * glwe_dimension; i++) {
-    glwe_ct[i] = 0;
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::LEVELED, -1, -1, out_size0);
+  assert(out_size0 == ct0_size0 && out_size1 == ct0_size1 &&
+         "size of lwe buffers are incompatible");
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  if (out_stride0 == out_size1 && ct0_stride0 == ct0_size1) {
+    mlir::concretelang::leveled::negate(out, ct0, out_size0 * out_size1);
+    return;
   }
-  for (size_t i = 0; i < polynomial_size; i++) {
-    glwe_ct[polynomial_size * glwe_dimension + i] = tlu[i];
+  for (size_t i = 0; i < out_size0; i++) {
+    mlir::concretelang::leveled::negate(out + i * out_stride0,
+                                        ct0 + i * ct0_stride0, out_size1);
   }
+}
 
-  // Get fourrier bootstrap key
-  const auto &fft = context->fft(bsk_index);
-  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
-  // Get stack parameter
-  size_t scratch_size;
-  size_t scratch_align;
-  concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
-      &scratch_size, &scratch_align, glwe_dimension, polynomial_size, fft);
-  // Allocate scratch
-  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-  // Bootstrap
-  concrete_cpu_bootstrap_lwe_ciphertext_u64(
-      out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
-      bootstrap_key, decomposition_level_count, decomposition_base_log,
-      glwe_dimension, polynomial_size, input_lwe_dimension, fft, scratch,
-      scratch_size);
+/// Copies `rows` rows of `size` words from `src` to `dst`, given their
+/// strides, with a single block copy when both are dense.
+static void copy_lwe_rows(uint64_t *dst, uint64_t dst_stride0,
+                          uint64_t dst_stride1, const uint64_t *src,
+                          uint64_t src_stride0, uint64_t src_stride1,
+                          uint64_t rows, uint64_t size) {
+  if (dst_stride1 == 1 && src_stride1 == 1) {
+    if (dst_stride0 == size && src_stride0 == size) {
+      memcpy(dst, src, rows * size * sizeof(uint64_t));
+      return;
+    }
+    for (uint64_t i = 0; i < rows; i++)
+      memcpy(dst + i * dst_stride0, src + i * src_stride0,
+             size * sizeof(uint64_t));
+    return;
+  }
+  for (uint64_t i = 0; i < rows; i++) {
+    for (uint64_t j = 0; j < size; j++)
+      dst[i * dst_stride0 + j * dst_stride1] =
+          src[i * src_stride0 + j * src_stride1];
+  }
+}
 
-  free(glwe_ct);
-  free(scratch);
+/// Returns the number of positions from `i` that follow each other, i.e.
+/// whose rows can be copied at once.
+static uint64_t consecutive_positions(const uint64_t *positions,
+                                      uint64_t stride, uint64_t size,
+                                      uint64_t i) {
+  uint64_t count = 1;
+  while (i + count < size &&
+         positions[(i + count) * stride] == positions[i * stride] + count)
+    count++;
+  return count;
 }
 
-void memref_batched_bootstrap_lwe_u64(
+void memref_gather_lwe_ciphertexts_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
-    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
-    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *positions_allocated,
+    uint64_t *positions_aligned, uint64_t positions_offset,
+    uint64_t positions_size, uint64_t positions_stride) {
+  assert(out_size0 == positions_size && out_size1 == ct0_size1 &&
+         "size of lwe buffers are incompatible");
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  uint64_t *positions = positions_aligned + positions_offset;
+  // Runs of consecutive positions are copied as a single block
+  for (uint64_t i = 0; i < out_size0;) {
+    uint64_t position = positions[i * positions_stride];
+    uint64_t count =
+        consecutive_positions(positions, positions_stride, out_size0, i);
+    assert(position + count <= ct0_size0 && "gather position out of range");
+    copy_lwe_rows(out + i * out_stride0, out_stride0, out_stride1,
+                  ct0 + position * ct0_stride0, ct0_stride0, ct0_stride1,
+                  count, out_size1);
+    i += count;
+  }
+}
+
+void memref_scatter_lwe_ciphertexts_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *values_allocated,
+    uint64_t *values_aligned, uint64_t values_offset, uint64_t values_size0,
+    uint64_t values_size1, uint64_t values_stride0, uint64_t values_stride1,
+    uint64_t *positions_allocated, uint64_t *positions_aligned,
+    uint64_t positions_offset, uint64_t positions_size,
+    uint64_t positions_stride) {
+  assert(out_size0 == ct0_size0 && out_size1 == ct0_size1 &&
+         values_size0 == positions_size && values_size1 == out_size1 &&
+         "size of lwe buffers are incompatible");
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  uint64_t *values = values_aligned + values_offset;
+  uint64_t *positions = positions_aligned + positions_offset;
+
+  // The values may be a view of the ciphertexts written in place, in which
+  // case they are read from a copy
+  std::vector<uint64_t> values_copy;
+  if (values_allocated == out_allocated) {
+    values_copy.resize(values_size0 * values_size1);
+    copy_lwe_rows(values_copy.data(), values_size1, 1, values, values_stride0,
+                  values_stride1, values_size0, values_size1);
+    values = values_copy.data();
+    values_stride0 = values_size1;
+    values_stride1 = 1;
+  }
+
+  if (out != ct0)
+    copy_lwe_rows(out, out_stride0, out_stride1, ct0, ct0_stride0,
+                  ct0_stride1, out_size0, out_size1);
+  for (uint64_t i = 0; i < values_size0;) {
+    uint64_t position = positions[i * positions_stride];
+    uint64_t count =
+        consecutive_positions(positions, positions_stride, values_size0, i);
+    assert(position + count <= out_size0 && "scatter position out of range");
+    copy_lwe_rows(out + position * out_stride0, out_stride0, out_stride1,
+                  values + i * values_stride0, values_stride0, values_stride1,
+                  count, out_size1);
+    i += count;
+  }
+}
+
+void memref_batched_keyswitch_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
+    uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
+    uint32_t ksk_index, mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH, ksk_index, -1,
+      ct0_size0);
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *ct0 = ct0_aligned + ct0_offset;
+  if (out_stride0 == out_size1 && ct0_stride0 == ct0_size1) {
+    concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+        out, ct0, ct0_size0, keyswitch_key, level, base_log, input_lwe_dim,
+        output_lwe_dim, Parallelism::No);
+    return;
+  }
+  // Views of bigger tensors, e.g. transposed or broadcasted, are keyswitched
+  // row by row
+  for (size_t i = 0; i < ct0_size0; i++) {
+    concrete_cpu_keyswitch_lwe_ciphertext_u64(
+        out + i * out_stride0, ct0 + i * ct0_stride0, keyswitch_key, level,
+        base_log, input_lwe_dim, output_lwe_dim);
+  }
+}
+
+/// A fourier bootstrap key of the context, stored in double precision or, if
+/// `compact` is not null, in single precision.
+struct FourierBootstrapKey {
+  const std::complex<double> *full;
+  const float *compact;
+};
+
+/// Fetches the fourier bootstrap key `bsk_index`, without expanding it to
+/// double precision if it is stored in single precision.
+static FourierBootstrapKey
+get_fourier_bootstrap_key(mlir::concretelang::RuntimeContext *context,
+                          uint32_t bsk_index) {
+  auto compact = context->compact_fourier_bootstrap_key_buffer(bsk_index);
+  if (compact != nullptr)
+    return {nullptr, compact};
+  return {context->fourier_bootstrap_key_buffer(bsk_index), nullptr};
+}
+
+/// Returns the replica on the NUMA node of the calling thread of
+/// `bootstrap_key`, the fourier bootstrap key `bsk_index` fetched with
+/// `get_fourier_bootstrap_key`. The batched wrappers fetch the key on the
+/// calling thread, then each OpenMP worker reads the replica of its node.
+static FourierBootstrapKey
+numa_local_bootstrap_key(mlir::concretelang::RuntimeContext *context,
+                         uint32_t bsk_index,
+                         FourierBootstrapKey bootstrap_key) {
+  if (bootstrap_key.compact != nullptr)
+    return {nullptr, context->numa_local_compact_fourier_bootstrap_key(
+                         bsk_index, bootstrap_key.compact)};
+  return {context->numa_local_fourier_bootstrap_key(bsk_index,
+                                                    bootstrap_key.full),
+          nullptr};
+}
+
+/// Bootstraps a single ciphertext with a prebuilt trivial GLWE accumulator,
+/// using an already fetched fourier bootstrap key and fft plan, so that
+/// batched callers only query the context once.
+static void bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out, uint64_t *ct0, const uint64_t *glwe_ct,
+    uint32_t input_lwe_dimension, uint32_t polynomial_size,
+    uint32_t decomposition_level_count, uint32_t decomposition_base_log,
+    uint32_t glwe_dimension, FourierBootstrapKey bootstrap_key,
+    const struct Fft *fft) {
+  auto &arena = mlir::concretelang::ScratchArena::local();
+
+  // Get stack parameter
+  size_t scratch_size;
+  size_t scratch_align;
+  if (bootstrap_key.compact != nullptr)
+    concrete_cpu_bootstrap_lwe_ciphertext_compact_u64_scratch(
+        &scratch_size, &scratch_align, decomposition_level_count,
+        glwe_dimension, polynomial_size, fft);
+  else
+    concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+        &scratch_size, &scratch_align, glwe_dimension, polynomial_size, fft);
+  auto scratch = arena.get(mlir::concretelang::ScratchArena::BOOTSTRAP,
+                           scratch_size, scratch_align);
+
+  // Bootstrap
+  if (bootstrap_key.compact != nullptr)
+    concrete_cpu_bootstrap_lwe_ciphertext_compact_u64(
+        out, ct0, glwe_ct, bootstrap_key.compact, decomposition_level_count,
+        decomposition_base_log, glwe_dimension, polynomial_size,
+        input_lwe_dimension, fft, scratch, scratch_size);
+  else
+    concrete_cpu_bootstrap_lwe_ciphertext_u64(
+        out, ct0, glwe_ct, bootstrap_key.full, decomposition_level_count,
+        decomposition_base_log, glwe_dimension, polynomial_size,
+        input_lwe_dimension, fft, scratch, scratch_size);
+}
+
+/// Bootstraps the `count` ciphertexts of `ct0`, `ct0_stride` integers apart,
+/// into `out`, `out_stride` integers apart, with the accumulators of
+/// `accumulators`, `accumulator_stride` integers apart (0 for a single
+/// accumulator). The batch is split in one contiguous chunk per OpenMP
+/// worker, each bootstrapped by a single call to the CPU backend that reuses
+/// its scratch for the whole chunk, or by single bootstraps sharing the
+/// scratch arena of the worker for the compact keys or the strided rows. When
+/// already running within a parallel region (e.g. a parallelized loop), stay
+/// sequential to avoid oversubscribing the cores. Each worker reads the
+/// replica of `bootstrap_key`, the key `bsk_index`, on its NUMA node.
+static void batched_bootstrap_lwe_u64(
+    uint64_t *out, uint64_t *ct0, size_t count, size_t out_lwe_size,
+    size_t ct0_lwe_size, size_t out_stride, size_t ct0_stride,
+    const uint64_t *accumulators,
+    size_t accumulator_stride, uint32_t input_lwe_dimension,
+    uint32_t polynomial_size, uint32_t decomposition_level_count,
+    uint32_t decomposition_base_log, uint32_t glwe_dimension,
+    FourierBootstrapKey shared_bootstrap_key, const struct Fft *fft,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context) {
+#pragma omp parallel if (count > 1 && !omp_in_parallel())
+  {
+    size_t threads = omp_get_num_threads();
+    size_t thread = omp_get_thread_num();
+    size_t begin = count * thread / threads;
+    size_t end = count * (thread + 1) / threads;
+    auto bootstrap_key =
+        numa_local_bootstrap_key(context, bsk_index, shared_bootstrap_key);
+    if (bootstrap_key.compact != nullptr || out_stride != out_lwe_size ||
+        ct0_stride != ct0_lwe_size) {
+      for (size_t i = begin; i < end; i++)
+        bootstrap_lwe_with_accumulator_u64(
+            out + i * out_stride, ct0 + i * ct0_stride,
+            accumulators + i * accumulator_stride, input_lwe_dimension,
+            polynomial_size, decomposition_level_count,
+            decomposition_base_log, glwe_dimension, bootstrap_key, fft);
+    } else if (begin < end) {
+      concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+          out + begin * out_lwe_size, ct0 + begin * ct0_lwe_size, end - begin,
+          accumulators + begin * accumulator_stride, accumulator_stride,
+          bootstrap_key.full, decomposition_level_count,
+          decomposition_base_log, glwe_dimension, polynomial_size,
+          input_lwe_dimension, fft, Parallelism::No);
+    }
+  }
+}
+
+/// Bootstraps a single ciphertext with the trivial GLWE encryption of the
+/// lookup table `tlu`.
+static void bootstrap_lwe_u64(uint64_t *out, uint64_t *ct0, uint64_t *tlu,
+                              uint32_t input_lwe_dimension,
+                              uint32_t polynomial_size,
+                              uint32_t decomposition_level_count,
+                              uint32_t decomposition_base_log,
+                              uint32_t glwe_dimension,
+                              FourierBootstrapKey bootstrap_key,
+                              const struct Fft *fft) {
+  auto &arena = mlir::concretelang::ScratchArena::local();
+
+  uint64_t glwe_ct_size = polynomial_size * (glwe_dimension + 1);
+  uint64_t *glwe_ct = arena.get<uint64_t>(
+      mlir::concretelang::ScratchArena::GLWE_ACCUMULATOR, glwe_ct_size);
+
+  // Glwe trivial encryption
+  concretelang::lut::trivialGlweAccumulator(glwe_ct, tlu, glwe_dimension,
+                                            polynomial_size);
+
+  bootstrap_lwe_with_accumulator_u64(out, ct0, glwe_ct, input_lwe_dimension,
+                                     polynomial_size,
+                                     decomposition_level_count,
+                                     decomposition_base_log, glwe_dimension,
+                                     bootstrap_key, fft);
+}
+
+void memref_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t input_lwe_dimension, uint32_t polynomial_size,
+    uint32_t decomposition_level_count, uint32_t decomposition_base_log,
+    uint32_t glwe_dimension, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index);
+
+  // Get fourrier bootstrap key
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
+
+  bootstrap_lwe_u64(out_aligned + out_offset, ct0_aligned + ct0_offset,
+                    tlu_aligned + tlu_offset, input_lwe_dimension,
+                    polynomial_size, decomposition_level_count,
+                    decomposition_base_log, glwe_dimension, bootstrap_key, fft);
+}
+
+void memref_batched_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
     uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
     uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index,
+      out_size0);
+  assert(out_size0 == ct0_size0 && "Input and output batch sizes differ");
+
+  // The keys are fetched once on the calling thread: on remote nodes
+  // of the distributed runtime this may require communication that
+  // must not happen from within the OpenMP workers, which only look up
+  // the replica of the key on their NUMA node.
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
 
-  for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated, tlu_aligned,
-        tlu_offset, tlu_size, tlu_stride, input_lwe_dim, poly_size, level,
-        base_log, glwe_dim, bsk_index, context);
-  }
+  // All the rows share the same lookup table, so its trivial GLWE
+  // accumulator is built once for the whole batch
+  uint64_t glwe_ct_size = poly_size * (glwe_dim + 1);
+  uint64_t *glwe_ct = mlir::concretelang::ScratchArena::local().get<uint64_t>(
+      mlir::concretelang::ScratchArena::GLWE_ACCUMULATOR, glwe_ct_size);
+  concretelang::lut::trivialGlweAccumulator(glwe_ct, tlu_aligned + tlu_offset,
+                                            glwe_dim, poly_size);
+
+  batched_bootstrap_lwe_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, out_size0,
+      out_size1, ct0_size1, out_stride0, ct0_stride0, glwe_ct, 0,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, bootstrap_key, fft,
+      bsk_index, context);
 }
 
 void memref_batched_mapped_bootstrap_lwe_u64(
@@ -834,141 +1404,555 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index,
+      out_size0);
   assert(out_size0 == tlu_size0 && "Number of LUTs does not match batch size");
+
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
+
+#pragma omp parallel for if (out_size0 > 1 && !omp_in_parallel())
   for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated,
-        tlu_aligned + i * tlu_size1, tlu_offset, tlu_size1, tlu_stride1,
-        input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index,
-        context);
+    bootstrap_lwe_u64(
+        out_aligned + out_offset + i * out_stride0,
+        ct0_aligned + ct0_offset + i * ct0_stride0,
+        tlu_aligned + tlu_offset + i * tlu_stride0, input_lwe_dim, poly_size,
+        level, base_log, glwe_dim,
+        numa_local_bootstrap_key(context, bsk_index, bootstrap_key), fft);
   }
 }
 
-uint64_t encode_crt(int64_t plaintext, uint64_t modulus, uint64_t product) {
-  return concretelang::crt::encode(plaintext, modulus, product);
+/// Keyswitches then bootstraps a single ciphertext, the small intermediate
+/// ciphertext living in the per-thread scratch arena. `tlu` is either the
+/// lookup table or, if `tlu_is_accumulator`, the trivial GLWE accumulator.
+static void keyswitch_bootstrap_lwe_u64(
+    uint64_t *out, uint64_t *ct0, uint64_t *tlu, bool tlu_is_accumulator,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, const uint64_t *keyswitch_key,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    FourierBootstrapKey bootstrap_key, const struct Fft *fft) {
+  uint64_t *ks_out = mlir::concretelang::ScratchArena::local().get<uint64_t>(
+      mlir::concretelang::ScratchArena::KEYSWITCH_OUTPUT,
+      ks_output_lwe_dim + 1);
+  concrete_cpu_keyswitch_lwe_ciphertext_u64(
+      ks_out, ct0, keyswitch_key, ks_level, ks_base_log, ks_input_lwe_dim,
+      ks_output_lwe_dim);
+  if (tlu_is_accumulator) {
+    bootstrap_lwe_with_accumulator_u64(out, ks_out, tlu, ks_output_lwe_dim,
+                                       poly_size, level, base_log, glwe_dim,
+                                       bootstrap_key, fft);
+  } else {
+    bootstrap_lwe_u64(out, ks_out, tlu, ks_output_lwe_dim, poly_size, level,
+                      base_log, glwe_dim, bootstrap_key, fft);
+  }
 }
 
-void memref_wop_pbs_crt_buffer(
-    // Output 2D memref
+static void batched_keyswitch_bootstrap_lwe_u64(
+    uint64_t *out, uint64_t out_size0, uint64_t out_stride0, uint64_t *ct0,
+    uint64_t ct0_stride0, uint64_t *tlu, bool tlu_is_accumulator,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
+
+  // Each worker keyswitches into its own scratch arena, so the rows are
+  // independent as for the batched bootstrap.
+#pragma omp parallel for if (out_size0 > 1 && !omp_in_parallel())
+  for (size_t i = 0; i < out_size0; i++) {
+    keyswitch_bootstrap_lwe_u64(
+        out + i * out_stride0, ct0 + i * ct0_stride0, tlu, tlu_is_accumulator,
+        ks_level, ks_base_log, ks_input_lwe_dim, ks_output_lwe_dim,
+        keyswitch_key, poly_size, level, base_log, glwe_dim,
+        numa_local_bootstrap_key(context, bsk_index, bootstrap_key), fft);
+  }
+}
+
+void memref_keyswitch_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
-    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_stride_0,
-    uint64_t out_stride_1,
-    // Input 2D memref
-    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
-    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_stride_0,
-    uint64_t in_stride_1,
-    // clear text lut 1D memref
-    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
-    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
-    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
-    // CRT decomposition 1D memref
-    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
-    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
-    uint64_t crt_decomp_stride,
-    // Additional crypto parameters
-    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
-    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
-    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
-    uint32_t polynomial_size,
-    // Key Indices,
-    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
-    // runtime context that hold evaluation keys
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH_BOOTSTRAP, ksk_index,
+      bsk_index);
+  assert(out_stride == 1 && ct0_stride == 1);
+  assert(ct0_size == ks_input_lwe_dim + 1 &&
+         "size of the input ciphertext does not match the keyswitch key");
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
 
-  // The compiler should only generates 2D memref<BxS>, where B is the number of
-  // ciphertext block and S the lweSize.
-  // Check for the strides
+  keyswitch_bootstrap_lwe_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset,
+      tlu_aligned + tlu_offset, false, ks_level, ks_base_log, ks_input_lwe_dim,
+      ks_output_lwe_dim, keyswitch_key, poly_size, level, base_log, glwe_dim,
+      bootstrap_key, fft);
+}
 
-  assert(out_stride_1 == 1);
-  assert(in_stride_0 == in_size_1 && in_stride_0 == in_size_1);
-  // Check for the size B
-  assert(out_size_0 == in_size_0 && out_size_0 == crt_decomp_size);
-  // Check for the size S
-  assert(out_size_1 == in_size_1);
+void memref_batched_keyswitch_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t ks_level, uint32_t ks_base_log,
+    uint32_t ks_input_lwe_dim, uint32_t ks_output_lwe_dim, uint32_t ksk_index,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH_BOOTSTRAP, ksk_index,
+      bsk_index, out_size0);
+  assert(out_size0 == ct0_size0 && "Input and output batch sizes differ");
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  batched_keyswitch_bootstrap_lwe_u64(
+      out_aligned + out_offset, out_size0, out_stride0,
+      ct0_aligned + ct0_offset, ct0_stride0, tlu_aligned + tlu_offset, false,
+      ks_level, ks_base_log, ks_input_lwe_dim, ks_output_lwe_dim, ksk_index,
+      poly_size, level, base_log, glwe_dim, bsk_index, context);
+}
 
-  uint64_t lwe_small_size = lwe_small_dim + 1;
+void memref_keyswitch_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH_BOOTSTRAP, ksk_index,
+      bsk_index);
+  assert(out_stride == 1 && ct0_stride == 1);
+  assert(ct0_size == ks_input_lwe_dim + 1 &&
+         "size of the input ciphertext does not match the keyswitch key");
+  assert(acc_size == (glwe_dim + 1) * poly_size &&
+         "size of the accumulator does not match the glwe parameters");
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
 
-  assert(out_size_1 == in_size_1);
-  uint64_t lwe_big_size = in_size_1;
-  uint64_t lwe_big_dim = lwe_big_size - 1;
-  assert(lwe_big_dim % polynomial_size == 0);
+  keyswitch_bootstrap_lwe_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset,
+      acc_aligned + acc_offset, true, ks_level, ks_base_log, ks_input_lwe_dim,
+      ks_output_lwe_dim, keyswitch_key, poly_size, level, base_log, glwe_dim,
+      bootstrap_key, fft);
+}
 
+void memref_batched_keyswitch_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *acc_allocated,
+    uint64_t *acc_aligned, uint64_t acc_offset, uint64_t acc_size,
+    uint64_t acc_stride, uint32_t ks_level, uint32_t ks_base_log,
+    uint32_t ks_input_lwe_dim, uint32_t ks_output_lwe_dim, uint32_t ksk_index,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t bsk_index, mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::KEYSWITCH_BOOTSTRAP, ksk_index,
+      bsk_index, out_size0);
+  assert(out_size0 == ct0_size0 && "Input and output batch sizes differ");
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  assert(acc_size == (glwe_dim + 1) * poly_size &&
+         "size of the accumulator does not match the glwe parameters");
+  batched_keyswitch_bootstrap_lwe_u64(
+      out_aligned + out_offset, out_size0, out_stride0,
+      ct0_aligned + ct0_offset, ct0_stride0, acc_aligned + acc_offset, true,
+      ks_level, ks_base_log, ks_input_lwe_dim, ks_output_lwe_dim, ksk_index,
+      poly_size, level, base_log, glwe_dim, bsk_index, context);
+}
+
+void memref_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index);
+  assert(acc_size == (uint64_t)poly_size * (glwe_dim + 1) &&
+         "Accumulator size does not match the GLWE parameters");
+
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
+
+  bootstrap_lwe_with_accumulator_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset,
+      acc_aligned + acc_offset, input_lwe_dim, poly_size, level, base_log,
+      glwe_dim, bootstrap_key, fft);
+}
+
+void memref_batched_bootstrap_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *acc_allocated,
+    uint64_t *acc_aligned, uint64_t acc_offset, uint64_t acc_size,
+    uint64_t acc_stride, uint32_t input_lwe_dim, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index,
+      out_size0);
+  assert(out_size0 == ct0_size0 && "Input and output batch sizes differ");
+  assert(acc_size == (uint64_t)poly_size * (glwe_dim + 1) &&
+         "Accumulator size does not match the GLWE parameters");
+
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = get_fourier_bootstrap_key(context, bsk_index);
+
+  batched_bootstrap_lwe_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, out_size0,
+      out_size1, ct0_size1, out_stride0, ct0_stride0, acc_aligned + acc_offset,
+      0, input_lwe_dim, poly_size, level, base_log, glwe_dim, bootstrap_key,
+      fft, bsk_index, context);
+}
+
+void memref_many_lut_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t lut_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::BOOTSTRAP, -1, bsk_index);
+  assert(out_stride1 == 1 && out_stride0 == out_size1 &&
+         "Runtime: output ciphertexts are not contiguous, check "
+         "memref_many_lut_bootstrap_lwe_u64");
+  assert(out_size1 == glwe_dim * poly_size + 1 &&
+         "Runtime: output lwe size does not match the bootstrap key, check "
+         "memref_many_lut_bootstrap_lwe_u64");
+  assert(ct0_size == input_lwe_dim + 1 &&
+         "Runtime: input lwe size does not match the bootstrap key, check "
+         "memref_many_lut_bootstrap_lwe_u64");
+  assert(tlu_size == poly_size &&
+         "Runtime: lookup table size does not match the polynomial size, "
+         "check memref_many_lut_bootstrap_lwe_u64");
+  assert(out_size0 >= 1 && (out_size0 - 1) * lut_stride < poly_size &&
+         "Runtime: packed lookup tables exceed the polynomial, check "
+         "memref_many_lut_bootstrap_lwe_u64");
+
+  auto &arena = mlir::concretelang::ScratchArena::local();
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+
+  uint64_t glwe_ct_size = poly_size * (glwe_dim + 1);
+  uint64_t *glwe_ct = arena.get<uint64_t>(
+      mlir::concretelang::ScratchArena::GLWE_ACCUMULATOR, glwe_ct_size);
+  concretelang::lut::trivialGlweAccumulator(glwe_ct, tlu_aligned + tlu_offset,
+                                            glwe_dim, poly_size);
+
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratch_size, &scratch_align, glwe_dim, poly_size, fft);
+  auto scratch = arena.get(mlir::concretelang::ScratchArena::BOOTSTRAP,
+                           scratch_size, scratch_align);
+
+  // One blind rotation for all the `out_size0` packed lookup tables
+  concrete_cpu_bootstrap_lwe_ciphertext_many_lut_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct, out_size0,
+      lut_stride, bootstrap_key, level, base_log, glwe_dim, poly_size,
+      input_lwe_dim, fft, scratch, scratch_size);
+}
+
+// The compact variants unpack the descriptors and the parameters of the
+// operation and forward them to the regular wrappers, which get inlined. The
+// parameters are read in the order of the scalar arguments of the regular
+// wrapper.
+
+#define MEMREF_1D_ARGS(m)                                                      \
+  (m)->basePtr, (m)->data, (m)->offset, (m)->sizes[0], (m)->strides[0]
+
+void _mlir_ciface_memref_keyswitch_lwe_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(params->sizes[0] == 5 && params->strides[0] == 1);
+  const uint32_t *p = params->data + params->offset;
+  memref_keyswitch_lwe_u64(MEMREF_1D_ARGS(out), MEMREF_1D_ARGS(ct0), p[0],
+                           p[1], p[2], p[3], p[4], context);
+}
+
+void _mlir_ciface_memref_bootstrap_lwe_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *tlu,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(params->sizes[0] == 6 && params->strides[0] == 1);
+  const uint32_t *p = params->data + params->offset;
+  memref_bootstrap_lwe_u64(MEMREF_1D_ARGS(out), MEMREF_1D_ARGS(ct0),
+                           MEMREF_1D_ARGS(tlu), p[0], p[1], p[2], p[3], p[4],
+                           p[5], context);
+}
+
+void _mlir_ciface_memref_bootstrap_lwe_with_accumulator_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *acc,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(params->sizes[0] == 6 && params->strides[0] == 1);
+  const uint32_t *p = params->data + params->offset;
+  memref_bootstrap_lwe_with_accumulator_u64(
+      MEMREF_1D_ARGS(out), MEMREF_1D_ARGS(ct0), MEMREF_1D_ARGS(acc), p[0], p[1],
+      p[2], p[3], p[4], p[5], context);
+}
+
+void _mlir_ciface_memref_keyswitch_bootstrap_lwe_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *tlu,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(params->sizes[0] == 10 && params->strides[0] == 1);
+  const uint32_t *p = params->data + params->offset;
+  memref_keyswitch_bootstrap_lwe_u64(
+      MEMREF_1D_ARGS(out), MEMREF_1D_ARGS(ct0), MEMREF_1D_ARGS(tlu), p[0], p[1],
+      p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9], context);
+}
+
+void _mlir_ciface_memref_keyswitch_bootstrap_lwe_with_accumulator_compact_u64(
+    StridedMemRefType<uint64_t, 1> *out, StridedMemRefType<uint64_t, 1> *ct0,
+    StridedMemRefType<uint64_t, 1> *acc,
+    StridedMemRefType<uint32_t, 1> *params,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(params->sizes[0] == 10 && params->strides[0] == 1);
+  const uint32_t *p = params->data + params->offset;
+  memref_keyswitch_bootstrap_lwe_with_accumulator_u64(
+      MEMREF_1D_ARGS(out), MEMREF_1D_ARGS(ct0), MEMREF_1D_ARGS(acc), p[0], p[1],
+      p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9], context);
+}
+
+#undef MEMREF_1D_ARGS
+
+// The async variants run their synchronous counterpart on the async
+// executor. The buffers must stay alive and unmodified until the returned
+// future is awaited with `memref_await_future`. The primitives are recorded in
+// the statistics of the caller, if any.
+
+void *memref_keyswitch_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint32_t level, uint32_t base_log,
+    uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t ksk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  auto *statistics = mlir::concretelang::getCurrentPrimitiveStatistics();
+  return mlir::concretelang::async::submit([=] {
+    mlir::concretelang::PrimitiveStatisticsScope scope(statistics);
+    memref_keyswitch_lwe_u64(out_allocated, out_aligned, out_offset, out_size,
+                             out_stride, ct0_allocated, ct0_aligned,
+                             ct0_offset, ct0_size, ct0_stride, level, base_log,
+                             input_lwe_dim, output_lwe_dim, ksk_index, context);
+  });
+}
+
+void *memref_bootstrap_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  auto *statistics = mlir::concretelang::getCurrentPrimitiveStatistics();
+  return mlir::concretelang::async::submit([=] {
+    mlir::concretelang::PrimitiveStatisticsScope scope(statistics);
+    memref_bootstrap_lwe_u64(out_allocated, out_aligned, out_offset, out_size,
+                             out_stride, ct0_allocated, ct0_aligned,
+                             ct0_offset, ct0_size, ct0_stride, tlu_allocated,
+                             tlu_aligned, tlu_offset, tlu_size, tlu_stride,
+                             input_lwe_dim, poly_size, level, base_log,
+                             glwe_dim, bsk_index, context);
+  });
+}
+
+void *memref_bootstrap_async_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  auto *statistics = mlir::concretelang::getCurrentPrimitiveStatistics();
+  return mlir::concretelang::async::submit([=] {
+    mlir::concretelang::PrimitiveStatisticsScope scope(statistics);
+    memref_bootstrap_lwe_with_accumulator_u64(
+        out_allocated, out_aligned, out_offset, out_size, out_stride,
+        ct0_allocated, ct0_aligned, ct0_offset, ct0_size, ct0_stride,
+        acc_allocated, acc_aligned, acc_offset, acc_size, acc_stride,
+        input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index,
+        context);
+  });
+}
+
+void *memref_keyswitch_bootstrap_async_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  auto *statistics = mlir::concretelang::getCurrentPrimitiveStatistics();
+  return mlir::concretelang::async::submit([=] {
+    mlir::concretelang::PrimitiveStatisticsScope scope(statistics);
+    memref_keyswitch_bootstrap_lwe_u64(
+        out_allocated, out_aligned, out_offset, out_size, out_stride,
+        ct0_allocated, ct0_aligned, ct0_offset, ct0_size, ct0_stride,
+        tlu_allocated, tlu_aligned, tlu_offset, tlu_size, tlu_stride, ks_level,
+        ks_base_log, ks_input_lwe_dim, ks_output_lwe_dim, ksk_index, poly_size,
+        level, base_log, glwe_dim, bsk_index, context);
+  });
+}
+
+void *memref_keyswitch_bootstrap_async_lwe_with_accumulator_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *acc_allocated, uint64_t *acc_aligned,
+    uint64_t acc_offset, uint64_t acc_size, uint64_t acc_stride,
+    uint32_t ks_level, uint32_t ks_base_log, uint32_t ks_input_lwe_dim,
+    uint32_t ks_output_lwe_dim, uint32_t ksk_index, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  auto *statistics = mlir::concretelang::getCurrentPrimitiveStatistics();
+  return mlir::concretelang::async::submit([=] {
+    mlir::concretelang::PrimitiveStatisticsScope scope(statistics);
+    memref_keyswitch_bootstrap_lwe_with_accumulator_u64(
+        out_allocated, out_aligned, out_offset, out_size, out_stride,
+        ct0_allocated, ct0_aligned, ct0_offset, ct0_size, ct0_stride,
+        acc_allocated, acc_aligned, acc_offset, acc_size, acc_stride, ks_level,
+        ks_base_log, ks_input_lwe_dim, ks_output_lwe_dim, ksk_index, poly_size,
+        level, base_log, glwe_dim, bsk_index, context);
+  });
+}
+
+void memref_await_future(uint64_t *out_allocated, uint64_t *out_aligned,
+                         uint64_t out_offset, uint64_t out_size,
+                         uint64_t out_stride, void *future,
+                         uint64_t *in_allocated, uint64_t *in_aligned,
+                         uint64_t in_offset, uint64_t in_size,
+                         uint64_t in_stride) {
+  mlir::concretelang::async::await(
+      static_cast<mlir::concretelang::async::Future *>(future));
+  // The result is produced in `in`, copy it unless awaited in place
+  uint64_t *out = out_aligned + out_offset;
+  uint64_t *in = in_aligned + in_offset;
+  if (out != in) {
+    assert(out_size == in_size && "size of lwe buffers are incompatible");
+    for (size_t i = 0; i < out_size; i++)
+      out[i * out_stride] = in[i * in_stride];
+  }
+}
+
+uint64_t encode_crt(int64_t plaintext, uint64_t modulus, uint64_t product) {
+  return concretelang::crt::encode(plaintext, modulus, product);
+}
+
+/// Evaluates the wop-pbs of a single CRT ciphertext of `crt_decomp_size`
+/// contiguous blocks of `lwe_big_dim + 1` words.
+static void wop_pbs_crt_u64(
+    uint64_t *out, const uint64_t *in, const uint64_t *lut, uint64_t lut_count,
+    uint64_t lut_size, const uint64_t *crt_decomp, uint64_t crt_decomp_size,
+    uint64_t lwe_big_dim, uint32_t lwe_small_dim, uint32_t cbs_level_count,
+    uint32_t cbs_base_log, uint32_t ksk_level_count, uint32_t ksk_base_log,
+    uint32_t bsk_level_count, uint32_t bsk_base_log,
+    uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size, const uint64_t *keyswitch_key,
+    const std::complex<double> *bootstrap_key,
+    const uint64_t *fp_keyswitch_key, const struct Fft *fft) {
+  uint64_t lwe_small_size = lwe_small_dim + 1;
+  uint64_t lwe_big_size = lwe_big_dim + 1;
   assert(lwe_big_dim % polynomial_size == 0);
   uint64_t glwe_dim = lwe_big_dim / polynomial_size;
 
-  // Compute the numbers of bits to extract for each block and the total one.
-  uint64_t total_number_of_bits_per_block = 0;
-  auto number_of_bits_per_block = new uint64_t[crt_decomp_size]();
-  for (uint64_t i = 0; i < crt_decomp_size; i++) {
-    uint64_t modulus = crt_decomp_aligned[i + crt_decomp_offset];
-    uint64_t nb_bit_to_extract =
-        static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
-    number_of_bits_per_block[i] = nb_bit_to_extract;
+  using mlir::concretelang::ScratchArena;
+  auto &arena = ScratchArena::local();
 
-    total_number_of_bits_per_block += nb_bit_to_extract;
-  }
+  // Compute the numbers of bits to extract for each block, the offset of
+  // their extracted bits and the total number of bits.
+  auto number_of_bits_per_block = arena.get<uint64_t>(
+      ScratchArena::WOP_PBS_BITS_PER_BLOCK, 2 * crt_decomp_size);
+  auto extract_bits_output_offsets =
+      number_of_bits_per_block + crt_decomp_size;
+  uint64_t total_number_of_bits_per_block =
+      crt_bits_to_extract(crt_decomp, crt_decomp_size, number_of_bits_per_block,
+                          extract_bits_output_offsets);
 
   // Create the buffer of ciphertexts for storing the total number of bits to
   // extract.
-  // The extracted bit should be in the following order:
-  //
-  // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
-  // is the size of the crt decomposition
-  auto extract_bits_output_buffer =
-      new uint64_t[lwe_small_size * total_number_of_bits_per_block]{0};
+  auto extract_bits_output_size =
+      lwe_small_size * total_number_of_bits_per_block;
+  auto extract_bits_output_buffer = arena.get<uint64_t>(
+      ScratchArena::WOP_PBS_EXTRACTED_BITS, extract_bits_output_size);
+  memset(extract_bits_output_buffer, 0,
+         extract_bits_output_size * sizeof(uint64_t));
 
   // We make a private copy to apply a subtraction on the body
-  auto first_ciphertext = in_aligned + in_offset;
   auto copy_size = crt_decomp_size * lwe_big_size;
-  std::vector<uint64_t> in_copy(first_ciphertext, first_ciphertext + copy_size);
-  // Extraction of each bit for each block
-
-  const auto &fft = context->fft(bsk_index);
-  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
-  auto keyswicth_key = context->keyswitch_key_buffer(ksk_index);
+  auto in_copy = arena.get<uint64_t>(ScratchArena::WOP_PBS_INPUT, copy_size);
+  memcpy(in_copy, in, copy_size * sizeof(uint64_t));
 
-  for (int64_t i = crt_decomp_size - 1, extract_bits_output_offset = 0; i >= 0;
-       extract_bits_output_offset += number_of_bits_per_block[i--]) {
+  // Extraction of each bit for each block. The blocks are independent, each
+  // worker uses the scratch space of its own arena.
+#pragma omp parallel for if (crt_decomp_size > 1 && !omp_in_parallel())
+  for (int64_t i = 0; i < (int64_t)crt_decomp_size; i++) {
     auto nb_bits_to_extract = number_of_bits_per_block[i];
 
     size_t delta_log = 64 - nb_bits_to_extract;
 
     auto in_block = &in_copy[lwe_big_size * i];
 
-    // trick ( ct - delta/2 + delta/2^4  )
-    uint64_t sub = (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
-                   (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
-    in_block[lwe_big_size - 1] -= sub;
+    in_block[lwe_big_size - 1] -= bit_extraction_shift(nb_bits_to_extract);
 
     size_t scratch_size;
     size_t scratch_align;
     concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(
         &scratch_size, &scratch_align, lwe_small_dim, lwe_big_dim, glwe_dim,
         polynomial_size, fft);
-    // Allocate scratch
-    auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+    auto *scratch = ScratchArena::local().get(
+        ScratchArena::WOP_PBS_EXTRACT_BITS, scratch_size, scratch_align);
 
     concrete_cpu_extract_bit_lwe_ciphertext_u64(
         &extract_bits_output_buffer[lwe_small_size *
-                                    extract_bits_output_offset],
-        in_block, bootstrap_key, keyswicth_key, lwe_small_dim,
+                                    extract_bits_output_offsets[i]],
+        in_block, bootstrap_key, keyswitch_key, lwe_small_dim,
         nb_bits_to_extract, lwe_big_dim, nb_bits_to_extract, delta_log,
         bsk_level_count, bsk_base_log, glwe_dim, polynomial_size, lwe_small_dim,
         ksk_level_count, ksk_base_log, lwe_big_dim, lwe_small_dim, fft, scratch,
         scratch_size);
-
-    free(scratch);
   }
 
   size_t ct_in_count = total_number_of_bits_per_block;
-  size_t lut_size = 1 << ct_in_count;
-  size_t ct_out_count = out_size_0;
-  size_t lut_count = ct_out_count;
+  size_t ct_out_count = lut_count;
 
-  assert(lut_ct_size0 == lut_count);
-  assert(lut_ct_size1 == lut_size);
+  assert(lut_size == (size_t)1 << ct_in_count);
 
   // Vertical packing
   size_t scratch_size;
@@ -978,20 +1962,134 @@ void memref_wop_pbs_crt_buffer(
       lut_size, lut_count, glwe_dim, polynomial_size, polynomial_size,
       cbs_level_count, fft);
 
-  auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-  auto fp_keyswicth_key = context->fp_keyswitch_key_buffer(pksk_index);
+  auto *scratch = arena.get(ScratchArena::WOP_PBS_VERTICAL_PACKING,
+                            scratch_size, scratch_align);
 
   concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
-      out_aligned + out_offset, extract_bits_output_buffer,
-      lut_ct_aligned + lut_ct_offset, bootstrap_key, fp_keyswicth_key,
+      out, extract_bits_output_buffer, lut, bootstrap_key, fp_keyswitch_key,
       lwe_big_dim, ct_out_count, lwe_small_dim, ct_in_count, lut_size,
       lut_count, bsk_level_count, bsk_base_log, glwe_dim, polynomial_size,
       lwe_small_dim, fpksk_level_count, fpksk_base_log, lwe_big_dim, glwe_dim,
       polynomial_size, glwe_dim + 1, cbs_level_count, cbs_base_log, fft,
       scratch, scratch_size);
+}
+
+void memref_wop_pbs_crt_buffer(
+    // Output 2D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_stride_0,
+    uint64_t out_stride_1,
+    // Input 2D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_stride_0,
+    uint64_t in_stride_1,
+    // clear text lut 1D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key Indices,
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evaluation keys
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::WOP_PBS, ksk_index, bsk_index);
+
+  // The compiler should only generates 2D memref<BxS>, where B is the number of
+  // ciphertext block and S the lweSize.
+  // Check for the strides
+  assert(out_stride_1 == 1);
+  assert(out_stride_0 == out_size_1);
+  assert(in_stride_0 == in_size_1 && in_stride_1 == 1);
+  // Check for the size B
+  assert(out_size_0 == in_size_0 && out_size_0 == crt_decomp_size);
+  // Check for the size S
+  assert(out_size_1 == in_size_1);
+  // The lookup tables are contiguous
+  assert(lut_ct_size0 == out_size_0 && lut_ct_stride0 == lut_ct_size1);
 
-  free(scratch);
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  auto keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  auto fp_keyswitch_key = context->fp_keyswitch_key_buffer(pksk_index);
+
+  wop_pbs_crt_u64(out_aligned + out_offset, in_aligned + in_offset,
+                  lut_ct_aligned + lut_ct_offset, lut_ct_size0, lut_ct_size1,
+                  crt_decomp_aligned + crt_decomp_offset, crt_decomp_size,
+                  in_size_1 - 1, lwe_small_dim, cbs_level_count, cbs_base_log,
+                  ksk_level_count, ksk_base_log, bsk_level_count, bsk_base_log,
+                  fpksk_level_count, fpksk_base_log, polynomial_size,
+                  keyswitch_key, bootstrap_key, fp_keyswitch_key, fft);
+}
+
+void memref_batched_wop_pbs_crt_buffer(
+    // Output 3D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_size_2,
+    uint64_t out_stride_0, uint64_t out_stride_1, uint64_t out_stride_2,
+    // Input 3D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_size_2,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t in_stride_2,
+    // clear text lut 2D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key Indices,
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evaluation keys
+    mlir::concretelang::RuntimeContext *context) {
+  mlir::concretelang::PrimitiveTimer timer(
+      mlir::concretelang::RuntimePrimitive::WOP_PBS, ksk_index, bsk_index,
+      out_size_0);
+
+  // 3D memref<NxBxS> of N CRT ciphertexts of B blocks of size S, each CRT
+  // ciphertext being contiguous.
+  assert(out_size_0 == in_size_0 && "Input and output batch sizes differ");
+  assert(out_size_1 == in_size_1 && out_size_1 == crt_decomp_size);
+  assert(out_size_2 == in_size_2);
+  assert(out_stride_2 == 1 && out_stride_1 == out_size_2);
+  assert(in_stride_2 == 1 && in_stride_1 == in_size_2);
+  assert(lut_ct_size0 == out_size_1 && lut_ct_stride0 == lut_ct_size1);
+
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  auto keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  auto fp_keyswitch_key = context->fp_keyswitch_key_buffer(pksk_index);
+
+  // The CRT ciphertexts are distributed over the OpenMP worker pool, the
+  // blocks of each one being then processed sequentially.
+#pragma omp parallel for if (out_size_0 > 1 && !omp_in_parallel())
+  for (size_t i = 0; i < out_size_0; i++) {
+    wop_pbs_crt_u64(out_aligned + out_offset + i * out_stride_0,
+                    in_aligned + in_offset + i * in_stride_0,
+                    lut_ct_aligned + lut_ct_offset, lut_ct_size0, lut_ct_size1,
+                    crt_decomp_aligned + crt_decomp_offset, crt_decomp_size,
+                    in_size_2 - 1, lwe_small_dim, cbs_level_count,
+                    cbs_base_log, ksk_level_count, ksk_base_log,
+                    bsk_level_count, bsk_base_log, fpksk_level_count,
+                    fpksk_base_log, polynomial_size, keyswitch_key,
+                    context->numa_local_fourier_bootstrap_key(bsk_index,
+                                                              bootstrap_key),
+                    fp_keyswitch_key, fft);
+  }
 }
 
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
@@ -1040,8 +2138,20 @@ void memref_trace_message(char *message_ptr, uint32_t message_len) {
   std::cout << message << std::flush;
 }
 
+void memref_trace_probe(char *name_ptr, uint32_t name_len, uint32_t precision,
+                        double noise_variance) {
+  mlir::concretelang::probes::record(name_ptr, name_len, precision,
+                                     noise_variance);
+}
+
 void *concrete_checked_malloc(size_t size) {
-  void *ptr = malloc(size);
+  void *ptr = mlir::concretelang::pinned::allocate(size);
+  if (ptr != nullptr)
+    return ptr;
+  ptr = mlir::concretelang::memory_pool::allocate(size);
+  if (ptr != nullptr)
+    return ptr;
+  ptr = malloc(size);
   if (ptr != nullptr)
     return ptr;
 
@@ -1075,3 +2185,35 @@ void *concrete_checked_malloc(size_t size) {
 
   exit(1);
 }
+
+void concrete_checked_free(void *ptr) {
+  if (!mlir::concretelang::pinned::release(ptr) &&
+      !mlir::concretelang::memory_pool::release(ptr))
+    free(ptr);
+}
+
+static uint64_t detect_x86_64_level() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  if (!__builtin_cpu_supports("popcnt") || !__builtin_cpu_supports("ssse3") ||
+      !__builtin_cpu_supports("sse4.2"))
+    return 0;
+  if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("bmi") ||
+      !__builtin_cpu_supports("bmi2") || !__builtin_cpu_supports("fma"))
+    return 1;
+  if (!__builtin_cpu_supports("avx512f") ||
+      !__builtin_cpu_supports("avx512bw") ||
+      !__builtin_cpu_supports("avx512cd") ||
+      !__builtin_cpu_supports("avx512dq") ||
+      !__builtin_cpu_supports("avx512vl"))
+    return 2;
+  return 3;
+#else
+  return 0;
+#endif
+}
+
+uint64_t concrete_x86_64_level() {
+  static const uint64_t level = detect_x86_64_level();
+  return level;
+}
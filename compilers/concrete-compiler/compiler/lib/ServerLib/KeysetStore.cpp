@@ -0,0 +1,175 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/ServerLib/KeysetStore.h"
+#include "concrete-cpu.h"
+#include "concrete-protocol.capnp.h"
+#include "concretelang/Common/Error.h"
+#include "concretelang/Common/Keysets.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace concretelang {
+namespace serverlib {
+
+KeysetStore::~KeysetStore() {
+  // The prefetches are not waited for with the lock held, as they take it to
+  // insert their keyset
+  std::list<std::future<void>> pending;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    pending.swap(prefetches);
+  }
+  for (auto &prefetch : pending)
+    prefetch.wait();
+}
+
+Result<ServerKeyset> KeysetStore::get(const std::string &tenantId) {
+  std::unique_ptr<Promise> promise;
+  std::shared_future<Result<ServerKeyset>> pending;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = resident.find(tenantId);
+    if (it != resident.end()) {
+      lru.splice(lru.begin(), lru, it->second.position);
+      return it->second.keyset;
+    }
+    auto loadingIt = loading.find(tenantId);
+    if (loadingIt != loading.end()) {
+      pending = loadingIt->second;
+    } else {
+      promise = std::make_unique<Promise>();
+      pending = promise->get_future().share();
+      loading.emplace(tenantId, pending);
+    }
+  }
+  if (promise)
+    load(tenantId, *promise);
+  return pending.get();
+}
+
+void KeysetStore::prefetch(const std::string &tenantId) {
+  std::lock_guard<std::mutex> guard(mutex);
+  // Forget about the prefetches which are done
+  prefetches.remove_if([](std::future<void> &prefetch) {
+    return prefetch.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  });
+  if (resident.count(tenantId) || loading.count(tenantId))
+    return;
+  auto promise = std::make_shared<Promise>();
+  loading.emplace(tenantId, promise->get_future().share());
+  auto task = [this, tenantId, promise]() { load(tenantId, *promise); };
+  prefetches.push_back(std::async(std::launch::async, task));
+}
+
+void KeysetStore::evict(const std::string &tenantId) {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (resident.count(tenantId))
+    remove(tenantId);
+}
+
+bool KeysetStore::isResident(const std::string &tenantId) {
+  std::lock_guard<std::mutex> guard(mutex);
+  return resident.count(tenantId) > 0;
+}
+
+Result<std::vector<TransportValue>>
+KeysetStore::call(ServerCircuit &circuit, const std::string &tenantId,
+                  std::vector<TransportValue> &args) {
+  OUTCOME_TRY(auto keyset, get(tenantId));
+  return circuit.call(keyset, args);
+}
+
+KeysetFootprint KeysetStore::getFootprint() {
+  std::lock_guard<std::mutex> guard(mutex);
+  KeysetFootprint footprint;
+  for (auto &entry : resident) {
+    footprint.compressed += entry.second.footprint.compressed;
+    footprint.decompressed += entry.second.footprint.decompressed;
+    footprint.fourier += entry.second.footprint.fourier;
+  }
+  return footprint;
+}
+
+KeysetFootprint KeysetStore::footprintOf(const ServerKeyset &keyset) {
+  KeysetFootprint footprint;
+  for (auto &bsk : keyset.lweBootstrapKeys) {
+    auto info = bsk.getInfo().asReader();
+    size_t transportSize = bsk.getTransportBuffer().size() * sizeof(uint64_t);
+    size_t size = transportSize;
+    if (info.getCompression() == concreteprotocol::Compression::SEED) {
+      auto params = info.getParams();
+      footprint.compressed += transportSize;
+      size = concrete_cpu_bootstrap_key_size_u64(
+                 params.getLevelCount(), params.getGlweDimension(),
+                 params.getPolynomialSize(), params.getInputLweDimension()) *
+             sizeof(uint64_t);
+    }
+    footprint.decompressed += size;
+    // The fourier key holds a complex of doubles per pair of words
+    footprint.fourier += size;
+  }
+  for (auto &ksk : keyset.lweKeyswitchKeys) {
+    auto info = ksk.getInfo().asReader();
+    size_t transportSize = ksk.getTransportBuffer().size() * sizeof(uint64_t);
+    if (info.getCompression() == concreteprotocol::Compression::SEED) {
+      auto params = info.getParams();
+      footprint.compressed += transportSize;
+      footprint.decompressed +=
+          concrete_cpu_keyswitch_key_size_u64(params.getLevelCount(),
+                                              params.getInputLweDimension(),
+                                              params.getOutputLweDimension()) *
+          sizeof(uint64_t);
+    } else {
+      footprint.decompressed += transportSize;
+    }
+  }
+  for (auto &pksk : keyset.packingKeyswitchKeys)
+    footprint.decompressed += pksk.getSize() * sizeof(uint64_t);
+  for (auto &gpksk : keyset.glwePackingKeyswitchKeys)
+    footprint.decompressed += gpksk.getSize() * sizeof(uint64_t);
+  return footprint;
+}
+
+void KeysetStore::load(const std::string &tenantId, Promise &promise) {
+  auto keyset = loader(tenantId);
+  if (keyset.has_value() && decompressOnLoad)
+    keyset.value().decompress();
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    loading.erase(tenantId);
+    if (keyset.has_value())
+      insert(tenantId, keyset.value());
+  }
+  promise.set_value(std::move(keyset));
+}
+
+void KeysetStore::insert(const std::string &tenantId,
+                         const ServerKeyset &keyset) {
+  if (resident.count(tenantId))
+    remove(tenantId);
+  lru.push_front(tenantId);
+  auto footprint = footprintOf(keyset);
+  resident.emplace(tenantId, Entry{keyset, footprint, lru.begin()});
+  memoryUsage += footprint.total();
+  while (memoryUsage > memoryBudget && lru.size() > 1) {
+    std::string victim = lru.back();
+    remove(victim);
+  }
+}
+
+void KeysetStore::remove(const std::string &tenantId) {
+  auto it = resident.find(tenantId);
+  memoryUsage -= it->second.footprint.total();
+  lru.erase(it->second.position);
+  resident.erase(it);
+}
+
+} // namespace serverlib
+} // namespace concretelang
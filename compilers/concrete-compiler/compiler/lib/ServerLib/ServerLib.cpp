@@ -4,9 +4,17 @@
 // for license information.
 
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <limits>
 #include <llvm/ADT/SmallSet.h>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <vector>
 
 #include "boost/outcome.h"
@@ -17,7 +25,14 @@
 #include "concretelang/Common/Transformers.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Runtime/DFRuntime.hpp"
+#include "concretelang/Runtime/GPUDFG.hpp"
+#include "concretelang/Runtime/async_executor.h"
 #include "concretelang/Runtime/context.h"
+#include "concretelang/Runtime/output_ready.h"
+#include "concretelang/Runtime/simulation.h"
+#include "concretelang/Runtime/stream_emulator_api.h"
+#include "concretelang/Runtime/tracing.h"
+#include "concretelang/Runtime/wrappers.h"
 #include "concretelang/ServerLib/ServerLib.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -94,19 +109,25 @@ struct MemRefDescriptor {
 
   /// Creates a memref descriptor referencing the data contained in a tensor.
   template <typename T> static MemRefDescriptor fromTensor(Tensor<T> &input) {
+    return fromBuffer((void *)input.values.data(), input.dimensions,
+                      sizeof(T) * 8, std::is_signed<T>());
+  }
+
+  /// Creates a memref descriptor referencing a dense row-major buffer of the
+  /// given sizes.
+  static MemRefDescriptor fromBuffer(void *data, std::vector<size_t> sizes,
+                                     size_t precision, bool isSigned) {
     std::vector<size_t> strides;
-    size_t stride = input.values.size();
-    for (size_t dim : input.dimensions) {
+    size_t stride = 1;
+    for (size_t dim : sizes) {
+      stride *= dim;
+    }
+    for (size_t dim : sizes) {
       stride = (dim == 0 ? 0 : (stride / dim));
       strides.push_back(stride);
     }
-    return MemRefDescriptor{sizeof(T) * 8,
-                            std::is_signed<T>(),
-                            (void *)nullptr,
-                            (void *)input.values.data(),
-                            0,
-                            input.dimensions,
-                            strides};
+    return MemRefDescriptor{precision, isSigned, (void *)nullptr, data, 0,
+                            sizes,     strides};
   }
 
   /// Creates a memref descriptor from a vector of uint64_t, which is the way to
@@ -145,19 +166,39 @@ struct MemRefDescriptor {
     assert(sizeof(T) * 8 == precision);
     assert(std::is_signed<T>() == isSigned);
 
+    T *memrefAligned = reinterpret_cast<T *>(aligned);
+
+    // The common case of a row-major contiguous memref is copied at once.
+    if (isContiguous()) {
+      std::vector<T> values(memrefAligned + offset,
+                            memrefAligned + offset + getLength());
+      return Tensor<T>{std::move(values), sizes};
+    }
+
     // We create the indexer.
     auto indexer = MultiDimIndexer(offset, sizes, strides);
 
     // We fill a vector of vales to construct the
     std::vector<T> values(getLength());
     for (size_t i = 0; i < values.size(); i++) {
-      T *memrefAligned = reinterpret_cast<T *>(aligned);
       auto index = indexer.currentIndex();
       values[i] = memrefAligned[index];
       indexer.increment();
     }
 
-    return Tensor<T>{values, sizes};
+    return Tensor<T>{std::move(values), sizes};
+  }
+
+  /// Returns true if the strides are those of a dense row-major layout. As in
+  /// the indexer, a null stride stands for the default one.
+  bool isContiguous() {
+    size_t expected = 1;
+    for (size_t r = sizes.size(); r-- > 0;) {
+      if (sizes[r] != 1 && strides[r] != 0 && strides[r] != expected)
+        return false;
+      expected *= sizes[r];
+    }
+    return true;
   }
 
   void intoOpaquePtrs(llvm::MutableArrayRef<void *> &opaquePtrs) {
@@ -178,7 +219,8 @@ struct ScalarDescriptor {
   bool isSigned;
   uint64_t val;
 
-  template <typename T> static ScalarDescriptor fromTensor(Tensor<T> &input) {
+  template <typename T>
+  static ScalarDescriptor fromTensor(const Tensor<T> &input) {
     T value = input.values[0];
     size_t width = sizeof(T) * 8;
     if (width == 64) {
@@ -282,6 +324,20 @@ struct InvocationDescriptor {
     }
   }
 
+  /// Copies the referenced data to a dense buffer of the same element type.
+  void copyInto(void *buffer) {
+    if (std::holds_alternative<ScalarDescriptor>(inner)) {
+      auto &scalar = std::get<ScalarDescriptor>(inner);
+      memcpy(buffer, &scalar.val, scalar.precision / 8);
+    } else {
+      auto &memref = std::get<MemRefDescriptor>(inner);
+      memcpy(buffer,
+             reinterpret_cast<uint8_t *>(memref.aligned) +
+                 memref.offset * memref.precision / 8,
+             memref.getLength() * memref.precision / 8);
+    }
+  }
+
   // Structure used to free memory allocated by the circuit after invocation.
   struct Liberator {
 
@@ -296,7 +352,8 @@ struct InvocationDescriptor {
     void tryFree() {
       for (void *ptr : ptrs) {
         if (ptr != nullptr && !isReferenceToMLIRGlobalMemory(ptr)) {
-          ::free(ptr);
+          // GPU circuits may allocate their results from the pinned pool
+          concrete_checked_free(ptr);
         }
       }
     }
@@ -360,9 +417,17 @@ DynamicModule::open(const std::string &sharedLibPath) {
   return module;
 }
 
-size_t
-getGateDescriptionSize(const Message<concreteprotocol::GateInfo> &gateInfo,
-                       bool useSimulation) {
+Result<void *> DynamicModule::lookup(const std::string &name) {
+  dlerror();
+  void *symbol = dlsym(libraryHandle, name.c_str());
+  if (auto err = dlerror()) {
+    return StringError(std::string(err));
+  }
+  return symbol;
+}
+
+size_t getGateDescriptionSize(concreteprotocol::GateInfo::Reader gateInfo,
+                              bool useSimulation) {
   auto shapeToSize = [](concreteprotocol::Shape::Reader shape) -> size_t {
     if (shape.getDimensions().size() == 0) {
       return 1;
@@ -371,7 +436,7 @@ getGateDescriptionSize(const Message<concreteprotocol::GateInfo> &gateInfo,
     }
   };
 
-  auto typeInfo = gateInfo.asReader().getTypeInfo();
+  auto typeInfo = gateInfo.getTypeInfo();
 
   if (typeInfo.hasIndex()) {
     return shapeToSize(typeInfo.getIndex().getShape());
@@ -400,98 +465,966 @@ getGateDescriptionSize(const Message<concreteprotocol::GateInfo> &gateInfo,
   }
 }
 
-size_t
-getGateIntegerPrecision(const Message<concreteprotocol::GateInfo> &gateInfo) {
-  if (gateInfo.asReader().getTypeInfo().hasIndex()) {
-    return gateInfo.asReader().getTypeInfo().getIndex().getIntegerPrecision();
-  } else if (gateInfo.asReader().getTypeInfo().hasPlaintext()) {
-    return gateInfo.asReader()
-        .getTypeInfo()
-        .getPlaintext()
-        .getIntegerPrecision();
-  } else if (gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
-    return gateInfo.asReader()
-        .getTypeInfo()
-        .getLweCiphertext()
-        .getIntegerPrecision();
+size_t getGateIntegerPrecision(concreteprotocol::GateInfo::Reader gateInfo) {
+  if (gateInfo.getTypeInfo().hasIndex()) {
+    return gateInfo.getTypeInfo().getIndex().getIntegerPrecision();
+  } else if (gateInfo.getTypeInfo().hasPlaintext()) {
+    return gateInfo.getTypeInfo().getPlaintext().getIntegerPrecision();
+  } else if (gateInfo.getTypeInfo().hasLweCiphertext()) {
+    return gateInfo.getTypeInfo().getLweCiphertext().getIntegerPrecision();
   }
   assert(false);
 }
 
-bool getGateIsSigned(const Message<concreteprotocol::GateInfo> &gateInfo) {
-  if (gateInfo.asReader().getTypeInfo().hasIndex()) {
-    return gateInfo.asReader().getTypeInfo().getIndex().getIsSigned();
-  } else if (gateInfo.asReader().getTypeInfo().hasPlaintext()) {
-    return gateInfo.asReader().getTypeInfo().getPlaintext().getIsSigned();
-  } else if (gateInfo.asReader().getTypeInfo().hasLweCiphertext()) {
+bool getGateIsSigned(concreteprotocol::GateInfo::Reader gateInfo) {
+  if (gateInfo.getTypeInfo().hasIndex()) {
+    return gateInfo.getTypeInfo().getIndex().getIsSigned();
+  } else if (gateInfo.getTypeInfo().hasPlaintext()) {
+    return gateInfo.getTypeInfo().getPlaintext().getIsSigned();
+  } else if (gateInfo.getTypeInfo().hasLweCiphertext()) {
     return false;
   }
   assert(false);
 }
 
+/// Returns the shape of the tensor passed through a gate, empty for a scalar.
+std::vector<size_t> getGateShape(concreteprotocol::GateInfo::Reader gateInfo,
+                                 bool useSimulation) {
+  auto typeInfo = gateInfo.getTypeInfo();
+  if (typeInfo.hasIndex()) {
+    return protoShapeToDimensions(typeInfo.getIndex().getShape());
+  } else if (typeInfo.hasPlaintext()) {
+    return protoShapeToDimensions(typeInfo.getPlaintext().getShape());
+  } else if (typeInfo.hasLweCiphertext()) {
+    auto dimensions = protoShapeToDimensions(
+        typeInfo.getLweCiphertext().getConcreteShape());
+    // Simulated ciphertexts are single integers, the lwe dimension is removed
+    if (useSimulation)
+      dimensions.pop_back();
+    return dimensions;
+  }
+  assert(false);
+}
+
+/// Returns true if the values returned through the gate `output` can be
+/// passed as they are through the gate `input`, i.e. if both gates hold
+/// values of the same kind, shape and element type, and ciphertexts
+/// encrypted with the same key.
+bool canFeedOutputToInput(concreteprotocol::GateInfo::Reader output,
+                          concreteprotocol::GateInfo::Reader input,
+                          bool useSimulation) {
+  auto outputType = output.getTypeInfo();
+  auto inputType = input.getTypeInfo();
+  if (outputType.hasIndex() != inputType.hasIndex() ||
+      outputType.hasPlaintext() != inputType.hasPlaintext() ||
+      outputType.hasLweCiphertext() != inputType.hasLweCiphertext())
+    return false;
+  if (outputType.hasLweCiphertext() &&
+      outputType.getLweCiphertext().getEncryption().getKeyId() !=
+          inputType.getLweCiphertext().getEncryption().getKeyId())
+    return false;
+  return getGateIntegerPrecision(output) == getGateIntegerPrecision(input) &&
+         getGateIsSigned(output) == getGateIsSigned(input) &&
+         getGateShape(output, useSimulation) ==
+             getGateShape(input, useSimulation);
+}
+
+/// Allocates a zero filled value of the given element type and shape.
+Value allocateValue(size_t precision, bool isSigned,
+                    std::vector<size_t> dimensions) {
+  if (isSigned) {
+    if (precision == 8) {
+      return Value{Tensor<int8_t>::fromDimensions(dimensions)};
+    } else if (precision == 16) {
+      return Value{Tensor<int16_t>::fromDimensions(dimensions)};
+    } else if (precision == 32) {
+      return Value{Tensor<int32_t>::fromDimensions(dimensions)};
+    } else if (precision == 64) {
+      return Value{Tensor<int64_t>::fromDimensions(dimensions)};
+    }
+  } else {
+    if (precision == 8) {
+      return Value{Tensor<uint8_t>::fromDimensions(dimensions)};
+    } else if (precision == 16) {
+      return Value{Tensor<uint16_t>::fromDimensions(dimensions)};
+    } else if (precision == 32) {
+      return Value{Tensor<uint32_t>::fromDimensions(dimensions)};
+    } else if (precision == 64) {
+      return Value{Tensor<uint64_t>::fromDimensions(dimensions)};
+    }
+  }
+  assert(false);
+}
+
+namespace {
+
+/// Returns the size of the serialized `values`, in bytes.
+uint64_t transportSize(const std::vector<TransportValue> &values) {
+  uint64_t size = 0;
+  for (auto &value : values)
+    size += value.asReader().totalSize().wordCount * sizeof(capnp::word);
+  return size;
+}
+
+/// Records a call in the metrics of its circuit, if any, once destroyed: as
+/// failed unless `succeeded` was called.
+class CallRecorder {
+public:
+  CallRecorder(CircuitMetrics *metrics, uint64_t argumentBytes)
+      : metrics(metrics), argumentBytes(argumentBytes),
+        start(std::chrono::steady_clock::now()) {}
+
+  ~CallRecorder() {
+    if (metrics == nullptr)
+      return;
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    metrics->recordCall(success, nanoseconds, argumentBytes, returnBytes);
+  }
+
+  void succeeded(uint64_t returnBytes) {
+    success = true;
+    this->returnBytes = returnBytes;
+  }
+
+private:
+  CircuitMetrics *metrics;
+  uint64_t argumentBytes;
+  uint64_t returnBytes = 0;
+  bool success = false;
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace
+
 Result<std::vector<TransportValue>>
 ServerCircuit::call(const ServerKeyset &serverKeyset,
                     std::vector<TransportValue> &args) {
-  std::vector<TransportValue> returns(returnsBuffer.size());
+  std::shared_ptr<RuntimeContext> runtimeContext;
+  if (mlir::concretelang::dfr::_dfr_is_root_node())
+    runtimeContext = contextCache->get(serverKeyset);
+  return callWithContext(runtimeContext.get(), args);
+}
+
+Result<ArgStream> ServerCircuit::prepareArgStream(size_t pos,
+                                                 const TransportValue &header) {
+  if (pos >= streamArgTransformers.size()) {
+    return StringError("Tried to prepare an argument for incorrect position.");
+  }
+  if (!streamArgTransformers[pos]) {
+    return StringError("Tried to stream a non-ciphertext argument.");
+  }
+  return streamArgTransformers[pos](header);
+}
+
+Result<Value> ServerCircuit::prepareArg(size_t pos,
+                                        const TransportValue &arg) {
+  if (pos >= argTransformers.size()) {
+    return StringError("Tried to prepare an argument for incorrect position.");
+  }
+  return argTransformers[pos](arg);
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::callWithArgs(const ServerKeyset &serverKeyset,
+                            std::vector<Value> &args) {
+  if (runRemoteScheduler())
+    return std::vector<TransportValue>(returnTransformers.size());
+  // The arguments were transformed, and possibly streamed, beforehand
+  CallRecorder recorder(metrics.get(), 0);
+  if (args.size() != argTransformers.size()) {
+    return StringError("Called circuit with wrong number of arguments");
+  }
+  auto runtimeContext = contextCache->get(serverKeyset);
+  auto result = callWithContext(runtimeContext.get(), args);
+  if (result.has_value())
+    recorder.succeeded(transportSize(result.value()));
+  return result;
+}
+
+Result<std::vector<std::vector<TransportValue>>>
+ServerCircuit::callBatch(const ServerKeyset &serverKeyset,
+                         std::vector<std::vector<TransportValue>> &batch) {
+  std::vector<std::vector<TransportValue>> returns(batch.size());
+  auto results = callEach(serverKeyset, batch);
+  for (size_t i = 0; i < results.size(); i++) {
+    OUTCOME_TRY(returns[i], std::move(results[i]));
+  }
+  return returns;
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::callRepeated(const ServerKeyset &serverKeyset,
+                            std::vector<TransportValue> &args, size_t n) {
+  if (n == 0)
+    return args;
+  if (runRemoteScheduler())
+    return std::vector<TransportValue>(returnTransformers.size());
+
+  auto inputs = circuitInfo.asReader().getInputs();
+  auto outputs = circuitInfo.asReader().getOutputs();
+  if (inputs.size() != outputs.size()) {
+    return StringError("Cannot compose a circuit with ")
+           << inputs.size() << " arguments and " << outputs.size()
+           << " outputs";
+  }
+  for (size_t i = 0; i < outputs.size(); i++) {
+    if (!canFeedOutputToInput(outputs[i], inputs[i], useSimulation)) {
+      return StringError("Cannot compose the output ")
+             << i << " of the circuit with its argument " << i;
+    }
+  }
+
+  CallRecorder recorder(metrics.get(), transportSize(args));
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      contextCache->get(serverKeyset);
+  OUTCOME_TRY(auto argsBuffer, transformArgs(args));
+  // The outputs of a call are the arguments of the next one
+  std::vector<Value> returnsBuffer(outputs.size());
+  for (size_t i = 0; i < n; i++) {
+    invoke(runtimeContext.get(), argsBuffer, returnsBuffer);
+    std::swap(argsBuffer, returnsBuffer);
+  }
+  OUTCOME_TRY(auto returns,
+              transformReturns(runtimeContext.get(), argsBuffer));
+  recorder.succeeded(transportSize(returns));
+  return returns;
+}
+
+std::vector<Result<std::vector<TransportValue>>>
+ServerCircuit::callEach(const ServerKeyset &serverKeyset,
+                        std::vector<std::vector<TransportValue>> &batch) {
+  std::vector<Result<std::vector<TransportValue>>> returns;
+  returns.reserve(batch.size());
   mlir::concretelang::dfr::_dfr_register_lib(dynamicModule->libraryHandle);
   if (!mlir::concretelang::dfr::_dfr_is_root_node()) {
     mlir::concretelang::dfr::_dfr_run_remote_scheduler();
+    for (size_t i = 0; i < batch.size(); i++)
+      returns.push_back(std::vector<TransportValue>());
     return returns;
   }
 
-  if (args.size() != argsBuffer.size()) {
-    return StringError("Called circuit with wrong number of arguments");
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      contextCache->get(serverKeyset);
+
+  // The distributed runtime synchronizes all the nodes on each call, so
+  // calls cannot overlap there.
+  if (mlir::concretelang::dfr::_dfr_is_distributed()) {
+    for (size_t i = 0; i < batch.size(); i++) {
+      returns.push_back(callWithContext(runtimeContext.get(), batch[i]));
+    }
+    return returns;
   }
 
-  // We load the processed arguments in the args buffer.
-  for (size_t i = 0; i < argsBuffer.size(); i++) {
-    OUTCOME_TRY(argsBuffer[i], argTransformers[i](args[i]));
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(
+      batch.size());
+  std::vector<mlir::concretelang::async::Future *> futures;
+  for (size_t i = 0; i < batch.size(); i++)
+    futures.push_back(mlir::concretelang::async::submit([&, i]() {
+      results[i] = callWithContext(runtimeContext.get(), batch[i]);
+    }));
+  for (auto future : futures)
+    mlir::concretelang::async::await(future);
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    returns.push_back(std::move(*results[i]));
+  }
+  return returns;
+}
+
+namespace {
+
+/// Thread pool running the asynchronous calls, with a bounded queue.
+class CallPool {
+public:
+  CallPool() {
+    size_t count = envSize("CONCRETE_SERVER_THREADS",
+                           std::max(std::thread::hardware_concurrency(), 1u));
+    depth = envSize("CONCRETE_SERVER_QUEUE_DEPTH", 4 * count);
+    for (size_t i = 0; i < count; i++)
+      threads.emplace_back([this] { work(); });
+  }
+
+  ~CallPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    notEmpty.notify_all();
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  /// Queues `task`, waiting for room in the queue if it is full. On the
+  /// threads of the pool, e.g. in the callback of a call, `task` runs inline
+  /// instead, as the threads waiting for each other would never free the
+  /// queue.
+  void push(std::function<void()> task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (onPoolThread && tasks.size() >= depth) {
+      lock.unlock();
+      task();
+      return;
+    }
+    notFull.wait(lock, [this] { return tasks.size() < depth; });
+    tasks.push_back(std::move(task));
+    notEmpty.notify_one();
+  }
+
+private:
+  static size_t envSize(const char *name, size_t defaultValue) {
+    if (const char *env = std::getenv(name)) {
+      long value = std::strtol(env, nullptr, 10);
+      if (value > 0)
+        return value;
+    }
+    return defaultValue;
   }
 
+  void work() {
+    onPoolThread = true;
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty())
+          return;
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      notFull.notify_one();
+      task();
+    }
+  }
+
+  std::vector<std::thread> threads;
+  std::deque<std::function<void()>> tasks;
+  size_t depth;
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  bool stopping = false;
+  static thread_local bool onPoolThread;
+};
+
+thread_local bool CallPool::onPoolThread = false;
+
+CallPool &callPool() {
+  static CallPool instance;
+  return instance;
+}
+
+} // namespace
+
+void ServerCircuit::callAsync(
+    const ServerKeyset &serverKeyset, std::vector<TransportValue> args,
+    std::function<void(Result<std::vector<TransportValue>>)> callback) {
+  // The circuit and the keyset are copied, they share their data with the
+  // originals, so that the caller does not have to keep them alive.
+  callPool().push([circuit = *this, serverKeyset, args = std::move(args),
+                   callback = std::move(callback)]() mutable {
+    callback(circuit.call(serverKeyset, args));
+  });
+}
+
+std::future<Result<std::vector<TransportValue>>>
+ServerCircuit::callAsync(const ServerKeyset &serverKeyset,
+                         std::vector<TransportValue> args) {
+  auto promise =
+      std::make_shared<std::promise<Result<std::vector<TransportValue>>>>();
+  auto future = promise->get_future();
+  callAsync(serverKeyset, std::move(args),
+            [promise](Result<std::vector<TransportValue>> result) {
+              promise->set_value(std::move(result));
+            });
+  return future;
+}
+
+std::unique_ptr<CircuitStream>
+ServerCircuit::openStream(const ServerKeyset &serverKeyset) {
+  return std::make_unique<CircuitStream>(*this, serverKeyset);
+}
+
+CircuitStream::CircuitStream(ServerCircuit circuit, ServerKeyset serverKeyset)
+    : circuit(std::move(circuit)), serverKeyset(std::move(serverKeyset)),
+      session(stream_emulator_open_session()) {}
+
+CircuitStream::~CircuitStream() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending == 0; });
+  }
+  if (session != nullptr)
+    stream_emulator_close_session(session);
+}
+
+std::future<Result<std::vector<TransportValue>>>
+CircuitStream::submit(std::vector<TransportValue> args) {
+  auto promise =
+      std::make_shared<std::promise<Result<std::vector<TransportValue>>>>();
+  auto future = promise->get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending++;
+  }
+  callPool().push([this, args = std::move(args), promise]() mutable {
+    // The SDFG init of the call joins the graph of the session
+    stream_emulator_set_session(session);
+    auto result = circuit.call(serverKeyset, args);
+    stream_emulator_set_session(nullptr);
+    promise->set_value(std::move(result));
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0)
+      idle.notify_all();
+  });
+  return future;
+}
+
+Result<std::vector<TransportValue>>
+CircuitStream::call(std::vector<TransportValue> args) {
+  return submit(std::move(args)).get();
+}
+
+Result<size_t> CallGraph::addCall(ServerCircuit circuit,
+                                  std::vector<Source> sources) {
+  if (sources.size() != circuit.argTransformers.size()) {
+    return StringError("Added a call with wrong number of arguments");
+  }
+  for (auto &source : sources) {
+    if (source.call == GRAPH_ARGUMENT) {
+      argumentCount = std::max(argumentCount, source.pos + 1);
+      continue;
+    }
+    if (source.call >= calls.size()) {
+      return StringError("Added a call taking an argument from a later call");
+    }
+    if (source.pos >= calls[source.call].circuit.returnTransformers.size()) {
+      return StringError("Added a call taking an unknown output of a call");
+    }
+  }
+  calls.push_back(Call{std::move(circuit), std::move(sources)});
+  return calls.size() - 1;
+}
+
+Result<std::vector<std::vector<TransportValue>>>
+CallGraph::run(const ServerKeyset &serverKeyset,
+               const std::vector<TransportValue> &args) {
+  if (args.size() < argumentCount) {
+    return StringError("Ran call graph with wrong number of arguments");
+  }
+
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(
+      calls.size());
+  std::vector<size_t> missing(calls.size(), 0);
+  std::vector<std::vector<size_t>> dependents(calls.size());
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < calls.size(); i++) {
+    for (auto &source : calls[i].sources) {
+      if (source.call != GRAPH_ARGUMENT) {
+        missing[i]++;
+        dependents[source.call].push_back(i);
+      }
+    }
+    if (missing[i] == 0)
+      ready.push_back(i);
+  }
+
+  // The calls are submitted from this thread only, as a pool thread waiting
+  // for room in the queue of the pool could deadlock it
+  std::mutex mutex;
+  std::condition_variable completed;
+  size_t inFlight = 0;
+  bool failed = false;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    while (!ready.empty() && !failed) {
+      auto i = ready.front();
+      ready.pop_front();
+      inFlight++;
+      lock.unlock();
+      // The outputs of the sources are complete, and no longer written
+      std::vector<TransportValue> callArgs;
+      for (auto &source : calls[i].sources) {
+        callArgs.push_back(source.call == GRAPH_ARGUMENT
+                               ? args[source.pos]
+                               : results[source.call]->value()[source.pos]);
+      }
+      calls[i].circuit.callAsync(
+          serverKeyset, std::move(callArgs),
+          [&, i](Result<std::vector<TransportValue>> result) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (result.has_value()) {
+              for (auto dependent : dependents[i])
+                if (--missing[dependent] == 0)
+                  ready.push_back(dependent);
+            } else {
+              failed = true;
+            }
+            results[i] = std::move(result);
+            inFlight--;
+            completed.notify_one();
+          });
+      lock.lock();
+    }
+    if (inFlight == 0)
+      break;
+    completed.wait(lock);
+  }
+
+  std::vector<std::vector<TransportValue>> outputs(calls.size());
+  for (size_t i = 0; i < calls.size(); i++) {
+    if (results[i] && results[i]->has_failure())
+      return results[i]->as_failure();
+  }
+  for (size_t i = 0; i < calls.size(); i++) {
+    outputs[i] = std::move(results[i]->value());
+  }
+  return outputs;
+}
+
+bool ServerCircuit::runRemoteScheduler() {
+  mlir::concretelang::dfr::_dfr_register_lib(dynamicModule->libraryHandle);
+  if (!mlir::concretelang::dfr::_dfr_is_root_node()) {
+    mlir::concretelang::dfr::_dfr_run_remote_scheduler();
+    return true;
+  }
+  return false;
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::callWithContext(RuntimeContext *runtimeContext,
+                               std::vector<TransportValue> &args) {
+  if (runRemoteScheduler())
+    return std::vector<TransportValue>(returnTransformers.size());
+
+  CallRecorder recorder(metrics.get(), transportSize(args));
+  OUTCOME_TRY(auto argsBuffer, transformArgs(args));
+  auto result = callWithContext(runtimeContext, argsBuffer);
+  if (result.has_value())
+    recorder.succeeded(transportSize(result.value()));
+  return result;
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::callWithContext(RuntimeContext *runtimeContext,
+                               std::vector<Value> &argsBuffer) {
+  size_t numReturns = returnTransformers.size();
+
   // The arguments has been pushed in the arg buffer, we are now ready to
   // invoke the circuit function.
-  invoke(serverKeyset);
+  std::vector<Value> returnsBuffer(numReturns);
+  invoke(runtimeContext, argsBuffer, returnsBuffer);
+  return transformReturns(runtimeContext, returnsBuffer);
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::transformReturns(RuntimeContext *runtimeContext,
+                                std::vector<Value> &returnsBuffer) {
+  std::vector<TransportValue> returns(returnsBuffer.size());
 
   // We process the return values to turn them into transport values.
   for (size_t i = 0; i < returnsBuffer.size(); i++) {
-    OUTCOME_TRY(returns[i], returnTransformers[i](returnsBuffer[i]));
+    OUTCOME_TRY(returns[i], transformReturn(runtimeContext, i,
+                                            std::move(returnsBuffer[i])));
   }
 
   return returns;
 }
 
+Result<TransportValue>
+ServerCircuit::transformReturn(RuntimeContext *runtimeContext, size_t pos,
+                               Value &&value) {
+  // The ciphertexts are packed if the keyset holds the packing key of the
+  // gate.
+  const GlwePackingKeyswitchKey *packingKey = nullptr;
+  if (packingReturnTransformers[pos])
+    packingKey = runtimeContext->glwe_packing_keyswitch_key(
+        circuitInfo.asReader()
+            .getOutputs()[pos]
+            .getTypeInfo()
+            .getLweCiphertext()
+            .getPacking()
+            .getKeyId());
+  if (packingKey != nullptr)
+    return packingReturnTransformers[pos](std::move(value), *packingKey);
+  return returnTransformers[pos](std::move(value));
+}
+
+Result<void> ServerCircuit::callWithEarlyOutputs(
+    const ServerKeyset &serverKeyset, std::vector<TransportValue> &args,
+    std::function<void(size_t, Result<TransportValue>)> onOutput) {
+  if (runRemoteScheduler())
+    return outcome::success();
+
+  CallRecorder recorder(metrics.get(), transportSize(args));
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      contextCache->get(serverKeyset);
+  OUTCOME_TRY(auto argsBuffer, transformArgs(args));
+
+  // The outputs passed as destinations are allocated here, so that the
+  // buffers signaled by the circuit are mapped back to their output.
+  size_t numOutputs = returnTransformers.size();
+  std::vector<Value> returnsBuffer(numOutputs);
+  std::vector<void *> destinations(numOutputs, nullptr);
+  for (size_t i = 0; i < numOutputs; i++) {
+    if (!isPassedAsDestination(i))
+      continue;
+    auto gateInfo = circuitInfo.asReader().getOutputs()[i];
+    returnsBuffer[i] =
+        allocateValue(getGateIntegerPrecision(gateInfo),
+                      getGateIsSigned(gateInfo), returnShapes[i]);
+    destinations[i] = std::visit(
+        [](auto &tensor) -> void * { return tensor.values.data(); },
+        returnsBuffer[i].inner);
+  }
+
+  std::vector<bool> delivered(numOutputs, false);
+  uint64_t returnBytes = 0;
+  auto deliver = [&](size_t pos) {
+    delivered[pos] = true;
+    auto result = transformReturn(runtimeContext.get(), pos,
+                                  std::move(returnsBuffer[pos]));
+    if (result.has_value())
+      returnBytes += result.value().asReader().totalSize().wordCount *
+                     sizeof(capnp::word);
+    onOutput(pos, std::move(result));
+  };
+
+  mlir::concretelang::OutputReadyListener listener = [&](void *buffer) {
+    for (size_t i = 0; i < numOutputs; i++) {
+      if (destinations[i] == buffer && !delivered[i])
+        deliver(i);
+    }
+  };
+  {
+    mlir::concretelang::OutputReadyScope scope(&listener);
+    invoke(runtimeContext.get(), argsBuffer, returnsBuffer, destinations);
+  }
+
+  // The scalar outputs, and those of the circuits not compiled in
+  // destination-passing mode, are only available once the call returns.
+  for (size_t i = 0; i < numOutputs; i++) {
+    if (!delivered[i])
+      deliver(i);
+  }
+  recorder.succeeded(returnBytes);
+  return outcome::success();
+}
+
+Result<void> ServerCircuit::callInto(const ServerKeyset &serverKeyset,
+                                     std::vector<TransportValue> &args,
+                                     std::vector<OutputBuffer> &outputs) {
+  mlir::concretelang::dfr::_dfr_register_lib(dynamicModule->libraryHandle);
+  if (!mlir::concretelang::dfr::_dfr_is_root_node()) {
+    mlir::concretelang::dfr::_dfr_run_remote_scheduler();
+    return outcome::success();
+  }
+
+  CallRecorder recorder(metrics.get(), transportSize(args));
+  if (outputs.size() != returnTransformers.size()) {
+    return StringError("Called circuit with wrong number of output buffers");
+  }
+  std::vector<void *> destinations(outputs.size(), nullptr);
+  for (size_t i = 0; i < outputs.size(); i++) {
+    if (outputs[i].size != getOutputBufferSize(i)) {
+      return StringError("Output buffer ")
+             << i << " has size " << outputs[i].size << " instead of "
+             << getOutputBufferSize(i);
+    }
+    if (!isPassedAsDestination(i))
+      continue;
+    auto gateInfo = circuitInfo.asReader().getOutputs()[i];
+    size_t elementSize = getGateIntegerPrecision(gateInfo) / 8;
+    if (reinterpret_cast<uintptr_t>(outputs[i].data) % elementSize != 0) {
+      return StringError("Output buffer ")
+             << i << " is not aligned on its element size";
+    }
+    destinations[i] = outputs[i].data;
+  }
+
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      contextCache->get(serverKeyset);
+  OUTCOME_TRY(auto argsBuffer, transformArgs(args));
+  std::vector<Value> returnsBuffer(outputs.size());
+  invoke(runtimeContext.get(), argsBuffer, returnsBuffer, destinations);
+
+  // The outputs which were not computed in place are copied to their buffer.
+  for (size_t i = 0; i < outputs.size(); i++) {
+    if (!isPassedAsDestination(i))
+      InvocationDescriptor::fromValue(returnsBuffer[i])
+          .copyInto(outputs[i].data);
+  }
+  uint64_t returnBytes = 0;
+  for (auto &output : outputs)
+    returnBytes += output.size;
+  recorder.succeeded(returnBytes);
+  return outcome::success();
+}
+
+size_t ServerCircuit::getOutputBufferSize(size_t pos) {
+  size_t length = 1;
+  for (auto dim : returnShapes[pos])
+    length *= dim;
+  auto gateInfo = circuitInfo.asReader().getOutputs()[pos];
+  return length * getGateIntegerPrecision(gateInfo) / 8;
+}
+
+bool ServerCircuit::isPassedAsDestination(size_t pos) {
+  return destinationPassing && returnDescriptorSizes[pos] > 1;
+}
+
+Result<std::vector<Value>>
+ServerCircuit::transformArgs(std::vector<TransportValue> &args) {
+  if (args.size() != argTransformers.size()) {
+    return StringError("Called circuit with wrong number of arguments");
+  }
+
+  // We load the processed arguments in the args buffer of this call.
+  std::vector<Value> argsBuffer(args.size());
+  for (size_t i = 0; i < argsBuffer.size(); i++) {
+    OUTCOME_TRY(argsBuffer[i], argTransformers[i](args[i]));
+  }
+  return argsBuffer;
+}
+
 Result<std::vector<TransportValue>>
 ServerCircuit::simulate(std::vector<TransportValue> &args) {
   ServerKeyset emptyKeyset;
   return call(emptyKeyset, args);
 }
 
+Result<std::vector<std::vector<TransportValue>>>
+ServerCircuit::simulateDataset(
+    std::vector<std::vector<TransportValue>> &dataset, uint64_t seed) {
+  if (!useSimulation) {
+    return StringError("Tried to simulate a circuit which was not compiled "
+                       "for simulation.");
+  }
+  ServerKeyset emptyKeyset;
+  std::shared_ptr<RuntimeContext> runtimeContext =
+      contextCache->get(emptyKeyset);
+
+  // The statistics of the simulation are those of the process, the scope of
+  // the dataset keeps them current while the scopes of the concurrent
+  // simulations restore each other's.
+  mlir::concretelang::SimulationStatisticsScope simulationScope(
+      simulationStatistics.get());
+
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(
+      dataset.size());
+  std::vector<mlir::concretelang::async::Future *> futures;
+  for (size_t i = 0; i < dataset.size(); i++)
+    futures.push_back(mlir::concretelang::async::submit([&, i]() {
+      if (seed != 0)
+        mlir::concretelang::setSimulationSeed(((__uint128_t)seed << 64) | i);
+      results[i] = callWithContext(runtimeContext.get(), dataset[i]);
+    }));
+  for (auto future : futures)
+    mlir::concretelang::async::await(future);
+
+  std::vector<std::vector<TransportValue>> returns(dataset.size());
+  for (size_t i = 0; i < dataset.size(); i++) {
+    OUTCOME_TRY(returns[i], std::move(*results[i]));
+  }
+  return returns;
+}
+
 std::string ServerCircuit::getName() {
   return circuitInfo.asReader().getName();
 }
 
+std::vector<std::string> ServerCircuit::getVariants() {
+  std::vector<std::string> names;
+  for (auto variant : circuitInfo.asReader().getVariants())
+    names.push_back(variant.getName());
+  return names;
+}
+
+std::string ServerCircuit::getSelectedVariant() {
+  size_t index = selectedVariant.index.load();
+  if (index == 0)
+    return "";
+  return circuitInfo.asReader().getVariants()[index - 1].getName();
+}
+
+Result<void> ServerCircuit::selectVariant(const std::string &name) {
+  if (name.empty()) {
+    selectedVariant.index.store(0);
+    return outcome::success();
+  }
+  auto variants = circuitInfo.asReader().getVariants();
+  for (size_t i = 0; i < variants.size(); i++) {
+    if (std::string(variants[i].getName().cStr()) == name) {
+      selectedVariant.index.store(i + 1);
+      return outcome::success();
+    }
+  }
+  return StringError("Unknown execution variant ")
+         << name << " of circuit " << getName();
+}
+
+bool ServerCircuit::isVariantAvailable(
+    const concreteprotocol::ExecutionVariant::Reader &variant) {
+  if (!variant.getGpu())
+    return true;
+  static bool gpus =
+      mlir::concretelang::gpu_dfg::check_cuda_device_available();
+  return gpus;
+}
+
+std::string ServerCircuit::getHostVariant() {
+  auto variants = circuitInfo.asReader().getVariants();
+  if (const char *env = std::getenv("CONCRETE_EXECUTION_VARIANT")) {
+    if (std::string(env) == "default")
+      return "";
+    for (auto variant : variants) {
+      if (std::string(variant.getName().cStr()) == env)
+        return env;
+    }
+  }
+  for (auto variant : variants) {
+    if (variant.getGpu() && isVariantAvailable(variant))
+      return variant.getName();
+  }
+  if (std::thread::hardware_concurrency() > 1) {
+    for (auto variant : variants) {
+      if (!variant.getGpu() && variant.getParallel())
+        return variant.getName();
+    }
+  }
+  for (auto variant : variants) {
+    if (!variant.getGpu() && !variant.getParallel())
+      return variant.getName();
+  }
+  return "";
+}
+
+Result<std::string>
+ServerCircuit::calibrateVariants(const ServerKeyset &serverKeyset,
+                                 std::vector<TransportValue> &args,
+                                 size_t repetitions) {
+  std::vector<std::string> candidates = {""};
+  for (auto variant : circuitInfo.asReader().getVariants()) {
+    if (isVariantAvailable(variant))
+      candidates.push_back(variant.getName());
+  }
+
+  std::string previous = getSelectedVariant();
+  std::string fastest;
+  double fastestTime = std::numeric_limits<double>::infinity();
+  for (auto &candidate : candidates) {
+    OUTCOME_TRYV(selectVariant(candidate));
+    // The first call prepares the keys of the variant, e.g. on the GPUs
+    auto warmup = call(serverKeyset, args);
+    if (warmup.has_failure()) {
+      OUTCOME_TRYV(selectVariant(previous));
+      return warmup.as_failure();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; i++) {
+      auto result = call(serverKeyset, args);
+      if (result.has_failure()) {
+        OUTCOME_TRYV(selectVariant(previous));
+        return result.as_failure();
+      }
+    }
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    if (time.count() < fastestTime) {
+      fastestTime = time.count();
+      fastest = candidate;
+    }
+  }
+  OUTCOME_TRYV(selectVariant(fastest));
+  return fastest;
+}
+
+void ServerCircuit::enablePrimitiveStatistics(bool enable,
+                                              bool hardwareCounters) {
+  if (!enable)
+    primitiveStatistics = nullptr;
+  else if (primitiveStatistics == nullptr ||
+           primitiveStatistics->countsHardwareEvents() != hardwareCounters)
+    primitiveStatistics =
+        std::make_shared<mlir::concretelang::PrimitiveStatistics>(
+            hardwareCounters);
+}
+
+std::vector<mlir::concretelang::PrimitiveStatistic>
+ServerCircuit::getPrimitiveStatistics() {
+  if (primitiveStatistics == nullptr)
+    return {};
+  return primitiveStatistics->get();
+}
+
+void ServerCircuit::resetPrimitiveStatistics() {
+  if (primitiveStatistics != nullptr)
+    primitiveStatistics->reset();
+}
+
+void ServerCircuit::enableSimulationStatistics(bool enable) {
+  if (!enable)
+    simulationStatistics = nullptr;
+  else if (simulationStatistics == nullptr)
+    simulationStatistics =
+        std::make_shared<mlir::concretelang::SimulationStatistics>();
+}
+
+std::vector<mlir::concretelang::SimulationStatistic>
+ServerCircuit::getSimulationStatistics() {
+  if (simulationStatistics == nullptr)
+    return {};
+  return simulationStatistics->get();
+}
+
+void ServerCircuit::resetSimulationStatistics() {
+  if (simulationStatistics != nullptr)
+    simulationStatistics->reset();
+}
+
 Result<ServerCircuit> ServerCircuit::fromDynamicModule(
-    const Message<concreteprotocol::CircuitInfo> &circuitInfo,
+    const SharedReader<concreteprotocol::CircuitInfo> &circuitInfo,
     std::shared_ptr<DynamicModule> dynamicModule, bool useSimulation = false) {
 
   ServerCircuit output;
   output.circuitInfo = circuitInfo;
   output.useSimulation = useSimulation;
   output.dynamicModule = dynamicModule;
-  output.func = (void (*)(void *, ...))dlsym(
-      dynamicModule->libraryHandle,
-      (std::string("_mlir_concrete_") +
-       std::string(circuitInfo.asReader().getName().cStr()))
-          .c_str());
-  if (auto err = dlerror()) {
+  output.destinationPassing = circuitInfo.asReader().getDestinationPassing();
+  auto symbol = dynamicModule->lookup(
+      std::string("_mlir_concrete_") +
+      std::string(circuitInfo.asReader().getName().cStr()));
+  if (!symbol.has_value()) {
     return StringError("Circuit symbol not found in dynamic module: ")
-           << std::string(err);
+           << symbol.error().mesg;
+  }
+  output.defaultFunc = (void (*)(void *, ...))symbol.value();
+
+  // The functions of the execution variants are suffixed by their name
+  for (auto variant : circuitInfo.asReader().getVariants()) {
+    auto variantSymbol = dynamicModule->lookup(
+        std::string("_mlir_concrete_") +
+        std::string(circuitInfo.asReader().getName().cStr()) + "__" +
+        std::string(variant.getName().cStr()));
+    if (!variantSymbol.has_value()) {
+      return StringError("Execution variant symbol not found in dynamic "
+                         "module: ")
+             << variantSymbol.error().mesg;
+    }
+    output.variantFuncs.push_back(
+        (void (*)(void *, ...))variantSymbol.value());
+  }
+  if (!useSimulation) {
+    OUTCOME_TRYV(output.selectVariant(output.getHostVariant()));
   }
 
   // We prepare the args transformers used to transform transport values into
   // arg values.
   for (auto gateInfo : circuitInfo.asReader().getInputs()) {
     ArgTransformer transformer;
+    StreamArgTransformer streamTransformer;
     if (gateInfo.getTypeInfo().hasIndex()) {
       OUTCOME_TRY(transformer,
                   TransformerFactory::getIndexArgTransformer(
@@ -505,10 +1438,15 @@ Result<ServerCircuit> ServerCircuit::fromDynamicModule(
           transformer,
           TransformerFactory::getLweCiphertextArgTransformer(
               (Message<concreteprotocol::GateInfo>)gateInfo, useSimulation));
+      OUTCOME_TRY(
+          streamTransformer,
+          TransformerFactory::getLweCiphertextStreamArgTransformer(
+              (Message<concreteprotocol::GateInfo>)gateInfo, useSimulation));
     } else {
       return StringError("Malformed input gate info.");
     }
     output.argTransformers.push_back(transformer);
+    output.streamArgTransformers.push_back(streamTransformer);
   }
 
   // We prepare the return transformers used to transform return values into
@@ -532,38 +1470,185 @@ Result<ServerCircuit> ServerCircuit::fromDynamicModule(
       return StringError("Malformed input gate info.");
     }
     output.returnTransformers.push_back(transformer);
-  }
 
-  output.argsBuffer =
-      std::vector<Value>(circuitInfo.asReader().getInputs().size());
-  output.returnsBuffer =
-      std::vector<Value>(circuitInfo.asReader().getOutputs().size());
+    PackingReturnTransformer packingTransformer;
+    if (!useSimulation && gateInfo.getTypeInfo().hasLweCiphertext() &&
+        gateInfo.getTypeInfo().getLweCiphertext().getCompression() ==
+            concreteprotocol::Compression::GLWE_PACKING) {
+      OUTCOME_TRY(packingTransformer,
+                  TransformerFactory::getLweCiphertextPackingReturnTransformer(
+                      (Message<concreteprotocol::GateInfo>)gateInfo));
+    }
+    output.packingReturnTransformers.push_back(packingTransformer);
+  }
 
   output.argRawSize = 0;
   for (auto gateInfo : circuitInfo.asReader().getInputs()) {
-    auto descriptorSize = getGateDescriptionSize(
-        (Message<concreteprotocol::GateInfo>)gateInfo, useSimulation);
+    auto descriptorSize = getGateDescriptionSize(gateInfo, useSimulation);
     output.argDescriptorSizes.push_back(descriptorSize);
     output.argRawSize += descriptorSize;
   }
 
   output.returnRawSize = 0;
+  output.destinationRawSize = 0;
   for (auto gateInfo : circuitInfo.asReader().getOutputs()) {
-    auto descriptorSize = getGateDescriptionSize(
-        (Message<concreteprotocol::GateInfo>)gateInfo, useSimulation);
+    auto descriptorSize = getGateDescriptionSize(gateInfo, useSimulation);
     output.returnDescriptorSizes.push_back(descriptorSize);
-    output.returnRawSize += descriptorSize;
+    output.returnShapes.push_back(getGateShape(gateInfo, useSimulation));
+    if (output.isPassedAsDestination(output.returnDescriptorSizes.size() - 1))
+      output.destinationRawSize += descriptorSize;
+    else
+      output.returnRawSize += descriptorSize;
   }
 
   return output;
 }
 
-void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
+/// Keys are shared between the copies of a keyset, so two keysets hold the
+/// same keys if their buffers are the same.
+static bool holdSameKeys(const ServerKeyset &lhs, const ServerKeyset &rhs) {
+  if (lhs.lweBootstrapKeys.size() != rhs.lweBootstrapKeys.size() ||
+      lhs.lweKeyswitchKeys.size() != rhs.lweKeyswitchKeys.size() ||
+      lhs.packingKeyswitchKeys.size() != rhs.packingKeyswitchKeys.size() ||
+      lhs.glwePackingKeyswitchKeys.size() !=
+          rhs.glwePackingKeyswitchKeys.size())
+    return false;
+  // The bootstrap keys may have been released by the contexts
+  for (size_t i = 0; i < lhs.lweBootstrapKeys.size(); i++)
+    if (!lhs.lweBootstrapKeys[i].isSameKey(rhs.lweBootstrapKeys[i]))
+      return false;
+  for (size_t i = 0; i < lhs.lweKeyswitchKeys.size(); i++)
+    if (lhs.lweKeyswitchKeys[i].getTransportBuffer().data() !=
+        rhs.lweKeyswitchKeys[i].getTransportBuffer().data())
+      return false;
+  for (size_t i = 0; i < lhs.packingKeyswitchKeys.size(); i++)
+    if (lhs.packingKeyswitchKeys[i].getRawPtr() !=
+        rhs.packingKeyswitchKeys[i].getRawPtr())
+      return false;
+  for (size_t i = 0; i < lhs.glwePackingKeyswitchKeys.size(); i++)
+    if (lhs.glwePackingKeyswitchKeys[i].getRawPtr() !=
+        rhs.glwePackingKeyswitchKeys[i].getRawPtr())
+      return false;
+  return true;
+}
 
-  // We create a runtime context from the keyset, and place a pointer to it in
-  // the structure.
-  RuntimeContext runtimeContext = RuntimeContext(serverKeyset);
-  RuntimeContext *_runtimeContextPtr = &runtimeContext;
+std::shared_ptr<RuntimeContext>
+RuntimeContextCache::lookup(const ServerKeyset &serverKeyset) {
+  for (auto it = contexts.begin(); it != contexts.end(); ++it) {
+    if (holdSameKeys((*it)->getKeys(), serverKeyset)) {
+      contexts.splice(contexts.begin(), contexts, it);
+      return contexts.front();
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<RuntimeContext>
+RuntimeContextCache::get(const ServerKeyset &serverKeyset) {
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (auto context = lookup(serverKeyset))
+      return context;
+  }
+  // The keys are prepared without holding the lock, so that calls with
+  // other keysets are not delayed.
+  auto context = std::make_shared<RuntimeContext>(serverKeyset);
+  if (metrics != nullptr)
+    metrics->recordContextCreation();
+  if (capacity == 0)
+    return context;
+  std::lock_guard<std::mutex> guard(mutex);
+  if (auto other = lookup(serverKeyset))
+    return other;
+  contexts.push_front(context);
+  if (contexts.size() > capacity)
+    contexts.pop_back();
+  return context;
+}
+
+void RuntimeContextCache::insert(std::shared_ptr<RuntimeContext> context) {
+  std::lock_guard<std::mutex> guard(mutex);
+  contexts.push_front(context);
+  if (contexts.size() > std::max<size_t>(capacity, 1))
+    contexts.pop_back();
+}
+
+CallBatcher::CallBatcher(ServerCircuit circuit,
+                         std::chrono::microseconds window, size_t maxBatchSize)
+    : circuit(std::move(circuit)), window(window),
+      maxBatchSize(std::max<size_t>(maxBatchSize, 1)) {
+  worker = std::thread([this] { work(); });
+}
+
+CallBatcher::~CallBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  pending.notify_all();
+  worker.join();
+}
+
+std::future<Result<std::vector<TransportValue>>>
+CallBatcher::submit(const ServerKeyset &serverKeyset,
+                    std::vector<TransportValue> args) {
+  Request request{serverKeyset, std::move(args),
+                  std::chrono::steady_clock::now(), {}};
+  auto future = request.promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.push_back(std::move(request));
+  }
+  pending.notify_all();
+  return future;
+}
+
+Result<std::vector<TransportValue>>
+CallBatcher::call(const ServerKeyset &serverKeyset,
+                  std::vector<TransportValue> args) {
+  return submit(serverKeyset, std::move(args)).get();
+}
+
+void CallBatcher::work() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    pending.wait(lock, [this] { return stopping || !requests.empty(); });
+    if (requests.empty())
+      return;
+    // The window opens with the oldest pending call
+    pending.wait_until(lock, requests.front().arrival + window, [this] {
+      return stopping || requests.size() >= maxBatchSize;
+    });
+    std::vector<Request> batch;
+    for (auto it = requests.begin();
+         it != requests.end() && batch.size() < maxBatchSize;) {
+      if (batch.empty() ||
+          holdSameKeys(batch.front().serverKeyset, it->serverKeyset)) {
+        batch.push_back(std::move(*it));
+        it = requests.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    lock.unlock();
+    std::vector<std::vector<TransportValue>> args;
+    args.reserve(batch.size());
+    for (auto &request : batch)
+      args.push_back(std::move(request.args));
+    auto results = circuit.callEach(batch.front().serverKeyset, args);
+    for (size_t i = 0; i < batch.size(); i++)
+      batch[i].promise.set_value(std::move(results[i]));
+    lock.lock();
+  }
+}
+
+void ServerCircuit::invoke(RuntimeContext *runtimeContext,
+                           std::vector<Value> &argsBuffer,
+                           std::vector<Value> &returnsBuffer,
+                           llvm::ArrayRef<void *> destinations) {
+
+  // We place a pointer to the runtime context in the structure.
+  RuntimeContext *_runtimeContextPtr = runtimeContext;
 
   auto _argRaws = std::vector<void *>(this->argRawSize);
   auto _argRawMaps = std::vector<llvm::MutableArrayRef<void *>>();
@@ -575,14 +1660,28 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
     currentRawIndex += descriptorSize;
   }
 
+  // In destination-passing mode, the tensor outputs are not returned but
+  // passed as descriptors of the buffers to write them to, after the
+  // runtime context.
+  auto _destinationRaws = std::vector<void *>(this->destinationRawSize);
+  auto _destinationRawMaps = std::vector<llvm::MutableArrayRef<void *>>();
   auto _returnRaws = std::vector<uint64_t>(this->returnRawSize);
   auto _returnRawMaps = std::vector<llvm::ArrayRef<uint64_t>>();
+  size_t currentDestinationRawIndex = 0;
   currentRawIndex = 0;
-  for (auto descriptorSize : this->returnDescriptorSizes) {
-    auto map =
-        llvm::ArrayRef<uint64_t>(&_returnRaws[currentRawIndex], descriptorSize);
-    _returnRawMaps.push_back(map);
-    currentRawIndex += descriptorSize;
+  for (size_t i = 0; i < this->returnDescriptorSizes.size(); i++) {
+    auto descriptorSize = this->returnDescriptorSizes[i];
+    if (isPassedAsDestination(i)) {
+      _destinationRawMaps.push_back(llvm::MutableArrayRef<void *>(
+          &_destinationRaws[currentDestinationRawIndex], descriptorSize));
+      _returnRawMaps.push_back(llvm::ArrayRef<uint64_t>());
+      currentDestinationRawIndex += descriptorSize;
+    } else {
+      _destinationRawMaps.push_back(llvm::MutableArrayRef<void *>());
+      _returnRawMaps.push_back(llvm::ArrayRef<uint64_t>(
+          &_returnRaws[currentRawIndex], descriptorSize));
+      currentRawIndex += descriptorSize;
+    }
   }
 
   auto _invocationRaws = std::vector<void *>();
@@ -590,6 +1689,9 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
     _invocationRaws.push_back(&arg);
   }
   _invocationRaws.push_back((void *)(&_runtimeContextPtr));
+  for (auto &destination : _destinationRaws) {
+    _invocationRaws.push_back(&destination);
+  }
   _invocationRaws.push_back(reinterpret_cast<void *>(_returnRaws.data()));
 
   // We load the argument descriptors in the _argRaws
@@ -601,7 +1703,37 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
     descriptor.intoOpaquePtrs(_argRawMaps[i]);
   }
 
-  func(_invocationRaws.data());
+  // We load the destination descriptors in the _destinationRaws, allocating
+  // the outputs the caller did not provide a buffer for.
+  for (unsigned int i = 0; i < returnDescriptorSizes.size(); i++) {
+    if (!isPassedAsDestination(i))
+      continue;
+    auto gateInfo = circuitInfo.asReader().getOutputs()[i];
+    size_t precision = getGateIntegerPrecision(gateInfo);
+    bool isSigned = getGateIsSigned(gateInfo);
+    void *destination = destinations.empty() ? nullptr : destinations[i];
+    if (destination == nullptr) {
+      returnsBuffer[i] = allocateValue(precision, isSigned, returnShapes[i]);
+      InvocationDescriptor::fromValue(returnsBuffer[i])
+          .intoOpaquePtrs(_destinationRawMaps[i]);
+    } else {
+      MemRefDescriptor::fromBuffer(destination, returnShapes[i], precision,
+                                   isSigned)
+          .intoOpaquePtrs(_destinationRawMaps[i]);
+    }
+  }
+
+  {
+    mlir::concretelang::PrimitiveStatisticsScope statisticsScope(
+        primitiveStatistics.get());
+    mlir::concretelang::SimulationStatisticsScope simulationScope(
+        useSimulation ? simulationStatistics.get() : nullptr);
+    mlir::concretelang::tracing::TraceScope trace(
+        "circuit", circuitInfo.asReader().getName().cStr());
+    size_t variant = selectedVariant.index.load();
+    auto func = variant == 0 ? defaultFunc : variantFuncs[variant - 1];
+    func(_invocationRaws.data());
+  }
 
   // The circuit has been executed, we can load the results from the
   // _returnRaws.
@@ -612,13 +1744,13 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
   auto liberator = InvocationDescriptor::Liberator();
   for (unsigned int i = 0; i < circuitInfo.asReader().getOutputs().size();
        i++) {
+    // The outputs passed as destinations are already in place.
+    if (isPassedAsDestination(i))
+      continue;
     // We read the descriptor from the _returnRaws via the maps.
-    size_t precision = getGateIntegerPrecision(
-        (Message<concreteprotocol::GateInfo>)circuitInfo.asReader()
-            .getOutputs()[i]);
-    bool isSigned = getGateIsSigned(
-        (Message<concreteprotocol::GateInfo>)circuitInfo.asReader()
-            .getOutputs()[i]);
+    auto gateInfo = circuitInfo.asReader().getOutputs()[i];
+    size_t precision = getGateIntegerPrecision(gateInfo);
+    bool isSigned = getGateIsSigned(gateInfo);
     InvocationDescriptor descriptor =
         InvocationDescriptor::fromU64s(_returnRawMaps[i], precision, isSigned);
     // We generate a value from the descriptor which we store in the
@@ -634,32 +1766,288 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
 
 Result<ServerProgram>
 ServerProgram::load(const Message<concreteprotocol::ProgramInfo> &programInfo,
-                    const std::string &sharedLibPath, bool useSimulation) {
-  ServerProgram output;
+                    const std::string &sharedLibPath, bool useSimulation,
+                    std::optional<ServerKeyset> serverKeyset,
+                    bool uploadKeysToGpus, size_t contextCacheSize,
+                    bool lazyCircuits) {
   OUTCOME_TRY(auto dynamicModule, DynamicModule::open(sharedLibPath));
-  auto sharedDynamicModule = std::shared_ptr<DynamicModule>(dynamicModule);
-  std::vector<ServerCircuit> serverCircuits;
-  for (auto circuitInfo : programInfo.asReader().getCircuits()) {
-    OUTCOME_TRY(auto serverCircuit,
-                ServerCircuit::fromDynamicModule(
-                    (Message<concreteprotocol::CircuitInfo>)circuitInfo,
-                    sharedDynamicModule, useSimulation));
-    serverCircuits.push_back(serverCircuit);
-  }
-  output.serverCircuits = serverCircuits;
+  return load(programInfo, dynamicModule, useSimulation,
+              std::move(serverKeyset), uploadKeysToGpus, contextCacheSize,
+              lazyCircuits);
+}
+
+Result<ServerProgram>
+ServerProgram::load(const Message<concreteprotocol::ProgramInfo> &programInfo,
+                    std::shared_ptr<DynamicModule> sharedDynamicModule,
+                    bool useSimulation,
+                    std::optional<ServerKeyset> serverKeyset,
+                    bool uploadKeysToGpus, size_t contextCacheSize,
+                    bool lazyCircuits) {
+  ServerProgram output;
+  output.metrics = std::make_shared<ServerMetrics>();
+  auto contextCache =
+      std::make_shared<RuntimeContextCache>(contextCacheSize, output.metrics);
+
+  // The keys are prepared while the circuits are built
+  std::vector<mlir::concretelang::async::Future *> futures;
+  if (serverKeyset.has_value() && !useSimulation) {
+    futures.push_back(mlir::concretelang::async::submit([&]() {
+      // The keyset is moved into the context, which may release the
+      // standard bootstrap keys
+      output.preloadedContext =
+          std::make_shared<RuntimeContext>(std::move(*serverKeyset));
+      output.metrics->recordContextCreation();
+#ifdef CONCRETELANG_CUDA_SUPPORT
+      if (uploadKeysToGpus)
+        output.preloadedContext->upload_keys_to_gpus();
+#endif
+    }));
+  }
+
+  // The circuits hold views on a single copy of the program info
+  auto sharedProgramInfo = SharedReader<concreteprotocol::ProgramInfo>(
+      Message<concreteprotocol::ProgramInfo>(programInfo));
+  auto circuitInfos = sharedProgramInfo.asReader().getCircuits();
+  std::vector<std::optional<Result<ServerCircuit>>> circuits(
+      lazyCircuits ? 0 : circuitInfos.size());
+  for (size_t i = 0; i < circuits.size(); i++)
+    futures.push_back(mlir::concretelang::async::submit([&, i]() {
+      circuits[i] = ServerCircuit::fromDynamicModule(
+          SharedReader<concreteprotocol::CircuitInfo>(sharedProgramInfo,
+                                                      circuitInfos[i]),
+          sharedDynamicModule, useSimulation);
+    }));
+  for (auto future : futures)
+    mlir::concretelang::async::await(future);
+
+  if (output.preloadedContext != nullptr)
+    contextCache->insert(output.preloadedContext);
+  for (auto &circuit : circuits) {
+    OUTCOME_TRY(auto serverCircuit, std::move(*circuit));
+    serverCircuit.contextCache = contextCache;
+    serverCircuit.metrics =
+        output.metrics->getCircuitMetrics(serverCircuit.getName());
+    output.serverCircuits.push_back(serverCircuit);
+  }
+  if (lazyCircuits) {
+    output.lazyCircuits = std::make_shared<LazyCircuits>();
+    for (auto circuitInfo : circuitInfos)
+      output.lazyCircuits->circuitInfos.push_back(
+          SharedReader<concreteprotocol::CircuitInfo>(sharedProgramInfo,
+                                                      circuitInfo));
+    output.lazyCircuits->circuits.resize(circuitInfos.size());
+    output.lazyCircuits->dynamicModule = sharedDynamicModule;
+    output.lazyCircuits->contextCache = contextCache;
+    output.lazyCircuits->metrics = output.metrics;
+    output.lazyCircuits->useSimulation = useSimulation;
+  }
   return output;
 }
 
+size_t ServerProgram::getGpuKeysMemory(uint32_t gpuIdx) {
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (preloadedContext != nullptr &&
+      gpuIdx < (uint32_t)preloadedContext->get_num_devices())
+    return preloadedContext->get_gpu_keys_memory(gpuIdx);
+#endif
+  return 0;
+}
+
 Result<ServerCircuit>
 ServerProgram::getServerCircuit(const std::string &circuitName) {
-  for (auto serverCircuit : serverCircuits) {
+  for (auto &serverCircuit : serverCircuits) {
     if (serverCircuit.getName() == circuitName) {
       return serverCircuit;
     }
   }
+  if (lazyCircuits != nullptr) {
+    std::lock_guard<std::mutex> guard(lazyCircuits->mutex);
+    for (size_t i = 0; i < lazyCircuits->circuitInfos.size(); i++) {
+      auto &circuitInfo = lazyCircuits->circuitInfos[i];
+      if (std::string(circuitInfo.asReader().getName()) != circuitName)
+        continue;
+      auto &circuit = lazyCircuits->circuits[i];
+      if (!circuit.has_value()) {
+        OUTCOME_TRY(circuit, ServerCircuit::fromDynamicModule(
+                                 circuitInfo, lazyCircuits->dynamicModule,
+                                 lazyCircuits->useSimulation));
+        circuit->contextCache = lazyCircuits->contextCache;
+        circuit->metrics =
+            lazyCircuits->metrics->getCircuitMetrics(circuit->getName());
+      }
+      return *circuit;
+    }
+  }
   return StringError("Tried to get unknown server circuit: `" + circuitName +
                      "`");
 }
 
+KeysetStream::KeysetStream(concreteprotocol::KeysetInfo::Reader keysetInfo,
+                           bool uploadKeysToGpus)
+    : uploadKeysToGpus(uploadKeysToGpus) {
+  // The keys not added yet are placeholders with empty buffers, which are
+  // not decompressed
+  ServerKeyset placeholders;
+  for (auto info : keysetInfo.getLweBootstrapKeys()) {
+    LweBootstrapKey::InfoType placeholderInfo(info);
+    placeholderInfo.asBuilder().setCompression(
+        concreteprotocol::Compression::NONE);
+    placeholders.lweBootstrapKeys.push_back(LweBootstrapKey(
+        std::make_shared<std::vector<uint64_t>>(), placeholderInfo));
+  }
+  for (auto info : keysetInfo.getLweKeyswitchKeys()) {
+    LweKeyswitchKey::InfoType placeholderInfo(info);
+    placeholderInfo.asBuilder().setCompression(
+        concreteprotocol::Compression::NONE);
+    placeholders.lweKeyswitchKeys.push_back(LweKeyswitchKey(
+        std::make_shared<std::vector<uint64_t>>(), placeholderInfo));
+  }
+  for (auto info : keysetInfo.getPackingKeyswitchKeys())
+    placeholders.packingKeyswitchKeys.push_back(
+        PackingKeyswitchKey(std::make_shared<std::vector<uint64_t>>(),
+                            PackingKeyswitchKey::InfoType(info)));
+  for (auto info : keysetInfo.getGlwePackingKeyswitchKeys())
+    placeholders.glwePackingKeyswitchKeys.push_back(
+        GlwePackingKeyswitchKey(std::make_shared<std::vector<uint64_t>>(),
+                                GlwePackingKeyswitchKey::InfoType(info)));
+
+  bootstrapKeys.resize(placeholders.lweBootstrapKeys.size(), false);
+  keyswitchKeys.resize(placeholders.lweKeyswitchKeys.size(), false);
+  packingKeyswitchKeys.resize(placeholders.packingKeyswitchKeys.size(), false);
+  glwePackingKeyswitchKeys.resize(
+      placeholders.glwePackingKeyswitchKeys.size(), false);
+  bootstrapKeysPending = bootstrapKeys;
+  keyswitchKeysPending = keyswitchKeys;
+  packingKeyswitchKeysPending = packingKeyswitchKeys;
+  glwePackingKeyswitchKeysPending = glwePackingKeyswitchKeys;
+  context = std::make_shared<RuntimeContext>(placeholders);
+}
+
+Result<void> KeysetStream::claim(std::vector<bool> &pending, size_t id,
+                                 const char *kind) {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (id >= pending.size())
+    return StringError("Unknown ") << kind << " key " << id;
+  if (pending[id])
+    return StringError("The ") << kind << " key " << id << " was already added";
+  pending[id] = true;
+  return outcome::success();
+}
+
+void KeysetStream::markAdded(std::vector<bool> &added, size_t id) {
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    added[id] = true;
+  }
+  keyAdded.notify_all();
+}
+
+// The keys are prepared without holding the lock, so that the keys added
+// concurrently are prepared concurrently.
+
+Result<void> KeysetStream::addBootstrapKey(LweBootstrapKey key) {
+  size_t id = key.getInfo().asReader().getId();
+  OUTCOME_TRYV(claim(bootstrapKeysPending, id, "bootstrap"));
+  context->add_bootstrap_key(id, key, uploadKeysToGpus);
+  markAdded(bootstrapKeys, id);
+  return outcome::success();
+}
+
+Result<void> KeysetStream::addKeyswitchKey(LweKeyswitchKey key) {
+  size_t id = key.getInfo().asReader().getId();
+  OUTCOME_TRYV(claim(keyswitchKeysPending, id, "keyswitch"));
+  context->add_keyswitch_key(id, key, uploadKeysToGpus);
+  markAdded(keyswitchKeys, id);
+  return outcome::success();
+}
+
+Result<void> KeysetStream::addPackingKeyswitchKey(PackingKeyswitchKey key) {
+  size_t id = key.getInfo().asReader().getId();
+  OUTCOME_TRYV(claim(packingKeyswitchKeysPending, id, "packing keyswitch"));
+  context->add_packing_keyswitch_key(id, key, uploadKeysToGpus);
+  markAdded(packingKeyswitchKeys, id);
+  return outcome::success();
+}
+
+Result<void>
+KeysetStream::addGlwePackingKeyswitchKey(GlwePackingKeyswitchKey key) {
+  size_t id = key.getInfo().asReader().getId();
+  OUTCOME_TRYV(
+      claim(glwePackingKeyswitchKeysPending, id, "glwe packing keyswitch"));
+  context->add_glwe_packing_keyswitch_key(id, key);
+  markAdded(glwePackingKeyswitchKeys, id);
+  return outcome::success();
+}
+
+static bool allAdded(const std::vector<bool> &added) {
+  return llvm::all_of(added, [](bool a) { return a; });
+}
+
+bool KeysetStream::isReadyLocked(const ServerCircuit &circuit) {
+  // The outputs are packed with any of the glwe packing keys
+  if (!allAdded(glwePackingKeyswitchKeys))
+    return false;
+  auto circuitInfo = circuit.circuitInfo.asReader();
+  if (!circuitInfo.hasKeys())
+    return allAdded(bootstrapKeys) && allAdded(keyswitchKeys) &&
+           allAdded(packingKeyswitchKeys);
+  auto keys = circuitInfo.getKeys();
+  auto addedAll = [](const std::vector<bool> &added, auto ids) {
+    return llvm::all_of(
+        ids, [&](uint32_t id) { return id < added.size() && added[id]; });
+  };
+  return addedAll(bootstrapKeys, keys.getLweBootstrapKeys()) &&
+         addedAll(keyswitchKeys, keys.getLweKeyswitchKeys()) &&
+         addedAll(packingKeyswitchKeys, keys.getPackingKeyswitchKeys());
+}
+
+bool KeysetStream::isReady(const ServerCircuit &circuit) {
+  std::lock_guard<std::mutex> guard(mutex);
+  return isReadyLocked(circuit);
+}
+
+bool KeysetStream::isComplete() {
+  std::lock_guard<std::mutex> guard(mutex);
+  return allAdded(bootstrapKeys) && allAdded(keyswitchKeys) &&
+         allAdded(packingKeyswitchKeys) && allAdded(glwePackingKeyswitchKeys);
+}
+
+Result<std::vector<TransportValue>>
+KeysetStream::call(ServerCircuit &circuit, std::vector<TransportValue> &args) {
+  if (circuit.runRemoteScheduler())
+    return std::vector<TransportValue>(circuit.returnTransformers.size());
+
+  // The arguments are transformed while the keys are still coming
+  CallRecorder recorder(circuit.metrics.get(), transportSize(args));
+  OUTCOME_TRY(auto argsBuffer, circuit.transformArgs(args));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    keyAdded.wait(lock, [&]() { return isReadyLocked(circuit); });
+  }
+  auto result = circuit.callWithContext(context.get(), argsBuffer);
+  if (result.has_value())
+    recorder.succeeded(transportSize(result.value()));
+  return result;
+}
+
+ServerKeyset KeysetStream::finish(ServerProgram &program) {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    keyAdded.wait(lock, [&]() {
+      return allAdded(bootstrapKeys) && allAdded(keyswitchKeys) &&
+             allAdded(packingKeyswitchKeys) &&
+             allAdded(glwePackingKeyswitchKeys);
+    });
+  }
+  std::shared_ptr<RuntimeContextCache> contextCache =
+      program.lazyCircuits != nullptr ? program.lazyCircuits->contextCache
+      : program.serverCircuits.empty()
+          ? nullptr
+          : program.serverCircuits.front().contextCache;
+  if (contextCache != nullptr)
+    contextCache->insert(context);
+  return context->getKeys();
+}
+
 } // namespace serverlib
 } // namespace concretelang
@@ -0,0 +1,237 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/ServerLib/ServerMetrics.h"
+#include "concretelang/Common/Keys.h"
+#include "concretelang/Runtime/context.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+namespace concretelang {
+namespace serverlib {
+
+namespace {
+
+/// Returns the bucket of the latency histograms counting `nanoseconds`.
+size_t latencyBucket(uint64_t nanoseconds) {
+  if (nanoseconds == 0)
+    nanoseconds = 1;
+  size_t exponent = 63 - __builtin_clzll(nanoseconds);
+  size_t sub = 0;
+  if (exponent >= 2)
+    sub = (nanoseconds >> (exponent - 2)) & (CALL_LATENCY_SUB_BUCKETS - 1);
+  return exponent * CALL_LATENCY_SUB_BUCKETS + sub;
+}
+
+/// Returns the lowest and the highest latency, in nanoseconds, counted by the
+/// bucket `bucket` of the latency histograms.
+std::pair<double, double> latencyBucketBounds(size_t bucket) {
+  size_t exponent = bucket / CALL_LATENCY_SUB_BUCKETS;
+  size_t sub = bucket % CALL_LATENCY_SUB_BUCKETS;
+  double low = std::ldexp(1, exponent);
+  if (exponent < 2)
+    return {low, 2 * low};
+  double width = low / CALL_LATENCY_SUB_BUCKETS;
+  return {low + sub * width, low + (sub + 1) * width};
+}
+
+MetricSample sample(std::string name, double value,
+                    std::vector<std::pair<std::string, std::string>> labels) {
+  return MetricSample{std::move(name), std::move(labels), value};
+}
+
+/// Returns a counter without labels.
+Metric unlabelledCounter(std::string name, std::string help, double value) {
+  return Metric{name, std::move(help), MetricType::COUNTER,
+                {sample(name, value, {})}};
+}
+
+std::string formatValue(double value) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.15g", value);
+  return buffer;
+}
+
+std::string escapeLabelValue(const std::string &value) {
+  std::string escaped;
+  for (char c : value) {
+    if (c == '\\' || c == '"')
+      escaped += '\\';
+    if (c == '\n') {
+      escaped += "\\n";
+      continue;
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+const char *metricTypeName(MetricType type) {
+  switch (type) {
+  case MetricType::COUNTER:
+    return "counter";
+  case MetricType::GAUGE:
+    return "gauge";
+  case MetricType::SUMMARY:
+    return "summary";
+  }
+  return "untyped";
+}
+
+} // namespace
+
+void CircuitMetrics::recordCall(bool success, uint64_t nanoseconds,
+                                uint64_t argumentBytes, uint64_t returnBytes) {
+  calls.fetch_add(1, std::memory_order_relaxed);
+  if (!success)
+    errors.fetch_add(1, std::memory_order_relaxed);
+  this->nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  this->argumentBytes.fetch_add(argumentBytes, std::memory_order_relaxed);
+  this->returnBytes.fetch_add(returnBytes, std::memory_order_relaxed);
+  latencyHistogram[latencyBucket(nanoseconds)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+double CircuitMetrics::getLatencyQuantile(double quantile) const {
+  std::array<uint64_t, CALL_LATENCY_BUCKETS> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < CALL_LATENCY_BUCKETS; i++) {
+    counts[i] = latencyHistogram[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0)
+    return 0;
+  // The calls are assumed evenly spread over the bucket holding the quantile
+  double rank = std::min(std::max(quantile, 0.0), 1.0) * total;
+  uint64_t below = 0;
+  for (size_t i = 0; i < CALL_LATENCY_BUCKETS; i++) {
+    if (counts[i] == 0 || below + counts[i] < rank) {
+      below += counts[i];
+      continue;
+    }
+    auto [low, high] = latencyBucketBounds(i);
+    return low + (high - low) * (rank - below) / counts[i];
+  }
+  return latencyBucketBounds(CALL_LATENCY_BUCKETS - 1).second;
+}
+
+std::shared_ptr<CircuitMetrics>
+ServerMetrics::getCircuitMetrics(const std::string &name) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto &metrics = circuits[name];
+  if (metrics == nullptr)
+    metrics = std::make_shared<CircuitMetrics>();
+  return metrics;
+}
+
+void ServerMetrics::addCollector(
+    std::function<void(std::vector<Metric> &)> collector) {
+  std::lock_guard<std::mutex> guard(mutex);
+  collectors.push_back(std::move(collector));
+}
+
+std::vector<Metric> ServerMetrics::collect() {
+  std::map<std::string, std::shared_ptr<CircuitMetrics>> circuits;
+  std::vector<std::function<void(std::vector<Metric> &)>> collectors;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    circuits = this->circuits;
+    collectors = this->collectors;
+  }
+
+  Metric calls{"concrete_server_calls_total",
+               "Calls of the circuit, including the failed ones.",
+               MetricType::COUNTER,
+               {}};
+  Metric errors{"concrete_server_call_errors_total",
+                "Calls of the circuit which returned an error.",
+                MetricType::COUNTER,
+                {}};
+  Metric latency{"concrete_server_call_duration_seconds",
+                 "Latency of the calls of the circuit.",
+                 MetricType::SUMMARY,
+                 {}};
+  Metric argumentBytes{"concrete_server_argument_bytes_total",
+                       "Size of the serialized arguments of the calls.",
+                       MetricType::COUNTER,
+                       {}};
+  Metric returnBytes{"concrete_server_return_bytes_total",
+                     "Size of the serialized results of the calls.",
+                     MetricType::COUNTER,
+                     {}};
+  for (auto &[name, metrics] : circuits) {
+    std::vector<std::pair<std::string, std::string>> labels{{"circuit", name}};
+    calls.samples.push_back(sample(calls.name, metrics->getCalls(), labels));
+    errors.samples.push_back(sample(errors.name, metrics->getErrors(), labels));
+    for (double quantile : {0.5, 0.9, 0.99}) {
+      auto quantileLabels = labels;
+      quantileLabels.emplace_back("quantile", formatValue(quantile));
+      latency.samples.push_back(
+          sample(latency.name, metrics->getLatencyQuantile(quantile) * 1e-9,
+                 quantileLabels));
+    }
+    latency.samples.push_back(sample(
+        latency.name + "_sum", metrics->getNanoseconds() * 1e-9, labels));
+    latency.samples.push_back(
+        sample(latency.name + "_count", metrics->getCalls(), labels));
+    argumentBytes.samples.push_back(
+        sample(argumentBytes.name, metrics->getArgumentBytes(), labels));
+    returnBytes.samples.push_back(
+        sample(returnBytes.name, metrics->getReturnBytes(), labels));
+  }
+
+  std::vector<Metric> result{calls, errors, latency, argumentBytes,
+                             returnBytes};
+  result.push_back(unlabelledCounter(
+      "concrete_server_runtime_context_creations_total",
+      "Runtime contexts built for the keysets of the calls, i.e. misses of "
+      "the context cache.",
+      getContextCreations()));
+  result.push_back(unlabelledCounter(
+      "concrete_key_decompressions_total",
+      "Seeded keys decompressed by the process.",
+      concretelang::keys::getKeyDecompressionCount()));
+  result.push_back(unlabelledCounter(
+      "concrete_gpu_key_uploads_total",
+      "Keys uploaded to a GPU by the process.",
+      mlir::concretelang::RuntimeContext::get_gpu_key_upload_count()));
+  for (auto &collector : collectors)
+    collector(result);
+  return result;
+}
+
+void ServerMetrics::visit(const std::function<void(const Metric &)> &visitor) {
+  for (auto &metric : collect())
+    visitor(metric);
+}
+
+std::string ServerMetrics::toPrometheusText() {
+  std::ostringstream text;
+  visit([&](const Metric &metric) {
+    text << "# HELP " << metric.name << " " << metric.help << "\n";
+    text << "# TYPE " << metric.name << " " << metricTypeName(metric.type)
+         << "\n";
+    for (auto &sample : metric.samples) {
+      text << sample.name;
+      if (!sample.labels.empty()) {
+        text << "{";
+        for (size_t i = 0; i < sample.labels.size(); i++) {
+          if (i != 0)
+            text << ",";
+          text << sample.labels[i].first << "=\""
+               << escapeLabelValue(sample.labels[i].second) << "\"";
+        }
+        text << "}";
+      }
+      text << " " << formatValue(sample.value) << "\n";
+    }
+  });
+  return text.str();
+}
+
+} // namespace serverlib
+} // namespace concretelang
@@ -0,0 +1,757 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <thread>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA256.h>
+#include <llvm/TargetParser/Host.h>
+
+#include <concretelang/Support/CompilationCache.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Writes the fields of an option as `name=value;`, the doubles in
+/// hexadecimal to keep all their bits
+class OptionsWriter {
+public:
+  OptionsWriter(llvm::raw_ostream &os) : os(os) {}
+
+  template <typename T> void operator()(llvm::StringRef name, const T &value) {
+    os << name << "=";
+    write(value);
+    os << ";";
+  }
+
+private:
+  void write(bool value) { os << (value ? "1" : "0"); }
+  void write(double value) { os << llvm::format("%a", value); }
+  void write(const std::string &value) {
+    os << value.size() << ":" << value;
+  }
+  template <typename T> void write(const T &value) {
+    if constexpr (std::is_enum_v<T>)
+      os << (int64_t)value;
+    else
+      os << value;
+  }
+  template <typename T> void write(const std::optional<T> &value) {
+    if (!value.has_value()) {
+      os << "none";
+      return;
+    }
+    os << "(";
+    write(*value);
+    os << ")";
+  }
+  template <typename T> void write(const std::shared_ptr<T> &value) {
+    if (value == nullptr) {
+      os << "none";
+      return;
+    }
+    os << "(";
+    write(*value);
+    os << ")";
+  }
+  template <typename T> void write(const std::vector<T> &values) {
+    os << "[";
+    for (const T &value : values) {
+      write(value);
+      os << ",";
+    }
+    os << "]";
+  }
+  template <typename T> void write(const rust::Vec<T> &values) {
+    os << "[";
+    for (const T &value : values) {
+      write(value);
+      os << ",";
+    }
+    os << "]";
+  }
+  void write(const V0FHEConstraint &value) {
+    (*this)("norm2", value.norm2);
+    (*this)("p", value.p);
+  }
+  void write(const LargeIntegerParameter &value) {
+    const WopPBSParameter &wopPBS = value.wopPBS;
+    (*this)("crt", value.crtDecomposition);
+    (*this)("pksInputLweDimension", wopPBS.packingKeySwitch.inputLweDimension);
+    (*this)("pksOutputPolynomialSize",
+            wopPBS.packingKeySwitch.outputPolynomialSize);
+    (*this)("pksLevel", wopPBS.packingKeySwitch.level);
+    (*this)("pksBaseLog", wopPBS.packingKeySwitch.baseLog);
+    (*this)("cbsLevel", wopPBS.circuitBootstrap.level);
+    (*this)("cbsBaseLog", wopPBS.circuitBootstrap.baseLog);
+  }
+  void write(const V0Parameter &value) {
+    (*this)("glweDimension", value.glweDimension);
+    (*this)("logPolynomialSize", value.logPolynomialSize);
+    (*this)("nSmall", value.nSmall);
+    (*this)("brLevel", value.brLevel);
+    (*this)("brLogBase", value.brLogBase);
+    (*this)("ksLevel", value.ksLevel);
+    (*this)("ksLogBase", value.ksLogBase);
+    (*this)("largeInteger", value.largeInteger);
+  }
+  void write(const optimizer::CompositionRule &value) {
+    (*this)("from", value.from_func);
+    (*this)("fromPos", value.from_pos);
+    (*this)("to", value.to_func);
+    (*this)("toPos", value.to_pos);
+  }
+  void write(const concrete_optimizer::restriction::RangeRestriction &value) {
+    (*this)("glweLogPolynomialSizes", value.glwe_log_polynomial_sizes);
+    (*this)("glweDimensions", value.glwe_dimensions);
+    (*this)("internalLweDimensions", value.internal_lwe_dimensions);
+    (*this)("pbsLevelCount", value.pbs_level_count);
+    (*this)("pbsBaseLog", value.pbs_base_log);
+    (*this)("ksLevelCount", value.ks_level_count);
+    (*this)("ksBaseLog", value.ks_base_log);
+  }
+
+  llvm::raw_ostream &os;
+};
+
+/// Returns an identifier of the build of the compiler, from the binary
+/// holding this code
+std::optional<std::string> getCompilerBuildId() {
+  Dl_info info;
+  if (dladdr((void *)&getCompilerBuildId, &info) == 0 ||
+      info.dli_fname == nullptr)
+    return std::nullopt;
+  llvm::sys::fs::file_status status;
+  if (llvm::sys::fs::status(info.dli_fname, status))
+    return std::nullopt;
+  return std::string(info.dli_fname) + ":" + std::to_string(status.getSize()) +
+         ":" +
+         std::to_string(
+             status.getLastModificationTime().time_since_epoch().count());
+}
+
+/// The enabled features of the host cpu, sorted by name
+std::vector<std::string> getHostFeatures() {
+  llvm::StringMap<bool> hostFeatures;
+  llvm::sys::getHostCPUFeatures(hostFeatures);
+  std::vector<std::string> features;
+  for (auto &feature : hostFeatures)
+    if (feature.second)
+      features.push_back(feature.first().str());
+  std::sort(features.begin(), features.end());
+  return features;
+}
+
+/// The artifacts of a library, by their paths in an output directory
+std::vector<std::string>
+getArtifactPaths(const CompilerEngine::Library &library, bool sharedLib,
+                 bool staticLib, bool clientParameters,
+                 bool compilationFeedback) {
+  std::vector<std::string> paths;
+  if (sharedLib)
+    paths.push_back(library.getSharedLibraryPath());
+  if (staticLib)
+    paths.push_back(library.getStaticLibraryPath());
+  if (clientParameters)
+    paths.push_back(library.getProgramInfoPath());
+  if (compilationFeedback)
+    paths.push_back(library.getCompilationFeedbackPath());
+  return paths;
+}
+
+/// The version of the cached solutions, to bump when the format of the
+/// entries or the solutions of the optimizer change
+const uint64_t SOLUTION_CACHE_VERSION = 2;
+
+/// Writes the fields of a solution as tokens ended by a space, the strings
+/// prefixed by their size and the doubles in hexadecimal to keep all their
+/// bits
+class SolutionWriter {
+public:
+  SolutionWriter(llvm::raw_ostream &os) : os(os) {}
+
+  void value(uint64_t &value) { os << value << " "; }
+  void value(double &value) { os << llvm::format("%a", value) << " "; }
+  void value(bool &value) { os << (value ? "1" : "0") << " "; }
+  void value(rust::String &value) {
+    os << value.size() << ":";
+    os.write(value.data(), value.size());
+    os << " ";
+  }
+  template <typename T> void value(rust::Vec<T> &values) {
+    os << values.size() << " ";
+    for (T &element : values)
+      value(element);
+  }
+  template <typename T> void value(T &object) { serialize(*this, object); }
+
+private:
+  llvm::raw_ostream &os;
+};
+
+/// Reads the fields of a solution written by a `SolutionWriter`, failing on
+/// the first malformed token
+class SolutionReader {
+public:
+  SolutionReader(llvm::StringRef content) : content(content) {}
+
+  /// Returns whether all the content has been read without error
+  bool succeeded() const { return !failed && content.empty(); }
+
+  void value(uint64_t &value) {
+    if (next().getAsInteger(10, value))
+      failed = true;
+  }
+  void value(double &value) {
+    std::string token = next().str();
+    char *end = nullptr;
+    value = std::strtod(token.c_str(), &end);
+    if (token.empty() || *end != '\0')
+      failed = true;
+  }
+  void value(bool &value) {
+    uint64_t integer = 0;
+    this->value(integer);
+    failed |= integer > 1;
+    value = integer == 1;
+  }
+  void value(rust::String &value) {
+    size_t separator = content.find(':');
+    size_t size = 0;
+    if (separator == llvm::StringRef::npos ||
+        content.take_front(separator).getAsInteger(10, size) ||
+        content.size() < separator + size + 2 ||
+        content[separator + 1 + size] != ' ' ||
+        !llvm::json::isUTF8(content.substr(separator + 1, size))) {
+      failed = true;
+      return;
+    }
+    value = rust::String(content.substr(separator + 1, size).str());
+    content = content.drop_front(separator + size + 2);
+  }
+  template <typename T> void value(rust::Vec<T> &values) {
+    uint64_t size = 0;
+    this->value(size);
+    // Each element takes at least 2 characters, bounding the size of the
+    // vectors of corrupted entries
+    failed |= size > content.size();
+    values.clear();
+    for (uint64_t i = 0; i < size && !failed; i++) {
+      T element{};
+      value(element);
+      values.push_back(std::move(element));
+    }
+  }
+  template <typename T> void value(T &object) { serialize(*this, object); }
+
+private:
+  llvm::StringRef next() {
+    size_t end = content.find(' ');
+    if (failed || end == llvm::StringRef::npos) {
+      failed = true;
+      return "";
+    }
+    llvm::StringRef token = content.take_front(end);
+    content = content.drop_front(end + 1);
+    return token;
+  }
+
+  llvm::StringRef content;
+  bool failed = false;
+};
+
+template <typename Archive>
+void serialize(Archive &ar, concrete_optimizer::dag::SecretLweKey &key) {
+  ar.value(key.identifier);
+  ar.value(key.polynomial_size);
+  ar.value(key.glwe_dimension);
+  ar.value(key.description);
+}
+
+template <typename Archive>
+void serialize(Archive &ar,
+               concrete_optimizer::dag::BrDecompositionParameters &params) {
+  ar.value(params.level);
+  ar.value(params.log2_base);
+}
+
+template <typename Archive>
+void serialize(Archive &ar,
+               concrete_optimizer::dag::KsDecompositionParameters &params) {
+  ar.value(params.level);
+  ar.value(params.log2_base);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, concrete_optimizer::dag::BootstrapKey &key) {
+  ar.value(key.identifier);
+  ar.value(key.input_key);
+  ar.value(key.output_key);
+  ar.value(key.br_decomposition_parameter);
+  ar.value(key.grouping_factor);
+  ar.value(key.description);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, concrete_optimizer::dag::KeySwitchKey &key) {
+  ar.value(key.identifier);
+  ar.value(key.input_key);
+  ar.value(key.output_key);
+  ar.value(key.ks_decomposition_parameter);
+  ar.value(key.description);
+}
+
+template <typename Archive>
+void serialize(Archive &ar,
+               concrete_optimizer::dag::ConversionKeySwitchKey &key) {
+  ar.value(key.identifier);
+  ar.value(key.input_key);
+  ar.value(key.output_key);
+  ar.value(key.ks_decomposition_parameter);
+  ar.value(key.fast_keyswitch);
+  ar.value(key.description);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, concrete_optimizer::dag::CircuitBoostrapKey &key) {
+  ar.value(key.identifier);
+  ar.value(key.representation_key);
+  ar.value(key.br_decomposition_parameter);
+  ar.value(key.description);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, PrivateFunctionalPackingBoostrapKey &key) {
+  ar.value(key.identifier);
+  ar.value(key.representation_key);
+  ar.value(key.br_decomposition_parameter);
+  ar.value(key.description);
+}
+
+template <typename Archive> void serialize(Archive &ar, CircuitKeys &keys) {
+  ar.value(keys.secret_keys);
+  ar.value(keys.keyswitch_keys);
+  ar.value(keys.bootstrap_keys);
+  ar.value(keys.conversion_keyswitch_keys);
+  ar.value(keys.circuit_bootstrap_keys);
+  ar.value(keys.private_functional_packing_keys);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, concrete_optimizer::dag::InstructionKeys &keys) {
+  ar.value(keys.input_key);
+  ar.value(keys.tlu_keyswitch_key);
+  ar.value(keys.tlu_bootstrap_key);
+  ar.value(keys.tlu_circuit_bootstrap_key);
+  ar.value(keys.tlu_private_functional_packing_key);
+  ar.value(keys.output_key);
+  ar.value(keys.extra_conversion_keys);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, optimizer::CircuitSolution &solution) {
+  ar.value(solution.circuit_keys);
+  ar.value(solution.instructions_keys);
+  ar.value(solution.crt_decomposition);
+  ar.value(solution.complexity);
+  ar.value(solution.p_error);
+  ar.value(solution.global_p_error);
+  ar.value(solution.is_feasible);
+  ar.value(solution.error_msg);
+}
+
+template <typename Archive>
+void serialize(Archive &ar, optimizer::DagSolution &solution) {
+  ar.value(solution.input_lwe_dimension);
+  ar.value(solution.internal_ks_output_lwe_dimension);
+  ar.value(solution.ks_decomposition_level_count);
+  ar.value(solution.ks_decomposition_base_log);
+  ar.value(solution.glwe_polynomial_size);
+  ar.value(solution.glwe_dimension);
+  ar.value(solution.br_decomposition_level_count);
+  ar.value(solution.br_decomposition_base_log);
+  ar.value(solution.complexity);
+  ar.value(solution.noise_max);
+  ar.value(solution.p_error);
+  ar.value(solution.global_p_error);
+  ar.value(solution.use_wop_pbs);
+  ar.value(solution.cb_decomposition_level_count);
+  ar.value(solution.cb_decomposition_base_log);
+  ar.value(solution.pp_decomposition_level_count);
+  ar.value(solution.pp_decomposition_base_log);
+  ar.value(solution.crt_decomposition);
+}
+
+template <typename Solution>
+bool loadSolution(const optimizer::Config &config, llvm::StringRef key,
+                  Solution &solution) {
+  std::vector<std::string> cacheDirs;
+  if (!config.solution_cache_dir.empty())
+    cacheDirs.push_back(config.solution_cache_dir);
+  cacheDirs.insert(cacheDirs.end(), config.shared_solution_cache_dirs.begin(),
+                   config.shared_solution_cache_dirs.end());
+
+  for (const std::string &cacheDir : cacheDirs) {
+    llvm::SmallString<0> entryPath(cacheDir);
+    llvm::sys::path::append(entryPath, key);
+    auto buffer = llvm::MemoryBuffer::getFile(entryPath);
+    if (!buffer)
+      continue;
+    Solution entry{};
+    SolutionReader reader((*buffer)->getBuffer());
+    reader.value(entry);
+    if (reader.succeeded()) {
+      solution = std::move(entry);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Solution>
+void storeSolution(const optimizer::Config &config, llvm::StringRef key,
+                   Solution solution) {
+  if (config.solution_cache_dir.empty())
+    return;
+  llvm::SmallString<0> entryPath(config.solution_cache_dir);
+  llvm::sys::path::append(entryPath, key);
+
+  // The entry is written to a fresh file, then renamed, such that the
+  // concurrent compilations never read a partial entry
+  int fd;
+  llvm::SmallString<0> tmpPath;
+  if (llvm::sys::fs::create_directories(config.solution_cache_dir) ||
+      llvm::sys::fs::createUniqueFile(entryPath.str() + "-%%%%%%.tmp", fd,
+                                      tmpPath))
+    return;
+  bool written;
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    SolutionWriter writer(os);
+    writer.value(solution);
+    os.close();
+    written = !os.has_error();
+    os.clear_error();
+  }
+  if (!written || llvm::sys::fs::rename(tmpPath, entryPath))
+    llvm::sys::fs::remove(tmpPath);
+}
+
+} // end anonymous namespace
+
+std::optional<std::string>
+getCompilationOptionsKey(const CompilationOptions &options) {
+  const optimizer::Config &config = options.optimizerConfig;
+
+  // The diagnostics, the printed choices and the profile would be missing on
+  // cache hits, the predicted latencies depend on the contents of the cost
+  // table, and the keyset restrictions have no stable description
+  if (options.verifyDiagnostics || options.printTluFusing || config.display ||
+      options.compilationProfile || options.latencyCostTable.has_value() ||
+      config.keyset_restriction != nullptr)
+    return std::nullopt;
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  OptionsWriter option(os);
+  option("v0FHEConstraints", options.v0FHEConstraints);
+  option("v0Parameter", options.v0Parameter);
+  option("largeIntegerParameter", options.largeIntegerParameter);
+  option("simulate", options.simulate);
+  option("enableOverflowDetectionInSimulation",
+         options.enableOverflowDetectionInSimulation);
+  option("enableNoiseInSimulation", options.enableNoiseInSimulation);
+  option("autoParallelize", options.autoParallelize);
+  option("loopParallelize", options.loopParallelize);
+  option("dataflowParallelize", options.dataflowParallelize);
+  option("dataflowMinTaskWork", options.dataflowMinTaskWork);
+  option("dataflowUnrollFactor", options.dataflowUnrollFactor);
+  option("dataflowThreadPolicy", options.dataflowThreadPolicy);
+  option("dataflowThreads", options.dataflowThreads);
+  option("asyncOffload", options.asyncOffload);
+  option("compressEvaluationKeys", options.compressEvaluationKeys);
+  option("compressInputCiphertexts", options.compressInputCiphertexts);
+  option("compressOutputCiphertexts", options.compressOutputCiphertexts);
+  option("compactFourierBootstrapKeys", options.compactFourierBootstrapKeys);
+  option("destinationPassing", options.destinationPassing);
+  option("p_error", config.p_error);
+  option("global_p_error", config.global_p_error);
+  option("strategy", config.strategy);
+  option("key_sharing", config.key_sharing);
+  option("multi_param_strategy", config.multi_param_strategy);
+  option("security", config.security);
+  option("fallback_log_norm_woppbs", config.fallback_log_norm_woppbs);
+  option("use_gpu_constraints", config.use_gpu_constraints);
+  option("encoding", config.encoding);
+  option("ciphertext_modulus_log", config.ciphertext_modulus_log);
+  option("fft_precision", config.fft_precision);
+  option("range_restriction", config.range_restriction);
+  option("composition_rules", config.composition_rules);
+  option("composable", config.composable);
+  option("nb_threads", config.nb_threads);
+  option("cost_model", config.cost_model);
+  option("gpu_number_of_sm", config.gpu_number_of_sm);
+  option("ks_cost_factor", config.ks_cost_factor);
+  option("pbs_cost_factor", config.pbs_cost_factor);
+  option("key_size_weight", config.key_size_weight);
+  option("key_reuse_threshold", config.key_reuse_threshold);
+  option("allow_pbs_ks_order", config.allow_pbs_ks_order);
+  option("many_lut_max_count", config.many_lut_max_count);
+  option("max_grouping_factor", config.max_grouping_factor);
+  option("emitGPUOps", options.emitGPUOps);
+  option("batchTFHEOps", options.batchTFHEOps);
+  option("maxBatchSize", options.maxBatchSize);
+  option("emitSDFGOps", options.emitSDFGOps);
+  option("unrollLoopsWithSDFGConvertibleOps",
+         options.unrollLoopsWithSDFGConvertibleOps);
+  option("sdfgLoopUnrollFactor", options.sdfgLoopUnrollFactor);
+  option("optimizeTFHE", options.optimizeTFHE);
+  option("fhelinalgTileSizes", options.fhelinalgTileSizes);
+  option("fhelinalgAutoTiling", options.fhelinalgAutoTiling);
+  option("fhelinalgAutoTilingCores", options.fhelinalgAutoTilingCores);
+  option("fhelinalgAutoTilingMinPbs", options.fhelinalgAutoTilingMinPbs);
+  option("fhelinalgAutoTilingMaxMemory", options.fhelinalgAutoTilingMaxMemory);
+  option("fhelinalgTreeReduction", options.fhelinalgTreeReduction);
+  option("fhelinalgIm2colConv2d", options.fhelinalgIm2colConv2d);
+  option("fhelinalgMaxpool2dTree", options.fhelinalgMaxpool2dTree);
+  option("fhelinalgMatMulSharedTLU", options.fhelinalgMatMulSharedTLU);
+  option("specializeConstantMatMul", options.specializeConstantMatMul);
+  option("fuseTLUChains", options.fuseTLUChains);
+  option("narrowTLUInputs", options.narrowTLUInputs);
+  option("roundTLUMaxPrecision", options.roundTLUMaxPrecision);
+  option("roundTLUByCost", options.roundTLUByCost);
+  option("fuseBooleanGates", options.fuseBooleanGates);
+  option("booleanGateFusionMaxInputs", options.booleanGateFusionMaxInputs);
+  option("chunkIntegers", options.chunkIntegers);
+  option("chunkSize", options.chunkSize);
+  option("chunkWidth", options.chunkWidth);
+  option("chunkCarryLookahead", options.chunkCarryLookahead);
+  option("chunkIntegersByCost", options.chunkIntegersByCost);
+  option("batchCrtBlocks", options.batchCrtBlocks);
+  option("enableTluFusing", options.enableTluFusing);
+  option("targetCpu", options.targetCpu);
+  option("targetCpuVariants", options.targetCpuVariants);
+  option("reuseBuffers", options.reuseBuffers);
+  option("runtimeBitcode", options.runtimeBitcode);
+  option("executionVariants", options.executionVariants);
+
+  std::optional<std::string> encodings;
+  if (options.encodings.has_value()) {
+    auto json = options.encodings->writeJsonToString();
+    if (json.has_failure())
+      return std::nullopt;
+    encodings = json.value();
+  }
+  option("encodings", encodings);
+  return os.str();
+}
+
+std::optional<std::string>
+getCompilationCacheKey(llvm::ArrayRef<std::string> sources,
+                       llvm::StringRef optionsKey) {
+  std::optional<std::string> buildId = getCompilerBuildId();
+  if (!buildId.has_value())
+    return std::nullopt;
+
+  // The code is generated for the host cpu, and the default tile sizes and
+  // number of threads depend on its number of cores
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  OptionsWriter field(os);
+  field("sources", std::vector<std::string>(sources.begin(), sources.end()));
+  field("options", optionsKey.str());
+  field("compiler", *buildId);
+  field("cpu", llvm::sys::getHostCPUName().str());
+  field("features", getHostFeatures());
+  field("cores", std::thread::hardware_concurrency());
+
+  return llvm::toHex(llvm::SHA256::hash(llvm::arrayRefFromStringRef(os.str())),
+                     /*LowerCase=*/true);
+}
+
+bool loadCachedArtifacts(llvm::StringRef cacheDir, llvm::StringRef key,
+                         CompilerEngine::Library &library, bool sharedLib,
+                         bool staticLib, bool clientParameters,
+                         bool compilationFeedback) {
+  llvm::SmallString<0> entryPath(cacheDir);
+  llvm::sys::path::append(entryPath, key);
+  CompilerEngine::Library entry(entryPath.str().str(), "", false);
+
+  std::vector<std::string> cached = getArtifactPaths(
+      entry, sharedLib, staticLib, clientParameters, compilationFeedback);
+  std::vector<std::string> outputs = getArtifactPaths(
+      library, sharedLib, staticLib, clientParameters, compilationFeedback);
+  if (!llvm::all_of(cached, [](const std::string &path) {
+        return llvm::sys::fs::exists(path);
+      }))
+    return false;
+
+  llvm::sys::fs::create_directories(library.getOutputDirPath());
+  for (size_t i = 0; i < cached.size(); i++)
+    if (llvm::sys::fs::copy_file(cached[i], outputs[i]))
+      return false;
+
+  if (sharedLib)
+    library.sharedLibraryPath = library.getSharedLibraryPath();
+  if (staticLib)
+    library.staticLibraryPath = library.getStaticLibraryPath();
+  return true;
+}
+
+void storeCachedArtifacts(llvm::StringRef cacheDir, llvm::StringRef key,
+                          const CompilerEngine::Library &library) {
+  llvm::SmallString<0> entryPath(cacheDir);
+  llvm::sys::path::append(entryPath, key);
+
+  // The entry is filled in a fresh directory, then renamed, such that the
+  // concurrent compilations never see a partial entry
+  llvm::SmallString<0> tmpPath;
+  if (llvm::sys::fs::create_directories(cacheDir) ||
+      llvm::sys::fs::createUniqueDirectory(entryPath.str() + "-tmp", tmpPath))
+    return;
+  CompilerEngine::Library entry(tmpPath.str().str(), "", false);
+
+  std::vector<std::string> outputs =
+      getArtifactPaths(library, true, true, true, true);
+  std::vector<std::string> cached =
+      getArtifactPaths(entry, true, true, true, true);
+  bool copied = true;
+  for (size_t i = 0; i < outputs.size() && copied; i++)
+    if (llvm::sys::fs::exists(outputs[i]))
+      copied = !llvm::sys::fs::copy_file(outputs[i], cached[i]);
+
+  // An existing entry holds less artifacts than requested by this
+  // compilation, otherwise it would have been a hit
+  if (copied && llvm::sys::fs::rename(tmpPath, entryPath)) {
+    llvm::sys::fs::remove_directories(entryPath);
+    copied = !llvm::sys::fs::rename(tmpPath, entryPath);
+  }
+  if (!copied)
+    llvm::sys::fs::remove_directories(tmpPath);
+}
+
+std::optional<std::string>
+getOptimizerCacheKey(const optimizer::Dag &dag,
+                     const optimizer::Config &config) {
+  // The keyset restrictions have no stable description
+  if (config.keyset_restriction != nullptr)
+    return std::nullopt;
+  std::optional<std::string> buildId = getCompilerBuildId();
+  if (!buildId.has_value())
+    return std::nullopt;
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  OptionsWriter field(os);
+  field("version", SOLUTION_CACHE_VERSION);
+  field("dag", std::string(dag->fingerprint()));
+  field("p_error", config.p_error);
+  field("global_p_error", config.global_p_error);
+  field("strategy", config.strategy);
+  field("key_sharing", config.key_sharing);
+  field("multi_param_strategy", config.multi_param_strategy);
+  field("security", config.security);
+  field("fallback_log_norm_woppbs", config.fallback_log_norm_woppbs);
+  field("use_gpu_constraints", config.use_gpu_constraints);
+  field("encoding", config.encoding);
+  field("ciphertext_modulus_log", config.ciphertext_modulus_log);
+  field("fft_precision", config.fft_precision);
+  field("range_restriction", config.range_restriction);
+  field("composition_rules", config.composition_rules);
+  field("composable", config.composable);
+  field("nb_threads", config.nb_threads);
+  field("cost_model", config.cost_model);
+  field("gpu_number_of_sm", config.gpu_number_of_sm);
+  field("ks_cost_factor", config.ks_cost_factor);
+  field("pbs_cost_factor", config.pbs_cost_factor);
+  field("key_size_weight", config.key_size_weight);
+  field("key_reuse_threshold", config.key_reuse_threshold);
+  field("allow_pbs_ks_order", config.allow_pbs_ks_order);
+  field("many_lut_max_count", config.many_lut_max_count);
+  field("max_grouping_factor", config.max_grouping_factor);
+  field("compiler", *buildId);
+
+  return llvm::toHex(llvm::SHA256::hash(llvm::arrayRefFromStringRef(os.str())),
+                     /*LowerCase=*/true);
+}
+
+bool loadCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                        optimizer::DagSolution &solution) {
+  return loadSolution(config, key, solution);
+}
+
+bool loadCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                        optimizer::CircuitSolution &solution) {
+  return loadSolution(config, key, solution);
+}
+
+void storeCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                         optimizer::DagSolution solution) {
+  storeSolution(config, key, std::move(solution));
+}
+
+void storeCachedSolution(const optimizer::Config &config, llvm::StringRef key,
+                         optimizer::CircuitSolution solution) {
+  storeSolution(config, key, std::move(solution));
+}
+
+std::optional<std::string> getObjectCacheKey(llvm::StringRef ir,
+                                             llvm::StringRef cpu) {
+  std::optional<std::string> buildId = getCompilerBuildId();
+  if (!buildId.has_value())
+    return std::nullopt;
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  OptionsWriter field(os);
+  field("ir", ir.str());
+  field("cpu", cpu.str());
+  if (cpu == "host") {
+    field("hostCpu", llvm::sys::getHostCPUName().str());
+    field("features", getHostFeatures());
+  }
+  field("compiler", *buildId);
+
+  return llvm::toHex(llvm::SHA256::hash(llvm::arrayRefFromStringRef(os.str())),
+                     /*LowerCase=*/true);
+}
+
+bool loadCachedObject(llvm::StringRef cacheDir, llvm::StringRef key,
+                      llvm::StringRef objectPath) {
+  llvm::SmallString<0> entryPath(cacheDir);
+  llvm::sys::path::append(entryPath, key + ".o");
+  return llvm::sys::fs::exists(entryPath) &&
+         !llvm::sys::fs::copy_file(entryPath, objectPath);
+}
+
+void storeCachedObject(llvm::StringRef cacheDir, llvm::StringRef key,
+                       llvm::StringRef objectPath) {
+  llvm::SmallString<0> entryPath(cacheDir);
+  llvm::sys::path::append(entryPath, key + ".o");
+
+  // The entry is copied to a fresh file, then renamed, such that the
+  // concurrent compilations never read a partial object
+  llvm::SmallString<0> tmpPath;
+  if (llvm::sys::fs::create_directories(cacheDir) ||
+      llvm::sys::fs::createUniqueFile(entryPath.str() + "-%%%%%%.tmp",
+                                      tmpPath))
+    return;
+  if (llvm::sys::fs::copy_file(objectPath, tmpPath) ||
+      llvm::sys::fs::rename(tmpPath, entryPath))
+    llvm::sys::fs::remove(tmpPath);
+}
+
+} // namespace concretelang
+} // namespace mlir
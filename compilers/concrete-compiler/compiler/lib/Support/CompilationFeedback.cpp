@@ -3,7 +3,9 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <fstream>
 #include <vector>
 
@@ -92,6 +94,31 @@ void ProgramCompilationFeedback::fillFromProgramInfo(
             level, glweDimension, outputLweDimension, inputLweDimension) *
         byteSize;
   }
+  // Compute the scratch of the bootstraps, whose buffers grow to the largest
+  // parameters in each thread
+  uint64_t accumulatorSize = 0, bootstrapScratchSize = 0,
+           keyswitchOutputSize = 0;
+  for (auto bskInfo : params.getKeyset().getLweBootstrapKeys()) {
+    auto glweDimension = bskInfo.getParams().getGlweDimension();
+    auto polynomialSize = bskInfo.getParams().getPolynomialSize();
+    accumulatorSize = std::max<uint64_t>(
+        accumulatorSize, (glweDimension + 1) * polynomialSize * 8);
+    keyswitchOutputSize = std::max<uint64_t>(
+        keyswitchOutputSize,
+        (bskInfo.getParams().getInputLweDimension() + 1) * 8);
+    auto fft = (struct Fft *)aligned_alloc(CONCRETE_FFT_ALIGN,
+                                           CONCRETE_FFT_SIZE);
+    concrete_cpu_construct_concrete_fft(fft, polynomialSize);
+    size_t scratchSize, scratchAlign;
+    concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+        &scratchSize, &scratchAlign, glweDimension, polynomialSize, fft);
+    concrete_cpu_destroy_concrete_fft(fft);
+    free(fft);
+    bootstrapScratchSize = std::max<uint64_t>(bootstrapScratchSize,
+                                              scratchSize);
+  }
+  runtimeScratchSize =
+      accumulatorSize + bootstrapScratchSize + keyswitchOutputSize;
   // Compute the keyswitch keys size
   totalKeyswitchKeysSize = 0;
   for (auto kskInfo : params.getKeyset().getLweKeyswitchKeys()) {
@@ -237,6 +264,18 @@ llvm::json::Array circuitFeedbacksToJson(
          crtDecompositionToJson(circuit.crtDecompositionsOfOutputs)},
         {"statistics", statisticsToJson(circuit.statistics)},
         {"memoryUsagePerLoc", memoryUsageToJson(circuit.memoryUsagePerLoc)},
+        {"removedPbsCount", circuit.removedPbsCount},
+        {"removedKeySwitchCount", circuit.removedKeySwitchCount},
+        {"fusedPbsCount", circuit.fusedPbsCount},
+        {"peakMemoryUsage", circuit.peakMemoryUsage},
+        {"allocatedMemory", circuit.allocatedMemory},
+        {"allocatedMemoryWithoutBufferReuse",
+         circuit.allocatedMemoryWithoutBufferReuse},
+        {"pbsDepth", circuit.pbsDepth},
+        {"averagePbsParallelism", circuit.averagePbsParallelism},
+        {"batchablePbsCount", circuit.batchablePbsCount},
+        {"predictedLatency", circuit.predictedLatency},
+        {"predictedThroughput", circuit.predictedThroughput},
     };
     object.push_back(std::move(circuitObject));
   }
@@ -252,6 +291,7 @@ toJSON(const mlir::concretelang::ProgramCompilationFeedback &program) {
       {"totalSecretKeysSize", program.totalSecretKeysSize},
       {"totalBootstrapKeysSize", program.totalBootstrapKeysSize},
       {"totalKeyswitchKeysSize", program.totalKeyswitchKeysSize},
+      {"runtimeScratchSize", program.runtimeScratchSize},
       {"circuitFeedbacks", circuitFeedbacksToJson(program.circuitFeedbacks)}};
   return programObject;
 }
@@ -348,7 +388,19 @@ bool fromJSON(const llvm::json::Value j,
          O.map("totalOutputsSize", v.totalOutputsSize) &&
          O.map("crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs) &&
          O.map("statistics", v.statistics) &&
-         O.map("memoryUsagePerLoc", v.memoryUsagePerLoc);
+         O.map("memoryUsagePerLoc", v.memoryUsagePerLoc) &&
+         O.mapOptional("removedPbsCount", v.removedPbsCount) &&
+         O.mapOptional("removedKeySwitchCount", v.removedKeySwitchCount) &&
+         O.mapOptional("fusedPbsCount", v.fusedPbsCount) &&
+         O.mapOptional("peakMemoryUsage", v.peakMemoryUsage) &&
+         O.mapOptional("allocatedMemory", v.allocatedMemory) &&
+         O.mapOptional("allocatedMemoryWithoutBufferReuse",
+                       v.allocatedMemoryWithoutBufferReuse) &&
+         O.mapOptional("pbsDepth", v.pbsDepth) &&
+         O.mapOptional("averagePbsParallelism", v.averagePbsParallelism) &&
+         O.mapOptional("batchablePbsCount", v.batchablePbsCount) &&
+         O.mapOptional("predictedLatency", v.predictedLatency) &&
+         O.mapOptional("predictedThroughput", v.predictedThroughput);
 }
 
 bool fromJSON(const llvm::json::Value j,
@@ -361,6 +413,7 @@ bool fromJSON(const llvm::json::Value j,
          O.map("totalSecretKeysSize", v.totalSecretKeysSize) &&
          O.map("totalBootstrapKeysSize", v.totalBootstrapKeysSize) &&
          O.map("totalKeyswitchKeysSize", v.totalKeyswitchKeysSize) &&
+         O.mapOptional("runtimeScratchSize", v.runtimeScratchSize) &&
          O.map("circuitFeedbacks", v.circuitFeedbacks);
 }
 
@@ -0,0 +1,195 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+#include "concretelang/Support/CompilationProfile.h"
+#include "mlir/Pass/PassInstrumentation.h"
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double>(end - start).count();
+}
+
+/// Returns the resident memory of the process, in bytes
+uint64_t getResidentMemory() {
+#ifdef __APPLE__
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info,
+                &count) != KERN_SUCCESS)
+    return 0;
+  return info.resident_size;
+#else
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident))
+    return 0;
+  return resident * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/// Returns the peak resident memory of the process, in bytes
+uint64_t getPeakResidentMemory() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+void recordStage(CompilationProfile &profile, StageProfile stage,
+                 Clock::time_point start, Clock::time_point end) {
+  stage.seconds = secondsSince(start, end);
+  stage.residentMemory = getResidentMemory();
+  stage.peakResidentMemory = getPeakResidentMemory();
+  profile.stages.push_back(std::move(stage));
+}
+
+/// Times the passes of a pipeline, recording them as a stage of `profile`
+/// once the pass manager owning the instrumentation is destroyed, i.e. once
+/// the pipeline has run.
+class StageInstrumentation : public mlir::PassInstrumentation {
+public:
+  StageInstrumentation(llvm::StringRef name, CompilationProfile &profile)
+      : name(name.str()), profile(profile) {}
+
+  ~StageInstrumentation() override {
+    if (!start.has_value())
+      return;
+    StageProfile stage;
+    stage.name = name;
+    for (auto &pass : passes)
+      stage.passes.push_back(PassProfile{pass.first, pass.second});
+    recordStage(profile, std::move(stage), *start, end);
+  }
+
+  void runBeforePass(mlir::Pass *pass, mlir::Operation *op) override {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!start.has_value())
+      start = now;
+    running[{pass, op}] = now;
+  }
+
+  void runAfterPass(mlir::Pass *pass, mlir::Operation *op) override {
+    runAfter(pass, op);
+  }
+
+  void runAfterPassFailed(mlir::Pass *pass, mlir::Operation *op) override {
+    runAfter(pass, op);
+  }
+
+private:
+  void runAfter(mlir::Pass *pass, mlir::Operation *op) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = running.find({pass, op});
+    if (it == running.end())
+      return;
+    end = now;
+    // The adaptors running nested pipelines would count their passes twice
+    llvm::StringRef passName = pass->getName();
+    if (passName.substr(0, 19) != "Pipeline Collection") {
+      auto index = passIndex.try_emplace(passName.str(), passes.size());
+      if (index.second)
+        passes.emplace_back(passName.str(), 0.);
+      passes[index.first->second].second += secondsSince(it->second, now);
+    }
+    running.erase(it);
+  }
+
+  std::string name;
+  CompilationProfile &profile;
+  std::mutex mutex;
+  std::optional<Clock::time_point> start;
+  Clock::time_point end;
+  std::map<std::pair<mlir::Pass *, mlir::Operation *>, Clock::time_point>
+      running;
+  /// The passes in the order they first ran, with their seconds
+  std::vector<std::pair<std::string, double>> passes;
+  std::map<std::string, size_t> passIndex;
+};
+
+thread_local CompilationProfile *currentCompilationProfile = nullptr;
+
+} // namespace
+
+void setCurrentCompilationProfile(CompilationProfile *profile) {
+  currentCompilationProfile = profile;
+}
+
+CompilationProfile *getCurrentCompilationProfile() {
+  return currentCompilationProfile;
+}
+
+void profilePipeline(llvm::StringRef name, mlir::PassManager &pm) {
+  if (currentCompilationProfile == nullptr)
+    return;
+  pm.addInstrumentation(
+      std::make_unique<StageInstrumentation>(name, *currentCompilationProfile));
+}
+
+ProfiledStage::ProfiledStage(llvm::StringRef name)
+    : profile(currentCompilationProfile), name(name.str()),
+      start(Clock::now()) {}
+
+ProfiledStage::~ProfiledStage() {
+  if (profile == nullptr)
+    return;
+  StageProfile stage;
+  stage.name = name;
+  recordStage(*profile, std::move(stage), start, Clock::now());
+}
+
+CompilationProfileScope::CompilationProfileScope(CompilationProfile *profile)
+    : previous(currentCompilationProfile) {
+  currentCompilationProfile = profile;
+}
+
+CompilationProfileScope::~CompilationProfileScope() {
+  currentCompilationProfile = previous;
+}
+
+llvm::json::Value toJSON(const mlir::concretelang::CompilationProfile &v) {
+  llvm::json::Array stages;
+  for (auto &stage : v.stages) {
+    llvm::json::Array passes;
+    for (auto &pass : stage.passes) {
+      passes.push_back(llvm::json::Object{
+          {"name", pass.name},
+          {"seconds", pass.seconds},
+      });
+    }
+    stages.push_back(llvm::json::Object{
+        {"name", stage.name},
+        {"seconds", stage.seconds},
+        {"residentMemory", (int64_t)stage.residentMemory},
+        {"peakResidentMemory", (int64_t)stage.peakResidentMemory},
+        {"passes", std::move(passes)},
+    });
+  }
+  return llvm::json::Object{{"stages", std::move(stages)}};
+}
+
+} // namespace concretelang
+} // namespace mlir
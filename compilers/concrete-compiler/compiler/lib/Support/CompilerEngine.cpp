@@ -14,6 +14,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <llvm/Support/Debug.h>
 #include <memory>
 #include <mlir/Dialect/Arith/Transforms/BufferizableOpInterfaceImpl.h>
@@ -25,6 +26,7 @@
 #include <optional>
 #include <stdio.h>
 #include <string>
+#include <thread>
 
 #include "mlir/Dialect/Bufferization/Transforms/FuncBufferizableOpInterfaceImpl.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
@@ -45,7 +47,10 @@
 #include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
 #include "concretelang/Dialect/Concrete/Transforms/BufferizableOpInterfaceImpl.h"
 #include "concretelang/Dialect/FHE/IR/FHEDialect.h"
+#include "concretelang/Dialect/FHE/IR/FHEOps.h"
 #include "concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h"
+#include "concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/Tiling.h"
 #include "concretelang/Dialect/Optimizer/IR/OptimizerDialect.h"
 #include "concretelang/Dialect/RT/IR/RTDialect.h"
 #include "concretelang/Dialect/RT/Transforms/BufferizableOpInterfaceImpl.h"
@@ -53,13 +58,17 @@
 #include "concretelang/Dialect/SDFG/Transforms/BufferizableOpInterfaceImpl.h"
 #include "concretelang/Dialect/SDFG/Transforms/SDFGConvertibleOpInterfaceImpl.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEDialect.h"
+#include "concretelang/Dialect/TFHE/Transforms/Transforms.h"
 #include "concretelang/Dialect/Tracing/IR/TracingDialect.h"
 #include "concretelang/Dialect/Tracing/Transforms/BufferizableOpInterfaceImpl.h"
 #include "concretelang/Dialect/TypeInference/IR/TypeInferenceDialect.h"
 #include "concretelang/Runtime/DFRuntime.hpp"
+#include "concretelang/Support/CompilationCache.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "concretelang/Support/Encodings.h"
 #include "concretelang/Support/Error.h"
+#include "concretelang/Support/JITModule.h"
+#include "concretelang/Support/LatencyModel.h"
 #include "concretelang/Support/LLVMEmitFile.h"
 #include "concretelang/Support/Pipeline.h"
 #include "concretelang/Support/Utils.h"
@@ -99,6 +108,29 @@ std::string getCompilationFeedbackPath(std::string outputDirPath) {
   llvm::sys::path::append(compilationFeedbackPath, "compilation_feedback.json");
   return compilationFeedbackPath.str().str();
 }
+
+/// Returns the path of the compilation profile
+std::string getCompilationProfilePath(std::string outputDirPath) {
+  llvm::SmallString<0> compilationProfilePath(outputDirPath);
+  llvm::sys::path::append(compilationProfilePath, "compilation_profile.json");
+  return compilationProfilePath.str().str();
+}
+
+/// The maximum precision of the table lookups of the roundings tried when
+/// choosing it by cost
+constexpr unsigned MAX_ROUND_TLU_PRECISION = 8;
+
+/// Returns true if `module` rounds some encrypted integers
+bool hasRounds(mlir::ModuleOp module) {
+  return module
+      .walk([](mlir::Operation *op) {
+        if (llvm::isa<mlir::concretelang::FHE::RoundEintOp,
+                      mlir::concretelang::FHELinalg::RoundOp>(op))
+          return mlir::WalkResult::interrupt();
+        return mlir::WalkResult::advance();
+      })
+      .wasInterrupted();
+}
 } // namespace
 
 namespace mlir {
@@ -187,6 +219,30 @@ void CompilerEngine::setMaxMANP(size_t v) { this->overrideMaxMANP = v; }
 void CompilerEngine::setEnablePass(
     std::function<bool(mlir::Pass *)> enablePass) {
   this->enablePass = enablePass;
+  this->customEnablePass = true;
+}
+
+std::optional<std::string>
+CompilerEngine::getCompilationCacheKey(llvm::ArrayRef<std::string> sources,
+                                       llvm::StringRef runtimeLibraryPath) {
+  if (this->customEnablePass)
+    return std::nullopt;
+  std::optional<std::string> optionsKey =
+      getCompilationOptionsKey(this->compilerOptions);
+  if (!optionsKey.has_value())
+    return std::nullopt;
+
+  // The overrides of the engine change the parameters, and the runtime
+  // library is linked to the shared library
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << *optionsKey << "maxEintPrecision="
+     << this->overrideMaxEintPrecision.value_or(0)
+     << ";maxMANP=" << this->overrideMaxMANP.value_or(0)
+     << ";generateProgramInfo=" << this->generateProgramInfo
+     << ";runtimeLibraryPath=" << runtimeLibraryPath.size() << ":"
+     << runtimeLibraryPath << ";";
+  return mlir::concretelang::getCompilationCacheKey(sources, os.str());
 }
 
 /// Returns the optimizer::Description
@@ -195,6 +251,10 @@ CompilerEngine::getConcreteOptimizerDescription(CompilationResult &res) {
   mlir::MLIRContext &mlirContext = *this->compilationContext->getMLIRContext();
   mlir::ModuleOp module = res.mlirModuleRef->get();
   auto config = this->compilerOptions.optimizerConfig;
+  // The many-LUT bootstrap is only implemented on cpu, and not simulated
+  if (compilerOptions.emitGPUOps || compilerOptions.simulate ||
+      llvm::is_contained(compilerOptions.executionVariants, "gpu"))
+    config.many_lut_max_count = 1;
   // If the values has been overwritten returns
   if (this->overrideMaxEintPrecision.has_value() &&
       this->overrideMaxMANP.has_value()) {
@@ -244,9 +304,23 @@ llvm::Error CompilerEngine::determineFHEParameters(CompilationResult &res) {
     }
     ProgramCompilationFeedback feedback;
     // Make sure to use the gpu constraint of the optimizer if we use gpu
-    // backend.
+    // backend, or if an execution variant does, the variants sharing the
+    // parameters of the default code.
     compilerOptions.optimizerConfig.use_gpu_constraints =
-        compilerOptions.emitGPUOps;
+        compilerOptions.emitGPUOps ||
+        llvm::is_contained(compilerOptions.executionVariants, "gpu");
+    // The multi-bit bootstrap is only run by the GPU wrappers, not by the
+    // SDFG nor on CPU, and its keys are not compressed.
+    if (!compilerOptions.emitGPUOps || compilerOptions.emitSDFGOps ||
+        compilerOptions.simulate || compilerOptions.compressEvaluationKeys ||
+        !compilerOptions.executionVariants.empty())
+      compilerOptions.optimizerConfig.max_grouping_factor = 0;
+    // The fourier bootstrap keys stored in single precision add the noise of
+    // a less precise fft.
+    if (compilerOptions.compactFourierBootstrapKeys)
+      compilerOptions.optimizerConfig.fft_precision =
+          std::min(compilerOptions.optimizerConfig.fft_precision,
+                   optimizer::COMPACT_FOURIER_PRECISION);
     auto expectedSolution = getSolution(descr.get().value(), feedback,
                                         compilerOptions.optimizerConfig);
     if (auto err = expectedSolution.takeError()) {
@@ -264,6 +338,20 @@ llvm::Error CompilerEngine::determineFHEParameters(CompilationResult &res) {
   return llvm::Error::success();
 }
 
+/// Returns the complexity of the parameters found by the optimizer for a copy
+/// of `module`, infinite if none is found
+double CompilerEngine::getOptimizedComplexity(mlir::ModuleOp module) {
+  CompilationResult res(this->compilationContext);
+  res.mlirModuleRef = mlir::OwningOpRef<mlir::ModuleOp>(module.clone());
+  if (auto err = this->determineFHEParameters(res)) {
+    llvm::consumeError(std::move(err));
+    return std::numeric_limits<double>::infinity();
+  }
+  if (!res.feedback.has_value())
+    return std::numeric_limits<double>::infinity();
+  return res.feedback->complexity;
+}
+
 mlir::LogicalResult
 CompilerEngine::materializeOptimizerPartitionFrontiers(CompilationResult &res) {
   mlir::ModuleOp module = res.mlirModuleRef->get();
@@ -277,6 +365,112 @@ CompilerEngine::materializeOptimizerPartitionFrontiers(CompilationResult &res) {
 }
 
 using OptionalLib = std::optional<std::shared_ptr<CompilerEngine::Library>>;
+
+/// Sets the options of the execution variant `name` on `options`
+static llvm::Error applyExecutionVariant(CompilationOptions &options,
+                                         llvm::StringRef name) {
+  options.autoParallelize = false;
+  options.loopParallelize = false;
+  options.dataflowParallelize = false;
+  options.emitGPUOps = false;
+  options.emitSDFGOps = false;
+  if (name == "loop") {
+    options.loopParallelize = true;
+  } else if (name == "dataflow") {
+    options.loopParallelize = true;
+    options.dataflowParallelize = true;
+  } else if (name == "gpu") {
+    options.loopParallelize = true;
+    options.batchTFHEOps = true;
+    options.emitGPUOps = true;
+    options.emitSDFGOps = true;
+  } else if (name != "cpu") {
+    return StreamStringError("Unknown execution variant ")
+           << name << ", expected cpu, loop, dataflow or gpu";
+  }
+  return llvm::Error::success();
+}
+
+/// Records the execution variants `names` in the info of `circuit`
+static void
+setExecutionVariants(concreteprotocol::CircuitInfo::Builder circuit,
+                     const std::vector<std::string> &names) {
+  auto variants = circuit.initVariants(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    variants[i].setName(names[i]);
+    variants[i].setGpu(names[i] == "gpu");
+    variants[i].setParallel(names[i] == "loop" || names[i] == "dataflow");
+  }
+}
+
+llvm::Expected<CompilerEngine::CompilationResult>
+CompilerEngine::compileExecutionVariants(mlir::ModuleOp moduleOp,
+                                         std::shared_ptr<Library> lib) {
+  // The module is lowered in place, each variant is compiled from a copy
+  mlir::OwningOpRef<mlir::ModuleOp> module(moduleOp);
+  CompilationOptions defaultOptions = compilerOptions;
+  std::vector<std::string> compiled;
+  std::vector<Message<concreteprotocol::KeysetInfo>> keysets;
+  compilingVariants = true;
+  auto restore = [&](llvm::Error err) {
+    compilerOptions = defaultOptions;
+    symbolSuffix.clear();
+    compilingVariants = false;
+    return err;
+  };
+
+  for (auto &variant : defaultOptions.executionVariants) {
+    if (llvm::is_contained(compiled, variant))
+      return restore(StreamStringError("Duplicate execution variant ")
+                     << variant);
+    if (variant == "gpu" &&
+        !mlir::concretelang::gpu_dfg::check_cuda_runtime_enabled()) {
+      warnx("This instance of the Concrete compiler does not support GPU "
+            "acceleration. Skipping the gpu execution variant.");
+      continue;
+    }
+    compilerOptions = defaultOptions;
+    if (auto err = applyExecutionVariant(compilerOptions, variant))
+      return restore(std::move(err));
+    symbolSuffix = "__" + variant;
+    auto compilation = compile(module->clone(), Target::LIBRARY, lib);
+    if (!compilation)
+      return restore(compilation.takeError());
+    keysets.emplace_back(compilation->programInfo->asReader().getKeyset());
+    compiled.push_back(variant);
+  }
+
+  // The default code is compiled last, its program info and feedback being
+  // the ones of the library
+  compilerOptions = defaultOptions;
+  compilerOptions.executionVariants = compiled;
+  symbolSuffix.clear();
+  auto compilation = compile(module.release(), Target::LIBRARY, lib);
+  if (!compilation)
+    return restore(compilation.takeError());
+  Message<concreteprotocol::KeysetInfo> keyset(
+      compilation->programInfo->asReader().getKeyset());
+  for (size_t i = 0; i < compiled.size(); i++) {
+    if (keysets[i] != keyset)
+      return restore(StreamStringError("The execution variant ")
+                     << compiled[i]
+                     << " does not share the parameters of the default code");
+  }
+  if (auto err = restore(llvm::Error::success()))
+    return std::move(err);
+  return compilation;
+}
+
+/// Returns the profile the compilation of `lib` is recorded in, or nullptr if
+/// it is not profiled
+static CompilationProfile *getLibraryProfile(const CompilationOptions &options,
+                                             OptionalLib lib) {
+  if (!lib || !options.compilationProfile)
+    return nullptr;
+  lib.value()->enableCompilationProfile();
+  return lib.value()->getCompilationProfile();
+}
+
 // Compile the sources managed by the source manager `sm` to the
 // target dialect `target`. If successful, the result can be retrieved
 // using `getModule()` and `getLLVMModule()`, respectively depending
@@ -307,8 +501,12 @@ CompilerEngine::compile(llvm::SourceMgr &sm, Target target, OptionalLib lib) {
 
   mlirContext.printOpOnDiagnostic(false);
 
-  mlir::OwningOpRef<mlir::ModuleOp> mlirModuleRef =
-      mlir::parseSourceFile<mlir::ModuleOp>(sm, &mlirContext);
+  CompilationProfileScope profileScope(getLibraryProfile(options, lib));
+  mlir::OwningOpRef<mlir::ModuleOp> mlirModuleRef;
+  {
+    ProfiledStage stage("Parsing");
+    mlirModuleRef = mlir::parseSourceFile<mlir::ModuleOp>(sm, &mlirContext);
+  }
 
   if (options.verifyDiagnostics) {
     if (smHandler->verify().failed())
@@ -327,12 +525,18 @@ CompilerEngine::compile(llvm::SourceMgr &sm, Target target, OptionalLib lib) {
 llvm::Expected<CompilerEngine::CompilationResult>
 CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
                         OptionalLib lib) {
+  if (target == Target::LIBRARY && lib && !compilingVariants &&
+      !compilerOptions.executionVariants.empty())
+    return compileExecutionVariants(moduleOp, lib.value());
+
   CompilationResult res(this->compilationContext);
 
   CompilationOptions &options = this->compilerOptions;
 
   mlir::MLIRContext &mlirContext = *this->compilationContext->getMLIRContext();
 
+  CompilationProfileScope profileScope(getLibraryProfile(options, lib));
+
   auto dataflowParallelize =
       options.autoParallelize || options.dataflowParallelize;
   auto loopParallelize = options.autoParallelize || options.loopParallelize;
@@ -367,8 +571,10 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
       }
     } else {
       // Ensure that at least one Cuda device is available if GPU option
-      // is used
-      if (!mlir::concretelang::gpu_dfg::check_cuda_device_available()) {
+      // is used, unless compiling an execution variant, which only runs on
+      // the hosts with GPUs
+      if (symbolSuffix.empty() &&
+          !mlir::concretelang::gpu_dfg::check_cuda_device_available()) {
         warnx("No Cuda device available on this system (either not present or "
               "the driver is not online).\n"
               "Continuing without GPU acceleration.");
@@ -390,8 +596,17 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   // If dataflow parallelization will proceed, mark it for
   // initialising the runtime
-  if (dataflowParallelize)
+  if (dataflowParallelize) {
+    mlir::concretelang::dfr::_dfr_thread_policy threadPolicy;
+    if (!mlir::concretelang::dfr::_dfr_parse_thread_policy(
+            options.dataflowThreadPolicy.c_str(), threadPolicy))
+      return StreamStringError("Invalid dataflow thread policy '")
+             << options.dataflowThreadPolicy
+             << "', expected default, partition or shared";
+    mlir::concretelang::dfr::_dfr_set_thread_policy(
+        threadPolicy, std::max<int64_t>(options.dataflowThreads, 0));
     mlir::concretelang::dfr::_dfr_set_required(true);
+  }
 
   mlir::OwningOpRef<mlir::ModuleOp> mlirModuleRef(moduleOp);
   res.mlirModuleRef = std::move(mlirModuleRef);
@@ -412,21 +627,112 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     options.encodings = std::move(*encodingInfosOrErr);
   }
 
-  if (mlir::concretelang::pipeline::transformFHEBoolean(mlirContext, module,
-                                                        enablePass)
+  if (options.fuseBooleanGates && options.booleanGateFusionMaxInputs != 2 &&
+      options.booleanGateFusionMaxInputs != 3) {
+    return StreamStringError(
+        "Boolean gates can only be fused on 2 or 3 inputs");
+  }
+  if (mlir::concretelang::pipeline::transformFHEBoolean(
+          mlirContext, module, enablePass, options.fuseBooleanGates,
+          options.booleanGateFusionMaxInputs)
           .failed()) {
     return StreamStringError("Transforming FHE boolean ops failed");
   }
 
-  if (options.chunkIntegers) {
+  // Prices the chunked and unchunked circuits with the optimizer, the optimizer
+  // choosing itself between the native and crt encodings
+  bool chunkIntegers = options.chunkIntegers;
+  if (options.chunkIntegersByCost && !chunkIntegers &&
+      !options.v0Parameter.has_value()) {
+    mlir::OwningOpRef<mlir::ModuleOp> chunked(module.clone());
+    mlir::ModuleOp chunkedModule = chunked.get();
+    if (mlir::concretelang::pipeline::transformFHEBigInt(
+            mlirContext, chunkedModule, enablePass, options.chunkSize,
+            options.chunkWidth, options.chunkCarryLookahead)
+            .failed()) {
+      return StreamStringError("Transforming FHE big integer ops failed");
+    }
+    chunkIntegers =
+        getOptimizedComplexity(chunkedModule) < getOptimizedComplexity(module);
+  }
+
+  if (chunkIntegers) {
     if (mlir::concretelang::pipeline::transformFHEBigInt(
             mlirContext, module, enablePass, options.chunkSize,
-            options.chunkWidth)
+            options.chunkWidth, options.chunkCarryLookahead)
             .failed()) {
       return StreamStringError("Transforming FHE big integer ops failed");
     }
   }
 
+  if (options.fhelinalgMatMulSharedTLU) {
+    if (mlir::concretelang::pipeline::shareEncryptedMatMulTLUs(
+            mlirContext, module, enablePass)
+            .failed()) {
+      return StreamStringError(
+          "Sharing the table lookups of encrypted matmuls failed");
+    }
+  }
+
+  if (options.specializeConstantMatMul) {
+    if (mlir::concretelang::pipeline::specializeConstantMatMul(
+            mlirContext, module, enablePass)
+            .failed()) {
+      return StreamStringError(
+          "Specializing the matmuls by constant weights failed");
+    }
+  }
+
+  std::map<std::string, uint64_t> fusedLookupCounts;
+  if (options.fuseTLUChains) {
+    if (mlir::concretelang::pipeline::fuseLookupTableChains(
+            mlirContext, module, enablePass, fusedLookupCounts)
+            .failed()) {
+      return StreamStringError("Fusing the chains of table lookups failed");
+    }
+  }
+
+  if (options.narrowTLUInputs) {
+    if (mlir::concretelang::pipeline::narrowLookupTableInputs(
+            mlirContext, module, enablePass)
+            .failed()) {
+      return StreamStringError(
+          "Narrowing the inputs of the table lookups failed");
+    }
+  }
+
+  // Prices the circuits rounding with table lookups of each precision with
+  // the optimizer, the bit by bit rounding being kept if it is the cheapest
+  unsigned roundTLUMaxPrecision = options.roundTLUMaxPrecision;
+  if (options.roundTLUByCost && roundTLUMaxPrecision == 0 &&
+      hasRounds(module) &&
+      !options.v0Parameter.has_value()) {
+    double bestComplexity = getOptimizedComplexity(module);
+    for (unsigned precision = 2; precision <= MAX_ROUND_TLU_PRECISION;
+         precision++) {
+      mlir::OwningOpRef<mlir::ModuleOp> rounded(module.clone());
+      mlir::ModuleOp roundedModule = rounded.get();
+      if (mlir::concretelang::pipeline::roundWithLookupTables(
+              mlirContext, roundedModule, enablePass, precision)
+              .failed()) {
+        return StreamStringError("Rounding with table lookups failed");
+      }
+      double complexity = getOptimizedComplexity(roundedModule);
+      if (complexity < bestComplexity) {
+        bestComplexity = complexity;
+        roundTLUMaxPrecision = precision;
+      }
+    }
+  }
+
+  if (roundTLUMaxPrecision != 0) {
+    if (mlir::concretelang::pipeline::roundWithLookupTables(
+            mlirContext, module, enablePass, roundTLUMaxPrecision)
+            .failed()) {
+      return StreamStringError("Rounding with table lookups failed");
+    }
+  }
+
   // FHE High level pass to determine FHE parameters
   if (auto err = this->determineFHEParameters(res))
     return std::move(err);
@@ -442,7 +748,7 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     std::optional<
         Message<concreteprotocol::IntegerCiphertextEncodingInfo::ChunkedMode>>
         maybeChunkInfo(std::nullopt);
-    if (options.chunkIntegers) {
+    if (chunkIntegers) {
       auto chunkedMode = Message<
           concreteprotocol::IntegerCiphertextEncodingInfo::ChunkedMode>();
       chunkedMode.asBuilder().setSize(options.chunkSize);
@@ -462,12 +768,29 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
           "Marking of FHELinalg operations for tiling failed");
   }
 
+  if (options.fhelinalgAutoTiling) {
+    AutoTilingParameters parameters;
+    parameters.parallelism = options.fhelinalgAutoTilingCores;
+    parameters.minPbsPerTile = options.fhelinalgAutoTilingMinPbs;
+    parameters.maxMemory = options.fhelinalgAutoTilingMaxMemory;
+    if (res.fheContext.has_value())
+      parameters.ciphertextSize =
+          getCiphertextSizeFromSolution(res.fheContext->solution);
+
+    if (mlir::concretelang::pipeline::markFHELinalgForAutoTiling(
+            mlirContext, module, parameters, enablePass)
+            .failed())
+      return StreamStringError(
+          "Automatic marking of FHELinalg operations for tiling failed");
+  }
+
   if (target == Target::FHE)
     return std::move(res);
 
   // FHELinalg -> FHE
-  if (mlir::concretelang::pipeline::lowerFHELinalgToLinalg(mlirContext, module,
-                                                           enablePass)
+  if (mlir::concretelang::pipeline::lowerFHELinalgToLinalg(
+          mlirContext, module, enablePass, options.fhelinalgTreeReduction,
+          options.fhelinalgIm2colConv2d, options.fhelinalgMaxpool2dTree)
           .failed()) {
     return StreamStringError("Lowering from FHELinalg to Linalg failed");
   }
@@ -499,7 +822,9 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   // Dataflow parallelization
   if (dataflowParallelize &&
-      mlir::concretelang::pipeline::autopar(mlirContext, module, enablePass)
+      mlir::concretelang::pipeline::autopar(mlirContext, module, enablePass,
+                                            options.dataflowMinTaskWork,
+                                            options.dataflowUnrollFactor)
           .failed()) {
     return StreamStringError("Dataflow parallelization failed");
   }
@@ -514,8 +839,9 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   }
 
   // FHE -> TFHE
-  if (mlir::concretelang::pipeline::lowerFHEToTFHE(mlirContext, module,
-                                                   res.fheContext, enablePass)
+  if (mlir::concretelang::pipeline::lowerFHEToTFHE(
+          mlirContext, module, res.fheContext, enablePass,
+          this->compilerOptions.batchCrtBlocks)
           .failed()) {
     return StreamStringError("Lowering from FHE to TFHE failed");
   }
@@ -544,6 +870,15 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return StreamStringError("Parametrization of TFHE operations failed");
   }
 
+  // Merging the identical keyswitches and bootstraps
+  std::map<std::string, TFHEDeduplicationCounts> deduplicationCounts;
+  if (this->compilerOptions.optimizeTFHE &&
+      mlir::concretelang::pipeline::deduplicateTFHE(
+          mlirContext, module, this->enablePass, deduplicationCounts)
+          .failed()) {
+    return StreamStringError("Deduplicating TFHE operations failed");
+  }
+
   if (target == Target::PARAMETRIZED_TFHE)
     return std::move(res);
 
@@ -574,13 +909,34 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
           mlir::concretelang::createProgramInfoFromTfheDialect(
               module, options.optimizerConfig.security,
               options.encodings.value(), options.compressEvaluationKeys,
-              options.compressInputCiphertexts);
+              options.compressInputCiphertexts,
+              options.compressOutputCiphertexts,
+              getPErrorFromSolution(res.fheContext->solution,
+                                    options.optimizerConfig),
+              options.compactFourierBootstrapKeys
+                  ? optimizer::COMPACT_FOURIER_PRECISION
+                  : 0);
 
       if (!programInfoOrErr)
         return programInfoOrErr.takeError();
 
       res.programInfo = std::move(*programInfoOrErr);
       res.feedback->fillFromProgramInfo(*res.programInfo);
+      for (auto &circuitFeedback : res.feedback->circuitFeedbacks) {
+        auto fused = fusedLookupCounts.find(circuitFeedback.name);
+        if (fused != fusedLookupCounts.end())
+          circuitFeedback.fusedPbsCount = fused->second;
+        auto counts = deduplicationCounts.find(circuitFeedback.name);
+        if (counts == deduplicationCounts.end())
+          continue;
+        circuitFeedback.removedPbsCount = counts->second.bootstraps;
+        circuitFeedback.removedKeySwitchCount = counts->second.keyswitches;
+      }
+    }
+    for (auto circuit : res.programInfo->asBuilder().getCircuits()) {
+      circuit.setDestinationPassing(options.destinationPassing);
+      if (target == Target::LIBRARY && symbolSuffix.empty())
+        setExecutionVariants(circuit, options.executionVariants);
     }
   }
 
@@ -593,12 +949,48 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
             .failed()) {
       return StreamStringError("Extracting TFHE statistics failed");
     }
+
+    if (options.latencyCostTable.has_value()) {
+      auto costs = PrimitiveCostTable::load(*options.latencyCostTable,
+                                            options.latencyTargetDevice);
+      if (costs.has_failure())
+        return StreamStringError(costs.as_failure().error().mesg);
+      LatencyModel model;
+      model.costs = costs.value();
+      if (options.latencyTargetCores != 0)
+        model.costs.parallelism = options.latencyTargetCores;
+      model.overlapOperations = options.dataflowParallelize;
+      model.parallelLoops = options.loopParallelize || options.batchTFHEOps;
+      if (mlir::concretelang::pipeline::predictTFHELatency(
+              mlirContext, module, this->enablePass, res.feedback.value(),
+              model)
+              .failed()) {
+        return StreamStringError("Predicting the latency of the circuits "
+                                 "failed");
+      }
+    }
+  }
+
+  // the simulated circuits are batched before their TFHE operations are
+  // lowered to the simulation runtime, which has batched versions of them,
+  // including of the WoP-PBS
+  if (options.simulate && options.batchTFHEOps) {
+    if (mlir::concretelang::pipeline::batchTFHE(mlirContext, module, enablePass,
+                                                options.maxBatchSize, true)
+            .failed()) {
+      return StreamStringError("Batching of TFHE operations");
+    }
   }
 
   if (options.simulate) {
+    // the feedback is left empty when the parameters come from the options
+    double pError = 0;
+    if (res.feedback.has_value() && !options.v0Parameter.has_value())
+      pError = res.feedback->pError;
     if (mlir::concretelang::pipeline::simulateTFHE(
             mlirContext, module, res.fheContext,
-            options.enableOverflowDetectionInSimulation, this->enablePass)
+            options.enableOverflowDetectionInSimulation,
+            options.enableNoiseInSimulation, pError, this->enablePass)
             .failed()) {
       return StreamStringError("Simulating TFHE failed");
     }
@@ -607,9 +999,12 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   if (target == Target::SIMULATED_TFHE)
     return std::move(res);
 
-  if (options.batchTFHEOps) {
+  // The WoP-PBS are batched as well on cpu, whose runtime spreads the batched
+  // WoP-PBS over its workers, but there is no gpu version of it
+  if (options.batchTFHEOps && !options.simulate) {
     if (mlir::concretelang::pipeline::batchTFHE(mlirContext, module, enablePass,
-                                                options.maxBatchSize)
+                                                options.maxBatchSize,
+                                                !options.emitGPUOps)
             .failed()) {
       return StreamStringError("Batching of TFHE operations");
     }
@@ -633,7 +1028,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   if (options.emitSDFGOps) {
     if (mlir::concretelang::pipeline::extractSDFGOps(
             mlirContext, module, enablePass,
-            options.unrollLoopsWithSDFGConvertibleOps)
+            options.unrollLoopsWithSDFGConvertibleOps,
+            options.sdfgLoopUnrollFactor)
             .failed()) {
       return StreamStringError("Extraction of SDFG operations from Concrete "
                                "representation failed");
@@ -661,7 +1057,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   // bufferize and related passes
   if (mlir::concretelang::pipeline::lowerToStd(mlirContext, module, enablePass,
-                                               loopParallelize)
+                                               loopParallelize,
+                                               options.destinationPassing)
           .failed()) {
     return StreamStringError("Failed to lower to std");
   }
@@ -675,18 +1072,37 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
             .failed()) {
       return StreamStringError("Computing memory usage failed");
     }
+    for (auto &circuitFeedback : res.feedback->circuitFeedbacks)
+      circuitFeedback.allocatedMemoryWithoutBufferReuse =
+          circuitFeedback.allocatedMemory;
+  }
+
+  if (options.reuseBuffers) {
+    if (mlir::concretelang::pipeline::reuseBuffers(mlirContext, module,
+                                                   enablePass)
+            .failed()) {
+      return StreamStringError("Reusing buffers failed");
+    }
+    if (res.feedback &&
+        mlir::concretelang::pipeline::computeBufferUsage(
+            mlirContext, module, this->enablePass, res.feedback.value())
+            .failed()) {
+      return StreamStringError("Computing buffer usage failed");
+    }
   }
 
   // Restrict direct lowering when already generating GPU code through
   // the SDFG dialect.
   bool lowerDirectlyToGPUOps = (options.emitGPUOps && !options.emitSDFGOps);
   if (mlir::concretelang::pipeline::lowerToCAPI(mlirContext, module, enablePass,
-                                                lowerDirectlyToGPUOps)
+                                                lowerDirectlyToGPUOps,
+                                                options.asyncOffload)
           .failed()) {
     return StreamStringError("Failed to lower to CAPI");
   }
 
-  // MLIR canonical dialects -> LLVM Dialect
+  // MLIR canonical dialects -> LLVM Dialect, buffers being allocated through
+  // the runtime so that they can be pinned or pooled
   if (mlir::concretelang::pipeline::lowerStdToLLVMDialect(mlirContext, module,
                                                           enablePass)
           .failed()) {
@@ -699,8 +1115,11 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   // Lowering to actual LLVM IR (i.e., not the LLVM dialect)
   llvm::LLVMContext &llvmContext = *this->compilationContext->getLLVMContext();
 
-  res.llvmModule = mlir::concretelang::pipeline::lowerLLVMDialectToLLVMIR(
-      mlirContext, llvmContext, module);
+  {
+    ProfiledStage stage("LLVMDialectToLLVMIR");
+    res.llvmModule = mlir::concretelang::pipeline::lowerLLVMDialectToLLVMIR(
+        mlirContext, llvmContext, module);
+  }
 
   if (!res.llvmModule)
     return StreamStringError("Failed to convert from LLVM dialect to LLVM IR");
@@ -708,10 +1127,21 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   if (target == Target::LLVM_IR)
     return std::move(res);
 
-  if (mlir::concretelang::pipeline::optimizeLLVMModule(llvmContext,
-                                                       *res.llvmModule)
-          .failed()) {
-    return StreamStringError("Failed to optimize LLVM IR");
+  if (!options.runtimeBitcode.empty()) {
+    ProfiledStage stage("LinkRuntimeBitcode");
+    if (auto err = mlir::concretelang::pipeline::linkRuntimeBitcode(
+            llvmContext, *res.llvmModule, options.runtimeBitcode)) {
+      return StreamStringError(llvm::toString(std::move(err)));
+    }
+  }
+
+  {
+    ProfiledStage stage("OptimizeLLVMIR");
+    if (mlir::concretelang::pipeline::optimizeLLVMModule(llvmContext,
+                                                         *res.llvmModule)
+            .failed()) {
+      return StreamStringError("Failed to optimize LLVM IR");
+    }
   }
 
   if (target == Target::OPTIMIZED_LLVM_IR)
@@ -722,9 +1152,17 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
       return StreamStringError(
           "Internal Error: Please provide a library parameter");
     }
-    auto objPath = lib.value()->setCompilationResult(res);
-    if (!objPath) {
-      return StreamStringError(llvm::toString(objPath.takeError()));
+    CodegenOptions codegen;
+    codegen.threads = options.codegenThreads;
+    if (codegen.threads == 0)
+      codegen.threads = std::max(1u, std::thread::hardware_concurrency());
+    codegen.cpu = options.targetCpu;
+    codegen.cpuVariants = options.targetCpuVariants;
+    codegen.cacheDir = options.objectCacheDir;
+    codegen.symbolSuffix = symbolSuffix;
+    auto objPaths = lib.value()->setCompilationResult(res, codegen);
+    if (!objPaths) {
+      return StreamStringError(llvm::toString(objPaths.takeError()));
     }
     return std::move(res);
   }
@@ -763,6 +1201,18 @@ CompilerEngine::compile(std::vector<std::string> inputs,
   using Library = mlir::concretelang::CompilerEngine::Library;
   auto outputLib = std::make_shared<Library>(outputDirPath, runtimeLibraryPath);
   auto target = CompilerEngine::Target::LIBRARY;
+
+  const std::string &cacheDir = this->compilerOptions.compilationCacheDir;
+  std::optional<std::string> cacheKey;
+  if (!cacheDir.empty()) {
+    cacheKey = getCompilationCacheKey(inputs, runtimeLibraryPath);
+    if (cacheKey.has_value() &&
+        loadCachedArtifacts(cacheDir, *cacheKey, *outputLib, generateSharedLib,
+                            generateStaticLib, generateClientParameters,
+                            generateCompilationFeedback))
+      return *outputLib.get();
+  }
+
   for (auto input : inputs) {
     auto compilation = compile(input, target, outputLib);
     if (!compilation) {
@@ -775,9 +1225,29 @@ CompilerEngine::compile(std::vector<std::string> inputs,
     return StreamStringError("Can't emit artifacts: ")
            << llvm::toString(std::move(err));
   }
+  if (cacheKey.has_value())
+    storeCachedArtifacts(cacheDir, *cacheKey, *outputLib);
   return *outputLib.get();
 }
 
+/// Returns the text of the sources of `sm`, keying the compilation cache
+static std::vector<std::string> getCacheSources(llvm::SourceMgr &sm) {
+  std::vector<std::string> sources;
+  for (unsigned int i = 1; i <= sm.getNumBuffers(); i++)
+    sources.push_back(sm.getMemoryBuffer(i)->getBuffer().str());
+  return sources;
+}
+
+/// Returns the generic form of `module` with its locations, keying the
+/// compilation cache
+static std::vector<std::string> getCacheSources(mlir::ModuleOp module) {
+  std::string source;
+  llvm::raw_string_ostream os(source);
+  module->print(
+      os, mlir::OpPrintingFlags().printGenericOpForm().enableDebugInfo());
+  return {os.str()};
+}
+
 template <typename T>
 llvm::Expected<CompilerEngine::Library>
 compileModuleOrSource(CompilerEngine *engine, T module,
@@ -789,6 +1259,20 @@ compileModuleOrSource(CompilerEngine *engine, T module,
   auto outputLib = std::make_shared<Library>(outputDirPath, runtimeLibraryPath);
   auto target = CompilerEngine::Target::LIBRARY;
 
+  // The cache is looked up before any lowering
+  const std::string &cacheDir =
+      engine->getCompilationOptions().compilationCacheDir;
+  std::optional<std::string> cacheKey;
+  if (!cacheDir.empty()) {
+    cacheKey = engine->getCompilationCacheKey(getCacheSources(module),
+                                              runtimeLibraryPath);
+    if (cacheKey.has_value() &&
+        loadCachedArtifacts(cacheDir, *cacheKey, *outputLib, generateSharedLib,
+                            generateStaticLib, generateClientParameters,
+                            generateCompilationFeedback))
+      return *outputLib.get();
+  }
+
   auto compilation = engine->compile(module, target, outputLib);
   if (!compilation) {
     return compilation.takeError();
@@ -800,6 +1284,8 @@ compileModuleOrSource(CompilerEngine *engine, T module,
     return StreamStringError("Can't emit artifacts: ")
            << llvm::toString(std::move(err));
   }
+  if (cacheKey.has_value())
+    storeCachedArtifacts(cacheDir, *cacheKey, *outputLib);
   return *outputLib.get();
 }
 
@@ -823,6 +1309,24 @@ CompilerEngine::compile(mlir::ModuleOp module, std::string outputDirPath,
       generateStaticLib, generateClientParameters, generateCompilationFeedback);
 }
 
+llvm::Expected<CompilerEngine::JITProgram>
+CompilerEngine::compileJIT(llvm::SourceMgr &sm,
+                           std::string runtimeLibraryPath) {
+  auto compilation = compile(sm, Target::OPTIMIZED_LLVM_IR);
+  if (!compilation) {
+    return compilation.takeError();
+  }
+  if (!compilation->programInfo.has_value()) {
+    return StreamStringError(
+        "Cannot compile in memory without generating the program info");
+  }
+  auto module = JITModule::create(*compilation->llvmModule, runtimeLibraryPath);
+  if (!module) {
+    return module.takeError();
+  }
+  return JITProgram{std::move(*compilation->programInfo), *module};
+}
+
 const std::string CompilerEngine::Library::OBJECT_EXT = ".o";
 const std::string CompilerEngine::Library::LINKER = "ld";
 #ifdef __APPLE__
@@ -890,6 +1394,20 @@ std::string CompilerEngine::Library::getCompilationFeedbackPath() const {
   return ::getCompilationFeedbackPath(getOutputDirPath());
 };
 
+/// Returns the path of the compilation profile
+std::string CompilerEngine::Library::getCompilationProfilePath() const {
+  return ::getCompilationProfilePath(getOutputDirPath());
+};
+
+void CompilerEngine::Library::enableCompilationProfile() {
+  if (!compilationProfile.has_value())
+    compilationProfile.emplace();
+}
+
+CompilationProfile *CompilerEngine::Library::getCompilationProfile() {
+  return compilationProfile.has_value() ? &*compilationProfile : nullptr;
+}
+
 llvm::Expected<std::string> CompilerEngine::Library::emitProgramInfoJSON() {
   auto programInfoPath = ::getProgramInfoPath(outputDirPath);
   std::error_code error;
@@ -922,6 +1440,23 @@ CompilerEngine::Library::emitCompilationFeedbackJSON() {
   return path;
 }
 
+llvm::Expected<std::string>
+CompilerEngine::Library::emitCompilationProfileJSON() {
+  auto path = ::getCompilationProfilePath(outputDirPath);
+  llvm::json::Value value(*compilationProfile);
+  std::error_code error;
+  llvm::raw_fd_ostream out(path, error);
+
+  if (error) {
+    return StreamStringError("cannot emit compilation profile, error: ")
+           << error.message();
+  }
+  out << llvm::formatv("{0:2}", value);
+  out.close();
+
+  return path;
+}
+
 CompilationOptions currentCompilationOptions;
 
 void setCurrentCompilationOptions(CompilationOptions options) {
@@ -937,8 +1472,9 @@ void printTluFusing(mlir::Value v1, mlir::Value v2, mlir::Value v1v2) {
                << "`\n";
 }
 
-llvm::Expected<std::string>
-CompilerEngine::Library::setCompilationResult(CompilationResult &compilation) {
+llvm::Expected<std::vector<std::string>>
+CompilerEngine::Library::setCompilationResult(CompilationResult &compilation,
+                                              const CodegenOptions &codegen) {
   llvm::Module *module = compilation.llvmModule.get();
   auto sourceName = module->getSourceFileName();
   if (sourceName == "" || sourceName == "LLVMDialectModule") {
@@ -946,18 +1482,25 @@ CompilerEngine::Library::setCompilationResult(CompilationResult &compilation) {
                  std::to_string(objectsPath.size()) + ".mlir";
   }
   auto objectPath = sourceName + OBJECT_EXT;
-  if (auto error = mlir::concretelang::emitObject(*module, objectPath)) {
-    return std::move(error);
+  std::optional<ProfiledStage> stage;
+  stage.emplace("Codegen");
+  auto objectPaths =
+      mlir::concretelang::emitObjects(*module, objectPath, codegen);
+  stage.reset();
+  if (!objectPaths) {
+    return objectPaths.takeError();
   }
 
-  addExtraObjectFilePath(objectPath);
+  for (auto &path : *objectPaths) {
+    addExtraObjectFilePath(path);
+  }
   if (compilation.programInfo) {
     programInfo = *compilation.programInfo;
   }
   if (compilation.feedback.has_value()) {
     compilationFeedback = compilation.feedback.value();
   }
-  return objectPath;
+  return *objectPaths;
 }
 
 bool stringEndsWith(std::string path, std::string requiredExt) {
@@ -1075,12 +1618,15 @@ llvm::Error CompilerEngine::Library::emitArtifacts(bool sharedLib,
                                                    bool compilationFeedback) {
   // Create output directory if doesn't exist
   llvm::sys::fs::create_directory(outputDirPath);
+  CompilationProfileScope profileScope(getCompilationProfile());
   if (sharedLib) {
+    ProfiledStage stage("LinkShared");
     if (auto err = emitShared().takeError()) {
       return err;
     }
   }
   if (staticLib) {
+    ProfiledStage stage("LinkStatic");
     if (auto err = emitStatic().takeError()) {
       return err;
     }
@@ -1095,6 +1641,11 @@ llvm::Error CompilerEngine::Library::emitArtifacts(bool sharedLib,
       return err;
     }
   }
+  if (compilationProfile.has_value()) {
+    if (auto err = emitCompilationProfileJSON().takeError()) {
+      return err;
+    }
+  }
   return llvm::Error::success();
 }
 
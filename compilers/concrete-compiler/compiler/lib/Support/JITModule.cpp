@@ -0,0 +1,95 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include "concretelang/Runtime/utils.h"
+#include "concretelang/Support/Error.h"
+#include "concretelang/Support/JITModule.h"
+#include "concretelang/Support/LLVMEmitFile.h"
+
+namespace mlir {
+namespace concretelang {
+
+JITModule::~JITModule() {
+  if (jit != nullptr)
+    llvm::consumeError(jit->deinitialize(jit->getMainJITDylib()));
+}
+
+llvm::Expected<std::shared_ptr<JITModule>>
+JITModule::create(const llvm::Module &module,
+                  const std::string &runtimeLibraryPath) {
+  mlir::concretelang::LLVMInitializeNativeTarget();
+
+  auto machineBuilder = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!machineBuilder)
+    return machineBuilder.takeError();
+  machineBuilder->setCodeGenOptLevel(llvm::CodeGenOpt::Level::Aggressive);
+  machineBuilder->setRelocationModel(llvm::Reloc::PIC_);
+  auto jit = llvm::orc::LLLazyJITBuilder()
+                 .setJITTargetMachineBuilder(std::move(*machineBuilder))
+                 .create();
+  if (!jit)
+    return jit.takeError();
+
+  // The symbols of the runtime library and of the process, such as those of
+  // the runtime already loaded by the python bindings, are called as is
+  auto &mainDylib = (*jit)->getMainJITDylib();
+  char globalPrefix = (*jit)->getDataLayout().getGlobalPrefix();
+  if (!runtimeLibraryPath.empty()) {
+    auto runtimeLibrary = llvm::orc::DynamicLibrarySearchGenerator::Load(
+        runtimeLibraryPath.c_str(), globalPrefix);
+    if (!runtimeLibrary)
+      return runtimeLibrary.takeError();
+    mainDylib.addGenerator(std::move(*runtimeLibrary));
+  }
+  auto process =
+      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+          globalPrefix);
+  if (!process)
+    return process.takeError();
+  mainDylib.addGenerator(std::move(*process));
+
+  // The module is copied in a context owned by the JIT, the functions being
+  // compiled lazily from any thread calling the circuits
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(module, os);
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto copy = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()),
+                            module.getModuleIdentifier()),
+      *context);
+  if (!copy)
+    return copy.takeError();
+  (*copy)->setDataLayout((*jit)->getDataLayout());
+  (*copy)->setTargetTriple((*jit)->getTargetTriple().str());
+  packFunctionArguments(copy->get());
+  if (auto err = (*jit)->addLazyIRModule(llvm::orc::ThreadSafeModule(
+          std::move(*copy), std::move(context))))
+    return std::move(err);
+  if (auto err = (*jit)->initialize(mainDylib))
+    return std::move(err);
+
+  auto jitModule = std::shared_ptr<JITModule>(new JITModule());
+  jitModule->jit = std::move(*jit);
+  return jitModule;
+}
+
+Result<void *> JITModule::lookup(const std::string &name) {
+  auto address = jit->lookup(name);
+  if (!address) {
+    return StringError(llvm::toString(address.takeError()));
+  }
+  return address->toPtr<void *>();
+}
+
+} // namespace concretelang
+} // namespace mlir
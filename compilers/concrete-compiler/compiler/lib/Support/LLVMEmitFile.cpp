@@ -6,17 +6,27 @@
 #include <errno.h>
 
 #include "llvm/MC/SubtargetFeature.h"
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/CodeGen/ParallelCG.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/ThreadPool.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/TargetParser/Host.h>
+#include <llvm/TargetParser/Triple.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 
 #include <mlir/Support/FileUtilities.h>
 
+#include <concretelang/Support/CompilationCache.h>
 #include <concretelang/Support/Error.h>
+#include <concretelang/Support/LLVMEmitFile.h>
 #include <concretelang/Support/Utils.h>
 
 namespace mlir {
@@ -25,9 +35,9 @@ namespace concretelang {
 using std::string;
 using std::vector;
 
-// Get target machine from current machine and setup LLVM module accordingly
-std::unique_ptr<llvm::TargetMachine>
-getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
+// Get target machine for `cpu`, or for the cpu and the features of the
+// current machine for "host"
+std::unique_ptr<llvm::TargetMachine> getTargetMachine(llvm::StringRef cpu) {
   // Setup the machine properties from the current architecture.
   auto targetTriple = llvm::sys::getDefaultTargetTriple();
   std::string errorMessage;
@@ -38,13 +48,14 @@ getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
     return nullptr;
   }
 
-  std::string cpu(llvm::sys::getHostCPUName());
   llvm::SubtargetFeatures features;
-  llvm::StringMap<bool> hostFeatures;
-
-  if (llvm::sys::getHostCPUFeatures(hostFeatures))
-    for (auto &f : hostFeatures)
-      features.AddFeature(f.first(), f.second);
+  if (cpu == "host") {
+    cpu = llvm::sys::getHostCPUName();
+    llvm::StringMap<bool> hostFeatures;
+    if (llvm::sys::getHostCPUFeatures(hostFeatures))
+      for (auto &f : hostFeatures)
+        features.AddFeature(f.first(), f.second);
+  }
 
   std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(
       targetTriple, cpu, features.getString(), {}, llvm::Reloc::PIC_));
@@ -52,6 +63,18 @@ getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
     llvm::errs() << "Unable to create target machine\n";
     return nullptr;
   }
+  machine->setOptLevel(llvm::CodeGenOpt::Level::Aggressive);
+  return machine;
+}
+
+// Get target machine for `cpu` and setup LLVM module accordingly
+std::unique_ptr<llvm::TargetMachine>
+getTargetMachineAndSetupModule(llvm::Module *llvmModule, llvm::StringRef cpu) {
+  auto machine = getTargetMachine(cpu);
+  if (!machine) {
+    return nullptr;
+  }
+  auto targetTriple = llvm::sys::getDefaultTargetTriple();
   llvmModule->setDataLayout(machine->createDataLayout());
   llvmModule->setTargetTriple(targetTriple);
   return machine;
@@ -62,9 +85,17 @@ getTargetMachineAndSetupModule(llvm::Module *llvmModule) {
 // For each function in the LLVM module, define an interface function that wraps
 // all the arguments of the original function and all its results into an i8**
 // pointer to provide a unified invocation interface.
-static void packFunctionArguments(llvm::Module *module) {
+void packFunctionArguments(llvm::Module *module,
+                           llvm::StringRef symbolSuffix) {
   auto &ctx = module->getContext();
   llvm::IRBuilder<> builder(ctx);
+  if (!symbolSuffix.empty()) {
+    for (auto &global : module->globals()) {
+      if (!global.isDeclaration() && !global.hasLocalLinkage()) {
+        global.setName(global.getName() + symbolSuffix);
+      }
+    }
+  }
   llvm::DenseSet<llvm::Function *> interfaceFunctions;
   for (auto &func : module->getFunctionList()) {
     if (func.isDeclaration()) {
@@ -74,8 +105,10 @@ static void packFunctionArguments(llvm::Module *module) {
       continue;
     }
 
-    // prefix to avoid colliding with other functions
-    func.setName(::concretelang::prefixFuncName(func.getName()));
+    // prefix to avoid colliding with other functions, suffix to avoid
+    // colliding with the other execution variants of the function
+    func.setName(::concretelang::prefixFuncName(func.getName()) +
+                 symbolSuffix.str());
 
     // Given a function `foo(<...>)`, define the interface function
     // `mlir_foo(i8**)`.
@@ -129,31 +162,34 @@ static void packFunctionArguments(llvm::Module *module) {
   }
 }
 
-llvm::Error emitObject(llvm::Module &module, string objectPath) {
-  auto targetMachine = getTargetMachineAndSetupModule(&module);
+// Returns `path` with `suffix` inserted before its extension
+static string addPathSuffix(string path, string suffix) {
+  llvm::SmallString<0> result(path);
+  llvm::sys::path::replace_extension(result,
+                                     suffix + llvm::sys::path::extension(path));
+  return result.str().str();
+}
+
+// Emits the object of `module` for `cpu` to `objectPath`
+static llvm::Error emitObject(llvm::Module &module, string objectPath,
+                              string cpu) {
+  auto targetMachine = getTargetMachine(cpu);
   if (!targetMachine) {
-    return StreamStringError("No default target machine for object generation");
+    return StreamStringError("No target machine for object generation");
   }
-
   string Error;
-  std::unique_ptr<llvm::ToolOutputFile> objectFile =
-      mlir::openOutputFile(objectPath, &Error);
+  auto objectFile = mlir::openOutputFile(objectPath, &Error);
   if (!objectFile) {
     return StreamStringError("Cannot create/open " + objectPath);
   }
 
-  packFunctionArguments(&module);
-
   // The legacy PassManager is mandatory for final code generation.
   // https://llvm.org/docs/NewPassManager.html#status-of-the-new-and-legacy-pass-managers
   llvm::legacy::PassManager pm;
-  auto FileType = llvm::CGFT_ObjectFile;
-  targetMachine->setOptLevel(llvm::CodeGenOpt::Level::Aggressive);
   if (targetMachine->addPassesToEmitFile(pm, objectFile->os(), nullptr,
-                                         FileType, false)) {
+                                         llvm::CGFT_ObjectFile, false)) {
     return StreamStringError("TheTargetMachine can't emit object file");
   }
-
   pm.run(module);
 
   objectFile->os().flush();
@@ -162,6 +198,334 @@ llvm::Error emitObject(llvm::Module &module, string objectPath) {
   return llvm::Error::success();
 }
 
+// Erases the local symbols of `module` which are not used anymore
+static void eraseDeadLocals(llvm::Module &module) {
+  bool erased = true;
+  while (erased) {
+    erased = false;
+    for (auto &func : llvm::make_early_inc_range(module.functions())) {
+      if (func.hasLocalLinkage() && func.use_empty()) {
+        func.eraseFromParent();
+        erased = true;
+      }
+    }
+    for (auto &global : llvm::make_early_inc_range(module.globals())) {
+      if (global.hasLocalLinkage() && global.use_empty()) {
+        global.eraseFromParent();
+        erased = true;
+      }
+    }
+  }
+}
+
+// Returns the name of the circuit of the exported symbol `value`, the
+// interface functions being in the circuit of the function they wrap
+static string getCircuitName(const llvm::GlobalValue &value) {
+  llvm::StringRef name = value.getName();
+  name.consume_front(::concretelang::makePackedFunctionName(""));
+  return name.str();
+}
+
+// Splits `module` in a module per circuit, holding the exported symbols of
+// the circuit and a copy of the local symbols they use, such that the
+// module of a circuit does not depend on the other circuits
+static vector<std::unique_ptr<llvm::Module>>
+splitCircuits(llvm::Module &module) {
+  std::map<string, llvm::SmallPtrSet<const llvm::GlobalValue *, 4>> circuits;
+  for (auto &value : module.global_values()) {
+    if (!value.isDeclaration() && !value.hasLocalLinkage()) {
+      circuits[getCircuitName(value)].insert(&value);
+    }
+  }
+
+  vector<std::unique_ptr<llvm::Module>> partitions;
+  for (auto &circuit : circuits) {
+    llvm::ValueToValueMapTy vmap;
+    std::unique_ptr<llvm::Module> partition = llvm::CloneModule(
+        module, vmap, [&](const llvm::GlobalValue *value) {
+          return value->hasLocalLinkage() || circuit.second.contains(value);
+        });
+    // The identifiers of the module are part of its IR, which keys its
+    // object, and must not depend on the output directory
+    partition->setModuleIdentifier(circuit.first);
+    partition->setSourceFileName(circuit.first);
+    eraseDeadLocals(*partition);
+    partitions.push_back(std::move(partition));
+  }
+  return partitions;
+}
+
+// Emits the objects of `module` for `cpu`, one per circuit, reusing the
+// objects of `cacheDir` generated from the same IR. The missing objects are
+// generated in parallel on at most `threads` threads.
+static llvm::Expected<vector<string>>
+emitCachedObjects(llvm::Module &module, string objectPath, string cpu,
+                  unsigned int threads, string cacheDir) {
+  vector<std::unique_ptr<llvm::Module>> partitions = splitCircuits(module);
+  if (partitions.empty()) {
+    if (auto error = emitObject(module, objectPath, cpu)) {
+      return std::move(error);
+    }
+    return vector<string>{objectPath};
+  }
+
+  vector<string> objectPaths;
+  vector<std::optional<string>> keys;
+  vector<size_t> missing;
+  for (size_t i = 0; i < partitions.size(); i++) {
+    objectPaths.push_back(addPathSuffix(objectPath, std::to_string(i)));
+    string ir;
+    llvm::raw_string_ostream os(ir);
+    partitions[i]->print(os, nullptr);
+    keys.push_back(getObjectCacheKey(os.str(), cpu));
+    if (!keys[i].has_value() ||
+        !loadCachedObject(cacheDir, *keys[i], objectPaths[i])) {
+      missing.push_back(i);
+    }
+  }
+
+  // Each missing object is generated from the bitcode of its module, parsed
+  // in its own context, like the partitions of `llvm::splitCodeGen`
+  vector<llvm::SmallString<0>> bitcodes(missing.size());
+  for (size_t j = 0; j < missing.size(); j++) {
+    llvm::raw_svector_ostream os(bitcodes[j]);
+    llvm::WriteBitcodeToFile(*partitions[missing[j]], os);
+  }
+  vector<string> errors(missing.size());
+  llvm::ThreadPool pool(llvm::hardware_concurrency(threads));
+  for (size_t j = 0; j < missing.size(); j++) {
+    pool.async([&, j]() {
+      llvm::LLVMContext context;
+      auto partition = llvm::parseBitcodeFile(
+          llvm::MemoryBufferRef(bitcodes[j].str(), objectPaths[missing[j]]),
+          context);
+      if (!partition) {
+        errors[j] = llvm::toString(partition.takeError());
+        return;
+      }
+      if (auto error = emitObject(**partition, objectPaths[missing[j]], cpu)) {
+        errors[j] = llvm::toString(std::move(error));
+      }
+    });
+  }
+  pool.wait();
+
+  for (size_t j = 0; j < missing.size(); j++) {
+    if (!errors[j].empty()) {
+      return StreamStringError(errors[j]);
+    }
+    if (keys[missing[j]].has_value()) {
+      storeCachedObject(cacheDir, *keys[missing[j]], objectPaths[missing[j]]);
+    }
+  }
+  return objectPaths;
+}
+
+// Emits the objects of `module` for `cpu`, split in at most `threads`
+// partitions generated in parallel, or in a partition per circuit cached in
+// `cacheDir` when it is not empty
+static llvm::Expected<vector<string>>
+emitPartitionedObjects(llvm::Module &module, string objectPath, string cpu,
+                       unsigned int threads, string cacheDir) {
+  // The appending globals, such as the constructors, cannot be split between
+  // the objects of the circuits
+  if (!cacheDir.empty() &&
+      llvm::none_of(module.globals(), [](llvm::GlobalVariable &global) {
+        return global.hasAppendingLinkage();
+      })) {
+    return emitCachedObjects(module, objectPath, cpu, threads, cacheDir);
+  }
+
+  // Each partition holds at least a function
+  size_t definedFunctions = llvm::count_if(
+      module.functions(), [](llvm::Function &f) { return !f.isDeclaration(); });
+  size_t partitions = std::max<size_t>(
+      1, std::min<size_t>(threads, definedFunctions));
+
+  if (partitions == 1) {
+    if (auto error = emitObject(module, objectPath, cpu)) {
+      return std::move(error);
+    }
+    return vector<string>{objectPath};
+  }
+
+  if (!getTargetMachine(cpu)) {
+    return StreamStringError("No target machine for object generation");
+  }
+  vector<string> objectPaths;
+  for (size_t i = 0; i < partitions; i++) {
+    objectPaths.push_back(addPathSuffix(objectPath, std::to_string(i)));
+  }
+
+  vector<std::unique_ptr<llvm::ToolOutputFile>> objectFiles;
+  for (auto &path : objectPaths) {
+    string Error;
+    objectFiles.push_back(mlir::openOutputFile(path, &Error));
+    if (!objectFiles.back()) {
+      return StreamStringError("Cannot create/open " + path);
+    }
+  }
+
+  // Each partition is cloned in its own context and generated by its own
+  // target machine. The local symbols stay in the partition of their users,
+  // such that they are not promoted to symbols which could clash with the
+  // ones of the other objects of the library.
+  vector<llvm::raw_pwrite_stream *> streams;
+  for (auto &objectFile : objectFiles) {
+    streams.push_back(&objectFile->os());
+  }
+  llvm::splitCodeGen(
+      module, streams, {}, [&]() { return getTargetMachine(cpu); },
+      llvm::CGFT_ObjectFile, /*PreserveLocals=*/true);
+
+  for (auto &objectFile : objectFiles) {
+    objectFile->os().flush();
+    objectFile->os().close();
+    objectFile->keep();
+  }
+  return objectPaths;
+}
+
+// The x86-64 microarchitecture levels, in the order of the values returned
+// by `concrete_x86_64_level`
+static const char *X86_64_LEVELS[] = {"x86-64", "x86-64-v2", "x86-64-v3",
+                                      "x86-64-v4"};
+
+// Emits a variant of `module` per x86-64 level of `cpuVariants`, with its
+// exported symbols suffixed by the level, and turns `module` into the
+// dispatcher of the exported functions to the variant of the highest level
+// supported by the cpu running them.
+static llvm::Expected<vector<string>>
+emitMultiversionedObjects(llvm::Module &module, string objectPath,
+                          vector<string> cpuVariants, unsigned int threads,
+                          string cacheDir) {
+  if (llvm::Triple(module.getTargetTriple()).getArch() !=
+      llvm::Triple::x86_64) {
+    return StreamStringError(
+        "Target cpu variants are only supported on x86-64");
+  }
+  vector<uint64_t> levels;
+  for (auto &variant : cpuVariants) {
+    auto level = llvm::find(X86_64_LEVELS, variant);
+    if (level == std::end(X86_64_LEVELS)) {
+      return StreamStringError("Unknown target cpu variant " + variant +
+                               ", expected an x86-64 level");
+    }
+    levels.push_back(level - std::begin(X86_64_LEVELS));
+  }
+  llvm::sort(levels, std::greater<uint64_t>());
+  levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+
+  auto isExported = [](llvm::GlobalValue &value) {
+    return !value.isDeclaration() && !value.hasLocalLinkage();
+  };
+
+  vector<string> objectPaths;
+  for (uint64_t level : levels) {
+    string cpu = X86_64_LEVELS[level];
+    std::unique_ptr<llvm::Module> variant = llvm::CloneModule(module);
+    for (auto &func : variant->functions()) {
+      if (isExported(func)) {
+        func.setName(func.getName() + "." + cpu);
+      }
+    }
+    for (auto &global : variant->globals()) {
+      if (isExported(global)) {
+        global.setLinkage(llvm::GlobalValue::InternalLinkage);
+      }
+    }
+    auto paths = emitPartitionedObjects(
+        *variant, addPathSuffix(objectPath, cpu), cpu, threads, cacheDir);
+    if (!paths) {
+      return paths.takeError();
+    }
+    objectPaths.insert(objectPaths.end(), paths->begin(), paths->end());
+  }
+
+  // The dispatchers forward their arguments to the first variant whose level
+  // is supported, the last one being the fallback
+  auto &ctx = module.getContext();
+  llvm::IRBuilder<> builder(ctx);
+  llvm::FunctionCallee levelFunc = module.getOrInsertFunction(
+      "concrete_x86_64_level", builder.getInt64Ty());
+  vector<llvm::Function *> exported;
+  for (auto &func : module.functions()) {
+    if (isExported(func)) {
+      exported.push_back(&func);
+    }
+  }
+  for (llvm::Function *func : exported) {
+    llvm::GlobalValue::LinkageTypes linkage = func->getLinkage();
+    func->deleteBody();
+    func->setLinkage(linkage);
+    llvm::SmallVector<llvm::Value *, 8> args;
+    for (auto &arg : func->args()) {
+      args.push_back(&arg);
+    }
+
+    auto *bb = llvm::BasicBlock::Create(ctx, "entry", func);
+    builder.SetInsertPoint(bb);
+    llvm::Value *hostLevel = builder.CreateCall(levelFunc);
+    for (size_t i = 0; i < levels.size(); i++) {
+      if (i + 1 < levels.size()) {
+        auto *call = llvm::BasicBlock::Create(ctx, "", func);
+        auto *next = llvm::BasicBlock::Create(ctx, "", func);
+        builder.CreateCondBr(
+            builder.CreateICmpUGE(hostLevel, builder.getInt64(levels[i])),
+            call, next);
+        builder.SetInsertPoint(call);
+        bb = next;
+      }
+      llvm::FunctionCallee variantFunc = module.getOrInsertFunction(
+          (func->getName() + "." + X86_64_LEVELS[levels[i]]).str(),
+          func->getFunctionType());
+      llvm::CallInst *result = builder.CreateCall(variantFunc, args);
+      result->setCallingConv(func->getCallingConv());
+      if (func->getReturnType()->isVoidTy()) {
+        builder.CreateRetVoid();
+      } else {
+        builder.CreateRet(result);
+      }
+      builder.SetInsertPoint(bb);
+    }
+  }
+
+  // The local symbols only used by the exported functions are now dead
+  eraseDeadLocals(module);
+
+  auto paths = emitPartitionedObjects(module, objectPath,
+                                      X86_64_LEVELS[levels.back()],
+                                      /*threads=*/1, cacheDir);
+  if (!paths) {
+    return paths.takeError();
+  }
+  objectPaths.insert(objectPaths.end(), paths->begin(), paths->end());
+  return objectPaths;
+}
+
+llvm::Expected<vector<string>> emitObjects(llvm::Module &module,
+                                           string objectPath,
+                                           const CodegenOptions &options) {
+  string cpu = options.cpuVariants.empty() ? options.cpu : "x86-64";
+  auto targetMachine = getTargetMachineAndSetupModule(&module, cpu);
+  if (!targetMachine) {
+    return StreamStringError("No default target machine for object generation");
+  }
+  if (cpu != "host" &&
+      !targetMachine->getMCSubtargetInfo()->isCPUStringValid(cpu)) {
+    return StreamStringError("Unknown target cpu " + cpu);
+  }
+
+  packFunctionArguments(&module, options.symbolSuffix);
+
+  if (!options.cpuVariants.empty()) {
+    return emitMultiversionedObjects(module, objectPath, options.cpuVariants,
+                                     options.threads, options.cacheDir);
+  }
+  return emitPartitionedObjects(module, objectPath, cpu, options.threads,
+                                options.cacheDir);
+}
+
 string linkerCmd(vector<string> objectsPath, string libraryPath, string linker,
                  std::optional<vector<string>> extraArgs) {
   string cmd = linker + libraryPath;
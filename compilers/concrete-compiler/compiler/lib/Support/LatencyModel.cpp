@@ -0,0 +1,53 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include <fstream>
+
+#include "concretelang/Support/LatencyModel.h"
+#include "llvm/Support/JSON.h"
+
+namespace mlir {
+namespace concretelang {
+
+outcome::checked<PrimitiveCostTable, StringError>
+PrimitiveCostTable::load(std::string path, std::string device) {
+  std::ifstream file(path);
+  std::string content((std::istreambuf_iterator<char>(file)),
+                      (std::istreambuf_iterator<char>()));
+  if (file.fail()) {
+    return StringError("Cannot read file: ") << path;
+  }
+  auto json = llvm::json::parse(content);
+  if (auto err = json.takeError()) {
+    return StringError("Cannot parse the primitive cost table: ")
+           << llvm::toString(std::move(err));
+  }
+  auto *devices = json->getAsObject();
+  if (devices == nullptr) {
+    return StringError("The primitive cost table is not an object: ") << path;
+  }
+  auto *costs = devices->getObject(device);
+  if (costs == nullptr) {
+    return StringError("No costs for the device ")
+           << device << " in the primitive cost table: " << path;
+  }
+
+  PrimitiveCostTable table;
+  if (auto parallelism = costs->getInteger("parallelism")) {
+    if (*parallelism <= 0) {
+      return StringError("The parallelism of the device ")
+             << device << " must be positive";
+    }
+    table.parallelism = *parallelism;
+  }
+  table.bootstrap = costs->getNumber("bootstrap");
+  table.keyswitch = costs->getNumber("keyswitch");
+  table.wopPbs = costs->getNumber("wop_pbs");
+  table.leveled = costs->getNumber("leveled");
+  return table;
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -3,10 +3,16 @@
 // https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
 // for license information.
 
+#include "llvm/ADT/StringSet.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Transforms/IPO/Internalize.h"
 
 #include "concrete-optimizer.hpp"
 #include "concretelang/Support/CompilationFeedback.h"
+#include "concretelang/Support/CompilationProfile.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "mlir/Conversion/BufferizationToMemRef/BufferizationToMemRef.h"
 #include "mlir/Conversion/Passes.h"
@@ -45,11 +51,18 @@
 #include "concretelang/Dialect/FHE/Transforms/EncryptedMulToDoubleTLU/EncryptedMulToDoubleTLU.h"
 #include "concretelang/Dialect/FHE/Transforms/Max/Max.h"
 #include "concretelang/Dialect/FHE/Transforms/Optimizer/Optimizer.h"
+#include "concretelang/Dialect/FHE/Transforms/SplitReductions/SplitReductions.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/EncryptedMatMulToSharedTLU.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/FuseLookupTableChains.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/NarrowLookupTableInputs.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/RoundWithLookupTables.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/SpecializeConstantMatMul.h"
 #include "concretelang/Dialect/FHELinalg/Transforms/Tiling.h"
 #include "concretelang/Dialect/RT/Analysis/Autopar.h"
 #include "concretelang/Dialect/RT/Transforms/Passes.h"
 #include "concretelang/Dialect/SDFG/Transforms/Passes.h"
 #include "concretelang/Dialect/TFHE/Analysis/ExtractStatistics.h"
+#include "concretelang/Dialect/TFHE/Analysis/PredictLatency.h"
 #include "concretelang/Dialect/TFHE/Transforms/Transforms.h"
 #include "concretelang/Runtime/utils.h"
 #include "concretelang/Support/CompilerEngine.h"
@@ -65,6 +78,7 @@ namespace pipeline {
 
 static void pipelinePrinting(llvm::StringRef name, mlir::PassManager &pm,
                              mlir::MLIRContext &ctx) {
+  profilePipeline(name, pm);
   if (mlir::concretelang::isVerbose()) {
     mlir::concretelang::log_verbose()
         << "##################################################\n"
@@ -191,12 +205,20 @@ mlir::LogicalResult materializeOptimizerPartitionFrontiers(
 }
 
 mlir::LogicalResult autopar(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                            std::function<bool(mlir::Pass *)> enablePass) {
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            int64_t minTaskWork, int64_t unrollFactor) {
   mlir::PassManager pm(&context);
   pipelinePrinting("AutoPar", pm, context);
 
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createBuildDataflowTaskGraphPass(), enablePass);
+      pm,
+      mlir::concretelang::createBuildDataflowTaskGraphPass(false,
+                                                           unrollFactor),
+      enablePass);
+  if (minTaskWork > 0)
+    addPotentiallyNestedPass(
+        pm, mlir::concretelang::createCoarsenDataflowTasksPass(minTaskWork),
+        enablePass);
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createLowerDataflowTasksPass(), enablePass);
   addPotentiallyNestedPass(pm, mlir::concretelang::createHoistAwaitFuturePass(),
@@ -232,6 +254,74 @@ markFHELinalgForTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+markFHELinalgForAutoTiling(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                           AutoTilingParameters parameters,
+                           std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("MarkFHELinalgForAutoTiling", pm, context);
+  addPotentiallyNestedPass(
+      pm, createFHELinalgAutoTilingMarkerPass(parameters), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+shareEncryptedMatMulTLUs(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                         std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("ShareEncryptedMatMulTLUs", pm, context);
+  addPotentiallyNestedPass(pm, createEncryptedMatMulToSharedTLUPass(),
+                           enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+specializeConstantMatMul(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                         std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("SpecializeConstantMatMul", pm, context);
+  addPotentiallyNestedPass(pm, createSpecializeConstantMatMulPass(),
+                           enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+fuseLookupTableChains(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass,
+                      std::map<std::string, uint64_t> &counts) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("FuseLookupTableChains", pm, context);
+  addPotentiallyNestedPass(pm, createFuseLookupTableChainsPass(&counts),
+                           enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+narrowLookupTableInputs(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                        std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("NarrowLookupTableInputs", pm, context);
+  addPotentiallyNestedPass(pm, createNarrowLookupTableInputsPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+roundWithLookupTables(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass,
+                      unsigned maxPrecision) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("RoundWithLookupTables", pm, context);
+  addPotentiallyNestedPass(pm, createRoundWithLookupTablesPass(maxPrecision),
+                           enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
                          std::function<bool(mlir::Pass *)> enablePass) {
@@ -247,13 +337,22 @@ transformHighLevelFHEOps(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerFHELinalgToLinalg(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                       std::function<bool(mlir::Pass *)> enablePass) {
+                       std::function<bool(mlir::Pass *)> enablePass,
+                       bool treeReduction, bool im2colConv2d,
+                       bool maxpool2dTree) {
   mlir::PassManager pm(&context);
   pipelinePrinting("FHELinalgToLinalg", pm, context);
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertFHETensorOpsToLinalg(), enablePass);
+      pm,
+      mlir::concretelang::createConvertFHETensorOpsToLinalg(
+          treeReduction, im2colConv2d, maxpool2dTree),
+      enablePass);
   addPotentiallyNestedPass(pm, mlir::createLinalgGeneralizationPass(),
                            enablePass);
+  // Transpositions and broadcasts read by other linalg operations are not
+  // materialized
+  addPotentiallyNestedPass(pm, mlir::concretelang::createFuseLinalgCopiesPass(),
+                           enablePass);
   return pm.run(module.getOperation());
 }
 
@@ -270,13 +369,25 @@ lowerLinalgToLoops(mlir::MLIRContext &context, mlir::ModuleOp &module,
           parallelizeLoops),
       enablePass);
 
+  // Split the encrypted accumulations of the reduction loops into partial
+  // sums computed in parallel, before their bufferization
+  if (parallelizeLoops)
+    addPotentiallyNestedPass(
+        pm, mlir::concretelang::createFHESplitReductionsPass(), enablePass);
+
   return pm.run(module.getOperation());
 }
 
 mlir::LogicalResult
 transformFHEBoolean(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass) {
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    bool fuseGates, unsigned int fusionMaxInputs) {
   mlir::PassManager pm(&context);
+  if (fuseGates) {
+    addPotentiallyNestedPass(
+        pm, mlir::concretelang::createFHEBooleanGateFusionPass(fusionMaxInputs),
+        enablePass);
+  }
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createFHEBooleanTransformPass(), enablePass);
   return pm.run(module.getOperation());
@@ -285,11 +396,13 @@ transformFHEBoolean(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult
 transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
                    std::function<bool(mlir::Pass *)> enablePass,
-                   unsigned int chunkSize, unsigned int chunkWidth) {
+                   unsigned int chunkSize, unsigned int chunkWidth,
+                   bool carryLookahead) {
   mlir::PassManager pm(&context);
   addPotentiallyNestedPass(
       pm,
-      mlir::concretelang::createFHEBigIntTransformPass(chunkSize, chunkWidth),
+      mlir::concretelang::createFHEBigIntTransformPass(chunkSize, chunkWidth,
+                                                       carryLookahead),
       enablePass);
   // We want to fully unroll for loops introduced by the BigInt transform since
   // MANP doesn't support loops. This is a workaround that make the IR much
@@ -302,7 +415,8 @@ transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult
 lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                std::optional<V0FHEContext> &fheContext,
-               std::function<bool(mlir::Pass *)> enablePass) {
+               std::function<bool(mlir::Pass *)> enablePass,
+               bool batchCrtBlocks) {
   if (!fheContext)
     return mlir::success();
 
@@ -315,7 +429,8 @@ lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
     addPotentiallyNestedPass(
         pm,
         mlir::concretelang::createConvertFHEToTFHECrtPass(
-            mlir::concretelang::CrtLoweringParameters(mods)),
+            mlir::concretelang::CrtLoweringParameters(mods,
+                                                      batchCrtBlocks)),
         enablePass);
   } else {
     pipelinePrinting("FHEToTFHEScalar", pm, context);
@@ -323,7 +438,8 @@ lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
     addPotentiallyNestedPass(
         pm,
         mlir::concretelang::createConvertFHEToTFHEScalarPass(
-            mlir::concretelang::ScalarLoweringParameters(polySize)),
+            mlir::concretelang::ScalarLoweringParameters(
+                polySize, getPbsKsLookupTablesFromSolution(solution))),
         enablePass);
   }
 
@@ -363,6 +479,10 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
         enablePass);
   }
 
+  // The parametrization sets the size of the encoded lookup tables, which
+  // can then be encoded once, or folded if constant
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createTFHELutEncodingHoistingPass(), enablePass);
   addPotentiallyNestedPass(pm, mlir::createCanonicalizerPass(), enablePass);
 
   return pm.run(module.getOperation());
@@ -371,14 +491,15 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult batchTFHE(mlir::MLIRContext &context,
                               mlir::ModuleOp &module,
                               std::function<bool(mlir::Pass *)> enablePass,
-                              int64_t maxBatchSize) {
+                              int64_t maxBatchSize, bool batchWopPBS) {
   mlir::PassManager pm(&context);
   pipelinePrinting("BatchTFHE", pm, context);
 
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createCollapseParallelLoops(), enablePass);
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createBatchingPass(maxBatchSize), enablePass);
+      pm, mlir::concretelang::createBatchingPass(maxBatchSize, batchWopPBS),
+      enablePass);
   addPotentiallyNestedPass(pm, mlir::createCanonicalizerPass(), enablePass);
 
   return pm.run(module.getOperation());
@@ -410,6 +531,20 @@ extractTFHEStatistics(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+predictTFHELatency(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                   std::function<bool(mlir::Pass *)> enablePass,
+                   ProgramCompilationFeedback &feedback, LatencyModel model) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("TFHELatencyPrediction", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createLatencyPredictionPass(feedback, model),
+      enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 lowerTFHEToConcrete(mlir::MLIRContext &context, mlir::ModuleOp &module,
                     std::function<bool(mlir::Pass *)> enablePass) {
@@ -431,6 +566,33 @@ computeMemoryUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createMemoryUsagePass(feedback), enablePass);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createBufferUsagePass(feedback), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult reuseBuffers(mlir::MLIRContext &context,
+                                 mlir::ModuleOp &module,
+                                 std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("Reusing Buffers", pm, context);
+
+  addPotentiallyNestedPass(pm, mlir::concretelang::createBufferReusePass(),
+                           enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+computeBufferUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                   std::function<bool(mlir::Pass *)> enablePass,
+                   ProgramCompilationFeedback &feedback) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("Computing Buffer Usage", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createBufferUsagePass(feedback), enablePass);
 
   return pm.run(module.getOperation());
 }
@@ -446,6 +608,19 @@ mlir::LogicalResult optimizeTFHE(mlir::MLIRContext &context,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+deduplicateTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                std::function<bool(mlir::Pass *)> enablePass,
+                std::map<std::string, TFHEDeduplicationCounts> &counts) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("TFHEDeduplication", pm, context);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createTFHEDeduplicationPass(&counts), enablePass);
+  addPotentiallyNestedPass(pm, mlir::createCanonicalizerPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 transformTFHEOperations(mlir::MLIRContext &context, mlir::ModuleOp &module,
                         std::function<bool(mlir::Pass *)> enablePass) {
@@ -461,10 +636,21 @@ transformTFHEOperations(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult simulateTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::optional<V0FHEContext> &fheContext,
-                                 bool enableOverflowDetection,
+                                 bool enableOverflowDetection, bool enableNoise,
+                                 double pError,
                                  std::function<bool(mlir::Pass *)> enablePass) {
   mlir::PassManager pm(&context);
 
+  // the precision of the messages is only known for a single set of
+  // parameters, without CRT, where all of them are encoded with the same one
+  uint32_t precision = 0;
+  if (fheContext) {
+    auto solution = fheContext.value().solution;
+    if (std::holds_alternative<V0Parameter>(solution) &&
+        !getCrtDecompositionFromSolution(solution))
+      precision = fheContext.value().constraint.p;
+  }
+
   // we want to disable overflow detection if CRT is used (overflow would be
   // expected)
   if (fheContext && enableOverflowDetection) {
@@ -478,7 +664,9 @@ mlir::LogicalResult simulateTFHE(mlir::MLIRContext &context,
 
   pipelinePrinting("TFHESimulation", pm, context);
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createSimulateTFHEPass(enableOverflowDetection),
+      pm,
+      mlir::concretelang::createSimulateTFHEPass(
+          enableOverflowDetection, precision, pError, enableNoise),
       enablePass);
 
   return pm.run(module.getOperation());
@@ -487,11 +675,12 @@ mlir::LogicalResult simulateTFHE(mlir::MLIRContext &context,
 mlir::LogicalResult extractSDFGOps(mlir::MLIRContext &context,
                                    mlir::ModuleOp &module,
                                    std::function<bool(mlir::Pass *)> enablePass,
-                                   bool unroll) {
+                                   bool unroll, unsigned unrollFactor) {
   mlir::PassManager pm(&context);
   pipelinePrinting("extract SDFG ops from Concrete", pm, context);
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createExtractSDFGOpsPass(unroll), enablePass);
+      pm, mlir::concretelang::createExtractSDFGOpsPass(unroll, unrollFactor),
+      enablePass);
   LogicalResult res = pm.run(module.getOperation());
 
   return res;
@@ -521,7 +710,7 @@ lowerSDFGToStd(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
                                mlir::ModuleOp &module,
                                std::function<bool(mlir::Pass *)> enablePass,
-                               bool parallelizeLoops) {
+                               bool parallelizeLoops, bool destinationPassing) {
   mlir::PassManager pm(&context);
   pipelinePrinting("Lowering to Std", pm, context);
 
@@ -546,12 +735,24 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
       };
   bufferizationOptions.bufferizeFunctionBoundaries = true;
   bufferizationOptions.createDeallocs = false;
+  // Destination buffers are dense, so are the results they receive.
+  if (destinationPassing)
+    bufferizationOptions.setFunctionBoundaryTypeConversion(
+        mlir::bufferization::LayoutMapOption::IdentityLayoutMap);
 
   std::unique_ptr<mlir::Pass> comprBuffPass =
       mlir::bufferization::createOneShotBufferizePass(bufferizationOptions);
 
   addPotentiallyNestedPass(pm, std::move(comprBuffPass), enablePass);
 
+  // Turn the memref results into out parameters appended after the runtime
+  // context, the buffers allocated for the results become temporaries freed
+  // by the buffer deallocation below.
+  if (destinationPassing)
+    addPotentiallyNestedPass(
+        pm, mlir::bufferization::createBufferResultsToOutParamsPass(),
+        enablePass);
+
   // The bufferization may create `linalg.map` operations; Add another
   // conversion pass from linalg to loops
   addPotentiallyNestedPass(pm, mlir::createConvertLinalgToLoopsPass(),
@@ -567,9 +768,12 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
                              enablePass);
   }
 
-  if (parallelizeLoops)
+  if (parallelizeLoops) {
     addPotentiallyNestedPass(pm, mlir::createConvertSCFToOpenMPPass(),
                              enablePass);
+    addPotentiallyNestedPass(
+        pm, mlir::concretelang::createOpenMPSchedulePass(), enablePass);
+  }
   // Lower affine
   addPotentiallyNestedPass(pm, mlir::createLowerAffinePass(), enablePass);
 
@@ -597,12 +801,14 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
 mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
                                 mlir::ModuleOp &module,
                                 std::function<bool(mlir::Pass *)> enablePass,
-                                bool gpu) {
+                                bool gpu, bool asyncOffload) {
   mlir::PassManager pm(&context);
   pipelinePrinting("Lowering to CAPI", pm, context);
 
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertConcreteToCAPIPass(gpu), enablePass);
+      pm,
+      mlir::concretelang::createConvertConcreteToCAPIPass(gpu, asyncOffload),
+      enablePass);
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createConvertTracingToCAPIPass(), enablePass);
 
@@ -618,8 +824,12 @@ lowerStdToLLVMDialect(mlir::MLIRContext &context, mlir::ModuleOp &module,
   // Convert to MLIR LLVM Dialect
   addPotentiallyNestedPass(pm, mlir::arith::createArithExpandOpsPass(),
                            enablePass);
+  // The heap allocations of all the circuits go through the runtime, which
+  // may serve them from the pinned or host memory pools
   addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertMLIRLowerableDialectsToLLVMPass(),
+      pm,
+      mlir::concretelang::createConvertMLIRLowerableDialectsToLLVMPass(
+          /*checkedAllocations=*/true),
       enablePass);
   addPotentiallyNestedPass(pm, mlir::createReconcileUnrealizedCastsPass(),
                            enablePass);
@@ -651,6 +861,42 @@ mlir::LogicalResult optimizeLLVMModule(llvm::LLVMContext &llvmContext,
     return mlir::success();
 }
 
+llvm::Error linkRuntimeBitcode(llvm::LLVMContext &llvmContext,
+                               llvm::Module &module, llvm::StringRef path) {
+  llvm::SMDiagnostic diagnostic;
+  std::unique_ptr<llvm::Module> runtime =
+      llvm::parseIRFile(path, diagnostic, llvmContext);
+  if (!runtime) {
+    return StreamStringError("Cannot load the runtime bitcode ")
+           << path << ": " << diagnostic.getMessage();
+  }
+
+  // The functions are compiled for the generic target of the runtime, they
+  // take the target of the circuits to be inlined and vectorized for it
+  runtime->setTargetTriple(module.getTargetTriple());
+  runtime->setDataLayout(module.getDataLayout());
+  for (llvm::Function &function : *runtime) {
+    function.removeFnAttr("target-cpu");
+    function.removeFnAttr("target-features");
+    function.removeFnAttr("tune-cpu");
+  }
+
+  // Only the functions called by the circuits are linked, and internalized
+  // such that they are dropped once inlined
+  bool failed = llvm::Linker::linkModules(
+      module, std::move(runtime), llvm::Linker::Flags::LinkOnlyNeeded,
+      [](llvm::Module &linkedModule, const llvm::StringSet<> &linked) {
+        llvm::internalizeModule(
+            linkedModule, [&](const llvm::GlobalValue &value) {
+              return !value.hasName() || !linked.contains(value.getName());
+            });
+      });
+  if (failed) {
+    return StreamStringError("Cannot link the runtime bitcode ") << path;
+  }
+  return llvm::Error::success();
+}
+
 } // namespace pipeline
 } // namespace concretelang
 } // namespace mlir
@@ -4,13 +4,16 @@
 // for license information.
 
 #include <cassert>
+#include <cmath>
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <unordered_set>
 #include <variant>
 
 #include "capnp/message.h"
+#include "concrete-cpu-noise-model.h"
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Protocol.h"
 #include "concretelang/Common/Security.h"
@@ -28,8 +31,10 @@
 #include "concretelang/Support/Variants.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -44,31 +49,31 @@ namespace concretelang {
 const auto keyFormat = ::concretelang::security::BINARY;
 typedef double Variance;
 
-llvm::Expected<Message<concreteprotocol::GateInfo>>
+/// Generates the info of a gate of type `inputType` in `output`.
+llvm::Error
 generateGate(mlir::Type inputType,
-             const Message<concreteprotocol::EncodingInfo> &inputEncodingInfo,
+             concreteprotocol::EncodingInfo::Reader inputEncodingInfo,
              ::concretelang::security::SecurityCurve curve,
-             concreteprotocol::Compression compression) {
+             concreteprotocol::Compression compression,
+             concreteprotocol::GateInfo::Builder output) {
 
-  auto inputEncoding = inputEncodingInfo.asReader().getEncoding();
+  auto inputEncoding = inputEncodingInfo.getEncoding();
   if (!inputEncoding.hasIntegerCiphertext() &&
       !inputEncoding.hasBooleanCiphertext() && !inputEncoding.hasIndex() &&
       !inputEncoding.hasPlaintext()) {
     return StreamStringError("Tried to generate gate info without encoding.");
   }
-  auto inputShape = inputEncodingInfo.asReader().getShape();
+  auto inputShape = inputEncodingInfo.getShape();
   if (auto inputTensorType = inputType.dyn_cast<mlir::RankedTensorType>()) {
     inputType = inputTensorType.getElementType();
   }
-  auto output = Message<concreteprotocol::GateInfo>();
-
   if (inputEncoding.hasIntegerCiphertext()) {
     auto normKey = inputType.cast<TFHE::GLWECipherTextType>()
                        .getKey()
                        .getNormalized()
                        .value();
     auto lweCiphertextGateInfo =
-        output.asBuilder().initTypeInfo().initLweCiphertext();
+        output.initTypeInfo().initLweCiphertext();
     auto concreteShape = lweCiphertextGateInfo.initConcreteShape();
     lweCiphertextGateInfo.setAbstractShape(inputShape);
     auto encodingDimensions = inputShape.getDimensions();
@@ -110,7 +115,7 @@ generateGate(mlir::Type inputType,
     lweCiphertextGateInfo.setCompression(compression);
     lweCiphertextGateInfo.initEncoding().setInteger(
         inputEncoding.getIntegerCiphertext());
-    auto rawInfo = output.asBuilder().initRawInfo();
+    auto rawInfo = output.initRawInfo();
     auto rawShape = rawInfo.initShape();
     rawShape.setDimensions(gateDimensions.asReader());
     rawInfo.setIntegerPrecision(64);
@@ -119,7 +124,7 @@ generateGate(mlir::Type inputType,
     auto glweType = inputType.cast<TFHE::GLWECipherTextType>();
     auto normKey = glweType.getKey().getNormalized().value();
     auto lweCiphertextGateInfo =
-        output.asBuilder().initTypeInfo().initLweCiphertext();
+        output.initTypeInfo().initLweCiphertext();
     auto encodingDimensions = inputShape.getDimensions();
     size_t gateDimensionsSize = inputShape.getDimensions().size() + 1;
     lweCiphertextGateInfo.setAbstractShape(inputShape);
@@ -143,20 +148,20 @@ generateGate(mlir::Type inputType,
     lweCiphertextGateInfo.setCompression(compression);
     lweCiphertextGateInfo.initEncoding().initBoolean();
 
-    auto rawInfo = output.asBuilder().initRawInfo();
+    auto rawInfo = output.initRawInfo();
     auto rawShape = rawInfo.initShape();
     rawShape.setDimensions(gateDimensions.asReader());
     rawInfo.setIntegerPrecision(64);
     rawInfo.setIsSigned(false);
   } else if (inputEncoding.hasPlaintext()) {
-    auto plaintextGateInfo = output.asBuilder().initTypeInfo().initPlaintext();
+    auto plaintextGateInfo = output.initTypeInfo().initPlaintext();
     plaintextGateInfo.setShape(inputShape);
     plaintextGateInfo.setIntegerPrecision(
         ::concretelang::values::getCorrespondingPrecision(
             inputType.getIntOrFloatBitWidth()));
     plaintextGateInfo.setIsSigned(inputType.isSignedInteger());
 
-    auto rawInfo = output.asBuilder().initRawInfo();
+    auto rawInfo = output.initRawInfo();
     rawInfo.setShape(inputShape);
     rawInfo.setIntegerPrecision(
         ::concretelang::values::getCorrespondingPrecision(
@@ -166,59 +171,55 @@ generateGate(mlir::Type inputType,
     // TODO - The index type is dependant of the target architecture,
     // so actually we assume we target only 64 bits, we need to have
     // some the size of the word of the target system.
-    auto indexGateInfo = output.asBuilder().initTypeInfo().initIndex();
+    auto indexGateInfo = output.initTypeInfo().initIndex();
     indexGateInfo.setShape(inputShape);
     indexGateInfo.setIntegerPrecision(64);
     indexGateInfo.setIsSigned(inputType.isSignedInteger());
 
-    auto rawInfo = output.asBuilder().initRawInfo();
+    auto rawInfo = output.initRawInfo();
     rawInfo.setShape(inputShape);
     rawInfo.setIntegerPrecision(64);
     rawInfo.setIsSigned(inputType.isSignedInteger());
   }
-  return output;
+  return llvm::Error::success();
 }
 
-Message<concreteprotocol::KeysetInfo>
-extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
-                  ::concretelang::security::SecurityCurve curve,
-                  bool compressEvaluationKeys) {
-
-  auto output = Message<concreteprotocol::KeysetInfo>();
+/// Generates the info of the keys of the circuits in `output`, the fourier
+/// bootstrap keys being stored by the server with `fourierPrecision` bits of
+/// mantissa (0 for the full precision).
+void extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
+                       ::concretelang::security::SecurityCurve curve,
+                       bool compressEvaluationKeys, uint32_t fourierPrecision,
+                       concreteprotocol::KeysetInfo::Builder output) {
 
   // Pushing secret keys
   auto secretKeysBuilder =
-      output.asBuilder().initLweSecretKeys(circuitKeys.secretKeys.size());
+      output.initLweSecretKeys(circuitKeys.secretKeys.size());
   for (size_t i = 0; i < circuitKeys.secretKeys.size(); i++) {
-    auto infoMessage = Message<concreteprotocol::LweSecretKeyInfo>();
+    auto info = secretKeysBuilder[i];
     auto sk = circuitKeys.secretKeys[i];
-    infoMessage.asBuilder().setId(sk.getNormalized()->index);
-    auto paramsBuilder = infoMessage.asBuilder().initParams();
+    info.setId(sk.getNormalized()->index);
+    auto paramsBuilder = info.initParams();
     paramsBuilder.setIntegerPrecision(64);
     paramsBuilder.setLweDimension(sk.getNormalized().value().dimension);
     paramsBuilder.setKeyType(concreteprotocol::KeyType::BINARY);
-    secretKeysBuilder.setWithCaveats(i, infoMessage.asReader());
   }
 
   // Pushing keyswitch keys
   auto keyswitchKeysBuilder =
-      output.asBuilder().initLweKeyswitchKeys(circuitKeys.keyswitchKeys.size());
+      output.initLweKeyswitchKeys(circuitKeys.keyswitchKeys.size());
   for (size_t i = 0; i < circuitKeys.keyswitchKeys.size(); i++) {
-    auto infoMessage = Message<concreteprotocol::LweKeyswitchKeyInfo>();
+    auto info = keyswitchKeysBuilder[i];
     auto ksk = circuitKeys.keyswitchKeys[i];
-    infoMessage.asBuilder().setId(ksk.getIndex());
-    infoMessage.asBuilder().setInputId(
-        ksk.getInputKey().getNormalized().value().index);
-    infoMessage.asBuilder().setOutputId(
-        ksk.getOutputKey().getNormalized().value().index);
+    info.setId(ksk.getIndex());
+    info.setInputId(ksk.getInputKey().getNormalized().value().index);
+    info.setOutputId(ksk.getOutputKey().getNormalized().value().index);
     if (!compressEvaluationKeys) {
-      infoMessage.asBuilder().setCompression(
-          concreteprotocol::Compression::NONE);
+      info.setCompression(concreteprotocol::Compression::NONE);
     } else {
-      infoMessage.asBuilder().setCompression(
-          concreteprotocol::Compression::SEED);
+      info.setCompression(concreteprotocol::Compression::SEED);
     }
-    auto paramsBuilder = infoMessage.asBuilder().initParams();
+    auto paramsBuilder = info.initParams();
     paramsBuilder.setLevelCount(ksk.getLevels());
     paramsBuilder.setBaseLog(ksk.getBaseLog());
     paramsBuilder.setVariance(curve.getVariance(
@@ -230,28 +231,23 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
         ksk.getOutputKey().getNormalized().value().dimension);
     paramsBuilder.setKeyType(concreteprotocol::KeyType::BINARY);
     paramsBuilder.initModulus().initMod().initNative();
-    keyswitchKeysBuilder.setWithCaveats(i, infoMessage.asReader());
   }
 
   // Pushing bootstrap keys
   auto bootstrapKeysBuilder =
-      output.asBuilder().initLweBootstrapKeys(circuitKeys.bootstrapKeys.size());
+      output.initLweBootstrapKeys(circuitKeys.bootstrapKeys.size());
   for (size_t i = 0; i < circuitKeys.bootstrapKeys.size(); i++) {
-    auto infoMessage = Message<concreteprotocol::LweBootstrapKeyInfo>();
+    auto info = bootstrapKeysBuilder[i];
     auto bsk = circuitKeys.bootstrapKeys[i];
-    infoMessage.asBuilder().setId(bsk.getIndex());
-    infoMessage.asBuilder().setInputId(
-        bsk.getInputKey().getNormalized().value().index);
-    infoMessage.asBuilder().setOutputId(
-        bsk.getOutputKey().getNormalized().value().index);
+    info.setId(bsk.getIndex());
+    info.setInputId(bsk.getInputKey().getNormalized().value().index);
+    info.setOutputId(bsk.getOutputKey().getNormalized().value().index);
     if (!compressEvaluationKeys) {
-      infoMessage.asBuilder().setCompression(
-          concreteprotocol::Compression::NONE);
+      info.setCompression(concreteprotocol::Compression::NONE);
     } else {
-      infoMessage.asBuilder().setCompression(
-          concreteprotocol::Compression::SEED);
+      info.setCompression(concreteprotocol::Compression::SEED);
     }
-    auto paramsBuilder = infoMessage.asBuilder().initParams();
+    auto paramsBuilder = info.initParams();
     paramsBuilder.setLevelCount(bsk.getLevels());
     paramsBuilder.setBaseLog(bsk.getBaseLog());
     paramsBuilder.setGlweDimension(bsk.getGlweDim());
@@ -263,29 +259,25 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
     paramsBuilder.setIntegerPrecision(64);
     paramsBuilder.setKeyType(concreteprotocol::KeyType::BINARY);
     paramsBuilder.initModulus().initMod().initNative();
-    bootstrapKeysBuilder.setWithCaveats(i, infoMessage.asReader());
+    paramsBuilder.setFourierPrecision(fourierPrecision);
+    paramsBuilder.setGroupingFactor(bsk.getGroupingFactor());
   }
 
   // Pushing circuit packing keyswitch keys
   auto packingKeyswitchKeysBuilder =
-      output.asBuilder().initPackingKeyswitchKeys(
-          circuitKeys.packingKeyswitchKeys.size());
+      output.initPackingKeyswitchKeys(circuitKeys.packingKeyswitchKeys.size());
   for (size_t i = 0; i < circuitKeys.packingKeyswitchKeys.size(); i++) {
-    auto infoMessage = Message<concreteprotocol::PackingKeyswitchKeyInfo>();
+    auto info = packingKeyswitchKeysBuilder[i];
     auto pksk = circuitKeys.packingKeyswitchKeys[i];
-    infoMessage.asBuilder().setId(pksk.getIndex());
-    infoMessage.asBuilder().setInputId(
-        pksk.getInputKey().getNormalized().value().index);
-    infoMessage.asBuilder().setOutputId(
-        pksk.getOutputKey().getNormalized().value().index);
+    info.setId(pksk.getIndex());
+    info.setInputId(pksk.getInputKey().getNormalized().value().index);
+    info.setOutputId(pksk.getOutputKey().getNormalized().value().index);
     if (!compressEvaluationKeys) {
-      infoMessage.asBuilder().setCompression(
-          concreteprotocol::Compression::NONE);
+      info.setCompression(concreteprotocol::Compression::NONE);
     } else {
-      infoMessage.asBuilder().setCompression(
-          concreteprotocol::Compression::SEED);
+      info.setCompression(concreteprotocol::Compression::SEED);
     }
-    auto paramsBuilder = infoMessage.asBuilder().initParams();
+    auto paramsBuilder = info.initParams();
     paramsBuilder.setLevelCount(pksk.getLevels());
     paramsBuilder.setBaseLog(pksk.getBaseLog());
     paramsBuilder.setGlweDimension(pksk.getGlweDim());
@@ -299,26 +291,58 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
     paramsBuilder.setIntegerPrecision(64);
     paramsBuilder.setKeyType(concreteprotocol::KeyType::BINARY);
     paramsBuilder.initModulus().initMod().initNative();
-    packingKeyswitchKeysBuilder.setWithCaveats(i, infoMessage.asReader());
   }
+}
 
-  return output;
+/// Generates the ids of the evaluation keys used by `funcOp`, and by the
+/// functions it calls, in `output`.
+void extractCircuitKeyIds(mlir::func::FuncOp funcOp,
+                          concreteprotocol::CircuitKeys::Builder output) {
+  llvm::SetVector<mlir::Operation *> funcs;
+  funcs.insert(funcOp);
+  for (size_t i = 0; i < funcs.size(); i++) {
+    funcs[i]->walk([&](mlir::CallOpInterface call) {
+      if (mlir::Operation *callee = call.resolveCallable())
+        funcs.insert(callee);
+    });
+  }
+
+  std::set<uint32_t> bootstrapKeys, keyswitchKeys, packingKeyswitchKeys;
+  for (mlir::Operation *func : funcs) {
+    auto keys = TFHE::extractCircuitKeys(func);
+    for (auto bsk : keys.bootstrapKeys)
+      bootstrapKeys.insert(bsk.getIndex());
+    for (auto ksk : keys.keyswitchKeys)
+      keyswitchKeys.insert(ksk.getIndex());
+    for (auto pksk : keys.packingKeyswitchKeys)
+      packingKeyswitchKeys.insert(pksk.getIndex());
+  }
+
+  auto fill = [](auto builder, const std::set<uint32_t> &ids) {
+    size_t i = 0;
+    for (uint32_t id : ids)
+      builder.set(i++, id);
+  };
+  fill(output.initLweBootstrapKeys(bootstrapKeys.size()), bootstrapKeys);
+  fill(output.initLweKeyswitchKeys(keyswitchKeys.size()), keyswitchKeys);
+  fill(output.initPackingKeyswitchKeys(packingKeyswitchKeys.size()),
+       packingKeyswitchKeys);
 }
 
-llvm::Expected<Message<concreteprotocol::CircuitInfo>>
+/// Generates the info of the circuit `funcOp` in `output`.
+llvm::Error
 extractCircuitInfo(mlir::func::FuncOp funcOp,
                    concreteprotocol::CircuitEncodingInfo::Reader encodings,
                    ::concretelang::security::SecurityCurve curve,
-                   bool compressInputCiphertexts) {
-
-  auto output = Message<concreteprotocol::CircuitInfo>();
+                   bool compressInputCiphertexts,
+                   concreteprotocol::CircuitInfo::Builder output) {
 
   // Create input and output circuit gate parameters
   auto funcType = funcOp.getFunctionType();
 
-  output.asBuilder().setName(encodings.getName().cStr());
-  output.asBuilder().initInputs(funcType.getNumInputs());
-  output.asBuilder().initOutputs(funcType.getNumResults());
+  output.setName(encodings.getName().cStr());
+  auto inputs = output.initInputs(funcType.getNumInputs());
+  auto outputs = output.initOutputs(funcType.getNumResults());
 
   for (unsigned int i = 0; i < funcType.getNumInputs(); i++) {
     auto ty = funcType.getInput(i);
@@ -326,39 +350,32 @@ extractCircuitInfo(mlir::func::FuncOp funcOp,
     auto compression = compressInputCiphertexts
                            ? concreteprotocol::Compression::SEED
                            : concreteprotocol::Compression::NONE;
-    auto maybeGate =
-        generateGate(ty, (Message<concreteprotocol::EncodingInfo>)encoding,
-                     curve, compression);
-    if (!maybeGate) {
-      return maybeGate.takeError();
-    }
-    output.asBuilder().getInputs().setWithCaveats(i, maybeGate->asReader());
+    if (auto err = generateGate(ty, encoding, curve, compression, inputs[i]))
+      return err;
   }
   for (unsigned int i = 0; i < funcType.getNumResults(); i++) {
     auto ty = funcType.getResult(i);
     auto encoding = encodings.getOutputs()[i];
     auto compression = concreteprotocol::Compression::NONE;
-    auto maybeGate =
-        generateGate(ty, (Message<concreteprotocol::EncodingInfo>)encoding,
-                     curve, compression);
-    if (!maybeGate) {
-      return maybeGate.takeError();
-    }
-    output.asBuilder().getOutputs().setWithCaveats(i, maybeGate->asReader());
+    if (auto err = generateGate(ty, encoding, curve, compression, outputs[i]))
+      return err;
   }
 
-  return output;
+  extractCircuitKeyIds(funcOp, output.initKeys());
+
+  return llvm::Error::success();
 }
 
-llvm::Expected<Message<concreteprotocol::ProgramInfo>> extractProgramInfo(
+/// Generates the info of the circuits of `module` in `output`.
+llvm::Error extractProgramInfo(
     mlir::ModuleOp module,
     const Message<concreteprotocol::ProgramEncodingInfo> &encodings,
     ::concretelang::security::SecurityCurve curve,
-    bool compressInputCiphertexts) {
+    bool compressInputCiphertexts,
+    concreteprotocol::ProgramInfo::Builder output) {
 
-  auto output = Message<concreteprotocol::ProgramInfo>();
   auto circuitsCount = encodings.asReader().getCircuits().size();
-  auto circuitsBuilder = output.asBuilder().initCircuits(circuitsCount);
+  auto circuitsBuilder = output.initCircuits(circuitsCount);
   auto rangeOps = module.getOps<mlir::func::FuncOp>();
 
   for (size_t i = 0; i < circuitsCount; i++) {
@@ -373,23 +390,200 @@ llvm::Expected<Message<concreteprotocol::ProgramInfo>> extractProgramInfo(
              << functionName.cStr();
     }
 
-    auto maybeCircuitInfo = extractCircuitInfo(*funcOp, circuitEncoding, curve,
-                                               compressInputCiphertexts);
-    if (!maybeCircuitInfo) {
-      return maybeCircuitInfo.takeError();
+    if (auto err = extractCircuitInfo(*funcOp, circuitEncoding, curve,
+                                      compressInputCiphertexts,
+                                      circuitsBuilder[i]))
+      return err;
+  }
+
+  return llvm::Error::success();
+}
+
+/// Returns the base 2 logarithm of the noise which makes the decryption of the
+/// ciphertexts of `lweCiphertext` fail, on the torus, i.e. half the step of
+/// their encoding, which keeps a padding bit.
+int getLog2NoiseBound(
+    concreteprotocol::LweCiphertextTypeInfo::Reader lweCiphertext) {
+  if (lweCiphertext.getEncoding().hasBoolean())
+    return -4;
+  auto integer = lweCiphertext.getEncoding().getInteger();
+  auto mode = integer.getMode();
+  if (mode.hasCrt()) {
+    uint32_t maxModulus = 0;
+    for (auto modulus : mode.getCrt().getModuli())
+      maxModulus = std::max(maxModulus, modulus);
+    return -(int)std::ceil(std::log2(maxModulus)) - 2;
+  }
+  auto width = mode.hasChunked() ? mode.getChunked().getWidth()
+                                 : integer.getWidth();
+  return -(int)width - 2;
+}
+
+/// Returns the ratio of the noise bound of the decryption to the standard
+/// deviation of a gaussian noise exceeding it with probability `pError`.
+double getNoiseBoundToStdDevRatio(double pError) {
+  // The ratio r solves erfc(r / sqrt(2)) = pError, erfc being decreasing
+  double low = 0, high = 64;
+  for (int i = 0; i < 100; i++) {
+    double middle = (low + high) / 2;
+    if (std::erfc(middle / std::sqrt(2.)) > pError)
+      low = middle;
+    else
+      high = middle;
+  }
+  return high;
+}
+
+/// The decomposition of a glwe packing keyswitch key, with the variance of the
+/// noise added by a packing keyswitch.
+struct PackingDecomposition {
+  uint32_t levelCount;
+  uint32_t baseLog;
+  double variance;
+};
+
+/// Returns the decomposition with the fewest levels of a glwe packing
+/// keyswitch key of `inputLweDimension` and of noise `keyVariance`, which adds
+/// less noise than `maxVariance` to the packed ciphertexts, or none if there is
+/// none.
+std::optional<PackingDecomposition>
+findPackingDecomposition(uint64_t inputLweDimension, double keyVariance,
+                         double maxVariance) {
+  for (uint32_t levelCount = 1; levelCount <= 64; levelCount++) {
+    std::optional<PackingDecomposition> best;
+    for (uint32_t baseLog = 1; baseLog * levelCount <= 64; baseLog++) {
+      double variance = concrete_cpu_variance_keyswitch(
+          inputLweDimension, baseLog, levelCount, 64, keyVariance);
+      if (!best.has_value() || variance < best->variance)
+        best = PackingDecomposition{levelCount, baseLog, variance};
+    }
+    if (best.has_value() && best->variance <= maxVariance)
+      return best;
+  }
+  return std::nullopt;
+}
+
+/// Compresses the ciphertext outputs of the circuits of `programInfo` by
+/// packing them in glwe ciphertexts. Only the ciphertexts encrypted under the
+/// output key of a bootstrap key can be packed, with the glwe parameters of
+/// this bootstrap key. The packed ciphertexts are encrypted under a secret key
+/// of their own, added to the keyset, so that no key encrypts itself.
+///
+/// The packing noise is not known to the optimizer, which bounds the noise of
+/// the outputs for an error probability `pError`. The decomposition of each
+/// packing key is thus chosen so that the variance of its noise stays below a
+/// thousandth of the variance allowed by this bound, for all the outputs it
+/// packs, which barely changes their error probability. The outputs which
+/// cannot be packed within their bound are left unpacked.
+void packOutputCiphertexts(Message<concreteprotocol::ProgramInfo> &programInfo,
+                           ::concretelang::security::SecurityCurve curve,
+                           double pError) {
+  auto keyset = programInfo.asReader().getKeyset();
+  // The tightest noise bound of the outputs of each lwe secret key
+  std::map<uint32_t, int> log2NoiseBounds;
+  for (auto circuit : programInfo.asReader().getCircuits()) {
+    for (auto gate : circuit.getOutputs()) {
+      if (!gate.getTypeInfo().hasLweCiphertext())
+        continue;
+      auto lweCiphertext = gate.getTypeInfo().getLweCiphertext();
+      auto keyId = lweCiphertext.getEncryption().getKeyId();
+      auto bound = getLog2NoiseBound(lweCiphertext);
+      if (!log2NoiseBounds.count(keyId) || bound < log2NoiseBounds[keyId])
+        log2NoiseBounds[keyId] = bound;
+    }
+  }
+  double boundToStdDev = getNoiseBoundToStdDevRatio(pError);
+
+  // The packing keys of the lwe secret keys which can be packed, and the
+  // secret keys of their packed ciphertexts
+  std::map<uint32_t, uint32_t> packingKeyIds;
+  std::vector<Message<concreteprotocol::GlwePackingKeyswitchKeyInfo>> keys;
+  std::vector<Message<concreteprotocol::LweSecretKeyInfo>> secretKeys;
+  for (auto secretKey : keyset.getLweSecretKeys())
+    secretKeys.push_back(secretKey);
+  for (auto [lweKeyId, log2NoiseBound] : log2NoiseBounds) {
+    std::optional<concreteprotocol::LweBootstrapKeyParams::Reader> bskParams;
+    for (auto bsk : keyset.getLweBootstrapKeys()) {
+      if (bsk.getOutputId() == lweKeyId)
+        bskParams = bsk.getParams();
     }
+    if (!bskParams.has_value())
+      continue;
+    auto glweDimension = bskParams->getGlweDimension();
+    auto polynomialSize = bskParams->getPolynomialSize();
+    auto lweDimension = glweDimension * polynomialSize;
+    auto keyVariance = curve.getVariance(glweDimension, polynomialSize, 64);
+    auto maxStdDev = std::exp2(log2NoiseBound) / boundToStdDev;
+    auto decomposition = findPackingDecomposition(lweDimension, keyVariance,
+                                                  maxStdDev * maxStdDev / 1000);
+    if (!decomposition.has_value())
+      continue;
+
+    auto secretKeyMessage = Message<concreteprotocol::LweSecretKeyInfo>();
+    secretKeyMessage.asBuilder().setId(secretKeys.size());
+    auto secretKeyParams = secretKeyMessage.asBuilder().initParams();
+    secretKeyParams.setLweDimension(lweDimension);
+    secretKeyParams.setIntegerPrecision(64);
+    secretKeyParams.setKeyType(concreteprotocol::KeyType::BINARY);
+
+    auto infoMessage = Message<concreteprotocol::GlwePackingKeyswitchKeyInfo>();
+    infoMessage.asBuilder().setId(keys.size());
+    infoMessage.asBuilder().setInputId(lweKeyId);
+    infoMessage.asBuilder().setOutputId(secretKeys.size());
+    infoMessage.asBuilder().setCompression(concreteprotocol::Compression::NONE);
+    auto paramsBuilder = infoMessage.asBuilder().initParams();
+    paramsBuilder.setLevelCount(decomposition->levelCount);
+    paramsBuilder.setBaseLog(decomposition->baseLog);
+    paramsBuilder.setGlweDimension(glweDimension);
+    paramsBuilder.setPolynomialSize(polynomialSize);
+    paramsBuilder.setInputLweDimension(lweDimension);
+    paramsBuilder.setVariance(keyVariance);
+    paramsBuilder.setIntegerPrecision(64);
+    paramsBuilder.setKeyType(concreteprotocol::KeyType::BINARY);
+    paramsBuilder.initModulus().initMod().initNative();
 
-    circuitsBuilder.setWithCaveats(i, (*maybeCircuitInfo).asReader());
+    packingKeyIds[lweKeyId] = keys.size();
+    keys.push_back(std::move(infoMessage));
+    secretKeys.push_back(std::move(secretKeyMessage));
   }
 
-  return output;
+  for (auto circuit : programInfo.asBuilder().getCircuits()) {
+    for (auto gate : circuit.getOutputs()) {
+      if (!gate.getTypeInfo().hasLweCiphertext())
+        continue;
+      auto lweCiphertext = gate.getTypeInfo().getLweCiphertext();
+      auto packingKeyId =
+          packingKeyIds.find(lweCiphertext.getEncryption().getKeyId());
+      if (packingKeyId == packingKeyIds.end())
+        continue;
+      auto key = keys[packingKeyId->second].asReader();
+      lweCiphertext.setCompression(
+          concreteprotocol::Compression::GLWE_PACKING);
+      auto packing = lweCiphertext.initPacking();
+      packing.setKeyId(key.getId());
+      packing.setGlweDimension(key.getParams().getGlweDimension());
+      packing.setPolynomialSize(key.getParams().getPolynomialSize());
+      packing.setSecretKeyId(key.getOutputId());
+    }
+  }
+
+  auto keysetBuilder = programInfo.asBuilder().getKeyset();
+  auto secretKeysBuilder = keysetBuilder.initLweSecretKeys(secretKeys.size());
+  for (size_t i = 0; i < secretKeys.size(); i++) {
+    secretKeysBuilder.setWithCaveats(i, secretKeys[i].asReader());
+  }
+  auto keysBuilder = keysetBuilder.initGlwePackingKeyswitchKeys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    keysBuilder.setWithCaveats(i, keys[i].asReader());
+  }
 }
 
 llvm::Expected<Message<concreteprotocol::ProgramInfo>>
 createProgramInfoFromTfheDialect(
     mlir::ModuleOp module, int bitsOfSecurity,
     const Message<concreteprotocol::ProgramEncodingInfo> &encodings,
-    bool compressEvaluationKeys, bool compressInputCiphertexts) {
+    bool compressEvaluationKeys, bool compressInputCiphertexts,
+    bool compressOutputCiphertexts, double pError, uint32_t fourierPrecision) {
 
   // Check that security curves exist
   const auto curve =
@@ -399,20 +593,24 @@ createProgramInfoFromTfheDialect(
            << bitsOfSecurity << "bits";
   }
 
-  // We generate the circuit infos from the module.
-  auto maybeProgramInfo =
-      extractProgramInfo(module, encodings, *curve, compressInputCiphertexts);
-  if (!maybeProgramInfo) {
-    return maybeProgramInfo.takeError();
-  }
+  // The infos are generated in place in the output message, which is moved
+  // to the caller instead of being copied from intermediate messages.
+  auto output = Message<concreteprotocol::ProgramInfo>();
 
-  // Extract the output Program Info.
-  Message<concreteprotocol::ProgramInfo> output = *maybeProgramInfo;
+  // We generate the circuit infos from the module.
+  if (auto err = extractProgramInfo(module, encodings, *curve,
+                                    compressInputCiphertexts,
+                                    output.asBuilder()))
+    return std::move(err);
 
   // We extract the keys of the circuit
-  auto keysetInfo = extractKeysetInfo(TFHE::extractCircuitKeys(module), *curve,
-                                      compressEvaluationKeys);
-  output.asBuilder().setKeyset(keysetInfo.asReader());
+  extractKeysetInfo(TFHE::extractCircuitKeys(module), *curve,
+                    compressEvaluationKeys, fourierPrecision,
+                    output.asBuilder().initKeyset());
+
+  if (compressOutputCiphertexts) {
+    packOutputCiphertexts(output, *curve, pError);
+  }
 
   return output;
 }
@@ -67,7 +67,7 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &OS,
   return OS;
 }
 
-TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
+TFHECircuitKeys extractCircuitKeys(mlir::Operation *root) {
   // Gathering circuit secret keys
   SmallSet<TFHE::GLWESecretKey> secretKeys;
   auto tryInsert = [&](mlir::Type type) {
@@ -80,7 +80,7 @@ TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
       }
     }
   };
-  moduleOp->walk([&](mlir::Operation *op) {
+  root->walk([&](mlir::Operation *op) {
     for (auto operand : op->getOperands()) {
       tryInsert(operand.getType());
     }
@@ -88,7 +88,7 @@ TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
       tryInsert(result.getType());
     }
   });
-  moduleOp->walk([&](mlir::func::FuncOp op) {
+  root->walk([&](mlir::func::FuncOp op) {
     for (auto argType : op.getArgumentTypes()) {
       tryInsert(argType);
     }
@@ -99,13 +99,13 @@ TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
 
   // Gathering circuit keyswitch keys
   SmallSet<TFHE::GLWEKeyswitchKeyAttr> keyswitchKeys;
-  moduleOp->walk([&](TFHE::KeySwitchGLWEOp op) {
+  root->walk([&](TFHE::KeySwitchGLWEOp op) {
     keyswitchKeys.insert(op.getKeyAttr());
     secretKeys.insert(op.getKeyAttr().getInputKey());
     secretKeys.insert(op.getKeyAttr().getOutputKey());
   });
 
-  moduleOp->walk([&](TFHE::BatchedKeySwitchGLWEOp op) {
+  root->walk([&](TFHE::BatchedKeySwitchGLWEOp op) {
     keyswitchKeys.insert(op.getKeyAttr());
     secretKeys.insert(op.getKeyAttr().getInputKey());
     secretKeys.insert(op.getKeyAttr().getOutputKey());
@@ -113,7 +113,13 @@ TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
 
   // Gathering circuit bootstrap keys
   SmallSet<TFHE::GLWEBootstrapKeyAttr> bootstrapKeys;
-  moduleOp->walk([&](TFHE::BootstrapGLWEOp op) {
+  root->walk([&](TFHE::BootstrapGLWEOp op) {
+    bootstrapKeys.insert(op.getKeyAttr());
+    secretKeys.insert(op.getKeyAttr().getInputKey());
+    secretKeys.insert(op.getKeyAttr().getOutputKey());
+  });
+
+  root->walk([&](TFHE::ManyLutBootstrapGLWEOp op) {
     bootstrapKeys.insert(op.getKeyAttr());
     secretKeys.insert(op.getKeyAttr().getInputKey());
     secretKeys.insert(op.getKeyAttr().getOutputKey());
@@ -121,7 +127,19 @@ TFHECircuitKeys extractCircuitKeys(mlir::ModuleOp moduleOp) {
 
   // Gathering circuit packing keyswitch keys
   SmallSet<TFHE::GLWEPackingKeyswitchKeyAttr> packingKeyswitchKeys;
-  moduleOp->walk([&](TFHE::WopPBSGLWEOp op) {
+  root->walk([&](TFHE::WopPBSGLWEOp op) {
+    keyswitchKeys.insert(op.getKskAttr());
+    secretKeys.insert(op.getKskAttr().getInputKey());
+    secretKeys.insert(op.getKskAttr().getOutputKey());
+    bootstrapKeys.insert(op.getBskAttr());
+    secretKeys.insert(op.getBskAttr().getInputKey());
+    secretKeys.insert(op.getBskAttr().getOutputKey());
+    packingKeyswitchKeys.insert(op.getPkskAttr());
+    secretKeys.insert(op.getPkskAttr().getInputKey());
+    secretKeys.insert(op.getPkskAttr().getOutputKey());
+  });
+
+  root->walk([&](TFHE::BatchedWopPBSGLWEOp op) {
     keyswitchKeys.insert(op.getKskAttr());
     secretKeys.insert(op.getKskAttr().getInputKey());
     secretKeys.insert(op.getKskAttr().getOutputKey());
@@ -17,6 +17,7 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include "concrete-optimizer.hpp"
+#include "concretelang/Support/CompilationCache.h"
 #include "concretelang/Support/Error.h"
 #include "concretelang/Support/V0Parameters.h"
 #include "concretelang/Support/logging.h"
@@ -40,6 +41,15 @@ concrete_optimizer::Options options_from_config(optimizer::Config config) {
       std::shared_ptr<concrete_optimizer::restriction::RangeRestriction>(),
       /* .keyset_restriction = */
       std::shared_ptr<concrete_optimizer::restriction::KeysetRestriction>(),
+      /* .nb_threads = */ config.nb_threads,
+      /* .cost_model = */ config.cost_model,
+      /* .gpu_number_of_sm = */ config.gpu_number_of_sm,
+      /* .ks_cost_factor = */ config.ks_cost_factor,
+      /* .pbs_cost_factor = */ config.pbs_cost_factor,
+      /* .key_size_weight = */ config.key_size_weight,
+      /* .key_reuse_threshold = */ config.key_reuse_threshold,
+      /* .allow_pbs_ks_order = */ config.allow_pbs_ks_order,
+      /* .max_grouping_factor = */ config.max_grouping_factor,
   };
   if (config.range_restriction) {
     options.range_restriction = config.range_restriction;
@@ -118,17 +128,38 @@ Solution getSolutionWithGlobalPError(optimizer::Config config,
   return sol;
 }
 
+/// Returns the solution of `dag` computed by `optimize`, memoized in the
+/// solution caches of `config`
+template <typename Solution, typename Optimize>
+Solution getCachedSolution(optimizer::Dag &dag, optimizer::Config config,
+                           Optimize optimize) {
+  std::optional<std::string> key;
+  if (!config.solution_cache_dir.empty() ||
+      !config.shared_solution_cache_dirs.empty())
+    key = getOptimizerCacheKey(dag, config);
+
+  Solution solution;
+  if (key.has_value() && loadCachedSolution(config, *key, solution))
+    return solution;
+  solution = optimize();
+  if (key.has_value())
+    storeCachedSolution(config, *key, solution);
+  return solution;
+}
+
 optimizer::DagSolution getDagMonoSolution(optimizer::Dag &dag,
                                           optimizer::Config config) {
   auto optimize =
       [&](concrete_optimizer::Options options) -> optimizer::DagSolution {
     return dag->optimize(options);
   };
-  if (!std::isnan(config.global_p_error)) {
-    return getSolutionWithGlobalPError<optimizer::DagSolution>(config,
-                                                               optimize);
-  }
-  return optimize(options_from_config(config));
+  return getCachedSolution<optimizer::DagSolution>(dag, config, [&]() {
+    if (!std::isnan(config.global_p_error)) {
+      return getSolutionWithGlobalPError<optimizer::DagSolution>(config,
+                                                                 optimize);
+    }
+    return optimize(options_from_config(config));
+  });
 }
 
 optimizer::CircuitSolution getDagMultiSolution(optimizer::Dag &dag,
@@ -138,11 +169,13 @@ optimizer::CircuitSolution getDagMultiSolution(optimizer::Dag &dag,
       [&](concrete_optimizer::Options options) -> optimizer::CircuitSolution {
     return dag->optimize_multi(options);
   };
-  if (!std::isnan(config.global_p_error)) {
-    return getSolutionWithGlobalPError<optimizer::CircuitSolution>(config,
-                                                                   optimize);
-  }
-  return optimize(options_from_config(config));
+  return getCachedSolution<optimizer::CircuitSolution>(dag, config, [&]() {
+    if (!std::isnan(config.global_p_error)) {
+      return getSolutionWithGlobalPError<optimizer::CircuitSolution>(config,
+                                                                     optimize);
+    }
+    return optimize(options_from_config(config));
+  });
 }
 
 constexpr double WARN_ABOVE_GLOBAL_ERROR_RATE = 1.0 / 1000.0;
@@ -16,6 +16,8 @@
 #include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
 #include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/ImplicitLocOpBuilder.h>
+#include <mlir/Interfaces/LoopLikeInterface.h>
 #include <mlir/Interfaces/SideEffectInterfaces.h>
 #include <mlir/Transforms/GreedyPatternRewriteDriver.h>
 #include <mlir/Transforms/RegionUtils.h>
@@ -1014,9 +1016,10 @@ operandsToValueSet(llvm::ArrayRef<mlir::OpOperand *> operands) {
 class BatchingPattern : public mlir::OpRewritePattern<mlir::func::FuncOp> {
 public:
   BatchingPattern(mlir::MLIRContext *context,
-                  int64_t maxBatchSize = std::numeric_limits<int64_t>::max())
+                  int64_t maxBatchSize = std::numeric_limits<int64_t>::max(),
+                  bool batchWopPBS = false)
       : mlir::OpRewritePattern<mlir::func::FuncOp>(context),
-        maxBatchSize(maxBatchSize) {}
+        maxBatchSize(maxBatchSize), batchWopPBS(batchWopPBS) {}
 
   mlir::LogicalResult
   matchAndRewrite(mlir::func::FuncOp func,
@@ -1047,14 +1050,20 @@ public:
 
     // Find a batchable op which is embedded into a loop nest
     func.walk([&](BatchableOpInterface scalarOp) {
+      // The batched WoP-PBS only has a simulated implementation
+      if (!batchWopPBS && llvm::isa<TFHE::WopPBSGLWEOp>(scalarOp))
+        return mlir::WalkResult::skip();
+
       // Predicate checking whether an scf.for op is a valid candidate
       // to expand the loop nest upwards towards the outermost loop
-      auto isCandidateLoop = [](mlir::scf::ForOp forOp) -> bool {
+      auto isCandidateLoop = [&](mlir::scf::ForOp forOp) -> bool {
         std::function<bool(mlir::scf::ForOp forOp)> hasKSorBS =
             [&](mlir::scf::ForOp forOp) -> bool {
           for (mlir::Operation &op : forOp.getBody()->getOperations()) {
             if (llvm::isa<TFHE::KeySwitchGLWEOp, TFHE::BootstrapGLWEOp>(op))
               return true;
+            if (batchWopPBS && llvm::isa<TFHE::WopPBSGLWEOp>(op))
+              return true;
             if (auto nested = llvm::dyn_cast_or_null<mlir::scf::ForOp>(op);
                 nested)
               if (hasKSorBS(nested))
@@ -1389,23 +1398,23 @@ public:
       rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(
           targetOp, structuredBatchedResult, idxUse);
     } else {
+      // Extract the row of the results of the scalar operation,
+      // dropping the unit dimensions of the loop nest
       llvm::SmallVector<OpFoldResult> offsets =
           map(idxUse, getValueAsOpFoldResult);
-      llvm::SmallVector<OpFoldResult> strides(1, ilob2.getI64IntegerAttr(1));
-      llvm::SmallVector<OpFoldResult> sizes(1, ilob2.getI64IntegerAttr(1));
+      llvm::SmallVector<OpFoldResult> sizes(idxUse.size(),
+                                            ilob2.getI64IntegerAttr(1));
+      llvm::SmallVector<OpFoldResult> strides(idxUse.size() + 1,
+                                              ilob2.getI64IntegerAttr(1));
 
-      offsets.append(batchedResultType.getShape().size() - 1,
-                     ilob2.getI64IntegerAttr(0));
-      strides.append(batchedResultType.getShape().size() - 1,
-                     ilob2.getI64IntegerAttr(1));
-
-      for (int64_t dim : batchedResultType.getShape().take_front()) {
-        strides.push_back(ilob2.getI64IntegerAttr(dim));
-        sizes.push_back(ilob2.getI64IntegerAttr(dim));
-      }
+      offsets.push_back(ilob2.getI64IntegerAttr(0));
+      sizes.push_back(ilob2.getI64IntegerAttr(
+          structuredBatchedShape[structuredBatchedShape.size() - 1]));
 
       rewriter.replaceOpWithNewOp<mlir::tensor::ExtractSliceOp>(
-          targetOp, batchedResult, offsets, sizes, strides);
+          targetOp,
+          llvm::cast<mlir::RankedTensorType>(targetOp->getResult(0).getType()),
+          structuredBatchedResult, offsets, sizes, strides);
     }
 
     return mlir::success();
@@ -1413,6 +1422,7 @@ public:
 
 private:
   int64_t maxBatchSize;
+  bool batchWopPBS;
 };
 
 // Returns a pair containing:
@@ -2026,6 +2036,391 @@ public:
   }
 };
 
+/// Pattern that batches the independent batchable operations of a
+/// block which is not part of a loop, e.g.,
+///
+///   %r0 = batchable_op %a, %lut, ...
+///   %s = ...
+///   %r1 = batchable_op %b, %lut, ...
+///
+/// is replaced with:
+///
+///   %s = ...
+///   %t = tensor.from_elements %a, %b
+///   %rT = batched_op %t, %lut, ...
+///   %r0 = tensor.extract %rT[%c0]
+///   %r1 = tensor.extract %rT[%c1]
+///
+/// Operations of the same kind and with the same non-batchable
+/// operands are batched by topological level, that is by the number
+/// of batchable operations on the longest chain producing their
+/// operands in the block. The batched operations are placed right
+/// after the last producer of their operands, such that the operations
+/// using their results stay where they are. Batched keyswitches and
+/// bootstraps, e.g. resulting from the batching of sibling loop nests,
+/// are merged the same way by concatenating their operands.
+class StraightLineBatchingPattern
+    : public mlir::OpRewritePattern<mlir::func::FuncOp> {
+public:
+  StraightLineBatchingPattern(
+      mlir::MLIRContext *context,
+      int64_t maxBatchSize = std::numeric_limits<int64_t>::max())
+      : mlir::OpRewritePattern<mlir::func::FuncOp>(context),
+        maxBatchSize(maxBatchSize) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(mlir::func::FuncOp func,
+                  mlir::PatternRewriter &rewriter) const override {
+    llvm::SmallVector<mlir::Block *> blocks;
+    func.walk([&](mlir::Block *block) {
+      if (!isInLoop(block))
+        blocks.push_back(block);
+    });
+
+    for (mlir::Block *block : blocks) {
+      for (unsigned variant = 0; variant < maxNumVariants(*block); variant++) {
+        if (batchBlock(*block, variant, rewriter))
+          return mlir::success();
+      }
+    }
+
+    return mlir::failure();
+  }
+
+private:
+  // A batchable operation, or an already batched operation with
+  // `width` results.
+  struct Member {
+    mlir::Operation *op;
+    int64_t width;
+    bool isBatched;
+    // Positions in the block of the last producer of an operand and
+    // of the first user of the result
+    int64_t lastProducer;
+    int64_t firstUser;
+    int64_t offset;
+  };
+
+  static bool isInLoop(mlir::Block *block) {
+    for (mlir::Operation *parent = block->getParentOp();
+         parent && !llvm::isa<mlir::func::FuncOp>(parent);
+         parent = parent->getParentOp()) {
+      if (llvm::isa<mlir::LoopLikeOpInterface>(parent))
+        return true;
+    }
+    return false;
+  }
+
+  // Returns true if `op` is a batched operation which can be merged
+  // with others by concatenating its first operand.
+  static bool isMergeableBatchedOp(mlir::Operation *op) {
+    return llvm::isa<TFHE::BatchedKeySwitchGLWEOp,
+                     TFHE::BatchedBootstrapGLWEOp>(op);
+  }
+
+  static bool isScalarBatchableOp(mlir::Operation *op) {
+    return llvm::isa<BatchableOpInterface>(op) && op->getNumResults() == 1 &&
+           !op->getResult(0).getType().isa<mlir::ShapedType>();
+  }
+
+  static unsigned maxNumVariants(mlir::Block &block) {
+    unsigned res = 0;
+    for (mlir::Operation &op : block) {
+      if (isMergeableBatchedOp(&op))
+        res = std::max(res, 1u);
+      else if (isScalarBatchableOp(&op))
+        res = std::max(
+            res, llvm::cast<BatchableOpInterface>(op).getNumBatchingVariants());
+    }
+    return res;
+  }
+
+  // Batches a group of operations of `block` using the batching
+  // variant `variant` of the scalar operations, and returns true if
+  // one was found.
+  bool batchBlock(mlir::Block &block, unsigned variant,
+                  mlir::PatternRewriter &rewriter) const {
+    llvm::SmallVector<mlir::Operation *> ops;
+    llvm::DenseMap<mlir::Operation *, int64_t> positions;
+    llvm::DenseMap<mlir::Operation *, int64_t> levels;
+
+    // Returns the position of the ancestor of `op` in the block, or
+    // -1 if it is not in the block
+    auto positionInBlock = [&](mlir::Operation *op) -> int64_t {
+      mlir::Operation *ancestor = block.findAncestorOpInBlock(*op);
+      return ancestor ? positions[ancestor] : -1;
+    };
+
+    for (mlir::Operation &op : block) {
+      positions[&op] = ops.size();
+      ops.push_back(&op);
+
+      llvm::SetVector<mlir::Value> used(op.getOperands().begin(),
+                                        op.getOperands().end());
+      mlir::getUsedValuesDefinedAbove(op.getRegions(), used);
+
+      int64_t level = 0;
+      for (mlir::Value v : used) {
+        mlir::Operation *producer = v.getDefiningOp();
+        if (!producer || producer->getBlock() != &block)
+          continue;
+        bool isCandidate =
+            isScalarBatchableOp(producer) || isMergeableBatchedOp(producer);
+        level = std::max(level, levels[producer] + (isCandidate ? 1 : 0));
+      }
+      levels[&op] = level;
+    }
+
+    // Group the candidates by kind, non-batchable operands and level
+    std::map<llvm::SmallVector<const void *>, size_t> groupIndexes;
+    std::vector<llvm::SmallVector<Member>> groups;
+
+    for (mlir::Operation *op : ops) {
+      bool isBatched = isMergeableBatchedOp(op);
+
+      if (!isBatched &&
+          (!isScalarBatchableOp(op) ||
+           llvm::cast<BatchableOpInterface>(op).getNumBatchingVariants() <=
+               variant))
+        continue;
+
+      // Already batched operations are only merged once
+      if (isBatched && variant != 0)
+        continue;
+
+      llvm::SmallVector<const void *> key;
+      key.push_back(op->getName().getAsOpaquePointer());
+      key.push_back(reinterpret_cast<const void *>(
+          static_cast<uintptr_t>(isBatched ? 0 : variant + 1)));
+      key.push_back(op->getAttrDictionary().getAsOpaquePointer());
+      key.push_back(
+          reinterpret_cast<const void *>(static_cast<uintptr_t>(levels[op])));
+
+      Member member{op, 1, isBatched, -1,
+                    std::numeric_limits<int64_t>::max(), 0};
+
+      if (isBatched) {
+        mlir::RankedTensorType resType =
+            op->getResult(0).getType().cast<mlir::RankedTensorType>();
+        key.push_back(resType.getElementType().getAsOpaquePointer());
+        member.width = resType.getDimSize(0);
+        for (mlir::Value v : op->getOperands().drop_front())
+          key.push_back(v.getAsOpaquePointer());
+      } else {
+        key.push_back(op->getResult(0).getType().getAsOpaquePointer());
+        llvm::SmallVector<mlir::OpOperand *> batchableOperands;
+        llvm::SmallVector<mlir::OpOperand *> nonBatchableOperands;
+        splitOperands(llvm::cast<BatchableOpInterface>(op), variant,
+                      batchableOperands, nonBatchableOperands);
+        for (mlir::OpOperand *operand : nonBatchableOperands)
+          key.push_back(operand->get().getAsOpaquePointer());
+      }
+
+      for (mlir::Value v : op->getOperands()) {
+        if (mlir::Operation *producer = v.getDefiningOp())
+          member.lastProducer =
+              std::max(member.lastProducer, positionInBlock(producer));
+      }
+
+      for (mlir::Operation *user : op->getUsers()) {
+        int64_t pos = positionInBlock(user);
+        if (pos >= 0)
+          member.firstUser = std::min(member.firstUser, pos);
+      }
+
+      auto inserted = groupIndexes.insert({key, groups.size()});
+      if (inserted.second)
+        groups.emplace_back();
+      groups[inserted.first->second].push_back(member);
+    }
+
+    for (llvm::SmallVector<Member> &group : groups) {
+      if (group.size() < 2)
+        continue;
+
+      // Select the members which can be batched at a single position,
+      // i.e. after the last producer of their operands and before the
+      // first user of their results
+      llvm::stable_sort(group, [](const Member &a, const Member &b) {
+        return a.lastProducer < b.lastProducer;
+      });
+
+      llvm::SmallVector<Member> batch;
+      int64_t lastProducer = -1;
+      int64_t firstUser = std::numeric_limits<int64_t>::max();
+      int64_t width = 0;
+
+      for (Member &member : group) {
+        if (width + member.width > maxBatchSize)
+          continue;
+
+        int64_t newLastProducer = std::max(lastProducer, member.lastProducer);
+        int64_t newFirstUser = std::min(firstUser, member.firstUser);
+
+        if (newLastProducer >= newFirstUser)
+          continue;
+
+        member.offset = width;
+        width += member.width;
+        lastProducer = newLastProducer;
+        firstUser = newFirstUser;
+        batch.push_back(member);
+      }
+
+      if (batch.size() < 2)
+        continue;
+
+      if (lastProducer < 0)
+        rewriter.setInsertionPointToStart(&block);
+      else
+        rewriter.setInsertionPointAfter(ops[lastProducer]);
+
+      rewriteBatch(batch, width, variant, rewriter);
+      return true;
+    }
+
+    return false;
+  }
+
+  // Concatenates the values `values` of the members of a batch into a
+  // tensor with one element per batched scalar.
+  static mlir::Value concatenate(mlir::ImplicitLocOpBuilder &builder,
+                                 llvm::ArrayRef<Member> batch,
+                                 llvm::ArrayRef<mlir::Value> values,
+                                 int64_t width) {
+    mlir::Type type = values.front().getType();
+
+    if (batch.front().isBatched) {
+      mlir::Type elementType =
+          type.cast<mlir::RankedTensorType>().getElementType();
+      mlir::Value res = builder.create<mlir::bufferization::AllocTensorOp>(
+          mlir::RankedTensorType::get({width}, elementType),
+          mlir::ValueRange{});
+
+      for (auto [member, value] : llvm::zip(batch, values)) {
+        res = builder.create<mlir::tensor::InsertSliceOp>(
+            value, res,
+            llvm::ArrayRef<mlir::OpFoldResult>{
+                builder.getIndexAttr(member.offset)},
+            llvm::ArrayRef<mlir::OpFoldResult>{
+                builder.getIndexAttr(member.width)},
+            llvm::ArrayRef<mlir::OpFoldResult>{builder.getIndexAttr(1)});
+      }
+
+      return res;
+    }
+
+    mlir::RankedTensorType tensorType = type.dyn_cast<mlir::RankedTensorType>();
+
+    if (!tensorType) {
+      return builder.create<mlir::tensor::FromElementsOp>(
+          mlir::RankedTensorType::get({width}, type), values);
+    }
+
+    // Tensor operands are stacked along a new leading dimension
+    llvm::SmallVector<int64_t> shape{width};
+    shape.append(tensorType.getShape().begin(), tensorType.getShape().end());
+
+    mlir::Value res = builder.create<mlir::bufferization::AllocTensorOp>(
+        mlir::RankedTensorType::get(shape, tensorType.getElementType()),
+        mlir::ValueRange{});
+
+    for (auto [member, value] : llvm::zip(batch, values)) {
+      llvm::SmallVector<mlir::OpFoldResult> offsets(shape.size(),
+                                                    builder.getIndexAttr(0));
+      llvm::SmallVector<mlir::OpFoldResult> sizes{builder.getIndexAttr(1)};
+      llvm::SmallVector<mlir::OpFoldResult> strides(shape.size(),
+                                                    builder.getIndexAttr(1));
+      offsets[0] = builder.getIndexAttr(member.offset);
+      for (int64_t dim : tensorType.getShape())
+        sizes.push_back(builder.getIndexAttr(dim));
+
+      res = builder.create<mlir::tensor::InsertSliceOp>(value, res, offsets,
+                                                        sizes, strides);
+    }
+
+    return res;
+  }
+
+  static void rewriteBatch(llvm::ArrayRef<Member> batch, int64_t width,
+                           unsigned variant, mlir::PatternRewriter &rewriter) {
+    mlir::Operation *first = batch.front().op;
+
+    mlir::ImplicitLocOpBuilder builder(
+        rewriter.getFusedLoc(llvm::to_vector(llvm::map_range(
+            batch, [](const Member &member) { return member.op->getLoc(); }))),
+        rewriter);
+
+    mlir::Value batched;
+
+    if (batch.front().isBatched) {
+      llvm::SmallVector<mlir::Value> values = llvm::to_vector(llvm::map_range(
+          batch,
+          [](const Member &member) { return member.op->getOperand(0); }));
+
+      mlir::Value concatenated = concatenate(builder, batch, values, width);
+      mlir::RankedTensorType resType =
+          first->getResult(0).getType().cast<mlir::RankedTensorType>();
+
+      mlir::OperationState state(builder.getLoc(), first->getName());
+      state.addOperands(concatenated);
+      state.addOperands(first->getOperands().drop_front());
+      state.addAttributes(first->getAttrs());
+      state.addTypes(
+          mlir::RankedTensorType::get({width}, resType.getElementType()));
+      batched = rewriter.create(state)->getResult(0);
+    } else {
+      BatchableOpInterface batchableOp =
+          llvm::cast<BatchableOpInterface>(first);
+      llvm::SmallVector<mlir::OpOperand *> batchableOperands;
+      llvm::SmallVector<mlir::OpOperand *> nonBatchableOperands;
+      splitOperands(batchableOp, variant, batchableOperands,
+                    nonBatchableOperands);
+
+      llvm::SmallVector<mlir::Value> batchedOperands;
+      for (mlir::OpOperand *operand : batchableOperands) {
+        unsigned operandNumber = operand->getOperandNumber();
+        llvm::SmallVector<mlir::Value> values =
+            llvm::to_vector(llvm::map_range(batch, [&](const Member &member) {
+              return member.op->getOperand(operandNumber);
+            }));
+        batchedOperands.push_back(concatenate(builder, batch, values, width));
+      }
+
+      llvm::SmallVector<mlir::Value> nonBatchedOperands = llvm::to_vector(
+          llvm::map_range(nonBatchableOperands,
+                          [](mlir::OpOperand *operand) -> mlir::Value {
+                            return operand->get();
+                          }));
+
+      batched = batchableOp.createBatchedOperation(
+          variant, builder, batchedOperands, nonBatchedOperands);
+    }
+
+    for (const Member &member : batch) {
+      mlir::Value res;
+
+      if (member.isBatched) {
+        res = builder.create<mlir::tensor::ExtractSliceOp>(
+            batched,
+            llvm::ArrayRef<mlir::OpFoldResult>{
+                builder.getIndexAttr(member.offset)},
+            llvm::ArrayRef<mlir::OpFoldResult>{
+                builder.getIndexAttr(member.width)},
+            llvm::ArrayRef<mlir::OpFoldResult>{builder.getIndexAttr(1)});
+      } else {
+        mlir::Value index =
+            builder.create<mlir::arith::ConstantIndexOp>(member.offset);
+        res = builder.create<mlir::tensor::ExtractOp>(batched, index);
+      }
+
+      rewriter.replaceOp(member.op, res);
+    }
+  }
+
+  int64_t maxBatchSize;
+};
+
 class TensorAllocationCleanupPattern
     : public mlir::OpRewritePattern<mlir::func::FuncOp> {
 public:
@@ -2051,12 +2446,14 @@ public:
 
 class BatchingPass : public BatchingBase<BatchingPass> {
 public:
-  BatchingPass(int64_t maxBatchSize) : maxBatchSize(maxBatchSize) {}
+  BatchingPass(int64_t maxBatchSize, bool batchWopPBS)
+      : maxBatchSize(maxBatchSize), batchWopPBS(batchWopPBS) {}
   void runOnOperation() override {
     mlir::Operation *op = getOperation();
 
     mlir::RewritePatternSet patterns(op->getContext());
-    patterns.add<BatchingPattern>(op->getContext(), maxBatchSize);
+    patterns.add<BatchingPattern>(op->getContext(), maxBatchSize, batchWopPBS);
+    patterns.add<StraightLineBatchingPattern>(op->getContext(), maxBatchSize);
     patterns
         .add<CleanupPattern<mlir::tensor::ExtractOp, mlir::tensor::InsertOp>,
              CleanupPattern<mlir::tensor::ExtractSliceOp,
@@ -2070,11 +2467,12 @@ public:
 
 private:
   int64_t maxBatchSize;
+  bool batchWopPBS;
 };
 
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
-createBatchingPass(int64_t maxBatchSize) {
-  return std::make_unique<BatchingPass>(maxBatchSize);
+createBatchingPass(int64_t maxBatchSize, bool batchWopPBS) {
+  return std::make_unique<BatchingPass>(maxBatchSize, batchWopPBS);
 }
 
 } // namespace concretelang
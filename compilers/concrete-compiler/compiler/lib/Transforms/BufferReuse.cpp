@@ -0,0 +1,115 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+
+#include "concretelang/Transforms/Passes.h"
+
+namespace {
+
+/// Returns true if the buffer allocated by `allocOp` has a static type, such
+/// that it can replace or be replaced by any buffer of the same type.
+bool isReusable(mlir::memref::AllocOp allocOp) {
+  mlir::MemRefType type = allocOp.getType();
+  return type.hasStaticShape() && type.getLayout().isIdentity() &&
+         allocOp->getNumOperands() == 0;
+}
+
+/// Returns the deallocation of the buffer allocated by `allocOp` if it has a
+/// single one.
+mlir::memref::DeallocOp getSingleDealloc(mlir::memref::AllocOp allocOp) {
+  mlir::memref::DeallocOp dealloc;
+  for (mlir::Operation *user : allocOp->getUsers()) {
+    if (auto deallocOp = llvm::dyn_cast<mlir::memref::DeallocOp>(user)) {
+      if (dealloc)
+        return nullptr;
+      dealloc = deallocOp;
+    }
+  }
+  return dealloc;
+}
+
+/// Allocates the buffers allocated and deallocated by each iteration of
+/// `forOp` once for all the iterations.
+void hoistFromLoop(mlir::scf::ForOp forOp) {
+  mlir::Block *body = forOp.getBody();
+  for (mlir::Operation &op : llvm::make_early_inc_range(*body)) {
+    auto allocOp = llvm::dyn_cast<mlir::memref::AllocOp>(op);
+    if (!allocOp || !isReusable(allocOp))
+      continue;
+    mlir::memref::DeallocOp dealloc = getSingleDealloc(allocOp);
+    if (!dealloc || dealloc->getBlock() != body)
+      continue;
+    // The buffer must not be passed to the next iteration
+    if (llvm::any_of(allocOp->getUsers(), [&](mlir::Operation *user) {
+          return user == body->getTerminator();
+        }))
+      continue;
+    allocOp->moveBefore(forOp);
+    dealloc->moveAfter(forOp);
+  }
+}
+
+/// Replaces the allocations of `block` by the buffers of the same type
+/// deallocated before them, if no allocation happens in between.
+void reuseInBlock(mlir::Block &block) {
+  llvm::SmallVector<mlir::memref::DeallocOp> deallocated;
+  for (mlir::Operation &op : llvm::make_early_inc_range(block)) {
+    if (auto deallocOp = llvm::dyn_cast<mlir::memref::DeallocOp>(op)) {
+      auto allocOp =
+          deallocOp.getMemref().getDefiningOp<mlir::memref::AllocOp>();
+      if (allocOp && isReusable(allocOp) &&
+          getSingleDealloc(allocOp) == deallocOp)
+        deallocated.push_back(deallocOp);
+      continue;
+    }
+
+    if (auto allocOp = llvm::dyn_cast<mlir::memref::AllocOp>(op)) {
+      auto reused = llvm::find_if(
+          deallocated, [&](mlir::memref::DeallocOp deallocOp) {
+            auto deallocatedOp =
+                deallocOp.getMemref().getDefiningOp<mlir::memref::AllocOp>();
+            return deallocatedOp.getType() == allocOp.getType() &&
+                   deallocatedOp.getAlignment() == allocOp.getAlignment();
+          });
+      if (!isReusable(allocOp) || reused == deallocated.end()) {
+        deallocated.clear();
+        continue;
+      }
+      allocOp.replaceAllUsesWith(reused->getMemref());
+      allocOp.erase();
+      reused->erase();
+      deallocated.erase(reused);
+      continue;
+    }
+
+    if (op.getNumRegions() != 0 &&
+        op.walk([](mlir::memref::AllocOp) {
+            return mlir::WalkResult::interrupt();
+          }).wasInterrupted())
+      deallocated.clear();
+  }
+}
+
+struct BufferReusePass : public BufferReuseBase<BufferReusePass> {
+  void runOnOperation() override {
+    mlir::ModuleOp module = getOperation();
+    // The inner loops first, for their buffers to be hoisted out of the
+    // enclosing loops
+    module.walk([](mlir::scf::ForOp forOp) { hoistFromLoop(forOp); });
+    module.walk([](mlir::Block *block) { reuseInBlock(*block); });
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<OperationPass<ModuleOp>> createBufferReusePass() {
+  return std::make_unique<BufferReusePass>();
+}
+} // namespace concretelang
+} // namespace mlir
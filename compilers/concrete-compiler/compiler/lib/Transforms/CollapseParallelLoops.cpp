@@ -9,8 +9,10 @@
 #include "mlir/Dialect/Bufferization/Transforms/Bufferize.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/Passes.h"
 #include "mlir/Transforms/RegionUtils.h"
@@ -18,6 +20,80 @@
 
 namespace {
 
+/// The trip count under which a parallel loop has too few iterations to keep
+/// the cores busy on its own, such that it is worth collapsing it with the
+/// parallel loop it contains even if they are not perfectly nested.
+constexpr int64_t SMALL_TRIP_COUNT = 128;
+
+static bool isParallel(mlir::scf::ForOp forOp) {
+  auto attr = forOp->getAttrOfType<mlir::BoolAttr>("parallel");
+  return attr != nullptr && attr.getValue();
+}
+
+/// Makes a parallel loop with a small or unknown trip count perfectly nested
+/// with the parallel loop of its body, by hoisting the loop invariant
+/// operations of its body above it, and sinking the others into the nested
+/// loop, e.g. the index computations of the nested loop. Returns false if the
+/// loops cannot be perfectly nested, i.e. if the body of `outer` has more than
+/// one loop, operations after it or operations which are not pure.
+static bool makePerfectlyNested(mlir::scf::ForOp outer) {
+  if (!isParallel(outer) || outer.getNumRegionIterArgs() != 0)
+    return false;
+
+  std::optional<int64_t> lb = mlir::getConstantIntValue(outer.getLowerBound());
+  std::optional<int64_t> ub = mlir::getConstantIntValue(outer.getUpperBound());
+  std::optional<int64_t> step = mlir::getConstantIntValue(outer.getStep());
+  if (lb.has_value() && ub.has_value() && step.has_value() && *step > 0 &&
+      (*ub - *lb + *step - 1) / *step >= SMALL_TRIP_COUNT)
+    return false;
+
+  mlir::scf::ForOp inner;
+  llvm::SmallVector<mlir::Operation *> hoisted;
+  llvm::SmallVector<mlir::Operation *> sunk;
+  llvm::SmallPtrSet<mlir::Operation *, 8> hoistedSet;
+  for (mlir::Operation &op : outer.getBody()->without_terminator()) {
+    if (auto forOp = llvm::dyn_cast<mlir::scf::ForOp>(op)) {
+      if (inner)
+        return false;
+      inner = forOp;
+      continue;
+    }
+    if (inner || op.getNumRegions() != 0 || !mlir::isMemoryEffectFree(&op))
+      return false;
+
+    bool invariant = llvm::all_of(op.getOperands(), [&](mlir::Value operand) {
+      return outer.isDefinedOutsideOfLoop(operand) ||
+             hoistedSet.contains(operand.getDefiningOp());
+    });
+    if (invariant) {
+      hoisted.push_back(&op);
+      hoistedSet.insert(&op);
+    } else {
+      sunk.push_back(&op);
+    }
+  }
+  if (!inner || !isParallel(inner) || inner.getNumResults() != 0 ||
+      (hoisted.empty() && sunk.empty()))
+    return false;
+
+  // The sunk operations are recomputed by each iteration of the nested loop,
+  // their results can only be used there
+  llvm::SmallPtrSet<mlir::Operation *, 8> sunkSet(sunk.begin(), sunk.end());
+  for (mlir::Operation *op : sunk) {
+    for (mlir::Operation *user : op->getUsers()) {
+      if (!sunkSet.contains(user) && !inner->isProperAncestor(user))
+        return false;
+    }
+  }
+
+  for (mlir::Operation *op : hoisted)
+    op->moveBefore(outer);
+  mlir::Operation *front = &inner.getBody()->front();
+  for (mlir::Operation *op : sunk)
+    op->moveBefore(front);
+  return true;
+}
+
 struct CollapseParallelLoopsPass
     : public CollapseParallelLoopsBase<CollapseParallelLoopsPass> {
 
@@ -27,10 +103,14 @@ struct CollapseParallelLoopsPass
   void runOnOperation() override {
     mlir::ModuleOp module = getOperation();
     module.walk([&](mlir::scf::ForOp forOp) {
-      // Ignore nested loops.
-      if (forOp->getParentOfType<mlir::scf::ForOp>())
+      // Ignore the loops perfectly nested in another loop, they are collapsed
+      // with the outermost loop of their nest
+      if (auto parent = llvm::dyn_cast<mlir::scf::ForOp>(forOp->getParentOp());
+          parent && parent.getBody()->getOperations().size() == 2)
         return;
 
+      makePerfectlyNested(forOp);
+
       // Determine which sequences of nested loops can be coalesced
       // TODO: add loop interchange and hoisting to find more
       // opportunities by getting multiple parallel loops in sequence
@@ -5,15 +5,27 @@
 
 #include "concretelang/Transforms/Passes.h"
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Bufferization/Transforms/Bufferize.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/Passes.h"
 #include <mlir/Transforms/GreedyPatternRewriteDriver.h>
 
 namespace {
+/// A loop carried value accumulated by an associative and commutative
+/// operation, such that the iterations can compute their contributions in
+/// any order, and the contributions be combined afterwards.
+struct Reduction {
+  /// The operation combining the accumulator with the contribution
+  mlir::Operation *combiner;
+  /// The value accumulated by an iteration
+  mlir::Value contribution;
+};
+
 class ForOpPattern : public mlir::OpRewritePattern<mlir::scf::ForOp> {
 public:
   ForOpPattern(::mlir::MLIRContext *context, mlir::PatternBenefit benefit = 1)
@@ -24,28 +36,125 @@ public:
                   mlir::PatternRewriter &rewriter) const override {
     auto attr = forOp->getAttrOfType<mlir::BoolAttr>("parallel");
 
-    if (!attr || !attr.getValue()) {
+    if (!attr) {
       return mlir::failure();
     }
 
-    assert(forOp.getRegionIterArgs().size() == 0 &&
-           "unexpecting iter args when loops are bufferized");
+    // The loops which are not parallel can still be converted if their only
+    // loop carried dependencies are reductions, i.e. if they have no side
+    // effects on the memory and their iter args are accumulated by
+    // associative and commutative operations
+    if (!attr.getValue() &&
+        (forOp.getRegionIterArgs().empty() || mayWriteMemory(forOp))) {
+      return mlir::failure();
+    }
+
+    llvm::SmallVector<Reduction> reductions;
+    if (!matchReductions(forOp, reductions)) {
+      return mlir::failure();
+    }
 
     rewriter.replaceOpWithNewOp<mlir::scf::ParallelOp>(
         forOp, mlir::ValueRange{forOp.getLowerBound()},
-        mlir::ValueRange{forOp.getUpperBound()}, forOp.getStep(), std::nullopt,
+        mlir::ValueRange{forOp.getUpperBound()}, forOp.getStep(),
+        forOp.getInitArgs(),
         [&](mlir::OpBuilder &builder, mlir::Location location,
             mlir::ValueRange indVar, mlir::ValueRange iterArgs) {
           mlir::IRMapping map;
           map.map(forOp.getInductionVar(), indVar.front());
-          for (auto &op : forOp.getRegion().front()) {
+          for (auto &op : forOp.getBody()->without_terminator()) {
+            if (llvm::any_of(reductions, [&](const Reduction &reduction) {
+                  return reduction.combiner == &op;
+                }))
+              continue;
             auto newOp = builder.clone(op, map);
             map.map(op.getResults(), newOp->getResults());
           }
+
+          // The contributions of the iterations are combined by the reduce
+          // operations, with the combiners of the accumulators
+          for (size_t i = 0; i < reductions.size(); i++) {
+            const Reduction &reduction = reductions[i];
+            builder.create<mlir::scf::ReduceOp>(
+                location, map.lookupOrDefault(reduction.contribution),
+                [&](mlir::OpBuilder &builder, mlir::Location location,
+                    mlir::Value lhs, mlir::Value rhs) {
+                  mlir::IRMapping combinerMap;
+                  combinerMap.map(forOp.getRegionIterArgs()[i], lhs);
+                  combinerMap.map(reduction.contribution, rhs);
+                  auto combined =
+                      builder.clone(*reduction.combiner, combinerMap);
+                  builder.create<mlir::scf::ReduceReturnOp>(
+                      location, combined->getResult(0));
+                });
+          }
         });
 
     return mlir::success();
   }
+
+private:
+  /// Returns true if `op` is associative and commutative, such that it can
+  /// combine the contributions of the iterations in any order.
+  static bool isReductionCombiner(mlir::Operation *op) {
+    return llvm::isa<mlir::arith::AddIOp, mlir::arith::MulIOp,
+                     mlir::arith::AndIOp, mlir::arith::OrIOp,
+                     mlir::arith::XOrIOp, mlir::arith::MaxSIOp,
+                     mlir::arith::MaxUIOp, mlir::arith::MinSIOp,
+                     mlir::arith::MinUIOp>(op);
+  }
+
+  /// Returns true if an operation of the body of `forOp` may write to the
+  /// memory, or has unknown effects.
+  static bool mayWriteMemory(mlir::scf::ForOp forOp) {
+    auto result = forOp.getBody()->walk([](mlir::Operation *op) {
+      if (auto effects = llvm::dyn_cast<mlir::MemoryEffectOpInterface>(op)) {
+        if (effects.hasEffect<mlir::MemoryEffects::Write>())
+          return mlir::WalkResult::interrupt();
+        return mlir::WalkResult::advance();
+      }
+      if (op->hasTrait<mlir::OpTrait::HasRecursiveMemoryEffects>() ||
+          op->hasTrait<mlir::OpTrait::IsTerminator>())
+        return mlir::WalkResult::advance();
+      return mlir::WalkResult::interrupt();
+    });
+    return result.wasInterrupted();
+  }
+
+  /// Matches the iter args of `forOp` as reductions, i.e. only used by a
+  /// combiner whose result is only yielded, and returns false if one of them
+  /// is not a reduction.
+  ///
+  /// Only the scalar integers are reduced. The encrypted accumulations are
+  /// bufferized by then, to buffers written by each iteration, which
+  /// `scf.reduce` and its lowering to OpenMP do not support. They are split
+  /// before the bufferization by `fhe-split-reductions` instead, into a
+  /// parallel loop accumulating into partial sums.
+  static bool matchReductions(mlir::scf::ForOp forOp,
+                              llvm::SmallVector<Reduction> &reductions) {
+    auto yield =
+        llvm::cast<mlir::scf::YieldOp>(forOp.getBody()->getTerminator());
+    for (auto [iterArg, yielded] :
+         llvm::zip(forOp.getRegionIterArgs(), yield.getOperands())) {
+      if (!iterArg.getType().isIntOrIndex())
+        return false;
+      mlir::Operation *combiner = yielded.getDefiningOp();
+      if (!combiner || combiner->getBlock() != forOp.getBody() ||
+          !isReductionCombiner(combiner) || !iterArg.hasOneUse() ||
+          !yielded.hasOneUse())
+        return false;
+
+      mlir::Value lhs = combiner->getOperand(0);
+      mlir::Value rhs = combiner->getOperand(1);
+      if (lhs == iterArg && rhs != iterArg)
+        reductions.push_back({combiner, rhs});
+      else if (rhs == iterArg && lhs != iterArg)
+        reductions.push_back({combiner, lhs});
+      else
+        return false;
+    }
+    return true;
+  }
 };
 } // namespace
 
@@ -0,0 +1,83 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#include "concretelang/Transforms/Passes.h"
+
+namespace {
+
+/// Returns true if `op` only moves the elements of its input to its output,
+/// as the transpositions and the broadcasts of `FHELinalg` do.
+bool isCopy(mlir::linalg::GenericOp op) {
+  if (!op.hasTensorSemantics() || op.getNumDpsInputs() != 1 ||
+      op.getNumDpsInits() != 1 ||
+      op.getNumParallelLoops() != op.getNumLoops() ||
+      op->hasAttr("tile-sizes"))
+    return false;
+  mlir::Block *body = op.getBody();
+  auto yield = llvm::dyn_cast<mlir::linalg::YieldOp>(&body->front());
+  return yield && yield.getNumOperands() == 1 &&
+         yield.getOperand(0) == body->getArgument(0);
+}
+
+/// Fuses the copies into the `linalg.generic` reading them, which then read
+/// the elements of the copied tensor in the order of the copy.
+struct FuseCopyIntoConsumerPattern
+    : public mlir::OpRewritePattern<mlir::linalg::GenericOp> {
+  FuseCopyIntoConsumerPattern(mlir::MLIRContext *context)
+      : mlir::OpRewritePattern<mlir::linalg::GenericOp>(context) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(mlir::linalg::GenericOp consumer,
+                  mlir::PatternRewriter &rewriter) const override {
+    // The fused operation would not be tiled as the consumer
+    if (consumer->hasAttr("tile-sizes"))
+      return mlir::failure();
+
+    for (mlir::OpOperand &operand : consumer->getOpOperands()) {
+      auto producer = operand.get().getDefiningOp<mlir::linalg::GenericOp>();
+      if (!producer || !isCopy(producer) ||
+          !mlir::linalg::areElementwiseOpsFusable(&operand))
+        continue;
+
+      auto fused = mlir::linalg::fuseElementwiseOps(rewriter, &operand);
+      if (mlir::failed(fused))
+        continue;
+      for (auto [original, replacement] : fused->replacements) {
+        rewriter.replaceUsesWithIf(
+            original, replacement, [&](mlir::OpOperand &use) {
+              return use.get().getDefiningOp() != producer;
+            });
+      }
+      rewriter.eraseOp(consumer);
+      return mlir::success();
+    }
+    return mlir::failure();
+  }
+};
+
+struct FuseLinalgCopiesPass
+    : public FuseLinalgCopiesBase<FuseLinalgCopiesPass> {
+  void runOnOperation() override {
+    mlir::RewritePatternSet patterns(&getContext());
+    patterns.add<FuseCopyIntoConsumerPattern>(&getContext());
+    if (mlir::applyPatternsAndFoldGreedily(getOperation(), std::move(patterns))
+            .failed())
+      signalPassFailure();
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<OperationPass<ModuleOp>> createFuseLinalgCopiesPass() {
+  return std::make_unique<FuseLinalgCopiesPass>();
+}
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,159 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+#include "concretelang/Transforms/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/OpenMP/OpenMPDialect.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Operation.h"
+
+#include <cmath>
+
+namespace {
+
+/// The estimated cost of an iteration of a loop body, in nanoseconds, and
+/// whether all the iterations cost the same.
+struct IterationCost {
+  double cost = 0;
+  bool uniform = true;
+};
+
+/// The costs of the primitives, in nanoseconds, as orders of magnitude of the
+/// costs of the CPU primitives for the usual parameters.
+constexpr double BOOTSTRAP_COST = 1e7;
+constexpr double WOP_PBS_COST = 1e9;
+constexpr double KEYSWITCH_COST = 1e5;
+constexpr double LEVELED_COST = 1e3;
+constexpr double OTHER_COST = 1;
+
+/// The work a chunk of iterations should at least amount to, such that the
+/// overhead of the dynamic scheduling (about a microsecond per chunk) stays
+/// negligible.
+constexpr double MIN_CHUNK_COST = 1e5;
+
+/// The number of iterations assumed for the loops without static trip count.
+constexpr int64_t UNKNOWN_TRIP_COUNT = 16;
+
+struct OpenMPSchedulePass : public OpenMPScheduleBase<OpenMPSchedulePass> {
+
+  void runOnOperation() override {
+    getOperation().walk([&](mlir::omp::WsLoopOp loop) {
+      // The schedule set by an earlier pass is kept
+      if (loop.getScheduleVal().has_value())
+        return;
+
+      IterationCost iteration = estimate(loop.getRegion());
+      int64_t chunkSize = std::max<int64_t>(
+          1, std::ceil(MIN_CHUNK_COST / std::max(iteration.cost, OTHER_COST)));
+
+      // Iterations costing about the same as the overhead of a chunk are
+      // balanced well enough by the default static schedule
+      if (chunkSize > 1 && iteration.uniform)
+        return;
+
+      // The iterations running bootstraps are taken one at a time by the
+      // threads as they become idle, and the cheaper ones in chunks which
+      // shrink as the loop completes
+      auto kind = chunkSize == 1 ? mlir::omp::ClauseScheduleKind::Dynamic
+                                 : mlir::omp::ClauseScheduleKind::Guided;
+      mlir::OpBuilder builder(loop);
+      mlir::Value chunk = builder.create<mlir::arith::ConstantIntOp>(
+          loop.getLoc(), chunkSize, 64);
+      loop.setScheduleValAttr(
+          mlir::omp::ClauseScheduleKindAttr::get(loop.getContext(), kind));
+      loop.getScheduleChunkVarMutable().assign(chunk);
+    });
+  }
+
+private:
+  /// Returns the static trip count of a loop, if any.
+  static std::optional<int64_t> getTripCount(mlir::Value lowerBound,
+                                             mlir::Value upperBound,
+                                             mlir::Value step) {
+    std::optional<int64_t> lb = mlir::getConstantIntValue(lowerBound);
+    std::optional<int64_t> ub = mlir::getConstantIntValue(upperBound);
+    std::optional<int64_t> s = mlir::getConstantIntValue(step);
+    if (!lb.has_value() || !ub.has_value() || !s.has_value() || *s <= 0)
+      return std::nullopt;
+    return std::max<int64_t>(0, (*ub - *lb + *s - 1) / *s);
+  }
+
+  /// Returns the cost of a primitive of the runtime from its name, i.e. from
+  /// the name of a Concrete operation or of a function called.
+  static double getPrimitiveCost(llvm::StringRef name) {
+    if (name.contains("wop_pbs"))
+      return WOP_PBS_COST;
+    if (name.contains("bootstrap"))
+      return BOOTSTRAP_COST;
+    if (name.contains("keyswitch"))
+      return KEYSWITCH_COST;
+    if (name.contains("lwe"))
+      return LEVELED_COST;
+    return OTHER_COST;
+  }
+
+  /// Estimates the cost of running the operations of `region` once, the
+  /// branches of conditionals and the loops with dynamic trip counts making it
+  /// vary between iterations.
+  IterationCost estimate(mlir::Region &region) {
+    IterationCost total;
+    for (mlir::Block &block : region) {
+      for (mlir::Operation &op : block) {
+        IterationCost opCost = estimate(&op);
+        total.cost += opCost.cost;
+        total.uniform &= opCost.uniform;
+      }
+    }
+    return total;
+  }
+
+  IterationCost estimate(mlir::Operation *op) {
+    if (auto ifOp = llvm::dyn_cast<mlir::scf::IfOp>(op)) {
+      IterationCost thenCost = estimate(ifOp.getThenRegion());
+      IterationCost elseCost = estimate(ifOp.getElseRegion());
+      return IterationCost{std::max(thenCost.cost, elseCost.cost),
+                           thenCost.uniform && elseCost.uniform &&
+                               thenCost.cost == elseCost.cost};
+    }
+
+    if (auto forOp = llvm::dyn_cast<mlir::scf::ForOp>(op)) {
+      IterationCost body = estimate(forOp.getRegion());
+      std::optional<int64_t> tripCount = getTripCount(
+          forOp.getLowerBound(), forOp.getUpperBound(), forOp.getStep());
+      return IterationCost{body.cost * tripCount.value_or(UNKNOWN_TRIP_COUNT),
+                           body.uniform && tripCount.has_value()};
+    }
+
+    if (llvm::isa<mlir::scf::WhileOp>(op)) {
+      IterationCost body = estimate(op->getRegion(1));
+      return IterationCost{body.cost * UNKNOWN_TRIP_COUNT, false};
+    }
+
+    if (auto callOp = llvm::dyn_cast<mlir::func::CallOp>(op))
+      return IterationCost{getPrimitiveCost(callOp.getCallee()), true};
+
+    IterationCost cost{op->getDialect() &&
+                               op->getDialect()->getNamespace() == "Concrete"
+                           ? getPrimitiveCost(op->getName().getStringRef())
+                           : OTHER_COST,
+                       true};
+    for (mlir::Region &region : op->getRegions()) {
+      IterationCost regionCost = estimate(region);
+      cost.cost += regionCost.cost;
+      cost.uniform &= regionCost.uniform;
+    }
+    return cost;
+  }
+};
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+mlir::concretelang::createOpenMPSchedulePass() {
+  return std::make_unique<OpenMPSchedulePass>();
+}
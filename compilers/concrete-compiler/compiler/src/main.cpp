@@ -125,6 +125,17 @@ llvm::cl::opt<bool> compressEvaluationKeys(
                    "evaluation keys and ciphertexts"),
     llvm::cl::init<bool>(false));
 
+llvm::cl::opt<bool> compactFourierBootstrapKeys(
+    "compact-fourier-keys",
+    llvm::cl::desc("Store the fourier bootstrap keys of the server in single "
+                   "precision"),
+    llvm::cl::init<bool>(false));
+
+llvm::cl::opt<bool> compressOutputCiphertexts(
+    "compress-outputs",
+    llvm::cl::desc("Pack the output ciphertexts in glwe ciphertexts"),
+    llvm::cl::init<bool>(false));
+
 llvm::cl::list<std::string> passes(
     "passes",
     llvm::cl::desc("Specify the passes to run (use only for compiler tests)"),
@@ -224,11 +235,58 @@ llvm::cl::opt<bool> unrollLoopsWithSDFGConvertibleOps(
                    "fully unrolled."),
     llvm::cl::init(false));
 
+llvm::cl::opt<unsigned> sdfgLoopUnrollFactor(
+    "sdfg-loop-unroll-factor",
+    llvm::cl::desc("With --unroll-loops-with-sdfg-convertible-ops, unroll the "
+                   "innermost loops around SDFG-convertible operations by at "
+                   "most this factor, the iterations left streaming their "
+                   "items through the same processes (0 unrolls fully)."),
+    llvm::cl::init(0));
+
 llvm::cl::opt<bool> dataflowParallelize(
     "parallelize-dataflow",
     llvm::cl::desc("Generate the program as a dataflow graph"),
     llvm::cl::init(false));
 
+llvm::cl::opt<int64_t> dataflowMinTaskWork(
+    "dataflow-min-task-work",
+    llvm::cl::desc("Merge dataflow tasks until their estimated work, in "
+                   "leveled operations on a ciphertext (a table lookup counts "
+                   "for 1000), reaches this threshold (0 to disable)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<int64_t> dataflowUnrollFactor(
+    "dataflow-unroll-factor",
+    llvm::cl::desc("Unroll the loops with a static trip count holding table "
+                   "lookups by up to this number of iterations before "
+                   "building the dataflow tasks (0 to disable)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<std::string> dataflowThreadPolicy(
+    "dataflow-thread-policy",
+    llvm::cl::desc("Sharing of the cores between the dataflow runtime workers "
+                   "and the OpenMP threads: default, partition (disjoint "
+                   "cores) or shared (single pool of dataflow workers)"),
+    llvm::cl::init("default"));
+
+llvm::cl::opt<int64_t> dataflowThreads(
+    "dataflow-threads",
+    llvm::cl::desc("Number of dataflow runtime workers per node (0 for the "
+                   "default of the thread policy)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> asyncOffload(
+    "async-offload",
+    llvm::cl::desc("Run independent table lookups of straight-line code "
+                   "concurrently on the CPU async executor"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> destinationPassing(
+    "destination-passing",
+    llvm::cl::desc("Pass the tensor outputs of the circuits as buffers "
+                   "provided by the caller, instead of returning them"),
+    llvm::cl::init(false));
+
 llvm::cl::opt<bool>
     chunkIntegers("chunk-integers",
                   llvm::cl::desc("Whether to decompose integer into chunks or "
@@ -247,6 +305,111 @@ llvm::cl::opt<unsigned int> chunkWidth(
         "Chunk width while decomposing big integers into chunks, default is 2"),
     llvm::cl::init<unsigned int>(2));
 
+llvm::cl::opt<bool> fuseBooleanGates(
+    "fuse-boolean-gates",
+    llvm::cl::desc("Fuse the trees of boolean gates into single table lookups"),
+    llvm::cl::init<bool>(false));
+
+llvm::cl::opt<unsigned int> booleanGateFusionMaxInputs(
+    "boolean-gate-fusion-max-inputs",
+    llvm::cl::desc("Maximal number of distinct boolean inputs of the fused "
+                   "gates, 2 or 3, default is 2"),
+    llvm::cl::init<unsigned int>(2));
+
+llvm::cl::opt<bool> chunkCarryLookahead(
+    "chunk-carry-lookahead",
+    llvm::cl::desc("Compute the carries of the additions of chunked integers "
+                   "with a parallel prefix, of logarithmic depth"),
+    llvm::cl::init<bool>(false));
+
+llvm::cl::opt<bool> chunkIntegersByCost(
+    "chunk-integers-by-cost",
+    llvm::cl::desc("Decompose the big integers into chunks only if it lowers "
+                   "the complexity of the parameters found by the optimizer"),
+    llvm::cl::init<bool>(false));
+
+llvm::cl::opt<bool> batchCrtBlocks(
+    "batch-crt-blocks",
+    llvm::cl::desc("Lower the leveled operations on the blocks of crt encoded "
+                   "integers to batched operations over the blocks"),
+    llvm::cl::init<bool>(false));
+
+llvm::cl::opt<unsigned int> codegenThreads(
+    "codegen-threads",
+    llvm::cl::desc("Number of threads generating the code of the library in "
+                   "parallel, on partitions of its LLVM module (0 for the "
+                   "number of hardware threads), default is 1"),
+    llvm::cl::init<unsigned int>(1));
+
+llvm::cl::opt<std::string> targetCpu(
+    "target-cpu",
+    llvm::cl::desc("Cpu the code of the library is generated for, host for "
+                   "the cpu and the features of this machine or a cpu name "
+                   "such as x86-64-v3, default is host"),
+    llvm::cl::init<std::string>("host"));
+
+llvm::cl::list<std::string> targetCpuVariants(
+    "target-cpu-variants",
+    llvm::cl::desc("Generate the code of the library for the given x86-64 "
+                   "levels (x86-64, x86-64-v2, x86-64-v3, x86-64-v4), "
+                   "dispatching at runtime to the highest level supported"),
+    llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated);
+
+llvm::cl::opt<std::string> objectCacheDir(
+    "object-cache-dir",
+    llvm::cl::desc("Directory caching the objects of the circuits of the "
+                   "library, such that only the circuits which changed are "
+                   "generated again, disabled when empty"),
+    llvm::cl::init<std::string>(""));
+
+llvm::cl::opt<bool> compilationProfile(
+    "compilation-profile",
+    llvm::cl::desc("Report the time and the memory spent by each stage of "
+                   "the compilation of the library, and by the passes of "
+                   "their pipelines, in compilation_profile.json"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<std::string> latencyCostTable(
+    "latency-cost-table",
+    llvm::cl::desc("Predict the latency and the throughput of the circuits "
+                   "in the compilation feedback from the primitive cost table "
+                   "at the given path"),
+    llvm::cl::init<std::string>(""));
+
+llvm::cl::opt<std::string> latencyTargetDevice(
+    "latency-target-device",
+    llvm::cl::desc("The device of the primitive cost table the latency of the "
+                   "circuits is predicted for, e.g. cpu or a GPU model"),
+    llvm::cl::init<std::string>("cpu"));
+
+llvm::cl::opt<unsigned int> latencyTargetCores(
+    "latency-target-cores",
+    llvm::cl::desc("The number of cores the latency of the circuits is "
+                   "predicted for, 0 for the parallelism of the primitive "
+                   "cost table"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> reuseBuffers(
+    "reuse-buffers",
+    llvm::cl::desc("Reuse the buffers deallocated by the circuits for their "
+                   "next allocations of the same type, and allocate the "
+                   "buffers of the iterations of the sequential loops once"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<std::string> runtimeBitcode(
+    "runtime-bitcode",
+    llvm::cl::desc("LLVM bitcode of the leveled wrappers of the runtime, "
+                   "linked into the circuits to inline the leveled "
+                   "operations, disabled when empty"),
+    llvm::cl::init<std::string>(""));
+
+llvm::cl::list<std::string> executionVariants(
+    "execution-variants",
+    llvm::cl::desc("Compile the library with the given execution variants "
+                   "besides its default code (cpu, loop, dataflow, gpu), the "
+                   "server running the variant it selects for its host"),
+    llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated);
+
 llvm::cl::opt<double> pbsErrorProbability(
     "pbs-error-probability",
     llvm::cl::desc("Change the default probability of error for all pbs"),
@@ -312,7 +475,11 @@ llvm::cl::opt<concrete_optimizer::MultiParamStrategy>
             concrete_optimizer::MultiParamStrategy::ByPrecisionAndNorm2,
             "by-precision-and-norm2",
             "One partition set for each possible input TLU precision and "
-            "output norm2")));
+            "output norm2")),
+        llvm::cl::values(clEnumValN(
+            concrete_optimizer::MultiParamStrategy::ByCost, "by-cost",
+            "The partitions by input TLU precision and output norm2 merged "
+            "while it does not increase the complexity")));
 
 llvm::cl::opt<concrete_optimizer::Encoding> optimizerEncoding(
     "force-encoding", llvm::cl::desc("Choose cyphertext encoding."),
@@ -330,12 +497,183 @@ llvm::cl::opt<bool> optimizerNoCacheOnDisk(
                    "cache issues."),
     llvm::cl::init(false));
 
+llvm::cl::opt<uint32_t> optimizerThreads(
+    "optimizer-threads",
+    llvm::cl::desc("Number of threads of the search of the dag-multi "
+                   "parameters, 0 for all the available threads"),
+    llvm::cl::init(optimizer::DEFAULT_NB_THREADS));
+
+llvm::cl::opt<concrete_optimizer::CostModel> optimizerCostModel(
+    "optimizer-cost-model",
+    llvm::cl::desc("Select the cost model minimized by the optimizer"),
+    llvm::cl::init(optimizer::DEFAULT_COST_MODEL),
+    llvm::cl::values(clEnumValN(concrete_optimizer::CostModel::Auto, "auto",
+                                "The gpu amortized model when emitting gpu "
+                                "operations, the cpu one otherwise [default]")),
+    llvm::cl::values(clEnumValN(concrete_optimizer::CostModel::Cpu, "cpu",
+                                "The cpu model")),
+    llvm::cl::values(clEnumValN(concrete_optimizer::CostModel::GpuAmortized,
+                                "gpu-amortized",
+                                "The gpu model of batched bootstraps")),
+    llvm::cl::values(clEnumValN(concrete_optimizer::CostModel::GpuLowlat,
+                                "gpu-lowlat",
+                                "The gpu model of single bootstraps")));
+
+llvm::cl::opt<uint32_t> optimizerGpuNumberOfSm(
+    "optimizer-gpu-sm",
+    llvm::cl::desc("Number of streaming multiprocessors of the gpu cost "
+                   "models"),
+    llvm::cl::init(optimizer::DEFAULT_GPU_NUMBER_OF_SM));
+
+llvm::cl::opt<double> optimizerKsCostFactor(
+    "optimizer-ks-cost-factor",
+    llvm::cl::desc("Measured time of a keyswitch per unit of complexity of "
+                   "the cost model, 0 to keep the model unscaled"),
+    llvm::cl::init(optimizer::DEFAULT_COST_FACTOR));
+
+llvm::cl::opt<double> optimizerPbsCostFactor(
+    "optimizer-pbs-cost-factor",
+    llvm::cl::desc("Measured time of a bootstrap per unit of complexity of "
+                   "the cost model, 0 to keep the model unscaled"),
+    llvm::cl::init(optimizer::DEFAULT_COST_FACTOR));
+
+llvm::cl::opt<double> optimizerKeySizeWeight(
+    "optimizer-key-size-weight",
+    llvm::cl::desc("Complexity added per byte of bootstrap and keyswitch "
+                   "keys by the dag-multi optimizer, to trade some "
+                   "complexity for smaller keysets, 0 to ignore the key "
+                   "sizes"),
+    llvm::cl::init(optimizer::DEFAULT_KEY_SIZE_WEIGHT));
+
+llvm::cl::opt<double> optimizerKeyReuseThreshold(
+    "optimizer-key-reuse-threshold",
+    llvm::cl::desc("Relative complexity increase accepted by the dag-multi "
+                   "optimizer to merge two partitions, reusing their keys in "
+                   "all the circuits of the program, 0 to only merge when it "
+                   "does not increase the complexity"),
+    llvm::cl::init(optimizer::DEFAULT_KEY_REUSE_THRESHOLD));
+
+llvm::cl::opt<bool> optimizerAllowPbsKsOrder(
+    "optimizer-allow-pbs-ks-order",
+    llvm::cl::desc("Let the dag-multi optimizer bootstrap and then keyswitch "
+                   "in the partitions where doing the levelled operations on "
+                   "the small key is cheaper"),
+    llvm::cl::init(optimizer::DEFAULT_ALLOW_PBS_KS_ORDER));
+
+llvm::cl::opt<uint32_t> optimizerManyLutMaxCount(
+    "optimizer-many-lut-max-count",
+    llvm::cl::desc("Maximum number of lookup tables of the same input that "
+                   "the dag-multi optimizer evaluates with a single many-LUT "
+                   "bootstrap, 1 to bootstrap each of them"),
+    llvm::cl::init(optimizer::DEFAULT_MANY_LUT_MAX_COUNT));
+
+llvm::cl::opt<uint32_t> optimizerMaxGroupingFactor(
+    "optimizer-max-grouping-factor",
+    llvm::cl::desc("Largest grouping factor of the multi-bit bootstraps that "
+                   "the dag-multi optimizer may use with --emit-gpu-ops, 0 "
+                   "or 1 to only use classic bootstraps"),
+    llvm::cl::init(optimizer::DEFAULT_MAX_GROUPING_FACTOR));
+
+llvm::cl::opt<std::string> optimizerSolutionCacheDir(
+    "optimizer-solution-cache-dir",
+    llvm::cl::desc("Cache the solutions of the optimizer in this directory, "
+                   "keyed by the optimized circuits and the options of the "
+                   "optimization"),
+    llvm::cl::init(""));
+
+llvm::cl::list<std::string> optimizerSharedSolutionCacheDirs(
+    "optimizer-shared-solution-cache-dirs",
+    llvm::cl::desc("Look up the solutions of the optimizer in these "
+                   "directories after --optimizer-solution-cache-dir, without "
+                   "ever writing to them"),
+    llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated);
+
 llvm::cl::list<int64_t> fhelinalgTileSizes(
     "fhelinalg-tile-sizes",
     llvm::cl::desc(
         "Force tiling of FHELinalg operation with the given tile sizes"),
     llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated);
 
+llvm::cl::opt<bool> fhelinalgAutoTiling(
+    "fhelinalg-auto-tiling",
+    llvm::cl::desc("Tile the FHELinalg operations with tile sizes selected "
+                   "from a cost model, unless given by --fhelinalg-tile-sizes"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<int64_t> fhelinalgAutoTilingCores(
+    "fhelinalg-auto-tiling-cores",
+    llvm::cl::desc("Number of tiles processed concurrently by the automatic "
+                   "tiling, 0 for the number of hardware threads"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<int64_t> fhelinalgAutoTilingMinPbs(
+    "fhelinalg-auto-tiling-min-pbs",
+    llvm::cl::desc("Minimum number of PBS per tile of the automatic tiling"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<int64_t> fhelinalgAutoTilingMaxMemory(
+    "fhelinalg-auto-tiling-max-memory",
+    llvm::cl::desc("Maximum memory in bytes used by the ciphertexts of the "
+                   "tiles of an operation by the automatic tiling, 0 for no "
+                   "limit"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> fhelinalgTreeReduction(
+    "fhelinalg-tree-reduction",
+    llvm::cl::desc("Lower the FHELinalg sums, dot products and matrix "
+                   "multiplications to trees of additions"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> fhelinalgIm2colConv2d(
+    "fhelinalg-im2col-conv2d",
+    llvm::cl::desc("Lower the FHELinalg convolutions without groups to matrix "
+                   "multiplications on the patches of their input"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> fhelinalgMaxpool2dTree(
+    "fhelinalg-maxpool2d-tree",
+    llvm::cl::desc("Lower the FHELinalg maxpools to trees of maxima shared "
+                   "between the overlapping windows"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> fhelinalgMatMulSharedTLU(
+    "fhelinalg-matmul-shared-tlu",
+    llvm::cl::desc("Compute the encrypted by encrypted matrix "
+                   "multiplications with table lookups shared between the "
+                   "products of a same row or column"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> specializeConstantMatMul(
+    "specialize-constant-matmul",
+    llvm::cl::desc("Specialize the matrix multiplications by constant "
+                   "weights on the values of the weights"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> fuseTLUChains(
+    "fuse-tlu-chains",
+    llvm::cl::desc("Fuse the chains of table lookups and leveled operations "
+                   "by constants into single table lookups"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> narrowTLUInputs(
+    "narrow-tlu-inputs",
+    llvm::cl::desc("Lower the precision of the inputs of the table lookups "
+                   "to the bits their values are proven to use"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<unsigned> roundTLUMaxPrecision(
+    "round-tlu-max-precision",
+    llvm::cl::desc("Remove the last bits of the roundings with a single table "
+                   "lookup of at most this precision, 0 to round bit by bit"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<bool> roundTLUByCost(
+    "round-tlu-by-cost",
+    llvm::cl::desc("Choose the precision of the table lookups of the "
+                   "roundings from the complexity of the parameters found by "
+                   "the optimizer"),
+    llvm::cl::init(false));
+
 llvm::cl::list<size_t> v0Constraint(
     "v0-constraint",
     llvm::cl::desc(
@@ -412,18 +750,44 @@ cmdlineCompilationOptions() {
   options.autoParallelize = cmdline::autoParallelize;
   options.loopParallelize = cmdline::loopParallelize;
   options.dataflowParallelize = cmdline::dataflowParallelize;
+  options.dataflowMinTaskWork = cmdline::dataflowMinTaskWork;
+  options.dataflowUnrollFactor = cmdline::dataflowUnrollFactor;
+  options.dataflowThreadPolicy = cmdline::dataflowThreadPolicy;
+  options.dataflowThreads = cmdline::dataflowThreads;
+  options.asyncOffload = cmdline::asyncOffload;
+  options.destinationPassing = cmdline::destinationPassing;
   options.batchTFHEOps = cmdline::batchTFHEOps;
   options.maxBatchSize = cmdline::maxBatchSize;
   options.emitSDFGOps = cmdline::emitSDFGOps;
   options.unrollLoopsWithSDFGConvertibleOps =
       cmdline::unrollLoopsWithSDFGConvertibleOps;
+  options.sdfgLoopUnrollFactor = cmdline::sdfgLoopUnrollFactor;
   options.optimizeTFHE = cmdline::optimizeTFHE;
   options.simulate = cmdline::simulate;
   options.emitGPUOps = cmdline::emitGPUOps;
   options.compressEvaluationKeys = cmdline::compressEvaluationKeys;
+  options.compressOutputCiphertexts = cmdline::compressOutputCiphertexts;
+  options.compactFourierBootstrapKeys = cmdline::compactFourierBootstrapKeys;
   options.chunkIntegers = cmdline::chunkIntegers;
   options.chunkSize = cmdline::chunkSize;
   options.chunkWidth = cmdline::chunkWidth;
+  options.chunkCarryLookahead = cmdline::chunkCarryLookahead;
+  options.chunkIntegersByCost = cmdline::chunkIntegersByCost;
+  options.fuseBooleanGates = cmdline::fuseBooleanGates;
+  options.booleanGateFusionMaxInputs = cmdline::booleanGateFusionMaxInputs;
+  options.batchCrtBlocks = cmdline::batchCrtBlocks;
+  options.codegenThreads = cmdline::codegenThreads;
+  options.targetCpu = cmdline::targetCpu;
+  options.targetCpuVariants = cmdline::targetCpuVariants;
+  options.objectCacheDir = cmdline::objectCacheDir;
+  options.compilationProfile = cmdline::compilationProfile;
+  if (!cmdline::latencyCostTable.empty())
+    options.latencyCostTable = cmdline::latencyCostTable;
+  options.latencyTargetDevice = cmdline::latencyTargetDevice;
+  options.latencyTargetCores = cmdline::latencyTargetCores;
+  options.reuseBuffers = cmdline::reuseBuffers;
+  options.runtimeBitcode = cmdline::runtimeBitcode;
+  options.executionVariants = cmdline::executionVariants;
   options.skipProgramInfo = cmdline::skipProgramInfo;
 
   if (!cmdline::v0Constraint.empty()) {
@@ -440,6 +804,20 @@ cmdlineCompilationOptions() {
   if (!cmdline::fhelinalgTileSizes.empty())
     options.fhelinalgTileSizes.emplace(cmdline::fhelinalgTileSizes);
 
+  options.fhelinalgAutoTiling = cmdline::fhelinalgAutoTiling;
+  options.fhelinalgAutoTilingCores = cmdline::fhelinalgAutoTilingCores;
+  options.fhelinalgAutoTilingMinPbs = cmdline::fhelinalgAutoTilingMinPbs;
+  options.fhelinalgAutoTilingMaxMemory = cmdline::fhelinalgAutoTilingMaxMemory;
+  options.fhelinalgTreeReduction = cmdline::fhelinalgTreeReduction;
+  options.fhelinalgIm2colConv2d = cmdline::fhelinalgIm2colConv2d;
+  options.fhelinalgMaxpool2dTree = cmdline::fhelinalgMaxpool2dTree;
+  options.fhelinalgMatMulSharedTLU = cmdline::fhelinalgMatMulSharedTLU;
+  options.specializeConstantMatMul = cmdline::specializeConstantMatMul;
+  options.fuseTLUChains = cmdline::fuseTLUChains;
+  options.narrowTLUInputs = cmdline::narrowTLUInputs;
+  options.roundTLUMaxPrecision = cmdline::roundTLUMaxPrecision;
+  options.roundTLUByCost = cmdline::roundTLUByCost;
+
   // Setup the v0 parameter options
   if (!cmdline::v0Parameter.empty()) {
     if (cmdline::v0Parameter.size() != 7) {
@@ -500,6 +878,24 @@ cmdlineCompilationOptions() {
       cmdline::optimizerMultiParamStrategy;
   options.optimizerConfig.encoding = cmdline::optimizerEncoding;
   options.optimizerConfig.cache_on_disk = !cmdline::optimizerNoCacheOnDisk;
+  options.optimizerConfig.solution_cache_dir =
+      cmdline::optimizerSolutionCacheDir;
+  options.optimizerConfig.shared_solution_cache_dirs =
+      cmdline::optimizerSharedSolutionCacheDirs;
+  options.optimizerConfig.nb_threads = cmdline::optimizerThreads;
+  options.optimizerConfig.cost_model = cmdline::optimizerCostModel;
+  options.optimizerConfig.gpu_number_of_sm = cmdline::optimizerGpuNumberOfSm;
+  options.optimizerConfig.ks_cost_factor = cmdline::optimizerKsCostFactor;
+  options.optimizerConfig.pbs_cost_factor = cmdline::optimizerPbsCostFactor;
+  options.optimizerConfig.key_size_weight = cmdline::optimizerKeySizeWeight;
+  options.optimizerConfig.key_reuse_threshold =
+      cmdline::optimizerKeyReuseThreshold;
+  options.optimizerConfig.allow_pbs_ks_order =
+      cmdline::optimizerAllowPbsKsOrder;
+  options.optimizerConfig.many_lut_max_count =
+      cmdline::optimizerManyLutMaxCount;
+  options.optimizerConfig.max_grouping_factor =
+      cmdline::optimizerMaxGroupingFactor;
 
   if (!std::isnan(options.optimizerConfig.global_p_error) &&
       options.optimizerConfig.strategy == optimizer::Strategy::V0) {
@@ -0,0 +1,26 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --async-offload --skip-program-info %s 2>&1| FileCheck %s
+
+// The first bootstrap is offloaded as the second one does not depend on it,
+// the second one runs on the calling thread meanwhile
+// CHECK-LABEL: llvm.func @independent
+// CHECK: %[[FUT:.*]] = llvm.call @memref_bootstrap_async_lwe_u64
+// CHECK: llvm.call @memref_bootstrap_lwe_compact_u64
+// CHECK: llvm.call @memref_await_future({{.*}}%[[FUT]]
+// CHECK: llvm.call @memref_add_lwe_ciphertexts_u64
+func.func @independent(%arg0: tensor<576xi64>, %arg1: tensor<576xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%arg1, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %2 = "Concrete.add_lwe_tensor"(%0, %1) : (tensor<1025xi64>, tensor<1025xi64>) -> tensor<1025xi64>
+  return %2 : tensor<1025xi64>
+}
+
+// A single table lookup has nothing to overlap with
+// CHECK-LABEL: llvm.func @single
+// CHECK-NOT: memref_bootstrap_async_lwe_u64
+// CHECK: llvm.call @memref_bootstrap_lwe_compact_u64
+func.func @single(%arg0: tensor<576xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %0 : tensor<1025xi64>
+}
@@ -0,0 +1,30 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --skip-program-info %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: llvm.func @fused
+// CHECK-NOT: llvm.call @memref_batched_mul_cleartext_lwe_ciphertext_u64
+// CHECK: llvm.call @memref_batched_mul_cleartext_add_lwe_ciphertexts_u64
+// CHECK-NOT: llvm.call @memref_batched_add_lwe_ciphertexts_u64
+func.func @fused(%arg0: tensor<4x1025xi64>, %arg1: tensor<4xi64>, %arg2: tensor<4x1025xi64>) -> tensor<4x1025xi64> {
+  %0 = "Concrete.batched_mul_cleartext_lwe_tensor"(%arg0, %arg1) : (tensor<4x1025xi64>, tensor<4xi64>) -> tensor<4x1025xi64>
+  %1 = "Concrete.batched_add_lwe_tensor"(%arg2, %0) : (tensor<4x1025xi64>, tensor<4x1025xi64>) -> tensor<4x1025xi64>
+  return %1 : tensor<4x1025xi64>
+}
+
+// CHECK-LABEL: llvm.func @fused_cst
+// CHECK: llvm.call @memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64
+// CHECK-NOT: llvm.call @memref_batched_add_lwe_ciphertexts_u64
+func.func @fused_cst(%arg0: tensor<4x1025xi64>, %arg1: i64, %arg2: tensor<4x1025xi64>) -> tensor<4x1025xi64> {
+  %0 = "Concrete.batched_mul_cleartext_cst_lwe_tensor"(%arg0, %arg1) : (tensor<4x1025xi64>, i64) -> tensor<4x1025xi64>
+  %1 = "Concrete.batched_add_lwe_tensor"(%0, %arg2) : (tensor<4x1025xi64>, tensor<4x1025xi64>) -> tensor<4x1025xi64>
+  return %1 : tensor<4x1025xi64>
+}
+
+// The products are also returned, so they must be materialized
+// CHECK-LABEL: llvm.func @not_fused
+// CHECK: llvm.call @memref_batched_mul_cleartext_lwe_ciphertext_u64
+// CHECK: llvm.call @memref_batched_add_lwe_ciphertexts_u64
+func.func @not_fused(%arg0: tensor<4x1025xi64>, %arg1: tensor<4xi64>, %arg2: tensor<4x1025xi64>) -> (tensor<4x1025xi64>, tensor<4x1025xi64>) {
+  %0 = "Concrete.batched_mul_cleartext_lwe_tensor"(%arg0, %arg1) : (tensor<4x1025xi64>, tensor<4xi64>) -> tensor<4x1025xi64>
+  %1 = "Concrete.batched_add_lwe_tensor"(%arg2, %0) : (tensor<4x1025xi64>, tensor<4x1025xi64>) -> tensor<4x1025xi64>
+  return %0, %1 : tensor<4x1025xi64>, tensor<4x1025xi64>
+}
@@ -0,0 +1,8 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --skip-program-info %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: llvm.func @batched_wop_pbs
+// CHECK: llvm.call @memref_batched_wop_pbs_crt_buffer
+func.func @batched_wop_pbs(%arg0: tensor<4x2x1025xi64>, %arg1: tensor<2x4xi64>) -> tensor<4x2x1025xi64> {
+  %0 = "Concrete.batched_wop_pbs_crt_lwe_tensor"(%arg0, %arg1) {bootstrapBaseLog = 15 : i32, bootstrapLevel = 2 : i32, bskIndex = 0 : i32, circuitBootstrapBaseLog = 10 : i32, circuitBootstrapLevel = 2 : i32, crtDecomposition = [2, 3], keyswitchBaseLog = 2 : i32, keyswitchLevel = 5 : i32, kskIndex = 0 : i32, packingKeySwitchBaseLog = 15 : i32, packingKeySwitchInputLweDimension = 1024 : i32, packingKeySwitchLevel = 2 : i32, packingKeySwitchoutputPolynomialSize = 1024 : i32, pkskIndex = 0 : i32} : (tensor<4x2x1025xi64>, tensor<2x4xi64>) -> tensor<4x2x1025xi64>
+  return %0 : tensor<4x2x1025xi64>
+}
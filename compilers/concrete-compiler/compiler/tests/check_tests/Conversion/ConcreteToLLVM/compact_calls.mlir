@@ -0,0 +1,20 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --skip-program-info %s 2>&1| FileCheck %s
+
+// The parameters of both bootstraps are emitted once, and the wrapper passes
+// the descriptors by pointer to the runtime
+// CHECK: llvm.mlir.global private constant @[[PARAMS:.*]](dense<[575, 1024, 5, 2, 1, 0]> : tensor<6xi32>)
+// CHECK-NOT: dense<[575, 1024, 5, 2, 1, 0]>
+// CHECK-LABEL: llvm.func @two_bootstraps
+// CHECK: llvm.mlir.addressof @[[PARAMS]]
+// CHECK: llvm.call @memref_bootstrap_lwe_compact_u64
+// CHECK: llvm.mlir.addressof @[[PARAMS]]
+// CHECK: llvm.call @memref_bootstrap_lwe_compact_u64
+// CHECK: llvm.func @memref_bootstrap_lwe_compact_u64
+// CHECK: llvm.call @_mlir_ciface_memref_bootstrap_lwe_compact_u64
+func.func @two_bootstraps(%arg0: tensor<576xi64>, %arg1: tensor<576xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%arg1, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %2 = "Concrete.add_lwe_tensor"(%0, %1) : (tensor<1025xi64>, tensor<1025xi64>) -> tensor<1025xi64>
+  return %2 : tensor<1025xi64>
+}
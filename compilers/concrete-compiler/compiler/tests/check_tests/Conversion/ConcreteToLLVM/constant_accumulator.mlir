@@ -0,0 +1,28 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --skip-program-info %s 2>&1| FileCheck %s
+
+// A constant lookup table is turned into a constant accumulator at compile
+// time
+// CHECK-LABEL: llvm.func @constant_lut
+// CHECK: llvm.call @memref_bootstrap_lwe_with_accumulator_{{(compact_)?}}u64
+func.func @constant_lut(%arg0: tensor<576xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<1152921504606846976> : tensor<1024xi64>
+  %0 = "Concrete.bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<1024xi64>) -> tensor<1025xi64>
+  return %0 : tensor<1025xi64>
+}
+
+// CHECK-LABEL: llvm.func @batched_constant_lut
+// CHECK: llvm.call @memref_batched_bootstrap_lwe_with_accumulator_u64
+func.func @batched_constant_lut(%arg0: tensor<4x576xi64>) -> tensor<4x1025xi64> {
+  %cst = arith.constant dense<1152921504606846976> : tensor<1024xi64>
+  %0 = "Concrete.batched_bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32} : (tensor<4x576xi64>, tensor<1024xi64>) -> tensor<4x1025xi64>
+  return %0 : tensor<4x1025xi64>
+}
+
+// The lookup table is only known at execution time
+// CHECK-LABEL: llvm.func @dynamic_lut
+// CHECK-NOT: with_accumulator
+// CHECK: llvm.call @memref_bootstrap_lwe_{{(compact_)?}}u64
+func.func @dynamic_lut(%arg0: tensor<576xi64>, %arg1: tensor<1024xi64>) -> tensor<1025xi64> {
+  %0 = "Concrete.bootstrap_lwe_tensor"(%arg0, %arg1) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<1024xi64>) -> tensor<1025xi64>
+  return %0 : tensor<1025xi64>
+}
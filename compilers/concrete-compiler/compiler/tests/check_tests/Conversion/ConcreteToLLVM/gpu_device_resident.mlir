@@ -0,0 +1,47 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --emit-gpu-ops --skip-program-info %s 2>&1| FileCheck %s
+
+// The bootstrapped ciphertext only feeds the keyswitch, so it stays on the GPU
+// CHECK-LABEL: llvm.func @chain
+// CHECK: llvm.call @memref_keep_on_device_cuda_u64
+// CHECK-NEXT: llvm.call @memref_bootstrap_lwe_cuda_u64
+// CHECK-NOT: llvm.call @memref_copy_to_host_cuda_u64
+// CHECK: llvm.call @memref_keyswitch_lwe_cuda_u64
+// CHECK: llvm.call @memref_release_on_device_cuda_u64
+func.func @chain(%arg0: tensor<576xi64>) -> tensor<576xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  %1 = "Concrete.keyswitch_lwe_tensor"(%0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1024 : i32, lwe_dim_out = 575 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  return %1 : tensor<576xi64>
+}
+
+// The keyswitched ciphertext is also returned, so it is copied back once the
+// bootstrap consumed it
+// CHECK-LABEL: llvm.func @returned
+// CHECK: llvm.call @memref_keep_on_device_cuda_u64
+// CHECK-NEXT: llvm.call @memref_keyswitch_lwe_cuda_u64
+// CHECK: llvm.call @memref_bootstrap_lwe_cuda_u64
+// CHECK: llvm.call @memref_copy_to_host_cuda_u64
+func.func @returned(%arg0: tensor<1025xi64>) -> (tensor<576xi64>, tensor<1025xi64>) {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1024 : i32, lwe_dim_out = 575 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %0, %1 : tensor<576xi64>, tensor<1025xi64>
+}
+
+// The keyswitch reads the second bootstrapped ciphertext, at an offset in the
+// buffer of the batch, so the device copy is not used and the batch stays on
+// the host
+// CHECK-LABEL: llvm.func @offset_view
+// CHECK-NOT: llvm.call @memref_keep_on_device_cuda_u64
+// CHECK: llvm.call @memref_batched_bootstrap_lwe_cuda_u64
+// CHECK-NOT: llvm.call @memref_keep_on_device_cuda_u64
+// CHECK: llvm.call @memref_keyswitch_lwe_cuda_u64
+// CHECK-NOT: llvm.call @memref_release_on_device_cuda_u64
+// CHECK: llvm.return
+func.func @offset_view(%arg0: tensor<2x576xi64>) -> tensor<576xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.batched_bootstrap_lwe_tensor"(%arg0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32} : (tensor<2x576xi64>, tensor<4xi64>) -> tensor<2x1025xi64>
+  %1 = tensor.extract_slice %0[1, 0] [1, 1025] [1, 1] : tensor<2x1025xi64> to tensor<1025xi64>
+  %2 = "Concrete.keyswitch_lwe_tensor"(%1) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1024 : i32, lwe_dim_out = 575 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  return %2 : tensor<576xi64>
+}
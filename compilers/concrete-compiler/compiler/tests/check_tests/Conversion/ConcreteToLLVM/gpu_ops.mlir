@@ -1,7 +1,9 @@
 // RUN: concretecompiler --action=dump-llvm-dialect --emit-gpu-ops --skip-program-info %s 2>&1| FileCheck %s
 
-//CHECK: llvm.call @memref_keyswitch_lwe_cuda_u64
-//CHECK: llvm.call @memref_bootstrap_lwe_cuda_u64
+// The keyswitch feeding a bootstrap is fused with it
+//CHECK-NOT: llvm.call @memref_keyswitch_lwe_cuda_u64
+//CHECK: llvm.call @memref_keyswitch_bootstrap_lwe_cuda_u64
+//CHECK-NOT: llvm.call @memref_bootstrap_lwe_cuda_u64
 func.func @main(%arg0: tensor<1025xi64>) -> tensor<1025xi64> {
   %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
   %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1025 : i32, lwe_dim_out = 576 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
@@ -0,0 +1,65 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --skip-program-info %s 2>&1| FileCheck %s
+
+// The negation overwrites the sum, which is only used by it
+// CHECK-LABEL: llvm.func @in_place
+// CHECK: llvm.call @concrete_checked_malloc
+// CHECK-NOT: llvm.call @concrete_checked_malloc
+// CHECK: llvm.return
+func.func @in_place(%arg0: tensor<1025xi64>, %arg1: tensor<1025xi64>) -> tensor<1025xi64> {
+  %0 = "Concrete.add_lwe_tensor"(%arg0, %arg1) : (tensor<1025xi64>, tensor<1025xi64>) -> tensor<1025xi64>
+  %1 = "Concrete.negate_lwe_tensor"(%0) : (tensor<1025xi64>) -> tensor<1025xi64>
+  return %1 : tensor<1025xi64>
+}
+
+// The sum is also returned, so the negation needs its own buffer
+// CHECK-LABEL: llvm.func @out_of_place
+// CHECK: llvm.call @concrete_checked_malloc
+// CHECK: llvm.call @concrete_checked_malloc
+// CHECK: llvm.return
+func.func @out_of_place(%arg0: tensor<1025xi64>, %arg1: tensor<1025xi64>) -> (tensor<1025xi64>, tensor<1025xi64>) {
+  %0 = "Concrete.add_lwe_tensor"(%arg0, %arg1) : (tensor<1025xi64>, tensor<1025xi64>) -> tensor<1025xi64>
+  %1 = "Concrete.negate_lwe_tensor"(%0) : (tensor<1025xi64>) -> tensor<1025xi64>
+  return %0, %1 : tensor<1025xi64>, tensor<1025xi64>
+}
+
+// The sum is written directly in the row of the tensor it is inserted in
+// CHECK-LABEL: llvm.func @insert
+// CHECK: llvm.call @memref_add_lwe_ciphertexts_u64
+// CHECK-NOT: {{memrefCopy|llvm.intr.memcpy}}
+// CHECK: llvm.return
+func.func @insert(%arg0: tensor<1025xi64>, %arg1: tensor<1025xi64>) -> tensor<2x1025xi64> {
+  %t = bufferization.alloc_tensor() : tensor<2x1025xi64>
+  %0 = "Concrete.add_lwe_tensor"(%arg0, %arg1) : (tensor<1025xi64>, tensor<1025xi64>) -> tensor<1025xi64>
+  %1 = tensor.insert_slice %0 into %t[0, 0] [1, 1025] [1, 1] : tensor<1025xi64> into tensor<2x1025xi64>
+  return %1 : tensor<2x1025xi64>
+}
+
+// The concatenated batches are written in their slice of the result
+// CHECK-LABEL: llvm.func @concat
+// CHECK: llvm.call @memref_batched_add_lwe_ciphertexts_u64
+// CHECK: llvm.call @memref_batched_negate_lwe_ciphertext_u64
+// CHECK-NOT: {{memrefCopy|llvm.intr.memcpy}}
+// CHECK: llvm.return
+func.func @concat(%arg0: tensor<2x1025xi64>, %arg1: tensor<2x1025xi64>) -> tensor<4x1025xi64> {
+  %0 = "Concrete.batched_add_lwe_tensor"(%arg0, %arg1) : (tensor<2x1025xi64>, tensor<2x1025xi64>) -> tensor<2x1025xi64>
+  %1 = "Concrete.batched_negate_lwe_tensor"(%arg0) : (tensor<2x1025xi64>) -> tensor<2x1025xi64>
+  %2 = tensor.empty() : tensor<4x1025xi64>
+  %3 = tensor.insert_slice %0 into %2[0, 0] [2, 1025] [1, 1] : tensor<2x1025xi64> into tensor<4x1025xi64>
+  %4 = tensor.insert_slice %1 into %3[2, 0] [2, 1025] [1, 1] : tensor<2x1025xi64> into tensor<4x1025xi64>
+  return %4 : tensor<4x1025xi64>
+}
+
+// The batches concatenated along the second dimension are written row by row
+// CHECK-LABEL: llvm.func @concat_columns
+// CHECK: llvm.call @memref_batched_add_lwe_ciphertexts_u64
+// CHECK: llvm.call @memref_batched_negate_lwe_ciphertext_u64
+// CHECK-NOT: {{memrefCopy|llvm.intr.memcpy}}
+// CHECK: llvm.return
+func.func @concat_columns(%arg0: tensor<2x1025xi64>, %arg1: tensor<2x1025xi64>) -> tensor<2x2x1025xi64> {
+  %0 = "Concrete.batched_add_lwe_tensor"(%arg0, %arg1) : (tensor<2x1025xi64>, tensor<2x1025xi64>) -> tensor<2x1025xi64>
+  %1 = "Concrete.batched_negate_lwe_tensor"(%arg0) : (tensor<2x1025xi64>) -> tensor<2x1025xi64>
+  %2 = tensor.empty() : tensor<2x2x1025xi64>
+  %3 = tensor.insert_slice %0 into %2[0, 0, 0] [2, 1, 1025] [1, 1, 1] : tensor<2x1025xi64> into tensor<2x2x1025xi64>
+  %4 = tensor.insert_slice %1 into %3[0, 1, 0] [2, 1, 1025] [1, 1, 1] : tensor<2x1025xi64> into tensor<2x2x1025xi64>
+  return %4 : tensor<2x2x1025xi64>
+}
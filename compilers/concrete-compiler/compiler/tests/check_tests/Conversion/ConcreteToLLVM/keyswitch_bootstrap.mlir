@@ -0,0 +1,23 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --skip-program-info %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: llvm.func @fused
+// CHECK-NOT: llvm.call @memref_keyswitch_lwe_u64
+// CHECK: llvm.call @memref_keyswitch_bootstrap_lwe_compact_u64
+// CHECK-NOT: llvm.call @memref_bootstrap_lwe_compact_u64
+func.func @fused(%arg0: tensor<1025xi64>) -> tensor<1025xi64> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1024 : i32, lwe_dim_out = 575 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %1 : tensor<1025xi64>
+}
+
+// The keyswitched ciphertext is also returned, so it must be materialized
+// CHECK-LABEL: llvm.func @not_fused
+// CHECK: llvm.call @memref_keyswitch_lwe_compact_u64
+// CHECK: llvm.call @memref_bootstrap_lwe_compact_u64
+func.func @not_fused(%arg0: tensor<1025xi64>) -> (tensor<576xi64>, tensor<1025xi64>) {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, kskIndex = 0 : i32, level = 5 : i32, lwe_dim_in = 1024 : i32, lwe_dim_out = 575 : i32} : (tensor<1025xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%0, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %0, %1 : tensor<576xi64>, tensor<1025xi64>
+}
@@ -0,0 +1,16 @@
+// RUN: concretecompiler --action=dump-llvm-dialect --destination-passing --skip-program-info %s 2>&1| FileCheck %s
+
+// The sum is signaled as soon as it is written, before the bootstrap
+// computing the second output
+// CHECK-LABEL: llvm.func @two_outputs
+// CHECK: llvm.call @memref_add_lwe_ciphertexts_u64
+// CHECK: llvm.call @concrete_output_ready
+// CHECK: llvm.call @memref_bootstrap_lwe_compact_u64
+// CHECK: llvm.call @concrete_output_ready
+// CHECK: llvm.return
+func.func @two_outputs(%arg0: tensor<576xi64>, %arg1: tensor<576xi64>) -> (tensor<576xi64>, tensor<1025xi64>) {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+  %0 = "Concrete.add_lwe_tensor"(%arg0, %arg1) : (tensor<576xi64>, tensor<576xi64>) -> tensor<576xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%arg1, %cst) {baseLog = 2 : i32, bskIndex = 0 : i32, level = 5 : i32, polySize = 1024: i32, glweDimension = 1 : i32, inputLweDim = 575 : i32, outPrecision = 2 : i32} : (tensor<576xi64>, tensor<4xi64>) -> tensor<1025xi64>
+  return %0, %1 : tensor<576xi64>, tensor<1025xi64>
+}
@@ -3,15 +3,10 @@
 // -----
 
 // CHECK:      func.func @from_1d_into_1d(%[[input:.*]]: tensor<25x!FHE.eint<6>>, %[[indices:.*]]: tensor<3xindex>, %[[values:.*]]: tensor<3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]]) in (3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<25x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[index:.*]] = tensor.extract %[[indices]][%[[i]]] : tensor<3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]]] : tensor<3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index]]] [1] [1] : tensor<1x!FHE.eint<6>> into tensor<25x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
-// CHECK-NEXT:   return %[[output]] : tensor<25x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<3x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[values]] into %[[input]][%[[positions]]] scatter_dims([0]) unique : (tensor<3x!FHE.eint<6>>, tensor<25x!FHE.eint<6>>, tensor<3x1xi64>) -> tensor<25x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[scattered]] : tensor<25x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_1d_into_1d(%input: tensor<25x!FHE.eint<6>>, %indices: tensor<3xindex>, %values: tensor<3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_assign"(%input, %indices, %values) : (tensor<25x!FHE.eint<6>>, tensor<3xindex>, tensor<3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>>
@@ -21,15 +16,12 @@ func.func @from_1d_into_1d(%input: tensor<25x!FHE.eint<6>>, %indices: tensor<3xi
 // -----
 
 // CHECK:      func.func @from_2d_into_1d(%[[input:.*]]: tensor<25x!FHE.eint<6>>, %[[indices:.*]]: tensor<2x3xindex>, %[[values:.*]]: tensor<2x3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]], %[[j:.*]]) in (2, 3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<25x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[index:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]]] : tensor<2x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]], %[[j]]] : tensor<2x3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index]]] [1] [1] : tensor<1x!FHE.eint<6>> into tensor<25x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
-// CHECK-NEXT:   return %[[output]] : tensor<25x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat_values:.*]] = tensor.collapse_shape %[[values]] {{\[\[}}0, 1]] : tensor<2x3x!FHE.eint<6>> into tensor<6x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1], [2]] : tensor<2x3x1xi64> into tensor<6x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[flat_values]] into %[[input]][%[[collapsed]]] scatter_dims([0]) unique : (tensor<6x!FHE.eint<6>>, tensor<25x!FHE.eint<6>>, tensor<6x1xi64>) -> tensor<25x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[scattered]] : tensor<25x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_2d_into_1d(%input: tensor<25x!FHE.eint<6>>, %indices: tensor<2x3xindex>, %values: tensor<2x3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_assign"(%input, %indices, %values) : (tensor<25x!FHE.eint<6>>, tensor<2x3xindex>, tensor<2x3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>>
@@ -39,15 +31,12 @@ func.func @from_2d_into_1d(%input: tensor<25x!FHE.eint<6>>, %indices: tensor<2x3
 // -----
 
 // CHECK:      func.func @from_3d_into_1d(%[[input:.*]]: tensor<25x!FHE.eint<6>>, %[[indices:.*]]: tensor<4x2x3xindex>, %[[values:.*]]: tensor<4x2x3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]], %[[j:.*]], %[[k:.*]]) in (4, 2, 3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<25x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[index:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]]] : tensor<4x2x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]], %[[j]], %[[k]]] : tensor<4x2x3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index]]] [1] [1] : tensor<1x!FHE.eint<6>> into tensor<25x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
-// CHECK-NEXT:   return %[[output]] : tensor<25x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat_values:.*]] = tensor.collapse_shape %[[values]] {{\[\[}}0, 1, 2]] : tensor<4x2x3x!FHE.eint<6>> into tensor<24x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<4x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2], [3]] : tensor<4x2x3x1xi64> into tensor<24x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[flat_values]] into %[[input]][%[[collapsed]]] scatter_dims([0]) unique : (tensor<24x!FHE.eint<6>>, tensor<25x!FHE.eint<6>>, tensor<24x1xi64>) -> tensor<25x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[scattered]] : tensor<25x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_into_1d(%input: tensor<25x!FHE.eint<6>>, %indices: tensor<4x2x3xindex>, %values: tensor<4x2x3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_assign"(%input, %indices, %values) : (tensor<25x!FHE.eint<6>>, tensor<4x2x3xindex>, tensor<4x2x3x!FHE.eint<6>>) -> tensor<25x!FHE.eint<6>>
@@ -57,17 +46,11 @@ func.func @from_3d_into_1d(%input: tensor<25x!FHE.eint<6>>, %indices: tensor<4x2
 // -----
 
 // CHECK:      func.func @from_1d_into_2d(%[[input:.*]]: tensor<5x10x!FHE.eint<6>>, %[[indices:.*]]: tensor<3x2xindex>, %[[values:.*]]: tensor<3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]]) in (3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<5x10x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[c0]]] : tensor<3x2xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[c1]]] : tensor<3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]]] : tensor<3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index0]], %[[index1]]] [1, 1] [1, 1] : tensor<1x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
+// CHECK-NEXT:   %[[flat_input:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<5x10x!FHE.eint<6>> into tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<3x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[values]] into %[[flat_input]][%[[positions]]] scatter_dims([0]) unique : (tensor<3x!FHE.eint<6>>, tensor<50x!FHE.eint<6>>, tensor<3x1xi64>) -> tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[scattered]] {{\[\[}}0, 1]] : tensor<50x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<5x10x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_1d_into_2d(%input: tensor<5x10x!FHE.eint<6>>, %indices: tensor<3x2xindex>, %values: tensor<3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
@@ -78,17 +61,13 @@ func.func @from_1d_into_2d(%input: tensor<5x10x!FHE.eint<6>>, %indices: tensor<3
 // -----
 
 // CHECK:      func.func @from_2d_into_2d(%[[input:.*]]: tensor<5x10x!FHE.eint<6>>, %[[indices:.*]]: tensor<2x3x2xindex>, %[[values:.*]]: tensor<2x3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]], %[[j:.*]]) in (2, 3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<5x10x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c0]]] : tensor<2x3x2xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c1]]] : tensor<2x3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]], %[[j]]] : tensor<2x3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index0]], %[[index1]]] [1, 1] [1, 1] : tensor<1x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
+// CHECK-NEXT:   %[[flat_input:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<5x10x!FHE.eint<6>> into tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat_values:.*]] = tensor.collapse_shape %[[values]] {{\[\[}}0, 1]] : tensor<2x3x!FHE.eint<6>> into tensor<6x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1], [2]] : tensor<2x3x1xi64> into tensor<6x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[flat_values]] into %[[flat_input]][%[[collapsed]]] scatter_dims([0]) unique : (tensor<6x!FHE.eint<6>>, tensor<50x!FHE.eint<6>>, tensor<6x1xi64>) -> tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[scattered]] {{\[\[}}0, 1]] : tensor<50x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<5x10x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_2d_into_2d(%input: tensor<5x10x!FHE.eint<6>>, %indices: tensor<2x3x2xindex>, %values: tensor<2x3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
@@ -99,17 +78,13 @@ func.func @from_2d_into_2d(%input: tensor<5x10x!FHE.eint<6>>, %indices: tensor<2
 // -----
 
 // CHECK:      func.func @from_3d_into_2d(%[[input:.*]]: tensor<5x10x!FHE.eint<6>>, %[[indices:.*]]: tensor<6x2x3x2xindex>, %[[values:.*]]: tensor<6x2x3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]], %[[j:.*]], %[[k:.*]]) in (6, 2, 3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<5x10x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c0]]] : tensor<6x2x3x2xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c1]]] : tensor<6x2x3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]], %[[j]], %[[k]]] : tensor<6x2x3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index0]], %[[index1]]] [1, 1] [1, 1] : tensor<1x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
+// CHECK-NEXT:   %[[flat_input:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<5x10x!FHE.eint<6>> into tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat_values:.*]] = tensor.collapse_shape %[[values]] {{\[\[}}0, 1, 2]] : tensor<6x2x3x!FHE.eint<6>> into tensor<36x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2], [3]] : tensor<6x2x3x1xi64> into tensor<36x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[flat_values]] into %[[flat_input]][%[[collapsed]]] scatter_dims([0]) unique : (tensor<36x!FHE.eint<6>>, tensor<50x!FHE.eint<6>>, tensor<36x1xi64>) -> tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[scattered]] {{\[\[}}0, 1]] : tensor<50x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<5x10x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_into_2d(%input: tensor<5x10x!FHE.eint<6>>, %indices: tensor<6x2x3x2xindex>, %values: tensor<6x2x3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
@@ -120,22 +95,32 @@ func.func @from_3d_into_2d(%input: tensor<5x10x!FHE.eint<6>>, %indices: tensor<6
 // -----
 
 // CHECK:      func.func @from_4d_into_3d(%[[input:.*]]: tensor<20x5x2x!FHE.eint<6>>, %[[indices:.*]]: tensor<5x6x2x3x3xindex>, %[[values:.*]]: tensor<5x6x2x3x!FHE.eint<6>>) -> tensor<20x5x2x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = scf.forall (%[[i:.*]], %[[j:.*]], %[[k:.*]], %[[l:.*]]) in (5, 6, 2, 3) shared_outs(%[[result:.*]] = %[[input]]) -> (tensor<20x5x2x!FHE.eint<6>>) {
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c0]]] : tensor<5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c1]]] : tensor<5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[c2:.*]] = arith.constant 2 : index
-// CHECK-NEXT:     %[[index2:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c2]]] : tensor<5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[values]][%[[i]], %[[j]], %[[k]], %[[l]]] : tensor<5x6x2x3x!FHE.eint<6>>
-// CHECK-NEXT:     %[[element_slice:.*]] = tensor.from_elements %[[element]] : tensor<1x!FHE.eint<6>>
-// CHECK-NEXT:     scf.forall.in_parallel {
-// CHECK-NEXT:       tensor.parallel_insert_slice %[[element_slice]] into %[[result]][%[[index0]], %[[index1]], %[[index2]]] [1, 1, 1] [1, 1, 1] : tensor<1x!FHE.eint<6>> into tensor<20x5x2x!FHE.eint<6>>
-// CHECK-NEXT:     }
-// CHECK-NEXT:   }
+// CHECK-NEXT:   %[[flat_input:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1, 2]] : tensor<20x5x2x!FHE.eint<6>> into tensor<200x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat_values:.*]] = tensor.collapse_shape %[[values]] {{\[\[}}0, 1, 2, 3]] : tensor<5x6x2x3x!FHE.eint<6>> into tensor<180x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<5x6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2, 3], [4]] : tensor<5x6x2x3x1xi64> into tensor<180x1xi64>
+// CHECK-NEXT:   %[[scattered:.*]] = tensor.scatter %[[flat_values]] into %[[flat_input]][%[[collapsed]]] scatter_dims([0]) unique : (tensor<180x!FHE.eint<6>>, tensor<200x!FHE.eint<6>>, tensor<180x1xi64>) -> tensor<200x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[scattered]] {{\[\[}}0, 1, 2]] : tensor<200x!FHE.eint<6>> into tensor<20x5x2x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<20x5x2x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_4d_into_3d(%input: tensor<20x5x2x!FHE.eint<6>>, %indices: tensor<5x6x2x3x3xindex>, %values: tensor<5x6x2x3x!FHE.eint<6>>) -> tensor<20x5x2x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_assign"(%input, %indices, %values) : (tensor<20x5x2x!FHE.eint<6>>, tensor<5x6x2x3x3xindex>, tensor<5x6x2x3x!FHE.eint<6>>) -> tensor<20x5x2x!FHE.eint<6>>
   return %output : tensor<20x5x2x!FHE.eint<6>>
 }
+
+// -----
+
+// Evenly spaced constant indices are a strided insertion into the input
+
+// CHECK:      func.func @from_constant_strided(%[[input:.*]]: tensor<5x10x!FHE.eint<6>>, %[[values:.*]]: tensor<3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
+// CHECK:        %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<5x10x!FHE.eint<6>> into tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[inserted:.*]] = tensor.insert_slice %[[values]] into %[[flat]][2] [3] [10] : tensor<3x!FHE.eint<6>> into tensor<50x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[inserted]] {{\[\[}}0, 1]] : tensor<50x!FHE.eint<6>> into tensor<5x10x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[output]] : tensor<5x10x!FHE.eint<6>>
+// CHECK-NEXT: }
+func.func @from_constant_strided(%input: tensor<5x10x!FHE.eint<6>>, %values: tensor<3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>> {
+  %indices = arith.constant dense<[[0, 2], [1, 2], [2, 2]]> : tensor<3x2xindex>
+  %output = "FHELinalg.fancy_assign"(%input, %indices, %values) : (tensor<5x10x!FHE.eint<6>>, tensor<3x2xindex>, tensor<3x!FHE.eint<6>>) -> tensor<5x10x!FHE.eint<6>>
+  return %output : tensor<5x10x!FHE.eint<6>>
+}
@@ -3,13 +3,14 @@
 // -----
 
 // CHECK:      func.func @from_1d_to_1d(%[[input:.*]]: tensor<5x!FHE.eint<6>>, %[[indices:.*]]: tensor<3xindex>) -> tensor<3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index):
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index):
 // CHECK-NEXT:     %[[index:.*]] = tensor.extract %[[indices]][%[[i]]] : tensor<3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index]]] : tensor<5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<3x!FHE.eint<6>>
-// CHECK-NEXT:   return %[[output]] : tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:     %[[position:.*]] = arith.index_cast %[[index]] : index to i64
+// CHECK-NEXT:     tensor.yield %[[position]] : i64
+// CHECK-NEXT:   } : tensor<3x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[input]][%[[positions]]] gather_dims([0]) : (tensor<5x!FHE.eint<6>>, tensor<3x1xi64>) -> tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[gathered]] : tensor<3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_1d_to_1d(%input: tensor<5x!FHE.eint<6>>, %indices: tensor<3xindex>) -> tensor<3x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_index"(%input, %indices) : (tensor<5x!FHE.eint<6>>, tensor<3xindex>) -> tensor<3x!FHE.eint<6>>
@@ -19,12 +20,11 @@ func.func @from_1d_to_1d(%input: tensor<5x!FHE.eint<6>>, %indices: tensor<3xinde
 // -----
 
 // CHECK:      func.func @from_1d_to_2d(%[[input:.*]]: tensor<5x!FHE.eint<6>>, %[[indices:.*]]: tensor<2x3xindex>) -> tensor<2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index):
-// CHECK-NEXT:     %[[index:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]]] : tensor<2x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index]]] : tensor<5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1], [2]] : tensor<2x3x1xi64> into tensor<6x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[input]][%[[collapsed]]] gather_dims([0]) : (tensor<5x!FHE.eint<6>>, tensor<6x1xi64>) -> tensor<6x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1]] : tensor<6x!FHE.eint<6>> into tensor<2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_1d_to_2d(%input: tensor<5x!FHE.eint<6>>, %indices: tensor<2x3xindex>) -> tensor<2x3x!FHE.eint<6>> {
@@ -35,12 +35,11 @@ func.func @from_1d_to_2d(%input: tensor<5x!FHE.eint<6>>, %indices: tensor<2x3xin
 // -----
 
 // CHECK:      func.func @from_1d_to_3d(%[[input:.*]]: tensor<5x!FHE.eint<6>>, %[[indices:.*]]: tensor<4x2x3xindex>) -> tensor<4x2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index, %[[k:.*]]: index):
-// CHECK-NEXT:     %[[index:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]]] : tensor<4x2x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index]]] : tensor<5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<4x2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<4x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2], [3]] : tensor<4x2x3x1xi64> into tensor<24x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[input]][%[[collapsed]]] gather_dims([0]) : (tensor<5x!FHE.eint<6>>, tensor<24x1xi64>) -> tensor<24x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1, 2]] : tensor<24x!FHE.eint<6>> into tensor<4x2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<4x2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_1d_to_3d(%input: tensor<5x!FHE.eint<6>>, %indices: tensor<4x2x3xindex>) -> tensor<4x2x3x!FHE.eint<6>> {
@@ -51,16 +50,21 @@ func.func @from_1d_to_3d(%input: tensor<5x!FHE.eint<6>>, %indices: tensor<4x2x3x
 // -----
 
 // CHECK:      func.func @from_2d_to_1d(%[[input:.*]]: tensor<4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<3x2xindex>) -> tensor<3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index):
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<4x5x!FHE.eint<6>> into tensor<20x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index):
 // CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
 // CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[c0]]] : tensor<3x2xindex>
 // CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
 // CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[c1]]] : tensor<3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]]] : tensor<4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<3x!FHE.eint<6>>
-// CHECK-NEXT:   return %[[output]] : tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:     %[[c5:.*]] = arith.constant 5 : index
+// CHECK-NEXT:     %[[row:.*]] = arith.muli %[[index0]], %[[c5]] : index
+// CHECK-NEXT:     %[[sum:.*]] = arith.addi %[[row]], %[[index1]] : index
+// CHECK-NEXT:     %[[position:.*]] = arith.index_cast %[[sum]] : index to i64
+// CHECK-NEXT:     tensor.yield %[[position]] : i64
+// CHECK-NEXT:   } : tensor<3x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[positions]]] gather_dims([0]) : (tensor<20x!FHE.eint<6>>, tensor<3x1xi64>) -> tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[gathered]] : tensor<3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_2d_to_1d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<3x2xindex>) -> tensor<3x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_index"(%input, %indices) : (tensor<4x5x!FHE.eint<6>>, tensor<3x2xindex>) -> tensor<3x!FHE.eint<6>>
@@ -70,15 +74,12 @@ func.func @from_2d_to_1d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<3x2x
 // -----
 
 // CHECK:      func.func @from_2d_to_2d(%[[input:.*]]: tensor<4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<2x3x2xindex>) -> tensor<2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c0]]] : tensor<2x3x2xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c1]]] : tensor<2x3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]]] : tensor<4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<4x5x!FHE.eint<6>> into tensor<20x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1], [2]] : tensor<2x3x1xi64> into tensor<6x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<20x!FHE.eint<6>>, tensor<6x1xi64>) -> tensor<6x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1]] : tensor<6x!FHE.eint<6>> into tensor<2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_2d_to_2d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<2x3x2xindex>) -> tensor<2x3x!FHE.eint<6>> {
@@ -89,15 +90,12 @@ func.func @from_2d_to_2d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<2x3x
 // -----
 
 // CHECK:      func.func @from_2d_to_3d(%[[input:.*]]: tensor<4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<6x2x3x2xindex>) -> tensor<6x2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index, %[[k:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c0]]] : tensor<6x2x3x2xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c1]]] : tensor<6x2x3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]]] : tensor<4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<6x2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<4x5x!FHE.eint<6>> into tensor<20x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2], [3]] : tensor<6x2x3x1xi64> into tensor<36x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<20x!FHE.eint<6>>, tensor<36x1xi64>) -> tensor<36x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1, 2]] : tensor<36x!FHE.eint<6>> into tensor<6x2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<6x2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_2d_to_3d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<6x2x3x2xindex>) -> tensor<6x2x3x!FHE.eint<6>> {
@@ -108,15 +106,12 @@ func.func @from_2d_to_3d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<6x2x
 // -----
 
 // CHECK:      func.func @from_2d_to_4d(%[[input:.*]]: tensor<4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<5x6x2x3x2xindex>) -> tensor<5x6x2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index, %[[k:.*]]: index, %[[l:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c0]]] : tensor<5x6x2x3x2xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c1]]] : tensor<5x6x2x3x2xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]]] : tensor<4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<5x6x2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<4x5x!FHE.eint<6>> into tensor<20x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<5x6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2, 3], [4]] : tensor<5x6x2x3x1xi64> into tensor<180x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<20x!FHE.eint<6>>, tensor<180x1xi64>) -> tensor<180x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1, 2, 3]] : tensor<180x!FHE.eint<6>> into tensor<5x6x2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<5x6x2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_2d_to_4d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<5x6x2x3x2xindex>) -> tensor<5x6x2x3x!FHE.eint<6>> {
@@ -127,18 +122,11 @@ func.func @from_2d_to_4d(%input: tensor<4x5x!FHE.eint<6>>, %indices: tensor<5x6x
 // -----
 
 // CHECK:      func.func @from_3d_to_1d(%[[input:.*]]: tensor<2x4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<3x3xindex>) -> tensor<3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[c0]]] : tensor<3x3xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[c1]]] : tensor<3x3xindex>
-// CHECK-NEXT:     %[[c2:.*]] = arith.constant 2 : index
-// CHECK-NEXT:     %[[index2:.*]] = tensor.extract %[[indices]][%[[i]], %[[c2]]] : tensor<3x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]], %[[index2]]] : tensor<2x4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<3x!FHE.eint<6>>
-// CHECK-NEXT:   return %[[output]] : tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1, 2]] : tensor<2x4x5x!FHE.eint<6>> into tensor<40x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<3x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[positions]]] gather_dims([0]) : (tensor<40x!FHE.eint<6>>, tensor<3x1xi64>) -> tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[gathered]] : tensor<3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_to_1d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<3x3xindex>) -> tensor<3x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_index"(%input, %indices) : (tensor<2x4x5x!FHE.eint<6>>, tensor<3x3xindex>) -> tensor<3x!FHE.eint<6>>
@@ -148,17 +136,12 @@ func.func @from_3d_to_1d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<3x
 // -----
 
 // CHECK:      func.func @from_3d_to_2d(%[[input:.*]]: tensor<2x4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<2x3x3xindex>) -> tensor<2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c0]]] : tensor<2x3x3xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c1]]] : tensor<2x3x3xindex>
-// CHECK-NEXT:     %[[c2:.*]] = arith.constant 2 : index
-// CHECK-NEXT:     %[[index2:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[c2]]] : tensor<2x3x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]], %[[index2]]] : tensor<2x4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1, 2]] : tensor<2x4x5x!FHE.eint<6>> into tensor<40x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1], [2]] : tensor<2x3x1xi64> into tensor<6x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<40x!FHE.eint<6>>, tensor<6x1xi64>) -> tensor<6x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1]] : tensor<6x!FHE.eint<6>> into tensor<2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_to_2d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<2x3x3xindex>) -> tensor<2x3x!FHE.eint<6>> {
@@ -169,17 +152,12 @@ func.func @from_3d_to_2d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<2x
 // -----
 
 // CHECK:      func.func @from_3d_to_3d(%[[input:.*]]: tensor<2x4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<6x2x3x3xindex>) -> tensor<6x2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index, %[[k:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c0]]] : tensor<6x2x3x3xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c1]]] : tensor<6x2x3x3xindex>
-// CHECK-NEXT:     %[[c2:.*]] = arith.constant 2 : index
-// CHECK-NEXT:     %[[index2:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[c2]]] : tensor<6x2x3x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]], %[[index2]]] : tensor<2x4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<6x2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1, 2]] : tensor<2x4x5x!FHE.eint<6>> into tensor<40x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2], [3]] : tensor<6x2x3x1xi64> into tensor<36x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<40x!FHE.eint<6>>, tensor<36x1xi64>) -> tensor<36x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1, 2]] : tensor<36x!FHE.eint<6>> into tensor<6x2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<6x2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_to_3d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<6x2x3x3xindex>) -> tensor<6x2x3x!FHE.eint<6>> {
@@ -190,17 +168,12 @@ func.func @from_3d_to_3d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<6x
 // -----
 
 // CHECK:      func.func @from_3d_to_4d(%[[input:.*]]: tensor<2x4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<5x6x2x3x3xindex>) -> tensor<5x6x2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index, %[[k:.*]]: index, %[[l:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c0]]] : tensor<5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c1]]] : tensor<5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[c2:.*]] = arith.constant 2 : index
-// CHECK-NEXT:     %[[index2:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[c2]]] : tensor<5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]], %[[index2]]] : tensor<2x4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<5x6x2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1, 2]] : tensor<2x4x5x!FHE.eint<6>> into tensor<40x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<5x6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2, 3], [4]] : tensor<5x6x2x3x1xi64> into tensor<180x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<40x!FHE.eint<6>>, tensor<180x1xi64>) -> tensor<180x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1, 2, 3]] : tensor<180x!FHE.eint<6>> into tensor<5x6x2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<5x6x2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_to_4d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<5x6x2x3x3xindex>) -> tensor<5x6x2x3x!FHE.eint<6>> {
@@ -211,20 +184,40 @@ func.func @from_3d_to_4d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<5x
 // -----
 
 // CHECK:      func.func @from_3d_to_5d(%[[input:.*]]: tensor<2x4x5x!FHE.eint<6>>, %[[indices:.*]]: tensor<4x5x6x2x3x3xindex>) -> tensor<4x5x6x2x3x!FHE.eint<6>> {
-// CHECK-NEXT:   %[[output:.*]] = tensor.generate  {
-// CHECK-NEXT:   ^bb0(%[[i:.*]]: index, %[[j:.*]]: index, %[[k:.*]]: index, %[[l:.*]]: index, %[[m:.*]]: index):
-// CHECK-NEXT:     %[[c0:.*]] = arith.constant 0 : index
-// CHECK-NEXT:     %[[index0:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[m]], %[[c0]]] : tensor<4x5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[c1:.*]] = arith.constant 1 : index
-// CHECK-NEXT:     %[[index1:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[m]], %[[c1]]] : tensor<4x5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[c2:.*]] = arith.constant 2 : index
-// CHECK-NEXT:     %[[index2:.*]] = tensor.extract %[[indices]][%[[i]], %[[j]], %[[k]], %[[l]], %[[m]], %[[c2]]] : tensor<4x5x6x2x3x3xindex>
-// CHECK-NEXT:     %[[element:.*]] = tensor.extract %[[input]][%[[index0]], %[[index1]], %[[index2]]] : tensor<2x4x5x!FHE.eint<6>>
-// CHECK-NEXT:     tensor.yield %[[element]] : !FHE.eint<6>
-// CHECK-NEXT:   } : tensor<4x5x6x2x3x!FHE.eint<6>>
+// CHECK-NEXT:   %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1, 2]] : tensor<2x4x5x!FHE.eint<6>> into tensor<40x!FHE.eint<6>>
+// CHECK-NEXT:   %[[positions:.*]] = tensor.generate  {
+// CHECK:        } : tensor<4x5x6x2x3x1xi64>
+// CHECK-NEXT:   %[[collapsed:.*]] = tensor.collapse_shape %[[positions]] {{\[\[}}0, 1, 2, 3, 4], [5]] : tensor<4x5x6x2x3x1xi64> into tensor<720x1xi64>
+// CHECK-NEXT:   %[[gathered:.*]] = tensor.gather %[[flat]][%[[collapsed]]] gather_dims([0]) : (tensor<40x!FHE.eint<6>>, tensor<720x1xi64>) -> tensor<720x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.expand_shape %[[gathered]] {{\[\[}}0, 1, 2, 3, 4]] : tensor<720x!FHE.eint<6>> into tensor<4x5x6x2x3x!FHE.eint<6>>
 // CHECK-NEXT:   return %[[output]] : tensor<4x5x6x2x3x!FHE.eint<6>>
 // CHECK-NEXT: }
 func.func @from_3d_to_5d(%input: tensor<2x4x5x!FHE.eint<6>>, %indices: tensor<4x5x6x2x3x3xindex>) -> tensor<4x5x6x2x3x!FHE.eint<6>> {
   %output = "FHELinalg.fancy_index"(%input, %indices) : (tensor<2x4x5x!FHE.eint<6>>, tensor<4x5x6x2x3x3xindex>) -> tensor<4x5x6x2x3x!FHE.eint<6>>
   return %output : tensor<4x5x6x2x3x!FHE.eint<6>>
 }
+
+// -----
+
+// Evenly spaced constant indices are a strided view of the input
+
+// CHECK:      func.func @from_constant_strided(%[[input:.*]]: tensor<4x5x!FHE.eint<6>>) -> tensor<3x!FHE.eint<6>> {
+// CHECK:        %[[flat:.*]] = tensor.collapse_shape %[[input]] {{\[\[}}0, 1]] : tensor<4x5x!FHE.eint<6>> into tensor<20x!FHE.eint<6>>
+// CHECK-NEXT:   %[[output:.*]] = tensor.extract_slice %[[flat]][1] [3] [4] : tensor<20x!FHE.eint<6>> to tensor<3x!FHE.eint<6>>
+// CHECK-NEXT:   return %[[output]] : tensor<3x!FHE.eint<6>>
+// CHECK-NEXT: }
+func.func @from_constant_strided(%input: tensor<4x5x!FHE.eint<6>>) -> tensor<3x!FHE.eint<6>> {
+  %indices = arith.constant dense<[[0, 1], [1, 0], [1, 4]]> : tensor<3x2xindex>
+  %output = "FHELinalg.fancy_index"(%input, %indices) : (tensor<4x5x!FHE.eint<6>>, tensor<3x2xindex>) -> tensor<3x!FHE.eint<6>>
+  return %output : tensor<3x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK:      func.func @from_constant_unordered(%[[input:.*]]: tensor<5x!FHE.eint<6>>) -> tensor<3x!FHE.eint<6>> {
+// CHECK:        tensor.gather %[[input]]
+func.func @from_constant_unordered(%input: tensor<5x!FHE.eint<6>>) -> tensor<3x!FHE.eint<6>> {
+  %indices = arith.constant dense<[3, 1, 2]> : tensor<3xindex>
+  %output = "FHELinalg.fancy_index"(%input, %indices) : (tensor<5x!FHE.eint<6>>, tensor<3xindex>) -> tensor<3x!FHE.eint<6>>
+  return %output : tensor<3x!FHE.eint<6>>
+}
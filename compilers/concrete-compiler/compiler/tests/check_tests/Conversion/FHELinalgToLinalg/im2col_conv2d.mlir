@@ -0,0 +1,22 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --fhelinalg-im2col-conv2d %s 2>&1 | FileCheck %s
+
+// CHECK-DAG: #[[PATCHES:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d4 * 2 + d2, d5 * 2 + d3)>
+// CHECK-DAG: #[[LHS:.*]] = affine_map<(d0, d1, d2, d3) -> (d0, d3, d2)>
+// CHECK-DAG: #[[RHS:.*]] = affine_map<(d0, d1, d2, d3) -> (d1, d3)>
+// CHECK-DAG: #[[OUT:.*]] = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2)>
+
+// CHECK-LABEL: func.func @conv2d
+// CHECK:      %[[V0:.*]] = linalg.generic {indexing_maps = [#[[PATCHES]], #{{.*}}], iterator_types = ["parallel", "parallel", "parallel", "parallel", "parallel", "parallel"]} ins(%{{.*}} : tensor<1x2x4x4x!FHE.eint<6>>) outs(%{{.*}} : tensor<1x2x2x2x2x2x!FHE.eint<6>>)
+// CHECK:      %[[V1:.*]] = tensor.collapse_shape %[[V0]] {{\[\[}}0], [1, 2, 3], [4, 5]] : tensor<1x2x2x2x2x2x!FHE.eint<6>> into tensor<1x8x4x!FHE.eint<6>>
+// CHECK-NEXT: %[[V2:.*]] = tensor.collapse_shape %[[W:.*]] {{\[\[}}0], [1, 2, 3]] : tensor<3x2x2x2xi7> into tensor<3x8xi7>
+// CHECK-NEXT: %[[V3:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0], [1], [2, 3]] : tensor<1x3x2x2x!FHE.eint<6>> into tensor<1x3x4x!FHE.eint<6>>
+// CHECK-NEXT: %[[V4:.*]] = linalg.generic {indexing_maps = [#[[LHS]], #[[RHS]], #[[OUT]]], iterator_types = ["parallel", "parallel", "parallel", "reduction"]} ins(%[[V1]], %[[V2]] : tensor<1x8x4x!FHE.eint<6>>, tensor<3x8xi7>) outs(%[[V3]] : tensor<1x3x4x!FHE.eint<6>>)
+// CHECK:        "FHE.mul_eint_int"
+// CHECK:        "FHE.add_eint"
+// CHECK:      tensor.expand_shape %[[V4]] {{\[\[}}0], [1], [2, 3]] : tensor<1x3x4x!FHE.eint<6>> into tensor<1x3x2x2x!FHE.eint<6>>
+func.func @conv2d(%input: tensor<1x2x4x4x!FHE.eint<6>>, %weight: tensor<3x2x2x2xi7>) -> tensor<1x3x2x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.conv2d"(%input, %weight){
+    strides = dense<[2,2]> : tensor<2xi64>, dilations = dense<[1,1]> : tensor<2xi64>, padding = dense<[0,0,0,0]> : tensor<4xi64>
+  } : (tensor<1x2x4x4x!FHE.eint<6>>, tensor<3x2x2x2xi7>) -> tensor<1x3x2x2x!FHE.eint<6>>
+  return %0 : tensor<1x3x2x2x!FHE.eint<6>>
+}
@@ -0,0 +1,40 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --fhelinalg-maxpool2d-tree %s 2>&1 | FileCheck %s
+
+// The maxima of the rows of the overlapping windows are shared
+// CHECK-LABEL: func.func @overlapping
+// CHECK:         %[[R0:.*]] = tensor.extract_slice %arg0[0, 0, 0, 0] [1, 1, 4, 2] [1, 1, 1, 1] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x4x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[R1:.*]] = tensor.extract_slice %arg0[0, 0, 0, 1] [1, 1, 4, 2] [1, 1, 1, 1] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x4x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[R2:.*]] = tensor.extract_slice %arg0[0, 0, 0, 2] [1, 1, 4, 2] [1, 1, 1, 1] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x4x2x!FHE.eint<5>>
+// CHECK:         %[[M0:.*]] = linalg.generic {{.*}} ins(%[[R0]], %[[R1]] : tensor<1x1x4x2x!FHE.eint<5>>, tensor<1x1x4x2x!FHE.eint<5>>)
+// CHECK:           "FHE.max_eint"
+// CHECK:         %[[M1:.*]] = linalg.generic {{.*}} ins(%[[M0]], %[[R2]] : tensor<1x1x4x2x!FHE.eint<5>>, tensor<1x1x4x2x!FHE.eint<5>>)
+// CHECK:           "FHE.max_eint"
+// CHECK:         %[[C0:.*]] = tensor.extract_slice %[[M1]][0, 0, 0, 0] [1, 1, 2, 2] [1, 1, 1, 1] : tensor<1x1x4x2x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[C1:.*]] = tensor.extract_slice %[[M1]][0, 0, 1, 0] [1, 1, 2, 2] [1, 1, 1, 1] : tensor<1x1x4x2x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[C2:.*]] = tensor.extract_slice %[[M1]][0, 0, 2, 0] [1, 1, 2, 2] [1, 1, 1, 1] : tensor<1x1x4x2x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK:         %[[M2:.*]] = linalg.generic {{.*}} ins(%[[C0]], %[[C1]] : tensor<1x1x2x2x!FHE.eint<5>>, tensor<1x1x2x2x!FHE.eint<5>>)
+// CHECK:           "FHE.max_eint"
+// CHECK:         %[[M3:.*]] = linalg.generic {{.*}} ins(%[[M2]], %[[C2]] : tensor<1x1x2x2x!FHE.eint<5>>, tensor<1x1x2x2x!FHE.eint<5>>)
+// CHECK:           "FHE.max_eint"
+// CHECK:         return %[[M3]] : tensor<1x1x2x2x!FHE.eint<5>>
+func.func @overlapping(%arg0: tensor<1x1x4x4x!FHE.eint<5>>) -> tensor<1x1x2x2x!FHE.eint<5>> {
+  %0 = "FHELinalg.maxpool2d"(%arg0) { kernel_shape = dense<[3, 3]> : tensor<2xi64> } : (tensor<1x1x4x4x!FHE.eint<5>>) -> tensor<1x1x2x2x!FHE.eint<5>>
+  return %0 : tensor<1x1x2x2x!FHE.eint<5>>
+}
+
+// -----
+
+// The windows which do not overlap are reduced by a single tree
+// CHECK-LABEL: func.func @disjoint
+// CHECK:         %[[S0:.*]] = tensor.extract_slice %arg0[0, 0, 0, 0] [1, 1, 2, 2] [1, 1, 2, 2] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[S1:.*]] = tensor.extract_slice %arg0[0, 0, 0, 1] [1, 1, 2, 2] [1, 1, 2, 2] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[S2:.*]] = tensor.extract_slice %arg0[0, 0, 1, 0] [1, 1, 2, 2] [1, 1, 2, 2] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK-NEXT:    %[[S3:.*]] = tensor.extract_slice %arg0[0, 0, 1, 1] [1, 1, 2, 2] [1, 1, 2, 2] : tensor<1x1x4x4x!FHE.eint<5>> to tensor<1x1x2x2x!FHE.eint<5>>
+// CHECK:         %[[M0:.*]] = linalg.generic {{.*}} ins(%[[S0]], %[[S1]] : {{.*}})
+// CHECK:         %[[M1:.*]] = linalg.generic {{.*}} ins(%[[S2]], %[[S3]] : {{.*}})
+// CHECK:         %[[M2:.*]] = linalg.generic {{.*}} ins(%[[M0]], %[[M1]] : {{.*}})
+// CHECK:         return %[[M2]] : tensor<1x1x2x2x!FHE.eint<5>>
+func.func @disjoint(%arg0: tensor<1x1x4x4x!FHE.eint<5>>) -> tensor<1x1x2x2x!FHE.eint<5>> {
+  %0 = "FHELinalg.maxpool2d"(%arg0) { kernel_shape = dense<[2, 2]> : tensor<2xi64>, strides = dense<[2, 2]> : tensor<2xi64> } : (tensor<1x1x4x4x!FHE.eint<5>>) -> tensor<1x1x2x2x!FHE.eint<5>>
+  return %0 : tensor<1x1x2x2x!FHE.eint<5>>
+}
@@ -0,0 +1,62 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --fhelinalg-tree-reduction %s 2>&1 | FileCheck %s
+
+// CHECK-LABEL: func.func @sum
+// CHECK:      %[[V0:.*]] = tensor.extract_slice %[[A:.*]][0] [2] [1] : tensor<5x!FHE.eint<7>> to tensor<2x!FHE.eint<7>>
+// CHECK-NEXT: %[[V1:.*]] = tensor.extract_slice %[[A]][3] [2] [1] : tensor<5x!FHE.eint<7>> to tensor<2x!FHE.eint<7>>
+// CHECK:      %[[V2:.*]] = linalg.generic {{.*}}iterator_types = ["parallel"]} ins(%[[V0]], %[[V1]] : tensor<2x!FHE.eint<7>>, tensor<2x!FHE.eint<7>>)
+// CHECK:        "FHE.add_eint"
+// CHECK:      %[[V3:.*]] = tensor.extract_slice %[[A]][0] [3] [1] : tensor<5x!FHE.eint<7>> to tensor<3x!FHE.eint<7>>
+// CHECK-NEXT: %[[V4:.*]] = tensor.insert_slice %[[V2]] into %[[V3]][0] [2] [1] : tensor<2x!FHE.eint<7>> into tensor<3x!FHE.eint<7>>
+// CHECK:      linalg.generic {{.*}}iterator_types = ["parallel"]} ins({{.*}} : tensor<1x!FHE.eint<7>>, tensor<1x!FHE.eint<7>>)
+// CHECK:      tensor.insert_slice {{.*}} : tensor<1x!FHE.eint<7>> into tensor<2x!FHE.eint<7>>
+// CHECK:      %[[V5:.*]] = linalg.generic {{.*}}iterator_types = ["parallel"]} ins({{.*}} : tensor<1x!FHE.eint<7>>, tensor<1x!FHE.eint<7>>)
+// CHECK-NOT:  "reduction"
+// CHECK:      tensor.extract %[[V5]][%{{.*}}] : tensor<1x!FHE.eint<7>>
+func.func @sum(%a: tensor<5x!FHE.eint<7>>) -> !FHE.eint<7> {
+  %0 = "FHELinalg.sum"(%a) : (tensor<5x!FHE.eint<7>>) -> !FHE.eint<7>
+  return %0 : !FHE.eint<7>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @sum_axis
+// CHECK:      tensor.extract_slice %[[A:.*]][0, 0] [3, 1] [1, 1] : tensor<3x2x!FHE.eint<7>> to tensor<3x1x!FHE.eint<7>>
+// CHECK-NEXT: tensor.extract_slice %[[A]][0, 1] [3, 1] [1, 1] : tensor<3x2x!FHE.eint<7>> to tensor<3x1x!FHE.eint<7>>
+// CHECK:      %[[V0:.*]] = linalg.generic {{.*}}iterator_types = ["parallel", "parallel"]}
+// CHECK:      tensor.collapse_shape %[[V0]] {{\[\[}}0, 1]] : tensor<3x1x!FHE.eint<7>> into tensor<3x!FHE.eint<7>>
+func.func @sum_axis(%a: tensor<3x2x!FHE.eint<7>>) -> tensor<3x!FHE.eint<7>> {
+  %0 = "FHELinalg.sum"(%a) { axes = [1] } : (tensor<3x2x!FHE.eint<7>>) -> tensor<3x!FHE.eint<7>>
+  return %0 : tensor<3x!FHE.eint<7>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @dot
+// CHECK:      %[[V0:.*]] = linalg.generic {{.*}}iterator_types = ["parallel"]} ins(%[[A:.*]], %[[B:.*]] : tensor<4x!FHE.eint<7>>, tensor<4xi8>)
+// CHECK:        "FHE.mul_eint_int"
+// CHECK:      tensor.extract_slice %[[V0]][0] [2] [1] : tensor<4x!FHE.eint<7>> to tensor<2x!FHE.eint<7>>
+// CHECK-NEXT: tensor.extract_slice %[[V0]][2] [2] [1] : tensor<4x!FHE.eint<7>> to tensor<2x!FHE.eint<7>>
+// CHECK:      linalg.generic {{.*}}iterator_types = ["parallel"]}
+// CHECK:        "FHE.add_eint"
+// CHECK:      %[[V1:.*]] = linalg.generic {{.*}}iterator_types = ["parallel"]}
+// CHECK:        "FHE.add_eint"
+// CHECK:      tensor.extract %[[V1]][%{{.*}}] : tensor<1x!FHE.eint<7>>
+func.func @dot(%a: tensor<4x!FHE.eint<7>>, %b: tensor<4xi8>) -> !FHE.eint<7> {
+  %0 = "FHELinalg.dot_eint_int"(%a, %b) : (tensor<4x!FHE.eint<7>>, tensor<4xi8>) -> !FHE.eint<7>
+  return %0 : !FHE.eint<7>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @matmul
+// CHECK:      %[[V0:.*]] = linalg.generic {{.*}}iterator_types = ["parallel", "parallel", "parallel"]} ins(%[[A:.*]], %[[B:.*]] : tensor<2x4x!FHE.eint<7>>, tensor<4x3xi8>) outs(%{{.*}} : tensor<2x3x4x!FHE.eint<7>>)
+// CHECK:        "FHE.mul_eint_int"
+// CHECK:      tensor.extract_slice %[[V0]][0, 0, 0] [2, 3, 2] [1, 1, 1] : tensor<2x3x4x!FHE.eint<7>> to tensor<2x3x2x!FHE.eint<7>>
+// CHECK-NEXT: tensor.extract_slice %[[V0]][0, 0, 2] [2, 3, 2] [1, 1, 1] : tensor<2x3x4x!FHE.eint<7>> to tensor<2x3x2x!FHE.eint<7>>
+// CHECK:      linalg.generic
+// CHECK:      %[[V1:.*]] = linalg.generic {{.*}} -> tensor<2x3x1x!FHE.eint<7>>
+// CHECK:      tensor.collapse_shape %[[V1]] {{\[\[}}0], [1, 2]] : tensor<2x3x1x!FHE.eint<7>> into tensor<2x3x!FHE.eint<7>>
+func.func @matmul(%a: tensor<2x4x!FHE.eint<7>>, %b: tensor<4x3xi8>) -> tensor<2x3x!FHE.eint<7>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<2x4x!FHE.eint<7>>, tensor<4x3xi8>) -> tensor<2x3x!FHE.eint<7>>
+  return %0 : tensor<2x3x!FHE.eint<7>>
+}
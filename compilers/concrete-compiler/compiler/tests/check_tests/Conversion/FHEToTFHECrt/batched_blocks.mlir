@@ -0,0 +1,60 @@
+// RUN: concretecompiler --passes fhe-to-tfhe-crt --action=dump-tfhe %s --batch-crt-blocks --large-integer-crt-decomposition=2,3,5,7,11 --large-integer-circuit-bootstrap=2,9 --large-integer-packing-keyswitch=694,1024,4,9 --v0-parameter=2,10,693,4,9,7,2 2>&1| FileCheck %s
+
+// CHECK:      func.func @add_eint_int(%[[Varg0:.*]]: tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>> {
+// CHECK-NEXT:   %[[Vc1_i8:.*]] = arith.constant 1 : i8
+// CHECK-NEXT:   %[[V0:.*]] = arith.extsi %[[Vc1_i8]] : i8 to i64
+// CHECK-NEXT:   %[[V1:.*]] = "TFHE.encode_plaintext_with_crt"(%[[V0]]) {mods = [2, 3, 5, 7, 11], modsProd = 2310 : i64} : (i64) -> tensor<5xi64>
+// CHECK-NEXT:   %[[V2:.*]] = "TFHE.batched_add_glwe_int"(%[[Varg0]], %[[V1]]) : (tensor<5x!TFHE.glwe<sk?>>, tensor<5xi64>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   return %[[V2]] : tensor<5x!TFHE.glwe<sk?>>
+func.func @add_eint_int(%arg0: !FHE.eint<7>) -> !FHE.eint<7> {
+  %0 = arith.constant 1 : i8
+  %1 = "FHE.add_eint_int"(%arg0, %0): (!FHE.eint<7>, i8) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
+
+// CHECK:      func.func @sub_int_eint(%[[Varg0:.*]]: tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>> {
+// CHECK:        %[[V1:.*]] = "TFHE.encode_plaintext_with_crt"
+// CHECK-NEXT:   %[[V2:.*]] = "TFHE.batched_neg_glwe"(%[[Varg0]]) : (tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   %[[V3:.*]] = "TFHE.batched_add_glwe_int"(%[[V2]], %[[V1]]) : (tensor<5x!TFHE.glwe<sk?>>, tensor<5xi64>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   return %[[V3]] : tensor<5x!TFHE.glwe<sk?>>
+func.func @sub_int_eint(%arg0: !FHE.eint<7>) -> !FHE.eint<7> {
+  %0 = arith.constant 1 : i8
+  %1 = "FHE.sub_int_eint"(%0, %arg0): (i8, !FHE.eint<7>) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
+
+// CHECK:      func.func @add_eint(%[[Varg0:.*]]: tensor<5x!TFHE.glwe<sk?>>, %[[Varg1:.*]]: tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>> {
+// CHECK-NEXT:   %[[V0:.*]] = "TFHE.batched_add_glwe"(%[[Varg0]], %[[Varg1]]) : (tensor<5x!TFHE.glwe<sk?>>, tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   return %[[V0]] : tensor<5x!TFHE.glwe<sk?>>
+func.func @add_eint(%arg0: !FHE.eint<7>, %arg1: !FHE.eint<7>) -> !FHE.eint<7> {
+  %1 = "FHE.add_eint"(%arg0, %arg1): (!FHE.eint<7>, !FHE.eint<7>) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
+
+// CHECK:      func.func @sub_eint(%[[Varg0:.*]]: tensor<5x!TFHE.glwe<sk?>>, %[[Varg1:.*]]: tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>> {
+// CHECK-NEXT:   %[[V0:.*]] = "TFHE.batched_neg_glwe"(%[[Varg1]]) : (tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   %[[V1:.*]] = "TFHE.batched_add_glwe"(%[[Varg0]], %[[V0]]) : (tensor<5x!TFHE.glwe<sk?>>, tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   return %[[V1]] : tensor<5x!TFHE.glwe<sk?>>
+func.func @sub_eint(%arg0: !FHE.eint<7>, %arg1: !FHE.eint<7>) -> !FHE.eint<7> {
+  %1 = "FHE.sub_eint"(%arg0, %arg1): (!FHE.eint<7>, !FHE.eint<7>) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
+
+// CHECK:      func.func @neg_eint(%[[Varg0:.*]]: tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>> {
+// CHECK-NEXT:   %[[V0:.*]] = "TFHE.batched_neg_glwe"(%[[Varg0]]) : (tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   return %[[V0]] : tensor<5x!TFHE.glwe<sk?>>
+func.func @neg_eint(%arg0: !FHE.eint<7>) -> !FHE.eint<7> {
+  %1 = "FHE.neg_eint"(%arg0): (!FHE.eint<7>) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
+
+// CHECK:      func.func @mul_eint_int(%[[Varg0:.*]]: tensor<5x!TFHE.glwe<sk?>>) -> tensor<5x!TFHE.glwe<sk?>> {
+// CHECK-NEXT:   %[[Vc2_i8:.*]] = arith.constant 2 : i8
+// CHECK-NEXT:   %[[V0:.*]] = arith.extsi %[[Vc2_i8]] : i8 to i64
+// CHECK-NEXT:   %[[V1:.*]] = "TFHE.batched_mul_glwe_int_cst"(%[[Varg0]], %[[V0]]) : (tensor<5x!TFHE.glwe<sk?>>, i64) -> tensor<5x!TFHE.glwe<sk?>>
+// CHECK-NEXT:   return %[[V1]] : tensor<5x!TFHE.glwe<sk?>>
+func.func @mul_eint_int(%arg0: !FHE.eint<7>) -> !FHE.eint<7> {
+  %0 = arith.constant 2 : i8
+  %1 = "FHE.mul_eint_int"(%arg0, %0): (!FHE.eint<7>, i8) -> (!FHE.eint<7>)
+  return %1: !FHE.eint<7>
+}
@@ -0,0 +1,21 @@
+// RUN: concretecompiler %s --optimize-tfhe=false --optimizer-strategy=dag-multi --optimizer-allow-pbs-ks-order --action=dump-tfhe 2>&1| FileCheck %s
+
+// The levelled dot product is cheaper on the small key, without any noise
+// cost as its weights are 1: the lookup tables bootstrap first, their inputs
+// being on the small key, and then keyswitch back to it
+
+//CHECK: func.func @main
+//CHECK-NOT: TFHE.keyswitch_glwe
+//CHECK: %[[BS0:.*]] = "TFHE.bootstrap_glwe"(%{{.*}}, %{{.*}}) {TFHE.OId = [[OID0:[0-9]+]] : i32, key = #TFHE.bsk<sk?, sk?, -1, -1, -1, -1>} : (!TFHE.glwe<sk?>, tensor<{{.*}}xi64>) -> !TFHE.glwe<sk?>
+//CHECK-NEXT: %{{.*}} = "TFHE.keyswitch_glwe"(%[[BS0]]) {TFHE.OId = [[OID0]] : i32, key = #TFHE.ksk<sk?, sk?, -1, -1>} : (!TFHE.glwe<sk?>) -> !TFHE.glwe<sk?>
+//CHECK: %[[BS1:.*]] = "TFHE.bootstrap_glwe"(%{{.*}}, %{{.*}}) {TFHE.OId = [[OID1:[0-9]+]] : i32, key = #TFHE.bsk<sk?, sk?, -1, -1, -1, -1>} : (!TFHE.glwe<sk?>, tensor<{{.*}}xi64>) -> !TFHE.glwe<sk?>
+//CHECK-NEXT: %[[KS1:.*]] = "TFHE.keyswitch_glwe"(%[[BS1]]) {TFHE.OId = [[OID1]] : i32, key = #TFHE.ksk<sk?, sk?, -1, -1>} : (!TFHE.glwe<sk?>) -> !TFHE.glwe<sk?>
+//CHECK-NEXT: return %[[KS1]] : !TFHE.glwe<sk?>
+func.func @main(%arg0: tensor<4x!FHE.eint<3>>) -> !FHE.eint<3> {
+  %tlu = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %weights = arith.constant dense<[1, 0, 0, 0]> : tensor<4xi4>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %tlu) : (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x!FHE.eint<3>>
+  %1 = "FHELinalg.dot_eint_int"(%0, %weights) : (tensor<4x!FHE.eint<3>>, tensor<4xi4>) -> !FHE.eint<3>
+  %2 = "FHE.apply_lookup_table"(%1, %tlu) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %2 : !FHE.eint<3>
+}
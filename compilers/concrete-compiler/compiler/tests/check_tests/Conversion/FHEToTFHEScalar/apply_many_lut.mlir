@@ -0,0 +1,21 @@
+// RUN: concretecompiler %s --optimize-tfhe=false --optimizer-strategy=dag-multi --optimizer-many-lut-max-count=2 --action=dump-tfhe 2>&1| FileCheck %s
+
+// The two lookup tables of the same input are evaluated by a single many-LUT
+// bootstrap, after a single keyswitch
+
+//CHECK: func.func @apply_many_lut(%[[A0:.*]]: !TFHE.glwe<sk?>) -> (!TFHE.glwe<sk?>, !TFHE.glwe<sk?>) {
+//CHECK: %[[LUTS:.*]] = arith.constant dense<{{\[\[}}1, 2, 3, 0], [0, 3, 2, 1]]> : tensor<2x4xi64>
+//CHECK: %[[LUT:.*]] = "TFHE.encode_expand_many_lut_for_bootstrap"(%[[LUTS]]) {isSigned = false, outputBits = 2 : i32, polySize = {{.*}} : i32} : (tensor<2x4xi64>) -> tensor<{{.*}}xi64>
+//CHECK-NEXT: %[[KS:.*]] = "TFHE.keyswitch_glwe"(%[[A0]]) {TFHE.OId = {{.*}} : i32, key = #TFHE.ksk<sk?, sk?, -1, -1>} : (!TFHE.glwe<sk?>) -> !TFHE.glwe<sk?>
+//CHECK-NEXT: %[[BS:.*]] = "TFHE.many_lut_bootstrap_glwe"(%[[KS]], %[[LUT]]) {TFHE.OId = {{.*}} : i32, key = #TFHE.bsk<sk?, sk?, -1, -1, -1, -1>, lutCount = 2 : i32, lutStride = {{.*}} : i32} : (!TFHE.glwe<sk?>, tensor<{{.*}}xi64>) -> tensor<2x!TFHE.glwe<sk?>>
+//CHECK-NOT: TFHE.bootstrap_glwe
+//CHECK: %[[R0:.*]] = tensor.extract %[[BS]][%{{.*}}] : tensor<2x!TFHE.glwe<sk?>>
+//CHECK: %[[R1:.*]] = tensor.extract %[[BS]][%{{.*}}] : tensor<2x!TFHE.glwe<sk?>>
+//CHECK: return %[[R0]], %[[R1]] : !TFHE.glwe<sk?>, !TFHE.glwe<sk?>
+func.func @apply_many_lut(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<2>) {
+  %tlu0 = arith.constant dense<[1, 2, 3, 0]> : tensor<4xi64>
+  %tlu1 = arith.constant dense<[0, 3, 2, 1]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %tlu0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %tlu1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %0, %1: !FHE.eint<2>, !FHE.eint<2>
+}
@@ -0,0 +1,19 @@
+// RUN: concretecompiler %s --simulate --action=dump-simulated-tfhe 2>&1| FileCheck %s
+
+// The noise of the simulated keyswitches and bootstraps only depends on their
+// keys, its standard deviations are computed at compile time and passed to
+// the runtime as constants
+
+//CHECK-LABEL: func.func @apply_lookup_table(%[[A0:.*]]: i64) -> i64 {
+//CHECK-NOT: arith.constant 0.000000e+00 : f64
+//CHECK: %[[KS:.*]] = call @sim_keyswitch_lwe_std_dev_u64(%[[A0]], %[[KS_STD_DEV:cst(_[0-9]+)?]]) : (i64, f64) -> i64
+//CHECK-NOT: arith.constant 0.000000e+00 : f64
+//CHECK: %[[BS:.*]] = call @sim_bootstrap_lwe_std_dev_u64(%[[KS]], %{{.*}}, %{{.*}}, %[[MS_STD_DEV:cst(_[0-9]+)?]], %[[BR_STD_DEV:cst(_[0-9]+)?]], %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}) : (i64, tensor<?xi64>, i32, f64, f64, i1, i32, f64, !llvm.ptr<i8>) -> i64
+//CHECK: return %[[BS]] : i64
+//CHECK-NOT: @sim_keyswitch_lwe_u64
+//CHECK-NOT: @sim_bootstrap_lwe_u64
+func.func @apply_lookup_table(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %tlu = arith.constant dense<[1, 3, 5, 7, 0, 2, 4, 6]> : tensor<8xi64>
+  %1 = "FHE.apply_lookup_table"(%arg0, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
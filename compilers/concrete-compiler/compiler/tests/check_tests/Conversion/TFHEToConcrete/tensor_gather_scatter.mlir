@@ -0,0 +1,35 @@
+// RUN: concretecompiler --split-input-file --passes tfhe-to-concrete --action=dump-concrete --skip-program-info %s 2>&1| FileCheck %s
+
+//CHECK: func.func @tensor_gather(%[[A0:.*]]: tensor<5x1025xi64>, %[[A1:.*]]: tensor<3x1xi64>) -> tensor<3x1025xi64> {
+//CHECK:   %[[V0:.*]] = tensor.collapse_shape %[[A1]] [[_:\[\[0, 1\]\]]] : tensor<3x1xi64> into tensor<3xi64>
+//CHECK:   %[[V1:.*]] = "Concrete.gather_lwe_tensor"(%[[A0]], %[[V0]]) : (tensor<5x1025xi64>, tensor<3xi64>) -> tensor<3x1025xi64>
+//CHECK:   return %[[V1]] : tensor<3x1025xi64>
+//CHECK: }
+func.func @tensor_gather(%arg0: tensor<5x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<3x1xi64>) -> tensor<3x!TFHE.glwe<sk[1]<1,1024>>> {
+    %0 = tensor.gather %arg0[%arg1] gather_dims([0]) : (tensor<5x!TFHE.glwe<sk[1]<1,1024>>>, tensor<3x1xi64>) -> tensor<3x!TFHE.glwe<sk[1]<1,1024>>>
+    return %0 : tensor<3x!TFHE.glwe<sk[1]<1,1024>>>
+}
+
+// -----
+//CHECK: func.func @tensor_gather_crt(%[[A0:.*]]: tensor<5x2x1025xi64>, %[[A1:.*]]: tensor<3x1xi64>) -> tensor<3x2x1025xi64> {
+//CHECK:   %[[V0:.*]] = tensor.collapse_shape %[[A1]] [[_:\[\[0, 1\]\]]] : tensor<3x1xi64> into tensor<3xi64>
+//CHECK:   %[[V1:.*]] = tensor.collapse_shape %[[A0]] [[_:\[\[0\], \[1, 2\]\]]] : tensor<5x2x1025xi64> into tensor<5x2050xi64>
+//CHECK:   %[[V2:.*]] = "Concrete.gather_lwe_tensor"(%[[V1]], %[[V0]]) : (tensor<5x2050xi64>, tensor<3xi64>) -> tensor<3x2050xi64>
+//CHECK:   %[[V3:.*]] = tensor.expand_shape %[[V2]] [[_:\[\[0\], \[1, 2\]\]]] : tensor<3x2050xi64> into tensor<3x2x1025xi64>
+//CHECK:   return %[[V3]] : tensor<3x2x1025xi64>
+//CHECK: }
+func.func @tensor_gather_crt(%arg0: tensor<5x2x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<3x1xi64>) -> tensor<3x2x!TFHE.glwe<sk[1]<1,1024>>> {
+    %0 = tensor.gather %arg0[%arg1] gather_dims([0]) : (tensor<5x2x!TFHE.glwe<sk[1]<1,1024>>>, tensor<3x1xi64>) -> tensor<3x2x!TFHE.glwe<sk[1]<1,1024>>>
+    return %0 : tensor<3x2x!TFHE.glwe<sk[1]<1,1024>>>
+}
+
+// -----
+//CHECK: func.func @tensor_scatter(%[[A0:.*]]: tensor<5x1025xi64>, %[[A1:.*]]: tensor<3x1xi64>, %[[A2:.*]]: tensor<3x1025xi64>) -> tensor<5x1025xi64> {
+//CHECK:   %[[V0:.*]] = tensor.collapse_shape %[[A1]] [[_:\[\[0, 1\]\]]] : tensor<3x1xi64> into tensor<3xi64>
+//CHECK:   %[[V1:.*]] = "Concrete.scatter_lwe_tensor"(%[[A0]], %[[A2]], %[[V0]]) : (tensor<5x1025xi64>, tensor<3x1025xi64>, tensor<3xi64>) -> tensor<5x1025xi64>
+//CHECK:   return %[[V1]] : tensor<5x1025xi64>
+//CHECK: }
+func.func @tensor_scatter(%arg0: tensor<5x!TFHE.glwe<sk[1]<1,1024>>>, %arg1: tensor<3x1xi64>, %arg2: tensor<3x!TFHE.glwe<sk[1]<1,1024>>>) -> tensor<5x!TFHE.glwe<sk[1]<1,1024>>> {
+    %0 = tensor.scatter %arg2 into %arg0[%arg1] scatter_dims([0]) unique : (tensor<3x!TFHE.glwe<sk[1]<1,1024>>>, tensor<5x!TFHE.glwe<sk[1]<1,1024>>>, tensor<3x1xi64>) -> tensor<5x!TFHE.glwe<sk[1]<1,1024>>>
+    return %0 : tensor<5x!TFHE.glwe<sk[1]<1,1024>>>
+}
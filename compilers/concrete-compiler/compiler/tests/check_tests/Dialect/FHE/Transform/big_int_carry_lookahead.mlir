@@ -0,0 +1,35 @@
+// RUN: concretecompiler --chunk-integers --chunk-size 4 --chunk-width 2 --chunk-carry-lookahead --passes fhe-big-int-transform --action=dump-fhe  %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @add_chunked_eint(%arg0: tensor<4x!FHE.eint<4>>, %arg1: tensor<4x!FHE.eint<4>>) -> tensor<4x!FHE.eint<4>>
+// CHECK-DAG:   %[[FIRST:.*]] = arith.constant dense<[0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1]> : tensor<16xi64>
+// CHECK-DAG:   %[[STATUS:.*]] = arith.constant dense<[0, 0, 0, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1]> : tensor<16xi64>
+// CHECK-DAG:   %[[COMBINE:.*]] = arith.constant dense<[0, 0, 0, 1, 1, 1, 0, 1, 2, 0, 0, 0, 0, 0, 0, 0]> : tensor<16xi64>
+// CHECK-DAG:   %[[C3:.*]] = arith.constant 3 : i5
+// CHECK-DAG:   %[[C4:.*]] = arith.constant 4 : i5
+
+// The sums of the digits and their carry statuses
+// CHECK:       "FHE.apply_lookup_table"(%{{.*}}, %[[FIRST]])
+// CHECK:       %[[DIGITS:.*]]:2 = affine.for %[[I:.*]] = 1 to 4 iter_args
+// CHECK:         %[[SUM:.*]] = "FHE.add_eint"
+// CHECK-NEXT:    "FHE.apply_lookup_table"(%[[SUM]], %[[STATUS]])
+
+// The parallel prefix on the statuses
+// CHECK:       %[[P1:.*]] = affine.for %[[J:.*]] = 1 to 4 iter_args
+// CHECK:         "FHE.mul_eint_int"(%{{.*}}, %[[C3]])
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[COMBINE]])
+// CHECK:       %[[P2:.*]] = affine.for %[[K:.*]] = 2 to 4 iter_args
+// CHECK:         tensor.extract %[[P1]]
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[COMBINE]])
+
+// The results, with the carries in and out of the chunks
+// CHECK:       "FHE.mul_eint_int"(%{{.*}}, %[[C4]])
+// CHECK:       %[[R:.*]] = affine.for %[[L:.*]] = 1 to 4 iter_args
+// CHECK:         tensor.extract %[[P2]]
+// CHECK:         "FHE.add_eint"
+// CHECK:         "FHE.mul_eint_int"(%{{.*}}, %[[C4]])
+// CHECK:         "FHE.sub_eint"
+// CHECK:       return %[[R]] : tensor<4x!FHE.eint<4>>
+func.func @add_chunked_eint(%arg0: !FHE.eint<8>, %arg1: !FHE.eint<8>) -> !FHE.eint<8> {
+  %1 = "FHE.add_eint"(%arg0, %arg1): (!FHE.eint<8>, !FHE.eint<8>) -> (!FHE.eint<8>)
+  return %1: !FHE.eint<8>
+}
@@ -0,0 +1,76 @@
+// RUN: concretecompiler --split-input-file --chunk-integers --chunk-size 4 --chunk-width 2 --passes fhe-big-int-transform --action=dump-fhe  %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @mul_chunked_eint(%arg0: tensor<3x!FHE.eint<4>>, %arg1: tensor<3x!FHE.eint<4>>) -> tensor<3x!FHE.eint<4>>
+// CHECK-DAG:   %[[LOW:.*]] = arith.constant dense<[0, 0, 0, 0, 0, 1, 2, 3, 0, 2, 0, 2, 0, 3, 2, 1]> : tensor<16xi64>
+// CHECK-DAG:   %[[HIGH:.*]] = arith.constant dense<[0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 2]> : tensor<16xi64>
+// CHECK-DAG:   %[[C4:.*]] = arith.constant 4 : i5
+
+// The low and high digits of the products of the first chunk of %arg0
+// CHECK:       %[[A0:.*]] = "FHE.mul_eint_int"(%{{.*}}, %[[C4]])
+// CHECK:       affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK:         %[[P0:.*]] = "FHE.add_eint"(%[[A0]], %{{.*}})
+// CHECK-NEXT:    "FHE.apply_lookup_table"(%[[P0]], %[[LOW]])
+// CHECK:       affine.for %{{.*}} = 1 to 3 iter_args
+// CHECK:         %[[P1:.*]] = "FHE.add_eint"(%[[A0]], %{{.*}})
+// CHECK-NEXT:    "FHE.apply_lookup_table"(%[[P1]], %[[HIGH]])
+
+// The other rows, then their sums by a tree
+// CHECK-COUNT-3: affine.for %{{.*}} iter_args
+// CHECK:         affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK:         affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK:         affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK:         affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK-NOT:     affine.for
+// CHECK:         return
+func.func @mul_chunked_eint(%arg0: !FHE.eint<6>, %arg1: !FHE.eint<6>) -> !FHE.eint<6> {
+  %1 = "FHE.mul_eint"(%arg0, %arg1): (!FHE.eint<6>, !FHE.eint<6>) -> (!FHE.eint<6>)
+  return %1: !FHE.eint<6>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @mul_chunked_eint_int(%arg0: tensor<4x!FHE.eint<4>>) -> tensor<4x!FHE.eint<4>>
+// CHECK-DAG:   %[[LOW:.*]] = arith.constant dense<[0, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2]> : tensor<16xi64>
+// CHECK-DAG:   %[[HIGH:.*]] = arith.constant dense<[0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7]> : tensor<16xi64>
+
+// 6 = 0b0110 has the digit 2 then the digit 1
+// CHECK:       affine.for %{{.*}} = 0 to 4 iter_args
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[LOW]])
+// CHECK:       affine.for %{{.*}} = 1 to 4 iter_args
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[HIGH]])
+// CHECK:       affine.for %{{.*}} = 1 to 4 iter_args
+// CHECK-NOT:     "FHE.apply_lookup_table"
+// CHECK:         affine.yield
+// CHECK:       return
+func.func @mul_chunked_eint_int(%arg0: !FHE.eint<8>) -> !FHE.eint<8> {
+  %c6 = arith.constant 6 : i9
+  %1 = "FHE.mul_eint_int"(%arg0, %c6): (!FHE.eint<8>, i9) -> (!FHE.eint<8>)
+  return %1: !FHE.eint<8>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @max_chunked_eint(%arg0: tensor<3x!FHE.eint<4>>, %arg1: tensor<3x!FHE.eint<4>>) -> tensor<3x!FHE.eint<4>>
+// CHECK-DAG:   %[[ORDER:.*]] = arith.constant dense<[2, 0, 0, 0, 1, 2, 0, 0, 1, 1, 2, 0, 1, 1, 1, 2]> : tensor<16xi64>
+// CHECK-DAG:   %[[COMBINE:.*]] = arith.constant dense<[0, 0, 0, 1, 1, 1, 0, 1, 2, 0, 0, 0, 0, 0, 0, 0]> : tensor<16xi64>
+// CHECK-DAG:   %[[SELECTA:.*]] = arith.constant dense<[0, 0, 0, 0, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3]> : tensor<16xi64>
+// CHECK-DAG:   %[[SELECTB:.*]] = arith.constant dense<[0, 1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]> : tensor<16xi64>
+
+// The orders of the chunks, then of the whole integers
+// CHECK:       %[[ORDERS:.*]] = affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[ORDER]])
+// CHECK:       affine.for %{{.*}} = 0 to 1 iter_args
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[COMBINE]])
+// CHECK:       %[[COMBINED:.*]] = affine.for %{{.*}} = 0 to 1 iter_args
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[COMBINE]])
+// CHECK:       tensor.extract %[[COMBINED]]
+
+// The chunks of the maximum
+// CHECK:       affine.for %{{.*}} = 0 to 3 iter_args
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[SELECTA]])
+// CHECK:         "FHE.apply_lookup_table"(%{{.*}}, %[[SELECTB]])
+// CHECK:       return
+func.func @max_chunked_eint(%arg0: !FHE.eint<6>, %arg1: !FHE.eint<6>) -> !FHE.eint<6> {
+  %1 = "FHE.max_eint"(%arg0, %arg1): (!FHE.eint<6>, !FHE.eint<6>) -> (!FHE.eint<6>)
+  return %1: !FHE.eint<6>
+}
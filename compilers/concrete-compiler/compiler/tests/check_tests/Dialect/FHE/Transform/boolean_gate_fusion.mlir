@@ -0,0 +1,65 @@
+// RUN: concretecompiler --fuse-boolean-gates --passes fhe-boolean-gate-fusion --action=dump-fhe --split-input-file %s 2>&1| FileCheck %s --check-prefixes=CHECK,TWO
+// RUN: concretecompiler --fuse-boolean-gates --boolean-gate-fusion-max-inputs=3 --passes fhe-boolean-gate-fusion --action=dump-fhe --split-input-file %s 2>&1| FileCheck %s --check-prefixes=CHECK,THREE
+
+// CHECK-LABEL: func.func @two_inputs(%arg0: !FHE.ebool, %arg1: !FHE.ebool) -> !FHE.ebool
+func.func @two_inputs(%arg0: !FHE.ebool, %arg1: !FHE.ebool) -> !FHE.ebool {
+  // CHECK-NEXT: %[[TT:.*]] = arith.constant dense<[0, 0, 1, 0]> : tensor<4xi64>
+  // CHECK-NEXT: %[[V0:.*]] = "FHE.gen_gate"(%arg0, %arg1, %[[TT]]) : (!FHE.ebool, !FHE.ebool, tensor<4xi64>) -> !FHE.ebool
+  // CHECK-NEXT: return %[[V0]] : !FHE.ebool
+  %0 = "FHE.and"(%arg0, %arg1) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  %1 = "FHE.xor"(%arg0, %0) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  return %1: !FHE.ebool
+}
+
+// -----
+
+// CHECK-LABEL: func.func @not(%arg0: !FHE.ebool, %arg1: !FHE.ebool) -> !FHE.ebool
+func.func @not(%arg0: !FHE.ebool, %arg1: !FHE.ebool) -> !FHE.ebool {
+  // CHECK-NEXT: %[[TT:.*]] = arith.constant dense<[1, 1, 1, 0]> : tensor<4xi64>
+  // CHECK-NEXT: %[[V0:.*]] = "FHE.gen_gate"(%arg0, %arg1, %[[TT]]) : (!FHE.ebool, !FHE.ebool, tensor<4xi64>) -> !FHE.ebool
+  // CHECK-NEXT: return %[[V0]] : !FHE.ebool
+  %0 = "FHE.and"(%arg0, %arg1) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  %1 = "FHE.not"(%0) : (!FHE.ebool) -> !FHE.ebool
+  return %1: !FHE.ebool
+}
+
+// -----
+
+// CHECK-LABEL: func.func @three_inputs(%arg0: !FHE.ebool, %arg1: !FHE.ebool, %arg2: !FHE.ebool) -> !FHE.ebool
+func.func @three_inputs(%arg0: !FHE.ebool, %arg1: !FHE.ebool, %arg2: !FHE.ebool) -> !FHE.ebool {
+  // TWO-NEXT: %[[V0:.*]] = "FHE.and"(%arg0, %arg1)
+  // TWO-NEXT: %[[V1:.*]] = "FHE.or"(%[[V0]], %arg2)
+  // TWO-NEXT: return %[[V1]] : !FHE.ebool
+
+  // THREE-DAG: %[[C4:.*]] = arith.constant 4 : i4
+  // THREE-DAG: %[[C2:.*]] = arith.constant 2 : i4
+  // THREE-DAG: %[[TT:.*]] = arith.constant dense<[0, 1, 0, 1, 0, 1, 1, 1]> : tensor<8xi64>
+  // THREE-DAG: %[[A:.*]] = "FHE.from_bool"(%arg0) : (!FHE.ebool) -> !FHE.eint<3>
+  // THREE-DAG: %[[B:.*]] = "FHE.from_bool"(%arg1) : (!FHE.ebool) -> !FHE.eint<3>
+  // THREE-DAG: %[[C:.*]] = "FHE.from_bool"(%arg2) : (!FHE.ebool) -> !FHE.eint<3>
+  // THREE-DAG: %[[A4:.*]] = "FHE.mul_eint_int"(%[[A]], %[[C4]]) : (!FHE.eint<3>, i4) -> !FHE.eint<3>
+  // THREE-DAG: %[[B2:.*]] = "FHE.mul_eint_int"(%[[B]], %[[C2]]) : (!FHE.eint<3>, i4) -> !FHE.eint<3>
+  // THREE-DAG: %[[AB:.*]] = "FHE.add_eint"(%[[A4]], %[[B2]])
+  // THREE-DAG: %[[ABC:.*]] = "FHE.add_eint"(%[[AB]], %[[C]])
+  // THREE:     %[[V0:.*]] = "FHE.apply_lookup_table"(%[[ABC]], %[[TT]]) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  // THREE-NEXT: %[[V1:.*]] = "FHE.to_bool"(%[[V0]]) : (!FHE.eint<3>) -> !FHE.ebool
+  // THREE-NEXT: return %[[V1]] : !FHE.ebool
+  %0 = "FHE.and"(%arg0, %arg1) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  %1 = "FHE.or"(%0, %arg2) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  return %1: !FHE.ebool
+}
+
+// -----
+
+// A gate used twice is not fused
+// CHECK-LABEL: func.func @shared(%arg0: !FHE.ebool, %arg1: !FHE.ebool) -> (!FHE.ebool, !FHE.ebool)
+func.func @shared(%arg0: !FHE.ebool, %arg1: !FHE.ebool) -> (!FHE.ebool, !FHE.ebool) {
+  // CHECK-NEXT: %[[V0:.*]] = "FHE.and"(%arg0, %arg1)
+  // CHECK-NEXT: %[[V1:.*]] = "FHE.xor"(%[[V0]], %arg0)
+  // CHECK-NEXT: %[[V2:.*]] = "FHE.or"(%[[V0]], %arg1)
+  // CHECK-NEXT: return %[[V1]], %[[V2]] : !FHE.ebool, !FHE.ebool
+  %0 = "FHE.and"(%arg0, %arg1) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  %1 = "FHE.xor"(%0, %arg0) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  %2 = "FHE.or"(%0, %arg1) : (!FHE.ebool, !FHE.ebool) -> !FHE.ebool
+  return %1, %2: !FHE.ebool, !FHE.ebool
+}
@@ -0,0 +1,45 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes DynamicTLU %s 2>&1 | FileCheck %s
+
+// The table is extended once, out of the loop of lookups
+// CHECK-LABEL: func.func @shared_table
+// CHECK:         %[[ALLOC:.*]] = bufferization.alloc_tensor() : tensor<16xi64>
+// CHECK-NEXT:    %[[LUT:.*]] = linalg.map { arith.extui } ins(%arg1 : tensor<16xi8>) outs(%[[ALLOC]] : tensor<16xi64>)
+// CHECK:         scf.for
+// CHECK:           %[[V0:.*]] = "FHE.apply_lookup_table"(%{{.*}}, %[[LUT]]) : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<4>
+// CHECK:           %[[V1:.*]] = "FHE.apply_lookup_table"(%[[V0]], %[[LUT]]) : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<4>
+func.func @shared_table(%arg0: tensor<8x!FHE.eint<4>>, %arg1: tensor<16xi8>) -> tensor<8x!FHE.eint<4>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %0 = scf.for %i = %c0 to %c8 step %c1 iter_args(%t = %arg0) -> (tensor<8x!FHE.eint<4>>) {
+    %1 = tensor.extract %t[%i] : tensor<8x!FHE.eint<4>>
+    %2 = "FHE.apply_lookup_table"(%1, %arg1) : (!FHE.eint<4>, tensor<16xi8>) -> !FHE.eint<4>
+    %3 = "FHE.apply_lookup_table"(%2, %arg1) : (!FHE.eint<4>, tensor<16xi8>) -> !FHE.eint<4>
+    %4 = tensor.insert %3 into %t[%i] : tensor<8x!FHE.eint<4>>
+    scf.yield %4 : tensor<8x!FHE.eint<4>>
+  }
+  return %0 : tensor<8x!FHE.eint<4>>
+}
+
+// -----
+
+// The tables sliced in the loop are sliced out of the extended tables
+// CHECK-LABEL: func.func @table_per_element
+// CHECK:         %[[ALLOC:.*]] = bufferization.alloc_tensor() : tensor<8x16xi64>
+// CHECK-NEXT:    %[[LUTS:.*]] = linalg.map { arith.extui } ins(%arg1 : tensor<8x16xi8>) outs(%[[ALLOC]] : tensor<8x16xi64>)
+// CHECK:         scf.for %[[I:.*]] =
+// CHECK:           %[[LUT:.*]] = tensor.extract_slice %[[LUTS]][%[[I]], 0] [1, 16] [1, 1] : tensor<8x16xi64> to tensor<16xi64>
+// CHECK:           "FHE.apply_lookup_table"(%{{.*}}, %[[LUT]]) : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<4>
+func.func @table_per_element(%arg0: tensor<8x!FHE.eint<4>>, %arg1: tensor<8x16xi8>) -> tensor<8x!FHE.eint<4>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %0 = scf.for %i = %c0 to %c8 step %c1 iter_args(%t = %arg0) -> (tensor<8x!FHE.eint<4>>) {
+    %1 = tensor.extract %t[%i] : tensor<8x!FHE.eint<4>>
+    %lut = tensor.extract_slice %arg1[%i, 0] [1, 16] [1, 1] : tensor<8x16xi8> to tensor<16xi8>
+    %2 = "FHE.apply_lookup_table"(%1, %lut) : (!FHE.eint<4>, tensor<16xi8>) -> !FHE.eint<4>
+    %3 = tensor.insert %2 into %t[%i] : tensor<8x!FHE.eint<4>>
+    scf.yield %3 : tensor<8x!FHE.eint<4>>
+  }
+  return %0 : tensor<8x!FHE.eint<4>>
+}
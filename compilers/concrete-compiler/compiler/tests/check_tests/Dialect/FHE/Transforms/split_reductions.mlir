@@ -0,0 +1,114 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --parallelize-loops --passes fhe-split-reductions %s 2>&1 | FileCheck %s
+
+// The 16 iterations are split into 4 chunks accumulating into partial sums,
+// which are then added to the initial accumulator
+
+// CHECK-LABEL: func.func @sum
+// CHECK:         %[[ZEROS:.*]] = "FHE.zero_tensor"() : () -> tensor<4x1x!FHE.eint<7>>
+// CHECK:         %[[PARTIALS:.*]] = scf.for %[[CHUNK:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[P:.*]] = %[[ZEROS]]) -> (tensor<4x1x!FHE.eint<7>>) {
+// CHECK:           %[[LB:.*]] = arith.addi
+// CHECK:           %[[UB:.*]] = arith.minsi
+// CHECK:           %[[PARTIAL:.*]] = tensor.extract_slice %[[P]][%[[CHUNK]], 0] [1, 1] [1, 1] : tensor<4x1x!FHE.eint<7>> to tensor<1x!FHE.eint<7>>
+// CHECK:           %[[SUM:.*]] = scf.for %{{.*}} = %[[LB]] to %[[UB]] step %{{.*}} iter_args(%{{.*}} = %[[PARTIAL]]) -> (tensor<1x!FHE.eint<7>>) {
+// CHECK:             "FHE.add_eint"
+// CHECK:           } {parallel = false}
+// CHECK:           %[[UPDATED:.*]] = tensor.insert_slice %[[SUM]] into %[[P]][%[[CHUNK]], 0] [1, 1] [1, 1] : tensor<1x!FHE.eint<7>> into tensor<4x1x!FHE.eint<7>>
+// CHECK:           scf.yield %[[UPDATED]] : tensor<4x1x!FHE.eint<7>>
+// CHECK:         } {parallel = true}
+// CHECK:         %[[RESULT:.*]] = scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC:.*]] = %arg1) -> (tensor<1x!FHE.eint<7>>) {
+// CHECK:           scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC2:.*]] = %[[ACC]]) -> (tensor<1x!FHE.eint<7>>) {
+// CHECK:             %[[X:.*]] = tensor.extract %[[PARTIALS]][%[[I]], %[[J]]] : tensor<4x1x!FHE.eint<7>>
+// CHECK:             %[[Y:.*]] = tensor.extract %[[ACC2]][%[[J]]] : tensor<1x!FHE.eint<7>>
+// CHECK:             %[[Z:.*]] = "FHE.add_eint"(%[[Y]], %[[X]])
+// CHECK:             tensor.insert %[[Z]] into %[[ACC2]][%[[J]]] : tensor<1x!FHE.eint<7>>
+// CHECK:         return %[[RESULT]] : tensor<1x!FHE.eint<7>>
+func.func @sum(%a: tensor<16x!FHE.eint<7>>, %init: tensor<1x!FHE.eint<7>>) -> tensor<1x!FHE.eint<7>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %0 = scf.for %i = %c0 to %c16 step %c1 iter_args(%acc = %init) -> (tensor<1x!FHE.eint<7>>) {
+    %x = tensor.extract %a[%i] : tensor<16x!FHE.eint<7>>
+    %y = tensor.extract %acc[%c0] : tensor<1x!FHE.eint<7>>
+    %z = "FHE.add_eint"(%y, %x) : (!FHE.eint<7>, !FHE.eint<7>) -> !FHE.eint<7>
+    %1 = tensor.insert %z into %acc[%c0] : tensor<1x!FHE.eint<7>>
+    scf.yield %1 : tensor<1x!FHE.eint<7>>
+  } {parallel = false}
+  return %0 : tensor<1x!FHE.eint<7>>
+}
+
+// -----
+
+// The accumulation of a sum along the first axis is carried through the
+// parallel loop nested in the reduction loop
+
+// CHECK-LABEL: func.func @sum_axis
+// CHECK:         scf.for
+// CHECK:           scf.for
+// CHECK:             scf.for
+// CHECK:               "FHE.add_eint"
+// CHECK:             } {parallel = true}
+// CHECK:           } {parallel = false}
+// CHECK:         } {parallel = true}
+func.func @sum_axis(%a: tensor<9x3x!FHE.eint<7>>, %init: tensor<3x!FHE.eint<7>>) -> tensor<3x!FHE.eint<7>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c3 = arith.constant 3 : index
+  %c9 = arith.constant 9 : index
+  %0 = scf.for %i = %c0 to %c9 step %c1 iter_args(%acc = %init) -> (tensor<3x!FHE.eint<7>>) {
+    %1 = scf.for %j = %c0 to %c3 step %c1 iter_args(%acc2 = %acc) -> (tensor<3x!FHE.eint<7>>) {
+      %x = tensor.extract %a[%i, %j] : tensor<9x3x!FHE.eint<7>>
+      %y = tensor.extract %acc2[%j] : tensor<3x!FHE.eint<7>>
+      %z = "FHE.add_eint"(%y, %x) : (!FHE.eint<7>, !FHE.eint<7>) -> !FHE.eint<7>
+      %2 = tensor.insert %z into %acc2[%j] : tensor<3x!FHE.eint<7>>
+      scf.yield %2 : tensor<3x!FHE.eint<7>>
+    } {parallel = true}
+    scf.yield %1 : tensor<3x!FHE.eint<7>>
+  } {parallel = false}
+  return %0 : tensor<3x!FHE.eint<7>>
+}
+
+// -----
+
+// The reductions nested in a parallel loop are left sequential, the
+// parallel loop already keeping the cores busy
+
+// CHECK-LABEL: func.func @matmul_row
+// CHECK-NOT:     "FHE.zero_tensor"
+func.func @matmul_row(%a: tensor<2x16x!FHE.eint<7>>, %init: tensor<2x!FHE.eint<7>>) -> tensor<2x!FHE.eint<7>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c16 = arith.constant 16 : index
+  %0 = scf.for %i = %c0 to %c2 step %c1 iter_args(%acc = %init) -> (tensor<2x!FHE.eint<7>>) {
+    %1 = scf.for %k = %c0 to %c16 step %c1 iter_args(%acc2 = %acc) -> (tensor<2x!FHE.eint<7>>) {
+      %x = tensor.extract %a[%i, %k] : tensor<2x16x!FHE.eint<7>>
+      %y = tensor.extract %acc2[%i] : tensor<2x!FHE.eint<7>>
+      %z = "FHE.add_eint"(%y, %x) : (!FHE.eint<7>, !FHE.eint<7>) -> !FHE.eint<7>
+      %2 = tensor.insert %z into %acc2[%i] : tensor<2x!FHE.eint<7>>
+      scf.yield %2 : tensor<2x!FHE.eint<7>>
+    } {parallel = false}
+    scf.yield %1 : tensor<2x!FHE.eint<7>>
+  } {parallel = true}
+  return %0 : tensor<2x!FHE.eint<7>>
+}
+
+// -----
+
+// An accumulator read by the iterations is not a reduction
+
+// CHECK-LABEL: func.func @prefix_sum
+// CHECK-NOT:     "FHE.zero_tensor"
+func.func @prefix_sum(%a: tensor<16x!FHE.eint<7>>, %init: tensor<16x!FHE.eint<7>>) -> tensor<16x!FHE.eint<7>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %0 = scf.for %i = %c1 to %c16 step %c1 iter_args(%acc = %init) -> (tensor<16x!FHE.eint<7>>) {
+    %p = arith.subi %i, %c1 : index
+    %x = tensor.extract %a[%i] : tensor<16x!FHE.eint<7>>
+    %y = tensor.extract %acc[%p] : tensor<16x!FHE.eint<7>>
+    %z = "FHE.add_eint"(%y, %x) : (!FHE.eint<7>, !FHE.eint<7>) -> !FHE.eint<7>
+    %1 = tensor.insert %z into %acc[%i] : tensor<16x!FHE.eint<7>>
+    scf.yield %1 : tensor<16x!FHE.eint<7>>
+  } {parallel = false}
+  return %0 : tensor<16x!FHE.eint<7>>
+}
@@ -0,0 +1,39 @@
+// RUN: concretecompiler --action=dump-fhe --fhelinalg-auto-tiling --fhelinalg-auto-tiling-cores=4 --optimizer-strategy=dag-mono --split-input-file %s 2>&1 | FileCheck %s
+
+// CHECK: "FHELinalg.matmul_eint_int"(%[[A:.*]], %[[B:.*]]) {"tile-sizes" = [0, 0, 4]}
+func.func @reduction_split_by_cores(%a: tensor<8x16x!FHE.eint<6>>, %b: tensor<16x2xi7>) -> tensor<8x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<8x16x!FHE.eint<6>>, tensor<16x2xi7>) -> tensor<8x2x!FHE.eint<6>>
+  return %0 : tensor<8x2x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK: "FHELinalg.matmul_eint_int"(%[[A:.*]], %[[B:.*]]) {"tile-sizes" = [0, 0, 3]}
+func.func @balanced_tiles(%a: tensor<8x10x!FHE.eint<6>>, %b: tensor<10x2xi7>) -> tensor<8x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<8x10x!FHE.eint<6>>, tensor<10x2xi7>) -> tensor<8x2x!FHE.eint<6>>
+  return %0 : tensor<8x2x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK: "FHELinalg.matmul_eint_int"(%[[A:.*]], %[[B:.*]]) {"tile-sizes" = [0, 0, 2]}
+func.func @explicit_tile_sizes_kept(%a: tensor<8x16x!FHE.eint<6>>, %b: tensor<16x2xi7>) -> tensor<8x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) { "tile-sizes" = [0,0,2] } : (tensor<8x16x!FHE.eint<6>>, tensor<16x2xi7>) -> tensor<8x2x!FHE.eint<6>>
+  return %0 : tensor<8x2x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK-NOT: tile-sizes
+func.func @vector_matrix_not_tiled(%a: tensor<16x!FHE.eint<6>>, %b: tensor<16x2xi7>) -> tensor<2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<16x!FHE.eint<6>>, tensor<16x2xi7>) -> tensor<2x!FHE.eint<6>>
+  return %0 : tensor<2x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK-NOT: tile-sizes
+func.func @small_reduction_not_tiled(%a: tensor<8x1x!FHE.eint<6>>, %b: tensor<1x2xi7>) -> tensor<8x2x!FHE.eint<6>> {
+  %0 = "FHELinalg.matmul_eint_int"(%a, %b) : (tensor<8x1x!FHE.eint<6>>, tensor<1x2xi7>) -> tensor<8x2x!FHE.eint<6>>
+  return %0 : tensor<8x2x!FHE.eint<6>>
+}
@@ -0,0 +1,31 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-linalg-encrypted-matmul-to-shared-tlu --fhelinalg-matmul-shared-tlu --skip-program-info %s 2>&1 | FileCheck %s
+
+// CHECK-LABEL: func.func @matmul
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[0, 0, 1, 3, 6, 2, 7, 5]> : tensor<8xi64>
+// CHECK-NEXT:    %[[V0:.*]] = tensor.expand_shape %[[A:.*]] {{\[\[}}0], [1, 2]] : tensor<3x3x!FHE.eint<3>> into tensor<3x3x1x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V1:.*]] = "FHELinalg.add_eint"(%[[V0]], %[[B:.*]]){{.*}} : (tensor<3x3x1x!FHE.eint<3>>, tensor<3x3x!FHE.eint<3>>) -> tensor<3x3x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V2:.*]] = "FHELinalg.apply_lookup_table"(%[[V1]], %[[LUT]]){{.*}} : (tensor<3x3x3x!FHE.eint<3>>, tensor<8xi64>) -> tensor<3x3x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V3:.*]] = "FHELinalg.sum"(%[[V2]]){{.*}}axes = [1], keep_dims = false{{.*}} : (tensor<3x3x3x!FHE.eint<3>>) -> tensor<3x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V4:.*]] = "FHELinalg.apply_lookup_table"(%[[A]], %[[LUT]]){{.*}} : (tensor<3x3x!FHE.eint<3>>, tensor<8xi64>) -> tensor<3x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V5:.*]] = "FHELinalg.sum"(%[[V4]]){{.*}}axes = [1], keep_dims = true{{.*}} : (tensor<3x3x!FHE.eint<3>>) -> tensor<3x1x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V6:.*]] = "FHELinalg.apply_lookup_table"(%[[B]], %[[LUT]]){{.*}} : (tensor<3x3x!FHE.eint<3>>, tensor<8xi64>) -> tensor<3x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V7:.*]] = "FHELinalg.sum"(%[[V6]]){{.*}}axes = [0], keep_dims = true{{.*}} : (tensor<3x3x!FHE.eint<3>>) -> tensor<1x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V8:.*]] = "FHELinalg.sub_eint"(%[[V3]], %[[V5]]){{.*}} : (tensor<3x3x!FHE.eint<3>>, tensor<3x1x!FHE.eint<3>>) -> tensor<3x3x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V9:.*]] = "FHELinalg.sub_eint"(%[[V8]], %[[V7]]){{.*}} : (tensor<3x3x!FHE.eint<3>>, tensor<1x3x!FHE.eint<3>>) -> tensor<3x3x!FHE.eint<3>>
+// CHECK-NEXT:    return %[[V9]]
+func.func @matmul(%a: tensor<3x3x!FHE.eint<3>>, %b: tensor<3x3x!FHE.eint<3>>) -> tensor<3x3x!FHE.eint<3>> {
+  %0 = "FHELinalg.matmul_eint_eint"(%a, %b) : (tensor<3x3x!FHE.eint<3>>, tensor<3x3x!FHE.eint<3>>) -> tensor<3x3x!FHE.eint<3>>
+  return %0 : tensor<3x3x!FHE.eint<3>>
+}
+
+// -----
+
+// The shared table lookups would not reduce the number of table lookups of
+// a product of vectors
+
+// CHECK-LABEL: func.func @vector_product
+// CHECK-NEXT:    "FHELinalg.matmul_eint_eint"
+func.func @vector_product(%a: tensor<1x3x!FHE.eint<3>>, %b: tensor<3x1x!FHE.eint<3>>) -> tensor<1x1x!FHE.eint<3>> {
+  %0 = "FHELinalg.matmul_eint_eint"(%a, %b) : (tensor<1x3x!FHE.eint<3>>, tensor<3x1x!FHE.eint<3>>) -> tensor<1x1x!FHE.eint<3>>
+  return %0 : tensor<1x1x!FHE.eint<3>>
+}
@@ -0,0 +1,67 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-fuse-lookup-table-chains --fuse-tlu-chains --skip-program-info %s 2>&1 | FileCheck %s
+
+// CHECK-LABEL: func.func @add_between_lookups
+// CHECK:         %[[LUT:.*]] = arith.constant dense<[30, 50, 70, 10]> : tensor<4xi64>
+// CHECK-NEXT:    %[[V0:.*]] = "FHE.apply_lookup_table"(%arg0, %[[LUT]]){{.*}} : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<7>
+// CHECK-NEXT:    return %[[V0]] : !FHE.eint<7>
+func.func @add_between_lookups(%arg0: !FHE.eint<2>) -> !FHE.eint<7> {
+  %lut0 = arith.constant dense<[1, 3, 5, 7]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[0, 10, 20, 30, 40, 50, 60, 70]> : tensor<8xi64>
+  %c2 = arith.constant 2 : i4
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  %1 = "FHE.add_eint_int"(%0, %c2): (!FHE.eint<3>, i4) -> (!FHE.eint<3>)
+  %2 = "FHE.apply_lookup_table"(%1, %lut1): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<7>)
+  return %2: !FHE.eint<7>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @mul_and_sub_between_lookups
+// CHECK:         %[[LUT:.*]] = arith.constant dense<[2, 12, 6, 0]> : tensor<4xi64>
+// CHECK-NEXT:    %[[V0:.*]] = "FHE.apply_lookup_table"(%arg0, %[[LUT]]){{.*}} : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<5>
+// CHECK-NEXT:    return %[[V0]] : !FHE.eint<5>
+func.func @mul_and_sub_between_lookups(%arg0: !FHE.eint<2>) -> !FHE.eint<5> {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[0, 2, 4, 6, 8, 10, 12, 14]> : tensor<8xi64>
+  %c1 = arith.constant 1 : i4
+  %c3 = arith.constant 3 : i4
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  %1 = "FHE.mul_eint_int"(%0, %c3): (!FHE.eint<3>, i4) -> (!FHE.eint<3>)
+  %2 = "FHE.sub_int_eint"(%c1, %1): (i4, !FHE.eint<3>) -> (!FHE.eint<3>)
+  %3 = "FHE.apply_lookup_table"(%2, %lut1): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<5>)
+  return %3: !FHE.eint<5>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @elementwise_lookups
+// CHECK:         %[[LUT:.*]] = arith.constant dense<[4, 1, 0, 9]> : tensor<4xi64>
+// CHECK-NEXT:    %[[V0:.*]] = "FHELinalg.apply_lookup_table"(%arg0, %[[LUT]]){{.*}} : (tensor<4x!FHE.eint<2>>, tensor<4xi64>) -> tensor<4x!FHE.eint<4>>
+// CHECK-NEXT:    return %[[V0]] : tensor<4x!FHE.eint<4>>
+func.func @elementwise_lookups(%arg0: tensor<4x!FHE.eint<2>>) -> tensor<4x!FHE.eint<4>> {
+  %lut0 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[0, 1, 4, 9]> : tensor<4xi64>
+  %c1 = arith.constant dense<1> : tensor<4xi3>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %lut0): (tensor<4x!FHE.eint<2>>, tensor<4xi64>) -> (tensor<4x!FHE.eint<2>>)
+  %1 = "FHELinalg.sub_eint_int"(%0, %c1): (tensor<4x!FHE.eint<2>>, tensor<4xi3>) -> (tensor<4x!FHE.eint<2>>)
+  %2 = "FHELinalg.apply_lookup_table"(%1, %lut1): (tensor<4x!FHE.eint<2>>, tensor<4xi64>) -> (tensor<4x!FHE.eint<4>>)
+  return %2: tensor<4x!FHE.eint<4>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @shared_intermediate
+// CHECK:         %[[V0:.*]] = "FHE.apply_lookup_table"(%arg0, %{{.*}}){{.*}} : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:    %[[V1:.*]] = "FHE.add_eint_int"(%[[V0]], %{{.*}}){{.*}} : (!FHE.eint<2>, i3) -> !FHE.eint<2>
+// CHECK-NEXT:    %[[V2:.*]] = "FHE.apply_lookup_table"(%[[V1]], %{{.*}}){{.*}} : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:    %[[V3:.*]] = "FHE.add_eint"(%[[V1]], %[[V2]]){{.*}} : (!FHE.eint<2>, !FHE.eint<2>) -> !FHE.eint<2>
+func.func @shared_intermediate(%arg0: !FHE.eint<2>) -> !FHE.eint<2> {
+  %lut0 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[0, 1, 0, 1]> : tensor<4xi64>
+  %c1 = arith.constant 1 : i3
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.add_eint_int"(%0, %c1): (!FHE.eint<2>, i3) -> (!FHE.eint<2>)
+  %2 = "FHE.apply_lookup_table"(%1, %lut1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %3 = "FHE.add_eint"(%1, %2): (!FHE.eint<2>, !FHE.eint<2>) -> (!FHE.eint<2>)
+  return %3: !FHE.eint<2>
+}
@@ -0,0 +1,67 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-narrow-lookup-table-inputs --narrow-tlu-inputs --skip-program-info %s 2>&1 | FileCheck %s
+
+// CHECK-LABEL: func.func @chained_lookups
+// CHECK:         %[[V0:.*]] = "FHE.apply_lookup_table"(%arg0, %{{.*}}){{.*}} : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<4>
+// CHECK-NEXT:    %[[C0:.*]] = arith.constant 4 : i5
+// CHECK-NEXT:    %[[V1:.*]] = "FHE.mul_eint_int"(%[[V0]], %[[C0]]){{.*}} : (!FHE.eint<4>, i5) -> !FHE.eint<4>
+// CHECK-NEXT:    %[[V2:.*]] = "FHE.reinterpret_precision"(%[[V1]]){{.*}} : (!FHE.eint<4>) -> !FHE.eint<2>
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+// CHECK-NEXT:    %[[V3:.*]] = "FHE.apply_lookup_table"(%[[V2]], %[[LUT]]){{.*}} : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<4>
+// CHECK-NEXT:    return %[[V3]] : !FHE.eint<4>
+func.func @chained_lookups(%arg0: !FHE.eint<4>) -> !FHE.eint<4> {
+  %lut0 = arith.constant dense<[0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3]> : tensor<16xi64>
+  %lut1 = arith.constant dense<[3, 2, 1, 0, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15]> : tensor<16xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<4>)
+  %1 = "FHE.apply_lookup_table"(%0, %lut1): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<4>)
+  return %1: !FHE.eint<4>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @sum_of_lookups
+// CHECK:         %[[V0:.*]] = "FHELinalg.sum"(%{{.*}}){{.*}} : (tensor<4x!FHE.eint<5>>) -> !FHE.eint<5>
+// CHECK-NEXT:    %[[C0:.*]] = arith.constant 4 : i6
+// CHECK-NEXT:    %[[V1:.*]] = "FHE.mul_eint_int"(%[[V0]], %[[C0]]){{.*}} : (!FHE.eint<5>, i6) -> !FHE.eint<5>
+// CHECK-NEXT:    %[[V2:.*]] = "FHE.reinterpret_precision"(%[[V1]]){{.*}} : (!FHE.eint<5>) -> !FHE.eint<3>
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[0, 1, 4, 9, 16, 25, 36, 49]> : tensor<8xi64>
+// CHECK-NEXT:    %[[V3:.*]] = "FHE.apply_lookup_table"(%[[V2]], %[[LUT]]){{.*}} : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<6>
+func.func @sum_of_lookups(%arg0: tensor<4x!FHE.eint<5>>) -> !FHE.eint<6> {
+  %lut0 = arith.constant dense<[0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1]> : tensor<32xi64>
+  %lut1 = arith.constant dense<[0, 1, 4, 9, 16, 25, 36, 49, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]> : tensor<32xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %lut0): (tensor<4x!FHE.eint<5>>, tensor<32xi64>) -> (tensor<4x!FHE.eint<5>>)
+  %1 = "FHELinalg.sum"(%0) : (tensor<4x!FHE.eint<5>>) -> !FHE.eint<5>
+  %2 = "FHE.apply_lookup_table"(%1, %lut1): (!FHE.eint<5>, tensor<32xi64>) -> (!FHE.eint<6>)
+  return %2: !FHE.eint<6>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @tensor_lookup
+// CHECK:         %[[V0:.*]] = "FHELinalg.add_eint_int"(%{{.*}}, %{{.*}}){{.*}} : (tensor<2x!FHE.eint<3>>, tensor<2xi4>) -> tensor<2x!FHE.eint<3>>
+// CHECK-NEXT:    %[[C0:.*]] = arith.constant dense<2> : tensor<2xi4>
+// CHECK-NEXT:    %[[V1:.*]] = "FHELinalg.mul_eint_int"(%[[V0]], %[[C0]]){{.*}} : (tensor<2x!FHE.eint<3>>, tensor<2xi4>) -> tensor<2x!FHE.eint<3>>
+// CHECK-NEXT:    %[[V2:.*]] = "FHELinalg.reinterpret_precision"(%[[V1]]){{.*}} : (tensor<2x!FHE.eint<3>>) -> tensor<2x!FHE.eint<2>>
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi64>
+// CHECK-NEXT:    %[[V3:.*]] = "FHELinalg.apply_lookup_table"(%[[V2]], %[[LUT]]){{.*}} : (tensor<2x!FHE.eint<2>>, tensor<4xi64>) -> tensor<2x!FHE.eint<3>>
+func.func @tensor_lookup(%arg0: tensor<2x!FHE.eint<3>>) -> tensor<2x!FHE.eint<3>> {
+  %lut0 = arith.constant dense<[0, 1, 0, 1, 0, 1, 0, 1]> : tensor<8xi64>
+  %lut1 = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %cst = arith.constant dense<[1, 2]> : tensor<2xi4>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %lut0): (tensor<2x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<2x!FHE.eint<3>>)
+  %1 = "FHELinalg.add_eint_int"(%0, %cst) : (tensor<2x!FHE.eint<3>>, tensor<2xi4>) -> tensor<2x!FHE.eint<3>>
+  %2 = "FHELinalg.apply_lookup_table"(%1, %lut1): (tensor<2x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<2x!FHE.eint<3>>)
+  return %2: tensor<2x!FHE.eint<3>>
+}
+
+// -----
+
+// The inputs of the function may use their whole precision
+// CHECK-LABEL: func.func @unbounded_input
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant
+// CHECK-NEXT:    %[[V0:.*]] = "FHE.apply_lookup_table"(%arg0, %[[LUT]]){{.*}} : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<4>
+// CHECK-NEXT:    return %[[V0]] : !FHE.eint<4>
+func.func @unbounded_input(%arg0: !FHE.eint<4>) -> !FHE.eint<4> {
+  %lut = arith.constant dense<[0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3]> : tensor<16xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<4>)
+  return %0: !FHE.eint<4>
+}
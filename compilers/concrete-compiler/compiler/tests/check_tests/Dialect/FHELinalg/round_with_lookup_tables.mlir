@@ -0,0 +1,46 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-round-with-lookup-tables --round-tlu-max-precision=4 --skip-program-info %s 2>&1 | FileCheck %s
+
+// CHECK-LABEL: func.func @round_in_one_lookup
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0]> : tensor<16xi64>
+// CHECK-NEXT:    %[[V0:.*]] = "FHE.apply_lookup_table"(%arg0, %[[LUT]]){{.*}} : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<1>
+// CHECK-NEXT:    return %[[V0]] : !FHE.eint<1>
+func.func @round_in_one_lookup(%arg0: !FHE.eint<4>) -> !FHE.eint<1> {
+  %0 = "FHE.round"(%arg0) : (!FHE.eint<4>) -> !FHE.eint<1>
+  return %0: !FHE.eint<1>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @round_bits_then_lookup
+// CHECK-NEXT:    %[[C0:.*]] = arith.constant 6 : i7
+// CHECK-NEXT:    %[[V0:.*]] = "FHE.add_eint_int"(%arg0, %[[C0]]){{.*}} : (!FHE.eint<6>, i7) -> !FHE.eint<6>
+// CHECK-NEXT:    %[[V1:.*]] = "FHE.round"(%[[V0]]){{.*}} : (!FHE.eint<6>) -> !FHE.eint<4>
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3]> : tensor<16xi64>
+// CHECK-NEXT:    %[[V2:.*]] = "FHE.apply_lookup_table"(%[[V1]], %[[LUT]]){{.*}} : (!FHE.eint<4>, tensor<16xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:    return %[[V2]] : !FHE.eint<2>
+func.func @round_bits_then_lookup(%arg0: !FHE.eint<6>) -> !FHE.eint<2> {
+  %0 = "FHE.round"(%arg0) : (!FHE.eint<6>) -> !FHE.eint<2>
+  return %0: !FHE.eint<2>
+}
+
+// -----
+
+// A single bit is still removed by the bit by bit rounding
+// CHECK-LABEL: func.func @round_one_bit
+// CHECK-NEXT:    %[[V0:.*]] = "FHE.round"(%arg0){{.*}} : (!FHE.eint<5>) -> !FHE.eint<4>
+// CHECK-NEXT:    return %[[V0]] : !FHE.eint<4>
+func.func @round_one_bit(%arg0: !FHE.eint<5>) -> !FHE.eint<4> {
+  %0 = "FHE.round"(%arg0) : (!FHE.eint<5>) -> !FHE.eint<4>
+  return %0: !FHE.eint<4>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @round_signed_tensor
+// CHECK-NEXT:    %[[LUT:.*]] = arith.constant dense<[0, 0, -1, -1, -1, -1, 0, 0]> : tensor<8xi64>
+// CHECK-NEXT:    %[[V0:.*]] = "FHELinalg.apply_lookup_table"(%arg0, %[[LUT]]){{.*}} : (tensor<4x!FHE.esint<3>>, tensor<8xi64>) -> tensor<4x!FHE.esint<1>>
+// CHECK-NEXT:    return %[[V0]] : tensor<4x!FHE.esint<1>>
+func.func @round_signed_tensor(%arg0: tensor<4x!FHE.esint<3>>) -> tensor<4x!FHE.esint<1>> {
+  %0 = "FHELinalg.round"(%arg0) : (tensor<4x!FHE.esint<3>>) -> tensor<4x!FHE.esint<1>>
+  return %0: tensor<4x!FHE.esint<1>>
+}
@@ -0,0 +1,44 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-linalg-specialize-constant-matmul --specialize-constant-matmul --skip-program-info %s 2>&1 | FileCheck %s
+
+// CHECK-LABEL: func.func @sparse_weights
+// CHECK-NOT:     FHELinalg.matmul_eint_int
+// CHECK-DAG:     %[[CST:.*]] = arith.constant dense<2> : tensor<2xi7>
+// CHECK-DAG:     %[[ZERO:.*]] = "FHE.zero_tensor"() : () -> tensor<2x2x!FHE.eint<6>>
+// CHECK-DAG:     %[[X0:.*]] = tensor.extract_slice %arg0[0, 0] [2, 1] [1, 1] : tensor<2x3x!FHE.eint<6>> to tensor<2x!FHE.eint<6>>
+// CHECK-DAG:     %[[X1:.*]] = tensor.extract_slice %arg0[0, 1] [2, 1] [1, 1] : tensor<2x3x!FHE.eint<6>> to tensor<2x!FHE.eint<6>>
+// CHECK-DAG:     %[[X2:.*]] = tensor.extract_slice %arg0[0, 2] [2, 1] [1, 1] : tensor<2x3x!FHE.eint<6>> to tensor<2x!FHE.eint<6>>
+// CHECK:         %[[C0:.*]] = "FHELinalg.add_eint"(%[[X0]], %[[X1]])
+// CHECK:         %[[R0:.*]] = tensor.insert_slice %[[C0]] into %[[ZERO]][0, 0] [2, 1] [1, 1]
+// CHECK:         %[[S1:.*]] = "FHELinalg.add_eint"(%[[X1]], %[[X2]])
+// CHECK-NEXT:    %[[C1:.*]] = "FHELinalg.mul_eint_int"(%[[S1]], %[[CST]])
+// CHECK-NEXT:    %[[R1:.*]] = tensor.insert_slice %[[C1]] into %[[R0]][0, 1] [2, 1] [1, 1]
+// CHECK-NEXT:    return %[[R1]] : tensor<2x2x!FHE.eint<6>>
+func.func @sparse_weights(%arg0: tensor<2x3x!FHE.eint<6>>) -> tensor<2x2x!FHE.eint<6>> {
+  %weights = arith.constant dense<[[1, 0], [1, 2], [0, 2]]> : tensor<3x2xi7>
+  %0 = "FHELinalg.matmul_eint_int"(%arg0, %weights) : (tensor<2x3x!FHE.eint<6>>, tensor<3x2xi7>) -> tensor<2x2x!FHE.eint<6>>
+  return %0 : tensor<2x2x!FHE.eint<6>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @minus_one_weights
+// CHECK:         %[[S:.*]] = "FHELinalg.add_eint"
+// CHECK-NEXT:    %[[N:.*]] = "FHELinalg.neg_eint"(%[[S]])
+// CHECK-NEXT:    %[[R:.*]] = tensor.insert_slice %[[N]]
+// CHECK-NEXT:    return %[[R]] : tensor<2x1x!FHE.eint<6>>
+func.func @minus_one_weights(%arg0: tensor<2x2x!FHE.eint<6>>) -> tensor<2x1x!FHE.eint<6>> {
+  %weights = arith.constant dense<[[-1], [-1]]> : tensor<2x1xi7>
+  %0 = "FHELinalg.matmul_eint_int"(%arg0, %weights) : (tensor<2x2x!FHE.eint<6>>, tensor<2x1xi7>) -> tensor<2x1x!FHE.eint<6>>
+  return %0 : tensor<2x1x!FHE.eint<6>>
+}
+
+// -----
+
+// The distinct weights would need more operations once specialized
+// CHECK-LABEL: func.func @dense_weights
+// CHECK:         "FHELinalg.matmul_eint_int"
+func.func @dense_weights(%arg0: tensor<2x2x!FHE.eint<6>>) -> tensor<2x2x!FHE.eint<6>> {
+  %weights = arith.constant dense<[[2, 3], [5, 7]]> : tensor<2x2xi7>
+  %0 = "FHELinalg.matmul_eint_int"(%arg0, %weights) : (tensor<2x2x!FHE.eint<6>>, tensor<2x2xi7>) -> tensor<2x2x!FHE.eint<6>>
+  return %0 : tensor<2x2x!FHE.eint<6>>
+}
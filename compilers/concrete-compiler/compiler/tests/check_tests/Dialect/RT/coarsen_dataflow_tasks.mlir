@@ -0,0 +1,26 @@
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize-dataflow | FileCheck %s --check-prefix=NOMERGE
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize-dataflow --dataflow-min-task-work=2000 | FileCheck %s --check-prefix=MERGE
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize-dataflow --dataflow-min-task-work=3001 | FileCheck %s --check-prefix=MERGEALL
+
+// Each table lookup is a task of its own unless tasks are coarsened, in
+// which case pairs of consecutive lookups reach the work threshold. The
+// results of a task are only counted once, through the lookup computing
+// them, so three lookups stay below a threshold just above 3000.
+
+// NOMERGE-COUNT-4: "RT.create_async_task"
+// NOMERGE-NOT:     "RT.create_async_task"
+
+// MERGE-COUNT-2:   "RT.create_async_task"
+// MERGE-NOT:       "RT.create_async_task"
+
+// MERGEALL-COUNT-1: "RT.create_async_task"
+// MERGEALL-NOT:     "RT.create_async_task"
+
+func.func @main(%a: !FHE.eint<3>, %b: !FHE.eint<3>, %c: !FHE.eint<3>, %d: !FHE.eint<3>) -> (!FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>) {
+  %tlu = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%a, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %1 = "FHE.apply_lookup_table"(%b, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %2 = "FHE.apply_lookup_table"(%c, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %3 = "FHE.apply_lookup_table"(%d, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %0, %1, %2, %3 : !FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>, !FHE.eint<3>
+}
@@ -0,0 +1,42 @@
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize --passes hoist-await-future --skip-program-info | FileCheck  %s
+
+func.func @_dfr_DFT_work_function__main0(%arg0: !RT.rtptr<!FHE.eint<6>>, %arg1: !RT.rtptr<!FHE.eint<6>>) attributes {_dfr_work_function_attribute} {
+  return
+}
+
+// CHECK:      %[[Vfutures:.*]] = tensor.empty() : tensor<4x!RT.future<!FHE.eint<6>>>
+// CHECK:      scf.for %[[Varg2:[^ ]*]] = %[[Vc0:[^ ]*]] to %[[Vc4:[^ ]*]] step %[[Vc1:[^ ]*]] iter_args({{.*}}%[[Varg4:[^ ]*]] = %[[Vfutures]])
+// CHECK:        "RT.create_async_task"
+// CHECK-NEXT:   %[[Vfuture:.*]] = "RT.deref_return_ptr_placeholder"
+// CHECK-NEXT:   %[[Vinserted:.*]] = tensor.insert %[[Vfuture]] into %[[Varg4]][%[[Varg2]]] : tensor<4x!RT.future<!FHE.eint<6>>>
+// CHECK-NEXT:   scf.yield {{.*}}%[[Vinserted]] :
+// CHECK-NEXT: }
+// CHECK-NEXT: %[[Vsync:.*]] = scf.for %[[Varg5:[^ ]*]] = %[[Vc0]] to %[[Vc4]] step %[[Vc1]] iter_args(%[[Varg6:[^ ]*]] = %[[V0:[^)]*]]) -> (tensor<4x!FHE.eint<6>>) {
+// CHECK-NEXT:   %[[Vextracted:.*]] = tensor.extract {{.*}}[%[[Varg5]]] : tensor<4x!RT.future<!FHE.eint<6>>>
+// CHECK-NEXT:   %[[Vawait:.*]] = "RT.await_future"(%[[Vextracted]]) : (!RT.future<!FHE.eint<6>>) -> !FHE.eint<6>
+// CHECK-NEXT:   %[[Vres:.*]] = tensor.insert %[[Vawait]] into %[[Varg6]][%[[Varg5]]] : tensor<4x!FHE.eint<6>>
+// CHECK-NEXT:   scf.yield %[[Vres]] : tensor<4x!FHE.eint<6>>
+// CHECK-NEXT: }
+// CHECK-NEXT: return %[[Vsync]] : tensor<4x!FHE.eint<6>>
+func.func @main(%arg0: tensor<4x!FHE.eint<6>>) -> tensor<4x!FHE.eint<6>> {
+  %f = constant @_dfr_DFT_work_function__main0 : (!RT.rtptr<!FHE.eint<6>>, !RT.rtptr<!FHE.eint<6>>) -> ()
+  "RT.register_task_work_function"(%f) : ((!RT.rtptr<!FHE.eint<6>>, !RT.rtptr<!FHE.eint<6>>) -> ()) -> ()
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = "FHE.zero_tensor"() : () -> tensor<4x!FHE.eint<6>>
+  %1 = scf.for %arg2 = %c0 to %c4 step %c1 iter_args(%arg3 = %0) -> (tensor<4x!FHE.eint<6>>) {
+    %extracted = tensor.extract %arg0[%arg2] : tensor<4x!FHE.eint<6>>
+    %c0_i64 = arith.constant 0 : i64
+    %2 = "RT.make_ready_future"(%extracted, %c0_i64) : (!FHE.eint<6>, i64) -> !RT.future<!FHE.eint<6>>
+    %f_0 = func.constant @_dfr_DFT_work_function__main0 : (!RT.rtptr<!FHE.eint<6>>, !RT.rtptr<!FHE.eint<6>>) -> ()
+    %c1_i64 = arith.constant 1 : i64
+    %3 = "RT.build_return_ptr_placeholder"() : () -> !RT.rtptr<!RT.future<!FHE.eint<6>>>
+    "RT.create_async_task"(%f_0, %c1_i64, %c1_i64, %3, %2) {workfn = @_dfr_DFT_work_function__main0} : ((!RT.rtptr<!FHE.eint<6>>, !RT.rtptr<!FHE.eint<6>>) -> (), i64, i64, !RT.rtptr<!RT.future<!FHE.eint<6>>>, !RT.future<!FHE.eint<6>>) -> ()
+    %4 = "RT.deref_return_ptr_placeholder"(%3) : (!RT.rtptr<!RT.future<!FHE.eint<6>>>) -> !RT.future<!FHE.eint<6>>
+    %5 = "RT.await_future"(%4) : (!RT.future<!FHE.eint<6>>) -> !FHE.eint<6>
+    %6 = tensor.insert %5 into %arg3[%arg2] : tensor<4x!FHE.eint<6>>
+    scf.yield %6 : tensor<4x!FHE.eint<6>>
+  }
+  return %1 : tensor<4x!FHE.eint<6>>
+}
@@ -0,0 +1,39 @@
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize-dataflow --passes BuildDataflowTaskGraph --skip-program-info | FileCheck %s --check-prefix=LOOP
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize-dataflow --passes BuildDataflowTaskGraph --skip-program-info --dataflow-unroll-factor=8 | FileCheck %s --check-prefix=FULL
+// RUN: concretecompiler --action=dump-fhe-df-parallelized %s --optimizer-strategy=dag-mono --parallelize-dataflow --passes BuildDataflowTaskGraph --skip-program-info --dataflow-unroll-factor=2 | FileCheck %s --check-prefix=CHUNK
+
+// Without unrolling, the lookup of the loop body is a single task, created
+// at each iteration.
+
+// LOOP:          scf.for
+// LOOP:            "RT.dataflow_task"
+// LOOP-NOT:        "RT.dataflow_task"
+
+// With a factor covering the trip count, the loop is fully unrolled into
+// a task per iteration.
+
+// FULL-NOT:      scf.for
+// FULL-COUNT-4:  "RT.dataflow_task"
+// FULL-NOT:      "RT.dataflow_task"
+// FULL-NOT:      scf.for
+
+// Otherwise, the loop iterates over chunks of iterations, a task per
+// iteration of a chunk.
+
+// CHUNK:         scf.for
+// CHUNK-COUNT-2:   "RT.dataflow_task"
+// CHUNK-NOT:       "RT.dataflow_task"
+
+func.func @main(%arg0: tensor<4x!FHE.eint<3>>) -> tensor<4x!FHE.eint<3>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %tlu = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi64>
+  %0 = scf.for %i = %c0 to %c4 step %c1 iter_args(%t = %arg0) -> (tensor<4x!FHE.eint<3>>) {
+    %1 = tensor.extract %t[%i] : tensor<4x!FHE.eint<3>>
+    %2 = "FHE.apply_lookup_table"(%1, %tlu) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+    %3 = tensor.insert %2 into %t[%i] : tensor<4x!FHE.eint<3>>
+    scf.yield %3 : tensor<4x!FHE.eint<3>>
+  }
+  return %0 : tensor<4x!FHE.eint<3>>
+}
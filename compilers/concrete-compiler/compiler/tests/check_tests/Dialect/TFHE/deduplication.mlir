@@ -0,0 +1,91 @@
+// RUN: concretecompiler --passes tfhe-deduplication --action=dump-parametrized-tfhe --split-input-file --skip-program-info %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @keyswitch(%arg0: !TFHE.glwe<sk[1]<1024,1>>) -> (!TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>)
+func.func @keyswitch(%arg0: !TFHE.glwe<sk[1]<1024,1>>) -> (!TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>) {
+  // CHECK-NEXT: %[[V0:.*]] = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1024,1>, sk[1]<527,1>, 4, 4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  // CHECK-NEXT: return %[[V0]], %[[V0]] : !TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  %1 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  return %0, %1 : !TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @keyswitch_different_keys(%arg0: !TFHE.glwe<sk[1]<1024,1>>) -> (!TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>)
+func.func @keyswitch_different_keys(%arg0: !TFHE.glwe<sk[1]<1024,1>>) -> (!TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>) {
+  // CHECK-NEXT: %[[V0:.*]] = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1024,1>, sk[1]<527,1>, 4, 4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  // CHECK-NEXT: %[[V1:.*]] = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1024,1>, sk[1]<527,1>, 3, 5>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  // CHECK-NEXT: return %[[V0]], %[[V1]] : !TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  %1 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,3,5>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  return %0, %1 : !TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @bootstrap_equal_luts(%arg0: !TFHE.glwe<sk[1]<527,1>>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>)
+func.func @bootstrap_equal_luts(%arg0: !TFHE.glwe<sk[1]<527,1>>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>) {
+  // CHECK:      %[[V0:.*]] = "TFHE.bootstrap_glwe"
+  // CHECK-NOT:  "TFHE.bootstrap_glwe"
+  // CHECK:      return %[[V0]], %[[V0]] : !TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>
+  %lut0 = arith.constant dense<1> : tensor<512xi64>
+  %lut1 = arith.constant dense<1> : tensor<512xi64>
+  %0 = "TFHE.bootstrap_glwe"(%arg0, %lut0) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+  %1 = "TFHE.bootstrap_glwe"(%arg0, %lut1) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+  return %0, %1 : !TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @bootstrap_different_luts(%arg0: !TFHE.glwe<sk[1]<527,1>>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>)
+func.func @bootstrap_different_luts(%arg0: !TFHE.glwe<sk[1]<527,1>>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>) {
+  // CHECK:      %[[V0:.*]] = "TFHE.bootstrap_glwe"
+  // CHECK-NEXT: %[[V1:.*]] = "TFHE.bootstrap_glwe"
+  // CHECK-NEXT: return %[[V0]], %[[V1]] : !TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>
+  %lut0 = arith.constant dense<1> : tensor<512xi64>
+  %lut1 = arith.constant dense<2> : tensor<512xi64>
+  %0 = "TFHE.bootstrap_glwe"(%arg0, %lut0) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+  %1 = "TFHE.bootstrap_glwe"(%arg0, %lut1) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+  return %0, %1 : !TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @keyswitch_through_tensor(%arg0: !TFHE.glwe<sk[1]<1024,1>>, %arg1: tensor<2x!TFHE.glwe<sk[1]<1024,1>>>) -> (!TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>)
+func.func @keyswitch_through_tensor(%arg0: !TFHE.glwe<sk[1]<1024,1>>, %arg1: tensor<2x!TFHE.glwe<sk[1]<1024,1>>>) -> (!TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>) {
+  // CHECK:      %[[V0:.*]] = "TFHE.keyswitch_glwe"(%arg0)
+  // CHECK-NOT:  "TFHE.keyswitch_glwe"
+  // CHECK:      return %[[V0]], %[[V0]] : !TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  %1 = tensor.insert %arg0 into %arg1[%c0] : tensor<2x!TFHE.glwe<sk[1]<1024,1>>>
+  %2 = tensor.insert %arg0 into %1[%c1] : tensor<2x!TFHE.glwe<sk[1]<1024,1>>>
+  %3 = tensor.extract %2[%c0] : tensor<2x!TFHE.glwe<sk[1]<1024,1>>>
+  %4 = "TFHE.keyswitch_glwe"(%3) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  return %0, %4 : !TFHE.glwe<sk[1]<527,1>>, !TFHE.glwe<sk[1]<527,1>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @keyswitch_shared_across_branches(%arg0: !TFHE.glwe<sk[1]<1024,1>>, %arg1: i1) -> !TFHE.glwe<sk[1]<527,1>>
+func.func @keyswitch_shared_across_branches(%arg0: !TFHE.glwe<sk[1]<1024,1>>, %arg1: i1) -> !TFHE.glwe<sk[1]<527,1>> {
+  // CHECK-NEXT: %[[V0:.*]] = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1024,1>, sk[1]<527,1>, 4, 4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  // CHECK-NOT:  "TFHE.keyswitch_glwe"
+  // CHECK:      "TFHE.bootstrap_glwe"(%[[V0]]
+  // CHECK-NOT:  "TFHE.keyswitch_glwe"
+  // CHECK:      "TFHE.bootstrap_glwe"(%[[V0]]
+  %lut0 = arith.constant dense<1> : tensor<512xi64>
+  %lut1 = arith.constant dense<2> : tensor<512xi64>
+  %0 = scf.if %arg1 -> !TFHE.glwe<sk[1]<1024,1>> {
+    %1 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+    %2 = "TFHE.bootstrap_glwe"(%1, %lut0) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+    scf.yield %2 : !TFHE.glwe<sk[1]<1024,1>>
+  } else {
+    %1 = "TFHE.keyswitch_glwe"(%arg0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+    %2 = "TFHE.bootstrap_glwe"(%1, %lut1) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+    scf.yield %2 : !TFHE.glwe<sk[1]<1024,1>>
+  }
+  %3 = "TFHE.keyswitch_glwe"(%0) {key=#TFHE.ksk<sk[1]<1024,1>,sk[1]<527,1>,4,4>} : (!TFHE.glwe<sk[1]<1024,1>>) -> !TFHE.glwe<sk[1]<527,1>>
+  return %3 : !TFHE.glwe<sk[1]<527,1>>
+}
@@ -0,0 +1,19 @@
+// RUN: concretecompiler --passes canonicalize --action=dump-parametrized-tfhe --skip-program-info %s 2>&1| FileCheck %s
+
+// The encoding of a constant lookup table is folded into a constant, the
+// first value being centered over zero
+// CHECK-LABEL: func.func @constant_lut
+// CHECK-NEXT: %[[LUT:.*]] = arith.constant dense<[2305843009213693952, 0, 0, 4611686018427387904, 4611686018427387904, 6917529027641081856, 6917529027641081856, -2305843009213693952]> : tensor<8xi64>
+// CHECK-NEXT: return %[[LUT]]
+func.func @constant_lut() -> tensor<8xi64> {
+  %cst = arith.constant dense<[1, 0, 2, 3]> : tensor<4xi64>
+  %0 = "TFHE.encode_expand_lut_for_bootstrap"(%cst) {isSigned = false, outputBits = 2 : i32, polySize = 8 : i32} : (tensor<4xi64>) -> tensor<8xi64>
+  return %0 : tensor<8xi64>
+}
+
+// CHECK-LABEL: func.func @dynamic_lut
+// CHECK-NEXT: "TFHE.encode_expand_lut_for_bootstrap"(%arg0)
+func.func @dynamic_lut(%arg0: tensor<4xi64>) -> tensor<8xi64> {
+  %0 = "TFHE.encode_expand_lut_for_bootstrap"(%arg0) {isSigned = false, outputBits = 2 : i32, polySize = 8 : i32} : (tensor<4xi64>) -> tensor<8xi64>
+  return %0 : tensor<8xi64>
+}
@@ -0,0 +1,18 @@
+// RUN: concretecompiler --passes canonicalize --action=dump-parametrized-tfhe --skip-program-info %s 2>&1| FileCheck %s
+
+// The encoding of a constant lookup table is folded into a constant
+// CHECK-LABEL: func.func @constant_lut
+// CHECK-NEXT: %[[LUT:.*]] = arith.constant dense<{{\[}}[0, -9223372036854775808, 0, -9223372036854775808, 0, 0, 0, 0], [0, 0, 0, 6148914691236517205, -6148914691236517206, 0, 0, 0]]> : tensor<2x8xi64>
+// CHECK-NEXT: return %[[LUT]]
+func.func @constant_lut() -> tensor<2x8xi64> {
+  %cst = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "TFHE.encode_lut_for_crt_woppbs"(%cst) {crtBits = [1, 2], crtDecomposition = [2, 3], isSigned = false, modulusProduct = 6 : i32} : (tensor<4xi64>) -> tensor<2x8xi64>
+  return %0 : tensor<2x8xi64>
+}
+
+// CHECK-LABEL: func.func @dynamic_lut
+// CHECK-NEXT: "TFHE.encode_lut_for_crt_woppbs"(%arg0)
+func.func @dynamic_lut(%arg0: tensor<4xi64>) -> tensor<2x8xi64> {
+  %0 = "TFHE.encode_lut_for_crt_woppbs"(%arg0) {crtBits = [1, 2], crtDecomposition = [2, 3], isSigned = false, modulusProduct = 6 : i32} : (tensor<4xi64>) -> tensor<2x8xi64>
+  return %0 : tensor<2x8xi64>
+}
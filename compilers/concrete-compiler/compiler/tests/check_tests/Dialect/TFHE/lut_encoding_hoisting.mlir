@@ -0,0 +1,57 @@
+// RUN: concretecompiler --passes tfhe-lut-encoding-hoisting --action=dump-parametrized-tfhe --split-input-file --skip-program-info %s 2>&1| FileCheck %s
+
+// The lookup table is the same for all the iterations, it is encoded once
+// before the outermost loop
+// CHECK-LABEL: func.func @invariant
+// CHECK: %[[LUT:.*]] = "TFHE.encode_expand_lut_for_bootstrap"(%arg1)
+// CHECK: scf.for
+// CHECK: scf.for
+// CHECK-NOT: TFHE.encode_expand_lut_for_bootstrap
+// CHECK: "TFHE.bootstrap_glwe"(%{{.*}}, %[[LUT]])
+func.func @invariant(%arg0: tensor<4x4x!TFHE.glwe<sk[1]<527,1>>>, %arg1: tensor<4xi64>) -> tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = "tensor.empty"() : () -> tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+  %1 = scf.for %i = %c0 to %c4 step %c1 iter_args(%acc0 = %0) -> (tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>) {
+    %2 = scf.for %j = %c0 to %c4 step %c1 iter_args(%acc1 = %acc0) -> (tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>) {
+      %3 = tensor.extract %arg0[%i, %j] : tensor<4x4x!TFHE.glwe<sk[1]<527,1>>>
+      %4 = "TFHE.encode_expand_lut_for_bootstrap"(%arg1) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+      %5 = "TFHE.bootstrap_glwe"(%3, %4) {key = #TFHE.bsk<sk[1]<527,1>, sk[1]<1024,1>, 1024, 1, 2, 8>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+      %6 = tensor.insert %5 into %acc1[%i, %j] : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+      scf.yield %6 : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+    }
+    scf.yield %2 : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+  }
+  return %1 : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+}
+
+// -----
+
+// The lookup table depends on the outer loop, it is encoded once per
+// iteration of the outer loop
+// CHECK-LABEL: func.func @outer_dependent
+// CHECK: scf.for
+// CHECK: tensor.extract_slice
+// CHECK: %[[LUT:.*]] = "TFHE.encode_expand_lut_for_bootstrap"
+// CHECK: scf.for
+// CHECK-NOT: TFHE.encode_expand_lut_for_bootstrap
+// CHECK: "TFHE.bootstrap_glwe"(%{{.*}}, %[[LUT]])
+func.func @outer_dependent(%arg0: tensor<4x4x!TFHE.glwe<sk[1]<527,1>>>, %arg1: tensor<4x4xi64>) -> tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = "tensor.empty"() : () -> tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+  %1 = scf.for %i = %c0 to %c4 step %c1 iter_args(%acc0 = %0) -> (tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>) {
+    %lut = tensor.extract_slice %arg1[%i, 0] [1, 4] [1, 1] : tensor<4x4xi64> to tensor<4xi64>
+    %2 = scf.for %j = %c0 to %c4 step %c1 iter_args(%acc1 = %acc0) -> (tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>) {
+      %3 = tensor.extract %arg0[%i, %j] : tensor<4x4x!TFHE.glwe<sk[1]<527,1>>>
+      %4 = "TFHE.encode_expand_lut_for_bootstrap"(%lut) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+      %5 = "TFHE.bootstrap_glwe"(%3, %4) {key = #TFHE.bsk<sk[1]<527,1>, sk[1]<1024,1>, 1024, 1, 2, 8>} : (!TFHE.glwe<sk[1]<527,1>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+      %6 = tensor.insert %5 into %acc1[%i, %j] : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+      scf.yield %6 : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+    }
+    scf.yield %2 : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+  }
+  return %1 : tensor<4x4x!TFHE.glwe<sk[1]<1024,1>>>
+}
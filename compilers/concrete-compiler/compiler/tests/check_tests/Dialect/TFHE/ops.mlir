@@ -16,3 +16,19 @@ func.func @bootstrap_glwe(%glwe: !TFHE.glwe<sk[1]<527,1>>, %lut: tensor<512xi64>
     return %0 : !TFHE.glwe<sk[1]<1024,1>>
 }
 
+// CHECK: func.func @multi_bit_bootstrap_glwe(%[[GLWE:.*]]: !TFHE.glwe<sk[1]<528,1>>, %[[LUT:.*]]: tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>> {
+func.func @multi_bit_bootstrap_glwe(%glwe: !TFHE.glwe<sk[1]<528,1>>, %lut: tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>> {
+    // CHECK-NEXT: %[[V0:.*]] = "TFHE.bootstrap_glwe"(%[[GLWE]], %[[LUT]]) {key = #TFHE.bsk<sk[1]<528,1>, sk[1]<1024,1>, 512, 2, 4, 4, 3>} : (!TFHE.glwe<sk[1]<528,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+    // CHECK-NEXT: return %[[V0]] : !TFHE.glwe<sk[1]<1024,1>>
+    %0 = "TFHE.bootstrap_glwe"(%glwe, %lut) {key=#TFHE.bsk<sk[1]<528,1>,sk[1]<1024,1>,512,2,4,4,3>} : (!TFHE.glwe<sk[1]<528,1>>, tensor<512xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+    return %0 : !TFHE.glwe<sk[1]<1024,1>>
+}
+
+// CHECK: func.func @many_lut_bootstrap_glwe(%[[GLWE:.*]]: !TFHE.glwe<sk[1]<527,1>>, %[[LUT:.*]]: tensor<512xi64>) -> tensor<4x!TFHE.glwe<sk[1]<1024,1>>> {
+func.func @many_lut_bootstrap_glwe(%glwe: !TFHE.glwe<sk[1]<527,1>>, %lut: tensor<512xi64>) -> tensor<4x!TFHE.glwe<sk[1]<1024,1>>> {
+    // CHECK-NEXT: %[[V0:.*]] = "TFHE.many_lut_bootstrap_glwe"(%[[GLWE]], %[[LUT]]) {key = #TFHE.bsk<sk[1]<527,1>, sk[1]<1024,1>, 512, 2, 4, 4>, lutCount = 4 : i32, lutStride = 16 : i32} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> tensor<4x!TFHE.glwe<sk[1]<1024,1>>>
+    // CHECK-NEXT: return %[[V0]] : tensor<4x!TFHE.glwe<sk[1]<1024,1>>>
+    %0 = "TFHE.many_lut_bootstrap_glwe"(%glwe, %lut) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>, lutCount = 4 : i32, lutStride = 16 : i32} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> tensor<4x!TFHE.glwe<sk[1]<1024,1>>>
+    return %0 : tensor<4x!TFHE.glwe<sk[1]<1024,1>>>
+}
+
@@ -323,3 +323,32 @@ func.func @apply_lookup_table_contiguous_hoistable_nonbatchable(%arg0: tensor<2x
   }
   return %1 : tensor<2x3x4x!TFHE.glwe<sk<0,1,2048>>>
 }
+
+// -----
+
+// CHECK-LABEL: func.func @batch_straight_line
+// CHECK:      %[[V0:.*]] = tensor.from_elements %arg0, %arg1 : tensor<2x!TFHE.glwe<sk{{\[}}[[SK_IN:.*]]{{\]}}<1,2048>>>
+// CHECK-NEXT: %[[V1:.*]] = "TFHE.batched_keyswitch_glwe"(%[[V0]])
+// CHECK-NOT:  "TFHE.keyswitch_glwe"
+// CHECK:      %[[V2:.*]] = "TFHE.batched_bootstrap_glwe"
+// CHECK-NOT:  "TFHE.bootstrap_glwe"
+// CHECK:      return
+func.func @batch_straight_line(%arg0: !TFHE.glwe<sk<0,1,2048>>, %arg1: !TFHE.glwe<sk<0,1,2048>>, %arg2: tensor<1024xi64>) -> (!TFHE.glwe<sk<0,1,2048>>, !TFHE.glwe<sk<0,1,2048>>) {
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>} : (!TFHE.glwe<sk<0,1,2048>>) -> !TFHE.glwe<sk<1,1,750>>
+  %1 = "TFHE.bootstrap_glwe"(%0, %arg2) {key = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk<1,1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk<0,1,2048>>
+  %2 = "TFHE.keyswitch_glwe"(%arg1) {key = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>} : (!TFHE.glwe<sk<0,1,2048>>) -> !TFHE.glwe<sk<1,1,750>>
+  %3 = "TFHE.bootstrap_glwe"(%2, %arg2) {key = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk<1,1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk<0,1,2048>>
+  return %1, %3 : !TFHE.glwe<sk<0,1,2048>>, !TFHE.glwe<sk<0,1,2048>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @no_batch_straight_line_dependent
+// CHECK-NOT:  "TFHE.batched_bootstrap_glwe"
+func.func @no_batch_straight_line_dependent(%arg0: !TFHE.glwe<sk<1,1,750>>, %arg1: tensor<1024xi64>) -> !TFHE.glwe<sk<1,1,750>> {
+  %0 = "TFHE.bootstrap_glwe"(%arg0, %arg1) {key = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk<1,1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk<0,1,2048>>
+  %1 = "TFHE.keyswitch_glwe"(%0) {key = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>} : (!TFHE.glwe<sk<0,1,2048>>) -> !TFHE.glwe<sk<1,1,750>>
+  %2 = "TFHE.bootstrap_glwe"(%1, %arg1) {key = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk<1,1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk<0,1,2048>>
+  %3 = "TFHE.keyswitch_glwe"(%2) {key = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>} : (!TFHE.glwe<sk<0,1,2048>>) -> !TFHE.glwe<sk<1,1,750>>
+  return %3 : !TFHE.glwe<sk<1,1,750>>
+}
@@ -0,0 +1,25 @@
+// RUN: concretecompiler --split-input-file --action=dump-std --parallelize-loops --skip-program-info --passes=collapse-parallel-loops %s 2>&1| FileCheck %s
+
+// The index computation between the loops is sunk into the inner loop, so
+// that both loops are collapsed into a single one
+// CHECK-LABEL: func.func @nested
+// CHECK:         scf.for
+// CHECK-NOT:     scf.for
+// CHECK:         return
+func.func @nested(%arg0: memref<32xi64>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c16 = arith.constant 16 : index
+  %i1 = arith.constant 1 : i64
+  scf.for %i = %c0 to %c2 step %c1 {
+    %base = arith.muli %i, %c16 : index
+    scf.for %j = %c0 to %c16 step %c1 {
+      %k = arith.addi %base, %j : index
+      %x = memref.load %arg0[%k] : memref<32xi64>
+      %y = arith.addi %x, %i1 : i64
+      memref.store %y, %arg0[%k] : memref<32xi64>
+    } {"parallel" = true }
+  } {"parallel" = true }
+  return
+}
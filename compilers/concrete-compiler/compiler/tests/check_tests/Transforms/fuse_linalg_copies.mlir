@@ -0,0 +1,25 @@
+// RUN: concretecompiler --split-input-file --action=dump-tfhe --passes fhe-tensor-ops-to-linalg --passes fuse-linalg-copies --skip-program-info %s 2>&1| FileCheck %s
+
+// The addition reads the transposed elements from the input of the transpose
+// CHECK: #[[$MAP0:.*]] = affine_map<(d0, d1) -> (d1, d0)>
+// CHECK: #[[$MAP1:.*]] = affine_map<(d0, d1) -> (d0, d1)>
+// CHECK-LABEL: func.func @transpose_add
+// CHECK: linalg.generic {indexing_maps = [#[[$MAP0]], #[[$MAP1]], #[[$MAP1]]]
+// CHECK: "FHE.add_eint"
+// CHECK-NOT: linalg.generic
+func.func @transpose_add(%arg0: tensor<2x3x!FHE.eint<7>>, %arg1: tensor<3x2x!FHE.eint<7>>) -> tensor<3x2x!FHE.eint<7>> {
+  %0 = "FHELinalg.transpose"(%arg0) : (tensor<2x3x!FHE.eint<7>>) -> tensor<3x2x!FHE.eint<7>>
+  %1 = "FHELinalg.add_eint"(%0, %arg1) : (tensor<3x2x!FHE.eint<7>>, tensor<3x2x!FHE.eint<7>>) -> tensor<3x2x!FHE.eint<7>>
+  return %1 : tensor<3x2x!FHE.eint<7>>
+}
+
+// -----
+
+// The transposed tensor is returned, so it is materialized
+// CHECK-LABEL: func.func @transpose
+// CHECK: linalg.generic
+// CHECK: linalg.yield
+func.func @transpose(%arg0: tensor<2x3x!FHE.eint<7>>) -> tensor<3x2x!FHE.eint<7>> {
+  %0 = "FHELinalg.transpose"(%arg0) : (tensor<2x3x!FHE.eint<7>>) -> tensor<3x2x!FHE.eint<7>>
+  return %0 : tensor<3x2x!FHE.eint<7>>
+}
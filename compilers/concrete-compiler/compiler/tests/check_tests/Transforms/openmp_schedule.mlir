@@ -0,0 +1,37 @@
+// RUN: concretecompiler --split-input-file --action=dump-std --parallelize-loops --skip-program-info --passes=for-loop-to-parallel --passes=convert-scf-to-openmp --passes=openmp-schedule %s 2>&1| FileCheck %s
+
+func.func private @memref_bootstrap_lwe_u64(memref<?xi64>, memref<?xi64>)
+
+// CHECK-LABEL: func.func @bootstraps
+// CHECK:         omp.wsloop schedule(dynamic
+func.func @bootstraps(%arg0: memref<8x?xi64>, %arg1: memref<8x?xi64>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  scf.for %iv = %c0 to %c8 step %c1 {
+    %in = memref.subview %arg0[%iv, 0] [1, 1025] [1, 1] : memref<8x?xi64> to memref<1025xi64, strided<[1], offset: ?>>
+    %out = memref.subview %arg1[%iv, 0] [1, 1025] [1, 1] : memref<8x?xi64> to memref<1025xi64, strided<[1], offset: ?>>
+    %in_cast = memref.cast %in : memref<1025xi64, strided<[1], offset: ?>> to memref<?xi64>
+    %out_cast = memref.cast %out : memref<1025xi64, strided<[1], offset: ?>> to memref<?xi64>
+    func.call @memref_bootstrap_lwe_u64(%out_cast, %in_cast) : (memref<?xi64>, memref<?xi64>) -> ()
+  } {"parallel" = true }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func.func @increments
+// CHECK:         omp.wsloop
+// CHECK-NOT:     schedule
+func.func @increments(%arg0: memref<64xi64>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  %i1 = arith.constant 1 : i64
+  scf.for %iv = %c0 to %c64 step %c1 {
+    %x = memref.load %arg0[%iv] : memref<64xi64>
+    %y = arith.addi %x, %i1 : i64
+    memref.store %y, %arg0[%iv] : memref<64xi64>
+  } {"parallel" = true }
+  return
+}
@@ -16,3 +16,71 @@ func.func @bar() -> () {
   
   return
 }
+
+// -----
+
+// CHECK-LABEL: func.func @sum
+// CHECK:         %[[R:.*]] = scf.parallel (%[[IV:.*]]) = (%{{.*}}) to (%{{.*}}) step (%{{.*}}) init (%{{.*}}) -> i32 {
+// CHECK-NEXT:      %[[X:.*]] = memref.load %arg0[%[[IV]]] : memref<4xi32>
+// CHECK-NEXT:      scf.reduce(%[[X]])
+// CHECK-NEXT:      ^bb0(%[[LHS:.*]]: i32, %[[RHS:.*]]: i32):
+// CHECK-NEXT:        %[[S:.*]] = arith.addi %[[LHS]], %[[RHS]] : i32
+// CHECK-NEXT:        scf.reduce.return %[[S]] : i32
+// CHECK:         return %[[R]] : i32
+func.func @sum(%arg0: memref<4xi32>) -> i32 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %i0 = arith.constant 0 : i32
+
+  %0 = scf.for %iv = %c0 to %c4 step %c1 iter_args(%ia = %i0) -> i32 {
+    %x = memref.load %arg0[%iv] : memref<4xi32>
+    %yld = arith.addi %ia, %x : i32
+    scf.yield %yld : i32
+  } {"parallel" = false }
+
+  return %0 : i32
+}
+
+// -----
+
+// CHECK-LABEL: func.func @sum_with_store
+// CHECK-NOT: scf.parallel
+func.func @sum_with_store(%arg0: memref<4xi32>) -> i32 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %i0 = arith.constant 0 : i32
+
+  %0 = scf.for %iv = %c0 to %c4 step %c1 iter_args(%ia = %i0) -> i32 {
+    %x = memref.load %arg0[%iv] : memref<4xi32>
+    %yld = arith.addi %ia, %x : i32
+    memref.store %yld, %arg0[%iv] : memref<4xi32>
+    scf.yield %yld : i32
+  } {"parallel" = false }
+
+  return %0 : i32
+}
+
+// -----
+
+// The encrypted accumulations are bufferized, each iteration writing the
+// accumulator to a buffer, and are not reduced by this pass, but split before
+// the bufferization by fhe-split-reductions
+
+// CHECK-LABEL: func.func @encrypted_sum
+// CHECK-NOT: scf.parallel
+func.func @encrypted_sum(%arg0: memref<4x2049xi64>, %init: memref<2049xi64>) -> memref<2049xi64> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+
+  %0 = scf.for %iv = %c0 to %c4 step %c1 iter_args(%acc = %init) -> memref<2049xi64> {
+    %ct = memref.subview %arg0[%iv, 0] [1, 2049] [1, 1] : memref<4x2049xi64> to memref<2049xi64, strided<[1], offset: ?>>
+    %sum = memref.alloc() : memref<2049xi64>
+    "Concrete.add_lwe_buffer"(%sum, %acc, %ct) : (memref<2049xi64>, memref<2049xi64>, memref<2049xi64, strided<[1], offset: ?>>) -> ()
+    scf.yield %sum : memref<2049xi64>
+  } {"parallel" = false }
+
+  return %0 : memref<2049xi64>
+}
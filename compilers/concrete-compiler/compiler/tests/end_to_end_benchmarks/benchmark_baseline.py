@@ -0,0 +1,183 @@
+"""Records the results of benchmarks as a baseline and compares new results to it.
+
+The results are the JSON outputs of the Google Benchmark programs (e.g.
+`end_to_end_benchmark --benchmark_out_format=json`), preferably with
+`--benchmark_repetitions` so that each benchmark has several samples.
+
+    record RESULTS... --baseline FILE
+        stores the samples of the benchmarks, their labels (the parameter sets
+        of the keysets for the end-to-end benchmarks) and the fingerprint of the
+        machine they ran on.
+
+    compare RESULTS... --baseline FILE
+        reports, for each benchmark of the baseline, the change of its median
+        time, and flags as regressions the benchmarks slower with a p-value of
+        the Mann-Whitney U test below --alpha and by more than --threshold.
+        Exits with 1 if there is a regression.
+"""
+
+import argparse
+import json
+import math
+import statistics
+import sys
+
+# The fields of the benchmark context identifying the machine
+FINGERPRINT = [
+    "host_name",
+    "num_cpus",
+    "mhz_per_cpu",
+    "cpu_scaling_enabled",
+    "caches",
+    "library_build_type",
+    "fft_backend",
+]
+
+UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1}
+
+# The smallest number of samples on each side for the test to be meaningful
+MIN_SAMPLES = 3
+
+
+def load(paths):
+    """Returns the fingerprint and the benchmarks of the results in
+    `paths`, the samples of a benchmark being its times in seconds."""
+    fingerprint = None
+    benchmarks = {}
+    for path in paths:
+        with open(path) as f:
+            results = json.load(f)
+        context = results.get("context", {})
+        current = {k: context[k] for k in FINGERPRINT if k in context}
+        if fingerprint is None:
+            fingerprint = current
+        elif fingerprint != current:
+            sys.exit("error: %s was not run on the same machine as %s" %
+                     (path, paths[0]))
+        for b in results["benchmarks"]:
+            # The aggregates (mean, median, ...) of the repetitions are
+            # recomputed from the samples
+            if b.get("run_type", "iteration") != "iteration":
+                continue
+            name = b.get("run_name", b["name"])
+            entry = benchmarks.setdefault(name, {
+                "label": b.get("label", ""),
+                "samples": []
+            })
+            entry["samples"].append(b["real_time"] * UNITS[b["time_unit"]])
+    return fingerprint or {}, benchmarks
+
+
+def mann_whitney_u(xs, ys):
+    """Returns the two-sided p-value of the Mann-Whitney U test of `xs` and
+    `ys`, with the normal approximation corrected for ties."""
+    values = sorted([(v, 0) for v in xs] + [(v, 1) for v in ys])
+    n = len(values)
+    ranks = [0.0] * n
+    ties = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        t = j - i + 1
+        ties += t**3 - t
+        i = j + 1
+    n1, n2 = len(xs), len(ys)
+    r1 = sum(r for r, (_, side) in zip(ranks, values) if side == 0)
+    u = r1 - n1 * (n1 + 1) / 2
+    mean = n1 * n2 / 2
+    variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def record(args):
+    fingerprint, benchmarks = load(args.results)
+    with open(args.baseline, "w") as f:
+        json.dump({"fingerprint": fingerprint, "benchmarks": benchmarks},
+                  f,
+                  indent=2)
+    print("recorded %d benchmarks in %s" % (len(benchmarks), args.baseline))
+    return 0
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    fingerprint, benchmarks = load(args.results)
+    if fingerprint != baseline["fingerprint"]:
+        print("warning: the machine differs from the one of the baseline:",
+              file=sys.stderr)
+        for k in FINGERPRINT:
+            if fingerprint.get(k) != baseline["fingerprint"].get(k):
+                print("  %s: %s (baseline %s)" %
+                      (k, fingerprint.get(k), baseline["fingerprint"].get(k)),
+                      file=sys.stderr)
+        if args.strict:
+            return 2
+
+    regressions = 0
+    print("%-12s %12s %12s %8s %8s  %s" %
+          ("status", "baseline (s)", "current (s)", "change", "p-value",
+           "benchmark"))
+    for name, base in sorted(baseline["benchmarks"].items()):
+        current = benchmarks.get(name)
+        if current is None:
+            print("%-12s %12s %12s %8s %8s  %s" %
+                  ("missing", "", "", "", "", name))
+            continue
+        before = statistics.median(base["samples"])
+        after = statistics.median(current["samples"])
+        change = after / before - 1
+        enough = (len(base["samples"]) >= MIN_SAMPLES
+                  and len(current["samples"]) >= MIN_SAMPLES)
+        p = mann_whitney_u(base["samples"],
+                           current["samples"]) if enough else float("nan")
+        if current["label"] != base["label"]:
+            # The times of different parameter sets are not comparable
+            status = "parameters"
+        elif not enough:
+            status = "few samples"
+        elif p < args.alpha and change > args.threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif p < args.alpha and change < -args.threshold:
+            status = "improvement"
+        else:
+            status = "unchanged"
+        print("%-12s %12.6f %12.6f %+7.1f%% %8.4f  %s" %
+              (status, before, after, 100 * change, p, name))
+    for name in sorted(set(benchmarks) - set(baseline["benchmarks"])):
+        print("%-12s %12s %12s %8s %8s  %s" % ("new", "", "", "", "", name))
+    print("%d regressions" % regressions)
+    return 1 if regressions > 0 else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="\n".join(__doc__.splitlines()[2:]))
+    parser.add_argument("command", choices=["record", "compare"])
+    parser.add_argument("results", nargs="+",
+                        help="The JSON outputs of the benchmark programs")
+    parser.add_argument("--baseline", required=True,
+                        help="The JSON file of the baseline")
+    parser.add_argument("--alpha", type=float, default=0.01,
+                        help="The significance level of the test")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="The relative slowdown below which a significant "
+                        "change is not a regression")
+    parser.add_argument("--strict", action="store_true",
+                        help="Do not compare results of another machine")
+    args = parser.parse_args()
+    return record(args) if args.command == "record" else compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
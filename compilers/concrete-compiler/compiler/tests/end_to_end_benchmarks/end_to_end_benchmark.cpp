@@ -1,4 +1,5 @@
 #include "../end_to_end_tests/end_to_end_test.h"
+#include "concretelang/Runtime/context.h"
 #include "concretelang/TestLib/TestProgram.h"
 #include <concretelang/Runtime/DFRuntime.hpp>
 
@@ -19,6 +20,35 @@ using namespace concretelang::testlib;
     assert(false && "See error above");                                        \
   }
 
+/// Labels the benchmark with the parameters of the keyset of the compiled
+/// program, so that a comparison with a baseline can tell the runs which did
+/// not use the same parameters
+static void setParametersLabel(benchmark::State &state, TestProgram &tc) {
+  auto programInfo = tc.getProgramInfo();
+  if (!programInfo)
+    return;
+  auto keyset = programInfo->asReader().getKeyset();
+  std::ostringstream label;
+  label << "sk";
+  for (auto sk : keyset.getLweSecretKeys())
+    label << ":" << sk.getParams().getLweDimension();
+  for (auto bsk : keyset.getLweBootstrapKeys()) {
+    auto params = bsk.getParams();
+    label << " bsk:" << params.getGlweDimension() << "x"
+          << params.getPolynomialSize() << "," << params.getLevelCount() << "x"
+          << params.getBaseLog();
+  }
+  for (auto ksk : keyset.getLweKeyswitchKeys()) {
+    auto params = ksk.getParams();
+    label << " ksk:" << params.getLevelCount() << "x" << params.getBaseLog();
+  }
+  for (auto pksk : keyset.getPackingKeyswitchKeys()) {
+    auto params = pksk.getParams();
+    label << " pksk:" << params.getLevelCount() << "x" << params.getBaseLog();
+  }
+  state.SetLabel(label.str());
+}
+
 /// Benchmark time of the compilation
 static void BM_Compile(benchmark::State &state, EndToEndDesc description,
                        mlir::concretelang::CompilationOptions options) {
@@ -33,6 +63,7 @@ static void BM_KeyGen(benchmark::State &state, EndToEndDesc description,
                       mlir::concretelang::CompilationOptions options) {
   TestProgram tc(options);
   assert(tc.compile(description.program));
+  setParametersLabel(state, tc);
 
   for (auto _ : state) {
     assert(tc.generateKeyset(0, 0, false));
@@ -46,6 +77,7 @@ static void BM_ExportArguments(benchmark::State &state,
   TestProgram tc(options);
   assert(tc.compile(description.program));
   assert(tc.generateKeyset());
+  setParametersLabel(state, tc);
 
   assert(description.tests.size() > 0);
   auto test = description.tests[0];
@@ -68,6 +100,7 @@ static void BM_Evaluate(benchmark::State &state, EndToEndDesc description,
   TestProgram tc(options);
   assert(tc.compile(description.program));
   assert(tc.generateKeyset());
+  setParametersLabel(state, tc);
   auto clientCircuit = tc.getClientCircuit().value();
 
   assert(description.tests.size() > 0);
@@ -186,6 +219,10 @@ int main(int argc, char **argv) {
                               stackSizeRequirement,
                               std::get<0>(options).numIterations);
   }
+  // The times of the bootstraps depend on the kernels their FFTs run on
+  ::benchmark::AddCustomContext(
+      "fft_backend", mlir::concretelang::getFftBackendName(
+                         mlir::concretelang::getFftBackend()));
   ::benchmark::RunSpecifiedBenchmarks();
   ::benchmark::Shutdown();
   _dfr_terminate();
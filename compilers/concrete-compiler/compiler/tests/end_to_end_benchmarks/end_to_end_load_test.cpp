@@ -0,0 +1,322 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+// Load test of the server programs: a loaded `ServerProgram` is called by
+// concurrent clients, either back to back or at a given request rate, and the
+// throughput, the latency quantiles and the utilization of the CPU and of the
+// GPUs are reported.
+
+#include "../end_to_end_tests/end_to_end_test.h"
+#include "concretelang/Runtime/context.h"
+#include "concretelang/TestLib/TestProgram.h"
+#include <concretelang/Runtime/DFRuntime.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Path.h"
+
+#include "tests_tools/StackSize.h"
+
+using namespace concretelang::testlib;
+using Clock = std::chrono::steady_clock;
+
+enum class CallMode { SYNC, ASYNC };
+
+struct LoadTestOptions {
+  unsigned clients;
+  /// The requests per second of all the clients, or 0 for the clients to call
+  /// back to back
+  double rate;
+  double duration;
+  double warmup;
+  CallMode mode;
+};
+
+struct LoadTestReport {
+  std::string name;
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  double seconds = 0;
+  /// The latencies of the successful requests, in seconds, sorted. With a
+  /// request rate, they are measured from the time each request was due, so
+  /// that the time waiting behind the previous requests of a client is
+  /// counted.
+  std::vector<double> latencies;
+  double cpuSeconds = 0;
+  unsigned cpus = 0;
+  double gpuSeconds = 0;
+  unsigned gpus = 0;
+
+  double quantile(double q) const {
+    if (latencies.empty())
+      return 0;
+    size_t i = std::min(latencies.size() - 1, (size_t)(q * latencies.size()));
+    return latencies[i];
+  }
+};
+
+static double processCpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+static double secondsBetween(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double>(to - from).count();
+}
+
+/// Calls `circuit` from `options.clients` threads during the warmup and the
+/// duration of `options`, and reports the requests due during the duration.
+static void runLoad(ServerCircuit &circuit, const ServerKeyset &keyset,
+                    const std::vector<TransportValue> &args,
+                    const LoadTestOptions &options, LoadTestReport &report) {
+  auto start = Clock::now();
+  auto measureFrom =
+      start + std::chrono::duration_cast<Clock::duration>(
+                  std::chrono::duration<double>(options.warmup));
+  auto end = measureFrom + std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(options.duration));
+
+  std::mutex mutex;
+  std::condition_variable completed;
+  uint64_t pending = 0;
+  auto record = [&](Clock::time_point due, bool success) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> guard(mutex);
+    if (due >= measureFrom && due < end) {
+      report.requests++;
+      if (success)
+        report.latencies.push_back(secondsBetween(due, now));
+      else
+        report.errors++;
+    }
+  };
+
+  auto client = [&](unsigned index) {
+    // The requests of a client are a Poisson process of rate
+    // `rate / clients`
+    std::mt19937_64 gen(index);
+    std::exponential_distribution<double> interval(
+        options.rate > 0 ? options.rate / options.clients : 1);
+    auto due = start;
+    while (true) {
+      if (options.rate > 0) {
+        due += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(interval(gen)));
+        std::this_thread::sleep_until(due);
+      } else {
+        due = Clock::now();
+      }
+      if (due >= end)
+        break;
+      auto callArgs = args;
+      if (options.mode == CallMode::SYNC) {
+        record(due, circuit.call(keyset, callArgs).has_value());
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        pending++;
+      }
+      circuit.callAsync(keyset, std::move(callArgs),
+                        [&, due](Result<std::vector<TransportValue>> result) {
+                          record(due, result.has_value());
+                          std::lock_guard<std::mutex> guard(mutex);
+                          if (--pending == 0)
+                            completed.notify_all();
+                        });
+    }
+  };
+
+  double cpuStart = 0;
+  std::thread sampler([&]() {
+    std::this_thread::sleep_until(measureFrom);
+    cpuStart = processCpuSeconds();
+    circuit.resetPrimitiveStatistics();
+  });
+  std::vector<std::thread> clients;
+  for (unsigned i = 0; i < options.clients; i++)
+    clients.emplace_back(client, i);
+  for (auto &c : clients)
+    c.join();
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [&]() { return pending == 0; });
+  }
+  sampler.join();
+
+  auto stop = std::max(Clock::now(), end);
+  report.seconds = secondsBetween(measureFrom, stop);
+  report.cpuSeconds = processCpuSeconds() - cpuStart;
+  report.cpus = std::thread::hardware_concurrency();
+  // The GPU primitives called by the direct wrappers wait for their kernels,
+  // so their latency is the time the GPUs are busy
+  for (auto &statistic : circuit.getPrimitiveStatistics())
+    if (statistic.gpu)
+      report.gpuSeconds += statistic.nanoseconds * 1e-9;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  report.gpus = cuda_get_number_of_gpus();
+#endif
+  std::sort(report.latencies.begin(), report.latencies.end());
+}
+
+static void printReport(const LoadTestReport &report) {
+  llvm::outs() << report.name << "\n";
+  llvm::outs() << llvm::format("  requests: %lu (%lu errors) in %.2fs\n",
+                               report.requests, report.errors, report.seconds);
+  llvm::outs() << llvm::format("  throughput: %.2f requests/s\n",
+                               report.latencies.size() / report.seconds);
+  llvm::outs() << llvm::format(
+      "  latency: p50 %.3fms, p99 %.3fms, p999 %.3fms, max %.3fms\n",
+      report.quantile(0.5) * 1e3, report.quantile(0.99) * 1e3,
+      report.quantile(0.999) * 1e3,
+      report.latencies.empty() ? 0 : report.latencies.back() * 1e3);
+  llvm::outs() << llvm::format("  cpu utilization: %.1f%% of %u cores\n",
+                               100 * report.cpuSeconds /
+                                   (report.seconds * report.cpus),
+                               report.cpus);
+  if (report.gpus > 0)
+    llvm::outs() << llvm::format("  gpu utilization: %.1f%% of %u gpus\n",
+                                 100 * report.gpuSeconds /
+                                     (report.seconds * report.gpus),
+                                 report.gpus);
+}
+
+static llvm::json::Value reportToJson(const LoadTestReport &report) {
+  return llvm::json::Object{
+      {"name", report.name},
+      {"requests", (int64_t)report.requests},
+      {"errors", (int64_t)report.errors},
+      {"seconds", report.seconds},
+      {"throughput", report.latencies.size() / report.seconds},
+      {"latency_p50", report.quantile(0.5)},
+      {"latency_p99", report.quantile(0.99)},
+      {"latency_p999", report.quantile(0.999)},
+      {"cpu_seconds", report.cpuSeconds},
+      {"cpus", (int64_t)report.cpus},
+      {"gpu_seconds", report.gpuSeconds},
+      {"gpus", (int64_t)report.gpus},
+  };
+}
+
+static bool loadTest(std::string name, EndToEndDesc description,
+                     mlir::concretelang::CompilationOptions compilationOptions,
+                     const LoadTestOptions &options, LoadTestReport &report) {
+  auto fail = [&](std::string what, std::string error) {
+    llvm::errs() << "Error: " << what << " " << name << ": " << error << "\n";
+    return false;
+  };
+  if (description.tests.empty())
+    return fail("no inputs for", "");
+  TestProgram tc(compilationOptions);
+  if (auto compiled = tc.compile(description.program); !compiled)
+    return fail("cannot compile", compiled.error().mesg);
+  if (auto generated = tc.generateKeyset(); !generated)
+    return fail("cannot generate the keyset of", generated.error().mesg);
+
+  auto clientCircuit = tc.getClientCircuit().value();
+  std::vector<TransportValue> args;
+  auto &test = description.tests[0];
+  for (size_t i = 0; i < test.inputs.size(); i++) {
+    auto arg = clientCircuit.prepareInput(test.inputs[i].getValue(), i);
+    if (!arg)
+      return fail("cannot encrypt the inputs of", arg.error().mesg);
+    args.push_back(arg.value());
+  }
+
+  auto circuit = tc.getServerCircuit();
+  if (!circuit)
+    return fail("cannot load", circuit.error().mesg);
+  circuit->enablePrimitiveStatistics();
+  report.name = name;
+  runLoad(circuit.value(), tc.getKeyset().value().server, args, options,
+          report);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  llvm::cl::opt<unsigned> clients(
+      "clients", llvm::cl::desc("Number of concurrent clients"),
+      llvm::cl::init(1));
+  llvm::cl::opt<double> rate(
+      "rate",
+      llvm::cl::desc("Requests per second of all the clients, which call back "
+                     "to back if 0"),
+      llvm::cl::init(0));
+  llvm::cl::opt<double> duration(
+      "duration", llvm::cl::desc("Seconds during which the load is measured"),
+      llvm::cl::init(10));
+  llvm::cl::opt<double> warmup(
+      "warmup",
+      llvm::cl::desc("Seconds of load before the measure, e.g. for the "
+                     "caches of the runtime to be filled"),
+      llvm::cl::init(1));
+  llvm::cl::opt<CallMode> mode(
+      "call-mode", llvm::cl::desc("How the clients call the server program"),
+      llvm::cl::values(clEnumValN(CallMode::SYNC, "sync",
+                                  "Each client waits for its calls")),
+      llvm::cl::values(clEnumValN(CallMode::ASYNC, "async",
+                                  "The clients submit their calls to the "
+                                  "server call pool without waiting")),
+      llvm::cl::init(CallMode::SYNC));
+  llvm::cl::opt<std::string> reportPath(
+      "report", llvm::cl::desc("Write the reports in JSON to this file"),
+      llvm::cl::init(""));
+
+  auto options = parseEndToEndCommandLine(argc, argv);
+  LoadTestOptions loadOptions{clients.getValue(), rate.getValue(),
+                              duration.getValue(), warmup.getValue(),
+                              mode.getValue()};
+  if (loadOptions.clients == 0) {
+    llvm::errs() << "Error: at least one client is needed\n";
+    return 1;
+  }
+
+  setCurrentStackLimit(0);
+  std::vector<LoadTestReport> reports;
+  for (auto descFile : std::get<1>(options)) {
+    auto suiteName = llvm::sys::path::stem(descFile.path).str();
+    for (auto description : descFile.descriptions) {
+      auto compilationOptions = std::get<0>(options).compilationOptions;
+      if (description.p_error)
+        compilationOptions.optimizerConfig.p_error =
+            description.p_error.value();
+      compilationOptions.optimizerConfig.encoding = description.encoding;
+      LoadTestReport report;
+      if (!loadTest(suiteName + "/" + description.description, description,
+                    compilationOptions, loadOptions, report))
+        return 1;
+      printReport(report);
+      reports.push_back(std::move(report));
+    }
+  }
+
+  if (!reportPath.empty()) {
+    std::error_code error;
+    llvm::raw_fd_ostream out(reportPath, error);
+    if (error) {
+      llvm::errs() << "Error: cannot write " << reportPath << ": "
+                   << error.message() << "\n";
+      return 1;
+    }
+    llvm::json::Array array;
+    for (auto &report : reports)
+      array.push_back(reportToJson(report));
+    out << llvm::json::Value(std::move(array)) << "\n";
+  }
+  _dfr_terminate();
+  return 0;
+}
@@ -0,0 +1,265 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+// Memory footprint of the keys and of the ciphertexts of the programs: the
+// size of the keysets on disk, the resident memory added by loading the
+// server keyset, by preparing it for the calls (the conversion of the
+// bootstrap keys to the fourier domain and their upload to the GPUs), the
+// device memory of the uploaded keys, and the peak resident memory during a
+// call. The resident memory is read from /proc, so the figures are only
+// reported on Linux.
+
+#include "../end_to_end_tests/end_to_end_test.h"
+#include "concretelang/Runtime/context.h"
+#include "concretelang/TestLib/TestProgram.h"
+#include <concretelang/Runtime/DFRuntime.hpp>
+
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Path.h"
+
+#include "tests_tools/StackSize.h"
+
+using namespace concretelang::testlib;
+
+/// The reader limits of the keysets, which exceed the default ones of capnp.
+const capnp::ReaderOptions KEYSET_READER_OPTIONS =
+    capnp::ReaderOptions{7000000000, 64};
+
+struct MemoryReport {
+  std::string name;
+  uint64_t clientKeysetBytes = 0;
+  uint64_t serverKeysetBytes = 0;
+  uint64_t argumentsBytes = 0;
+  uint64_t resultsBytes = 0;
+  /// The resident memory added by each phase, in bytes
+  int64_t loadedKeysetBytes = 0;
+  int64_t preparedKeysetBytes = 0;
+  /// The peak resident memory during a call, over the resident memory before
+  /// the call, in bytes
+  int64_t callPeakBytes = 0;
+  /// The device memory of the keys uploaded to each GPU, in bytes
+  std::vector<uint64_t> gpuKeysBytes;
+};
+
+/// Returns the resident memory of the process, in bytes, or 0 if unknown.
+static int64_t residentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident))
+    return 0;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+/// Resets the peak resident memory of the process to its current resident
+/// memory, returns false if the kernel does not support it.
+static bool resetPeakResidentBytes() {
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5";
+  clearRefs.flush();
+  return clearRefs.good();
+}
+
+/// Returns the peak resident memory of the process, in bytes, or 0 if
+/// unknown.
+static int64_t peakResidentBytes() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0)
+      return std::stoll(line.substr(6)) * 1024;
+  }
+  return 0;
+}
+
+template <typename T>
+static Result<uint64_t> writeToFile(const Message<T> &message,
+                                    const std::string &path) {
+  std::ofstream out(path, std::ofstream::binary);
+  OUTCOME_TRYV(message.writeBinaryToOstream(out));
+  out.close();
+  uint64_t size;
+  if (llvm::sys::fs::file_size(path, size))
+    return StringError("cannot stat ") << path;
+  return size;
+}
+
+static Result<ServerKeyset> readServerKeyset(const std::string &path,
+                                             bool mapKeys) {
+  if (mapKeys)
+    return ServerKeyset::fromMappedFile(path);
+  std::ifstream in(path, std::ifstream::binary);
+  Message<concreteprotocol::ServerKeyset> proto;
+  OUTCOME_TRYV(proto.readBinaryFromIstream(in, KEYSET_READER_OPTIONS));
+  return ServerKeyset::fromProto(proto);
+}
+
+static Result<MemoryReport>
+measureMemory(std::string name, EndToEndDesc description,
+              mlir::concretelang::CompilationOptions compilationOptions,
+              bool mapKeys) {
+  if (description.tests.empty())
+    return StringError("no inputs");
+  MemoryReport report;
+  report.name = name;
+
+  TestProgram tc(compilationOptions);
+  OUTCOME_TRYV(tc.compile(description.program));
+  OUTCOME_TRYV(tc.generateKeyset());
+  OUTCOME_TRY(auto keyset, tc.getKeyset());
+  OUTCOME_TRY(auto programInfo, tc.getProgramInfo());
+  OUTCOME_TRY(auto libraryPath, tc.getSharedLibraryPath());
+
+  // The keysets are written next to the library, the server keyset being
+  // loaded back from its file
+  auto directory = llvm::sys::path::parent_path(libraryPath).str();
+  auto clientPath = directory + "/client.keyset";
+  auto serverPath = directory + "/server.keyset";
+  OUTCOME_TRY(report.clientKeysetBytes,
+              writeToFile(keyset.client.toProto(), clientPath));
+  OUTCOME_TRY(report.serverKeysetBytes,
+              writeToFile(keyset.server.toProto(), serverPath));
+
+  OUTCOME_TRY(auto clientCircuit, tc.getClientCircuit());
+  std::vector<TransportValue> args;
+  auto &test = description.tests[0];
+  for (size_t i = 0; i < test.inputs.size(); i++) {
+    OUTCOME_TRY(auto arg,
+                clientCircuit.prepareInput(test.inputs[i].getValue(), i));
+    OUTCOME_TRY(auto bytes, arg.writeBinaryToString());
+    report.argumentsBytes += bytes.size();
+    args.push_back(arg);
+  }
+
+  int64_t before = residentBytes();
+  OUTCOME_TRY(auto serverKeyset, readServerKeyset(serverPath, mapKeys));
+  int64_t loaded = residentBytes();
+  report.loadedKeysetBytes = loaded - before;
+
+  bool uploadKeysToGpus = false;
+  unsigned gpus = 0;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  gpus = cuda_get_number_of_gpus();
+  uploadKeysToGpus = compilationOptions.emitGPUOps && gpus > 0;
+#endif
+  OUTCOME_TRY(auto program,
+              ServerProgram::load(programInfo, libraryPath, false,
+                                  serverKeyset, uploadKeysToGpus));
+  OUTCOME_TRY(auto circuit, program.getServerCircuit("main"));
+  int64_t prepared = residentBytes();
+  report.preparedKeysetBytes = prepared - loaded;
+  if (uploadKeysToGpus) {
+    for (unsigned gpu = 0; gpu < gpus; gpu++)
+      report.gpuKeysBytes.push_back(program.getGpuKeysMemory(gpu));
+  }
+
+  bool peakReset = resetPeakResidentBytes();
+  int64_t beforeCall = residentBytes();
+  OUTCOME_TRY(auto results, circuit.call(serverKeyset, args));
+  if (peakReset)
+    report.callPeakBytes = peakResidentBytes() - beforeCall;
+  for (auto &result : results) {
+    OUTCOME_TRY(auto bytes, result.writeBinaryToString());
+    report.resultsBytes += bytes.size();
+  }
+  return report;
+}
+
+static double toMiB(int64_t bytes) { return bytes / (1024. * 1024.); }
+
+static void printReport(const MemoryReport &report) {
+  llvm::outs() << report.name << "\n";
+  llvm::outs() << llvm::format("  keysets on disk: client %.2fMiB, server "
+                               "%.2fMiB\n",
+                               toMiB(report.clientKeysetBytes),
+                               toMiB(report.serverKeysetBytes));
+  llvm::outs() << llvm::format("  ciphertexts: arguments %.2fMiB, results "
+                               "%.2fMiB\n",
+                               toMiB(report.argumentsBytes),
+                               toMiB(report.resultsBytes));
+  llvm::outs() << llvm::format("  resident: +%.2fMiB after load, +%.2fMiB "
+                               "after preparation\n",
+                               toMiB(report.loadedKeysetBytes),
+                               toMiB(report.preparedKeysetBytes));
+  llvm::outs() << llvm::format("  call peak: +%.2fMiB\n",
+                               toMiB(report.callPeakBytes));
+  for (size_t gpu = 0; gpu < report.gpuKeysBytes.size(); gpu++)
+    llvm::outs() << llvm::format("  gpu %zu keys: %.2fMiB\n", gpu,
+                                 toMiB(report.gpuKeysBytes[gpu]));
+}
+
+static llvm::json::Value reportToJson(const MemoryReport &report) {
+  llvm::json::Array gpuKeysBytes;
+  for (auto bytes : report.gpuKeysBytes)
+    gpuKeysBytes.push_back((int64_t)bytes);
+  return llvm::json::Object{
+      {"name", report.name},
+      {"client_keyset_bytes", (int64_t)report.clientKeysetBytes},
+      {"server_keyset_bytes", (int64_t)report.serverKeysetBytes},
+      {"arguments_bytes", (int64_t)report.argumentsBytes},
+      {"results_bytes", (int64_t)report.resultsBytes},
+      {"loaded_keyset_resident_bytes", report.loadedKeysetBytes},
+      {"prepared_keyset_resident_bytes", report.preparedKeysetBytes},
+      {"call_peak_resident_bytes", report.callPeakBytes},
+      {"gpu_keys_bytes", std::move(gpuKeysBytes)},
+  };
+}
+
+int main(int argc, char **argv) {
+  llvm::cl::opt<bool> mapKeys(
+      "map-keys",
+      llvm::cl::desc("Load the server keysets by mapping their files instead "
+                     "of copying them to the heap"),
+      llvm::cl::init(false));
+  llvm::cl::opt<std::string> reportPath(
+      "report", llvm::cl::desc("Write the reports in JSON to this file"),
+      llvm::cl::init(""));
+
+  auto options = parseEndToEndCommandLine(argc, argv);
+
+  setCurrentStackLimit(0);
+  std::vector<MemoryReport> reports;
+  for (auto descFile : std::get<1>(options)) {
+    auto suiteName = llvm::sys::path::stem(descFile.path).str();
+    for (auto description : descFile.descriptions) {
+      auto compilationOptions = std::get<0>(options).compilationOptions;
+      if (description.p_error)
+        compilationOptions.optimizerConfig.p_error =
+            description.p_error.value();
+      compilationOptions.optimizerConfig.encoding = description.encoding;
+      auto name = suiteName + "/" + description.description;
+      auto report =
+          measureMemory(name, description, compilationOptions, mapKeys);
+      if (!report) {
+        llvm::errs() << "Error: cannot measure " << name << ": "
+                     << report.error().mesg << "\n";
+        return 1;
+      }
+      printReport(report.value());
+      reports.push_back(report.value());
+    }
+  }
+
+  if (!reportPath.empty()) {
+    std::error_code error;
+    llvm::raw_fd_ostream out(reportPath, error);
+    if (error) {
+      llvm::errs() << "Error: cannot write " << reportPath << ": "
+                   << error.message() << "\n";
+      return 1;
+    }
+    llvm::json::Array array;
+    for (auto &report : reports)
+      array.push_back(reportToJson(report));
+    out << llvm::json::Value(std::move(array)) << "\n";
+  }
+  _dfr_terminate();
+  return 0;
+}
@@ -0,0 +1,139 @@
+"""Strong scaling of the parallelization modes of the compiler.
+
+Runs the evaluation benchmarks of `end_to_end_benchmark` on the given
+description files once per parallelization mode and per number of threads
+(and of HPX localities for the dataflow mode), then reports for each benchmark
+the speedup and the parallel efficiency relative to its run on one thread.
+
+As the runtimes size their thread pools once per process, each point of the
+curves is a separate run of the benchmark program.
+"""
+
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+# The compilation options of each mode, and the environment variable setting
+# the number of threads the mode runs on.
+MODES = {
+    "loop": (["--loop-parallelize=1"], "OMP_NUM_THREADS"),
+    "dataflow": (["--dataflow-parallelize=1"], "DFR_NUM_THREADS"),
+    "batch": (["--batch-tfhe-ops=1", "--loop-parallelize=1"], "OMP_NUM_THREADS"),
+}
+
+UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1}
+
+
+def powers_of_two(n):
+    counts = []
+    count = 1
+    while count < n:
+        counts.append(count)
+        count *= 2
+    counts.append(n)
+    return counts
+
+
+def run(args, mode, threads, localities, output):
+    options, variable = MODES[mode]
+    env = dict(os.environ)
+    # Only the threads of the mode are counted: the dataflow workers do not
+    # spawn OpenMP threads of their own.
+    env["OMP_NUM_THREADS"] = "1"
+    env[variable] = str(threads)
+    command = [
+        args.benchmark, "--bench=evaluate", "--benchmark_out_format=json"
+    ] + options + shlex.split(args.options) + args.descriptions
+    if localities > 1:
+        # Each locality writes its own results, those of the root node are kept
+        launcher = shlex.split(args.launcher) + [
+            "-n%d" % localities, "-c%d" % threads
+        ]
+        command = launcher + [
+            "bash", "-c",
+            'exec "$@" --benchmark_out="$0.${SLURM_PROCID:-0}.json"',
+            output
+        ] + command
+        output += ".0.json"
+    else:
+        command += ["--benchmark_out=" + output]
+    print("$", " ".join(shlex.quote(c) for c in command), file=sys.stderr)
+    subprocess.run(command, env=env, check=True)
+    with open(output) as f:
+        results = json.load(f)
+    times = {}
+    for b in results["benchmarks"]:
+        times[b["name"]] = b["real_time"] * UNITS[b["time_unit"]]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("benchmark", help="The end_to_end_benchmark program")
+    parser.add_argument("descriptions", nargs="+",
+                        help="The YAML description files of the circuits")
+    parser.add_argument("--modes", nargs="+", choices=MODES.keys(),
+                        default=list(MODES.keys()))
+    parser.add_argument("--threads", type=int, nargs="+",
+                        default=powers_of_two(os.cpu_count()),
+                        help="The numbers of threads (default: the powers of "
+                        "two up to the number of cores)")
+    parser.add_argument("--localities", type=int, nargs="+", default=[1],
+                        help="The numbers of HPX localities of the dataflow "
+                        "mode, more than one are launched with --launcher")
+    parser.add_argument("--launcher", default="srun --kill-on-bad-exit=1",
+                        help="The command launching the localities")
+    parser.add_argument("--options", default="",
+                        help="More options of the benchmark program")
+    parser.add_argument("--output", default="scaling_benchmarks_results.json",
+                        help="The JSON file of the scaling curves")
+    args = parser.parse_args()
+
+    points = []
+    with tempfile.TemporaryDirectory() as directory:
+        for mode in args.modes:
+            localities = args.localities if mode == "dataflow" else [1]
+            for l in localities:
+                for t in args.threads:
+                    output = os.path.join(directory,
+                                          "%s-%d-%d.json" % (mode, l, t))
+                    for name, seconds in run(args, mode, t, l, output).items():
+                        points.append({
+                            "mode": mode,
+                            "benchmark": name,
+                            "localities": l,
+                            "threads": t,
+                            "seconds": seconds,
+                        })
+
+    # The speedups are relative to the run of each mode on a single thread of
+    # a single locality, or to its smallest run if it was not measured.
+    for p in points:
+        same = [
+            q for q in points
+            if q["mode"] == p["mode"] and q["benchmark"] == p["benchmark"]
+        ]
+        base = min(same, key=lambda q: q["localities"] * q["threads"])
+        cores = p["localities"] * p["threads"]
+        base_cores = base["localities"] * base["threads"]
+        p["speedup"] = base["seconds"] / p["seconds"]
+        p["efficiency"] = p["speedup"] * base_cores / cores
+
+    with open(args.output, "w") as f:
+        json.dump(points, f, indent=2)
+
+    print("%-9s %5s %7s %12s %8s %10s  %s" %
+          ("mode", "nodes", "threads", "time (s)", "speedup", "efficiency",
+           "benchmark"))
+    for p in points:
+        print("%-9s %5d %7d %12.4f %8.2f %9.0f%%  %s" %
+              (p["mode"], p["localities"], p["threads"], p["seconds"],
+               p["speedup"], 100 * p["efficiency"], p["benchmark"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,597 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete/blob/main/LICENSE.txt
+// for license information.
+
+// Benchmarks of the cryptographic primitives of the runtime, i.e. the
+// functions of `wrappers.h` called by the compiled programs, with the
+// parameters chosen by the optimizer for programs of several precisions.
+
+#include "concretelang/Common/HugePages.h"
+#include "concretelang/Common/Keysets.h"
+#include "concretelang/Dialect/Concrete/IR/ConcreteOps.h"
+#include "concretelang/Runtime/context.h"
+#include "concretelang/Runtime/wrappers.h"
+#include "concretelang/Support/CompilerEngine.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include "llvm/Support/CommandLine.h"
+
+#include "tests_tools/keySetCache.h"
+
+namespace Concrete = mlir::concretelang::Concrete;
+using mlir::concretelang::CompilationContext;
+using mlir::concretelang::CompilationOptions;
+using mlir::concretelang::CompilerEngine;
+using mlir::concretelang::RuntimeContext;
+
+struct KeyswitchParameters {
+  uint32_t level;
+  uint32_t baseLog;
+  uint32_t inputLweDim;
+  uint32_t outputLweDim;
+  uint32_t kskIndex;
+};
+
+struct BootstrapParameters {
+  uint32_t inputLweDim;
+  uint32_t polySize;
+  uint32_t level;
+  uint32_t baseLog;
+  uint32_t glweDim;
+  uint32_t bskIndex;
+
+  uint64_t outputLweSize() const { return glweDim * polySize + 1; }
+};
+
+struct WopPBSParameters {
+  uint32_t bootstrapLevel;
+  uint32_t bootstrapBaseLog;
+  uint32_t keyswitchLevel;
+  uint32_t keyswitchBaseLog;
+  uint32_t packingKeyswitchInputLweDim;
+  uint32_t packingKeyswitchPolySize;
+  uint32_t packingKeyswitchLevel;
+  uint32_t packingKeyswitchBaseLog;
+  uint32_t circuitBootstrapLevel;
+  uint32_t circuitBootstrapBaseLog;
+  std::vector<uint64_t> crtDecomposition;
+  uint64_t lweSize;
+  uint64_t lutSize;
+  uint32_t kskIndex;
+  uint32_t bskIndex;
+  uint32_t pkskIndex;
+};
+
+/// The parameters chosen by the optimizer for a program, with the runtime
+/// context holding the evaluation keys of the program.
+struct ParameterSet {
+  std::string name;
+  std::optional<KeyswitchParameters> keyswitch;
+  std::optional<BootstrapParameters> bootstrap;
+  std::optional<WopPBSParameters> wopPBS;
+  std::unique_ptr<RuntimeContext> context;
+};
+
+/// Compiles `program` to the Concrete dialect and gathers the parameters of
+/// its first keyswitch, bootstrap and WoP-PBS.
+static std::shared_ptr<ParameterSet>
+loadParameterSet(std::string name, std::string program,
+                 CompilationOptions options) {
+  CompilerEngine compiler(CompilationContext::createShared());
+  compiler.setCompilationOptions(options);
+  auto compilation =
+      compiler.compile(program, CompilerEngine::Target::CONCRETE);
+  if (!compilation) {
+    llvm::errs() << "Error: cannot compile the program of " << name << ": "
+                 << llvm::toString(compilation.takeError()) << "\n";
+    return nullptr;
+  }
+
+  auto set = std::make_shared<ParameterSet>();
+  set->name = name;
+  mlir::ModuleOp module = compilation->mlirModuleRef->get();
+  module->walk([&](Concrete::KeySwitchLweTensorOp op) {
+    if (!set->keyswitch)
+      set->keyswitch = KeyswitchParameters{op.getLevel(), op.getBaseLog(),
+                                           op.getLweDimIn(), op.getLweDimOut(),
+                                           op.getKskIndex()};
+  });
+  module->walk([&](Concrete::BootstrapLweTensorOp op) {
+    if (!set->bootstrap)
+      set->bootstrap = BootstrapParameters{
+          op.getInputLweDim(), op.getPolySize(),      op.getLevel(),
+          op.getBaseLog(),     op.getGlweDimension(), op.getBskIndex()};
+  });
+  module->walk([&](Concrete::WopPBSCRTLweTensorOp op) {
+    if (set->wopPBS)
+      return;
+    auto ciphertextShape =
+        op.getCiphertext().getType().cast<mlir::RankedTensorType>().getShape();
+    auto lutShape = op.getLookupTable()
+                        .getType()
+                        .cast<mlir::RankedTensorType>()
+                        .getShape();
+    std::vector<uint64_t> crtDecomposition;
+    for (auto modulus : op.getCrtDecomposition())
+      crtDecomposition.push_back(
+          modulus.cast<mlir::IntegerAttr>().getValue().getZExtValue());
+    set->wopPBS = WopPBSParameters{op.getBootstrapLevel(),
+                                   op.getBootstrapBaseLog(),
+                                   op.getKeyswitchLevel(),
+                                   op.getKeyswitchBaseLog(),
+                                   op.getPackingKeySwitchInputLweDimension(),
+                                   op.getPackingKeySwitchoutputPolynomialSize(),
+                                   op.getPackingKeySwitchLevel(),
+                                   op.getPackingKeySwitchBaseLog(),
+                                   op.getCircuitBootstrapLevel(),
+                                   op.getCircuitBootstrapBaseLog(),
+                                   crtDecomposition,
+                                   (uint64_t)ciphertextShape.back(),
+                                   (uint64_t)lutShape.back(),
+                                   op.getKskIndex(),
+                                   op.getBskIndex(),
+                                   op.getPkskIndex()};
+  });
+
+  auto keysetInfo = (Message<concreteprotocol::KeysetInfo>)compilation
+                        ->programInfo->asReader()
+                        .getKeyset();
+  auto keyset = getTestKeySetCachePtr()->getKeyset(keysetInfo, 0, 0);
+  if (keyset.has_failure()) {
+    llvm::errs() << "Error: cannot generate the keyset of " << name << ": "
+                 << keyset.error().mesg << "\n";
+    return nullptr;
+  }
+  set->context = std::make_unique<RuntimeContext>(keyset.value().server);
+  // The fourier bootstrap keys are allocated following the current huge pages
+  // policy, so they are converted now rather than on the first bootstrap
+  if (set->bootstrap)
+    set->context->get_fourier_bootstrap_key(set->bootstrap->bskIndex);
+  if (set->wopPBS)
+    set->context->get_fourier_bootstrap_key(set->wopPBS->bskIndex);
+  return set;
+}
+
+/// A batch of `count` ciphertexts of `size` words, stored contiguously and
+/// filled with random words: the running time of the primitives does not
+/// depend on the encrypted values.
+struct Ciphertexts {
+  Ciphertexts(uint64_t count, uint64_t size, bool random = true)
+      : data(count * size), count(count), size(size) {
+    if (!random)
+      return;
+    std::mt19937_64 gen(count * size);
+    for (auto &word : data)
+      word = gen();
+  }
+
+  uint64_t *row(uint64_t i) { return data.data() + i * size; }
+
+  std::vector<uint64_t> data;
+  uint64_t count;
+  uint64_t size;
+};
+
+/// Runs `call` once to warm up the caches of the runtime, e.g. the keys
+/// uploaded to the GPUs, then measures it on `batch` ciphertexts per
+/// iteration.
+template <typename Call>
+static void measure(benchmark::State &state, uint64_t batch, Call call) {
+  call();
+  for (auto _ : state)
+    call();
+  state.SetItemsProcessed(state.iterations() * batch);
+  state.counters["batch"] = batch;
+}
+
+static void BM_Keyswitch(benchmark::State &state, ParameterSet *set,
+                         bool batched, bool gpu) {
+  auto &ks = *set->keyswitch;
+  uint64_t batch = state.range(0);
+  Ciphertexts in(batch, ks.inputLweDim + 1);
+  Ciphertexts out(batch, ks.outputLweDim + 1, false);
+  auto scalar = memref_keyswitch_lwe_u64;
+  auto vector = memref_batched_keyswitch_lwe_u64;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (gpu) {
+    scalar = memref_keyswitch_lwe_cuda_u64;
+    vector = memref_batched_keyswitch_lwe_cuda_u64;
+  }
+#endif
+  measure(state, batch, [&]() {
+    if (batched) {
+      vector(out.data.data(), out.data.data(), 0, batch, out.size, out.size, 1,
+             in.data.data(), in.data.data(), 0, batch, in.size, in.size, 1,
+             ks.level, ks.baseLog, ks.inputLweDim, ks.outputLweDim, ks.kskIndex,
+             set->context.get());
+      return;
+    }
+    for (uint64_t i = 0; i < batch; i++)
+      scalar(out.row(i), out.row(i), 0, out.size, 1, in.row(i), in.row(i), 0,
+             in.size, 1, ks.level, ks.baseLog, ks.inputLweDim, ks.outputLweDim,
+             ks.kskIndex, set->context.get());
+  });
+}
+
+enum class BootstrapVariant { SCALAR, BATCHED, MAPPED };
+
+static void BM_Bootstrap(benchmark::State &state, ParameterSet *set,
+                         BootstrapVariant variant, bool gpu) {
+  auto &bs = *set->bootstrap;
+  uint64_t batch = state.range(0);
+  Ciphertexts in(batch, bs.inputLweDim + 1);
+  Ciphertexts out(batch, bs.outputLweSize(), false);
+  // The mapped bootstrap applies a lookup table per ciphertext
+  Ciphertexts luts(variant == BootstrapVariant::MAPPED ? batch : 1,
+                   bs.polySize);
+  auto scalar = memref_bootstrap_lwe_u64;
+  auto vector = memref_batched_bootstrap_lwe_u64;
+  auto mapped = memref_batched_mapped_bootstrap_lwe_u64;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (gpu) {
+    scalar = memref_bootstrap_lwe_cuda_u64;
+    vector = memref_batched_bootstrap_lwe_cuda_u64;
+    mapped = memref_batched_mapped_bootstrap_lwe_cuda_u64;
+  }
+#endif
+  measure(state, batch, [&]() {
+    switch (variant) {
+    case BootstrapVariant::SCALAR:
+      for (uint64_t i = 0; i < batch; i++)
+        scalar(out.row(i), out.row(i), 0, out.size, 1, in.row(i), in.row(i), 0,
+               in.size, 1, luts.row(0), luts.row(0), 0, luts.size, 1,
+               bs.inputLweDim, bs.polySize, bs.level, bs.baseLog, bs.glweDim,
+               bs.bskIndex, set->context.get());
+      break;
+    case BootstrapVariant::BATCHED:
+      vector(out.data.data(), out.data.data(), 0, batch, out.size, out.size, 1,
+             in.data.data(), in.data.data(), 0, batch, in.size, in.size, 1,
+             luts.row(0), luts.row(0), 0, luts.size, 1, bs.inputLweDim,
+             bs.polySize, bs.level, bs.baseLog, bs.glweDim, bs.bskIndex,
+             set->context.get());
+      break;
+    case BootstrapVariant::MAPPED:
+      mapped(out.data.data(), out.data.data(), 0, batch, out.size, out.size, 1,
+             in.data.data(), in.data.data(), 0, batch, in.size, in.size, 1,
+             luts.data.data(), luts.data.data(), 0, batch, luts.size, luts.size,
+             1, bs.inputLweDim, bs.polySize, bs.level, bs.baseLog, bs.glweDim,
+             bs.bskIndex, set->context.get());
+      break;
+    }
+  });
+}
+
+static void BM_KeyswitchBootstrap(benchmark::State &state, ParameterSet *set,
+                                  bool batched) {
+  auto &ks = *set->keyswitch;
+  auto &bs = *set->bootstrap;
+  uint64_t batch = state.range(0);
+  Ciphertexts in(batch, ks.inputLweDim + 1);
+  Ciphertexts out(batch, bs.outputLweSize(), false);
+  Ciphertexts lut(1, bs.polySize);
+  measure(state, batch, [&]() {
+    if (batched) {
+      memref_batched_keyswitch_bootstrap_lwe_u64(
+          out.data.data(), out.data.data(), 0, batch, out.size, out.size, 1,
+          in.data.data(), in.data.data(), 0, batch, in.size, in.size, 1,
+          lut.row(0), lut.row(0), 0, lut.size, 1, ks.level, ks.baseLog,
+          ks.inputLweDim, ks.outputLweDim, ks.kskIndex, bs.polySize, bs.level,
+          bs.baseLog, bs.glweDim, bs.bskIndex, set->context.get());
+      return;
+    }
+    for (uint64_t i = 0; i < batch; i++)
+      memref_keyswitch_bootstrap_lwe_u64(
+          out.row(i), out.row(i), 0, out.size, 1, in.row(i), in.row(i), 0,
+          in.size, 1, lut.row(0), lut.row(0), 0, lut.size, 1, ks.level,
+          ks.baseLog, ks.inputLweDim, ks.outputLweDim, ks.kskIndex, bs.polySize,
+          bs.level, bs.baseLog, bs.glweDim, bs.bskIndex, set->context.get());
+  });
+}
+
+enum class LeveledOp { ADD, MUL_CLEARTEXT, NEGATE };
+
+static void BM_Leveled(benchmark::State &state, ParameterSet *set,
+                       LeveledOp leveledOp, bool batched) {
+  uint64_t batch = state.range(0);
+  uint64_t size = set->bootstrap->outputLweSize();
+  Ciphertexts ct0(batch, size), ct1(batch, size);
+  Ciphertexts out(batch, size, false);
+  std::vector<uint64_t> cleartexts(batch, 3);
+  uint64_t *d0 = ct0.data.data(), *d1 = ct1.data.data(),
+           *o = out.data.data();
+  measure(state, batch, [&]() {
+    switch (leveledOp) {
+    case LeveledOp::ADD:
+      if (batched) {
+        memref_batched_add_lwe_ciphertexts_u64(o, o, 0, batch, size, size, 1,
+                                               d0, d0, 0, batch, size, size, 1,
+                                               d1, d1, 0, batch, size, size, 1);
+        return;
+      }
+      for (uint64_t i = 0; i < batch; i++)
+        memref_add_lwe_ciphertexts_u64(out.row(i), out.row(i), 0, size, 1,
+                                       ct0.row(i), ct0.row(i), 0, size, 1,
+                                       ct1.row(i), ct1.row(i), 0, size, 1);
+      return;
+    case LeveledOp::MUL_CLEARTEXT:
+      if (batched) {
+        memref_batched_mul_cleartext_lwe_ciphertext_u64(
+            o, o, 0, batch, size, size, 1, d0, d0, 0, batch, size, size, 1,
+            cleartexts.data(), cleartexts.data(), 0, batch, 1);
+        return;
+      }
+      for (uint64_t i = 0; i < batch; i++)
+        memref_mul_cleartext_lwe_ciphertext_u64(out.row(i), out.row(i), 0,
+                                                size, 1, ct0.row(i), ct0.row(i),
+                                                0, size, 1, cleartexts[i]);
+      return;
+    case LeveledOp::NEGATE:
+      if (batched) {
+        memref_batched_negate_lwe_ciphertext_u64(o, o, 0, batch, size, size, 1,
+                                                 d0, d0, 0, batch, size, size,
+                                                 1);
+        return;
+      }
+      for (uint64_t i = 0; i < batch; i++)
+        memref_negate_lwe_ciphertext_u64(out.row(i), out.row(i), 0, size, 1,
+                                         ct0.row(i), ct0.row(i), 0, size, 1);
+      return;
+    }
+  });
+}
+
+static void BM_WopPBS(benchmark::State &state, ParameterSet *set, bool batched,
+                      bool gpu) {
+  auto &wop = *set->wopPBS;
+  uint64_t batch = state.range(0);
+  uint64_t blocks = wop.crtDecomposition.size();
+  Ciphertexts in(batch * blocks, wop.lweSize);
+  Ciphertexts out(batch * blocks, wop.lweSize, false);
+  Ciphertexts luts(blocks, wop.lutSize);
+  // The lookup tables are not encoded, so the results are meaningless
+  uint64_t *crt = wop.crtDecomposition.data();
+  auto scalar = memref_wop_pbs_crt_buffer;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (gpu)
+    scalar = memref_wop_pbs_crt_buffer_cuda;
+#endif
+  measure(state, batch, [&]() {
+    if (batched) {
+      memref_batched_wop_pbs_crt_buffer(
+          out.data.data(), out.data.data(), 0, batch, blocks, out.size,
+          blocks * out.size, out.size, 1, in.data.data(), in.data.data(), 0,
+          batch, blocks, in.size, blocks * in.size, in.size, 1,
+          luts.data.data(), luts.data.data(), 0, blocks, luts.size, luts.size,
+          1, crt, crt, 0, blocks, 1, wop.packingKeyswitchInputLweDim,
+          wop.circuitBootstrapLevel, wop.circuitBootstrapBaseLog,
+          wop.keyswitchLevel, wop.keyswitchBaseLog, wop.bootstrapLevel,
+          wop.bootstrapBaseLog, wop.packingKeyswitchLevel,
+          wop.packingKeyswitchBaseLog, wop.packingKeyswitchPolySize,
+          wop.kskIndex, wop.bskIndex, wop.pkskIndex, set->context.get());
+      return;
+    }
+    for (uint64_t i = 0; i < batch; i++)
+      scalar(out.row(i * blocks), out.row(i * blocks), 0, blocks, out.size,
+             out.size, 1, in.row(i * blocks), in.row(i * blocks), 0, blocks,
+             in.size, in.size, 1, luts.data.data(), luts.data.data(), 0, blocks,
+             luts.size, luts.size, 1, crt, crt, 0, blocks, 1,
+             wop.packingKeyswitchInputLweDim, wop.circuitBootstrapLevel,
+             wop.circuitBootstrapBaseLog, wop.keyswitchLevel,
+             wop.keyswitchBaseLog, wop.bootstrapLevel, wop.bootstrapBaseLog,
+             wop.packingKeyswitchLevel, wop.packingKeyswitchBaseLog,
+             wop.packingKeyswitchPolySize, wop.kskIndex, wop.bskIndex,
+             wop.pkskIndex, set->context.get());
+  });
+}
+
+/// Returns a program applying a lookup table to an integer of `precision`
+/// bits.
+static std::string lookupTableProgram(unsigned precision) {
+  std::ostringstream s;
+  s << "func.func @main(%arg0: !FHE.eint<" << precision
+    << ">, %arg1: tensor<" << (1 << precision) << "xi64>) -> !FHE.eint<"
+    << precision << "> {\n"
+    << "  %0 = \"FHE.apply_lookup_table\"(%arg0, %arg1): (!FHE.eint<"
+    << precision << ">, tensor<" << (1 << precision)
+    << "xi64>) -> (!FHE.eint<" << precision << ">)\n"
+    << "  return %0: !FHE.eint<" << precision << ">\n"
+    << "}\n";
+  return s.str();
+}
+
+static void registerPrimitiveBenchmarks(std::shared_ptr<ParameterSet> set,
+                                        std::vector<int64_t> batchSizes,
+                                        bool gpu) {
+  auto registerBenchmark = [&](std::string primitive, auto bench) {
+    std::ostringstream name;
+    name << "primitive/" << primitive << "/" << set->name;
+    // The set is kept alive by the benchmark
+    auto b = benchmark::RegisterBenchmark(
+        name.str().c_str(), [set, bench](benchmark::State &state) {
+          bench(state, set.get());
+        });
+    b->ArgName("batch")->UseRealTime();
+    for (auto batchSize : batchSizes)
+      b->Arg(batchSize);
+  };
+
+  if (set->keyswitch) {
+    for (bool batched : {false, true})
+      registerBenchmark(batched ? "batched_keyswitch" : "keyswitch",
+                        [=](benchmark::State &state, ParameterSet *set) {
+                          BM_Keyswitch(state, set, batched, false);
+                        });
+  }
+  if (set->bootstrap) {
+    std::vector<std::pair<std::string, BootstrapVariant>> variants = {
+        {"bootstrap", BootstrapVariant::SCALAR},
+        {"batched_bootstrap", BootstrapVariant::BATCHED},
+        {"batched_mapped_bootstrap", BootstrapVariant::MAPPED}};
+    for (auto [name, variant] : variants)
+      registerBenchmark(name, [=](benchmark::State &state, ParameterSet *set) {
+        BM_Bootstrap(state, set, variant, false);
+      });
+    std::vector<std::pair<std::string, LeveledOp>> leveledOps = {
+        {"add_lwe", LeveledOp::ADD},
+        {"mul_cleartext_lwe", LeveledOp::MUL_CLEARTEXT},
+        {"negate_lwe", LeveledOp::NEGATE}};
+    for (auto [name, leveledOp] : leveledOps)
+      for (bool batched : {false, true})
+        registerBenchmark(batched ? "batched_" + name : name,
+                          [=](benchmark::State &state, ParameterSet *set) {
+                            BM_Leveled(state, set, leveledOp, batched);
+                          });
+  }
+  if (set->keyswitch && set->bootstrap) {
+    for (bool batched : {false, true})
+      registerBenchmark(batched ? "batched_keyswitch_bootstrap"
+                                : "keyswitch_bootstrap",
+                        [=](benchmark::State &state, ParameterSet *set) {
+                          BM_KeyswitchBootstrap(state, set, batched);
+                        });
+  }
+  if (set->wopPBS) {
+    for (bool batched : {false, true})
+      registerBenchmark(batched ? "batched_wop_pbs_crt" : "wop_pbs_crt",
+                        [=](benchmark::State &state, ParameterSet *set) {
+                          BM_WopPBS(state, set, batched, false);
+                        });
+  }
+
+  if (!gpu)
+    return;
+#ifdef CONCRETELANG_CUDA_SUPPORT
+  if (set->keyswitch) {
+    for (bool batched : {false, true})
+      registerBenchmark(batched ? "batched_keyswitch_cuda" : "keyswitch_cuda",
+                        [=](benchmark::State &state, ParameterSet *set) {
+                          BM_Keyswitch(state, set, batched, true);
+                        });
+  }
+  if (set->bootstrap) {
+    std::vector<std::pair<std::string, BootstrapVariant>> variants = {
+        {"bootstrap_cuda", BootstrapVariant::SCALAR},
+        {"batched_bootstrap_cuda", BootstrapVariant::BATCHED},
+        {"batched_mapped_bootstrap_cuda", BootstrapVariant::MAPPED}};
+    for (auto [name, variant] : variants)
+      registerBenchmark(name, [=](benchmark::State &state, ParameterSet *set) {
+        BM_Bootstrap(state, set, variant, true);
+      });
+  }
+  if (set->wopPBS) {
+    registerBenchmark("wop_pbs_crt_cuda",
+                      [=](benchmark::State &state, ParameterSet *set) {
+                        BM_WopPBS(state, set, false, true);
+                      });
+  }
+#endif
+}
+
+int main(int argc, char **argv) {
+  // Parse google benchmark options
+  ::benchmark::Initialize(&argc, argv);
+
+  llvm::cl::list<unsigned> clPrecisions(
+      "precision",
+      llvm::cl::desc("Precisions of the programs whose parameters are used "
+                     "for the keyswitch, bootstrap and leveled benchmarks"),
+      llvm::cl::CommaSeparated);
+  llvm::cl::list<unsigned> clCrtPrecisions(
+      "crt-precision",
+      llvm::cl::desc("Precisions of the CRT encoded programs whose "
+                     "parameters are used for the WoP-PBS benchmarks"),
+      llvm::cl::CommaSeparated);
+  llvm::cl::list<int64_t> clBatchSizes(
+      "batch-size",
+      llvm::cl::desc("Numbers of ciphertexts processed per iteration"),
+      llvm::cl::CommaSeparated);
+  llvm::cl::opt<bool> gpu(
+      "gpu",
+      llvm::cl::desc("Also benchmark the CUDA variants of the primitives"),
+      llvm::cl::init(false));
+  llvm::cl::opt<int> securityLevel(
+      "security-level",
+      llvm::cl::desc("Set the number of bit of security to target"),
+      llvm::cl::init(mlir::concretelang::optimizer::DEFAULT_CONFIG.security));
+  llvm::cl::list<std::string> clHugePages(
+      "huge-pages",
+      llvm::cl::desc("Huge pages policies of the keys and buffers to compare "
+                     "(off, transparent, 2mb or 1gb), the one of the "
+                     "environment by default"),
+      llvm::cl::CommaSeparated);
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  std::vector<unsigned> precisions = clPrecisions;
+  if (precisions.empty())
+    precisions = {2, 4, 6, 8};
+  std::vector<unsigned> crtPrecisions = clCrtPrecisions;
+  if (crtPrecisions.empty())
+    crtPrecisions = {10, 16};
+  std::vector<int64_t> batchSizes = clBatchSizes;
+  if (batchSizes.empty())
+    batchSizes = {1, 16, 256};
+
+  CompilationOptions options;
+  options.optimizerConfig.security = securityLevel.getValue();
+
+  // The CRT encoding makes the optimizer choose WoP-PBS parameters
+  std::vector<std::tuple<std::string, unsigned, concrete_optimizer::Encoding>>
+      programs;
+  for (auto precision : precisions)
+    programs.emplace_back("pbs_" + std::to_string(precision), precision,
+                          concrete_optimizer::Encoding::Native);
+  for (auto precision : crtPrecisions)
+    programs.emplace_back("crt_" + std::to_string(precision), precision,
+                          concrete_optimizer::Encoding::Crt);
+
+  namespace huge_pages = ::concretelang::huge_pages;
+  std::vector<std::optional<huge_pages::Policy>> policies;
+  for (auto &name : clHugePages) {
+    auto policy = huge_pages::getPolicyByName(name.c_str());
+    if (!policy) {
+      llvm::errs() << "Error: unknown huge pages policy " << name << "\n";
+      return 1;
+    }
+    policies.push_back(policy);
+  }
+  if (policies.empty())
+    policies.push_back(std::nullopt);
+
+  // The sets of each policy hold their own fourier keys, the other buffers
+  // of the runtime following the policy of the environment
+  huge_pages::Policy environmentPolicy = huge_pages::getPolicy();
+  for (auto policy : policies) {
+    std::string suffix;
+    if (policy) {
+      huge_pages::setPolicy(*policy);
+      suffix = std::string("_huge_pages_") + huge_pages::getPolicyName(*policy);
+    }
+    for (auto [name, precision, encoding] : programs) {
+      options.optimizerConfig.encoding = encoding;
+      auto set = loadParameterSet(name + suffix, lookupTableProgram(precision),
+                                  options);
+      if (!set)
+        return 1;
+      registerPrimitiveBenchmarks(set, batchSizes, gpu);
+    }
+  }
+  huge_pages::setPolicy(environmentPolicy);
+
+  // The times of the bootstraps depend on the kernels their FFTs run on
+  ::benchmark::AddCustomContext(
+      "fft_backend", mlir::concretelang::getFftBackendName(
+                         mlir::concretelang::getFftBackend()));
+  ::benchmark::AddCustomContext("huge_pages",
+                                huge_pages::getPolicyName(environmentPolicy));
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
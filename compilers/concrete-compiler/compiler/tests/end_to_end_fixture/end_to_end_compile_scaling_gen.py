@@ -0,0 +1,106 @@
+import argparse
+
+# The circuits exercise the scaling of the compilation passes with the number
+# of operations, as in unrolled circuits, and are only meant for the compile
+# benchmark.
+
+PRECISION = 3
+
+
+def print_test(input_value, output_value):
+    print("tests:")
+    print("  - inputs:")
+    print(f"    - scalar: {input_value}")
+    print("    outputs:")
+    print(f"    - scalar: {output_value}")
+
+
+def leveled_chain(size):
+    # Alternates additions and subtractions of 1, computing the identity
+    print(f"description: leveled_chain_{size}ops")
+    print("program: |")
+    print(f"  func.func @main(%arg0: !FHE.eint<{PRECISION}>) -> !FHE.eint<{PRECISION}> {{")
+    print("    %c1 = arith.constant 1 : i4")
+    value = "%arg0"
+    for i in range(size):
+        op = "FHE.add_eint_int" if i % 2 == 0 else "FHE.sub_eint_int"
+        print(
+            f'    %{i} = "{op}"({value}, %c1): (!FHE.eint<{PRECISION}>, i4) -> (!FHE.eint<{PRECISION}>)'
+        )
+        value = f"%{i}"
+    print(f"    return {value}: !FHE.eint<{PRECISION}>")
+    print("  }")
+    print_test(3, 3 + size % 2)
+
+
+def lookup_chain(size):
+    # Chains lookups of the identity table
+    table = ", ".join(str(i) for i in range(2**PRECISION))
+    print(f"description: lookup_chain_{size}ops")
+    print("program: |")
+    print(f"  func.func @main(%arg0: !FHE.eint<{PRECISION}>) -> !FHE.eint<{PRECISION}> {{")
+    print(f"    %tlu = arith.constant dense<[{table}]> : tensor<{2**PRECISION}xi64>")
+    value = "%arg0"
+    for i in range(size):
+        print(
+            f'    %{i} = "FHE.apply_lookup_table"({value}, %tlu): (!FHE.eint<{PRECISION}>, tensor<{2**PRECISION}xi64>) -> (!FHE.eint<{PRECISION}>)'
+        )
+        value = f"%{i}"
+    print(f"    return {value}: !FHE.eint<{PRECISION}>")
+    print("  }")
+    print_test(5, 5)
+
+
+def tensor_lookups(size):
+    # Adds 1 to the elements of a large tensor, then looks them up in the
+    # table subtracting 1, the tensor operations being lowered to an
+    # operation per element
+    table = ", ".join(str((i - 1) % 2**PRECISION) for i in range(2**PRECISION))
+    tensor = f"tensor<{size}x!FHE.eint<{PRECISION}>>"
+    print(f"description: tensor_lookups_{size}elements")
+    print("program: |")
+    print(f"  func.func @main(%arg0: {tensor}) -> {tensor} {{")
+    print("    %c1 = arith.constant dense<1> : tensor<1xi4>")
+    print(f"    %tlu = arith.constant dense<[{table}]> : tensor<{2**PRECISION}xi64>")
+    print(
+        f'    %0 = "FHELinalg.add_eint_int"(%arg0, %c1): ({tensor}, tensor<1xi4>) -> ({tensor})'
+    )
+    print(
+        f'    %1 = "FHELinalg.apply_lookup_table"(%0, %tlu): ({tensor}, tensor<{2**PRECISION}xi64>) -> ({tensor})'
+    )
+    print(f"    return %1: {tensor}")
+    print("  }")
+    # The inputs leave room for the addition
+    values = ", ".join(str(i % (2**PRECISION - 1)) for i in range(size))
+    print("tests:")
+    print("  - inputs:")
+    print(f"    - tensor: [{values}]")
+    print(f"      shape: [{size}]")
+    print("    outputs:")
+    print(f"    - tensor: [{values}]")
+    print(f"      shape: [{size}]")
+
+
+def main(args):
+    print("# /!\ DO NOT EDIT MANUALLY THIS FILE MANUALLY")
+    print("# /!\ THIS FILE HAS BEEN GENERATED THANKS THE end_to_end_compile_scaling_gen.py scripts")
+    print("# This file aims to benchmark the compilation time of circuits with many operations.\n")
+    first = True
+    for size in args.sizes:
+        for generate in [leveled_chain, lookup_chain, tensor_lookups]:
+            if not first:
+                print("---")
+            first = False
+            generate(size)
+
+
+if __name__ == "__main__":
+    CLI = argparse.ArgumentParser()
+    CLI.add_argument(
+        "--sizes",
+        type=int,
+        nargs="+",
+        default=[1000, 10000, 100000],
+        help="The numbers of operations or elements of the circuits",
+    )
+    main(CLI.parse_args())
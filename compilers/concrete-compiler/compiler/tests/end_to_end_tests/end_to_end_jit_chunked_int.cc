@@ -28,3 +28,73 @@ TEST(Lambda_chunked_int, chunked_int_add_eint) {
       lambda({Tensor<uint64_t>(2057594037927936), Tensor<uint64_t>(1111)}),
       (uint64_t)2057594037929047);
 }
+
+namespace {
+
+// Compiles `src` letting the compiler chunk the integers when the optimizer
+// prices the chunked circuit below the unchunked one
+Result<TestProgram> compileChunkedByCost(llvm::StringRef src) {
+  auto options = mlir::concretelang::CompilationOptions();
+  options.optimizerConfig.global_p_error = DEFAULT_global_p_error;
+  options.chunkIntegersByCost = true;
+  options.chunkSize = 4;
+  options.chunkWidth = 2;
+  TestProgram program(options);
+  OUTCOME_TRYV(program.compile(src.str()));
+  OUTCOME_TRYV(program.generateKeyset());
+  return std::move(program);
+}
+
+// The integer encoding of the first input of the first circuit
+Result<Message<concreteprotocol::IntegerCiphertextEncodingInfo>>
+firstInputEncoding(TestProgram &program) {
+  OUTCOME_TRY(auto programInfo, program.getProgramInfo());
+  auto typeInfo =
+      programInfo.asReader().getCircuits()[0].getInputs()[0].getTypeInfo();
+  if (!typeInfo.hasLweCiphertext() ||
+      !typeInfo.getLweCiphertext().getEncoding().hasInteger())
+    return StringError("the first input is no encrypted integer");
+  return Message<concreteprotocol::IntegerCiphertextEncodingInfo>(
+      typeInfo.getLweCiphertext().getEncoding().getInteger());
+}
+
+} // namespace
+
+// A 64 bits addition has no native nor crt parameters, so the chunked
+// circuit is the cheaper one
+TEST(Lambda_chunked_int, chunked_by_cost_wide_add_eint) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(program, compileChunkedByCost(R"XXX(
+    func.func @main(%arg0: !FHE.eint<64>, %arg1: !FHE.eint<64>) -> !FHE.eint<64> {
+      %1 = "FHE.add_eint"(%arg0, %arg1): (!FHE.eint<64>, !FHE.eint<64>) -> (!FHE.eint<64>)
+      return %1: !FHE.eint<64>
+    }
+    )XXX"));
+  ASSERT_ASSIGN_OUTCOME_VALUE(encoding, firstInputEncoding(program));
+  auto mode = encoding.asReader().getMode();
+  ASSERT_TRUE(mode.hasChunked());
+  ASSERT_EQ(mode.getChunked().getSize(), 4u);
+  ASSERT_EQ(mode.getChunked().getWidth(), 2u);
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      result, program.call({Tensor<uint64_t>(72057594037927936),
+                            Tensor<uint64_t>(10000)}));
+  ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0],
+            (uint64_t)72057594037937936);
+}
+
+// Integers no wider than a chunk are left as they are by the chunking, which
+// makes the chunked circuit no cheaper, so the integers stay native
+TEST(Lambda_chunked_int, chunked_by_cost_narrow_lut) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(program, compileChunkedByCost(R"XXX(
+    func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+      %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+      %1 = "FHE.apply_lookup_table"(%arg0, %cst): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+      return %1: !FHE.eint<3>
+    }
+    )XXX"));
+  ASSERT_ASSIGN_OUTCOME_VALUE(encoding, firstInputEncoding(program));
+  ASSERT_TRUE(encoding.asReader().getMode().hasNative());
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(result, program.call({Tensor<uint64_t>(5)}));
+  ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], (uint64_t)6);
+}
@@ -0,0 +1,179 @@
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "concretelang/Runtime/DFRuntime.hpp"
+#include "concretelang/Runtime/dfr_debug_interface.h"
+#include "concretelang/TestLib/TestProgram.h"
+#include "end_to_end_jit_test.h"
+#include "tests_tools/GtestEnvironment.h"
+
+// Tests of the dataflow runtime, run on a single node by
+// `make run-end-to-end-dataflow-tests` and on several nodes by
+// `make run-end-to-end-distributed-tests`, with the environment variables
+// of the runtime features under test.
+//
+// All the nodes run the same tests and make the same calls, the remote
+// nodes serving the tasks of the root node during their calls, but only
+// the root node gets the results. The tests share a single program, as the
+// remote nodes of the persistent runtime only load the program of their
+// first call.
+
+using concretelang::testlib::TestProgram;
+
+namespace {
+
+// Lookups on two tensors, whose results are added and looked up again. The
+// lookups and the addition are tasks of their own, which exchange memrefs,
+// and run parallel loops.
+const char *TREE = R"XXX(
+func.func @main(%a: tensor<4x!FHE.eint<4>>, %b: tensor<4x!FHE.eint<4>>) -> tensor<4x!FHE.eint<4>> {
+  %tlu = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 7, 6, 5, 4, 3, 2, 1, 0]> : tensor<16xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%a, %tlu) : (tensor<4x!FHE.eint<4>>, tensor<16xi64>) -> tensor<4x!FHE.eint<4>>
+  %1 = "FHELinalg.apply_lookup_table"(%b, %tlu) : (tensor<4x!FHE.eint<4>>, tensor<16xi64>) -> tensor<4x!FHE.eint<4>>
+  %2 = "FHELinalg.add_eint"(%0, %1) : (tensor<4x!FHE.eint<4>>, tensor<4x!FHE.eint<4>>) -> tensor<4x!FHE.eint<4>>
+  %3 = "FHELinalg.apply_lookup_table"(%2, %tlu) : (tensor<4x!FHE.eint<4>>, tensor<16xi64>) -> tensor<4x!FHE.eint<4>>
+  return %3 : tensor<4x!FHE.eint<4>>
+}
+)XXX";
+
+uint64_t fold(uint64_t x) { return x < 8 ? x : 15 - x; }
+
+class DataflowRuntime : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    auto maybeProgram =
+        internalCheckedJit(TREE, "main", false, /*dataflowParallelize=*/true,
+                           /*loopParallelize=*/true);
+    ASSERT_TRUE(maybeProgram.has_value()) << maybeProgram.error().mesg;
+    program.emplace(std::move(maybeProgram.value()));
+  }
+
+  static void TearDownTestSuite() { program.reset(); }
+
+  void SetUp() override { ASSERT_TRUE(program.has_value()); }
+
+  static std::vector<uint64_t> inputs(uint64_t seed) {
+    std::vector<uint64_t> values(4);
+    for (uint64_t i = 0; i < 4; i++)
+      values[i] = (seed * 7 + i * 5) % 16;
+    return values;
+  }
+
+  // Calls the program on the inputs of `seedA` and `seedB` and, on the
+  // root node, checks the result
+  static void callAndCheck(uint64_t seedA, uint64_t seedB) {
+    auto a = inputs(seedA);
+    auto b = inputs(seedB);
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        result, program->call({Tensor<uint64_t>(a, {4}),
+                               Tensor<uint64_t>(b, {4})}));
+    if (!mlir::concretelang::dfr::_dfr_is_root_node())
+      return;
+    auto output = result[0].getTensor<uint64_t>().value();
+    for (size_t i = 0; i < 4; i++)
+      ASSERT_EQ(output[i], fold(fold(a[i]) + fold(b[i])));
+  }
+
+  static std::optional<TestProgram> program;
+};
+
+std::optional<TestProgram> DataflowRuntime::program;
+
+bool envSet(const char *name) { return getenv(name) != nullptr; }
+
+} // namespace
+
+TEST_F(DataflowRuntime, tasks_with_tensor_payloads) {
+  for (uint64_t seed = 0; seed < 4; seed++)
+    callAndCheck(seed, seed + 1);
+}
+
+// The runtime keeps no state of a call that spoils the next ones, the
+// persistent runtime in particular keeping the remote nodes and their keys
+// across calls
+TEST_F(DataflowRuntime, repeated_calls) {
+  for (uint64_t seed = 0; seed < 16; seed++)
+    callAndCheck(seed, 15 - seed);
+}
+
+// Calls in flight together, which the distributed runtime only allows in
+// its persistent mode
+TEST_F(DataflowRuntime, concurrent_calls) {
+  if (mlir::concretelang::dfr::_dfr_is_distributed() &&
+      !envSet("DFR_PERSISTENT_RUNTIME"))
+    GTEST_SKIP() << "calls are serialized by the distributed runtime";
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, program->getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, program->getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, program->getKeyset());
+
+  const size_t threads = 4;
+  const size_t callsPerThread = 4;
+  std::vector<std::vector<TransportValue>> args(threads * callsPerThread);
+  for (size_t c = 0; c < args.size(); c++) {
+    for (uint64_t seed : {c, c + 3}) {
+      ASSERT_ASSIGN_OUTCOME_VALUE(
+          arg, clientCircuit.prepareInput(
+                   Tensor<uint64_t>(inputs(seed), {4}), args[c].size()));
+      args[c].push_back(arg);
+    }
+  }
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(
+      args.size());
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++)
+    workers.emplace_back([&, t]() {
+      for (size_t c = t * callsPerThread; c < (t + 1) * callsPerThread; c++)
+        results[c] = serverCircuit.call(keyset.server, args[c]);
+    });
+  for (auto &worker : workers)
+    worker.join();
+
+  if (!mlir::concretelang::dfr::_dfr_is_root_node())
+    return;
+  for (size_t c = 0; c < args.size(); c++) {
+    ASSERT_OUTCOME_HAS_VALUE(*results[c]);
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        value, clientCircuit.processOutput(results[c]->value()[0], 0));
+    auto output = value.getTensor<uint64_t>().value();
+    auto a = inputs(c);
+    auto b = inputs(c + 3);
+    for (size_t i = 0; i < 4; i++)
+      ASSERT_EQ(output[i], fold(fold(a[i]) + fold(b[i])));
+  }
+}
+
+// With a small DFR_SPECULATION_FACTOR, the remote tasks running for longer
+// than a fraction of their expected time are executed again on another
+// node, and the first result is kept
+TEST_F(DataflowRuntime, speculative_reexecution) {
+  if (!mlir::concretelang::dfr::_dfr_is_distributed() ||
+      !envSet("DFR_SPECULATION_FACTOR"))
+    GTEST_SKIP() << "speculation needs several nodes and "
+                    "DFR_SPECULATION_FACTOR";
+  size_t reexecutionsBefore, wins, failures;
+  _dfr_debug_get_speculation_stats(&reexecutionsBefore, &wins, &failures);
+  // The first calls give the expected times of the tasks
+  for (uint64_t seed = 0; seed < 8; seed++)
+    callAndCheck(seed, seed + 2);
+  if (!mlir::concretelang::dfr::_dfr_is_root_node())
+    return;
+  size_t reexecutions;
+  _dfr_debug_get_speculation_stats(&reexecutions, &wins, &failures);
+  ASSERT_GT(reexecutions, reexecutionsBefore);
+  ASSERT_EQ(failures, 0u);
+}
+
+// With CONCRETE_RELEASE_STANDARD_BSK, the contexts only keep the fourier
+// form of the bootstrap keys, which is what the root node sends to the
+// remote nodes
+TEST_F(DataflowRuntime, released_standard_keys) {
+  if (!mlir::concretelang::dfr::_dfr_is_distributed() ||
+      !envSet("CONCRETE_RELEASE_STANDARD_BSK"))
+    GTEST_SKIP() << "the keys are only sent with several nodes and "
+                    "CONCRETE_RELEASE_STANDARD_BSK";
+  for (uint64_t seed = 0; seed < 4; seed++)
+    callAndCheck(seed, 3 - seed);
+}
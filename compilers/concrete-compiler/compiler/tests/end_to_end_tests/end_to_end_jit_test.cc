@@ -1,11 +1,20 @@
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <optional>
+#include <thread>
 #include <type_traits>
 
+#include "concretelang/Runtime/context.h"
+#include "concretelang/ServerLib/KeysetStore.h"
 #include "concretelang/TestLib/TestProgram.h"
 #include "end_to_end_jit_test.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "tests_tools/GtestEnvironment.h"
 
 TEST(CompileAndRunClear, add_u64) {
@@ -502,3 +511,709 @@ func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
   ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.simulate({Tensor<uint64_t>(7)}));
   ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], (uint64_t)(7));
 }
+
+TEST(CompileAndRun, destination_passing) {
+  mlir::concretelang::CompilationOptions options;
+  options.destinationPassing = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<3x!FHE.eint<5>>, %arg1: !FHE.eint<5>) -> (tensor<3x!FHE.eint<5>>, !FHE.eint<5>) {
+  %cst = arith.constant 1 : i6
+  %0 = "FHELinalg.add_eint_int"(%arg0, %cst) : (tensor<3x!FHE.eint<5>>, i6) -> tensor<3x!FHE.eint<5>>
+  %1 = "FHE.add_eint_int"(%arg1, %cst) : (!FHE.eint<5>, i6) -> !FHE.eint<5>
+  return %0, %1: tensor<3x!FHE.eint<5>>, !FHE.eint<5>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      result,
+      circuit.call({Tensor<uint64_t>({1, 2, 3}, {3}), Tensor<uint64_t>(4)}));
+  Tensor<uint64_t> tensor = result[0].getTensor<uint64_t>().value();
+  ASSERT_EQ(tensor.values.size(), (size_t)3);
+  ASSERT_EQ(tensor.values[0], 2_u64);
+  ASSERT_EQ(tensor.values[1], 3_u64);
+  ASSERT_EQ(tensor.values[2], 4_u64);
+  ASSERT_EQ(result[1].getTensor<uint64_t>().value()[0], 5_u64);
+}
+
+#ifdef CONCRETELANG_RUNTIME_BITCODE
+TEST(CompileAndRun, runtime_bitcode) {
+  mlir::concretelang::CompilationOptions options;
+  options.runtimeBitcode = CONCRETELANG_RUNTIME_BITCODE;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<4x!FHE.eint<5>>, %arg1: tensor<4x!FHE.eint<5>>) -> tensor<4x!FHE.eint<5>> {
+  %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi6>
+  %max = arith.constant dense<31> : tensor<4xi6>
+  %0 = "FHELinalg.mul_eint_int"(%arg0, %cst) : (tensor<4x!FHE.eint<5>>, tensor<4xi6>) -> tensor<4x!FHE.eint<5>>
+  %1 = "FHELinalg.add_eint"(%0, %arg1) : (tensor<4x!FHE.eint<5>>, tensor<4x!FHE.eint<5>>) -> tensor<4x!FHE.eint<5>>
+  %2 = "FHELinalg.add_eint_int"(%1, %cst) : (tensor<4x!FHE.eint<5>>, tensor<4xi6>) -> tensor<4x!FHE.eint<5>>
+  %3 = "FHELinalg.sub_int_eint"(%max, %2) : (tensor<4xi6>, tensor<4x!FHE.eint<5>>) -> tensor<4x!FHE.eint<5>>
+  return %3: tensor<4x!FHE.eint<5>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      result, circuit.call({Tensor<uint64_t>({1, 2, 3, 4}, {4}),
+                            Tensor<uint64_t>({4, 3, 2, 1}, {4})}));
+  Tensor<uint64_t> tensor = result[0].getTensor<uint64_t>().value();
+  for (size_t i = 0; i < 4; i++) {
+    uint64_t sum = (i + 1) * (i + 1) + (4 - i) + (i + 1);
+    ASSERT_EQ(tensor.values[i], 31 - sum);
+  }
+}
+#endif
+
+TEST(CompileAndRun, execution_variants) {
+  mlir::concretelang::CompilationOptions options;
+  options.executionVariants = {"cpu", "loop"};
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<8x!FHE.eint<3>>) -> tensor<8x!FHE.eint<3>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<8x!FHE.eint<3>>, tensor<8xi64>) -> tensor<8x!FHE.eint<3>>
+  return %0: tensor<8x!FHE.eint<3>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_EQ(serverCircuit.getVariants(),
+            std::vector<std::string>({"cpu", "loop"}));
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      arg, clientCircuit.prepareInput(
+               Tensor<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7}, {8}), 0));
+  std::vector<TransportValue> args{arg};
+  for (std::string variant : {"", "cpu", "loop"}) {
+    ASSERT_OUTCOME_HAS_VALUE(serverCircuit.selectVariant(variant));
+    ASSERT_EQ(serverCircuit.getSelectedVariant(), variant);
+    ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                                serverCircuit.call(keyset.server, args));
+    ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                                clientCircuit.processOutput(result[0], 0));
+    Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+    for (size_t i = 0; i < 8; i++)
+      ASSERT_EQ(tensor.values[i], (i + 1) % 8);
+  }
+  ASSERT_OUTCOME_HAS_FAILURE(serverCircuit.selectVariant("gpu"));
+
+  // The variant can be selected while calls are in flight on other threads,
+  // each call running one of the variants
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(4);
+  std::vector<std::thread> callers;
+  for (size_t c = 0; c < results.size(); c++)
+    callers.emplace_back([&, c]() {
+      auto callArgs = args;
+      results[c] = serverCircuit.call(keyset.server, callArgs);
+    });
+  bool selected = true;
+  for (size_t i = 0; i < 16; i++)
+    selected &= serverCircuit.selectVariant(i % 2 ? "cpu" : "loop").has_value();
+  for (auto &caller : callers)
+    caller.join();
+  ASSERT_TRUE(selected);
+  for (auto &result : results) {
+    ASSERT_OUTCOME_HAS_VALUE(*result);
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        output, clientCircuit.processOutput(result->value()[0], 0));
+    Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+    for (size_t i = 0; i < 8; i++)
+      ASSERT_EQ(tensor.values[i], (i + 1) % 8);
+  }
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(fastest,
+                              serverCircuit.calibrateVariants(keyset.server,
+                                                              args));
+  ASSERT_EQ(serverCircuit.getSelectedVariant(), fastest);
+}
+
+TEST(CompileAndRun, compress_output_ciphertexts) {
+  mlir::concretelang::CompilationOptions options;
+  options.compressOutputCiphertexts = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<8x!FHE.eint<3>>) -> tensor<8x!FHE.eint<3>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<8x!FHE.eint<3>>, tensor<8xi64>) -> tensor<8x!FHE.eint<3>>
+  return %0: tensor<8x!FHE.eint<3>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_EQ(keyset.server.glwePackingKeyswitchKeys.size(), (size_t)1);
+  // The packed ciphertexts are encrypted under a key of their own
+  auto packingKey =
+      keyset.server.glwePackingKeyswitchKeys[0].getInfo().asReader();
+  ASSERT_NE(packingKey.getInputId(), packingKey.getOutputId());
+  ASSERT_EQ(packingKey.getOutputId() + 1, keyset.client.lweSecretKeys.size());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      arg, clientCircuit.prepareInput(
+               Tensor<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7}, {8}), 0));
+  std::vector<TransportValue> args{arg};
+  ASSERT_ASSIGN_OUTCOME_VALUE(result, serverCircuit.call(keyset.server, args));
+
+  // The 8 ciphertexts are packed in a single glwe ciphertext
+  auto lweCiphertext = result[0].asReader().getTypeInfo().getLweCiphertext();
+  ASSERT_EQ(lweCiphertext.getCompression(),
+            concreteprotocol::Compression::GLWE_PACKING);
+  auto packedDimensions =
+      result[0].asReader().getRawInfo().getShape().getDimensions();
+  ASSERT_EQ(packedDimensions.size(), (size_t)2);
+  ASSERT_EQ(packedDimensions[0], (uint32_t)1);
+  size_t packedSize = 0;
+  for (auto blob : result[0].asReader().getPayload().getData())
+    packedSize += blob.size();
+  size_t lweSize = lweCiphertext.getEncryption().getLweDimension() + 1;
+  ASSERT_LT(packedSize, 8 * lweSize * sizeof(uint64_t));
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                              clientCircuit.processOutput(result[0], 0));
+  Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+  ASSERT_EQ(tensor.dimensions, std::vector<size_t>({8}));
+  for (size_t i = 0; i < 8; i++)
+    ASSERT_EQ(tensor.values[i], (i + 1) % 8);
+}
+
+TEST(CompileAndRun, buffered_encryption_randomness) {
+  TestProgram circuit;
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<8x!FHE.eint<3>>) -> tensor<8x!FHE.eint<3>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<8x!FHE.eint<3>>, tensor<8xi64>) -> tensor<8x!FHE.eint<3>>
+  return %0: tensor<8x!FHE.eint<3>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  // Blocks smaller than an input, so that they are refilled while encrypting
+  circuit.getEncryptionCsprng()->enableBuffering(3);
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+
+  for (size_t call = 0; call < 2; call++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        arg, clientCircuit.prepareInput(
+                 Tensor<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7}, {8}), 0));
+    std::vector<TransportValue> args{arg};
+    ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                                serverCircuit.call(keyset.server, args));
+    ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                                clientCircuit.processOutput(result[0], 0));
+    Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+    for (size_t i = 0; i < 8; i++)
+      ASSERT_EQ(tensor.values[i], (i + 1) % 8);
+  }
+}
+
+TEST(CompileAndRun, precomputed_input_encryptions) {
+  TestProgram circuit;
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<8x!FHE.eint<3>>) -> tensor<8x!FHE.eint<3>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<8x!FHE.eint<3>>, tensor<8xi64>) -> tensor<8x!FHE.eint<3>>
+  return %0: tensor<8x!FHE.eint<3>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(none,
+                              clientCircuit.getPrecomputedInputEncryptions(0));
+  ASSERT_EQ(none, (size_t)0);
+
+  // Enough for the first call and part of the second, whose missing
+  // encryptions of zero are computed on the spot
+  ASSERT_OUTCOME_HAS_VALUE(clientCircuit.precomputeInputEncryptions(0, 12));
+  // The encryptions are kept by the generator shared by the circuits
+  ASSERT_ASSIGN_OUTCOME_VALUE(otherCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(shared,
+                              otherCircuit.getPrecomputedInputEncryptions(0));
+  ASSERT_EQ(shared, (size_t)12);
+  for (size_t call = 0; call < 2; call++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        arg, clientCircuit.prepareInput(
+                 Tensor<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7}, {8}), 0));
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        left, clientCircuit.getPrecomputedInputEncryptions(0));
+    ASSERT_EQ(left, call == 0 ? (size_t)4 : (size_t)0);
+    std::vector<TransportValue> args{arg};
+    ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                                serverCircuit.call(keyset.server, args));
+    ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                                clientCircuit.processOutput(result[0], 0));
+    Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+    for (size_t i = 0; i < 8; i++)
+      ASSERT_EQ(tensor.values[i], (i + 1) % 8);
+  }
+}
+
+TEST(CompileAndRun, csprng_backends) {
+  using concretelang::csprng::EncryptionCSPRNG;
+  using concretelang::csprng::setCsprngBackend;
+  mlir::concretelang::CompilationOptions options;
+  options.compressEvaluationKeys = true;
+  options.compressInputCiphertexts = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<8x!FHE.eint<3>>) -> tensor<8x!FHE.eint<3>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<8x!FHE.eint<3>>, tensor<8xi64>) -> tensor<8x!FHE.eint<3>>
+  return %0: tensor<8x!FHE.eint<3>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  auto activeBackend = concretelang::csprng::getCsprngBackend();
+
+  // The seeded ciphertexts encrypted with a backend are decompressed on the
+  // server with another one
+  for (auto backend :
+       {CsprngBackend::Software, CsprngBackend::AesNi, CsprngBackend::ArmAes}) {
+    if (!setCsprngBackend(backend))
+      continue;
+    circuit.setEncryptionCsprng(std::make_shared<EncryptionCSPRNG>(0));
+    ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        arg, clientCircuit.prepareInput(
+                 Tensor<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7}, {8}), 0));
+    ASSERT_TRUE(setCsprngBackend(CsprngBackend::Software));
+    std::vector<TransportValue> args{arg};
+    ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                                serverCircuit.call(keyset.server, args));
+    ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                                clientCircuit.processOutput(result[0], 0));
+    Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+    for (size_t i = 0; i < 8; i++)
+      ASSERT_EQ(tensor.values[i], (i + 1) % 8);
+  }
+  ASSERT_TRUE(setCsprngBackend(activeBackend));
+}
+
+TEST(CompileAndRun, keyset_cache_reuses_unchanged_keys) {
+  using concretelang::keysets::KeysetCache;
+  TestProgram circuit;
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %0: !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_ASSIGN_OUTCOME_VALUE(programInfo, circuit.getProgramInfo());
+  auto keysetInfo =
+      (Message<concreteprotocol::KeysetInfo>)programInfo.asReader()
+          .getKeyset();
+
+  // The same keyset with a new secret key first, which shifts the
+  // identifiers of the others
+  Message<concreteprotocol::KeysetInfo> shiftedInfo;
+  auto secretKeys = keysetInfo.asReader().getLweSecretKeys();
+  auto shiftedSecretKeys =
+      shiftedInfo.asBuilder().initLweSecretKeys(secretKeys.size() + 1);
+  shiftedSecretKeys.setWithCaveats(0, secretKeys[0]);
+  shiftedSecretKeys[0].getParams().setLweDimension(
+      secretKeys[0].getParams().getLweDimension() + 1);
+  for (size_t i = 0; i < secretKeys.size(); i++) {
+    shiftedSecretKeys.setWithCaveats(i + 1, secretKeys[i]);
+    shiftedSecretKeys[i + 1].setId(i + 1);
+  }
+  auto bootstrapKeys = keysetInfo.asReader().getLweBootstrapKeys();
+  auto shiftedBootstrapKeys =
+      shiftedInfo.asBuilder().initLweBootstrapKeys(bootstrapKeys.size());
+  for (size_t i = 0; i < bootstrapKeys.size(); i++) {
+    shiftedBootstrapKeys.setWithCaveats(i, bootstrapKeys[i]);
+    shiftedBootstrapKeys[i].setInputId(bootstrapKeys[i].getInputId() + 1);
+    shiftedBootstrapKeys[i].setOutputId(bootstrapKeys[i].getOutputId() + 1);
+  }
+  auto keyswitchKeys = keysetInfo.asReader().getLweKeyswitchKeys();
+  auto shiftedKeyswitchKeys =
+      shiftedInfo.asBuilder().initLweKeyswitchKeys(keyswitchKeys.size());
+  for (size_t i = 0; i < keyswitchKeys.size(); i++) {
+    shiftedKeyswitchKeys.setWithCaveats(i, keyswitchKeys[i]);
+    shiftedKeyswitchKeys[i].setInputId(keyswitchKeys[i].getInputId() + 1);
+    shiftedKeyswitchKeys[i].setOutputId(keyswitchKeys[i].getOutputId() + 1);
+  }
+
+  llvm::SmallString<0> cachePath;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("keyset_cache", cachePath));
+  auto removeCache = llvm::make_scope_exit(
+      [&]() { llvm::sys::fs::remove_directories(cachePath); });
+  KeysetCache cache{std::string(cachePath)};
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, cache.getKeyset(keysetInfo, 1, 2));
+  ASSERT_ASSIGN_OUTCOME_VALUE(shiftedKeyset,
+                              cache.getKeyset(shiftedInfo, 1, 2));
+
+  // The evaluation keys are loaded from the entries of the first keyset,
+  // with the identifiers of the second one
+  for (size_t i = 0; i < secretKeys.size(); i++)
+    ASSERT_EQ(shiftedKeyset.client.lweSecretKeys[i + 1].getBuffer(),
+              keyset.client.lweSecretKeys[i].getBuffer());
+  for (size_t i = 0; i < bootstrapKeys.size(); i++) {
+    auto &key = shiftedKeyset.server.lweBootstrapKeys[i];
+    ASSERT_TRUE(key.getBuffer() ==
+                keyset.server.lweBootstrapKeys[i].getBuffer());
+    ASSERT_EQ(key.getInfo().asReader().getInputId(),
+              bootstrapKeys[i].getInputId() + 1);
+  }
+  for (size_t i = 0; i < keyswitchKeys.size(); i++) {
+    auto &key = shiftedKeyset.server.lweKeyswitchKeys[i];
+    ASSERT_TRUE(key.getBuffer() ==
+                keyset.server.lweKeyswitchKeys[i].getBuffer());
+    ASSERT_EQ(key.getInfo().asReader().getOutputId(),
+              keyswitchKeys[i].getOutputId() + 1);
+  }
+}
+
+TEST(CompileAndRun, keyset_store) {
+  using concretelang::serverlib::KeysetStore;
+  TestProgram circuit;
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %0: !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  auto footprint = KeysetStore::footprintOf(keyset.server);
+  ASSERT_GT(footprint.fourier, (size_t)0);
+
+  // The budget only fits one keyset
+  std::atomic<size_t> loads{0};
+  KeysetStore store(
+      [&](const std::string &tenantId) -> Result<ServerKeyset> {
+        loads++;
+        if (tenantId == "unknown")
+          return StringError("unknown tenant");
+        return keyset.server;
+      },
+      footprint.total());
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      arg, clientCircuit.prepareInput(Tensor<uint64_t>(3), 0));
+  std::vector<TransportValue> args{arg};
+  ASSERT_ASSIGN_OUTCOME_VALUE(result, store.call(serverCircuit, "a", args));
+  ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                              clientCircuit.processOutput(result[0], 0));
+  ASSERT_EQ(output.getTensor<uint64_t>().value()[0], 4_u64);
+  ASSERT_TRUE(store.isResident("a"));
+
+  store.prefetch("b");
+  ASSERT_OUTCOME_HAS_VALUE(store.get("b"));
+  ASSERT_TRUE(store.isResident("b"));
+  ASSERT_FALSE(store.isResident("a"));
+  ASSERT_EQ(store.getFootprint().total(), footprint.total());
+  ASSERT_EQ(loads.load(), (size_t)2);
+
+  ASSERT_FALSE(store.get("unknown").has_value());
+  ASSERT_FALSE(store.isResident("unknown"));
+  ASSERT_TRUE(store.isResident("b"));
+}
+
+TEST(CompileAndRun, decompress_keys_in_background) {
+  mlir::concretelang::CompilationOptions options;
+  options.compressEvaluationKeys = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %0: !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  // The copies of a keyset share their keys, calls made while the
+  // decompression is in progress wait for it
+  auto done = keyset.server.decompressInBackground();
+  ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.call({Tensor<uint64_t>(3)}));
+  ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], 4_u64);
+  done.wait();
+  ASSERT_ASSIGN_OUTCOME_VALUE(other, circuit.call({Tensor<uint64_t>(7)}));
+  ASSERT_EQ(other[0].getTensor<uint64_t>().value()[0], 0_u64);
+}
+
+TEST(CompileAndRun, stream_input_chunks) {
+  mlir::concretelang::CompilationOptions options;
+  options.compressInputCiphertexts = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<5x!FHE.eint<5>>, %arg1: !FHE.eint<5>) -> tensor<5x!FHE.eint<5>> {
+  %0 = "FHELinalg.add_eint"(%arg0, %arg1) : (tensor<5x!FHE.eint<5>>, !FHE.eint<5>) -> tensor<5x!FHE.eint<5>>
+  return %0: tensor<5x!FHE.eint<5>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+
+  // The tensor is sent in chunks of 2 elements, the last one holding 1
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      stream, clientCircuit.prepareInputStream(
+                  Tensor<uint64_t>({1, 2, 3, 4, 5}, {5}), 0, 2));
+  ASSERT_EQ(stream.chunkCount, (size_t)3);
+  ASSERT_ASSIGN_OUTCOME_VALUE(argStream,
+                              serverCircuit.prepareArgStream(0, stream.header));
+  for (size_t i = 0; i < stream.chunkCount; i++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(chunk, stream.getChunk(i));
+    ASSERT_OUTCOME_HAS_VALUE(argStream.push(chunk));
+  }
+  ASSERT_ASSIGN_OUTCOME_VALUE(arg0, argStream.finish());
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      transportArg1, clientCircuit.prepareInput(Tensor<uint64_t>(10), 1));
+  ASSERT_ASSIGN_OUTCOME_VALUE(arg1,
+                              serverCircuit.prepareArg(1, transportArg1));
+  std::vector<Value> args{arg0, arg1};
+  ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                              serverCircuit.callWithArgs(keyset.server, args));
+  ASSERT_ASSIGN_OUTCOME_VALUE(output,
+                              clientCircuit.processOutput(result[0], 0));
+  Tensor<uint64_t> tensor = output.getTensor<uint64_t>().value();
+  ASSERT_EQ(tensor.values.size(), (size_t)5);
+  for (size_t i = 0; i < 5; i++)
+    ASSERT_EQ(tensor.values[i], 11 + i);
+
+  // A missing chunk is reported when finishing the stream
+  ASSERT_ASSIGN_OUTCOME_VALUE(partial,
+                              serverCircuit.prepareArgStream(0, stream.header));
+  ASSERT_ASSIGN_OUTCOME_VALUE(first, stream.getChunk(0));
+  ASSERT_OUTCOME_HAS_VALUE(partial.push(first));
+  ASSERT_FALSE(partial.finish().has_value());
+}
+
+TEST(CompileAndRun, batched_bootstrap_on_worker_pool) {
+  // Without parallel loops, the rows of the batched bootstraps are spread
+  // over the OpenMP workers by the wrappers themselves
+  mlir::concretelang::CompilationOptions options;
+  options.batchTFHEOps = true;
+  options.loopParallelize = false;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<16x!FHE.eint<3>>, %arg1: tensor<2x8x!FHE.eint<3>>) -> (tensor<16x!FHE.eint<3>>, tensor<2x8x!FHE.eint<3>>) {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<16x!FHE.eint<3>>, tensor<8xi64>) -> tensor<16x!FHE.eint<3>>
+  %luts = arith.constant dense<[[1, 2, 3, 4, 5, 6, 7, 0], [7, 6, 5, 4, 3, 2, 1, 0]]> : tensor<2x8xi64>
+  %map = arith.constant dense<[[0, 0, 0, 0, 0, 0, 0, 0], [1, 1, 1, 1, 1, 1, 1, 1]]> : tensor<2x8xindex>
+  %2 = "FHELinalg.apply_mapped_lookup_table"(%arg1, %luts, %map) : (tensor<2x8x!FHE.eint<3>>, tensor<2x8xi64>, tensor<2x8xindex>) -> tensor<2x8x!FHE.eint<3>>
+  return %0, %2: tensor<16x!FHE.eint<3>>, tensor<2x8x!FHE.eint<3>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  std::vector<uint64_t> input;
+  for (size_t i = 0; i < 16; i++)
+    input.push_back(i % 8);
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      result, circuit.call({Tensor<uint64_t>(input, {16}),
+                            Tensor<uint64_t>(input, {2, 8})}));
+  Tensor<uint64_t> lookup = result[0].getTensor<uint64_t>().value();
+  Tensor<uint64_t> mapped = result[1].getTensor<uint64_t>().value();
+  for (size_t i = 0; i < 16; i++) {
+    ASSERT_EQ(lookup.values[i], (input[i] + 1) % 8);
+    uint64_t expected = i < 8 ? (input[i] + 1) % 8 : 7 - input[i];
+    ASSERT_EQ(mapped.values[i], expected);
+  }
+}
+
+TEST(CompileAndRun, many_lut_bootstrap) {
+  // The two lookup tables of the same input are evaluated by one bootstrap
+  mlir::concretelang::CompilationOptions options;
+  options.optimizerConfig.strategy = mlir::concretelang::optimizer::DAG_MULTI;
+  options.optimizerConfig.many_lut_max_count = 2;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> (!FHE.eint<3>, !FHE.eint<3>) {
+  %tlu0 = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %tlu1 = arith.constant dense<[7, 6, 5, 4, 3, 2, 1, 0]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %tlu0): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %tlu1): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %0, %1: !FHE.eint<3>, !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  for (uint64_t a = 0; a < 8; a++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.call({Tensor<uint64_t>(a)}));
+    ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], (a + 1) % 8);
+    ASSERT_EQ(result[1].getTensor<uint64_t>().value()[0], 7 - a);
+  }
+}
+
+TEST(CompileAndRun, bootstrap_then_keyswitch) {
+  // The dot product is cheaper on the small key, the lookup tables then
+  // bootstrap first and keyswitch back to it
+  mlir::concretelang::CompilationOptions options;
+  options.optimizerConfig.strategy = mlir::concretelang::optimizer::DAG_MULTI;
+  options.optimizerConfig.allow_pbs_ks_order = true;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<4x!FHE.eint<3>>) -> !FHE.eint<3> {
+  %tlu = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %weights = arith.constant dense<[1, 0, 0, 0]> : tensor<4xi4>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %tlu) : (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x!FHE.eint<3>>
+  %1 = "FHELinalg.dot_eint_int"(%0, %weights) : (tensor<4x!FHE.eint<3>>, tensor<4xi4>) -> !FHE.eint<3>
+  %2 = "FHE.apply_lookup_table"(%1, %tlu) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %2 : !FHE.eint<3>
+}
+)XXX"));
+
+  // The inputs are encrypted under the small key, which the bootstrap key
+  // takes as input, and the keyswitch key goes from its big key
+  ASSERT_ASSIGN_OUTCOME_VALUE(programInfo, circuit.getProgramInfo());
+  auto keyset = programInfo.asReader().getKeyset();
+  ASSERT_EQ(keyset.getLweBootstrapKeys().size(), 1u);
+  ASSERT_EQ(keyset.getLweKeyswitchKeys().size(), 1u);
+  auto bsk = keyset.getLweBootstrapKeys()[0];
+  auto ksk = keyset.getLweKeyswitchKeys()[0];
+  auto input = programInfo.asReader().getCircuits()[0].getInputs()[0];
+  ASSERT_EQ(
+      input.getTypeInfo().getLweCiphertext().getEncryption().getKeyId(),
+      bsk.getInputId());
+  ASSERT_EQ(ksk.getInputId(), bsk.getOutputId());
+  ASSERT_EQ(ksk.getOutputId(), bsk.getInputId());
+
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  for (uint64_t a = 0; a < 8; a++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        result, circuit.call({Tensor<uint64_t>({a, 0, 0, 0}, {4})}));
+    ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], (a + 2) % 8);
+  }
+}
+
+TEST(CompileAndRun, batched_wop_pbs) {
+  // The lookup tables of the CRT encoded tensor are batched into one WoP-PBS
+  mlir::concretelang::CompilationOptions options;
+  options.batchTFHEOps = true;
+  options.optimizerConfig.encoding = concrete_optimizer::Encoding::Crt;
+  TestProgram circuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: tensor<4x!FHE.eint<9>>) -> tensor<4x!FHE.eint<9>> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 269, 270, 271, 272, 273, 274, 275, 276, 277, 278, 279, 280, 281, 282, 283, 284, 285, 286, 287, 288, 289, 290, 291, 292, 293, 294, 295, 296, 297, 298, 299, 300, 301, 302, 303, 304, 305, 306, 307, 308, 309, 310, 311, 312, 313, 314, 315, 316, 317, 318, 319, 320, 321, 322, 323, 324, 325, 326, 327, 328, 329, 330, 331, 332, 333, 334, 335, 336, 337, 338, 339, 340, 341, 342, 343, 344, 345, 346, 347, 348, 349, 350, 351, 352, 353, 354, 355, 356, 357, 358, 359, 360, 361, 362, 363, 364, 365, 366, 367, 368, 369, 370, 371, 372, 373, 374, 375, 376, 377, 378, 379, 380, 381, 382, 383, 384, 385, 386, 387, 388, 389, 390, 391, 392, 393, 394, 395, 396, 397, 398, 399, 400, 401, 402, 403, 404, 405, 406, 407, 408, 409, 410, 411, 412, 413, 414, 415, 416, 417, 418, 419, 420, 421, 422, 423, 424, 425, 426, 427, 428, 429, 430, 431, 432, 433, 434, 435, 436, 437, 438, 439, 440, 441, 442, 443, 444, 445, 446, 447, 448, 449, 450, 451, 452, 453, 454, 455, 456, 457, 458, 459, 460, 461, 462, 463, 464, 465, 466, 467, 468, 469, 470, 471, 472, 473, 474, 475, 476, 477, 478, 479, 480, 481, 482, 483, 484, 485, 486, 487, 488, 489, 490, 491, 492, 493, 494, 495, 496, 497, 498, 499, 500, 501, 502, 503, 504, 505, 506, 507, 508, 509, 510, 511, 0]> : tensor<512xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %cst) : (tensor<4x!FHE.eint<9>>, tensor<512xi64>) -> tensor<4x!FHE.eint<9>>
+  return %0: tensor<4x!FHE.eint<9>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  std::vector<uint64_t> input{0, 1, 255, 511};
+  ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                              circuit.call({Tensor<uint64_t>(input, {4})}));
+  Tensor<uint64_t> output = result[0].getTensor<uint64_t>().value();
+  for (size_t i = 0; i < 4; i++)
+    ASSERT_EQ(output.values[i], (input[i] + 1) % 512);
+}
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+TEST(CompileAndRun, wop_pbs_crt_gpu) {
+  // The CRT WoP-PBS run on GPU by memref_wop_pbs_crt_buffer_cuda gives the
+  // same results as the one run on CPU
+  std::string table;
+  for (uint64_t i = 0; i < 512; i++)
+    table += (i == 0 ? "" : ", ") + std::to_string((3 * i + 1) % 512);
+  std::string source = R"XXX(
+func.func @main(%arg0: !FHE.eint<9>) -> !FHE.eint<9> {
+  %cst = arith.constant dense<[)XXX" + table +
+                       R"XXX(]> : tensor<512xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<9>, tensor<512xi64>) -> (!FHE.eint<9>)
+  return %0: !FHE.eint<9>
+}
+)XXX";
+  std::vector<uint64_t> inputs{0, 1, 170, 255, 256, 511};
+  std::vector<uint64_t> outputs[2];
+  for (bool gpu : {false, true}) {
+    mlir::concretelang::CompilationOptions options;
+    options.emitGPUOps = gpu;
+    options.optimizerConfig.encoding = concrete_optimizer::Encoding::Crt;
+    TestProgram circuit(options);
+    ASSERT_OUTCOME_HAS_VALUE(circuit.compile(source));
+    ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+    for (auto a : inputs) {
+      ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.call({Tensor<uint64_t>(a)}));
+      outputs[gpu].push_back(result[0].getTensor<uint64_t>().value()[0]);
+    }
+  }
+  ASSERT_EQ(outputs[true], outputs[false]);
+  for (size_t i = 0; i < inputs.size(); i++)
+    ASSERT_EQ(outputs[false][i], (3 * inputs[i] + 1) % 512);
+}
+#endif
+
+TEST(CompileAndRun, fourier_bsk_cache) {
+  using mlir::concretelang::FourierBootstrapKey;
+  using mlir::concretelang::RuntimeContext;
+  TestProgram circuit;
+  ASSERT_OUTCOME_HAS_VALUE(circuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %cst = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+  return %0: !FHE.eint<3>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+
+  llvm::SmallString<0> cachePath;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("fourier_bsk_cache", cachePath));
+  setenv("CONCRETE_FOURIER_BSK_CACHE_DIR", cachePath.c_str(), 1);
+  auto removeCache = llvm::make_scope_exit([&]() {
+    unsetenv("CONCRETE_FOURIER_BSK_CACHE_DIR");
+    unsetenv("CONCRETE_LAZY_BSK_CONVERSION");
+    llvm::sys::fs::remove_directories(cachePath);
+  });
+
+  // Each context is destroyed before the next one is created, so that it
+  // does not share its fourier key with it
+  auto fourierKey = [&]() {
+    RuntimeContext context(keyset.server);
+    return FourierBootstrapKey(*context.get_fourier_bootstrap_key(0));
+  };
+  auto cacheFiles = [&]() {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator it(cachePath, ec), end;
+         it != end && !ec; it.increment(ec))
+      if (llvm::sys::path::extension(it->path()) == ".fbsk")
+        files.push_back(it->path());
+    return files;
+  };
+
+  // The converted key is stored, then loaded back as is
+  auto converted = fourierKey();
+  auto files = cacheFiles();
+  ASSERT_EQ(files.size(), (size_t)1);
+  ASSERT_TRUE(fourierKey() == converted);
+
+  // A file holding another key under the same name is converted again, as
+  // its digest does not match, and replaced. The digest is the last field
+  // of the header, which comes first in the file.
+  {
+    std::fstream file(files[0],
+                      std::ios::binary | std::ios::in | std::ios::out);
+    char byte;
+    file.seekg(64);
+    file.read(&byte, 1);
+    byte ^= 1;
+    file.seekp(64);
+    file.write(&byte, 1);
+  }
+  ASSERT_TRUE(fourierKey() == converted);
+  ASSERT_EQ(cacheFiles(), files);
+  ASSERT_TRUE(fourierKey() == converted);
+
+  // Keys converted on their first use are loaded as well
+  setenv("CONCRETE_LAZY_BSK_CONVERSION", "1", 1);
+  ASSERT_TRUE(fourierKey() == converted);
+  ASSERT_ASSIGN_OUTCOME_VALUE(result, circuit.call({Tensor<uint64_t>(3)}));
+  ASSERT_EQ(result[0].getTensor<uint64_t>().value()[0], 4_u64);
+}
@@ -81,6 +81,10 @@ parseEndToEndCommandLine(int argc, char **argv) {
       "compress-input-ciphertexts",
       llvm::cl::desc("Enable the compression of input ciphertexts"),
       llvm::cl::init(false));
+  llvm::cl::opt<bool> compactFourierBootstrapKeys(
+      "compact-fourier-keys",
+      llvm::cl::desc("Store the fourier bootstrap keys in single precision"),
+      llvm::cl::init(false));
 
   llvm::cl::opt<bool> distBenchmark(
       "distributed",
@@ -160,6 +164,8 @@ parseEndToEndCommandLine(int argc, char **argv) {
   compilationOptions.compressEvaluationKeys = compressEvaluationKeys.getValue();
   compilationOptions.compressInputCiphertexts =
       compressInputCiphertexts.getValue();
+  compilationOptions.compactFourierBootstrapKeys =
+      compactFourierBootstrapKeys.getValue();
   compilationOptions.optimizerConfig.display = optimizerDisplay.getValue();
   compilationOptions.optimizerConfig.security = securityLevel.getValue();
   compilationOptions.optimizerConfig.strategy = optimizerStrategy.getValue();
@@ -226,6 +232,10 @@ std::string getOptionsName(mlir::concretelang::CompilationOptions compilation) {
   if (compilation.compressInputCiphertexts !=
       defaultOptions.compressInputCiphertexts)
     os << "_compressInputCiphertexts" << compilation.compressInputCiphertexts;
+  if (compilation.compactFourierBootstrapKeys !=
+      defaultOptions.compactFourierBootstrapKeys)
+    os << "_compactFourierBootstrapKeys"
+       << compilation.compactFourierBootstrapKeys;
 
   /// Optimizer options
   if (compilation.optimizerConfig.strategy !=
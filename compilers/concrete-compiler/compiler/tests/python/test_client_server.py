@@ -104,7 +104,10 @@ func.func @main(%a0: tensor<4x!FHE.eint<5>>, %a1: tensor<4x!FHE.eint<5>>) -> ten
         ),
     ],
 )
-def test_client_server_end_to_end(mlir, args, expected_results, keyset_cache):
+@pytest.mark.parametrize("lazy_circuits", [False, True])
+def test_client_server_end_to_end(
+    mlir, args, expected_results, lazy_circuits, keyset_cache
+):
     with tempfile.TemporaryDirectory() as tmpdirname:
         support = Compiler(
             str(tmpdirname), lookup_runtime_lib(), generate_shared_lib=True
@@ -128,7 +131,7 @@ def test_client_server_end_to_end(mlir, args, expected_results, keyset_cache):
         ]
         args_deserialized = [TransportValue.deserialize(arg) for arg in args_serialized]
 
-        server_program = ServerProgram(library, False)
+        server_program = ServerProgram(library, False, lazy_circuits)
         server_circuit = server_program.get_server_circuit("main")
 
         results = server_circuit.call(
@@ -149,3 +152,52 @@ def test_client_server_end_to_end(mlir, args, expected_results, keyset_cache):
                 for (result, expected) in zip(results_deserialized, expected_results)
             ]
         )
+
+
+def test_client_server_zero_copy_buffers(keyset_cache):
+    mlir = """
+func.func @main(%arg0: tensor<2x!FHE.eint<5>>) -> tensor<2x!FHE.eint<5>> {
+    %res = "FHELinalg.add_eint"(%arg0, %arg0) : (tensor<2x!FHE.eint<5>>, tensor<2x!FHE.eint<5>>) -> tensor<2x!FHE.eint<5>>
+    return %res: tensor<2x!FHE.eint<5>>
+}
+"""
+    with tempfile.TemporaryDirectory() as tmpdirname:
+        support = Compiler(
+            str(tmpdirname), lookup_runtime_lib(), generate_shared_lib=True
+        )
+        library = support.compile(mlir, CompilationOptions(Backend.CPU))
+        program_info = library.get_program_info()
+        keyset = Keyset(program_info, keyset_cache)
+
+        client_program = ClientProgram.create_encrypted(program_info, keyset)
+        client_circuit = client_program.get_client_circuit("main")
+        # A strided view of an array
+        arg = np.array([[1, 2], [3, 4]], dtype=np.int64).T[0]
+        serialized = client_circuit.prepare_input(Value(arg), 0).serialize()
+
+        server_program = ServerProgram(library, False)
+        server_circuit = server_program.get_server_circuit("main")
+        (result,) = server_circuit.call(
+            [TransportValue.deserialize(memoryview(serialized))],
+            keyset.get_server_keys(),
+        )
+
+        view = result.serialize_to_memoryview()
+        assert bytes(view) == result.serialize()
+        # Not aligned on words
+        unaligned = memoryview(bytearray(b"\0") + result.serialize())[1:]
+        for buffer in (view, unaligned):
+            output = client_circuit.process_output(
+                TransportValue.deserialize(buffer), 0
+            )
+            assert np.all(np.asarray(output) == 2 * arg)
+            # The storage may be shared with the copies of the value
+            assert not np.asarray(output).flags.writeable
+            assert np.all(output.to_py_val() == 2 * arg)
+
+        # Several values serialized in a single buffer
+        buffer = TransportValue.serialize_all([result, result])
+        assert bytes(buffer) == 2 * result.serialize()
+        for value in TransportValue.deserialize_all(buffer):
+            output = client_circuit.process_output(value, 0)
+            assert np.all(output.to_py_val() == 2 * arg)
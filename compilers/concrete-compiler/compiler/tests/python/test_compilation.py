@@ -1,3 +1,4 @@
+import json
 import platform
 import pytest
 import os.path
@@ -12,11 +13,15 @@ from concrete.compiler import (
     lookup_runtime_lib,
     Keyset,
     Library,
+    JITProgram,
     ServerKeyset,
     ServerProgram,
     ClientProgram,
     TransportValue,
     Value,
+    RuntimePrimitive,
+    bootstrap_work,
+    keyswitch_work,
 )
 
 
@@ -47,6 +52,9 @@ def run(library: Library, args, keyset_cache, circuit_name):
     assert isinstance(circuit_feedback, CircuitCompilationFeedback)
     assert isinstance(circuit_feedback.total_inputs_size, int)
     assert isinstance(circuit_feedback.total_output_size, int)
+    assert isinstance(circuit_feedback.removed_pbs_count, int)
+    assert isinstance(circuit_feedback.removed_key_switch_count, int)
+    assert isinstance(circuit_feedback.fused_pbs_count, int)
 
     program_info = library.get_program_info()
     keyset = Keyset(program_info, keyset_cache)
@@ -267,6 +275,344 @@ def test_lib_compilation_artifacts():
     assert not os.path.exists(library.get_shared_lib_path())
 
 
+def test_lib_compilation_cache(keyset_cache):
+    mlir_str = """
+    func.func @main(%arg0: !FHE.eint<7>, %arg1: i8) -> !FHE.eint<7> {
+        %1 = "FHE.add_eint_int"(%arg0, %arg1): (!FHE.eint<7>, i8) -> (!FHE.eint<7>)
+        return %1: !FHE.eint<7>
+    }
+    """
+    cache_dir = "./test_compilation_cache"
+    options = CompilationOptions(Backend.CPU)
+    options.set_compilation_cache_dir(cache_dir)
+    first = Compiler("./test_compilation_cache_first", lookup_runtime_lib()).compile(
+        mlir_str, options
+    )
+    assert len(os.listdir(cache_dir)) == 1
+    # The second compilation is a hit, copying the cached artifacts
+    second = Compiler(
+        "./test_compilation_cache_second", lookup_runtime_lib()
+    ).compile(mlir_str, options)
+    assert len(os.listdir(cache_dir)) == 1
+    assert os.path.exists(second.get_program_info_path())
+    assert os.path.exists(second.get_shared_lib_path())
+    assert_result(run(second, (5, 7), keyset_cache, "main"), (12,))
+    # Other options make another entry
+    options.set_p_error(0.00001)
+    Compiler("./test_compilation_cache_third", lookup_runtime_lib()).compile(
+        mlir_str, options
+    )
+    assert len(os.listdir(cache_dir)) == 2
+    for artifact_dir in [
+        cache_dir,
+        first.get_output_dir_path(),
+        second.get_output_dir_path(),
+        "./test_compilation_cache_third",
+    ]:
+        shutil.rmtree(artifact_dir)
+
+
+def test_lib_optimizer_solution_cache(keyset_cache):
+    mlir_str = """
+    func.func @main(%arg0: !FHE.eint<5>) -> !FHE.eint<5> {
+        %tlu = arith.constant dense<[0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30]> : tensor<32xi64>
+        %1 = "FHE.apply_lookup_table"(%arg0, %tlu): (!FHE.eint<5>, tensor<32xi64>) -> (!FHE.eint<5>)
+        return %1: !FHE.eint<5>
+    }
+    """
+    cache_dir = "./test_optimizer_solution_cache"
+    options = CompilationOptions(Backend.CPU)
+    options.set_optimizer_solution_cache_dir(cache_dir)
+    first = Compiler(
+        "./test_optimizer_solution_cache_first", lookup_runtime_lib()
+    ).compile(mlir_str, options)
+    assert len(os.listdir(cache_dir)) == 1
+    # The shared caches are only read
+    options.set_optimizer_solution_cache_dir("")
+    options.set_optimizer_shared_solution_cache_dirs([cache_dir])
+    second = Compiler(
+        "./test_optimizer_solution_cache_second", lookup_runtime_lib()
+    ).compile(mlir_str, options)
+    assert len(os.listdir(cache_dir)) == 1
+    with open(first.get_program_info_path()) as f, open(
+        second.get_program_info_path()
+    ) as s:
+        assert f.read() == s.read()
+    assert_result(run(second, (5,), keyset_cache, "main"), (10,))
+    for artifact_dir in [
+        cache_dir,
+        first.get_output_dir_path(),
+        second.get_output_dir_path(),
+    ]:
+        shutil.rmtree(artifact_dir)
+
+
+def test_lib_object_cache(keyset_cache):
+    mlir_template = """
+    func.func @inc(%arg0: !FHE.eint<7>) -> !FHE.eint<7> {{
+        %c = arith.constant {} : i8
+        %1 = "FHE.add_eint_int"(%arg0, %c): (!FHE.eint<7>, i8) -> (!FHE.eint<7>)
+        return %1: !FHE.eint<7>
+    }}
+    func.func @dec(%arg0: !FHE.eint<7>) -> !FHE.eint<7> {{
+        %c = arith.constant 1 : i8
+        %1 = "FHE.sub_eint_int"(%arg0, %c): (!FHE.eint<7>, i8) -> (!FHE.eint<7>)
+        return %1: !FHE.eint<7>
+    }}
+    """
+    cache_dir = "./test_object_cache"
+    options = CompilationOptions(Backend.CPU)
+    options.set_object_cache_dir(cache_dir)
+    first = Compiler("./test_object_cache_first", lookup_runtime_lib()).compile(
+        mlir_template.format(1), options
+    )
+    assert len(os.listdir(cache_dir)) == 2
+    # Only the object of the modified circuit is generated again
+    second = Compiler("./test_object_cache_second", lookup_runtime_lib()).compile(
+        mlir_template.format(2), options
+    )
+    assert len(os.listdir(cache_dir)) == 3
+    assert_result(run(second, (5,), keyset_cache, "inc"), (7,))
+    assert_result(run(second, (5,), keyset_cache, "dec"), (4,))
+    for artifact_dir in [
+        cache_dir,
+        first.get_output_dir_path(),
+        second.get_output_dir_path(),
+    ]:
+        shutil.rmtree(artifact_dir)
+
+
+@pytest.mark.parametrize("lazy_circuits", [False, True])
+def test_jit_compile_and_run(lazy_circuits, keyset_cache):
+    mlir_input, args, expected_result = end_to_end_fixture[0].values
+    artifact_dir = "./py_test_jit_compile_and_run"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    program = compiler.compile_jit(mlir_input, CompilationOptions(Backend.CPU))
+    assert isinstance(program, JITProgram)
+    # Nothing is written to the output directory
+    assert os.listdir(artifact_dir) == []
+    program_info = program.get_program_info()
+    keyset = Keyset(program_info, keyset_cache)
+    client_circuit = ClientProgram.create_encrypted(
+        program_info, keyset
+    ).get_client_circuit("main")
+    server_circuit = ServerProgram(
+        program, False, lazy_circuits
+    ).get_server_circuit("main")
+    results = server_circuit.call(
+        [client_circuit.prepare_input(Value(arg), i) for (i, arg) in enumerate(args)],
+        keyset.get_server_keys(),
+    )
+    result = [
+        client_circuit.process_output(result, i).to_py_val()
+        for (i, result) in enumerate(results)
+    ]
+    assert_result(result, expected_result)
+    shutil.rmtree(artifact_dir)
+
+
+def test_lib_compilation_profile():
+    mlir_input, _, _ = end_to_end_fixture[0].values
+    artifact_dir = "./py_test_lib_compilation_profile"
+    options = CompilationOptions(Backend.CPU)
+    options.set_compilation_profile(True)
+    library = Compiler(artifact_dir, lookup_runtime_lib()).compile(
+        mlir_input, options
+    )
+    with open(library.get_compilation_profile_path()) as f:
+        profile = json.load(f)
+    stages = {stage["name"]: stage for stage in profile["stages"]}
+    for name in ["Parsing", "Lowering to Std", "Codegen", "LinkShared"]:
+        assert name in stages
+        assert stages[name]["seconds"] >= 0
+        assert stages[name]["peakResidentMemory"] > 0
+    assert len(stages["Lowering to Std"]["passes"]) > 0
+    shutil.rmtree(artifact_dir)
+
+
+def test_lib_primitive_statistics(keyset_cache):
+    (mlir_input, args, expected_result) = next(
+        param for param in end_to_end_fixture if param.id == "apply_lookup_table"
+    ).values
+    artifact_dir = "./py_test_lib_primitive_statistics"
+    library = Compiler(artifact_dir, lookup_runtime_lib()).compile(
+        mlir_input, CompilationOptions(Backend.CPU)
+    )
+    program_info = library.get_program_info()
+    keyset = Keyset(program_info, keyset_cache)
+    client_circuit = ClientProgram.create_encrypted(
+        program_info, keyset
+    ).get_client_circuit("main")
+    server_circuit = ServerProgram(library, False).get_server_circuit("main")
+    assert server_circuit.get_primitive_statistics() == []
+    server_circuit.enable_primitive_statistics()
+    for _ in range(2):
+        results = server_circuit.call(
+            [
+                client_circuit.prepare_input(Value(arg), i)
+                for (i, arg) in enumerate(args)
+            ],
+            keyset.get_server_keys(),
+        )
+    result = [
+        client_circuit.process_output(result, i).to_py_val()
+        for (i, result) in enumerate(results)
+    ]
+    assert_result(result, expected_result)
+    statistics = server_circuit.get_primitive_statistics()
+    bootstraps = [
+        statistic
+        for statistic in statistics
+        if statistic.primitive
+        in (RuntimePrimitive.BOOTSTRAP, RuntimePrimitive.KEYSWITCH_BOOTSTRAP)
+    ]
+    assert len(bootstraps) == 1
+    assert bootstraps[0].calls == 2
+    assert bootstraps[0].ciphertexts == 2
+    assert not bootstraps[0].gpu
+    assert sum(bootstraps[0].latency_histogram) == 2
+    assert bootstraps[0].counted_calls == 0
+    server_circuit.reset_primitive_statistics()
+    assert server_circuit.get_primitive_statistics() == []
+
+    # the performance counters may not be available on the host
+    server_circuit.enable_primitive_statistics(hardware_counters=True)
+    server_circuit.call(
+        [
+            client_circuit.prepare_input(Value(arg), i)
+            for (i, arg) in enumerate(args)
+        ],
+        keyset.get_server_keys(),
+    )
+    for statistic in server_circuit.get_primitive_statistics():
+        assert statistic.counted_calls in (0, statistic.calls)
+        if statistic.counted_calls:
+            assert statistic.cycles > 0
+            assert statistic.instructions > 0
+    shutil.rmtree(artifact_dir)
+
+
+def test_pbs_dependency_feedback():
+    mlir_input = """
+    func.func @main(%arg0: tensor<4x!FHE.eint<3>>, %arg1: !FHE.eint<3>) -> (tensor<4x!FHE.eint<3>>, !FHE.eint<3>) {
+        %tlu = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+        %0 = "FHELinalg.apply_lookup_table"(%arg0, %tlu): (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<4x!FHE.eint<3>>)
+        %1 = "FHELinalg.apply_lookup_table"(%0, %tlu): (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<4x!FHE.eint<3>>)
+        %2 = "FHE.apply_lookup_table"(%arg1, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+        return %1, %2: tensor<4x!FHE.eint<3>>, !FHE.eint<3>
+    }
+    """
+    artifact_dir = "./py_test_pbs_dependency_feedback"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    library = compiler.compile(mlir_input, CompilationOptions(Backend.CPU))
+    circuit_feedback = library.get_program_compilation_feedback().get_circuit_feedback(
+        "main"
+    )
+    # the elements of the tensor are bootstrapped twice in sequence, the
+    # scalar once beside them
+    assert circuit_feedback.pbs_depth == 2
+    assert circuit_feedback.average_pbs_parallelism == pytest.approx(9 / 2)
+    assert circuit_feedback.batchable_pbs_count == 8
+    shutil.rmtree(artifact_dir)
+
+
+def test_buffer_reuse_feedback():
+    mlir_input = """
+    func.func @main(%arg0: tensor<4x!FHE.eint<3>>) -> tensor<4x!FHE.eint<3>> {
+        %tlu = arith.constant dense<[1, 2, 3, 4, 5, 6, 7, 0]> : tensor<8xi64>
+        %0 = "FHELinalg.apply_lookup_table"(%arg0, %tlu): (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<4x!FHE.eint<3>>)
+        %1 = "FHELinalg.apply_lookup_table"(%0, %tlu): (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<4x!FHE.eint<3>>)
+        %2 = "FHELinalg.apply_lookup_table"(%1, %tlu): (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> (tensor<4x!FHE.eint<3>>)
+        return %2: tensor<4x!FHE.eint<3>>
+    }
+    """
+    artifact_dir = "./py_test_buffer_reuse_feedback"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    options = CompilationOptions(Backend.CPU)
+    options.set_loop_parallelize(False)
+    options.set_reuse_buffers(True)
+    library = compiler.compile(mlir_input, options)
+    program_feedback = library.get_program_compilation_feedback()
+    circuit_feedback = program_feedback.get_circuit_feedback("main")
+    assert program_feedback.runtime_scratch_size > 0
+    assert isinstance(circuit_feedback.peak_memory_usage, int)
+    assert circuit_feedback.peak_memory_usage > (
+        program_feedback.total_bootstrap_keys_size
+        + program_feedback.runtime_scratch_size
+    )
+    assert (
+        circuit_feedback.allocated_memory
+        <= circuit_feedback.allocated_memory_without_buffer_reuse
+    )
+    shutil.rmtree(artifact_dir)
+
+
+def test_lib_predicted_latency(tmp_path):
+    (mlir_input, _, _) = next(
+        param for param in end_to_end_fixture if param.id == "apply_lookup_table"
+    ).values
+    cost_table = tmp_path / "costs.json"
+    cost_table.write_text(
+        json.dumps(
+            {
+                "cpu": {"parallelism": 4, "bootstrap": 2.0, "leveled": 1.0},
+                "gpu": {"bootstrap": 1.0, "keyswitch": 1.0, "leveled": 0.0},
+            }
+        )
+    )
+    artifact_dir = "./py_test_lib_predicted_latency"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+
+    # the keyswitches have no cost on the cpu, the circuit is not predicted
+    options = CompilationOptions(Backend.CPU)
+    options.set_latency_cost_table(str(cost_table))
+    library = compiler.compile(mlir_input, options)
+    circuit_feedback = library.get_program_compilation_feedback().get_circuit_feedback(
+        "main"
+    )
+    assert circuit_feedback.predicted_latency is None
+    assert circuit_feedback.predicted_throughput is None
+
+    options.set_latency_cost_table(str(cost_table), "gpu", 2)
+    library = compiler.compile(mlir_input, options)
+    keyset_info = library.get_program_info().get_keyset_info()
+    secret_keys = keyset_info.secret_keys()
+    (bsk,) = keyset_info.bootstrap_keys()
+    (ksk,) = keyset_info.keyswitch_keys()
+    nanoseconds = bootstrap_work(
+        bsk.input_lwe_dimension(),
+        bsk.level(),
+        bsk.glwe_dimension(),
+        bsk.polynomial_size(),
+    ) + keyswitch_work(
+        secret_keys[ksk.input_secret_key_id()].dimension(),
+        ksk.level(),
+        secret_keys[ksk.output_secret_key_id()].dimension(),
+    )
+    circuit_feedback = library.get_program_compilation_feedback().get_circuit_feedback(
+        "main"
+    )
+    assert circuit_feedback.predicted_latency == pytest.approx(nanoseconds * 1e-9)
+    assert circuit_feedback.predicted_throughput == pytest.approx(2e9 / nanoseconds)
+    shutil.rmtree(artifact_dir)
+
+
+@pytest.mark.skipif(
+    platform.machine() != "x86_64", reason="cpu variants are x86-64 levels"
+)
+@pytest.mark.parametrize("variants", [["x86-64"], ["x86-64", "x86-64-v3"]])
+def test_lib_compile_and_run_cpu_variants(variants, keyset_cache):
+    mlir_input, args, expected_result = end_to_end_fixture[0].values
+    artifact_dir = "./py_test_lib_compile_and_run_cpu_variants"
+    options = CompilationOptions(Backend.CPU)
+    options.set_target_cpu_variants(variants)
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    compile_run_assert(
+        compiler, mlir_input, args, expected_result, keyset_cache, options
+    )
+    shutil.rmtree(artifact_dir)
+
+
 def test_multi_circuits(keyset_cache):
     from mlir._mlir_libs._concretelang._compiler import OptimizerStrategy
 
@@ -79,3 +79,45 @@ module {
                 for (result, expected) in zip(results_deserialized, expected_results)
             ]
         )
+
+
+def test_keyset_mapped_loading():
+    mlir = """
+
+module {
+  func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<6> {
+    %cst = arith.constant dense<[0, 1, 4, 9, 16, 25, 36, 49]> : tensor<8xi64>
+    %0 = "FHE.apply_lookup_table"(%arg0, %cst) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<6>
+    return %0 : !FHE.eint<6>
+  }
+}
+
+    """.strip()
+
+    with tempfile.TemporaryDirectory() as tmpdirname:
+
+        support = Compiler(
+            str(tmpdirname), lookup_runtime_lib(), generate_shared_lib=True
+        )
+        library = support.compile(mlir, CompilationOptions(Backend.CPU))
+
+        program_info = library.get_program_info()
+        keyset = Keyset(program_info, None)
+
+        serialized = keyset.get_server_keys().serialize()
+        keyset_path = f"{tmpdirname}/server_keyset"
+        with open(keyset_path, "wb") as f:
+            f.write(serialized)
+        evaluation_keys = ServerKeyset.load_mapped(keyset_path)
+
+        client_program = ClientProgram.create_encrypted(program_info, keyset)
+        client_circuit = client_program.get_client_circuit("main")
+        arg = client_circuit.prepare_input(Value(5), 0)
+
+        server_program = ServerProgram(library, False)
+        server_circuit = server_program.get_server_circuit("main")
+        results = server_circuit.call([arg], evaluation_keys)
+
+        assert client_circuit.process_output(results[0], 0).to_py_val() == 25
+        # The keys used in place serialize back to the same keyset
+        assert evaluation_keys.serialize() == serialized
@@ -222,6 +222,20 @@ end_to_end_fixture = [
         (96,),
         id="add_lut_crt",
     ),
+    pytest.param(
+        """
+            func.func @main(%arg0: tensor<4x!FHE.eint<14>>, %arg1: tensor<16384xi64>) -> tensor<4x!FHE.eint<14>> {
+                %1 = "FHELinalg.apply_lookup_table"(%arg0, %arg1): (tensor<4x!FHE.eint<14>>, tensor<16384xi64>) -> (tensor<4x!FHE.eint<14>>)
+                return %1: tensor<4x!FHE.eint<14>>
+            }
+        """,
+        (
+            np.array([0, 81, 1024, 16383]),
+            np.array(range(16384)),
+        ),
+        (np.array([0, 81, 1024, 16383]),),
+        id="apply_lookup_table_crt_1D",
+    ),
 ]
 
 end_to_end_parallel_fixture = [
@@ -271,6 +285,28 @@ def test_lib_compile_and_run_simulation(mlir_input, args, expected_result):
     shutil.rmtree(artifact_dir)
 
 
+@pytest.mark.parametrize("mlir_input, args, expected_result", end_to_end_fixture)
+def test_lib_compile_and_run_simulation_batched(mlir_input, args, expected_result):
+    artifact_dir = "./py_test_lib_compile_and_run_batched"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    options = CompilationOptions(Backend.CPU)
+    options.set_batch_tfhe_ops(True)
+    compile_run_assert(compiler, mlir_input, args, expected_result, options)
+    shutil.rmtree(artifact_dir)
+
+
+@pytest.mark.parametrize("mlir_input, args, expected_result", end_to_end_fixture)
+def test_lib_compile_and_run_simulation_without_noise(
+    mlir_input, args, expected_result
+):
+    artifact_dir = "./py_test_lib_compile_and_run_without_noise"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    options = CompilationOptions(Backend.CPU)
+    options.set_enable_noise_in_simulation(False)
+    compile_run_assert(compiler, mlir_input, args, expected_result, options)
+    shutil.rmtree(artifact_dir)
+
+
 end_to_end_overflow_simu_fixture = [
     pytest.param(
         """
@@ -589,3 +625,105 @@ def test_lib_compile_and_run_simulation_with_overflow(
     mlir_file.close()
 
     assert overflow_message == out
+
+
+def test_simulate_dataset():
+    mlir_input = """
+        func.func @main(%arg0: !FHE.eint<3>, %arg1: i4) -> !FHE.eint<3> {
+            %tlu = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi64>
+            %0 = "FHE.add_eint_int"(%arg0, %arg1): (!FHE.eint<3>, i4) -> (!FHE.eint<3>)
+            %1 = "FHE.apply_lookup_table"(%0, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+            return %1: !FHE.eint<3>
+        }
+        """
+    artifact_dir = "./py_test_simulate_dataset"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    options = CompilationOptions(Backend.CPU)
+    options.simulation(True)
+    library = compiler.compile(mlir_input, options)
+
+    program_info = library.get_program_info()
+    client_circuit = ClientProgram.create_simulated(program_info).get_client_circuit(
+        "main"
+    )
+    server_circuit = ServerProgram(library, True).get_server_circuit("main")
+
+    inputs = [(x % 4, x % 3) for x in range(64)]
+    dataset = [
+        [
+            client_circuit.simulate_prepare_input(Value(arg), i)
+            for (i, arg) in enumerate(args)
+        ]
+        for args in inputs
+    ]
+
+    def decode(results):
+        return [
+            client_circuit.simulate_process_output(result[0], 0).to_py_val()
+            for result in results
+        ]
+
+    outputs = server_circuit.simulate_dataset(dataset, seed=42)
+    assert decode(outputs) == [x + y for (x, y) in inputs]
+    serialized = [result[0].serialize() for result in outputs]
+    reproduced = server_circuit.simulate_dataset(dataset, seed=42)
+    assert [result[0].serialize() for result in reproduced] == serialized
+    shutil.rmtree(artifact_dir)
+
+
+def test_simulation_statistics():
+    from mlir._mlir_libs._concretelang._compiler import OptimizerStrategy
+
+    mlir_input = """
+        func.func @main(%arg0: !FHE.eint<3>, %arg1: i4) -> !FHE.eint<3> {
+            %tlu = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi64>
+            %0 = "FHE.add_eint_int"(%arg0, %arg1): (!FHE.eint<3>, i4) -> (!FHE.eint<3>)
+            %1 = "FHE.apply_lookup_table"(%0, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+            return %1: !FHE.eint<3>
+        }
+        """
+    artifact_dir = "./py_test_simulation_statistics"
+    compiler = Compiler(artifact_dir, lookup_runtime_lib())
+    options = CompilationOptions(Backend.CPU)
+    options.simulation(True)
+    options.set_enable_overflow_detection_in_simulation(True)
+    options.set_optimizer_strategy(OptimizerStrategy.DAG_MONO)
+    library = compiler.compile(mlir_input, options)
+
+    program_info = library.get_program_info()
+    client_circuit = ClientProgram.create_simulated(program_info).get_client_circuit(
+        "main"
+    )
+    server_circuit = ServerProgram(library, True).get_server_circuit("main")
+    assert server_circuit.get_simulation_statistics() == []
+    server_circuit.enable_simulation_statistics()
+
+    calls = 100
+    for _ in range(calls):
+        args = [
+            client_circuit.simulate_prepare_input(Value(arg), i)
+            for (i, arg) in enumerate((2, 3))
+        ]
+        server_circuit.simulate(args)
+
+    statistics = server_circuit.get_simulation_statistics()
+    bootstraps = [s for s in statistics if s.bootstraps != 0]
+    assert len(bootstraps) == 1
+    bootstrap = bootstraps[0]
+    assert bootstrap.bootstraps == calls
+    assert bootstrap.precision == 3
+    assert 0 < bootstrap.noise_variance < bootstrap.max_variance
+    assert bootstrap.max_noise < 2 ** -(bootstrap.precision + 2)
+    assert all(s.overflows == 0 for s in statistics)
+
+    # 7 + 3 does not fit in 3 bits
+    args = [
+        client_circuit.simulate_prepare_input(Value(arg), i)
+        for (i, arg) in enumerate((7, 3))
+    ]
+    server_circuit.simulate(args)
+    assert sum(s.overflows for s in server_circuit.get_simulation_statistics()) > 0
+
+    server_circuit.reset_simulation_statistics()
+    assert server_circuit.get_simulation_statistics() == []
+    shutil.rmtree(artifact_dir)
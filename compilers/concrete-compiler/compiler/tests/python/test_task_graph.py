@@ -0,0 +1,64 @@
+import pytest
+from concrete.compiler.task_graph import analyze
+
+
+def test_task_graph_analysis():
+    graph = {
+        "localities": 2,
+        "end": 100,
+        "tasks": [
+            {
+                "id": 0,
+                "name": "_dfr_DFT_work_function__main0",
+                "locality": 0,
+                "inputs": [{"producer": -1, "bytes": 10}],
+                "outputs": [20],
+                "created": 0,
+                "start": 0,
+                "end": 40,
+            },
+            {
+                "id": 1,
+                "name": "_dfr_DFT_work_function__main1",
+                "locality": 1,
+                "inputs": [{"producer": -1, "bytes": 30}],
+                "outputs": [5],
+                "created": 0,
+                "start": 0,
+                "end": 60,
+            },
+            {
+                "id": 2,
+                "name": "_dfr_DFT_work_function__main2",
+                "locality": 0,
+                "inputs": [
+                    {"producer": 0, "bytes": 20},
+                    {"producer": 1, "bytes": 5},
+                ],
+                "outputs": [8],
+                "created": 0,
+                "start": 60,
+                "end": 100,
+            },
+            # still running when the call ended
+            {
+                "id": 3,
+                "name": "_dfr_DFT_work_function__main3",
+                "locality": 1,
+                "inputs": [{"producer": 2}],
+                "outputs": [],
+                "created": 90,
+            },
+        ],
+    }
+    analysis = analyze(graph)
+    assert analysis.tasks == 4
+    assert analysis.busy == 140
+    assert analysis.achieved_parallelism == pytest.approx(1.4)
+    # the critical path goes through the remote task
+    assert analysis.critical_path == 100
+    # only the data of the remote task crosses the network
+    assert analysis.network_bytes == 35
+    assert analysis.nodes[0].busy == 80
+    assert analysis.nodes[1].tasks == 1
+    assert analysis.load_imbalance == pytest.approx(80 / 70)
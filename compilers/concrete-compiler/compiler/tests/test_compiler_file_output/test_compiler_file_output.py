@@ -88,3 +88,53 @@ def test_compile_many_library():
     assert 0 == result.returncode
 
     remove(ALL_ARTIFACTS, EXE)
+
+
+def test_compile_many_library_codegen_threads():
+    remove(ALL_ARTIFACTS)
+
+    run(
+        CONCRETECOMPILER,
+        SOURCE_1,
+        SOURCE_2,
+        "--action=compile",
+        "--codegen-threads=4",
+        "-o",
+        ARTIFACTS_DIR,
+    )
+
+    assert_exists(LIBS)
+
+    EXE = "./main.exe"
+    for source_c, expected in ((SOURCE_C_1, 13), (SOURCE_C_2, 0)):
+        remove(EXE)
+        run(CCOMPILER, "-o", EXE, source_c, LIB_DYNAMIC)
+
+        result = subprocess.run([EXE], capture_output=True)
+        assert expected == result.returncode
+
+    remove(ALL_ARTIFACTS, EXE)
+
+
+def test_compile_library_portable_target():
+    remove(ALL_ARTIFACTS)
+
+    run(
+        CONCRETECOMPILER,
+        SOURCE_1,
+        "--action=compile",
+        "--target-cpu=generic",
+        "-o",
+        ARTIFACTS_DIR,
+    )
+
+    assert_exists(LIBS)
+
+    EXE = "./main.exe"
+    remove(EXE)
+    run(CCOMPILER, "-o", EXE, SOURCE_C_1, LIB_DYNAMIC)
+
+    result = subprocess.run([EXE], capture_output=True)
+    assert 13 == result.returncode
+
+    remove(ALL_ARTIFACTS, EXE)
@@ -31,9 +31,21 @@ std::vector<CRTModuli> generateAllParameters() {
   return {
       // This is our default moduli for the 16 bits
       {7, 8, 9, 11, 13},
+      // The quotients of the product by the moduli overflow an int
+      {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31},
   };
 }
 
+TEST_P(CRTTest, iCrtCoefficients) {
+  auto moduli = GetParam();
+  auto coefficients = crt::iCrtCoefficients(moduli);
+
+  // Each coefficient is 1 modulo its own modulus and 0 modulo the others
+  for (size_t i = 0; i < moduli.size(); i++)
+    for (size_t j = 0; j < moduli.size(); j++)
+      ASSERT_EQ(coefficients[i] % moduli[j], i == j ? 1 : 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(CRTSuite, CRTTest,
                          ::testing::ValuesIn(generateAllParameters()),
                          [](const testing::TestParamInfo<CRTModuli> info) {
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "concretelang/Common/Values.h"
+
+namespace {
+using concretelang::protocol::Message;
+using concretelang::protocol::protoPayloadToVector;
+using concretelang::values::SharedVector;
+using concretelang::values::Tensor;
+using concretelang::values::Value;
+
+TEST(SharedVector, copies_share_elements_until_written) {
+  SharedVector<uint64_t> a(std::vector<uint64_t>{1, 2, 3});
+  const SharedVector<uint64_t> b = a;
+  ASSERT_EQ(a.data(), b.data());
+
+  a[0] = 4;
+  ASSERT_NE(a.data(), b.data());
+  ASSERT_EQ(a[0], 4u);
+  ASSERT_EQ(b[0], 1u);
+}
+
+TEST(SharedVector, slices_share_elements) {
+  const SharedVector<uint64_t> a(std::vector<uint64_t>{1, 2, 3, 4});
+  SharedVector<uint64_t> slice = a.slice(1, 3);
+  ASSERT_EQ(slice.size(), 2u);
+  ASSERT_EQ(((const SharedVector<uint64_t> &)slice).data(), a.data() + 1);
+
+  slice.push_back(5);
+  ASSERT_EQ(slice, SharedVector<uint64_t>(std::vector<uint64_t>{2, 3, 5}));
+  ASSERT_EQ(a, SharedVector<uint64_t>(std::vector<uint64_t>{1, 2, 3, 4}));
+}
+
+TEST(SharedVector, to_vector_takes_exclusive_elements) {
+  SharedVector<uint64_t> a(std::vector<uint64_t>{1, 2, 3});
+  const uint64_t *data = ((const SharedVector<uint64_t> &)a).data();
+  std::vector<uint64_t> vector = std::move(a).toVector();
+  ASSERT_EQ(vector.data(), data);
+
+  SharedVector<uint64_t> b(std::vector<uint64_t>{1, 2, 3});
+  const SharedVector<uint64_t> c = b;
+  vector = std::move(b).toVector();
+  ASSERT_NE(vector.data(), c.data());
+  ASSERT_EQ(vector, std::vector<uint64_t>({1, 2, 3}));
+}
+
+TEST(Tensor, arithmetic_does_not_modify_operands) {
+  const Tensor<uint64_t> a({1, 2, 3, 4}, {2, 2});
+  Tensor<uint64_t> b = a + 1;
+  ASSERT_EQ(b, Tensor<uint64_t>({2, 3, 4, 5}, {2, 2}));
+  ASSERT_EQ(a, Tensor<uint64_t>({1, 2, 3, 4}, {2, 2}));
+}
+
+TEST(Value, raw_transport_value_round_trip) {
+  const Value unsignedValue(Tensor<uint64_t>({1, 2, 3, 4, 5, 6}, {2, 3}));
+  ASSERT_EQ(
+      Value::fromRawTransportValue(unsignedValue.intoRawTransportValue()),
+      unsignedValue);
+  const Value signedValue(Tensor<int8_t>({-1, 2, -3}, {3}));
+  ASSERT_EQ(Value::fromRawTransportValue(signedValue.intoRawTransportValue()),
+            signedValue);
+}
+
+TEST(Value, payload_written_into_builder) {
+  const Value value(Tensor<uint16_t>({1, 2, 3}, {3}));
+  Message<concreteprotocol::Value> message;
+  value.intoProtoPayload(message.asBuilder().initPayload());
+  ASSERT_EQ(protoPayloadToVector<uint16_t>(message.asReader().getPayload()),
+            std::vector<uint16_t>({1, 2, 3}));
+  ASSERT_EQ(protoPayloadToVector<uint16_t>(value.intoProtoPayload()),
+            std::vector<uint16_t>({1, 2, 3}));
+}
+} // namespace
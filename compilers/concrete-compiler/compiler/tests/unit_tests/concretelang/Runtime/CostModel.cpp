@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+
+#include "concretelang/Runtime/cost_model.h"
+
+namespace {
+
+using mlir::concretelang::gpu_dfg::KernelCost;
+using mlir::concretelang::gpu_dfg::plan_split;
+using mlir::concretelang::gpu_dfg::SplitPlan;
+
+TEST(CostModel, kernel_time) {
+  KernelCost cost{2.0, 0.5};
+  ASSERT_EQ(cost.time(0), 0);
+  ASSERT_EQ(cost.time(1), 2.5);
+  ASSERT_EQ(cost.time(4), 4.0);
+}
+
+TEST(CostModel, host_only_when_device_latency_dominates) {
+  SplitPlan plan = plan_split({0, 1}, {100, 1}, 8, 4, 1);
+  ASSERT_FALSE(plan.offload);
+  // A device chunk needs as many samples as its latency to be worth it
+  ASSERT_EQ(plan.min_gpu_chunk_samples, 100u);
+}
+
+TEST(CostModel, device_only_when_host_cannot_help) {
+  SplitPlan plan = plan_split({0, 1}, {0, 0.001}, 1000, 4, 1);
+  ASSERT_TRUE(plan.offload);
+  ASSERT_EQ(plan.cpu_chunks, 0u);
+  ASSERT_EQ(plan.gpu_chunk_factor, 1u);
+}
+
+TEST(CostModel, mixed_split_finishes_together) {
+  // The device computes a sample 4 times as fast as a core, so its chunks
+  // are 4 times as large and all resources finish in half the time either
+  // would take alone
+  SplitPlan plan = plan_split({0, 1}, {0, 0.25}, 80, 4, 1);
+  ASSERT_TRUE(plan.offload);
+  ASSERT_EQ(plan.cpu_chunks, 4u);
+  ASSERT_EQ(plan.gpu_chunk_factor, 4u);
+  ASSERT_EQ(plan.min_gpu_chunk_samples, 1u);
+}
+
+TEST(CostModel, uncalibrated_kernels_run_on_host) {
+  ASSERT_FALSE(plan_split({0, 0}, {0, 0.25}, 80, 4, 1).offload);
+  ASSERT_FALSE(plan_split({0, 1}, {0, 0}, 80, 4, 1).offload);
+}
+
+TEST(CostModel, cache_round_trip) {
+  std::string path = testing::TempDir() + "sdfg_cost_model_cache";
+  std::remove(path.c_str());
+  std::map<std::string, KernelCost> costs;
+  mlir::concretelang::gpu_dfg::load_kernel_costs(path.c_str(), costs);
+  ASSERT_TRUE(costs.empty());
+
+  ASSERT_TRUE(mlir::concretelang::gpu_dfg::save_kernel_cost(
+      path.c_str(), "pbs-1-23-600-2048-1 cpu", {0, 1.25e-3}));
+  ASSERT_TRUE(mlir::concretelang::gpu_dfg::save_kernel_cost(
+      path.c_str(), "ks-3-4-2048-600 Tesla_V100", {1e-4, 1.0 / 3}));
+  mlir::concretelang::gpu_dfg::load_kernel_costs(path.c_str(), costs);
+  ASSERT_EQ(costs.size(), 2u);
+  ASSERT_EQ(costs["pbs-1-23-600-2048-1 cpu"].per_sample, 1.25e-3);
+  ASSERT_EQ(costs["ks-3-4-2048-600 Tesla_V100"].latency, 1e-4);
+  ASSERT_EQ(costs["ks-3-4-2048-600 Tesla_V100"].per_sample, 1.0 / 3);
+  std::remove(path.c_str());
+}
+
+} // namespace
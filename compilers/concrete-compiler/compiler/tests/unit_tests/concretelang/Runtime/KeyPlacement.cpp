@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "concretelang/Runtime/key_placement.h"
+
+namespace {
+
+using mlir::concretelang::dfr::default_key_fetch_cost;
+using mlir::concretelang::dfr::key_fetch_cost;
+using mlir::concretelang::dfr::key_localities_add;
+using mlir::concretelang::dfr::key_partition_allows;
+using mlir::concretelang::dfr::KeyLocalities;
+
+TEST(KeyPlacement, default_fetch_cost) {
+  ASSERT_EQ(default_key_fetch_cost, 4u);
+  KeyLocalities localities;
+  ASSERT_EQ(key_fetch_cost(localities, 7, 1, default_key_fetch_cost), 4u);
+}
+
+TEST(KeyPlacement, fetch_cost_of_holders) {
+  KeyLocalities localities;
+  // The root holds all the keys
+  ASSERT_EQ(key_fetch_cost(localities, 7, 0, 4), 0u);
+  ASSERT_EQ(key_fetch_cost(localities, 7, 2, 4), 4u);
+
+  key_localities_add(localities, 7, 2, 4);
+  ASSERT_EQ(key_fetch_cost(localities, 7, 2, 4), 0u);
+  ASSERT_EQ(key_fetch_cost(localities, 7, 3, 4), 4u);
+  // The keys of the other work functions are still to fetch
+  ASSERT_EQ(key_fetch_cost(localities, 8, 2, 4), 4u);
+
+  // The root is not recorded
+  key_localities_add(localities, 9, 0, 4);
+  ASSERT_EQ(localities.count(9), 0u);
+}
+
+TEST(KeyPlacement, no_fetch_cost_disables_affinity) {
+  KeyLocalities localities;
+  ASSERT_EQ(key_fetch_cost(localities, 7, 2, 0), 0u);
+}
+
+TEST(KeyPlacement, partition_of_consecutive_remote_nodes) {
+  // 5 nodes: the root and 4 remote ones, partitions of 2 nodes. The work
+  // function 5 has its home at the second remote node, locality 2.
+  std::vector<bool> allowed;
+  for (size_t loc = 0; loc < 5; loc++)
+    allowed.push_back(key_partition_allows(5, loc, 5, 2));
+  ASSERT_EQ(allowed, std::vector<bool>({true, false, true, true, false}));
+
+  // The partitions wrap around the remote nodes
+  allowed.clear();
+  for (size_t loc = 0; loc < 5; loc++)
+    allowed.push_back(key_partition_allows(3, loc, 5, 2));
+  ASSERT_EQ(allowed, std::vector<bool>({true, true, false, false, true}));
+}
+
+TEST(KeyPlacement, unpartitioned) {
+  for (size_t loc = 0; loc < 5; loc++) {
+    ASSERT_TRUE(key_partition_allows(3, loc, 5, 0));
+    // Partitions of all the remote nodes, or more
+    ASSERT_TRUE(key_partition_allows(3, loc, 5, 4));
+    ASSERT_TRUE(key_partition_allows(3, loc, 5, 8));
+  }
+}
+
+} // namespace
@@ -1,9 +1,102 @@
+#include <atomic>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
 
+#include "concretelang/Common/HugePages.h"
+#include "concretelang/Runtime/async_executor.h"
+#include "concretelang/Runtime/memory_pool.h"
+#include "concretelang/Runtime/pinned_memory.h"
+#include "concretelang/Runtime/runtime_api.h"
+#include "concretelang/Runtime/tracing.h"
 #include "concretelang/Runtime/wrappers.h"
 
 namespace {
 
+// Allocates and releases buffers through the wrappers with the pool
+// enabled, and returns whether the buffers were reused
+bool poolReusesSizeClasses() {
+  namespace memory_pool = mlir::concretelang::memory_pool;
+  setenv("CONCRETE_HOST_MEMORY_POOL", "1", 1);
+  if (!memory_pool::enabled())
+    return false;
+
+  // Small buffers are left to malloc
+  int foreign;
+  if (memory_pool::allocate(16) != nullptr || memory_pool::release(&foreign))
+    return false;
+
+  auto *first = (uint8_t *)concrete_checked_malloc(1 << 20);
+  if (first == nullptr)
+    return false;
+  memset(first, 0xff, 1 << 20);
+  concrete_checked_free(first);
+  // Released buffers are handed out again for sizes of the same class
+  auto *second = (uint8_t *)concrete_checked_malloc((1 << 20) - 100);
+  auto *third = (uint8_t *)concrete_checked_malloc(1 << 20);
+  bool reused = second == first && third != first;
+  concrete_checked_free(third);
+  concrete_checked_free(second);
+  return reused;
+}
+
+// The environment is read once, on the first use of the pool, so the test
+// runs in a process of its own and leaves the pool of the other tests
+// disabled
+TEST(MemoryPool, reuse_size_classes) {
+  testing::GTEST_FLAG(death_test_style) = "threadsafe";
+  EXPECT_EXIT(_exit(poolReusesSizeClasses() ? 0 : 1),
+              testing::ExitedWithCode(0), "");
+}
+
+#ifdef CONCRETELANG_CUDA_SUPPORT
+// Allocates and releases page-locked buffers through the wrappers with the
+// pinned host pool enabled, as do the GPU circuits and the dataflow runtime,
+// and returns whether the buffers were reused
+bool pinnedPoolReusesBuffers() {
+  namespace pinned = mlir::concretelang::pinned;
+  setenv("CONCRETE_PINNED_HOST_MEMORY", "1", 1);
+  if (!pinned::enabled())
+    return false;
+
+  // Buffers smaller than a page are left to malloc
+  int foreign;
+  if (pinned::allocate(16) != nullptr || pinned::release(&foreign))
+    return false;
+
+  auto *first = (uint8_t *)concrete_checked_malloc(1 << 20);
+  if (first == nullptr)
+    return false;
+  memset(first, 0xff, 1 << 20);
+  concrete_checked_free(first);
+  // Released buffers keep their registration and are handed out again
+  auto *second = (uint8_t *)concrete_checked_malloc(1 << 20);
+  if (second != first)
+    return false;
+#ifdef CONCRETELANG_DATAFLOW_EXECUTION_ENABLED
+  // The dataflow runtime releases the buffer of a future with its last
+  // reference
+  _dfr_deallocate_future(_dfr_make_ready_future(second, 0));
+  auto *third = (uint8_t *)concrete_checked_malloc(1 << 20);
+  bool reused = third == first;
+  concrete_checked_free(third);
+  return reused;
+#else
+  concrete_checked_free(second);
+  return true;
+#endif
+}
+
+// As for the memory pool, the test runs in a process of its own
+TEST(PinnedMemory, reuse_released_buffers) {
+  testing::GTEST_FLAG(death_test_style) = "threadsafe";
+  EXPECT_EXIT(_exit(pinnedPoolReusesBuffers() ? 0 : 1),
+              testing::ExitedWithCode(0), "");
+}
+#endif
+
 TEST(WrappersDeathTest, bad_alloc) {
   ASSERT_DEATH(
       { concrete_checked_malloc(SIZE_MAX); },
@@ -11,4 +104,247 @@ TEST(WrappersDeathTest, bad_alloc) {
       "malloc\\(17179869183 GB\\).*Backtrace:.*");
 }
 
+TEST(Wrappers, checked_malloc_free) {
+  // Both page-locked and small buffers are released by concrete_checked_free
+  for (size_t size : {16ul, 1ul << 20}) {
+    auto *ptr = (uint8_t *)concrete_checked_malloc(size);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xff, size);
+    concrete_checked_free(ptr);
+  }
+  concrete_checked_free(nullptr);
+}
+
+TEST(HugePages, transparent_buffers_are_aligned) {
+  namespace huge_pages = ::concretelang::huge_pages;
+  // As the NUMA replicas of the bootstrap keys, whatever the current policy
+  size_t size = 3 * huge_pages::HUGE_PAGE_SIZE + 100;
+  auto *ptr = (uint8_t *)huge_pages::allocate(size,
+                                              huge_pages::Policy::TRANSPARENT);
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_EQ((uintptr_t)ptr % huge_pages::HUGE_PAGE_SIZE, 0u);
+  memset(ptr, 0xff, size);
+  huge_pages::deallocate(ptr, size);
+}
+
+TEST(ScratchArena, reuse_and_grow) {
+  using mlir::concretelang::ScratchArena;
+  auto &arena = ScratchArena::local();
+
+  auto first = arena.get(ScratchArena::BOOTSTRAP, 1024, 64);
+  ASSERT_EQ((uintptr_t)first % 64, 0u);
+  // Same or smaller requests reuse the buffer
+  ASSERT_EQ(arena.get(ScratchArena::BOOTSTRAP, 512, 64), first);
+  ASSERT_EQ(arena.get(ScratchArena::BOOTSTRAP, 1024, 16), first);
+  // Bigger or more aligned requests get a suitable buffer
+  auto bigger = arena.get(ScratchArena::BOOTSTRAP, 4096, 256);
+  ASSERT_EQ((uintptr_t)bigger % 256, 0u);
+  ASSERT_EQ(arena.get(ScratchArena::BOOTSTRAP, 4096, 64), bigger);
+  // Slots are independent
+  ASSERT_NE(arena.get(ScratchArena::GLWE_ACCUMULATOR, 64, 64), bigger);
+}
+
+TEST(Wrappers, batched_leveled_ops) {
+  // 3 ciphertexts of size 5, the output rows being padded to a stride of 7 so
+  // that both the contiguous and the row by row paths are exercised
+  const uint64_t rows = 3, size = 5, stride = 7;
+  std::vector<uint64_t> ct0(rows * size), ct1(rows * size);
+  for (uint64_t i = 0; i < rows * size; i++) {
+    ct0[i] = UINT64_MAX - i;
+    ct1[i] = i * 0x9e3779b97f4a7c15ULL;
+  }
+  std::vector<uint64_t> cleartexts = {3, UINT64_MAX, 1ULL << 40};
+
+  std::vector<uint64_t> dense(rows * size), padded(rows * stride);
+  auto check = [&](auto expected) {
+    for (uint64_t r = 0; r < rows; r++) {
+      for (uint64_t c = 0; c < size; c++) {
+        ASSERT_EQ(dense[r * size + c], expected(r, r * size + c));
+        ASSERT_EQ(padded[r * stride + c], expected(r, r * size + c));
+      }
+    }
+  };
+
+  for (auto *out : {&dense, &padded}) {
+    uint64_t outStride = out == &dense ? size : stride;
+    memref_batched_add_lwe_ciphertexts_u64(
+        out->data(), out->data(), 0, rows, size, outStride, 1, ct0.data(),
+        ct0.data(), 0, rows, size, size, 1, ct1.data(), ct1.data(), 0, rows,
+        size, size, 1);
+  }
+  check([&](uint64_t, uint64_t i) { return ct0[i] + ct1[i]; });
+
+  for (auto *out : {&dense, &padded}) {
+    uint64_t outStride = out == &dense ? size : stride;
+    memref_batched_mul_cleartext_lwe_ciphertext_u64(
+        out->data(), out->data(), 0, rows, size, outStride, 1, ct0.data(),
+        ct0.data(), 0, rows, size, size, 1, cleartexts.data(),
+        cleartexts.data(), 0, rows, 1);
+  }
+  check([&](uint64_t r, uint64_t i) { return ct0[i] * cleartexts[r]; });
+
+  for (auto *out : {&dense, &padded}) {
+    uint64_t outStride = out == &dense ? size : stride;
+    memref_batched_negate_lwe_ciphertext_u64(out->data(), out->data(), 0, rows,
+                                             size, outStride, 1, ct0.data(),
+                                             ct0.data(), 0, rows, size, size, 1);
+  }
+  check([&](uint64_t, uint64_t i) { return -ct0[i]; });
+
+  for (auto *out : {&dense, &padded}) {
+    uint64_t outStride = out == &dense ? size : stride;
+    memref_batched_add_plaintext_lwe_ciphertext_u64(
+        out->data(), out->data(), 0, rows, size, outStride, 1, ct0.data(),
+        ct0.data(), 0, rows, size, size, 1, cleartexts.data(),
+        cleartexts.data(), 0, rows, 1);
+  }
+  check([&](uint64_t r, uint64_t i) {
+    return i % size == size - 1 ? ct0[i] + cleartexts[r] : ct0[i];
+  });
+
+  for (auto *out : {&dense, &padded}) {
+    uint64_t outStride = out == &dense ? size : stride;
+    memref_batched_mul_cleartext_add_lwe_ciphertexts_u64(
+        out->data(), out->data(), 0, rows, size, outStride, 1, ct0.data(),
+        ct0.data(), 0, rows, size, size, 1, cleartexts.data(),
+        cleartexts.data(), 0, rows, 1, ct1.data(), ct1.data(), 0, rows, size,
+        size, 1);
+  }
+  check([&](uint64_t r, uint64_t i) {
+    return ct0[i] * cleartexts[r] + ct1[i];
+  });
+
+  for (auto *out : {&dense, &padded}) {
+    uint64_t outStride = out == &dense ? size : stride;
+    memref_batched_mul_cleartext_cst_add_lwe_ciphertexts_u64(
+        out->data(), out->data(), 0, rows, size, outStride, 1, ct0.data(),
+        ct0.data(), 0, rows, size, size, 1, cleartexts[2], ct1.data(),
+        ct1.data(), 0, rows, size, size, 1);
+  }
+  check([&](uint64_t, uint64_t i) {
+    return ct0[i] * cleartexts[2] + ct1[i];
+  });
+}
+
+TEST(Wrappers, gather_scatter_lwe_ciphertexts) {
+  // 5 ciphertexts of size 3, gathered to rows padded to a stride of 4
+  const uint64_t rows = 5, size = 3, stride = 4;
+  std::vector<uint64_t> ct(rows * size);
+  for (uint64_t i = 0; i < rows * size; i++)
+    ct[i] = i * 0x9e3779b97f4a7c15ULL;
+
+  std::vector<uint64_t> positions = {4, 1, 2, 3, 0, 0};
+  std::vector<uint64_t> gathered(positions.size() * stride);
+  memref_gather_lwe_ciphertexts_u64(
+      gathered.data(), gathered.data(), 0, positions.size(), size, stride, 1,
+      ct.data(), ct.data(), 0, rows, size, size, 1, positions.data(),
+      positions.data(), 0, positions.size(), 1);
+  for (uint64_t r = 0; r < positions.size(); r++) {
+    for (uint64_t c = 0; c < size; c++)
+      ASSERT_EQ(gathered[r * stride + c], ct[positions[r] * size + c]);
+  }
+
+  // Out of place, the other rows are copied from the input
+  std::vector<uint64_t> values = {100, 101, 102, 200, 201, 202};
+  std::vector<uint64_t> targets = {3, 1};
+  std::vector<uint64_t> scattered(rows * size);
+  memref_scatter_lwe_ciphertexts_u64(
+      scattered.data(), scattered.data(), 0, rows, size, size, 1, ct.data(),
+      ct.data(), 0, rows, size, size, 1, values.data(), values.data(), 0, 2,
+      size, size, 1, targets.data(), targets.data(), 0, 2, 1);
+  for (uint64_t r = 0; r < rows; r++) {
+    for (uint64_t c = 0; c < size; c++) {
+      uint64_t expected = r == 3   ? values[c]
+                          : r == 1 ? values[size + c]
+                                   : ct[r * size + c];
+      ASSERT_EQ(scattered[r * size + c], expected);
+    }
+  }
+
+  // In place, with values read from the rows being written
+  std::vector<uint64_t> swapped = ct;
+  std::vector<uint64_t> swap = {1, 0};
+  memref_scatter_lwe_ciphertexts_u64(
+      swapped.data(), swapped.data(), 0, rows, size, size, 1, swapped.data(),
+      swapped.data(), 0, rows, size, size, 1, swapped.data(), swapped.data(),
+      0, 2, size, size, 1, swap.data(), swap.data(), 0, 2, 1);
+  for (uint64_t c = 0; c < size; c++) {
+    ASSERT_EQ(swapped[c], ct[size + c]);
+    ASSERT_EQ(swapped[size + c], ct[c]);
+  }
+}
+
+TEST(AsyncExecutor, nested_await) {
+  namespace async = mlir::concretelang::async;
+  // Each task awaits the tasks it spawns, which must not deadlock the pool
+  // whatever its number of workers
+  std::function<uint64_t(uint64_t)> fib = [&](uint64_t n) -> uint64_t {
+    if (n < 2)
+      return n;
+    uint64_t a;
+    auto future = async::submit([&] { a = fib(n - 1); });
+    uint64_t b = fib(n - 2);
+    async::await(future);
+    return a + b;
+  };
+  ASSERT_EQ(fib(20), 6765u);
+
+  std::atomic<int> count{0};
+  std::vector<async::Future *> futures;
+  for (int i = 0; i < 100; i++)
+    futures.push_back(async::submit([&] { count++; }));
+  for (auto future : futures)
+    async::await(future);
+  ASSERT_EQ(count.load(), 100);
+}
+
+TEST(Wrappers, await_future_copies_result) {
+  std::vector<uint64_t> in = {1, 2, 3}, out(3);
+  auto future =
+      mlir::concretelang::async::submit([&] { in = {4, 5, 6}; });
+  memref_await_future(out.data(), out.data(), 0, 3, 1, future, in.data(),
+                      in.data(), 0, 3, 1);
+  ASSERT_EQ(out, in);
+}
+
+TEST(Wrappers, x86_64_level) {
+  uint64_t level = concrete_x86_64_level();
+  ASSERT_LE(level, 3u);
+  ASSERT_EQ(concrete_x86_64_level(), level);
+}
+
+#if CONCRETELANG_TRACING_ENABLED
+TEST(Tracing, chrome_trace_events) {
+  namespace tracing = mlir::concretelang::tracing;
+  // The environment is read on the first use of the tracing
+  std::string path = testing::TempDir() + "runtime_trace.json";
+  setenv("CONCRETE_TRACE_FILE", path.c_str(), 1);
+  ASSERT_TRUE(tracing::isEnabled());
+
+  tracing::setThreadName("test thread");
+  uint64_t start = tracing::now();
+  {
+    tracing::TraceScope trace("test", "scope \"quoted\"",
+                              {{"count", 3}, {"label", std::string("a")}});
+  }
+  tracing::asyncSpan("test", "lifetime", 7, start);
+  tracing::flush();
+
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  std::string trace = content.str();
+  ASSERT_EQ(trace.find("{\"traceEvents\":["), 0u);
+  ASSERT_NE(trace.find("\"name\":\"thread_name\""), std::string::npos);
+  ASSERT_NE(trace.find("\"ph\":\"X\",\"cat\":\"test\","
+                       "\"name\":\"scope \\\"quoted\\\"\""),
+            std::string::npos);
+  ASSERT_NE(trace.find("\"args\":{\"count\":3,\"label\":\"a\"}"),
+            std::string::npos);
+  ASSERT_NE(trace.find("\"ph\":\"b\""), std::string::npos);
+  ASSERT_NE(trace.find("\"ph\":\"e\""), std::string::npos);
+  ASSERT_NE(trace.find("\"id\":7"), std::string::npos);
+}
+#endif
+
 } // namespace
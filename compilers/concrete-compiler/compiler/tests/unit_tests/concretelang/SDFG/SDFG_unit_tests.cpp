@@ -20,9 +20,9 @@ using namespace concretelang::testlib;
 testing::Environment *const dfr_env =
     testing::AddGlobalTestEnvironment(new DFREnvironment);
 
-Result<TestProgram> setupTestProgram(std::string source,
-                                     std::string funcname = FUNCNAME) {
-  mlir::concretelang::CompilationOptions options;
+Result<TestProgram>
+setupTestProgram(std::string source, std::string funcname = FUNCNAME,
+                 mlir::concretelang::CompilationOptions options = {}) {
 #ifdef CONCRETELANG_CUDA_SUPPORT
   options.emitGPUOps = true;
   options.emitSDFGOps = true;
@@ -235,3 +235,116 @@ TEST(SDFG_unit_tests, batched_tree_mapped_tlu) {
   ASSERT_TRUE(res.has_value());
   ASSERT_EQ(res.value()[0].getTensor<uint64_t>(), expected);
 }
+
+TEST(SDFG_unit_tests, tlu_batched_chunks) {
+  std::string source = R"(
+    func.func @main(%t: tensor<4x3x!FHE.eint<2>>) -> tensor<4x3x!FHE.eint<3>> {
+      %lut = arith.constant dense<[1,3,5,7]> : tensor<4xi64>
+      %res = "FHELinalg.apply_lookup_table"(%t, %lut) : (tensor<4x3x!FHE.eint<2>>, tensor<4xi64>) -> tensor<4x3x!FHE.eint<3>>
+      return %res : tensor<4x3x!FHE.eint<3>>
+    }
+)";
+  // Batches of a row, streamed two by two through the same processes
+  mlir::concretelang::CompilationOptions options;
+  options.maxBatchSize = 3;
+  options.emitSDFGOps = true;
+  options.unrollLoopsWithSDFGConvertibleOps = true;
+  options.sdfgLoopUnrollFactor = 2;
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit,
+                              setupTestProgram(source, FUNCNAME, options));
+  auto t = Tensor<uint64_t>({0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3}, {4, 3});
+  auto expected =
+      Tensor<uint64_t>({1, 3, 5, 7, 1, 3, 5, 7, 1, 3, 5, 7}, {4, 3});
+  auto res = circuit.call({t});
+  ASSERT_TRUE(res.has_value());
+  ASSERT_EQ(res.value()[0].getTensor<uint64_t>(), expected);
+}
+
+TEST(SDFG_unit_tests, tlu_batched_stream) {
+  std::string source = R"(
+    func.func @main(%t: tensor<4x3x!FHE.eint<2>>) -> tensor<4x3x!FHE.eint<3>> {
+      %lut = arith.constant dense<[1,3,5,7]> : tensor<4xi64>
+      %res = "FHELinalg.apply_lookup_table"(%t, %lut) : (tensor<4x3x!FHE.eint<2>>, tensor<4xi64>) -> tensor<4x3x!FHE.eint<3>>
+      return %res : tensor<4x3x!FHE.eint<3>>
+    }
+)";
+  mlir::concretelang::CompilationOptions options;
+  options.maxBatchSize = 3;
+  options.emitSDFGOps = true;
+  options.unrollLoopsWithSDFGConvertibleOps = true;
+  options.sdfgLoopUnrollFactor = 2;
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit,
+                              setupTestProgram(source, FUNCNAME, options));
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  // Each call gets inputs of its own, so that the results of calls sharing
+  // the graph cannot be mixed up
+  std::vector<std::future<Result<std::vector<TransportValue>>>> results;
+  {
+    auto stream = serverCircuit.openStream(keyset.server);
+    for (uint64_t c = 0; c < 6; c++) {
+      std::vector<uint64_t> values;
+      for (uint64_t i = 0; i < 12; i++)
+        values.push_back((i + c) % 4);
+      ASSERT_ASSIGN_OUTCOME_VALUE(
+          arg, clientCircuit.prepareInput(Tensor<uint64_t>(values, {4, 3}), 0));
+      results.push_back(stream->submit({arg}));
+    }
+  }
+  for (uint64_t c = 0; c < results.size(); c++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(res, results[c].get());
+    ASSERT_ASSIGN_OUTCOME_VALUE(output, clientCircuit.processOutput(res[0], 0));
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < 12; i++)
+      expected.push_back(2 * ((i + c) % 4) + 1);
+    ASSERT_EQ(output.getTensor<uint64_t>(), Tensor<uint64_t>(expected, {4, 3}));
+  }
+}
+
+TEST(SDFG_unit_tests, tlu_tree_worker_pool) {
+  std::string source = R"(
+    func.func @main(%t: tensor<4x3x!FHE.eint<3>>) -> tensor<4x3x!FHE.eint<4>> {
+      %lut = arith.constant dense<[1,3,5,7,9,11,13,15]> : tensor<8xi64>
+      %a = "FHELinalg.apply_lookup_table"(%t, %lut) : (tensor<4x3x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x3x!FHE.eint<4>>
+      %b = "FHELinalg.apply_lookup_table"(%t, %lut) : (tensor<4x3x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x3x!FHE.eint<4>>
+      %res = "FHELinalg.add_eint"(%a, %b) : (tensor<4x3x!FHE.eint<4>>, tensor<4x3x!FHE.eint<4>>) -> tensor<4x3x!FHE.eint<4>>
+      return %res : tensor<4x3x!FHE.eint<4>>
+    }
+)";
+  // Fewer workers than processes, which the workers must then share
+  setenv("SDFG_NUM_THREADS", "2", 1);
+  mlir::concretelang::CompilationOptions options;
+  options.maxBatchSize = 3;
+  options.emitSDFGOps = true;
+  options.unrollLoopsWithSDFGConvertibleOps = true;
+  options.sdfgLoopUnrollFactor = 2;
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit,
+                              setupTestProgram(source, FUNCNAME, options));
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  // More calls than the items a stream between two processes holds, so that
+  // the writers wait for the readers to free slots
+  std::vector<std::future<Result<std::vector<TransportValue>>>> results;
+  {
+    auto stream = serverCircuit.openStream(keyset.server);
+    for (uint64_t c = 0; c < 20; c++) {
+      std::vector<uint64_t> values;
+      for (uint64_t i = 0; i < 12; i++)
+        values.push_back((i + c) % 4);
+      ASSERT_ASSIGN_OUTCOME_VALUE(
+          arg, clientCircuit.prepareInput(Tensor<uint64_t>(values, {4, 3}), 0));
+      results.push_back(stream->submit({arg}));
+    }
+  }
+  for (uint64_t c = 0; c < results.size(); c++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(res, results[c].get());
+    ASSERT_ASSIGN_OUTCOME_VALUE(output, clientCircuit.processOutput(res[0], 0));
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < 12; i++)
+      expected.push_back(2 * (2 * ((i + c) % 4) + 1));
+    ASSERT_EQ(output.getTensor<uint64_t>(), Tensor<uint64_t>(expected, {4, 3}));
+  }
+  unsetenv("SDFG_NUM_THREADS");
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "concretelang/ServerLib/ServerMetrics.h"
+
+using concretelang::serverlib::Metric;
+using concretelang::serverlib::MetricType;
+using concretelang::serverlib::ServerMetrics;
+
+namespace {
+
+TEST(ServerMetrics, latency_quantiles) {
+  ServerMetrics metrics;
+  auto circuit = metrics.getCircuitMetrics("main");
+  ASSERT_EQ(circuit->getLatencyQuantile(0.5), 0);
+  for (uint64_t i = 1; i <= 1000; i++)
+    circuit->recordCall(true, i * 1000, 0, 0);
+  ASSERT_EQ(circuit->getCalls(), 1000u);
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    double expected = quantile * 1000 * 1000;
+    ASSERT_NEAR(circuit->getLatencyQuantile(quantile), expected,
+                0.25 * expected);
+  }
+}
+
+TEST(ServerMetrics, shared_by_name) {
+  ServerMetrics metrics;
+  metrics.getCircuitMetrics("main")->recordCall(false, 10, 1, 2);
+  auto circuit = metrics.getCircuitMetrics("main");
+  ASSERT_EQ(circuit->getCalls(), 1u);
+  ASSERT_EQ(circuit->getErrors(), 1u);
+  ASSERT_EQ(circuit->getArgumentBytes(), 1u);
+  ASSERT_EQ(circuit->getReturnBytes(), 2u);
+}
+
+TEST(ServerMetrics, prometheus_text) {
+  ServerMetrics metrics;
+  metrics.getCircuitMetrics("main")->recordCall(true, 2000, 16, 8);
+  metrics.getCircuitMetrics("main")->recordCall(false, 2000, 16, 0);
+  metrics.recordContextCreation();
+  metrics.addCollector([](std::vector<Metric> &collected) {
+    collected.push_back(
+        Metric{"app_queue_size", "Queued requests.", MetricType::GAUGE,
+               {{"app_queue_size", {{"queue", "a\"b"}}, 3}}});
+  });
+
+  auto text = metrics.toPrometheusText();
+  auto contains = [&](const std::string &line) {
+    return text.find(line + "\n") != std::string::npos;
+  };
+  ASSERT_TRUE(contains("# TYPE concrete_server_calls_total counter"));
+  ASSERT_TRUE(contains("concrete_server_calls_total{circuit=\"main\"} 2"));
+  ASSERT_TRUE(
+      contains("concrete_server_call_errors_total{circuit=\"main\"} 1"));
+  ASSERT_TRUE(
+      contains("# TYPE concrete_server_call_duration_seconds summary"));
+  ASSERT_TRUE(contains(
+      "concrete_server_call_duration_seconds_count{circuit=\"main\"} 2"));
+  ASSERT_TRUE(
+      contains("concrete_server_argument_bytes_total{circuit=\"main\"} 32"));
+  ASSERT_TRUE(
+      contains("concrete_server_return_bytes_total{circuit=\"main\"} 8"));
+  ASSERT_TRUE(contains("concrete_server_runtime_context_creations_total 1"));
+  ASSERT_TRUE(contains("# TYPE app_queue_size gauge"));
+  ASSERT_TRUE(contains("app_queue_size{queue=\"a\\\"b\"} 3"));
+}
+
+} // namespace
@@ -1,14 +1,22 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <numeric>
+#include <optional>
+#include <thread>
+#include <unistd.h>
 
 #include "boost/outcome.h"
 
 #include "concretelang/Common/Error.h"
+#include "concretelang/Runtime/context.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "concretelang/TestLib/TestProgram.h"
+#include "llvm/ADT/ScopeExit.h"
 
 #include "tests_tools/GtestEnvironment.h"
 #include "tests_tools/assert.h"
@@ -321,3 +329,211 @@ func.func @main(%arg0: !FHE.eint<6>, %arg1: !FHE.eint<3>) -> !FHE.eint<6> {
       ASSERT_EQ(out, (uint64_t)a + b);
     }
 }
+
+const std::string LOOKUP_TABLE_SOURCE = R"(
+func.func @main(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %tlu = arith.constant dense<[7, 6, 5, 4, 3, 2, 1, 0]> : tensor<8xi64>
+  %1 = "FHE.apply_lookup_table"(%arg0, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
+)";
+
+TEST(ServerCircuit, context_cache_reuses_contexts) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_OUTCOME_HAS_VALUE(circuit.generateKeyset(1, 1));
+  ASSERT_ASSIGN_OUTCOME_VALUE(otherKeyset, circuit.getKeyset());
+
+  concretelang::serverlib::RuntimeContextCache cache(1);
+  auto context = cache.get(keyset.server);
+  ASSERT_EQ(cache.get(keyset.server), context);
+  // The copies of a keyset share its keys
+  auto copy = keyset.server;
+  ASSERT_EQ(cache.get(copy), context);
+  ASSERT_NE(cache.get(otherKeyset.server), context);
+  // The context of the first keyset was dropped for the other one
+  ASSERT_NE(cache.get(keyset.server), context);
+}
+
+TEST(ServerCircuit, calls_with_the_same_keys_share_a_context) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(programInfo, circuit.getProgramInfo());
+  ASSERT_ASSIGN_OUTCOME_VALUE(libraryPath, circuit.getSharedLibraryPath());
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      serverProgram, ServerProgram::load(programInfo, libraryPath, false));
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit,
+                              serverProgram.getServerCircuit("main"));
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  for (uint64_t a : {1, 2, 3}) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        arg, clientCircuit.prepareInput(Tensor<uint64_t>(a), 0));
+    std::vector<TransportValue> args{arg};
+    ASSERT_ASSIGN_OUTCOME_VALUE(results,
+                                serverCircuit.call(keyset.server, args));
+    ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                                clientCircuit.processOutput(results[0], 0));
+    ASSERT_EQ(result.getTensor<uint64_t>().value()[0], 7 - a);
+  }
+  ASSERT_EQ(serverProgram.getMetrics()->getContextCreations(), 1u);
+}
+
+TEST(ServerCircuit, concurrent_calls) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  const size_t threads = 4;
+  std::vector<std::vector<TransportValue>> args(threads * 8);
+  for (size_t c = 0; c < args.size(); c++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        arg, clientCircuit.prepareInput(Tensor<uint64_t>(c % 8), 0));
+    args[c].push_back(arg);
+  }
+  std::vector<std::optional<Result<std::vector<TransportValue>>>> results(
+      args.size());
+  // Each thread calls the same circuit on its share of the arguments
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; t++)
+    workers.emplace_back([&, t]() {
+      for (size_t c = t; c < args.size(); c += threads)
+        results[c] = serverCircuit.call(keyset.server, args[c]);
+    });
+  for (auto &worker : workers)
+    worker.join();
+  for (size_t c = 0; c < args.size(); c++) {
+    ASSERT_OUTCOME_HAS_VALUE(*results[c]);
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        result, clientCircuit.processOutput(results[c]->value()[0], 0));
+    ASSERT_EQ(result.getTensor<uint64_t>().value()[0], 7 - c % 8);
+  }
+}
+
+TEST(ServerCircuit, call_batch) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  std::vector<std::vector<TransportValue>> batch;
+  for (uint64_t a = 0; a < 8; a++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(
+        arg, clientCircuit.prepareInput(Tensor<uint64_t>(a), 0));
+    batch.push_back({arg});
+  }
+  ASSERT_ASSIGN_OUTCOME_VALUE(results,
+                              serverCircuit.callBatch(keyset.server, batch));
+  ASSERT_EQ(results.size(), batch.size());
+  for (uint64_t a = 0; a < 8; a++) {
+    ASSERT_EQ(results[a].size(), 1u);
+    ASSERT_ASSIGN_OUTCOME_VALUE(result,
+                                clientCircuit.processOutput(results[a][0], 0));
+    ASSERT_EQ(result.getTensor<uint64_t>().value()[0], 7 - a);
+  }
+}
+
+TEST(ServerCircuit, call_batch_bad_call) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  ASSERT_ASSIGN_OUTCOME_VALUE(serverCircuit, circuit.getServerCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientCircuit, circuit.getClientCircuit());
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      arg, clientCircuit.prepareInput(Tensor<uint64_t>(1), 0));
+  std::vector<std::vector<TransportValue>> batch{{arg}, {}};
+  ASSERT_OUTCOME_HAS_FAILURE(serverCircuit.callBatch(keyset.server, batch));
+}
+
+// Makes two asynchronous calls from the callback of an asynchronous call,
+// and returns the number of calls which succeeded within a minute.
+Result<size_t> callAsyncFromCallback() {
+  OUTCOME_TRY(auto circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  OUTCOME_TRY(auto keyset, circuit.getKeyset());
+  OUTCOME_TRY(auto serverCircuit, circuit.getServerCircuit());
+  OUTCOME_TRY(auto clientCircuit, circuit.getClientCircuit());
+  OUTCOME_TRY(auto arg, clientCircuit.prepareInput(Tensor<uint64_t>(1), 0));
+  std::vector<TransportValue> args{arg};
+  std::atomic<size_t> succeeded{0};
+  std::atomic<size_t> remaining{3};
+  std::promise<void> done;
+  auto onResult = [&](Result<std::vector<TransportValue>> result) {
+    if (result.has_value())
+      succeeded++;
+    if (--remaining == 0)
+      done.set_value();
+  };
+  serverCircuit.callAsync(
+      keyset.server, args,
+      [&](Result<std::vector<TransportValue>> result) {
+        serverCircuit.callAsync(keyset.server, args, onResult);
+        serverCircuit.callAsync(keyset.server, args, onResult);
+        onResult(std::move(result));
+      });
+  done.get_future().wait_for(std::chrono::minutes(1));
+  return succeeded.load();
+}
+
+// With a single pool thread and a queue of one call, the second call made
+// from the callback would wait forever for the thread of the callback to free
+// the queue. The pool is configured on its first use, so the test runs in a
+// process of its own.
+TEST(ServerCircuit, call_async_from_callback) {
+  testing::GTEST_FLAG(death_test_style) = "threadsafe";
+  EXPECT_EXIT(
+      {
+        setenv("CONCRETE_SERVER_THREADS", "1", 1);
+        setenv("CONCRETE_SERVER_QUEUE_DEPTH", "1", 1);
+        auto succeeded = callAsyncFromCallback();
+        // Skips the destruction of a pool which could be stuck
+        _exit(succeeded.has_value() && succeeded.value() == 3 ? 0 : 1);
+      },
+      testing::ExitedWithCode(0), "");
+}
+
+using mlir::concretelang::RuntimeContext;
+
+// The context releasing the standard bootstrap keys shares their fourier
+// form with the contexts created from its released keys
+TEST(RuntimeContext, released_bootstrap_keys_are_adopted) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  setenv("CONCRETE_RELEASE_STANDARD_BSK", "1", 1);
+  auto unset = llvm::make_scope_exit(
+      []() { unsetenv("CONCRETE_RELEASE_STANDARD_BSK"); });
+
+  RuntimeContext first(keyset.server);
+  auto released = first.getKeys();
+  ASSERT_EQ(released.lweBootstrapKeys[0].getTransportBuffer().size(), 0u);
+  auto fourier = first.get_fourier_bootstrap_key(0);
+  ASSERT_NE(fourier, nullptr);
+
+  RuntimeContext second(released);
+  ASSERT_EQ(second.get_fourier_bootstrap_key(0), fourier);
+  ASSERT_NE(second.fft(0), nullptr);
+}
+
+// Without the eager conversion, the keys are converted on their first use
+// and thus never released, while the released keys of another context are
+// adopted on their first use
+TEST(RuntimeContext, release_with_lazy_conversion) {
+  ASSERT_ASSIGN_OUTCOME_VALUE(circuit, setupTestProgram(LOOKUP_TABLE_SOURCE));
+  ASSERT_ASSIGN_OUTCOME_VALUE(keyset, circuit.getKeyset());
+  setenv("CONCRETE_RELEASE_STANDARD_BSK", "1", 1);
+  auto unset = llvm::make_scope_exit([]() {
+    unsetenv("CONCRETE_RELEASE_STANDARD_BSK");
+    unsetenv("CONCRETE_LAZY_BSK_CONVERSION");
+  });
+
+  RuntimeContext eager(keyset.server);
+  auto released = eager.getKeys();
+  auto fourier = eager.get_fourier_bootstrap_key(0);
+
+  setenv("CONCRETE_LAZY_BSK_CONVERSION", "1", 1);
+  RuntimeContext lazy(keyset.server);
+  ASSERT_GT(lazy.getKeys().lweBootstrapKeys[0].getTransportBuffer().size(),
+            0u);
+  ASSERT_NE(lazy.fft(0), nullptr);
+  ASSERT_GT(lazy.getKeys().lweBootstrapKeys[0].getTransportBuffer().size(),
+            0u);
+
+  RuntimeContext lazyReleased(released);
+  ASSERT_EQ(lazyReleased.get_fourier_bootstrap_key(0), fourier);
+}
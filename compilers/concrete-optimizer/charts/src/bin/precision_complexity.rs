@@ -51,6 +51,8 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         ciphertext_modulus_log,
         fft_precision,
         complexity_model: &CpuComplexity::default(),
+        nb_threads: 1,
+        key_size_weight: 0.0,
     };
 
     let cache = decomposition::cache(
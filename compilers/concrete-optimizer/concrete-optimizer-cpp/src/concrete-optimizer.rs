@@ -3,7 +3,9 @@
 
 use core::panic;
 
-use concrete_optimizer::computing_cost::cpu::CpuComplexity;
+use concrete_optimizer::computing_cost::calibrated::CalibratedComplexity;
+use concrete_optimizer::computing_cost::complexity_model::ComplexityModel;
+use concrete_optimizer::computing_cost::gpu::GpuComplexity;
 use concrete_optimizer::config;
 use concrete_optimizer::config::ProcessingUnit;
 use concrete_optimizer::dag::operator::{
@@ -12,9 +14,10 @@ use concrete_optimizer::dag::operator::{
 use concrete_optimizer::dag::unparametrized;
 use concrete_optimizer::optimization::config::{Config, SearchSpace};
 use concrete_optimizer::optimization::dag::multi_parameters::keys_spec::CircuitSolution;
+use concrete_optimizer::optimization::dag::multi_parameters::multi_bit::use_multi_bit_bootstraps;
 use concrete_optimizer::optimization::dag::multi_parameters::optimize::{
-    KeysetRestriction, MacroParameters, NoSearchSpaceRestriction, RangeRestriction,
-    SearchSpaceRestriction,
+    choose_pbs_ks_partitions, search_partition_cut, KeysetRestriction, MacroParameters,
+    NoSearchSpaceRestriction, RangeRestriction, SearchSpaceRestriction,
 };
 use concrete_optimizer::optimization::dag::multi_parameters::partition_cut::PartitionCut;
 use concrete_optimizer::optimization::dag::multi_parameters::virtual_circuit::generate_virtual_parameters;
@@ -30,6 +33,7 @@ use concrete_optimizer::parameters::{
 use concrete_optimizer::utils::cache::persistent::default_cache_dir;
 use concrete_optimizer::utils::viz::Viz;
 use cxx::CxxString;
+use std::sync::Arc;
 
 fn no_solution() -> ffi::Solution {
     ffi::Solution {
@@ -55,7 +59,7 @@ fn caches_from(options: &ffi::Options) -> decomposition::PersistDecompCaches {
     decomposition::cache(
         options.security_level,
         processing_unit,
-        Some(ProcessingUnit::Cpu.complexity_model()),
+        Some(complexity_model(options)),
         options.cache_on_disk,
         options.ciphertext_modulus_log,
         options.fft_precision,
@@ -120,13 +124,16 @@ fn optimize_bootstrap(precision: u64, noise_factor: f64, options: &ffi::Options)
     // Support composable since there is no dag
     let processing_unit = processing_unit(options);
 
+    let complexity_model = complexity_model(options);
     let config = Config {
         security_level: options.security_level,
         maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
         key_sharing: options.key_sharing,
         ciphertext_modulus_log: options.ciphertext_modulus_log,
         fft_precision: options.fft_precision,
-        complexity_model: &CpuComplexity::default(),
+        complexity_model: complexity_model.as_ref(),
+        nb_threads: options.nb_threads as usize,
+        key_size_weight: options.key_size_weight,
     };
 
     let sum_size = 1;
@@ -320,6 +327,7 @@ fn convert_to_circuit_solution(sol: &ffi::DagSolution, dag: &Dag) -> ffi::Circui
             level: sol.br_decomposition_level_count,
             log2_base: sol.br_decomposition_base_log,
         },
+        grouping_factor: 0,
         description: "tlu bootstrap".into(),
     };
     let circuit_bootstrap_keys = if sol.use_wop_pbs {
@@ -476,6 +484,7 @@ impl From<keys_spec::BootstrapKey> for ffi::BootstrapKey {
             input_key: v.input_key.into(),
             output_key: v.output_key.into(),
             br_decomposition_parameter: v.br_decomposition_parameter.into(),
+            grouping_factor: v.grouping_factor,
             description: v.description,
         }
     }
@@ -556,6 +565,10 @@ impl Dag {
         self.0.viz_string()
     }
 
+    fn fingerprint(&self) -> String {
+        self.0.fingerprint()
+    }
+
     fn get_input_indices(&self) -> Vec<ffi::OperatorIndex> {
         self.0
             .get_input_operators_iter()
@@ -572,13 +585,16 @@ impl Dag {
 
     fn optimize(&self, options: &ffi::Options) -> ffi::DagSolution {
         let processing_unit = processing_unit(options);
+        let complexity_model = complexity_model(options);
         let config = Config {
             security_level: options.security_level,
             maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: complexity_model.as_ref(),
+            nb_threads: options.nb_threads as usize,
+            key_size_weight: options.key_size_weight,
         };
 
         let search_space = SearchSpace::default(processing_unit);
@@ -644,75 +660,122 @@ impl Dag {
 
     fn optimize_multi(&self, options: &ffi::Options) -> ffi::CircuitSolution {
         let processing_unit = processing_unit(options);
+        let complexity_model = complexity_model(options);
         let config = Config {
             security_level: options.security_level,
             maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: complexity_model.as_ref(),
+            nb_threads: options.nb_threads as usize,
+            key_size_weight: options.key_size_weight,
         };
         let search_space = SearchSpace::default(processing_unit);
 
-        let encoding = options.encoding.into();
-        #[allow(clippy::wildcard_in_or_patterns)]
-        let p_cut = match options.multi_param_strategy {
-            ffi::MultiParamStrategy::ByPrecisionAndNorm2 => {
-                PartitionCut::maximal_partitionning(&self.0)
-            }
-            ffi::MultiParamStrategy::ByPrecision | _ => PartitionCut::for_each_precision(&self.0),
-        };
-        let circuit_sol =
+        let mut circuit_sol =
             if !options.keyset_restriction.is_null() && !options.range_restriction.is_null() {
-                concrete_optimizer::optimization::dag::multi_parameters::optimize_generic::optimize(
-                    &self.0,
+                self.optimize_multi_restricted(
+                    options,
                     config,
                     &search_space,
                     &(
                         (*options.keyset_restriction).clone(),
                         (*options.range_restriction).clone(),
                     ),
-                    encoding,
-                    options.default_log_norm2_woppbs,
-                    &caches_from(options),
-                    &Some(p_cut),
                 )
             } else if !options.keyset_restriction.is_null() {
-                concrete_optimizer::optimization::dag::multi_parameters::optimize_generic::optimize(
-                    &self.0,
+                self.optimize_multi_restricted(
+                    options,
                     config,
                     &search_space,
                     &*options.keyset_restriction,
-                    encoding,
-                    options.default_log_norm2_woppbs,
-                    &caches_from(options),
-                    &Some(p_cut),
                 )
             } else if !options.range_restriction.is_null() {
-                concrete_optimizer::optimization::dag::multi_parameters::optimize_generic::optimize(
-                    &self.0,
+                self.optimize_multi_restricted(
+                    options,
                     config,
                     &search_space,
                     &*options.range_restriction,
-                    encoding,
-                    options.default_log_norm2_woppbs,
-                    &caches_from(options),
-                    &Some(p_cut),
                 )
             } else {
-                concrete_optimizer::optimization::dag::multi_parameters::optimize_generic::optimize(
-                    &self.0,
+                self.optimize_multi_restricted(
+                    options,
                     config,
                     &search_space,
                     &NoSearchSpaceRestriction,
-                    encoding,
-                    options.default_log_norm2_woppbs,
-                    &caches_from(options),
-                    &Some(p_cut),
                 )
             };
+        // a restricted keyset only has classic bootstrap keys
+        if matches!(processing_unit, ProcessingUnit::Gpu { .. })
+            && options.keyset_restriction.is_null()
+        {
+            use_multi_bit_bootstraps(
+                &mut circuit_sol,
+                &self.0,
+                config,
+                options.max_grouping_factor,
+            );
+        }
         circuit_sol.into()
     }
+
+    fn optimize_multi_restricted(
+        &self,
+        options: &ffi::Options,
+        config: Config,
+        search_space: &SearchSpace,
+        search_space_restriction: &impl SearchSpaceRestriction,
+    ) -> CircuitSolution {
+        let caches = caches_from(options);
+        let encoding = options.encoding.into();
+        #[allow(clippy::wildcard_in_or_patterns)]
+        let p_cut = match options.multi_param_strategy {
+            ffi::MultiParamStrategy::ByPrecisionAndNorm2 | ffi::MultiParamStrategy::ByCost => {
+                PartitionCut::maximal_partitionning(&self.0)
+            }
+            ffi::MultiParamStrategy::ByPrecision | _ => PartitionCut::for_each_precision(&self.0),
+        };
+        let p_cut = if matches!(
+            options.multi_param_strategy,
+            ffi::MultiParamStrategy::ByCost
+        ) || options.key_reuse_threshold > 0.0
+        {
+            search_partition_cut(
+                &self.0,
+                config,
+                search_space,
+                search_space_restriction,
+                &caches,
+                p_cut,
+                options.key_reuse_threshold,
+            )
+        } else {
+            p_cut
+        };
+        let p_cut = if options.allow_pbs_ks_order {
+            choose_pbs_ks_partitions(
+                &self.0,
+                config,
+                search_space,
+                search_space_restriction,
+                &caches,
+                p_cut,
+            )
+        } else {
+            p_cut
+        };
+        concrete_optimizer::optimization::dag::multi_parameters::optimize_generic::optimize(
+            &self.0,
+            config,
+            search_space,
+            search_space_restriction,
+            encoding,
+            options.default_log_norm2_woppbs,
+            &caches,
+            &Some(p_cut),
+        )
+    }
 }
 
 pub struct DagBuilder<'dag>(unparametrized::DagBuilder<'dag>);
@@ -919,13 +982,16 @@ fn generate_virtual_keyset_info(
     generate_fks: bool,
     options: &ffi::Options,
 ) -> ffi::CircuitKeys {
+    let complexity_model = complexity_model(options);
     let config = Config {
         security_level: options.security_level,
         maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
         key_sharing: options.key_sharing,
         ciphertext_modulus_log: options.ciphertext_modulus_log,
         fft_precision: options.fft_precision,
-        complexity_model: &CpuComplexity::default(),
+        complexity_model: complexity_model.as_ref(),
+        nb_threads: options.nb_threads as usize,
+        key_size_weight: options.key_size_weight,
     };
     generate_virtual_parameters(
         inputs
@@ -1042,6 +1108,8 @@ mod ffi {
 
         fn dump(self: &Dag) -> String;
 
+        fn fingerprint(self: &Dag) -> String;
+
         fn dump(self: &DagBuilder) -> String;
 
         unsafe fn add_input(
@@ -1216,6 +1284,16 @@ mod ffi {
     pub enum MultiParamStrategy {
         ByPrecision,
         ByPrecisionAndNorm2,
+        ByCost,
+    }
+
+    #[derive(Debug, Clone, Copy)]
+    #[namespace = "concrete_optimizer"]
+    pub enum CostModel {
+        Auto,
+        Cpu,
+        GpuAmortized,
+        GpuLowlat,
     }
 
     #[namespace = "concrete_optimizer::restriction"]
@@ -1245,6 +1323,23 @@ mod ffi {
         pub fft_precision: u32,
         pub range_restriction: SharedPtr<RangeRestriction>, // SharedPtr used for Options since optionals are not available...
         pub keyset_restriction: SharedPtr<KeysetRestriction>, // SharedPtr used for Options since optionals are not available...
+        // number of threads of the multi parameters search, 0 for all the available ones
+        pub nb_threads: u32,
+        // cost model minimized by the parameters search
+        pub cost_model: CostModel,
+        // number of streaming multiprocessors of the gpu cost models
+        pub gpu_number_of_sm: u32,
+        // measured time per unit of complexity of the keyswitch and the bootstrap, 0 to keep the model unscaled
+        pub ks_cost_factor: f64,
+        pub pbs_cost_factor: f64,
+        // complexity added per byte of evaluation keys, 0 to ignore the key sizes
+        pub key_size_weight: f64,
+        // relative complexity increase accepted to merge partitions, and share their keys between the circuits
+        pub key_reuse_threshold: f64,
+        // whether the luts of a partition may bootstrap and then keyswitch, the levelled operations using the small key
+        pub allow_pbs_ks_order: bool,
+        // largest grouping factor of the multi-bit bootstraps replacing the classic ones on gpu, 0 or 1 keeping the classic ones
+        pub max_grouping_factor: u32,
     }
 
     #[namespace = "concrete_optimizer::dag"]
@@ -1278,6 +1373,8 @@ mod ffi {
         pub input_key: SecretLweKey,
         pub output_key: SecretLweKey,
         pub br_decomposition_parameter: BrDecompositionParameters,
+        // input mask bits blind rotated at once by a multi-bit bootstrap, 0 for the classic one
+        pub grouping_factor: u64,
         pub description: String,
     }
 
@@ -1402,11 +1499,35 @@ mod ffi {
     }
 }
 
+/// The cost model minimized by the parameters search, `Auto` following the processing unit.
+fn complexity_model(options: &ffi::Options) -> Arc<dyn ComplexityModel> {
+    let number_of_sm = options.gpu_number_of_sm as u64;
+    #[allow(clippy::wildcard_in_or_patterns)]
+    let model: Arc<dyn ComplexityModel> = match options.cost_model {
+        ffi::CostModel::Auto => processing_unit(options).complexity_model(),
+        ffi::CostModel::GpuAmortized => {
+            Arc::new(GpuComplexity::default_amortized_u64(number_of_sm))
+        }
+        ffi::CostModel::GpuLowlat => Arc::new(GpuComplexity::default_lowlat_u64(number_of_sm)),
+        ffi::CostModel::Cpu | _ => ProcessingUnit::Cpu.complexity_model(),
+    };
+    let calibrated = CalibratedComplexity::new(
+        model.clone(),
+        options.ks_cost_factor,
+        options.pbs_cost_factor,
+    );
+    if calibrated.is_identity() {
+        model
+    } else {
+        Arc::new(calibrated)
+    }
+}
+
 fn processing_unit(options: &ffi::Options) -> ProcessingUnit {
     if options.use_gpu_constraints {
         config::ProcessingUnit::Gpu {
             pbs_type: config::GpuPbsType::Amortized,
-            number_of_sm: 1,
+            number_of_sm: options.gpu_number_of_sm as u64,
         }
     } else {
         config::ProcessingUnit::Cpu
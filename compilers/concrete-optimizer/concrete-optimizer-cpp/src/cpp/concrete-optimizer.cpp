@@ -1459,6 +1459,8 @@ extern "C" {
 
 void concrete_optimizer$cxxbridge1$Dag$dump(::concrete_optimizer::Dag const &self, ::rust::String *return$) noexcept;
 
+void concrete_optimizer$cxxbridge1$Dag$fingerprint(::concrete_optimizer::Dag const &self, ::rust::String *return$) noexcept;
+
 void concrete_optimizer$cxxbridge1$DagBuilder$dump(::concrete_optimizer::DagBuilder const &self, ::rust::String *return$) noexcept;
 
 ::concrete_optimizer::dag::OperatorIndex concrete_optimizer$cxxbridge1$DagBuilder$add_input(::concrete_optimizer::DagBuilder &self, ::std::uint8_t out_precision, ::rust::Slice<::std::uint64_t const> out_shape, ::concrete_optimizer::Location const &location) noexcept;
@@ -1616,6 +1618,12 @@ namespace dag {
   return ::std::move(return$.value);
 }
 
+::rust::String Dag::fingerprint() const noexcept {
+  ::rust::MaybeUninit<::rust::String> return$;
+  concrete_optimizer$cxxbridge1$Dag$fingerprint(*this, &return$.value);
+  return ::std::move(return$.value);
+}
+
 ::rust::String DagBuilder::dump() const noexcept {
   ::rust::MaybeUninit<::rust::String> return$;
   concrete_optimizer$cxxbridge1$DagBuilder$dump(*this, &return$.value);
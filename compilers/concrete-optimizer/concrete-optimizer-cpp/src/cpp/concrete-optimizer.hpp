@@ -930,6 +930,7 @@ namespace concrete_optimizer {
   struct Weights;
   enum class Encoding : ::std::uint8_t;
   enum class MultiParamStrategy : ::std::uint8_t;
+  enum class CostModel : ::std::uint8_t;
   struct Options;
   namespace dag {
     struct OperatorIndex;
@@ -966,6 +967,7 @@ namespace concrete_optimizer {
 struct Dag final : public ::rust::Opaque {
   ::rust::Box<::concrete_optimizer::DagBuilder> builder(::rust::String circuit) noexcept;
   ::rust::String dump() const noexcept;
+  ::rust::String fingerprint() const noexcept;
   ::concrete_optimizer::dag::DagSolution optimize(::concrete_optimizer::Options const &options) const noexcept;
   void add_composition(::std::string const &from_func, ::std::size_t from_pos, ::std::string const &to_func, ::std::size_t to_pos) noexcept;
   void add_all_compositions() noexcept;
@@ -1126,9 +1128,20 @@ struct DagSolution final {
 enum class MultiParamStrategy : ::std::uint8_t {
   ByPrecision = 0,
   ByPrecisionAndNorm2 = 1,
+  ByCost = 2,
 };
 #endif // CXXBRIDGE1_ENUM_concrete_optimizer$MultiParamStrategy
 
+#ifndef CXXBRIDGE1_ENUM_concrete_optimizer$CostModel
+#define CXXBRIDGE1_ENUM_concrete_optimizer$CostModel
+enum class CostModel : ::std::uint8_t {
+  Auto = 0,
+  Cpu = 1,
+  GpuAmortized = 2,
+  GpuLowlat = 3,
+};
+#endif // CXXBRIDGE1_ENUM_concrete_optimizer$CostModel
+
 namespace restriction {
 #ifndef CXXBRIDGE1_STRUCT_concrete_optimizer$restriction$RangeRestriction
 #define CXXBRIDGE1_STRUCT_concrete_optimizer$restriction$RangeRestriction
@@ -1161,6 +1174,15 @@ struct Options final {
   ::std::uint32_t fft_precision;
   ::std::shared_ptr<::concrete_optimizer::restriction::RangeRestriction> range_restriction;
   ::std::shared_ptr<::concrete_optimizer::restriction::KeysetRestriction> keyset_restriction;
+  ::std::uint32_t nb_threads;
+  ::concrete_optimizer::CostModel cost_model;
+  ::std::uint32_t gpu_number_of_sm;
+  double ks_cost_factor;
+  double pbs_cost_factor;
+  double key_size_weight;
+  double key_reuse_threshold;
+  bool allow_pbs_ks_order;
+  ::std::uint32_t max_grouping_factor;
 
   using IsRelocatable = ::std::true_type;
 };
@@ -1206,6 +1228,7 @@ struct BootstrapKey final {
   ::concrete_optimizer::dag::SecretLweKey input_key;
   ::concrete_optimizer::dag::SecretLweKey output_key;
   ::concrete_optimizer::dag::BrDecompositionParameters br_decomposition_parameter;
+  ::std::uint64_t grouping_factor;
   ::rust::String description;
 
   using IsRelocatable = ::std::true_type;
@@ -0,0 +1,134 @@
+use std::sync::Arc;
+
+use super::complexity::Complexity;
+use super::complexity_model::ComplexityModel;
+use crate::parameters::{CmuxParameters, KeyswitchParameters, LweDimension, PbsParameters};
+
+/// Scales the keyswitch and the bootstrap costs of a model by factors, e.g. the measured
+/// times per unit of complexity of the primitives on the target, so that the relative cost
+/// of the two matches the hardware.
+#[derive(Clone)]
+pub struct CalibratedComplexity {
+    pub model: Arc<dyn ComplexityModel>,
+    pub ks_factor: f64,
+    pub pbs_factor: f64,
+}
+
+impl CalibratedComplexity {
+    /// Calibrates `model`, a null factor keeping the cost of its primitive unscaled.
+    pub fn new(model: Arc<dyn ComplexityModel>, ks_factor: f64, pbs_factor: f64) -> Self {
+        let unscaled = |factor: f64| if factor > 0. { factor } else { 1. };
+        Self {
+            model,
+            ks_factor: unscaled(ks_factor),
+            pbs_factor: unscaled(pbs_factor),
+        }
+    }
+
+    pub fn is_identity(&self) -> bool {
+        self.ks_factor == 1. && self.pbs_factor == 1.
+    }
+}
+
+impl ComplexityModel for CalibratedComplexity {
+    fn pbs_complexity(&self, params: PbsParameters, ciphertext_modulus_log: u32) -> Complexity {
+        self.pbs_factor * self.model.pbs_complexity(params, ciphertext_modulus_log)
+    }
+
+    fn cmux_complexity(&self, params: CmuxParameters, ciphertext_modulus_log: u32) -> Complexity {
+        self.pbs_factor * self.model.cmux_complexity(params, ciphertext_modulus_log)
+    }
+
+    fn ks_complexity(
+        &self,
+        params: KeyswitchParameters,
+        ciphertext_modulus_log: u32,
+    ) -> Complexity {
+        self.ks_factor * self.model.ks_complexity(params, ciphertext_modulus_log)
+    }
+
+    fn fft_complexity(&self, glwe_polynomial_size: f64, ciphertext_modulus_log: u32) -> Complexity {
+        self.pbs_factor
+            * self
+                .model
+                .fft_complexity(glwe_polynomial_size, ciphertext_modulus_log)
+    }
+
+    fn levelled_complexity(
+        &self,
+        sum_size: u64,
+        lwe_dimension: LweDimension,
+        ciphertext_modulus_log: u32,
+    ) -> Complexity {
+        self.model
+            .levelled_complexity(sum_size, lwe_dimension, ciphertext_modulus_log)
+    }
+
+    fn multi_bit_pbs_complexity(
+        &self,
+        params: PbsParameters,
+        ciphertext_modulus_log: u32,
+        grouping_factor: u32,
+        jit_fft: bool,
+    ) -> Complexity {
+        self.pbs_factor
+            * self.model.multi_bit_pbs_complexity(
+                params,
+                ciphertext_modulus_log,
+                grouping_factor,
+                jit_fft,
+            )
+    }
+
+    fn cache_suffix(&self) -> String {
+        if self.is_identity() {
+            return self.model.cache_suffix();
+        }
+        format!(
+            "{}-ks{:e}-pbs{:e}",
+            self.model.cache_suffix(),
+            self.ks_factor,
+            self.pbs_factor
+        )
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::computing_cost::cpu::CpuComplexity;
+    use crate::parameters::{BrDecompositionParameters, GlweParameters, KsDecompositionParameters};
+
+    #[test]
+    fn test_scales_keyswitch_only() {
+        let cpu = Arc::new(CpuComplexity::default());
+        let calibrated = CalibratedComplexity::new(cpu.clone(), 3., 0.);
+        let ks = KeyswitchParameters {
+            input_lwe_dimension: LweDimension(2048),
+            output_lwe_dimension: LweDimension(700),
+            ks_decomposition_parameter: KsDecompositionParameters {
+                level: 3,
+                log2_base: 4,
+            },
+        };
+        let cmux = CmuxParameters {
+            br_decomposition_parameter: BrDecompositionParameters {
+                level: 1,
+                log2_base: 23,
+            },
+            output_glwe_params: GlweParameters {
+                log2_polynomial_size: 11,
+                glwe_dimension: 1,
+            },
+        };
+        assert_eq!(
+            calibrated.ks_complexity(ks, 64),
+            3. * cpu.ks_complexity(ks, 64)
+        );
+        assert_eq!(
+            calibrated.cmux_complexity(cmux, 64),
+            cpu.cmux_complexity(cmux, 64)
+        );
+        assert_ne!(calibrated.cache_suffix(), cpu.cache_suffix());
+    }
+}
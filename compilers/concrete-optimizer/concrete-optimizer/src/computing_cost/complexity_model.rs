@@ -20,4 +20,7 @@ pub trait ComplexityModel: Send + Sync {
         grouping_factor: u32,
         jit_fft: bool,
     ) -> Complexity;
+    /// Distinguishes the caches of the decomposition quantities computed with this model,
+    /// empty for the reference cpu model.
+    fn cache_suffix(&self) -> String;
 }
@@ -53,6 +53,10 @@ impl ComplexityModel for CpuComplexity {
     ) -> Complexity {
         sum_size as f64 * lwe_dimension.0 as f64
     }
+
+    fn cache_suffix(&self) -> String {
+        String::new()
+    }
 }
 
 impl Default for CpuComplexity {
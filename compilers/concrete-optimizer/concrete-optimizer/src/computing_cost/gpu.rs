@@ -37,31 +37,68 @@ impl GpuComplexity {
     }
 }
 
+impl GpuComplexity {
+    fn number_of_sm(&self) -> f64 {
+        self.number_of_sm.max(1) as f64
+    }
+
+    /// Number of streaming multiprocessors working on the same external product.
+    /// The amortized bootstrap spreads a batch of bootstraps on all of them, the
+    /// low latency one spreads the `(k + 1) * level` decomposed polynomials of a
+    /// single bootstrap, so an extra level only costs latency once they are all busy.
+    fn external_product_parallelism(&self, params: CmuxParameters) -> f64 {
+        match self.pbs {
+            GpuPbsComplexity::Amortized => self.number_of_sm(),
+            GpuPbsComplexity::Lowlat => {
+                let glwe_size = params.output_glwe_params.glwe_dimension as f64 + 1.;
+                let level = params.br_decomposition_parameter.level as f64;
+                (glwe_size * level).min(self.number_of_sm())
+            }
+        }
+    }
+}
+
 impl ComplexityModel for GpuComplexity {
     #[allow(clippy::let_and_return, non_snake_case)]
-    fn pbs_complexity(&self, _params: PbsParameters, _ciphertext_modulus_log: u32) -> Complexity {
-        todo!()
+    fn pbs_complexity(&self, params: PbsParameters, ciphertext_modulus_log: u32) -> Complexity {
+        params.internal_lwe_dimension.0 as f64
+            * self.cmux_complexity(params.cmux_parameters(), ciphertext_modulus_log)
     }
 
-    fn cmux_complexity(&self, _params: CmuxParameters, _ciphertext_modulus_log: u32) -> Complexity {
-        todo!()
+    #[allow(non_snake_case)]
+    fn cmux_complexity(&self, params: CmuxParameters, _ciphertext_modulus_log: u32) -> Complexity {
+        let k = params.output_glwe_params.glwe_dimension as f64;
+        let N = params.output_glwe_params.polynomial_size() as f64;
+        let ell = params.br_decomposition_parameter.level as f64;
+        algorithmic_complexity_pbs(1., k, N, ell) / self.external_product_parallelism(params)
     }
 
     #[allow(clippy::let_and_return)]
     fn ks_complexity(
         &self,
-        _params: KeyswitchParameters,
-        _ciphertext_modulus_log: u32,
+        params: KeyswitchParameters,
+        ciphertext_modulus_log: u32,
     ) -> Complexity {
-        todo!()
+        // the output coefficients are computed in parallel for both pbs types
+        let complexity = algorithmic_complexity_ks(
+            params.input_lwe_dimension.0 as f64,
+            params.output_lwe_dimension.0 as f64,
+            params.ks_decomposition_parameter.level as f64,
+            ciphertext_modulus_log as f64,
+        ) / self.number_of_sm();
+        complexity
     }
 
     fn fft_complexity(
         &self,
-        _glwe_polynomial_size: f64,
+        glwe_polynomial_size: f64,
         _ciphertext_modulus_log: u32,
     ) -> Complexity {
-        todo!()
+        let complexity = glwe_polynomial_size * (glwe_polynomial_size.log2() + 1.);
+        match self.pbs {
+            GpuPbsComplexity::Amortized => complexity / self.number_of_sm(),
+            GpuPbsComplexity::Lowlat => complexity,
+        }
     }
 
     fn levelled_complexity(
@@ -75,17 +112,33 @@ impl ComplexityModel for GpuComplexity {
 
     fn multi_bit_pbs_complexity(
         &self,
-        _params: PbsParameters,
-        _ciphertext_modulus_log: u32,
-        _grouping_factor: u32,
+        params: PbsParameters,
+        ciphertext_modulus_log: u32,
+        grouping_factor: u32,
         _jit_fft: bool,
     ) -> Complexity {
-        todo!()
+        let cmux_params = params.cmux_parameters();
+        let cmux_cost = self.cmux_complexity(cmux_params, ciphertext_modulus_log);
+        // each group of bits first sums its 2^grouping_factor GGSW into a key bundle
+        let ggsw_size = params.br_decomposition_parameter.level as f64
+            * square(params.output_glwe_params.glwe_dimension as f64 + 1.)
+            * params.output_glwe_params.polynomial_size() as f64;
+        let keybundle_cost = f64::exp2(grouping_factor as f64) * ggsw_size
+            / self.external_product_parallelism(cmux_params);
+        (params.internal_lwe_dimension.0 as f64) / (grouping_factor as f64)
+            * (cmux_cost + keybundle_cost)
+    }
+
+    fn cache_suffix(&self) -> String {
+        let pbs = match self.pbs {
+            GpuPbsComplexity::Lowlat => "lowlat",
+            GpuPbsComplexity::Amortized => "amortized",
+        };
+        format!("-gpu_{pbs}_cost-{}sm", self.number_of_sm)
     }
 }
 
 #[allow(non_snake_case)]
-#[allow(dead_code)]
 fn algorithmic_complexity_pbs(n: f64, k: f64, N: f64, ell: f64) -> f64 {
     n * (ell * (k + 1.) * N * (N.log2() + 1.)
         + (k + 1.) * N * (N.log2() + 1.)
@@ -93,7 +146,6 @@ fn algorithmic_complexity_pbs(n: f64, k: f64, N: f64, ell: f64) -> f64 {
 }
 
 #[allow(non_snake_case)]
-#[allow(dead_code)]
 fn algorithmic_complexity_ks(na: f64, nb: f64, ell: f64, log2_q: f64) -> f64 {
     na * nb * ell * log2_q
 }
@@ -822,6 +822,22 @@ impl Dag {
         !self.composition.0.is_empty()
     }
 
+    /// Returns a description of everything the optimization depends on, which is the same for the
+    /// same dag in every process. The locations are left out, not changing the optimization.
+    pub fn fingerprint(&self) -> String {
+        let mut composition: Vec<_> = self.composition.0.iter().collect();
+        composition.sort_by_key(|(to, _)| to.0);
+        format!(
+            "{:?}\n{:?}\n{:?}\n{:?}\n{:?}\n{:?}",
+            self.operators,
+            self.out_shapes,
+            self.out_precisions,
+            self.output_state,
+            self.circuit_tags,
+            composition
+        )
+    }
+
     /// Returns an iterator over the operator indices.
     pub fn get_indices_iter(&self) -> impl Iterator<Item = OperatorIndex> {
         (0..self.len()).map(OperatorIndex)
@@ -949,6 +965,26 @@ mod tests {
         assert!(!graph.get_operator(a).is_output());
     }
 
+    #[test]
+    fn fingerprint_ignores_locations() {
+        let build = |location: Location| {
+            let mut graph = Dag::new();
+            let mut builder = graph.builder("main");
+            let a = builder.add_input(1, Shape::number(), location.clone());
+            let b = builder.add_input(1, Shape::number(), location.clone());
+            let c = builder.add_dot([a, b], [1, 2], location);
+            graph.add_composition(c, a);
+            graph
+        };
+        let graph = build(Location::Unknown);
+        let located = build(Location::File("main.mlir".into()));
+        assert_eq!(graph.fingerprint(), located.fingerprint());
+
+        let mut other = build(Location::Unknown);
+        let _ = other.add_input(2, Shape::number());
+        assert_ne!(graph.fingerprint(), other.fingerprint());
+    }
+
     #[test]
     #[allow(clippy::many_single_char_names)]
     fn graph_builder() {
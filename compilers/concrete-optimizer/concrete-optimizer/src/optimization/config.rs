@@ -18,6 +18,11 @@ pub struct Config<'a> {
     pub ciphertext_modulus_log: u32,
     pub fft_precision: u32,
     pub complexity_model: &'a dyn ComplexityModel,
+    // number of threads of the multi parameters search, 0 for all the available ones
+    pub nb_threads: usize,
+    // complexity added per byte of evaluation keys by the multi parameters search, 0 to ignore the
+    // key sizes
+    pub key_size_weight: f64,
 }
 
 #[derive(Clone, Copy, Debug)]
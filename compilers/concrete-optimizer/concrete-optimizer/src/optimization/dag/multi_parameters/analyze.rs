@@ -287,6 +287,7 @@ impl VariancedDag {
         // We save the old variance to compute the diff at the end.
         let old_variances = self.variances.clone();
         let nb_partitions = self.partitions.nb_partitions;
+        let pbs_ks_partitions = self.partitions.p_cut.pbs_ks_partitions.clone();
 
         // We loop through the operators and propagate the noise.
         for operator_id in self.dag.get_indices_iter() {
@@ -305,6 +306,12 @@ impl VariancedDag {
                 .operator()
                 .operator
             {
+                // In the bootstrap-then-keyswitch order, the lut output is keyswitched
+                Operator::Lut { .. } if pbs_ks_partitions.contains(&operator_partition) => {
+                    NoiseExpression::zero()
+                        + 1.0 * bootstrap_noise(operator_partition)
+                        + 1.0 * keyswitch_noise(operator_partition, operator_partition)
+                }
                 Operator::Lut { .. } => {
                     NoiseExpression::zero() + 1.0 * bootstrap_noise(operator_partition)
                 }
@@ -412,6 +419,8 @@ pub struct AnalyzedDag {
     pub operations_count: OperationsCount,
     pub instruction_rewrite_index: Vec<Vec<OperatorIndex>>,
     pub p_cut: PartitionCut,
+    // Whether each partition bootstraps and then keyswitches, its ciphertexts being on the small key
+    pub pbs_ks_partitions: Vec<bool>,
 }
 
 pub fn analyze(
@@ -443,6 +452,14 @@ pub fn analyze(
         .into_iter()
         .reduce(Add::add)
         .unwrap();
+    let pbs_ks_partitions = PartitionIndex::range(0, varianced_dag.partitions.nb_partitions)
+        .map(|partition| {
+            varianced_dag
+                .partitions
+                .p_cut
+                .is_pbs_ks_partition(&partition)
+        })
+        .collect();
     Ok(AnalyzedDag {
         operators: varianced_dag.dag.operators,
         instruction_rewrite_index,
@@ -455,6 +472,7 @@ pub fn analyze(
         operations_count_per_instrs,
         operations_count,
         p_cut,
+        pbs_ks_partitions,
     })
 }
 
@@ -462,7 +480,14 @@ pub fn original_instrs_partition(
     dag: &AnalyzedDag,
     keys: &keys_spec::ExpandedCircuitKeys,
 ) -> Vec<keys_spec::InstructionKeys> {
-    let big_keys = &keys.big_secret_keys;
+    // The ciphertexts of a partition are on its small key in the bootstrap-then-keyswitch order
+    let ciphertext_key = |partition: PartitionIndex| {
+        if dag.pbs_ks_partitions[partition.0] {
+            keys.small_secret_keys[partition.0].identifier
+        } else {
+            keys.big_secret_keys[partition.0].identifier
+        }
+    };
     let ks_keys = &keys.keyswitch_keys;
     let pbs_keys = &keys.bootstrap_keys;
     let fks_keys = &keys.conversion_keyswitch_keys;
@@ -518,10 +543,10 @@ pub fn original_instrs_partition(
             partition.unwrap_or(dag.instrs_partition[new_instructions[0].0].instruction_partition);
         let input_partition = input_partition.unwrap_or(partition);
         let merged = keys_spec::InstructionKeys {
-            input_key: big_keys[input_partition.0].identifier,
+            input_key: ciphertext_key(input_partition),
             tlu_keyswitch_key: tlu_keyswitch_key.unwrap_or(unknown),
             tlu_bootstrap_key: tlu_bootstrap_key.unwrap_or(unknown),
-            output_key: big_keys[partition.0].identifier,
+            output_key: ciphertext_key(partition),
             extra_conversion_keys: conversion_key.iter().copied().collect(),
             tlu_circuit_bootstrap_key: keys_spec::NO_KEY_ID,
             tlu_private_functional_packing_key: keys_spec::NO_KEY_ID,
@@ -688,9 +713,15 @@ fn collect_all_variance_constraints(
                 }
             };
             let variance = variances[*input][src_partition].clone();
-            let variance = variance
-                + 1.0 * keyswitch_noise(src_partition, dst_partition)
-                + 1.0 * modulus_switching_noise(partition);
+            // In the bootstrap-then-keyswitch order, the input is already keyswitched
+            let variance = if partitions.p_cut.is_pbs_ks_partition(&dst_partition) {
+                assert!(src_partition == dst_partition);
+                variance + 1.0 * modulus_switching_noise(partition)
+            } else {
+                variance
+                    + 1.0 * keyswitch_noise(src_partition, dst_partition)
+                    + 1.0 * modulus_switching_noise(partition)
+            };
             constraints.push(variance_constraint(
                 dag,
                 noise_config,
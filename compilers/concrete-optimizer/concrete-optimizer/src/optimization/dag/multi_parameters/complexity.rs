@@ -27,26 +27,44 @@ impl fmt::Display for OperationsCount {
     }
 }
 
-/// An ensemble of costs associated with fhe operation symbols.
+/// An ensemble of costs associated with fhe operation symbols, with the size of the evaluation key
+/// each operation uses.
 #[derive(Clone, Debug)]
-pub struct ComplexityValues(SymbolArray<f64>);
+pub struct ComplexityValues {
+    costs: SymbolArray<f64>,
+    key_sizes: SymbolArray<f64>,
+}
 
 impl ComplexityValues {
     /// Returns an empty set of cost values.
     pub fn from_scheme(scheme: &SymbolScheme) -> ComplexityValues {
-        ComplexityValues(SymbolArray::from_scheme(scheme))
+        ComplexityValues {
+            costs: SymbolArray::from_scheme(scheme),
+            key_sizes: SymbolArray::from_scheme(scheme),
+        }
     }
 
-    /// Sets the cost associated with an fhe operation symbol.
+    /// Sets the cost associated with an fhe operation symbol, without a key size (e.g. for lower
+    /// bounds).
     pub fn set_cost(&mut self, source: Symbol, value: f64) {
-        self.0.set(&source, value);
+        self.set_cost_and_key_size(source, value, 0.0);
+    }
+
+    /// Sets the cost associated with an fhe operation symbol and the size in bytes of its key.
+    pub fn set_cost_and_key_size(&mut self, source: Symbol, value: f64, key_size: f64) {
+        self.costs.set(&source, value);
+        self.key_sizes.set(&source, key_size);
     }
 }
 
 /// A complexity expression is a sum of complexity terms associating operation
-/// symbols with the number of time they gets executed in the circuit.
+/// symbols with the number of time they gets executed in the circuit, plus the size of the keys of
+/// the executed operations times a weight.
 #[derive(Clone, Debug)]
-pub struct ComplexityEvaluator(SymbolArray<usize>);
+pub struct ComplexityEvaluator {
+    counts: SymbolArray<usize>,
+    key_size_weight: f64,
+}
 
 impl ComplexityEvaluator {
     /// Creates a complexity expression from a set of operation counts.
@@ -54,19 +72,68 @@ impl ComplexityEvaluator {
         scheme: &SymbolScheme,
         counts: &OperationsCount,
     ) -> ComplexityEvaluator {
-        Self(SymbolArray::from_scheme_and_map(scheme, &counts.0))
+        Self {
+            counts: SymbolArray::from_scheme_and_map(scheme, &counts.0),
+            key_size_weight: 0.0,
+        }
+    }
+
+    /// Adds the size in bytes of the keys, times `key_size_weight`, to the complexity.
+    pub fn with_key_size_weight(self, key_size_weight: f64) -> ComplexityEvaluator {
+        Self {
+            key_size_weight,
+            ..self
+        }
     }
 
     pub fn scheme(&self) -> &SymbolScheme {
-        self.0.scheme()
+        self.counts.scheme()
     }
 
     /// Evaluates the total cost expression on a set of cost values.
+    #[allow(clippy::float_cmp)]
     pub fn evaluate_total_cost(&self, costs: &ComplexityValues) -> f64 {
-        self.0
+        let operations_cost = self
+            .counts
+            .iter()
+            .zip(costs.costs.iter())
+            .fold(0.0, |acc, (n_ops, cost)| acc + (*n_ops as f64) * *cost);
+        if self.key_size_weight == 0.0 {
+            return operations_cost;
+        }
+        // only the keys of the executed operations are generated
+        let key_size = self
+            .counts
             .iter()
-            .zip(costs.0.iter())
-            .fold(0.0, |acc, (n_ops, cost)| acc + (*n_ops as f64) * *cost)
+            .zip(costs.key_sizes.iter())
+            .filter(|(n_ops, _)| **n_ops > 0)
+            .fold(0.0, |acc, (_, key_size)| acc + *key_size);
+        operations_cost + self.key_size_weight * key_size
+    }
+
+    /// Returns the cost of one operation of a symbol, with its share of the weighted key size.
+    #[allow(clippy::float_cmp)]
+    pub fn amortized_cost(&self, source: Symbol, cost: f64, key_size: f64) -> f64 {
+        let n_ops = *self.counts.get(&source);
+        if n_ops == 0 || self.key_size_weight == 0.0 {
+            return cost;
+        }
+        cost + self.key_size_weight * key_size / n_ops as f64
+    }
+
+    /// Evaluates the max amortized cost of one operation of a symbol on a set of cost values.
+    fn evaluate_max_cost(
+        &self,
+        complexity_cut: f64,
+        costs: &ComplexityValues,
+        source: Symbol,
+    ) -> f64 {
+        let actual_cost = *costs.costs.get(&source);
+        let actual_key_size = *costs.key_sizes.get(&source);
+        let coeff = *self.counts.get(&source) as f64;
+        let actual_complexity = self.evaluate_total_cost(costs)
+            - coeff * self.amortized_cost(source, actual_cost, actual_key_size);
+        (complexity_cut - actual_complexity) / coeff
     }
 
     /// Evaluates the max ks cost expression on a set of cost values.
@@ -77,11 +144,11 @@ impl ComplexityEvaluator {
         src_partition: PartitionIndex,
         dst_partition: PartitionIndex,
     ) -> f64 {
-        let actual_ks_cost = costs.0.get(&keyswitch(src_partition, dst_partition));
-        let ks_coeff = self.0.get(&keyswitch(src_partition, dst_partition));
-        let actual_complexity =
-            self.evaluate_total_cost(costs) - (*ks_coeff as f64) * actual_ks_cost;
-        (complexity_cut - actual_complexity) / (*ks_coeff as f64)
+        self.evaluate_max_cost(
+            complexity_cut,
+            costs,
+            keyswitch(src_partition, dst_partition),
+        )
     }
 
     /// Evaluates the max fks cost expression on a set of cost values.
@@ -92,10 +159,10 @@ impl ComplexityEvaluator {
         src_partition: PartitionIndex,
         dst_partition: PartitionIndex,
     ) -> f64 {
-        let actual_fks_cost = costs.0.get(&fast_keyswitch(src_partition, dst_partition));
-        let fks_coeff = self.0.get(&fast_keyswitch(src_partition, dst_partition));
-        let actual_complexity =
-            self.evaluate_total_cost(costs) - (*fks_coeff as f64) * actual_fks_cost;
-        (complexity_cut - actual_complexity) / (*fks_coeff as f64)
+        self.evaluate_max_cost(
+            complexity_cut,
+            costs,
+            fast_keyswitch(src_partition, dst_partition),
+        )
     }
 }
@@ -20,6 +20,18 @@ pub struct FksComplexityNoise {
     pub dst_glwe_param: GlweParameters,
 }
 
+impl FksComplexityNoise {
+    // size in bytes of the key, there is no key between the same glwe parameters
+    pub fn key_size(&self) -> f64 {
+        if self.src_glwe_param == self.dst_glwe_param {
+            return 0.0;
+        }
+        let in_lwe_dim = self.src_glwe_param.sample_extract_lwe_dimension();
+        let out_lwe_dim = self.dst_glwe_param.sample_extract_lwe_dimension();
+        8.0 * (in_lwe_dim * self.decomp.level) as f64 * (out_lwe_dim + 1) as f64
+    }
+}
+
 // Copy & paste from concrete-cpu
 const FFT_SCALING_WEIGHT: f64 = -2.577_224_94;
 fn fft_noise_variance_external_product_glwe(
@@ -31,6 +31,8 @@ pub struct BootstrapKey {
     pub input_key: SecretLweKey,
     pub output_key: SecretLweKey,
     pub br_decomposition_parameter: BrDecompositionParameters,
+    /* Input mask bits blind rotated at once by a multi-bit bootstrap, 0 for the classic one */
+    pub grouping_factor: u64,
     pub description: String,
 }
 
@@ -87,6 +89,7 @@ pub struct CircuitKeys {
 pub struct InstructionKeys {
     /* Describe for each instructions what is the key of inputs/outputs.
        For tlus, it gives the internal keyswitch/pbs keys.
+       A tlu whose input key is the input key of its pbs bootstraps and then keyswitches.
        It also express if the output need to be converted to other keys. */
     /* Note: Levelled instructions doesn't need to use any keys.*/
     pub input_key: SecretLweKeyId,
@@ -162,6 +165,7 @@ impl CircuitSolution {
                 level: sol.br_decomposition_level_count,
                 log2_base: sol.br_decomposition_base_log,
             },
+            grouping_factor: 0,
             description: "tlu bootstrap".into(),
         };
         let circuit_bootstrap_key = CircuitBoostrapKey {
@@ -286,6 +290,7 @@ impl CircuitSolution {
                 level: sol.br_decomposition_level_count,
                 log2_base: sol.br_decomposition_base_log,
             },
+            grouping_factor: 0,
             description: "tlu bootstrap".into(),
         };
         let instruction_keys = InstructionKeys {
@@ -379,6 +384,7 @@ impl ExpandedCircuitKeys {
                     input_key: small_secret_keys[i].clone(),
                     output_key: big_secret_keys[i].clone(),
                     br_decomposition_parameter,
+                    grouping_factor: 0,
                     description: format!("pbs[{i}]"),
                 }
             })
@@ -3,6 +3,7 @@ mod complexity;
 mod fast_keyswitch;
 mod feasible;
 pub mod keys_spec;
+pub mod multi_bit;
 pub mod optimize;
 pub mod optimize_generic;
 pub mod partition_cut;
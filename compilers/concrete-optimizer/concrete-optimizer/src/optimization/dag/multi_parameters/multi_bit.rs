@@ -0,0 +1,307 @@
+use concrete_cpu_noise_model::gaussian_noise::noise::blind_rotate::variance_blind_rotate;
+use concrete_cpu_noise_model::gaussian_noise::noise::multi_bit_blind_rotate::variance_multi_bit_blind_rotate;
+
+use crate::computing_cost::complexity_model::ComplexityModel;
+use crate::dag::operator::OperatorIndex;
+use crate::dag::unparametrized;
+use crate::optimization::config::Config;
+use crate::parameters::{BrDecompositionParameters, GlweParameters, LweDimension, PbsParameters};
+
+use super::keys_spec::{BootstrapKey, CircuitSolution, NO_KEY_ID};
+
+/// The gpu multi-bit bootstrap computes the fourier transforms of the key bundles on the fly.
+const JIT_FFT: bool = true;
+
+/// Largest grouping factor implemented by the gpu multi-bit bootstrap.
+pub const MAX_GROUPING_FACTOR: u32 = 4;
+
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct MultiBitBlindRotate {
+    pub grouping_factor: u32,
+    pub decomp: BrDecompositionParameters,
+    pub complexity: f64,
+    pub noise: f64,
+    // size in bytes of the bootstrap key, 2^grouping_factor ggsw per group of input masks
+    pub key_size: f64,
+}
+
+fn pbs_parameters(
+    in_lwe_dim: u64,
+    glwe_params: GlweParameters,
+    decomp: BrDecompositionParameters,
+) -> PbsParameters {
+    PbsParameters {
+        internal_lwe_dimension: LweDimension(in_lwe_dim),
+        br_decomposition_parameter: decomp,
+        output_glwe_params: glwe_params,
+    }
+}
+
+fn ggsw_size(glwe_params: GlweParameters, decomp: BrDecompositionParameters) -> f64 {
+    let glwe_size = (glwe_params.glwe_dimension + 1) as f64;
+    8.0 * decomp.level as f64 * glwe_size * glwe_size * glwe_params.polynomial_size() as f64
+}
+
+/// Returns the cheapest multi-bit blind rotation with `grouping_factor` whose noise does not
+/// exceed `max_noise`, trying the decompositions by increasing level.
+pub fn cheapest_multi_bit_blind_rotate(
+    complexity_model: &dyn ComplexityModel,
+    ciphertext_modulus_log: u32,
+    fft_precision: u32,
+    security_level: u64,
+    in_lwe_dim: u64,
+    glwe_params: GlweParameters,
+    grouping_factor: u32,
+    max_noise: f64,
+) -> Option<MultiBitBlindRotate> {
+    if grouping_factor < 2 || in_lwe_dim % grouping_factor as u64 != 0 {
+        return None;
+    }
+    let variance_bsk = glwe_params.minimal_variance(ciphertext_modulus_log, security_level);
+    for level in 1..=ciphertext_modulus_log as u64 {
+        let (mut log2_base, mut noise) = (0, f64::INFINITY);
+        for base in 1..=(ciphertext_modulus_log as u64 / level) {
+            let base_noise = variance_multi_bit_blind_rotate(
+                in_lwe_dim,
+                glwe_params.glwe_dimension,
+                glwe_params.polynomial_size(),
+                base,
+                level,
+                ciphertext_modulus_log,
+                fft_precision,
+                variance_bsk,
+                grouping_factor,
+                JIT_FFT,
+            );
+            if base_noise < noise {
+                (log2_base, noise) = (base, base_noise);
+            }
+        }
+        // the complexity increases with the level, the first level that fits is the cheapest
+        if noise <= max_noise {
+            let decomp = BrDecompositionParameters { level, log2_base };
+            let complexity = complexity_model.multi_bit_pbs_complexity(
+                pbs_parameters(in_lwe_dim, glwe_params, decomp),
+                ciphertext_modulus_log,
+                grouping_factor,
+                JIT_FFT,
+            );
+            let nb_groups = (in_lwe_dim / grouping_factor as u64) as f64;
+            let ggsw_per_group = f64::exp2(grouping_factor as f64);
+            return Some(MultiBitBlindRotate {
+                grouping_factor,
+                decomp,
+                complexity,
+                noise,
+                key_size: nb_groups * ggsw_per_group * ggsw_size(glwe_params, decomp),
+            });
+        }
+    }
+    None
+}
+
+// input lwe dimension and output glwe parameters of a bootstrap key
+fn key_dimensions(key: &BootstrapKey) -> (u64, GlweParameters) {
+    let in_lwe_dim = key.input_key.polynomial_size * key.input_key.glwe_dimension;
+    let glwe_params = GlweParameters {
+        log2_polynomial_size: key.output_key.polynomial_size.ilog2() as u64,
+        glwe_dimension: key.output_key.glwe_dimension,
+    };
+    (in_lwe_dim, glwe_params)
+}
+
+fn classic_pbs_complexity(config: Config, key: &BootstrapKey) -> f64 {
+    let (in_lwe_dim, glwe_params) = key_dimensions(key);
+    config.complexity_model.pbs_complexity(
+        pbs_parameters(in_lwe_dim, glwe_params, key.br_decomposition_parameter),
+        config.ciphertext_modulus_log,
+    )
+}
+
+/// Returns the multi-bit blind rotation replacing the classic blind rotation of `key` at the
+/// lowest cost for `nb_pbs` bootstraps, without adding noise, or None if the classic one is the
+/// cheapest.
+pub fn multi_bit_replacement(
+    config: Config,
+    key: &BootstrapKey,
+    nb_pbs: u64,
+    max_grouping_factor: u32,
+) -> Option<MultiBitBlindRotate> {
+    let (in_lwe_dim, glwe_params) = key_dimensions(key);
+    let decomp = key.br_decomposition_parameter;
+    let variance_bsk =
+        glwe_params.minimal_variance(config.ciphertext_modulus_log, config.security_level);
+    let classic_noise = variance_blind_rotate(
+        in_lwe_dim,
+        glwe_params.glwe_dimension,
+        glwe_params.polynomial_size(),
+        decomp.log2_base,
+        decomp.level,
+        config.ciphertext_modulus_log,
+        config.fft_precision,
+        variance_bsk,
+    );
+    let cost = |complexity: f64, key_size: f64| {
+        nb_pbs as f64 * complexity + config.key_size_weight * key_size
+    };
+    let classic_cost = cost(
+        classic_pbs_complexity(config, key),
+        in_lwe_dim as f64 * ggsw_size(glwe_params, decomp),
+    );
+    (2..=max_grouping_factor.min(MAX_GROUPING_FACTOR))
+        .filter_map(|grouping_factor| {
+            cheapest_multi_bit_blind_rotate(
+                config.complexity_model,
+                config.ciphertext_modulus_log,
+                config.fft_precision,
+                config.security_level,
+                in_lwe_dim,
+                glwe_params,
+                grouping_factor,
+                classic_noise,
+            )
+        })
+        .filter(|multi_bit| cost(multi_bit.complexity, multi_bit.key_size) < classic_cost)
+        .min_by(|a, b| cost(a.complexity, a.key_size).total_cmp(&cost(b.complexity, b.key_size)))
+}
+
+/// Replaces the classic bootstrap keys of a native solution by multi-bit ones when it lowers the
+/// complexity of the circuit, keeping its noise, and so its error probability, unchanged.
+pub fn use_multi_bit_bootstraps(
+    sol: &mut CircuitSolution,
+    dag: &unparametrized::Dag,
+    config: Config,
+    max_grouping_factor: u32,
+) {
+    if max_grouping_factor < 2
+        || !sol.is_feasible
+        || !sol.circuit_keys.circuit_bootstrap_keys.is_empty()
+    {
+        return;
+    }
+    let mut nb_pbs = vec![0; sol.circuit_keys.bootstrap_keys.len()];
+    for (i, instruction_keys) in sol.instructions_keys.iter().enumerate() {
+        if instruction_keys.tlu_bootstrap_key != NO_KEY_ID {
+            nb_pbs[instruction_keys.tlu_bootstrap_key as usize] +=
+                dag.get_operator(OperatorIndex(i)).shape.flat_size();
+        }
+    }
+    for (key, nb_pbs) in sol.circuit_keys.bootstrap_keys.iter_mut().zip(nb_pbs) {
+        if nb_pbs == 0 {
+            continue;
+        }
+        if let Some(multi_bit) = multi_bit_replacement(config, key, nb_pbs, max_grouping_factor) {
+            sol.complexity +=
+                nb_pbs as f64 * (multi_bit.complexity - classic_pbs_complexity(config, key));
+            key.br_decomposition_parameter = multi_bit.decomp;
+            key.grouping_factor = multi_bit.grouping_factor as u64;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::computing_cost::gpu::GpuComplexity;
+    use crate::optimization::dag::multi_parameters::keys_spec::SecretLweKey;
+
+    fn config(complexity_model: &dyn ComplexityModel) -> Config<'_> {
+        Config {
+            security_level: 128,
+            maximum_acceptable_error_probability: 1.0 / 100000.0,
+            key_sharing: true,
+            ciphertext_modulus_log: 64,
+            fft_precision: 53,
+            complexity_model,
+            nb_threads: 1,
+            key_size_weight: 0.0,
+        }
+    }
+
+    fn bootstrap_key(in_lwe_dim: u64) -> BootstrapKey {
+        BootstrapKey {
+            identifier: 0,
+            input_key: SecretLweKey {
+                identifier: 1,
+                polynomial_size: in_lwe_dim,
+                glwe_dimension: 1,
+                description: "small".into(),
+            },
+            output_key: SecretLweKey {
+                identifier: 0,
+                polynomial_size: 2048,
+                glwe_dimension: 1,
+                description: "big".into(),
+            },
+            br_decomposition_parameter: BrDecompositionParameters {
+                level: 1,
+                log2_base: 23,
+            },
+            grouping_factor: 0,
+            description: "pbs".into(),
+        }
+    }
+
+    #[test]
+    fn multi_bit_is_cheaper_without_adding_noise() {
+        let complexity_model = GpuComplexity::default_amortized_u64(108);
+        let config = config(&complexity_model);
+        let key = bootstrap_key(840);
+        for grouping_factor in 2..=MAX_GROUPING_FACTOR {
+            let classic_noise = variance_blind_rotate(
+                840,
+                1,
+                2048,
+                23,
+                1,
+                config.ciphertext_modulus_log,
+                config.fft_precision,
+                GlweParameters {
+                    log2_polynomial_size: 11,
+                    glwe_dimension: 1,
+                }
+                .minimal_variance(config.ciphertext_modulus_log, config.security_level),
+            );
+            let multi_bit = cheapest_multi_bit_blind_rotate(
+                config.complexity_model,
+                config.ciphertext_modulus_log,
+                config.fft_precision,
+                config.security_level,
+                840,
+                GlweParameters {
+                    log2_polynomial_size: 11,
+                    glwe_dimension: 1,
+                },
+                grouping_factor,
+                classic_noise,
+            )
+            .unwrap();
+            assert!(multi_bit.noise <= classic_noise);
+            assert_eq!(multi_bit.grouping_factor, grouping_factor);
+        }
+        let multi_bit = multi_bit_replacement(config, &key, 1000, MAX_GROUPING_FACTOR).unwrap();
+        // the key bundles of 2^4 ggsw cost more than the 3 bits they blind rotate at once
+        assert_eq!(multi_bit.grouping_factor, 3);
+    }
+
+    #[test]
+    fn grouping_factor_divides_the_input_dimension() {
+        let complexity_model = GpuComplexity::default_amortized_u64(108);
+        let config = config(&complexity_model);
+        // 841 is not a multiple of any grouping factor but 29 x 29
+        assert_eq!(
+            multi_bit_replacement(config, &bootstrap_key(841), 1000, MAX_GROUPING_FACTOR),
+            None
+        );
+    }
+
+    #[test]
+    fn max_grouping_factor_one_keeps_the_classic_bootstrap() {
+        let complexity_model = GpuComplexity::default_amortized_u64(108);
+        let config = config(&complexity_model);
+        assert_eq!(
+            multi_bit_replacement(config, &bootstrap_key(840), 1000, 1),
+            None
+        );
+    }
+}
@@ -1,5 +1,6 @@
 // OPT: cache for fks and verified pareto
 use concrete_cpu_noise_model::gaussian_noise::noise::modulus_switching::estimate_modulus_switching_noise_with_binary_key;
+use concrete_security_curves::gaussian::security::minimal_variance_lwe;
 
 use crate::dag::unparametrized::Dag;
 use crate::noise_estimator::error;
@@ -8,7 +9,9 @@ use crate::optimization::config::{Config, NoiseBoundConfig, SearchSpace};
 use crate::optimization::dag::multi_parameters::analyze::{analyze, AnalyzedDag};
 use crate::optimization::dag::multi_parameters::fast_keyswitch;
 use crate::optimization::dag::multi_parameters::fast_keyswitch::FksComplexityNoise;
-use crate::optimization::dag::solo_key::analyze::lut_count_from_dag;
+use crate::optimization::dag::solo_key::analyze::{
+    has_round, lut_count_from_dag, op_levelled_complexity,
+};
 use crate::optimization::dag::solo_key::optimize::optimize as optimize_mono;
 use crate::optimization::decomposition::cmux::CmuxComplexityNoise;
 use crate::optimization::decomposition::keyswitch::KsComplexityNoise;
@@ -18,7 +21,7 @@ use crate::parameters::GlweParameters;
 use crate::optimization::dag::multi_parameters::complexity::ComplexityEvaluator;
 use crate::optimization::dag::multi_parameters::feasible::Feasible;
 use crate::optimization::dag::multi_parameters::partition_cut::PartitionCut;
-use crate::optimization::dag::multi_parameters::partitions::PartitionIndex;
+use crate::optimization::dag::multi_parameters::partitions::{PartitionIndex, Transition};
 use crate::optimization::dag::multi_parameters::{analyze, keys_spec};
 
 use super::complexity::ComplexityValues;
@@ -110,14 +113,19 @@ fn optimize_1_ks(
         // variance is decreasing, complexity is increasing
         let ks_cost = ks_quantity.complexity(ks_input_lwe_dim);
         let ks_variance = ks_quantity.noise(ks_input_lwe_dim);
-        if ks_cost > ks_max_cost {
+        let ks_key_size =
+            ks_quantity.key_size(ks_input_lwe_dim, macro_parameters[ks_dst.0].internal_dim);
+        if complexity.amortized_cost(keyswitch(ks_src, ks_dst), ks_cost, ks_key_size) > ks_max_cost
+        {
             return None;
         }
         if ks_variance <= ks_max_variance {
             operations
                 .variance
                 .set_variance(keyswitch_noise(ks_src, ks_dst), ks_variance);
-            operations.cost.set_cost(keyswitch(ks_src, ks_dst), ks_cost);
+            operations
+                .cost
+                .set_cost_and_key_size(keyswitch(ks_src, ks_dst), ks_cost, ks_key_size);
             return Some(ks_quantity);
         }
     }
@@ -260,8 +268,14 @@ fn optimize_1_fks_and_all_compatible_ks(
             }
         };
 
-        if fks_quantity.complexity > fks_max_cost {
-            // complexity is strictly increasing by level
+        let fks_key_size = fks_quantity.key_size();
+        if complexity.amortized_cost(
+            fast_keyswitch(fks_src, fks_dst),
+            fks_quantity.complexity,
+            fks_key_size,
+        ) > fks_max_cost
+        {
+            // complexity and key size are strictly increasing by level
             // next complexity will be worse
             return best_sol;
         }
@@ -270,9 +284,11 @@ fn optimize_1_fks_and_all_compatible_ks(
             continue;
         }
 
-        operations
-            .cost
-            .set_cost(fast_keyswitch(fks_src, fks_dst), fks_quantity.complexity);
+        operations.cost.set_cost_and_key_size(
+            fast_keyswitch(fks_src, fks_dst),
+            fks_quantity.complexity,
+            fks_key_size,
+        );
         operations
             .variance
             .set_variance(fast_keyswitch_noise(fks_src, fks_dst), fks_quantity.noise);
@@ -412,7 +428,13 @@ fn optimize_1_cmux_and_dst_exclusive_fks_subset_and_all_ks(
 
         // Lower bounds cuts
         let pbs_cost = cmux_quantity.complexity_br(macro_param_partition.internal_dim);
-        operations.cost.set_cost(bootstrap(partition), pbs_cost);
+        let pbs_key_size = cmux_quantity.key_size_br(
+            macro_param_partition.glwe_params,
+            macro_param_partition.internal_dim,
+        );
+        operations
+            .cost
+            .set_cost_and_key_size(bootstrap(partition), pbs_cost, pbs_key_size);
         let lower_cost = complexity.evaluate_total_cost(&operations.cost);
         if lower_cost > best_sol_complexity {
             continue;
@@ -543,9 +565,11 @@ fn apply_fks_variance_and_cost_or_lower_bound(
                     operations
                         .variance
                         .set_variance(fast_keyswitch_noise(src, dst), this_fks.noise);
-                    operations
-                        .cost
-                        .set_cost(fast_keyswitch(src, dst), this_fks.complexity);
+                    operations.cost.set_cost_and_key_size(
+                        fast_keyswitch(src, dst),
+                        this_fks.complexity,
+                        this_fks.key_size(),
+                    );
                 }
                 continue;
             }
@@ -588,26 +612,37 @@ fn apply_partitions_input_and_modulus_variance_and_cost(
     security_level: u64,
     nb_partitions: usize,
     macro_parameters: &[MacroParameters],
+    pbs_ks_partitions: &[bool],
     partition: PartitionIndex,
     input_variance: f64,
     variance_modulus_switching: f64,
     operations: &mut OperationsCV,
 ) {
     for i in PartitionIndex::range(0, nb_partitions) {
-        let (input_variance, variance_modulus_switching) =
-            if macro_parameters[i.0] == macro_parameters[partition.0] {
-                (input_variance, variance_modulus_switching)
-            } else {
-                let input_variance = macro_parameters[i.0]
-                    .glwe_params
-                    .minimal_variance(ciphertext_modulus_log, security_level);
-                let variance_modulus_switching = estimate_modulus_switching_noise_with_binary_key(
-                    macro_parameters[i.0].internal_dim,
-                    macro_parameters[i.0].glwe_params.log2_polynomial_size,
-                    ciphertext_modulus_log,
-                );
-                (input_variance, variance_modulus_switching)
-            };
+        let (input_variance, variance_modulus_switching) = if pbs_ks_partitions[i.0] {
+            // the inputs are encrypted on the small key
+            let internal_dim = macro_parameters[i.0].internal_dim;
+            let input_variance =
+                minimal_variance_lwe(internal_dim, ciphertext_modulus_log, security_level);
+            let variance_modulus_switching = estimate_modulus_switching_noise_with_binary_key(
+                internal_dim,
+                macro_parameters[i.0].glwe_params.log2_polynomial_size,
+                ciphertext_modulus_log,
+            );
+            (input_variance, variance_modulus_switching)
+        } else if macro_parameters[i.0] == macro_parameters[partition.0] {
+            (input_variance, variance_modulus_switching)
+        } else {
+            let input_variance = macro_parameters[i.0]
+                .glwe_params
+                .minimal_variance(ciphertext_modulus_log, security_level);
+            let variance_modulus_switching = estimate_modulus_switching_noise_with_binary_key(
+                macro_parameters[i.0].internal_dim,
+                macro_parameters[i.0].glwe_params.log2_polynomial_size,
+                ciphertext_modulus_log,
+            );
+            (input_variance, variance_modulus_switching)
+        };
         operations
             .variance
             .set_variance(input_noise(i), input_variance);
@@ -630,12 +665,15 @@ fn apply_pbs_variance_and_cost_or_lower_bounds(
         let this_pbs = if i == partition { &None } else { this_pbs };
         if let Some(this_pbs) = this_pbs {
             let internal_dim = macro_parameters[i.0].internal_dim;
+            let glwe_params = macro_parameters[i.0].glwe_params;
             operations
                 .variance
                 .set_variance(bootstrap_noise(i), this_pbs.noise_br(internal_dim));
-            operations
-                .cost
-                .set_cost(bootstrap(i), this_pbs.complexity_br(internal_dim));
+            operations.cost.set_cost_and_key_size(
+                bootstrap(i),
+                this_pbs.complexity_br(internal_dim),
+                this_pbs.key_size_br(glwe_params, internal_dim),
+            );
         } else {
             // OPT: Most values could be shared on first optimize_macro
             let in_internal_dim = macro_parameters[i.0].internal_dim;
@@ -699,6 +737,33 @@ fn fks_to_optimize(
 // In case fast ks are not used
 pub const REAL_FAST_KS: bool = false;
 
+/// The best parameters found so far by the search of the macro parameters of a partition.
+#[derive(Clone)]
+struct MacroSearch {
+    best_parameters: Parameters,
+    best_complexity: f64,
+    best_p_error: f64,
+    best_partition_p_error: f64,
+    lb_message: Option<&'static str>,
+}
+
+impl MacroSearch {
+    /// Keeps the best parameters of the two searches, `other` having searched parameters after the
+    /// ones of `self`.
+    fn merge(&mut self, other: Self) {
+        let other_is_better = if other.best_parameters.is_feasible.is_feasible() {
+            !self.best_parameters.is_feasible.is_feasible()
+                || other.best_complexity < self.best_complexity
+        } else {
+            !self.best_parameters.is_feasible.is_feasible()
+                && other.best_partition_p_error < self.best_partition_p_error
+        };
+        if other_is_better {
+            *self = other;
+        }
+    }
+}
+
 #[allow(clippy::cognitive_complexity)]
 #[allow(clippy::too_many_lines)]
 fn optimize_macro(
@@ -710,9 +775,10 @@ fn optimize_macro(
     partition: PartitionIndex,
     used_tlu_keyswitch: &[Vec<bool>],
     used_conversion_keyswitch: &[Vec<bool>],
+    pbs_ks_partitions: &[bool],
     feasible: &Feasible,
     complexity: &ComplexityEvaluator,
-    caches: &mut DecompCaches,
+    caches: &mut [DecompCaches],
     init_parameters: &Parameters,
     best_complexity: f64,
     best_p_error: f64,
@@ -728,11 +794,6 @@ fn optimize_macro(
         )
     };
 
-    let mut best_parameters = init_parameters.clone();
-    let mut best_complexity = best_complexity;
-    let mut best_p_error = best_p_error;
-    let mut best_partition_p_error = f64::INFINITY;
-
     let fks_to_optimize = fks_to_optimize(nb_partitions, used_conversion_keyswitch, partition);
     let operations = OperationsCV {
         variance: NoiseValues::from_scheme(complexity.scheme()),
@@ -740,14 +801,19 @@ fn optimize_macro(
     };
     let partition_feasible = feasible.filter_constraints(partition);
 
-    let glwe_params_domain = search_space.glwe_dimensions.iter().flat_map(|a| {
-        search_space
-            .glwe_log_polynomial_sizes
-            .iter()
-            .map(|b| (*a, *b))
-    });
-    let mut lb_message = None;
-    for (glwe_dimension, log2_polynomial_size) in glwe_params_domain {
+    let glwe_params_domain: Vec<(u64, u64)> = search_space
+        .glwe_dimensions
+        .iter()
+        .flat_map(|a| {
+            search_space
+                .glwe_log_polynomial_sizes
+                .iter()
+                .map(|b| (*a, *b))
+        })
+        .collect();
+    let search_glwe = |(glwe_dimension, log2_polynomial_size): (u64, u64),
+                       caches: &mut DecompCaches,
+                       search: &mut MacroSearch| {
         if !search_space_restriction.is_available_glwe(
             partition,
             GlweParameters {
@@ -756,7 +822,7 @@ fn optimize_macro(
             },
         ) {
             // No parameters with these macro parameters are available in the search space.
-            continue;
+            return;
         }
         let glwe_params = GlweParameters {
             log2_polynomial_size,
@@ -767,7 +833,7 @@ fn optimize_macro(
         if glwe_dimension == 1 && log2_polynomial_size == 8 {
             // this is insecure and so minimal variance will be above 1
             assert!(input_variance > 1.0);
-            continue;
+            return;
         }
 
         for &internal_dim in &search_space.internal_lwe_dimensions {
@@ -808,20 +874,26 @@ fn optimize_macro(
                 security_level,
                 nb_partitions,
                 &macros,
+                pbs_ks_partitions,
                 partition,
                 input_variance,
                 variance_modulus_switching,
                 &mut operations,
             );
 
-            if best_parameters.is_feasible.is_feasible() && !feasible.feasible(&operations.variance)
+            if search.best_parameters.is_feasible.is_feasible()
+                && !feasible.feasible(&operations.variance)
             {
                 // noise_modulus_switching is increasing with internal_dim so we can cut
                 // but as long as nothing feasible as been found we don't break to improve feasibility
+                // the input noise on the small key is decreasing with internal_dim, so we can't cut
+                if pbs_ks_partitions[partition.0] {
+                    continue;
+                }
                 break;
             }
 
-            if complexity.evaluate_total_cost(&operations.cost) > best_complexity {
+            if complexity.evaluate_total_cost(&operations.cost) > search.best_complexity {
                 continue;
             }
 
@@ -857,18 +929,18 @@ fn optimize_macro(
             );
 
             let non_feasible = !feasible.feasible(&operations.variance);
-            if best_parameters.is_feasible.is_feasible() && non_feasible {
+            if search.best_parameters.is_feasible.is_feasible() && non_feasible {
                 continue;
             }
 
-            if complexity.evaluate_total_cost(&operations.cost) > best_complexity {
+            if complexity.evaluate_total_cost(&operations.cost) > search.best_complexity {
                 continue;
             }
 
             let cmux_pareto = caches.cmux.pareto_quantities(glwe_params);
 
             if non_feasible {
-                lb_message = Some("Non feasible");
+                search.lb_message = Some("Non feasible");
                 // here we optimize for feasibility only
                 // if nothing is feasible, it will give improves feasability for later iterations
                 let mut macro_params = init_parameters.macro_params.clone();
@@ -881,10 +953,10 @@ fn optimize_macro(
                 let complexity = f64::INFINITY;
                 let cmux_params = cmux::lowest_noise(cmux_pareto);
                 let partition_p_error = partition_feasible.p_error(&operations.variance);
-                if partition_p_error >= best_partition_p_error {
+                if partition_p_error >= search.best_partition_p_error {
                     continue;
                 }
-                best_partition_p_error = partition_p_error;
+                search.best_partition_p_error = partition_p_error;
                 let (_, _, worst_constraint) = feasible.worst_constraint(&operations.variance);
                 let p_error = feasible.p_error(&operations.variance);
                 let global_p_error = feasible.global_p_error(&operations.variance);
@@ -895,7 +967,7 @@ fn optimize_macro(
                     ks: vec![vec![None; nb_partitions]; nb_partitions],
                     fks: vec![vec![None; nb_partitions]; nb_partitions],
                 };
-                best_parameters = Parameters {
+                search.best_parameters = Parameters {
                     p_error,
                     global_p_error,
                     complexity,
@@ -907,7 +979,7 @@ fn optimize_macro(
                 continue;
             }
 
-            if complexity.evaluate_total_cost(&operations.cost) > best_complexity {
+            if complexity.evaluate_total_cost(&operations.cost) > search.best_complexity {
                 continue;
             }
 
@@ -923,8 +995,8 @@ fn optimize_macro(
                 feasible,
                 complexity,
                 &mut caches.keyswitch,
-                best_complexity,
-                best_p_error,
+                search.best_complexity,
+                search.best_p_error,
                 ciphertext_modulus_log,
                 fft_precision,
             );
@@ -932,12 +1004,12 @@ fn optimize_macro(
                 // erase macros and all fks that can't be real
                 // set global is_lower_bound here, if any parameter is missing this is lower bound
                 // optimize_micro has already checked for best-ness
-                lb_message = None;
+                search.lb_message = None;
                 let mut macro_params = init_parameters.macro_params.clone();
                 macro_params[partition.0] = Some(macro_param_partition);
                 let mut is_lower_bound = macro_params.iter().any(Option::is_none);
                 if is_lower_bound {
-                    lb_message = Some("is_lower_bound due to missing macro parameter");
+                    search.lb_message = Some("is_lower_bound due to missing macro parameter");
                 }
                 // copy back pbs from other partition
                 let mut all_pbs = init_parameters.micro_params.pbs.clone();
@@ -959,7 +1031,8 @@ fn optimize_macro(
                     }
                     let fks = &all_fks[src_partition.0][dst_partition.0];
                     if !is_lower_bound && fks.is_none() {
-                        lb_message = Some("is_lower_bound due to missing fast keyswitch parameter");
+                        search.lb_message =
+                            Some("is_lower_bound due to missing fast keyswitch parameter");
                         is_lower_bound = true;
                     }
                     let src_glwe_param = macro_params[src_partition.0].map(|p| p.glwe_params);
@@ -970,7 +1043,8 @@ fn optimize_macro(
                         continue;
                     }
                     if !is_lower_bound {
-                        lb_message = Some("is_lower_bound due to changing others fks macro param");
+                        search.lb_message =
+                            Some("is_lower_bound due to changing others fks macro param");
                     }
                     all_fks[src_partition.0][dst_partition.0] = None;
                     is_lower_bound = true;
@@ -980,12 +1054,12 @@ fn optimize_macro(
                     ks: some_micro_params.ks,
                     fks: all_fks,
                 };
-                best_complexity = some_micro_params.complexity;
-                best_p_error = some_micro_params.p_error;
-                best_parameters = Parameters {
-                    p_error: best_p_error,
+                search.best_complexity = some_micro_params.complexity;
+                search.best_p_error = some_micro_params.p_error;
+                search.best_parameters = Parameters {
+                    p_error: search.best_p_error,
                     global_p_error: some_micro_params.global_p_error,
-                    complexity: best_complexity,
+                    complexity: search.best_complexity,
                     micro_params,
                     macro_params,
                     is_lower_bound,
@@ -993,11 +1067,57 @@ fn optimize_macro(
                 };
             }
         }
+    };
+
+    let initial_search = MacroSearch {
+        best_parameters: init_parameters.clone(),
+        best_complexity,
+        best_p_error,
+        best_partition_p_error: f64::INFINITY,
+        lb_message: None,
+    };
+    let nb_threads = caches.len().min(glwe_params_domain.len()).max(1);
+    let search = if nb_threads == 1 {
+        let mut search = initial_search;
+        for &glwe in &glwe_params_domain {
+            search_glwe(glwe, &mut caches[0], &mut search);
+        }
+        search
+    } else {
+        // Each thread searches one glwe parameters out of nb_threads with its own caches, and the
+        // searches are merged in the order of the threads, not to depend on their scheduling
+        let searches: Vec<MacroSearch> = std::thread::scope(|scope| {
+            let search_glwe = &search_glwe;
+            let glwe_params_domain = &glwe_params_domain;
+            let handles: Vec<_> = caches[..nb_threads]
+                .iter_mut()
+                .enumerate()
+                .map(|(thread, caches)| {
+                    let mut search = initial_search.clone();
+                    scope.spawn(move || {
+                        for &glwe in glwe_params_domain.iter().skip(thread).step_by(nb_threads) {
+                            search_glwe(glwe, caches, &mut search);
+                        }
+                        search
+                    })
+                })
+                .collect();
+            handles
+                .into_iter()
+                .map(|handle| handle.join().unwrap())
+                .collect()
+        });
+        let mut searches = searches.into_iter();
+        let mut search = searches.next().unwrap();
+        for other in searches {
+            search.merge(other);
+        }
+        search
+    };
+    if DEBUG && search.lb_message.is_some() {
+        eprintln!("{}", search.lb_message.unwrap());
     }
-    if DEBUG && lb_message.is_some() {
-        eprintln!("{}", lb_message.unwrap());
-    }
-    best_parameters
+    search.best_parameters
 }
 
 fn cross_partition(nb_partitions: usize) -> impl Iterator<Item = (PartitionIndex, PartitionIndex)> {
@@ -1032,7 +1152,14 @@ pub fn optimize(
     let kappa =
         error::sigma_scale_of_error_probability(config.maximum_acceptable_error_probability);
 
-    let mut caches = persistent_caches.caches();
+    // The threads of the search each use their own caches
+    let nb_threads = match config.nb_threads {
+        0 => std::thread::available_parallelism().map_or(1, std::num::NonZeroUsize::get),
+        nb_threads => nb_threads,
+    };
+    let mut caches: Vec<DecompCaches> = (0..nb_threads)
+        .map(|_| persistent_caches.caches())
+        .collect();
 
     let scheme = SymbolScheme::new(dag.nb_partitions);
 
@@ -1041,7 +1168,8 @@ pub fn optimize(
         .for_each(|c| c.init_evaluator(&scheme));
     let feasible = Feasible::of(&dag.variance_constraints, kappa, None);
 
-    let complexity = ComplexityEvaluator::from_scheme_and_counts(&scheme, &dag.operations_count);
+    let complexity = ComplexityEvaluator::from_scheme_and_counts(&scheme, &dag.operations_count)
+        .with_key_size_weight(config.key_size_weight);
     let used_tlu_keyswitch = used_tlu_keyswitch(&dag);
     let used_conversion_keyswitch = used_conversion_keyswitch(&dag);
 
@@ -1083,6 +1211,7 @@ pub fn optimize(
                         partition,
                         &used_tlu_keyswitch,
                         &used_conversion_keyswitch,
+                        &dag.pbs_ks_partitions,
                         &feasible,
                         &complexity,
                         &mut caches,
@@ -1100,6 +1229,7 @@ pub fn optimize(
                     partition,
                     &used_tlu_keyswitch,
                     &used_conversion_keyswitch,
+                    &dag.pbs_ks_partitions,
                     &feasible,
                     &complexity,
                     &mut caches,
@@ -1183,6 +1313,7 @@ pub fn optimize(
         &best_params,
         &used_conversion_keyswitch,
         &used_tlu_keyswitch,
+        &dag.pbs_ks_partitions,
         ciphertext_modulus_log,
         security_level,
         &feasible,
@@ -1230,6 +1361,7 @@ fn sanity_check(
     params: &Parameters,
     used_conversion_keyswitch: &[Vec<bool>],
     used_tlu_keyswitch: &[Vec<bool>],
+    pbs_ks_partitions: &[bool],
     ciphertext_modulus_log: u32,
     security_level: u64,
     feasible: &Feasible,
@@ -1250,7 +1382,11 @@ fn sanity_check(
         let partition_macro = params.macro_params[partition.0].unwrap();
         let glwe_param = partition_macro.glwe_params;
         let internal_dim = partition_macro.internal_dim;
-        let input_variance = glwe_param.minimal_variance(ciphertext_modulus_log, security_level);
+        let input_variance = if pbs_ks_partitions[partition.0] {
+            minimal_variance_lwe(internal_dim, ciphertext_modulus_log, security_level)
+        } else {
+            glwe_param.minimal_variance(ciphertext_modulus_log, security_level)
+        };
         let variance_modulus_switching = estimate_modulus_switching_noise_with_binary_key(
             internal_dim,
             glwe_param.log2_polynomial_size,
@@ -1267,9 +1403,11 @@ fn sanity_check(
             operations
                 .variance
                 .set_variance(bootstrap_noise(partition), this_pbs.noise_br(internal_dim));
-            operations
-                .cost
-                .set_cost(bootstrap(partition), this_pbs.complexity_br(internal_dim));
+            operations.cost.set_cost_and_key_size(
+                bootstrap(partition),
+                this_pbs.complexity_br(internal_dim),
+                this_pbs.key_size_br(glwe_param, internal_dim),
+            );
         } else {
             operations
                 .variance
@@ -1289,9 +1427,10 @@ fn sanity_check(
                     keyswitch_noise(src_partition, partition),
                     this_ks.noise(src_lwe_dim),
                 );
-                operations.cost.set_cost(
+                operations.cost.set_cost_and_key_size(
                     keyswitch(src_partition, partition),
                     this_ks.complexity(src_lwe_dim),
+                    this_ks.key_size(src_lwe_dim, internal_dim),
                 );
             } else {
                 assert!(
@@ -1314,9 +1453,10 @@ fn sanity_check(
                     fast_keyswitch_noise(src_partition, partition),
                     this_fks.noise,
                 );
-                operations.cost.set_cost(
+                operations.cost.set_cost_and_key_size(
                     fast_keyswitch(src_partition, partition),
                     this_fks.complexity,
+                    this_fks.key_size(),
                 );
             } else {
                 assert!(
@@ -1341,6 +1481,179 @@ fn sanity_check(
     }
 }
 
+/// Searches the partitions minimizing the complexity of the dag, starting from `p_cut`.
+/// Two adjacent internal partitions are merged, one cut at a time, as long as the complexity of the
+/// optimized parameters stays within `max_complexity_increase` (relative) of the lowest one found.
+/// Merging saves the keyswitches between the partitions and their keys, splitting lets the low
+/// precision luts use cheaper bootstraps.
+/// The partitions are shared by all the circuits of the dag, so a merge also reuses parameters and
+/// keys across circuits.
+pub fn search_partition_cut(
+    dag: &Dag,
+    config: Config,
+    search_space: &SearchSpace,
+    search_space_restriction: &impl SearchSpaceRestriction,
+    persistent_caches: &PersistDecompCaches,
+    p_cut: PartitionCut,
+    max_complexity_increase: f64,
+) -> PartitionCut {
+    let complexity_of = |p_cut: &PartitionCut| {
+        optimize(
+            dag,
+            config,
+            search_space,
+            search_space_restriction,
+            persistent_caches,
+            &Some(p_cut.clone()),
+            PartitionIndex::FIRST,
+        )
+        .map_or(f64::INFINITY, |(_, params)| params.complexity)
+    };
+    let mut best_p_cut = p_cut;
+    let mut complexity = complexity_of(&best_p_cut);
+    let mut lowest_complexity = complexity;
+    loop {
+        let mut best_merge: Option<(f64, PartitionCut)> = None;
+        for i in 0..best_p_cut.p_cut.len() {
+            let merged = best_p_cut.merge_with_next(i);
+            let merged_complexity = complexity_of(&merged);
+            // on a tie, less partitions are better
+            if best_merge
+                .as_ref()
+                .map_or(true, |merge| merged_complexity <= merge.0)
+            {
+                best_merge = Some((merged_complexity, merged));
+            }
+        }
+        let (merged_complexity, merged) = match best_merge {
+            Some(best_merge) => best_merge,
+            None => break,
+        };
+        let max_complexity = lowest_complexity * (1.0 + max_complexity_increase.max(0.0));
+        if merged_complexity == f64::INFINITY || merged_complexity > max_complexity {
+            break;
+        }
+        if DEBUG {
+            eprintln!("Merged partitions, complexity {complexity} -> {merged_complexity}");
+        }
+        complexity = merged_complexity;
+        lowest_complexity = lowest_complexity.min(complexity);
+        best_p_cut = merged;
+    }
+    best_p_cut
+}
+
+// The complexity of the levelled operations, on the big key of their partition or on its small key
+// in the bootstrap-then-keyswitch order
+fn levelled_complexity(dag: &Dag, analyzed: &AnalyzedDag, params: &Parameters) -> f64 {
+    assert!(dag.operators.len() == analyzed.instrs_partition.len());
+    dag.operators
+        .iter()
+        .zip(&analyzed.instrs_partition)
+        .map(|(op, instr_partition)| {
+            let partition = instr_partition.instruction_partition;
+            let macro_params = params.macro_params[partition.0].unwrap();
+            let lwe_dimension = if analyzed.pbs_ks_partitions[partition.0] {
+                macro_params.internal_dim
+            } else {
+                macro_params.glwe_params.sample_extract_lwe_dimension()
+            };
+            op_levelled_complexity(op, &dag.out_shapes).cost(lwe_dimension)
+        })
+        .sum()
+}
+
+// Whether no value goes from or to the partition through a keyswitch or a fast keyswitch
+fn is_isolated_partition(analyzed: &AnalyzedDag, partition: PartitionIndex) -> bool {
+    analyzed.instrs_partition.iter().all(|instr_partition| {
+        if instr_partition.instruction_partition == partition {
+            instr_partition
+                .inputs_transition
+                .iter()
+                .all(Option::is_none)
+                && instr_partition.alternative_output_representation.is_empty()
+        } else {
+            !instr_partition
+                .alternative_output_representation
+                .contains(&partition)
+                && instr_partition
+                    .inputs_transition
+                    .iter()
+                    .flatten()
+                    .all(|transition| match transition {
+                        Transition::Internal { src_partition }
+                        | Transition::Additional { src_partition } => *src_partition != partition,
+                    })
+        }
+    })
+}
+
+/// Chooses the order of the luts of each partition of `p_cut` without transitions to the other
+/// partitions.
+/// Keyswitching and then bootstrapping does the levelled operations on the big key, bootstrapping
+/// and then keyswitching does them on the small key, which is cheaper for levelled-heavy partitions
+/// but adds the keyswitch noise to the levelled operations.
+/// A partition is switched to the bootstrap-then-keyswitch order if it lowers the complexity of the
+/// optimized parameters plus the one of the levelled operations.
+pub fn choose_pbs_ks_partitions(
+    dag: &Dag,
+    config: Config,
+    search_space: &SearchSpace,
+    search_space_restriction: &impl SearchSpaceRestriction,
+    persistent_caches: &PersistDecompCaches,
+    p_cut: PartitionCut,
+) -> PartitionCut {
+    if has_round(dag) {
+        // the luts of the rounded operations are always lowered keyswitch first
+        return p_cut;
+    }
+    let complexity_of = |p_cut: &PartitionCut| {
+        optimize(
+            dag,
+            config,
+            search_space,
+            search_space_restriction,
+            persistent_caches,
+            &Some(p_cut.clone()),
+            PartitionIndex::FIRST,
+        )
+        .ok()
+        .map(|(analyzed, params)| {
+            let complexity = params.complexity + levelled_complexity(dag, &analyzed, &params);
+            (analyzed, complexity)
+        })
+    };
+    let (analyzed, mut best_complexity) = match complexity_of(&p_cut) {
+        Some(analyzed_and_complexity) => analyzed_and_complexity,
+        None => return p_cut,
+    };
+    if analyzed.nb_partitions != p_cut.n_partitions() {
+        // the unused partitions have been removed, the partitions are renumbered
+        return p_cut;
+    }
+    let mut best_p_cut = p_cut;
+    for partition in PartitionIndex::range(0, analyzed.nb_partitions) {
+        if !best_p_cut.is_internal_partition(&partition)
+            || !is_isolated_partition(&analyzed, partition)
+        {
+            continue;
+        }
+        let pbs_ks_p_cut = best_p_cut.with_pbs_ks_partition(partition);
+        if let Some((_, complexity)) = complexity_of(&pbs_ks_p_cut) {
+            if complexity < best_complexity {
+                if DEBUG {
+                    eprintln!(
+                        "Bootstrap then keyswitch in partition {partition}, complexity {best_complexity} -> {complexity}"
+                    );
+                }
+                best_complexity = complexity;
+                best_p_cut = pbs_ks_p_cut;
+            }
+        }
+    }
+    best_p_cut
+}
+
 pub fn optimize_to_circuit_solution(
     dag: &Dag,
     config: Config,
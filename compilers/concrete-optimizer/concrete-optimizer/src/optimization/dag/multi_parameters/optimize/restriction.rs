@@ -10,8 +10,9 @@ use super::MacroParameters;
 /// A trait to restrict search space in the optimization algorithm.
 ///
 /// The trait methods are called at different level of the optimization algorithm to
-/// perform cuts depending on whether the parameters are available.
-pub trait SearchSpaceRestriction {
+/// perform cuts depending on whether the parameters are available. The restrictions are shared by
+/// the threads of the search.
+pub trait SearchSpaceRestriction: Sync {
     /// Return whether the glwe parameters are available for the given partition.
     fn is_available_glwe(&self, partition: PartitionIndex, glwe_params: GlweParameters) -> bool;
 
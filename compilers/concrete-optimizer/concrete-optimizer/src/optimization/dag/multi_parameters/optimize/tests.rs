@@ -28,6 +28,8 @@ fn default_config() -> Config<'static> {
         ciphertext_modulus_log: 64,
         fft_precision: 53,
         complexity_model,
+        nb_threads: 1,
+        key_size_weight: 0.0,
     }
 }
 
@@ -517,6 +519,193 @@ fn test_partition_increasing_chain() {
     test_partition_chain(true);
 }
 
+#[test]
+fn test_multi_threaded_search() {
+    let mut dag = unparametrized::Dag::new();
+    let mut lut_input = dag.add_input(8, Shape::number());
+    for out_precision in [6, 7, 8, 6] {
+        lut_input = dag.add_lut(lut_input, FunctionTable::UNKWOWN, out_precision);
+    }
+    let search_space = SearchSpace::default_cpu();
+    let optimize_with = |nb_threads| {
+        let config = Config {
+            nb_threads,
+            ..default_config()
+        };
+        super::optimize(
+            &dag,
+            config,
+            &search_space,
+            &NoSearchSpaceRestriction,
+            &SHARED_CACHES,
+            &None,
+            PartitionIndex(0),
+        )
+        .unwrap()
+        .1
+    };
+    let sol = optimize_with(1);
+    let sol_threaded = optimize_with(4);
+    assert!(sol.macro_params.len() > 1);
+    assert_eq!(sol.macro_params, sol_threaded.macro_params);
+    assert!(sol.complexity == sol_threaded.complexity);
+    assert!(sol.p_error == sol_threaded.p_error);
+}
+
+fn keys_size(params: &Parameters) -> f64 {
+    let macro_params: Vec<_> = params.macro_params.iter().map(|p| p.unwrap()).collect();
+    let mut size = 0.0;
+    for (partition, pbs) in params.micro_params.pbs.iter().enumerate() {
+        if let Some(pbs) = pbs {
+            let macro_param = macro_params[partition];
+            size += pbs.key_size_br(macro_param.glwe_params, macro_param.internal_dim);
+        }
+    }
+    for (src, dst) in cross_partition(macro_params.len()) {
+        if let Some(ks) = params.micro_params.ks[src.0][dst.0] {
+            let in_lwe_dim = macro_params[src.0]
+                .glwe_params
+                .sample_extract_lwe_dimension();
+            size += ks.key_size(in_lwe_dim, macro_params[dst.0].internal_dim);
+        }
+        if let Some(fks) = params.micro_params.fks[src.0][dst.0] {
+            size += fks.key_size();
+        }
+    }
+    size
+}
+
+#[test]
+fn test_key_size_weight() {
+    let mut dag = unparametrized::Dag::new();
+    let mut lut_input = dag.add_input(8, Shape::number());
+    for out_precision in [6, 8, 6] {
+        lut_input = dag.add_lut(lut_input, FunctionTable::UNKWOWN, out_precision);
+    }
+    let search_space = SearchSpace::default_cpu();
+    let optimize_with = |key_size_weight| {
+        let config = Config {
+            key_size_weight,
+            ..default_config()
+        };
+        super::optimize(
+            &dag,
+            config,
+            &search_space,
+            &NoSearchSpaceRestriction,
+            &SHARED_CACHES,
+            &None,
+            PartitionIndex(0),
+        )
+        .unwrap()
+        .1
+    };
+    let sol = optimize_with(0.0);
+    let sol_weighted = optimize_with(1.0);
+    assert!(sol.is_feasible.is_feasible() && sol_weighted.is_feasible.is_feasible());
+    // the key sizes are part of the minimized complexity
+    assert!(keys_size(&sol_weighted) <= keys_size(&sol));
+    assert!(sol.complexity <= sol_weighted.complexity);
+}
+
+#[test]
+fn test_search_partition_cut() {
+    let mut dag = unparametrized::Dag::new();
+    let mut lut_input = dag.add_input(8, Shape::number());
+    for out_precision in [3, 4, 8, 3] {
+        lut_input = dag.add_lut(lut_input, FunctionTable::UNKWOWN, out_precision);
+    }
+    let search_space = SearchSpace::default_cpu();
+    let complexity_of = |p_cut: &PartitionCut| {
+        super::optimize(
+            &dag,
+            default_config(),
+            &search_space,
+            &NoSearchSpaceRestriction,
+            &SHARED_CACHES,
+            &Some(p_cut.clone()),
+            PartitionIndex(0),
+        )
+        .unwrap()
+        .1
+        .complexity
+    };
+    let p_cut = PartitionCut::maximal_partitionning(&dag);
+    let searched_p_cut = search_partition_cut(
+        &dag,
+        default_config(),
+        &search_space,
+        &NoSearchSpaceRestriction,
+        &SHARED_CACHES,
+        p_cut.clone(),
+        0.0,
+    );
+    assert!(searched_p_cut.n_partitions() <= p_cut.n_partitions());
+    assert!(complexity_of(&searched_p_cut) <= complexity_of(&p_cut));
+    // accepting a complexity increase shares more keys
+    let reused_p_cut = search_partition_cut(
+        &dag,
+        default_config(),
+        &search_space,
+        &NoSearchSpaceRestriction,
+        &SHARED_CACHES,
+        p_cut.clone(),
+        0.5,
+    );
+    assert!(reused_p_cut.n_partitions() <= searched_p_cut.n_partitions());
+    assert!(complexity_of(&reused_p_cut) <= 1.5 * complexity_of(&searched_p_cut));
+}
+
+#[test]
+fn test_choose_pbs_ks_partitions() {
+    let make_dag = |levelled_cost_factor: f64| {
+        let mut dag = unparametrized::Dag::new();
+        let input = dag.add_input(4, Shape::number());
+        let lut = dag.add_lut(input, FunctionTable::UNKWOWN, 4);
+        let complexity = LevelledComplexity {
+            lwe_dim_cost_factor: levelled_cost_factor,
+            fixed_cost: 0.0,
+        };
+        let levelled = dag.add_linear_noise([lut], complexity, [4.0], Shape::number(), "");
+        let _ = dag.add_lut(levelled, FunctionTable::UNKWOWN, 4);
+        dag
+    };
+    let choose = |dag: &unparametrized::Dag| {
+        choose_pbs_ks_partitions(
+            dag,
+            default_config(),
+            &SearchSpace::default_cpu(),
+            &NoSearchSpaceRestriction,
+            &SHARED_CACHES,
+            PartitionCut::for_each_precision(dag),
+        )
+    };
+    // without levelled operations, the keyswitch noise is better not multiplied by the weights
+    assert!(choose(&make_dag(0.0)).pbs_ks_partitions.is_empty());
+    // the levelled operations are cheaper on the small key
+    let dag = make_dag(1e6);
+    let p_cut = choose(&dag);
+    assert!(p_cut.is_pbs_ks_partition(&PartitionIndex::FIRST));
+    let (analyzed, params) = super::optimize(
+        &dag,
+        default_config(),
+        &SearchSpace::default_cpu(),
+        &NoSearchSpaceRestriction,
+        &SHARED_CACHES,
+        &Some(p_cut),
+        PartitionIndex::FIRST,
+    )
+    .unwrap();
+    let ext_keys = keys_spec::ExpandedCircuitKeys::of(&params);
+    let instructions_keys = analyze::original_instrs_partition(&analyzed, &ext_keys);
+    // the input and the luts are on the small key, which is the input of the bootstrap
+    let small_key = ext_keys.small_secret_keys[0].identifier;
+    assert!(instructions_keys[0].output_key == small_key);
+    assert!(instructions_keys[1].input_key == small_key);
+    assert!(instructions_keys[1].output_key == small_key);
+    assert!(ext_keys.bootstrap_keys[0].input_key.identifier == small_key);
+}
+
 const MAX_WEIGHT: &[u64] = &[
     // max v0 weight for each precision
     1_073_741_824,
@@ -647,6 +836,8 @@ fn test_big_secret_key_sharing() {
         ciphertext_modulus_log: 64,
         fft_precision: 53,
         complexity_model: &CpuComplexity::default(),
+        nb_threads: 1,
+        key_size_weight: 0.0,
     };
     let config_no_sharing = Config {
         key_sharing: false,
@@ -698,6 +889,8 @@ fn test_big_and_small_secret_key() {
         ciphertext_modulus_log: 64,
         fft_precision: 53,
         complexity_model: &CpuComplexity::default(),
+        nb_threads: 1,
+        key_size_weight: 0.0,
     };
     let config_no_sharing = Config {
         key_sharing: false,
@@ -65,6 +65,10 @@ pub struct PartitionCut {
     pub rnorm2: Vec<f64>,
 
     pub external_partitions: Vec<ExternalPartition>,
+
+    // Internal partitions whose ciphertexts are kept on the small key, their luts bootstrap and then
+    // keyswitch, instead of keyswitching and then bootstrapping
+    pub pbs_ks_partitions: Vec<PartitionIndex>,
 }
 
 impl PartitionCut {
@@ -74,6 +78,7 @@ impl PartitionCut {
             rnorm2: vec![],
             external_partitions: vec![],
             has_internal_partitions: true,
+            pbs_ks_partitions: vec![],
         }
     }
 
@@ -101,6 +106,22 @@ impl PartitionCut {
         partition.0 < self.n_internal_partitions()
     }
 
+    pub fn is_pbs_ks_partition(&self, partition: &PartitionIndex) -> bool {
+        self.pbs_ks_partitions.contains(partition)
+    }
+
+    pub fn with_pbs_ks_partition(&self, partition: PartitionIndex) -> Self {
+        assert!(self.is_internal_partition(&partition));
+        let mut pbs_ks_partitions = self.pbs_ks_partitions.clone();
+        if !pbs_ks_partitions.contains(&partition) {
+            pbs_ks_partitions.push(partition);
+        }
+        Self {
+            pbs_ks_partitions,
+            ..self.clone()
+        }
+    }
+
     pub fn from_precisions(precisions: &[Precision]) -> Self {
         let mut precisions: Vec<_> = precisions.to_vec();
         let has_internal_partitions = !precisions.is_empty();
@@ -112,6 +133,7 @@ impl PartitionCut {
             rnorm2: vec![],
             external_partitions: vec![],
             has_internal_partitions,
+            pbs_ks_partitions: vec![],
         }
     }
 
@@ -129,6 +151,7 @@ impl PartitionCut {
             rnorm2: vec![],
             external_partitions: external_partitions.to_vec(),
             has_internal_partitions,
+            pbs_ks_partitions: vec![],
         }
     }
 
@@ -335,6 +358,32 @@ impl PartitionCut {
             rnorm2: max_output_norm2,
             external_partitions,
             has_internal_partitions,
+            pbs_ks_partitions: vec![],
+        }
+    }
+
+    // The luts of the internal partition i go to the following partitions
+    pub fn merge_with_next(&self, i: usize) -> Self {
+        assert!(i < self.p_cut.len());
+        let mut p_cut = self.p_cut.clone();
+        _ = p_cut.remove(i);
+        // the merged partition keeps the keyswitch-then-bootstrap order
+        let pbs_ks_partitions = self
+            .pbs_ks_partitions
+            .iter()
+            .filter(|p| p.0 != i && p.0 != i + 1)
+            .map(|p| {
+                if p.0 > i + 1 {
+                    PartitionIndex(p.0 - 1)
+                } else {
+                    *p
+                }
+            })
+            .collect();
+        Self {
+            p_cut,
+            pbs_ks_partitions,
+            ..self.clone()
         }
     }
 
@@ -349,11 +398,18 @@ impl PartitionCut {
             && self.is_internal_partition(&PartitionIndex(
                 used.iter().map(|u| u.0).min().unwrap_or(usize::MAX),
             ));
+        let pbs_ks_partitions = self
+            .pbs_ks_partitions
+            .iter()
+            .filter(|p| used.contains(p))
+            .map(|p| PartitionIndex(used.iter().filter(|u| u.0 < p.0).count()))
+            .collect();
         Self {
             p_cut,
             rnorm2: self.rnorm2.clone(),
             external_partitions: self.external_partitions.clone(),
             has_internal_partitions,
+            pbs_ks_partitions,
         }
     }
 }
@@ -383,6 +439,9 @@ impl std::fmt::Display for PartitionCut {
             "partition {}: {prev_precision_cut} bits and higher",
             self.p_cut.len()
         )?;
+        for partition in &self.pbs_ks_partitions {
+            writeln!(f, "partition {partition}: bootstrap then keyswitch")?;
+        }
         for (i, e_partition) in self.external_partitions.iter().enumerate() {
             writeln!(
                 f,
@@ -116,7 +116,7 @@ fn get_singleton_value<V: Copy>(hashset: &HashSet<V>) -> V {
     *hashset.iter().next().unwrap()
 }
 
-fn only_1_partition(dag: &unparametrized::Dag) -> Partitions {
+fn only_1_partition(dag: &unparametrized::Dag, p_cut: &PartitionCut) -> Partitions {
     let mut instrs_partition =
         vec![InstructionPartition::new(PartitionIndex::FIRST); dag.operators.len()];
     for (op_i, op) in dag.operators.iter().enumerate() {
@@ -133,10 +133,14 @@ fn only_1_partition(dag: &unparametrized::Dag) -> Partitions {
             Op::Round { .. } => unreachable!(),
         }
     }
+    // the single partition keeps its order
     Partitions {
         nb_partitions: 1,
         instrs_partition,
-        p_cut: PartitionCut::empty(),
+        p_cut: PartitionCut {
+            pbs_ks_partitions: p_cut.pbs_ks_partitions.clone(),
+            ..PartitionCut::empty()
+        },
     }
 }
 
@@ -161,7 +165,7 @@ fn resolve_by_levelled_block(
         );
     }
     if nb_partitions == 1 {
-        return only_1_partition(dag);
+        return only_1_partition(dag, p_cut);
     }
     let mut block_partition: Vec<PartitionIndex> = vec![];
     for constraints in constraints_by_blocks {
@@ -268,7 +272,7 @@ pub fn partitionning_with_preferred(
     default_partition: PartitionIndex,
 ) -> Partitions {
     if p_cut.n_partitions() <= 1 {
-        only_1_partition(dag)
+        only_1_partition(dag, p_cut)
     } else {
         resolve_by_levelled_block(dag, p_cut, default_partition)
     }
@@ -156,6 +156,8 @@ mod test {
             ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
+            nb_threads: 1,
+            key_size_weight: 0.0,
         };
         let _a = generate_virtual_parameters(
             vec![
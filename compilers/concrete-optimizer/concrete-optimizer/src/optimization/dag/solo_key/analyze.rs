@@ -249,7 +249,7 @@ fn in_luts_variance(
         .collect()
 }
 
-fn op_levelled_complexity(op: &Operator, out_shapes: &[Shape]) -> LevelledComplexity {
+pub fn op_levelled_complexity(op: &Operator, out_shapes: &[Shape]) -> LevelledComplexity {
     match op {
         Operator::Dot {
             kind: DotKind::Unsupported,
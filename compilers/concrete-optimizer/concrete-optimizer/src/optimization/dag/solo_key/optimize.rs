@@ -477,6 +477,8 @@ pub(crate) mod tests {
             ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
+            nb_threads: 1,
+            key_size_weight: 0.0,
         };
 
         let search_space = SearchSpace::default_cpu();
@@ -522,6 +524,8 @@ pub(crate) mod tests {
             ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
+            nb_threads: 1,
+            key_size_weight: 0.0,
         };
 
         _ = optimize_v0(
@@ -618,6 +622,8 @@ pub(crate) mod tests {
             ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
+            nb_threads: 1,
+            key_size_weight: 0.0,
         };
 
         let state = optimize(&dag);
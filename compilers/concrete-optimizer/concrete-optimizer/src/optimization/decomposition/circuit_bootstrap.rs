@@ -115,7 +115,11 @@ pub fn cache(
     fft_precision: u32,
 ) -> PersistDecompCache {
     let cache_dir: String = default_cache_dir();
-    let hardware = processing_unit.br_to_string();
+    let hardware = format!(
+        "{}{}",
+        processing_unit.br_to_string(),
+        complexity_model.cache_suffix()
+    );
     let path =
         format!("{cache_dir}/cb-decomp-{hardware}-{ciphertext_modulus_log}-{fft_precision}-{security_level}");
     let function = move |glwe_params| {
@@ -24,6 +24,13 @@ impl CmuxComplexityNoise {
     pub fn noise_br(&self, in_lwe_dim: u64) -> f64 {
         in_lwe_dim as f64 * self.noise
     }
+    // size in bytes of the bootstrap key, one glwe ggsw of 64 bits coefficients per input mask
+    pub fn key_size_br(&self, glwe_params: GlweParameters, in_lwe_dim: u64) -> f64 {
+        let glwe_size = (glwe_params.glwe_dimension + 1) as f64;
+        let ggsw_size =
+            self.decomp.level as f64 * glwe_size * glwe_size * glwe_params.polynomial_size() as f64;
+        8.0 * in_lwe_dim as f64 * ggsw_size
+    }
 }
 
 /* This is strictly variance decreasing and strictly complexity increasing */
@@ -133,7 +140,11 @@ pub fn cache(
     fft_precision: u32,
 ) -> PersistDecompCache {
     let cache_dir: String = default_cache_dir();
-    let hardware = processing_unit.br_to_string();
+    let hardware = format!(
+        "{}{}",
+        processing_unit.br_to_string(),
+        complexity_model.cache_suffix()
+    );
     let path =
         format!("{cache_dir}/cmux-decomp-{hardware}-{ciphertext_modulus_log}-{fft_precision}-{security_level}");
 
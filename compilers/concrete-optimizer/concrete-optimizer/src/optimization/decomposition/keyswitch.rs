@@ -24,6 +24,10 @@ impl KsComplexityNoise {
     pub fn noise(&self, in_lwe_dim: u64) -> f64 {
         in_lwe_dim as f64 * self.noise
     }
+    // size in bytes of the keyswitch key, one lwe of 64 bits coefficients per input mask and level
+    pub fn key_size(&self, in_lwe_dim: u64, out_lwe_dim: u64) -> f64 {
+        8.0 * (in_lwe_dim * self.decomp.level) as f64 * (out_lwe_dim + 1) as f64
+    }
 }
 
 /* This is strictly variance decreasing and strictly complexity increasing */
@@ -133,7 +137,11 @@ pub fn cache(
     ciphertext_modulus_log: u32,
 ) -> PersistDecompCache {
     let cache_dir: String = default_cache_dir();
-    let hardware = processing_unit.ks_to_string();
+    let hardware = format!(
+        "{}{}",
+        processing_unit.ks_to_string(),
+        complexity_model.cache_suffix()
+    );
     let path =
         format!("{cache_dir}/ks-decomp-{hardware}-{ciphertext_modulus_log}-{security_level}");
 
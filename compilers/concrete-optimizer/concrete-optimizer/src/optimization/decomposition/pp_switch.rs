@@ -113,7 +113,11 @@ pub fn cache(
     ciphertext_modulus_log: u32,
 ) -> PersistDecompCache {
     let cache_dir: String = default_cache_dir();
-    let hardware = processing_unit.br_to_string();
+    let hardware = format!(
+        "{}{}",
+        processing_unit.br_to_string(),
+        complexity_model.cache_suffix()
+    );
     let path =
         format!("{cache_dir}/pp-decomp-{hardware}-{ciphertext_modulus_log}-{security_level}");
 
@@ -126,6 +126,8 @@ pub fn all_results(args: &Args) -> Vec<Vec<Option<Solution>>> {
         ciphertext_modulus_log: args.ciphertext_modulus_log,
         fft_precision: args.fft_precision,
         complexity_model: &CpuComplexity::default(),
+        nb_threads: 1,
+        key_size_weight: 0.0,
     };
 
     let cache = decomposition::cache(
@@ -199,7 +199,11 @@ Provide a `function_name` keyword argument to disambiguate."
                 if arg is None
                 else Value(
                     client_circuit.prepare_input(
-                        Value_(arg.astype(np.int64) if isinstance(arg, np.ndarray) else arg),
+                        Value_(
+                            arg.astype(np.int64, copy=False)
+                            if isinstance(arg, np.ndarray)
+                            else arg
+                        ),
                         position,
                     )
                 )
@@ -251,7 +255,11 @@ Provide a `function_name` keyword argument to disambiguate."
                 if arg is None
                 else Value(
                     client_circuit.simulate_prepare_input(
-                        Value_(arg.astype(np.int64) if isinstance(arg, np.ndarray) else arg),
+                        Value_(
+                            arg.astype(np.int64, copy=False)
+                            if isinstance(arg, np.ndarray)
+                            else arg
+                        ),
                         position,
                     )
                 )
@@ -315,6 +323,129 @@ Provide a `function_name` keyword argument to disambiguate."
 
         return decrypted if len(decrypted) != 1 else decrypted[0]
 
+    def encrypt_batch(
+        self,
+        samples: List[Tuple[Optional[Union[int, np.ndarray, List]], ...]],
+        function_name: Optional[str] = None,
+    ) -> List[Optional[Union[Value, Tuple[Optional[Value], ...]]]]:
+        """
+        Encrypt the argument(s) of many samples for evaluation.
+
+        The samples of each argument are encrypted at once, in parallel, which is faster than
+        encrypting them one by one with `encrypt` when they are many and small.
+
+        Args:
+            samples (List[Tuple[Optional[Union[int, np.ndarray, List]], ...]]):
+                argument(s) of each sample for evaluation
+
+            function_name (str):
+                name of the function to encrypt
+
+        Returns:
+            List[Optional[Union[Value, Tuple[Optional[Value], ...]]]]:
+                encrypted argument(s) of each sample for evaluation
+        """
+
+        assert self._keys is not None, "Tried to encrypt on a simulated client."
+        if not self._keys.are_generated:
+            self._keys.generate()
+
+        if function_name is None:
+            functions = self.specs.program_info.function_list()
+            if len(functions) == 1:
+                function_name = functions[0]
+            else:  # pragma: no cover
+                msg = "The client contains more than one functions. \
+Provide a `function_name` keyword argument to disambiguate."
+                raise TypeError(msg)
+
+        sanitized_samples = [
+            validate_input_args(self._client_specs, *args, function_name=function_name)
+            for args in samples
+        ]
+        client_program = ClientProgram.create_encrypted(
+            self._client_specs.program_info, self._keys._keyset  # pylint: disable=protected-access
+        )
+        client_circuit = client_program.get_client_circuit(function_name)
+
+        exported: List[List[Optional[Value]]] = [[] for _ in sanitized_samples]
+        arity = len(sanitized_samples[0]) if len(sanitized_samples) != 0 else 0
+        for position in range(arity):
+            indices = [
+                index
+                for index, args in enumerate(sanitized_samples)
+                if args[position] is not None
+            ]
+            prepared = client_circuit.prepare_inputs(
+                [
+                    Value_(
+                        arg.astype(np.int64, copy=False) if isinstance(arg, np.ndarray) else arg
+                    )
+                    for arg in (sanitized_samples[index][position] for index in indices)
+                ],
+                position,
+            )
+            encrypted = dict(zip(indices, prepared))
+            for index, sample in enumerate(exported):
+                sample.append(Value(encrypted[index]) if index in encrypted else None)
+
+        return [tuple(sample) if len(sample) != 1 else sample[0] for sample in exported]
+
+    def decrypt_batch(
+        self,
+        results: List[Union[Value, Tuple[Value, ...]]],
+        function_name: Optional[str] = None,
+    ) -> List[Optional[Union[int, np.ndarray, Tuple[Optional[Union[int, np.ndarray]], ...]]]]:
+        """
+        Decrypt the result(s) of evaluation of many samples.
+
+        The samples of each result are decrypted at once, in parallel, which is faster than
+        decrypting them one by one with `decrypt` when they are many and small.
+
+        Args:
+            results (List[Union[Value, Tuple[Value, ...]]]):
+                result(s) of evaluation of each sample
+
+            function_name (str):
+                name of the function to decrypt for
+
+        Returns:
+            List[Optional[Union[int, np.ndarray, Tuple[Optional[Union[int, np.ndarray]], ...]]]]:
+                decrypted result(s) of evaluation of each sample
+        """
+
+        if function_name is None:  # pragma: no cover
+            functions = self.specs.program_info.function_list()
+            if len(functions) == 1:
+                function_name = functions[0]
+            else:  # pragma: no cover
+                msg = "The client contains more than one functions. \
+Provide a `function_name` keyword argument to disambiguate."
+                raise TypeError(msg)
+
+        assert self._keys is not None, "Tried to decrypt on a simulated client."
+        assert self._keys.are_generated
+
+        client_program = ClientProgram.create_encrypted(
+            self._client_specs.program_info, self._keys._keyset  # pylint: disable=protected-access
+        )
+        client_circuit = client_program.get_client_circuit(function_name)
+
+        samples = [result if isinstance(result, tuple) else (result,) for result in results]
+        arity = len(samples[0]) if len(samples) != 0 else 0
+
+        decrypted: List[List[Union[int, np.ndarray]]] = [[] for _ in samples]
+        for position in range(arity):
+            processed = client_circuit.process_outputs(
+                [sample[position]._inner for sample in samples],  # pylint: disable=protected-access
+                position,
+            )
+            for sample, value in zip(decrypted, processed):
+                d = value.to_py_val()
+                sample.append(d.astype("int64") if isinstance(d, np.ndarray) else d)
+
+        return [tuple(sample) if len(sample) != 1 else sample[0] for sample in decrypted]
+
     def simulate_decrypt(
         self,
         *results: Union[Value, Tuple[Value, ...]],
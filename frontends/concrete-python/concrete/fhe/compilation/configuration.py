@@ -65,6 +65,7 @@ class MultiParameterStrategy(str, Enum):
 
     PRECISION = "precision"
     PRECISION_AND_NORM2 = "precision_and_norm2"
+    COST = "cost"
 
     @classmethod
     def parse(cls, string: str) -> "MultiParameterStrategy":
@@ -967,6 +968,8 @@ class Configuration:
     auto_parallelize: bool
     compress_evaluation_keys: bool
     compress_input_ciphertexts: bool
+    compress_output_ciphertexts: bool
+    compact_fourier_bootstrap_keys: bool
     p_error: Optional[float]
     global_p_error: Optional[float]
     insecure_key_cache_location: Optional[str]
@@ -1000,6 +1003,7 @@ class Configuration:
     print_tlu_fusing: bool
     optimize_tlu_based_on_original_bit_width: Union[bool, int]
     detect_overflow_in_simulation: bool
+    simulate_with_noise: bool
     dynamic_indexing_check_out_of_bounds: bool
     dynamic_assignment_check_out_of_bounds: bool
     simulate_encrypt_run_decrypt: bool
@@ -1029,6 +1033,8 @@ class Configuration:
         auto_parallelize: bool = False,
         compress_evaluation_keys: bool = False,
         compress_input_ciphertexts: bool = False,
+        compress_output_ciphertexts: bool = False,
+        compact_fourier_bootstrap_keys: bool = False,
         p_error: Optional[float] = None,
         global_p_error: Optional[float] = None,
         auto_adjust_rounders: bool = False,
@@ -1074,6 +1080,7 @@ class Configuration:
         print_tlu_fusing: bool = False,
         optimize_tlu_based_on_original_bit_width: Union[bool, int] = 8,
         detect_overflow_in_simulation: bool = False,
+        simulate_with_noise: bool = True,
         dynamic_indexing_check_out_of_bounds: bool = True,
         dynamic_assignment_check_out_of_bounds: bool = True,
         simulate_encrypt_run_decrypt: bool = False,
@@ -1105,6 +1112,8 @@ class Configuration:
         self.auto_parallelize = auto_parallelize
         self.compress_evaluation_keys = compress_evaluation_keys
         self.compress_input_ciphertexts = compress_input_ciphertexts
+        self.compress_output_ciphertexts = compress_output_ciphertexts
+        self.compact_fourier_bootstrap_keys = compact_fourier_bootstrap_keys
         self.p_error = p_error
         self.global_p_error = global_p_error
         self.auto_adjust_rounders = auto_adjust_rounders
@@ -1182,6 +1191,7 @@ class Configuration:
         self.optimize_tlu_based_on_original_bit_width = optimize_tlu_based_on_original_bit_width
 
         self.detect_overflow_in_simulation = detect_overflow_in_simulation
+        self.simulate_with_noise = simulate_with_noise
 
         self.dynamic_indexing_check_out_of_bounds = dynamic_indexing_check_out_of_bounds
         self.dynamic_assignment_check_out_of_bounds = dynamic_assignment_check_out_of_bounds
@@ -1222,6 +1232,8 @@ class Configuration:
         auto_parallelize: Union[Keep, bool] = KEEP,
         compress_evaluation_keys: Union[Keep, bool] = KEEP,
         compress_input_ciphertexts: Union[Keep, bool] = KEEP,
+        compress_output_ciphertexts: Union[Keep, bool] = KEEP,
+        compact_fourier_bootstrap_keys: Union[Keep, bool] = KEEP,
         p_error: Union[Keep, Optional[float]] = KEEP,
         global_p_error: Union[Keep, Optional[float]] = KEEP,
         auto_adjust_rounders: Union[Keep, bool] = KEEP,
@@ -1266,6 +1278,7 @@ class Configuration:
         print_tlu_fusing: Union[Keep, bool] = KEEP,
         optimize_tlu_based_on_original_bit_width: Union[Keep, bool, int] = KEEP,
         detect_overflow_in_simulation: Union[Keep, bool] = KEEP,
+        simulate_with_noise: Union[Keep, bool] = KEEP,
         dynamic_indexing_check_out_of_bounds: Union[Keep, bool] = KEEP,
         dynamic_assignment_check_out_of_bounds: Union[Keep, bool] = KEEP,
         simulate_encrypt_run_decrypt: Union[Keep, bool] = KEEP,
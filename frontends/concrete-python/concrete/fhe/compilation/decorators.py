@@ -183,6 +183,10 @@ def compiler(parameters: Mapping[str, Union[str, EncryptionStatus]]):
 def module():
     """
     Provide an easy interface for the compilation of multi functions modules.
+
+    Besides its functions, the module can declare a `composition` policy, and `fused_calls`
+    mapping the names of additional functions to the graphs of calls of the other functions they
+    run, in the format of `FheModule.run_graph`.
     """
 
     def decoration(class_):
@@ -192,7 +196,8 @@ def module():
             raise RuntimeError(error)
         composition = getattr(class_, "composition", AllComposable())
         assert isinstance(composition, CompositionPolicy)
-        return ModuleCompiler([f for (_, f) in functions], composition)
+        fused_calls = getattr(class_, "fused_calls", None)
+        return ModuleCompiler([f for (_, f) in functions], composition, fused_calls)
 
     return decoration
 
@@ -3,6 +3,9 @@ Declaration of `EvaluationKeys`.
 """
 
 # pylint: disable=import-error,no-member,no-name-in-module
+from pathlib import Path
+from typing import Union
+
 from concrete.compiler import ServerKeyset
 from typing_extensions import NamedTuple
 
@@ -26,3 +29,39 @@ class EvaluationKeys(NamedTuple):
         Deserialize evaluation keys from bytes.
         """
         return EvaluationKeys(ServerKeyset.deserialize(buffer))
+
+    def save(self, location: Union[str, Path]):
+        """
+        Save the evaluation keys to a file.
+
+        The keys are written directly from the native keyset, without being copied to a python
+        buffer first.
+
+        Args:
+            location (Union[str, Path]):
+                location to save to
+        """
+        self.server_keyset.serialize_to_file(str(location))
+
+    @staticmethod
+    def load(location: Union[str, Path], mmap: bool = False) -> "EvaluationKeys":
+        """
+        Load evaluation keys saved with `save`.
+
+        Args:
+            location (Union[str, Path]):
+                location to load from
+
+            mmap (bool, default = False):
+                whether to map the file read-only instead of reading it, so that the keys are used
+                in place, the loading is immediate and the pages of the keys are shared by all the
+                processes mapping the same file (the file must not be modified while the keys are
+                in use)
+
+        Returns:
+            EvaluationKeys:
+                loaded evaluation keys
+        """
+        if mmap:
+            return EvaluationKeys(ServerKeyset.load_mapped(str(location)))
+        return EvaluationKeys(ServerKeyset.deserialize_from_file(str(location)))
@@ -806,6 +806,67 @@ class FheModule:
         """
         self.execution_runtime.val.client.keygen(force, seed, encryption_seed, initial_keys)
 
+    def run_graph(
+        self,
+        calls: List[Tuple[str, List[Tuple[int, int]]]],
+        *args: Value,
+    ) -> List[Tuple[Value, ...]]:
+        """
+        Evaluate a composition of the functions of the module, scheduled natively.
+
+        Unlike chaining `run_async`, the calls are scheduled without the GIL, on native threads,
+        as soon as their arguments are computed.
+
+        Args:
+            calls (List[Tuple[str, List[Tuple[int, int]]]]):
+                calls of the composition, as the name of the function called and the sources of
+                its arguments, each call only taking arguments from the calls before it. A source
+                is the index of a call and the position of one of its results, or -1 and the
+                position of an argument in `args`
+
+            *args (Value):
+                encrypted argument(s) of the composition
+
+        Returns:
+            List[Tuple[Value, ...]]:
+                result(s) of each call
+        """
+        runtime = self.execution_runtime.val
+        return runtime.server.run_graph(
+            calls, *args, evaluation_keys=runtime.client.evaluation_keys
+        )
+
+    def run_repeated(
+        self,
+        function_name: str,
+        n: int,
+        *args: Value,
+    ) -> Union[Value, Tuple[Value, ...]]:
+        """
+        Evaluate a composable function of the module `n` times in a row, natively.
+
+        Unlike calling `run` in a loop, the intermediate results stay in native memory instead of
+        being serialized between the calls.
+
+        Args:
+            function_name (str):
+                name of the function to run, whose results must have the types of its arguments
+
+            n (int):
+                number of calls
+
+            *args (Value):
+                encrypted argument(s) of the first call
+
+        Returns:
+            Union[Value, Tuple[Value, ...]]:
+                result(s) of the last call
+        """
+        runtime = self.execution_runtime.val
+        return runtime.server.run_repeated(
+            function_name, n, *args, evaluation_keys=runtime.client.evaluation_keys
+        )
+
     def cleanup(self):
         """
         Cleanup the temporary library output directory.
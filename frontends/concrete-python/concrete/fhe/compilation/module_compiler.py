@@ -6,15 +6,17 @@ Declaration of `MultiCompiler` class.
 
 import inspect
 import traceback
+from copy import deepcopy
 from pathlib import Path
 from typing import Any, Callable, Dict, Iterable, List, Optional, Set, Tuple, Union
 
+import networkx as nx
 import numpy as np
 from concrete.compiler import CompilationContext
 
 from ..extensions import AutoRounder, AutoTruncator
 from ..mlir import GraphConverter
-from ..representation import Graph
+from ..representation import Graph, Node
 from ..tracing import Tracer
 from ..values import ValueDescription
 from .artifacts import DebugManager, FunctionDebugArtifacts, ModuleDebugArtifacts
@@ -336,8 +338,14 @@ class ModuleCompiler:
     functions: Dict[str, FunctionDef]
     compilation_context: CompilationContext
     composition: CompositionPolicy
+    fused_calls: Dict[str, List[Tuple[str, List[Tuple[int, int]]]]]
 
-    def __init__(self, functions: List[FunctionDef], composition: CompositionPolicy):
+    def __init__(
+        self,
+        functions: List[FunctionDef],
+        composition: CompositionPolicy,
+        fused_calls: Optional[Dict[str, List[Tuple[str, List[Tuple[int, int]]]]]] = None,
+    ):
         self.default_configuration = Configuration(
             p_error=0.00001,
             parameter_selection_strategy="multi",
@@ -345,6 +353,12 @@ class ModuleCompiler:
         self.functions = {function.name: function for function in functions}
         self.compilation_context = CompilationContext()
         self.composition = composition
+        self.fused_calls = fused_calls if fused_calls is not None else {}
+
+        for name in self.fused_calls:
+            if name in self.functions:
+                message = f"Fused function '{name}' has the name of a function of the module"
+                raise ValueError(message)
 
     def wire_pipeline(self, inputset: Union[Iterable[Any], Iterable[Tuple[Any, ...]]]):
         """
@@ -414,6 +428,13 @@ class ModuleCompiler:
                 assert function.graph is not None
                 graphs[name] = function.graph
 
+            # Inline the calls of the fused functions in their own graphs
+            for name, calls in self.fused_calls.items():
+                graphs[name] = self._fuse_calls(name, calls)
+                module_artifacts.functions.setdefault(name, FunctionDebugArtifacts())
+                module_artifacts.functions[name].add_graph("final", graphs[name])
+                dbg.debug_computation_graph(name, graphs[name])
+
             # pylint: disable=protected-access
             mlir_module = GraphConverter(
                 configuration,
@@ -426,10 +447,10 @@ class ModuleCompiler:
             module_artifacts.add_mlir_to_compile(mlir_str)
 
             # Debug some function informations
-            for name, function in self.functions.items():
-                dbg.debug_bit_width_constaints(name, function.graph)
-                dbg.debug_bit_width_assignments(name, function.graph)
-                dbg.debug_assigned_graph(name, function.graph)
+            for name, graph in graphs.items():
+                dbg.debug_bit_width_constaints(name, graph)
+                dbg.debug_bit_width_assignments(name, graph)
+                dbg.debug_assigned_graph(name, graph)
 
             # Compile to a module!
             with dbg.debug_table("Optimizer", activate=dbg.show_optimizer()):
@@ -467,6 +488,116 @@ class ModuleCompiler:
 
     # pylint: enable=too-many-branches,too-many-statements
 
+    def _fuse_calls(self, name: str, calls: List[Tuple[str, List[Tuple[int, int]]]]) -> Graph:
+        """
+        Build the graph of a fused function, inlining the graphs of the functions it calls.
+
+        The calls of the fused function are given as for `FheModule.run_graph`. Each call gets a
+        copy of the graph of the function called, whose inputs are replaced by the nodes they are
+        taken from. The independent calls then end up side by side in a single circuit, and their
+        table lookups are scheduled (e.g. batched) together by the compiler.
+
+        Args:
+            name (str):
+                name of the fused function
+
+            calls (List[Tuple[str, List[Tuple[int, int]]]]):
+                calls of the fused function, as the name of the function called and the sources of
+                its arguments, each call only taking arguments from the calls before it. A source
+                is the index of a call and the position of one of its results, or -1 and the
+                position of an argument of the fused function
+
+        Returns:
+            Graph:
+                graph of the fused function, whose outputs are the results of the calls which are
+                not arguments of another call, in the order of the calls
+        """
+
+        fused = nx.MultiDiGraph()
+        input_nodes: Dict[int, Node] = {}
+        call_outputs: List[List[Node]] = []
+        consumed: Set[Node] = set()
+
+        def replace(node: Node, by: Node):
+            for successor in list(fused.successors(node)):
+                for edge in fused.get_edge_data(node, successor).values():
+                    fused.add_edge(by, successor, input_idx=edge["input_idx"])
+            fused.remove_node(node)
+
+        for index, (function_name, sources) in enumerate(calls):
+            function = self.functions.get(function_name)
+            if function is None:
+                message = f"Fused function '{name}' calls unknown function '{function_name}'"
+                raise ValueError(message)
+
+            graph = function.graph
+            assert graph is not None
+
+            if len(sources) != graph.inputs_count:
+                message = (
+                    f"Call #{index} of fused function '{name}' passes {len(sources)} arguments "
+                    f"to function '{function_name}' which takes {graph.inputs_count}"
+                )
+                raise ValueError(message)
+
+            # The constraints of the nodes are not copied, as they are generated for each graph
+            memo: Dict[int, Any] = {id(node.bit_width_constraints): [] for node in graph.graph}
+            copied = deepcopy(graph.graph, memo)
+            fused.add_nodes_from(copied.nodes)
+            fused.add_edges_from(copied.edges(data=True))
+
+            replaced = {}
+            for position, (call, source_position) in enumerate(sources):
+                node = memo[id(graph.input_nodes[position])]
+
+                if call == -1:
+                    source = input_nodes.setdefault(source_position, node)
+                    if source is node:
+                        continue
+                elif 0 <= call < index and 0 <= source_position < len(call_outputs[call]):
+                    source = call_outputs[call][source_position]
+                    consumed.add(source)
+                else:
+                    message = (
+                        f"Argument {position} of call #{index} of fused function '{name}' "
+                        f"is taken from an invalid source {(call, source_position)}"
+                    )
+                    raise ValueError(message)
+
+                if (
+                    source.output.is_encrypted != node.output.is_encrypted
+                    or source.output.shape != node.output.shape
+                ):
+                    message = (
+                        f"Argument {position} of call #{index} of fused function '{name}' "
+                        f"is {source.output} but function '{function_name}' expects {node.output}"
+                    )
+                    raise ValueError(message)
+
+                replace(node, source)
+                replaced[node] = source
+
+            outputs = [memo[id(node)] for node in graph.ordered_outputs()]
+            call_outputs.append([replaced.get(node, node) for node in outputs])
+
+        if sorted(input_nodes) != list(range(len(input_nodes))):
+            message = f"Fused function '{name}' does not use all of its arguments"
+            raise ValueError(message)
+
+        output_nodes = [node for outputs in call_outputs for node in outputs if node not in consumed]
+        if len(output_nodes) == 0:
+            message = f"Fused function '{name}' has no result"
+            raise ValueError(message)
+
+        location = self.functions[calls[0][0]].location
+        return Graph(
+            fused,
+            input_nodes,
+            dict(enumerate(output_nodes)),
+            name,
+            location=location,
+        )
+
     def __getattr__(self, item) -> FunctionDef:
         if item not in list(self.functions.keys()):
             error = f"No attribute {item}"
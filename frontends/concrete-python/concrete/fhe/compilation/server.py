@@ -7,6 +7,7 @@ Declaration of `Server` class.
 import json
 import shutil
 import tempfile
+import threading
 from pathlib import Path
 from typing import Dict, Iterable, List, Optional, Tuple, Union
 
@@ -16,6 +17,8 @@ import jsonpickle
 import numpy as np
 from concrete.compiler import (
     Backend,
+    CallBatcher,
+    CallGraph,
     ClientProgram,
     CompilationContext,
     CompilationOptions,
@@ -60,6 +63,9 @@ class Server:
     _mlir: Optional[str]
     _configuration: Optional[Configuration]
     _composition_rules: Optional[List[CompositionRule]]
+    _batching: Optional[Tuple[float, int]]
+    _batchers: Dict[str, CallBatcher]
+    _batchers_lock: threading.Lock
 
     def __init__(
         self,
@@ -71,6 +77,9 @@ class Server:
         self._library = library
         self._mlir = None
         self._composition_rules = composition_rules
+        self._batching = None
+        self._batchers = {}
+        self._batchers_lock = threading.Lock()
 
     @property
     def client_specs(self) -> ClientSpecs:
@@ -115,9 +124,12 @@ class Server:
         options.set_auto_parallelize(configuration.auto_parallelize)
         options.set_compress_evaluation_keys(configuration.compress_evaluation_keys)
         options.set_compress_input_ciphertexts(configuration.compress_input_ciphertexts)
+        options.set_compress_output_ciphertexts(configuration.compress_output_ciphertexts)
+        options.set_compact_fourier_bootstrap_keys(configuration.compact_fourier_bootstrap_keys)
         options.set_enable_overflow_detection_in_simulation(
             configuration.detect_overflow_in_simulation
         )
+        options.set_enable_noise_in_simulation(configuration.simulate_with_noise)
         options.set_composable(configuration.composable)
         composition_rules = list(composition_rules) if composition_rules else []
         for rule in composition_rules:
@@ -175,6 +187,7 @@ class Server:
             MultiParameterStrategy.PRECISION_AND_NORM2: (
                 OptimizerMultiParameterStrategy.PRECISION_AND_NORM2
             ),
+            MultiParameterStrategy.COST: OptimizerMultiParameterStrategy.COST,
         }
         options.set_optimizer_multi_parameter_strategy(converter[multi_parameter_strategy])
 
@@ -440,7 +453,154 @@ Provide a `function_name` keyword argument to disambiguate."
             result = server_circuit.simulate(unwrapped_args)
         else:
             assert evaluation_keys is not None
-            result = server_circuit.call(unwrapped_args, evaluation_keys.server_keyset)
+            if self._batching is not None:
+                result = self._batcher(function_name).call(
+                    unwrapped_args, evaluation_keys.server_keyset
+                )
+            else:
+                result = server_circuit.call(unwrapped_args, evaluation_keys.server_keyset)
+
+        result = [Value(r) for r in result]
+        return tuple(result) if len(result) > 1 else result[0]
+
+    def enable_batching(self, window: float = 0.001, max_batch_size: int = 64):
+        """
+        Coalesce the concurrent calls of `run` into batches.
+
+        The calls of a function made from several threads (e.g. by a web server handling each
+        request on its own thread) with the same evaluation keys, i.e. with the same
+        `EvaluationKeys` object, are run together natively, which keeps the cores or the GPUs
+        busy under concurrent load. A call waits at most `window` seconds for the next ones.
+
+        Args:
+            window (float, default = 0.001):
+                time in seconds a call waits for other calls to batch with
+
+            max_batch_size (int, default = 64):
+                number of pending calls after which a batch runs without waiting
+        """
+
+        if self.is_simulated:
+            message = "Expected a server in execution mode to batch calls"
+            raise RuntimeError(message)
+
+        with self._batchers_lock:
+            self._batching = (window, max_batch_size)
+            self._batchers = {}
+
+    def disable_batching(self):
+        """
+        Run each call of `run` on its own again, once the pending batches are done.
+        """
+
+        with self._batchers_lock:
+            self._batching = None
+            self._batchers = {}
+
+    def _batcher(self, function_name: str) -> CallBatcher:
+        with self._batchers_lock:
+            assert self._batching is not None
+            batcher = self._batchers.get(function_name)
+            if batcher is None:
+                window, max_batch_size = self._batching
+                server_program = ServerProgram(self._library, False)
+                batcher = CallBatcher(
+                    server_program.get_server_circuit(function_name), window, max_batch_size
+                )
+                self._batchers[function_name] = batcher
+            return batcher
+
+    def run_graph(
+        self,
+        calls: List[Tuple[str, List[Tuple[int, int]]]],
+        *args: Value,
+        evaluation_keys: Optional[EvaluationKeys] = None,
+    ) -> List[Tuple[Value, ...]]:
+        """
+        Evaluate a composition of functions, scheduled natively.
+
+        The calls run on native threads as soon as their arguments are computed, the results
+        are only returned once all the calls are done.
+
+        Args:
+            calls (List[Tuple[str, List[Tuple[int, int]]]]):
+                calls of the composition, as the name of the function called and the sources of
+                its arguments, each call only taking arguments from the calls before it. A source
+                is the index of a call and the position of one of its results, or -1 and the
+                position of an argument in `args`
+
+            *args (Value):
+                argument(s) of the composition
+
+            evaluation_keys (Optional[EvaluationKeys], default = None):
+                evaluation keys required for fhe execution
+
+        Returns:
+            List[Tuple[Value, ...]]:
+                result(s) of each call
+        """
+
+        if self.is_simulated:
+            message = "Expected a server in execution mode to run a graph of calls"
+            raise RuntimeError(message)
+
+        if evaluation_keys is None:
+            message = "Expected evaluation keys to be provided when not in simulation mode"
+            raise RuntimeError(message)
+
+        server_program = ServerProgram(self._library, False)
+        graph = CallGraph()
+        for function_name, sources in calls:
+            graph.add_call(server_program.get_server_circuit(function_name), sources)
+
+        outputs = graph.run(
+            [arg._inner for arg in args],  # pylint: disable=protected-access
+            evaluation_keys.server_keyset,
+        )
+        return [tuple(Value(r) for r in results) for results in outputs]
+
+    def run_repeated(
+        self,
+        function_name: str,
+        n: int,
+        *args: Value,
+        evaluation_keys: Optional[EvaluationKeys] = None,
+    ) -> Union[Value, Tuple[Value, ...]]:
+        """
+        Evaluate a composable function `n` times in a row, natively.
+
+        Each call takes the results of the previous one as arguments. The intermediate results
+        stay in native memory instead of being serialized between the calls.
+
+        Args:
+            function_name (str):
+                name of the function to run, whose results must have the types of its arguments
+
+            n (int):
+                number of calls
+
+            *args (Value):
+                argument(s) of the first call
+
+            evaluation_keys (Optional[EvaluationKeys], default = None):
+                evaluation keys required for fhe execution
+
+        Returns:
+            Union[Value, Tuple[Value, ...]]:
+                result(s) of the last call
+        """
+
+        if evaluation_keys is None and not self.is_simulated:
+            message = "Expected evaluation keys to be provided when not in simulation mode"
+            raise RuntimeError(message)
+
+        server_program = ServerProgram(self._library, self.is_simulated)
+        server_circuit = server_program.get_server_circuit(function_name)
+        result = server_circuit.call_repeated(
+            [arg._inner for arg in args],  # pylint: disable=protected-access
+            None if evaluation_keys is None else evaluation_keys.server_keyset,
+            n,
+        )
 
         result = [Value(r) for r in result]
         return tuple(result) if len(result) > 1 else result[0]
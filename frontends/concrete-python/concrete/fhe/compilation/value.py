@@ -4,6 +4,8 @@ Declaration of `Value` class.
 
 # pylint: disable=import-error,no-name-in-module
 
+from typing import List, Union
+
 from concrete.compiler import TransportValue
 
 
@@ -18,9 +20,9 @@ class Value:
         self._inner = inner
 
     @staticmethod
-    def deserialize(buffer: bytes) -> "Value":
+    def deserialize(buffer: Union[bytes, bytearray, memoryview]) -> "Value":
         """
-        Deserialize a Value from bytes.
+        Deserialize a Value from bytes, or from any buffer (e.g., a memoryview).
         """
         return Value(TransportValue.deserialize(buffer))
 
@@ -29,3 +31,23 @@ class Value:
         Serialize a Value to bytes.
         """
         return self._inner.serialize()
+
+    def serialize_to_memoryview(self) -> memoryview:
+        """
+        Serialize a Value to a memoryview, without copying the serialized bytes to a `bytes`.
+        """
+        return self._inner.serialize_to_memoryview()
+
+    @staticmethod
+    def serialize_all(values: List["Value"]) -> memoryview:
+        """
+        Serialize Values, e.g., all the arguments or results of a call, to a single memoryview.
+        """
+        return TransportValue.serialize_all([value._inner for value in values])
+
+    @staticmethod
+    def deserialize_all(buffer: Union[bytes, bytearray, memoryview]) -> List["Value"]:
+        """
+        Deserialize the Values serialized by `serialize_all`.
+        """
+        return [Value(inner) for inner in TransportValue.deserialize_all(buffer)]
@@ -950,6 +950,17 @@ class Converter:
             [value << (msg_width * i) for value in range(2 ** (msg_width + carry_width))]
             for i in range(num_cts)
         ]
+
+        # we want to set the padding bit if the native type is signed
+        # and the ciphertext is negative (sign bit set to 1)
+        if dtype.is_signed:
+            # the padding bit is set by the table of the msb ciphertext, so that it
+            # doesn't cost an extra bootstrap of the msb (carry would be considered negative)
+            tables[-1] = [
+                value + (0 if i < 2 ** (msg_width - 1) else 2**result_bit_width)
+                for i, value in enumerate(tables[-1])
+            ]
+
         mapping = np.broadcast_to(np.array(range(num_cts)), tfhers_int.shape)
 
         # intermediate type increase bit_width via TLU but keep the same shape
@@ -963,31 +974,7 @@ class Converter:
             ctx.esint(result_bit_width) if dtype.is_signed else ctx.eint(result_bit_width),
             result_shape,
         )
-        sum_result = ctx.sum(result_type, mapped, axes=-1)
-
-        # we want to set the padding bit if the native type is signed
-        # and the ciphertext is negative (sign bit set to 1)
-        if dtype.is_signed:
-            # select MSBs of all tfhers ciphetexts
-            index = [slice(0, dim_size) for dim_size in tfhers_int.shape[:-1]] + [
-                -1,
-            ]
-            msbs = ctx.index(
-                ctx.tensor(ctx.eint(msg_width + carry_width), tfhers_int.shape[:-1]),
-                tfhers_int,
-                index=index,
-            )
-            # construct padding bits based on sign bits (carry would be considered negative)
-            padding_bit_table = [
-                0,
-            ] * 2 ** (msg_width - 1) + [
-                2**result_bit_width,
-            ] * (2 ** (carry_width + msg_width) - 2 ** (msg_width - 1))
-            padding_bits_inc = ctx.tlu(result_type, msbs, padding_bit_table)
-            # set padding bits (where necessary) in the final result
-            result = ctx.add(result_type, sum_result, padding_bits_inc)
-        else:
-            result = sum_result
+        result = ctx.sum(result_type, mapped, axes=-1)
 
         # even if TFHE-rs value are using non-variable bit-width, we want the output
         # to be pluggable into the rest of the computation. For example, two 8bits TFHE-rs integers
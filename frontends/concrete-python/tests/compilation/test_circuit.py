@@ -3,6 +3,7 @@ Tests of `Circuit` class.
 """
 
 import tempfile
+import threading
 from pathlib import Path
 
 import numpy as np
@@ -406,6 +407,103 @@ def test_client_server_api_crt(helpers):
             assert np.array_equal(output, [100**2, 150**2, 10**2])
 
 
+def test_client_server_api_batch(helpers):
+    """
+    Test encrypting and decrypting many samples at once with the client API.
+    """
+
+    configuration = helpers.configuration()
+
+    @fhe.compiler({"x": "encrypted", "y": "encrypted"})
+    def function(x, y):
+        return x + y, x * 2
+
+    inputset = fhe.inputset(fhe.uint3, fhe.tensor[fhe.uint3, 2])  # type: ignore
+    circuit = function.compile(inputset, configuration.fork())
+
+    client = circuit.client
+    server = circuit.server
+
+    samples = [(x, np.array([x, 7 - x])) for x in range(8)]
+    encrypted = client.encrypt_batch(samples)
+    assert len(encrypted) == len(samples)
+
+    results = [server.run(*args, evaluation_keys=client.evaluation_keys) for args in encrypted]
+    decrypted = client.decrypt_batch(results)
+
+    for (x, y), (sum_, double) in zip(samples, decrypted):
+        assert np.array_equal(sum_, x + y)
+        assert double == x * 2
+
+    assert client.encrypt_batch([]) == []
+
+
+@pytest.mark.parametrize("mmap", [False, True])
+def test_client_server_api_evaluation_keys_file(mmap, helpers):
+    """
+    Test running a circuit with evaluation keys loaded from a file.
+    """
+
+    configuration = helpers.configuration()
+
+    @fhe.compiler({"x": "encrypted"})
+    def function(x):
+        return x**2
+
+    inputset = fhe.inputset(fhe.uint4)
+    circuit = function.compile(inputset, configuration.fork())
+
+    client = circuit.client
+    server = circuit.server
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        keys_path = Path(tmp_dir) / "evaluation_keys.bin"
+        client.evaluation_keys.save(keys_path)
+
+        evaluation_keys = EvaluationKeys.load(keys_path, mmap=mmap)
+        result = server.run(client.encrypt(7), evaluation_keys=evaluation_keys)
+        assert client.decrypt(result) == 49
+
+
+def test_client_server_api_batching(helpers):
+    """
+    Test coalescing concurrent calls of the server into batches.
+    """
+
+    configuration = helpers.configuration()
+
+    @fhe.compiler({"x": "encrypted"})
+    def function(x):
+        return x**2
+
+    inputset = fhe.inputset(fhe.uint4)
+    circuit = function.compile(inputset, configuration.fork())
+
+    client = circuit.client
+    server = circuit.server
+    evaluation_keys = client.evaluation_keys
+
+    server.enable_batching(window=0.01, max_batch_size=4)
+
+    inputs = list(range(10))
+    encrypted = [client.encrypt(x) for x in inputs]
+    results = [None] * len(inputs)
+
+    def request(i):
+        results[i] = server.run(encrypted[i], evaluation_keys=evaluation_keys)
+
+    threads = [threading.Thread(target=request, args=(i,)) for i in range(len(inputs))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert [client.decrypt(result) for result in results] == [x**2 for x in inputs]
+
+    server.disable_batching()
+    assert client.decrypt(server.run(encrypted[3], evaluation_keys=evaluation_keys)) == 9
+
+
 def test_client_server_api_via_mlir(helpers):
     """
     Test client/server API.
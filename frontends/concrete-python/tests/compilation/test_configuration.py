@@ -128,7 +128,7 @@ FORK_NAME = "fork" if sys.version_info < (3, 10) else "Configuration.fork"
         pytest.param(
             {"multi_parameter_strategy": "bad"},
             ValueError,
-            "'bad' is not a valid 'MultiParameterStrategy' (precision, precision_and_norm2)",
+            "'bad' is not a valid 'MultiParameterStrategy' (precision, precision_and_norm2, cost)",
         ),
         pytest.param(
             {"comparison_strategy_preference": 42},
@@ -997,6 +997,92 @@ def test_run_async():
     del module
 
 
+def test_run_graph():
+    """
+    Test `run_graph` with independent and dependent calls.
+    """
+
+    module = IncDec.Module.compile(IncDec.to_compile)
+
+    sample_x = 5
+    encrypted_x = module.inc.encrypt(sample_x)
+
+    results = module.run_graph(
+        [
+            ("inc", [(-1, 0)]),
+            ("dec", [(-1, 0)]),
+            ("inc", [(0, 0)]),
+            ("dec", [(2, 0)]),
+        ],
+        encrypted_x,
+    )
+    assert len(results) == 4
+    decrypted = [module.inc.decrypt(*result) for result in results]
+    assert decrypted == [sample_x + 1, sample_x - 1, sample_x + 2, sample_x + 1]
+
+    with pytest.raises(RuntimeError):
+        module.run_graph([("inc", [(1, 0)])], encrypted_x)
+
+
+def test_run_repeated():
+    """
+    Test `run_repeated` against chained `run` calls.
+    """
+
+    module = IncDec.Module.compile(IncDec.to_compile)
+
+    sample_x = 5
+    encrypted_x = module.inc.encrypt(sample_x)
+
+    result = module.run_repeated("inc", 3, encrypted_x)
+    assert module.inc.decrypt(result) == sample_x + 3
+
+    result = module.run_repeated("dec", 0, encrypted_x)
+    assert module.dec.decrypt(result) == sample_x
+
+
+def test_fused_calls():
+    """
+    Test a module with a fused function inlining independent and dependent calls.
+    """
+
+    @fhe.module()
+    class Module:
+        @fhe.function({"x": "encrypted"})
+        def inc(x):
+            return fhe.refresh(x + 1)
+
+        @fhe.function({"x": "encrypted"})
+        def dec(x):
+            return fhe.refresh(x - 1)
+
+        fused_calls = {
+            "inc_dec": [
+                ("inc", [(-1, 0)]),
+                ("dec", [(-1, 1)]),
+                ("inc", [(0, 0)]),
+            ],
+        }
+
+    module = Module.compile(IncDec.to_compile)
+    assert module.function_count == 3
+
+    sample = (5, 9)
+    assert module.inc_dec(*sample) == (8, 7)
+    assert module.inc_dec.encrypt_run_decrypt(*sample) == (8, 7)
+
+    @fhe.module()
+    class Invalid:
+        @fhe.function({"x": "encrypted"})
+        def inc(x):
+            return fhe.refresh(x + 1)
+
+        fused_calls = {"twice": [("inc", [(-1, 0)]), ("inc", [(1, 0)])]}
+
+    with pytest.raises(ValueError):
+        Invalid.compile({"inc": IncDec.inputset})
+
+
 def test_run_sync():
     """
     Test `run_sync` with `auto_schedule_run=True` configuration option.
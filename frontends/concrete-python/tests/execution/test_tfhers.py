@@ -272,6 +272,47 @@ def test_tfhers_conversion_one_tfhers_one_native(
     assert (dtype.decode(encoded_result) == function(*sample)).all()
 
 
+@pytest.mark.parametrize(
+    "signed_dtype, unsigned_dtype, values",
+    [
+        pytest.param(
+            tfhers.int8_2_2,
+            tfhers.uint8_2_2,
+            [-128, -77, -1, 0, 1, 42, 127],
+            id="int8",
+        ),
+    ],
+)
+def test_tfhers_signed_to_native(signed_dtype, unsigned_dtype, values, helpers):
+    """
+    Test the conversion of signed tfhers integers, whose padding bit is set by the table of
+    their most significant block, so that it costs as many bootstraps as an unsigned one.
+    """
+
+    # Only valid when running in multi
+    if helpers.configuration().parameter_selection_strategy != fhe.ParameterSelectionStrategy.MULTI:
+        return
+
+    def compile_to_native(dtype, inputset):
+        compiler = fhe.Compiler(lambda x: tfhers.to_native(x), {"x": "encrypted"})
+        inputset = [tfhers.TFHERSInteger(dtype, value) for value in inputset]
+        return compiler.compile(inputset, helpers.configuration())
+
+    dtype = parameterize_partial_dtype(signed_dtype)
+    circuit = compile_to_native(dtype, values)
+    unsigned_circuit = compile_to_native(
+        parameterize_partial_dtype(unsigned_dtype), [abs(value) for value in values]
+    )
+
+    # one bootstrap per block, for both signednesses
+    num_blocks = dtype.bit_width // dtype.msg_width
+    assert unsigned_circuit.programmable_bootstrap_count == num_blocks
+    assert circuit.programmable_bootstrap_count == num_blocks
+
+    for value in values:
+        assert circuit.encrypt_run_decrypt(dtype.encode(value)) == value
+
+
 def lut_add_lut(x, y):
     """lut add lut compute"""
     lut = fhe.LookupTable(list(range(256)))